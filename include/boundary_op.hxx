@@ -10,6 +10,7 @@ class BoundaryModifier;
 #include "field3d.hxx"
 #include "vector2d.hxx"
 #include "vector3d.hxx"
+#include "bout/fieldgroup.hxx"
 #include "unused.hxx"
 
 #include <cmath>
@@ -40,6 +41,19 @@ public:
     apply(f.y);
     apply(f.z);
   }
+
+  /// Apply this boundary condition to every field in \p group in one
+  /// batch, so e.g. all evolving fields sharing a boundary condition
+  /// can be handled with a single call per boundary region
+  void apply(FieldGroup &group, BoutReal t = 0.0) {
+    for (FieldData *f : group.get()) {
+      if (Field3D *f3d = dynamic_cast<Field3D *>(f)) {
+        apply(*f3d, t);
+      } else if (Field2D *f2d = dynamic_cast<Field2D *>(f)) {
+        apply(*f2d, t);
+      }
+    }
+  }
 };
 
 /// An operation on a boundary
@@ -71,6 +85,18 @@ public:
     apply(ddt(f));
   }
 
+  /// Apply this boundary condition to the time derivative of every
+  /// field in \p group in one batch
+  void apply_ddt(FieldGroup &group) {
+    for (FieldData *f : group.get()) {
+      if (Field3D *f3d = dynamic_cast<Field3D *>(f)) {
+        apply_ddt(*f3d);
+      } else if (Field2D *f2d = dynamic_cast<Field2D *>(f)) {
+        apply_ddt(*f2d);
+      }
+    }
+  }
+
   BoundaryRegion *bndry;
   bool apply_to_ddt; // True if this boundary condition should be applied on the time derivatives, false if it should be applied to the field values
 };
@@ -8,6 +8,8 @@ class BoundaryRegion;
 #include <utility>
 using std::string;
 
+#include <bout/region.hxx>
+
 class Mesh;
 extern Mesh* mesh;
 
@@ -63,6 +65,26 @@ public:
   virtual void next1d() = 0; ///< Loop over the innermost elements
   virtual void nextX() = 0;  ///< Just loop over X
   virtual void nextY() = 0;  ///< Just loop over Y
+
+  /// All points in this boundary region as a precomputed Region, so
+  /// that independent boundary loops can be parallelised with BOUT_FOR
+  /// instead of walking the serial first()/next() protocol. Calculated
+  /// on first use; note that this resets the region iterator.
+  const Region<Ind2D> &getRegion();
+
+  /// The innermost boundary points (the first()/next1d() loop) as a
+  /// precomputed Region. The boundary direction (bx, by) and width are
+  /// the same for every point in the region, so a boundary condition
+  /// can be compiled down to one flat sweep over these points with the
+  /// per-point virtual iterator calls removed. Calculated on first
+  /// use; note that this resets the region iterator.
+  const Region<Ind2D> &getRegion1d();
+
+private:
+  Region<Ind2D> pointRegion; ///< Cache for getRegion()
+  bool pointRegionSet{false};
+  Region<Ind2D> pointRegion1d; ///< Cache for getRegion1d()
+  bool pointRegion1dSet{false};
 };
 
 class BoundaryRegionXIn : public BoundaryRegion {
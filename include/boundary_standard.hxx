@@ -9,6 +9,64 @@
 #include "unused.hxx"
 
 #include <utility>
+#include <vector>
+
+/// Caches the stream of values produced by a boundary expression
+/// generator during one application pass.
+///
+/// Boundary conditions with expression arguments re-evaluate their
+/// FieldGenerator tree once per boundary point per application. The
+/// evaluation order is fixed by the boundary region iterator, so for a
+/// given time the value stream is deterministic: record it on the
+/// first pass and replay the flat array afterwards. Time-independent
+/// conditions (always applied at the same time) therefore walk the
+/// expression tree exactly once; time-dependent ones fall back to
+/// evaluating the parsed tree each pass.
+class BoundaryValueCache {
+public:
+  /// Set or replace the generator the values come from. Changing the
+  /// generator discards any recorded values.
+  void setGenerator(std::shared_ptr<FieldGenerator> g) {
+    if (g != gen) {
+      gen = std::move(g);
+      valid = false;
+    }
+  }
+
+  /// Start an application pass at time \p t. Values are replayed only
+  /// if a complete pass has been recorded at the same time.
+  void startPass(BoutReal t) {
+    replay = valid && (t == cachedTime);
+    if (!replay) {
+      values.clear();
+      valid = false;
+      cachedTime = t;
+    }
+    pos = 0;
+  }
+
+  /// Finish a pass, marking the recorded stream usable for replay
+  void endPass() { valid = true; }
+
+  /// Next value in the stream: the recorded value when replaying,
+  /// otherwise evaluate the generator and record the result
+  BoutReal generate(BoutReal x, BoutReal y, BoutReal z, BoutReal t) {
+    if (replay) {
+      return values[pos++];
+    }
+    BoutReal val = gen->generate(x, y, z, t);
+    values.push_back(val);
+    return val;
+  }
+
+private:
+  std::shared_ptr<FieldGenerator> gen;
+  std::vector<BoutReal> values; ///< Recorded value stream
+  std::vector<BoutReal>::size_type pos{0}; ///< Replay position
+  BoutReal cachedTime{0.0}; ///< Time the stream was recorded at
+  bool valid{false};  ///< Has a complete pass been recorded?
+  bool replay{false}; ///< Is the current pass replaying?
+};
 
 /// Dirichlet boundary condition set half way between guard cell and grid cell at 2nd order accuracy
 class BoundaryDirichlet_2ndOrder : public BoundaryOp {
@@ -48,6 +106,7 @@ class BoundaryDirichlet : public BoundaryOp {
   void apply_ddt(Field3D &f) override;
  private:
   std::shared_ptr<FieldGenerator>  gen; // Generator
+  BoundaryValueCache valCache; // Cached generator values
 };
 
 BoutReal default_func(BoutReal t, int x, int y, int z);
@@ -71,6 +130,7 @@ class BoundaryDirichlet_O3 : public BoundaryOp {
   void apply_ddt(Field3D &f) override;
  private:
   std::shared_ptr<FieldGenerator>  gen; // Generator
+  BoundaryValueCache valCache; // Cached generator values
 };
 
 /// 4th-order boundary condition
@@ -92,6 +152,7 @@ class BoundaryDirichlet_O4 : public BoundaryOp {
   void apply_ddt(Field3D &f) override;
  private:
   std::shared_ptr<FieldGenerator>  gen; // Generator
+  BoundaryValueCache valCache; // Cached generator values
 };
 
 /// Dirichlet boundary condition set half way between guard cell and grid cell at 4th order accuracy
@@ -178,6 +239,7 @@ class BoundaryNeumann : public BoundaryOp {
   void apply_ddt(Field3D &f) override;
  private:
   std::shared_ptr<FieldGenerator> gen;
+  BoundaryValueCache valCache; // Cached generator values
 };
 
 /// Neumann boundary condition set half way between guard cell and grid cell at 4th order accuracy
@@ -218,6 +280,7 @@ class BoundaryNeumann_O4 : public BoundaryOp {
   void apply_ddt(Field3D &f) override;
  private:
   std::shared_ptr<FieldGenerator> gen;
+  BoundaryValueCache valCache; // Cached generator values
 };
 
 /// NeumannPar (zero-gradient) boundary condition on
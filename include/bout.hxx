@@ -109,7 +109,41 @@ int bout_run(Solver *solver, rhsfunc physics_run);
  * or in bout/physicsmodel.hxx
  */
 class BoutMonitor: public Monitor{
+public:
+  /// Registers the timings below with the dump file if save_wtimes is
+  /// set, and \p solver's integrator statistics if save_solver_stats is
+  BoutMonitor(Solver *solver = nullptr);
+
+private:
   int call(Solver *solver, BoutReal t, int iter, int NOUT) override;
+
+  /// Wall-clock times over the last output timestep, optionally
+  /// saved to the dump file as a time series (option save_wtimes)
+  BoutReal wtime{0.0};        ///< Total time
+  BoutReal wtime_rhs{0.0};    ///< Time evaluating the RHS
+  BoutReal wtime_invert{0.0}; ///< Time in inversions
+  BoutReal wtime_comms{0.0};  ///< Time communicating (part of RHS)
+  BoutReal wtime_io{0.0};     ///< Time on I/O
+
+  /// Load imbalance telemetry, collected each output timestep when the
+  /// report_imbalance option is set. The slowest processor sets the
+  /// pace, so max/mean of the RHS time measures the time wasted waiting
+  bool report_imbalance{false};
+  BoutReal wtime_mpi_wait{0.0}; ///< This processor's time blocked in MPI waits
+  BoutReal wtime_rhs_min{0.0};  ///< Fastest processor's RHS time
+  BoutReal wtime_rhs_mean{0.0}; ///< Mean RHS time across processors
+  BoutReal wtime_rhs_max{0.0};  ///< Slowest processor's RHS time
+  int rhs_straggler{0};         ///< Rank of the slowest processor
+
+  /// Dump the Array store instrumentation (allocations, store misses,
+  /// copy-on-write copies, per solver stage) each output timestep when
+  /// the report_array_metrics option is set. See bout/array_metrics.hxx
+  bool report_array_metrics{false};
+
+  /// Report what fraction of bout::Cached operator results were reused
+  /// rather than recomputed each output timestep when the
+  /// report_cache_reuse option is set. See bout/cached.hxx
+  bool report_cache_reuse{false};
 };
 
 /*!
@@ -26,9 +26,12 @@
 #define __ARRAY_H__
 
 #include <algorithm>
+#include <cstdlib>
 #include <map>
-#include <vector>
 #include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -38,9 +41,21 @@
 #include <valarray>
 #endif
 
+#ifdef BOUT_USE_CUDA
+#include <cuda_runtime.h>
+#endif
+
+#include <bout/array_metrics.hxx>
 #include <bout/assert.hxx>
 #include <bout/openmpwrap.hxx>
 
+/// Alignment (in bytes) of Array backing storage: a cache line, and
+/// at least the widest SIMD vector in use. With an aligned base, any
+/// z extent that is a multiple of the vector width (e.g. the usual
+/// power-of-two nz) puts every z-pencil of a Field3D on an aligned
+/// address, so vectorized z kernels never pay for split loads
+#define BOUT_ARRAY_ALIGNMENT 64
+
 /*!
  * Data array type with automatic memory management
  *
@@ -63,12 +78,28 @@
  * This behaviour can be disabled by calling the static function useStore:
  *
  * Array<dcomplex>::useStore(false); // Disables memory store
- * 
+ *
+ * When a device backend is compiled in (BOUT_USE_CUDA), each data
+ * block can also hold a device copy. Migration between the spaces is
+ * explicit — migrateToDevice(), migrateToHost(), prefetchToDevice() —
+ * and the block tracks which copy is valid, so host access to
+ * device-resident data is caught by the CHECK-level assertions.
+ * Device allocations are recycled through the store along with their
+ * host blocks. Without a backend everything stays host resident and
+ * the migration calls are no-ops.
+ *
  */
 template<typename T>
 class Array {
 public:
   typedef T data_type;
+
+  /*!
+   * Which copy of the data is valid. HOST and DEVICE mean only that
+   * copy is current; BOTH means the copies agree (e.g. after a
+   * prefetch, before either side writes)
+   */
+  enum Residency { HOST, DEVICE, BOTH };
     
   /*!
    * Create an empty array
@@ -137,6 +168,147 @@ public:
     return value;
   }
   
+  /*!
+   * Controls whether blocks are bulk-reserved in slabs
+   *
+   * When enabled, a freelist miss reserves a slab holding several
+   * blocks of the requested size in a single allocation, and carves
+   * it up into the calling thread's freelist. Combined with the
+   * thread-local freelists this makes Array construction in hot
+   * loops (e.g. Field3D temporaries in the RHS) allocation-free and
+   * lock-free after warm-up.
+   *
+   * Disabled by default; typically enabled at startup. Has no effect
+   * when the store is disabled, or with BOUT_ARRAY_WITH_VALARRAY
+   * backing (which cannot view slab storage).
+   */
+  static bool useArena(bool enable) {
+    arenaEnabled() = enable;
+    return arenaEnabled();
+  }
+
+  /*!
+   * Controls whether freshly allocated blocks are first-touched in
+   * parallel
+   *
+   * With first-touch NUMA policy (the Linux default), a page is
+   * placed on the node of the thread that first writes to it. Blocks
+   * allocated here would otherwise be touched serially by whichever
+   * loop writes them first, putting whole fields on one socket while
+   * BOUT_FOR threads on the other pull every line across the
+   * interconnect. When enabled, new blocks are value-initialised by
+   * an OpenMP loop with the same schedule BOUT_FOR uses, so pages
+   * land on the node of the thread that will work on them.
+   *
+   * Recycled blocks keep their placement: the freelists are
+   * per-thread, so a block released by a thread is reused by that
+   * same thread and stays on its node.
+   *
+   * Disabled by default; typically enabled at startup on multi-socket
+   * nodes. Only fresh allocations are affected, so enabling it after
+   * the store is warm does nothing
+   */
+  static bool useFirstTouch(bool enable) {
+    firstTouchEnabled() = enable;
+    return firstTouchEnabled();
+  }
+
+  /*!
+   * Is a device backend compiled in? When false the data always
+   * stays host resident and the migration calls below are no-ops
+   */
+  static bool hasDevice() {
+#ifdef BOUT_USE_CUDA
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  /*!
+   * Which copy of the data is currently valid. An empty Array is
+   * host resident
+   */
+  Residency residency() const {
+#ifdef BOUT_ARRAY_WITH_VALARRAY
+    return HOST;
+#else
+    return (ptr) ? ptr->resident : HOST;
+#endif
+  }
+
+  /// Is the host copy valid, i.e. safe to read through operator[]?
+  bool isHostResident() const {
+    return residency() != DEVICE;
+  }
+
+  /*!
+   * Move the valid copy to the device. The host copy is uploaded if
+   * it is the only valid one, and is considered stale afterwards:
+   * host access asserts until migrateToHost(). The device block is
+   * allocated on first migration and recycled through the store with
+   * the host block
+   */
+  void migrateToDevice() {
+#ifndef BOUT_ARRAY_WITH_VALARRAY
+    if (!ptr || !hasDevice())
+      return;
+    if (ptr->resident == HOST) {
+      ptr->allocDevice();
+      ptr->copyToDevice();
+    }
+    ptr->resident = DEVICE;
+#endif
+  }
+
+  /*!
+   * Move the valid copy back to the host, downloading it if the
+   * device copy is the only valid one. The device allocation is kept
+   * for the next migration
+   */
+  void migrateToHost() {
+#ifndef BOUT_ARRAY_WITH_VALARRAY
+    if (!ptr)
+      return;
+    if (ptr->resident == DEVICE) {
+      ptr->copyToHost();
+    }
+    ptr->resident = HOST;
+#endif
+  }
+
+  /*!
+   * Upload a copy to the device without giving up host validity:
+   * afterwards both copies agree (BOTH) and a later migrateToDevice()
+   * needs no transfer. Call ahead of device work while the host is
+   * still reading
+   */
+  void prefetchToDevice() {
+#ifndef BOUT_ARRAY_WITH_VALARRAY
+    if (!ptr || !hasDevice())
+      return;
+    if (ptr->resident == HOST) {
+      ptr->allocDevice();
+      ptr->copyToDevice();
+      ptr->resident = BOTH;
+    }
+#endif
+  }
+
+  /*!
+   * Pointer to the device copy, for passing to device kernels. The
+   * data must have been migrated or prefetched to the device
+   */
+  T* deviceData() {
+#ifdef BOUT_ARRAY_WITH_VALARRAY
+    return nullptr;
+#else
+    ASSERT1(ptr != nullptr);
+    ASSERT2(residency() != HOST);
+    return ptr->devData;
+#endif
+  }
+
   /*!
    * Release data. After this the Array is empty and any data access
    * will be invalid
@@ -195,6 +367,20 @@ public:
     if(!ptr || unique())
       return;
 
+#ifndef BOUT_ARRAY_WITH_VALARRAY
+    // The copy below reads the host side; bring it up to date if the
+    // device holds the only valid copy. The shared block stays valid
+    // both sides — this is a sync, not a modification
+    if (ptr->resident == DEVICE) {
+      ptr->copyToHost();
+      ptr->resident = BOTH;
+    }
+#endif
+
+    if (ArrayMetrics::enabled()) {
+      ArrayMetrics::recordUniqueCopy(sizeof(T) * static_cast<std::size_t>(size()));
+    }
+
     // Get a new (unique) block of data
     dataPtrType p = get(size());
 
@@ -216,20 +402,24 @@ public:
   typedef T* iterator;
   typedef const T* const_iterator;
 #ifndef BOUT_ARRAY_WITH_VALARRAY
-  iterator begin() { 
+  iterator begin() {
+    ASSERT2(isHostResident()); // Stale host copy: migrateToHost() first
     return (ptr) ? ptr->data : nullptr;
   }
 
   iterator end() {
+    ASSERT2(isHostResident());
     return (ptr) ? ptr->data + ptr->len : nullptr;
   }
 
-  // Const iterators  
+  // Const iterators
   const_iterator begin() const {
+    ASSERT2(isHostResident()); // Stale host copy: migrateToHost() first
     return (ptr) ? ptr->data : nullptr;
   }
 
   const_iterator end() const {
+    ASSERT2(isHostResident());
     return (ptr) ? ptr->data + ptr->len : nullptr;
   }
 #else
@@ -260,19 +450,21 @@ public:
    */
   T& operator[](int ind) {
     ASSERT3(0 <= ind && ind < size());
+    ASSERT3(isHostResident()); // Stale host copy: migrateToHost() first
 #ifdef BOUT_ARRAY_WITH_VALARRAY
     return ptr->operator[](ind);
-#else    
+#else
     return ptr->data[ind];
-#endif    
+#endif
   }
   const T& operator[](int ind) const {
     ASSERT3(0 <= ind && ind < size());
+    ASSERT3(isHostResident()); // Stale host copy: migrateToHost() first
 #ifdef BOUT_ARRAY_WITH_VALARRAY
     return ptr->operator[](ind);
-#else    
+#else
     return ptr->data[ind];
-#endif    
+#endif
   }
 
   /*!
@@ -294,12 +486,47 @@ private:
   struct ArrayData {
     int len;    ///< Size of the array
     T *data;    ///< Array of data
-    
+    T *devData = nullptr;      ///< Device copy; null until first migration
+    Residency resident = HOST; ///< Which copy is valid
+
     ArrayData(int size) : len(size) {
-      data = new T[len];
+      data = alignedAlloc(len);
     }
+    /*!
+     * Construct a block viewing part of a shared slab allocation.
+     * The slab is freed once every block carved from it has been
+     * deleted.
+     */
+    ArrayData(int size, T *view, std::shared_ptr<T> keep)
+        : len(size), data(view), slab(std::move(keep)) {}
     ~ArrayData() {
-      delete[] data;
+      freeDevice();
+      if (!slab)
+        alignedFree(data, len);
+    }
+
+    /*!
+     * Allocate \p n default-initialised elements starting on a
+     * BOUT_ARRAY_ALIGNMENT boundary. Equivalent to new T[n] apart
+     * from the alignment guarantee; free with alignedFree
+     */
+    static T* alignedAlloc(int n) {
+      if (n <= 0)
+        return nullptr;
+      void *mem = nullptr;
+      if (posix_memalign(&mem, BOUT_ARRAY_ALIGNMENT,
+                         sizeof(T) * static_cast<std::size_t>(n)) != 0)
+        throw std::bad_alloc();
+      T *block = static_cast<T *>(mem);
+      for (int i = 0; i < n; i++)
+        new (block + i) T; // A no-op loop for BoutReal etc.
+      return block;
+    }
+
+    static void alignedFree(T *block, int n) {
+      for (int i = n - 1; i >= 0; i--)
+        block[i].~T();
+      free(block);
     }
     iterator begin() {
       return data;
@@ -307,6 +534,35 @@ private:
     iterator end() {
       return data + len;
     }
+
+    // Device backend hooks. Without a backend the device side is
+    // never allocated and these are no-ops
+#ifdef BOUT_USE_CUDA
+    void allocDevice() {
+      if (!devData) {
+        cudaMalloc(reinterpret_cast<void**>(&devData), sizeof(T) * len);
+      }
+    }
+    void copyToDevice() {
+      cudaMemcpy(devData, data, sizeof(T) * len, cudaMemcpyHostToDevice);
+    }
+    void copyToHost() {
+      cudaMemcpy(data, devData, sizeof(T) * len, cudaMemcpyDeviceToHost);
+    }
+    void freeDevice() {
+      if (devData) {
+        cudaFree(devData);
+        devData = nullptr;
+      }
+    }
+#else
+    void allocDevice() {}
+    void copyToDevice() {}
+    void copyToHost() {}
+    void freeDevice() {}
+#endif
+  private:
+    std::shared_ptr<T> slab; ///< Owns the slab storage when non-null
   };
 #endif
 
@@ -326,7 +582,53 @@ private:
   dataPtrType ptr;
 
   typedef std::map< int, std::vector<dataPtrType> > storeType;
-  typedef std::vector< storeType > arenaType;
+  typedef std::vector< std::shared_ptr<storeType> > arenaType;
+
+  /*!
+   * Whether freelist misses are served by carving up bulk slab
+   * reservations. See useArena()
+   */
+  static bool& arenaEnabled() {
+    static bool enabled = false;
+    return enabled;
+  }
+
+  /*!
+   * Whether fresh allocations are first-touched in parallel. See
+   * useFirstTouch()
+   */
+  static bool& firstTouchEnabled() {
+    static bool enabled = false;
+    return enabled;
+  }
+
+  /*!
+   * Value-initialise freshly allocated storage with the same OpenMP
+   * schedule BOUT_FOR uses, so under first-touch NUMA policy the
+   * pages are distributed the same way BOUT_FOR distributes work
+   */
+  static void firstTouch(T *data, int len) {
+    BOUT_OMP(parallel for schedule(OPENMP_SCHEDULE))
+    for (int i = 0; i < len; ++i) {
+      data[i] = T();
+    }
+  }
+
+  /*!
+   * Registry of the per-thread stores, so that cleanup() on the main
+   * thread can empty all of them. Stores are shared_ptr so a store
+   * outlives its thread if cleanup runs after the thread has gone
+   */
+  static arenaType& arena() {
+    static arenaType stores;
+    return stores;
+  }
+
+  /// Protects registration of new per-thread stores in arena()
+  static std::mutex& arenaMutex() {
+    static std::mutex m;
+    return m;
+  }
 
   /*!
    * This maps from array size (int) to vectors of pointers to ArrayData objects
@@ -340,44 +642,69 @@ private:
    * @param[in] cleanup   If set to true, deletes all ArrayData and clears the store
    */
   static storeType& store(bool cleanup=false) {
-#ifdef _OPENMP    
-    static arenaType arena(omp_get_max_threads());
-#else
-    static arenaType arena(1);
-#endif
-    
+    // Each thread has its own freelists, so the fast path below
+    // touches no shared state and needs no locking. The store is
+    // registered once per thread so that cleanup() can reach it.
+    static thread_local std::shared_ptr<storeType> mine = []() {
+      auto s = std::make_shared<storeType>();
+      std::lock_guard<std::mutex> lock(arenaMutex());
+      arena().push_back(s);
+      return s;
+    }();
+
     if (!cleanup) {
-#ifdef _OPENMP 
-      return arena[omp_get_thread_num()];
-#else
-      return arena[0];
-#endif
+      return *mine;
     }
 
-    // Clean by deleting all data -- possible that just stores.clear() is
-    // sufficient rather than looping over each entry.
-    BOUT_OMP(single)
+    // Clean by deleting all data from every registered store. Any
+    // slab reservations are freed once the last block carved from
+    // them has been deleted.
     {
-      for (auto &stores : arena) {
-        for (auto &p : stores) {
+      std::lock_guard<std::mutex> lock(arenaMutex());
+      for (auto &stores : arena()) {
+        for (auto &p : *stores) {
           auto &v = p.second;
           for (dataPtrType a : v) {
             a.reset();
           }
           v.clear();
         }
-        stores.clear();
+        stores->clear();
       }
-      // Here we ensure there is exactly one empty map still
-      // left in the arena as we have to return one such item
-      arena.resize(1);
     }
 
     //Store should now be empty but we need to return something,
-    //so return an empty storeType from the arena.
-    return arena[0];
+    //so return the (empty) store of the calling thread.
+    return *mine;
   }
-  
+
+  /*!
+   * Number of blocks reserved in one slab, aiming for slabs of
+   * around 1MB while bounding the amount of memory committed for
+   * very small or very large block sizes
+   */
+  static int slabBlocks(int len) {
+    const std::size_t target = 1048576; // 1MB slabs
+    std::size_t nblocks = target / (sizeof(T) * static_cast<std::size_t>(len));
+    if (nblocks < 4)
+      nblocks = 4;
+    if (nblocks > 64)
+      nblocks = 64;
+    return static_cast<int>(nblocks);
+  }
+
+  /*!
+   * Block stride (in elements) within a slab: \p len rounded up so
+   * that consecutive blocks all start on BOUT_ARRAY_ALIGNMENT
+   * boundaries, not just the first
+   */
+  static int alignedStride(int len) {
+    if ((BOUT_ARRAY_ALIGNMENT % sizeof(T)) != 0)
+      return len; // Element size can't tile the alignment: no padding
+    const int elems = BOUT_ARRAY_ALIGNMENT / sizeof(T);
+    return ((len + elems - 1) / elems) * elems;
+  }
+
   /*!
    * Returns a pointer to an ArrayData object with no
    * references. This is either from the store, or newly allocated
@@ -386,14 +713,62 @@ private:
     dataPtrType p;
 
     auto& st = store()[len];
-    
+
     if (!st.empty()) {
       p = st.back();
       st.pop_back();
-    } else {
-      p = std::make_shared<dataBlock>(len);
+#ifndef BOUT_ARRAY_WITH_VALARRAY
+      // Recycled blocks keep their device allocation (so repeated
+      // migrations of same-size arrays reuse it), but the contents on
+      // both sides are undefined: a fresh Array starts host resident
+      p->resident = HOST;
+#endif
+      if (ArrayMetrics::enabled()) {
+        ArrayMetrics::recordStoreHit();
+      }
+      return p;
+    }
+
+    if (ArrayMetrics::enabled()) {
+      ArrayMetrics::recordStoreMiss();
     }
 
+#ifndef BOUT_ARRAY_WITH_VALARRAY
+    if (arenaEnabled() && useStore() && (len > 0)) {
+      // Freelist miss: reserve a slab holding several blocks of this
+      // size in one allocation, keep one and put the rest into this
+      // thread's freelist. Subsequent Array constructions of this
+      // size are then served without touching the system allocator.
+      const int nblocks = slabBlocks(len);
+      // Pad the stride between blocks so that every block starts
+      // aligned, as a fresh allocation would
+      const int stride = alignedStride(len);
+      const int total = stride * nblocks;
+      if (ArrayMetrics::enabled()) {
+        ArrayMetrics::recordAllocation(sizeof(T) * static_cast<std::size_t>(total));
+      }
+      std::shared_ptr<T> slab(dataBlock::alignedAlloc(total),
+                              [total](T *p) { dataBlock::alignedFree(p, total); });
+      T *raw = slab.get();
+      if (firstTouchEnabled()) {
+        // Touch the whole slab before carving it up, so every block
+        // cut from it has BOUT_FOR-compatible page placement
+        firstTouch(raw, total);
+      }
+      for (int b = 1; b < nblocks; ++b) {
+        st.push_back(std::make_shared<dataBlock>(len, raw + b * stride, slab));
+      }
+      return std::make_shared<dataBlock>(len, raw, std::move(slab));
+    }
+#endif
+
+    if (ArrayMetrics::enabled()) {
+      ArrayMetrics::recordAllocation(sizeof(T) * static_cast<std::size_t>(len));
+    }
+    p = std::make_shared<dataBlock>(len);
+    if (firstTouchEnabled() && (len > 0)) {
+      firstTouch(std::begin(*p), len);
+    }
     return p;
   }
   
@@ -0,0 +1,203 @@
+/*
+ * Instrumentation counters for the Array store
+ *
+ * The Array store silently services allocation requests and
+ * copy-on-write triggers, which makes hidden allocations inside hot
+ * code (e.g. the RHS) invisible. This collects per-label event
+ * counters: blocks recycled from the store, store misses, system
+ * allocator calls and bytes, and copy-on-write copies made by
+ * ensureUnique(). The label identifies a phase of the run ("rhs",
+ * "convective", ...) and is set with an RAII Label scope, so events
+ * can be attributed to the solver stage that triggered them.
+ *
+ * Collection is off by default and costs a single predictable branch
+ * per event; it is enabled by the root option report_array_metrics,
+ * which also dumps and resets the counters every output timestep (see
+ * BoutMonitor). With array_metrics_callsites the message stack is
+ * captured at every copy-on-write copy, so the copies can be traced
+ * to the operation that caused them; this needs CHECK >= 2 for the
+ * stack to carry TRACE messages.
+ *
+ * When collection is enabled the counters are guarded by a mutex, so
+ * event counts from OpenMP regions are exact but carry locking
+ * overhead: this is a debugging tool, not for production runs.
+ */
+
+#ifndef __ARRAY_METRICS_H__
+#define __ARRAY_METRICS_H__
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+#include <msg_stack.hxx>
+
+class ArrayMetrics {
+public:
+  /// Event counters for one label
+  struct Counters {
+    unsigned long long store_hits = 0;    ///< Blocks recycled from the store
+    unsigned long long store_misses = 0;  ///< Requests the store could not serve
+    unsigned long long allocations = 0;   ///< System allocator calls
+    unsigned long long bytes_allocated = 0;
+    unsigned long long unique_copies = 0; ///< Copy-on-write copies (ensureUnique)
+    unsigned long long bytes_copied = 0;
+  };
+
+  /// Is collection enabled? Off by default; checked before taking any
+  /// lock, so the disabled cost is one branch per event
+  static bool &enabled() {
+    static bool value = false;
+    return value;
+  }
+
+  /// Capture the message stack at every copy-on-write copy?
+  static bool &captureCallsites() {
+    static bool value = false;
+    return value;
+  }
+
+  /// Attribute subsequent events to \p label
+  static void setLabel(const std::string &label) {
+    std::lock_guard<std::mutex> guard(mutex());
+    currentLabel() = label;
+  }
+
+  /// RAII scope labelling events, restoring the previous label on
+  /// destruction:
+  ///
+  ///     ArrayMetrics::Label label("rhs");
+  ///
+  /// Does nothing when collection is disabled
+  class Label {
+  public:
+    Label(const std::string &label) : active(enabled()) {
+      if (active) {
+        std::lock_guard<std::mutex> guard(mutex());
+        previous = currentLabel();
+        currentLabel() = label;
+      }
+    }
+    ~Label() {
+      if (active) {
+        std::lock_guard<std::mutex> guard(mutex());
+        currentLabel() = previous;
+      }
+    }
+
+  private:
+    bool active;
+    std::string previous;
+  };
+
+  static void recordStoreHit() {
+    std::lock_guard<std::mutex> guard(mutex());
+    counters()[currentLabel()].store_hits += 1;
+  }
+
+  static void recordStoreMiss() {
+    std::lock_guard<std::mutex> guard(mutex());
+    counters()[currentLabel()].store_misses += 1;
+  }
+
+  /// One system allocator call of \p bytes (which may be a slab
+  /// holding several blocks)
+  static void recordAllocation(std::size_t bytes) {
+    std::lock_guard<std::mutex> guard(mutex());
+    Counters &c = counters()[currentLabel()];
+    c.allocations += 1;
+    c.bytes_allocated += bytes;
+  }
+
+  /// One copy-on-write copy of \p bytes made by ensureUnique()
+  static void recordUniqueCopy(std::size_t bytes) {
+    std::lock_guard<std::mutex> guard(mutex());
+    Counters &c = counters()[currentLabel()];
+    c.unique_copies += 1;
+    c.bytes_copied += bytes;
+    if (captureCallsites()) {
+      callsites()[msg_stack.getDump()] += 1;
+    }
+  }
+
+  /// Sum of the counters over all labels, e.g. for the scenario
+  /// benchmarks' whole-run allocation count
+  static Counters total() {
+    std::lock_guard<std::mutex> guard(mutex());
+    Counters sum;
+    for (const auto &it : counters()) {
+      const Counters &c = it.second;
+      sum.store_hits += c.store_hits;
+      sum.store_misses += c.store_misses;
+      sum.allocations += c.allocations;
+      sum.bytes_allocated += c.bytes_allocated;
+      sum.unique_copies += c.unique_copies;
+      sum.bytes_copied += c.bytes_copied;
+    }
+    return sum;
+  }
+
+  /// Format the counters as a table, one row per label, followed by
+  /// the captured copy-on-write callsites (if enabled)
+  static std::string report() {
+    std::lock_guard<std::mutex> guard(mutex());
+    std::stringstream result;
+
+    result << "Array store events by label:\n";
+    result << "  label                   hits    misses    allocs  MB alloc"
+           << "    copies  MB copied\n";
+    for (const auto &it : counters()) {
+      const Counters &c = it.second;
+      char line[256];
+      snprintf(line, sizeof(line), "  %-20s %9llu %9llu %9llu %9.2f %9llu %10.2f\n",
+               it.first.c_str(), c.store_hits, c.store_misses, c.allocations,
+               c.bytes_allocated / 1048576., c.unique_copies,
+               c.bytes_copied / 1048576.);
+      result << line;
+    }
+
+    if (captureCallsites() && !callsites().empty()) {
+      result << "Copy-on-write callsites:\n";
+      for (const auto &it : callsites()) {
+        result << "  " << it.second << " copies at:\n"
+               << (it.first.empty() ? std::string("    (no trace: needs CHECK >= 2)\n")
+                                    : it.first);
+      }
+    }
+
+    return result.str();
+  }
+
+  /// Zero all counters and captured callsites
+  static void reset() {
+    std::lock_guard<std::mutex> guard(mutex());
+    counters().clear();
+    callsites().clear();
+  }
+
+private:
+  static std::mutex &mutex() {
+    static std::mutex m;
+    return m;
+  }
+
+  static std::string &currentLabel() {
+    static std::string label = "other";
+    return label;
+  }
+
+  static std::map<std::string, Counters> &counters() {
+    static std::map<std::string, Counters> c;
+    return c;
+  }
+
+  /// Copy-on-write event counts keyed by the message stack dump
+  static std::map<std::string, unsigned long long> &callsites() {
+    static std::map<std::string, unsigned long long> c;
+    return c;
+  }
+};
+
+#endif // __ARRAY_METRICS_H__
@@ -0,0 +1,99 @@
+/// Monitor which runs in the background, off the integration path
+///
+/// Diagnostic monitors computing e.g. volume averages or spectra can
+/// stall every processor if run synchronously from the solver. An
+/// AsyncMonitor copies what it needs in snapshot() (cheap, since
+/// fields are copy-on-write), then runs asyncCall() on a helper
+/// thread whilst the solver continues integrating. At most one call
+/// is in flight: the next call (and hence anything later in the
+/// solver's monitor list, such as the output write) waits for the
+/// previous one to finish.
+///
+/// Requires MPI_THREAD_MULTIPLE if asyncCall makes MPI calls; if the
+/// MPI implementation provides less (see BoutComm::threadSafe) then
+/// the monitor falls back to running synchronously.
+
+#ifndef __ASYNC_MONITOR_H__
+#define __ASYNC_MONITOR_H__
+
+#include "monitor.hxx"
+#include "unused.hxx"
+#include <boutcomm.hxx>
+#include <bout/sys/steppipeline.hxx>
+
+#include <future>
+
+class AsyncMonitor : public Monitor {
+public:
+  /// A \p timestep_ of -1 defaults to the frequency of the BOUT++
+  /// output monitor
+  AsyncMonitor(BoutReal timestep_ = -1) : Monitor(timestep_) {}
+
+  ~AsyncMonitor() override {
+    // Can't throw from a destructor, so swallow any error from the
+    // background call
+    if (running.valid()) {
+      try {
+        running.get();
+      } catch (...) {
+      }
+    }
+  }
+
+  /// Waits for any previous background call, takes a snapshot of the
+  /// state, then dispatches asyncCall in the background.
+  ///
+  /// Note: an exception thrown by asyncCall is re-thrown here on the
+  /// following call, or in wait()
+  int call(Solver *solver, BoutReal time, int iter, int nout) final {
+    // Enforce completion of the previous call before anything from
+    // this output step is processed
+    int status = wait();
+    if (status != 0)
+      return status;
+
+    // Copy whatever fields the background call needs
+    snapshot(solver);
+
+    if (!BoutComm::threadSafe()) {
+      // MPI calls are only allowed from the main thread,
+      // so run synchronously
+      return asyncCall(solver, time, iter, nout);
+    }
+
+    running = std::async(std::launch::async, [this, solver, time, iter, nout]() {
+      StepPipeline::backgroundBegin("async monitor");
+      int ret = asyncCall(solver, time, iter, nout);
+      StepPipeline::backgroundEnd("async monitor");
+      return ret;
+    });
+    return 0;
+  }
+
+  /// Block until the background call has finished, returning its
+  /// result (0 if no call is in flight)
+  int wait() {
+    if (!running.valid())
+      return 0;
+    return running.get();
+  }
+
+  void cleanup() override { wait(); }
+
+protected:
+  /// Called on the solver thread before each dispatch. Copy any
+  /// fields needed by asyncCall into members here: field copies are
+  /// copy-on-write, so this is cheap. asyncCall must only read these
+  /// copies, since the solver modifies the evolving fields whilst the
+  /// background call runs.
+  virtual void snapshot(Solver *UNUSED(solver)) {}
+
+  /// The monitor body, run in the background. Same signature and
+  /// return convention as Monitor::call
+  virtual int asyncCall(Solver *solver, BoutReal time, int iter, int nout) = 0;
+
+private:
+  std::future<int> running; ///< The in-flight background call, if any
+};
+
+#endif // __ASYNC_MONITOR_H__
@@ -0,0 +1,166 @@
+/*!
+ * \file cached.hxx
+ *
+ * \brief Memoised operator results with dependency invalidation
+ *
+ * Physics models often evaluate the same subexpression in several
+ * equations, e.g. Grad_par(phi) appearing in three of the five
+ * equations of a reduced MHD model. Cached binds such an operator
+ * call to the generation counters of its Field3D inputs (see
+ * Field3D::getGeneration), recomputing only when an input has been
+ * modified since the last evaluation, so repeated uses within one
+ * RHS evaluation cost a few integer compares.
+ *
+ **************************************************************************
+ * Copyright 2010 B.D.Dudson, S.Farley, M.V.Umansky, X.Q.Xu
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+#ifndef __CACHED_H__
+#define __CACHED_H__
+
+#include "field3d.hxx"
+#include "bout/assert.hxx"
+
+#include <functional>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+namespace bout {
+
+/*!
+ * Shared reuse counters for every Cached instance
+ *
+ * Source and profile fields that are constant, or quasi-static
+ * (changing only on transport timescales), make their dependent
+ * Cached results hits for thousands of consecutive RHS calls — their
+ * generation counters simply stop advancing. These counters record
+ * how often that skipping happens; the root option report_cache_reuse
+ * prints the reuse fraction each output timestep and resets them, so
+ * the report shows what fraction of the wrapped RHS terms were reused
+ */
+class CacheStats {
+public:
+  static void recordHit() { counters().hits++; }
+  static void recordMiss() { counters().misses++; }
+
+  static unsigned long long hits() { return counters().hits; }
+  static unsigned long long misses() { return counters().misses; }
+
+  static void reset() {
+    counters().hits = 0;
+    counters().misses = 0;
+  }
+
+private:
+  struct Counters {
+    unsigned long long hits{0};   ///< Calls returning the cached result
+    unsigned long long misses{0}; ///< Calls that recomputed
+  };
+  /// Shared across all Cached instantiations
+  static Counters &counters() {
+    static Counters c;
+    return c;
+  }
+};
+
+/*!
+ * A memoised operator result
+ *
+ * Declared once, typically as a physics model member, with the
+ * operator call and the fields it reads:
+ *
+ *     Field3D phi, n, vort;
+ *     bout::Cached<Field3D> gradparphi{[this]() { return Grad_par(phi); },
+ *                                      {&phi}};
+ *
+ * then used like a function wherever the result is needed:
+ *
+ *     ddt(n) -= gradparphi();
+ *     ddt(vort) += gradparphi();
+ *
+ * The first call evaluates the operator; later calls return the
+ * cached result until one of the listed inputs is modified, tracked
+ * through the Field3D generation counter. List every field the
+ * callable reads: non-field inputs (metric coefficients, constants)
+ * are assumed fixed, so a cache reading something that changes
+ * outside the listed fields must be invalidate()d by hand.
+ *
+ * Quasi-static inputs need no special flagging: a source or profile
+ * field updated only on transport timescales stops advancing its
+ * counter, so results depending only on it are skipped on every RHS
+ * call until it next changes. The reuse this achieves is reported per
+ * output timestep by the report_cache_reuse option (see CacheStats).
+ */
+template <typename T = Field3D>
+class Cached {
+public:
+  /// Bind \p compute to the generation counters of \p inputs. The
+  /// pointed-to fields must outlive this object
+  Cached(std::function<T()> compute, std::initializer_list<const Field3D *> inputs)
+      : compute(std::move(compute)), inputs(inputs), seen(this->inputs.size(), 0) {
+    ASSERT1(static_cast<bool>(this->compute));
+  }
+
+  /// The operator result, recomputed only if an input changed since
+  /// the last call. The reference stays valid until the next call
+  const T &operator()() {
+    if (upToDate()) {
+      CacheStats::recordHit();
+      return value;
+    }
+    CacheStats::recordMiss();
+    value = compute();
+    for (std::vector<const Field3D *>::size_type i = 0; i < inputs.size(); i++) {
+      seen[i] = inputs[i]->getGeneration();
+    }
+    valid = true;
+    return value;
+  }
+
+  /// Would operator() return the cached result without recomputing?
+  bool upToDate() const {
+    if (!valid) {
+      return false;
+    }
+    for (std::vector<const Field3D *>::size_type i = 0; i < inputs.size(); i++) {
+      if (inputs[i]->getGeneration() != seen[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// Force recomputation on the next call, for dependencies the
+  /// generation counters can't see
+  void invalidate() { valid = false; }
+
+private:
+  std::function<T()> compute;          ///< The operator call
+  std::vector<const Field3D *> inputs; ///< Fields the callable reads
+  std::vector<unsigned int> seen;      ///< Input generations at the last evaluation
+  T value;                             ///< The cached result
+  bool valid{false};                   ///< Has value been computed at all?
+};
+
+} // namespace bout
+
+#endif // __CACHED_H__
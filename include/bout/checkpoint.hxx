@@ -0,0 +1,118 @@
+/*!
+ * \file checkpoint.hxx
+ *
+ * \brief Fast binary checkpoint/restart, bypassing the Datafile machinery
+ *
+ * Writes the registered variables as one aggregated binary stream in
+ * a single file using collective MPI-IO, with a small header and
+ * index. Intended for restart data only: unlike Datafile there is no
+ * metadata, no time history and no per-variable structure in the
+ * file, so writes are a single collective operation per checkpoint.
+ *
+ * Two files are written alternately, so an interrupted write cannot
+ * corrupt the last complete checkpoint. On restart the data is read
+ * straight back into the registered field storage, and must be read
+ * on the same number of processors as it was written.
+ *
+ **************************************************************************
+ * Copyright 2010 B.D.Dudson, S.Farley, M.V.Umansky, X.Q.Xu
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+class Checkpoint;
+
+#ifndef __CHECKPOINT_H__
+#define __CHECKPOINT_H__
+
+#include "bout_types.hxx"
+#include "options.hxx"
+
+#include <string>
+#include <vector>
+
+class Field2D;
+class Field3D;
+
+class Checkpoint {
+public:
+  Checkpoint() {}
+  /// Reads configuration from \p opt: "enabled" (default false) and
+  /// "directory" (default the "datadir" root option)
+  Checkpoint(Options *opt);
+
+  /// Is fast checkpointing turned on?
+  bool isEnabled() const { return enabled; }
+
+  /// Register variables. Like Datafile, a pointer to the variable is
+  /// kept, so it must not go out of scope
+  void add(int &value, const std::string &name);
+  void add(BoutReal &value, const std::string &name);
+  void add(Field2D &f, const std::string &name);
+  void add(Field3D &f, const std::string &name);
+
+  /// Write all registered variables as a single collective operation.
+  /// Alternates between two files, and marks the new one as latest
+  /// only once it is complete. Throws on I/O errors
+  void write();
+
+  /// True if a checkpoint file exists which could be restarted from
+  bool canRestart();
+
+  /// Read the latest complete checkpoint straight into the registered
+  /// variables. Returns false if no checkpoint exists or if it
+  /// doesn't match the registered variables and processor count, so
+  /// the caller can fall back to the Datafile restart path
+  bool read();
+
+private:
+  template <class T>
+  struct VarStr {
+    T *ptr;
+    std::string name;
+  };
+
+  bool enabled = false;
+  std::string directory; ///< Directory for checkpoint files
+
+  std::vector<VarStr<int>> int_arr;
+  std::vector<VarStr<BoutReal>> BoutReal_arr;
+  std::vector<VarStr<Field2D>> f2d_arr;
+  std::vector<VarStr<Field3D>> f3d_arr;
+
+  /// Name of checkpoint file \p index (0 or 1)
+  std::string fileName(int index) const;
+  /// Name of the marker file recording which file is the latest
+  std::string latestFileName() const;
+
+  /// Number of bytes this processor contributes
+  size_t localSize() const;
+  /// Copy registered variables to/from a contiguous buffer
+  void packVars(char *buf) const;
+  void unpackVars(const char *buf);
+
+  /// Build the header and variable table (identical on all processors)
+  std::vector<char> makeHeader() const;
+
+  /// Read one checkpoint file into the registered variables.
+  /// Returns false if the file is missing or doesn't match
+  bool readFile(const std::string &filename);
+};
+
+#endif // __CHECKPOINT_H__
@@ -37,6 +37,10 @@
 #include "utils.hxx"
 #include <bout_types.hxx>
 
+#include <map>
+#include <memory>
+#include <vector>
+
 class Mesh;
 
 /*!
@@ -53,7 +57,15 @@ public:
   Coordinates(Mesh *mesh, const CELL_LOC loc, const Coordinates* coords_in);
   
   ~Coordinates() {}
-  
+
+  // The coefficient caches below make this class move-only (they hold
+  // unique_ptrs), and the user-declared destructor suppresses the
+  // implicit moves; default them so std::swap keeps working
+  // (Mesh::recalculateStaggeredCoordinates swaps Coordinates objects)
+  Coordinates(Coordinates &&) = default;
+  Coordinates &operator=(Coordinates &&) = default;
+
+
   /*!
    * Adds variables to the output file, for post-processing
    * 
@@ -69,7 +81,53 @@ public:
   /// True if corrections for non-uniform mesh spacing should be included in operators
   bool non_uniform;
   Field2D d1_dx, d1_dy;  ///< 2nd-order correction for non-uniform meshes d/di(1/dx) and d/di(1/dy)
-  
+
+  /// Per-cell stencil coefficient tables, combining the grid spacing
+  /// with the non-uniform corrections. A first index-derivative scaled
+  /// by ddx/ddy and a second index-derivative scaled by d2dx2/d2dy2
+  /// plus a first-derivative term scaled by d2dx2_corr/d2dy2_corr give
+  /// the physical DDX/D2DX2 etc, so consumers make one fused table
+  /// read per point instead of dividing by dx and loading d1_dx
+  struct StencilCoefs {
+    StencilCoefs(Mesh *m)
+        : ddx(m), ddy(m), d2dx2(m), d2dy2(m), d2dx2_corr(m), d2dy2_corr(m) {}
+    Field2D ddx, ddy;               ///< 1/dx, 1/dy
+    Field2D d2dx2, d2dy2;           ///< 1/dx^2, 1/dy^2
+    Field2D d2dx2_corr, d2dy2_corr; ///< d1_dx/dx, d1_dy/dy (zero if uniform)
+  };
+
+  /// Lazily computed; invalidated by geometry()
+  const StencilCoefs &stencilCoefs();
+
+  /// Storage type of the packed metric records below. Define
+  /// PACKED_METRIC_SINGLE to store them in single precision, halving
+  /// the record size: the metrics are smooth equilibrium quantities,
+  /// so float resolution is usually well above the discretisation
+  /// error of the operators reading them
+#ifdef PACKED_METRIC_SINGLE
+  typedef float MetricReal;
+#else
+  typedef BoutReal MetricReal;
+#endif
+
+  /// One interleaved record per (x, y) point of the 2D coefficients
+  /// the advection operators read together. A consumer makes one
+  /// contiguous fetch per (x, y) and reuses it across the z points,
+  /// instead of walking half a dozen separate Field2D streams which
+  /// evict each other between fields. The record is 64 bytes in double
+  /// precision - one cache line - and 32 with PACKED_METRIC_SINGLE
+  struct PackedMetric {
+    MetricReal dx, dy;           ///< Grid spacing
+    MetricReal J, Bxy;           ///< Jacobian and field magnitude
+    MetricReal g_12, g_22, g_23; ///< Covariant components of b0 x Grad advection
+    MetricReal inv_J_sqrtg22;    ///< 1 / (J * sqrt(g_22)), the b0xGrad_dot_Grad divisor
+  };
+
+  /// Packed records indexed like Ind2D, i.e. record jx * LocalNy + jy
+  /// holds the coefficients at (jx, jy). Lazily built; invalidated by
+  /// geometry()
+  const PackedMetric *packedMetrics();
+
   Field2D J; ///< Coordinate system Jacobian, so volume of cell is J*dx*dy*dz
 
   Field2D Bxy; ///< Magnitude of B = nabla z times nabla x
@@ -92,7 +150,25 @@ public:
   Field2D IntShiftTorsion; ///< Integrated shear (I in BOUT notation)
 
   /// Calculate differential geometry quantities from the metric tensor
+  ///
+  /// Delta-driven: the inputs (spacings, metric components, J, Bxy)
+  /// are compared against their values at the previous call, and only
+  /// the connection terms and cached coefficient tables that depend
+  /// on a changed component are recomputed and re-communicated. A
+  /// call where nothing changed returns almost immediately, and a
+  /// transport-coupled equilibrium update pays only for what it
+  /// touched.
+  ///
+  /// Note: changes are detected by value (or shared storage), so
+  /// assign new fields to the components; mutating a component's
+  /// underlying data in place is not reliably detected.
   int geometry();
+
+  /// Incremented by geometry() whenever it finds real changes.
+  /// Consumers caching expensive derived objects (e.g. Laplacian
+  /// factorisations built from the metrics) can compare generations
+  /// instead of values to decide whether to rebuild
+  int geometryGeneration() const { return geometry_generation; }
   int calcCovariant(); ///< Inverts contravatiant metric to get covariant
   int calcContravariant(); ///< Invert covariant metric to get contravariant
   int jacobian(); ///< Calculate J and Bxy
@@ -142,9 +218,77 @@ public:
   const Field3D Laplace(const Field3D &f, CELL_LOC outloc=CELL_DEFAULT);
   
 private:
+  /// Chains Delp2 with other per-mode operations in one transform
+  /// round trip, sharing the cached Delp2 coefficients below
+  friend class SpectralPipeline;
+
   int nz; // Size of mesh in Z. This is mesh->ngz-1
   Mesh * localmesh;
   CELL_LOC location;
+
+  // Lazily computed caches of fused operator coefficients, so the hot
+  // operators stream a few precombined arrays instead of recombining
+  // the metric components per point per call. All are invalidated by
+  // geometry(), since that is where the metrics they derive from are
+  // (re)calculated.
+
+  /// Cache of 1/sqrt(g_22), used by the parallel operators
+  std::unique_ptr<Field2D> invSgCache;
+  const Field2D &invSg();
+
+  /// Cache of DDY(1/sqrt(g_22))/sqrt(g_22), the first-derivative
+  /// coefficient of Grad2_par2, keyed by the derivative method
+  std::map<DIFF_METHOD, Field2D> Grad2_par2_DDY_invSgCache;
+  const Field2D &Grad2_par2_DDY_invSg(CELL_LOC outloc, DIFF_METHOD method);
+
+  /// Cache of 1/(dy*sqrt(g_22)), the coefficient of the index-space Y
+  /// derivative in Grad_par
+  std::unique_ptr<Field2D> gradParCoefCache;
+  const Field2D &gradParCoef();
+
+  /// Fused Laplacian coefficients for Delp2: the tridiagonal
+  /// coefficients for mode kwave are
+  ///   a = (a_re, -kwave*c3), b = (b0 - kwave^2*c2, kwave*c5),
+  ///   c = (c_re, kwave*c3)
+  /// matching laplace_tridag_coefs but with the per-point metric
+  /// combination done once
+  struct Delp2Coefs {
+    Delp2Coefs(Mesh *m) : a_re(m), c_re(m), b0(m), c2(m), c3(m), c5(m) {}
+    Field2D a_re, c_re, b0, c2, c3, c5;
+  };
+  std::unique_ptr<Delp2Coefs> delp2Cache;
+  const Delp2Coefs &delp2Coefs();
+
+  /// Cache behind stencilCoefs()
+  std::unique_ptr<StencilCoefs> stencilCache;
+
+  /// Cache behind packedMetrics(); empty when invalid
+  std::vector<PackedMetric> packedCache;
+
+  /// Copies of geometry()'s inputs at the previous call, for the
+  /// delta-driven update. Each copy shares data with the component it
+  /// mirrors once found equal, so repeat comparisons are pointer
+  /// checks (the same scheme as Laplacian::updateCoefCache)
+  struct GeometryInputs {
+    GeometryInputs(Mesh *m)
+        : dx(m), dy(m), g11(m), g22(m), g33(m), g12(m), g13(m), g23(m), g_11(m),
+          g_22(m), g_33(m), g_12(m), g_13(m), g_23(m), J(m), Bxy(m) {}
+    Field2D dx, dy;
+    BoutReal dz = 0.0;
+    Field2D g11, g22, g33, g12, g13, g23;
+    Field2D g_11, g_22, g_33, g_12, g_13, g_23;
+    Field2D J, Bxy;
+  };
+  std::unique_ptr<GeometryInputs> geometry_inputs;
+
+  /// Bumped on every geometry() call that found changes; see
+  /// geometryGeneration()
+  int geometry_generation = 0;
+
+  /// Has \p val changed since the last geometry() call? Updates
+  /// \p cache to share data with \p val when they are equal, so the
+  /// next comparison short-circuits on the pointers
+  static bool updateChanged(Field2D &cache, const Field2D &val);
 };
 
 /*
@@ -0,0 +1,70 @@
+/**************************************************************************
+ * Runtime CPU dispatch for hot kernels
+ *
+ * One binary is often deployed across partitions with different vector
+ * widths (SSE2, AVX2, AVX-512), and compiling for the lowest common
+ * denominator wastes the wider units. BOUT_TARGET_CLONES compiles the
+ * annotated function once per target and the dynamic loader binds the
+ * best variant for the running CPU through the GNU indirect-function
+ * mechanism, with no change at the call sites. GCC also clones the
+ * OpenMP-outlined loop bodies, so parallel kernels keep their per-target
+ * vectorisation.
+ *
+ **************************************************************************
+ * Copyright 2018 BOUT++ contributors
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+#ifndef __CPU_DISPATCH_H__
+#define __CPU_DISPATCH_H__
+
+/// Compile the annotated function for each listed target and select at
+/// load time. Requires GCC on x86-64 ELF; elsewhere the macro is empty
+/// and the kernels are built for the configured target only. Disable
+/// explicitly with -DBOUT_NO_TARGET_CLONES
+#if defined(__GNUC__) && !defined(__clang__) && !defined(__INTEL_COMPILER) \
+    && defined(__x86_64__) && defined(__ELF__) && !defined(BOUT_NO_TARGET_CLONES)
+#define BOUT_HAS_TARGET_CLONES 1
+#define BOUT_TARGET_CLONES __attribute__((target_clones("default", "avx2", "avx512f")))
+#else
+#define BOUT_TARGET_CLONES
+#endif
+
+namespace bout {
+
+/// Which kernel variant the running CPU selects, for the startup output
+inline const char* cpuDispatchTarget() {
+#ifdef BOUT_HAS_TARGET_CLONES
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return "avx512f";
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return "avx2";
+  }
+  return "default (SSE2)";
+#else
+  return "compile-time target";
+#endif
+}
+
+} // namespace bout
+
+#endif // __CPU_DISPATCH_H__
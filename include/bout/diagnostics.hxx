@@ -0,0 +1,115 @@
+/**************************************************************************
+ * Batched scalar diagnostics, evaluated in fused mesh sweeps
+ *
+ * A DiagnosticSet collects named spatially-reduced outputs (volume
+ * averages, RMS values, extrema, surface sums) declared up front, and
+ * evaluates all of them together at each output step: one fused
+ * traversal per region plus one batched MPI resolution, instead of one
+ * sweep and one MPI_Allreduce per quantity.
+ *
+ **************************************************************************
+ * Copyright 2018 BOUT++ contributors
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+#ifndef __DIAGNOSTICS_H__
+#define __DIAGNOSTICS_H__
+
+#include "bout/monitor.hxx"
+#include "bout_types.hxx"
+
+#include <deque>
+#include <string>
+
+class Datafile;
+class Field2D;
+class Field3D;
+
+/// A set of named scalar diagnostics, each a reduction of a field over
+/// a region, evaluated together in fused mesh sweeps.
+///
+/// DiagnosticSet is a Monitor, so the usual pattern in a physics model
+/// is to declare the reductions during init, register the results with
+/// the dump file, and add the set to the solver:
+///
+///     diagnostics.add("n_mean", n, DiagnosticSet::Op::Mean);
+///     diagnostics.add("n_max", n, DiagnosticSet::Op::Max);
+///     diagnostics.add("flux_sol", flux, DiagnosticSet::Op::Sum, RGN_NOY);
+///     diagnostics.outputVars(dump);
+///     solver->addMonitor(&diagnostics);
+///
+/// At each output step the regions are each traversed once, with every
+/// field reduced during the same sweep, and the results are resolved
+/// across processors in two MPI_Allreduce calls however many
+/// diagnostics are declared. User monitors run before the BOUT++
+/// output monitor, so the values are up to date when the dump file is
+/// written.
+///
+/// The declared field references must outlive the DiagnosticSet, and
+/// every processor must declare the same diagnostics in the same order
+class DiagnosticSet : public Monitor {
+public:
+  /// How a field is reduced to a scalar. Sum is the plain sum over the
+  /// region's points: for volume integrals or surface fluxes, fold the
+  /// metric factors into the declared field
+  enum class Op { Mean, RMS, Min, Max, Sum };
+
+  /// A \p timestep_ of -1 evaluates at the frequency of the BOUT++
+  /// output monitor
+  DiagnosticSet(BoutReal timestep_ = -1) : Monitor(timestep_) {}
+
+  /// Declare a reduction of \p f over region \p rgn, output under
+  /// \p name. Throws BoutException if the name is already taken
+  void add(const std::string &name, const Field3D &f, Op op, REGION rgn = RGN_NOBNDRY);
+  void add(const std::string &name, const Field2D &f, Op op, REGION rgn = RGN_NOBNDRY);
+
+  /// Register all declared diagnostics as time-evolving scalars in
+  /// \p file. Call after the last add(): later declarations are not
+  /// picked up by the Datafile
+  void outputVars(Datafile &file);
+
+  /// Evaluate all declared diagnostics: one fused traversal per
+  /// distinct region and dimensionality, then one batched MPI
+  /// resolution. Called automatically when used as a solver monitor
+  void evaluate();
+
+  /// Get the value of diagnostic \p name from the last evaluate().
+  /// Throws BoutException for unknown names
+  BoutReal get(const std::string &name) const;
+
+  /// Monitor callback: evaluates the set
+  int call(Solver *solver, BoutReal time, int iter, int nout) override;
+
+private:
+  struct Entry {
+    std::string name;
+    const Field3D *f3; ///< One of f3, f2 is set, the other nullptr
+    const Field2D *f2;
+    Op op;
+    REGION rgn;
+    BoutReal value; ///< Result of the last evaluate()
+  };
+
+  // deque rather than vector: the Datafile keeps references to the
+  // values, so entries must not move when more are declared
+  std::deque<Entry> entries;
+};
+
+#endif // __DIAGNOSTICS_H__
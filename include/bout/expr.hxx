@@ -1,10 +1,14 @@
 /**************************************************************************
  *
  * Operators, and support for template expressions
- * 
+ *
+ * Chained Field3D / Field2D / BoutReal arithmetic built from these
+ * expression nodes is fused into a single BOUT_FOR loop when passed to
+ * eval3D, so no intermediate fields are allocated between operators.
+ *
  * Originally based on article by Klaus Kreft & Angelika Langer
  * http://www.angelikalanger.com/Articles/Cuj/ExpressionTemplates/ExpressionTemplates.htm
- * 
+ *
  * Parts adapted from Blitz++ library
  *
  **************************************************************************/
@@ -12,9 +16,13 @@
 #ifndef __EXPR_H__
 #define __EXPR_H__
 
-#include <field3d.hxx>
 #include <field2d.hxx>
+#include <field3d.hxx>
+#include <globals.hxx>
 #include <bout/mesh.hxx>
+#include <bout/region.hxx>
+
+#include <type_traits>
 
 /// Literal class to capture BoutReal values in expressions
 class Literal {
@@ -22,30 +30,49 @@ class Literal {
   typedef Literal type; ///< Type of this expression
 
   Literal(BoutReal v) : val(v) {}
-  ~Literal() {}
-  BoutReal operator()(int x, int y, int z) const {return val;}
+  BoutReal operator()(const Ind3D &) const { return val; }
+  /// Literals are not associated with any mesh or location
+  Mesh* getMesh() const { return nullptr; }
+  CELL_LOC getLocation() const { return CELL_DEFAULT; }
 private:
   const BoutReal val;
 };
 
+/// Expression node wrapping a Field3D. Holds a pointer to the field
+/// data, so the field must outlive the expression.
 class Field3DExpr {
 public:
   typedef Field3D type;
-  
-  Field3DExpr(const Field3D &f) : data(&f(0,0,0)) {}
-  const BoutReal& operator()(int x, int y, int z) const { return data[(x*mesh->LocalNy + y)*mesh->LocalNz + z]; }
+
+  Field3DExpr(const Field3D &f)
+      : data(&f(0, 0, 0)), fieldmesh(f.getMesh()), location(f.getLocation()) {}
+  const BoutReal& operator()(const Ind3D &i) const { return data[i.ind]; }
+  Mesh* getMesh() const { return fieldmesh; }
+  CELL_LOC getLocation() const { return location; }
 private:
   const BoutReal *data;
+  Mesh *fieldmesh;
+  CELL_LOC location;
 };
 
+/// Expression node wrapping a Field2D. Indexed using 3D indices, so
+/// that Field2D values are broadcast over the Z dimension without
+/// creating a Field3D temporary.
 class Field2DExpr {
 public:
   typedef Field2D type;
-  
-  Field2DExpr(const Field2D &f) : data(&f(0,0)) {}
-  const BoutReal& operator()(int x, int y, int z) const { return data[x*mesh->LocalNy + y]; }
+
+  Field2DExpr(const Field2D &f)
+      : data(&f(0, 0)), nz(f.getMesh()->LocalNz), fieldmesh(f.getMesh()),
+        location(f.getLocation()) {}
+  const BoutReal& operator()(const Ind3D &i) const { return data[i.ind / nz]; }
+  Mesh* getMesh() const { return fieldmesh; }
+  CELL_LOC getLocation() const { return location; }
 private:
   const BoutReal *data;
+  int nz;
+  Mesh *fieldmesh;
+  CELL_LOC location;
 };
 
 /// Expression traits, to convert doubles etc. to Literal
@@ -82,25 +109,31 @@ struct asExpr {
 template <>
 struct asExpr<int> {
   typedef Literal type;
-  static const Literal getExpr(const int& x) {return Literal(x);}
+  static Literal getExpr(const int& x) {return Literal(x);}
 };
 
 template <>
 struct asExpr<double> {
   typedef Literal type;
-  static const Literal getExpr(const double& x) {return Literal(x);}
+  static Literal getExpr(const double& x) {return Literal(x);}
 };
 
 template <>
 struct asExpr<float> {
   typedef Literal type;
-  static const Literal getExpr(const float& x) {return Literal(x);}
+  static Literal getExpr(const float& x) {return Literal(x);}
+};
+
+template <>
+struct asExpr<Field2D> {
+  typedef Field2DExpr type;
+  static Field2DExpr getExpr(const Field2D& x) {return Field2DExpr(x);}
 };
 
 template <>
 struct asExpr<Field3D> {
   typedef Field3DExpr type;
-  static const Field3DExpr getExpr(const Field3D& x) {return Field3DExpr(x);}
+  static Field3DExpr getExpr(const Field3D& x) {return Field3DExpr(x);}
 };
 
 /////////////////////////////////////////////////////////////
@@ -115,24 +148,36 @@ struct PromoteType {
 /////////////////////////////////////////////////////////////
 // Binary expressions
 
-template <class ExprT1, class ExprT2, class BinOp> 
-class BinaryExpr { 
+template <class ExprT1, class ExprT2, class BinOp>
+class BinaryExpr {
 public:
-  BinaryExpr(const ExprT1 &e1, const ExprT2 &e2) 
+  BinaryExpr(const ExprT1 &e1, const ExprT2 &e2)
     : _expr1(e1),_expr2(e2) {
   }
-  
+
   // Work out the type of the inputs
   typedef typename exprTraits<ExprT1>::expr_type ltype;
   typedef typename exprTraits<ExprT2>::expr_type rtype;
-  
+
   /// Type of the resulting expression
   typedef typename PromoteType<ltype, rtype>::type type;
-  
-  BoutReal operator()(int x, int y, int z) const {
-    return BinOp::apply((_expr1)(x,y,z),(_expr2)(x,y,z));
+
+  BoutReal operator()(const Ind3D &i) const {
+    return BinOp::apply((_expr1)(i), (_expr2)(i));
+  }
+
+  /// The mesh of the first field operand found, or nullptr if the
+  /// expression contains only literals
+  Mesh* getMesh() const {
+    Mesh* m = _expr1.getMesh();
+    return (m != nullptr) ? m : _expr2.getMesh();
+  }
+
+  CELL_LOC getLocation() const {
+    CELL_LOC loc = _expr1.getLocation();
+    return (loc != CELL_DEFAULT) ? loc : _expr2.getLocation();
   }
-  
+
 private:
   ltype const _expr1;
   rtype const _expr2;
@@ -161,9 +206,9 @@ DEFINE_BINARY_OP(Multiply,*)
 DEFINE_BINARY_OP(Divide,/)
 
 struct Power {
-  template<typename T> 
+  template<typename T>
   static inline T apply(T a, T b) {
-    return pow(a, b); 
+    return pow(a, b);
   }
 };
 
@@ -178,18 +223,87 @@ struct Power {
 
 /// Addition of two Expressions
 DEFINE_OVERLOAD_FUNC(Add, add);
+/// Subtraction of two Expressions
+DEFINE_OVERLOAD_FUNC(Subtract, sub);
 /// Multiplication of two Expressions
 DEFINE_OVERLOAD_FUNC(Multiply, mul);
+/// Division of two Expressions
+DEFINE_OVERLOAD_FUNC(Divide, div);
+
+/// Identify expression nodes, so that operator overloads below don't
+/// clash with the eager Field operators in generated_fieldops.cxx
+template <typename T>
+struct isFieldExpr : std::false_type {};
 
-/// A function to evaluate expressions
+template <>
+struct isFieldExpr<Literal> : std::true_type {};
+
+template <>
+struct isFieldExpr<Field3DExpr> : std::true_type {};
+
+template <>
+struct isFieldExpr<Field2DExpr> : std::true_type {};
+
+template <typename E1, typename E2, typename Op>
+struct isFieldExpr<BinaryExpr<E1, E2, Op>> : std::true_type {};
+
+/// Infix operators on expressions. Only enabled when at least one
+/// operand is already an expression node; plain Field arithmetic is
+/// unaffected.
+#define DEFINE_EXPR_OP(name, op)                                                         \
+  template <typename ExprT1, typename ExprT2>                                            \
+  typename std::enable_if<isFieldExpr<ExprT1>::value || isFieldExpr<ExprT2>::value,      \
+                          typename BinaryResult<ExprT1, ExprT2, name>::type>::type       \
+  operator op(const ExprT1 &e1, const ExprT2 &e2) {                                     \
+    typedef typename BinaryResult<ExprT1, ExprT2, name>::type type;                      \
+    return type(asExpr<ExprT1>::getExpr(e1), asExpr<ExprT2>::getExpr(e2));               \
+  }
+
+DEFINE_EXPR_OP(Add, +)
+DEFINE_EXPR_OP(Subtract, -)
+DEFINE_EXPR_OP(Multiply, *)
+DEFINE_EXPR_OP(Divide, /)
+
+/// Convert a field or BoutReal into an expression node, for use with
+/// the infix operators above
+template <typename T>
+typename asExpr<T>::type expr(const T &x) {
+  return asExpr<T>::getExpr(x);
+}
+
+/// Evaluate an expression into an existing Field3D. The whole
+/// expression is computed in a single BOUT_FOR loop with no
+/// intermediate temporaries.
 template<typename Expr>
-const Field3D eval3D(Expr e) {
-  Field3D result;
+void eval3D(const Expr &e, Field3D &result, const std::string &rgn = "RGN_ALL") {
+  Mesh *localmesh = e.getMesh();
+  if (localmesh == nullptr) {
+    // Expression contains only literals
+    localmesh = mesh;
+  }
+
+  if (result.getMesh() != localmesh) {
+    result = Field3D(localmesh);
+  }
   result.allocate();
-  for(int i=0;i<mesh->LocalNx;i++)
-    for(int j=0;j<mesh->LocalNy;j++)
-      for(int k=0;k<mesh->LocalNz;k++)
-	result(i,j,k) = e(i,j,k);
+
+  BOUT_FOR(i, localmesh->getRegion3D(rgn)) {
+    result[i] = e(i);
+  }
+
+  CELL_LOC loc = e.getLocation();
+  if (loc != CELL_DEFAULT) {
+    result.setLocation(loc);
+  }
+
+  checkData(result);
+}
+
+/// A function to evaluate expressions, returning a new Field3D
+template<typename Expr>
+const Field3D eval3D(const Expr &e, const std::string &rgn = "RGN_ALL") {
+  Field3D result;
+  eval3D(e, result, rgn);
   return result;
 }
 
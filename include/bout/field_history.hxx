@@ -0,0 +1,124 @@
+/**************************************************************************
+ * In-memory ring buffer of past values of a Field3D, for time-delayed
+ * physics terms (e.g. wall recycling models needing f(t - tau)).
+ *
+ * Samples are recorded with their simulation time and retrieved at an
+ * arbitrary delay by linear interpolation between the two bracketing
+ * samples. Storage can be compressed: single precision halves the
+ * footprint, and keeping only the lowest z Fourier modes gives a
+ * tunable further factor of ~LocalNz / (2*zmodes).
+ *
+ **************************************************************************
+ * Copyright 2018 B.D.Dudson
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+class FieldHistory;
+
+#ifndef __FIELD_HISTORY_H__
+#define __FIELD_HISTORY_H__
+
+#include "bout/array.hxx"
+#include "dcomplex.hxx"
+#include "field3d.hxx"
+
+#include <vector>
+
+class Options;
+
+/*!
+ * Ring buffer of past Field3D values with interpolated retrieval
+ *
+ * Example
+ * -------
+ *
+ *     FieldHistory nhist(mesh, 128);       // 128 samples, single precision
+ *
+ *     // Each timestep:
+ *     nhist.record(n, time);
+ *     Field3D ndelayed = nhist.get(tau);   // n at (time - tau)
+ *
+ * The retrieved field has no valid guard cells; communicate it and
+ * apply boundary conditions if derivatives of it are needed.
+ */
+class FieldHistory {
+public:
+  /// @param[in] mesh  The mesh the recorded fields live on
+  /// @param[in] nsamples  Number of past samples kept; older ones are overwritten
+  /// @param[in] single_precision  Store samples as float rather than BoutReal
+  /// @param[in] zmodes  If > 0, keep only the lowest \p zmodes z Fourier
+  ///                    modes of each sample (z-spectral truncation)
+  /// @param[in] max_memory_mb  If > 0, throw at construction if the ring
+  ///                    would exceed this many megabytes
+  FieldHistory(Mesh *mesh, int nsamples, bool single_precision = true,
+               int zmodes = 0, BoutReal max_memory_mb = 0.0);
+
+  /// Construct from an options section with keys nsamples (default 16),
+  /// single_precision (true), zmodes (0) and max_memory_mb (0)
+  FieldHistory(Mesh *mesh, Options *opt);
+
+  /// Record a sample of \p f at simulation time \p time, overwriting
+  /// the oldest sample if the ring is full. Times must be increasing
+  void record(const Field3D &f, BoutReal time);
+
+  /// The field at time (latest - \p delay), linearly interpolated
+  /// between the two bracketing samples. A delay of zero (or less)
+  /// returns the most recent sample. Throws if the delay reaches
+  /// beyond the oldest stored sample
+  const Field3D get(BoutReal delay) const;
+
+  /// Number of samples currently stored
+  int size() const { return count; }
+
+  /// The largest retrievable delay, i.e. latest time minus oldest time.
+  /// Zero if fewer than two samples are stored
+  BoutReal maxDelay() const;
+
+  /// Memory used by the ring, in bytes
+  size_t getBytes() const { return static_cast<size_t>(nsamples) * sample_bytes; }
+
+private:
+  /// One recorded sample in compressed form; which array is used
+  /// depends on the precision and truncation settings
+  struct Sample {
+    BoutReal time;
+    CELL_LOC location;
+    Array<BoutReal> raw_d;  ///< Full values, double
+    Array<float> raw_f;     ///< Full values, single
+    Array<dcomplex> spec_d; ///< Truncated z spectrum, double
+    Array<float> spec_f;    ///< Truncated z spectrum, single (interleaved re,im)
+  };
+
+  void compress(const Field3D &f, Sample &s);
+  const Field3D decompress(const Sample &s) const;
+
+  Mesh *localmesh;
+  int nsamples;
+  bool single_precision;
+  int zmodes;
+
+  size_t sample_bytes; ///< Storage per sample
+
+  std::vector<Sample> ring;
+  int head{0};  ///< Index the next sample is written to
+  int count{0}; ///< Number of valid samples
+};
+
+#endif // __FIELD_HISTORY_H__
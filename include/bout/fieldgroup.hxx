@@ -21,7 +21,11 @@ class FieldGroup {
  public:
   FieldGroup() {}
 
-  FieldGroup(const FieldGroup &other) : fvec(other.fvec), f3vec(other.f3vec) {}
+  FieldGroup(const FieldGroup &other)
+      : fvec(other.fvec), f3vec(other.f3vec), halo_depth(other.halo_depth),
+        single_prec(other.single_prec) {}
+
+  FieldGroup &operator=(const FieldGroup &other) = default;
 
   /// Constructor with a single FieldData \p f
   FieldGroup(FieldData &f) { fvec.push_back(&f); }
@@ -165,7 +169,27 @@ class FieldGroup {
   }
 
   /// Remove all fields from this group
-  void clear() {fvec.clear(); f3vec.clear(); }
+  void clear() {fvec.clear(); f3vec.clear(); halo_depth = 0; single_prec = false; }
+
+  /// Declare how many guard cells the stencils reading these fields
+  /// actually need. Communication then ships only that depth; most
+  /// fields feed 2nd-order (1-cell) stencils and only the few feeding
+  /// 4th-order stencils need the full width. 0 (the default) means the
+  /// full configured MXG/MYG depth
+  void setHaloDepth(int depth) { halo_depth = depth; }
+
+  /// Guard cell depth this group's communication ships; 0 means the
+  /// full configured depth
+  int getHaloDepth() const { return halo_depth; }
+
+  /// Exchange these fields' guard cells as single precision (float),
+  /// halving the bytes on the wire. Suitable when the halo values
+  /// only feed low-order stencils; the fields themselves stay full
+  /// precision, only the messages are converted
+  void setSinglePrecision(bool single = true) { single_prec = single; }
+
+  /// Are guard cells exchanged as single precision?
+  bool getSinglePrecision() const { return single_prec; }
 
   /// Iteration over all fields
   typedef std::vector<FieldData*>::iterator iterator;
@@ -199,6 +223,9 @@ class FieldGroup {
  private:
   std::vector<FieldData*> fvec;  // Vector of fields
   std::vector<Field3D*>   f3vec; // Vector of 3D fields
+
+  int halo_depth{0}; // Guard cell depth to communicate; 0 = full depth
+  bool single_prec{false}; // Exchange guard cells as float?
 };
 
 /// Combine two FieldGroups
@@ -0,0 +1,156 @@
+/*!
+ * \file fieldstats.hxx
+ *
+ * \brief Running time-statistics of fields, accumulated every timestep
+ *
+ * Turbulence statistics (means, RMS fluctuation levels, covariances)
+ * computed in post-processing need high-cadence dumps of the full
+ * fields. Accumulating them on the compute ranks instead needs only
+ * O(1) storage per statistic: registered fields are folded into
+ * weighted running sums at every internal timestep, and the reduced
+ * moments are written through the normal Datafile at output cadence,
+ * so the dump rate can be set by restart needs rather than statistics.
+ *
+ * Each statistic costs one fused pass over the field per internal
+ * step, reading the field once and updating all of its accumulators
+ * together.
+ *
+ **************************************************************************
+ * Copyright 2010 B.D.Dudson, S.Farley, M.V.Umansky, X.Q.Xu
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+class FieldStats;
+
+#ifndef __FIELDSTATS_H__
+#define __FIELDSTATS_H__
+
+#include "bout_types.hxx"
+#include "field3d.hxx"
+#include "options.hxx"
+
+#include "bout/array.hxx"
+
+#include <list>
+#include <string>
+
+class Datafile;
+class Solver;
+
+/*!
+ * Accumulates running time-averages of registered fields and writes
+ * the reduced moments through Datafile. Usage, e.g. in
+ * PhysicsModel::init:
+ *
+ *     stats = FieldStats(Options::getRoot()->getSection("stats"));
+ *     stats.addMean(Vi, "Vi");            // Vi_mean
+ *     stats.addRMS(Ni, "Ni");             // Ni_mean, Ni_rms
+ *     stats.addCovariance(Ni, phi, "Ni_phi"); // Ni_phi_cov
+ *     stats.outputVars(dump);
+ *     stats.enable(solver); // Accumulate every internal timestep
+ *
+ * Samples are weighted by the timestep, so the moments are time
+ * averages independent of how the solver subdivides the interval. By
+ * default the accumulators reset after each output write, making every
+ * dump record the average over one output interval; set
+ * reset_on_write=false for cumulative averages since the start of the
+ * run. The first record is written before any timestep has been taken
+ * and holds zeros.
+ */
+class FieldStats {
+public:
+  FieldStats() {}
+  /// Reads configuration from \p opt: "enabled" (default true) and
+  /// "reset_on_write" (default true), whether the accumulators restart
+  /// from zero after each output step
+  FieldStats(Options *opt);
+  FieldStats(FieldStats &&other) noexcept;
+  ~FieldStats();
+
+  FieldStats& operator=(FieldStats &&rhs) noexcept;
+  FieldStats& operator=(const FieldStats &rhs) = delete;
+
+  /// Register statistics of \p f, written under names derived from
+  /// \p name as listed below. Like Datafile, a pointer to the field is
+  /// kept, so it must not go out of scope. Register all statistics
+  /// before calling outputVars()
+  void addMean(const Field3D &f, const std::string &name); ///< <name>_mean
+  /// <name>_mean and <name>_rms, the RMS fluctuation about the mean
+  void addRMS(const Field3D &f, const std::string &name);
+  /// <name>_cov, the covariance <f g> - <f><g>
+  void addCovariance(const Field3D &f, const Field3D &g, const std::string &name);
+
+  /// Add the reduced moment fields to \p file as time-evolving
+  /// variables
+  void outputVars(Datafile &file);
+
+  /// Start accumulating: fold the registered fields into the running
+  /// sums at every internal timestep, and finalise the moments just
+  /// before each output write. Does nothing if not enabled or if no
+  /// statistics are registered
+  void enable(Solver *solver);
+
+  /// Stop accumulating
+  void disable(Solver *solver);
+
+  /// Fold the current field values into the running sums with weight
+  /// \p dt. Called from the solver's timestep monitor
+  void accumulate(BoutReal dt);
+
+  /// Convert the running sums into the moment fields registered with
+  /// outputVars(), then reset the sums if configured to. Called from
+  /// the output monitor, before the dump file is written
+  void finalise();
+
+private:
+  bool enabled{true};
+  bool reset_on_write{true};
+
+  enum class StatType { Mean, RMS, Covariance };
+
+  /// One registered statistic: the source field(s), the weighted
+  /// running sums, and the moment fields written to the output file
+  struct Stat {
+    StatType type;
+    const Field3D *f;
+    const Field3D *g; ///< Covariance only, else nullptr
+    std::string name;
+
+    // Weighted sums, allocated on the first accumulation
+    Array<BoutReal> sf;  ///< sum dt*f
+    Array<BoutReal> sff; ///< sum dt*f*f (RMS)
+    Array<BoutReal> sg;  ///< sum dt*g   (Covariance)
+    Array<BoutReal> sfg; ///< sum dt*f*g (Covariance)
+
+    // Outputs. Only those the statistic needs are registered
+    Field3D mean, rms, cov;
+  };
+
+  /// In a std::list so that the pointers Datafile keeps to the moment
+  /// fields stay valid as statistics are added
+  std::list<Stat> stats;
+
+  BoutReal total_time{0.0}; ///< Sum of the accumulation weights
+
+  /// One fused pass updating all of \p s's sums from its field(s)
+  void accumulateStat(Stat &s, BoutReal dt);
+};
+
+#endif // __FIELDSTATS_H__
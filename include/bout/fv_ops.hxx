@@ -114,14 +114,13 @@ namespace FV {
      * If the inputs have different signs then
      * returns zero, otherwise chooses the value
      * with the minimum magnitude.
+     *
+     * Branchless formulation (as in MINMOD in utils.hxx): the sign
+     * factor is zero when the signs differ, so this evaluates to the
+     * same result as testing the signs explicitly, but vectorises
      */
     BoutReal _minmod(BoutReal a, BoutReal b) {
-      if( a*b <= 0.0 )
-        return 0.0;
-      
-      if(fabs(a) < fabs(b))
-        return a;
-      return b;
+      return 0.5 * (SIGN(a) + SIGN(b)) * BOUTMIN(fabs(a), fabs(b));
     }
   };
 
@@ -144,14 +143,15 @@ namespace FV {
   private:
     // Return zero if any signs are different
     // otherwise return the value with the minimum magnitude
+    //
+    // Branchless formulation: each (SIGN + SIGN) factor is zero when
+    // the corresponding pair of signs differ, and +/-2 otherwise, so
+    // the prefactor is SIGN(a) when all three signs agree and zero
+    // otherwise. Evaluates to the same result as testing the signs
+    // explicitly, but vectorises
     BoutReal minmod(BoutReal a, BoutReal b, BoutReal c) {
-      // if any of the signs are different, return zero gradient
-      if ((a * b <= 0.0) || (a * c <= 0.0)) {
-        return 0.0;
-      }
-
-      // Return the minimum absolute value
-      return SIGN(a) * BOUTMIN(fabs(a), fabs(b), fabs(c));
+      BoutReal sign = 0.25 * (SIGN(a) + SIGN(b)) * (SIGN(a) + SIGN(c)) * SIGN(a);
+      return sign * BOUTMIN(fabs(a), fabs(b), fabs(c));
     }
   };
   
@@ -198,7 +198,12 @@ namespace FV {
 
     for (int i = mesh->xstart; i <= mesh->xend; i++) {
 
-      if (!mesh->firstY(i) || mesh->periodicY(i)) {
+      // Domain boundary predicates, hoisted out of the inner loops
+      bool yperiodic = mesh->periodicY(i);
+      bool has_lower_boundary = !yperiodic && mesh->firstY(i);
+      bool has_upper_boundary = !yperiodic && mesh->lastY(i);
+
+      if (!has_lower_boundary) {
         // Calculate in guard cell to get fluxes consistent between processors
         ys = mesh->ystart - 1;
       } else {
@@ -207,7 +212,7 @@ namespace FV {
         ys = mesh->ystart;
       }
 
-      if (!mesh->lastY(i) || mesh->periodicY(i)) {
+      if (!has_upper_boundary) {
         // Calculate in guard cells
         ye = mesh->yend + 1;
       } else {
@@ -216,6 +221,9 @@ namespace FV {
       }
 
       for (int j = ys; j <= ye; j++) {
+        // Whether this row's faces are on the domain boundary
+        bool lower_boundary = has_lower_boundary && (j == mesh->ystart);
+        bool upper_boundary = has_upper_boundary && (j == mesh->yend);
         // Pre-calculate factors which multiply fluxes
 
         // For right cell boundaries
@@ -254,7 +262,7 @@ namespace FV {
           BoutReal vpar = 0.5 * (v(i, j, k) + v(i, j + 1, k));
           BoutReal flux;
 
-          if (mesh->lastY(i) && (j == mesh->yend) && !mesh->periodicY(i)) {
+          if (upper_boundary) {
             // Last point in domain
 
             BoutReal bndryval = 0.5 * (s.c + s.p);
@@ -266,20 +274,16 @@ namespace FV {
               flux = s.R * vpar + wave_speed(i, j, k) * (s.R - bndryval);
             }
           } else {
-            
+
             // Maximum wave speed in the two cells
             BoutReal amax = BOUTMAX(wave_speed(i, j, k), wave_speed(i, j + 1, k));
 
-            if (vpar > amax) {
-              // Supersonic flow out of this cell
-              flux = s.R * vpar;
-            } else if (vpar < -amax) {
-              // Supersonic flow into this cell
-              flux = 0.0;
-            } else {
-              // Subsonic flow, so a mix of right and left fluxes
-              flux = s.R * 0.5 * (vpar + amax);
-            }
+            // Branchless form of the upwind flux selection: the
+            // largest of {vpar, (vpar + amax)/2, 0} is vpar for
+            // supersonic flow out of this cell (vpar > amax), zero for
+            // supersonic flow in (vpar < -amax), and the subsonic mix
+            // of right and left fluxes in between
+            flux = s.R * BOUTMAX(vpar, 0.5 * (vpar + amax), 0.0);
           }
           
           result(i, j, k) += flux * flux_factor_rc;
@@ -290,7 +294,7 @@ namespace FV {
           
           vpar = 0.5 * (v(i, j, k) + v(i, j - 1, k));
 
-          if (mesh->firstY(i) && (j == mesh->ystart) && !mesh->periodicY(i)) {
+          if (lower_boundary) {
             // First point in domain
             BoutReal bndryval = 0.5 * (s.c + s.m);
             if (fixflux) {
@@ -301,19 +305,14 @@ namespace FV {
               flux = s.L * vpar - wave_speed(i, j, k) * (s.L - bndryval);
             }
           } else {
-            
+
             // Maximum wave speed in the two cells
             BoutReal amax = BOUTMAX(wave_speed(i, j, k), wave_speed(i, j - 1, k));
 
-            if (vpar < -amax) {
-              // Supersonic out of this cell
-              flux = s.L * vpar;
-            } else if (vpar > amax) {
-              // Supersonic into this cell
-              flux = 0.0;
-            } else {
-              flux = s.L * 0.5 * (vpar - amax);
-            }
+            // Mirror image of the right-boundary selection: vpar for
+            // supersonic flow out (vpar < -amax), zero for supersonic
+            // flow in, the subsonic mix in between
+            flux = s.L * BOUTMIN(vpar, 0.5 * (vpar - amax), 0.0);
           }
           
           result(i, j, k) -= flux * flux_factor_lc;
@@ -11,6 +11,9 @@ class GlobalField2D;
 
 #include "mesh.hxx"
 
+#include <functional>
+#include <vector>
+
 /*!
  * This provides a method for gathering and scattering a field
  * which takes into account the local and global indices
@@ -64,6 +67,11 @@ protected:
   void proc_origin(int proc, int *x, int *y, int *z = nullptr) const;
   /// Return the array size of processor proc
   void proc_size(int proc, int *lx, int *ly, int *lz = nullptr) const;
+
+  /// Per-processor block lengths and offsets (in BoutReals) into the
+  /// packed global buffer, as passed to MPI_Gatherv / MPI_Scatterv.
+  /// Filled by the derived class constructors
+  std::vector<int> counts, displs;
 };
 
 /*!
@@ -126,11 +134,31 @@ public:
   /// Is the data valid and on this processor?
   bool valid() const override { return data_valid; }
 
-  /// Gather all data onto one processor
+  /// Gather all data onto one processor.
+  /// A collective operation, implemented with MPI_Gatherv
   void gather(const Field2D &f);
-  /// Scatter data back from one to many processors
+  /// Scatter data back from one to many processors.
+  /// A collective operation, implemented with MPI_Scatterv
   const Field2D scatter() const;
-  
+
+  /// Consumes one processor's block of a streamed gather. Called with
+  /// the block's global origin and size, and the packed block data
+  /// indexed [x*ysize + y]
+  typedef std::function<void(int xorig, int yorig, int xsize, int ysize,
+                             const BoutReal *block)>
+      BlockConsumer;
+
+  /// Stream the field through \p consumer on the gathering processor,
+  /// one processor's block at a time.
+  ///
+  /// Unlike gather() this never assembles the global field: the
+  /// gathering processor needs memory for just one block, so
+  /// diagnostics that reduce the data (spectra, flux surface
+  /// averages) can run at resolutions where a full gather would run
+  /// out of memory. A collective operation; the consumer is only
+  /// called on the gathering processor, and valid() is unaffected
+  void gatherBlocks(const Field2D &f, const BlockConsumer &consumer);
+
   /// Assignment from a 2D field. Shorthand for a gather, and must be called on all processors
   /// The scatter assignment operator needs to be a member of Field2D.
   GlobalField2D& operator=(const Field2D &rhs) {
@@ -146,10 +174,15 @@ protected:
   
 private:
 
-  /// Buffer for sending and receiving. First index
-  /// is the processor index, and second is the data
-  BoutReal** buffer;
-  
+  /// This processor's block, packed [x*ysize + y]
+  mutable Array<BoutReal> sendbuf;
+  /// All blocks packed end to end, in processor order at offsets
+  /// displs. Only allocated on the gathering processor
+  mutable Array<BoutReal> recvbuf;
+
+  /// Pack the local part of \p f into \p dest
+  void packLocal(const Field2D &f, BoutReal *dest) const;
+
   /// The length of message (in BoutReals) to
   /// be sent to or from processor \p proc
   ///
@@ -222,10 +255,30 @@ public:
   /// Test if the data is valid i.e. has been allocated
   bool valid() const override { return data_valid; }
 
-  /// Gather all data onto one processor
+  /// Gather all data onto one processor.
+  /// A collective operation, implemented with MPI_Gatherv
   void gather(const Field3D &f);
-  /// Scatter data back from one to many processors
+  /// Scatter data back from one to many processors.
+  /// A collective operation, implemented with MPI_Scatterv
   const Field3D scatter() const;
+
+  /// Consumes one processor's block of a streamed gather. Called with
+  /// the block's global origin and size, and the packed block data
+  /// indexed [x*ysize*zsize + y*zsize + z]
+  typedef std::function<void(int xorig, int yorig, int xsize, int ysize, int zsize,
+                             const BoutReal *block)>
+      BlockConsumer;
+
+  /// Stream the field through \p consumer on the gathering processor,
+  /// one processor's block at a time.
+  ///
+  /// Unlike gather() this never assembles the global field: the
+  /// gathering processor needs memory for just one block, so
+  /// diagnostics that reduce the data (spectra, flux surface
+  /// averages) can run at resolutions where a full gather would run
+  /// out of memory. A collective operation; the consumer is only
+  /// called on the gathering processor, and valid() is unaffected
+  void gatherBlocks(const Field3D &f, const BlockConsumer &consumer);
   
   /// Assignment from a 2D field. Shorthand for a gather, and must be called on all processors
   /// The scatter assignment operator needs to be a member of Field2D.
@@ -238,9 +291,14 @@ protected:
   
 private:
 
-  /// Buffer for sending and receiving. First index
-  /// is the processor index, and second is the data
-  BoutReal** buffer; 
+  /// This processor's block, packed [x*ysize*zsize + y*zsize + z]
+  mutable Array<BoutReal> sendbuf;
+  /// All blocks packed end to end, in processor order at offsets
+  /// displs. Only allocated on the gathering processor
+  mutable Array<BoutReal> recvbuf;
+
+  /// Pack the local part of \p f into \p dest
+  void packLocal(const Field3D &f, BoutReal *dest) const;
 
   /// The length of message (in BoutReals) to
   /// be sent to or from processor \p proc
@@ -93,6 +93,21 @@ private:
   std::unique_ptr<DataFormat> file;
   string filename;
 
+  /// When set (mesh:broadcast_read), metadata and variables are read
+  /// by processor 0 only and broadcast, so large runs do not hammer
+  /// the filesystem with identical reads from every processor
+  bool broadcast_read{false};
+  int mype{0}; ///< This processor's rank in BoutComm
+
+  /// Variable dimensions, read on processor 0 and broadcast when
+  /// broadcast_read is set
+  std::vector<int> varSize(const string &name);
+
+  /// Rank-0 read plus broadcast of a whole 2D variable, with each
+  /// processor slicing out its own part. Used by get(Field2D) when
+  /// broadcast_read is set
+  bool getField2DBroadcast(Mesh *m, Field2D &var, const string &name, BoutReal def);
+
   bool readgrid_3dvar_fft(Mesh *m, const string &name, int yread, int ydest, int ysize,
                           int xge, int xlt, Field3D &var);
 
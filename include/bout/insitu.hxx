@@ -0,0 +1,144 @@
+/*!
+ * \file insitu.hxx
+ *
+ * \brief In-situ analysis of fields on the compute ranks
+ *
+ * Analysis plugins registered with a PhysicsModel run at output
+ * cadence, on the processors holding the data. Plugins get read-only
+ * access to the registered field storage (no copies are made), and
+ * can write reduced results through a dedicated small Datafile, so
+ * diagnostics which would otherwise need the full 3D dumps can be
+ * computed without writing them.
+ *
+ * Everything is rank-local: a plugin sees this processor's part of
+ * each field, and any global reductions it needs are its own
+ * responsibility. The framework adds no barriers beyond those implied
+ * by writing the analysis file.
+ *
+ **************************************************************************
+ * Copyright 2010 B.D.Dudson, S.Farley, M.V.Umansky, X.Q.Xu
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+class InSitu;
+class InSituAnalysis;
+
+#ifndef __INSITU_H__
+#define __INSITU_H__
+
+#include "bout_types.hxx"
+#include "datafile.hxx"
+#include "options.hxx"
+#include "unused.hxx"
+
+#include <string>
+#include <vector>
+
+class Field2D;
+class Field3D;
+
+/// Base class for in-situ analysis plugins
+///
+/// Subclass this and register with InSitu::addAnalysis. The analyse()
+/// method is called at every output step on every compute rank, after
+/// the state has been written to the dump file.
+class InSituAnalysis {
+public:
+  virtual ~InSituAnalysis() {}
+
+  /// Called once when the analysis file is opened, before the first
+  /// analyse() call. Reduced output variables should be added to
+  /// insitu.dump() here
+  virtual void init(InSitu &UNUSED(insitu)) {}
+
+  /// Analyse the registered fields at an output time
+  ///
+  /// @param[in] insitu  Access to the registered fields, via field3d()/field2d()
+  /// @param[in] time    The current simulation time
+  /// @param[in] iter    The current output iteration
+  ///
+  /// @returns non-zero if the simulation should be stopped
+  virtual int analyse(const InSitu &insitu, BoutReal time, int iter) = 0;
+};
+
+/// Runs registered analysis plugins at output cadence
+///
+/// Owned by PhysicsModel; models expose fields with addField() and
+/// register plugins with addAnalysis() during init(). Field access is
+/// zero-copy: only a pointer to the field is stored, so the plugin
+/// reads the same storage the solver evolves.
+class InSitu {
+public:
+  InSitu() {}
+  /// Reads configuration from \p opt: "enabled" (default false)
+  InSitu(Options *opt);
+
+  /// Is in-situ analysis turned on?
+  bool isEnabled() const { return enabled; }
+
+  /// Expose a field to analysis plugins under \p name. A pointer to
+  /// the field is kept, so it must not go out of scope
+  void addField(const Field2D &f, const std::string &name);
+  void addField(const Field3D &f, const std::string &name);
+
+  /// Register an analysis plugin. A pointer is kept, so the plugin
+  /// must outlive this object; it is not deleted here
+  void addAnalysis(InSituAnalysis *analysis);
+
+  /// Look up a registered field by name. Throws BoutException if no
+  /// field of that type was registered under \p name
+  const Field2D &field2d(const std::string &name) const;
+  const Field3D &field3d(const std::string &name) const;
+
+  /// The analysis output file, for reduced results. Variables should
+  /// be added in InSituAnalysis::init(); the file is written after
+  /// the plugins have run at each output step
+  Datafile &dump() { return analysis_file; }
+
+  /// Open the analysis file and initialise the plugins. Called once
+  /// by PhysicsModel::postInit(); does nothing if not enabled or if
+  /// no plugins are registered
+  void initialise();
+
+  /// Run all plugins, then write the analysis file. Called by the
+  /// output monitor after each dump write
+  ///
+  /// @returns non-zero if any plugin requests a stop
+  int run(BoutReal time, int iter);
+
+private:
+  template <class T>
+  struct FieldStr {
+    const T *ptr;
+    std::string name;
+  };
+
+  bool enabled = false;
+  bool initialised = false;
+
+  std::vector<FieldStr<Field2D>> f2d_arr;
+  std::vector<FieldStr<Field3D>> f3d_arr;
+
+  std::vector<InSituAnalysis *> analyses;
+
+  Datafile analysis_file; ///< Small dedicated file for reduced results
+};
+
+#endif // __INSITU_H__
@@ -56,6 +56,9 @@ class LaplaceXY {
   const Field2D solve(const Field2D &UNUSED(rhs), const Field2D &UNUSED(x0)) {
     throw BoutException("LaplaceXY requires PETSc. No LaplaceXY available");
   }
+  const Field2D solve(const Field2D &UNUSED(rhs)) {
+    throw BoutException("LaplaceXY requires PETSc. No LaplaceXY available");
+  }
 };
 
 #else // BOUT_HAS_PETSC
@@ -101,6 +104,15 @@ public:
    */
   const Field2D solve(const Field2D &rhs, const Field2D &x0);
 
+  /*!
+   * Solve Laplacian in X-Y, warm-starting from the previous solution
+   *
+   * Uses the result of the last solve as the initial guess, which
+   * converges in few iterations when called once per timestep and the
+   * solution changes slowly. The first call starts from zero.
+   */
+  const Field2D solve(const Field2D &rhs);
+
   /*!
    * Preconditioner function
    * This is called by PETSc via a static function.
@@ -133,7 +145,14 @@ private:
 
   // Location of the rhs and solution
   CELL_LOC location;
-  
+
+  bool coefs_set;   ///< Has setCoefs been called? Pattern frozen after the first call
+  int reuse_limit;  ///< How many setCoefs calls can reuse the preconditioner?
+  int reuse_count;  ///< How many times has it been reused?
+
+  Field2D last_solution;   ///< Result of the previous solve, for warm-starting
+  bool have_last_solution; ///< Has a solve completed yet?
+
   /*!
    * Number of grid points on this processor
    */
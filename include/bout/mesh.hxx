@@ -186,6 +186,20 @@ class Mesh {
   bool sourceHasVar(const string &name);
   
   // Communications
+
+  /// Guard cell regions, for communications which fill only some of
+  /// the guard cells. Combine with "|" to select several regions;
+  /// the same selection must be made on all processors
+  enum CommDir {
+    COMM_XIN   = 1, ///< Inner (low) X guard cells
+    COMM_XOUT  = 2, ///< Outer (high) X guard cells
+    COMM_YDOWN = 4, ///< Lower (low) Y guard cells
+    COMM_YUP   = 8, ///< Upper (high) Y guard cells
+    COMM_X = COMM_XIN | COMM_XOUT,   ///< Both X boundaries
+    COMM_Y = COMM_YDOWN | COMM_YUP,  ///< Both Y boundaries
+    COMM_ALL = COMM_X | COMM_Y       ///< The full guard region
+  };
+
   /*!
    * Communicate a list of FieldData objects
    * Uses a variadic template (C++11) to pack all
@@ -203,21 +217,102 @@ class Mesh {
     communicateXZ(g);
   }
 
+  /// Communicate guard cells in Y only, for quantities (e.g. flux
+  /// diagnostics) whose stencils need no X neighbours
+  template <typename... Ts>
+  void communicateY(Ts&... ts) {
+    FieldGroup g(ts...);
+    communicateY(g);
+  }
+
   /*!
    * Communicate a group of fields
    */
   void communicate(FieldGroup &g);
 
+  /// Communicate only the guard regions selected by \p dirs, a
+  /// combination of the CommDir flags. Fields needing only
+  /// boundary-adjacent values (e.g. a flux through one target) can
+  /// exchange a single boundary instead of the full halo.
+  ///
+  /// @param g     The group of fields to communicate
+  /// @param dirs  Which guard regions to fill, e.g. COMM_YUP | COMM_YDOWN.
+  ///              Must be the same on all processors
+  void communicate(FieldGroup &g, int dirs);
+
   /// Communcate guard cells in XZ only
   /// i.e. no Y communication
   ///
   /// @param g  The group of fields to communicate. Guard cells will be modified
   void communicateXZ(FieldGroup &g);
 
+  /// Communicate guard cells in Y only. Parallel slices (yup/ydown)
+  /// are updated; X guard cells are left unchanged
+  ///
+  /// @param g  The group of fields to communicate
+  void communicateY(FieldGroup &g);
+
   /*!
    * Communicate an X-Z field
    */
-  void communicate(FieldPerp &f); 
+  void communicate(FieldPerp &f);
+
+  /*!
+   * Begin a halo exchange without waiting for it to finish, so that
+   * interior work can overlap with communication. Must be completed
+   * with a matching communicateEnd() call, which waits for the data
+   * and updates parallel slices (yup/ydown).
+   *
+   * The regions "RGN_INTERIOR" and "RGN_RIM" split RGN_NOBNDRY into
+   * points whose width-one stencils are independent of the
+   * communicated guard cells, and those that need them, so kernels
+   * can be evaluated on RGN_INTERIOR between the two calls:
+   *
+   *     comm_handle h = mesh->communicateBegin(f);
+   *     // ... compute on mesh->getRegion3D("RGN_INTERIOR") ...
+   *     mesh->communicateEnd(h);
+   *     // ... compute on mesh->getRegion3D("RGN_RIM") ...
+   */
+  template <typename... Ts>
+  comm_handle communicateBegin(Ts&... ts) {
+    FieldGroup g(ts...);
+    return communicateBegin(g);
+  }
+
+  /// Begin communicating a group of fields without blocking.
+  /// See communicateBegin(Ts&...) for details
+  comm_handle communicateBegin(FieldGroup &g);
+
+  /// Finish a halo exchange started with communicateBegin()
+  void communicateEnd(comm_handle handle);
+
+  /*!
+   * Deferred communication: accumulate fields to communicate later,
+   * then exchange all of them with a single packed message per
+   * neighbour when flushDeferred() is called. Useful when an RHS
+   * function communicates several small groups: deferring them and
+   * flushing once pays the message latency once per direction rather
+   * than once per group.
+   *
+   * Example
+   * -------
+   *     mesh->communicateDeferred(f);    // No MPI yet
+   *     mesh->communicateDeferred(g, h);
+   *     mesh->flushDeferred();           // One exchange for f, g and h
+   */
+  template <typename... Ts>
+  void communicateDeferred(Ts&... ts) {
+    FieldGroup g(ts...);
+    communicateDeferred(g);
+  }
+
+  /// Add a group of fields to the deferred communication.
+  /// See communicateDeferred(Ts&...) for details
+  void communicateDeferred(FieldGroup &g);
+
+  /// Exchange all fields accumulated by communicateDeferred() in a
+  /// single communication. Does nothing if no fields are deferred
+  void flushDeferred();
 
   /*!
    * Send a list of FieldData objects
@@ -235,7 +330,15 @@ class Mesh {
   ///
   /// \param g Group of fields to communicate
   /// \returns handle to be used as input to wait()
-  virtual comm_handle send(FieldGroup &g) = 0;  
+  virtual comm_handle send(FieldGroup &g) = 0;
+
+  /// As send(FieldGroup&), but exchange only the guard regions
+  /// selected by \p dirs (CommDir flags). The default implementation
+  /// communicates the full halo, which fills the requested regions
+  /// (and more); implementations override this to skip the messages
+  /// for unselected boundaries
+  virtual comm_handle send(FieldGroup &g, int UNUSED(dirs)) { return send(g); }
+
   virtual int wait(comm_handle handle) = 0; ///< Wait for the handle, return error code
 
   // non-local communications
@@ -292,6 +395,20 @@ class Mesh {
   /// @param[in] tag     A label for the communication. Must be the same at receive
   virtual int sendXIn(BoutReal *buffer, int size, int tag) = 0;
 
+  /// Non-blocking version of sendXOut. The send proceeds in the
+  /// background; \p buffer must stay valid until the returned handle
+  /// has been waited on
+  ///
+  /// @param[in] buffer  The data to send. Must be at least length \p size
+  /// @param[in] size    The number of BoutReals to send
+  /// @param[in] tag     A label for the communication. Must be the same at receive
+  /// @returns A handle to pass to wait(), or nullptr if there is no
+  ///          processor at X index +1
+  virtual comm_handle isendXOut(BoutReal *buffer, int size, int tag) = 0;
+
+  /// Non-blocking version of sendXIn; see isendXOut
+  virtual comm_handle isendXIn(BoutReal *buffer, int size, int tag) = 0;
+
   /// Receive a buffer of data from X index +1
   ///
   /// @param[in] buffer  A buffer to put the data in. Must already be allocated of length \p size
@@ -472,20 +589,33 @@ class Mesh {
   /// First derivative in X direction, in index space
   const Field3D indexDDX(const Field3D &f, CELL_LOC outloc, DIFF_METHOD method,
                          REGION region=RGN_NOBNDRY);
+  /// First derivative in X direction, in index space, restricted to a named region
+  const Field3D indexDDX(const Field3D &f, CELL_LOC outloc, DIFF_METHOD method,
+                         const std::string &region);
   /// First derivative in X direction, in index space
   const Field2D indexDDX(const Field2D &f, CELL_LOC outloc = CELL_DEFAULT,
                          DIFF_METHOD method = DIFF_DEFAULT,
                          REGION region= RGN_NOBNDRY);
+  const Field2D indexDDX(const Field2D &f, CELL_LOC outloc, DIFF_METHOD method,
+                         const std::string &region);
   /// First derivative in Y direction in index space
   const Field3D indexDDY(const Field3D &f, CELL_LOC outloc, DIFF_METHOD method,
                          REGION region=RGN_NOBNDRY);
+  /// First derivative in Y direction in index space, restricted to a named region
+  const Field3D indexDDY(const Field3D &f, CELL_LOC outloc, DIFF_METHOD method,
+                         const std::string &region);
   /// First derivative in Y direction in index space
   const Field2D indexDDY(const Field2D &f, CELL_LOC outloc = CELL_DEFAULT,
                          DIFF_METHOD method = DIFF_DEFAULT,
                          REGION region=RGN_NOBNDRY);
+  const Field2D indexDDY(const Field2D &f, CELL_LOC outloc, DIFF_METHOD method,
+                         const std::string &region);
   /// First derivative in Z direction in index space
   const Field3D indexDDZ(const Field3D &f, CELL_LOC outloc, DIFF_METHOD method,
                          REGION region=RGN_NOBNDRY);
+  /// First derivative in Z direction in index space, restricted to a named region
+  const Field3D indexDDZ(const Field3D &f, CELL_LOC outloc, DIFF_METHOD method,
+                         const std::string &region);
   const Field3D indexDDZ(const Field3D &f, CELL_LOC outloc, DIFF_METHOD method,
                          bool inc_xbndry) {
     return indexDDZ(f, outloc, method, inc_xbndry? RGN_NOY : RGN_NOBNDRY);
@@ -506,10 +636,15 @@ class Mesh {
   /// @param[in] region  The region of the grid for which the result is calculated.
   const Field3D indexD2DX2(const Field3D &f, CELL_LOC outloc, DIFF_METHOD method,
                            REGION region=RGN_NOBNDRY);
+  /// Second derivative in X direction in index space, restricted to a named region
+  const Field3D indexD2DX2(const Field3D &f, CELL_LOC outloc, DIFF_METHOD method,
+                           const std::string &region);
   /// Second derivative in X direction in index space
   const Field2D indexD2DX2(const Field2D &f, CELL_LOC outloc = CELL_DEFAULT,
                            DIFF_METHOD method = DIFF_DEFAULT,
                            REGION region=RGN_NOBNDRY);
+  const Field2D indexD2DX2(const Field2D &f, CELL_LOC outloc, DIFF_METHOD method,
+                           const std::string &region);
 
   /// Second derivative in Y direction in index space
   ///
@@ -519,10 +654,72 @@ class Mesh {
   /// @param[in] region  The region of the grid for which the result is calculated.
   const Field3D indexD2DY2(const Field3D &f, CELL_LOC outloc, DIFF_METHOD method,
                            REGION region=RGN_NOBNDRY);
+  /// Second derivative in Y direction in index space, restricted to a named region
+  const Field3D indexD2DY2(const Field3D &f, CELL_LOC outloc, DIFF_METHOD method,
+                           const std::string &region);
   /// Second derivative in Y direction in index space
   const Field2D indexD2DY2(const Field2D &f, CELL_LOC outloc = CELL_DEFAULT,
                            DIFF_METHOD method = DIFF_DEFAULT,
                            REGION region=RGN_NOBNDRY);
+  const Field2D indexD2DY2(const Field2D &f, CELL_LOC outloc, DIFF_METHOD method,
+                           const std::string &region);
+
+  /// Fused first and second Y derivative in index space, combined as
+  ///
+  /// \f[
+  ///    c_1 \frac{df}{di} + c_2 \frac{d^2 f}{di^2}
+  /// \f]
+  ///
+  /// in a single sweep over \p f, using the default differencing
+  /// methods. Used by composite parallel operators such as Grad2_par2
+  /// so that the field is read once and one output written
+  ///
+  /// @param[in] f   The field to be differentiated
+  /// @param[in] c1  Axisymmetric coefficient of the first derivative
+  /// @param[in] c2  Axisymmetric coefficient of the second derivative
+  /// @param[in] outloc  The cell location where the result is desired.
+  ///                    Must match the location of \p f; staggering is not supported
+  /// @param[in] region  The region of the grid for which the result is calculated.
+  const Field3D indexDDY_D2DY2(const Field3D &f, const Field2D &c1, const Field2D &c2,
+                               CELL_LOC outloc = CELL_DEFAULT,
+                               REGION region = RGN_NOBNDRY);
+
+  /// First Y derivative in index space multiplied by an axisymmetric
+  /// coefficient in the same sweep, using the default differencing
+  /// method. Equivalent to indexDDY(f, outloc) * coef but with one
+  /// pass over \p f and one output written instead of a derivative
+  /// sweep followed by scaling sweeps. Unlike the other fused kernels
+  /// this supports the CELL_CENTRE <-> CELL_YLOW staggers allowed by
+  /// indexDDY, applying the staggered stencil directly so no separate
+  /// interpolation pass is needed. Used by Grad_par
+  ///
+  /// @param[in] f     The field to be differentiated
+  /// @param[in] coef  Axisymmetric coefficient, at \p outloc
+  /// @param[in] outloc  The cell location where the result is desired
+  /// @param[in] region  The region of the grid for which the result is calculated.
+  const Field3D indexDDY_scaled(const Field3D &f, const Field2D &coef,
+                                CELL_LOC outloc = CELL_DEFAULT,
+                                REGION region = RGN_NOBNDRY);
+
+  /// Compute the first derivatives in x, y and z in index space in a
+  /// single traversal of \p f, sharing the loaded neighbourhood
+  /// between the three stencils. Equivalent to separate calls to
+  /// indexDDX, indexDDY and indexDDZ with the default methods, but
+  /// with roughly one read of \p f instead of three. Staggering is
+  /// not supported: the results are at the location of \p f, and
+  /// callers wanting staggered output should use the separate calls.
+  /// If the default z method is FFT, the z derivative keeps its own
+  /// sweep and only x and y are fused.
+  ///
+  /// @param[in]  f    The field to be differentiated
+  /// @param[out] ddx  Derivative in X, in index space
+  /// @param[out] ddy  Derivative in Y, in index space
+  /// @param[out] ddz  Derivative in Z, in index space
+  /// @param[in]  outloc  The cell location where the result is desired.
+  ///                     Must match the location of \p f
+  /// @param[in]  region  The region of the grid for which the result is calculated.
+  void indexGradAll(const Field3D &f, Field3D &ddx, Field3D &ddy, Field3D &ddz,
+                    CELL_LOC outloc = CELL_DEFAULT, REGION region = RGN_NOBNDRY);
 
   /// Second derivative in Z direction in index space
   ///
@@ -532,6 +729,9 @@ class Mesh {
   /// @param[in] region  The region of the grid for which the result is calculated.
   const Field3D indexD2DZ2(const Field3D &f, CELL_LOC outloc,
                            DIFF_METHOD method, REGION region);
+  /// Second derivative in Z direction in index space, restricted to a named region
+  const Field3D indexD2DZ2(const Field3D &f, CELL_LOC outloc,
+                           DIFF_METHOD method, const std::string &region);
   const Field3D indexD2DZ2(const Field3D &f, CELL_LOC outloc,
                            DIFF_METHOD method, bool inc_xbndry) {
     return indexD2DZ2(f,outloc, method, inc_xbndry ? RGN_NOY : RGN_NOBNDRY);
@@ -620,6 +820,19 @@ class Mesh {
                           DIFF_METHOD method, REGION region=RGN_NOBNDRY);
   const Field3D indexFDDY(const Field3D &v, const Field3D &f, CELL_LOC outloc,
                           DIFF_METHOD method, REGION region=RGN_NOBNDRY);
+  /// Fused flux derivative in the Y direction in index space, with the
+  /// field scaled inside the stencil and the result scaled on the way out:
+  ///
+  /// \f[
+  ///    r \frac{d}{di}\left( v s f \right)
+  /// \f]
+  ///
+  /// where \p fscale (s) and \p rscale (r) must be axisymmetric. Used
+  /// by Div_par_flux to avoid materialising the scaled field and its
+  /// yup/ydown slices
+  const Field3D indexFDDY(const Field3D &v, const Field3D &f, const Field2D &fscale,
+                          const Field2D &rscale, CELL_LOC outloc, DIFF_METHOD method,
+                          REGION region=RGN_NOBNDRY);
   const Field3D indexFDDZ(const Field3D &v, const Field3D &f, CELL_LOC outloc,
                           DIFF_METHOD method, REGION region=RGN_NOBNDRY);
   /// Derivative functions of a single field stencil
@@ -638,6 +851,14 @@ class Mesh {
     return getParallelTransform().fromFieldAligned(f);
   }
 
+  /// In-place versions, avoiding the allocation of a result field
+  void toFieldAlignedInPlace(Field3D &f) {
+    getParallelTransform().toFieldAlignedInPlace(f);
+  }
+  void fromFieldAlignedInPlace(Field3D &f) {
+    getParallelTransform().fromFieldAlignedInPlace(f);
+  }
+
   bool canToFromFieldAligned() {
     return getParallelTransform().canToFromFieldAligned();
   }
@@ -694,6 +915,55 @@ class Mesh {
   void addRegion2D(const std::string &region_name, const Region<Ind2D> &region);
   void addRegionPerp(const std::string &region_name, const Region<IndPerp> &region);
 
+  /// Register a new region derived from two already-registered regions
+  /// by set algebra: the union (duplicates removed), intersection or
+  /// difference of regions \p a and \p b is stored under \p region_name.
+  /// The result is block-optimized at registration, so physics models
+  /// can precompute masked iteration sets (e.g. "closed field lines
+  /// minus X-point neighbourhood") once instead of branching per point
+  /// every timestep.
+  ///
+  /// Throws if \p region_name already exists, or \p a or \p b do not
+  void addRegionUnion3D(const std::string &region_name, const std::string &a,
+                        const std::string &b);
+  void addRegionUnion2D(const std::string &region_name, const std::string &a,
+                        const std::string &b);
+  void addRegionUnionPerp(const std::string &region_name, const std::string &a,
+                          const std::string &b);
+  void addRegionIntersection3D(const std::string &region_name, const std::string &a,
+                               const std::string &b);
+  void addRegionIntersection2D(const std::string &region_name, const std::string &a,
+                               const std::string &b);
+  void addRegionIntersectionPerp(const std::string &region_name, const std::string &a,
+                                 const std::string &b);
+  void addRegionDifference3D(const std::string &region_name, const std::string &a,
+                             const std::string &b);
+  void addRegionDifference2D(const std::string &region_name, const std::string &a,
+                             const std::string &b);
+  void addRegionDifferencePerp(const std::string &region_name, const std::string &a,
+                               const std::string &b);
+
+  /// Trimmed regions for communication-avoiding sub-stages:
+  /// RGN_NOBNDRY shrunk by \p depth points in x and y (z is periodic
+  /// locally, so z is not trimmed). With halos exchanged \p k stencil
+  /// widths deep, sub-stage s of an explicit scheme can be evaluated
+  /// with purely local data over the region shrunk by s widths, since
+  /// each stage invalidates one more halo layer. Registered as
+  /// "RGN_SHRUNK_<depth>" on first use, so the name can also be
+  /// passed to any API taking a region string. Throws if the trimmed
+  /// region would be empty
+  const Region<Ind3D> &getRegionShrunk3D(int depth);
+  const Region<Ind2D> &getRegionShrunk2D(int depth);
+
+  /// Communication-avoiding sub-stage counter, set by solvers
+  /// stepping in communication-avoiding mode (see rk3ssp's
+  /// comm_avoiding option) and 0 otherwise. A cooperating model's RHS
+  /// exchanges full-depth halos only when the stage is 0, and
+  /// evaluates its stencils over getRegionShrunk3D(stage * width)
+  /// where width is its stencil half-width
+  int getCommAvoidStage() const { return comm_avoid_stage; }
+  void setCommAvoidStage(int stage) { comm_avoid_stage = stage; }
+
   /// Converts an Ind2D to an Ind3D using calculation
   Ind3D ind2Dto3D(const Ind2D &ind2D, int jz = 0) { return {ind2D.ind * LocalNz + jz, LocalNy, LocalNz}; }
 
@@ -748,30 +1018,94 @@ protected:
   void derivs_init(Options* options);
   
   /// Loop over mesh, applying a stencil in the X direction
+  /// Each comes in two flavours: one taking the REGION enum, and one
+  /// taking the name of a region registered with addRegion2D/addRegion3D,
+  /// so that evaluation can be restricted to a user-defined subset of
+  /// the domain
   const Field2D applyXdiff(const Field2D &var, deriv_func func,
                            CELL_LOC loc = CELL_DEFAULT,
                            REGION region = RGN_NOBNDRY);
+  const Field2D applyXdiff(const Field2D &var, deriv_func func,
+                           CELL_LOC loc, const std::string &region);
 
   const Field3D applyXdiff(const Field3D &var, deriv_func func,
                            CELL_LOC loc = CELL_DEFAULT,
                            REGION region = RGN_NOBNDRY);
+  const Field3D applyXdiff(const Field3D &var, deriv_func func,
+                           CELL_LOC loc, const std::string &region);
 
   const Field2D applyYdiff(const Field2D &var, deriv_func func,
                            CELL_LOC loc = CELL_DEFAULT,
                            REGION region = RGN_NOBNDRY);
+  const Field2D applyYdiff(const Field2D &var, deriv_func func,
+                           CELL_LOC loc, const std::string &region);
 
   const Field3D applyYdiff(const Field3D &var, deriv_func func,
                            CELL_LOC loc = CELL_DEFAULT,
                            REGION region = RGN_NOBNDRY);
+  const Field3D applyYdiff(const Field3D &var, deriv_func func,
+                           CELL_LOC loc, const std::string &region);
 
   const Field3D applyZdiff(const Field3D &var, Mesh::deriv_func func,
                            CELL_LOC loc = CELL_DEFAULT,
                            REGION region = RGN_NOBNDRY);
+  const Field3D applyZdiff(const Field3D &var, Mesh::deriv_func func,
+                           CELL_LOC loc, const std::string &region);
+
+  /// Two-pass derivative evaluation, for overlapping computation with
+  /// communication. The Interior variant computes on the widest region
+  /// whose stencils do not read guard cells still being filled by an
+  /// in-flight communicateBegin() ("RGN_XINTERIOR"/"RGN_YINTERIOR"),
+  /// leaving the rest of \p result unset; after communicateEnd() the
+  /// Shell variant fills the remaining halo-adjacent points
+  /// ("RGN_XRIM"/"RGN_YRIM"):
+  ///
+  ///     comm_handle h = mesh->communicateBegin(f);
+  ///     Field3D d = mesh->applyXdiffInterior(f, fDDX);
+  ///     mesh->communicateEnd(h);
+  ///     mesh->applyXdiffShell(d, f, fDDX);
+  ///
+  /// Z is periodic within each processor, so Z derivatives never read
+  /// communicated data: applyZdiffInterior covers all of RGN_NOBNDRY
+  /// and applyZdiffShell does nothing. They exist so that code generic
+  /// over the direction can treat all three uniformly
+  const Field2D applyXdiffInterior(const Field2D &var, deriv_func func,
+                                   CELL_LOC loc = CELL_DEFAULT);
+  void applyXdiffShell(Field2D &result, const Field2D &var, deriv_func func,
+                       CELL_LOC loc = CELL_DEFAULT);
+  const Field3D applyXdiffInterior(const Field3D &var, deriv_func func,
+                                   CELL_LOC loc = CELL_DEFAULT);
+  void applyXdiffShell(Field3D &result, const Field3D &var, deriv_func func,
+                       CELL_LOC loc = CELL_DEFAULT);
+  const Field2D applyYdiffInterior(const Field2D &var, deriv_func func,
+                                   CELL_LOC loc = CELL_DEFAULT);
+  void applyYdiffShell(Field2D &result, const Field2D &var, deriv_func func,
+                       CELL_LOC loc = CELL_DEFAULT);
+  const Field3D applyYdiffInterior(const Field3D &var, deriv_func func,
+                                   CELL_LOC loc = CELL_DEFAULT);
+  void applyYdiffShell(Field3D &result, const Field3D &var, deriv_func func,
+                       CELL_LOC loc = CELL_DEFAULT);
+  const Field3D applyZdiffInterior(const Field3D &var, deriv_func func,
+                                   CELL_LOC loc = CELL_DEFAULT);
+  void applyZdiffShell(Field3D &result, const Field3D &var, deriv_func func,
+                       CELL_LOC loc = CELL_DEFAULT);
 
 private:
   /// Allocates default Coordinates objects
   std::shared_ptr<Coordinates> createDefaultCoordinates(const CELL_LOC location);
 
+  /// Groups with a communication in flight, started by
+  /// communicateBegin(). Keyed on the comm_handle so that
+  /// communicateEnd() can update parallel slices of the right fields
+  std::map<comm_handle, FieldGroup> pending_groups;
+
+  /// Fields accumulated by communicateDeferred(), exchanged
+  /// together by the next flushDeferred() call
+  FieldGroup deferred_comms;
+
+  /// Current communication-avoiding sub-stage, see getCommAvoidStage()
+  int comm_avoid_stage{0};
+
   //Internal region related information
   std::map<std::string, Region<Ind3D>> regionMap3D;
   std::map<std::string, Region<Ind2D>> regionMap2D;
@@ -0,0 +1,97 @@
+/*!
+ * \file offload.hxx
+ *
+ * \brief Opt-in OpenMP target offload backend for field kernels
+ *
+ * Define BOUT_USE_OPENMP_OFFLOAD (and compile with OpenMP target
+ * support, e.g. -fopenmp -foffload=<target>) to lower selected field
+ * kernels to "omp target" device loops. Without the flag everything
+ * here compiles away and the usual host paths are taken, so the
+ * backend is selected per build target.
+ *
+ * This is a first version for benchmarking the approach: kernels map
+ * their operands to the device per launch, covering the pointwise
+ * field functions and the Z index-derivative stencils, whose data
+ * never needs MPI. Device-resident Array storage with transfers only
+ * at the communicate() and Datafile boundaries is the follow-up that
+ * removes the per-kernel traffic.
+ *
+ **************************************************************************
+ * Copyright 2010 B.D.Dudson, S.Farley, M.V.Umansky, X.Q.Xu
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+#ifndef __BOUT_OFFLOAD_H__
+#define __BOUT_OFFLOAD_H__
+
+#include "field3d.hxx"
+#include "unused.hxx"
+#include "bout/openmpwrap.hxx"
+
+/// Wrapper for "#pragma omp target ..." directives, analogous to
+/// BOUT_OMP: expands to nothing unless offload is selected, so the
+/// loop it decorates falls back to plain host code
+#if defined(BOUT_USE_OPENMP_OFFLOAD) && defined(_OPENMP)
+#define BOUT_OFFLOAD(...) _Pragma(INDIRECT2(__VA_ARGS__))
+#else
+#define BOUT_OFFLOAD(...)
+#endif
+
+namespace bout {
+
+/// True if this build lowers the supported kernels to device loops
+inline constexpr bool offloadEnabled() {
+#ifdef BOUT_USE_OPENMP_OFFLOAD
+  return true;
+#else
+  return false;
+#endif
+}
+
+#ifdef BOUT_USE_OPENMP_OFFLOAD
+/// Evaluate result[i] = op(f[i]) on the device. Only the whole
+/// contiguous field can be mapped as one span, so regions other than
+/// RGN_ALL return false and the caller takes its host path
+template <typename Op>
+bool offloadPointwise(Field3D &result, const Field3D &f, REGION rgn, Op op) {
+  if (rgn != RGN_ALL)
+    return false;
+
+  const int n = f.getNx() * f.getNy() * f.getNz();
+  const BoutReal *in = &f(0, 0, 0);
+  BoutReal *out = &result(0, 0, 0);
+
+  BOUT_OFFLOAD(target teams distribute parallel for map(to: in[0:n]) map(from: out[0:n]))
+  for (int i = 0; i < n; ++i) {
+    out[i] = op(in[i]);
+  }
+  return true;
+}
+#else
+template <typename Op>
+inline bool offloadPointwise(Field3D &UNUSED(result), const Field3D &UNUSED(f),
+                             REGION UNUSED(rgn), Op UNUSED(op)) {
+  return false; // Constant-folds the host path in
+}
+#endif
+
+} // namespace bout
+
+#endif // __BOUT_OFFLOAD_H__
@@ -44,6 +44,12 @@ public:
   /// into standard form
   virtual const Field3D fromFieldAligned(const Field3D &f) = 0;
 
+  /// In-place versions of the above, for callers which do not need the
+  /// original field afterwards. Implementations can override these to
+  /// transform \p f without allocating a result field
+  virtual void toFieldAlignedInPlace(Field3D &f) { f = toFieldAligned(f); }
+  virtual void fromFieldAlignedInPlace(Field3D &f) { f = fromFieldAligned(f); }
+
   virtual bool canToFromFieldAligned() = 0;
 };
 
@@ -117,6 +123,13 @@ public:
    */
   const Field3D fromFieldAligned(const Field3D &f) override;
 
+  /*!
+   * In-place variants: transform the field's own data, avoiding the
+   * allocation of a result field.
+   */
+  void toFieldAlignedInPlace(Field3D &f) override;
+  void fromFieldAlignedInPlace(Field3D &f) override;
+
   bool canToFromFieldAligned() override{
     return true;
   }
@@ -131,6 +144,7 @@ private:
   Field2D zShift;
   std::vector<dcomplex> cmplx; ///< A temporary array, used for input/output to fft routines
   std::vector<dcomplex> cmplxLoc; ///< A temporary array, used for input/output to fft routines
+  std::vector<dcomplex> cmplxAll; ///< A temporary array for the batched whole-field transforms
 
   arr3Dvec toAlignedPhs; ///< Cache of phase shifts for transforming from X-Z orthogonal coordinates to field-aligned coordinates
   arr3Dvec fromAlignedPhs; ///< Cache of phase shifts for transforming from field-aligned coordinates to X-Z orthogonal coordinates
@@ -138,6 +152,55 @@ private:
   arr3Dvec yupPhs; ///< Cache of phase shifts for calculating yup fields
   arr3Dvec ydownPhs; ///< Cache of phase shifts for calculating ydown fields
 
+  /// Real-space shift mode, selected by realspace=true in the
+  /// [shiftedmetric] options section: the shifts are applied by
+  /// Lagrange interpolation along z with weights precomputed per
+  /// (x, y), instead of an FFT round trip per transform. The shift
+  /// depends only on (x, y), so each pencil costs order
+  /// multiply-adds per point; much cheaper than the two FFTs when the
+  /// shift is smooth enough for the interpolation order to resolve
+  /// (small fractions of the z period). realspace_order (default 4)
+  /// sets the stencil width, and realspace_check=true compares the
+  /// first transform against the spectral path and reports the
+  /// maximum difference
+  bool realspace_shift{false};
+  int interp_order{4};        ///< Points in the Lagrange stencil
+  bool check_spectral{false}; ///< Cross-check first transform against FFT path
+  bool checked{false};        ///< Cross-check already done?
+
+  /// Precomputed real-space shift: for each (x, y) pencil, the
+  /// integer z offset of the stencil and interp_order Lagrange
+  /// weights, indexed jx * LocalNy + jy
+  struct ZShiftInterp {
+    std::vector<int> offset;
+    std::vector<BoutReal> weights;
+  };
+
+  ZShiftInterp toAlignedInterp, fromAlignedInterp;
+  ZShiftInterp yupInterp, ydownInterp;
+
+  /// Offset and Lagrange weights interpolating a pencil shifted by
+  /// \p angle (in z radians), written to \p offset and \p w
+  /// (length interp_order)
+  void interpWeights(BoutReal angle, int &offset, BoutReal *w);
+
+  /// Build the per-(x, y) table for a shift of \p sign * the angle
+  /// field used by the corresponding phase table. \p ys / \p ye bound
+  /// the y indices shifted; outside them the table is the identity
+  ZShiftInterp makeInterpTable(int ys, int ye, int ydir, BoutReal sign);
+
+  /// out[jz] = the input pencil interpolated at jz + offset + frac,
+  /// wrapping periodically in z
+  void shiftZInterpPencil(const BoutReal *in, int offset, const BoutReal *w,
+                          BoutReal *out);
+
+  /// Real-space counterparts of the shiftZ variants. \p phs is the
+  /// matching phase table, used only for the one-off spectral
+  /// cross-check
+  const Field3D shiftZInterp(const Field3D &f, const ZShiftInterp &tab,
+                             const arr3Dvec &phs);
+  void shiftZInterpInPlace(Field3D &f, const ZShiftInterp &tab);
+
   /*!
    * Shift a 2D field in Z. 
    * Since 2D fields are constant in Z, this has no effect
@@ -164,6 +227,15 @@ private:
    */
   const Field3D shiftZ(const Field3D &f, const arr3Dvec &phs);
 
+  /*!
+   * As shiftZ(const Field3D&, const arr3Dvec&), but transforming the
+   * field's own data so no result field is allocated.
+   *
+   * @param[inout] f  The field to shift
+   * @param[in] phs  The phase to shift by
+   */
+  void shiftZInPlace(Field3D &f, const arr3Dvec &phs);
+
   /*!
    * Shift a given 1D array, assumed to be in Z, by the given \p zangle
    *
@@ -180,8 +252,9 @@ private:
    * @param[in] in  A 1D array of length mesh.LocalNz
    * @param[in] phs Phase shift, assumed to have length (mesh.LocalNz/2 + 1) i.e. the number of modes
    * @param[out] out  A 1D array of length mesh.LocalNz, already allocated
+   * @param[in] zlimit  If >= 0, the highest mode number kept; higher modes are zeroed
    */
-  void shiftZ(const BoutReal *in, const std::vector<dcomplex> &phs, BoutReal *out);
+  void shiftZ(const BoutReal *in, const std::vector<dcomplex> &phs, BoutReal *out, int zlimit = -1);
 };
 
 
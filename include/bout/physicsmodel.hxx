@@ -39,10 +39,15 @@ class PhysicsModel;
 
 #include <bout.hxx>
 #include <options.hxx>
+#include "checkpoint.hxx"
 #include <msg_stack.hxx>
 #include "solver.hxx"
 #include "unused.hxx"
+#include "bout/insitu.hxx"     // Analysis plugins running on the compute ranks
 #include "bout/macro_for_each.hxx"
+#include "bout/reductions.hxx" // One-pass field reductions and batched monitor diagnostics
+#include "bout/rhsgraph.hxx"   // Declarative RHS pipeline with comm/compute overlap
+#include "bout/taskgroup.hxx"
 /*!
   Base class for physics models
  */
@@ -215,6 +220,13 @@ protected:
   void setSplitOperator(bool split=true) {splitop = split;}
 
   /// Specify a preconditioner function
+  ///
+  /// The function approximately solves (I - \p gamma J) x = b, where J
+  /// is the Jacobian of the rhs function. On entry the system state is
+  /// in the evolving fields and the vector b is in the ddt() fields;
+  /// the result x should be put back into the ddt() fields. Every
+  /// implicit solver implementation routes its preconditioner solve
+  /// through this function when solver option use_precon is set.
   void setPrecon(preconfunc pset) {userprecon = pset;}
 
   /// Specify a Jacobian-vector multiply function
@@ -241,7 +253,22 @@ protected:
   void bout_solve(Vector3D &var, const char *name);
 
   /// Stores the state for restarting
-  Datafile restart; 
+  Datafile restart;
+
+  /// Fast binary checkpointing of the state, enabled by the
+  /// "checkpoint" options section. When enabled this replaces the
+  /// restart file writes
+  Checkpoint checkpoint;
+
+  /// Save the state for restarting, using the fast binary checkpoint
+  /// engine if enabled, otherwise the restart file
+  void writeRestartFile();
+
+  /// In-situ analysis, enabled by the "insitu" options section. Models
+  /// expose fields with insitu.addField() and register plugins with
+  /// insitu.addAnalysis() during init(); the plugins then run at output
+  /// cadence with zero-copy read access to the fields
+  InSitu insitu;
 
   /*!
    * Specify a constrained variable \p var, which will be
@@ -263,8 +290,12 @@ protected:
     PhysicsModelMonitor() = delete;
     PhysicsModelMonitor(PhysicsModel *model) : model(model) {}
     int call(Solver* UNUSED(solver), BoutReal simtime, int iter, int nout) {
-      // Save state to restart file
-      model->restart.write();
+      // Save state for restarting
+      model->writeRestartFile();
+      // Run any in-situ analysis plugins on the freshly output state
+      int ret = model->insitu.run(simtime, iter);
+      if (ret != 0)
+        return ret;
       // Call user output monitor
       return model->outputMonitor(simtime, iter, nout);
     }
@@ -282,6 +313,79 @@ private:
   bool initialised; ///< True if model already initialised
 };
 
+//////////////////////////////////////////////////////////////////
+// Compile-time model specialization
+//
+// Model switches which are fixed for the whole run (electromagnetic
+// on/off, 2D/3D, staggering, ...) are often tested inside rhs() on
+// every evaluation. Making them template parameters instead lets the
+// compiler treat them as constants: dead branches are removed and
+// the remaining code inlines freely.
+//
+// Usage: write the model as a class template over bool parameters,
+//
+//   template <bool electromagnetic, bool threeD>
+//   class MyModel : public PhysicsModel {
+//     int rhs(BoutReal t) override {
+//       ...
+//       if (electromagnetic) { ... } // Resolved at compile time
+//       ...
+//     }
+//   };
+//
+// and declare the switches in the main() macro:
+//
+//   BOUTMAIN_SPECIALIZED(MyModel, {"electromagnetic", true}, {"threeD", true});
+//
+// All combinations are instantiated at compile time; the one matching
+// the input options (read from the [model] section, with the given
+// defaults) is created at startup.
+
+namespace bout {
+
+/// A model switch which is a template parameter of the model class,
+/// read from the [model] options section at startup
+struct ModelSwitch {
+  const char *name; ///< Option name in the [model] section
+  bool def;         ///< Default if not set in the input
+};
+
+/// Builds the full set of specializations of \p Model over \p N bool
+/// parameters, recursively converting one runtime value per step into
+/// a template argument. \p Fixed accumulates the arguments chosen so
+/// far.
+template <int N, template <bool...> class Model, bool... Fixed>
+struct SpecializedModelFactory {
+  static PhysicsModel *create(const bool *values) {
+    return values[0]
+               ? SpecializedModelFactory<N - 1, Model, Fixed..., true>::create(values + 1)
+               : SpecializedModelFactory<N - 1, Model, Fixed..., false>::create(values
+                                                                                + 1);
+  }
+};
+
+template <template <bool...> class Model, bool... Fixed>
+struct SpecializedModelFactory<0, Model, Fixed...> {
+  static PhysicsModel *create(const bool *) { return new Model<Fixed...>(); }
+};
+
+/// Create the specialization of \p Model selected by the input options:
+/// each switch is read from the [model] section and passed to \p Model
+/// as a compile-time bool template argument, in declaration order
+template <template <bool...> class Model, int N>
+PhysicsModel *createSpecializedModel(const ModelSwitch (&switches)[N]) {
+  Options *options = Options::getRoot()->getSection("model");
+  bool values[N];
+  for (int i = 0; i < N; i++) {
+    options->get(switches[i].name, values[i], switches[i].def);
+    output_info.write("\tModel switch %s = %s (compile-time specialized)\n",
+                      switches[i].name, values[i] ? "true" : "false");
+  }
+  return SpecializedModelFactory<N, Model>::create(values);
+}
+
+} // namespace bout
+
 /*!
  * Macro to define a simple main() which creates
  * the given model and runs it. This should be sufficient
@@ -308,7 +412,52 @@ private:
       ModelClass *model = new ModelClass();           \
       Solver *solver = Solver::create();              \
       solver->setModel(model);                        \
-      Monitor * bout_monitor = new BoutMonitor();     \
+      Monitor * bout_monitor = new BoutMonitor(solver); \
+      solver->addMonitor(bout_monitor, Solver::BACK); \
+      solver->outputVars(dump);                       \
+      solver->solve();                                \
+      delete model;                                   \
+      delete solver;                                  \
+      delete bout_monitor;                            \
+    }catch (BoutException &e) {                       \
+      output << "Error encountered\n";                \
+      output << e.what() << endl;                     \
+      MPI_Abort(BoutComm::get(), 1);                  \
+    }                                                 \
+    BoutFinalise();                                   \
+    return 0;                                         \
+  }
+
+/*!
+ * Variant of BOUTMAIN for model class templates over bool switches
+ * (see "Compile-time model specialization" above). The switches are
+ * given as {"name", default} pairs; the matching instantiation is
+ * created at startup.
+ *
+ * Example
+ * -------
+ *
+ * template <bool electromagnetic, bool threeD>
+ * class MyModel : public PhysicsModel {
+ *   ..
+ * };
+ *
+ * BOUTMAIN_SPECIALIZED(MyModel, {"electromagnetic", true}, {"threeD", true});
+ */
+#define BOUTMAIN_SPECIALIZED(ModelClass, ...)         \
+  int main(int argc, char **argv) {                   \
+    int init_err = BoutInitialise(argc, argv);        \
+    if (init_err < 0)				      \
+      return 0;                                       \
+    else if (init_err > 0) 			      \
+      return init_err;				      \
+    try {                                             \
+      const bout::ModelSwitch switches[] = {__VA_ARGS__}; \
+      PhysicsModel *model =                           \
+          bout::createSpecializedModel<ModelClass>(switches); \
+      Solver *solver = Solver::create();              \
+      solver->setModel(model);                        \
+      Monitor * bout_monitor = new BoutMonitor(solver); \
       solver->addMonitor(bout_monitor, Solver::BACK); \
       solver->outputVars(dump);                       \
       solver->solve();                                \
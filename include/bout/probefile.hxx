@@ -0,0 +1,150 @@
+/*!
+ * \file probefile.hxx
+ *
+ * \brief High-frequency point/line/plane probe output
+ *
+ * Dumping full 3D fields through Datafile is far too expensive for
+ * high-frequency time traces, so probes provide the complement: a few
+ * sample locations written every internal timestep. Probes are
+ * registered with global indices and mapped to the owning processors;
+ * each processor appends its samples to its own text stream, relying
+ * on stdio buffering plus a configurable explicit flush interval, so
+ * the per-step cost is a few formatted values into a memory buffer.
+ *
+ **************************************************************************
+ * Copyright 2010 B.D.Dudson, S.Farley, M.V.Umansky, X.Q.Xu
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+class ProbeFile;
+
+#ifndef __PROBEFILE_H__
+#define __PROBEFILE_H__
+
+#include "bout_types.hxx"
+#include "options.hxx"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+class Field3D;
+class Solver;
+
+/*!
+ * Samples registered fields at probe locations and appends the values
+ * to a per-processor text file. Usage, e.g. in PhysicsModel::init:
+ *
+ *     probes = ProbeFile(Options::getRoot()->getSection("probes"));
+ *     probes.addPoint(Ni, "Ni_probe", 34, 32, 0); // Global indices
+ *     probes.addLineX(Te, "Te_midplane", 32, 0);  // Profile along x
+ *     probes.open("%s/probes", data_dir);
+ *     probes.enable(solver); // Sample every internal timestep
+ *
+ * Each processor owning part of a probe writes the file
+ * "<name>.<processor>.dat": '#' comment lines recording the column
+ * layout with global indices, then one line per sample holding the
+ * time followed by the locally owned values. Processors owning no part
+ * of any probe still record the time axis.
+ */
+class ProbeFile {
+public:
+  ProbeFile() {}
+  /// Reads configuration from \p opt: "enabled" (default true) and
+  /// "flush_every" (default 16), the number of samples between
+  /// explicit flushes of the stream
+  ProbeFile(Options *opt);
+  ProbeFile(ProbeFile &&other) noexcept;
+  ~ProbeFile();
+
+  ProbeFile& operator=(ProbeFile &&rhs) noexcept;
+  ProbeFile& operator=(const ProbeFile &rhs) = delete;
+
+  /// Register probes. Like Datafile, a pointer to the field is kept,
+  /// so it must not go out of scope. All indices are global; z is the
+  /// same on every processor. Probes must be registered before the
+  /// first sample is taken
+  void addPoint(const Field3D &f, const std::string &name, int gx, int gy, int gz);
+  /// Line along x (e.g. a midplane profile) at fixed y and z
+  void addLineX(const Field3D &f, const std::string &name, int gy, int gz);
+  /// Line along y at fixed x and z
+  void addLineY(const Field3D &f, const std::string &name, int gx, int gz);
+  /// Line along z at fixed x and y
+  void addLineZ(const Field3D &f, const std::string &name, int gx, int gy);
+  /// x-z plane (a poloidal slice, e.g. the outboard midplane) at fixed y
+  void addPlaneY(const Field3D &f, const std::string &name, int gy);
+
+  /// Open this processor's stream; the name passed is a base to which
+  /// ".<processor>.dat" is appended. Appends if the file exists, so
+  /// restarted runs continue their traces
+  bool open(const char *format, ...);
+
+  void close(); ///< Flush and close the stream
+
+  /// Append one record: the time \p t and every locally owned value.
+  /// The header is written before the first record
+  void sample(BoutReal t);
+
+  void flush(); ///< Flush buffered samples to the file
+
+  /// Sample on every internal timestep taken by \p solver
+  void enable(Solver *solver);
+  /// Stop sampling; the file stays open until close()
+  void disable(Solver *solver);
+
+private:
+  /// A single locally owned sample location (local indices)
+  struct ProbePoint {
+    int x, y, z;
+  };
+
+  /// A registered probe: the locally owned part may be empty
+  struct Probe {
+    const Field3D *ptr;   ///< Pointer to the field; may be a user object
+    std::string name;     ///< Name recorded in the file header
+    std::vector<ProbePoint> points; ///< Locally owned sample points
+    std::vector<std::string> labels; ///< Column labels, "name[gx,gy,gz]"
+  };
+
+  bool enabled = true;  ///< Writing enabled?
+  int flush_every = 16; ///< Samples between explicit flushes
+  int mype = 0;         ///< This processor's rank
+
+  std::FILE *fp = nullptr; ///< This processor's stream
+  bool first_time = true;  ///< Header not yet written?
+  int samples_since_flush = 0;
+
+  std::vector<Probe> probes;
+
+  /// Common registration checks, returns the new probe to fill in
+  Probe &addProbe(const Field3D &f, const std::string &name);
+  /// Add one sample point given global x,y and local z indices
+  void addIfOwned(Probe &probe, int gx, int gy, int z);
+
+  /// Local index owning global index \p gx (interior only), or -1
+  int localX(int gx) const;
+  /// Local index owning global index \p gy (interior only), or -1
+  int localY(int gy) const;
+
+  /// Write the '#' comment lines describing the columns
+  void writeHeader();
+};
+
+#endif // __PROBEFILE_H__
@@ -0,0 +1,145 @@
+/**************************************************************************
+ * One-pass reductions over field regions
+ *
+ * Computes several moments of a field (or of several fields) in a
+ * single traversal, and batches the MPI resolution so that a monitor
+ * computing a dozen diagnostics pays for one reduction round instead
+ * of one MPI_Allreduce per quantity.
+ *
+ **************************************************************************
+ * Copyright 2018 BOUT++ contributors
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+#ifndef __REDUCTIONS_H__
+#define __REDUCTIONS_H__
+
+#include <bout_types.hxx>
+
+#include <cmath>
+#include <map>
+#include <string>
+#include <vector>
+
+class Field2D;
+class Field3D;
+
+/// Moments of a field over a region, gathered in one traversal.
+/// Sums are accumulated in double with compensated (Kahan) addition
+/// of vectorised per-block partial sums, so the result does not
+/// degrade with domain size or when fields are stored in single
+/// precision
+struct FieldReduction {
+  BoutReal min;  ///< Smallest value in the region
+  BoutReal max;  ///< Largest value in the region
+  double sum;    ///< Sum of values
+  double sum2;   ///< Sum of squared values
+  int count;     ///< Number of points reduced over
+
+  double mean() const { return sum / count; }
+  /// RMS value, i.e. the L2 norm normalised by the number of points
+  double l2() const { return std::sqrt(sum2 / count); }
+};
+
+/// True if reductions run in deterministic mode, read from the
+/// "deterministic" option in the [reductions] section (default false)
+/// on first use. In deterministic mode the local sums combine
+/// fixed-size vectorised chunk partials in a fixed order independent
+/// of the OpenMP thread count and schedule, and the cross-processor
+/// sums gather the per-rank partials and combine them pairwise in
+/// rank order instead of using MPI_Allreduce, whose reduction tree is
+/// up to the MPI library. Results are then bitwise-reproducible from
+/// run to run (and across thread counts) at a small cost: the chunk
+/// partials still vectorise, and the extrema still use MPI_Allreduce
+/// since min/max are order-independent
+bool deterministicReductions();
+
+/// Compute min, max, sum and sum of squares of \p f over region \p rgn
+/// in a single pass. If \p allpe is true the result is resolved across
+/// all processors (two MPI_Allreduce calls: one for the extrema, one
+/// for the sums); otherwise it is local to this processor
+FieldReduction reduce(const Field3D &f, REGION rgn = RGN_NOBNDRY, bool allpe = true);
+FieldReduction reduce(const Field2D &f, REGION rgn = RGN_NOBNDRY, bool allpe = true);
+
+/// As reduce(Field3D), but for several fields fused into one MPI
+/// resolution: the region is traversed once with every field reduced
+/// during the same sweep, then all the extrema and all the sums travel
+/// in the same two MPI_Allreduce calls. The result vector matches the
+/// order of \p fields
+std::vector<FieldReduction> reduce(const std::vector<const Field3D *> &fields,
+                                   REGION rgn = RGN_NOBNDRY, bool allpe = true);
+
+/// Local (single processor) fused reduction: one traversal of \p rgn
+/// computing the moments of every field in \p fields. All fields must
+/// be defined on the same mesh. No MPI is involved; batch the results
+/// from several calls (e.g. over different regions) and complete them
+/// with a single resolveReductions() call
+std::vector<FieldReduction> reduceLocal(const std::vector<const Field3D *> &fields,
+                                        REGION rgn = RGN_NOBNDRY);
+std::vector<FieldReduction> reduceLocal(const std::vector<const Field2D *> &fields,
+                                        REGION rgn = RGN_NOBNDRY);
+
+/// Resolve a batch of local reductions across all processors. However
+/// many reductions are batched, this costs exactly two MPI_Allreduce
+/// calls. Every processor must pass the same number of reductions in
+/// the same order
+void resolveReductions(std::vector<FieldReduction> &reductions);
+
+/// A batch of named scalar reductions, resolved with a single
+/// MPI_Allreduce per operation kind (sum, min, max) rather than one
+/// per quantity.
+///
+/// Typical monitor usage:
+///
+///     ReductionBatch batch;
+///     batch.max("max_density", max(n, false));   // local extremum
+///     batch.sum("total_energy", local_energy);
+///     batch.gather();                            // <= 3 MPI calls
+///     output.write("%e", batch.get("total_energy"));
+///
+/// Every processor must register the same names in the same batch, as
+/// the quantities are packed by name for the collective calls. Names
+/// must be unique across the three operation kinds
+class ReductionBatch {
+public:
+  /// Register local contributions. Repeated registration under the
+  /// same name combines locally: sum adds, min/max keep the extremum
+  void sum(const std::string &name, double local);
+  void min(const std::string &name, double local);
+  void max(const std::string &name, double local);
+
+  /// Resolve all registered quantities across processors, using one
+  /// MPI_Allreduce per operation kind. Clears the registrations, so
+  /// the batch can be refilled on the next monitor call
+  void gather();
+
+  /// Get a resolved value. Throws BoutException for unknown names or
+  /// if gather() has not been called since it was registered
+  double get(const std::string &name) const;
+
+private:
+  // Pending local contributions, keyed by name. std::map iterates in
+  // sorted order, so all processors pack the values identically
+  std::map<std::string, double> pending_sum, pending_min, pending_max;
+
+  std::map<std::string, double> results; ///< Resolved values
+};
+
+#endif // __REDUCTIONS_H__
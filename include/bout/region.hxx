@@ -52,6 +52,10 @@
 #include "bout/assert.hxx"
 #include "bout/openmpwrap.hxx"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 /// The MAXREGIONBLOCKSIZE value can be tuned to try to optimise
 /// performance on specific hardware. It determines what the largest
 /// contiguous block size can be. As we hope the compiler will vectorise
@@ -64,6 +68,16 @@
 #error "In region.hxx must set MAXREGIONBLOCKSIZE > 0"
 #endif
 
+#ifdef _OPENMP
+/// The omp_sched_t matching the compile-time default loop schedule
+/// OPENMP_SCHEDULE, used by Region::applySchedule for regions without
+/// an explicit scheduling hint. Two-level macro so OPENMP_SCHEDULE is
+/// expanded before pasting.
+#define BOUT_OMP_SCHED_PASTE_(s) omp_sched_##s
+#define BOUT_OMP_SCHED_PASTE(s) BOUT_OMP_SCHED_PASTE_(s)
+#define BOUT_OMP_SCHED_DEFAULT BOUT_OMP_SCHED_PASTE(OPENMP_SCHEDULE)
+#endif
+
 /// Helper macros for iterating over a Region making use of the
 /// contiguous blocks of indices
 ///
@@ -123,12 +137,74 @@
 #define BOUT_FOR_OMP(index, region, omp_pragmas) BOUT_FOR_SERIAL(index, region)
 #endif
 
+// BOUT_FOR honours the region's scheduling hint (see
+// Region::setSchedule): applySchedule() installs the hint (or the
+// compile-time default) as the calling thread's runtime schedule for
+// the following schedule(runtime) loop, and the if clause skips
+// forking a thread team entirely for regions below their serial
+// threshold. The wrapper for-statement runs once; it exists only to
+// sequence the applySchedule() call before the pragma.
 #define BOUT_FOR(index, region)                                                          \
-  BOUT_FOR_OMP(index, region, parallel for schedule(OPENMP_SCHEDULE))
-
+  for (bool bout_sched_once = ((region).applySchedule(), true); bout_sched_once;         \
+       bout_sched_once = false)                                                          \
+  BOUT_FOR_OMP(index, region,                                                            \
+               parallel for schedule(runtime) if ((region).forkParallel()))
+
+// Note: BOUT_FOR_INNER runs inside an existing parallel region, where
+// one thread updating the runtime-schedule control variable would not
+// be seen by its team mates, so it keeps the compile-time schedule
 #define BOUT_FOR_INNER(index, region)                                                    \
   BOUT_FOR_OMP(index, region, for schedule(OPENMP_SCHEDULE) nowait)
 
+/// Loop over the contiguous blocks of a Region directly, for writing
+/// explicitly vectorised kernels. `block` iterates over the
+/// [first, second) index pairs of the region's block decomposition,
+/// so the caller controls the inner loop and can use a plain integer
+/// induction variable, as required by `omp simd`:
+///
+///     BOUT_FOR_BLOCK(block, region) {
+///       const int iend = block->second.ind;
+///       BOUT_SIMD
+///       for (int i = block->first.ind; i < iend; ++i) {
+///         A[Ind3D(i)] = B[Ind3D(i)] + C[Ind3D(i)];
+///       }
+///     }
+#define BOUT_FOR_BLOCK_SERIAL(block, region)                                             \
+  for (auto block = region.getBlocks().cbegin(), block##_end = region.getBlocks().cend();\
+       block < block##_end; ++block)
+
+#ifdef _OPENMP
+#define BOUT_FOR_BLOCK(block, region)                                                    \
+  for (bool bout_sched_once = ((region).applySchedule(), true); bout_sched_once;         \
+       bout_sched_once = false)                                                          \
+  BOUT_OMP(parallel for schedule(runtime) if ((region).forkParallel()))                  \
+  for (auto block = region.getBlocks().cbegin(); block < region.getBlocks().cend();      \
+       ++block)
+#else
+#define BOUT_FOR_BLOCK(block, region) BOUT_FOR_BLOCK_SERIAL(block, region)
+#endif
+
+/// As BOUT_FOR, but iterating the region in cache-sized 3D tiles of
+/// tx * ty * tz points (see Region::asTiled). The tiled region is
+/// constructed on every use, which is relatively expensive: loops run
+/// every timestep should instead cache `region.asTiled(tx, ty, tz)`
+/// once and use BOUT_FOR on it directly.
+#define BOUT_FOR_TILED(index, region, tx, ty, tz)                                        \
+  for (bool bout_tiled_once = true; bout_tiled_once;)                                    \
+    for (const auto bout_tiled_region = (region).asTiled(tx, ty, tz); bout_tiled_once;   \
+         bout_tiled_once = false)                                                        \
+      BOUT_FOR(index, bout_tiled_region)
+
+/// Request SIMD vectorisation of the following loop. Expands to
+/// `#pragma omp simd` when compiled with OpenMP 4.0 or later, and to
+/// nothing otherwise. Note that `omp simd` requires an integer (not
+/// Ind2D/Ind3D) induction variable; see BOUT_FOR_BLOCK above.
+#if defined(_OPENMP) && _OPENMP >= 201307
+#define BOUT_SIMD BOUT_OMP(simd)
+#else
+#define BOUT_SIMD
+#endif
+
 
 enum class IND_TYPE { IND_3D = 0, IND_2D = 1, IND_PERP = 2 };
 
@@ -504,6 +580,74 @@ public:
     indices = getRegionIndices();
   };
 
+  /// OpenMP loop scheduling policy for this region, honoured by
+  /// BOUT_FOR and BOUT_FOR_BLOCK. The default is the compile-time
+  /// schedule chosen with --with-openmp-schedule; dynamic suits
+  /// ragged regions (boundaries, rims) whose blocks do varying
+  /// amounts of work
+  enum Schedule { SCHEDULE_DEFAULT, SCHEDULE_STATIC, SCHEDULE_DYNAMIC };
+
+  /// Set the scheduling policy hint. Returns this region so calls can
+  /// be chained onto a constructor
+  Region<T> &setSchedule(Schedule s) {
+    schedule = s;
+    return *this;
+  }
+  Schedule getSchedule() const { return schedule; }
+
+  /// Below \p npoints points, BOUT_FOR runs loops over this region
+  /// without forking a thread team: forking 16 threads to process a
+  /// 200-point boundary region costs more than the loop. Zero (the
+  /// default) always forks
+  Region<T> &setSerialThreshold(unsigned int npoints) {
+    serialThreshold = npoints;
+    return *this;
+  }
+  unsigned int getSerialThreshold() const { return serialThreshold; }
+
+  /// Choose a scheduling policy from the region's shape: blocks of
+  /// very uneven size get dynamic scheduling, and regions too small
+  /// to amortise a fork get a serial threshold. A cheap static
+  /// heuristic standing in for per-loop measurement, which would need
+  /// the loop bodies
+  Region<T> &tuneSchedule() {
+#ifdef _OPENMP
+    // Less than ~MAXREGIONBLOCKSIZE points of work per thread does
+    // not pay for the fork
+    setSerialThreshold(MAXREGIONBLOCKSIZE * omp_get_max_threads());
+    if (size() > 0) {
+      const auto stats = getStats();
+      if ((stats.maxImbalance > 2.0) || (stats.numSmallBlocks > stats.numBlocks / 2)) {
+        setSchedule(SCHEDULE_DYNAMIC);
+      }
+    }
+#endif
+    return *this;
+  }
+
+  /// True if BOUT_FOR should fork a thread team for this region
+  bool forkParallel() const { return size() >= serialThreshold; }
+
+  /// Install this region's scheduling policy as the calling thread's
+  /// runtime schedule, so that the schedule(runtime) clause of the
+  /// following BOUT_FOR loop uses it. Called by BOUT_FOR; no effect
+  /// without OpenMP
+  void applySchedule() const {
+#ifdef _OPENMP
+    switch (schedule) {
+    case SCHEDULE_STATIC:
+      omp_set_schedule(omp_sched_static, 0);
+      break;
+    case SCHEDULE_DYNAMIC:
+      omp_set_schedule(omp_sched_dynamic, 0);
+      break;
+    default:
+      omp_set_schedule(BOUT_OMP_SCHED_DEFAULT, 0);
+      break;
+    }
+#endif
+  }
+
   /// Return a new Region that has the same indices as this one but
   /// ensures the indices are sorted.
   Region<T> asSorted(){
@@ -540,6 +684,46 @@ public:
     return *this;
   }
 
+  /// Return a new Region with the same indices reordered into 3D
+  /// tiles of size tx * ty * tz points. Iterating the tiled region
+  /// visits all points of one tile before moving to the next, so
+  /// stencil-heavy kernels reuse cache lines across their footprint
+  /// instead of streaming through whole ny*nz slabs. Within each tile
+  /// the original (memory) order is preserved, so contiguous runs in
+  /// z remain contiguous blocks and can still be vectorised.
+  ///
+  /// Tile sizes should be chosen so a tile plus its stencil halo fits
+  /// in cache; the result is typically cached and reused, as the
+  /// reordering itself is relatively expensive.
+  Region<T> asTiled(int tx, int ty, int tz,
+                    int maxregionblocksize = MAXREGIONBLOCKSIZE) const {
+    ASSERT1(tx > 0 && ty > 0 && tz > 0);
+    auto tiledIndices = getIndices();
+    // Tiles are visited in the same x-y-z order as the underlying
+    // indices, and a stable sort preserves memory order within each
+    // tile
+    std::stable_sort(std::begin(tiledIndices), std::end(tiledIndices),
+                     [tx, ty, tz](const T &a, const T &b) {
+                       const int axt = a.x() / tx, bxt = b.x() / tx;
+                       if (axt != bxt) {
+                         return axt < bxt;
+                       }
+                       const int ayt = a.y() / ty, byt = b.y() / ty;
+                       if (ayt != byt) {
+                         return ayt < byt;
+                       }
+                       return (a.z() / tz) < (b.z() / tz);
+                     });
+    return Region<T>(tiledIndices, maxregionblocksize);
+  }
+
+  /// Reorder this Region into cache-sized tiles in-place. See asTiled
+  Region<T> tiled(int tx, int ty, int tz,
+                  int maxregionblocksize = MAXREGIONBLOCKSIZE) {
+    *this = this->asTiled(tx, ty, tz, maxregionblocksize);
+    return *this;
+  }
+
   /// Return a new region equivalent to *this but with indices contained
   /// in mask Region removed
   Region<T> mask(const Region<T> & maskRegion){
@@ -571,6 +755,38 @@ public:
     return *this; // To allow command chaining
   };
 
+  /// Return a new region equivalent to *this but keeping only the
+  /// indices that are also contained in the other Region (set
+  /// intersection)
+  Region<T> intersect(const Region<T> & otherRegion){
+    // Get the other region's indices and sort as we're going to be
+    // searching through this vector so if it's sorted we can be more efficient
+    auto otherIndices = otherRegion.getIndices();
+    std::sort(std::begin(otherIndices), std::end(otherIndices));
+
+    // Get the current set of indices that we're going to filter and then
+    // use to create the result region.
+    auto currentIndices = getIndices();
+
+    // Lambda that returns true/false depending if the passed value is in otherIndices
+    // With C++14 T can be auto instead
+    auto notInVector = [&](T val){
+      return !std::binary_search(std::begin(otherIndices), std::end(otherIndices), val);
+    };
+
+    // Erase elements of currentIndices that are not in otherIndices
+    currentIndices.erase(
+             std::remove_if(std::begin(currentIndices), std::end(currentIndices),
+                    notInVector),
+             std::end(currentIndices)
+             );
+
+    // Update indices
+    setIndices(currentIndices);
+
+    return *this; // To allow command chaining
+  };
+
   /// Accumulate operator
   Region<T> & operator+=(const Region<T> &rhs){
     (*this) = (*this) + rhs;
@@ -679,6 +895,8 @@ private:
   ContiguousBlocks blocks; //< Contiguous sections of flattened indices
   int ny = -1;             //< Size of y dimension
   int nz = -1;             //< Size of z dimension
+  Schedule schedule = SCHEDULE_DEFAULT; //< OpenMP scheduling hint for BOUT_FOR
+  unsigned int serialThreshold = 0;     //< Below this many points, don't fork
 
   /// Helper function to create a RegionIndices, given the start and end
   /// points in x, y, z, and the total y, z lengths
@@ -798,6 +1016,23 @@ Region<T> mask(const Region<T> &region, const Region<T> &mask) {
   return result.mask(mask);
 };
 
+/// Return the intersection of two regions, i.e. the indices of \p region
+/// that are also contained in \p other
+template<typename T>
+Region<T> intersection(const Region<T> &region, const Region<T> &other) {
+  auto result = region;
+  return result.intersect(other);
+};
+
+/// Return the set union of two regions: combined indices with
+/// duplicates removed and the result sorted. Unlike operator+ this is
+/// safe to use when the two regions overlap.
+template<typename T>
+Region<T> getUnion(const Region<T> &lhs, const Region<T> &rhs) {
+  auto result = lhs + rhs;
+  return result.unique();
+};
+
 /// Return a new region with combined indices from two Regions
 /// This doesn't attempt to avoid duplicate elements or enforce
 /// any sorting etc. but could be done if desired.
@@ -0,0 +1,65 @@
+/*!
+ * \file restart_fanout.hxx
+ *
+ * \brief Fan-out restart reads through designated per-node reader ranks
+ *
+ * On restart every processor opens its own BOUT.restart file, and at
+ * large rank counts the simultaneous opens overwhelm the parallel
+ * filesystem's metadata servers. In fan-out mode only a few reader
+ * ranks per node touch the filesystem: each reader streams its node
+ * peers' restart files and sends the bytes over node-local MPI, and
+ * each peer writes its file to a node-local staging path (tmpfs, SSD
+ * or burst buffer) and opens it from there. The filesystem then sees
+ * a fixed number of concurrent readers per node regardless of the
+ * rank count.
+ *
+ **************************************************************************
+ * Copyright 2010 B.D.Dudson, S.Farley, M.V.Umansky, X.Q.Xu
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+#ifndef __RESTART_FANOUT_H__
+#define __RESTART_FANOUT_H__
+
+#include <string>
+
+namespace bout {
+
+/// Stage this processor's restart file through a node-local path,
+/// returning the filename the restart Datafile should open. \p
+/// filename is the per-run name without the processor number (e.g.
+/// "data/BOUT.restart.nc"), as passed to Datafile::openr, which
+/// inserts the number itself; the staged copy is named the same way
+/// so the returned base resolves to it.
+///
+/// Configured in the [restart] options section:
+///
+///   fanout         = true     # Enable (default false: \p filename is
+///                             # returned unchanged and nothing is read)
+///   fanout_stage_dir = /tmp   # Node-local directory for the staged
+///                             # copies; must exist on every node
+///   fanout_readers = 1        # Reader ranks per node
+///
+/// Collective over BoutComm: every processor must call it
+std::string fanoutRestartPath(const std::string &filename);
+
+} // namespace bout
+
+#endif // __RESTART_FANOUT_H__
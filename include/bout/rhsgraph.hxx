@@ -0,0 +1,152 @@
+/************************************************************************//**
+ * \brief Declarative RHS pipeline with dataflow scheduling
+ *
+ * PhysicsModel::rhs is an opaque user function, so BOUT++ cannot
+ * reorder or overlap anything across the operator calls inside it.
+ * RhsGraph lets a model instead register its RHS as a dataflow graph
+ * of named stages — communications, derivative evaluations,
+ * inversions, pointwise algebra — with explicit dependencies. The
+ * scheduler then executes the graph so that:
+ *
+ *  - communication stages are started (communicateBegin) as soon as
+ *    their dependencies complete, and only waited for
+ *    (communicateEnd) when no independent compute stage is left to
+ *    run, overlapping the halo exchange with computation
+ *  - pointwise stages over the same region that become ready together
+ *    are fused into a single traversal, so their fields are read once
+ *    while hot in cache
+ *
+ * The graph is built once (e.g. in PhysicsModel::init) and run every
+ * RHS evaluation. Partial adoption works: a model can register just
+ * its communications and derivative calls and keep the rest of the
+ * RHS in an ordinary final stage.
+ *
+ **************************************************************************
+ * Copyright 2018 BOUT++ contributors
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+#ifndef __RHSGRAPH_H__
+#define __RHSGRAPH_H__
+
+#include "bout/fieldgroup.hxx"
+#include "bout/region.hxx"
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+class Mesh;
+
+/// A dataflow graph of named RHS stages, executed with automatic
+/// communication/computation overlap and fusion of pointwise stages
+///
+/// Example (two evolving fields; the Laplacian inversion does not need
+/// the halo exchange, so it runs while the exchange is in flight):
+///
+///     RhsGraph graph;           // Built once, e.g. in init()
+///     graph.addCommunicate("comm", FieldGroup(n, vort));
+///     graph.add("invert", [this]() { phi = lap->solve(vort); });
+///     graph.add("ddt_n", [this]() { ddt(n) = -bracket(phi, n); },
+///               {"comm", "invert"});
+///     graph.add("ddt_vort", [this]() { ddt(vort) = ...; },
+///               {"comm", "invert"});
+///
+///     int rhs(BoutReal) override {
+///       graph.run();
+///       return 0;
+///     }
+///
+/// Dependencies must name stages that have already been added, so the
+/// graph is acyclic by construction.
+class RhsGraph {
+public:
+  /// An ordinary stage: any callable, e.g. a derivative evaluation or
+  /// an inversion
+  typedef std::function<void()> Stage;
+
+  /// A pointwise stage, called once per point of its region. Stages
+  /// over the same region that become ready together are fused into
+  /// one traversal
+  typedef std::function<void(const Ind3D &)> PointwiseStage;
+
+  /// Uses the global mesh unless \p m is given
+  RhsGraph(Mesh *m = nullptr) : localmesh(m) {}
+
+  /// Add stage \p name running \p work after the stages named in
+  /// \p depends have completed
+  void add(const std::string &name, Stage work,
+           const std::vector<std::string> &depends = {});
+
+  /// Add a pointwise stage over \p region (default "RGN_NOBNDRY").
+  /// Fusion shares the traversal, not the arithmetic: it pays off for
+  /// memory-bound stages reading common fields
+  void addPointwise(const std::string &name, PointwiseStage work,
+                    const std::vector<std::string> &depends = {},
+                    const std::string &region = "RGN_NOBNDRY");
+
+  /// Add a halo exchange of \p fields. Started as soon as its
+  /// dependencies complete; stages depending on it only wait for the
+  /// data once no independent work remains
+  void addCommunicate(const std::string &name, const FieldGroup &fields,
+                      const std::vector<std::string> &depends = {});
+
+  /// Execute all stages, respecting dependencies. Can be called every
+  /// RHS evaluation; the graph is not consumed
+  void run();
+
+  /// Remove all stages, so the graph can be rebuilt
+  void clear();
+
+  /// Number of registered stages
+  int size() const { return static_cast<int>(nodes.size()); }
+
+private:
+  enum StageType { COMPUTE, POINTWISE, COMMUNICATE };
+
+  struct Node {
+    std::string name;
+    StageType type;
+    Stage work;               ///< For COMPUTE stages
+    PointwiseStage pointwise; ///< For POINTWISE stages
+    FieldGroup fields;        ///< For COMMUNICATE stages
+    std::string region;       ///< For POINTWISE stages
+    std::vector<int> depends; ///< Indices of prerequisite stages
+  };
+
+  /// Register a node, resolving its dependency names. Throws
+  /// BoutException for duplicate names or unknown dependencies
+  void addNode(Node node, const std::vector<std::string> &depends);
+
+  /// Run a batch of ready pointwise stages over one region in a
+  /// single traversal
+  void runPointwiseBatch(const std::string &region, const std::vector<int> &batch);
+
+  /// The mesh used for communication and regions; resolved lazily so
+  /// a RhsGraph member can be constructed before the mesh exists
+  Mesh *getMesh();
+
+  std::vector<Node> nodes;
+  std::map<std::string, int> names; ///< Stage name -> index in nodes
+  Mesh *localmesh;
+};
+
+#endif // __RHSGRAPH_H__
@@ -41,6 +41,7 @@ class RKScheme;
 
 #include <iomanip>
 #include <string>
+#include <vector>
 using std::string;
 using std::setw;
 
@@ -65,11 +66,11 @@ class RKScheme {
   BoutReal setCurTime(BoutReal timeIn,BoutReal dt,int curStage);
 
   //Get the state vector at given stage
-  virtual void setCurState(const Array<BoutReal> &start, Array<BoutReal> &out,int curStage, 
+  virtual void setCurState(const Array<double> &start, Array<double> &out,int curStage, 
 			   const BoutReal dt);
 
   //Calculate the output state and return the error estimate (if adaptive)
-  virtual BoutReal setOutputStates(const Array<BoutReal> &start,BoutReal dt, Array<BoutReal> &resultFollow);
+  virtual BoutReal setOutputStates(const Array<double> &start,BoutReal dt, Array<double> &resultFollow);
 
   //Update the timestep
   virtual BoutReal updateTimestep(BoutReal dt,BoutReal err);
@@ -84,7 +85,7 @@ class RKScheme {
   int getNumOrders(){return numOrders;};
 
   //The intermediate stages
-  Matrix<BoutReal> steps;
+  Matrix<double> steps;
 
  protected:
   //Information about scheme
@@ -95,11 +96,11 @@ class RKScheme {
   int order; //Order of scheme
 
   //The Butcher Tableau
-  Matrix<BoutReal> stageCoeffs;
-  Matrix<BoutReal> resultCoeffs;
-  Array<BoutReal> timeCoeffs;
+  Matrix<double> stageCoeffs;
+  Matrix<double> resultCoeffs;
+  Array<double> timeCoeffs;
   
-  Array<BoutReal> resultAlt;
+  Array<double> resultAlt;
 
   int nlocal;
   int neq;
@@ -109,19 +110,25 @@ class RKScheme {
 
   BoutReal dtfac;
 
-  virtual BoutReal getErr(Array<BoutReal> &solA, Array<BoutReal> &solB);
+  virtual BoutReal getErr(Array<double> &solA, Array<double> &solB);
 
-  virtual void constructOutput(const Array<BoutReal> &start,BoutReal dt, 
-			       const int index, Array<BoutReal> &sol);
+  virtual void constructOutput(const Array<double> &start,BoutReal dt, 
+			       const int index, Array<double> &sol);
 
-  virtual void constructOutputs(const Array<BoutReal> &start,BoutReal dt, 
+  virtual void constructOutputs(const Array<double> &start,BoutReal dt, 
 				const int indexFollow,int indexAlt,
-				Array<BoutReal> &solFollow, Array<BoutReal> &solAlt);
+				Array<double> &solFollow, Array<double> &solAlt);
 
  private:
   void verifyCoeffs();
   void printButcherTableau();
   void zeroSteps();
+
+  //Scratch space for gathering the non-zero stage contributions, so
+  //states can be constructed in a single pass over the data.
+  //Allocated once in init
+  Array<double> curFacs, curFacsAlt;
+  std::vector<BoutReal*> curRows;
 };
 
 #endif // __RKSCHEME_H__
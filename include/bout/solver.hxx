@@ -34,6 +34,7 @@
  **************************************************************************/
 
 class Solver;
+class Checkpoint;
 
 #include <bout_types.hxx>
 #include <boutexception.hxx>
@@ -92,6 +93,8 @@ typedef std::string SolverType;
 #define SOLVERIMEXBDF2    "imexbdf2"
 #define SOLVERSNES        "snes"
 #define SOLVERRKGENERIC   "rkgeneric"
+#define SOLVERMULTIRATE   "multirate"
+#define SOLVERSPLITRK     "splitrk"
 
 enum SOLVER_VAR_OP {LOAD_VARS, LOAD_DERIVS, SET_ID, SAVE_VARS, SAVE_DERIVS};
 
@@ -293,6 +296,29 @@ class Solver {
   /// @param[in] save_repeat    If true, add variables with time dimension
   void outputVars(Datafile &outputfile, bool save_repeat=true);
 
+  /// Add evolving variables to a fast binary checkpoint
+  ///
+  /// @param[inout] checkpoint   The checkpoint to add variables to
+  void outputVars(Checkpoint &checkpoint);
+
+  /// Integrator statistics for the current output step, for
+  /// performance monitoring. Implementations fill in what they can;
+  /// quantities a solver doesn't track are left at zero. The RHS call
+  /// count is filled in by the base class, and all counts are reset
+  /// after the monitors have been called
+  struct SolverStats {
+    int nsteps = 0;        ///< Internal steps taken
+    int nfailed = 0;       ///< Failed (rejected or retried) steps
+    int nrhs_calls = 0;    ///< RHS evaluations
+    int nnewton_iters = 0; ///< Nonlinear (Newton) iterations
+    int nkrylov_iters = 0; ///< Linear (Krylov) iterations
+    BoutReal last_dt = 0.0; ///< Most recent internal timestep
+  };
+
+  /// Add the integrator statistics to \p outputfile as time-series
+  /// variables, named "solver_nsteps", "solver_nfailed" etc.
+  void addTelemetry(Datafile &outputfile);
+
   /*!
    * Create a Solver object. This uses the "type" option
    * in the given Option section to determine which solver
@@ -354,6 +380,8 @@ protected:
   BoutReal simtime;  ///< Current simulation time
   int iteration; ///< Current iteration (output time-step) number
 
+  SolverStats stats; ///< Per-output-step integrator statistics
+
   int run_rhs(BoutReal t); ///< Run the user's RHS function
   int run_convective(BoutReal t); ///< Calculate only the convective parts
   int run_diffusive(BoutReal t, bool linear=true); ///< Calculate only the diffusive parts
@@ -367,12 +395,39 @@ protected:
   int run_precon(BoutReal t, BoutReal gamma, BoutReal delta);
   
   // Loading data from BOUT++ to/from solver
-  void load_vars(BoutReal *udata);
-  void load_derivs(BoutReal *udata);
-  void save_vars(BoutReal *udata);
-  void save_derivs(BoutReal *dudata);
-  void set_id(BoutReal *udata);
-  
+  // State vectors are always double, so the integrator keeps full
+  // precision even when fields are stored in single precision
+  void load_vars(double *udata);
+  void load_derivs(double *udata);
+  void save_vars(double *udata);
+  void save_derivs(double *dudata);
+  void set_id(double *udata);
+
+  // Snapshot/rollback of solver state vectors, for adaptive schemes
+  // that may reject or re-take a step. A snapshot is O(1): it shares
+  // the underlying storage through Array's reference counting, and
+  // the deep copy is deferred until the live state is next written.
+  // Writes after a snapshot must go through writableState(), which
+  // detaches the storage so the snapshot keeps its saved values
+
+  /// An O(1) snapshot of \p state, sharing its storage
+  static Array<BoutReal> snapshotState(const Array<BoutReal> &state) { return state; }
+
+  /// Roll \p state back to \p snapshot in O(1). The two share
+  /// storage again until the next writableState() call
+  static void rollbackState(Array<BoutReal> &state, const Array<BoutReal> &snapshot) {
+    state = snapshot;
+  }
+
+  /// Pointer for writing into \p state once snapshots may exist:
+  /// detaches the storage from any snapshots sharing it, copying
+  /// only if there are any
+  static BoutReal *writableState(Array<BoutReal> &state) {
+    state.ensureUnique();
+    return std::begin(state);
+  }
+
+
   // 
   const Field3D globalIndex(int localStart);
   
@@ -388,11 +443,27 @@ private:
   rhsfunc phys_run;       ///< The user's RHS function
   PhysicsPrecon prefunc;  // Preconditioner
   bool split_operator;
+  /// Buffers reused by the split-operator run_rhs, which runs every
+  /// RHS evaluation and previously allocated them per call
+  Array<BoutReal> split_state, split_deriv;
   rhsfunc phys_conv, phys_diff; ///< Convective and Diffusive parts (if split operator)
 
   bool mms; ///< Enable sources and solutions for Method of Manufactured Solutions
   bool mms_initialise; ///< Initialise variables to the manufactured solution
 
+  /// Sentinel checking of the evolving fields (option sentinel), a
+  /// safety net for production runs compiled with CHECK=0: the
+  /// floating-point exception status flags are read after every RHS
+  /// call at near-zero cost, and a full non-finite scan of the fields
+  /// and their time derivatives runs every sentinel_every calls, or
+  /// brought forward when the flags trip. See sentinel_check()
+  bool sentinel;
+  int sentinel_every;    ///< Full-scan interval, in RHS calls
+  int sentinel_fp_trips; ///< RHS calls which raised FP exception flags
+
+  void sentinel_clear_fp(); ///< Clear the FP status flags before the RHS runs
+  void sentinel_check();    ///< Per-call sentinel test; throws if bad data is found
+
   void add_mms_sources(BoutReal t);
   void calculate_mms_error(BoutReal t);
   
@@ -403,8 +474,13 @@ private:
   void post_rhs(BoutReal t); // Should be run after user RHS is called
   
   // Loading data from BOUT++ to/from solver
-  void loop_vars_op(Ind2D i2d, BoutReal *udata, int &p, SOLVER_VAR_OP op, bool bndry);
-  void loop_vars(BoutReal *udata, SOLVER_VAR_OP op);
+  void loop_vars_op(Ind2D i2d, double *udata, int &p, SOLVER_VAR_OP op, bool bndry);
+  void loop_vars(double *udata, SOLVER_VAR_OP op);
+
+  /// Fast path for the data copying operations (everything except
+  /// SET_ID), which run on every RHS call: copies through raw pointers
+  /// gathered once per call, in the same layout as loop_vars_op
+  void loop_vars_raw(double *udata, SOLVER_VAR_OP op);
 
   bool varAdded(const string &name); // Check if a variable has already been added
 };
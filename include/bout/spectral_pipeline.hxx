@@ -0,0 +1,133 @@
+/*!
+ * \file spectral_pipeline.hxx
+ *
+ * \brief Fused z-spectral operator pipeline
+ *
+ * Delp2, lowPass and spectral smoothing each transform to z-spectral
+ * space, operate per mode, and transform straight back. When they are
+ * applied back to back — as in a typical vorticity equation — the
+ * intermediate inverse/forward transform pairs cancel. A
+ * SpectralPipeline chains the per-mode operations so the data makes
+ * one rfft/irfft round trip instead of one per operator.
+ *
+ * The parallel derivative joins the chain through gradPar(): on a
+ * shifted-metric mesh the field alignment is a per-mode phase
+ * rotation, so Grad_par becomes a phase-shifted central difference in
+ * y applied directly to the spectral coefficients, with no transform
+ * round trips at all between it and the other stages.
+ *
+ * Example:
+ *
+ *     SpectralPipeline pipe(coords);
+ *     pipe.delp2().lowPass(zmax);
+ *     ...
+ *     vort = pipe.apply(phi); // in the rhs function
+ *
+ * The pipeline is built once and reused: stages are fixed, only the
+ * field changes between apply() calls.
+ *
+ **************************************************************************
+ * Copyright 2010 B.D.Dudson, S.Farley, M.V.Umansky, X.Q.Xu
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+class SpectralPipeline;
+
+#ifndef __SPECTRAL_PIPELINE_H__
+#define __SPECTRAL_PIPELINE_H__
+
+#include "bout_types.hxx"
+#include "dcomplex.hxx"
+
+#include <vector>
+
+class Coordinates;
+class Field3D;
+class Mesh;
+
+class SpectralPipeline {
+public:
+  /// Build an empty pipeline on \p coords. Stages are appended with
+  /// the chainable methods below
+  SpectralPipeline(Coordinates *coords);
+
+  /// Append the perpendicular Laplacian, the same operator (and
+  /// cached coefficients) as Coordinates::Delp2
+  SpectralPipeline &delp2();
+
+  /// Append a low-pass filter keeping modes jz <= \p zmax, matching
+  /// lowPass(f, zmax). \p zmin = 0 also removes the zonal (jz = 0)
+  /// component, matching lowPass(f, zmax, zmin)
+  SpectralPipeline &lowPass(int zmax, int zmin = -1);
+
+  /// Append a spectral smoother multiplying mode kz by
+  /// 1 / (1 + (alpha*kz)^2), damping the short z wavelengths which
+  /// make the subsequent Laplacian inversion stiff
+  SpectralPipeline &kzDamp(BoutReal alpha);
+
+  /// Append the parallel gradient Grad_par = (1/sqrt(g_22)) d/dy
+  /// along the field, as a central difference in y applied per z
+  /// mode. On a shifted-metric mesh (mesh:paralleltransform =
+  /// shifted) the neighbouring y pencils are rotated into alignment
+  /// by the cached zShift phase factors — the spectral equivalent of
+  /// the yup/ydown fields — so no transforms are needed. The input
+  /// field must have communicated y guard cells; the y guard rows of
+  /// the result are set to zero. Not available on FCI meshes
+  SpectralPipeline &gradPar();
+
+  /// Append the radially-varying mode truncation configured in the
+  /// [zmask] options section (see zmodemask.hxx): at each x index,
+  /// modes above ZModeMask::zmax(jx) are zeroed. A no-op stage when
+  /// zmask:enabled is false
+  SpectralPipeline &zMask();
+
+  /// Apply the chained stages to \p f with a single transform round
+  /// trip. Boundary values in x are set to zero when the pipeline
+  /// contains a delp2() stage, as for Coordinates::Delp2
+  const Field3D apply(const Field3D &f);
+
+private:
+  enum StageKind { STAGE_DELP2, STAGE_LOWPASS, STAGE_KZDAMP, STAGE_GRADPAR,
+                   STAGE_ZMASK };
+
+  struct Stage {
+    StageKind kind;
+    int zmax, zmin;  ///< Filter limits for STAGE_LOWPASS
+    BoutReal alpha;  ///< Damping length for STAGE_KZDAMP
+  };
+
+  Coordinates *coords;
+  std::vector<Stage> stages;
+  bool has_delp2 = false;   ///< Any STAGE_DELP2 in the chain?
+  bool has_gradpar = false; ///< Any STAGE_GRADPAR in the chain?
+
+  /// Phase factors rotating the y+1 / y-1 pencils into alignment with
+  /// pencil y, indexed [(jx*LocalNy + jy)*nmodes + jz] as the spectral
+  /// buffer. Empty until the first apply() of a gradPar() chain, and
+  /// unit phases on an identity-transform (already aligned) mesh
+  std::vector<dcomplex> gradParUpPhs, gradParDownPhs;
+  bool gradpar_phases_built = false;
+
+  /// Build the gradPar phase tables from the mesh zShift (a no-op
+  /// rebuild guard on later calls). Throws on FCI meshes
+  void buildGradParPhases(Mesh *localmesh, int nmodes);
+};
+
+#endif // __SPECTRAL_PIPELINE_H__
@@ -0,0 +1,133 @@
+/*!
+ * \file stencil_view.hxx
+ *
+ * \brief Immediate-mode stencil access to Field3D data
+ *
+ * The legacy stencil struct (stencils.hxx) gathers neighbouring values
+ * into a temporary object which is filled point-by-point and then read
+ * back — two passes over the data with poor locality. A StencilView
+ * instead wraps the raw field storage once; neighbour accesses are
+ * guaranteed-inline address arithmetic using the same offsets as the
+ * Ind3D xp/yp/zp methods in region.hxx, so the compiler sees plain
+ * indexed loads and stores it can keep in registers and vectorise.
+ *
+ * Example, operating on a z pencil:
+ *
+ *     StencilView v(f);
+ *     BoutReal *fc = v.pencil(x, y);          // f(x, y, z) = fc[z]
+ *     const BoutReal *fi = v.pencil(x-1, y);
+ *     for(int z=0; z<nz; z++)
+ *       fc[z] = 2.*value - fi[z];
+ *
+ * or using Ind3D offsets:
+ *
+ *     v[i] = 0.5*(v[i.xp()] + v[i.xm()]);
+ *
+ * The field must stay allocated, and must not be reallocated, for the
+ * lifetime of the view.
+ *
+ **************************************************************************
+ * Copyright 2010 B.D.Dudson, S.Farley, M.V.Umansky, X.Q.Xu
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+#ifndef __STENCIL_VIEW_H__
+#define __STENCIL_VIEW_H__
+
+#include "../field3d.hxx"
+#include "region.hxx"
+
+/// Ask the compiler to inline even when not optimising, so that view
+/// accessors never cost a function call in inner loops
+#ifndef BOUT_ALWAYS_INLINE
+#if defined(__GNUC__) || defined(__clang__)
+#define BOUT_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+#define BOUT_ALWAYS_INLINE inline
+#endif
+#endif
+
+/// Lightweight mutable view of a Field3D for stencil operations
+///
+/// Caches the data pointer and strides once, outside the loop; every
+/// accessor is then a single address calculation with no bounds
+/// checking, so hot loops pay nothing for going through the view
+class StencilView {
+public:
+  /// Create a view over \p f, which must be allocated
+  explicit StencilView(Field3D &f)
+      : ptr(&f(0, 0, 0)), ny(f.getNy()), nz(f.getNz()) {}
+
+  /// Value at index \p i. Neighbours are reached through the Ind3D
+  /// offset methods, e.g. view[i.xp()] or view[i.zm()]
+  BOUT_ALWAYS_INLINE BoutReal &operator[](const Ind3D &i) const {
+    return ptr[i.ind];
+  }
+
+  /// Value at (jx, jy, jz)
+  BOUT_ALWAYS_INLINE BoutReal &operator()(int jx, int jy, int jz) const {
+    return ptr[(jx * ny + jy) * nz + jz];
+  }
+
+  /// The contiguous z pencil through (jx, jy): pencil(jx, jy)[jz]
+  /// addresses f(jx, jy, jz). Hoisting pencils out of z loops removes
+  /// the per-point index arithmetic entirely
+  BOUT_ALWAYS_INLINE BoutReal *pencil(int jx, int jy) const {
+    return ptr + (jx * ny + jy) * nz;
+  }
+
+private:
+  friend class ConstStencilView;
+
+  BoutReal *ptr; ///< Start of the field data
+  int ny, nz;    ///< Sizes fixing the x and y strides
+};
+
+/// Read-only counterpart of StencilView
+class ConstStencilView {
+public:
+  /// Create a view over \p f, which must be allocated
+  explicit ConstStencilView(const Field3D &f)
+      : ptr(&f(0, 0, 0)), ny(f.getNy()), nz(f.getNz()) {}
+
+  /// A mutable view converts to a read-only one, as T* does to const T*
+  ConstStencilView(const StencilView &v) : ptr(v.ptr), ny(v.ny), nz(v.nz) {}
+
+  /// Value at index \p i
+  BOUT_ALWAYS_INLINE const BoutReal &operator[](const Ind3D &i) const {
+    return ptr[i.ind];
+  }
+
+  /// Value at (jx, jy, jz)
+  BOUT_ALWAYS_INLINE const BoutReal &operator()(int jx, int jy, int jz) const {
+    return ptr[(jx * ny + jy) * nz + jz];
+  }
+
+  /// The contiguous z pencil through (jx, jy)
+  BOUT_ALWAYS_INLINE const BoutReal *pencil(int jx, int jy) const {
+    return ptr + (jx * ny + jy) * nz;
+  }
+
+private:
+  const BoutReal *ptr; ///< Start of the field data
+  int ny, nz;          ///< Sizes fixing the x and y strides
+};
+
+#endif /* __STENCIL_VIEW_H__ */
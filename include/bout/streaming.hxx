@@ -0,0 +1,136 @@
+/**************************************************************************
+ * Streaming (non-temporal) stores and software prefetch helpers
+ *
+ * Whole-field assignments overwrite every byte of their destination,
+ * so letting the ordinary store path read-allocate the destination
+ * cache lines wastes a third of the memory traffic. When the
+ * destination is larger than the cache, streamAssign() writes it with
+ * non-temporal stores instead. Used by the generated field operators
+ * (gen_fieldops.py); BOUT_PREFETCH is available for hand-written
+ * stencil kernels whose access patterns defeat the hardware
+ * prefetchers.
+ *
+ **************************************************************************
+ * Copyright 2018 BOUT++ contributors
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+#ifndef __STREAMING_H__
+#define __STREAMING_H__
+
+#include "bout_types.hxx"
+
+#include <cstdint>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// The streaming path below uses _mm_stream_pd, which stores doubles,
+// so fall back to the plain loop when BoutReal is single precision
+#if defined(__SSE2__) && !defined(BOUT_SINGLE_PRECISION)
+#include <emmintrin.h>
+#define BOUT_HAS_STREAM_STORES 1
+#endif
+
+/// Size in bytes a destination must exceed before whole-field
+/// assignments bypass the cache. Below this the data plausibly fits in
+/// cache and will be read again before eviction, so ordinary stores
+/// win. Override at configure time with -DBOUT_STREAM_THRESHOLD_BYTES
+#ifndef BOUT_STREAM_THRESHOLD_BYTES
+#define BOUT_STREAM_THRESHOLD_BYTES (1 << 22)
+#endif
+
+/// Prefetch the cache line containing \p addr for reading. For
+/// stencil-offset loops where the hardware prefetchers cannot follow
+/// the access pattern; unit-stride streams do not need it
+#if defined(__GNUC__)
+#define BOUT_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define BOUT_PREFETCH(addr)
+#endif
+
+namespace bout {
+
+/// Whether an assignment of \p npoints BoutReals is large enough that
+/// streaming stores pay off
+inline bool streamLargeEnough(int npoints) {
+  return (static_cast<std::size_t>(npoints) * sizeof(BoutReal))
+         >= BOUT_STREAM_THRESHOLD_BYTES;
+}
+
+/// This thread's slice [start, end) of a contiguous range of \p n
+/// points. For use inside a parallel region: the split is in whole
+/// cache lines (counted from index 0), so streaming threads do not
+/// share destination lines. Without OpenMP the slice is the full range
+inline void streamChunk(int n, int &start, int &end) {
+#ifdef _OPENMP
+  const int nthreads = omp_get_num_threads();
+  const int tid = omp_get_thread_num();
+  const int perline = 64 / sizeof(BoutReal);
+  const int nlines = (n + perline - 1) / perline;
+  const int base = nlines / nthreads;
+  const int extra = nlines % nthreads;
+  const int first = tid * base + ((tid < extra) ? tid : extra);
+  const int count = base + ((tid < extra) ? 1 : 0);
+  start = first * perline;
+  end = (first + count) * perline;
+  if (start > n) {
+    start = n;
+  }
+  if (end > n) {
+    end = n;
+  }
+#else
+  start = 0;
+  end = n;
+#endif
+}
+
+/// Store kernel(i) to out[i] for i in [istart, iend), using
+/// non-temporal stores where supported so the destination lines are
+/// not read-allocated. The destination must not be read by \p kernel.
+/// Ends with a store fence, so each calling thread's streamed data is
+/// ordered before it reaches any subsequent barrier or read
+template <typename Kernel>
+inline void streamAssign(BoutReal *out, int istart, int iend, Kernel kernel) {
+#ifdef BOUT_HAS_STREAM_STORES
+  int i = istart;
+  // Scalar stores up to the first 16-byte aligned destination
+  for (; (i < iend) && ((reinterpret_cast<std::uintptr_t>(out + i) & 0xf) != 0); ++i) {
+    out[i] = kernel(i);
+  }
+  for (; i + 1 < iend; i += 2) {
+    _mm_stream_pd(out + i, _mm_set_pd(kernel(i + 1), kernel(i)));
+  }
+  for (; i < iend; ++i) {
+    out[i] = kernel(i);
+  }
+  _mm_sfence();
+#else
+  for (int i = istart; i < iend; ++i) {
+    out[i] = kernel(i);
+  }
+#endif
+}
+
+} // namespace bout
+
+#endif // __STREAMING_H__
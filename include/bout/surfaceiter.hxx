@@ -7,7 +7,10 @@ class SurfaceIter;
 #ifndef __SURFACEITER_H__
 #define __SURFACEITER_H__
 
+#include <functional>
+
 #include "mesh.hxx"
+#include "../utils.hxx"
 
 /// Iterates over Y-Z surfaces, optionally distributing work between processors
 ///
@@ -55,8 +58,32 @@ class SurfaceIter {
   void first(); ///< Begin iteration
   void next();  ///< Move to next flux surface
   bool isDone(); ///< Are we done iterating?
+
+  /// Total length in Y of the gathered surfaces (interior points only)
+  int yGlobalSize();
+
+  /// Gather the full Y profile of every surface on this processor in
+  /// one aggregated exchange, instead of one message per surface.
+  ///
+  /// Returns a contiguous slab indexed (x, yglobal) with
+  /// 0 <= yglobal < yGlobalSize(), covering the interior Y range
+  /// (guard and boundary cells are excluded), so per-surface kernels
+  /// such as flux surface averages can run vectorised over whole rows.
+  /// Every processor in the Y communicator receives the slab.
+  ///
+  /// A collective operation over the Y communicator. Like averageY,
+  /// this assumes all surfaces share the same Y decomposition
+  Matrix<BoutReal> gatherY(const Field2D &f);
+
+  /// Gather one Z plane (z = \p jz) of every surface on this
+  /// processor in one aggregated exchange. See gatherY(const Field2D&)
+  Matrix<BoutReal> gatherY(const Field3D &f, int jz);
 private:
   Mesh *m; ///< The mesh being iterated over
+
+  /// Gather implementation shared by the Field2D and Field3D
+  /// overloads: \p get returns the value at local (x, y)
+  Matrix<BoutReal> gatherYImpl(const std::function<BoutReal(int, int)> &get);
 };
 
 #endif // __SURFACEITER_H__
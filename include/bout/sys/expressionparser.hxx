@@ -27,6 +27,7 @@
 class FieldGenerator;
 class ExpressionParser;
 class ParseException;
+class GeneratorBytecode; // In bout/sys/generatorbytecode.hxx
 
 #ifndef __EXPRESSION_PARSER_H__
 #define __EXPRESSION_PARSER_H__
@@ -68,6 +69,12 @@ public:
   /// This should be deterministic, always returning the same value given the same inputs
   virtual double generate(double x, double y, double z, double t) = 0;
 
+  /// Append the operations for this node to a bytecode program,
+  /// children first (see GeneratorBytecode). The default emits a
+  /// callback to generate(), so generators which don't implement this
+  /// still evaluate correctly, just through a virtual call per point
+  virtual void compile(GeneratorBytecode &code);
+
   /// Create a string representation of the generator, for debugging output
   virtual const std::string str() {return std::string("?");}
 };
@@ -116,11 +123,34 @@ protected:
 
   /// Parses a given string into a tree of FieldGenerator objects
   FieldGeneratorPtr parseString(const std::string &input);
-  
+
+  /// Return the canonical node for the subtree described by \p key,
+  /// registering \p g if \p key has not been seen before. The parser
+  /// calls this for every node it builds, so identical subexpressions
+  /// - within one expression or across separately parsed ones - share
+  /// a single FieldGenerator node. Downstream evaluation can then
+  /// recognise repeats by address and compute them once
+  /// (see GeneratorBytecode). resolve() implementations may also call
+  /// this to make symbols shareable, using a key which includes
+  /// whatever context the symbol was looked up in
+  FieldGeneratorPtr intern(const std::string &key, FieldGeneratorPtr g);
+
+  /// The key \p g was interned under, or nullptr if it wasn't.
+  /// A node without a key can still be used; subtrees containing it
+  /// just aren't shared
+  const std::string *internKey(FieldGenerator *g) const;
+
 private:
-  
+
   std::map<std::string, FieldGeneratorPtr> gen;  ///< Generators, addressed by name
   std::map<char, std::pair<FieldGeneratorPtr, int>> bin_op; ///< Binary operations
+
+  /// Hash-consing of parsed subtrees: canonical node for each subtree
+  /// key, and the reverse mapping used to build parents' keys.
+  /// Cleared when a generator is redefined, since the interned nodes
+  /// may embed the old definition
+  std::map<std::string, FieldGeneratorPtr> interned;
+  std::map<FieldGenerator*, std::string> subtree_keys;
   
   /// Lexing info, used when splitting input into tokens
   struct LexInfo {
@@ -135,6 +165,11 @@ private:
     char nextToken(); ///< Get the next token in the string
   };
   
+  /// Build the node for \p op applied to \p lhs and \p rhs, interning
+  /// it when both children have keys
+  FieldGeneratorPtr makeBinary(char op, FieldGeneratorPtr lhs, FieldGeneratorPtr rhs,
+                               FieldGeneratorPtr node);
+
   FieldGeneratorPtr parseIdentifierExpr(LexInfo &lex);
   FieldGeneratorPtr parseParenExpr(LexInfo &lex);
 
@@ -159,6 +194,7 @@ public:
       : lhs(std::move(l)), rhs(std::move(r)), op(o) {}
   FieldGeneratorPtr clone(const std::list<FieldGeneratorPtr> args) override;
   double generate(double x, double y, double z, double t) override;
+  void compile(GeneratorBytecode &code) override;
 
   const std::string str() override {
     return std::string("(") + lhs->str() + std::string(1, op) + rhs->str() +
@@ -183,6 +219,7 @@ public:
                   double UNUSED(t)) override {
     return value;
   }
+  void compile(GeneratorBytecode &code) override;
   const std::string str() override {
     std::stringstream ss;
     ss << value;
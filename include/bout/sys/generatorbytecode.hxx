@@ -0,0 +1,159 @@
+/*!************************************************************************
+ * \file generatorbytecode.hxx
+ *
+ * Flattens a tree of FieldGenerator objects into a linear bytecode
+ * program, evaluated by a small stack machine. This removes the
+ * virtual generate() call per tree node per grid point, which
+ * dominates the cost of evaluating expressions over fine meshes.
+ *
+ * Copyright 2010 B.D.Dudson, S.Farley, M.V.Umansky, X.Q.Xu
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+class GeneratorBytecode;
+
+#ifndef __GENERATOR_BYTECODE_H__
+#define __GENERATOR_BYTECODE_H__
+
+#include "expressionparser.hxx"
+
+#include <bout_types.hxx>
+
+#include <map>
+#include <vector>
+
+/*!
+ * A bytecode program compiled from a tree of FieldGenerator nodes,
+ * via FieldGenerator::compile(). Each instruction pushes a value onto
+ * a stack or combines the values on top of it, so evaluation is a
+ * single loop with a switch on the opcode instead of a virtual call
+ * per node. Nodes which don't implement compile() are embedded as
+ * callbacks to their generate() method, so any tree can be compiled.
+ *
+ * Example:
+ *
+ *     GeneratorBytecode code(factory.parse("sin(x) * exp(-t)"));
+ *     BoutReal value = code.run(x, y, z, t);
+ */
+class GeneratorBytecode {
+public:
+  /// Compile the given generator tree. The tree is kept alive, since
+  /// nodes which can't be flattened are called through it
+  GeneratorBytecode(FieldGeneratorPtr gen);
+
+  /// Evaluate at the given coordinates. Thread-safe, provided the
+  /// generators of any embedded callback nodes are
+  BoutReal run(BoutReal x, BoutReal y, BoutReal z, BoutReal t) const;
+
+  /// Append the program for \p gen. compile() implementations should
+  /// pass their children through this rather than calling their
+  /// compile() directly: the parser shares the nodes of identical
+  /// subexpressions (see ExpressionParser::intern), and a node added
+  /// more than once is computed once, its value stored and reloaded
+  /// on the repeats
+  void add(const FieldGeneratorPtr &gen);
+
+  // Emitting routines, called by FieldGenerator::compile
+  // implementations in tree order: children first, then the operation
+
+  void emitConstant(BoutReal value);               ///< Push a fixed value
+  void emitPointer(const BoutReal *ptr);           ///< Push *ptr, read at run time
+  void emitX();                                    ///< Push the x coordinate
+  void emitY();                                    ///< Push the y coordinate
+  void emitZ();                                    ///< Push the z coordinate
+  void emitT();                                    ///< Push the time
+  void emitBinary(char op);                        ///< One of +,-,*,/,^. Pops two values
+  void emitFunc1(BoutReal (*func)(BoutReal));      ///< Apply a function to the top value
+  void emitFunc2(BoutReal (*func)(BoutReal, BoutReal)); ///< Pops two values
+  void emitGenerator(FieldGenerator *gen); ///< Fallback: push gen->generate(x,y,z,t)
+
+  /// Maximum stack depth needed to run this program
+  int stackDepth() const { return maxdepth; }
+
+  /// True if repeated runs at the same (x, y, z) always give the same
+  /// value: the program never reads the time, a runtime pointer, or
+  /// an embedded generator callback (which could do either).
+  /// FieldFactory uses this to decide whether the generated field can
+  /// be cached
+  bool cacheable() const;
+
+private:
+  enum Opcode {
+    opConstant,  ///< Push value
+    opPointer,   ///< Push *ptr
+    opX,         ///< Push x
+    opY,         ///< Push y
+    opZ,         ///< Push z
+    opT,         ///< Push t
+    opAdd,       ///< Replace top two values by their sum
+    opSub,       ///< ... difference
+    opMul,       ///< ... product
+    opDiv,       ///< ... quotient
+    opPow,       ///< ... power
+    opFunc1,     ///< Apply func1 to the top value
+    opFunc2,     ///< Replace top two values by func2 of them
+    opGenerator, ///< Push gen->generate(x,y,z,t)
+    opStore,     ///< Copy the top value into a slot, leaving it on the stack
+    opLoad       ///< Push the value of a slot
+  };
+
+  /// A single instruction: an opcode plus its operand, if any
+  struct Instr {
+    Opcode op;
+    union {
+      BoutReal value;
+      const BoutReal *ptr;
+      BoutReal (*func1)(BoutReal);
+      BoutReal (*func2)(BoutReal, BoutReal);
+      FieldGenerator *gen;
+      int slot;
+    };
+  };
+
+  /// The size of the evaluation stack in run(). Expressions needing
+  /// more than this fall back to calling the tree directly
+  static const int max_stack = 64;
+
+  /// The number of value slots available for common subexpressions.
+  /// Shared subtrees beyond this are recomputed instead
+  static const int max_slots = 64;
+
+  /// Append an instruction which pops \p npop values and pushes one
+  void emit(const Instr &ins, int npop);
+
+  void emitStore(int slot); ///< Copy the top value into \p slot
+  void emitLoad(int slot);  ///< Push the value of \p slot
+
+  std::vector<Instr> code; ///< The program, in evaluation order
+  FieldGeneratorPtr root;  ///< Keeps the generator tree alive
+
+  int depth;    ///< Current stack depth while compiling
+  int maxdepth; ///< Largest stack depth reached
+
+  // Common subexpression elimination, used while compiling: the
+  // constructor makes a counting pass first, so the emitting pass
+  // knows which nodes repeat and are worth a slot
+  bool counting;                          ///< In the counting pass?
+  int nslots;                             ///< Slots assigned so far
+  std::map<FieldGenerator*, int> uses;    ///< add() calls per node
+  std::map<FieldGenerator*, int> slot_of; ///< Slot caching each shared node's value
+};
+
+#endif // __GENERATOR_BYTECODE_H__
@@ -0,0 +1,101 @@
+
+class HwCounters;
+
+#ifndef __HWCOUNTERS_H__
+#define __HWCOUNTERS_H__
+
+#include <map>
+#include <string>
+
+/*!
+ * Hardware performance counters per Timer scope
+ *
+ * Timings say where the run spends its time; deciding what to do
+ * about a hot region needs its arithmetic intensity — how much
+ * computation per byte moved. When enabled ([hwcounters]
+ * enabled=true), every Timer scope also snapshots a small set of CPU
+ * counters through the Linux perf_event interface: cycles,
+ * instructions, last-level cache misses, and optionally a
+ * floating-point operation count. The deltas are accumulated per
+ * path of nested scopes, the same keys as the Timer report, and
+ * getReport() reduces them across processors into a table of the
+ * hottest paths with derived columns: instructions per cycle, data
+ * moved (cache misses times line size) and FLOP per byte.
+ *
+ * FLOP counters are microarchitecture specific, so the event is
+ * given as a raw code in the input ([hwcounters] flops_event =
+ * "0x..."; see "perf list" and the vendor event tables; scalar and
+ * vector FP events may need separate runs). Without it the FLOP and
+ * intensity columns are omitted. With the machine's peak rates
+ * configured ([hwcounters] peak_gflops, peak_gbytes), each region is
+ * also positioned against the roofline ridge point: below it the
+ * region is bandwidth bound and wants locality or fusion work, above
+ * it compute bound and wants vectorisation.
+ *
+ * The cost per Timer scope is one counter read per event (a short
+ * syscall each), so this is cheap for the coarse scopes (rhs, comms,
+ * invert) but not free for very fine ones. Counters are opened with
+ * inherit set, so threads started afterwards (e.g. the OpenMP pool)
+ * are included. Needs kernel.perf_event_paranoid <= 2; enable()
+ * reports and disables itself when the events cannot be opened.
+ */
+class HwCounters {
+public:
+  /// Counter slots. FLOPS is only counted when a raw event code was
+  /// configured
+  enum CounterKind { CYCLES = 0, INSTRUCTIONS, CACHE_MISSES, FLOPS, NCOUNTERS };
+
+  /*!
+   * Open the counters and turn on per-scope sampling. \p flops_raw
+   * is the raw PMU event code counting floating-point operations, or
+   * 0 for none. \p line_size is the cache line size in bytes used to
+   * convert misses to data moved. \p peak_gflops and \p peak_gbytes
+   * give the machine peaks for roofline positioning, or 0 to skip it
+   */
+  static void enable(long long flops_raw, int line_size, double peak_gflops,
+                     double peak_gbytes);
+
+  /*!
+   * Is counter sampling turned on? Recording call sites guard on
+   * this, so disabled counters cost one predictable branch
+   */
+  static bool enabled() { return is_enabled; }
+
+  /// Read the current counter values into \p counts, one per slot;
+  /// unopened slots read as zero
+  static void snapshot(long long counts[NCOUNTERS]);
+
+  /// Accumulate the difference since \p start into the totals for
+  /// \p path, the Timer scope path (e.g. "run/rhs/comms")
+  static void accumulate(const std::string &path, const long long start[NCOUNTERS]);
+
+  /*!
+   * A table of the \p top_n paths with the most cycles, with the
+   * derived per-path columns summed across processors.
+   *
+   * Collective: must be called on all processors, and returns the
+   * report on rank 0, an empty string elsewhere.
+   */
+  static std::string getReport(int top_n = 10);
+
+  /// Close the counters and free the totals
+  static void cleanup();
+
+private:
+  /// Accumulated counter deltas and scope count for one path
+  struct totals_info {
+    long long counts[NCOUNTERS] = {0, 0, 0, 0};
+    int hits = 0;
+  };
+
+  static bool is_enabled;
+  static int fds[NCOUNTERS]; ///< perf event descriptors, -1 if not open
+  static int cache_line;     ///< Bytes per cache miss
+  static bool have_flops;    ///< Was a FLOP event configured and opened?
+  static double peak_flops;  ///< Machine peak, GFLOP/s (0: unknown)
+  static double peak_bytes;  ///< Machine peak, GB/s (0: unknown)
+
+  static std::map<std::string, totals_info> totals; ///< Deltas per Timer path
+};
+
+#endif // __HWCOUNTERS_H__
@@ -0,0 +1,112 @@
+class StepPipeline;
+
+#ifndef __STEPPIPELINE_H__
+#define __STEPPIPELINE_H__
+
+#include "bout_types.hxx"
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+class Field3D;
+
+/*!
+ * Cross-step pipeline coordinator
+ *
+ * Several pieces of the output path can run in the background while
+ * the solver integrates the next output step: asynchronous Datafile
+ * writes, AsyncMonitor diagnostics, in-situ analysis. Each enforces
+ * its own local ordering (at most one call in flight, wait before the
+ * next dispatch), but nothing showed whether the intended overlap
+ * actually happens, or whether a monitor quietly breaks the
+ * assumption the overlap rests on by modifying the evolving state.
+ *
+ * The pipeline records the phases of each output step: the monitor
+ * stages run on the solver thread, the integration window between
+ * output steps, and the background windows reported by the
+ * asynchronous components. When enabled (solver option
+ * trace_pipeline=true) it prints one timeline line per output step,
+ * giving the duration of each phase and, for each background window,
+ * how much of it overlapped integration:
+ *
+ *     Pipeline step 12: monitors 0.014 s [0: 0.002, 1: 0.012], integrate 0.813 s,
+ *       background dump write 0.341 s (0.338 overlapped)
+ *
+ * A background window that overlaps nothing is the signal that a
+ * synchronous stage is serialising the pipeline.
+ *
+ * Data hazards are checked with the field generation counters: the
+ * solver guards its evolving fields at the start of the monitor
+ * phase, and a field whose generation has advanced by the end of the
+ * phase was written by a monitor. Background consumers read
+ * copy-on-write snapshots taken at dispatch, so such a write makes
+ * the snapshot order ill-defined and the overlap unsafe; it is
+ * reported once as a warning.
+ *
+ * The solver-thread interface (stepBegin, stageBegin/stageEnd, guard,
+ * stepEnd) is called from Solver::call_monitors. backgroundBegin/End
+ * may be called from any thread.
+ */
+class StepPipeline {
+public:
+  /// Switch on the per-step timeline trace. Called by Solver::solve
+  /// when the solver option trace_pipeline is set
+  static void enable();
+
+  /// Start the monitor phase of output step \p iter: closes the
+  /// integration window and reports the previous step's timeline
+  static void stepBegin(int iter, BoutReal simtime);
+
+  /// Bracket one synchronous monitor stage on the solver thread
+  static void stageBegin(const std::string &name);
+  static void stageEnd();
+
+  /// Record the current generation of an evolving field; checked
+  /// against the field at stepEnd to detect monitors writing state
+  static void guard(const Field3D *field, const std::string &name);
+
+  /// End the monitor phase: verifies the guarded fields are
+  /// unmodified and opens the integration window of the next step
+  static void stepEnd();
+
+  /// Bracket a background window (an asynchronous write or monitor
+  /// body). May be called from any thread; windows are matched by
+  /// \p what, which works because each asynchronous component allows
+  /// only one call in flight
+  static void backgroundBegin(const std::string &what);
+  static void backgroundEnd(const std::string &what);
+
+private:
+  /// A named interval of wall-clock time
+  struct Window {
+    std::string name;
+    double start;
+    double stop;
+  };
+
+  /// A guarded field and its generation at the start of the monitor phase
+  struct Guard {
+    const Field3D *field;
+    std::string name;
+    unsigned int generation;
+  };
+
+  static bool is_enabled;
+  static bool have_previous;     ///< A completed step is ready to report
+  static int current_iter;       ///< Output step whose monitor phase is running
+  static double phase_start;     ///< Start of the current monitor phase
+  static double integrate_start; ///< Start of the current integration window
+  static double monitors_time;   ///< Monitor phase duration of the completed step
+
+  static std::vector<Window> stages;     ///< Monitor stages of the completed step
+  static std::vector<Guard> guards;      ///< Fields guarded this monitor phase
+  static std::vector<std::string> warned; ///< Hazards already reported
+
+  // Background windows are opened and closed from worker threads
+  static std::mutex background_mutex;
+  static std::vector<Window> background_open;
+  static std::vector<Window> background_done;
+};
+
+#endif // __STEPPIPELINE_H__
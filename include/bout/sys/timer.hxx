@@ -7,6 +7,8 @@ class Timer;
 #include <map>
 #include <string>
 
+#include <bout/sys/hwcounters.hxx>
+
 /*!
  * Timing class for performance benchmarking and diagnosis
  *
@@ -74,7 +76,17 @@ public:
    * Clears all timers, freeing memory
    */
   static void cleanup();
-  
+
+  /*!
+   * A report of where time was spent, as a table of the \p top_n
+   * hottest paths of nested Timer scopes (e.g. "run/rhs/comms"),
+   * with the minimum, mean and maximum total time across processors.
+   *
+   * Collective: must be called on all processors, and returns the
+   * report on rank 0, an empty string elsewhere.
+   */
+  static std::string getPerformanceReport(int top_n = 10);
+
 private:
   /// Structure to contain timing information
   struct timer_info {
@@ -82,12 +94,30 @@ private:
     bool running;   ///< Is the timer currently running?
     double started; ///< Start time
   };
-  
+
   static std::map<std::string, timer_info*> info;
-  
+
   static timer_info *getInfo(const std::string &label);
-  
+
   timer_info* timing;
+
+  /// Accumulated time and number of scopes for a path of nested timers
+  struct path_info {
+    double time = 0.0;
+    int hits = 0;
+  };
+
+  static std::map<std::string, path_info> paths; ///< Timing per path, e.g. "run/rhs/comms"
+  static std::string current_path;               ///< Path of the innermost running Timer
+
+  std::string path;        ///< This timer's place in the scope tree
+  std::string parent_path; ///< Restored to current_path on destruction
+  double hier_started;     ///< Start time of this scope. Unlike timing->started,
+                           ///< not shared with other timers using the same label
+
+  /// Counter values at scope entry, when hardware counter sampling
+  /// is enabled (see bout/sys/hwcounters.hxx)
+  long long hw_start[HwCounters::NCOUNTERS];
 };
 
 #endif // __TIMER_H__
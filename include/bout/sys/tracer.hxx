@@ -0,0 +1,91 @@
+
+class Tracer;
+
+#ifndef __TRACER_H__
+#define __TRACER_H__
+
+#include <string>
+#include <vector>
+
+/*!
+ * Timeline tracing of scoped events
+ *
+ * Timer totals show where time goes, but not when: a communicate that
+ * stalls once per output step and an I/O burst look the same in the
+ * accumulated report. When tracing is enabled ([trace] enabled=true),
+ * every Timer scope and MsgStack point is appended to a per-processor
+ * ring buffer of fixed-size binary records with nanosecond
+ * timestamps. Recording is a bounds check and three stores, so it can
+ * stay on in production runs.
+ *
+ * The buffer is flushed by write() at the end of the run, one file
+ * per processor in the Trace Event format that standard timeline
+ * viewers (chrome://tracing, Perfetto) read directly. When the ring
+ * wraps, the oldest events are overwritten, so a flushed file covers
+ * the most recent [trace] buffer_size events; viewers tolerate the
+ * unmatched end events this leaves at the start of the file.
+ */
+class Tracer {
+public:
+  /*!
+   * Turn on tracing, with room for \p nevents events per processor
+   * before the ring wraps. Records the time origin, so should be
+   * called once, at startup
+   */
+  static void enable(int nevents);
+
+  /*!
+   * Is tracing turned on? Recording call sites guard on this, so
+   * a disabled tracer costs one predictable branch
+   */
+  static bool enabled() { return is_enabled; }
+
+  /// Open a scope named \p label. The label is interned, so the
+  /// caller's string need not outlive the call
+  static void begin(const std::string &label);
+
+  /// Close the innermost open scope
+  static void end();
+
+  /// A point event, e.g. a MsgStack message. The string is interned
+  static void instant(const std::string &label);
+
+  /// A point event whose name has static storage (a string literal),
+  /// recorded without interning
+  static void instant(const char *name);
+
+  /*!
+   * Flush this processor's ring to \p basename.<rank>.json in Trace
+   * Event format, oldest event first. Each processor writes its own
+   * file; they can be viewed individually, or merged by
+   * concatenating the per-rank event lists
+   */
+  static void write(const std::string &basename);
+
+  /// Discard the ring and interned names, freeing memory
+  static void cleanup();
+
+private:
+  /// One binary trace record
+  struct Event {
+    const char *name;  ///< Interned label, or nullptr for end events
+    long long time_ns; ///< Nanoseconds since enable()
+    char phase;        ///< 'B' begin, 'E' end, 'i' instant
+  };
+
+  static bool is_enabled;
+  static std::vector<Event> ring;
+  static std::vector<Event>::size_type next; ///< Slot the next event overwrites
+  static bool wrapped; ///< Has the ring overwritten old events?
+
+  /// Copy \p label into storage that outlives the ring, returning
+  /// a pointer that compares equal for equal labels
+  static const char *intern(const std::string &label);
+
+  /// Nanoseconds since enable()
+  static long long now();
+
+  static void record(char phase, const char *name);
+};
+
+#endif // __TRACER_H__
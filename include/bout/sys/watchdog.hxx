@@ -0,0 +1,75 @@
+class Watchdog;
+
+#ifndef __WATCHDOG_H__
+#define __WATCHDOG_H__
+
+#include "bout_types.hxx"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+/*!
+ * Per-processor stall watchdog
+ *
+ * When one processor wedges (a bad MPI state, a hung filesystem),
+ * nothing is learned until the whole job hits its time limit. When the
+ * watchdog is enabled ([watchdog] enabled=true), a monitoring thread
+ * on each processor watches a heartbeat counter incremented from the
+ * hot paths (run_rhs, communicate, Datafile::write). If the counter
+ * stops advancing for longer than [watchdog] timeout seconds, the
+ * thread writes a diagnosis to stderr: the phase the processor was in
+ * when it stalled, the message stack and the timer report. With
+ * [watchdog] abort=true it then calls MPI_Abort, so the allocation is
+ * freed instead of idling until the job times out.
+ *
+ * Recording a heartbeat is two relaxed atomic stores, so the beats can
+ * stay in the hot paths in production runs. The diagnosis is written
+ * from the monitoring thread while the stalled thread sits in a
+ * blocking call, so the message and timer stacks it reads are
+ * quiescent; no locks the stalled thread could hold are taken.
+ */
+class Watchdog {
+public:
+  /*!
+   * Start the monitoring thread. \p timeout is the stall threshold in
+   * seconds; it should comfortably exceed the longest healthy gap
+   * between heartbeats (e.g. a slow implicit solver internal step).
+   * If \p abort_on_stall is set, a diagnosed stall calls MPI_Abort
+   * after writing the report
+   */
+  static void enable(BoutReal timeout, bool abort_on_stall);
+
+  /// Stop and join the monitoring thread. Called at finalisation, and
+  /// safe to call when not enabled
+  static void disable();
+
+  /*!
+   * Record liveness. \p phase must have static storage (a string
+   * literal), since only the pointer is stored
+   */
+  static void beat(const char *phase) {
+    if (!is_enabled)
+      return;
+    current_phase.store(phase, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+  }
+
+private:
+  static bool is_enabled;
+  static std::atomic<uint64_t> count;            ///< Heartbeat counter
+  static std::atomic<const char *> current_phase; ///< Last heartbeat location
+
+  static std::atomic<bool> run; ///< Cleared to stop the monitor thread
+  static std::thread monitor_thread;
+  static BoutReal timeout;      ///< Stall threshold in seconds
+  static bool abort_on_stall;   ///< Call MPI_Abort after diagnosing?
+  static int mype;              ///< Processor rank, cached at enable()
+
+  /// Body of the monitoring thread
+  static void monitorLoop();
+  /// Write the stall diagnosis to stderr
+  static void reportStall(BoutReal stalled_for);
+};
+
+#endif // __WATCHDOG_H__
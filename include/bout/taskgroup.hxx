@@ -0,0 +1,136 @@
+/************************************************************************//**
+ * \brief Task-level parallelism on top of OpenMP tasks
+ *
+ * BOUT_FOR parallelises single loops, but a physics RHS often contains
+ * several independent coarse pieces of work (Laplacian inversions,
+ * boundary applications, diagnostics) which serialise against each
+ * other. TaskGroup lets such pieces be submitted as tasks which the
+ * OpenMP runtime schedules across cores with work stealing, so a rank
+ * with more cores than loop parallelism still keeps them busy.
+ *
+ **************************************************************************
+ * Copyright 2018
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+#ifndef __TASKGROUP_H__
+#define __TASKGROUP_H__
+
+#include "openmpwrap.hxx"
+
+#include <exception>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace bout {
+
+/// A group of independent tasks run in parallel by the OpenMP runtime
+///
+/// Usage, e.g. in a PhysicsModel::rhs:
+///
+///     bout::TaskGroup tasks;
+///     tasks.add([&]() { ddt(Ni) = ...; });
+///     tasks.add([&]() { ddt(Vort) = ...; });
+///     tasks.wait(); // Runs the tasks, returns when all have finished
+///
+/// Tasks must not depend on each other; within a task the usual
+/// BOUT_FOR / BOUT_OMP loops may still be used (they become nested
+/// parallelism, which OpenMP serialises unless enabled).
+///
+/// wait() cooperates with existing BOUT_OMP usage: called outside a
+/// parallel region it opens one, called inside it just spawns tasks
+/// into the enclosing region. Tasks are scheduled by the OpenMP
+/// runtime, which steals work between idle threads. Without OpenMP the
+/// tasks run serially in submission order.
+///
+/// If tasks throw, the first exception is rethrown from wait() on the
+/// submitting thread.
+class TaskGroup {
+public:
+  /// Submit a task. Not thread safe: submit from one thread, before wait()
+  void add(std::function<void()> task) { tasks.push_back(std::move(task)); }
+
+  /// Run all submitted tasks and block until they have finished,
+  /// then clear the group so it can be reused.
+  /// Rethrows the first exception thrown by a task
+  void wait() {
+#ifdef _OPENMP
+    if (omp_in_parallel()) {
+      // Already in a parallel region: spawn into it
+      spawnTasks();
+    } else {
+      BOUT_OMP(parallel)
+      BOUT_OMP(single)
+      { spawnTasks(); }
+    }
+#else
+    for (const auto &task : tasks) {
+      runTask(task);
+    }
+#endif
+    tasks.clear();
+
+    if (first_exception) {
+      std::exception_ptr e = first_exception;
+      first_exception = nullptr;
+      std::rethrow_exception(e);
+    }
+  }
+
+  /// Number of tasks submitted and not yet run
+  int size() const { return static_cast<int>(tasks.size()); }
+
+private:
+  /// Create one OpenMP task per submitted task, and wait for them
+  void spawnTasks() {
+    for (std::size_t i = 0; i < tasks.size(); i++) {
+      BOUT_OMP(task firstprivate(i))
+      { runTask(tasks[i]); }
+    }
+    BOUT_OMP(taskwait)
+  }
+
+  /// Run a single task, capturing the first exception so it can be
+  /// rethrown on the submitting thread rather than terminating
+  void runTask(const std::function<void()> &task) {
+    try {
+      task();
+    } catch (...) {
+      BOUT_OMP(critical(BoutTaskGroup))
+      {
+        if (!first_exception) {
+          first_exception = std::current_exception();
+        }
+      }
+    }
+  }
+
+  std::vector<std::function<void()>> tasks; ///< Submitted, not yet run
+  std::exception_ptr first_exception;       ///< First failure, if any
+};
+
+} // namespace bout
+
+#endif // __TASKGROUP_H__
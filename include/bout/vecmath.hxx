@@ -0,0 +1,137 @@
+/*!
+ * \file vecmath.hxx
+ *
+ * \brief Vectorisable polynomial kernels for transcendental functions
+ *
+ * libm calls defeat SIMD: a loop calling exp() per point runs one
+ * scalar call per element. The kernels here are branch-light inline
+ * polynomials marked "omp declare simd", so loops over them vectorise
+ * across the full register width.
+ *
+ * This is the fast precision mode: results are accurate to a few ulp
+ * over the normal range, but the special cases are simplified - no
+ * errno, overflow goes to infinity, fast_exp flushes results below
+ * the normal range to zero, and fast_log of a negative number returns
+ * NaN without raising anything. Use the libm-backed field functions
+ * where exact special-case handling matters.
+ *
+ **************************************************************************
+ * Copyright 2010 B.D.Dudson, S.Farley, M.V.Umansky, X.Q.Xu
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+#ifndef __VECMATH_H__
+#define __VECMATH_H__
+
+#include "bout/openmpwrap.hxx"
+
+#include <cmath>
+#include <cstring>
+
+namespace bout {
+
+/// e to the power \p x. Cody-Waite reduction x = n*ln2 + r with
+/// |r| <= ln2/2, a degree-12 polynomial for exp(r), and the 2^n scale
+/// applied by constructing the exponent bits directly
+BOUT_OMP(declare simd)
+inline double fast_exp(double x) {
+  if (x > 709.0) {
+    return HUGE_VAL; // Overflows double
+  }
+  if (x < -708.0) {
+    return 0.0; // Subnormal or smaller: flushed to zero
+  }
+
+  const double log2e = 1.4426950408889634074;
+  const double ln2_hi = 6.93147180369123816490e-01;
+  const double ln2_lo = 1.90821492927058770002e-10;
+
+  const double n = std::floor(x * log2e + 0.5);
+  double r = x - n * ln2_hi;
+  r -= n * ln2_lo;
+
+  // exp(r) by Horner; |r| <= 0.347 so the truncation error of the
+  // degree-12 series is below one ulp
+  double p = 1.0 / 479001600.0;
+  p = p * r + 1.0 / 39916800.0;
+  p = p * r + 1.0 / 3628800.0;
+  p = p * r + 1.0 / 362880.0;
+  p = p * r + 1.0 / 40320.0;
+  p = p * r + 1.0 / 5040.0;
+  p = p * r + 1.0 / 720.0;
+  p = p * r + 1.0 / 120.0;
+  p = p * r + 1.0 / 24.0;
+  p = p * r + 1.0 / 6.0;
+  p = p * r + 0.5;
+  p = p * r + 1.0;
+  p = p * r + 1.0;
+
+  // 2^n, n in [-1022, 1023] given the clamps above
+  const long long bits = (static_cast<long long>(n) + 1023LL) << 52;
+  double two_n;
+  std::memcpy(&two_n, &bits, sizeof(double));
+
+  return p * two_n;
+}
+
+/// Natural logarithm of \p x. The mantissa is brought into
+/// [sqrt(2)/2, sqrt(2)) and its log evaluated from the atanh series
+/// in s = (m-1)/(m+1), |s| <= 0.172
+BOUT_OMP(declare simd)
+inline double fast_log(double x) {
+  if (x <= 0.0) {
+    return (x == 0.0) ? -HUGE_VAL : std::nan("");
+  }
+
+  long long bits;
+  std::memcpy(&bits, &x, sizeof(double));
+
+  long long e = ((bits >> 52) & 0x7ffLL) - 1022LL;
+  const long long mbits =
+      (bits & 0x000fffffffffffffLL) | 0x3fe0000000000000LL; // m in [0.5, 1)
+  double m;
+  std::memcpy(&m, &mbits, sizeof(double));
+
+  if (m < 0.70710678118654752440) {
+    m *= 2.0;
+    e -= 1;
+  }
+
+  const double s = (m - 1.0) / (m + 1.0);
+  const double s2 = s * s;
+
+  double p = 1.0 / 19.0;
+  p = p * s2 + 1.0 / 17.0;
+  p = p * s2 + 1.0 / 15.0;
+  p = p * s2 + 1.0 / 13.0;
+  p = p * s2 + 1.0 / 11.0;
+  p = p * s2 + 1.0 / 9.0;
+  p = p * s2 + 1.0 / 7.0;
+  p = p * s2 + 1.0 / 5.0;
+  p = p * s2 + 1.0 / 3.0;
+  p = p * s2 + 1.0;
+  p *= 2.0 * s;
+
+  return p + static_cast<double>(e) * 0.69314718055994530942;
+}
+
+} // namespace bout
+
+#endif // __VECMATH_H__
@@ -0,0 +1,138 @@
+/**************************************************************************
+ * Region-of-interest output windows
+ *
+ **************************************************************************
+ * Copyright 2018 B.D.Dudson
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+class WindowFile;
+
+#ifndef __WINDOWFILE_H__
+#define __WINDOWFILE_H__
+
+#include "bout_types.hxx"
+#include "options.hxx"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class DataFormat;
+class Field3D;
+class Solver;
+
+/*!
+ * Writes registered fields inside a global index box to a
+ * per-processor binary file at its own (usually high) cadence, so
+ * small regions of interest such as an X-point or divertor target can
+ * be resolved in time without dumping global 3D fields. Usage, e.g.
+ * in PhysicsModel::init:
+ *
+ *     window = WindowFile(Options::getRoot()->getSection("window_xpoint"),
+ *                         "xpoint");
+ *     window.add(Ni, "Ni");
+ *     window.add(Te, "Te");
+ *     window.open("%s/BOUT.window_xpoint.%s", data_dir, dump_ext);
+ *     window.enable(solver); // Sample every internal timestep
+ *
+ * The window is a box in global (x, y) and local z indices, read from
+ * the options section: xmin, xmax, ymin, ymax, zmin, zmax (inclusive;
+ * y and z default to the full range) and "every", the number of
+ * internal timesteps between samples. Each processor owning part of
+ * the box writes only its intersection, as record (time-evolving)
+ * variables in a file whose x, y, z dimensions are the local window
+ * sizes; the global origin of the local box is stored in the
+ * variables window_x0, window_y0, window_z0 so the pieces can be
+ * reassembled. Processors owning no part of the box write nothing.
+ */
+class WindowFile {
+public:
+  WindowFile() {}
+  /// Configure a window named \p name from the options in \p opt.
+  /// Reads "enabled" (default true), "every" (default 1) and the
+  /// index box xmin/xmax/ymin/ymax/zmin/zmax
+  WindowFile(Options *opt, const std::string &name);
+  WindowFile(WindowFile &&other) noexcept;
+  ~WindowFile();
+
+  WindowFile& operator=(WindowFile &&rhs) noexcept;
+  WindowFile& operator=(const WindowFile &rhs) = delete;
+
+  /// Register a field to be written. Like Datafile, a pointer to the
+  /// field is kept, so it must not go out of scope. Fields must be
+  /// registered before the first sample is taken
+  void add(const Field3D &f, const std::string &name);
+
+  /// Open this processor's file; the name passed is a base including
+  /// the extension (which selects the format), to which the
+  /// processor number is appended as for dump files. Processors
+  /// owning no part of the window open nothing
+  bool open(const char *format, ...);
+
+  void close(); ///< Flush and close the file
+
+  /// Append one record: the time \p t and every registered field's
+  /// window values. Only every "every"-th call writes; the variables
+  /// are created before the first record
+  void sample(BoutReal t);
+
+  void flush(); ///< Flush records to the file
+
+  /// Sample on internal timesteps taken by \p solver
+  void enable(Solver *solver);
+  /// Stop sampling; the file stays open until close()
+  void disable(Solver *solver);
+
+private:
+  /// A registered field
+  struct Var {
+    const Field3D *ptr; ///< Pointer to the field; may be a user object
+    std::string name;   ///< Name of the variable in the file
+  };
+
+  bool enabled{true};
+  int every{1};         ///< Internal timesteps between samples
+  std::string name;     ///< Window name, for messages
+
+  /// Requested global index box (inclusive); -1 means the full range
+  int xmin{0}, xmax{-1}, ymin{0}, ymax{-1}, zmin{0}, zmax{-1};
+
+  /// Locally owned part of the box: start (local indices) and count
+  int lx0{0}, lxn{0}, ly0{0}, lyn{0}, lz0{0}, lzn{0};
+  /// Global indices of the local box origin, for reassembly
+  int gx0{0}, gy0{0}, gz0{0};
+  bool have_data{false}; ///< Does this processor own part of the box?
+
+  std::unique_ptr<DataFormat> file;
+  int mype{0};
+  bool first_time{true}; ///< Variables not yet created?
+  int steps{0};          ///< Timesteps since the last sample
+
+  std::vector<Var> vars;
+  std::vector<BoutReal> buffer; ///< Staging space for one field's box
+
+  /// Work out this processor's intersection with the requested box
+  void computeIntersection();
+  /// Create the file variables, called before the first record
+  void addVariables();
+};
+
+#endif // __WINDOWFILE_H__
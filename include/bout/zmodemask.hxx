@@ -0,0 +1,92 @@
+/*!
+ * \file zmodemask.hxx
+ *
+ * \brief Radially-varying z mode truncation
+ *
+ * Turbulence amplitude varies strongly across the radius: the outer
+ * SOL typically carries far fewer z modes than the core, but every
+ * spectral loop runs over the global nz. ZModeMask holds a per-x
+ * maximum mode number, settable from the input file as an expression
+ * in x or adapted at run time from a field's z spectrum. The
+ * mode-batched kernels (ShiftedMetric transforms, the
+ * SpectralPipeline zMask() stage, filter()) multiply only the kept
+ * modes and zero the rest, so their cost scales with the local
+ * physical content instead of nz.
+ *
+ * Configured from the [zmask] section:
+ *
+ *     [zmask]
+ *     enabled = true
+ *     zmax = 16 + 48*H(0.5 - x)  # Modes kept: expression in x (and y)
+ *     margin = 2                 # Extra modes kept by adaptFromSpectrum
+ *
+ * Truncation changes the answer wherever the discarded modes are not
+ * negligible; the mask is a resolution choice, like nz itself.
+ *
+ **************************************************************************
+ * Copyright 2010 B.D.Dudson, S.Farley, M.V.Umansky, X.Q.Xu
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+#ifndef __ZMODEMASK_H__
+#define __ZMODEMASK_H__
+
+#include "bout_types.hxx"
+
+#include <vector>
+
+class Field3D;
+
+class ZModeMask {
+public:
+  /// Is per-x mode truncation turned on? Reads the [zmask] options on
+  /// the first call
+  static bool enabled();
+
+  /// Highest kept mode number at local x index \p jx: modes
+  /// jz <= zmax(jx) are kept, higher ones treated as zero
+  static int zmax(int jx);
+
+  /// The largest zmax over this processor's x indices, e.g. for
+  /// setting a matching global maxmode on a Laplacian inversion
+  static int maxZmax();
+
+  /// Recompute the mask from the z spectrum of \p f: at each x, modes
+  /// are kept up to the highest one whose amplitude (averaged over the
+  /// interior y points) exceeds \p threshold times the peak amplitude
+  /// at that x, plus the configured margin. Call between timesteps,
+  /// on a representative field
+  static void adaptFromSpectrum(const Field3D &f, BoutReal threshold = 1e-6);
+
+  /// \p f with each x index truncated to its kept modes, one
+  /// transform round trip
+  static const Field3D filter(const Field3D &f);
+
+private:
+  static bool is_enabled;
+  static bool configured;
+  static int margin;             ///< Extra modes kept by adaptFromSpectrum
+  static std::vector<int> zmax_x; ///< Highest kept mode per local x index
+
+  /// Read the [zmask] options and build the initial mask
+  static void configure();
+};
+
+#endif // __ZMODEMASK_H__
@@ -27,8 +27,19 @@
 #include <map>
 #include <limits>
 
-/// Size of real numbers
+/// Size of real numbers. Fields can be stored in single precision by
+/// adding -DBOUT_SINGLE_PRECISION to BOUT_FLAGS (see make.config),
+/// halving the memory traffic of bandwidth-bound runs at the cost of
+/// accuracy. Reductions and the time-integrator state always
+/// accumulate in double; interfaces to external libraries (file
+/// formats, SUNDIALS, FFTW) continue to exchange double
+#ifdef BOUT_SINGLE_PRECISION
+typedef float BoutReal;
+#define BOUT_MPI_REAL MPI_FLOAT
+#else
 typedef double BoutReal;
+#define BOUT_MPI_REAL MPI_DOUBLE
+#endif
 
 /// Quiet NaN
 const BoutReal BoutNaN = std::numeric_limits<BoutReal>::quiet_NaN();
@@ -49,6 +49,9 @@ public:
   static int rank(); ///< Rank: my processor number
   static int size(); ///< Size: number of processors
 
+  /// True if MPI may be called from any thread (MPI_THREAD_MULTIPLE)
+  static bool threadSafe();
+
   // Setting options
   void setComm(MPI_Comm c);
 
@@ -54,6 +54,8 @@
 
 #include "bout/openmpwrap.hxx"
 
+#include <vector>
+
 template <class T> class CyclicReduce {
 public:
   CyclicReduce() {
@@ -253,10 +255,6 @@ public:
         coefs(j, 4 * i + 3) = rhs(j, i);
       }
 
-    ///////////////////////////////////////
-    // Reduce local part of the matrix to interface equations
-    reduce(Nsys, N, coefs, myif);
-
     ///////////////////////////////////////
     // Gather all interface equations onto single processor
     // NOTE: Need to replace with divide-and-conquer at some point
@@ -279,10 +277,9 @@ public:
     int ns = Nsys / nprocs;      // Number of systems to assign to all processors
     int nsextra = Nsys % nprocs; // Number of processors with 1 extra
 
-    MPI_Request *req = new MPI_Request[nprocs];
-
     if (myns > 0) {
-      // Post receives from all other processors
+      // Post receives from all other processors before doing any local
+      // reduction, so transfers can begin as soon as chunks arrive
       req[myproc] = MPI_REQUEST_NULL;
       for (int p = 0; p < nprocs; p++) { // Loop over processor
         // 2 interface equations per processor
@@ -290,13 +287,7 @@ public:
         // 3 coefficients + 1 RHS value
         int len = 2 * myns * 4 * sizeof(T); // Length of data in bytes
 
-        if (p == myproc) {
-          // Just copy the data
-	  BOUT_OMP(parallel for)
-          for (int i = 0; i < myns; i++)
-            for (int j = 0; j < 8; j++)
-              ifcs(i, 8 * p + j) = myif(sys0 + i, j);
-        } else {
+        if (p != myproc) {
 #ifdef DIAGNOSE
           output << "Expecting to receive " << len << " from " << p << endl;
 #endif
@@ -310,24 +301,38 @@ public:
       }
     }
 
-    // Send data
+    // Reduce the local part of the matrix to interface equations one
+    // destination chunk at a time, sending each chunk as soon as it is
+    // ready: the network transfers earlier chunks while later ones are
+    // still being computed
     int s0 = 0;
     for (int p = 0; p < nprocs; p++) { // Loop over processor
       int nsp = ns;
       if (p < nsextra)
         nsp++;
-      if ((p != myproc) && (nsp > 0)) {
+      sendreq[p] = MPI_REQUEST_NULL;
+      if (nsp > 0) {
+        reduce(s0, s0 + nsp, N, coefs, myif);
+        if (p != myproc) {
 #ifdef DIAGNOSE
-        output << "Sending to " << p << endl;
-        for (int i = 0; i < 8; i++)
-          output << "value " << i << " : " << myif(s0, i) << endl;
+          output << "Sending to " << p << endl;
+          for (int i = 0; i < 8; i++)
+            output << "value " << i << " : " << myif(s0, i) << endl;
 #endif
-        MPI_Send(&myif(s0, 0),        // Data pointer
-                 8 * nsp * sizeof(T), // Number
-                 MPI_BYTE,            // Type
-                 p,                   // Destination
-                 myproc,              // Message identifier
-                 comm);               // Communicator
+          MPI_Isend(&myif(s0, 0),        // Data pointer
+                    8 * nsp * sizeof(T), // Number
+                    MPI_BYTE,            // Type
+                    p,                   // Destination
+                    myproc,              // Message identifier
+                    comm,                // Communicator
+                    &sendreq[p]);        // Request
+        } else {
+          // This processor's own chunk: just copy the data
+	  BOUT_OMP(parallel for)
+          for (int i = 0; i < myns; i++)
+            for (int j = 0; j < 8; j++)
+              ifcs(i, 8 * p + j) = myif(sys0 + i, j);
+        }
       }
       s0 += nsp;
     }
@@ -337,7 +342,7 @@ public:
       int p;
       do {
         MPI_Status stat;
-        MPI_Waitany(nprocs, req, &p, &stat);
+        MPI_Waitany(nprocs, req.data(), &p, &stat);
         if (p != MPI_UNDEFINED) {
 // p is the processor number. Copy data
 #ifdef DIAGNOSE
@@ -361,7 +366,7 @@ public:
 #ifdef DIAGNOSE
         output << "Reducing again\n";
 #endif
-        reduce(myns, 2 * nprocs, ifcs, if2x2);
+        reduce(0, myns, 2 * nprocs, ifcs, if2x2);
       } else {
         // Already just a pair of equations
         if2x2 = ifcs;
@@ -407,6 +412,11 @@ public:
       back_solve(myns, 2 * nprocs, ifcs, x1, xn, ifx);
     }
 
+    // Complete the gather-stage sends. Left until now so the
+    // interface solve overlaps with any still in flight; myif can't
+    // be reused until they have finished
+    MPI_Waitall(nprocs, sendreq.data(), MPI_STATUSES_IGNORE);
+
     if (nprocs > 1) {
       ///////////////////////////////////////
       // Scatter back solution
@@ -440,22 +450,26 @@ public:
           req[p] = MPI_REQUEST_NULL;
       }
 
+      for (int p = 0; p < nprocs; p++)
+        sendreq[p] = MPI_REQUEST_NULL;
+
       if (myns > 0) {
-        // Send data
+        // Send data. Non-blocking, with a separate buffer row per
+        // destination, so all returns are in flight at once
         for (int p = 0; p < nprocs; p++) { // Loop over processor
           if (p != myproc) {
-	    BOUT_OMP(parallel for)	    
+	    BOUT_OMP(parallel for)
             for (int i = 0; i < myns; i++) {
-              ifp[2 * i] = ifx(i, 2 * p);
-              ifp[2 * i + 1] = ifx(i, 2 * p + 1);
+              ifp(p, 2 * i) = ifx(i, 2 * p);
+              ifp(p, 2 * i + 1) = ifx(i, 2 * p + 1);
 #ifdef DIAGNOSE
-              output << "Returning: " << ifp[2 * i] << ", " << ifp[2 * i + 1] << " to "
-                     << p << endl;
+              output << "Returning: " << ifp(p, 2 * i) << ", " << ifp(p, 2 * i + 1)
+                     << " to " << p << endl;
 #endif
             }
-            MPI_Send(std::begin(ifp), 2 * myns * sizeof(T), MPI_BYTE, p,
-                     myproc, // Message identifier
-                     comm);
+            MPI_Isend(&ifp(p, 0), 2 * myns * sizeof(T), MPI_BYTE, p,
+                      myproc, // Message identifier
+                      comm, &sendreq[p]);
           }
         }
       }
@@ -465,7 +479,7 @@ public:
       int nsp;
       do {
         MPI_Status stat;
-        MPI_Waitany(nprocs, req, &fromproc, &stat);
+        MPI_Waitany(nprocs, req.data(), &fromproc, &stat);
 
         if (fromproc != MPI_UNDEFINED) {
           // fromproc is the processor number. Copy data
@@ -495,9 +509,11 @@ public:
     }
 
     ///////////////////////////////////////
-    // Solve local equations
+    // Solve local equations, overlapping with the scatter-stage sends,
+    // which are completed only once the local solve is finished
     back_solve(Nsys, N, coefs, x1, xn, x);
-    delete[] req;
+
+    MPI_Waitall(nprocs, sendreq.data(), MPI_STATUSES_IGNORE);
   }
 
 private:
@@ -518,9 +534,12 @@ private:
   Matrix<T> ifcs;       ///< Coefficients for interface solve
   Matrix<T> if2x2;      ///< 2x2 interface equations on this processor
   Matrix<T> ifx;        ///< Solution of interface equations
-  Array<T> ifp;         ///< Interface equations returned to processor p
+  Matrix<T> ifp;        ///< Send buffers for returning interface values, one row per processor
   Array<T> x1, xn;      ///< Interface solutions for back-solving
 
+  std::vector<MPI_Request> req;     ///< Receive requests, one per processor
+  std::vector<MPI_Request> sendreq; ///< Non-blocking send requests, one per processor
+
   /// Allocate memory arrays
   /// @param[in] np   Number of processors
   /// @param[in] nsys  Number of independent systems to solve
@@ -565,91 +584,123 @@ private:
     ifcs = Matrix<T>(myns, 2 * 4 * nprocs); // Coefficients for interface solve
     if (nprocs > 1)
       if2x2 = Matrix<T>(myns, 2 * 4);  // 2x2 interface equations on this processor
-    ifx = Matrix<T>(myns, 2 * nprocs); // Solution of interface equations
-    ifp = Array<T>(myns * 2);          // Solution to be sent to processor p
+    ifx = Matrix<T>(myns, 2 * nprocs);  // Solution of interface equations
+    ifp = Matrix<T>(nprocs, myns * 2);  // Solution to be sent, one row per processor
     // Each system to be solved on this processor has two interface equations from each
     // processor
 
     x1 = Array<T>(Nsys);
     xn = Array<T>(Nsys);
+
+    // Communication requests, reused across calls
+    req.assign(nprocs, MPI_REQUEST_NULL);
+    sendreq.assign(nprocs, MPI_REQUEST_NULL);
   }
 
+  /// Number of systems swept together in reduce and back_solve. The
+  /// sweeps carry a recurrence along each row, so vectorization has to
+  /// happen across independent systems: the inner loops run over the
+  /// lanes of a block, which advance side by side
+  static const int block_size = 8;
+
   /// Calculate interface equations
   ///
-  /// This reduces ns separate systems of equations, each consisting
-  /// of nloc rows on this processor, to two interface rows for each system,
-  /// which are stored in ifc.
+  /// This reduces the systems of equations [sys_start, sys_end), each
+  /// consisting of nloc rows on this processor, to two interface rows
+  /// for each system, which are stored in the same rows of ifc.
+  /// Taking a range allows the caller to reduce one destination's
+  /// chunk at a time, overlapping with sending earlier chunks.
   ///
   /// (a1 b1 c1                  )
   /// (   a2 b2 c2               )       (A1 B1 C1   )
   /// (      a3 b3 c3            )   =>  (   A2 B2 C2)
   /// (              ...         )
   /// (                  an bn cn)
-  void reduce(int ns, int nloc, Matrix<T> &co, Matrix<T> &ifc) {
+  void reduce(int sys_start, int sys_end, int nloc, Matrix<T> &co, Matrix<T> &ifc) {
 #ifdef DIAGNOSE
     if (nloc < 2)
       throw BoutException("CyclicReduce::reduce nloc < 2");
 #endif
-    
+
+    int nblocks = (sys_end - sys_start + block_size - 1) / block_size;
+
     BOUT_OMP(parallel for)
-    for (int j = 0; j < ns; j++) {
-      // Calculate upper interface equation
+    for (int block = 0; block < nblocks; block++) {
+      const int j0 = sys_start + block * block_size;
+      const int nj = (sys_end - j0) < block_size ? (sys_end - j0) : block_size;
+      int zero_pivot = 0; // Flagged inside the lane loops, checked at the end
+
+      // Calculate upper interface equations
 
       // v_l <- v_(k+N-2)
       // b_u <- b_{k+N-2}
-      for (int i = 0; i < 4; i++) {
-        ifc(j, i) = co(j, 4 * (nloc - 2) + i);
-      }
+      for (int j = j0; j < j0 + nj; j++)
+        for (int i = 0; i < 4; i++) {
+          ifc(j, i) = co(j, 4 * (nloc - 2) + i);
+        }
 
       for (int i = nloc - 3; i >= 0; i--) {
-        // Check for zero pivot
-        if (abs(ifc(j, 1)) < 1e-10)
-          throw BoutException("Zero pivot in CyclicReduce::reduce");
+        BOUT_OMP(simd reduction(|:zero_pivot))
+        for (int jl = 0; jl < nj; jl++) {
+          int j = j0 + jl;
+
+          // Check for zero pivot
+          zero_pivot |= (abs(ifc(j, 1)) < 1e-10);
 
-        // beta <- v_{i,i+1} / v_u,i
-        T beta = co(j, 4 * i + 2) / ifc(j, 1);
+          // beta <- v_{i,i+1} / v_u,i
+          T beta = co(j, 4 * i + 2) / ifc(j, 1);
 
-        // v_u <- v_i - beta * v_u
-        ifc(j, 1) = co(j, 4 * i + 1) - beta * ifc(j, 0);
-        ifc(j, 0) = co(j, 4 * i);
-        ifc(j, 2) *= -beta;
-        // ic columns  {i-1, i, N-1}
+          // v_u <- v_i - beta * v_u
+          ifc(j, 1) = co(j, 4 * i + 1) - beta * ifc(j, 0);
+          ifc(j, 0) = co(j, 4 * i);
+          ifc(j, 2) *= -beta;
+          // ic columns  {i-1, i, N-1}
 
-        // b_u <- b_i - beta*b_u
-        ifc(j, 3) = co(j, 4 * i + 3) - beta * ifc(j, 3);
+          // b_u <- b_i - beta*b_u
+          ifc(j, 3) = co(j, 4 * i + 3) - beta * ifc(j, 3);
+        }
       }
 
-      // Calculate lower interface equation
-      // Uses next 4 ifc values for this system so have +4 in indexinf
+      // Calculate lower interface equations
+      // Uses next 4 ifc values for each system so have +4 in indexing
 
       // v_l <- v_(k+1)
       // b_l <- b_{k+1}
-      for (int i = 0; i < 4; i++)
-        ifc(j, 4 + i) = co(j, 4 + i);
+      for (int j = j0; j < j0 + nj; j++)
+        for (int i = 0; i < 4; i++)
+          ifc(j, 4 + i) = co(j, 4 + i);
 
       for (int i = 2; i < nloc; i++) {
+        BOUT_OMP(simd reduction(|:zero_pivot))
+        for (int jl = 0; jl < nj; jl++) {
+          int j = j0 + jl;
 
-        if (abs(ifc(j, 4 + 1)) < 1e-10)
-          throw BoutException("Zero pivot in CyclicReduce::reduce");
+          zero_pivot |= (abs(ifc(j, 4 + 1)) < 1e-10);
 
-        // alpha <- v_{i,i-1} / v_l,i-1
-        T alpha = co(j, 4 * i) / ifc(j, 4 + 1);
+          // alpha <- v_{i,i-1} / v_l,i-1
+          T alpha = co(j, 4 * i) / ifc(j, 4 + 1);
 
-        // v_l <- v_i - alpha*v_l
-        ifc(j, 4 + 0) *= -alpha;
-        ifc(j, 4 + 1) = co(j, 4 * i + 1) - alpha * ifc(j, 4 + 2);
-        ifc(j, 4 + 2) = co(j, 4 * i + 2);
-        // columns of ic are {0, i, i + 1}
+          // v_l <- v_i - alpha*v_l
+          ifc(j, 4 + 0) *= -alpha;
+          ifc(j, 4 + 1) = co(j, 4 * i + 1) - alpha * ifc(j, 4 + 2);
+          ifc(j, 4 + 2) = co(j, 4 * i + 2);
+          // columns of ic are {0, i, i + 1}
 
-        // b_l <- b_{k + i} - alpha*b_l
-        ifc(j, 4 + 3) = co(j, 4 * i + 3) - alpha * ifc(j, 4 + 3);
+          // b_l <- b_{k + i} - alpha*b_l
+          ifc(j, 4 + 3) = co(j, 4 * i + 3) - alpha * ifc(j, 4 + 3);
+        }
       }
 
+      if (zero_pivot)
+        throw BoutException("Zero pivot in CyclicReduce::reduce");
+
 #ifdef DIAGNOSE
-      output << "Lower: " << ifc(j, 4 + 0) << ", " << ifc(j, 4 + 1) << ", "
-             << ifc(j, 4 + 2) << " : " << ifc(j, 4 + 3) << endl;
-      output << "Upper: " << ifc(j, 0) << ", " << ifc(j, 1) << ", " << ifc(j, 2) << " : "
-             << ifc(j, 3) << endl;
+      for (int j = j0; j < j0 + nj; j++) {
+        output << "Lower: " << ifc(j, 4 + 0) << ", " << ifc(j, 4 + 1) << ", "
+               << ifc(j, 4 + 2) << " : " << ifc(j, 4 + 3) << endl;
+        output << "Upper: " << ifc(j, 0) << ", " << ifc(j, 1) << ", " << ifc(j, 2)
+               << " : " << ifc(j, 3) << endl;
+      }
 #endif
     }
 
@@ -663,26 +714,46 @@ private:
                   Matrix<T> &xa) {
 
     xa.ensureUnique(); // Going to be modified, so call this outside parallel region
-    
-    // Tridiagonal system, solve using serial Thomas algorithm
+
+    int nblocks = (ns + block_size - 1) / block_size;
+
+    // Tridiagonal systems, solved using the Thomas algorithm with the
+    // sweeps running across the independent systems of each block
     // xa -- Result for each system
     // co -- Coefficients & rhs for each system
     BOUT_OMP(parallel for)
-    for (int i = 0; i < ns; i++) { // Loop over systems
-      Array<T> gam(nloc); // Thread-local array
-      T bet = 1.0;
-      xa(i, 0) = x1[i]; // Already know the first
-      gam[1] = 0.;
+    for (int block = 0; block < nblocks; block++) {
+      const int i0 = block * block_size;
+      const int ni = (ns - i0) < block_size ? (ns - i0) : block_size;
+
+      Array<T> gam(nloc * block_size); // Thread-local, lane-interleaved
+
+      for (int il = 0; il < ni; il++) {
+        xa(i0 + il, 0) = x1[i0 + il]; // Already know the first
+        gam[block_size + il] = 0.;    // gam[1] for this lane
+      }
+
       for (int j = 1; j < nloc - 1; j++) {
-        bet = co(i, 4 * j + 1) - co(i, 4 * j) * gam[j]; // bet = b[j]-a[j]*gam[j]
-        xa(i, j) = (co(i, 4 * j + 3) - co(i, 4 * j) * xa(i, j - 1)) /
-                   bet;                      // x[j] = (r[j]-a[j]*x[j-1])/bet;
-        gam[j + 1] = co(i, 4 * j + 2) / bet; // gam[j+1] = c[j]/bet
+        BOUT_OMP(simd)
+        for (int il = 0; il < ni; il++) {
+          int i = i0 + il;
+          T bet = co(i, 4 * j + 1)
+                  - co(i, 4 * j) * gam[j * block_size + il]; // bet = b[j]-a[j]*gam[j]
+          xa(i, j) = (co(i, 4 * j + 3) - co(i, 4 * j) * xa(i, j - 1)) /
+                     bet; // x[j] = (r[j]-a[j]*x[j-1])/bet;
+          gam[(j + 1) * block_size + il] = co(i, 4 * j + 2) / bet; // gam[j+1] = c[j]/bet
+        }
       }
-      xa(i, nloc - 1) = xn[i]; // Know the last value
+
+      for (int il = 0; il < ni; il++)
+        xa(i0 + il, nloc - 1) = xn[i0 + il]; // Know the last value
 
       for (int j = nloc - 2; j > 0; j--) {
-        xa(i, j) = xa(i, j) - gam[j + 1] * xa(i, j + 1);
+        BOUT_OMP(simd)
+        for (int il = 0; il < ni; il++) {
+          int i = i0 + il;
+          xa(i, j) = xa(i, j) - gam[(j + 1) * block_size + il] * xa(i, j + 1);
+        }
       }
     }
   }
@@ -32,6 +32,7 @@ class Datafile;
 #include <vector>
 #include <string>
 #include <memory>
+#include <thread>
 
 /*!
   Uses a generic interface to file formats (DataFormat)
@@ -91,6 +92,7 @@ class Datafile {
   bool flush;    // Flush after every write?
   bool guards;   // Write guard cells?
   bool floats;   // Low precision?
+  bool floats3d; // Low precision for 3D fields only?
   bool openclose; // Open and close file for each write
   int Lx,Ly,Lz; // The sizes in the x-, y- and z-directions of the arrays to be written
   bool enabled;  // Enable / Disable writing
@@ -99,6 +101,12 @@ class Datafile {
   bool shiftInput;  // Read in shifted space?
   int flushFrequencyCounter; //Counter used in determining when next openclose required
   int flushFrequency; //How many write calls do we want between openclose
+  bool async;    // Write in a background thread, overlapping I/O with computation?
+  bool staged;   // Pipeline the async write: prepare (sanitise/groom) the next
+                 // 3D field on a worker thread while the current one is put
+  int deflate;   // Deflate compression level for field variables, 0 = off (NetCDF4 only)
+  bool shuffle;  // Apply the byte-shuffle filter, improves compression
+  int groombits; // Keep only this many mantissa bits (lossy), 0 = off
 
   std::unique_ptr<DataFormat> file;
   size_t filenamelen;
@@ -119,6 +127,19 @@ class Datafile {
     string name;        ///< Name as it appears in the output file
     bool save_repeat;   ///< If true, has a time dimension and is saved every time step
     bool covar;         ///< For vectors, true if a covariant vector, false if contravariant
+
+    // Per-variable write policy, read from a subsection of the section
+    // this Datafile was configured from, e.g. [output:Ni]. See readWritePolicy
+    int period{1};            ///< Write only on every period-th call to write()
+    bool write_once{false};   ///< Write the first time only, then skip
+    bool skip_unchanged{false}; ///< Skip writing when the data has not changed
+                                ///< since it was last written (Field3D only)
+    bool transpose{false};    ///< Store with x and y interchanged, so (x,z)
+                              ///< planes are contiguous for analysis. Field3D
+                              ///< only, and only if the format supports it
+    bool written{false};      ///< Written since the file was opened?
+    unsigned int written_generation{0}; ///< Field3D generation at the last write,
+                                        ///< used by skip_unchanged
   };
 
   // one set per variable type
@@ -135,7 +156,73 @@ class Datafile {
   bool write_int(const string &name, int *f, bool save_repeat);
   bool write_real(const string &name, BoutReal *f, bool save_repeat);
   bool write_f2d(const string &name, Field2D *f, bool save_repeat);
-  bool write_f3d(const string &name, Field3D *f, bool save_repeat);
+  bool write_f3d(const string &name, Field3D *f, bool save_repeat,
+                 bool transpose = false);
+
+  /// Read the per-variable write policy for \p var from a subsection
+  /// of the section this Datafile was configured from, e.g. [output:Ni]
+  template <class T> void readWritePolicy(VarStr<T> &var);
+
+  /// Apply the per-variable write policy: should \p var be written by
+  /// this call to write()?
+  template <class T> bool shouldWrite(const VarStr<T> &var);
+
+  /// Reset the per-variable write policy state so the next write()
+  /// writes every variable at least once. Called when a file is opened
+  void resetWritePolicy();
+
+  /// The options section this Datafile was configured from ([output],
+  /// [restart], ...), kept to look up per-variable write policies
+  Options *options{nullptr};
+
+  /// Number of calls to write() since the file was opened, for the
+  /// per-variable period policy
+  int writeCount{0};
+
+  /// Write all added variables. If \p use_copy is true, the data
+  /// written is the snapshot taken by the last call to write() rather
+  /// than the live variables; this is what the background thread runs
+  /// in asynchronous mode
+  bool writeAll(bool use_copy);
+
+  /// The staged version of the 3D field loop in writeAll(), used when
+  /// staged is set: while one variable is inside the library put, a
+  /// worker thread copies the next one into the other staging slot and
+  /// runs the backend's prepare() pass on it, so the dump time is
+  /// bounded by the slower of the two stages rather than their sum
+  void write_f3d_staged();
+
+  /// Copy the current values of all added variables into the *_copy
+  /// buffers. Field copies share data until the variable is next
+  /// modified (copy-on-write), so this is cheap
+  void snapshotVars();
+
+  /// Wait for an outstanding asynchronous write to complete. No-op if
+  /// there isn't one
+  void waitWrite();
+
+  std::thread write_thread; ///< Background thread used when async is set
+  bool async_failed = false; ///< An asynchronous write threw; rethrow on the next write()
+  int mype = 0; ///< This processor's rank, cached so the background thread makes no MPI calls
+
+  // Snapshots of the added variables, written by the background thread
+  std::vector<unsigned int> f3d_gen_copy; ///< Field3D generations at snapshot time,
+                                          ///< for skip_unchanged in asynchronous mode
+  std::vector<int> int_copy;
+  std::vector<BoutReal> BoutReal_copy;
+  std::vector<Field2D> f2d_copy;
+  std::vector<Field3D> f3d_copy;
+  std::vector<Vector2D> v2d_copy;
+  std::vector<Vector3D> v3d_copy;
+
+  /// Double-buffered staging slots for write_f3d_staged(): one is
+  /// being written while the other is being prepared. A two-slot
+  /// bounded queue, so at most one variable is staged ahead
+  std::vector<BoutReal> stage_buffer[2];
+
+  /// Scratch space for the layout conversion of transposed variables
+  /// in the synchronous write path (see VarStr::transpose)
+  std::vector<BoutReal> transpose_buffer;
 
   /// Check if a variable has already been added
   bool varAdded(const string &name);
@@ -68,11 +68,28 @@ class DataFormat {
   virtual const vector<int> getSize(const char *var) = 0;
   virtual const vector<int> getSize(const string &var) = 0;
 
+  /// List the names of all variables in the file, in no particular
+  /// order. Formats that cannot enumerate their variables return an
+  /// empty list
+  virtual vector<string> listVars() { return {}; }
+
   // Set the origin for all subsequent calls
   virtual bool setGlobalOrigin(int x = 0, int y = 0, int z = 0) = 0; 
   virtual bool setLocalOrigin(int x = 0, int y = 0, int z = 0, int offset_x = 0, int offset_y = 0, int offset_z = 0);
   virtual bool setRecord(int t) = 0; // negative -> latest
 
+  /*!
+   * Override the sizes used for this file's x, y and z dimensions.
+   * By default files are created with the local mesh sizes; this
+   * allows creating (or appending to) files holding a sub-box of the
+   * domain, e.g. a region-of-interest output window. Must be called
+   * before the file is opened for writing. Returns false if the
+   * format does not support it
+   */
+  virtual bool setLocalGridSize(int UNUSED(nx), int UNUSED(ny), int UNUSED(nz)) {
+    return false;
+  }
+
   // Add a variable to the file
   virtual bool addVarInt(const string &name, bool repeat) = 0;
   virtual bool addVarBoutReal(const string &name, bool repeat) = 0;
@@ -103,10 +120,62 @@ class DataFormat {
   virtual bool write_rec(BoutReal *var, const char *name, int lx = 0, int ly = 0, int lz = 0) = 0;
   virtual bool write_rec(BoutReal *var, const string &name, int lx = 0, int ly = 0, int lz = 0) = 0;
 
+  // Bulk write path straight from field storage
+
+  /// Write a block of data without modifying it, so it can come
+  /// straight from a Field's Array storage. Backends override this to
+  /// hand \p data to a single bulk put; the default implementation
+  /// stages a copy through write(), which is allowed to sanitise its
+  /// buffer in place
+  virtual bool write_block(const BoutReal *data, const string &name, int lx = 0,
+                           int ly = 0, int lz = 0);
+  /// Record (time-dependent) version of write_block
+  virtual bool write_rec_block(const BoutReal *data, const string &name, int lx = 0,
+                               int ly = 0, int lz = 0);
+
+  /// Apply the lossy and sanitising passes (low-precision range
+  /// clamping, non-finite replacement, mantissa grooming) that the
+  /// write routines would otherwise apply to \p data just before the
+  /// library put. Exposed so a staging thread can prepare the next
+  /// variable's buffer while the current one is being written:
+  /// implementations may only read configuration and modify the
+  /// caller's buffer. Does nothing by default
+  virtual void prepare(BoutReal *UNUSED(data), int UNUSED(n)) {}
+
+  /// Declare that buffers passed to write_block / write_rec_block have
+  /// already been through prepare(), so the backend can put them
+  /// directly without staging and sanitising another copy
+  void setPreparedInput(bool on) { prepared_input = on; }
+
+  /// Request that the 3D variable \p name be stored with x and y
+  /// interchanged, i.e. with dimensions (t,) y, x, z. An (x,z) plane at
+  /// fixed y is then contiguous in the file, matching the access
+  /// pattern of typical post-processing, at the cost of a transpose at
+  /// write time (see Datafile). Must be called before the variable is
+  /// added; the caller is responsible for passing (y,x,z)-ordered data
+  /// to the write routines. Returns false if this format does not
+  /// support transposed layouts
+  virtual bool setTransposeXY(const string &UNUSED(name)) { return false; }
+
   // Optional functions
   
   virtual void setLowPrecision() { }  // By default doesn't do anything
 
+  /// Write only 3D field data in single precision, leaving scalars,
+  /// time bases and 2D fields (coordinates, equilibrium profiles)
+  /// double. Halves the largest output stream where the analysis
+  /// does not need more than float precision. By default doesn't do
+  /// anything
+  virtual void setLowPrecision3D() { }
+
+  /// Configure compression of variables, where the format supports it
+  /// (currently NetCDF4). \p level is the deflate level (0 disables),
+  /// \p shuf enables the byte-shuffle filter, and \p groombits, if
+  /// positive, keeps only that many mantissa bits of floating-point
+  /// data: lossy, but makes the values far more compressible
+  virtual void setCompression(int UNUSED(level), bool UNUSED(shuf),
+                              int UNUSED(groombits)) {}
+
   // Attributes
 
   /// Sets a string attribute
@@ -155,6 +224,11 @@ class DataFormat {
   /// -------
   /// value                  An int attribute of the variable
   virtual bool getAttribute(const string &varname, const string &attrname, int &value) = 0;
+
+ protected:
+  /// Buffers passed to the block writes have already been through
+  /// prepare(); see setPreparedInput()
+  bool prepared_input{false};
 };
 
 // For backwards compatability. In formatfactory.cxx
@@ -34,11 +34,57 @@
 
 #include <complex>
 #include "bout_types.hxx"
+#include <bout/array.hxx>
 
 typedef std::complex<BoutReal> dcomplex;
 
 const dcomplex Im(0,1); // 1i 
 
+/// Batch of complex vectors in split real/imaginary (structure of
+/// arrays) layout.
+///
+/// std::complex interleaves real and imaginary parts in memory, which
+/// prevents vectorisation of sweep recurrences such as tridiagonal
+/// solves. Storing a batch of vectors as two flat BoutReal arrays with
+/// the batch index fastest lets those sweeps vectorise across the
+/// batch (e.g. across Z modes) while each recurrence stays scalar in
+/// the sweep direction.
+///
+/// Element \p i of batch member \p j is stored at offset
+/// i * batchSize() + j in both the real and imaginary arrays
+class ComplexBatch {
+public:
+  ComplexBatch() = default;
+
+  /// A batch of \p batch vectors, each of length \p length
+  ComplexBatch(int length, int batch)
+      : len(length), nbatch(batch), re(length * batch), im(length * batch) {}
+
+  int length() const { return len; }
+  int batchSize() const { return nbatch; }
+  bool empty() const { return len * nbatch == 0; }
+
+  BoutReal *real() { return re.begin(); }
+  BoutReal *imag() { return im.begin(); }
+  const BoutReal *real() const { return re.begin(); }
+  const BoutReal *imag() const { return im.begin(); }
+
+  /// Store interleaved \p val as element \p i of batch member \p j
+  void set(int i, int j, const dcomplex &val) {
+    re[i * nbatch + j] = val.real();
+    im[i * nbatch + j] = val.imag();
+  }
+
+  /// Element \p i of batch member \p j as an interleaved complex
+  dcomplex get(int i, int j) const {
+    return dcomplex(re[i * nbatch + j], im[i * nbatch + j]);
+  }
+
+private:
+  int len{0}, nbatch{0};
+  Array<BoutReal> re, im; ///< Split storage, batch index fastest
+};
+
 /// Complex type for passing data to/from FORTRAN
 struct fcmplx {
   BoutReal r, i;
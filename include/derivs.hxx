@@ -58,6 +58,11 @@
 const Field3D DDX(const Field3D &f, CELL_LOC outloc = CELL_DEFAULT,
                   DIFF_METHOD method = DIFF_DEFAULT, REGION region = RGN_NOBNDRY);
 
+/// Variant of DDX(const Field3D&) restricted to a named region
+/// registered with the Mesh. Only cells in \p region are set.
+const Field3D DDX(const Field3D &f, CELL_LOC outloc, DIFF_METHOD method,
+                  const std::string &region);
+
 /// Reorder arguments to match DDX(const Field3D &f, CELL_LOC, DIFF_METHOD, REGION)
 DEPRECATED(inline const Field3D DDX(const Field3D &f, DIFF_METHOD method,
                                     CELL_LOC outloc = CELL_DEFAULT,
@@ -102,6 +107,11 @@ DEPRECATED(inline const Field2D DDX(const Field2D &f, DIFF_METHOD method,
 const Field3D DDY(const Field3D &f, CELL_LOC outloc = CELL_DEFAULT,
                   DIFF_METHOD method = DIFF_DEFAULT, REGION region = RGN_NOBNDRY);
 
+/// Variant of DDY(const Field3D&) restricted to a named region
+/// registered with the Mesh. Only cells in \p region are set.
+const Field3D DDY(const Field3D &f, CELL_LOC outloc, DIFF_METHOD method,
+                  const std::string &region);
+
 /// Reorder arguments to match DDY(const Field3D &f, CELL_LOC, DIFF_METHOD, REGION)
 DEPRECATED(inline const Field3D DDY(const Field3D &f, DIFF_METHOD method,
                                     CELL_LOC outloc = CELL_DEFAULT,
@@ -146,6 +156,11 @@ DEPRECATED(inline const Field2D DDY(const Field2D &f, DIFF_METHOD method,
 const Field3D DDZ(const Field3D &f, CELL_LOC outloc = CELL_DEFAULT,
                   DIFF_METHOD method = DIFF_DEFAULT, REGION region = RGN_NOBNDRY);
 
+/// Variant of DDZ(const Field3D&) restricted to a named region
+/// registered with the Mesh. Only cells in \p region are set.
+const Field3D DDZ(const Field3D &f, CELL_LOC outloc, DIFF_METHOD method,
+                  const std::string &region);
+
 /// Reorder arguments to match DDZ(const Field3D &f, CELL_LOC, DIFF_METHOD, REGION)
 DEPRECATED(inline const Field3D DDZ(const Field3D &f, DIFF_METHOD method,
                                     CELL_LOC outloc = CELL_DEFAULT,
@@ -174,6 +189,23 @@ DEPRECATED(inline const Field2D DDZ(const Field2D &f, DIFF_METHOD method,
                                     REGION region = RGN_NOBNDRY)) {
   return DDZ(f, outloc, method, region);
 }
+/// Calculate all three first partial derivatives of \p f in a single
+/// traversal, sharing the loaded stencil neighbourhood between the
+/// three directions (see Mesh::indexGradAll). Equivalent to separate
+/// calls to DDX, DDY and DDZ with the default methods, but with
+/// roughly one read of \p f instead of three. Falls back to the
+/// separate calls for staggered output locations.
+///
+/// @param[in]  f    The field to be differentiated
+/// @param[out] ddx  \f$\partial f / \partial x\f$
+/// @param[out] ddy  \f$\partial f / \partial y\f$
+/// @param[out] ddz  \f$\partial f / \partial z\f$
+/// @param[in] outloc  The cell location where the result is desired. If
+///                    staggered grids is not enabled then this has no effect
+///                    If not given, defaults to CELL_DEFAULT
+void gradAll(const Field3D &f, Field3D &ddx, Field3D &ddy, Field3D &ddz,
+             CELL_LOC outloc = CELL_DEFAULT);
+
 ////////// SECOND DERIVATIVES //////////
 
 /// Calculate second partial derivative in X
@@ -191,6 +223,11 @@ DEPRECATED(inline const Field2D DDZ(const Field2D &f, DIFF_METHOD method,
 const Field3D D2DX2(const Field3D &f, CELL_LOC outloc = CELL_DEFAULT,
                     DIFF_METHOD method = DIFF_DEFAULT, REGION region = RGN_NOBNDRY);
 
+/// Variant of D2DX2(const Field3D&) restricted to a named region
+/// registered with the Mesh. Only cells in \p region are set.
+const Field3D D2DX2(const Field3D &f, CELL_LOC outloc, DIFF_METHOD method,
+                    const std::string &region);
+
 /// Reorder arguments to match D2DX2(const Field3D &f, CELL_LOC, DIFF_METHOD, REGION)
 DEPRECATED(inline const Field3D D2DX2(const Field3D &f, DIFF_METHOD method,
                                       CELL_LOC outloc = CELL_DEFAULT,
@@ -235,6 +272,11 @@ DEPRECATED(inline const Field2D D2DX2(const Field2D &f, DIFF_METHOD method,
 const Field3D D2DY2(const Field3D &f, CELL_LOC outloc = CELL_DEFAULT,
                     DIFF_METHOD method = DIFF_DEFAULT, REGION region = RGN_NOBNDRY);
 
+/// Variant of D2DY2(const Field3D&) restricted to a named region
+/// registered with the Mesh. Only cells in \p region are set.
+const Field3D D2DY2(const Field3D &f, CELL_LOC outloc, DIFF_METHOD method,
+                    const std::string &region);
+
 /// Reorder arguments to match D2DY2(const Field3D &f, CELL_LOC, DIFF_METHOD, REGION)
 DEPRECATED(inline const Field3D D2DY2(const Field3D &f, DIFF_METHOD method,
                                       CELL_LOC outloc = CELL_DEFAULT,
@@ -279,6 +321,11 @@ DEPRECATED(inline const Field2D D2DY2(const Field2D &f, DIFF_METHOD method,
 const Field3D D2DZ2(const Field3D &f, CELL_LOC outloc = CELL_DEFAULT,
                     DIFF_METHOD method = DIFF_DEFAULT, REGION region = RGN_NOBNDRY);
 
+/// Variant of D2DZ2(const Field3D&) restricted to a named region
+/// registered with the Mesh. Only cells in \p region are set.
+const Field3D D2DZ2(const Field3D &f, CELL_LOC outloc, DIFF_METHOD method,
+                    const std::string &region);
+
 /// Reorder arguments to match D2DZ2(const Field3D &f, CELL_LOC, DIFF_METHOD, REGION)
 DEPRECATED(inline const Field3D D2DZ2(const Field3D &f, DIFF_METHOD method,
                                       CELL_LOC outloc = CELL_DEFAULT,
@@ -285,7 +285,10 @@ enum BRACKET_METHOD {
                           /// method. Explicit method only,
                           /// needs the timestep from the
                           /// solver
-  BRACKET_ARAKAWA_OLD = 4 ///< Older version, for regression testing of optimised version.
+  BRACKET_ARAKAWA_OLD = 4, ///< Older version, for regression testing of optimised version.
+  BRACKET_ARAKAWA_FAST = 5 ///< Arakawa method in X-Z, rotating the stencil
+                           /// values through registers along z-contiguous
+                           /// lines so each point is loaded only once
 };
 
 /*!
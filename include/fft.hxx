@@ -30,6 +30,64 @@
 
 #include "dcomplex.hxx"
 
+#include <string>
+
+namespace bout {
+namespace fft {
+
+struct PlanImpl; // Holds the FFTW types, kept out of this header
+
+/*!
+ * Re-entrant FFT context for real transforms of a fixed length,
+ * owning its own FFTW plans and aligned buffers. Unlike the legacy
+ * rfft/irfft free functions (which are now layered on top of this),
+ * independent Plan objects can transform different lengths
+ * concurrently without serialising on shared static state.
+ *
+ * Executing a Plan is thread safe with respect to other Plan objects,
+ * but a single Plan must not be executed by two threads at once: use
+ * Plan::get() (one table of plans per thread) or one Plan per thread.
+ *
+ * Building a plan serialises on FFTW's (thread-unsafe) planner, but
+ * only on the first transform of each length and direction.
+ */
+class Plan {
+public:
+  /// Create a context for transforms of \p length real points.
+  /// Buffers are allocated here; the FFTW plans for each direction
+  /// are built on first use
+  Plan(int length);
+  ~Plan();
+
+  // The FFTW plans are tied to this object's buffers, so can't be shared
+  Plan(const Plan &other) = delete;
+  Plan &operator=(const Plan &other) = delete;
+
+  /// Number of real points this context transforms
+  int size() const;
+
+  /// Forward transform: \p in has size() real points, \p out
+  /// size()/2 + 1 complex modes, normalised as rfft()
+  void forward(const BoutReal *in, dcomplex *out);
+
+  /// Inverse transform: \p in has size()/2 + 1 complex modes, \p out
+  /// size() real points. Not normalised, as irfft()
+  void backward(const dcomplex *in, BoutReal *out);
+
+  /// The calling thread's cached Plan for transforms of \p length
+  /// points, created on first use. Each thread has its own table, so
+  /// lookups never synchronise and plans for different lengths
+  /// coexist (the legacy functions rebuilt their plans whenever the
+  /// length changed)
+  static Plan &get(int length);
+
+private:
+  PlanImpl *impl; ///< FFTW plans and aligned buffers
+};
+
+} // namespace fft
+} // namespace bout
+
 /*!
  * Returns the fft of a real signal using fftw_forward
  *
@@ -40,6 +98,9 @@
  * where IDFT is the inverse fourier transform.
  * See the the fftw user manual for details.
  *
+ * Thread safe: each thread transforms through its own cached
+ * bout::fft::Plan.
+ *
  * \param[in] in     Pointer to the 1D array to take the fourier transform of
  * \param[in] length Number of points in the input array
  * \param[out] out   Pointer to the complex 1D array which is the FFT of in
@@ -64,6 +125,69 @@ void rfft(const BoutReal *in, int length, dcomplex *out);
  */
 void irfft(const dcomplex *in, int length, BoutReal *out);
 
+/*!
+ * Batched version of rfft: takes the fft of \p howmany contiguous
+ * real signals of \p length points in a single call, using FFTW's
+ * many-plan interface. This is typically several times faster than
+ * calling rfft in a loop, e.g. when transforming every z-pencil of a
+ * Field3D or FieldPerp.
+ *
+ * The input rows are contiguous (row j starts at in + j*length), as
+ * are the output rows (row j starts at out + j*(length/2 + 1)).
+ *
+ * Note: Not thread-safe, so must be called from outside any parallel
+ * region; the batching replaces the loop that would otherwise be
+ * parallelised.
+ *
+ * \param[in] in      Pointer to \p howmany real arrays of \p length points
+ * \param[in] length  Number of points in each input row
+ * \param[in] howmany Number of rows (independent transforms)
+ * \param[out] out    Pointer to \p howmany complex arrays of length/2 + 1 points
+ */
+void rfft_many(const BoutReal *in, int length, int howmany, dcomplex *out);
+
+/*!
+ * Batched version of irfft: takes the inverse fft of \p howmany
+ * contiguous complex spectra in a single call. See rfft_many for the
+ * data layout and threading caveats.
+ *
+ * \param[in] in      Pointer to \p howmany complex arrays of length/2 + 1 points
+ * \param[in] length  Number of points in each output row
+ * \param[in] howmany Number of rows (independent transforms)
+ * \param[out] out    Pointer to \p howmany real arrays of \p length points
+ */
+void irfft_many(const dcomplex *in, int length, int howmany, BoutReal *out);
+
+/*!
+ * Import FFTW wisdom (accumulated planning knowledge) from \p filename
+ *
+ * With imported wisdom, building plans for lengths already measured in
+ * a previous run is nearly free, even with fft:fft_measure set.
+ * Quietly does nothing if the file does not exist.
+ *
+ * \param[in] filename  Path of the wisdom file
+ * \return true if wisdom was read successfully
+ */
+bool fft_load_wisdom(const std::string &filename);
+
+/*!
+ * Export the FFTW wisdom accumulated by this process to \p filename
+ *
+ * \param[in] filename  Path of the wisdom file
+ * \return true if wisdom was written successfully
+ */
+bool fft_save_wisdom(const std::string &filename);
+
+/*!
+ * Build the cached forward and backward plans for transforms of
+ * \p length points, so that planning cost is paid up front (e.g. at
+ * BoutInitialise) rather than in the first timestep. Most useful
+ * together with fft:fft_measure, where planning can take seconds.
+ *
+ * \param[in] length  Number of (real) points in the transform
+ */
+void fft_warmup(int length);
+
 /*!
  * Discrete Sine Transform
  *
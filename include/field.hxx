@@ -40,6 +40,7 @@ class Field;
 #include "bout/deprecated.hxx"
 
 #include "bout/dataiterator.hxx"
+#include "bout/region.hxx"
 
 #include "unused.hxx"
 
@@ -140,4 +141,42 @@ class Field {
   DEPRECATED(void error(const char *s, ...) const);
 };
 
+/// Runtime switches for the non-finite scans in checkData(), read
+/// from the root options at startup.
+///
+/// At CHECK levels 1 and 2 the scan is compiled out of checkData
+/// unless check_data_enable_finite is set, which enables the cheap
+/// branch-free reduction for triage without a rebuild. At all levels
+/// check_data_sample_stride > 1 thins the scan to every stride'th
+/// point of each region, trading certainty of detection for speed in
+/// production runs
+extern bool check_data_enable_finite;
+extern int check_data_sample_stride;
+
+/// Branch-free scan of \p f for non-finite values over \p region,
+/// checking every \p stride points. The inner loop accumulates a
+/// count of failed (val - val) == 0 comparisons -- false for NaN and
+/// infinity -- over each contiguous block, so it vectorises; callers
+/// run per-point throw logic only when this reports a problem
+template <typename FieldType, typename IndexType>
+bool isFiniteOnRegion(const FieldType &f, const Region<IndexType> &region,
+                      int stride = 1) {
+  if (stride < 1) {
+    stride = 1;
+  }
+
+  int nbad = 0;
+  for (const auto &block : region.getBlocks()) {
+    const int istart = block.first.ind;
+    const int iend = block.second.ind;
+
+    BOUT_OMP(simd reduction(+ : nbad))
+    for (int i = istart; i < iend; i += stride) {
+      const BoutReal val = f[IndexType(i)];
+      nbad += ((val - val) == 0.0) ? 0 : 1;
+    }
+  }
+  return nbad == 0;
+}
+
 #endif /* __FIELD_H__ */
@@ -27,6 +27,8 @@ class Field3D;
 #define __FIELD3D_H__
 
 class Mesh;  // #include "bout/mesh.hxx"
+class StencilView;      // #include "bout/stencil_view.hxx"
+class ConstStencilView;
 #include "field.hxx"
 #include "field2d.hxx"
 #include "fieldperp.hxx"
@@ -241,6 +243,38 @@ class Field3D : public Field, public FieldData {
     return (yup_field != nullptr) && (ydown_field != nullptr);
   }
 
+  /// True if the yup()/ydown() parallel slices were calculated from the
+  /// current field data. ParallelTransform::calcYUpDown implementations
+  /// use this to skip the recalculation when a field is communicated
+  /// again without having been modified in between.
+  ///
+  /// Modifications are tracked through allocate(), the assignment
+  /// operators and the compound assignment operators (+= etc). Direct
+  /// element writes are only counted via the allocate() call that
+  /// must precede them (element writes to a field whose data may be
+  /// shared are invalid anyway); code mutating elements of a field it
+  /// knows to be unique without calling allocate() must call
+  /// invalidateParallelSlices() itself. Guard cell unpacking during
+  /// communication deliberately does not count as a modification
+  bool parallelSlicesUpToDate() const {
+    return hasYupYdown() && (yup_field != this) && (slice_generation == generation);
+  }
+
+  /// Record that the parallel slices match the current data; called by
+  /// ParallelTransform implementations after calculating the slices
+  void parallelSlicesCalculated() { slice_generation = generation; }
+
+  /// Counter incremented whenever the data may have been modified; see
+  /// parallelSlicesUpToDate() for what counts as a modification.
+  /// Callers such as Datafile use this to skip work when a field is
+  /// unchanged since it was last seen. Starts at 1, so 0 can be used
+  /// to mean "never seen"
+  unsigned int getGeneration() const { return generation; }
+
+  /// Mark the parallel slices as not matching the current data, e.g.
+  /// after filling them with something other than calcYUpDown's result
+  void invalidateParallelSlices() { slice_generation = generation - 1; }
+
   /// Return reference to yup field
   Field3D& yup() { 
     ASSERT2(yup_field != nullptr); // Check for communicate
@@ -433,7 +467,22 @@ class Field3D : public Field, public FieldData {
 #endif
     return &data[(jx*ny +jy)*nz];
   }
-  
+
+  /*!
+   * Unchecked view of the underlying data, for the inner loops of
+   * stencil kernels (see bout/stencil_view.hxx)
+   *
+   * The returned view performs NO bounds checking at any CHECK level:
+   * the caller guarantees that every access - region indices plus any
+   * neighbour offsets the kernel applies - stays within the field, so
+   * the region must keep clear of the domain edge by the stencil
+   * width. At CHECK >= 2 the region's blocks are verified to fit
+   * inside the field when the view is taken, which catches a
+   * mismatched mesh at a single, loop-free point
+   */
+  StencilView view(const Region<Ind3D> &region);
+  ConstStencilView view(const Region<Ind3D> &region) const;
+
   /////////////////////////////////////////////////////////
   // Operators
   
@@ -475,7 +524,18 @@ class Field3D : public Field, public FieldData {
   Field3D & operator/=(const Field2D &rhs);
   Field3D & operator/=(BoutReal rhs);
   ///@}
-  
+
+  /*!
+   * Exchange the contents of two fields in O(1): the data blocks and
+   * the value metadata (mesh, location, coordinates) swap, while each
+   * variable keeps its identity — time derivative, parallel slices
+   * and boundary conditions stay put (the slices are marked stale).
+   * With the *_into operations this lets a right-hand side be built
+   * in a scratch field and swapped into ddt() without copying
+   */
+  friend void swap(Field3D &first, Field3D &second);
+
+
   // FieldData virtual functions
   
   bool isReal() const override   { return true; }         // Consists of BoutReal values
@@ -525,6 +585,13 @@ private:
 
   /// Pointers to fields containing values along Y
   Field3D *yup_field, *ydown_field;
+
+  /// Incremented whenever the data may have been modified (allocate()
+  /// and assignment), for dirty tracking of the parallel slices
+  unsigned int generation = 1;
+  /// The value of generation when the parallel slices were last
+  /// calculated; see parallelSlicesUpToDate()
+  unsigned int slice_generation = 0;
 };
 
 // Non-member overloaded operators
@@ -555,6 +622,57 @@ Field3D operator-(BoutReal lhs, const Field3D &rhs);
 Field3D operator*(BoutReal lhs, const Field3D &rhs);
 Field3D operator/(BoutReal lhs, const Field3D &rhs);
 
+/// Destination-aware arithmetic: compute lhs <op> rhs directly into
+/// \p result, reusing its storage when already allocated and unique
+/// instead of allocating a fresh temporary per term. Intended for
+/// accumulating right-hand-side terms into ddt() fields:
+///
+///     multiply_into(ddt(n), phi, n); // instead of ddt(n) = phi * n
+///
+/// \p result may alias an operand. If it shares storage with another
+/// field it is detached first (one copy, as for allocate()), and it
+/// is reconstructed if it is on a different mesh.
+///@{
+void add_into(Field3D &result, const Field3D &lhs, const Field3D &rhs);
+void subtract_into(Field3D &result, const Field3D &lhs, const Field3D &rhs);
+void multiply_into(Field3D &result, const Field3D &lhs, const Field3D &rhs);
+void divide_into(Field3D &result, const Field3D &lhs, const Field3D &rhs);
+
+void add_into(Field3D &result, const Field3D &lhs, BoutReal rhs);
+void subtract_into(Field3D &result, const Field3D &lhs, BoutReal rhs);
+void multiply_into(Field3D &result, const Field3D &lhs, BoutReal rhs);
+void divide_into(Field3D &result, const Field3D &lhs, BoutReal rhs);
+
+void add_into(Field3D &result, BoutReal lhs, const Field3D &rhs);
+void subtract_into(Field3D &result, BoutReal lhs, const Field3D &rhs);
+void multiply_into(Field3D &result, BoutReal lhs, const Field3D &rhs);
+void divide_into(Field3D &result, BoutReal lhs, const Field3D &rhs);
+///@}
+
+/// Region-restricted arithmetic: as the corresponding binary operator,
+/// but only the cells in the named region \p rgn (registered with the
+/// Mesh, see Mesh::getRegion3D) are calculated. Cells outside the
+/// region are left unset, so the result must only be used inside \p rgn.
+Field3D add(const Field3D &lhs, const Field3D &rhs, const std::string &rgn);
+Field3D sub(const Field3D &lhs, const Field3D &rhs, const std::string &rgn);
+Field3D mul(const Field3D &lhs, const Field3D &rhs, const std::string &rgn);
+Field3D div(const Field3D &lhs, const Field3D &rhs, const std::string &rgn);
+
+Field3D add(const Field3D &lhs, const Field2D &rhs, const std::string &rgn);
+Field3D sub(const Field3D &lhs, const Field2D &rhs, const std::string &rgn);
+Field3D mul(const Field3D &lhs, const Field2D &rhs, const std::string &rgn);
+Field3D div(const Field3D &lhs, const Field2D &rhs, const std::string &rgn);
+
+Field3D add(const Field3D &lhs, BoutReal rhs, const std::string &rgn);
+Field3D sub(const Field3D &lhs, BoutReal rhs, const std::string &rgn);
+Field3D mul(const Field3D &lhs, BoutReal rhs, const std::string &rgn);
+Field3D div(const Field3D &lhs, BoutReal rhs, const std::string &rgn);
+
+Field3D add(BoutReal lhs, const Field3D &rhs, const std::string &rgn);
+Field3D sub(BoutReal lhs, const Field3D &rhs, const std::string &rgn);
+Field3D mul(BoutReal lhs, const Field3D &rhs, const std::string &rgn);
+Field3D div(BoutReal lhs, const Field3D &rhs, const std::string &rgn);
+
 /*!
  * Unary minus. Returns the negative of given field,
  * iterates over whole domain including guard/boundary cells.
@@ -640,6 +758,16 @@ const Field3D exp(const Field3D &f, REGION rgn = RGN_ALL);
 ///
 const Field3D log(const Field3D &f, REGION rgn = RGN_ALL);
 
+/// As exp() and log(), but always through the vectorised polynomial
+/// kernels in bout/vecmath.hxx: accurate to a few ulp with simplified
+/// special-case handling, and several times faster since the loop
+/// vectorises instead of calling libm per point. exp() and log()
+/// themselves switch to these kernels when the "fast" option in the
+/// [vecmath] section is set; the fast_ variants select the fast mode
+/// per call site regardless of the option
+const Field3D fast_exp(const Field3D &f, REGION rgn = RGN_ALL);
+const Field3D fast_log(const Field3D &f, REGION rgn = RGN_ALL);
+
 /// Sine trigonometric function.
 ///
 /// @param[in] f    Angle in radians
@@ -737,6 +865,12 @@ const Field3D floor(const Field3D &var, BoutReal f, REGION rgn = RGN_ALL);
 /// @param[in] rgn The region to calculate the result over
 const Field3D filter(const Field3D &var, int N0, REGION rgn = RGN_ALL);
 
+/// Fourier filtering of a temporary, e.g. filter(f * g, 1). The field
+/// is transformed in place, reusing the temporary's storage instead of
+/// allocating a new field. `f = filter(std::move(f), 1)` filters
+/// without any allocation
+const Field3D filter(Field3D &&var, int N0, REGION rgn = RGN_ALL);
+
 /// Fourier low pass filtering. Removes modes higher than \p zmax
 ///
 /// @param[in] var   Variable to apply filter to
@@ -744,6 +878,11 @@ const Field3D filter(const Field3D &var, int N0, REGION rgn = RGN_ALL);
 /// @param[in] rgn   The region to calculate the result over
 const Field3D lowPass(const Field3D &var, int zmax, REGION rgn = RGN_ALL);
 
+/// Low pass filtering of a temporary; transformed in place, reusing
+/// the temporary's storage. `f = lowPass(std::move(f), zmax)` filters
+/// without any allocation
+const Field3D lowPass(Field3D &&var, int zmax, REGION rgn = RGN_ALL);
+
 /// Fourier low pass filtering. Removes modes
 /// lower than \p zmin and higher than \p zmax
 ///
@@ -753,6 +892,10 @@ const Field3D lowPass(const Field3D &var, int zmax, REGION rgn = RGN_ALL);
 /// @param[in] rgn   The region to calculate the result over
 const Field3D lowPass(const Field3D &var, int zmax, int zmin, REGION rgn = RGN_ALL);
 
+/// As above, for a temporary; transformed in place, reusing the
+/// temporary's storage
+const Field3D lowPass(Field3D &&var, int zmax, int zmin, REGION rgn = RGN_ALL);
+
 /// Perform a shift by a given angle in Z
 ///
 /// @param[inout] var  The variable to be modified in-place
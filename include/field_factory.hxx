@@ -68,7 +68,8 @@ public:
   // Singleton object
   static FieldFactory *get();
 
-  /// clean the cache of parsed strings
+  /// clean the cache of parsed strings and generated fields.
+  /// Call after changing options or values which expressions refer to
   void cleanCache();
 protected:
   // These functions called by the parser
@@ -82,7 +83,22 @@ private:
   
   // Cache parsed strings
   std::map<std::string, FieldGeneratorPtr > cache;
-  
+
+  // Cache generated fields, keyed on (expression, options identity,
+  // mesh, location), so repeated generation of the same static profile
+  // or boundary shape is a lookup rather than a mesh sweep. Only
+  // time-independent expressions are cached (see
+  // GeneratorBytecode::cacheable), so the cache is bounded by the set
+  // of distinct expressions in the input. Cheap to retain, since the
+  // cached and returned fields share data until one of them is
+  // written to
+  std::map<std::string, Field2D> cache2D;
+  std::map<std::string, Field3D> cache3D;
+
+  /// Build the key used for cache2D/cache3D lookups
+  std::string createKey(const std::string &value, const Options *opt, Mesh *m,
+                        CELL_LOC loc) const;
+
   const Options* findOption(const Options *opt, const std::string &name, std::string &val);
 };
 
@@ -92,9 +92,15 @@ class FieldPerp : public Field {
   const IndexRange DEPRECATED(region(REGION rgn)) const override;
 
   /// Return a Region<IndPerp> reference to use to iterate over this field
-  const Region<IndPerp>& getRegion(REGION region) const;  
+  const Region<IndPerp>& getRegion(REGION region) const;
   const Region<IndPerp>& getRegion(const std::string &region_name) const;
 
+  /// Fill the physical X boundary guard cells with \p value: the
+  /// inner boundary if this processor is first in X, the outer if it
+  /// is last. Guard cells on processor boundaries are left for
+  /// communication to fill
+  void applyBoundary(BoutReal value);
+
   /*!
    * Direct data access using DataIterator indexing
    */
@@ -397,6 +403,13 @@ FieldPerp pow(BoutReal lhs, const FieldPerp &rhs, REGION rgn=RGN_ALL);
 /// Create a FieldPerp by slicing a 3D field at a given y
 const FieldPerp sliceXZ(const Field3D& f, int y);
 
+/// Slice a 3D field at a given y into \p result, reusing its storage
+/// when possible. For loops over y (e.g. plane-by-plane Laplacian
+/// inversions) this avoids allocating a fresh slab per plane; the
+/// data is made unique first, so anything sharing it is unaffected.
+/// Returns a reference to \p result
+FieldPerp& sliceXZ(const Field3D& f, int y, FieldPerp &result);
+
 /// Calculates the minimum of a field, excluding
 /// the boundary/guard cells by default (this can be
 /// changed with the rgn argument).
@@ -34,6 +34,8 @@
 
 #include "field3d.hxx"
 
+#include <memory>
+
 const int GYRO_FLAGS = 64 + 16384 + 32768; ///< = INVERT_BNDRY_ONE | INVERT_IN_RHS | INVERT_OUT_RHS; uses old-style Laplacian inversion flags
 
 /// Gyro-average using Taylor series approximation
@@ -96,4 +98,49 @@ const Field3D gyroPade2(const Field3D &f, const Field2D &rho,
 const Field3D gyroPade2(const Field3D &f, BoutReal rho, 
                         int flags=GYRO_FLAGS);
 
+class Laplacian;
+
+/// Reusable Pade gyro-averaging operator
+///
+/// The free gyroPade functions reset the coefficients of the shared
+/// Laplacian inverter on every call, which discards any cached
+/// factorisations. GyroAverage owns its own inverter and sets the
+/// coefficients once, so while rho is unchanged repeated applications
+/// (e.g. five fields every RHS in a gyrofluid model) reuse the cached
+/// coefficients, and Pade1 and Pade2 of all fields share one setup.
+///
+/// Example
+/// -------
+///
+///     GyroAverage gyro(rho);  // Setup once; rho is a Field2D
+///
+///     // Every RHS:
+///     Field3D ni_avg = gyro.pade1(Ni);
+///     Field3D ti_avg = gyro.pade1(Ti);
+///
+/// If rho changes, call setRho() with the new value
+class GyroAverage {
+public:
+  GyroAverage() = delete;
+
+  /// Create an operator for gyro-radius \p rho (Z average is used),
+  /// passing \p flags to the Laplacian inversion
+  GyroAverage(const Field2D &rho, int flags = GYRO_FLAGS);
+  GyroAverage(BoutReal rho, int flags = GYRO_FLAGS);
+
+  /// Change the gyro-radius, invalidating cached coefficients
+  void setRho(const Field2D &rho);
+  void setRho(BoutReal rho);
+
+  /// Pade approximation \f$\Gamma_1 = (1 - \frac{1}{2} \rho^2 \nabla_\perp^2)g = f\f$
+  const Field3D pade1(const Field3D &f);
+
+  /// Pade approximation \f$\Gamma_2\f$, see gyroPade2
+  const Field3D pade2(const Field3D &f);
+
+private:
+  std::unique_ptr<Laplacian> lap; ///< Owned inverter, keeping its coefficient cache
+  Field2D rho2;                   ///< Gyro-radius squared
+};
+
 #endif // __GYRO_AVERAGE_H__
@@ -35,6 +35,10 @@
 const Field3D interp_to(const Field3D &var, CELL_LOC loc, REGION region = RGN_ALL);
 const Field2D interp_to(const Field2D &var, CELL_LOC loc, REGION region = RGN_ALL);
 
+/// Interpolation of a temporary. When no interpolation is needed the
+/// temporary is passed straight through, reusing its storage
+const Field3D interp_to(Field3D &&var, CELL_LOC loc, REGION region = RGN_ALL);
+
 /// Print out the cell location (for debugging)
 void printLocation(const Field3D &var);
 
@@ -57,6 +61,29 @@ protected:
 
   Mesh *localmesh;
 
+  /// Weight-cache generation: the displacement data the current
+  /// weights were calculated from. Field-aligned schemes and probe
+  /// diagnostics call interpolate(f, delta_x, delta_z) thousands of
+  /// times with identical displacements, so calcWeights returns
+  /// immediately when the data matches. Keyed on the underlying data
+  /// pointers, which copy-on-write replaces whenever a displacement
+  /// field is assigned a new value
+  const BoutReal *cached_delta_x = nullptr;
+  const BoutReal *cached_delta_z = nullptr;
+
+  /// True if the current weights were calculated from exactly this
+  /// displacement data
+  bool weightsCachedFor(const Field3D &delta_x, const Field3D &delta_z) const {
+    return (cached_delta_x == &delta_x(0, 0, 0))
+           && (cached_delta_z == &delta_z(0, 0, 0));
+  }
+
+  /// Record the displacement data the weights were calculated from
+  void cacheWeightsFor(const Field3D &delta_x, const Field3D &delta_z) {
+    cached_delta_x = &delta_x(0, 0, 0);
+    cached_delta_z = &delta_z(0, 0, 0);
+  }
+
 public:
   Interpolation(int y_offset = 0, Mesh *mesh = nullptr)
       : localmesh(mesh), y_offset(y_offset) {
@@ -80,11 +107,24 @@ public:
   virtual Field3D interpolate(const Field3D &f, const Field3D &delta_x,
                               const Field3D &delta_z, const BoutMask &mask) = 0;
 
-  void setMask(const BoutMask &mask) { skip_mask = mask; }
+  virtual void setMask(const BoutMask &mask) {
+    skip_mask = mask;
+    invalidateWeights(); // The mask selects which points get weights
+  }
+
+  /// Drop the cached weight generation, forcing the next calcWeights
+  /// to recalculate. Only needed by callers that modify a displacement
+  /// field in place through operator(), which keeps its data pointer
+  void invalidateWeights() { cached_delta_x = cached_delta_z = nullptr; }
 
   // Interpolate using the field at (x,y+y_offset,z), rather than (x,y,z)
   int y_offset;
-  void setYOffset(int offset) { y_offset = offset; }
+  void setYOffset(int offset) {
+    if (offset != y_offset) {
+      invalidateWeights(); // The offset is baked into the weight rows
+    }
+    y_offset = offset;
+  }
 };
 
 class HermiteSpline : public Interpolation {
@@ -110,6 +150,20 @@ protected:
   Field3D h10_z;
   Field3D h11_z;
 
+  // Fused interpolation weights, applied as a sparse matrix-vector
+  // product in interpolate(). Each unmasked point has one row: a flat
+  // output index and 16 column index / weight pairs, combining the
+  // spline basis functions with the central-difference tension
+  // derivatives so no derivative fields are needed at apply time.
+  std::vector<int> fused_out;    // Flat output index, one per row
+  std::vector<int> fused_ind;    // Flat source indices, 16 per row
+  std::vector<BoutReal> fused_w; // Weights, 16 per row
+  bool weights_calculated = false; ///< Has calcWeights been called?
+
+  /// (Re)build the fused weight rows from the spline basis functions,
+  /// corner indices and skip_mask. Called from calcWeights and setMask
+  void buildFusedWeights();
+
 public:
   HermiteSpline(Mesh *mesh = nullptr) : HermiteSpline(0, mesh) {}
   HermiteSpline(int y_offset = 0, Mesh *mesh = nullptr);
@@ -127,6 +181,13 @@ public:
   void calcWeights(const Field3D &delta_x, const Field3D &delta_z,
                    const BoutMask &mask) override;
 
+  /// The mask selects which fused weight rows exist, so changing it
+  /// rebuilds them
+  void setMask(const BoutMask &mask) override {
+    Interpolation::setMask(mask);
+    buildFusedWeights();
+  }
+
   // Use precalculated weights
   Field3D interpolate(const Field3D &f) const override;
   // Calculate weights and interpolate
@@ -165,10 +226,14 @@ public:
 };
 
 class Lagrange4pt : public Interpolation {
-  Tensor<int> i_corner; // x-index of bottom-left grid point
-  Tensor<int> k_corner; // z-index of bottom-left grid point
-
-  Field3D t_x, t_z;
+  // Precalculated weight rows in the same blocked layout as
+  // HermiteSpline: one flat output index and 16 column index / weight
+  // pairs per unmasked point. The Lagrange polynomial is linear in the
+  // field values, so the weights are the outer product of the 4-point
+  // basis polynomials evaluated at the cell offsets
+  std::vector<int> fused_out;    // Flat output index, one per row
+  std::vector<int> fused_ind;    // Flat source indices, 16 per row
+  std::vector<BoutReal> fused_w; // Weights, 16 per row
 
 public:
   Lagrange4pt(Mesh *mesh = nullptr) : Lagrange4pt(0, mesh) {}
@@ -198,10 +263,13 @@ public:
 };
 
 class Bilinear : public Interpolation {
-  Tensor<int> i_corner; // x-index of bottom-left grid point
-  Tensor<int> k_corner; // z-index of bottom-left grid point
-
-  Field3D w0, w1, w2, w3;
+  // Precalculated weight rows in the same blocked layout as
+  // HermiteSpline, but with the bilinear scheme's four-point stencil:
+  // one flat output index and 4 column index / weight pairs per
+  // unmasked point
+  std::vector<int> fused_out;    // Flat output index, one per row
+  std::vector<int> fused_ind;    // Flat source indices, 4 per row
+  std::vector<BoutReal> fused_w; // Weights, 4 per row
 
 public:
   Bilinear(Mesh *mesh = nullptr) : Bilinear(0, mesh) {}
@@ -35,7 +35,7 @@ class Laplacian;
 #define __LAPLACE_H__
 
 #ifdef BOUT_HAS_PETSC
-#define PVEC_REAL_MPI_TYPE MPI_DOUBLE
+#define PVEC_REAL_MPI_TYPE BOUT_MPI_REAL
 #endif
 
 #include "fieldperp.hxx"
@@ -46,6 +46,10 @@ class Laplacian;
 
 #include "dcomplex.hxx"
 #include "options.hxx"
+#include "utils.hxx"
+
+#include <memory>
+#include <vector>
 
 // Inversion flags for each boundary
 const int INVERT_DC_GRAD  = 1; ///< Zero-gradient for DC (constant in Z) component. Default is zero value
@@ -173,10 +177,90 @@ public:
   virtual void setGlobalFlags(int f) { global_flags = f; }
   virtual void setInnerBoundaryFlags(int f) { inner_boundary_flags = f; }
   virtual void setOuterBoundaryFlags(int f) { outer_boundary_flags = f; }
-  
+
+  /// Force any cached matrices, factorizations or preconditioners to be
+  /// rebuilt on the next solve. The setCoef* methods detect changed
+  /// coefficients automatically; call this if something a solver depends
+  /// on changes behind its back (e.g. the Coordinates are modified)
+  virtual void invalidate() { coef_generation++; }
+
+  /// Number of kz modes skipped / considered by the last solve, when
+  /// adaptive mode truncation is enabled (mode_threshold > 0). Both are
+  /// zero if the solver does not support truncation
+  int getModesSkipped() const { return modes_skipped; }
+  int getModesTotal() const { return modes_total; }
+
   virtual const FieldPerp solve(const FieldPerp &b) = 0;
   virtual const Field3D solve(const Field3D &b);
   virtual const Field2D solve(const Field2D &b);
+
+  /// Handle to an inversion started with solveAsync(). While the
+  /// communication is pending other work can be done, calling
+  /// progress() occasionally to keep messages moving; get() blocks
+  /// until the result is available. get() may be called only once
+  class Future {
+  public:
+    /// Implemented by solvers supporting asynchronous inversion;
+    /// drives the pending solve to completion
+    class State {
+    public:
+      virtual ~State();
+      /// Advance any pending communication, without blocking
+      virtual void progress() {}
+      /// Block until the inversion is finished, returning the result
+      virtual const Field3D wait() = 0;
+    };
+
+    Future() {}
+    /// An already-completed inversion, used by the synchronous fallback
+    explicit Future(const Field3D &value) : value(value), ready(true) {}
+    explicit Future(std::unique_ptr<State> state) : state(std::move(state)) {}
+
+    /// True if get() will produce a result
+    bool valid() const { return ready || (state != nullptr); }
+
+    /// Make one non-blocking pass over any pending communication
+    void progress() {
+      if (state != nullptr)
+        state->progress();
+    }
+
+    /// Wait for the inversion to finish and return the result
+    const Field3D get() {
+      if (!ready) {
+        if (state == nullptr)
+          throw BoutException("Laplacian::Future::get() called on an empty future");
+        value = state->wait();
+        state.reset();
+        ready = true;
+      }
+      return value;
+    }
+
+  private:
+    std::unique_ptr<State> state;
+    Field3D value;
+    bool ready{false};
+  };
+
+  /// Start inverting \p b, returning a Future for the result. The
+  /// default implementation solves immediately and returns a completed
+  /// Future, so callers can use the asynchronous interface with any
+  /// solver; implementations with split-phase communication (see
+  /// LaplaceSPT) override it to overlap the inversion with whatever the
+  /// caller does before Future::get(). Only one asynchronous solve may
+  /// be in flight per solver, and coefficient changes made while one is
+  /// pending apply to subsequent solves only
+  virtual Future solveAsync(const Field3D &b);
+  /// As above, but with an initial guess / boundary value \p x0,
+  /// matching solve(b, x0)
+  virtual Future solveAsync(const Field3D &b, const Field3D &x0);
+
+  /// Invert a batch of right-hand sides which share the same
+  /// coefficients. The default implementation just loops over the
+  /// fields; implementations can override it to amortize matrix setup
+  /// and communication latency over the batch (see LaplaceCyclic)
+  virtual const std::vector<Field3D> solve(const std::vector<Field3D> &b);
   
   virtual const FieldPerp solve(const FieldPerp &b, const FieldPerp &UNUSED(x0)) { return solve(b); }
   virtual const Field3D solve(const Field3D &b, const Field3D &x0);
@@ -200,7 +284,24 @@ protected:
   bool async_send; ///< If true, use asyncronous send in parallel algorithms
   
   int maxmode;     ///< The maximum Z mode to solve for
-  
+
+  /// Skip kz modes whose RHS amplitude is below this fraction of the
+  /// largest mode amplitude, writing zeros instead. 0 (default) solves
+  /// every mode. In saturated turbulence the high-kz RHS amplitudes are
+  /// negligible, so a small threshold (e.g. 1e-8) can skip a large
+  /// fraction of the tridiagonal solves with no measurable change
+  BoutReal mode_threshold;
+
+  /// Flag kz modes whose maximum RHS \p amplitude (length maxmode+1)
+  /// falls below mode_threshold times the largest mode amplitude. The
+  /// DC (kz=0) mode is always solved. Updates the statistics returned
+  /// by getModesSkipped() / getModesTotal()
+  void selectModes(const Array<BoutReal> &amplitude);
+
+  /// Whether selectModes() flagged mode \p kz for skipping. The solver
+  /// writes zeros for skipped modes instead of inverting the matrix
+  bool skipMode(int kz) const { return mode_threshold > 0.0 && mode_skip[kz]; }
+
   bool low_mem;    ///< If true, reduce the amount of memory used
   bool all_terms;  ///< applies to Delp2 operator and laplacian inversion
   bool nonuniform; ///< Non-uniform mesh correction
@@ -212,6 +313,20 @@ protected:
   int inner_boundary_flags; ///< Flags to set inner boundary condition
   int outer_boundary_flags; ///< Flags to set outer boundary condition
 
+  /// Update a cached coefficient field, returning true if the value changed.
+  /// If \p cache shares data with \p val (fields are copy-on-write, so an
+  /// unmodified copy aliases the original) the check is a pointer compare;
+  /// otherwise the values are compared, which is still much cheaper than
+  /// rebuilding a matrix or factorization. Increments coef_generation when
+  /// the coefficient has changed
+  bool updateCoefCache(Field2D &cache, const Field2D &val);
+  bool updateCoefCache(Field3D &cache, const Field3D &val);
+
+  /// Incremented each time a coefficient changes. Implementations record
+  /// the generation their matrix or factorization was built from, and can
+  /// skip the rebuild when it still matches
+  unsigned int coef_generation;
+
   void tridagCoefs(int jx, int jy, BoutReal kwave, dcomplex &a, dcomplex &b, dcomplex &c,
                    const Field2D *ccoef = nullptr, const Field2D *d = nullptr,
                    CELL_LOC loc = CELL_DEFAULT);
@@ -222,13 +337,48 @@ protected:
                     const Field2D *d = nullptr);
 
   void tridagMatrix(dcomplex *avec, dcomplex *bvec, dcomplex *cvec,
-                    dcomplex *bk, int jy, int kz, BoutReal kwave, 
+                    dcomplex *bk, int jy, int kz, BoutReal kwave,
                     int flags, int inner_boundary_flags, int outer_boundary_flags,
-                    const Field2D *a, const Field2D *ccoef, 
+                    const Field2D *a, const Field2D *ccoef,
                     const Field2D *d,
                     bool includeguards=true);
+
+  /// Tridiagonal matrix coefficients for one y index, as built by
+  /// tridagMatrix with includeguards = true
+  struct TridagCoefTable {
+    Matrix<dcomplex> avec, bvec, cvec; ///< Diagonal bands, indexed (kz, ix)
+    /// The same bands in split real/imaginary layout with the mode
+    /// index fastest, for the batched solver (see tridagBatch)
+    ComplexBatch avecs, bvecs, cvecs;
+    unsigned int generation;           ///< coef_generation the table was built from
+    bool valid = false;
+  };
+
+  /// Return the tridiagonal matrix coefficients for y index \p jy,
+  /// for all modes kz <= maxmode. The table is built on first use and
+  /// rebuilt only when a coefficient has changed (see coef_generation),
+  /// so in steady state a solve does no coefficient work.
+  ///
+  /// Note the returned matrix must not be modified: callers apply the
+  /// RHS part of the boundary conditions with zeroBoundaryRHS()
+  const TridagCoefTable &cachedTridagMatrix(int jy, const Field2D *a,
+                                            const Field2D *ccoef, const Field2D *d);
+
+  /// Apply the RHS part of the boundary conditions to \p bk (length
+  /// LocalNx), zeroing boundary rows unless a user-specified value is
+  /// used (INVERT_RHS or INVERT_SET). This is the only change
+  /// tridagMatrix makes to the RHS, factored out so cached matrices
+  /// can be used. Same for all kz
+  void zeroBoundaryRHS(dcomplex *bk);
+
   CELL_LOC location;
 private:
+  /// Per-y-index cached tridiagonal matrices, built by cachedTridagMatrix()
+  std::vector<TridagCoefTable> coef_table;
+
+  std::vector<bool> mode_skip; ///< Modes flagged by selectModes()
+  int modes_skipped = 0, modes_total = 0; ///< Statistics from the last selectModes()
+
   /// Singleton instance
   static Laplacian *instance;
 };
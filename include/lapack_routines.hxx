@@ -43,12 +43,33 @@
 
 // Tri-diagonal solvers
 int tridag(const dcomplex *a, const dcomplex *b, const dcomplex *c, const dcomplex *r, dcomplex *u, int n);
+
+/// Batched complex tridiagonal solver on split real/imaginary storage.
+///
+/// Solves one tridiagonal system per batch member. The Thomas
+/// recurrence runs over rows with an inner, contiguous loop over the
+/// batch, so independent per-mode solves vectorise across modes.
+/// Band conventions per batch member are the same as for tridag().
+/// All arguments must have the same length and batch size.
+///
+/// Unlike tridag() this does not need LAPACK
+void tridagBatch(const ComplexBatch &a, const ComplexBatch &b, const ComplexBatch &c,
+                 const ComplexBatch &r, ComplexBatch &u);
 bool tridag(const BoutReal *a, const BoutReal *b, const BoutReal *c, const BoutReal *r, BoutReal *x, int n);
 
 // Cyclic tridiagonal
 void cyclic_tridag(BoutReal *a, BoutReal *b, BoutReal *c, BoutReal *r, BoutReal *x, int n);
 void cyclic_tridag(dcomplex *a, dcomplex *b, dcomplex *c, dcomplex *r, dcomplex *x, int n);
 
+/// Batched cyclic (periodic) tridiagonal solver on split storage.
+///
+/// Solves one cyclic tridiagonal system per batch member using the
+/// Sherman-Morrison formula, with both inner solves going through
+/// tridagBatch() so they vectorise across the batch. Each system must
+/// have length > 2. Like tridagBatch(), does not need LAPACK
+void cyclicTridagBatch(const ComplexBatch &a, const ComplexBatch &b,
+                       const ComplexBatch &c, const ComplexBatch &r, ComplexBatch &x);
+
 /// Complex band matrix solver
 void cband_solve(Matrix<dcomplex> &a, int n, int m1, int m2, Array<dcomplex> &b);
 
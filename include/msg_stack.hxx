@@ -32,6 +32,7 @@ class MsgStack;
 #include "unused.hxx"
 #include "bout/format.hxx"
 
+#include <cstdio>
 #include <exception>
 #include <stdarg.h>
 #include <string>
@@ -61,6 +62,12 @@ public:
   int push(const char *s, ...)
     BOUT_FORMAT_ARGS( 2, 3); ///< Add a message to the stack. Returns a message id
 
+  /// Add a message to the stack without formatting it: only the
+  /// pointers are stored, and the message is formatted if the stack is
+  /// dumped. \p file and \p msg must outlive the stack entry, so should
+  /// be string literals (as in the TRACE macro)
+  int push(const char *file, int line, const char *msg);
+
   int setPoint(); ///< get a message point
 
   void pop();       ///< Remove the last message
@@ -72,6 +79,9 @@ public:
 #else
   /// Dummy functions which should be optimised out
   int push(const char *UNUSED(s), ...) { return 0; }
+  int push(const char *UNUSED(file), int UNUSED(line), const char *UNUSED(msg)) {
+    return 0;
+  }
 
   int setPoint() { return 0; }
 
@@ -86,8 +96,18 @@ public:
 private:
   char buffer[256]; ///< Buffer for vsnprintf
 
-  std::vector<std::string> stack;               ///< Message stack;
-  std::vector<std::string>::size_type position; ///< Position in stack
+  /// A message on the stack. Deferred messages store only pointers to
+  /// string literals, with \p msg non-null; eagerly formatted messages
+  /// store the result in \p formatted with \p msg null
+  struct Message {
+    std::string formatted;
+    const char *msg = nullptr;
+    const char *file = nullptr;
+    int line = 0;
+  };
+
+  std::vector<Message> stack;               ///< Message stack;
+  std::vector<Message>::size_type position; ///< Position in stack
 };
 
 /*!
@@ -121,23 +141,37 @@ public:
   MsgStackItem(const char *msg, const char *file, int line) {
     point = msg_stack.push("%s on line %d of '%s'", msg, line, file);
   }
-  MsgStackItem(const char *file, int line, const char *msg, ...)
-    BOUT_FORMAT_ARGS( 4, 5) {
-    va_list args;
-    va_start(args, msg);
-    vsnprintf(buffer, MSG_MAX_SIZE, msg, args);
+  // Common case: a message with no arguments, so all formatting can be
+  // deferred until the stack is dumped
+  MsgStackItem(MAYBE_UNUSED(const char *file), MAYBE_UNUSED(int line),
+               MAYBE_UNUSED(const char *msg)) {
+#if CHECK > 1
+    point = msg_stack.push(file, line, msg);
+#endif
+  }
+  /// A message with arguments must be formatted on push, since the
+  /// arguments may no longer exist when the stack is dumped. A template
+  /// rather than C varargs so that the deferred constructor above is
+  /// preferred when there are no arguments
+  template <typename... Args>
+  MsgStackItem(MAYBE_UNUSED(const char *file), MAYBE_UNUSED(int line),
+               MAYBE_UNUSED(const char *msg), Args... args) {
+#if CHECK > 1
+    snprintf(buffer, MSG_MAX_SIZE, msg, args...);
     point = msg_stack.push("%s on line %d of '%s'", buffer, line, file);
-    va_end(args);
+#endif
   }
   ~MsgStackItem() {
+#if CHECK > 1
     // If an exception has occurred, don't pop the message
     if (!std::uncaught_exception()) {
       msg_stack.pop(point);
     }
+#endif
   }
 
 private:
-  int point;
+  int point = 0;
   char buffer[256];
 };
 
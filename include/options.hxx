@@ -34,6 +34,7 @@
 **************************************************************************/
 
 class Options;
+template <typename T> class OptionHandle;
 
 #pragma once
 #ifndef __OPTIONS_H__
@@ -332,6 +333,21 @@ public:
     return val;
   }
 
+  /// Bind a variable to this option, returning a lightweight typed
+  /// handle. Reading the handle is a counter compare plus pointer
+  /// dereference, so it can be used every RHS or monitor call without
+  /// repeating the string map lookups. See OptionHandle
+  template <typename T> OptionHandle<T> bind(T def);
+
+  /// Bind a variable to option \p name in \p section, creating it
+  /// with default \p def if not set. See bind(T def)
+  template <typename T>
+  OptionHandle<T> bind(const std::string &section, const std::string &name, T def);
+
+  /// Number of times this option's value has been (re)assigned.
+  /// Used by OptionHandle to detect changes cheaply
+  unsigned int modificationCount() const { return modification; }
+
   /// Get the parent Options object
   Options &parent() {
     if (parent_instance == nullptr) {
@@ -435,6 +451,8 @@ public:
 
   bool is_value = false; ///< Is this Options object a value?
   OptionValue value{}; ///< If a value
+
+  unsigned int modification = 0; ///< Incremented every time the value is set
   
   void _set(std::string val, std::string source, bool force);
 
@@ -475,6 +493,72 @@ inline void Options::assign<std::string>(std::string val, const std::string sour
   _set(val,source,false);
 };
 
+/// Lightweight typed handle to a single option, created by
+/// Options::bind.
+///
+/// The string map lookups and parsing happen once, when the handle is
+/// created or when the underlying option changes; after that reading
+/// the value is a counter compare plus pointer dereference, cheap
+/// enough for a physics rhs() or monitor.
+///
+/// Example
+/// -------
+///
+///     // In init():
+///     auto flag = Options::root().bind("mymodel", "flag", false);
+///
+///     // Every rhs():
+///     if (flag) { ... }            // No string lookups here
+///     if (flag.changed()) { ... }  // Option was re-set since last read
+///
+/// The handle holds a pointer into the Options tree, so it must not
+/// outlive the tree (e.g. be read after Options::cleanup())
+template <typename T>
+class OptionHandle {
+public:
+  OptionHandle() = delete;
+
+  /// Bind to \p option, assigning default \p def if it has no value
+  OptionHandle(Options *option, T def) : option(option), def(def) {
+    refresh();
+  }
+
+  /// Current value, re-parsed only if the option has been re-set
+  const T& get() {
+    if (seen != option->modificationCount()) {
+      refresh();
+    }
+    return val;
+  }
+
+  /// Implicit conversion, so the handle can be used like the value
+  operator T() { return get(); }
+
+  /// Has the option been re-set since the last get()?
+  bool changed() const { return seen != option->modificationCount(); }
+
+private:
+  void refresh() {
+    val = option->withDefault<T>(def);
+    seen = option->modificationCount();
+  }
+
+  Options *option;  ///< The bound option; owned by the Options tree
+  T val;            ///< Cached parsed value
+  T def;            ///< Default, reused if the value is unset again
+  unsigned int seen;///< Modification count the cache was parsed from
+};
+
+template <typename T>
+OptionHandle<T> Options::bind(T def) {
+  return OptionHandle<T>(this, def);
+}
+
+template <typename T>
+OptionHandle<T> Options::bind(const std::string &section, const std::string &name, T def) {
+  return (*this)[section][name].bind(def);
+}
+
 /// Define for reading options which passes the variable name
 #define OPTION(options, var, def)  \
   pointer(options)->get(#var, var, def)
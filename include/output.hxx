@@ -30,9 +30,12 @@ class Output;
 #define __OUTPUT_H__
 
 #include "multiostream.hxx"
+#include <atomic>
 #include <iostream>
 #include <fstream>
 #include <functional>
+#include <thread>
+#include <vector>
 
 #include "bout/assert.hxx"
 #include "boutexception.hxx"
@@ -77,6 +80,7 @@ public:
     open("%s",fname);
   }
   ~Output() override {
+    flushBuffer(); // Stop the flush thread (if any) before closing streams
     close();
     delete[] buffer;
   }
@@ -110,6 +114,20 @@ public:
 
   static Output *getInstance(); ///< Return pointer to instance
 
+  /// Switch to buffered logging. Formatted messages are pushed into a
+  /// ring buffer of \p size bytes and drained to the output streams by
+  /// a background thread, so writes don't pay for stream flushing.
+  /// The ring is single-producer (BOUT++ logs from the serial sections
+  /// only), single-consumer, and lock-free; if a burst overruns the
+  /// ring the writer waits for the flush thread, preserving message
+  /// order. No effect if already buffered.
+  void setBuffered(int size);
+
+  /// Stop buffered logging, draining any pending messages to the
+  /// output streams. Subsequent writes are synchronous again. Safe to
+  /// call when not buffered.
+  void flushBuffer();
+
 protected:
   friend class ConditionalOutput;
   virtual Output *getBase() { return this; }
@@ -121,6 +139,18 @@ private:
   int buffer_len;                     ///< the current length
   char *buffer;                       ///< Buffer used for C style output
   bool enabled;                       ///< Whether output to stdout is enabled
+
+  // Buffered logging mode (see setBuffered). head and tail count bytes
+  // monotonically; the storage index is position modulo the ring size
+  std::vector<char> ring;               ///< Ring buffer storage
+  std::atomic<size_t> ring_head{0};     ///< Next write position (producer)
+  std::atomic<size_t> ring_tail{0};     ///< Next read position (consumer)
+  std::atomic<bool> flush_run{false};   ///< Is the flush thread running?
+  std::thread flush_thread;             ///< Drains the ring in the background
+
+  bool ringPush(const char *data, size_t len); ///< Producer side; false if full
+  void drainRing();                     ///< Consumer side; write pending bytes
+  void flushLoop();                     ///< Flush thread main loop
 };
 
 /// Class which behaves like Output, but has no effect.
@@ -33,6 +33,11 @@
 /// Smooth in X using simple 1-2-1 filter
 const Field3D smooth_x(const Field3D &f);
 
+/// Apply \p npasses passes of the 1-2-1 filter in X, fused so that
+/// only one temporary is allocated and boundaries are communicated
+/// once at the end rather than per pass
+const Field3D smooth_x(const Field3D &f, int npasses);
+
 /// Smooth in Y using 1-2-1 filter
 const Field3D smooth_y(const Field3D &f);
 
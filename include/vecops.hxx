@@ -96,6 +96,11 @@ const Vector3D DEPRECATED(Grad_perp(const Field3D &f, CELL_LOC outloc_x,
 const Field2D Div(const Vector2D &v, CELL_LOC outloc = CELL_DEFAULT);
 const Field3D Div(const Vector3D &v, CELL_LOC outloc = CELL_DEFAULT);
 
+/// Div of a temporary vector, e.g. Div(f * v). The covariant/contravariant
+/// conversion is done in place, reusing the temporary's storage instead
+/// of copying all three components
+const Field3D Div(Vector3D &&v, CELL_LOC outloc = CELL_DEFAULT);
+
 const Field2D Div(const Vector2D &v, const Field2D &f, CELL_LOC outloc = CELL_DEFAULT);
 const Field3D Div(const Vector3D &v, const Field3D &f, DIFF_METHOD method, CELL_LOC outloc = CELL_DEFAULT);
 const Field3D Div(const Vector3D &v, const Field3D &f, CELL_LOC outloc, DIFF_METHOD method = DIFF_DEFAULT);
@@ -115,6 +120,10 @@ const Field3D Div(const Vector3D &v, const Field3D &f);
 ///
 const Vector2D Curl(const Vector2D &v);
 const Vector3D Curl(const Vector3D &v);
+
+/// Curl of a temporary vector. The conversion to covariant components
+/// is done in place, reusing the temporary's storage
+const Vector3D Curl(Vector3D &&v);
 inline const Vector2D DEPRECATED(Curl(const Vector2D &v, CELL_LOC UNUSED(outloc))) {
   return Curl(v);
 }
@@ -138,6 +147,11 @@ const Field3D V_dot_Grad(const Vector2D &v, const Field3D &f);
 const Field3D V_dot_Grad(const Vector3D &v, const Field2D &f);
 const Field3D V_dot_Grad(const Vector3D &v, const Field3D &f);
 
+/// Advection by a temporary velocity vector, e.g. V_dot_Grad(b0 ^ Grad(phi), f).
+/// The conversion to contravariant components is done in place, reusing
+/// the temporary's storage instead of copying all three components
+const Field3D V_dot_Grad(Vector3D &&v, const Field3D &f);
+
 /// Advection of a vector field \p a by a velocity vector \p v
 ///
 /// Both vectors must be at the same location, which cannot be CELL_VSHIFT
@@ -146,4 +160,8 @@ const Vector3D V_dot_Grad(const Vector2D &v, const Vector3D &a);
 const Vector3D V_dot_Grad(const Vector3D &v, const Vector2D &a);
 const Vector3D V_dot_Grad(const Vector3D &v, const Vector3D &a);
 
+/// Advection by a temporary velocity vector; converted in place,
+/// reusing the temporary's storage
+const Vector3D V_dot_Grad(Vector3D &&v, const Vector3D &a);
+
 #endif // __VECOPS_H__
@@ -59,5 +59,19 @@ const Field2D where(const Field2D &test, BoutReal gt0, BoutReal le0);
 /// @param[in] le0    Uses this value if test <= 0.0
 const Field3D where(const Field3D &test, BoutReal gt0, const Field3D &le0);
 
+/// In-place versions: select into an existing \p result field, avoiding
+/// the temporary returned by the versions above. \p result is allocated
+/// if needed and every cell is overwritten.
+void where(Field3D &result, const Field2D &test, const Field3D &gt0, const Field3D &le0);
+void where(Field3D &result, const Field2D &test, const Field3D &gt0, BoutReal le0);
+void where(Field3D &result, const Field2D &test, BoutReal gt0, const Field3D &le0);
+void where(Field3D &result, const Field2D &test, const Field3D &gt0, const Field2D &le0);
+void where(Field3D &result, const Field2D &test, const Field2D &gt0, const Field3D &le0);
+void where(Field2D &result, const Field2D &test, const Field2D &gt0, const Field2D &le0);
+void where(Field2D &result, const Field2D &test, const Field2D &gt0, BoutReal le0);
+void where(Field2D &result, const Field2D &test, BoutReal gt0, const Field2D &le0);
+void where(Field2D &result, const Field2D &test, BoutReal gt0, BoutReal le0);
+void where(Field3D &result, const Field3D &test, BoutReal gt0, const Field3D &le0);
+
 #endif // __WHERE_H__
 
@@ -57,10 +57,18 @@ const char DEFAULT_LOG[] = "BOUT.log";
 #include <optionsreader.hxx>
 #include <msg_stack.hxx>
 
+#include <bout/array_metrics.hxx>
+#include <bout/cached.hxx>
+#include <bout/cpu_dispatch.hxx>
 #include <bout/sys/timer.hxx>
+#include <bout/sys/hwcounters.hxx>
+#include <bout/sys/tracer.hxx>
+#include <bout/sys/watchdog.hxx>
 
 #include <boundary_factory.hxx>
 
+#include <fft.hxx>
+
 #include <invert_laplace.hxx>
 
 #include <bout/slepclib.hxx>
@@ -378,6 +386,13 @@ int BoutInitialise(int &argc, char **&argv) {
   output_info.write("\tOpenMP parallelisation disabled\n");
 #endif
 
+#ifdef BOUT_HAS_TARGET_CLONES
+  output_info.write("\tMulti-versioned kernels enabled, this CPU selects %s\n",
+                    bout::cpuDispatchTarget());
+#else
+  output_info.write("\tMulti-versioned kernels disabled\n");
+#endif
+
 #ifdef METRIC3D
   output_info.write("\tRUNNING IN 3D-METRIC MODE\n");
 #endif
@@ -394,6 +409,8 @@ int BoutInitialise(int &argc, char **&argv) {
   Options *options = Options::getRoot();
 
   try {
+    Timer timer("startup:options"); // Phase timing, reported below
+
     /// Load settings file
     OptionsReader *reader = OptionsReader::getInstance();
     reader->read(options, "%s/%s", data_dir, opt_file);
@@ -413,13 +430,110 @@ int BoutInitialise(int &argc, char **&argv) {
 
   try {
     /////////////////////////////////////////////
-    
-    mesh = Mesh::create();  ///< Create the mesh
-    mesh->load();           ///< Load from sources. Required for Field initialisation
-    mesh->setParallelTransform(); ///< Set the parallel transform from options
+    {
+      Timer timer("startup:mesh");
+
+      mesh = Mesh::create();  ///< Create the mesh
+      mesh->load();           ///< Load from sources. Required for Field initialisation
+
+      // Note: The parallel transform (and any interpolation tables it
+      // builds, e.g. for shifted metric or FCI) is not constructed
+      // here: Mesh::getParallelTransform() creates it on first use, so
+      // runs which never use it don't pay for it at startup
+    }
+    /////////////////////////////////////////////
+
+    Timer timer("startup:io"); // Remainder of initialisation is I/O setup
+
+    {
+      Timer fft_timer("startup:fft");
+
+      // FFTW wisdom: import plans measured by previous runs in this
+      // directory, then optionally plan the z transforms this mesh will
+      // use, so planner cost is paid once here and the first timestep
+      // latency is deterministic. Wisdom is saved again in BoutFinalise.
+      fft_load_wisdom(string(data_dir) + "/BOUT.wisdom");
+
+      bool fft_warm_start;
+      options->getSection("fft")->get("warm_start", fft_warm_start, true);
+      if (fft_warm_start && (mesh->LocalNz > 1)) {
+        fft_warmup(mesh->LocalNz);
+      }
+    }
+
     /////////////////////////////////////////////
     /// Get some settings
 
+    // Runtime tiering of the non-finite data checks (see checkData in
+    // the field sources): the cheap reduction can be enabled below
+    // CHECK > 2 for triage, and thinned by sampling in production
+    OPTION(options, check_data_enable_finite, false);
+    OPTION(options, check_data_sample_stride, 1);
+
+    // Timeline tracing of Timer scopes and MsgStack points, flushed
+    // as per-processor Trace Event files at the end of the run (see
+    // bout/sys/tracer.hxx)
+    bool trace_enabled;
+    options->getSection("trace")->get("enabled", trace_enabled, false);
+    if (trace_enabled) {
+      int trace_buffer_size; // Events kept per processor; the ring
+                             // wraps, keeping the most recent
+      options->getSection("trace")->get("buffer_size", trace_buffer_size, 1048576);
+      Tracer::enable(trace_buffer_size);
+    }
+
+    // Hardware counter sampling of Timer scopes, for per-region
+    // arithmetic intensity (see bout/sys/hwcounters.hxx)
+    bool hwcounters_enabled;
+    options->getSection("hwcounters")->get("enabled", hwcounters_enabled, false);
+    if (hwcounters_enabled) {
+      string flops_event; // Raw PMU event code counting FLOPs,
+                          // e.g. "0x10c7"; "0" for none
+      int line_size;      // Bytes moved per cache miss
+      BoutReal peak_gflops, peak_gbytes; // Machine peaks for roofline
+                                         // positioning; 0 to skip
+      options->getSection("hwcounters")->get("flops_event", flops_event, "0");
+      options->getSection("hwcounters")->get("line_size", line_size, 64);
+      options->getSection("hwcounters")->get("peak_gflops", peak_gflops, 0.0);
+      options->getSection("hwcounters")->get("peak_gbytes", peak_gbytes, 0.0);
+      HwCounters::enable(strtoll(flops_event.c_str(), nullptr, 0), line_size,
+                         peak_gflops, peak_gbytes);
+    }
+
+    // Buffered logging: formatted log messages go into a ring buffer
+    // drained by a background thread, so per-step logging doesn't
+    // serialise on stream flushing (see Output::setBuffered)
+    bool log_buffered;
+    options->getSection("logging")->get("buffered", log_buffered, false);
+    if (log_buffered) {
+      int log_buffer_size; // Ring size in bytes
+      options->getSection("logging")->get("buffer_size", log_buffer_size, 65536);
+      Output::getInstance()->setBuffered(log_buffer_size);
+    }
+
+    // Stall watchdog: a monitoring thread per processor that dumps a
+    // diagnosis to stderr when the heartbeat counter incremented in
+    // the hot paths stops advancing (see bout/sys/watchdog.hxx)
+    bool watchdog_enabled;
+    options->getSection("watchdog")->get("enabled", watchdog_enabled, false);
+    if (watchdog_enabled) {
+      BoutReal watchdog_timeout; // Stall threshold in seconds
+      options->getSection("watchdog")->get("timeout", watchdog_timeout, 300.0);
+      bool watchdog_abort; // MPI_Abort on a diagnosed stall?
+      options->getSection("watchdog")->get("abort", watchdog_abort, false);
+      Watchdog::enable(watchdog_timeout, watchdog_abort);
+    }
+
+    // Optionally restrict info and progress output to processor 0;
+    // warnings and errors are still logged by every processor
+    bool log_all_ranks;
+    options->getSection("logging")->get("all_ranks", log_all_ranks, true);
+    if ((!log_all_ranks) && (MYPE != 0)) {
+      output_info.disable();
+      output_progress.disable();
+      output.disable();
+    }
+
     // Check if restarting
     bool append;
     OPTION(options, append, false);
@@ -454,6 +568,14 @@ int BoutInitialise(int &argc, char **&argv) {
     output_error.write("Error encountered during initialisation: %s\n", e.what());
     throw;
   }
+
+  // Report where startup time went, so slow starts at scale can be
+  // diagnosed and attacked phase by phase
+  output_info.write("Startup: options %.3f s, mesh %.3f s (fft %.3f s, other io %.3f s)\n",
+                    Timer::getTime("startup:options"), Timer::getTime("startup:mesh"),
+                    Timer::getTime("startup:fft"),
+                    Timer::getTime("startup:io") - Timer::getTime("startup:fft"));
+
   return 0;
 }
 
@@ -463,7 +585,7 @@ int bout_run(Solver *solver, rhsfunc physics_run) {
   solver->setRHS(physics_run);
   
   /// Add the monitor function
-  Monitor * bout_monitor = new BoutMonitor();
+  Monitor * bout_monitor = new BoutMonitor(solver);
   solver->addMonitor(bout_monitor, Solver::BACK);
 
   /// Run the simulation
@@ -472,6 +594,15 @@ int bout_run(Solver *solver, rhsfunc physics_run) {
 
 int BoutFinalise() {
 
+  // Stop the stall watchdog before teardown, so slow cleanup (e.g.
+  // closing files) is not diagnosed as a stall
+  Watchdog::disable();
+
+  // Drain any buffered log output and return to synchronous logging,
+  // so everything below appears in order and nothing is lost if a
+  // cleanup step fails
+  Output::getInstance()->flushBuffer();
+
   // Output the settings, showing which options were used
   // This overwrites the file written during initialisation
   try {
@@ -489,6 +620,15 @@ int BoutFinalise() {
     output_error << e.what() << endl;
   }
 
+  // Save the FFTW wisdom gathered during this run, so future runs in
+  // the same directory can skip plan measurement. All processors plan
+  // the same transforms, so only one needs to write
+  if (BoutComm::rank() == 0) {
+    string data_dir;
+    Options::getRoot()->get("datadir", data_dir, string(DEFAULT_DIR));
+    fft_save_wisdom(data_dir + "/BOUT.wisdom");
+  }
+
   // Delete the mesh
   delete mesh;
 
@@ -498,6 +638,29 @@ int BoutFinalise() {
   // Make sure all processes have finished writing before exit
   MPI_Barrier(BoutComm::get());
 
+  // Optionally print a breakdown of where time was spent, over the
+  // tree of nested Timer scopes. Collective over all processors, so
+  // must be done before MPI is finalised
+  bool time_report;
+  Options::getRoot()->get("time_report", time_report, false);
+  if (time_report) {
+    output << Timer::getPerformanceReport();
+  }
+
+  // Hardware counter breakdown over the same scopes. Also collective
+  if (HwCounters::enabled()) {
+    output << HwCounters::getReport();
+  }
+  HwCounters::cleanup();
+
+  // Flush the timeline trace, one file per processor
+  if (Tracer::enabled()) {
+    string data_dir;
+    Options::getRoot()->get("datadir", data_dir, string(DEFAULT_DIR));
+    Tracer::write(data_dir + "/BOUT.trace");
+  }
+  Tracer::cleanup();
+
   // Laplacian inversion
   Laplacian::cleanup();
 
@@ -505,6 +668,7 @@ int BoutFinalise() {
   Array<BoutReal>::cleanup();
   Array<dcomplex>::cleanup();
   Array<fcmplx>::cleanup();
+  Array<float>::cleanup(); // Used by FieldHistory single-precision storage
   Array<int>::cleanup();
   Array<unsigned long>::cleanup();
   
@@ -539,6 +703,59 @@ int BoutFinalise() {
  * Called each timestep by the solver
  **************************************************************************/
 
+BoutMonitor::BoutMonitor(Solver *solver) {
+  // Optionally save per-output-step integrator statistics (internal
+  // steps, failed steps, RHS calls, Newton/Krylov iterations, last
+  // internal timestep) to the dump file, so performance collapses can
+  // be correlated with physics events in post-processing
+  bool save_solver_stats;
+  Options::getRoot()->get("save_solver_stats", save_solver_stats, false);
+  if (save_solver_stats && (solver != nullptr)) {
+    solver->addTelemetry(dump);
+  }
+
+  // Optionally save the per-timestep timings to the dump file, as a
+  // cheap way to monitor performance over a run
+  bool save_wtimes;
+  Options::getRoot()->get("save_wtimes", save_wtimes, false);
+  if (save_wtimes) {
+    dump.add(wtime, "wtime", true);
+    dump.add(wtime_rhs, "wtime_rhs", true);
+    dump.add(wtime_invert, "wtime_invert", true);
+    dump.add(wtime_comms, "wtime_comms", true);
+    dump.add(wtime_io, "wtime_io", true);
+  }
+
+  // Optionally instrument the Array store, counting allocations, store
+  // misses and copy-on-write copies per solver stage. Dumped and reset
+  // each output timestep below
+  Options::getRoot()->get("report_array_metrics", report_array_metrics, false);
+  if (report_array_metrics) {
+    ArrayMetrics::enabled() = true;
+    // Optionally also capture the message stack at every copy-on-write
+    // copy, to trace the copies back to the operations causing them.
+    // Needs CHECK >= 2 for the stack to carry TRACE messages
+    bool callsites;
+    Options::getRoot()->get("array_metrics_callsites", callsites, false);
+    ArrayMetrics::captureCallsites() = callsites;
+  }
+
+  // Optionally report the fraction of bout::Cached operator results
+  // reused rather than recomputed, showing how much of the RHS is
+  // skipped for static or quasi-static inputs
+  Options::getRoot()->get("report_cache_reuse", report_cache_reuse, false);
+
+  // Optionally collect the distribution of RHS time across processors,
+  // to identify which part of the decomposition is the straggler
+  Options::getRoot()->get("report_imbalance", report_imbalance, false);
+  if (report_imbalance) {
+    dump.add(wtime_mpi_wait, "wtime_mpi_wait", true);
+    dump.add(wtime_rhs_min, "wtime_rhs_min", true);
+    dump.add(wtime_rhs_mean, "wtime_rhs_mean", true);
+    dump.add(wtime_rhs_max, "wtime_rhs_max", true);
+  }
+}
+
 int BoutMonitor::call(Solver *solver, BoutReal t, int iter, int NOUT) {
   TRACE("BoutMonitor::call(%e, %d, %d)", t, iter, NOUT);
 
@@ -558,16 +775,63 @@ int BoutMonitor::call(Solver *solver, BoutReal t, int iter, int NOUT) {
   dump.write();
 
   /// Collect timing information
-  BoutReal wtime        = Timer::resetTime("run");
+  wtime                 = Timer::resetTime("run");
   int ncalls            = solver->resetRHSCounter();
   int ncalls_e		= solver->resetRHSCounter_e();
   int ncalls_i		= solver->resetRHSCounter_i();
 
   bool output_split     = solver->splitOperator();
-  BoutReal wtime_rhs    = Timer::resetTime("rhs");
-  BoutReal wtime_invert = Timer::resetTime("invert");
-  BoutReal wtime_comms  = Timer::resetTime("comms");  // Time spent communicating (part of RHS)
-  BoutReal wtime_io     = Timer::resetTime("io");      // Time spend on I/O
+  wtime_rhs             = Timer::resetTime("rhs");
+  wtime_invert          = Timer::resetTime("invert");
+  wtime_comms           = Timer::resetTime("comms");  // Time spent communicating (part of RHS)
+  wtime_io              = Timer::resetTime("io");      // Time spend on I/O
+
+  if (report_imbalance) {
+    // Distribution of the RHS time across processors. Collective, so
+    // every processor must take this branch
+    wtime_mpi_wait = Timer::resetTime("mpi_wait");
+
+    struct {
+      double t; // Timings stay double even when fields are single precision
+      int rank;
+    } local, fastest, slowest;
+    local.t = wtime_rhs;
+    local.rank = BoutComm::rank();
+    MPI_Allreduce(&local, &fastest, 1, MPI_DOUBLE_INT, MPI_MINLOC, BoutComm::get());
+    MPI_Allreduce(&local, &slowest, 1, MPI_DOUBLE_INT, MPI_MAXLOC, BoutComm::get());
+    double local_wtime = wtime_rhs, total;
+    MPI_Allreduce(&local_wtime, &total, 1, MPI_DOUBLE, MPI_SUM, BoutComm::get());
+
+    wtime_rhs_min = fastest.t;
+    wtime_rhs_max = slowest.t;
+    wtime_rhs_mean = total / BoutComm::size();
+    rhs_straggler = slowest.rank;
+
+    if (wtime_rhs_mean > 0.0) {
+      output.write("RHS imbalance: min %.3e  mean %.3e  max %.3e (+%.1f%%, rank %d)\n",
+                   wtime_rhs_min, wtime_rhs_mean, wtime_rhs_max,
+                   100. * (wtime_rhs_max / wtime_rhs_mean - 1.), rhs_straggler);
+    }
+  }
+
+  if (report_array_metrics) {
+    // Dump and reset the Array store counters, so each report covers
+    // one output timestep
+    output.write("%s", ArrayMetrics::report().c_str());
+    ArrayMetrics::reset();
+  }
+
+  if (report_cache_reuse) {
+    // Fraction of memoised operator results returned without
+    // recomputation, reset so each report covers one output timestep
+    const unsigned long long hits = bout::CacheStats::hits();
+    const unsigned long long total = hits + bout::CacheStats::misses();
+    if (total > 0) {
+      output.write("Cached operator reuse: %llu of %llu calls (%.1f%%)\n", hits, total,
+                   100. * static_cast<BoutReal>(hits) / static_cast<BoutReal>(total));
+    }
+    bout::CacheStats::reset();
+  }
 
   output_progress.print("\r"); // Only goes to screen
 
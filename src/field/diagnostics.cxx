@@ -0,0 +1,164 @@
+/**************************************************************************
+ * Batched scalar diagnostics, evaluated in fused mesh sweeps
+ *
+ * See include/bout/diagnostics.hxx for the API description
+ *
+ **************************************************************************
+ * Copyright 2018 BOUT++ contributors
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+#include <bout/diagnostics.hxx>
+
+#include <bout/reductions.hxx>
+#include <boutexception.hxx>
+#include <datafile.hxx>
+#include <msg_stack.hxx>
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+namespace {
+
+/// Pick the declared reduction out of a resolved FieldReduction
+BoutReal applyOp(const FieldReduction &r, DiagnosticSet::Op op) {
+  switch (op) {
+  case DiagnosticSet::Op::Mean:
+    return r.mean();
+  case DiagnosticSet::Op::RMS:
+    return r.l2();
+  case DiagnosticSet::Op::Min:
+    return r.min;
+  case DiagnosticSet::Op::Max:
+    return r.max;
+  case DiagnosticSet::Op::Sum:
+    return r.sum;
+  }
+  throw BoutException("DiagnosticSet: unknown reduction operation");
+}
+
+/// Index of \p f in \p fields, adding it if not yet present. Distinct
+/// ops on the same field over the same region share one reduction
+template <typename FieldType>
+int fieldIndex(std::vector<const FieldType *> &fields, const FieldType *f) {
+  auto it = std::find(fields.begin(), fields.end(), f);
+  if (it == fields.end()) {
+    fields.push_back(f);
+    return static_cast<int>(fields.size()) - 1;
+  }
+  return static_cast<int>(it - fields.begin());
+}
+
+} // namespace
+
+void DiagnosticSet::add(const std::string &name, const Field3D &f, Op op, REGION rgn) {
+  for (const Entry &e : entries) {
+    if (e.name == name) {
+      throw BoutException("DiagnosticSet: diagnostic '%s' already declared",
+                          name.c_str());
+    }
+  }
+  entries.push_back({name, &f, nullptr, op, rgn, 0.0});
+}
+
+void DiagnosticSet::add(const std::string &name, const Field2D &f, Op op, REGION rgn) {
+  for (const Entry &e : entries) {
+    if (e.name == name) {
+      throw BoutException("DiagnosticSet: diagnostic '%s' already declared",
+                          name.c_str());
+    }
+  }
+  entries.push_back({name, nullptr, &f, op, rgn, 0.0});
+}
+
+void DiagnosticSet::outputVars(Datafile &file) {
+  for (Entry &e : entries) {
+    file.add(e.value, e.name.c_str(), true);
+  }
+}
+
+void DiagnosticSet::evaluate() {
+  TRACE("DiagnosticSet::evaluate()");
+
+  if (entries.empty()) {
+    return;
+  }
+
+  // Group the declarations by region and dimensionality, so each
+  // region is traversed once with every field reduced during the same
+  // sweep. For each entry, remember which group and which field within
+  // it supplies the result
+  std::map<int, std::vector<const Field3D *>> fields3d;
+  std::map<int, std::vector<const Field2D *>> fields2d;
+  std::vector<std::pair<int, int>> lookup; // (region, field index) per entry
+
+  lookup.reserve(entries.size());
+  for (const Entry &e : entries) {
+    const int rgn = static_cast<int>(e.rgn);
+    if (e.f3 != nullptr) {
+      lookup.emplace_back(rgn, fieldIndex(fields3d[rgn], e.f3));
+    } else {
+      lookup.emplace_back(rgn, fieldIndex(fields2d[rgn], e.f2));
+    }
+  }
+
+  // One fused local sweep per group, batched into a single MPI
+  // resolution. std::map iterates in key order, so all processors
+  // traverse the groups (and so pack the collective buffers)
+  // identically
+  std::vector<FieldReduction> batch;
+  std::map<int, int> start3d, start2d; // Offset of each group in the batch
+
+  for (const auto &group : fields3d) {
+    start3d[group.first] = static_cast<int>(batch.size());
+    auto local = reduceLocal(group.second, static_cast<REGION>(group.first));
+    batch.insert(batch.end(), local.begin(), local.end());
+  }
+  for (const auto &group : fields2d) {
+    start2d[group.first] = static_cast<int>(batch.size());
+    auto local = reduceLocal(group.second, static_cast<REGION>(group.first));
+    batch.insert(batch.end(), local.begin(), local.end());
+  }
+
+  resolveReductions(batch);
+
+  for (std::size_t i = 0; i < entries.size(); i++) {
+    Entry &e = entries[i];
+    const int start = (e.f3 != nullptr) ? start3d[lookup[i].first]
+                                        : start2d[lookup[i].first];
+    e.value = applyOp(batch[start + lookup[i].second], e.op);
+  }
+}
+
+BoutReal DiagnosticSet::get(const std::string &name) const {
+  for (const Entry &e : entries) {
+    if (e.name == name) {
+      return e.value;
+    }
+  }
+  throw BoutException("DiagnosticSet: no diagnostic named '%s'", name.c_str());
+}
+
+int DiagnosticSet::call(Solver *UNUSED(solver), BoutReal UNUSED(time), int UNUSED(iter),
+                        int UNUSED(nout)) {
+  evaluate();
+  return 0;
+}
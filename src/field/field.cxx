@@ -34,6 +34,11 @@
 #include <utils.hxx>
 #include <bout/mesh.hxx>
 
+// Runtime switches for the non-finite scans in checkData(), set from
+// the root options in BoutInitialise
+bool check_data_enable_finite = false;
+int check_data_sample_stride = 1;
+
 Field::Field() : fieldmesh(nullptr), fieldCoordinates(nullptr) {
 #if CHECK > 0
   bndry_xin = bndry_xout = bndry_yup = bndry_ydown = true;
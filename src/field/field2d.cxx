@@ -429,7 +429,7 @@ BoutReal min(const Field2D &f, bool allpe, REGION rgn) {
   if(allpe) {
     // MPI reduce
     BoutReal localresult = result;
-    MPI_Allreduce(&localresult, &result, 1, MPI_DOUBLE, MPI_MIN, BoutComm::get());
+    MPI_Allreduce(&localresult, &result, 1, BOUT_MPI_REAL, MPI_MIN, BoutComm::get());
   }
 
   return result;
@@ -453,7 +453,7 @@ BoutReal max(const Field2D &f, bool allpe,REGION rgn) {
   if(allpe) {
     // MPI reduce
     BoutReal localresult = result;
-    MPI_Allreduce(&localresult, &result, 1, MPI_DOUBLE, MPI_MAX, BoutComm::get());
+    MPI_Allreduce(&localresult, &result, 1, BOUT_MPI_REAL, MPI_MAX, BoutComm::get());
   }
 
   return result;
@@ -625,7 +625,13 @@ namespace {
 void checkDataIsFiniteOnRegion(const Field2D &f, REGION region) {
   const Region<Ind2D> &new_region = f.getMesh()->getRegion2D(REGION_STRING(region));
 
-  // Do full checks
+  // Cheap branch-free reduction first (optionally thinned by
+  // sampling); the per-point throw logic below only runs once
+  // something is known to be wrong
+  if (isFiniteOnRegion(f, new_region, check_data_sample_stride)) {
+    return;
+  }
+
   BOUT_FOR_SERIAL(i, new_region) {
     if (!::finite(f[i])) {
       throw BoutException("Field2D: Operation on non-finite data at [%d][%d]\n", i.x(),
@@ -634,8 +640,18 @@ void checkDataIsFiniteOnRegion(const Field2D &f, REGION region) {
   }
 }
 #elif CHECK > 0
-// No-op for no checking
-void checkDataIsFiniteOnRegion(const Field2D &UNUSED(f), REGION UNUSED(region)) {}
+// The per-point checks are compiled out at this level, but the cheap
+// reduction can be switched on at runtime for triage
+void checkDataIsFiniteOnRegion(const Field2D &f, REGION region) {
+  if (!check_data_enable_finite) {
+    return;
+  }
+  if (!isFiniteOnRegion(f, f.getMesh()->getRegion2D(REGION_STRING(region)),
+                        check_data_sample_stride)) {
+    throw BoutException("Field2D: Operation on non-finite data in %s\n",
+                        REGION_STRING(region).c_str());
+  }
+}
 #endif
 }
 
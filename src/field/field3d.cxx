@@ -28,6 +28,7 @@
 #include <boutcomm.hxx>
 #include <globals.hxx>
 
+#include <algorithm>
 #include <cmath>
 
 #include <field3d.hxx>
@@ -41,7 +42,11 @@
 #include <output.hxx>
 #include <msg_stack.hxx>
 #include <bout/constants.hxx>
+#include <options.hxx>
 #include <bout/assert.hxx>
+#include <bout/offload.hxx>
+#include <bout/vecmath.hxx>
+#include <bout/stencil_view.hxx>
 
 /// Constructor
 Field3D::Field3D(Mesh *localmesh)
@@ -155,6 +160,10 @@ Field3D::~Field3D() {
 }
 
 void Field3D::allocate() {
+  // The caller may be about to write to the data, so the parallel
+  // slices can no longer be assumed to match it
+  generation++;
+
   if(data.empty()) {
     if(!fieldmesh) {
       /// If no mesh, use the global
@@ -276,6 +285,36 @@ const BoutReal &Field3D::operator()(const Ind2D &d, int jz) const {
   return operator[](fieldmesh->ind2Dto3D(d, jz));
 }
 
+#if CHECK > 1
+namespace {
+/// Check once that a region's blocks lie within a field of n points
+void checkRegionFits(const Region<Ind3D> &region, int n) {
+  for (const auto &block : region.getBlocks()) {
+    if ((block.first.ind < 0) || (block.second.ind > n))
+      throw BoutException("Field3D::view: region block [%d,%d) outside field of "
+                          "size %d",
+                          block.first.ind, block.second.ind, n);
+  }
+}
+} // namespace
+#endif
+
+StencilView Field3D::view(const Region<Ind3D> &region) {
+  ASSERT1(isAllocated());
+#if CHECK > 1
+  checkRegionFits(region, nx * ny * nz);
+#endif
+  return StencilView(*this);
+}
+
+ConstStencilView Field3D::view(const Region<Ind3D> &region) const {
+  ASSERT1(isAllocated());
+#if CHECK > 1
+  checkRegionFits(region, nx * ny * nz);
+#endif
+  return ConstStencilView(*this);
+}
+
 /***************************************************************
  *                         OPERATORS 
  ***************************************************************/
@@ -364,6 +403,26 @@ const Region<Ind3D> &Field3D::getRegion(const std::string &region_name) const {
 
 /////////////////// ASSIGNMENT ////////////////////
 
+void swap(Field3D &first, Field3D &second) {
+  using std::swap;
+
+  // The value swaps: data block and the metadata describing it
+  swap(first.data, second.data);
+  swap(first.fieldmesh, second.fieldmesh);
+  swap(first.nx, second.nx);
+  swap(first.ny, second.ny);
+  swap(first.nz, second.nz);
+  swap(first.location, second.location);
+  swap(first.fieldCoordinates, second.fieldCoordinates);
+  swap(first.background, second.background);
+
+  // Each variable keeps its identity: the time derivative, parallel
+  // slice fields and boundary conditions stay with their field. The
+  // slices no longer match the swapped data
+  first.generation++;
+  second.generation++;
+}
+
 Field3D & Field3D::operator=(const Field3D &rhs) {
   /// Check for self-assignment
   if(this == &rhs)
@@ -380,6 +439,9 @@ Field3D & Field3D::operator=(const Field3D &rhs) {
   
   data = rhs.data;
 
+  // The data has been replaced, so any parallel slices are stale
+  generation++;
+
   setLocation(rhs.location);
 
   return *this;
@@ -416,11 +478,13 @@ void Field3D::operator=(const FieldPerp &rhs) {
   /// Make sure there's a unique array to copy data into
   allocate();
 
-  /// Copy data
-  const Region<IndPerp> &region_all = fieldmesh->getRegionPerp("RGN_ALL");
-
-  BOUT_FOR(i, region_all) {
-    (*this)(i, rhs.getIndex()) = rhs[i];
+  /// Copy data: each (x, y) pencil is contiguous in z, so the slab
+  /// goes in as one straight copy per x index
+  const int y = rhs.getIndex();
+  const int nz = fieldmesh->LocalNz;
+  for (int jx = 0; jx < fieldmesh->LocalNx; jx++) {
+    const BoutReal *src = rhs[jx];
+    std::copy(src, src + nz, &(*this)(jx, y, 0));
   }
 }
 
@@ -734,6 +798,124 @@ Field3D operator-(const Field3D &f) { return -1.0 * f; }
 
 //////////////// NON-MEMBER FUNCTIONS //////////////////
 
+// Region-restricted arithmetic. These only calculate the cells in the
+// named region; cells outside it are left unset, so the result must not
+// be read outside the region (and is deliberately not checked here).
+
+namespace {
+template <typename Op>
+Field3D binary3D3D(const Field3D &lhs, const Field3D &rhs, const std::string &rgn,
+                   Op op) {
+  ASSERT1(lhs.getLocation() == rhs.getLocation());
+  ASSERT1(lhs.getMesh() == rhs.getMesh());
+
+  Field3D result(lhs.getMesh());
+  result.allocate();
+
+  BOUT_FOR(i, lhs.getMesh()->getRegion3D(rgn)) {
+    result[i] = op(lhs[i], rhs[i]);
+  }
+
+  result.setLocation(lhs.getLocation());
+  return result;
+}
+
+template <typename Op>
+Field3D binary3D2D(const Field3D &lhs, const Field2D &rhs, const std::string &rgn,
+                   Op op) {
+  ASSERT1(lhs.getMesh() == rhs.getMesh());
+
+  Mesh *localmesh = lhs.getMesh();
+  Field3D result(localmesh);
+  result.allocate();
+
+  BOUT_FOR(i, localmesh->getRegion3D(rgn)) {
+    result[i] = op(lhs[i], rhs[localmesh->ind3Dto2D(i)]);
+  }
+
+  result.setLocation(lhs.getLocation());
+  return result;
+}
+
+template <typename Op>
+Field3D binary3DReal(const Field3D &lhs, BoutReal rhs, const std::string &rgn,
+                     Op op) {
+  Field3D result(lhs.getMesh());
+  result.allocate();
+
+  BOUT_FOR(i, lhs.getMesh()->getRegion3D(rgn)) {
+    result[i] = op(lhs[i], rhs);
+  }
+
+  result.setLocation(lhs.getLocation());
+  return result;
+}
+} // namespace
+
+Field3D add(const Field3D &lhs, const Field3D &rhs, const std::string &rgn) {
+  return binary3D3D(lhs, rhs, rgn, [](BoutReal a, BoutReal b) { return a + b; });
+}
+
+Field3D sub(const Field3D &lhs, const Field3D &rhs, const std::string &rgn) {
+  return binary3D3D(lhs, rhs, rgn, [](BoutReal a, BoutReal b) { return a - b; });
+}
+
+Field3D mul(const Field3D &lhs, const Field3D &rhs, const std::string &rgn) {
+  return binary3D3D(lhs, rhs, rgn, [](BoutReal a, BoutReal b) { return a * b; });
+}
+
+Field3D div(const Field3D &lhs, const Field3D &rhs, const std::string &rgn) {
+  return binary3D3D(lhs, rhs, rgn, [](BoutReal a, BoutReal b) { return a / b; });
+}
+
+Field3D add(const Field3D &lhs, const Field2D &rhs, const std::string &rgn) {
+  return binary3D2D(lhs, rhs, rgn, [](BoutReal a, BoutReal b) { return a + b; });
+}
+
+Field3D sub(const Field3D &lhs, const Field2D &rhs, const std::string &rgn) {
+  return binary3D2D(lhs, rhs, rgn, [](BoutReal a, BoutReal b) { return a - b; });
+}
+
+Field3D mul(const Field3D &lhs, const Field2D &rhs, const std::string &rgn) {
+  return binary3D2D(lhs, rhs, rgn, [](BoutReal a, BoutReal b) { return a * b; });
+}
+
+Field3D div(const Field3D &lhs, const Field2D &rhs, const std::string &rgn) {
+  return binary3D2D(lhs, rhs, rgn, [](BoutReal a, BoutReal b) { return a / b; });
+}
+
+Field3D add(const Field3D &lhs, BoutReal rhs, const std::string &rgn) {
+  return binary3DReal(lhs, rhs, rgn, [](BoutReal a, BoutReal b) { return a + b; });
+}
+
+Field3D sub(const Field3D &lhs, BoutReal rhs, const std::string &rgn) {
+  return binary3DReal(lhs, rhs, rgn, [](BoutReal a, BoutReal b) { return a - b; });
+}
+
+Field3D mul(const Field3D &lhs, BoutReal rhs, const std::string &rgn) {
+  return binary3DReal(lhs, rhs, rgn, [](BoutReal a, BoutReal b) { return a * b; });
+}
+
+Field3D div(const Field3D &lhs, BoutReal rhs, const std::string &rgn) {
+  return binary3DReal(lhs, rhs, rgn, [](BoutReal a, BoutReal b) { return a / b; });
+}
+
+Field3D add(BoutReal lhs, const Field3D &rhs, const std::string &rgn) {
+  return binary3DReal(rhs, lhs, rgn, [](BoutReal a, BoutReal b) { return b + a; });
+}
+
+Field3D sub(BoutReal lhs, const Field3D &rhs, const std::string &rgn) {
+  return binary3DReal(rhs, lhs, rgn, [](BoutReal a, BoutReal b) { return b - a; });
+}
+
+Field3D mul(BoutReal lhs, const Field3D &rhs, const std::string &rgn) {
+  return binary3DReal(rhs, lhs, rgn, [](BoutReal a, BoutReal b) { return b * a; });
+}
+
+Field3D div(BoutReal lhs, const Field3D &rhs, const std::string &rgn) {
+  return binary3DReal(rhs, lhs, rgn, [](BoutReal a, BoutReal b) { return b / a; });
+}
+
 Field3D pow(const Field3D &lhs, const Field3D &rhs, REGION rgn) {
   TRACE("pow(Field3D, Field3D)");
 
@@ -862,7 +1044,7 @@ BoutReal min(const Field3D &f, bool allpe, REGION rgn) {
   if(allpe) {
     // MPI reduce
     BoutReal localresult = result;
-    MPI_Allreduce(&localresult, &result, 1, MPI_DOUBLE, MPI_MIN, BoutComm::get());
+    MPI_Allreduce(&localresult, &result, 1, BOUT_MPI_REAL, MPI_MIN, BoutComm::get());
   }
 
   return result;
@@ -886,7 +1068,7 @@ BoutReal max(const Field3D &f, bool allpe, REGION rgn) {
   if(allpe) {
     // MPI reduce
     BoutReal localresult = result;
-    MPI_Allreduce(&localresult, &result, 1, MPI_DOUBLE, MPI_MAX, BoutComm::get());
+    MPI_Allreduce(&localresult, &result, 1, BOUT_MPI_REAL, MPI_MAX, BoutComm::get());
   }
   
   return result;
@@ -898,7 +1080,9 @@ BoutReal mean(const Field3D &f, bool allpe, REGION rgn) {
   checkData(f);
 
   // Intitialise the cummulative sum and counter
-  BoutReal result = 0.;
+  // Accumulate in double so the sum stays accurate when fields are
+  // stored in single precision
+  double result = 0.;
   int count = 0;
 
   const Region<Ind3D> &region = f.getMesh()->getRegion3D(REGION_STRING(rgn));
@@ -910,7 +1094,7 @@ BoutReal mean(const Field3D &f, bool allpe, REGION rgn) {
 
   if(allpe) {
     // MPI reduce
-    BoutReal localresult = result;
+    double localresult = result;
     MPI_Allreduce(&localresult, &result, 1, MPI_DOUBLE, MPI_SUM, BoutComm::get());
     int localcount = count;
     MPI_Allreduce(&localcount, &count, 1, MPI_INT, MPI_SUM, BoutComm::get());
@@ -946,9 +1130,87 @@ BoutReal mean(const Field3D &f, bool allpe, REGION rgn) {
     /* Define and allocate the output result */                                          \
     Field3D result(f.getMesh());                                                         \
     result.allocate();                                                                   \
+    /* Device path when built with BOUT_USE_OPENMP_OFFLOAD, else false */                \
+    if (!bout::offloadPointwise(result, f, rgn, [](BoutReal x) { return func(x); })) {   \
+      const Region<Ind3D> &region = f.getMesh()->getRegion3D(REGION_STRING(rgn));        \
+      /* Block loop with a simd inner span, so compilers with a vector                   \
+       * libm can vectorise the transcendental call */                                   \
+      BOUT_FOR_BLOCK(block, region) {                                                    \
+        const int iend = block->second.ind;                                              \
+        BOUT_SIMD                                                                        \
+        for (int i = block->first.ind; i < iend; ++i) {                                  \
+          result[Ind3D(i)] = func(f[Ind3D(i)]);                                          \
+        }                                                                                \
+      }                                                                                  \
+    }                                                                                    \
+    result.setLocation(f.getLocation());                                                 \
+    checkData(result);                                                                   \
+    return result;                                                                       \
+  }
+
+namespace {
+/// True if exp() and log() over fields use the vectorised polynomial
+/// kernels from bout/vecmath.hxx by default, read from the "fast"
+/// option in the [vecmath] section (default false) on first use
+bool vecmathFast() {
+  static bool initialised = false;
+  static bool fast = false;
+  if (!initialised) {
+    Options::getRoot()->getSection("vecmath")->get("fast", fast, false);
+    initialised = true;
+  }
+  return fast;
+}
+} // namespace
+
+/*!
+ * As F3D_FUNC, for functions with a vectorised polynomial kernel: the
+ * fast kernel is taken when the "fast" option in the [vecmath]
+ * section is set, and unconditionally by the fast_<name> variant. See
+ * bout/vecmath.hxx for the precision trade-off
+ */
+#define F3D_FUNC_VEC(name, func, fastfunc)                                               \
+  const Field3D name(const Field3D &f, REGION rgn) {                                     \
+    TRACE(#name "(Field3D)");                                                            \
+    checkData(f);                                                                        \
+    Field3D result(f.getMesh());                                                         \
+    result.allocate();                                                                   \
+    if (!bout::offloadPointwise(result, f, rgn, [](BoutReal x) { return func(x); })) {   \
+      const Region<Ind3D> &region = f.getMesh()->getRegion3D(REGION_STRING(rgn));        \
+      if (vecmathFast()) {                                                               \
+        BOUT_FOR_BLOCK(block, region) {                                                  \
+          const int iend = block->second.ind;                                            \
+          BOUT_SIMD                                                                      \
+          for (int i = block->first.ind; i < iend; ++i) {                                \
+            result[Ind3D(i)] = fastfunc(f[Ind3D(i)]);                                    \
+          }                                                                              \
+        }                                                                                \
+      } else {                                                                           \
+        BOUT_FOR_BLOCK(block, region) {                                                  \
+          const int iend = block->second.ind;                                            \
+          BOUT_SIMD                                                                      \
+          for (int i = block->first.ind; i < iend; ++i) {                                \
+            result[Ind3D(i)] = func(f[Ind3D(i)]);                                        \
+          }                                                                              \
+        }                                                                                \
+      }                                                                                  \
+    }                                                                                    \
+    result.setLocation(f.getLocation());                                                 \
+    checkData(result);                                                                   \
+    return result;                                                                       \
+  }                                                                                      \
+  const Field3D fast_##name(const Field3D &f, REGION rgn) {                              \
+    TRACE("fast_" #name "(Field3D)");                                                    \
+    checkData(f);                                                                        \
+    Field3D result(f.getMesh());                                                         \
+    result.allocate();                                                                   \
     const Region<Ind3D> &region = f.getMesh()->getRegion3D(REGION_STRING(rgn));          \
-    BOUT_FOR (d, region) {                                                               \
-      result[d] = func(f[d]);                                                            \
+    BOUT_FOR_BLOCK(block, region) {                                                      \
+      const int iend = block->second.ind;                                                \
+      BOUT_SIMD                                                                          \
+      for (int i = block->first.ind; i < iend; ++i) {                                    \
+        result[Ind3D(i)] = fastfunc(f[Ind3D(i)]);                                        \
+      }                                                                                  \
     }                                                                                    \
     result.setLocation(f.getLocation());                                                 \
     checkData(result);                                                                   \
@@ -958,8 +1220,8 @@ BoutReal mean(const Field3D &f, bool allpe, REGION rgn) {
 F3D_FUNC(sqrt, ::sqrt);
 F3D_FUNC(abs, ::fabs);
 
-F3D_FUNC(exp, ::exp);
-F3D_FUNC(log, ::log);
+F3D_FUNC_VEC(exp, ::exp, bout::fast_exp);
+F3D_FUNC_VEC(log, ::log, bout::fast_log);
 
 F3D_FUNC(sin, ::sin);
 F3D_FUNC(cos, ::cos);
@@ -969,16 +1231,20 @@ F3D_FUNC(sinh, ::sinh);
 F3D_FUNC(cosh, ::cosh);
 F3D_FUNC(tanh, ::tanh);
 
-const Field3D filter(const Field3D &var, int N0, REGION rgn) {
+const Field3D filter(Field3D &&var, int N0, REGION rgn) {
   TRACE("filter(Field3D, int)");
-  
+
   checkData(var);
 
   Mesh *localmesh = var.getMesh();
 
   int ncz = localmesh->LocalNz;
 
-  Field3D result(localmesh);
+  // Filter in place: each pencil is read into the Fourier buffer
+  // before being overwritten, and allocate() ensures the storage is
+  // not shared. If var held the only reference to its data this
+  // reuses the storage without any allocation
+  Field3D result = std::move(var);
   result.allocate();
 
   const auto region_str = REGION_STRING(rgn);
@@ -989,38 +1255,64 @@ const Field3D filter(const Field3D &var, int N0, REGION rgn) {
 
   const Region<Ind2D> &region = localmesh->getRegion2D(region_str);
 
-  BOUT_OMP(parallel)
-  {
-    Array<dcomplex> f(ncz / 2 + 1);
+  if (region_str == "RGN_ALL") {
+    // All pencils are contiguous, so transform the whole field in two
+    // batched FFT calls rather than one pair of calls per pencil
+    const int nmodes = ncz / 2 + 1;
+    const int npencils = localmesh->LocalNx * localmesh->LocalNy;
+    Array<dcomplex> f(npencils * nmodes);
 
-    BOUT_FOR_INNER(i, region) {
-      // Forward FFT
-      rfft(var(i.x(), i.y()), ncz, f.begin());
+    rfft_many(result(0, 0), ncz, npencils, f.begin());
 
-      for (int jz = 0; jz <= ncz / 2; jz++) {
+    BOUT_OMP(parallel for)
+    for (int p = 0; p < npencils; p++) {
+      for (int jz = 0; jz < nmodes; jz++) {
         if (jz != N0) {
           // Zero this component
-          f[jz] = 0.0;
+          f[p * nmodes + jz] = 0.0;
         }
       }
+    }
 
-      // Reverse FFT
-      irfft(f.begin(), ncz, result(i.x(), i.y()));
+    irfft_many(f.begin(), ncz, npencils, result(0, 0));
+  } else {
+    BOUT_OMP(parallel)
+    {
+      Array<dcomplex> f(ncz / 2 + 1);
+
+      BOUT_FOR_INNER(i, region) {
+        // Forward FFT
+        rfft(result(i.x(), i.y()), ncz, f.begin());
+
+        for (int jz = 0; jz <= ncz / 2; jz++) {
+          if (jz != N0) {
+            // Zero this component
+            f[jz] = 0.0;
+          }
+        }
+
+        // Reverse FFT
+        irfft(f.begin(), ncz, result(i.x(), i.y()));
+      }
     }
   }
 
 #ifdef TRACK
-  result.name = "filter(" + var.name + ")";
+  result.name = "filter(" + result.name + ")";
 #endif
 
-  result.setLocation(var.getLocation());
-
   checkData(result);
   return result;
 }
 
+const Field3D filter(const Field3D &var, int N0, REGION rgn) {
+  // The copy is shallow; the in-place overload detaches it from var's
+  // data when it allocates
+  return filter(Field3D(var), N0, rgn);
+}
+
 // Fourier filter in z
-const Field3D lowPass(const Field3D &var, int zmax, REGION rgn) {
+const Field3D lowPass(Field3D &&var, int zmax, REGION rgn) {
   TRACE("lowPass(Field3D, %d)", zmax);
 
   checkData(var);
@@ -1030,10 +1322,12 @@ const Field3D lowPass(const Field3D &var, int zmax, REGION rgn) {
 
   if ((zmax >= ncz / 2) || (zmax < 0)) {
     // Removing nothing
-    return var;
+    return std::move(var);
   }
 
-  Field3D result(localmesh);
+  // Filter in place, reusing var's storage if it held the only
+  // reference to its data (see filter above)
+  Field3D result = std::move(var);
   result.allocate();
 
   const auto region_str = REGION_STRING(rgn);
@@ -1044,30 +1338,53 @@ const Field3D lowPass(const Field3D &var, int zmax, REGION rgn) {
 
   const Region<Ind2D> &region = localmesh->getRegion2D(region_str);
 
-  BOUT_OMP(parallel) {
-    Array<dcomplex> f(ncz / 2 + 1);
+  if (region_str == "RGN_ALL") {
+    // All pencils are contiguous, so transform the whole field in two
+    // batched FFT calls rather than one pair of calls per pencil
+    const int nmodes = ncz / 2 + 1;
+    const int npencils = localmesh->LocalNx * localmesh->LocalNy;
+    Array<dcomplex> f(npencils * nmodes);
 
-    BOUT_FOR_INNER(i, region) {
-      // Take FFT in the Z direction
-      rfft(var(i.x(), i.y()), ncz, f.begin());
+    rfft_many(result(0, 0), ncz, npencils, f.begin());
 
+    BOUT_OMP(parallel for)
+    for (int p = 0; p < npencils; p++) {
       // Filter in z
-      for (int jz = zmax + 1; jz <= ncz / 2; jz++) {
-        f[jz] = 0.0;
+      for (int jz = zmax + 1; jz < nmodes; jz++) {
+        f[p * nmodes + jz] = 0.0;
       }
+    }
+
+    irfft_many(f.begin(), ncz, npencils, result(0, 0));
+  } else {
+    BOUT_OMP(parallel) {
+      Array<dcomplex> f(ncz / 2 + 1);
+
+      BOUT_FOR_INNER(i, region) {
+        // Take FFT in the Z direction
+        rfft(result(i.x(), i.y()), ncz, f.begin());
+
+        // Filter in z
+        for (int jz = zmax + 1; jz <= ncz / 2; jz++) {
+          f[jz] = 0.0;
+        }
 
-      // Reverse FFT
-      irfft(f.begin(), ncz, result(i.x(), i.y()));
+        // Reverse FFT
+        irfft(f.begin(), ncz, result(i.x(), i.y()));
+      }
     }
   }
-  result.setLocation(var.getLocation());
 
   checkData(result);
   return result;
 }
 
+const Field3D lowPass(const Field3D &var, int zmax, REGION rgn) {
+  return lowPass(Field3D(var), zmax, rgn);
+}
+
 // Fourier filter in z with zmin
-const Field3D lowPass(const Field3D &var, int zmax, int zmin, REGION rgn) {
+const Field3D lowPass(Field3D &&var, int zmax, int zmin, REGION rgn) {
   TRACE("lowPass(Field3D, %d, %d)", zmax, zmin);
 
   checkData(var);
@@ -1076,10 +1393,12 @@ const Field3D lowPass(const Field3D &var, int zmax, int zmin, REGION rgn) {
 
   if (((zmax >= ncz / 2) || (zmax < 0)) && (zmin < 0)) {
     // Removing nothing
-    return var;
+    return std::move(var);
   }
 
-  Field3D result(localmesh);
+  // Filter in place, reusing var's storage if it held the only
+  // reference to its data (see filter above)
+  Field3D result = std::move(var);
   result.allocate();
 
   const auto region_str = REGION_STRING(rgn);
@@ -1090,32 +1409,58 @@ const Field3D lowPass(const Field3D &var, int zmax, int zmin, REGION rgn) {
 
   const Region<Ind2D> &region = localmesh->getRegion2D(region_str);
 
-  BOUT_OMP(parallel) {
-    Array<dcomplex> f(ncz / 2 + 1);
+  if (region_str == "RGN_ALL") {
+    // All pencils are contiguous, so transform the whole field in two
+    // batched FFT calls rather than one pair of calls per pencil
+    const int nmodes = ncz / 2 + 1;
+    const int npencils = localmesh->LocalNx * localmesh->LocalNy;
+    Array<dcomplex> f(npencils * nmodes);
 
-    BOUT_FOR_INNER(i, region) {
-      // Take FFT in the Z direction
-      rfft(var(i.x(), i.y()), ncz, f.begin());
+    rfft_many(result(0, 0), ncz, npencils, f.begin());
 
+    BOUT_OMP(parallel for)
+    for (int p = 0; p < npencils; p++) {
       // Filter in z
-      for (int jz = zmax + 1; jz <= ncz / 2; jz++)
-        f[jz] = 0.0;
+      for (int jz = zmax + 1; jz < nmodes; jz++)
+        f[p * nmodes + jz] = 0.0;
 
       // Filter zonal mode
       if (zmin == 0) {
-        f[0] = 0.0;
+        f[p * nmodes] = 0.0;
       }
-      // Reverse FFT
-      irfft(f.begin(), ncz, result(i.x(), i.y()));
     }
-  }
 
-  result.setLocation(var.getLocation());
+    irfft_many(f.begin(), ncz, npencils, result(0, 0));
+  } else {
+    BOUT_OMP(parallel) {
+      Array<dcomplex> f(ncz / 2 + 1);
+
+      BOUT_FOR_INNER(i, region) {
+        // Take FFT in the Z direction
+        rfft(result(i.x(), i.y()), ncz, f.begin());
+
+        // Filter in z
+        for (int jz = zmax + 1; jz <= ncz / 2; jz++)
+          f[jz] = 0.0;
+
+        // Filter zonal mode
+        if (zmin == 0) {
+          f[0] = 0.0;
+        }
+        // Reverse FFT
+        irfft(f.begin(), ncz, result(i.x(), i.y()));
+      }
+    }
+  }
 
   checkData(result);
   return result;
 }
 
+const Field3D lowPass(const Field3D &var, int zmax, int zmin, REGION rgn) {
+  return lowPass(Field3D(var), zmax, zmin, rgn);
+}
+
 /* 
  * Use FFT to shift by an angle in the Z direction
  */
@@ -1182,9 +1527,15 @@ namespace {
   // levels and UNUSED parameters
 #if CHECK > 2
 void checkDataIsFiniteOnRegion(const Field3D &f, REGION region) {
-  // Do full checks
   const Region<Ind3D> &new_region = f.getMesh()->getRegion3D(REGION_STRING(region));
 
+  // Cheap branch-free reduction first (optionally thinned by
+  // sampling); the per-point throw logic below only runs once
+  // something is known to be wrong
+  if (isFiniteOnRegion(f, new_region, check_data_sample_stride)) {
+    return;
+  }
+
   BOUT_FOR_SERIAL(i, new_region) {
     if (!finite(f[i])) {
       throw BoutException("Field3D: Operation on non-finite data at [%d][%d][%d]\n",
@@ -1193,8 +1544,18 @@ void checkDataIsFiniteOnRegion(const Field3D &f, REGION region) {
   }
 }
 #elif CHECK > 0
-// No-op for no checking
-void checkDataIsFiniteOnRegion(const Field3D &UNUSED(f), REGION UNUSED(region)) {}
+// The per-point checks are compiled out at this level, but the cheap
+// reduction can be switched on at runtime for triage
+void checkDataIsFiniteOnRegion(const Field3D &f, REGION region) {
+  if (!check_data_enable_finite) {
+    return;
+  }
+  if (!isFiniteOnRegion(f, f.getMesh()->getRegion3D(REGION_STRING(region)),
+                        check_data_sample_stride)) {
+    throw BoutException("Field3D: Operation on non-finite data in %s\n",
+                        REGION_STRING(region).c_str());
+  }
+}
 #endif
 }
 
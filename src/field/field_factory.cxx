@@ -33,6 +33,8 @@
 
 #include "fieldgenerators.hxx"
 
+#include <bout/sys/generatorbytecode.hxx>
+
 /// Helper function to create a FieldValue generator from a BoutReal
 FieldGeneratorPtr generator(BoutReal value) {
   return std::make_shared<FieldValue>(value);
@@ -106,11 +108,11 @@ const Field2D FieldFactory::create2D(const string &value, const Options *opt,
   if(localmesh == nullptr)
     throw BoutException("Not a valid mesh");
 
-  Field2D result(0.,localmesh);
-
   if(localmesh->StaggerGrids == false){
     loc = CELL_CENTRE ;
   }
+
+  Field2D result(0.,localmesh);
   result.setLocation(loc);
 
   FieldGeneratorPtr gen = parse(value, opt);
@@ -121,11 +123,28 @@ const Field2D FieldFactory::create2D(const string &value, const Options *opt,
     return result;
   }
 
+  // Flatten the generator tree into bytecode, so that the loops below
+  // don't make a virtual call per tree node per point
+  GeneratorBytecode code(gen);
+
+  // Check if this field has been generated before. Only
+  // time-independent expressions are cached: keying on the time would
+  // make nearby times collide, and grow the cache by one field per
+  // distinct time for e.g. MMS sources evaluated every RHS call
+  string key;
+  if (code.cacheable()) {
+    key = createKey(value, opt, localmesh, loc);
+    auto cached = cache2D.find(key);
+    if (cached != cache2D.end()) {
+      return cached->second;
+    }
+  }
+
   switch(loc)  {
   case CELL_XLOW: {
     BOUT_FOR(i, localmesh->getRegion2D("RGN_ALL")) {
       BoutReal xpos = 0.5 * (localmesh->GlobalX(i.x() - 1) + localmesh->GlobalX(i.x()));
-      result[i] = gen->generate(xpos, TWOPI * localmesh->GlobalY(i.y()),
+      result[i] = code.run(xpos, TWOPI * localmesh->GlobalY(i.y()),
                                 0.0, // Z
                                 t);  // T
     }
@@ -135,7 +154,7 @@ const Field2D FieldFactory::create2D(const string &value, const Options *opt,
     BOUT_FOR(i, localmesh->getRegion2D("RGN_ALL")) {
       BoutReal ypos =
           TWOPI * 0.5 * (localmesh->GlobalY(i.y() - 1) + localmesh->GlobalY(i.y()));
-      result[i] = gen->generate(localmesh->GlobalX(i.x()), ypos,
+      result[i] = code.run(localmesh->GlobalX(i.x()), ypos,
                                 0.0, // Z
                                 t);  // T
     }
@@ -144,7 +163,7 @@ const Field2D FieldFactory::create2D(const string &value, const Options *opt,
   default: {// CELL_CENTRE or CELL_ZLOW
     BOUT_FOR(i, localmesh->getRegion2D("RGN_ALL")) {
       result[i] =
-          gen->generate(localmesh->GlobalX(i.x()), TWOPI * localmesh->GlobalY(i.y()),
+          code.run(localmesh->GlobalX(i.x()), TWOPI * localmesh->GlobalY(i.y()),
                         0.0, // Z
                         t);  // T
     }
@@ -153,6 +172,11 @@ const Field2D FieldFactory::create2D(const string &value, const Options *opt,
 
   // Don't delete the generator, as will be cached
 
+  // Cache the result. Copy-on-write means this doesn't copy the data
+  if (!key.empty()) {
+    cache2D[key] = result;
+  }
+
   return result;
 }
 
@@ -165,25 +189,42 @@ const Field3D FieldFactory::create3D(const string &value, const Options *opt,
   if(localmesh == nullptr)
     throw BoutException("Not a valid mesh");
 
+  // Parse expression to create a tree of generators
+  FieldGeneratorPtr gen = parse(value, opt);
+  if(!gen) {
+    throw BoutException("FieldFactory error: Couldn't create 3D field from '%s'", value.c_str());
+  }
+
+  // Flatten the generator tree into bytecode, so that the loops below
+  // don't make a virtual call per tree node per point
+  GeneratorBytecode code(gen);
+
+  // Check if this field has been generated before. Only
+  // time-independent expressions are cached: keying on the time would
+  // make nearby times collide, and grow the cache by one field per
+  // distinct time for e.g. MMS sources evaluated every RHS call
+  string key;
+  if (code.cacheable()) {
+    key = createKey(value, opt, localmesh, loc);
+    auto cached = cache3D.find(key);
+    if (cached != cache3D.end()) {
+      return cached->second;
+    }
+  }
+
   // Create a Field3D over mesh "localmesh"
   Field3D result(localmesh);
-  
+
   // Ensure that data is allocated and unique
   result.allocate();
 
   result.setLocation(loc);
 
-  // Parse expression to create a tree of generators
-  FieldGeneratorPtr gen = parse(value, opt);
-  if(!gen) {
-    throw BoutException("FieldFactory error: Couldn't create 3D field from '%s'", value.c_str());
-  }
-
   switch(loc)  {
   case CELL_XLOW: {
     BOUT_FOR(i, localmesh->getRegion3D("RGN_ALL")) {
       BoutReal xpos = 0.5 * (localmesh->GlobalX(i.x() - 1) + localmesh->GlobalX(i.x()));
-      result[i] = gen->generate(xpos, TWOPI * localmesh->GlobalY(i.y()),
+      result[i] = code.run(xpos, TWOPI * localmesh->GlobalY(i.y()),
                                 TWOPI * static_cast<BoutReal>(i.z()) /
                                     static_cast<BoutReal>(localmesh->LocalNz), // Z
                                 t);                                            // T
@@ -194,7 +235,7 @@ const Field3D FieldFactory::create3D(const string &value, const Options *opt,
     BOUT_FOR(i, localmesh->getRegion3D("RGN_ALL")) {
       BoutReal ypos =
           TWOPI * 0.5 * (localmesh->GlobalY(i.y() - 1) + localmesh->GlobalY(i.y()));
-      result[i] = gen->generate(localmesh->GlobalX(i.x()), ypos,
+      result[i] = code.run(localmesh->GlobalX(i.x()), ypos,
                                 TWOPI * static_cast<BoutReal>(i.z()) /
                                     static_cast<BoutReal>(localmesh->LocalNz), // Z
                                 t);                                            // T
@@ -204,7 +245,7 @@ const Field3D FieldFactory::create3D(const string &value, const Options *opt,
   case CELL_ZLOW: {
     BOUT_FOR(i, localmesh->getRegion3D("RGN_ALL")) {
       result[i] =
-          gen->generate(localmesh->GlobalX(i.x()), TWOPI * localmesh->GlobalY(i.y()),
+          code.run(localmesh->GlobalX(i.x()), TWOPI * localmesh->GlobalY(i.y()),
                         TWOPI * (static_cast<BoutReal>(i.z()) - 0.5) /
                             static_cast<BoutReal>(localmesh->LocalNz), // Z
                         t);                                            // T
@@ -214,7 +255,7 @@ const Field3D FieldFactory::create3D(const string &value, const Options *opt,
   default: {// CELL_CENTRE
     BOUT_FOR(i, localmesh->getRegion3D("RGN_ALL")) {
       result[i] =
-          gen->generate(localmesh->GlobalX(i.x()), TWOPI * localmesh->GlobalY(i.y()),
+          code.run(localmesh->GlobalX(i.x()), TWOPI * localmesh->GlobalY(i.y()),
                         TWOPI * static_cast<BoutReal>(i.z()) /
                             static_cast<BoutReal>(localmesh->LocalNz), // Z
                         t);                                            // T
@@ -230,9 +271,25 @@ const Field3D FieldFactory::create3D(const string &value, const Options *opt,
     result = localmesh->fromFieldAligned(result);
   }
 
+  // Cache the result. Copy-on-write means this doesn't copy the data
+  if (!key.empty()) {
+    cache3D[key] = result;
+  }
+
   return result;
 }
 
+std::string FieldFactory::createKey(const string &value, const Options *opt,
+                                    Mesh *localmesh, CELL_LOC loc) const {
+  std::stringstream ss;
+  // The options context is keyed by identity: parse() resolves
+  // variable references through this object, and its name alone would
+  // not distinguish two sections with the same name
+  ss << localmesh << ":" << static_cast<int>(loc) << ":" << opt;
+  ss << "#" << value;
+  return ss.str();
+}
+
 const Options* FieldFactory::findOption(const Options *opt, const string &name, string &val) {
   // Find an Options object which contains the given name
 
@@ -325,6 +382,12 @@ FieldGeneratorPtr FieldFactory::resolve(string &name) {
     // Parse
     FieldGeneratorPtr g = parse(value, section);
 
+    // Intern under a context-qualified key, so expressions referring
+    // to this symbol share one node per (section, name) pair and
+    // GeneratorBytecode can evaluate it once per point. The '$' keeps
+    // symbol keys apart from expression keys
+    g = intern("$" + key, g);
+
     // Cache
     cache[key] = g;
 
@@ -377,4 +440,6 @@ FieldFactory* FieldFactory::get() {
 
 void FieldFactory::cleanCache() {
   cache.clear();
+  cache2D.clear();
+  cache3D.clear();
 }
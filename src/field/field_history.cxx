@@ -0,0 +1,269 @@
+/**************************************************************************
+ * In-memory ring buffer of past Field3D values. See
+ * include/bout/field_history.hxx for a description
+ *
+ **************************************************************************
+ * Copyright 2018 B.D.Dudson
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+#include <bout/field_history.hxx>
+
+#include <bout/assert.hxx>
+#include <bout/mesh.hxx>
+#include <bout/openmpwrap.hxx>
+#include <boutexception.hxx>
+#include <fft.hxx>
+#include <msg_stack.hxx>
+#include <options.hxx>
+
+FieldHistory::FieldHistory(Mesh *mesh, int nsamples, bool single_precision,
+                           int zmodes, BoutReal max_memory_mb)
+    : localmesh(mesh), nsamples(nsamples), single_precision(single_precision),
+      zmodes(zmodes) {
+
+  ASSERT1(localmesh != nullptr);
+
+  if (nsamples < 1) {
+    throw BoutException("FieldHistory needs at least one sample, got %d", nsamples);
+  }
+
+  const int ncz = localmesh->LocalNz;
+  if (ncz == 1) {
+    // No z direction to truncate
+    this->zmodes = 0;
+  }
+  if (this->zmodes > ncz / 2 + 1) {
+    this->zmodes = ncz / 2 + 1; // Keeping everything
+  }
+
+  const size_t npoints = static_cast<size_t>(localmesh->LocalNx)
+                         * localmesh->LocalNy * ncz;
+  const size_t npencil = static_cast<size_t>(localmesh->LocalNx) * localmesh->LocalNy;
+
+  if (this->zmodes > 0) {
+    // Two values (re, im) per retained mode per z pencil
+    sample_bytes = npencil * this->zmodes * 2
+                   * (single_precision ? sizeof(float) : sizeof(BoutReal));
+  } else {
+    sample_bytes = npoints * (single_precision ? sizeof(float) : sizeof(BoutReal));
+  }
+
+  if (max_memory_mb > 0.0) {
+    const BoutReal total_mb = BoutReal(nsamples) * BoutReal(sample_bytes) / (1024. * 1024.);
+    if (total_mb > max_memory_mb) {
+      throw BoutException("FieldHistory: %d samples would use %.1f MB, over the "
+                          "%.1f MB budget. Reduce nsamples or increase the "
+                          "compression (single_precision, zmodes)",
+                          nsamples, total_mb, max_memory_mb);
+    }
+  }
+
+  ring.resize(nsamples);
+}
+
+namespace {
+/// Fetch an option value for passing to the delegated constructor
+template <typename T>
+T getOpt(Options *opt, const char *name, T def) {
+  T value;
+  opt->get(name, value, def);
+  return value;
+}
+} // namespace
+
+FieldHistory::FieldHistory(Mesh *mesh, Options *opt)
+    : FieldHistory(mesh, getOpt(opt, "nsamples", 16),
+                   getOpt(opt, "single_precision", true), getOpt(opt, "zmodes", 0),
+                   getOpt(opt, "max_memory_mb", 0.0)) {}
+
+void FieldHistory::record(const Field3D &f, BoutReal time) {
+  TRACE("FieldHistory::record");
+
+  ASSERT1(f.getMesh() == localmesh);
+  ASSERT1(f.isAllocated());
+  // Times must be increasing for the interpolation in get()
+  ASSERT1((count == 0)
+          || (time > ring[(head + nsamples - 1) % nsamples].time));
+
+  Sample &s = ring[head];
+  s.time = time;
+  s.location = f.getLocation();
+  compress(f, s);
+
+  head = (head + 1) % nsamples;
+  if (count < nsamples) {
+    count++;
+  }
+}
+
+BoutReal FieldHistory::maxDelay() const {
+  if (count < 2) {
+    return 0.0;
+  }
+  const BoutReal newest = ring[(head + nsamples - 1) % nsamples].time;
+  const BoutReal oldest = ring[(head + nsamples - count) % nsamples].time;
+  return newest - oldest;
+}
+
+const Field3D FieldHistory::get(BoutReal delay) const {
+  TRACE("FieldHistory::get");
+
+  if (count == 0) {
+    throw BoutException("FieldHistory::get called with no samples recorded");
+  }
+
+  const int newest = (head + nsamples - 1) % nsamples;
+
+  if ((delay <= 0.0) || (count == 1)) {
+    return decompress(ring[newest]);
+  }
+
+  const BoutReal target = ring[newest].time - delay;
+
+  // Walk back from the newest sample to find the bracketing pair
+  int upper = newest;
+  for (int n = 1; n < count; n++) {
+    const int lower = (head + nsamples - 1 - n) % nsamples;
+    if (ring[lower].time <= target) {
+      const BoutReal t0 = ring[lower].time;
+      const BoutReal t1 = ring[upper].time;
+      const BoutReal w = (target - t0) / (t1 - t0);
+
+      if (w <= 0.0) {
+        return decompress(ring[lower]);
+      }
+
+      Field3D a = decompress(ring[lower]);
+      Field3D b = decompress(ring[upper]);
+      return (1. - w) * a + w * b;
+    }
+    upper = lower;
+  }
+
+  throw BoutException("FieldHistory: delay %e reaches beyond the oldest stored "
+                      "sample (max delay %e)", delay, maxDelay());
+}
+
+void FieldHistory::compress(const Field3D &f, Sample &s) {
+  const int ncz = localmesh->LocalNz;
+  const int npencil = localmesh->LocalNx * localmesh->LocalNy;
+  const BoutReal *fd = &f(0, 0, 0);
+
+  if (zmodes > 0) {
+    // Keep the lowest zmodes Fourier coefficients of each z pencil
+    if (single_precision) {
+      if (s.spec_f.size() != npencil * zmodes * 2) {
+        s.spec_f = Array<float>(npencil * zmodes * 2);
+      }
+    } else {
+      if (s.spec_d.size() != npencil * zmodes) {
+        s.spec_d = Array<dcomplex>(npencil * zmodes);
+      }
+    }
+
+    BOUT_OMP(parallel)
+    {
+      Array<dcomplex> cv(ncz / 2 + 1);
+      BOUT_OMP(for)
+      for (int p = 0; p < npencil; p++) {
+        rfft(&fd[p * ncz], ncz, cv.begin());
+        if (single_precision) {
+          for (int k = 0; k < zmodes; k++) {
+            s.spec_f[(p * zmodes + k) * 2] = static_cast<float>(cv[k].real());
+            s.spec_f[(p * zmodes + k) * 2 + 1] = static_cast<float>(cv[k].imag());
+          }
+        } else {
+          for (int k = 0; k < zmodes; k++) {
+            s.spec_d[p * zmodes + k] = cv[k];
+          }
+        }
+      }
+    }
+    return;
+  }
+
+  // Full values
+  const int n = npencil * ncz;
+  if (single_precision) {
+    if (s.raw_f.size() != n) {
+      s.raw_f = Array<float>(n);
+    }
+    BOUT_OMP(parallel for)
+    for (int i = 0; i < n; i++) {
+      s.raw_f[i] = static_cast<float>(fd[i]);
+    }
+  } else {
+    if (s.raw_d.size() != n) {
+      s.raw_d = Array<BoutReal>(n);
+    }
+    BOUT_OMP(parallel for)
+    for (int i = 0; i < n; i++) {
+      s.raw_d[i] = fd[i];
+    }
+  }
+}
+
+const Field3D FieldHistory::decompress(const Sample &s) const {
+  const int ncz = localmesh->LocalNz;
+  const int npencil = localmesh->LocalNx * localmesh->LocalNy;
+
+  Field3D result(localmesh);
+  result.allocate();
+  result.setLocation(s.location);
+  BoutReal *rd = &result(0, 0, 0);
+
+  if (zmodes > 0) {
+    BOUT_OMP(parallel)
+    {
+      Array<dcomplex> cv(ncz / 2 + 1);
+      BOUT_OMP(for)
+      for (int p = 0; p < npencil; p++) {
+        for (int k = 0; k < zmodes; k++) {
+          if (single_precision) {
+            cv[k] = dcomplex(s.spec_f[(p * zmodes + k) * 2],
+                             s.spec_f[(p * zmodes + k) * 2 + 1]);
+          } else {
+            cv[k] = s.spec_d[p * zmodes + k];
+          }
+        }
+        for (int k = zmodes; k <= ncz / 2; k++) {
+          cv[k] = 0.0; // Truncated modes
+        }
+        irfft(cv.begin(), ncz, &rd[p * ncz]);
+      }
+    }
+    return result;
+  }
+
+  const int n = npencil * ncz;
+  if (single_precision) {
+    BOUT_OMP(parallel for)
+    for (int i = 0; i < n; i++) {
+      rd[i] = s.raw_f[i];
+    }
+  } else {
+    BOUT_OMP(parallel for)
+    for (int i = 0; i < n; i++) {
+      rd[i] = s.raw_d[i];
+    }
+  }
+  return result;
+}
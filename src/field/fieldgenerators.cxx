@@ -139,6 +139,15 @@ BoutReal FieldHeaviside::generate(double x, double y, double z, double t) {
   return (gen->generate(x, y, z, t) > 0.0) ? 1.0 : 0.0;
 }
 
+namespace {
+  BoutReal heaviside(BoutReal x) { return (x > 0.0) ? 1.0 : 0.0; }
+}
+
+void FieldHeaviside::compile(GeneratorBytecode &code) {
+  code.add(gen);
+  code.emitFunc1(heaviside);
+}
+
 FieldGeneratorPtr FieldErf::clone(const list<FieldGeneratorPtr> args) {
   if (args.size() != 1) {
     throw ParseException(
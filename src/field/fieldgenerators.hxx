@@ -9,6 +9,7 @@
 
 #include <field_factory.hxx>
 #include <boutexception.hxx>
+#include <bout/sys/generatorbytecode.hxx>
 #include <unused.hxx>
 
 #include <cmath>
@@ -25,6 +26,7 @@ public:
   FieldValuePtr(BoutReal *val) : ptr(val) {}
   FieldGeneratorPtr clone(const list<FieldGeneratorPtr > UNUSED(args)) { return std::make_shared<FieldValuePtr>(ptr); }
   BoutReal generate(double UNUSED(x), double UNUSED(y), double UNUSED(z), double UNUSED(t)) { return *ptr; }
+  void compile(GeneratorBytecode &code) { code.emitPointer(ptr); }
 private:
   BoutReal *ptr; 
 };
@@ -39,6 +41,7 @@ public:
 
   FieldGeneratorPtr clone(const list<FieldGeneratorPtr > args);
   BoutReal generate(double x, double y, double z, double t);
+  void compile(GeneratorBytecode &code) { code.add(gen); code.emitFunc1(sin); }
   const std::string str() {return std::string("sin(")+gen->str()+std::string(")");}
 private:
   FieldGeneratorPtr gen;
@@ -51,6 +54,7 @@ public:
 
   FieldGeneratorPtr clone(const list<FieldGeneratorPtr > args);
   BoutReal generate(double x, double y, double z, double t);
+  void compile(GeneratorBytecode &code) { code.add(gen); code.emitFunc1(cos); }
 
   const std::string str() {return std::string("cos(")+gen->str()+std::string(")");}
 private:
@@ -74,6 +78,7 @@ public:
   BoutReal generate(double x, double y, double z, double t) {
     return Op(gen->generate(x,y,z,t));
   }
+  void compile(GeneratorBytecode &code) { code.add(gen); code.emitFunc1(Op); }
   const std::string str() {return std::string("func(")+gen->str()+std::string(")");}
 private:
   FieldGeneratorPtr gen;
@@ -96,6 +101,11 @@ public:
   BoutReal generate(double x, double y, double z, double t) {
     return Op(A->generate(x,y,z,t), B->generate(x,y,z,t));
   }
+  void compile(GeneratorBytecode &code) {
+    code.add(A);
+    code.add(B);
+    code.emitFunc2(Op);
+  }
   const std::string str() {
     return std::string("cos(") + A->str() + "," + B->str() + std::string(")");
   }
@@ -123,6 +133,15 @@ public:
       return atan(A->generate(x,y,z,t));
     return atan2(A->generate(x,y,z,t), B->generate(x,y,z,t));
   }
+  void compile(GeneratorBytecode &code) {
+    code.add(A);
+    if(B == nullptr) {
+      code.emitFunc1(atan);
+    }else {
+      code.add(B);
+      code.emitFunc2(atan2);
+    }
+  }
 private:
   FieldGeneratorPtr A, B;
 };
@@ -134,6 +153,7 @@ public:
 
   FieldGeneratorPtr clone(const list<FieldGeneratorPtr > args);
   BoutReal generate(double x, double y, double z, double t);
+  void compile(GeneratorBytecode &code) { code.add(gen); code.emitFunc1(sinh); }
 private:
   FieldGeneratorPtr gen;
 };
@@ -145,6 +165,7 @@ public:
 
   FieldGeneratorPtr clone(const list<FieldGeneratorPtr > args);
   BoutReal generate(double x, double y, double z, double t);
+  void compile(GeneratorBytecode &code) { code.add(gen); code.emitFunc1(cosh); }
 private:
   FieldGeneratorPtr gen;
 };
@@ -156,6 +177,7 @@ public:
 
   FieldGeneratorPtr clone(const list<FieldGeneratorPtr > args);
   BoutReal generate(double x, double y, double z, double t);
+  void compile(GeneratorBytecode &code) { code.add(gen); code.emitFunc1(tanh); }
 private:
   FieldGeneratorPtr gen;
 };
@@ -178,6 +200,7 @@ public:
 
   FieldGeneratorPtr clone(const list<FieldGeneratorPtr > args);
   BoutReal generate(double x, double y, double z, double t);
+  void compile(GeneratorBytecode &code) { code.add(gen); code.emitFunc1(fabs); }
 private:
   FieldGeneratorPtr gen;
 };
@@ -189,6 +212,7 @@ public:
 
   FieldGeneratorPtr clone(const list<FieldGeneratorPtr > args);
   BoutReal generate(double x, double y, double z, double t);
+  void compile(GeneratorBytecode &code) { code.add(gen); code.emitFunc1(sqrt); }
 private:
   FieldGeneratorPtr gen;
 };
@@ -200,6 +224,7 @@ public:
 
   FieldGeneratorPtr clone(const list<FieldGeneratorPtr > args);
   BoutReal generate(double x, double y, double z, double t);
+  void compile(GeneratorBytecode &code);
   const std::string str() {return std::string("H(")+gen->str()+std::string(")");}
 private:
   FieldGeneratorPtr gen;
@@ -212,6 +237,7 @@ public:
 
   FieldGeneratorPtr clone(const list<FieldGeneratorPtr > args);
   BoutReal generate(double x, double y, double z, double t);
+  void compile(GeneratorBytecode &code) { code.add(gen); code.emitFunc1(erf); }
 private:
   FieldGeneratorPtr gen;
 };
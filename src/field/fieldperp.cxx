@@ -34,6 +34,8 @@
 #include <boutexception.hxx>
 #include <msg_stack.hxx>
 
+#include <algorithm>
+
 FieldPerp::FieldPerp(Mesh *localmesh) : Field(localmesh) {
   if (fieldmesh) {
     nx = fieldmesh->LocalNx;
@@ -222,6 +224,21 @@ const Region<IndPerp> &FieldPerp::getRegion(const std::string &region_name) cons
   return fieldmesh->getRegionPerp(region_name);
 };
 
+void FieldPerp::applyBoundary(BoutReal value) {
+  TRACE("FieldPerp::applyBoundary(BoutReal)");
+
+  checkData(*this);
+
+  if (fieldmesh->firstX()) {
+    const Region<IndPerp> &inner = fieldmesh->getRegionPerp("RGN_INNER_X");
+    BOUT_FOR(i, inner) { (*this)[i] = value; }
+  }
+  if (fieldmesh->lastX()) {
+    const Region<IndPerp> &outer = fieldmesh->getRegionPerp("RGN_OUTER_X");
+    BOUT_FOR(i, outer) { (*this)[i] = value; }
+  }
+}
+
 //////////////// NON-MEMBER FUNCTIONS //////////////////
 
 ////////////// NON-MEMBER OVERLOADED OPERATORS //////////////
@@ -398,20 +415,31 @@ const FieldPerp floor(const FieldPerp &var, BoutReal f, REGION rgn) {
 }
 
 const FieldPerp sliceXZ(const Field3D& f, int y) {
+  FieldPerp result(f.getMesh());
+  sliceXZ(f, y, result);
+  return result;
+}
+
+FieldPerp& sliceXZ(const Field3D& f, int y, FieldPerp &result) {
   // Source field should be valid
   checkData(f);
 
-  FieldPerp result(f.getMesh());
+  ASSERT1(f.getMesh() == result.getMesh());
 
-  // Allocate memory
+  // Reuses result's storage when already allocated; makes it unique
+  // first, so any previously shared data is untouched
   result.allocate();
   result.setIndex(y);
 
-  const Region<IndPerp> &region_all = f.getMesh()->getRegionPerp("RGN_ALL");
-  BOUT_FOR(i, region_all) {
-    result[i] = f(i, y);
+  // Each (x, y) pencil of a Field3D is contiguous in z, so the slab
+  // comes out as one straight copy per x index
+  Mesh *localmesh = f.getMesh();
+  const int nz = localmesh->LocalNz;
+  for (int jx = 0; jx < localmesh->LocalNx; jx++) {
+    const BoutReal *src = &f(jx, y, 0);
+    std::copy(src, src + nz, result[jx]);
   }
-  
+
   checkData(result);
   return result;
 }
@@ -434,7 +462,7 @@ BoutReal min(const FieldPerp &f, bool allpe, REGION rgn) {
   if (allpe) {
     // MPI reduce
     BoutReal localresult = result;
-    MPI_Allreduce(&localresult, &result, 1, MPI_DOUBLE, MPI_MIN, BoutComm::get());
+    MPI_Allreduce(&localresult, &result, 1, BOUT_MPI_REAL, MPI_MIN, BoutComm::get());
   }
 
   return result;
@@ -458,7 +486,7 @@ BoutReal max(const FieldPerp &f, bool allpe, REGION rgn) {
   if (allpe) {
     // MPI reduce
     BoutReal localresult = result;
-    MPI_Allreduce(&localresult, &result, 1, MPI_DOUBLE, MPI_MAX, BoutComm::get());
+    MPI_Allreduce(&localresult, &result, 1, BOUT_MPI_REAL, MPI_MAX, BoutComm::get());
   }
 
   return result;
@@ -550,8 +578,14 @@ FieldPerp pow(BoutReal lhs, const FieldPerp &rhs, REGION rgn) {
 #if CHECK > 2
 void checkDataIsFiniteOnRegion(const FieldPerp &f, REGION region) {
   const Region<IndPerp> &new_region = f.getMesh()->getRegionPerp(REGION_STRING(region));
-  
-  // Do full checks
+
+  // Cheap branch-free reduction first (optionally thinned by
+  // sampling); the per-point throw logic below only runs once
+  // something is known to be wrong
+  if (isFiniteOnRegion(f, new_region, check_data_sample_stride)) {
+    return;
+  }
+
   BOUT_FOR_SERIAL(i, new_region) {
     if (!::finite(f[i])) {
       throw BoutException("FieldPerp: Operation on non-finite data at [%d][%d]\n", i.x(),
@@ -559,6 +593,19 @@ void checkDataIsFiniteOnRegion(const FieldPerp &f, REGION region) {
     }
   }
 }
+#elif CHECK > 0
+// The per-point checks are compiled out at this level, but the cheap
+// reduction can be switched on at runtime for triage
+void checkDataIsFiniteOnRegion(const FieldPerp &f, REGION region) {
+  if (!check_data_enable_finite) {
+    return;
+  }
+  if (!isFiniteOnRegion(f, f.getMesh()->getRegionPerp(REGION_STRING(region)),
+                        check_data_sample_stride)) {
+    throw BoutException("FieldPerp: Operation on non-finite data in %s\n",
+                        REGION_STRING(region).c_str());
+  }
+}
 #else
 void checkDataIsFiniteOnRegion(const FieldPerp &UNUSED(f), REGION UNUSED(region)) {}
 #endif
@@ -60,9 +60,22 @@ operators = OrderedDict([
     ('-', 'subtraction'),
 ])
 
+# Names of the destination-aware forms, op_into(result, lhs, rhs),
+# which write into an existing field instead of allocating a
+# temporary. Only emitted for the Field3D combinations used when
+# accumulating right-hand-side terms
+into_names = OrderedDict([
+    ('*', 'multiply_into'),
+    ('/', 'divide_into'),
+    ('+', 'add_into'),
+    ('-', 'subtract_into'),
+])
+
 header = """// This file is autogenerated - see gen_fieldops.py
+#include <bout/cpu_dispatch.hxx>
 #include <bout/mesh.hxx>
 #include <bout/region.hxx>
+#include <bout/streaming.hxx>
 #include <field2d.hxx>
 #include <field3d.hxx>
 #include <globals.hxx>
@@ -118,6 +131,19 @@ class Field(object):
         else:
             return "{self.name}[{self.index_var}]".format(self=self)
 
+    @property
+    def block_index(self):
+        """Returns "{name}[Ind{region_type}(i)]", except if field_type is
+        BoutReal, in which case just returns the name. Used by the
+        explicitly vectorised kernels, where the inner loop induction
+        variable is a plain int as required by `omp simd`
+
+        """
+        if self.field_type == "BoutReal":
+            return "{self.name}".format(self=self)
+        else:
+            return "{self.name}[Ind{self.region_type}(i)]".format(self=self)
+
     @property
     def mixed_index(self):
         """Returns "[{index_var} + {jz_var}]" if field_type is Field3D,
@@ -167,8 +193,11 @@ if __name__ == "__main__":
     parser.add_argument("--filename", default="-",
                         help="Write output to FILENAME instead of stdout")
     # By default use OpenMP enabled loops but allow to disable
-    parser.add_argument("--no-openmp", action="store_false", default=False, dest = "noOpenMP", 
+    parser.add_argument("--no-openmp", action="store_false", default=False, dest = "noOpenMP",
                         help="Don't use OpenMP compatible loops")
+    # By default emit explicitly vectorised kernels but allow to disable
+    parser.add_argument("--no-simd", action="store_true", default=False, dest = "noSimd",
+                        help="Don't emit explicitly vectorised (omp simd) kernels")
 
     args = parser.parse_args()
 
@@ -182,7 +211,12 @@ if __name__ == "__main__":
         region_loop = 'BOUT_FOR_SERIAL'
     else:
         region_loop = 'BOUT_FOR'
-        
+
+    # Explicit vectorisation: iterate over the region's contiguous
+    # blocks with BOUT_FOR_BLOCK and request `omp simd` on the integer
+    # inner loop. Falls back to plain region loops when disabled
+    simd = not args.noSimd
+
     # Declare what fields we currently support:
     # Field perp is currently missing
     field3D = Field('Field3D', ['x', 'y', 'z'], index_var=index_var,
@@ -221,6 +255,7 @@ if __name__ == "__main__":
             template_args = {
                 'operator': operator,
                 'operator_name': operator_name,
+                'into_name': into_names[operator],
                 #
                 'out': out,
                 'lhs': lhs,
@@ -228,6 +263,7 @@ if __name__ == "__main__":
                 #
                 'region_loop': region_loop,
                 'region_name': region_name,
+                'simd': simd,
                 #
                 'index_var': index_var,
                 'mixed_base_ind': mixed_base_ind_var,
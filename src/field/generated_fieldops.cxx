@@ -1,12 +1,15 @@
 // This file is autogenerated - see gen_fieldops.py
+#include <bout/cpu_dispatch.hxx>
 #include <bout/mesh.hxx>
 #include <bout/region.hxx>
+#include <bout/streaming.hxx>
 #include <field2d.hxx>
 #include <field3d.hxx>
 #include <globals.hxx>
 #include <interpolation.hxx>
 
 // Provide the C++ wrapper for multiplication of Field3D and Field3D
+BOUT_TARGET_CLONES
 Field3D operator*(const Field3D &lhs, const Field3D &rhs) {
 #if CHECK > 0
   if (lhs.getLocation() != rhs.getLocation()) {
@@ -25,8 +28,31 @@ Field3D operator*(const Field3D &lhs, const Field3D &rhs) {
   checkData(lhs);
   checkData(rhs);
 
-  BOUT_FOR(index, localmesh->getRegion3D("RGN_ALL")) {
-    result[index] = lhs[index] * rhs[index];
+  const auto &region = localmesh->getRegion3D("RGN_ALL");
+  if (bout::streamLargeEnough(region.size())) {
+    // The whole destination is freshly allocated, fully overwritten
+    // and larger than the cache, so store it non-temporally: the
+    // destination lines are not read-allocated just to be
+    // clobbered. RGN_ALL is one contiguous span, so each thread
+    // streams one large chunk (and fences it) rather than looping
+    // over the region's small blocks
+    BoutReal *result_data = &result[Ind3D(0)];
+    const int region_size = region.size();
+    BOUT_OMP(parallel)
+    {
+      int chunk_start, chunk_end;
+      bout::streamChunk(region_size, chunk_start, chunk_end);
+      bout::streamAssign(result_data, chunk_start, chunk_end,
+                         [&](int i) { return lhs[Ind3D(i)] * rhs[Ind3D(i)]; });
+    }
+  } else {
+    BOUT_FOR_BLOCK(block, region) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        result[Ind3D(i)] = lhs[Ind3D(i)] * rhs[Ind3D(i)];
+      }
+    }
   }
 
   result.setLocation(rhs.getLocation());
@@ -35,7 +61,63 @@ Field3D operator*(const Field3D &lhs, const Field3D &rhs) {
   return result;
 }
 
+// Provide the destination-aware form of multiplication of Field3D and Field3D,
+// writing into an existing field instead of allocating a temporary
+BOUT_TARGET_CLONES
+void multiply_into(Field3D &result, const Field3D &lhs, const Field3D &rhs) {
+#if CHECK > 0
+  if (lhs.getLocation() != rhs.getLocation()) {
+    throw BoutException("Error in multiply_into(Field3D, Field3D): fields at different "
+                        "locations. lhs is at %s, rhs is at %s!",
+                        strLocation(lhs.getLocation()), strLocation(rhs.getLocation()));
+  }
+#endif
+
+  Mesh *localmesh = lhs.getMesh();
+
+  ASSERT1(localmesh == rhs.getMesh());
+
+  // Reuse the destination's storage: allocate() keeps unique data in
+  // place and detaches shared data, so the stores below cannot
+  // corrupt a field sharing the block. Aliasing an operand is safe,
+  // as each element is read before it is overwritten
+  if (result.getMesh() != localmesh) {
+    result = Field3D(localmesh);
+  }
+  result.allocate();
+  checkData(lhs);
+  checkData(rhs);
+
+  const auto &region = localmesh->getRegion3D("RGN_ALL");
+  if (bout::streamLargeEnough(region.size())) {
+    // The whole destination is fully overwritten and larger than the
+    // cache, so store it non-temporally as in the allocating form
+    BoutReal *result_data = &result[Ind3D(0)];
+    const int region_size = region.size();
+    BOUT_OMP(parallel)
+    {
+      int chunk_start, chunk_end;
+      bout::streamChunk(region_size, chunk_start, chunk_end);
+      bout::streamAssign(result_data, chunk_start, chunk_end,
+                         [&](int i) { return lhs[Ind3D(i)] * rhs[Ind3D(i)]; });
+    }
+  } else {
+    BOUT_FOR_BLOCK(block, region) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        result[Ind3D(i)] = lhs[Ind3D(i)] * rhs[Ind3D(i)];
+      }
+    }
+  }
+
+  result.setLocation(rhs.getLocation());
+
+  checkData(result);
+}
+
 // Provide the C++ operator to update Field3D by multiplication with Field3D
+BOUT_TARGET_CLONES
 Field3D &Field3D::operator*=(const Field3D &rhs) {
   // only if data is unique we update the field
   // otherwise just call the non-inplace version
@@ -55,10 +137,20 @@ Field3D &Field3D::operator*=(const Field3D &rhs) {
     checkData(*this);
     checkData(rhs);
 
-    BOUT_FOR(index, fieldmesh->getRegion3D("RGN_ALL")) { (*this)[index] *= rhs[index]; }
+    BOUT_FOR_BLOCK(block, fieldmesh->getRegion3D("RGN_ALL")) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        (*this)[Ind3D(i)] *= rhs[Ind3D(i)];
+      }
+    }
 
     checkData(*this);
 
+    // Written in place: count the modification (the non-unique
+    // branch goes through operator=, which already does)
+    generation++;
+
   } else {
     (*this) = (*this) * rhs;
   }
@@ -66,6 +158,7 @@ Field3D &Field3D::operator*=(const Field3D &rhs) {
 }
 
 // Provide the C++ wrapper for division of Field3D and Field3D
+BOUT_TARGET_CLONES
 Field3D operator/(const Field3D &lhs, const Field3D &rhs) {
 #if CHECK > 0
   if (lhs.getLocation() != rhs.getLocation()) {
@@ -84,8 +177,31 @@ Field3D operator/(const Field3D &lhs, const Field3D &rhs) {
   checkData(lhs);
   checkData(rhs);
 
-  BOUT_FOR(index, localmesh->getRegion3D("RGN_ALL")) {
-    result[index] = lhs[index] / rhs[index];
+  const auto &region = localmesh->getRegion3D("RGN_ALL");
+  if (bout::streamLargeEnough(region.size())) {
+    // The whole destination is freshly allocated, fully overwritten
+    // and larger than the cache, so store it non-temporally: the
+    // destination lines are not read-allocated just to be
+    // clobbered. RGN_ALL is one contiguous span, so each thread
+    // streams one large chunk (and fences it) rather than looping
+    // over the region's small blocks
+    BoutReal *result_data = &result[Ind3D(0)];
+    const int region_size = region.size();
+    BOUT_OMP(parallel)
+    {
+      int chunk_start, chunk_end;
+      bout::streamChunk(region_size, chunk_start, chunk_end);
+      bout::streamAssign(result_data, chunk_start, chunk_end,
+                         [&](int i) { return lhs[Ind3D(i)] / rhs[Ind3D(i)]; });
+    }
+  } else {
+    BOUT_FOR_BLOCK(block, region) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        result[Ind3D(i)] = lhs[Ind3D(i)] / rhs[Ind3D(i)];
+      }
+    }
   }
 
   result.setLocation(rhs.getLocation());
@@ -94,7 +210,63 @@ Field3D operator/(const Field3D &lhs, const Field3D &rhs) {
   return result;
 }
 
+// Provide the destination-aware form of division of Field3D and Field3D,
+// writing into an existing field instead of allocating a temporary
+BOUT_TARGET_CLONES
+void divide_into(Field3D &result, const Field3D &lhs, const Field3D &rhs) {
+#if CHECK > 0
+  if (lhs.getLocation() != rhs.getLocation()) {
+    throw BoutException("Error in divide_into(Field3D, Field3D): fields at different "
+                        "locations. lhs is at %s, rhs is at %s!",
+                        strLocation(lhs.getLocation()), strLocation(rhs.getLocation()));
+  }
+#endif
+
+  Mesh *localmesh = lhs.getMesh();
+
+  ASSERT1(localmesh == rhs.getMesh());
+
+  // Reuse the destination's storage: allocate() keeps unique data in
+  // place and detaches shared data, so the stores below cannot
+  // corrupt a field sharing the block. Aliasing an operand is safe,
+  // as each element is read before it is overwritten
+  if (result.getMesh() != localmesh) {
+    result = Field3D(localmesh);
+  }
+  result.allocate();
+  checkData(lhs);
+  checkData(rhs);
+
+  const auto &region = localmesh->getRegion3D("RGN_ALL");
+  if (bout::streamLargeEnough(region.size())) {
+    // The whole destination is fully overwritten and larger than the
+    // cache, so store it non-temporally as in the allocating form
+    BoutReal *result_data = &result[Ind3D(0)];
+    const int region_size = region.size();
+    BOUT_OMP(parallel)
+    {
+      int chunk_start, chunk_end;
+      bout::streamChunk(region_size, chunk_start, chunk_end);
+      bout::streamAssign(result_data, chunk_start, chunk_end,
+                         [&](int i) { return lhs[Ind3D(i)] / rhs[Ind3D(i)]; });
+    }
+  } else {
+    BOUT_FOR_BLOCK(block, region) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        result[Ind3D(i)] = lhs[Ind3D(i)] / rhs[Ind3D(i)];
+      }
+    }
+  }
+
+  result.setLocation(rhs.getLocation());
+
+  checkData(result);
+}
+
 // Provide the C++ operator to update Field3D by division with Field3D
+BOUT_TARGET_CLONES
 Field3D &Field3D::operator/=(const Field3D &rhs) {
   // only if data is unique we update the field
   // otherwise just call the non-inplace version
@@ -114,10 +286,20 @@ Field3D &Field3D::operator/=(const Field3D &rhs) {
     checkData(*this);
     checkData(rhs);
 
-    BOUT_FOR(index, fieldmesh->getRegion3D("RGN_ALL")) { (*this)[index] /= rhs[index]; }
+    BOUT_FOR_BLOCK(block, fieldmesh->getRegion3D("RGN_ALL")) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        (*this)[Ind3D(i)] /= rhs[Ind3D(i)];
+      }
+    }
 
     checkData(*this);
 
+    // Written in place: count the modification (the non-unique
+    // branch goes through operator=, which already does)
+    generation++;
+
   } else {
     (*this) = (*this) / rhs;
   }
@@ -125,6 +307,7 @@ Field3D &Field3D::operator/=(const Field3D &rhs) {
 }
 
 // Provide the C++ wrapper for addition of Field3D and Field3D
+BOUT_TARGET_CLONES
 Field3D operator+(const Field3D &lhs, const Field3D &rhs) {
 #if CHECK > 0
   if (lhs.getLocation() != rhs.getLocation()) {
@@ -143,8 +326,31 @@ Field3D operator+(const Field3D &lhs, const Field3D &rhs) {
   checkData(lhs);
   checkData(rhs);
 
-  BOUT_FOR(index, localmesh->getRegion3D("RGN_ALL")) {
-    result[index] = lhs[index] + rhs[index];
+  const auto &region = localmesh->getRegion3D("RGN_ALL");
+  if (bout::streamLargeEnough(region.size())) {
+    // The whole destination is freshly allocated, fully overwritten
+    // and larger than the cache, so store it non-temporally: the
+    // destination lines are not read-allocated just to be
+    // clobbered. RGN_ALL is one contiguous span, so each thread
+    // streams one large chunk (and fences it) rather than looping
+    // over the region's small blocks
+    BoutReal *result_data = &result[Ind3D(0)];
+    const int region_size = region.size();
+    BOUT_OMP(parallel)
+    {
+      int chunk_start, chunk_end;
+      bout::streamChunk(region_size, chunk_start, chunk_end);
+      bout::streamAssign(result_data, chunk_start, chunk_end,
+                         [&](int i) { return lhs[Ind3D(i)] + rhs[Ind3D(i)]; });
+    }
+  } else {
+    BOUT_FOR_BLOCK(block, region) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        result[Ind3D(i)] = lhs[Ind3D(i)] + rhs[Ind3D(i)];
+      }
+    }
   }
 
   result.setLocation(rhs.getLocation());
@@ -153,7 +359,63 @@ Field3D operator+(const Field3D &lhs, const Field3D &rhs) {
   return result;
 }
 
+// Provide the destination-aware form of addition of Field3D and Field3D,
+// writing into an existing field instead of allocating a temporary
+BOUT_TARGET_CLONES
+void add_into(Field3D &result, const Field3D &lhs, const Field3D &rhs) {
+#if CHECK > 0
+  if (lhs.getLocation() != rhs.getLocation()) {
+    throw BoutException("Error in add_into(Field3D, Field3D): fields at different "
+                        "locations. lhs is at %s, rhs is at %s!",
+                        strLocation(lhs.getLocation()), strLocation(rhs.getLocation()));
+  }
+#endif
+
+  Mesh *localmesh = lhs.getMesh();
+
+  ASSERT1(localmesh == rhs.getMesh());
+
+  // Reuse the destination's storage: allocate() keeps unique data in
+  // place and detaches shared data, so the stores below cannot
+  // corrupt a field sharing the block. Aliasing an operand is safe,
+  // as each element is read before it is overwritten
+  if (result.getMesh() != localmesh) {
+    result = Field3D(localmesh);
+  }
+  result.allocate();
+  checkData(lhs);
+  checkData(rhs);
+
+  const auto &region = localmesh->getRegion3D("RGN_ALL");
+  if (bout::streamLargeEnough(region.size())) {
+    // The whole destination is fully overwritten and larger than the
+    // cache, so store it non-temporally as in the allocating form
+    BoutReal *result_data = &result[Ind3D(0)];
+    const int region_size = region.size();
+    BOUT_OMP(parallel)
+    {
+      int chunk_start, chunk_end;
+      bout::streamChunk(region_size, chunk_start, chunk_end);
+      bout::streamAssign(result_data, chunk_start, chunk_end,
+                         [&](int i) { return lhs[Ind3D(i)] + rhs[Ind3D(i)]; });
+    }
+  } else {
+    BOUT_FOR_BLOCK(block, region) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        result[Ind3D(i)] = lhs[Ind3D(i)] + rhs[Ind3D(i)];
+      }
+    }
+  }
+
+  result.setLocation(rhs.getLocation());
+
+  checkData(result);
+}
+
 // Provide the C++ operator to update Field3D by addition with Field3D
+BOUT_TARGET_CLONES
 Field3D &Field3D::operator+=(const Field3D &rhs) {
   // only if data is unique we update the field
   // otherwise just call the non-inplace version
@@ -173,10 +435,20 @@ Field3D &Field3D::operator+=(const Field3D &rhs) {
     checkData(*this);
     checkData(rhs);
 
-    BOUT_FOR(index, fieldmesh->getRegion3D("RGN_ALL")) { (*this)[index] += rhs[index]; }
+    BOUT_FOR_BLOCK(block, fieldmesh->getRegion3D("RGN_ALL")) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        (*this)[Ind3D(i)] += rhs[Ind3D(i)];
+      }
+    }
 
     checkData(*this);
 
+    // Written in place: count the modification (the non-unique
+    // branch goes through operator=, which already does)
+    generation++;
+
   } else {
     (*this) = (*this) + rhs;
   }
@@ -184,6 +456,7 @@ Field3D &Field3D::operator+=(const Field3D &rhs) {
 }
 
 // Provide the C++ wrapper for subtraction of Field3D and Field3D
+BOUT_TARGET_CLONES
 Field3D operator-(const Field3D &lhs, const Field3D &rhs) {
 #if CHECK > 0
   if (lhs.getLocation() != rhs.getLocation()) {
@@ -202,8 +475,31 @@ Field3D operator-(const Field3D &lhs, const Field3D &rhs) {
   checkData(lhs);
   checkData(rhs);
 
-  BOUT_FOR(index, localmesh->getRegion3D("RGN_ALL")) {
-    result[index] = lhs[index] - rhs[index];
+  const auto &region = localmesh->getRegion3D("RGN_ALL");
+  if (bout::streamLargeEnough(region.size())) {
+    // The whole destination is freshly allocated, fully overwritten
+    // and larger than the cache, so store it non-temporally: the
+    // destination lines are not read-allocated just to be
+    // clobbered. RGN_ALL is one contiguous span, so each thread
+    // streams one large chunk (and fences it) rather than looping
+    // over the region's small blocks
+    BoutReal *result_data = &result[Ind3D(0)];
+    const int region_size = region.size();
+    BOUT_OMP(parallel)
+    {
+      int chunk_start, chunk_end;
+      bout::streamChunk(region_size, chunk_start, chunk_end);
+      bout::streamAssign(result_data, chunk_start, chunk_end,
+                         [&](int i) { return lhs[Ind3D(i)] - rhs[Ind3D(i)]; });
+    }
+  } else {
+    BOUT_FOR_BLOCK(block, region) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        result[Ind3D(i)] = lhs[Ind3D(i)] - rhs[Ind3D(i)];
+      }
+    }
   }
 
   result.setLocation(rhs.getLocation());
@@ -212,7 +508,63 @@ Field3D operator-(const Field3D &lhs, const Field3D &rhs) {
   return result;
 }
 
+// Provide the destination-aware form of subtraction of Field3D and Field3D,
+// writing into an existing field instead of allocating a temporary
+BOUT_TARGET_CLONES
+void subtract_into(Field3D &result, const Field3D &lhs, const Field3D &rhs) {
+#if CHECK > 0
+  if (lhs.getLocation() != rhs.getLocation()) {
+    throw BoutException("Error in subtract_into(Field3D, Field3D): fields at different "
+                        "locations. lhs is at %s, rhs is at %s!",
+                        strLocation(lhs.getLocation()), strLocation(rhs.getLocation()));
+  }
+#endif
+
+  Mesh *localmesh = lhs.getMesh();
+
+  ASSERT1(localmesh == rhs.getMesh());
+
+  // Reuse the destination's storage: allocate() keeps unique data in
+  // place and detaches shared data, so the stores below cannot
+  // corrupt a field sharing the block. Aliasing an operand is safe,
+  // as each element is read before it is overwritten
+  if (result.getMesh() != localmesh) {
+    result = Field3D(localmesh);
+  }
+  result.allocate();
+  checkData(lhs);
+  checkData(rhs);
+
+  const auto &region = localmesh->getRegion3D("RGN_ALL");
+  if (bout::streamLargeEnough(region.size())) {
+    // The whole destination is fully overwritten and larger than the
+    // cache, so store it non-temporally as in the allocating form
+    BoutReal *result_data = &result[Ind3D(0)];
+    const int region_size = region.size();
+    BOUT_OMP(parallel)
+    {
+      int chunk_start, chunk_end;
+      bout::streamChunk(region_size, chunk_start, chunk_end);
+      bout::streamAssign(result_data, chunk_start, chunk_end,
+                         [&](int i) { return lhs[Ind3D(i)] - rhs[Ind3D(i)]; });
+    }
+  } else {
+    BOUT_FOR_BLOCK(block, region) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        result[Ind3D(i)] = lhs[Ind3D(i)] - rhs[Ind3D(i)];
+      }
+    }
+  }
+
+  result.setLocation(rhs.getLocation());
+
+  checkData(result);
+}
+
 // Provide the C++ operator to update Field3D by subtraction with Field3D
+BOUT_TARGET_CLONES
 Field3D &Field3D::operator-=(const Field3D &rhs) {
   // only if data is unique we update the field
   // otherwise just call the non-inplace version
@@ -232,10 +584,20 @@ Field3D &Field3D::operator-=(const Field3D &rhs) {
     checkData(*this);
     checkData(rhs);
 
-    BOUT_FOR(index, fieldmesh->getRegion3D("RGN_ALL")) { (*this)[index] -= rhs[index]; }
+    BOUT_FOR_BLOCK(block, fieldmesh->getRegion3D("RGN_ALL")) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        (*this)[Ind3D(i)] -= rhs[Ind3D(i)];
+      }
+    }
 
     checkData(*this);
 
+    // Written in place: count the modification (the non-unique
+    // branch goes through operator=, which already does)
+    generation++;
+
   } else {
     (*this) = (*this) - rhs;
   }
@@ -243,6 +605,7 @@ Field3D &Field3D::operator-=(const Field3D &rhs) {
 }
 
 // Provide the C++ wrapper for multiplication of Field3D and Field2D
+BOUT_TARGET_CLONES
 Field3D operator*(const Field3D &lhs, const Field2D &rhs) {
 #if CHECK > 0
   if (lhs.getLocation() != rhs.getLocation()) {
@@ -263,8 +626,10 @@ Field3D operator*(const Field3D &lhs, const Field2D &rhs) {
 
   BOUT_FOR(index, localmesh->getRegion2D("RGN_ALL")) {
     const auto base_ind = localmesh->ind2Dto3D(index);
+    const BoutReal rhs_val = rhs[index];
+    BOUT_SIMD
     for (int jz = 0; jz < localmesh->LocalNz; ++jz) {
-      result[base_ind + jz] = lhs[base_ind + jz] * rhs[index];
+      result[base_ind + jz] = lhs[base_ind + jz] * rhs_val;
     }
   }
 
@@ -275,6 +640,7 @@ Field3D operator*(const Field3D &lhs, const Field2D &rhs) {
 }
 
 // Provide the C++ operator to update Field3D by multiplication with Field2D
+BOUT_TARGET_CLONES
 Field3D &Field3D::operator*=(const Field2D &rhs) {
   // only if data is unique we update the field
   // otherwise just call the non-inplace version
@@ -296,13 +662,19 @@ Field3D &Field3D::operator*=(const Field2D &rhs) {
 
     BOUT_FOR(index, fieldmesh->getRegion2D("RGN_ALL")) {
       const auto base_ind = fieldmesh->ind2Dto3D(index);
+      const BoutReal rhs_val = rhs[index];
+      BOUT_SIMD
       for (int jz = 0; jz < fieldmesh->LocalNz; ++jz) {
-        (*this)[base_ind + jz] *= rhs[index];
+        (*this)[base_ind + jz] *= rhs_val;
       }
     }
 
     checkData(*this);
 
+    // Written in place: count the modification (the non-unique
+    // branch goes through operator=, which already does)
+    generation++;
+
   } else {
     (*this) = (*this) * rhs;
   }
@@ -310,6 +682,7 @@ Field3D &Field3D::operator*=(const Field2D &rhs) {
 }
 
 // Provide the C++ wrapper for division of Field3D and Field2D
+BOUT_TARGET_CLONES
 Field3D operator/(const Field3D &lhs, const Field2D &rhs) {
 #if CHECK > 0
   if (lhs.getLocation() != rhs.getLocation()) {
@@ -331,6 +704,7 @@ Field3D operator/(const Field3D &lhs, const Field2D &rhs) {
   BOUT_FOR(index, localmesh->getRegion2D("RGN_ALL")) {
     const auto base_ind = localmesh->ind2Dto3D(index);
     const auto tmp = 1.0 / rhs[index];
+    BOUT_SIMD
     for (int jz = 0; jz < localmesh->LocalNz; ++jz) {
       result[base_ind + jz] = lhs[base_ind + jz] * tmp;
     }
@@ -343,6 +717,7 @@ Field3D operator/(const Field3D &lhs, const Field2D &rhs) {
 }
 
 // Provide the C++ operator to update Field3D by division with Field2D
+BOUT_TARGET_CLONES
 Field3D &Field3D::operator/=(const Field2D &rhs) {
   // only if data is unique we update the field
   // otherwise just call the non-inplace version
@@ -365,6 +740,7 @@ Field3D &Field3D::operator/=(const Field2D &rhs) {
     BOUT_FOR(index, fieldmesh->getRegion2D("RGN_ALL")) {
       const auto base_ind = fieldmesh->ind2Dto3D(index);
       const auto tmp = 1.0 / rhs[index];
+      BOUT_SIMD
       for (int jz = 0; jz < fieldmesh->LocalNz; ++jz) {
         (*this)[base_ind + jz] *= tmp;
       }
@@ -372,6 +748,10 @@ Field3D &Field3D::operator/=(const Field2D &rhs) {
 
     checkData(*this);
 
+    // Written in place: count the modification (the non-unique
+    // branch goes through operator=, which already does)
+    generation++;
+
   } else {
     (*this) = (*this) / rhs;
   }
@@ -379,6 +759,7 @@ Field3D &Field3D::operator/=(const Field2D &rhs) {
 }
 
 // Provide the C++ wrapper for addition of Field3D and Field2D
+BOUT_TARGET_CLONES
 Field3D operator+(const Field3D &lhs, const Field2D &rhs) {
 #if CHECK > 0
   if (lhs.getLocation() != rhs.getLocation()) {
@@ -399,8 +780,10 @@ Field3D operator+(const Field3D &lhs, const Field2D &rhs) {
 
   BOUT_FOR(index, localmesh->getRegion2D("RGN_ALL")) {
     const auto base_ind = localmesh->ind2Dto3D(index);
+    const BoutReal rhs_val = rhs[index];
+    BOUT_SIMD
     for (int jz = 0; jz < localmesh->LocalNz; ++jz) {
-      result[base_ind + jz] = lhs[base_ind + jz] + rhs[index];
+      result[base_ind + jz] = lhs[base_ind + jz] + rhs_val;
     }
   }
 
@@ -411,6 +794,7 @@ Field3D operator+(const Field3D &lhs, const Field2D &rhs) {
 }
 
 // Provide the C++ operator to update Field3D by addition with Field2D
+BOUT_TARGET_CLONES
 Field3D &Field3D::operator+=(const Field2D &rhs) {
   // only if data is unique we update the field
   // otherwise just call the non-inplace version
@@ -432,13 +816,19 @@ Field3D &Field3D::operator+=(const Field2D &rhs) {
 
     BOUT_FOR(index, fieldmesh->getRegion2D("RGN_ALL")) {
       const auto base_ind = fieldmesh->ind2Dto3D(index);
+      const BoutReal rhs_val = rhs[index];
+      BOUT_SIMD
       for (int jz = 0; jz < fieldmesh->LocalNz; ++jz) {
-        (*this)[base_ind + jz] += rhs[index];
+        (*this)[base_ind + jz] += rhs_val;
       }
     }
 
     checkData(*this);
 
+    // Written in place: count the modification (the non-unique
+    // branch goes through operator=, which already does)
+    generation++;
+
   } else {
     (*this) = (*this) + rhs;
   }
@@ -446,6 +836,7 @@ Field3D &Field3D::operator+=(const Field2D &rhs) {
 }
 
 // Provide the C++ wrapper for subtraction of Field3D and Field2D
+BOUT_TARGET_CLONES
 Field3D operator-(const Field3D &lhs, const Field2D &rhs) {
 #if CHECK > 0
   if (lhs.getLocation() != rhs.getLocation()) {
@@ -466,8 +857,10 @@ Field3D operator-(const Field3D &lhs, const Field2D &rhs) {
 
   BOUT_FOR(index, localmesh->getRegion2D("RGN_ALL")) {
     const auto base_ind = localmesh->ind2Dto3D(index);
+    const BoutReal rhs_val = rhs[index];
+    BOUT_SIMD
     for (int jz = 0; jz < localmesh->LocalNz; ++jz) {
-      result[base_ind + jz] = lhs[base_ind + jz] - rhs[index];
+      result[base_ind + jz] = lhs[base_ind + jz] - rhs_val;
     }
   }
 
@@ -478,6 +871,7 @@ Field3D operator-(const Field3D &lhs, const Field2D &rhs) {
 }
 
 // Provide the C++ operator to update Field3D by subtraction with Field2D
+BOUT_TARGET_CLONES
 Field3D &Field3D::operator-=(const Field2D &rhs) {
   // only if data is unique we update the field
   // otherwise just call the non-inplace version
@@ -499,13 +893,19 @@ Field3D &Field3D::operator-=(const Field2D &rhs) {
 
     BOUT_FOR(index, fieldmesh->getRegion2D("RGN_ALL")) {
       const auto base_ind = fieldmesh->ind2Dto3D(index);
+      const BoutReal rhs_val = rhs[index];
+      BOUT_SIMD
       for (int jz = 0; jz < fieldmesh->LocalNz; ++jz) {
-        (*this)[base_ind + jz] -= rhs[index];
+        (*this)[base_ind + jz] -= rhs_val;
       }
     }
 
     checkData(*this);
 
+    // Written in place: count the modification (the non-unique
+    // branch goes through operator=, which already does)
+    generation++;
+
   } else {
     (*this) = (*this) - rhs;
   }
@@ -513,6 +913,7 @@ Field3D &Field3D::operator-=(const Field2D &rhs) {
 }
 
 // Provide the C++ wrapper for multiplication of Field3D and BoutReal
+BOUT_TARGET_CLONES
 Field3D operator*(const Field3D &lhs, const BoutReal rhs) {
 
   Mesh *localmesh = lhs.getMesh();
@@ -522,7 +923,32 @@ Field3D operator*(const Field3D &lhs, const BoutReal rhs) {
   checkData(lhs);
   checkData(rhs);
 
-  BOUT_FOR(index, localmesh->getRegion3D("RGN_ALL")) { result[index] = lhs[index] * rhs; }
+  const auto &region = localmesh->getRegion3D("RGN_ALL");
+  if (bout::streamLargeEnough(region.size())) {
+    // The whole destination is freshly allocated, fully overwritten
+    // and larger than the cache, so store it non-temporally: the
+    // destination lines are not read-allocated just to be
+    // clobbered. RGN_ALL is one contiguous span, so each thread
+    // streams one large chunk (and fences it) rather than looping
+    // over the region's small blocks
+    BoutReal *result_data = &result[Ind3D(0)];
+    const int region_size = region.size();
+    BOUT_OMP(parallel)
+    {
+      int chunk_start, chunk_end;
+      bout::streamChunk(region_size, chunk_start, chunk_end);
+      bout::streamAssign(result_data, chunk_start, chunk_end,
+                         [&](int i) { return lhs[Ind3D(i)] * rhs; });
+    }
+  } else {
+    BOUT_FOR_BLOCK(block, region) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        result[Ind3D(i)] = lhs[Ind3D(i)] * rhs;
+      }
+    }
+  }
 
   result.setLocation(lhs.getLocation());
 
@@ -530,7 +956,54 @@ Field3D operator*(const Field3D &lhs, const BoutReal rhs) {
   return result;
 }
 
+// Provide the destination-aware form of multiplication of Field3D and BoutReal,
+// writing into an existing field instead of allocating a temporary
+BOUT_TARGET_CLONES
+void multiply_into(Field3D &result, const Field3D &lhs, const BoutReal rhs) {
+
+  Mesh *localmesh = lhs.getMesh();
+
+  // Reuse the destination's storage: allocate() keeps unique data in
+  // place and detaches shared data, so the stores below cannot
+  // corrupt a field sharing the block. Aliasing an operand is safe,
+  // as each element is read before it is overwritten
+  if (result.getMesh() != localmesh) {
+    result = Field3D(localmesh);
+  }
+  result.allocate();
+  checkData(lhs);
+  checkData(rhs);
+
+  const auto &region = localmesh->getRegion3D("RGN_ALL");
+  if (bout::streamLargeEnough(region.size())) {
+    // The whole destination is fully overwritten and larger than the
+    // cache, so store it non-temporally as in the allocating form
+    BoutReal *result_data = &result[Ind3D(0)];
+    const int region_size = region.size();
+    BOUT_OMP(parallel)
+    {
+      int chunk_start, chunk_end;
+      bout::streamChunk(region_size, chunk_start, chunk_end);
+      bout::streamAssign(result_data, chunk_start, chunk_end,
+                         [&](int i) { return lhs[Ind3D(i)] * rhs; });
+    }
+  } else {
+    BOUT_FOR_BLOCK(block, region) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        result[Ind3D(i)] = lhs[Ind3D(i)] * rhs;
+      }
+    }
+  }
+
+  result.setLocation(lhs.getLocation());
+
+  checkData(result);
+}
+
 // Provide the C++ operator to update Field3D by multiplication with BoutReal
+BOUT_TARGET_CLONES
 Field3D &Field3D::operator*=(const BoutReal rhs) {
   // only if data is unique we update the field
   // otherwise just call the non-inplace version
@@ -539,10 +1012,20 @@ Field3D &Field3D::operator*=(const BoutReal rhs) {
     checkData(*this);
     checkData(rhs);
 
-    BOUT_FOR(index, fieldmesh->getRegion3D("RGN_ALL")) { (*this)[index] *= rhs; }
+    BOUT_FOR_BLOCK(block, fieldmesh->getRegion3D("RGN_ALL")) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        (*this)[Ind3D(i)] *= rhs;
+      }
+    }
 
     checkData(*this);
 
+    // Written in place: count the modification (the non-unique
+    // branch goes through operator=, which already does)
+    generation++;
+
   } else {
     (*this) = (*this) * rhs;
   }
@@ -550,6 +1033,7 @@ Field3D &Field3D::operator*=(const BoutReal rhs) {
 }
 
 // Provide the C++ wrapper for division of Field3D and BoutReal
+BOUT_TARGET_CLONES
 Field3D operator/(const Field3D &lhs, const BoutReal rhs) {
 
   Mesh *localmesh = lhs.getMesh();
@@ -559,7 +1043,32 @@ Field3D operator/(const Field3D &lhs, const BoutReal rhs) {
   checkData(lhs);
   checkData(rhs);
 
-  BOUT_FOR(index, localmesh->getRegion3D("RGN_ALL")) { result[index] = lhs[index] / rhs; }
+  const auto &region = localmesh->getRegion3D("RGN_ALL");
+  if (bout::streamLargeEnough(region.size())) {
+    // The whole destination is freshly allocated, fully overwritten
+    // and larger than the cache, so store it non-temporally: the
+    // destination lines are not read-allocated just to be
+    // clobbered. RGN_ALL is one contiguous span, so each thread
+    // streams one large chunk (and fences it) rather than looping
+    // over the region's small blocks
+    BoutReal *result_data = &result[Ind3D(0)];
+    const int region_size = region.size();
+    BOUT_OMP(parallel)
+    {
+      int chunk_start, chunk_end;
+      bout::streamChunk(region_size, chunk_start, chunk_end);
+      bout::streamAssign(result_data, chunk_start, chunk_end,
+                         [&](int i) { return lhs[Ind3D(i)] / rhs; });
+    }
+  } else {
+    BOUT_FOR_BLOCK(block, region) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        result[Ind3D(i)] = lhs[Ind3D(i)] / rhs;
+      }
+    }
+  }
 
   result.setLocation(lhs.getLocation());
 
@@ -567,7 +1076,54 @@ Field3D operator/(const Field3D &lhs, const BoutReal rhs) {
   return result;
 }
 
+// Provide the destination-aware form of division of Field3D and BoutReal,
+// writing into an existing field instead of allocating a temporary
+BOUT_TARGET_CLONES
+void divide_into(Field3D &result, const Field3D &lhs, const BoutReal rhs) {
+
+  Mesh *localmesh = lhs.getMesh();
+
+  // Reuse the destination's storage: allocate() keeps unique data in
+  // place and detaches shared data, so the stores below cannot
+  // corrupt a field sharing the block. Aliasing an operand is safe,
+  // as each element is read before it is overwritten
+  if (result.getMesh() != localmesh) {
+    result = Field3D(localmesh);
+  }
+  result.allocate();
+  checkData(lhs);
+  checkData(rhs);
+
+  const auto &region = localmesh->getRegion3D("RGN_ALL");
+  if (bout::streamLargeEnough(region.size())) {
+    // The whole destination is fully overwritten and larger than the
+    // cache, so store it non-temporally as in the allocating form
+    BoutReal *result_data = &result[Ind3D(0)];
+    const int region_size = region.size();
+    BOUT_OMP(parallel)
+    {
+      int chunk_start, chunk_end;
+      bout::streamChunk(region_size, chunk_start, chunk_end);
+      bout::streamAssign(result_data, chunk_start, chunk_end,
+                         [&](int i) { return lhs[Ind3D(i)] / rhs; });
+    }
+  } else {
+    BOUT_FOR_BLOCK(block, region) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        result[Ind3D(i)] = lhs[Ind3D(i)] / rhs;
+      }
+    }
+  }
+
+  result.setLocation(lhs.getLocation());
+
+  checkData(result);
+}
+
 // Provide the C++ operator to update Field3D by division with BoutReal
+BOUT_TARGET_CLONES
 Field3D &Field3D::operator/=(const BoutReal rhs) {
   // only if data is unique we update the field
   // otherwise just call the non-inplace version
@@ -576,10 +1132,20 @@ Field3D &Field3D::operator/=(const BoutReal rhs) {
     checkData(*this);
     checkData(rhs);
 
-    BOUT_FOR(index, fieldmesh->getRegion3D("RGN_ALL")) { (*this)[index] /= rhs; }
+    BOUT_FOR_BLOCK(block, fieldmesh->getRegion3D("RGN_ALL")) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        (*this)[Ind3D(i)] /= rhs;
+      }
+    }
 
     checkData(*this);
 
+    // Written in place: count the modification (the non-unique
+    // branch goes through operator=, which already does)
+    generation++;
+
   } else {
     (*this) = (*this) / rhs;
   }
@@ -587,6 +1153,7 @@ Field3D &Field3D::operator/=(const BoutReal rhs) {
 }
 
 // Provide the C++ wrapper for addition of Field3D and BoutReal
+BOUT_TARGET_CLONES
 Field3D operator+(const Field3D &lhs, const BoutReal rhs) {
 
   Mesh *localmesh = lhs.getMesh();
@@ -596,7 +1163,32 @@ Field3D operator+(const Field3D &lhs, const BoutReal rhs) {
   checkData(lhs);
   checkData(rhs);
 
-  BOUT_FOR(index, localmesh->getRegion3D("RGN_ALL")) { result[index] = lhs[index] + rhs; }
+  const auto &region = localmesh->getRegion3D("RGN_ALL");
+  if (bout::streamLargeEnough(region.size())) {
+    // The whole destination is freshly allocated, fully overwritten
+    // and larger than the cache, so store it non-temporally: the
+    // destination lines are not read-allocated just to be
+    // clobbered. RGN_ALL is one contiguous span, so each thread
+    // streams one large chunk (and fences it) rather than looping
+    // over the region's small blocks
+    BoutReal *result_data = &result[Ind3D(0)];
+    const int region_size = region.size();
+    BOUT_OMP(parallel)
+    {
+      int chunk_start, chunk_end;
+      bout::streamChunk(region_size, chunk_start, chunk_end);
+      bout::streamAssign(result_data, chunk_start, chunk_end,
+                         [&](int i) { return lhs[Ind3D(i)] + rhs; });
+    }
+  } else {
+    BOUT_FOR_BLOCK(block, region) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        result[Ind3D(i)] = lhs[Ind3D(i)] + rhs;
+      }
+    }
+  }
 
   result.setLocation(lhs.getLocation());
 
@@ -604,7 +1196,54 @@ Field3D operator+(const Field3D &lhs, const BoutReal rhs) {
   return result;
 }
 
+// Provide the destination-aware form of addition of Field3D and BoutReal,
+// writing into an existing field instead of allocating a temporary
+BOUT_TARGET_CLONES
+void add_into(Field3D &result, const Field3D &lhs, const BoutReal rhs) {
+
+  Mesh *localmesh = lhs.getMesh();
+
+  // Reuse the destination's storage: allocate() keeps unique data in
+  // place and detaches shared data, so the stores below cannot
+  // corrupt a field sharing the block. Aliasing an operand is safe,
+  // as each element is read before it is overwritten
+  if (result.getMesh() != localmesh) {
+    result = Field3D(localmesh);
+  }
+  result.allocate();
+  checkData(lhs);
+  checkData(rhs);
+
+  const auto &region = localmesh->getRegion3D("RGN_ALL");
+  if (bout::streamLargeEnough(region.size())) {
+    // The whole destination is fully overwritten and larger than the
+    // cache, so store it non-temporally as in the allocating form
+    BoutReal *result_data = &result[Ind3D(0)];
+    const int region_size = region.size();
+    BOUT_OMP(parallel)
+    {
+      int chunk_start, chunk_end;
+      bout::streamChunk(region_size, chunk_start, chunk_end);
+      bout::streamAssign(result_data, chunk_start, chunk_end,
+                         [&](int i) { return lhs[Ind3D(i)] + rhs; });
+    }
+  } else {
+    BOUT_FOR_BLOCK(block, region) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        result[Ind3D(i)] = lhs[Ind3D(i)] + rhs;
+      }
+    }
+  }
+
+  result.setLocation(lhs.getLocation());
+
+  checkData(result);
+}
+
 // Provide the C++ operator to update Field3D by addition with BoutReal
+BOUT_TARGET_CLONES
 Field3D &Field3D::operator+=(const BoutReal rhs) {
   // only if data is unique we update the field
   // otherwise just call the non-inplace version
@@ -613,10 +1252,20 @@ Field3D &Field3D::operator+=(const BoutReal rhs) {
     checkData(*this);
     checkData(rhs);
 
-    BOUT_FOR(index, fieldmesh->getRegion3D("RGN_ALL")) { (*this)[index] += rhs; }
+    BOUT_FOR_BLOCK(block, fieldmesh->getRegion3D("RGN_ALL")) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        (*this)[Ind3D(i)] += rhs;
+      }
+    }
 
     checkData(*this);
 
+    // Written in place: count the modification (the non-unique
+    // branch goes through operator=, which already does)
+    generation++;
+
   } else {
     (*this) = (*this) + rhs;
   }
@@ -624,6 +1273,7 @@ Field3D &Field3D::operator+=(const BoutReal rhs) {
 }
 
 // Provide the C++ wrapper for subtraction of Field3D and BoutReal
+BOUT_TARGET_CLONES
 Field3D operator-(const Field3D &lhs, const BoutReal rhs) {
 
   Mesh *localmesh = lhs.getMesh();
@@ -633,7 +1283,32 @@ Field3D operator-(const Field3D &lhs, const BoutReal rhs) {
   checkData(lhs);
   checkData(rhs);
 
-  BOUT_FOR(index, localmesh->getRegion3D("RGN_ALL")) { result[index] = lhs[index] - rhs; }
+  const auto &region = localmesh->getRegion3D("RGN_ALL");
+  if (bout::streamLargeEnough(region.size())) {
+    // The whole destination is freshly allocated, fully overwritten
+    // and larger than the cache, so store it non-temporally: the
+    // destination lines are not read-allocated just to be
+    // clobbered. RGN_ALL is one contiguous span, so each thread
+    // streams one large chunk (and fences it) rather than looping
+    // over the region's small blocks
+    BoutReal *result_data = &result[Ind3D(0)];
+    const int region_size = region.size();
+    BOUT_OMP(parallel)
+    {
+      int chunk_start, chunk_end;
+      bout::streamChunk(region_size, chunk_start, chunk_end);
+      bout::streamAssign(result_data, chunk_start, chunk_end,
+                         [&](int i) { return lhs[Ind3D(i)] - rhs; });
+    }
+  } else {
+    BOUT_FOR_BLOCK(block, region) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        result[Ind3D(i)] = lhs[Ind3D(i)] - rhs;
+      }
+    }
+  }
 
   result.setLocation(lhs.getLocation());
 
@@ -641,7 +1316,54 @@ Field3D operator-(const Field3D &lhs, const BoutReal rhs) {
   return result;
 }
 
+// Provide the destination-aware form of subtraction of Field3D and BoutReal,
+// writing into an existing field instead of allocating a temporary
+BOUT_TARGET_CLONES
+void subtract_into(Field3D &result, const Field3D &lhs, const BoutReal rhs) {
+
+  Mesh *localmesh = lhs.getMesh();
+
+  // Reuse the destination's storage: allocate() keeps unique data in
+  // place and detaches shared data, so the stores below cannot
+  // corrupt a field sharing the block. Aliasing an operand is safe,
+  // as each element is read before it is overwritten
+  if (result.getMesh() != localmesh) {
+    result = Field3D(localmesh);
+  }
+  result.allocate();
+  checkData(lhs);
+  checkData(rhs);
+
+  const auto &region = localmesh->getRegion3D("RGN_ALL");
+  if (bout::streamLargeEnough(region.size())) {
+    // The whole destination is fully overwritten and larger than the
+    // cache, so store it non-temporally as in the allocating form
+    BoutReal *result_data = &result[Ind3D(0)];
+    const int region_size = region.size();
+    BOUT_OMP(parallel)
+    {
+      int chunk_start, chunk_end;
+      bout::streamChunk(region_size, chunk_start, chunk_end);
+      bout::streamAssign(result_data, chunk_start, chunk_end,
+                         [&](int i) { return lhs[Ind3D(i)] - rhs; });
+    }
+  } else {
+    BOUT_FOR_BLOCK(block, region) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        result[Ind3D(i)] = lhs[Ind3D(i)] - rhs;
+      }
+    }
+  }
+
+  result.setLocation(lhs.getLocation());
+
+  checkData(result);
+}
+
 // Provide the C++ operator to update Field3D by subtraction with BoutReal
+BOUT_TARGET_CLONES
 Field3D &Field3D::operator-=(const BoutReal rhs) {
   // only if data is unique we update the field
   // otherwise just call the non-inplace version
@@ -650,10 +1372,20 @@ Field3D &Field3D::operator-=(const BoutReal rhs) {
     checkData(*this);
     checkData(rhs);
 
-    BOUT_FOR(index, fieldmesh->getRegion3D("RGN_ALL")) { (*this)[index] -= rhs; }
+    BOUT_FOR_BLOCK(block, fieldmesh->getRegion3D("RGN_ALL")) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        (*this)[Ind3D(i)] -= rhs;
+      }
+    }
 
     checkData(*this);
 
+    // Written in place: count the modification (the non-unique
+    // branch goes through operator=, which already does)
+    generation++;
+
   } else {
     (*this) = (*this) - rhs;
   }
@@ -661,6 +1393,7 @@ Field3D &Field3D::operator-=(const BoutReal rhs) {
 }
 
 // Provide the C++ wrapper for multiplication of Field2D and Field3D
+BOUT_TARGET_CLONES
 Field3D operator*(const Field2D &lhs, const Field3D &rhs) {
 #if CHECK > 0
   if (lhs.getLocation() != rhs.getLocation()) {
@@ -681,8 +1414,10 @@ Field3D operator*(const Field2D &lhs, const Field3D &rhs) {
 
   BOUT_FOR(index, localmesh->getRegion2D("RGN_ALL")) {
     const auto base_ind = localmesh->ind2Dto3D(index);
+    const BoutReal lhs_val = lhs[index];
+    BOUT_SIMD
     for (int jz = 0; jz < localmesh->LocalNz; ++jz) {
-      result[base_ind + jz] = lhs[index] * rhs[base_ind + jz];
+      result[base_ind + jz] = lhs_val * rhs[base_ind + jz];
     }
   }
 
@@ -693,6 +1428,7 @@ Field3D operator*(const Field2D &lhs, const Field3D &rhs) {
 }
 
 // Provide the C++ wrapper for division of Field2D and Field3D
+BOUT_TARGET_CLONES
 Field3D operator/(const Field2D &lhs, const Field3D &rhs) {
 #if CHECK > 0
   if (lhs.getLocation() != rhs.getLocation()) {
@@ -713,8 +1449,10 @@ Field3D operator/(const Field2D &lhs, const Field3D &rhs) {
 
   BOUT_FOR(index, localmesh->getRegion2D("RGN_ALL")) {
     const auto base_ind = localmesh->ind2Dto3D(index);
+    const BoutReal lhs_val = lhs[index];
+    BOUT_SIMD
     for (int jz = 0; jz < localmesh->LocalNz; ++jz) {
-      result[base_ind + jz] = lhs[index] / rhs[base_ind + jz];
+      result[base_ind + jz] = lhs_val / rhs[base_ind + jz];
     }
   }
 
@@ -725,6 +1463,7 @@ Field3D operator/(const Field2D &lhs, const Field3D &rhs) {
 }
 
 // Provide the C++ wrapper for addition of Field2D and Field3D
+BOUT_TARGET_CLONES
 Field3D operator+(const Field2D &lhs, const Field3D &rhs) {
 #if CHECK > 0
   if (lhs.getLocation() != rhs.getLocation()) {
@@ -745,8 +1484,10 @@ Field3D operator+(const Field2D &lhs, const Field3D &rhs) {
 
   BOUT_FOR(index, localmesh->getRegion2D("RGN_ALL")) {
     const auto base_ind = localmesh->ind2Dto3D(index);
+    const BoutReal lhs_val = lhs[index];
+    BOUT_SIMD
     for (int jz = 0; jz < localmesh->LocalNz; ++jz) {
-      result[base_ind + jz] = lhs[index] + rhs[base_ind + jz];
+      result[base_ind + jz] = lhs_val + rhs[base_ind + jz];
     }
   }
 
@@ -757,6 +1498,7 @@ Field3D operator+(const Field2D &lhs, const Field3D &rhs) {
 }
 
 // Provide the C++ wrapper for subtraction of Field2D and Field3D
+BOUT_TARGET_CLONES
 Field3D operator-(const Field2D &lhs, const Field3D &rhs) {
 #if CHECK > 0
   if (lhs.getLocation() != rhs.getLocation()) {
@@ -777,8 +1519,10 @@ Field3D operator-(const Field2D &lhs, const Field3D &rhs) {
 
   BOUT_FOR(index, localmesh->getRegion2D("RGN_ALL")) {
     const auto base_ind = localmesh->ind2Dto3D(index);
+    const BoutReal lhs_val = lhs[index];
+    BOUT_SIMD
     for (int jz = 0; jz < localmesh->LocalNz; ++jz) {
-      result[base_ind + jz] = lhs[index] - rhs[base_ind + jz];
+      result[base_ind + jz] = lhs_val - rhs[base_ind + jz];
     }
   }
 
@@ -789,6 +1533,7 @@ Field3D operator-(const Field2D &lhs, const Field3D &rhs) {
 }
 
 // Provide the C++ wrapper for multiplication of Field2D and Field2D
+BOUT_TARGET_CLONES
 Field2D operator*(const Field2D &lhs, const Field2D &rhs) {
 #if CHECK > 0
   if (lhs.getLocation() != rhs.getLocation()) {
@@ -807,8 +1552,31 @@ Field2D operator*(const Field2D &lhs, const Field2D &rhs) {
   checkData(lhs);
   checkData(rhs);
 
-  BOUT_FOR(index, localmesh->getRegion2D("RGN_ALL")) {
-    result[index] = lhs[index] * rhs[index];
+  const auto &region = localmesh->getRegion2D("RGN_ALL");
+  if (bout::streamLargeEnough(region.size())) {
+    // The whole destination is freshly allocated, fully overwritten
+    // and larger than the cache, so store it non-temporally: the
+    // destination lines are not read-allocated just to be
+    // clobbered. RGN_ALL is one contiguous span, so each thread
+    // streams one large chunk (and fences it) rather than looping
+    // over the region's small blocks
+    BoutReal *result_data = &result[Ind2D(0)];
+    const int region_size = region.size();
+    BOUT_OMP(parallel)
+    {
+      int chunk_start, chunk_end;
+      bout::streamChunk(region_size, chunk_start, chunk_end);
+      bout::streamAssign(result_data, chunk_start, chunk_end,
+                         [&](int i) { return lhs[Ind2D(i)] * rhs[Ind2D(i)]; });
+    }
+  } else {
+    BOUT_FOR_BLOCK(block, region) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        result[Ind2D(i)] = lhs[Ind2D(i)] * rhs[Ind2D(i)];
+      }
+    }
   }
 
   result.setLocation(rhs.getLocation());
@@ -818,6 +1586,7 @@ Field2D operator*(const Field2D &lhs, const Field2D &rhs) {
 }
 
 // Provide the C++ operator to update Field2D by multiplication with Field2D
+BOUT_TARGET_CLONES
 Field2D &Field2D::operator*=(const Field2D &rhs) {
   // only if data is unique we update the field
   // otherwise just call the non-inplace version
@@ -837,7 +1606,13 @@ Field2D &Field2D::operator*=(const Field2D &rhs) {
     checkData(*this);
     checkData(rhs);
 
-    BOUT_FOR(index, fieldmesh->getRegion2D("RGN_ALL")) { (*this)[index] *= rhs[index]; }
+    BOUT_FOR_BLOCK(block, fieldmesh->getRegion2D("RGN_ALL")) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        (*this)[Ind2D(i)] *= rhs[Ind2D(i)];
+      }
+    }
 
     checkData(*this);
 
@@ -848,6 +1623,7 @@ Field2D &Field2D::operator*=(const Field2D &rhs) {
 }
 
 // Provide the C++ wrapper for division of Field2D and Field2D
+BOUT_TARGET_CLONES
 Field2D operator/(const Field2D &lhs, const Field2D &rhs) {
 #if CHECK > 0
   if (lhs.getLocation() != rhs.getLocation()) {
@@ -866,8 +1642,31 @@ Field2D operator/(const Field2D &lhs, const Field2D &rhs) {
   checkData(lhs);
   checkData(rhs);
 
-  BOUT_FOR(index, localmesh->getRegion2D("RGN_ALL")) {
-    result[index] = lhs[index] / rhs[index];
+  const auto &region = localmesh->getRegion2D("RGN_ALL");
+  if (bout::streamLargeEnough(region.size())) {
+    // The whole destination is freshly allocated, fully overwritten
+    // and larger than the cache, so store it non-temporally: the
+    // destination lines are not read-allocated just to be
+    // clobbered. RGN_ALL is one contiguous span, so each thread
+    // streams one large chunk (and fences it) rather than looping
+    // over the region's small blocks
+    BoutReal *result_data = &result[Ind2D(0)];
+    const int region_size = region.size();
+    BOUT_OMP(parallel)
+    {
+      int chunk_start, chunk_end;
+      bout::streamChunk(region_size, chunk_start, chunk_end);
+      bout::streamAssign(result_data, chunk_start, chunk_end,
+                         [&](int i) { return lhs[Ind2D(i)] / rhs[Ind2D(i)]; });
+    }
+  } else {
+    BOUT_FOR_BLOCK(block, region) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        result[Ind2D(i)] = lhs[Ind2D(i)] / rhs[Ind2D(i)];
+      }
+    }
   }
 
   result.setLocation(rhs.getLocation());
@@ -877,6 +1676,7 @@ Field2D operator/(const Field2D &lhs, const Field2D &rhs) {
 }
 
 // Provide the C++ operator to update Field2D by division with Field2D
+BOUT_TARGET_CLONES
 Field2D &Field2D::operator/=(const Field2D &rhs) {
   // only if data is unique we update the field
   // otherwise just call the non-inplace version
@@ -896,7 +1696,13 @@ Field2D &Field2D::operator/=(const Field2D &rhs) {
     checkData(*this);
     checkData(rhs);
 
-    BOUT_FOR(index, fieldmesh->getRegion2D("RGN_ALL")) { (*this)[index] /= rhs[index]; }
+    BOUT_FOR_BLOCK(block, fieldmesh->getRegion2D("RGN_ALL")) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        (*this)[Ind2D(i)] /= rhs[Ind2D(i)];
+      }
+    }
 
     checkData(*this);
 
@@ -907,6 +1713,7 @@ Field2D &Field2D::operator/=(const Field2D &rhs) {
 }
 
 // Provide the C++ wrapper for addition of Field2D and Field2D
+BOUT_TARGET_CLONES
 Field2D operator+(const Field2D &lhs, const Field2D &rhs) {
 #if CHECK > 0
   if (lhs.getLocation() != rhs.getLocation()) {
@@ -925,8 +1732,31 @@ Field2D operator+(const Field2D &lhs, const Field2D &rhs) {
   checkData(lhs);
   checkData(rhs);
 
-  BOUT_FOR(index, localmesh->getRegion2D("RGN_ALL")) {
-    result[index] = lhs[index] + rhs[index];
+  const auto &region = localmesh->getRegion2D("RGN_ALL");
+  if (bout::streamLargeEnough(region.size())) {
+    // The whole destination is freshly allocated, fully overwritten
+    // and larger than the cache, so store it non-temporally: the
+    // destination lines are not read-allocated just to be
+    // clobbered. RGN_ALL is one contiguous span, so each thread
+    // streams one large chunk (and fences it) rather than looping
+    // over the region's small blocks
+    BoutReal *result_data = &result[Ind2D(0)];
+    const int region_size = region.size();
+    BOUT_OMP(parallel)
+    {
+      int chunk_start, chunk_end;
+      bout::streamChunk(region_size, chunk_start, chunk_end);
+      bout::streamAssign(result_data, chunk_start, chunk_end,
+                         [&](int i) { return lhs[Ind2D(i)] + rhs[Ind2D(i)]; });
+    }
+  } else {
+    BOUT_FOR_BLOCK(block, region) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        result[Ind2D(i)] = lhs[Ind2D(i)] + rhs[Ind2D(i)];
+      }
+    }
   }
 
   result.setLocation(rhs.getLocation());
@@ -936,6 +1766,7 @@ Field2D operator+(const Field2D &lhs, const Field2D &rhs) {
 }
 
 // Provide the C++ operator to update Field2D by addition with Field2D
+BOUT_TARGET_CLONES
 Field2D &Field2D::operator+=(const Field2D &rhs) {
   // only if data is unique we update the field
   // otherwise just call the non-inplace version
@@ -955,7 +1786,13 @@ Field2D &Field2D::operator+=(const Field2D &rhs) {
     checkData(*this);
     checkData(rhs);
 
-    BOUT_FOR(index, fieldmesh->getRegion2D("RGN_ALL")) { (*this)[index] += rhs[index]; }
+    BOUT_FOR_BLOCK(block, fieldmesh->getRegion2D("RGN_ALL")) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        (*this)[Ind2D(i)] += rhs[Ind2D(i)];
+      }
+    }
 
     checkData(*this);
 
@@ -966,6 +1803,7 @@ Field2D &Field2D::operator+=(const Field2D &rhs) {
 }
 
 // Provide the C++ wrapper for subtraction of Field2D and Field2D
+BOUT_TARGET_CLONES
 Field2D operator-(const Field2D &lhs, const Field2D &rhs) {
 #if CHECK > 0
   if (lhs.getLocation() != rhs.getLocation()) {
@@ -984,8 +1822,31 @@ Field2D operator-(const Field2D &lhs, const Field2D &rhs) {
   checkData(lhs);
   checkData(rhs);
 
-  BOUT_FOR(index, localmesh->getRegion2D("RGN_ALL")) {
-    result[index] = lhs[index] - rhs[index];
+  const auto &region = localmesh->getRegion2D("RGN_ALL");
+  if (bout::streamLargeEnough(region.size())) {
+    // The whole destination is freshly allocated, fully overwritten
+    // and larger than the cache, so store it non-temporally: the
+    // destination lines are not read-allocated just to be
+    // clobbered. RGN_ALL is one contiguous span, so each thread
+    // streams one large chunk (and fences it) rather than looping
+    // over the region's small blocks
+    BoutReal *result_data = &result[Ind2D(0)];
+    const int region_size = region.size();
+    BOUT_OMP(parallel)
+    {
+      int chunk_start, chunk_end;
+      bout::streamChunk(region_size, chunk_start, chunk_end);
+      bout::streamAssign(result_data, chunk_start, chunk_end,
+                         [&](int i) { return lhs[Ind2D(i)] - rhs[Ind2D(i)]; });
+    }
+  } else {
+    BOUT_FOR_BLOCK(block, region) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        result[Ind2D(i)] = lhs[Ind2D(i)] - rhs[Ind2D(i)];
+      }
+    }
   }
 
   result.setLocation(rhs.getLocation());
@@ -995,6 +1856,7 @@ Field2D operator-(const Field2D &lhs, const Field2D &rhs) {
 }
 
 // Provide the C++ operator to update Field2D by subtraction with Field2D
+BOUT_TARGET_CLONES
 Field2D &Field2D::operator-=(const Field2D &rhs) {
   // only if data is unique we update the field
   // otherwise just call the non-inplace version
@@ -1014,7 +1876,13 @@ Field2D &Field2D::operator-=(const Field2D &rhs) {
     checkData(*this);
     checkData(rhs);
 
-    BOUT_FOR(index, fieldmesh->getRegion2D("RGN_ALL")) { (*this)[index] -= rhs[index]; }
+    BOUT_FOR_BLOCK(block, fieldmesh->getRegion2D("RGN_ALL")) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        (*this)[Ind2D(i)] -= rhs[Ind2D(i)];
+      }
+    }
 
     checkData(*this);
 
@@ -1025,6 +1893,7 @@ Field2D &Field2D::operator-=(const Field2D &rhs) {
 }
 
 // Provide the C++ wrapper for multiplication of Field2D and BoutReal
+BOUT_TARGET_CLONES
 Field2D operator*(const Field2D &lhs, const BoutReal rhs) {
 
   Mesh *localmesh = lhs.getMesh();
@@ -1034,7 +1903,32 @@ Field2D operator*(const Field2D &lhs, const BoutReal rhs) {
   checkData(lhs);
   checkData(rhs);
 
-  BOUT_FOR(index, localmesh->getRegion2D("RGN_ALL")) { result[index] = lhs[index] * rhs; }
+  const auto &region = localmesh->getRegion2D("RGN_ALL");
+  if (bout::streamLargeEnough(region.size())) {
+    // The whole destination is freshly allocated, fully overwritten
+    // and larger than the cache, so store it non-temporally: the
+    // destination lines are not read-allocated just to be
+    // clobbered. RGN_ALL is one contiguous span, so each thread
+    // streams one large chunk (and fences it) rather than looping
+    // over the region's small blocks
+    BoutReal *result_data = &result[Ind2D(0)];
+    const int region_size = region.size();
+    BOUT_OMP(parallel)
+    {
+      int chunk_start, chunk_end;
+      bout::streamChunk(region_size, chunk_start, chunk_end);
+      bout::streamAssign(result_data, chunk_start, chunk_end,
+                         [&](int i) { return lhs[Ind2D(i)] * rhs; });
+    }
+  } else {
+    BOUT_FOR_BLOCK(block, region) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        result[Ind2D(i)] = lhs[Ind2D(i)] * rhs;
+      }
+    }
+  }
 
   result.setLocation(lhs.getLocation());
 
@@ -1043,6 +1937,7 @@ Field2D operator*(const Field2D &lhs, const BoutReal rhs) {
 }
 
 // Provide the C++ operator to update Field2D by multiplication with BoutReal
+BOUT_TARGET_CLONES
 Field2D &Field2D::operator*=(const BoutReal rhs) {
   // only if data is unique we update the field
   // otherwise just call the non-inplace version
@@ -1051,7 +1946,13 @@ Field2D &Field2D::operator*=(const BoutReal rhs) {
     checkData(*this);
     checkData(rhs);
 
-    BOUT_FOR(index, fieldmesh->getRegion2D("RGN_ALL")) { (*this)[index] *= rhs; }
+    BOUT_FOR_BLOCK(block, fieldmesh->getRegion2D("RGN_ALL")) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        (*this)[Ind2D(i)] *= rhs;
+      }
+    }
 
     checkData(*this);
 
@@ -1062,6 +1963,7 @@ Field2D &Field2D::operator*=(const BoutReal rhs) {
 }
 
 // Provide the C++ wrapper for division of Field2D and BoutReal
+BOUT_TARGET_CLONES
 Field2D operator/(const Field2D &lhs, const BoutReal rhs) {
 
   Mesh *localmesh = lhs.getMesh();
@@ -1071,7 +1973,32 @@ Field2D operator/(const Field2D &lhs, const BoutReal rhs) {
   checkData(lhs);
   checkData(rhs);
 
-  BOUT_FOR(index, localmesh->getRegion2D("RGN_ALL")) { result[index] = lhs[index] / rhs; }
+  const auto &region = localmesh->getRegion2D("RGN_ALL");
+  if (bout::streamLargeEnough(region.size())) {
+    // The whole destination is freshly allocated, fully overwritten
+    // and larger than the cache, so store it non-temporally: the
+    // destination lines are not read-allocated just to be
+    // clobbered. RGN_ALL is one contiguous span, so each thread
+    // streams one large chunk (and fences it) rather than looping
+    // over the region's small blocks
+    BoutReal *result_data = &result[Ind2D(0)];
+    const int region_size = region.size();
+    BOUT_OMP(parallel)
+    {
+      int chunk_start, chunk_end;
+      bout::streamChunk(region_size, chunk_start, chunk_end);
+      bout::streamAssign(result_data, chunk_start, chunk_end,
+                         [&](int i) { return lhs[Ind2D(i)] / rhs; });
+    }
+  } else {
+    BOUT_FOR_BLOCK(block, region) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        result[Ind2D(i)] = lhs[Ind2D(i)] / rhs;
+      }
+    }
+  }
 
   result.setLocation(lhs.getLocation());
 
@@ -1080,6 +2007,7 @@ Field2D operator/(const Field2D &lhs, const BoutReal rhs) {
 }
 
 // Provide the C++ operator to update Field2D by division with BoutReal
+BOUT_TARGET_CLONES
 Field2D &Field2D::operator/=(const BoutReal rhs) {
   // only if data is unique we update the field
   // otherwise just call the non-inplace version
@@ -1088,7 +2016,13 @@ Field2D &Field2D::operator/=(const BoutReal rhs) {
     checkData(*this);
     checkData(rhs);
 
-    BOUT_FOR(index, fieldmesh->getRegion2D("RGN_ALL")) { (*this)[index] /= rhs; }
+    BOUT_FOR_BLOCK(block, fieldmesh->getRegion2D("RGN_ALL")) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        (*this)[Ind2D(i)] /= rhs;
+      }
+    }
 
     checkData(*this);
 
@@ -1099,6 +2033,7 @@ Field2D &Field2D::operator/=(const BoutReal rhs) {
 }
 
 // Provide the C++ wrapper for addition of Field2D and BoutReal
+BOUT_TARGET_CLONES
 Field2D operator+(const Field2D &lhs, const BoutReal rhs) {
 
   Mesh *localmesh = lhs.getMesh();
@@ -1108,7 +2043,32 @@ Field2D operator+(const Field2D &lhs, const BoutReal rhs) {
   checkData(lhs);
   checkData(rhs);
 
-  BOUT_FOR(index, localmesh->getRegion2D("RGN_ALL")) { result[index] = lhs[index] + rhs; }
+  const auto &region = localmesh->getRegion2D("RGN_ALL");
+  if (bout::streamLargeEnough(region.size())) {
+    // The whole destination is freshly allocated, fully overwritten
+    // and larger than the cache, so store it non-temporally: the
+    // destination lines are not read-allocated just to be
+    // clobbered. RGN_ALL is one contiguous span, so each thread
+    // streams one large chunk (and fences it) rather than looping
+    // over the region's small blocks
+    BoutReal *result_data = &result[Ind2D(0)];
+    const int region_size = region.size();
+    BOUT_OMP(parallel)
+    {
+      int chunk_start, chunk_end;
+      bout::streamChunk(region_size, chunk_start, chunk_end);
+      bout::streamAssign(result_data, chunk_start, chunk_end,
+                         [&](int i) { return lhs[Ind2D(i)] + rhs; });
+    }
+  } else {
+    BOUT_FOR_BLOCK(block, region) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        result[Ind2D(i)] = lhs[Ind2D(i)] + rhs;
+      }
+    }
+  }
 
   result.setLocation(lhs.getLocation());
 
@@ -1117,6 +2077,7 @@ Field2D operator+(const Field2D &lhs, const BoutReal rhs) {
 }
 
 // Provide the C++ operator to update Field2D by addition with BoutReal
+BOUT_TARGET_CLONES
 Field2D &Field2D::operator+=(const BoutReal rhs) {
   // only if data is unique we update the field
   // otherwise just call the non-inplace version
@@ -1125,7 +2086,13 @@ Field2D &Field2D::operator+=(const BoutReal rhs) {
     checkData(*this);
     checkData(rhs);
 
-    BOUT_FOR(index, fieldmesh->getRegion2D("RGN_ALL")) { (*this)[index] += rhs; }
+    BOUT_FOR_BLOCK(block, fieldmesh->getRegion2D("RGN_ALL")) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        (*this)[Ind2D(i)] += rhs;
+      }
+    }
 
     checkData(*this);
 
@@ -1136,6 +2103,7 @@ Field2D &Field2D::operator+=(const BoutReal rhs) {
 }
 
 // Provide the C++ wrapper for subtraction of Field2D and BoutReal
+BOUT_TARGET_CLONES
 Field2D operator-(const Field2D &lhs, const BoutReal rhs) {
 
   Mesh *localmesh = lhs.getMesh();
@@ -1145,7 +2113,32 @@ Field2D operator-(const Field2D &lhs, const BoutReal rhs) {
   checkData(lhs);
   checkData(rhs);
 
-  BOUT_FOR(index, localmesh->getRegion2D("RGN_ALL")) { result[index] = lhs[index] - rhs; }
+  const auto &region = localmesh->getRegion2D("RGN_ALL");
+  if (bout::streamLargeEnough(region.size())) {
+    // The whole destination is freshly allocated, fully overwritten
+    // and larger than the cache, so store it non-temporally: the
+    // destination lines are not read-allocated just to be
+    // clobbered. RGN_ALL is one contiguous span, so each thread
+    // streams one large chunk (and fences it) rather than looping
+    // over the region's small blocks
+    BoutReal *result_data = &result[Ind2D(0)];
+    const int region_size = region.size();
+    BOUT_OMP(parallel)
+    {
+      int chunk_start, chunk_end;
+      bout::streamChunk(region_size, chunk_start, chunk_end);
+      bout::streamAssign(result_data, chunk_start, chunk_end,
+                         [&](int i) { return lhs[Ind2D(i)] - rhs; });
+    }
+  } else {
+    BOUT_FOR_BLOCK(block, region) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        result[Ind2D(i)] = lhs[Ind2D(i)] - rhs;
+      }
+    }
+  }
 
   result.setLocation(lhs.getLocation());
 
@@ -1154,6 +2147,7 @@ Field2D operator-(const Field2D &lhs, const BoutReal rhs) {
 }
 
 // Provide the C++ operator to update Field2D by subtraction with BoutReal
+BOUT_TARGET_CLONES
 Field2D &Field2D::operator-=(const BoutReal rhs) {
   // only if data is unique we update the field
   // otherwise just call the non-inplace version
@@ -1162,7 +2156,13 @@ Field2D &Field2D::operator-=(const BoutReal rhs) {
     checkData(*this);
     checkData(rhs);
 
-    BOUT_FOR(index, fieldmesh->getRegion2D("RGN_ALL")) { (*this)[index] -= rhs; }
+    BOUT_FOR_BLOCK(block, fieldmesh->getRegion2D("RGN_ALL")) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        (*this)[Ind2D(i)] -= rhs;
+      }
+    }
 
     checkData(*this);
 
@@ -1173,6 +2173,7 @@ Field2D &Field2D::operator-=(const BoutReal rhs) {
 }
 
 // Provide the C++ wrapper for multiplication of BoutReal and Field3D
+BOUT_TARGET_CLONES
 Field3D operator*(const BoutReal lhs, const Field3D &rhs) {
 
   Mesh *localmesh = rhs.getMesh();
@@ -1182,7 +2183,32 @@ Field3D operator*(const BoutReal lhs, const Field3D &rhs) {
   checkData(lhs);
   checkData(rhs);
 
-  BOUT_FOR(index, localmesh->getRegion3D("RGN_ALL")) { result[index] = lhs * rhs[index]; }
+  const auto &region = localmesh->getRegion3D("RGN_ALL");
+  if (bout::streamLargeEnough(region.size())) {
+    // The whole destination is freshly allocated, fully overwritten
+    // and larger than the cache, so store it non-temporally: the
+    // destination lines are not read-allocated just to be
+    // clobbered. RGN_ALL is one contiguous span, so each thread
+    // streams one large chunk (and fences it) rather than looping
+    // over the region's small blocks
+    BoutReal *result_data = &result[Ind3D(0)];
+    const int region_size = region.size();
+    BOUT_OMP(parallel)
+    {
+      int chunk_start, chunk_end;
+      bout::streamChunk(region_size, chunk_start, chunk_end);
+      bout::streamAssign(result_data, chunk_start, chunk_end,
+                         [&](int i) { return lhs * rhs[Ind3D(i)]; });
+    }
+  } else {
+    BOUT_FOR_BLOCK(block, region) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        result[Ind3D(i)] = lhs * rhs[Ind3D(i)];
+      }
+    }
+  }
 
   result.setLocation(rhs.getLocation());
 
@@ -1190,7 +2216,54 @@ Field3D operator*(const BoutReal lhs, const Field3D &rhs) {
   return result;
 }
 
+// Provide the destination-aware form of multiplication of BoutReal and Field3D,
+// writing into an existing field instead of allocating a temporary
+BOUT_TARGET_CLONES
+void multiply_into(Field3D &result, const BoutReal lhs, const Field3D &rhs) {
+
+  Mesh *localmesh = rhs.getMesh();
+
+  // Reuse the destination's storage: allocate() keeps unique data in
+  // place and detaches shared data, so the stores below cannot
+  // corrupt a field sharing the block. Aliasing an operand is safe,
+  // as each element is read before it is overwritten
+  if (result.getMesh() != localmesh) {
+    result = Field3D(localmesh);
+  }
+  result.allocate();
+  checkData(lhs);
+  checkData(rhs);
+
+  const auto &region = localmesh->getRegion3D("RGN_ALL");
+  if (bout::streamLargeEnough(region.size())) {
+    // The whole destination is fully overwritten and larger than the
+    // cache, so store it non-temporally as in the allocating form
+    BoutReal *result_data = &result[Ind3D(0)];
+    const int region_size = region.size();
+    BOUT_OMP(parallel)
+    {
+      int chunk_start, chunk_end;
+      bout::streamChunk(region_size, chunk_start, chunk_end);
+      bout::streamAssign(result_data, chunk_start, chunk_end,
+                         [&](int i) { return lhs * rhs[Ind3D(i)]; });
+    }
+  } else {
+    BOUT_FOR_BLOCK(block, region) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        result[Ind3D(i)] = lhs * rhs[Ind3D(i)];
+      }
+    }
+  }
+
+  result.setLocation(rhs.getLocation());
+
+  checkData(result);
+}
+
 // Provide the C++ wrapper for division of BoutReal and Field3D
+BOUT_TARGET_CLONES
 Field3D operator/(const BoutReal lhs, const Field3D &rhs) {
 
   Mesh *localmesh = rhs.getMesh();
@@ -1200,7 +2273,32 @@ Field3D operator/(const BoutReal lhs, const Field3D &rhs) {
   checkData(lhs);
   checkData(rhs);
 
-  BOUT_FOR(index, localmesh->getRegion3D("RGN_ALL")) { result[index] = lhs / rhs[index]; }
+  const auto &region = localmesh->getRegion3D("RGN_ALL");
+  if (bout::streamLargeEnough(region.size())) {
+    // The whole destination is freshly allocated, fully overwritten
+    // and larger than the cache, so store it non-temporally: the
+    // destination lines are not read-allocated just to be
+    // clobbered. RGN_ALL is one contiguous span, so each thread
+    // streams one large chunk (and fences it) rather than looping
+    // over the region's small blocks
+    BoutReal *result_data = &result[Ind3D(0)];
+    const int region_size = region.size();
+    BOUT_OMP(parallel)
+    {
+      int chunk_start, chunk_end;
+      bout::streamChunk(region_size, chunk_start, chunk_end);
+      bout::streamAssign(result_data, chunk_start, chunk_end,
+                         [&](int i) { return lhs / rhs[Ind3D(i)]; });
+    }
+  } else {
+    BOUT_FOR_BLOCK(block, region) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        result[Ind3D(i)] = lhs / rhs[Ind3D(i)];
+      }
+    }
+  }
 
   result.setLocation(rhs.getLocation());
 
@@ -1208,7 +2306,54 @@ Field3D operator/(const BoutReal lhs, const Field3D &rhs) {
   return result;
 }
 
+// Provide the destination-aware form of division of BoutReal and Field3D,
+// writing into an existing field instead of allocating a temporary
+BOUT_TARGET_CLONES
+void divide_into(Field3D &result, const BoutReal lhs, const Field3D &rhs) {
+
+  Mesh *localmesh = rhs.getMesh();
+
+  // Reuse the destination's storage: allocate() keeps unique data in
+  // place and detaches shared data, so the stores below cannot
+  // corrupt a field sharing the block. Aliasing an operand is safe,
+  // as each element is read before it is overwritten
+  if (result.getMesh() != localmesh) {
+    result = Field3D(localmesh);
+  }
+  result.allocate();
+  checkData(lhs);
+  checkData(rhs);
+
+  const auto &region = localmesh->getRegion3D("RGN_ALL");
+  if (bout::streamLargeEnough(region.size())) {
+    // The whole destination is fully overwritten and larger than the
+    // cache, so store it non-temporally as in the allocating form
+    BoutReal *result_data = &result[Ind3D(0)];
+    const int region_size = region.size();
+    BOUT_OMP(parallel)
+    {
+      int chunk_start, chunk_end;
+      bout::streamChunk(region_size, chunk_start, chunk_end);
+      bout::streamAssign(result_data, chunk_start, chunk_end,
+                         [&](int i) { return lhs / rhs[Ind3D(i)]; });
+    }
+  } else {
+    BOUT_FOR_BLOCK(block, region) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        result[Ind3D(i)] = lhs / rhs[Ind3D(i)];
+      }
+    }
+  }
+
+  result.setLocation(rhs.getLocation());
+
+  checkData(result);
+}
+
 // Provide the C++ wrapper for addition of BoutReal and Field3D
+BOUT_TARGET_CLONES
 Field3D operator+(const BoutReal lhs, const Field3D &rhs) {
 
   Mesh *localmesh = rhs.getMesh();
@@ -1218,7 +2363,32 @@ Field3D operator+(const BoutReal lhs, const Field3D &rhs) {
   checkData(lhs);
   checkData(rhs);
 
-  BOUT_FOR(index, localmesh->getRegion3D("RGN_ALL")) { result[index] = lhs + rhs[index]; }
+  const auto &region = localmesh->getRegion3D("RGN_ALL");
+  if (bout::streamLargeEnough(region.size())) {
+    // The whole destination is freshly allocated, fully overwritten
+    // and larger than the cache, so store it non-temporally: the
+    // destination lines are not read-allocated just to be
+    // clobbered. RGN_ALL is one contiguous span, so each thread
+    // streams one large chunk (and fences it) rather than looping
+    // over the region's small blocks
+    BoutReal *result_data = &result[Ind3D(0)];
+    const int region_size = region.size();
+    BOUT_OMP(parallel)
+    {
+      int chunk_start, chunk_end;
+      bout::streamChunk(region_size, chunk_start, chunk_end);
+      bout::streamAssign(result_data, chunk_start, chunk_end,
+                         [&](int i) { return lhs + rhs[Ind3D(i)]; });
+    }
+  } else {
+    BOUT_FOR_BLOCK(block, region) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        result[Ind3D(i)] = lhs + rhs[Ind3D(i)];
+      }
+    }
+  }
 
   result.setLocation(rhs.getLocation());
 
@@ -1226,7 +2396,54 @@ Field3D operator+(const BoutReal lhs, const Field3D &rhs) {
   return result;
 }
 
+// Provide the destination-aware form of addition of BoutReal and Field3D,
+// writing into an existing field instead of allocating a temporary
+BOUT_TARGET_CLONES
+void add_into(Field3D &result, const BoutReal lhs, const Field3D &rhs) {
+
+  Mesh *localmesh = rhs.getMesh();
+
+  // Reuse the destination's storage: allocate() keeps unique data in
+  // place and detaches shared data, so the stores below cannot
+  // corrupt a field sharing the block. Aliasing an operand is safe,
+  // as each element is read before it is overwritten
+  if (result.getMesh() != localmesh) {
+    result = Field3D(localmesh);
+  }
+  result.allocate();
+  checkData(lhs);
+  checkData(rhs);
+
+  const auto &region = localmesh->getRegion3D("RGN_ALL");
+  if (bout::streamLargeEnough(region.size())) {
+    // The whole destination is fully overwritten and larger than the
+    // cache, so store it non-temporally as in the allocating form
+    BoutReal *result_data = &result[Ind3D(0)];
+    const int region_size = region.size();
+    BOUT_OMP(parallel)
+    {
+      int chunk_start, chunk_end;
+      bout::streamChunk(region_size, chunk_start, chunk_end);
+      bout::streamAssign(result_data, chunk_start, chunk_end,
+                         [&](int i) { return lhs + rhs[Ind3D(i)]; });
+    }
+  } else {
+    BOUT_FOR_BLOCK(block, region) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        result[Ind3D(i)] = lhs + rhs[Ind3D(i)];
+      }
+    }
+  }
+
+  result.setLocation(rhs.getLocation());
+
+  checkData(result);
+}
+
 // Provide the C++ wrapper for subtraction of BoutReal and Field3D
+BOUT_TARGET_CLONES
 Field3D operator-(const BoutReal lhs, const Field3D &rhs) {
 
   Mesh *localmesh = rhs.getMesh();
@@ -1236,7 +2453,32 @@ Field3D operator-(const BoutReal lhs, const Field3D &rhs) {
   checkData(lhs);
   checkData(rhs);
 
-  BOUT_FOR(index, localmesh->getRegion3D("RGN_ALL")) { result[index] = lhs - rhs[index]; }
+  const auto &region = localmesh->getRegion3D("RGN_ALL");
+  if (bout::streamLargeEnough(region.size())) {
+    // The whole destination is freshly allocated, fully overwritten
+    // and larger than the cache, so store it non-temporally: the
+    // destination lines are not read-allocated just to be
+    // clobbered. RGN_ALL is one contiguous span, so each thread
+    // streams one large chunk (and fences it) rather than looping
+    // over the region's small blocks
+    BoutReal *result_data = &result[Ind3D(0)];
+    const int region_size = region.size();
+    BOUT_OMP(parallel)
+    {
+      int chunk_start, chunk_end;
+      bout::streamChunk(region_size, chunk_start, chunk_end);
+      bout::streamAssign(result_data, chunk_start, chunk_end,
+                         [&](int i) { return lhs - rhs[Ind3D(i)]; });
+    }
+  } else {
+    BOUT_FOR_BLOCK(block, region) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        result[Ind3D(i)] = lhs - rhs[Ind3D(i)];
+      }
+    }
+  }
 
   result.setLocation(rhs.getLocation());
 
@@ -1244,7 +2486,54 @@ Field3D operator-(const BoutReal lhs, const Field3D &rhs) {
   return result;
 }
 
+// Provide the destination-aware form of subtraction of BoutReal and Field3D,
+// writing into an existing field instead of allocating a temporary
+BOUT_TARGET_CLONES
+void subtract_into(Field3D &result, const BoutReal lhs, const Field3D &rhs) {
+
+  Mesh *localmesh = rhs.getMesh();
+
+  // Reuse the destination's storage: allocate() keeps unique data in
+  // place and detaches shared data, so the stores below cannot
+  // corrupt a field sharing the block. Aliasing an operand is safe,
+  // as each element is read before it is overwritten
+  if (result.getMesh() != localmesh) {
+    result = Field3D(localmesh);
+  }
+  result.allocate();
+  checkData(lhs);
+  checkData(rhs);
+
+  const auto &region = localmesh->getRegion3D("RGN_ALL");
+  if (bout::streamLargeEnough(region.size())) {
+    // The whole destination is fully overwritten and larger than the
+    // cache, so store it non-temporally as in the allocating form
+    BoutReal *result_data = &result[Ind3D(0)];
+    const int region_size = region.size();
+    BOUT_OMP(parallel)
+    {
+      int chunk_start, chunk_end;
+      bout::streamChunk(region_size, chunk_start, chunk_end);
+      bout::streamAssign(result_data, chunk_start, chunk_end,
+                         [&](int i) { return lhs - rhs[Ind3D(i)]; });
+    }
+  } else {
+    BOUT_FOR_BLOCK(block, region) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        result[Ind3D(i)] = lhs - rhs[Ind3D(i)];
+      }
+    }
+  }
+
+  result.setLocation(rhs.getLocation());
+
+  checkData(result);
+}
+
 // Provide the C++ wrapper for multiplication of BoutReal and Field2D
+BOUT_TARGET_CLONES
 Field2D operator*(const BoutReal lhs, const Field2D &rhs) {
 
   Mesh *localmesh = rhs.getMesh();
@@ -1254,7 +2543,32 @@ Field2D operator*(const BoutReal lhs, const Field2D &rhs) {
   checkData(lhs);
   checkData(rhs);
 
-  BOUT_FOR(index, localmesh->getRegion2D("RGN_ALL")) { result[index] = lhs * rhs[index]; }
+  const auto &region = localmesh->getRegion2D("RGN_ALL");
+  if (bout::streamLargeEnough(region.size())) {
+    // The whole destination is freshly allocated, fully overwritten
+    // and larger than the cache, so store it non-temporally: the
+    // destination lines are not read-allocated just to be
+    // clobbered. RGN_ALL is one contiguous span, so each thread
+    // streams one large chunk (and fences it) rather than looping
+    // over the region's small blocks
+    BoutReal *result_data = &result[Ind2D(0)];
+    const int region_size = region.size();
+    BOUT_OMP(parallel)
+    {
+      int chunk_start, chunk_end;
+      bout::streamChunk(region_size, chunk_start, chunk_end);
+      bout::streamAssign(result_data, chunk_start, chunk_end,
+                         [&](int i) { return lhs * rhs[Ind2D(i)]; });
+    }
+  } else {
+    BOUT_FOR_BLOCK(block, region) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        result[Ind2D(i)] = lhs * rhs[Ind2D(i)];
+      }
+    }
+  }
 
   result.setLocation(rhs.getLocation());
 
@@ -1263,6 +2577,7 @@ Field2D operator*(const BoutReal lhs, const Field2D &rhs) {
 }
 
 // Provide the C++ wrapper for division of BoutReal and Field2D
+BOUT_TARGET_CLONES
 Field2D operator/(const BoutReal lhs, const Field2D &rhs) {
 
   Mesh *localmesh = rhs.getMesh();
@@ -1272,7 +2587,32 @@ Field2D operator/(const BoutReal lhs, const Field2D &rhs) {
   checkData(lhs);
   checkData(rhs);
 
-  BOUT_FOR(index, localmesh->getRegion2D("RGN_ALL")) { result[index] = lhs / rhs[index]; }
+  const auto &region = localmesh->getRegion2D("RGN_ALL");
+  if (bout::streamLargeEnough(region.size())) {
+    // The whole destination is freshly allocated, fully overwritten
+    // and larger than the cache, so store it non-temporally: the
+    // destination lines are not read-allocated just to be
+    // clobbered. RGN_ALL is one contiguous span, so each thread
+    // streams one large chunk (and fences it) rather than looping
+    // over the region's small blocks
+    BoutReal *result_data = &result[Ind2D(0)];
+    const int region_size = region.size();
+    BOUT_OMP(parallel)
+    {
+      int chunk_start, chunk_end;
+      bout::streamChunk(region_size, chunk_start, chunk_end);
+      bout::streamAssign(result_data, chunk_start, chunk_end,
+                         [&](int i) { return lhs / rhs[Ind2D(i)]; });
+    }
+  } else {
+    BOUT_FOR_BLOCK(block, region) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        result[Ind2D(i)] = lhs / rhs[Ind2D(i)];
+      }
+    }
+  }
 
   result.setLocation(rhs.getLocation());
 
@@ -1281,6 +2621,7 @@ Field2D operator/(const BoutReal lhs, const Field2D &rhs) {
 }
 
 // Provide the C++ wrapper for addition of BoutReal and Field2D
+BOUT_TARGET_CLONES
 Field2D operator+(const BoutReal lhs, const Field2D &rhs) {
 
   Mesh *localmesh = rhs.getMesh();
@@ -1290,7 +2631,32 @@ Field2D operator+(const BoutReal lhs, const Field2D &rhs) {
   checkData(lhs);
   checkData(rhs);
 
-  BOUT_FOR(index, localmesh->getRegion2D("RGN_ALL")) { result[index] = lhs + rhs[index]; }
+  const auto &region = localmesh->getRegion2D("RGN_ALL");
+  if (bout::streamLargeEnough(region.size())) {
+    // The whole destination is freshly allocated, fully overwritten
+    // and larger than the cache, so store it non-temporally: the
+    // destination lines are not read-allocated just to be
+    // clobbered. RGN_ALL is one contiguous span, so each thread
+    // streams one large chunk (and fences it) rather than looping
+    // over the region's small blocks
+    BoutReal *result_data = &result[Ind2D(0)];
+    const int region_size = region.size();
+    BOUT_OMP(parallel)
+    {
+      int chunk_start, chunk_end;
+      bout::streamChunk(region_size, chunk_start, chunk_end);
+      bout::streamAssign(result_data, chunk_start, chunk_end,
+                         [&](int i) { return lhs + rhs[Ind2D(i)]; });
+    }
+  } else {
+    BOUT_FOR_BLOCK(block, region) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        result[Ind2D(i)] = lhs + rhs[Ind2D(i)];
+      }
+    }
+  }
 
   result.setLocation(rhs.getLocation());
 
@@ -1299,6 +2665,7 @@ Field2D operator+(const BoutReal lhs, const Field2D &rhs) {
 }
 
 // Provide the C++ wrapper for subtraction of BoutReal and Field2D
+BOUT_TARGET_CLONES
 Field2D operator-(const BoutReal lhs, const Field2D &rhs) {
 
   Mesh *localmesh = rhs.getMesh();
@@ -1308,7 +2675,32 @@ Field2D operator-(const BoutReal lhs, const Field2D &rhs) {
   checkData(lhs);
   checkData(rhs);
 
-  BOUT_FOR(index, localmesh->getRegion2D("RGN_ALL")) { result[index] = lhs - rhs[index]; }
+  const auto &region = localmesh->getRegion2D("RGN_ALL");
+  if (bout::streamLargeEnough(region.size())) {
+    // The whole destination is freshly allocated, fully overwritten
+    // and larger than the cache, so store it non-temporally: the
+    // destination lines are not read-allocated just to be
+    // clobbered. RGN_ALL is one contiguous span, so each thread
+    // streams one large chunk (and fences it) rather than looping
+    // over the region's small blocks
+    BoutReal *result_data = &result[Ind2D(0)];
+    const int region_size = region.size();
+    BOUT_OMP(parallel)
+    {
+      int chunk_start, chunk_end;
+      bout::streamChunk(region_size, chunk_start, chunk_end);
+      bout::streamAssign(result_data, chunk_start, chunk_end,
+                         [&](int i) { return lhs - rhs[Ind2D(i)]; });
+    }
+  } else {
+    BOUT_FOR_BLOCK(block, region) {
+      const int iend = block->second.ind;
+      BOUT_SIMD
+      for (int i = block->first.ind; i < iend; ++i) {
+        result[Ind2D(i)] = lhs - rhs[Ind2D(i)];
+      }
+    }
+  }
 
   result.setLocation(rhs.getLocation());
 
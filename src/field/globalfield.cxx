@@ -3,6 +3,8 @@
 #include <boutexception.hxx>
 #include <boutcomm.hxx>
 
+#include <algorithm>
+
 GlobalField::GlobalField(Mesh *m, int proc, int xsize, int ysize, int zsize) 
   : mesh(m), data_on_proc(proc), nx(xsize), ny(ysize), nz(zsize) {
   
@@ -85,153 +87,130 @@ GlobalField2D::GlobalField2D(Mesh *m, int proc) : GlobalField(m, proc, m->Global
   
   if((proc < 0) || (proc >= npes))
     throw BoutException("Processor out of range");
-  
-  if(mype == data_on_proc) {
+
+  // Block lengths and offsets for the packed global buffer, as
+  // passed to MPI_Gatherv / MPI_Scatterv
+  counts.resize(npes);
+  displs.resize(npes);
+  int total = 0;
+  for (int p = 0; p < npes; p++) {
+    counts[p] = msg_len(p);
+    displs[p] = total;
+    total += counts[p];
+  }
+
+  sendbuf = Array<BoutReal>(msg_len(mype));
+  if (mype == data_on_proc) {
     // Gathering onto this processor
-    buffer = new BoutReal*[npes];
-    for(int p=0;p<npes;p++)
-      buffer[p] = new BoutReal[msg_len(p)];
-  }else {
-    buffer = new BoutReal*[1];
-    buffer[0] = new BoutReal[msg_len(mype)];
+    recvbuf = Array<BoutReal>(total);
   }
 }
 
-GlobalField2D::~GlobalField2D() {
-  if(mype == data_on_proc) {
-    for(int p=0;p<npes;p++)
-      delete[] buffer[p];
-  }else
-    delete[] buffer[0];
-  delete[] buffer;
+GlobalField2D::~GlobalField2D() {}
+
+void GlobalField2D::packLocal(const Field2D &f, BoutReal *dest) const {
+  int local_xorig, local_yorig;
+  proc_local_origin(mype, &local_xorig, &local_yorig);
+  int xsize, ysize;
+  proc_size(mype, &xsize, &ysize);
+
+  for (int x = 0; x < xsize; x++)
+    for (int y = 0; y < ysize; y++) {
+      dest[x * ysize + y] = f(local_xorig + x, local_yorig + y);
+    }
 }
 
 void GlobalField2D::gather(const Field2D &f) {
-  // Gather all data onto processor 'proc'
-  
-  if(mype == data_on_proc) {
-    // This processor will receive the data
-    
-    MPI_Request* req = new MPI_Request[npes]; // Array of receive handles
-
-    // Post receives
-    for(int p = 0; p < npes; p++) {
-      if( p != mype ) {
-        // Check size of the array
-        MPI_Irecv(buffer[p], msg_len(p), MPI_DOUBLE, p, 3141, comm, &req[p]);
-      }
+  // Gather all data onto processor 'proc' with a single collective
+
+  packLocal(f, sendbuf.begin());
+
+  MPI_Gatherv(sendbuf.begin(), msg_len(mype), BOUT_MPI_REAL,
+              recvbuf.begin(), counts.data(), displs.data(), BOUT_MPI_REAL,
+              data_on_proc, comm);
+
+  if (mype == data_on_proc) {
+    // Unpack each processor's block into the global field
+    for (int p = 0; p < npes; p++) {
+      int xorig, yorig;
+      proc_origin(p, &xorig, &yorig);
+      int xsize, ysize;
+      proc_size(p, &xsize, &ysize);
+      const BoutReal *block = recvbuf.begin() + displs[p];
+
+      for (int x = 0; x < xsize; x++)
+        for (int y = 0; y < ysize; y++) {
+          (*this)(x + xorig, y + yorig) = block[x * ysize + y];
+        }
     }
-    
-    req[mype] = MPI_REQUEST_NULL; // Mark as not used
-    
-    // Copy data from this processor
-    int local_xorig, local_yorig;
-    proc_local_origin(mype, &local_xorig, &local_yorig);
-    int xorig, yorig;
-    proc_origin(mype, &xorig, &yorig);
-    int xsize, ysize;
-    proc_size(mype, &xsize, &ysize);
-    
-    for(int x=0;x<xsize;x++)
-      for(int y=0;y<ysize;y++) {
-        (*this)(x+xorig,y+yorig) =  f(local_xorig+x, local_yorig+y);
-      }
-    
-    if(npes > 1) {
-      // Wait for receives, process as they arrive
-      int pe;
+  }
+  data_valid = true;
+}
+
+void GlobalField2D::gatherBlocks(const Field2D &f, const BlockConsumer &consumer) {
+  // Stream one processor's block at a time to the consumer, so the
+  // gathering processor never needs the assembled global field
+
+  if (mype != data_on_proc) {
+    packLocal(f, sendbuf.begin());
+    MPI_Send(sendbuf.begin(), msg_len(mype), BOUT_MPI_REAL, data_on_proc, 3141, comm);
+    return;
+  }
+
+  // One block of scratch, reused for every remote processor
+  int maxlen = 0;
+  for (int p = 0; p < npes; p++)
+    maxlen = std::max(maxlen, msg_len(p));
+  Array<BoutReal> block(maxlen);
+
+  for (int p = 0; p < npes; p++) {
+    if (p == mype) {
+      packLocal(f, block.begin());
+    } else {
       MPI_Status status;
-      do {
-        MPI_Waitany(npes, req, &pe, &status);
-
-        if(pe != MPI_UNDEFINED) {
-          // Unpack data from processor 'pe'
-          int remote_xorig, remote_yorig;
-          proc_origin(pe, &remote_xorig, &remote_yorig);
-          int remote_xsize, remote_ysize;
-          proc_size(pe, &remote_xsize, &remote_ysize);
-          
-          for(int x=0;x<remote_xsize;x++)
-            for(int y=0;y<remote_ysize;y++) {
-              (*this)(x+remote_xorig,y+remote_yorig) =  buffer[pe][x*remote_ysize + y];
-            }
-          
-          req[pe] = MPI_REQUEST_NULL;
-        }
-      }while(pe != MPI_UNDEFINED);
+      MPI_Recv(block.begin(), msg_len(p), BOUT_MPI_REAL, p, 3141, comm, &status);
     }
-    delete[] req;
-  }else {
-    // Sending data to proc
-    
-    int local_xorig, local_yorig;
-    proc_local_origin(mype, &local_xorig, &local_yorig);
-    int xsize, ysize;
-    proc_size(mype, &xsize, &ysize);
-    
-    for(int x=0;x<xsize;x++)
-      for(int y=0;y<ysize;y++) {
-        buffer[0][x*ysize + y] = f(local_xorig+x, local_yorig+y);
-      }
 
-    MPI_Send(buffer[0], msg_len(mype), MPI_DOUBLE, data_on_proc, 3141, comm);
+    int xorig, yorig;
+    proc_origin(p, &xorig, &yorig);
+    int xsize, ysize;
+    proc_size(p, &xsize, &ysize);
+    consumer(xorig, yorig, xsize, ysize, block.begin());
   }
-  data_valid = true;
 }
 
 const Field2D GlobalField2D::scatter() const {
   Field2D result(mesh);
   result.allocate();
-  
-  MPI_Status status;
-  if(mype == data_on_proc) {
-    // Data is on this processor. Send to other processors
-    
-    for(int p = 0; p < npes; p++) {
-      if(p == mype) continue;
-      
+
+  if (mype == data_on_proc) {
+    // Pack each processor's block from the global field
+    for (int p = 0; p < npes; p++) {
       int xorig, yorig;
       proc_origin(p, &xorig, &yorig);
       int xsize, ysize;
       proc_size(p, &xsize, &ysize);
-      
-      // Send to processor p
-      for(int x=0;x<xsize;x++)
-        for(int y=0;y<ysize;y++) {
-          buffer[p][x*ysize + y] = (*this)(x+xorig,y+yorig);
+      BoutReal *block = recvbuf.begin() + displs[p];
+
+      for (int x = 0; x < xsize; x++)
+        for (int y = 0; y < ysize; y++) {
+          block[x * ysize + y] = (*this)(x + xorig, y + yorig);
         }
-      
-      MPI_Send(buffer[p], xsize*ysize, MPI_DOUBLE, p, 1413, comm);
     }
-
-    int local_xorig, local_yorig;
-    proc_local_origin(mype, &local_xorig, &local_yorig);
-    int xorig, yorig;
-    proc_origin(mype, &xorig, &yorig);
-    int xsize, ysize;
-    proc_size(mype, &xsize, &ysize);
-    
-    // Copy to result
-    for(int x=0;x<xsize;x++)
-      for(int y=0;y<ysize;y++) {
-        result(local_xorig+x,local_yorig+y) = (*this)(x+xorig,y+yorig);
-      }
-  }else {
-    // Receive data
-    MPI_Recv(buffer[0], msg_len(mype), MPI_DOUBLE, data_on_proc, 1413, comm, &status);
-    
-    int local_xorig, local_yorig;
-    proc_local_origin(mype, &local_xorig, &local_yorig);
-    int xorig, yorig;
-    proc_origin(mype, &xorig, &yorig);
-    int xsize, ysize;
-    proc_size(mype, &xsize, &ysize);
-    
-    for(int x=0;x<xsize;x++)
-      for(int y=0;y<ysize;y++) {
-        result(local_xorig+x,local_yorig+y) = buffer[0][x*ysize + y];
-      }
   }
+
+  MPI_Scatterv(recvbuf.begin(), counts.data(), displs.data(), BOUT_MPI_REAL,
+               sendbuf.begin(), msg_len(mype), BOUT_MPI_REAL, data_on_proc, comm);
+
+  int local_xorig, local_yorig;
+  proc_local_origin(mype, &local_xorig, &local_yorig);
+  int xsize, ysize;
+  proc_size(mype, &xsize, &ysize);
+
+  for (int x = 0; x < xsize; x++)
+    for (int y = 0; y < ysize; y++) {
+      result(local_xorig + x, local_yorig + y) = sendbuf[x * ysize + y];
+    }
   return result;
 }
 
@@ -248,164 +227,138 @@ GlobalField3D::GlobalField3D(Mesh *m, int proc) : GlobalField(m, proc, m->Global
   
   if((proc < 0) || (proc >= npes))
     throw BoutException("Processor out of range");
-  
-  if(mype == data_on_proc) {
+
+  // Block lengths and offsets for the packed global buffer, as
+  // passed to MPI_Gatherv / MPI_Scatterv
+  counts.resize(npes);
+  displs.resize(npes);
+  int total = 0;
+  for (int p = 0; p < npes; p++) {
+    counts[p] = msg_len(p);
+    displs[p] = total;
+    total += counts[p];
+  }
+
+  sendbuf = Array<BoutReal>(msg_len(mype));
+  if (mype == data_on_proc) {
     // Gathering onto this processor
-    buffer = new BoutReal*[npes];
-    for(int p=0;p<npes;p++)
-      buffer[p] = new BoutReal[msg_len(p)];
-  }else {
-    buffer = new BoutReal*[1];
-    buffer[0] = new BoutReal[msg_len(mype)];
+    recvbuf = Array<BoutReal>(total);
   }
 }
 
-GlobalField3D::~GlobalField3D() {
-  if(mype == data_on_proc) {
-    for(int p=0;p<npes;p++)
-      delete[] buffer[p];
-  }else
-    delete[] buffer[0];
-  delete[] buffer;
+GlobalField3D::~GlobalField3D() {}
+
+void GlobalField3D::packLocal(const Field3D &f, BoutReal *dest) const {
+  int local_xorig, local_yorig;
+  proc_local_origin(mype, &local_xorig, &local_yorig);
+  int xsize, ysize;
+  proc_size(mype, &xsize, &ysize);
+  int zsize = mesh->LocalNz;
+
+  for (int x = 0; x < xsize; x++)
+    for (int y = 0; y < ysize; y++)
+      for (int z = 0; z < zsize; z++) {
+        dest[x * ysize * zsize + y * zsize + z] = f(local_xorig + x, local_yorig + y, z);
+      }
 }
 
 void GlobalField3D::gather(const Field3D &f) {
-  // Gather all data onto processor 'proc'
-  
-  if(mype == data_on_proc) {
-    // This processor will receive the data
-    
-    MPI_Request* req = new MPI_Request[npes]; // Array of receive handles
-
-    // Post receives
-    for(int p = 0; p < npes; p++) {
-      if( p != mype ) {
-        // Check size of the array
-        MPI_Irecv(buffer[p], msg_len(p), MPI_DOUBLE, p, 3141, comm, &req[p]);
-      }
+  // Gather all data onto processor 'proc' with a single collective
+
+  packLocal(f, sendbuf.begin());
+
+  MPI_Gatherv(sendbuf.begin(), msg_len(mype), BOUT_MPI_REAL,
+              recvbuf.begin(), counts.data(), displs.data(), BOUT_MPI_REAL,
+              data_on_proc, comm);
+
+  if (mype == data_on_proc) {
+    // Unpack each processor's block into the global field
+    for (int p = 0; p < npes; p++) {
+      int xorig, yorig;
+      proc_origin(p, &xorig, &yorig);
+      int xsize, ysize;
+      proc_size(p, &xsize, &ysize);
+      int zsize = mesh->LocalNz;
+      const BoutReal *block = recvbuf.begin() + displs[p];
+
+      for (int x = 0; x < xsize; x++)
+        for (int y = 0; y < ysize; y++)
+          for (int z = 0; z < zsize; z++) {
+            (*this)(x + xorig, y + yorig, z) = block[x * ysize * zsize + y * zsize + z];
+          }
     }
-    
-    req[mype] = MPI_REQUEST_NULL; // Mark as not used
-    
-    // Copy data from this processor
-    int local_xorig, local_yorig;
-    proc_local_origin(mype, &local_xorig, &local_yorig);
-    int xorig, yorig;
-    proc_origin(mype, &xorig, &yorig);
-    int xsize, ysize;
-    proc_size(mype, &xsize, &ysize);
-    
-    for(int x=0;x<xsize;x++)
-      for(int y=0;y<ysize;y++) 
-        for(int z=0;z<mesh->LocalNz;z++) {
-          (*this)(x+xorig,y+yorig,z) =  f(local_xorig+x, local_yorig+y, z);
-        }
-    
-    if(npes > 1) {
-      // Wait for receives, process as they arrive
-      int pe;
+  }
+  data_valid = true;
+}
+
+void GlobalField3D::gatherBlocks(const Field3D &f, const BlockConsumer &consumer) {
+  // Stream one processor's block at a time to the consumer, so the
+  // gathering processor never needs the assembled global field
+
+  if (mype != data_on_proc) {
+    packLocal(f, sendbuf.begin());
+    MPI_Send(sendbuf.begin(), msg_len(mype), BOUT_MPI_REAL, data_on_proc, 3141, comm);
+    return;
+  }
+
+  // One block of scratch, reused for every remote processor
+  int maxlen = 0;
+  for (int p = 0; p < npes; p++)
+    maxlen = std::max(maxlen, msg_len(p));
+  Array<BoutReal> block(maxlen);
+
+  for (int p = 0; p < npes; p++) {
+    if (p == mype) {
+      packLocal(f, block.begin());
+    } else {
       MPI_Status status;
-      do {
-        MPI_Waitany(npes, req, &pe, &status);
-
-        if(pe != MPI_UNDEFINED) {
-          // Unpack data from processor 'pe'
-          int remote_xorig, remote_yorig;
-          proc_origin(pe, &remote_xorig, &remote_yorig);
-          int remote_xsize, remote_ysize;
-          proc_size(pe, &remote_xsize, &remote_ysize);
-          int zsize = mesh->LocalNz;
-          
-          for(int x=0;x<remote_xsize;x++)
-            for(int y=0;y<remote_ysize;y++)
-              for(int z=0;z<mesh->LocalNz;z++) {
-                (*this)(x+remote_xorig,y+remote_yorig,z) =  buffer[pe][x*remote_ysize*zsize + y*zsize + z];
-              }
-          
-          req[pe] = MPI_REQUEST_NULL;
-        }
-      }while(pe != MPI_UNDEFINED);
+      MPI_Recv(block.begin(), msg_len(p), BOUT_MPI_REAL, p, 3141, comm, &status);
     }
-    delete[] req;
-  }else {
-    // Sending data to proc
-    
-    int local_xorig, local_yorig;
-    proc_local_origin(mype, &local_xorig, &local_yorig);
+
+    int xorig, yorig;
+    proc_origin(p, &xorig, &yorig);
     int xsize, ysize;
-    proc_size(mype, &xsize, &ysize);
-    int zsize = mesh->LocalNz;
-    
-    for(int x=0;x<xsize;x++)
-      for(int y=0;y<ysize;y++)
-        for(int z=0;z<mesh->LocalNz;z++) {
-          buffer[0][x*ysize*zsize + y*zsize + z] = f(local_xorig+x, local_yorig+y, z);
-        }
-    
-    MPI_Send(buffer[0], msg_len(mype), MPI_DOUBLE, data_on_proc, 3141, comm);
+    proc_size(p, &xsize, &ysize);
+    consumer(xorig, yorig, xsize, ysize, mesh->LocalNz, block.begin());
   }
-  data_valid = true;
 }
 
 const Field3D GlobalField3D::scatter() const {
   Field3D result(mesh);
   result.allocate();
-  
-  MPI_Status status;
-  if(mype == data_on_proc) {
-    // Data is on this processor. Send to other processors
-    
-    for(int p = 0; p < npes; p++) {
-      if(p == mype) continue;
-      
+
+  if (mype == data_on_proc) {
+    // Pack each processor's block from the global field
+    for (int p = 0; p < npes; p++) {
       int xorig, yorig;
       proc_origin(p, &xorig, &yorig);
       int xsize, ysize;
       proc_size(p, &xsize, &ysize);
       int zsize = mesh->LocalNz;
-      
-      // Send to processor p
-      for(int x=0;x<xsize;x++)
-        for(int y=0;y<ysize;y++) 
-          for(int z=0;z<zsize;z++) {
-            buffer[p][x*ysize*zsize + y*zsize + z] = (*this)(x+xorig,y+yorig,z);
+      BoutReal *block = recvbuf.begin() + displs[p];
+
+      for (int x = 0; x < xsize; x++)
+        for (int y = 0; y < ysize; y++)
+          for (int z = 0; z < zsize; z++) {
+            block[x * ysize * zsize + y * zsize + z] = (*this)(x + xorig, y + yorig, z);
           }
-      
-      MPI_Send(buffer[p], xsize*ysize*zsize, MPI_DOUBLE, p, 1413, comm);
     }
-
-    int local_xorig, local_yorig;
-    proc_local_origin(mype, &local_xorig, &local_yorig);
-    int xorig, yorig;
-    proc_origin(mype, &xorig, &yorig);
-    int xsize, ysize;
-    proc_size(mype, &xsize, &ysize);
-    int zsize = mesh->LocalNz;
-    
-    // Copy to result
-    for(int x=0;x<xsize;x++)
-      for(int y=0;y<ysize;y++)
-        for(int z=0;z<zsize;z++) {
-          result(local_xorig+x,local_yorig+y,z) = (*this)(x+xorig,y+yorig,z);
-        }
-  }else {
-    // Receive data
-    MPI_Recv(buffer[0], msg_len(mype), MPI_DOUBLE, data_on_proc, 1413, comm, &status);
-    
-    int local_xorig, local_yorig;
-    proc_local_origin(mype, &local_xorig, &local_yorig);
-    int xorig, yorig;
-    proc_origin(mype, &xorig, &yorig);
-    int xsize, ysize;
-    proc_size(mype, &xsize, &ysize);
-    int zsize = mesh->LocalNz;
-    
-    for(int x=0;x<xsize;x++)
-      for(int y=0;y<ysize;y++) 
-        for(int z=0;z<zsize;z++) {
-          result(local_xorig+x,local_yorig+y,z) = buffer[0][x*ysize*zsize + y*zsize + z];
-        }
   }
+
+  MPI_Scatterv(recvbuf.begin(), counts.data(), displs.data(), BOUT_MPI_REAL,
+               sendbuf.begin(), msg_len(mype), BOUT_MPI_REAL, data_on_proc, comm);
+
+  int local_xorig, local_yorig;
+  proc_local_origin(mype, &local_xorig, &local_yorig);
+  int xsize, ysize;
+  proc_size(mype, &xsize, &ysize);
+  int zsize = mesh->LocalNz;
+
+  for (int x = 0; x < xsize; x++)
+    for (int y = 0; y < ysize; y++)
+      for (int z = 0; z < zsize; z++) {
+        result(local_xorig + x, local_yorig + y, z) = sendbuf[x * ysize * zsize + y * zsize + z];
+      }
   return result;
 }
 
@@ -0,0 +1,644 @@
+/**************************************************************************
+ * One-pass reductions over field regions
+ *
+ * See include/bout/reductions.hxx for the API description
+ *
+ **************************************************************************
+ * Copyright 2018 BOUT++ contributors
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+#include <bout/reductions.hxx>
+
+#include <bout/assert.hxx>
+#include <bout/mesh.hxx>
+#include <bout/openmpwrap.hxx>
+#include <bout/region.hxx>
+#include <boutcomm.hxx>
+#include <boutexception.hxx>
+#include <field2d.hxx>
+#include <field3d.hxx>
+#include <msg_stack.hxx>
+#include <options.hxx>
+
+#include "mpi.h"
+
+bool deterministicReductions() {
+  static bool initialised = false;
+  static bool deterministic = false;
+  if (!initialised) {
+    Options::getRoot()->getSection("reductions")->get("deterministic", deterministic,
+                                                      false);
+    initialised = true;
+  }
+  return deterministic;
+}
+
+namespace {
+
+/// Width of the vectorised chunks the deterministic mode accumulates
+/// in. Fixed at compile time so the in-chunk summation order never
+/// changes between runs
+constexpr int det_chunk = 256;
+
+/// Sum \p n partials pairwise in a fixed order. Order depends only on
+/// \p n, and the balanced tree also keeps the rounding error growth
+/// logarithmic in \p n
+double pairwiseSum(const double *p, int n) {
+  if (n <= 8) {
+    double s = 0.;
+    for (int i = 0; i < n; ++i) {
+      s += p[i];
+    }
+    return s;
+  }
+  const int half = n / 2;
+  return pairwiseSum(p, half) + pairwiseSum(p + half, n - half);
+}
+
+/// Allgather each processor's values and sum them pairwise in rank
+/// order, so every processor computes the same bitwise-identical
+/// totals regardless of how the MPI library would tree its reduce
+std::vector<double> deterministicAllSum(const std::vector<double> &local) {
+  int npes;
+  MPI_Comm_size(BoutComm::get(), &npes);
+
+  const int n = local.size();
+  std::vector<double> all(static_cast<size_t>(n) * npes);
+  MPI_Allgather(const_cast<double *>(local.data()), n, MPI_DOUBLE, all.data(), n,
+                MPI_DOUBLE, BoutComm::get());
+
+  std::vector<double> result(n);
+  std::vector<double> partials(npes);
+  for (int j = 0; j < n; j++) {
+    for (int r = 0; r < npes; r++) {
+      partials[r] = all[static_cast<size_t>(r) * n + j];
+    }
+    result[j] = pairwiseSum(partials.data(), npes);
+  }
+  return result;
+}
+
+/// Compensated (Kahan) addition: add \p value to \p sum, carrying the
+/// rounding error in \p comp so long sums don't drift
+inline void kahanAdd(double &sum, double &comp, double value) {
+  double y = value - comp;
+  double t = sum + y;
+  comp = (t - sum) - y;
+  sum = t;
+}
+
+/// Deterministic one-pass local reduction: each region block is
+/// reduced independently (vectorised over fixed-size chunks whose
+/// partials are added in order), and the per-block partials are
+/// combined pairwise in block order afterwards. Blocks are a fixed
+/// property of the region, so the summation order - and hence the
+/// bits of the result - do not depend on the thread count or on how
+/// the OpenMP runtime interleaves the threads
+template <typename FieldType, typename IndexType>
+FieldReduction reduceLocalDeterministic(const FieldType &f,
+                                        const Region<IndexType> &region) {
+  FieldReduction out;
+  out.sum = 0.;
+  out.sum2 = 0.;
+  out.count = region.size();
+
+  if (out.count == 0) {
+    out.min = 0.;
+    out.max = 0.;
+    return out;
+  }
+
+  const auto &blocks = region.getBlocks();
+  const int nb = blocks.size();
+
+  std::vector<double> bsum(nb), bsum2(nb);
+  std::vector<BoutReal> bmn(nb), bmx(nb);
+
+  BOUT_OMP(parallel for schedule(static))
+  for (int ib = 0; ib < nb; ++ib) {
+    const int istart = blocks[ib].first.ind;
+    const int iend = blocks[ib].second.ind;
+
+    BoutReal mn = f[IndexType(istart)];
+    BoutReal mx = mn;
+    double sum = 0., sum2 = 0.;
+
+    for (int cs = istart; cs < iend; cs += det_chunk) {
+      const int ce = (cs + det_chunk < iend) ? cs + det_chunk : iend;
+      double csum = 0., csum2 = 0.;
+
+      BOUT_OMP(simd reduction(+ : csum, csum2) reduction(min : mn) reduction(max : mx))
+      for (int i = cs; i < ce; ++i) {
+        const double val = f[IndexType(i)];
+        csum += val;
+        csum2 += val * val;
+        mn = (val < mn) ? BoutReal(val) : mn;
+        mx = (val > mx) ? BoutReal(val) : mx;
+      }
+
+      sum += csum;
+      sum2 += csum2;
+    }
+
+    bsum[ib] = sum;
+    bsum2[ib] = sum2;
+    bmn[ib] = mn;
+    bmx[ib] = mx;
+  }
+
+  out.min = bmn[0];
+  out.max = bmx[0];
+  for (int ib = 1; ib < nb; ++ib) {
+    if (bmn[ib] < out.min) {
+      out.min = bmn[ib];
+    }
+    if (bmx[ib] > out.max) {
+      out.max = bmx[ib];
+    }
+  }
+  out.sum = pairwiseSum(bsum.data(), nb);
+  out.sum2 = pairwiseSum(bsum2.data(), nb);
+  return out;
+}
+
+/// Deterministic counterpart of reduceLocalFused below: per-block,
+/// per-field partials combined pairwise in block order
+template <typename FieldType, typename IndexType>
+std::vector<FieldReduction>
+reduceLocalFusedDeterministic(const std::vector<const FieldType *> &fields,
+                              const Region<IndexType> &region) {
+  const int nf = static_cast<int>(fields.size());
+  const int npoints = region.size();
+
+  std::vector<FieldReduction> out(nf);
+  for (int j = 0; j < nf; j++) {
+    out[j].min = 0.;
+    out[j].max = 0.;
+    out[j].sum = 0.;
+    out[j].sum2 = 0.;
+    out[j].count = npoints;
+  }
+
+  if ((nf == 0) || (npoints == 0)) {
+    return out;
+  }
+
+  const auto &blocks = region.getBlocks();
+  const int nb = blocks.size();
+
+  // Partials indexed [field][block], so each field's block partials
+  // are contiguous for the pairwise combine
+  std::vector<double> bsum(static_cast<size_t>(nf) * nb), bsum2(bsum.size());
+  std::vector<BoutReal> bmn(bsum.size()), bmx(bsum.size());
+
+  BOUT_OMP(parallel for schedule(static))
+  for (int ib = 0; ib < nb; ++ib) {
+    const int istart = blocks[ib].first.ind;
+    const int iend = blocks[ib].second.ind;
+
+    for (int j = 0; j < nf; j++) {
+      const FieldType &f = *fields[j];
+
+      BoutReal mn = f[IndexType(istart)];
+      BoutReal mx = mn;
+      double sum = 0., sum2 = 0.;
+
+      for (int cs = istart; cs < iend; cs += det_chunk) {
+        const int ce = (cs + det_chunk < iend) ? cs + det_chunk : iend;
+        double csum = 0., csum2 = 0.;
+
+        BOUT_OMP(simd reduction(+ : csum, csum2) reduction(min : mn) reduction(max : mx))
+        for (int i = cs; i < ce; ++i) {
+          const double val = f[IndexType(i)];
+          csum += val;
+          csum2 += val * val;
+          mn = (val < mn) ? BoutReal(val) : mn;
+          mx = (val > mx) ? BoutReal(val) : mx;
+        }
+
+        sum += csum;
+        sum2 += csum2;
+      }
+
+      bsum[static_cast<size_t>(j) * nb + ib] = sum;
+      bsum2[static_cast<size_t>(j) * nb + ib] = sum2;
+      bmn[static_cast<size_t>(j) * nb + ib] = mn;
+      bmx[static_cast<size_t>(j) * nb + ib] = mx;
+    }
+  }
+
+  for (int j = 0; j < nf; j++) {
+    const size_t o = static_cast<size_t>(j) * nb;
+    out[j].min = bmn[o];
+    out[j].max = bmx[o];
+    for (int ib = 1; ib < nb; ++ib) {
+      if (bmn[o + ib] < out[j].min) {
+        out[j].min = bmn[o + ib];
+      }
+      if (bmx[o + ib] > out[j].max) {
+        out[j].max = bmx[o + ib];
+      }
+    }
+    out[j].sum = pairwiseSum(&bsum[o], nb);
+    out[j].sum2 = pairwiseSum(&bsum2[o], nb);
+  }
+  return out;
+}
+
+/// One-pass local reduction of \p f over \p region. The loop over each
+/// contiguous block is vectorised with plain double accumulators; the
+/// per-block partial sums are then folded into the running totals with
+/// compensated addition, so the vectorisation doesn't cost accuracy
+template <typename FieldType, typename IndexType>
+FieldReduction reduceLocal(const FieldType &f, const Region<IndexType> &region) {
+  if (deterministicReductions()) {
+    return reduceLocalDeterministic(f, region);
+  }
+
+  FieldReduction out;
+  out.sum = 0.;
+  out.sum2 = 0.;
+  out.count = region.size();
+
+  if (out.count == 0) {
+    out.min = 0.;
+    out.max = 0.;
+    return out;
+  }
+
+  BoutReal gmin = f[*region.cbegin()];
+  BoutReal gmax = gmin;
+  double gsum = 0., gsum_c = 0.;
+  double gsum2 = 0., gsum2_c = 0.;
+
+  BOUT_OMP(parallel) {
+    BoutReal tmin = gmin;
+    BoutReal tmax = gmax;
+    double tsum = 0., tsum_c = 0.;
+    double tsum2 = 0., tsum2_c = 0.;
+
+    BOUT_OMP(for schedule(OPENMP_SCHEDULE) nowait)
+    for (auto block = region.getBlocks().cbegin(); block < region.getBlocks().cend();
+         ++block) {
+      const int istart = block->first.ind;
+      const int iend = block->second.ind;
+
+      BoutReal bmin = tmin;
+      BoutReal bmax = tmax;
+      double bsum = 0., bsum2 = 0.;
+
+      BOUT_OMP(simd reduction(+ : bsum, bsum2) reduction(min : bmin) reduction(max : bmax))
+      for (int i = istart; i < iend; ++i) {
+        const double val = f[IndexType(i)];
+        bsum += val;
+        bsum2 += val * val;
+        bmin = (val < bmin) ? BoutReal(val) : bmin;
+        bmax = (val > bmax) ? BoutReal(val) : bmax;
+      }
+
+      tmin = bmin;
+      tmax = bmax;
+      kahanAdd(tsum, tsum_c, bsum);
+      kahanAdd(tsum2, tsum2_c, bsum2);
+    }
+
+    BOUT_OMP(critical(reduceLocal)) {
+      if (tmin < gmin) {
+        gmin = tmin;
+      }
+      if (tmax > gmax) {
+        gmax = tmax;
+      }
+      kahanAdd(gsum, gsum_c, tsum);
+      kahanAdd(gsum2, gsum2_c, tsum2);
+    }
+  }
+
+  out.min = gmin;
+  out.max = gmax;
+  out.sum = gsum;
+  out.sum2 = gsum2;
+  return out;
+}
+
+/// One-pass fused local reduction of several fields over the same
+/// region: the region's index blocks are traversed once, with each
+/// field reduced over the block while it is hot in cache. Compared to
+/// reducing the fields one at a time this shares the traversal
+/// overhead between all the fields, which matters when a monitor
+/// reduces a dozen small quantities at high output cadence
+template <typename FieldType, typename IndexType>
+std::vector<FieldReduction>
+reduceLocalFused(const std::vector<const FieldType *> &fields,
+                 const Region<IndexType> &region) {
+  if (deterministicReductions()) {
+    return reduceLocalFusedDeterministic(fields, region);
+  }
+
+  const int nf = static_cast<int>(fields.size());
+  const int npoints = region.size();
+
+  std::vector<FieldReduction> out(nf);
+  for (int j = 0; j < nf; j++) {
+    out[j].min = 0.;
+    out[j].max = 0.;
+    out[j].sum = 0.;
+    out[j].sum2 = 0.;
+    out[j].count = npoints;
+  }
+
+  if ((nf == 0) || (npoints == 0)) {
+    return out;
+  }
+
+  const IndexType first = *region.cbegin();
+  std::vector<BoutReal> gmin(nf), gmax(nf);
+  std::vector<double> gsum(nf, 0.), gsum_c(nf, 0.);
+  std::vector<double> gsum2(nf, 0.), gsum2_c(nf, 0.);
+  for (int j = 0; j < nf; j++) {
+    gmin[j] = gmax[j] = (*fields[j])[first];
+  }
+
+  BOUT_OMP(parallel) {
+    std::vector<BoutReal> tmin(gmin), tmax(gmax);
+    std::vector<double> tsum(nf, 0.), tsum_c(nf, 0.);
+    std::vector<double> tsum2(nf, 0.), tsum2_c(nf, 0.);
+
+    BOUT_OMP(for schedule(OPENMP_SCHEDULE) nowait)
+    for (auto block = region.getBlocks().cbegin(); block < region.getBlocks().cend();
+         ++block) {
+      const int istart = block->first.ind;
+      const int iend = block->second.ind;
+
+      for (int j = 0; j < nf; j++) {
+        const FieldType &f = *fields[j];
+
+        BoutReal bmin = tmin[j];
+        BoutReal bmax = tmax[j];
+        double bsum = 0., bsum2 = 0.;
+
+        BOUT_OMP(simd reduction(+ : bsum, bsum2) reduction(min : bmin) reduction(max : bmax))
+        for (int i = istart; i < iend; ++i) {
+          const double val = f[IndexType(i)];
+          bsum += val;
+          bsum2 += val * val;
+          bmin = (val < bmin) ? BoutReal(val) : bmin;
+          bmax = (val > bmax) ? BoutReal(val) : bmax;
+        }
+
+        tmin[j] = bmin;
+        tmax[j] = bmax;
+        kahanAdd(tsum[j], tsum_c[j], bsum);
+        kahanAdd(tsum2[j], tsum2_c[j], bsum2);
+      }
+    }
+
+    BOUT_OMP(critical(reduceLocalFused)) {
+      for (int j = 0; j < nf; j++) {
+        if (tmin[j] < gmin[j]) {
+          gmin[j] = tmin[j];
+        }
+        if (tmax[j] > gmax[j]) {
+          gmax[j] = tmax[j];
+        }
+        kahanAdd(gsum[j], gsum_c[j], tsum[j]);
+        kahanAdd(gsum2[j], gsum2_c[j], tsum2[j]);
+      }
+    }
+  }
+
+  for (int j = 0; j < nf; j++) {
+    out[j].min = gmin[j];
+    out[j].max = gmax[j];
+    out[j].sum = gsum[j];
+    out[j].sum2 = gsum2[j];
+  }
+  return out;
+}
+
+/// Resolve a set of local reductions across processors. However many
+/// fields are batched, this costs exactly two MPI_Allreduce calls:
+/// MPI has no mixed-operation reduce, so the extrema travel together
+/// in an MPI_MAX call (with the minima negated) and the sums and
+/// counts in an MPI_SUM call
+void resolve(std::vector<FieldReduction> &reductions) {
+  const int n = reductions.size();
+
+  std::vector<double> local_extrema(2 * n), extrema(2 * n);
+  std::vector<double> local_sums(3 * n), sums(3 * n);
+  for (int i = 0; i < n; i++) {
+    local_extrema[2 * i] = reductions[i].max;
+    local_extrema[2 * i + 1] = -static_cast<double>(reductions[i].min);
+    local_sums[3 * i] = reductions[i].sum;
+    local_sums[3 * i + 1] = reductions[i].sum2;
+    local_sums[3 * i + 2] = reductions[i].count;
+  }
+
+  MPI_Allreduce(local_extrema.data(), extrema.data(), 2 * n, MPI_DOUBLE, MPI_MAX,
+                BoutComm::get());
+  if (deterministicReductions()) {
+    // The extrema are order-independent, but the sum order must be
+    // pinned down for bitwise reproducibility
+    sums = deterministicAllSum(local_sums);
+  } else {
+    MPI_Allreduce(local_sums.data(), sums.data(), 3 * n, MPI_DOUBLE, MPI_SUM,
+                  BoutComm::get());
+  }
+
+  for (int i = 0; i < n; i++) {
+    reductions[i].max = extrema[2 * i];
+    reductions[i].min = -extrema[2 * i + 1];
+    reductions[i].sum = sums[3 * i];
+    reductions[i].sum2 = sums[3 * i + 1];
+    reductions[i].count = static_cast<int>(sums[3 * i + 2]);
+  }
+}
+
+} // namespace
+
+FieldReduction reduce(const Field3D &f, REGION rgn, bool allpe) {
+  TRACE("reduce(Field3D) %s", allpe ? "over all PEs" : "");
+
+  checkData(f);
+
+  FieldReduction result =
+      reduceLocal(f, f.getMesh()->getRegion3D(REGION_STRING(rgn)));
+
+  if (allpe) {
+    std::vector<FieldReduction> tmp(1, result);
+    resolve(tmp);
+    result = tmp[0];
+  }
+
+  return result;
+}
+
+FieldReduction reduce(const Field2D &f, REGION rgn, bool allpe) {
+  TRACE("reduce(Field2D) %s", allpe ? "over all PEs" : "");
+
+  checkData(f);
+
+  FieldReduction result =
+      reduceLocal(f, f.getMesh()->getRegion2D(REGION_STRING(rgn)));
+
+  if (allpe) {
+    std::vector<FieldReduction> tmp(1, result);
+    resolve(tmp);
+    result = tmp[0];
+  }
+
+  return result;
+}
+
+std::vector<FieldReduction> reduce(const std::vector<const Field3D *> &fields,
+                                   REGION rgn, bool allpe) {
+  TRACE("reduce(vector<Field3D*>) %s", allpe ? "over all PEs" : "");
+
+  std::vector<FieldReduction> results = reduceLocal(fields, rgn);
+
+  if (allpe && !results.empty()) {
+    resolve(results);
+  }
+
+  return results;
+}
+
+std::vector<FieldReduction> reduceLocal(const std::vector<const Field3D *> &fields,
+                                        REGION rgn) {
+  TRACE("reduceLocal(vector<Field3D*>)");
+
+  if (fields.empty()) {
+    return {};
+  }
+
+  Mesh *mesh = fields[0]->getMesh();
+  for (const Field3D *f : fields) {
+    ASSERT1(f != nullptr);
+    ASSERT1(f->getMesh() == mesh);
+    checkData(*f);
+  }
+
+  return reduceLocalFused(fields, mesh->getRegion3D(REGION_STRING(rgn)));
+}
+
+std::vector<FieldReduction> reduceLocal(const std::vector<const Field2D *> &fields,
+                                        REGION rgn) {
+  TRACE("reduceLocal(vector<Field2D*>)");
+
+  if (fields.empty()) {
+    return {};
+  }
+
+  Mesh *mesh = fields[0]->getMesh();
+  for (const Field2D *f : fields) {
+    ASSERT1(f != nullptr);
+    ASSERT1(f->getMesh() == mesh);
+    checkData(*f);
+  }
+
+  return reduceLocalFused(fields, mesh->getRegion2D(REGION_STRING(rgn)));
+}
+
+void resolveReductions(std::vector<FieldReduction> &reductions) {
+  TRACE("resolveReductions()");
+
+  if (!reductions.empty()) {
+    resolve(reductions);
+  }
+}
+
+/////////////////////////////////////////////////////////////////////
+// ReductionBatch
+
+namespace {
+
+/// Resolve one operation kind: pack the pending values in map order
+/// (identical on every processor, since std::map iterates sorted by
+/// name), make a single MPI_Allreduce, and unpack into \p results
+void gatherOp(std::map<std::string, double> &pending, MPI_Op op,
+              std::map<std::string, double> &results) {
+  if (pending.empty()) {
+    return;
+  }
+
+  std::vector<double> local;
+  local.reserve(pending.size());
+  for (const auto &it : pending) {
+    local.push_back(it.second);
+  }
+
+  std::vector<double> global(local.size());
+  if (deterministicReductions() && (op == MPI_SUM)) {
+    global = deterministicAllSum(local);
+  } else {
+    MPI_Allreduce(local.data(), global.data(), local.size(), MPI_DOUBLE, op,
+                  BoutComm::get());
+  }
+
+  int i = 0;
+  for (const auto &it : pending) {
+    results[it.first] = global[i++];
+  }
+  pending.clear();
+}
+
+} // namespace
+
+void ReductionBatch::sum(const std::string &name, double local) {
+  auto it = pending_sum.find(name);
+  if (it == pending_sum.end()) {
+    pending_sum[name] = local;
+  } else {
+    it->second += local;
+  }
+}
+
+void ReductionBatch::min(const std::string &name, double local) {
+  auto it = pending_min.find(name);
+  if ((it == pending_min.end()) || (local < it->second)) {
+    pending_min[name] = local;
+  }
+}
+
+void ReductionBatch::max(const std::string &name, double local) {
+  auto it = pending_max.find(name);
+  if ((it == pending_max.end()) || (local > it->second)) {
+    pending_max[name] = local;
+  }
+}
+
+void ReductionBatch::gather() {
+  TRACE("ReductionBatch::gather()");
+
+  gatherOp(pending_sum, MPI_SUM, results);
+  gatherOp(pending_min, MPI_MIN, results);
+  gatherOp(pending_max, MPI_MAX, results);
+}
+
+double ReductionBatch::get(const std::string &name) const {
+  auto it = results.find(name);
+  if (it == results.end()) {
+    throw BoutException("ReductionBatch: no resolved value for '%s'. "
+                        "Was gather() called after registering it?",
+                        name.c_str());
+  }
+  return it->second;
+}
@@ -91,9 +91,15 @@ const Vector3D Grad(const Field3D &f, CELL_LOC outloc) {
 
   Vector3D result(f.getMesh());
 
-  result.x = DDX(f, outloc_x);
-  result.y = DDY(f, outloc_y);
-  result.z = DDZ(f, outloc_z);
+  if (outloc == CELL_VSHIFT) {
+    result.x = DDX(f, outloc_x);
+    result.y = DDY(f, outloc_y);
+    result.z = DDZ(f, outloc_z);
+  } else {
+    // All three components at the same location: compute them in a
+    // single traversal of f
+    gradAll(f, result.x, result.y, result.z, outloc);
+  }
 
   if (outloc == CELL_DEFAULT) {
     result.setLocation(result.x.getLocation());
@@ -122,13 +128,27 @@ const Vector3D Grad_perp(const Field3D &f, CELL_LOC outloc) {
 
   Coordinates *metric = f.getCoordinates(outloc);
 
-  Vector3D result(f.getMesh());
+  Mesh *localmesh = f.getMesh();
+  Vector3D result(localmesh);
+
+  const Field3D dfdx = DDX(f, outloc);
+  const Field3D dfdy = DDY(f, outloc); // Shared by the x and z components
+  const Field3D dfdz = DDZ(f, outloc);
+
+  result.x.allocate();
+  result.z.allocate();
 
-  result.x = DDX(f, outloc) - metric->g_12 * DDY(f, outloc) / SQ(metric->J * metric->Bxy);
+  // Form both components in one pass, sharing the Y derivative and
+  // the 1/(JB)^2 factor rather than re-deriving them per component
+  BOUT_FOR(i, localmesh->getRegion3D("RGN_ALL")) {
+    const auto i2 = localmesh->ind3Dto2D(i);
+    const BoutReal coef = dfdy[i] / SQ(metric->J[i2] * metric->Bxy[i2]);
+    result.x[i] = dfdx[i] - metric->g_12[i2] * coef;
+    result.z[i] = dfdz[i] - metric->g_23[i2] * coef;
+  }
   result.y = 0.0;
-  result.z = DDZ(f, outloc) - metric->g_23 * DDY(f, outloc) / SQ(metric->J * metric->Bxy);
 
-  result.setLocation(result.x.getLocation());
+  result.setLocation(dfdx.getLocation());
 
   result.covariant = true;
 
@@ -156,15 +176,52 @@ const Field2D Div(const Vector2D &v, CELL_LOC outloc) {
   // get contravariant components of v
   Vector2D vcn = v;
   vcn.toContravariant();
-  
-  result = DDX(metric->J*vcn.x, outloc);
-  result += DDY(metric->J*vcn.y, outloc);
-  result += DDZ(metric->J*vcn.z, outloc);
-  result /= metric->J;
+
+  const Field2D dfx = DDX(metric->J * vcn.x, outloc);
+  const Field2D dfy = DDY(metric->J * vcn.y, outloc);
+  const Field2D dfz = DDZ(metric->J * vcn.z, outloc);
+
+  result.allocate();
+  result.setLocation(dfx.getLocation());
+
+  // Sum the flux derivatives and divide by J in a single pass, rather
+  // than three read-modify-write sweeps over the result
+  BOUT_FOR(i, localmesh->getRegion2D("RGN_ALL")) {
+    result[i] = (dfx[i] + dfy[i] + dfz[i]) / metric->J[i];
+  }
 
   return result;
 }
 
+namespace {
+
+/// Divergence of a vector whose components \p vcn are already
+/// contravariant. Shared by the lvalue and rvalue forms of Div(Vector3D)
+Field3D divContravariant(const Vector3D &vcn, CELL_LOC outloc) {
+  Mesh *localmesh = vcn.x.getMesh();
+
+  Coordinates *metric = localmesh->getCoordinates(outloc);
+
+  const Field3D dfx = DDX(vcn.x.getCoordinates()->J * vcn.x, outloc);
+  const Field3D dfy = DDY(vcn.y.getCoordinates()->J * vcn.y, outloc);
+  const Field3D dfz = DDZ(vcn.z.getCoordinates()->J * vcn.z, outloc);
+
+  Field3D result(localmesh);
+  result.allocate();
+  result.setLocation(dfx.getLocation());
+
+  // Sum the flux derivatives and divide by J in a single pass, rather
+  // than three read-modify-write sweeps over the result
+  BOUT_FOR(i, localmesh->getRegion3D("RGN_ALL")) {
+    const auto i2 = localmesh->ind3Dto2D(i);
+    result[i] = (dfx[i] + dfy[i] + dfz[i]) / metric->J[i2];
+  }
+
+  return result;
+}
+
+} // namespace
+
 const Field3D Div(const Vector3D &v, CELL_LOC outloc) {
   TRACE("Div( Vector3D )");
 
@@ -175,21 +232,27 @@ const Field3D Div(const Vector3D &v, CELL_LOC outloc) {
   // This also catches the combination of v at VSHIFT and outloc at DEFAULT
   ASSERT1(outloc != CELL_VSHIFT);
 
-  Mesh *localmesh = v.x.getMesh();
-  Field3D result(localmesh);
-
-  Coordinates *metric = localmesh->getCoordinates(outloc);
-
   // get contravariant components of v
   Vector3D vcn = v;
   vcn.toContravariant();
 
-  result = DDX(vcn.x.getCoordinates()->J * vcn.x, outloc);
-  result += DDY(vcn.y.getCoordinates()->J * vcn.y, outloc);
-  result += DDZ(vcn.z.getCoordinates()->J * vcn.z, outloc);
-  result /= metric->J;
+  return divContravariant(vcn, outloc);
+}
 
-  return result;
+const Field3D Div(Vector3D &&v, CELL_LOC outloc) {
+  TRACE("Div( Vector3D&& )");
+
+  if (outloc == CELL_DEFAULT) {
+    outloc = v.getLocation();
+  }
+
+  ASSERT1(outloc != CELL_VSHIFT);
+
+  // Convert in place, reusing the temporary's storage instead of
+  // copying all three components
+  v.toContravariant();
+
+  return divContravariant(v, outloc);
 }
 
 /**************************************************************************
@@ -274,14 +337,27 @@ const Vector2D Curl(const Vector2D &v) {
   Vector2D vco = v;
   vco.toCovariant();
 
-  // get components (curl(v))^j
-  Vector2D result(localmesh);
-  result.x = (DDY(vco.z) - DDZ(vco.y)) / metric->J;
-  result.y = (DDZ(vco.x) - DDX(vco.z)) / metric->J;
-  result.z = (DDX(vco.y) - DDY(vco.x)) / metric->J;
+  const Field2D dvz_dy = DDY(vco.z);
+  const Field2D dvy_dz = DDZ(vco.y);
+  const Field2D dvx_dz = DDZ(vco.x);
+  const Field2D dvz_dx = DDX(vco.z);
+  const Field2D dvy_dx = DDX(vco.y);
+  const Field2D dvx_dy = DDY(vco.x);
 
-  /// Coordinate torsion
-  result.z -= metric->ShiftTorsion * vco.z / metric->J;
+  // get components (curl(v))^j, all three in one pass so 1/J (and the
+  // torsion correction) is read once per point
+  Vector2D result(localmesh);
+  result.x.allocate();
+  result.y.allocate();
+  result.z.allocate();
+
+  BOUT_FOR(i, localmesh->getRegion2D("RGN_ALL")) {
+    const BoutReal invJ = 1.0 / metric->J[i];
+    result.x[i] = (dvz_dy[i] - dvy_dz[i]) * invJ;
+    result.y[i] = (dvx_dz[i] - dvz_dx[i]) * invJ;
+    // Includes the coordinate torsion correction
+    result.z[i] = (dvy_dx[i] - dvx_dy[i] - metric->ShiftTorsion[i] * vco.z[i]) * invJ;
+  }
 
   result.setLocation(v.getLocation());
 
@@ -290,32 +366,68 @@ const Vector2D Curl(const Vector2D &v) {
   return result;
 }
 
+namespace {
+
+/// Curl of a vector whose components \p vco are already covariant.
+/// Shared by the lvalue and rvalue forms of Curl(Vector3D)
+Vector3D curlCovariant(const Vector3D &vco) {
+  Mesh *localmesh = vco.x.getMesh();
+  auto metric = vco.x.getCoordinates();
+
+  const Field3D dvz_dy = DDY(vco.z);
+  const Field3D dvy_dz = DDZ(vco.y);
+  const Field3D dvx_dz = DDZ(vco.x);
+  const Field3D dvz_dx = DDX(vco.z);
+  const Field3D dvy_dx = DDX(vco.y);
+  const Field3D dvx_dy = DDY(vco.x);
+
+  // get components (curl(v))^j, all three in one pass so 1/J (and the
+  // torsion correction) is read once per point
+  Vector3D result(localmesh);
+  result.x.allocate();
+  result.y.allocate();
+  result.z.allocate();
+
+  BOUT_FOR(i, localmesh->getRegion3D("RGN_ALL")) {
+    const auto i2 = localmesh->ind3Dto2D(i);
+    const BoutReal invJ = 1.0 / metric->J[i2];
+    result.x[i] = (dvz_dy[i] - dvy_dz[i]) * invJ;
+    result.y[i] = (dvx_dz[i] - dvz_dx[i]) * invJ;
+    // Includes the coordinate torsion correction
+    result.z[i] = (dvy_dx[i] - dvx_dy[i] - metric->ShiftTorsion[i2] * vco.z[i]) * invJ;
+  }
+
+  result.setLocation(vco.getLocation());
+
+  result.covariant = false; // result is contravariant
+
+  return result;
+}
+
+} // namespace
+
 const Vector3D Curl(const Vector3D &v) {
   TRACE("Curl( Vector3D )");
 
   ASSERT1(v.getLocation() != CELL_VSHIFT);
 
-  Mesh *localmesh = v.x.getMesh();
-  auto metric = v.x.getCoordinates();
-
   // Get covariant components of v
   Vector3D vco = v;
   vco.toCovariant();
 
-  // get components (curl(v))^j
-  Vector3D result(localmesh);
-  result.x = (DDY(vco.z) - DDZ(vco.y)) / metric->J;
-  result.y = (DDZ(vco.x) - DDX(vco.z)) / metric->J;
-  result.z = (DDX(vco.y) - DDY(vco.x)) / metric->J;
+  return curlCovariant(vco);
+}
 
-  // Coordinate torsion
-  result.z -= metric->ShiftTorsion * vco.z / metric->J;
+const Vector3D Curl(Vector3D &&v) {
+  TRACE("Curl( Vector3D&& )");
 
-  result.setLocation(v.getLocation());
+  ASSERT1(v.getLocation() != CELL_VSHIFT);
 
-  result.covariant = false; // result is contravariant
+  // Convert in place, reusing the temporary's storage instead of
+  // copying all three components
+  v.toCovariant();
 
-  return result;
+  return curlCovariant(v);
 }
 
 /**************************************************************************
@@ -372,59 +484,101 @@ const Field3D V_dot_Grad(const Vector3D &v, const Field3D &f) {
   // Get contravariant components of v
   Vector3D vcn = v;
   vcn.toContravariant();
-  
+
   result = VDDX(vcn.x, f) + VDDY(vcn.y, f) + VDDZ(vcn.z, f);
 
   return result;
 }
 
+const Field3D V_dot_Grad(Vector3D &&v, const Field3D &f) {
+  TRACE("V_dot_Grad( Vector3D&& , Field3D )");
+
+  // Convert in place, reusing the temporary's storage instead of
+  // copying all three components
+  v.toContravariant();
+
+  return VDDX(v.x, f) + VDDY(v.y, f) + VDDZ(v.z, f);
+}
+
 const Vector2D V_dot_Grad(const Vector2D &v, const Vector2D &a) {
   TRACE("V_dot_Grad( Vector2D , Vector2D )");
 
   ASSERT1(v.getLocation() == a.getLocation());
   ASSERT1(v.getLocation() != CELL_VSHIFT);
 
-  Vector2D result{v.x.getMesh()};
+  Mesh *localmesh = v.x.getMesh();
+  Vector2D result{localmesh};
 
   auto metric = v.x.getCoordinates();
 
   Vector2D vcn = v;
   vcn.toContravariant();
 
-  if (a.covariant) {
-
-    result.x = VDDX(vcn.x, a.x) + VDDY(vcn.y, a.x) + VDDZ(vcn.z, a.x);
-    result.x -= vcn.x * (metric->G1_11 * a.x + metric->G2_11 * a.y + metric->G3_11 * a.z);
-    result.x -= vcn.y * (metric->G1_12 * a.x + metric->G2_12 * a.y + metric->G3_12 * a.z);
-    result.x -= vcn.z * (metric->G1_13 * a.x + metric->G2_13 * a.y + metric->G3_13 * a.z);
+  // The nine advection derivatives need the full mesh derivative
+  // machinery; the Christoffel symbol corrections below are pointwise
+  // and are fused into a single pass over the data
+  const Field2D advx_ax = VDDX(vcn.x, a.x);
+  const Field2D advy_ax = VDDY(vcn.y, a.x);
+  const Field2D advz_ax = VDDZ(vcn.z, a.x);
+  const Field2D advx_ay = VDDX(vcn.x, a.y);
+  const Field2D advy_ay = VDDY(vcn.y, a.y);
+  const Field2D advz_ay = VDDZ(vcn.z, a.y);
+  const Field2D advx_az = VDDX(vcn.x, a.z);
+  const Field2D advy_az = VDDY(vcn.y, a.z);
+  const Field2D advz_az = VDDZ(vcn.z, a.z);
+
+  result.x.allocate();
+  result.y.allocate();
+  result.z.allocate();
 
-    result.y = VDDX(vcn.x, a.y) + VDDY(vcn.y, a.y) + VDDZ(vcn.z, a.y);
-    result.y -= vcn.x * (metric->G1_12 * a.x + metric->G2_12 * a.y + metric->G3_12 * a.z);
-    result.y -= vcn.y * (metric->G1_22 * a.x + metric->G2_22 * a.y + metric->G3_22 * a.z);
-    result.y -= vcn.z * (metric->G1_23 * a.x + metric->G2_23 * a.y + metric->G3_23 * a.z);
-
-    result.z = VDDX(vcn.x, a.z) + VDDY(vcn.y, a.z) + VDDZ(vcn.z, a.z);
-    result.z -= vcn.x * (metric->G1_13 * a.x + metric->G2_13 * a.y + metric->G3_13 * a.z);
-    result.z -= vcn.y * (metric->G1_23 * a.x + metric->G2_23 * a.y + metric->G3_23 * a.z);
-    result.z -= vcn.z * (metric->G1_33 * a.x + metric->G2_33 * a.y + metric->G3_33 * a.z);
+  if (a.covariant) {
+    BOUT_FOR(i, localmesh->getRegion2D("RGN_ALL")) {
+      const BoutReal vx = vcn.x[i], vy = vcn.y[i], vz = vcn.z[i];
+      const BoutReal ax = a.x[i], ay = a.y[i], az = a.z[i];
+
+      result.x[i] =
+          advx_ax[i] + advy_ax[i] + advz_ax[i]
+          - vx * (metric->G1_11[i] * ax + metric->G2_11[i] * ay + metric->G3_11[i] * az)
+          - vy * (metric->G1_12[i] * ax + metric->G2_12[i] * ay + metric->G3_12[i] * az)
+          - vz * (metric->G1_13[i] * ax + metric->G2_13[i] * ay + metric->G3_13[i] * az);
+
+      result.y[i] =
+          advx_ay[i] + advy_ay[i] + advz_ay[i]
+          - vx * (metric->G1_12[i] * ax + metric->G2_12[i] * ay + metric->G3_12[i] * az)
+          - vy * (metric->G1_22[i] * ax + metric->G2_22[i] * ay + metric->G3_22[i] * az)
+          - vz * (metric->G1_23[i] * ax + metric->G2_23[i] * ay + metric->G3_23[i] * az);
+
+      result.z[i] =
+          advx_az[i] + advy_az[i] + advz_az[i]
+          - vx * (metric->G1_13[i] * ax + metric->G2_13[i] * ay + metric->G3_13[i] * az)
+          - vy * (metric->G1_23[i] * ax + metric->G2_23[i] * ay + metric->G3_23[i] * az)
+          - vz * (metric->G1_33[i] * ax + metric->G2_33[i] * ay + metric->G3_33[i] * az);
+    }
 
     result.covariant = true;
   } else {
-
-    result.x = VDDX(vcn.x, a.x) + VDDY(vcn.y, a.x) + VDDZ(vcn.z, a.x);
-    result.x += vcn.x * (metric->G1_11 * a.x + metric->G1_12 * a.y + metric->G1_13 * a.z);
-    result.x += vcn.y * (metric->G1_12 * a.x + metric->G1_22 * a.y + metric->G1_23 * a.z);
-    result.x += vcn.z * (metric->G1_13 * a.x + metric->G1_23 * a.y + metric->G1_33 * a.z);
-
-    result.y = VDDX(vcn.x, a.y) + VDDY(vcn.y, a.y) + VDDZ(vcn.z, a.y);
-    result.y += vcn.x * (metric->G2_11 * a.x + metric->G2_12 * a.y + metric->G2_13 * a.z);
-    result.y += vcn.y * (metric->G2_12 * a.x + metric->G2_22 * a.y + metric->G2_23 * a.z);
-    result.y += vcn.z * (metric->G2_13 * a.x + metric->G2_23 * a.y + metric->G2_33 * a.z);
-
-    result.z = VDDX(vcn.x, a.z) + VDDY(vcn.y, a.z) + VDDZ(vcn.z, a.z);
-    result.z += vcn.x * (metric->G3_11 * a.x + metric->G3_12 * a.y + metric->G3_13 * a.z);
-    result.z += vcn.y * (metric->G3_12 * a.x + metric->G3_22 * a.y + metric->G3_23 * a.z);
-    result.z += vcn.z * (metric->G3_13 * a.x + metric->G3_23 * a.y + metric->G3_33 * a.z);
+    BOUT_FOR(i, localmesh->getRegion2D("RGN_ALL")) {
+      const BoutReal vx = vcn.x[i], vy = vcn.y[i], vz = vcn.z[i];
+      const BoutReal ax = a.x[i], ay = a.y[i], az = a.z[i];
+
+      result.x[i] =
+          advx_ax[i] + advy_ax[i] + advz_ax[i]
+          + vx * (metric->G1_11[i] * ax + metric->G1_12[i] * ay + metric->G1_13[i] * az)
+          + vy * (metric->G1_12[i] * ax + metric->G1_22[i] * ay + metric->G1_23[i] * az)
+          + vz * (metric->G1_13[i] * ax + metric->G1_23[i] * ay + metric->G1_33[i] * az);
+
+      result.y[i] =
+          advx_ay[i] + advy_ay[i] + advz_ay[i]
+          + vx * (metric->G2_11[i] * ax + metric->G2_12[i] * ay + metric->G2_13[i] * az)
+          + vy * (metric->G2_12[i] * ax + metric->G2_22[i] * ay + metric->G2_23[i] * az)
+          + vz * (metric->G2_13[i] * ax + metric->G2_23[i] * ay + metric->G2_33[i] * az);
+
+      result.z[i] =
+          advx_az[i] + advy_az[i] + advz_az[i]
+          + vx * (metric->G3_11[i] * ax + metric->G3_12[i] * ay + metric->G3_13[i] * az)
+          + vy * (metric->G3_12[i] * ax + metric->G3_22[i] * ay + metric->G3_23[i] * az)
+          + vz * (metric->G3_13[i] * ax + metric->G3_23[i] * ay + metric->G3_33[i] * az);
+    }
 
     result.covariant = false;
   }
@@ -542,56 +696,130 @@ const Vector3D V_dot_Grad(const Vector3D &v, const Vector2D &a) {
   return result;
 }
 
-const Vector3D V_dot_Grad(const Vector3D &v, const Vector3D &a) {
-  TRACE("V_dot_Grad( Vector3D , Vector3D )");
+namespace {
+
+/// Advection of \p a by a vector whose components \p vcn are already
+/// contravariant. Shared by the lvalue and rvalue forms of
+/// V_dot_Grad(Vector3D, Vector3D)
+///
+/// The nine advection derivatives need the full mesh derivative
+/// machinery; the Christoffel symbol corrections and the component
+/// sums are pointwise, and are fused into a single pass over the data
+/// sharing the reads of vcn, a and the metric terms
+Vector3D vDotGradContravariant(const Vector3D &vcn, const Vector3D &a) {
+  Mesh *localmesh = vcn.x.getMesh();
+  Vector3D result{localmesh};
+
+  auto metric = vcn.x.getCoordinates();
+
+  const Field3D advx_ax = VDDX(vcn.x, a.x);
+  const Field3D advy_ax = VDDY(vcn.y, a.x);
+  const Field3D advz_ax = VDDZ(vcn.z, a.x);
+  const Field3D advx_ay = VDDX(vcn.x, a.y);
+  const Field3D advy_ay = VDDY(vcn.y, a.y);
+  const Field3D advz_ay = VDDZ(vcn.z, a.y);
+  const Field3D advx_az = VDDX(vcn.x, a.z);
+  const Field3D advy_az = VDDY(vcn.y, a.z);
+  const Field3D advz_az = VDDZ(vcn.z, a.z);
+
+  result.x.allocate();
+  result.y.allocate();
+  result.z.allocate();
 
-  ASSERT1(v.getLocation() == a.getLocation());
-  ASSERT1(v.getLocation() != CELL_VSHIFT);
+  if (a.covariant) {
+    BOUT_FOR(i, localmesh->getRegion3D("RGN_ALL")) {
+      const auto i2 = localmesh->ind3Dto2D(i);
+      const BoutReal vx = vcn.x[i], vy = vcn.y[i], vz = vcn.z[i];
+      const BoutReal ax = a.x[i], ay = a.y[i], az = a.z[i];
+
+      result.x[i] = advx_ax[i] + advy_ax[i] + advz_ax[i]
+                    - vx * (metric->G1_11[i2] * ax + metric->G2_11[i2] * ay
+                            + metric->G3_11[i2] * az)
+                    - vy * (metric->G1_12[i2] * ax + metric->G2_12[i2] * ay
+                            + metric->G3_12[i2] * az)
+                    - vz * (metric->G1_13[i2] * ax + metric->G2_13[i2] * ay
+                            + metric->G3_13[i2] * az);
+
+      result.y[i] = advx_ay[i] + advy_ay[i] + advz_ay[i]
+                    - vx * (metric->G1_12[i2] * ax + metric->G2_12[i2] * ay
+                            + metric->G3_12[i2] * az)
+                    - vy * (metric->G1_22[i2] * ax + metric->G2_22[i2] * ay
+                            + metric->G3_22[i2] * az)
+                    - vz * (metric->G1_23[i2] * ax + metric->G2_23[i2] * ay
+                            + metric->G3_23[i2] * az);
+
+      result.z[i] = advx_az[i] + advy_az[i] + advz_az[i]
+                    - vx * (metric->G1_13[i2] * ax + metric->G2_13[i2] * ay
+                            + metric->G3_13[i2] * az)
+                    - vy * (metric->G1_23[i2] * ax + metric->G2_23[i2] * ay
+                            + metric->G3_23[i2] * az)
+                    - vz * (metric->G1_33[i2] * ax + metric->G2_33[i2] * ay
+                            + metric->G3_33[i2] * az);
+    }
 
-  Vector3D result{v.x.getMesh()};
+    result.covariant = true;
+  } else {
+    BOUT_FOR(i, localmesh->getRegion3D("RGN_ALL")) {
+      const auto i2 = localmesh->ind3Dto2D(i);
+      const BoutReal vx = vcn.x[i], vy = vcn.y[i], vz = vcn.z[i];
+      const BoutReal ax = a.x[i], ay = a.y[i], az = a.z[i];
+
+      result.x[i] = advx_ax[i] + advy_ax[i] + advz_ax[i]
+                    + vx * (metric->G1_11[i2] * ax + metric->G1_12[i2] * ay
+                            + metric->G1_13[i2] * az)
+                    + vy * (metric->G1_12[i2] * ax + metric->G1_22[i2] * ay
+                            + metric->G1_23[i2] * az)
+                    + vz * (metric->G1_13[i2] * ax + metric->G1_23[i2] * ay
+                            + metric->G1_33[i2] * az);
+
+      result.y[i] = advx_ay[i] + advy_ay[i] + advz_ay[i]
+                    + vx * (metric->G2_11[i2] * ax + metric->G2_12[i2] * ay
+                            + metric->G2_13[i2] * az)
+                    + vy * (metric->G2_12[i2] * ax + metric->G2_22[i2] * ay
+                            + metric->G2_23[i2] * az)
+                    + vz * (metric->G2_13[i2] * ax + metric->G2_23[i2] * ay
+                            + metric->G2_33[i2] * az);
+
+      result.z[i] = advx_az[i] + advy_az[i] + advz_az[i]
+                    + vx * (metric->G3_11[i2] * ax + metric->G3_12[i2] * ay
+                            + metric->G3_13[i2] * az)
+                    + vy * (metric->G3_12[i2] * ax + metric->G3_22[i2] * ay
+                            + metric->G3_23[i2] * az)
+                    + vz * (metric->G3_13[i2] * ax + metric->G3_23[i2] * ay
+                            + metric->G3_33[i2] * az);
+    }
 
-  auto metric = v.x.getCoordinates();
+    result.covariant = false;
+  }
 
-  Vector3D vcn = v;
-  vcn.toContravariant();
+  result.setLocation(a.getLocation());
 
-  if (a.covariant) {
-    result.x = VDDX(vcn.x, a.x) + VDDY(vcn.y, a.x) + VDDZ(vcn.z, a.x);
-    result.x -= vcn.x * (metric->G1_11 * a.x + metric->G2_11 * a.y + metric->G3_11 * a.z);
-    result.x -= vcn.y * (metric->G1_12 * a.x + metric->G2_12 * a.y + metric->G3_12 * a.z);
-    result.x -= vcn.z * (metric->G1_13 * a.x + metric->G2_13 * a.y + metric->G3_13 * a.z);
+  return result;
+}
 
-    result.y = VDDX(vcn.x, a.y) + VDDY(vcn.y, a.y) + VDDZ(vcn.z, a.y);
-    result.y -= vcn.x * (metric->G1_12 * a.x + metric->G2_12 * a.y + metric->G3_12 * a.z);
-    result.y -= vcn.y * (metric->G1_22 * a.x + metric->G2_22 * a.y + metric->G3_22 * a.z);
-    result.y -= vcn.z * (metric->G1_23 * a.x + metric->G2_23 * a.y + metric->G3_23 * a.z);
+} // namespace
 
-    result.z = VDDX(vcn.x, a.z) + VDDY(vcn.y, a.z) + VDDZ(vcn.z, a.z);
-    result.z -= vcn.x * (metric->G1_13 * a.x + metric->G2_13 * a.y + metric->G3_13 * a.z);
-    result.z -= vcn.y * (metric->G1_23 * a.x + metric->G2_23 * a.y + metric->G3_23 * a.z);
-    result.z -= vcn.z * (metric->G1_33 * a.x + metric->G2_33 * a.y + metric->G3_33 * a.z);
+const Vector3D V_dot_Grad(const Vector3D &v, const Vector3D &a) {
+  TRACE("V_dot_Grad( Vector3D , Vector3D )");
 
-    result.covariant = true;
-  } else {
-    result.x = VDDX(vcn.x, a.x) + VDDY(vcn.y, a.x) + VDDZ(vcn.z, a.x);
-    result.x += vcn.x * (metric->G1_11 * a.x + metric->G1_12 * a.y + metric->G1_13 * a.z);
-    result.x += vcn.y * (metric->G1_12 * a.x + metric->G1_22 * a.y + metric->G1_23 * a.z);
-    result.x += vcn.z * (metric->G1_13 * a.x + metric->G1_23 * a.y + metric->G1_33 * a.z);
+  ASSERT1(v.getLocation() == a.getLocation());
+  ASSERT1(v.getLocation() != CELL_VSHIFT);
 
-    result.y = VDDX(vcn.x, a.y) + VDDY(vcn.y, a.y) + VDDZ(vcn.z, a.y);
-    result.y += vcn.x * (metric->G2_11 * a.x + metric->G2_12 * a.y + metric->G2_13 * a.z);
-    result.y += vcn.y * (metric->G2_12 * a.x + metric->G2_22 * a.y + metric->G2_23 * a.z);
-    result.y += vcn.z * (metric->G2_13 * a.x + metric->G2_23 * a.y + metric->G2_33 * a.z);
+  Vector3D vcn = v;
+  vcn.toContravariant();
 
-    result.z = VDDX(vcn.x, a.z) + VDDY(vcn.y, a.z) + VDDZ(vcn.z, a.z);
-    result.z += vcn.x * (metric->G3_11 * a.x + metric->G3_12 * a.y + metric->G3_13 * a.z);
-    result.z += vcn.y * (metric->G3_12 * a.x + metric->G3_22 * a.y + metric->G3_23 * a.z);
-    result.z += vcn.z * (metric->G3_13 * a.x + metric->G3_23 * a.y + metric->G3_33 * a.z);
+  return vDotGradContravariant(vcn, a);
+}
 
-    result.covariant = false;
-  }
+const Vector3D V_dot_Grad(Vector3D &&v, const Vector3D &a) {
+  TRACE("V_dot_Grad( Vector3D&& , Vector3D )");
 
-  result.setLocation(v.getLocation());
+  ASSERT1(v.getLocation() == a.getLocation());
+  ASSERT1(v.getLocation() != CELL_VSHIFT);
 
-  return result;
+  // Convert in place, reusing the temporary's storage instead of
+  // copying all three components
+  v.toContravariant();
+
+  return vDotGradContravariant(v, a);
 }
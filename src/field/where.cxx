@@ -27,167 +27,141 @@
 #include <where.hxx>
 
 //////////////////////////////////////////////////////////////////////////////////
-// Versions taking Field2D and returning Field3D
-
-const Field3D where(const Field2D &test, const Field3D &gt0, const Field3D &le0) {
-  const auto testMesh = test.getMesh();
-  Field3D result(testMesh);
+// Branchless select kernel
+//
+// Both inputs are read unconditionally and the conditional is a simple
+// select, so the compiler can if-convert the loop body into vector
+// masks/blends instead of a data-dependent branch per point.
+
+namespace {
+inline BoutReal value(BoutReal v, const Ind3D &UNUSED(i)) { return v; }
+inline BoutReal value(BoutReal v, const Ind2D &UNUSED(i)) { return v; }
+inline BoutReal value(const Field3D &f, const Ind3D &i) { return f[i]; }
+inline BoutReal value(const Field2D &f, const Ind3D &i) { return f[i]; }
+inline BoutReal value(const Field2D &f, const Ind2D &i) { return f[i]; }
+
+template <typename FieldT, typename IndT, typename TestT, typename GtT, typename LeT>
+void whereInto(FieldT &result, const TestT &test, const GtT &gt0, const LeT &le0,
+               const Region<IndT> &region) {
   result.allocate();
 
-  BOUT_FOR(i, testMesh->getRegion3D("RGN_ALL")) {
-    if(test[i] > 0.0) {
-      result[i] = gt0[i];
-    }else {
-      result[i] = le0[i];
-    }
+  BOUT_FOR(i, region) {
+    const BoutReal g = value(gt0, i);
+    const BoutReal l = value(le0, i);
+    result[i] = (value(test, i) > 0.0) ? g : l;
   }
+}
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////////////
+// Versions taking Field2D and returning Field3D
+
+void where(Field3D &result, const Field2D &test, const Field3D &gt0,
+           const Field3D &le0) {
+  whereInto(result, test, gt0, le0, test.getMesh()->getRegion3D("RGN_ALL"));
+}
+
+void where(Field3D &result, const Field2D &test, const Field3D &gt0, BoutReal le0) {
+  whereInto(result, test, gt0, le0, test.getMesh()->getRegion3D("RGN_ALL"));
+}
+
+void where(Field3D &result, const Field2D &test, BoutReal gt0, const Field3D &le0) {
+  whereInto(result, test, gt0, le0, test.getMesh()->getRegion3D("RGN_ALL"));
+}
+
+void where(Field3D &result, const Field2D &test, const Field3D &gt0,
+           const Field2D &le0) {
+  whereInto(result, test, gt0, le0, test.getMesh()->getRegion3D("RGN_ALL"));
+}
+
+void where(Field3D &result, const Field2D &test, const Field2D &gt0,
+           const Field3D &le0) {
+  whereInto(result, test, gt0, le0, test.getMesh()->getRegion3D("RGN_ALL"));
+}
+
+const Field3D where(const Field2D &test, const Field3D &gt0, const Field3D &le0) {
+  Field3D result(test.getMesh());
+  where(result, test, gt0, le0);
   return result;
 }
 
 const Field3D where(const Field2D &test, const Field3D &gt0, BoutReal le0) {
-  const auto testMesh = test.getMesh();
-  Field3D result(testMesh);
-  result.allocate();
-
-  BOUT_FOR(i, testMesh->getRegion3D("RGN_ALL")) {
-    if(test[i] > 0.0) {
-      result[i] = gt0[i];
-    }else {
-      result[i] = le0;
-    }
-  }
+  Field3D result(test.getMesh());
+  where(result, test, gt0, le0);
   return result;
 }
 
 const Field3D where(const Field2D &test, BoutReal gt0, const Field3D &le0) {
-  const auto testMesh = test.getMesh();
-  Field3D result(testMesh);
-  result.allocate();
-
-  BOUT_FOR(i, testMesh->getRegion3D("RGN_ALL")) {
-    if(test[i] > 0.0) {
-      result[i] = gt0;
-    }else {
-      result[i] = le0[i];
-    }
-  }
-  
+  Field3D result(test.getMesh());
+  where(result, test, gt0, le0);
   return result;
 }
 
 const Field3D where(const Field2D &test, const Field3D &gt0, const Field2D &le0) {
-  const auto testMesh = test.getMesh();
-  Field3D result(testMesh);
-  result.allocate();
-
-  BOUT_FOR(i, testMesh->getRegion3D("RGN_ALL")) {
-    if(test[i] > 0.0) {
-      result[i] = gt0[i];
-    }else {
-      result[i] = le0[i];
-    }
-  }
-  
+  Field3D result(test.getMesh());
+  where(result, test, gt0, le0);
   return result;
 }
 
 const Field3D where(const Field2D &test, const Field2D &gt0, const Field3D &le0) {
-  const auto testMesh = test.getMesh();
-  Field3D result(testMesh);
-  result.allocate();
-
-  BOUT_FOR(i, testMesh->getRegion3D("RGN_ALL")) {
-    if(test[i] > 0.0) {
-      result[i] = gt0[i];
-    }else {
-      result[i] = le0[i];
-    }
-  }
-  
+  Field3D result(test.getMesh());
+  where(result, test, gt0, le0);
   return result;
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 // Versions taking Field2D and returning Field2D
 
-const Field2D where(const Field2D &test, const Field2D &gt0, const Field2D &le0) {
-  const auto testMesh = test.getMesh();
-  Field2D result(testMesh);
-  result.allocate();
+void where(Field2D &result, const Field2D &test, const Field2D &gt0,
+           const Field2D &le0) {
+  whereInto(result, test, gt0, le0, test.getMesh()->getRegion2D("RGN_ALL"));
+}
 
-  BOUT_FOR(i, testMesh->getRegion2D("RGN_ALL")) {
-    if(test[i] > 0.0) {
-      result[i] = gt0[i];
-    }else {
-      result[i] = le0[i];
-    }
-  }
-  
+void where(Field2D &result, const Field2D &test, const Field2D &gt0, BoutReal le0) {
+  whereInto(result, test, gt0, le0, test.getMesh()->getRegion2D("RGN_ALL"));
+}
+
+void where(Field2D &result, const Field2D &test, BoutReal gt0, const Field2D &le0) {
+  whereInto(result, test, gt0, le0, test.getMesh()->getRegion2D("RGN_ALL"));
+}
+
+void where(Field2D &result, const Field2D &test, BoutReal gt0, BoutReal le0) {
+  whereInto(result, test, gt0, le0, test.getMesh()->getRegion2D("RGN_ALL"));
+}
+
+const Field2D where(const Field2D &test, const Field2D &gt0, const Field2D &le0) {
+  Field2D result(test.getMesh());
+  where(result, test, gt0, le0);
   return result;
 }
 
 const Field2D where(const Field2D &test, const Field2D &gt0, BoutReal le0) {
-  const auto testMesh = test.getMesh();
-  Field2D result(testMesh);
-  result.allocate();
-
-  BOUT_FOR(i, testMesh->getRegion2D("RGN_ALL")) {
-    if(test[i] > 0.0) {
-      result[i] = gt0[i];
-    }else {
-      result[i] = le0;
-    }
-  }
-  
+  Field2D result(test.getMesh());
+  where(result, test, gt0, le0);
   return result;
 }
 
 const Field2D where(const Field2D &test, BoutReal gt0, const Field2D &le0) {
-  const auto testMesh = test.getMesh();
-  Field2D result(testMesh);
-  result.allocate();
-
-  BOUT_FOR(i, testMesh->getRegion2D("RGN_ALL")) {
-    if(test[i] > 0.0) {
-      result[i] = gt0;
-    }else {
-      result[i] = le0[i];
-    }
-  }
-  
+  Field2D result(test.getMesh());
+  where(result, test, gt0, le0);
   return result;
 }
 
 const Field2D where(const Field2D &test, BoutReal gt0, BoutReal le0) {
-  const auto testMesh = test.getMesh();
-  Field2D result(testMesh);
-  result.allocate();
-
-  BOUT_FOR(i, testMesh->getRegion2D("RGN_ALL")) {
-    if(test[i] > 0.0) {
-      result[i] = gt0;
-    }else {
-      result[i] = le0;
-    }
-  }
-  
+  Field2D result(test.getMesh());
+  where(result, test, gt0, le0);
   return result;
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 // Versions taking Field3D and returning Field3D
 
-const Field3D where(const Field3D &test, BoutReal gt0, const Field3D &le0) {
-  const auto testMesh = test.getMesh();
-  Field3D result(testMesh);
-  result.allocate();
+void where(Field3D &result, const Field3D &test, BoutReal gt0, const Field3D &le0) {
+  whereInto(result, test, gt0, le0, test.getMesh()->getRegion3D("RGN_ALL"));
+}
 
-  BOUT_FOR(i, testMesh->getRegion3D("RGN_ALL")) {
-    if(test[i] > 0.0) {
-      result[i] = gt0;
-    }else {
-      result[i] = le0[i];
-    }
-  }
+const Field3D where(const Field3D &test, BoutReal gt0, const Field3D &le0) {
+  Field3D result(test.getMesh());
+  where(result, test, gt0, le0);
   return result;
 }
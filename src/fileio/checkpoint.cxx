@@ -0,0 +1,331 @@
+/*!
+ * \file checkpoint.cxx
+ *
+ * \brief Fast binary checkpoint/restart implementation
+ *
+ * File layout (version 1):
+ *
+ *   [header]      magic, version, number of processors, variable table
+ *   [size table]  bytes contributed by each processor (int64 each)
+ *   [payload]     per-processor data blocks, in rank order
+ *
+ * Each processor's payload holds the registered variables in
+ * registration order, as raw copies of their local data. The header
+ * and table are small; the payload is written and read with a single
+ * collective MPI-IO operation.
+ */
+
+#include <bout/checkpoint.hxx>
+
+#include <boutcomm.hxx>
+#include <boutexception.hxx>
+#include <field2d.hxx>
+#include <field3d.hxx>
+#include <output.hxx>
+
+#include "mpi.h"
+
+#include <cstring>
+#include <fstream>
+
+namespace {
+const char checkpoint_magic[8] = {'B', 'O', 'U', 'T', 'C', 'K', 'P', 'T'};
+const int32_t checkpoint_version = 1;
+
+const int name_len = 60; ///< Bytes per name in the variable table
+const int entry_len = name_len + sizeof(int32_t); ///< Bytes per variable table entry
+
+// Type codes in the variable table
+enum VarType : int32_t { INT_VAR = 0, BOUTREAL_VAR = 1, F2D_VAR = 2, F3D_VAR = 3 };
+
+/// Throw if an MPI-IO call failed
+void checkMPI(int ierr, const char *op) {
+  if (ierr != MPI_SUCCESS) {
+    char buffer[MPI_MAX_ERROR_STRING];
+    int len;
+    MPI_Error_string(ierr, buffer, &len);
+    throw BoutException("Checkpoint: %s failed: %s", op, buffer);
+  }
+}
+
+/// Append a variable table entry to \p header
+void addEntry(std::vector<char> &header, const std::string &name, int32_t type) {
+  char entry[entry_len];
+  std::memset(entry, 0, entry_len);
+  std::strncpy(entry, name.c_str(), name_len - 1);
+  std::memcpy(entry + name_len, &type, sizeof(int32_t));
+  header.insert(header.end(), entry, entry + entry_len);
+}
+} // namespace
+
+Checkpoint::Checkpoint(Options *opt) {
+  if (opt == nullptr)
+    return; // Not enabled
+
+  opt->get("enabled", enabled, false);
+
+  std::string datadir;
+  Options::getRoot()->get("datadir", datadir, "data");
+  opt->get("directory", directory, datadir);
+}
+
+void Checkpoint::add(int &value, const std::string &name) {
+  int_arr.push_back({&value, name});
+}
+
+void Checkpoint::add(BoutReal &value, const std::string &name) {
+  BoutReal_arr.push_back({&value, name});
+}
+
+void Checkpoint::add(Field2D &f, const std::string &name) {
+  f2d_arr.push_back({&f, name});
+}
+
+void Checkpoint::add(Field3D &f, const std::string &name) {
+  f3d_arr.push_back({&f, name});
+}
+
+std::string Checkpoint::fileName(int index) const {
+  return directory + "/BOUT.checkpoint." + std::to_string(index) + ".bin";
+}
+
+std::string Checkpoint::latestFileName() const {
+  return directory + "/BOUT.checkpoint.latest";
+}
+
+size_t Checkpoint::localSize() const {
+  size_t nbytes = int_arr.size() * sizeof(int) + BoutReal_arr.size() * sizeof(BoutReal);
+  for (const auto &var : f2d_arr) {
+    nbytes += var.ptr->getNx() * var.ptr->getNy() * sizeof(BoutReal);
+  }
+  for (const auto &var : f3d_arr) {
+    nbytes += var.ptr->getNx() * var.ptr->getNy() * var.ptr->getNz() * sizeof(BoutReal);
+  }
+  return nbytes;
+}
+
+void Checkpoint::packVars(char *buf) const {
+  for (const auto &var : int_arr) {
+    std::memcpy(buf, var.ptr, sizeof(int));
+    buf += sizeof(int);
+  }
+  for (const auto &var : BoutReal_arr) {
+    std::memcpy(buf, var.ptr, sizeof(BoutReal));
+    buf += sizeof(BoutReal);
+  }
+  for (const auto &var : f2d_arr) {
+    size_t nbytes = var.ptr->getNx() * var.ptr->getNy() * sizeof(BoutReal);
+    std::memcpy(buf, &(*var.ptr)(0, 0), nbytes);
+    buf += nbytes;
+  }
+  for (const auto &var : f3d_arr) {
+    size_t nbytes =
+        var.ptr->getNx() * var.ptr->getNy() * var.ptr->getNz() * sizeof(BoutReal);
+    std::memcpy(buf, &(*var.ptr)(0, 0, 0), nbytes);
+    buf += nbytes;
+  }
+}
+
+void Checkpoint::unpackVars(const char *buf) {
+  for (const auto &var : int_arr) {
+    std::memcpy(var.ptr, buf, sizeof(int));
+    buf += sizeof(int);
+  }
+  for (const auto &var : BoutReal_arr) {
+    std::memcpy(var.ptr, buf, sizeof(BoutReal));
+    buf += sizeof(BoutReal);
+  }
+  for (const auto &var : f2d_arr) {
+    var.ptr->allocate();
+    size_t nbytes = var.ptr->getNx() * var.ptr->getNy() * sizeof(BoutReal);
+    std::memcpy(&(*var.ptr)(0, 0), buf, nbytes);
+    buf += nbytes;
+  }
+  for (const auto &var : f3d_arr) {
+    var.ptr->allocate();
+    size_t nbytes =
+        var.ptr->getNx() * var.ptr->getNy() * var.ptr->getNz() * sizeof(BoutReal);
+    std::memcpy(&(*var.ptr)(0, 0, 0), buf, nbytes);
+    buf += nbytes;
+  }
+}
+
+std::vector<char> Checkpoint::makeHeader() const {
+  std::vector<char> header;
+
+  header.insert(header.end(), checkpoint_magic, checkpoint_magic + 8);
+
+  int32_t nranks = BoutComm::size();
+  int32_t nvars = static_cast<int32_t>(int_arr.size() + BoutReal_arr.size()
+                                       + f2d_arr.size() + f3d_arr.size());
+  const char *p = reinterpret_cast<const char *>(&checkpoint_version);
+  header.insert(header.end(), p, p + sizeof(int32_t));
+  p = reinterpret_cast<const char *>(&nranks);
+  header.insert(header.end(), p, p + sizeof(int32_t));
+  p = reinterpret_cast<const char *>(&nvars);
+  header.insert(header.end(), p, p + sizeof(int32_t));
+
+  // Variable table, in payload order
+  for (const auto &var : int_arr)
+    addEntry(header, var.name, INT_VAR);
+  for (const auto &var : BoutReal_arr)
+    addEntry(header, var.name, BOUTREAL_VAR);
+  for (const auto &var : f2d_arr)
+    addEntry(header, var.name, F2D_VAR);
+  for (const auto &var : f3d_arr)
+    addEntry(header, var.name, F3D_VAR);
+
+  return header;
+}
+
+void Checkpoint::write() {
+  TRACE("Checkpoint::write()");
+
+  MPI_Comm comm = BoutComm::get();
+  int rank = BoutComm::rank();
+  int nranks = BoutComm::size();
+
+  // Alternate between two files, so the last complete checkpoint
+  // is never overwritten
+  static int next_index = 0;
+  int index = next_index;
+  next_index = (next_index + 1) % 2;
+
+  std::vector<char> header = makeHeader();
+  long long nbytes = static_cast<long long>(localSize());
+
+  // Offset of this processor's payload within the data region
+  long long myoffset = 0;
+  MPI_Exscan(&nbytes, &myoffset, 1, MPI_LONG_LONG, MPI_SUM, comm);
+  if (rank == 0)
+    myoffset = 0; // Undefined on rank 0
+
+  MPI_Offset table_start = static_cast<MPI_Offset>(header.size());
+  MPI_Offset data_start = table_start + nranks * sizeof(long long);
+
+  MPI_File file;
+  checkMPI(MPI_File_open(comm, const_cast<char *>(fileName(index).c_str()),
+                         MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &file),
+           "opening file for writing");
+  MPI_File_set_size(file, 0); // Discard any previous contents
+
+  // Header, written by one processor
+  if (rank == 0) {
+    checkMPI(MPI_File_write_at(file, 0, header.data(), static_cast<int>(header.size()),
+                               MPI_BYTE, MPI_STATUS_IGNORE),
+             "writing header");
+  }
+
+  // Size table: each processor records how many bytes it contributes
+  checkMPI(MPI_File_write_at_all(file, table_start + rank * sizeof(long long), &nbytes,
+                                 1, MPI_LONG_LONG, MPI_STATUS_IGNORE),
+           "writing size table");
+
+  // Payload: one aggregated stream per processor, single collective write
+  std::vector<char> buffer(nbytes);
+  packVars(buffer.data());
+  checkMPI(MPI_File_write_at_all(file, data_start + myoffset, buffer.data(),
+                                 static_cast<int>(nbytes), MPI_BYTE, MPI_STATUS_IGNORE),
+           "writing data");
+
+  checkMPI(MPI_File_close(&file), "closing file");
+
+  // Only mark this file as the latest checkpoint once every
+  // processor has finished writing it
+  MPI_Barrier(comm);
+  if (rank == 0) {
+    std::ofstream latest(latestFileName());
+    latest << index << "\n";
+  }
+}
+
+bool Checkpoint::canRestart() {
+  int found = 0;
+  if (BoutComm::rank() == 0) {
+    for (int index = 0; index < 2; index++) {
+      std::ifstream file(fileName(index), std::ios::binary);
+      if (file.good())
+        found = 1;
+    }
+  }
+  MPI_Bcast(&found, 1, MPI_INT, 0, BoutComm::get());
+  return found != 0;
+}
+
+bool Checkpoint::read() {
+  TRACE("Checkpoint::read()");
+
+  // Find out which file was written last. If the marker file is
+  // missing, try both
+  int latest = 0;
+  if (BoutComm::rank() == 0) {
+    std::ifstream file(latestFileName());
+    if (!(file >> latest) || (latest < 0) || (latest > 1))
+      latest = 0;
+  }
+  MPI_Bcast(&latest, 1, MPI_INT, 0, BoutComm::get());
+
+  if (readFile(fileName(latest)))
+    return true;
+  return readFile(fileName((latest + 1) % 2));
+}
+
+bool Checkpoint::readFile(const std::string &filename) {
+  MPI_Comm comm = BoutComm::get();
+  int rank = BoutComm::rank();
+  int nranks = BoutComm::size();
+
+  MPI_File file;
+  if (MPI_File_open(comm, const_cast<char *>(filename.c_str()), MPI_MODE_RDONLY,
+                    MPI_INFO_NULL, &file)
+      != MPI_SUCCESS) {
+    return false; // No such file
+  }
+
+  // The header must match what this run would write: same format
+  // version, processor count, and variables
+  std::vector<char> expected = makeHeader();
+  std::vector<char> header(expected.size());
+  if (MPI_File_read_at_all(file, 0, header.data(), static_cast<int>(header.size()),
+                           MPI_BYTE, MPI_STATUS_IGNORE)
+      != MPI_SUCCESS) {
+    MPI_File_close(&file);
+    return false;
+  }
+  if (header != expected) {
+    output_warn.write("\tCheckpoint file '%s' doesn't match this run\n",
+                      filename.c_str());
+    MPI_File_close(&file);
+    return false;
+  }
+
+  // Size table, needed to locate this processor's payload
+  MPI_Offset table_start = static_cast<MPI_Offset>(header.size());
+  std::vector<long long> sizes(nranks);
+  checkMPI(MPI_File_read_at_all(file, table_start, sizes.data(), nranks, MPI_LONG_LONG,
+                                MPI_STATUS_IGNORE),
+           "reading size table");
+
+  long long nbytes = static_cast<long long>(localSize());
+  if (sizes[rank] != nbytes) {
+    output_warn.write("\tCheckpoint file '%s' has wrong size for processor %d\n",
+                      filename.c_str(), rank);
+    MPI_File_close(&file);
+    return false;
+  }
+
+  MPI_Offset myoffset = table_start + nranks * sizeof(long long);
+  for (int r = 0; r < rank; r++)
+    myoffset += sizes[r];
+
+  // Read this processor's payload in one collective operation,
+  // then copy straight into the registered variables
+  std::vector<char> buffer(nbytes);
+  checkMPI(MPI_File_read_at_all(file, myoffset, buffer.data(), static_cast<int>(nbytes),
+                                MPI_BYTE, MPI_STATUS_IGNORE),
+           "reading data");
+  unpackVars(buffer.data());
+
+  MPI_File_close(&file);
+  return true;
+}
@@ -36,7 +36,9 @@
 //#include "mpi.h" // For MPI_Wtime()
 
 #include <globals.hxx>
+#include <bout/sys/steppipeline.hxx>
 #include <bout/sys/timer.hxx>
+#include <bout/sys/watchdog.hxx>
 #include <datafile.hxx>
 #include <boutexception.hxx>
 #include <output.hxx>
@@ -46,9 +48,34 @@
 #include <cstring>
 #include "formatfactory.hxx"
 
+#include <algorithm>
+
+namespace {
+/// Copy \p in, in the usual (x,y,z) ordering, into \p out with x and y
+/// interchanged. Whole z pencils are moved at a time, in tiles of
+/// block x block pencils so both the source and destination stay cache
+/// resident while the tile is traversed
+void transposeXYBlocked(const BoutReal *in, BoutReal *out, int nx, int ny, int nz) {
+  const int block = 16;
+  for (int xb = 0; xb < nx; xb += block) {
+    const int xe = std::min(xb + block, nx);
+    for (int yb = 0; yb < ny; yb += block) {
+      const int ye = std::min(yb + block, ny);
+      for (int x = xb; x < xe; x++) {
+        for (int y = yb; y < ye; y++) {
+          std::memcpy(&out[(y * nx + x) * nz], &in[(x * ny + y) * nz],
+                      nz * sizeof(BoutReal));
+        }
+      }
+    }
+  }
+}
+} // namespace
+
 Datafile::Datafile(Options *opt) : parallel(false), flush(true), guards(true),
-  floats(false), openclose(true), enabled(true), shiftOutput(false),
-  shiftInput(false), flushFrequencyCounter(0), flushFrequency(1),
+  floats(false), floats3d(false), openclose(true), enabled(true), shiftOutput(false),
+  shiftInput(false), flushFrequencyCounter(0), flushFrequency(1), async(false),
+  staged(false), deflate(0), shuffle(false), groombits(0),
   file(nullptr), writable(false), appending(false), first_time(true)
 {
   filenamelen=FILENAMELEN;
@@ -58,31 +85,62 @@ Datafile::Datafile(Options *opt) : parallel(false), flush(true), guards(true),
   if (opt == nullptr) {
     return; // To allow static initialisation
   }
+  // Keep the section: per-variable write policies are read from its
+  // subsections as variables are added (see readWritePolicy)
+  options = opt;
+
   // Read options
-  
+
   OPTION(opt, parallel, false); // By default no parallel formats for now
   OPTION(opt, flush, true);     // Safer. Disable explicitly if required
   OPTION(opt, guards, true);    // Compatible with old behavior
   OPTION(opt, floats, false); // High precision by default
+  OPTION(opt, floats3d, false); // Write 3D fields as float32, everything else
+                                // (scalars, time base, 2D fields) as double
   OPTION(opt, openclose, true); // Open and close every write or read
   OPTION(opt, enabled, true);
   OPTION(opt, init_missing, false); // Initialise missing variables?
   OPTION(opt, shiftOutput, false); // Do we want to write 3D fields in shifted space?
   OPTION(opt, shiftInput, false); // Do we want to read 3D fields in shifted space?
   OPTION(opt, flushFrequency, 1); // How frequently do we flush the file
-  
+  OPTION(opt, async, false); // Write in a background thread, overlapping I/O with computation
+  OPTION(opt, staged, false); // Pipeline the async write: prepare the next 3D field
+                              // on a worker thread while the current one is put
+  OPTION(opt, deflate, 0);   // Deflate compression level for field variables, 0 = off
+  OPTION(opt, shuffle, false); // Byte-shuffle filter; improves compression of groomed data
+  OPTION(opt, groombits, 0); // Keep only this many mantissa bits (lossy!), 0 = off
+
+  if (async && shiftOutput) {
+    // Shifting to field-aligned space on output uses the FFT routines,
+    // which are not safe to call from the background thread while the
+    // solver may also be using them
+    throw BoutException("Datafile: async=true cannot be combined with shiftOutput=true");
+  }
+
+  if (staged && !async) {
+    // The pipeline only makes sense when the writing already happens
+    // off the solver thread; a synchronous write has nothing to
+    // overlap the preparation with
+    throw BoutException("Datafile: staged=true requires async=true");
+  }
 }
 
 Datafile::Datafile(Datafile &&other) noexcept
     : parallel(other.parallel), flush(other.flush), guards(other.guards),
-      floats(other.floats), openclose(other.openclose), Lx(other.Lx), Ly(other.Ly),
+      floats(other.floats), floats3d(other.floats3d), openclose(other.openclose),
+      Lx(other.Lx), Ly(other.Ly),
       Lz(other.Lz), enabled(other.enabled), shiftOutput(other.shiftOutput),
       shiftInput(other.shiftInput), flushFrequencyCounter(other.flushFrequencyCounter),
-      flushFrequency(other.flushFrequency), file(std::move(other.file)),
+      flushFrequency(other.flushFrequency), async(other.async), staged(other.staged),
+      deflate(other.deflate), shuffle(other.shuffle), groombits(other.groombits),
+      file(std::move(other.file)),
       writable(other.writable), appending(other.appending), first_time(other.first_time),
       int_arr(std::move(other.int_arr)), BoutReal_arr(std::move(other.BoutReal_arr)),
       f2d_arr(std::move(other.f2d_arr)), f3d_arr(std::move(other.f3d_arr)),
-      v2d_arr(std::move(other.v2d_arr)), v3d_arr(std::move(other.v3d_arr)) {
+      v2d_arr(std::move(other.v2d_arr)), v3d_arr(std::move(other.v3d_arr)),
+      write_thread(std::move(other.write_thread)), mype(other.mype) {
+  options = other.options;
+  writeCount = other.writeCount;
   filenamelen = other.filenamelen;
   filename = other.filename;
   other.filenamelen = 0;
@@ -92,13 +150,16 @@ Datafile::Datafile(Datafile &&other) noexcept
 
 Datafile::Datafile(const Datafile &other) :
   parallel(other.parallel), flush(other.flush), guards(other.guards),
-  floats(other.floats), openclose(other.openclose), Lx(other.Lx), Ly(other.Ly), Lz(other.Lz),
-  enabled(other.enabled), shiftOutput(other.shiftOutput), shiftInput(other.shiftInput), flushFrequencyCounter(other.flushFrequencyCounter), flushFrequency(other.flushFrequency), 
+  floats(other.floats), floats3d(other.floats3d), openclose(other.openclose), Lx(other.Lx), Ly(other.Ly), Lz(other.Lz),
+  enabled(other.enabled), shiftOutput(other.shiftOutput), shiftInput(other.shiftInput), flushFrequencyCounter(other.flushFrequencyCounter), flushFrequency(other.flushFrequency),
+  async(false), staged(false), // A copy always writes synchronously
+  deflate(other.deflate), shuffle(other.shuffle), groombits(other.groombits),
   file(nullptr), writable(other.writable), appending(other.appending), first_time(other.first_time),
   int_arr(other.int_arr), BoutReal_arr(other.BoutReal_arr),
   f2d_arr(other.f2d_arr), f3d_arr(other.f3d_arr), v2d_arr(other.v2d_arr),
   v3d_arr(other.v3d_arr)
 {
+  options = other.options;
   filenamelen=other.filenamelen;
   filename=new char[filenamelen];
   strncpy(filename,other.filename,filenamelen);
@@ -106,10 +167,13 @@ Datafile::Datafile(const Datafile &other) :
 }
 
 Datafile& Datafile::operator=(Datafile &&rhs) noexcept {
+  waitWrite(); // Can't replace a file mid-write
+  rhs.waitWrite();
   parallel     = rhs.parallel;
   flush        = rhs.flush;
   guards       = rhs.guards;
   floats       = rhs.floats;
+  floats3d     = rhs.floats3d;
   openclose    = rhs.openclose;
   enabled      = rhs.enabled;
   init_missing = rhs.init_missing;
@@ -117,6 +181,14 @@ Datafile& Datafile::operator=(Datafile &&rhs) noexcept {
   shiftInput   = rhs.shiftInput;
   flushFrequencyCounter = 0;
   flushFrequency = rhs.flushFrequency;
+  async        = rhs.async;
+  staged       = rhs.staged;
+  deflate      = rhs.deflate;
+  shuffle      = rhs.shuffle;
+  groombits    = rhs.groombits;
+  mype         = rhs.mype;
+  options      = rhs.options;
+  writeCount   = rhs.writeCount;
   file         = std::move(rhs.file);
   writable     = rhs.writable;
   appending    = rhs.appending;
@@ -137,6 +209,7 @@ Datafile& Datafile::operator=(Datafile &&rhs) noexcept {
 }
 
 Datafile::~Datafile() {
+  waitWrite();
   if (filename != nullptr){
     delete[] filename;
     filename=nullptr;
@@ -156,6 +229,10 @@ bool Datafile::openr(const char *format, ...) {
   
   if(!file)
     throw BoutException("Datafile::open: Factory failed to create a DataFormat!");
+
+  if ((deflate > 0) || shuffle || (groombits > 0)) {
+    file->setCompression(deflate, shuffle, groombits);
+  }
   
   // If parallel do not want to write ghost points, and it is easier then to ignore the boundary guard cells as well
   if (parallel) {
@@ -193,6 +270,10 @@ bool Datafile::openw(const char *format, ...) {
   
   if(!file)
     throw BoutException("Datafile::open: Factory failed to create a DataFormat!");
+
+  if ((deflate > 0) || shuffle || (groombits > 0)) {
+    file->setCompression(deflate, shuffle, groombits);
+  }
   
   // If parallel do not want to write ghost points, and it is easier then to ignore the boundary guard cells as well
   if (parallel) {
@@ -217,6 +298,7 @@ bool Datafile::openw(const char *format, ...) {
 
   appending = true;
   first_time = true; // newly opened file, so write attributes when variables are first written
+  resetWritePolicy(); // and write every variable at least once
 
   // Add variables to file
   // Add integers
@@ -241,7 +323,12 @@ bool Datafile::openw(const char *format, ...) {
   }
 
   // Add 3D fields
-  for (const auto& var : f3d_arr) {
+  for (auto& var : f3d_arr) {
+    if (var.transpose && !file->setTransposeXY(var.name)) {
+      output_warn.write("WARNING: This file format cannot store '%s' transposed; "
+                        "using the usual layout\n", var.name.c_str());
+      var.transpose = false;
+    }
     if (!file->addVarField3D(var.name, var.save_repeat)) {
       throw BoutException("Failed to add Field3D variable %s to Datafile", var.name.c_str());
     }
@@ -297,6 +384,10 @@ bool Datafile::opena(const char *format, ...) {
   if(!file)
     throw BoutException("Datafile::open: Factory failed to create a DataFormat!");
 
+  if ((deflate > 0) || shuffle || (groombits > 0)) {
+    file->setCompression(deflate, shuffle, groombits);
+  }
+
   // If parallel do not want to write ghost points, and it is easier then to ignore the boundary guard cells as well
   if (parallel) {
     file->setLocalOrigin(0, 0, 0, mesh->xstart, mesh->ystart, 0);
@@ -319,6 +410,7 @@ bool Datafile::opena(const char *format, ...) {
     throw BoutException("Datafile::open: Failed to open file!");
 
   first_time = true; // newly opened file, so write attributes when variables are first written
+  resetWritePolicy(); // and write every variable at least once
 
   // Add variables to file
   // Add integers
@@ -343,7 +435,12 @@ bool Datafile::opena(const char *format, ...) {
   }
 
   // Add 3D fields
-  for (const auto& var : f3d_arr) {
+  for (auto& var : f3d_arr) {
+    if (var.transpose && !file->setTransposeXY(var.name)) {
+      output_warn.write("WARNING: This file format cannot store '%s' transposed; "
+                        "using the usual layout\n", var.name.c_str());
+      var.transpose = false;
+    }
     if (!file->addVarField3D(var.name, var.save_repeat)) {
       throw BoutException("Failed to add Field3D variable %s to Datafile", var.name.c_str());
     }
@@ -394,6 +491,7 @@ bool Datafile::isValid() {
 }
 
 void Datafile::close() {
+  waitWrite(); // Let any outstanding asynchronous write finish
   if(!file)
     return;
   if(!openclose)
@@ -410,6 +508,80 @@ void Datafile::setLowPrecision() {
   file->setLowPrecision();
 }
 
+/*!
+ * Read the per-variable write policy for \p var, configured in a
+ * subsection of the section this Datafile was built from. For example
+ *
+ *     [output:Ni]
+ *     period = 10          # Write Ni on every 10th output only
+ *
+ *     [output:profile0]
+ *     write_once = true    # Write the first time only, then skip
+ *
+ *     [output:Te]
+ *     skip_unchanged = true  # Skip outputs where Te has not changed
+ *
+ * period applies to both evolving and static variables; an evolving
+ * variable then simply has fewer records in its time dimension.
+ * skip_unchanged only works for Field3D, which tracks modifications for
+ * its parallel slices (see Field3D::getGeneration); it is read but has
+ * no effect for other types.
+ *
+ *     [output:phi]
+ *     transpose = true     # Store phi as (t,y,x,z) instead of (t,x,y,z)
+ *
+ * transpose converts the variable to an analysis-friendly layout at
+ * write time: (x,z) planes at fixed y become contiguous in the file,
+ * so post-processing reads them without striding. The conversion runs
+ * in the writer (in the background when async=true). It only applies
+ * to Field3D variables, needs a format which supports it (netCDF), and
+ * the transposed variable cannot be read back through this class - use
+ * it for analysis output, not restart data.
+ */
+template <class T>
+void Datafile::readWritePolicy(VarStr<T> &var) {
+  if (options == nullptr)
+    return; // Statically initialised Datafile; the defaults apply
+
+  Options *section = options->getSection(var.name);
+  section->get("period", var.period, 1);
+  section->get("write_once", var.write_once, false);
+  section->get("skip_unchanged", var.skip_unchanged, false);
+  section->get("transpose", var.transpose, false);
+
+  if (var.period < 1) {
+    throw BoutException("Datafile: period for variable '%s' must be at least 1",
+                        var.name.c_str());
+  }
+}
+
+template <class T>
+bool Datafile::shouldWrite(const VarStr<T> &var) {
+  if (var.write_once && var.written) {
+    return false; // Static variable, already in the file
+  }
+  if ((var.period > 1) && (writeCount % var.period != 0)) {
+    return false; // Between outputs for this variable
+  }
+  return true;
+}
+
+void Datafile::resetWritePolicy() {
+  writeCount = 0;
+  for (auto &var : int_arr)
+    var.written = false;
+  for (auto &var : BoutReal_arr)
+    var.written = false;
+  for (auto &var : f2d_arr)
+    var.written = false;
+  for (auto &var : f3d_arr)
+    var.written = false;
+  for (auto &var : v2d_arr)
+    var.written = false;
+  for (auto &var : v3d_arr)
+    var.written = false;
+}
+
 void Datafile::add(int &i, const char *name, bool save_repeat) {
   TRACE("DataFile::add(int)");
   if (!enabled)
@@ -429,7 +601,8 @@ void Datafile::add(int &i, const char *name, bool save_repeat) {
   d.name = string(name);
   d.save_repeat = save_repeat;
   d.covar = false;
-  
+  readWritePolicy(d);
+
   int_arr.push_back(d);
 
   if (writable) {
@@ -479,7 +652,8 @@ void Datafile::add(BoutReal &r, const char *name, bool save_repeat) {
   d.name = string(name);
   d.save_repeat = save_repeat;
   d.covar = false;
-  
+  readWritePolicy(d);
+
   BoutReal_arr.push_back(d);
 
   if (writable) {
@@ -500,6 +674,8 @@ void Datafile::add(BoutReal &r, const char *name, bool save_repeat) {
 
     if(floats)
       file->setLowPrecision();
+    if(floats3d)
+      file->setLowPrecision3D();
 
     // Add variable to file
     if (!file->addVarBoutReal(name, save_repeat)) {
@@ -531,7 +707,8 @@ void Datafile::add(Field2D &f, const char *name, bool save_repeat) {
   d.name = string(name);
   d.save_repeat = save_repeat;
   d.covar = false;
-  
+  readWritePolicy(d);
+
   f2d_arr.push_back(d);
 
   if (writable) {
@@ -552,6 +729,8 @@ void Datafile::add(Field2D &f, const char *name, bool save_repeat) {
 
     if(floats)
       file->setLowPrecision();
+    if(floats3d)
+      file->setLowPrecision3D();
 
     // Add variable to file
     if (!file->addVarField2D(name, save_repeat)) {
@@ -583,7 +762,8 @@ void Datafile::add(Field3D &f, const char *name, bool save_repeat) {
   d.name = string(name);
   d.save_repeat = save_repeat;
   d.covar = false;
-  
+  readWritePolicy(d);
+
   f3d_arr.push_back(d);
 
   if (writable) {
@@ -604,8 +784,15 @@ void Datafile::add(Field3D &f, const char *name, bool save_repeat) {
 
     if(floats)
       file->setLowPrecision();
+    if(floats3d)
+      file->setLowPrecision3D();
 
     // Add variable to file
+    if (d.transpose && !file->setTransposeXY(d.name)) {
+      output_warn.write("WARNING: This file format cannot store '%s' transposed; "
+                        "using the usual layout\n", name);
+      f3d_arr.back().transpose = false;
+    }
     if (!file->addVarField3D(name, save_repeat)) {
       throw BoutException("Failed to add Field3D variable %s to Datafile", name);
     }
@@ -635,6 +822,7 @@ void Datafile::add(Vector2D &f, const char *name, bool save_repeat) {
   d.name = string(name);
   d.save_repeat = save_repeat;
   d.covar = f.covariant;
+  readWritePolicy(d);
 
   v2d_arr.push_back(d);
 
@@ -656,6 +844,8 @@ void Datafile::add(Vector2D &f, const char *name, bool save_repeat) {
 
     if(floats)
       file->setLowPrecision();
+    if(floats3d)
+      file->setLowPrecision3D();
 
     // Add variables to file
     if (!file->addVarField2D(string(name)+string("_x"), save_repeat)) {
@@ -693,6 +883,7 @@ void Datafile::add(Vector3D &f, const char *name, bool save_repeat) {
   d.name = string(name);
   d.save_repeat = save_repeat;
   d.covar = f.covariant;
+  readWritePolicy(d);
 
   v3d_arr.push_back(d);
 
@@ -714,6 +905,8 @@ void Datafile::add(Vector3D &f, const char *name, bool save_repeat) {
 
     if(floats)
       file->setLowPrecision();
+    if(floats3d)
+      file->setLowPrecision3D();
 
     // Add variables to file
     if (!file->addVarField3D(string(name)+string("_x"), save_repeat)) {
@@ -849,28 +1042,63 @@ bool Datafile::write() {
     return true; // Just pretend it worked
 
   TRACE("Datafile::write()");
+  Watchdog::beat("Datafile::write");
 
   if(!file)
     throw BoutException("Datafile::write: File is not valid!");
 
+  // Cache the rank, so that the background thread makes no MPI calls
+  MPI_Comm_rank(BoutComm::get(), &mype);
+
+  if (!async) {
+    Timer timer("io");
+    return writeAll(false);
+  }
+
+  // At most one write in flight: if the previous one is still going we
+  // stall here, but normally it finished during the preceding timesteps
+  waitWrite();
+
+  if (async_failed) {
+    async_failed = false;
+    throw BoutException("Datafile::write: Background write failed! See above for the error message");
+  }
+
+  // Snapshot the data, so the solver is free to modify the variables
+  // while the background thread writes them out
+  snapshotVars();
+
+  write_thread = std::thread([this]() {
+    StepPipeline::backgroundBegin("dump write");
+    try {
+      writeAll(true);
+    } catch (BoutException &e) {
+      output_error.write("Error in background Datafile write: %s\n", e.what());
+      async_failed = true;
+    }
+    StepPipeline::backgroundEnd("dump write");
+  });
+
+  return true;
+}
+
+bool Datafile::writeAll(bool use_copy) {
   if(openclose && (flushFrequencyCounter % flushFrequency == 0)) {
     // Open the file
-    int MYPE;
-    MPI_Comm_rank(BoutComm::get(), &MYPE);
-    if(!file->openw(filename, MYPE, appending))
+    if(!file->openw(filename, mype, appending))
       throw BoutException("Datafile::write: Failed to open file!");
     appending = true;
     flushFrequencyCounter = 0;
   }
-  
+
   if(!file->is_valid())
     throw BoutException("Datafile::open: File is not valid!");
 
   if(floats)
     file->setLowPrecision();
-  
-  Timer timer("io");
-  
+  if(floats3d)
+    file->setLowPrecision3D();
+
   file->setRecord(-1); // Latest record
 
   if (first_time) {
@@ -913,40 +1141,76 @@ bool Datafile::write() {
   }
 
   // Write integers
-  for(const auto& var : int_arr) {
-    write_int(var.name, var.ptr, var.save_repeat);
+  for (std::size_t i = 0; i < int_arr.size(); i++) {
+    auto& var = int_arr[i];
+    if (!shouldWrite(var))
+      continue;
+    write_int(var.name, use_copy ? &int_copy[i] : var.ptr, var.save_repeat);
+    var.written = true;
   }
-  
+
   // Write BoutReals
-  for(const auto& var : BoutReal_arr) {
-    write_real(var.name, var.ptr, var.save_repeat);
+  for (std::size_t i = 0; i < BoutReal_arr.size(); i++) {
+    auto& var = BoutReal_arr[i];
+    if (!shouldWrite(var))
+      continue;
+    write_real(var.name, use_copy ? &BoutReal_copy[i] : var.ptr, var.save_repeat);
+    var.written = true;
   }
 
   // Write 2D fields
-  for (const auto& var : f2d_arr) {
-    write_f2d(var.name, var.ptr, var.save_repeat);
+  for (std::size_t i = 0; i < f2d_arr.size(); i++) {
+    auto& var = f2d_arr[i];
+    if (!shouldWrite(var))
+      continue;
+    write_f2d(var.name, use_copy ? &f2d_copy[i] : var.ptr, var.save_repeat);
+    var.written = true;
   }
 
   // Write 3D fields
-  for (const auto& var : f3d_arr) {
-    write_f3d(var.name, var.ptr, var.save_repeat);
+  if (use_copy && staged) {
+    // Pipelined: the preparation of each field overlaps the put of the
+    // previous one
+    write_f3d_staged();
+  } else {
+    for (std::size_t i = 0; i < f3d_arr.size(); i++) {
+      auto& var = f3d_arr[i];
+      if (!shouldWrite(var))
+        continue;
+      if (var.skip_unchanged) {
+        // Generation of the data about to be written. In asynchronous
+        // mode the live variable belongs to the solver, so use the value
+        // recorded when the snapshot was taken
+        unsigned int gen = use_copy ? f3d_gen_copy[i] : var.ptr->getGeneration();
+        if (var.written && (gen == var.written_generation)) {
+          continue; // Not modified since it was last written
+        }
+        var.written_generation = gen;
+      }
+      write_f3d(var.name, use_copy ? &f3d_copy[i] : var.ptr, var.save_repeat,
+                var.transpose);
+      var.written = true;
+    }
   }
-  
+
   // 2D vectors
-  for(const auto& var : v2d_arr) {
+  for (std::size_t i = 0; i < v2d_arr.size(); i++) {
+    auto& var = v2d_arr[i];
+    if (!shouldWrite(var))
+      continue;
+    var.written = true;
+    Vector2D v = use_copy ? v2d_copy[i] : *(var.ptr);
     if(var.covar) {
       // Writing covariant vector
-      Vector2D v  = *(var.ptr);
       v.toCovariant();
-      
+
       write_f2d(var.name+string("_x"), &(v.x), var.save_repeat);
       write_f2d(var.name+string("_y"), &(v.y), var.save_repeat);
       write_f2d(var.name+string("_z"), &(v.z), var.save_repeat);
     } else {
       // Writing contravariant vector
-      Vector2D v  = *(var.ptr);
       v.toContravariant();
-      
+
       write_f2d(var.name+string("x"), &(v.x), var.save_repeat);
       write_f2d(var.name+string("y"), &(v.y), var.save_repeat);
       write_f2d(var.name+string("z"), &(v.z), var.save_repeat);
@@ -954,33 +1218,158 @@ bool Datafile::write() {
   }
 
   // 3D vectors
-  for(const auto& var : v3d_arr) {
+  for (std::size_t i = 0; i < v3d_arr.size(); i++) {
+    auto& var = v3d_arr[i];
+    if (!shouldWrite(var))
+      continue;
+    var.written = true;
+    Vector3D v = use_copy ? v3d_copy[i] : *(var.ptr);
     if(var.covar) {
       // Writing covariant vector
-      Vector3D v  = *(var.ptr);
       v.toCovariant();
-      
+
       write_f3d(var.name+string("_x"), &(v.x), var.save_repeat);
       write_f3d(var.name+string("_y"), &(v.y), var.save_repeat);
       write_f3d(var.name+string("_z"), &(v.z), var.save_repeat);
     } else {
       // Writing contravariant vector
-      Vector3D v  = *(var.ptr);
       v.toContravariant();
-      
+
       write_f3d(var.name+string("x"), &(v.x), var.save_repeat);
       write_f3d(var.name+string("y"), &(v.y), var.save_repeat);
       write_f3d(var.name+string("z"), &(v.z), var.save_repeat);
     }
   }
-  
+
   if(openclose  && (flushFrequencyCounter+1 % flushFrequency == 0)){
     file->close();
   }
   flushFrequencyCounter++;
+  writeCount++;
   return true;
 }
 
+void Datafile::write_f3d_staged() {
+  // Apply the same selection as the plain loop: the per-variable write
+  // policies and skip_unchanged, using the generations recorded when
+  // the snapshot was taken
+  std::vector<std::size_t> towrite;
+  for (std::size_t i = 0; i < f3d_arr.size(); i++) {
+    auto& var = f3d_arr[i];
+    if (!shouldWrite(var))
+      continue;
+    if (var.skip_unchanged) {
+      unsigned int gen = f3d_gen_copy[i];
+      if (var.written && (gen == var.written_generation)) {
+        continue; // Not modified since it was last written
+      }
+      var.written_generation = gen;
+    }
+    towrite.push_back(i);
+  }
+
+  if (towrite.empty()) {
+    return;
+  }
+
+  const int n = mesh->LocalNx * mesh->LocalNy * mesh->LocalNz;
+
+  // Copy the snapshot into a staging slot and run the backend's lossy
+  // and sanitising passes on it there, so the put below is a straight
+  // write of an already-prepared buffer
+  auto stage = [this, n](std::size_t i, std::vector<BoutReal>& buf) {
+    const Field3D& f = f3d_copy[i];
+    if (f3d_arr[i].transpose) {
+      // Convert to the variable's (y,x,z) file layout while copying
+      // out of the snapshot; the put below then streams the buffer
+      // straight into the file
+      buf.resize(n);
+      transposeXYBlocked(&f(0, 0, 0), buf.data(), mesh->LocalNx, mesh->LocalNy,
+                         mesh->LocalNz);
+    } else {
+      buf.assign(&f(0, 0, 0), &f(0, 0, 0) + n);
+    }
+    file->prepare(buf.data(), n);
+  };
+
+  stage(towrite[0], stage_buffer[0]);
+  for (std::size_t k = 0; k < towrite.size(); k++) {
+    // Prepare the next variable in the other slot while this one is
+    // inside the library write. prepare() only reads the backend's
+    // configuration, so this does not race with the put
+    std::thread stager;
+    if (k + 1 < towrite.size()) {
+      stager = std::thread(stage, towrite[k + 1], std::ref(stage_buffer[(k + 1) % 2]));
+    }
+
+    auto& var = f3d_arr[towrite[k]];
+    file->setPreparedInput(true);
+    try {
+      if (var.save_repeat) {
+        file->write_rec_block(stage_buffer[k % 2].data(), var.name, mesh->LocalNx,
+                              mesh->LocalNy, mesh->LocalNz);
+      } else {
+        file->write_block(stage_buffer[k % 2].data(), var.name, mesh->LocalNx,
+                          mesh->LocalNy, mesh->LocalNz);
+      }
+    } catch (...) {
+      // The stager must be joined before the exception unwinds this
+      // frame, or its destructor terminates the program
+      file->setPreparedInput(false);
+      if (stager.joinable()) {
+        stager.join();
+      }
+      throw;
+    }
+    file->setPreparedInput(false);
+    var.written = true;
+
+    if (stager.joinable()) {
+      stager.join();
+    }
+  }
+}
+
+void Datafile::snapshotVars() {
+  int_copy.clear();
+  for (const auto& var : int_arr) {
+    int_copy.push_back(*(var.ptr));
+  }
+
+  BoutReal_copy.clear();
+  for (const auto& var : BoutReal_arr) {
+    BoutReal_copy.push_back(*(var.ptr));
+  }
+
+  f2d_copy.clear();
+  for (const auto& var : f2d_arr) {
+    f2d_copy.push_back(*(var.ptr));
+  }
+
+  f3d_copy.clear();
+  f3d_gen_copy.clear();
+  for (const auto& var : f3d_arr) {
+    f3d_copy.push_back(*(var.ptr));
+    f3d_gen_copy.push_back(var.ptr->getGeneration());
+  }
+
+  v2d_copy.clear();
+  for (const auto& var : v2d_arr) {
+    v2d_copy.push_back(*(var.ptr));
+  }
+
+  v3d_copy.clear();
+  for (const auto& var : v3d_arr) {
+    v3d_copy.push_back(*(var.ptr));
+  }
+}
+
+void Datafile::waitWrite() {
+  if (write_thread.joinable()) {
+    write_thread.join();
+  }
+}
+
 bool Datafile::write(const char *format, ...) const {
   if(!enabled)
     return true;
@@ -1163,35 +1552,54 @@ bool Datafile::write_f2d(const string &name, Field2D *f, bool save_repeat) {
   if (!f->isAllocated()) {
     throw BoutException("Datafile::write_f2d: Field2D '%s' is not allocated!", name.c_str());
   }
+
+  // The block path writes straight from the field's storage without
+  // modifying it, so no staging copy is needed
+  const Field2D &fc = *f;
   if (save_repeat) {
-    if (!file->write_rec(&((*f)(0, 0)), name, mesh->LocalNx, mesh->LocalNy)) {
+    if (!file->write_rec_block(&fc(0, 0), name, mesh->LocalNx, mesh->LocalNy)) {
       throw BoutException("Datafile::write_f2d: Failed to write %s!", name.c_str());
     }
   } else {
-    if (!file->write(&((*f)(0, 0)), name, mesh->LocalNx, mesh->LocalNy)) {
+    if (!file->write_block(&fc(0, 0), name, mesh->LocalNx, mesh->LocalNy)) {
       throw BoutException("Datafile::write_f2d: Failed to write %s!", name.c_str());
     }
   }
   return true;
 }
 
-bool Datafile::write_f3d(const string &name, Field3D *f, bool save_repeat) {
+bool Datafile::write_f3d(const string &name, Field3D *f, bool save_repeat,
+                         bool transpose) {
   if (!f->isAllocated()) {
     throw BoutException("Datafile::write_f3d: Field3D '%s' is not allocated!", name.c_str());
   }
 
-  //Deal with shifting the output
-  Field3D f_out(f->getMesh());
+  // Shifting to field-aligned space produces a new field; otherwise
+  // the block path writes straight from the field's storage
+  Field3D f_aligned(f->getMesh());
+  const Field3D *f_out = f;
   if(shiftOutput) {
-    f_out = mesh->toFieldAligned(*f);
-  }else {
-    f_out = *f;
+    f_aligned = mesh->toFieldAligned(*f);
+    f_out = &f_aligned;
+  }
+
+  if (transpose) {
+    // Convert to the variable's (y,x,z) file layout in a scratch
+    // buffer; the backend was told the layout when the variable was
+    // added (see setTransposeXY)
+    const int nx = mesh->LocalNx, ny = mesh->LocalNy, nz = mesh->LocalNz;
+    transpose_buffer.resize(static_cast<std::size_t>(nx) * ny * nz);
+    transposeXYBlocked(&((*f_out)(0, 0, 0)), transpose_buffer.data(), nx, ny, nz);
+    if (save_repeat) {
+      return file->write_rec_block(transpose_buffer.data(), name, nx, ny, nz);
+    }
+    return file->write_block(transpose_buffer.data(), name, nx, ny, nz);
   }
 
   if(save_repeat) {
-    return file->write_rec(&(f_out(0,0,0)), name, mesh->LocalNx, mesh->LocalNy, mesh->LocalNz);
+    return file->write_rec_block(&((*f_out)(0,0,0)), name, mesh->LocalNx, mesh->LocalNy, mesh->LocalNz);
   }else {
-    return file->write(&(f_out(0,0,0)), name, mesh->LocalNx, mesh->LocalNy, mesh->LocalNz);
+    return file->write_block(&((*f_out)(0,0,0)), name, mesh->LocalNx, mesh->LocalNy, mesh->LocalNz);
   }
 }
 
@@ -27,3 +27,27 @@ bool DataFormat::setLocalOrigin(int x, int y, int z, int UNUSED(offset_x),
                                 int UNUSED(offset_y), int UNUSED(offset_z)) {
   return setGlobalOrigin(x + mesh->OffsetX, y + mesh->OffsetY, z + mesh->OffsetZ);
 }
+
+bool DataFormat::write_block(const BoutReal *data, const string &name, int lx, int ly,
+                             int lz) {
+  // write() is allowed to sanitise its buffer in place, so pass it a
+  // copy to keep the caller's field storage intact
+  int n = lx;
+  if (ly > 0)
+    n *= ly;
+  if (lz > 0)
+    n *= lz;
+  std::vector<BoutReal> copy(data, data + n);
+  return write(copy.data(), name, lx, ly, lz);
+}
+
+bool DataFormat::write_rec_block(const BoutReal *data, const string &name, int lx,
+                                 int ly, int lz) {
+  int n = lx;
+  if (ly > 0)
+    n *= ly;
+  if (lz > 0)
+    n *= lz;
+  std::vector<BoutReal> copy(data, data + n);
+  return write_rec(copy.data(), name, lx, ly, lz);
+}
@@ -0,0 +1,321 @@
+/**************************************************************************
+ * Running time-statistics of fields, accumulated every timestep
+ *
+ **************************************************************************
+ * Copyright 2010 B.D.Dudson, S.Farley, M.V.Umansky, X.Q.Xu
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+#include <bout/fieldstats.hxx>
+
+#include <boutexception.hxx>
+#include <datafile.hxx>
+#include <bout/assert.hxx>
+#include <bout/monitor.hxx>
+#include <bout/openmpwrap.hxx>
+#include <bout/solver.hxx>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+/// FieldStats instances currently accumulating. Kept here rather than
+/// in the class so one pair of solver hooks serves every instance
+std::vector<FieldStats *> enabled_stats;
+
+int fieldstats_timestep_monitor(Solver *UNUSED(solver), BoutReal UNUSED(simtime),
+                                BoutReal lastdt) {
+  for (auto *s : enabled_stats) {
+    s->accumulate(lastdt);
+  }
+  return 0;
+}
+
+/// Finalises the moments of every accumulating instance. Added at the
+/// FRONT of the monitor list, so it runs before the BoutMonitor at the
+/// BACK writes the dump file
+class FieldStatsMonitor : public Monitor {
+public:
+  int call(Solver *UNUSED(solver), BoutReal UNUSED(time), int UNUSED(iter),
+           int UNUSED(nout)) override {
+    for (auto *s : enabled_stats) {
+      s->finalise();
+    }
+    return 0;
+  }
+};
+
+FieldStatsMonitor fieldstats_monitor;
+
+/// Keep the registry valid when an enabled FieldStats is moved
+void replaceEnabled(FieldStats *from, FieldStats *to) {
+  std::replace(enabled_stats.begin(), enabled_stats.end(), from, to);
+}
+
+void dropEnabled(FieldStats *s) {
+  replaceEnabled(s, nullptr);
+  enabled_stats.erase(std::remove(enabled_stats.begin(), enabled_stats.end(),
+                                  static_cast<FieldStats *>(nullptr)),
+                      enabled_stats.end());
+}
+} // namespace
+
+FieldStats::FieldStats(Options *opt) {
+  if (opt == nullptr) {
+    return; // To allow static initialisation
+  }
+
+  OPTION(opt, enabled, true);
+  OPTION(opt, reset_on_write, true);
+}
+
+FieldStats::FieldStats(FieldStats &&other) noexcept
+    : enabled(other.enabled), reset_on_write(other.reset_on_write),
+      stats(std::move(other.stats)), total_time(other.total_time) {
+  replaceEnabled(&other, this);
+}
+
+FieldStats& FieldStats::operator=(FieldStats &&rhs) noexcept {
+  dropEnabled(this);
+  enabled = rhs.enabled;
+  reset_on_write = rhs.reset_on_write;
+  stats = std::move(rhs.stats);
+  total_time = rhs.total_time;
+  replaceEnabled(&rhs, this);
+  return *this;
+}
+
+FieldStats::~FieldStats() {
+  dropEnabled(this);
+}
+
+void FieldStats::addMean(const Field3D &f, const std::string &name) {
+  stats.emplace_back();
+  Stat &s = stats.back();
+  s.type = StatType::Mean;
+  s.f = &f;
+  s.g = nullptr;
+  s.name = name;
+  s.mean = Field3D(0.0, f.getMesh());
+}
+
+void FieldStats::addRMS(const Field3D &f, const std::string &name) {
+  stats.emplace_back();
+  Stat &s = stats.back();
+  s.type = StatType::RMS;
+  s.f = &f;
+  s.g = nullptr;
+  s.name = name;
+  s.mean = Field3D(0.0, f.getMesh());
+  s.rms = Field3D(0.0, f.getMesh());
+}
+
+void FieldStats::addCovariance(const Field3D &f, const Field3D &g,
+                               const std::string &name) {
+  ASSERT1(f.getMesh() == g.getMesh());
+  stats.emplace_back();
+  Stat &s = stats.back();
+  s.type = StatType::Covariance;
+  s.f = &f;
+  s.g = &g;
+  s.name = name;
+  s.cov = Field3D(0.0, f.getMesh());
+}
+
+void FieldStats::outputVars(Datafile &file) {
+  for (Stat &s : stats) {
+    switch (s.type) {
+    case StatType::Mean:
+      file.addRepeat(s.mean, s.name + "_mean");
+      break;
+    case StatType::RMS:
+      file.addRepeat(s.mean, s.name + "_mean");
+      file.addRepeat(s.rms, s.name + "_rms");
+      break;
+    case StatType::Covariance:
+      file.addRepeat(s.cov, s.name + "_cov");
+      break;
+    }
+  }
+}
+
+void FieldStats::enable(Solver *solver) {
+  if (!enabled || stats.empty())
+    return;
+  if (std::find(enabled_stats.begin(), enabled_stats.end(), this)
+      != enabled_stats.end()) {
+    return; // Already accumulating
+  }
+  // The same hooks serve every instance, so register them with the
+  // solver only when the first instance is enabled
+  if (enabled_stats.empty()) {
+    solver->addTimestepMonitor(fieldstats_timestep_monitor);
+    solver->addMonitor(&fieldstats_monitor);
+  }
+  enabled_stats.push_back(this);
+}
+
+void FieldStats::disable(Solver *solver) {
+  dropEnabled(this);
+  if (enabled_stats.empty()) {
+    solver->removeTimestepMonitor(fieldstats_timestep_monitor);
+    solver->removeMonitor(&fieldstats_monitor);
+  }
+}
+
+void FieldStats::accumulate(BoutReal dt) {
+  if (dt <= 0.0)
+    return; // No time has passed, e.g. the initialisation call
+
+  for (Stat &s : stats) {
+    accumulateStat(s, dt);
+  }
+  total_time += dt;
+}
+
+void FieldStats::accumulateStat(Stat &s, BoutReal dt) {
+  ASSERT1(s.f->isAllocated());
+
+  const int n = s.f->getNx() * s.f->getNy() * s.f->getNz();
+  const BoutReal *f = &(*s.f)(0, 0, 0);
+
+  switch (s.type) {
+  case StatType::Mean: {
+    if (s.sf.size() != n) {
+      s.sf = Array<BoutReal>(n);
+      std::fill(s.sf.begin(), s.sf.end(), 0.0);
+    }
+    BoutReal *sf = s.sf.begin();
+    BOUT_OMP(parallel for)
+    for (int i = 0; i < n; ++i) {
+      sf[i] += dt * f[i];
+    }
+    break;
+  }
+  case StatType::RMS: {
+    if (s.sf.size() != n) {
+      s.sf = Array<BoutReal>(n);
+      s.sff = Array<BoutReal>(n);
+      std::fill(s.sf.begin(), s.sf.end(), 0.0);
+      std::fill(s.sff.begin(), s.sff.end(), 0.0);
+    }
+    BoutReal *sf = s.sf.begin();
+    BoutReal *sff = s.sff.begin();
+    // One pass: read the field once, update both moments
+    BOUT_OMP(parallel for)
+    for (int i = 0; i < n; ++i) {
+      const BoutReal v = f[i];
+      sf[i] += dt * v;
+      sff[i] += dt * v * v;
+    }
+    break;
+  }
+  case StatType::Covariance: {
+    ASSERT1(s.g->isAllocated());
+    if (s.sf.size() != n) {
+      s.sf = Array<BoutReal>(n);
+      s.sg = Array<BoutReal>(n);
+      s.sfg = Array<BoutReal>(n);
+      std::fill(s.sf.begin(), s.sf.end(), 0.0);
+      std::fill(s.sg.begin(), s.sg.end(), 0.0);
+      std::fill(s.sfg.begin(), s.sfg.end(), 0.0);
+    }
+    const BoutReal *g = &(*s.g)(0, 0, 0);
+    BoutReal *sf = s.sf.begin();
+    BoutReal *sg = s.sg.begin();
+    BoutReal *sfg = s.sfg.begin();
+    BOUT_OMP(parallel for)
+    for (int i = 0; i < n; ++i) {
+      const BoutReal vf = f[i];
+      const BoutReal vg = g[i];
+      sf[i] += dt * vf;
+      sg[i] += dt * vg;
+      sfg[i] += dt * vf * vg;
+    }
+    break;
+  }
+  }
+}
+
+void FieldStats::finalise() {
+  if (total_time <= 0.0)
+    return; // Nothing accumulated yet; the moment fields stay zero
+
+  const BoutReal inv = 1.0 / total_time;
+
+  for (Stat &s : stats) {
+    if (s.sf.size() == 0)
+      continue; // Never accumulated
+
+    const int n = s.sf.size();
+    const BoutReal *sf = s.sf.begin();
+
+    switch (s.type) {
+    case StatType::Mean: {
+      BoutReal *m = &s.mean(0, 0, 0);
+      BOUT_OMP(parallel for)
+      for (int i = 0; i < n; ++i) {
+        m[i] = sf[i] * inv;
+      }
+      if (reset_on_write) {
+        std::fill(s.sf.begin(), s.sf.end(), 0.0);
+      }
+      break;
+    }
+    case StatType::RMS: {
+      const BoutReal *sff = s.sff.begin();
+      BoutReal *m = &s.mean(0, 0, 0);
+      BoutReal *r = &s.rms(0, 0, 0);
+      BOUT_OMP(parallel for)
+      for (int i = 0; i < n; ++i) {
+        const BoutReal mv = sf[i] * inv;
+        m[i] = mv;
+        // Clip rounding error: the variance cannot be negative
+        const BoutReal var = sff[i] * inv - mv * mv;
+        r[i] = sqrt(var > 0.0 ? var : 0.0);
+      }
+      if (reset_on_write) {
+        std::fill(s.sf.begin(), s.sf.end(), 0.0);
+        std::fill(s.sff.begin(), s.sff.end(), 0.0);
+      }
+      break;
+    }
+    case StatType::Covariance: {
+      const BoutReal *sg = s.sg.begin();
+      const BoutReal *sfg = s.sfg.begin();
+      BoutReal *c = &s.cov(0, 0, 0);
+      BOUT_OMP(parallel for)
+      for (int i = 0; i < n; ++i) {
+        c[i] = sfg[i] * inv - (sf[i] * inv) * (sg[i] * inv);
+      }
+      if (reset_on_write) {
+        std::fill(s.sf.begin(), s.sf.end(), 0.0);
+        std::fill(s.sg.begin(), s.sg.end(), 0.0);
+        std::fill(s.sfg.begin(), s.sfg.end(), 0.0);
+      }
+      break;
+    }
+    }
+  }
+
+  if (reset_on_write) {
+    total_time = 0.0;
+  }
+}
@@ -9,6 +9,7 @@
 #include "impls/netcdf/nc_format.hxx"
 #include "impls/hdf5/h5_format.hxx"
 #include "impls/pnetcdf/pnetcdf.hxx"
+#include "impls/memory/memoryformat.hxx"
 
 #include <boutexception.hxx>
 #include <output.hxx>
@@ -96,6 +97,15 @@ std::unique_ptr<DataFormat> FormatFactory::createDataFormat(const char *filename
   }
 #endif
 
+  // No external library needed, so always available. Mainly useful as
+  // restart_format = mem, to hand restart state between chained runs
+  // in one job without touching the filesystem
+  const char *mem_match[] = {"mem"};
+  if(matchString(s, 1, mem_match) != -1) {
+    output.write("\tUsing in-memory format for '%s'\n", filename);
+    return std::unique_ptr<DataFormat>(new MemoryFormat);
+  }
+
 #ifdef HDF5
   const char *hdf5_match[] = {"h5","hdf","hdf5"};
   if(matchString(s, 3, hdf5_match) != -1) {
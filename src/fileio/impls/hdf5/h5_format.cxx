@@ -27,65 +27,142 @@
 
 #include <utils.hxx>
 #include <cmath>
+#include <cstdio>
 #include <string>
 #include <mpi.h>
 
+#include <options.hxx>
 #include <output.hxx>
 #include <msg_stack.hxx>
 #include <boutcomm.hxx>
 
 H5Format::H5Format(bool parallel_in) {
-  parallel = parallel_in;
-  x0 = y0 = z0 = t0 = 0;
-  lowPrecision = false;
-  fname = nullptr;
-  dataFile = -1;
-  chunk_length = 10; // could change this to try to optimize IO performance (i.e. allocate new chunks of disk space less often)
-  
-  dataFile_plist = H5Pcreate(H5P_FILE_ACCESS);
-  if (dataFile_plist < 0)
-    throw BoutException("Failed to create dataFile_plist");
-
-#ifdef PHDF5
-  if (parallel)
-    if (H5Pset_fapl_mpio(dataFile_plist, BoutComm::get(), MPI_INFO_NULL) < 0)
-      throw BoutException("Failed to set dataFile_plist");
-#endif
-
-  dataSet_plist = H5Pcreate(H5P_DATASET_XFER);
-  if (dataSet_plist < 0)
-    throw BoutException("Failed to create dataSet_plist");
+  initProperties(parallel_in);
+}
 
-#ifdef PHDF5
-  if (parallel)
-    if (H5Pset_dxpl_mpio(dataSet_plist, H5FD_MPIO_INDEPENDENT) < 0) // Default, independent writes
-//     if (H5Pset_dxpl_mpio(dataSet_plist, H5FD_MPIO_COLLECTIVE) < 0) // Alternative, collective writes
-      throw BoutException("Failed to set dataSet_plist");
-#endif
+H5Format::H5Format(const char *name, bool parallel_in) {
+  initProperties(parallel_in);
 
-  // Disable automatic printing of error messages so that we can catch
-  // errors without printing error messages to stdout
-  if (H5Eset_auto(H5E_DEFAULT, nullptr, nullptr) < 0)
-    throw BoutException("Failed to set error stack to not print errors");
+  H5Format::openr(name);
 }
 
-H5Format::H5Format(const char *name, bool parallel_in) {
+/// Creates the file-access and transfer property lists, applying the
+/// I/O tuning options from the [hdf5] section:
+///
+///     [hdf5]
+///     chunk_t = 10     # Time records per chunk
+///     chunk_x = 0      # Chunk shape in x/y/z; 0 = whole dimension.
+///     chunk_y = 0      # e.g. chunk_z = 1 lays the file out for
+///     chunk_z = 0      # z-slice analysis reads
+///     cache_mb = 0     # Raw chunk cache per dataset, 0 = library default
+///     alignment = 0    # File object alignment in bytes, e.g. the
+///                      # filesystem block size; 0 = library default
+///     collective = true  # Collective MPIO transfers (parallel mode;
+///                        # defaults to true there, unused otherwise)
+///     cb_write = false # Force two-phase collective buffering on writes
+///     cb_nodes = 0     # Aggregator processes for collective buffering,
+///                      # 0 = MPI-IO default (typically one per node)
+///     cb_buffer_mb = 0 # Collective buffer per aggregator, 0 = default
+///
+/// The cb_* options are passed to MPI-IO as hints (romio_cb_write,
+/// cb_nodes, cb_buffer_size), so small per-processor hyperslabs are
+/// aggregated into large contiguous filesystem writes by a subset of
+/// the processors. The defaults reproduce the previous behaviour
+void H5Format::initProperties(bool parallel_in) {
+#ifndef PHDF5
+  if (parallel_in)
+    throw BoutException("Parallel HDF5 output needs BOUT++ configured against a "
+                        "parallel HDF5 build (PHDF5); this build would have every "
+                        "processor open the shared file without MPI-IO");
+#endif
   parallel = parallel_in;
   x0 = y0 = z0 = t0 = 0;
   lowPrecision = false;
+  lowPrecision3D = false;
   fname = nullptr;
   dataFile = -1;
-  chunk_length = 10; // could change this to try to optimize IO performance (i.e. allocate new chunks of disk space less often)
-  
+
+  Options *opt = Options::getRoot()->getSection("hdf5");
+  int chunk_t, chunk_x_in, chunk_y_in, chunk_z_in, cache_mb, alignment_in;
+  opt->get("chunk_t", chunk_t, 10);
+  opt->get("chunk_x", chunk_x_in, 0);
+  opt->get("chunk_y", chunk_y_in, 0);
+  opt->get("chunk_z", chunk_z_in, 0);
+  opt->get("cache_mb", cache_mb, 0);
+  opt->get("alignment", alignment_in, 0);
+  // Collective transfers are the point of the shared-file mode, so
+  // they default on there; independent transfers can be selected for
+  // comparison
+  opt->get("collective", collective, parallel_in);
+
+  int cb_nodes, cb_buffer_mb;
+  bool cb_write;
+  opt->get("cb_nodes", cb_nodes, 0);
+  opt->get("cb_buffer_mb", cb_buffer_mb, 0);
+  opt->get("cb_write", cb_write, false);
+
+  if (chunk_t < 1) {
+    throw BoutException("H5Format: chunk_t must be at least 1");
+  }
+  chunk_length = chunk_t;
+  chunk_x = (chunk_x_in > 0) ? chunk_x_in : 0;
+  chunk_y = (chunk_y_in > 0) ? chunk_y_in : 0;
+  chunk_z = (chunk_z_in > 0) ? chunk_z_in : 0;
+  cache_bytes = (cache_mb > 0) ? static_cast<size_t>(cache_mb) * 1048576 : 0;
+  // Rule of thumb from the HDF5 documentation: a prime roughly 100
+  // times the number of chunks that fit in the cache; one slot per
+  // 16kB is a reasonable stand-in without knowing the chunk size
+  cache_slots = (cache_bytes > 0) ? (cache_bytes / 16384) | 1 : 0;
+  alignment = (alignment_in > 0) ? alignment_in : 0;
+
   dataFile_plist = H5Pcreate(H5P_FILE_ACCESS);
   if (dataFile_plist < 0)
     throw BoutException("Failed to create dataFile_plist");
 
+  if (cache_bytes > 0)
+    // Size the raw chunk cache so a whole chunk (or several) stays
+    // resident while it is filled by successive partial writes
+    if (H5Pset_cache(dataFile_plist, 0, cache_slots, cache_bytes, 0.75) < 0)
+      throw BoutException("Failed to set chunk cache on dataFile_plist");
+
+  if (alignment > 0)
+    // Align objects at least as large as the alignment itself, so
+    // chunks start on filesystem block/stripe boundaries
+    if (H5Pset_alignment(dataFile_plist, alignment, alignment) < 0)
+      throw BoutException("Failed to set alignment on dataFile_plist");
+
 #ifdef PHDF5
-  if (parallel)
-    if (H5Pset_fapl_mpio(dataFile_plist, BoutComm::get(), MPI_INFO_NULL) < 0)
+  if (parallel) {
+    // Pass the collective-buffering options to MPI-IO as hints, so a
+    // subset of processors aggregates the many small hyperslabs into
+    // large contiguous filesystem writes (two-phase I/O)
+    MPI_Info info = MPI_INFO_NULL;
+    if (cb_write || (cb_nodes > 0) || (cb_buffer_mb > 0)) {
+      MPI_Info_create(&info);
+      char value[32];
+      if (cb_write) {
+        MPI_Info_set(info, "romio_cb_write", "enable");
+      }
+      if (cb_nodes > 0) {
+        snprintf(value, sizeof(value), "%d", cb_nodes);
+        MPI_Info_set(info, "cb_nodes", value);
+      }
+      if (cb_buffer_mb > 0) {
+        snprintf(value, sizeof(value), "%ld",
+                 static_cast<long>(cb_buffer_mb) * 1048576);
+        MPI_Info_set(info, "cb_buffer_size", value);
+      }
+    }
+
+    // The property list keeps its own copy of the info object
+    if (H5Pset_fapl_mpio(dataFile_plist, BoutComm::get(), info) < 0)
       throw BoutException("Failed to set dataFile_plist");
-#endif  
+
+    if (info != MPI_INFO_NULL) {
+      MPI_Info_free(&info);
+    }
+  }
+#endif
 
   dataSet_plist = H5Pcreate(H5P_DATASET_XFER);
   if (dataSet_plist < 0)
@@ -93,7 +170,9 @@ H5Format::H5Format(const char *name, bool parallel_in) {
 
 #ifdef PHDF5
   if (parallel)
-    if (H5Pset_dxpl_mpio(dataSet_plist, H5FD_MPIO_COLLECTIVE) < 0)
+    if (H5Pset_dxpl_mpio(dataSet_plist,
+                         collective ? H5FD_MPIO_COLLECTIVE
+                                    : H5FD_MPIO_INDEPENDENT) < 0)
       throw BoutException("Failed to set dataSet_plist");
 #endif
 
@@ -101,8 +180,6 @@ H5Format::H5Format(const char *name, bool parallel_in) {
   // errors without printing error messages to stdout
   if (H5Eset_auto(H5E_DEFAULT, nullptr, nullptr) < 0)
     throw BoutException("Failed to set error stack to not print errors");
-
-  H5Format::openr(name);
 }
 
 H5Format::~H5Format() {
@@ -110,6 +187,22 @@ H5Format::~H5Format() {
   H5Pclose(dataFile_plist);
 }
 
+bool H5Format::openr(const string &name, int mype) {
+  if (parallel) {
+    // One shared file, opened collectively by every processor
+    return openr(name);
+  }
+  return DataFormat::openr(name, mype);
+}
+
+bool H5Format::openw(const string &name, int mype, bool append) {
+  if (parallel) {
+    // One shared file, created collectively by every processor
+    return openw(name, append);
+  }
+  return DataFormat::openw(name, mype, append);
+}
+
 bool H5Format::openr(const char *name) {
   TRACE("H5Format::openr");
 
@@ -285,6 +378,15 @@ bool H5Format::addVar(const string &name, bool repeat, hid_t write_hdf5_type, in
     hsize_t chunk_dims[4],max_dims[4];
     max_dims[0] = H5S_UNLIMITED; max_dims[1]=init_size[1]; max_dims[2]=init_size[2]; max_dims[3]=init_size[3];
     chunk_dims[0] = chunk_length; chunk_dims[1]=init_size[1]; chunk_dims[2]=init_size[2]; chunk_dims[3]=init_size[3];
+    // Apply the [hdf5] chunk shape options, clipped to the dataset
+    // extent. The z dimension is last in chunk_dims for 4D (Field3D)
+    // datasets, so chunk_z = 1 matches z-slice analysis reads
+    if ((chunk_x > 0) && (chunk_x < chunk_dims[1]))
+      chunk_dims[1] = chunk_x;
+    if ((chunk_y > 0) && (chunk_y < chunk_dims[2]))
+      chunk_dims[2] = chunk_y;
+    if ((nd == 4) && (chunk_z > 0) && (chunk_z < chunk_dims[3]))
+      chunk_dims[3] = chunk_z;
     if (H5Pset_chunk(propertyList, nd, chunk_dims) < 0)
       throw BoutException("Failed to set chunk property");
 
@@ -389,7 +491,7 @@ bool H5Format::addVarField2D(const string &name, bool repeat) {
 }
 
 bool H5Format::addVarField3D(const string &name, bool repeat) {
-  auto h5_float_type = lowPrecision ? H5T_NATIVE_FLOAT : H5T_NATIVE_DOUBLE;
+  auto h5_float_type = (lowPrecision || lowPrecision3D) ? H5T_NATIVE_FLOAT : H5T_NATIVE_DOUBLE;
   return addVar(name, repeat, h5_float_type, 3);
 }
 
@@ -474,7 +576,7 @@ bool H5Format::write(int *var, const string &name, int lx, int ly, int lz) {
 
 bool H5Format::write(BoutReal *data, const char *name, int lx, int ly, int lz) {
   
-  if(lowPrecision) {
+  if(lowPrecision || (lowPrecision3D && (lz > 0))) {
     // An out of range value can make the conversion
     // corrupt the whole dataset. Make sure everything
     // is in the range of a float
@@ -530,6 +632,7 @@ bool H5Format::write(void *data, hid_t mem_hdf5_type, const char *name, int lx,
   init_size_local[1] = mesh->LocalNy;
   init_size_local[2] = mesh->LocalNz;
 
+  bool empty_selection = false;
   if (nd==0) {
     // Need to write a scalar, not a 0-d array
     nd = 1;
@@ -537,28 +640,39 @@ bool H5Format::write(void *data, hid_t mem_hdf5_type, const char *name, int lx,
     offset[0] = 0;
     offset_local[0] = 0;
     init_size_local[0] = 1;
+    // In the shared-file parallel mode every processor holds the same
+    // value; one writer is enough, and the others take part in the
+    // (possibly collective) transfer with an empty selection
+    if (parallel && (BoutComm::rank() != 0))
+      empty_selection = true;
   }
-  
+
   hid_t mem_space = H5Screate_simple(nd, init_size_local, init_size_local);
   if (mem_space < 0)
     throw BoutException("Failed to create mem_space");
-  if (H5Sselect_hyperslab(mem_space, H5S_SELECT_SET, offset_local, /*stride=*/nullptr,
-                          counts, /*block=*/nullptr) < 0)
+  if (empty_selection) {
+    if (H5Sselect_none(mem_space) < 0)
+      throw BoutException("Failed to select none");
+  } else if (H5Sselect_hyperslab(mem_space, H5S_SELECT_SET, offset_local,
+                                 /*stride=*/nullptr, counts, /*block=*/nullptr) < 0)
     throw BoutException("Failed to select hyperslab");
-  
+
   hid_t dataSet = H5Dopen(dataFile, name, H5P_DEFAULT);
   if (dataSet < 0) {
     output_error.write("ERROR: HDF5 variable '%s' has not been added to file '%s'\n", name, fname);
     return false;
   }
-  
+
   hid_t dataSpace = H5Dget_space(dataSet);
   if (dataSpace < 0)
     throw BoutException("Failed to create dataSpace");
-  if (H5Sselect_hyperslab(dataSpace, H5S_SELECT_SET, offset, /*stride=*/nullptr, counts,
-                          /*block=*/nullptr) < 0)
+  if (empty_selection) {
+    if (H5Sselect_none(dataSpace) < 0)
+      throw BoutException("Failed to select none");
+  } else if (H5Sselect_hyperslab(dataSpace, H5S_SELECT_SET, offset,
+                                 /*stride=*/nullptr, counts, /*block=*/nullptr) < 0)
     throw BoutException("Failed to select hyperslab");
-  
+
   if (H5Dwrite(dataSet, mem_hdf5_type, mem_space, dataSpace, dataSet_plist, data) < 0)
     throw BoutException("Failed to write data");
   
@@ -680,7 +794,7 @@ bool H5Format::write_rec(int *var, const string &name, int lx, int ly, int lz) {
 
 bool H5Format::write_rec(BoutReal *data, const char *name, int lx, int ly, int lz) {
   
-  if(lowPrecision) {
+  if(lowPrecision || (lowPrecision3D && (lz > 0))) {
     // An out of range value can make the conversion
     // corrupt the whole dataset. Make sure everything
     // is in the range of a float
@@ -737,19 +851,29 @@ bool H5Format::write_rec(void *data, hid_t mem_hdf5_type, const char *name, int
   init_size_local[1] = mesh->LocalNy;
   init_size_local[2] = mesh->LocalNz;
 
+  bool empty_selection = false;
   if (nd_local == 0) {
     nd_local = 1;
     // Need to write a time-series of scalars
     counts_local[0] = 1;
     offset_local[0] = 0;
     init_size_local[0] = 1;
+    // In the shared-file parallel mode every processor holds the same
+    // value; one writer is enough, and the others take part in the
+    // (possibly collective) transfer with an empty selection
+    if (parallel && (BoutComm::rank() != 0))
+      empty_selection = true;
   }
-  
+
   hid_t mem_space = H5Screate_simple(nd_local, init_size_local, init_size_local);
   if (mem_space < 0)
     throw BoutException("Failed to create mem_space");
-  if (H5Sselect_hyperslab(mem_space, H5S_SELECT_SET, offset_local, /*stride=*/nullptr,
-                          counts_local, /*block=*/nullptr) < 0)
+  if (empty_selection) {
+    if (H5Sselect_none(mem_space) < 0)
+      throw BoutException("Failed to select none");
+  } else if (H5Sselect_hyperslab(mem_space, H5S_SELECT_SET, offset_local,
+                                 /*stride=*/nullptr, counts_local,
+                                 /*block=*/nullptr) < 0)
     throw BoutException("Failed to select hyperslab");
   
   hid_t dataSet = H5Dopen(dataFile, name, H5P_DEFAULT);
@@ -780,12 +904,16 @@ bool H5Format::write_rec(void *data, hid_t mem_hdf5_type, const char *name, int
   }
 
   offset[0]=t0;
-  
+
   hid_t dataSpace = H5Dget_space(dataSet);
   if (dataSpace < 0)
     throw BoutException("Failed to create dataSpace");
-  if (H5Sselect_hyperslab(dataSpace, H5S_SELECT_SET, offset, /*stride=*/nullptr, counts,
-                          /*block=*/nullptr) < 0)
+  if (empty_selection) {
+    if (H5Sselect_none(dataSpace) < 0)
+      throw BoutException("Failed to select none");
+  } else if (H5Sselect_hyperslab(dataSpace, H5S_SELECT_SET, offset,
+                                 /*stride=*/nullptr, counts,
+                                 /*block=*/nullptr) < 0)
     throw BoutException("Failed to select hyperslab");
   
   if (H5Dwrite(dataSet, mem_hdf5_type, mem_space, dataSpace, dataSet_plist, data) < 0)
@@ -66,6 +66,12 @@ class H5Format : public DataFormat {
   bool openr(const char *name) override;
   using DataFormat::openw;
   bool openw(const char *name, bool append=false) override;
+
+  /// In the parallel mode every processor opens the same shared file,
+  /// so the processor number is not inserted into the name; serial
+  /// mode keeps the per-processor files
+  bool openr(const string &name, int mype) override;
+  bool openw(const string &name, int mype, bool append = false) override;
   
   bool is_valid() override;
   
@@ -114,6 +120,7 @@ class H5Format : public DataFormat {
   bool write_rec(BoutReal *var, const string &name, int lx = 0, int ly = 0, int lz = 0) override;
   
   void setLowPrecision() override { lowPrecision = true; }
+  void setLowPrecision3D() override { lowPrecision3D = true; }
 
   // Attributes
 
@@ -133,12 +140,23 @@ class H5Format : public DataFormat {
   hid_t dataSet_plist;
 
   bool lowPrecision; ///< When writing, down-convert to floats
+  bool lowPrecision3D; ///< Down-convert only 3D field data to floats
   bool parallel;
 
   int x0, y0, z0, t0; ///< Data origins for file access
   int x0_local, y0_local, z0_local; ///< Data origins for memory access
   
-  hsize_t chunk_length;
+  // I/O tuning, read from the [hdf5] options section; see initProperties
+  hsize_t chunk_length;           ///< Time records per chunk
+  hsize_t chunk_x, chunk_y, chunk_z; ///< Chunk shape in the spatial
+                                     ///< dimensions, 0 = whole dimension
+  size_t cache_slots, cache_bytes; ///< Raw chunk cache size, 0 = library default
+  hsize_t alignment;  ///< File object alignment in bytes, 0 = library default
+  bool collective;    ///< Collective MPIO transfers in the parallel build?
+
+  /// Create the file-access and transfer property lists and apply the
+  /// [hdf5] tuning options; shared by the constructors
+  void initProperties(bool parallel_in);
 
   bool addVar(const string &name, bool repeat, hid_t write_hdf5_type, int nd);
   bool read(void *var, hid_t hdf5_type, const char *name, int lx = 1, int ly = 0, int lz = 0);
@@ -0,0 +1,379 @@
+/**************************************************************************
+ * In-memory data format
+ *
+ * Copyright 2010 B.D.Dudson, S.Farley, M.V.Umansky, X.Q.Xu
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+#include "memoryformat.hxx"
+
+#include <boutexception.hxx>
+#include <msg_stack.hxx>
+
+#include <algorithm>
+#include <cstring>
+
+std::map<std::string, MemoryFormat::MemFile> &MemoryFormat::store() {
+  // Constructed on first use, lives for the whole job so regions
+  // written by one run can be adopted by the next
+  static std::map<std::string, MemFile> regions;
+  return regions;
+}
+
+void MemoryFormat::erase(const std::string &name) {
+  store().erase(name);
+}
+
+size_t MemoryFormat::numElements(int lx, int ly, int lz) {
+  size_t n = (lx > 0) ? lx : 1;
+  if (ly > 0)
+    n *= ly;
+  if (lz > 0)
+    n *= lz;
+  return n;
+}
+
+std::vector<int> MemoryFormat::shape(int lx, int ly, int lz) {
+  std::vector<int> s;
+  s.push_back((lx > 0) ? lx : 1);
+  if (ly > 0) {
+    s.push_back(ly);
+    if (lz > 0)
+      s.push_back(lz);
+  }
+  return s;
+}
+
+MemoryFormat::MemoryFormat() {}
+
+MemoryFormat::MemoryFormat(const char *name) {
+  openr(name);
+}
+
+MemoryFormat::~MemoryFormat() {
+  // Note: does NOT discard the region; that is the point of this
+  // format. Call erase() to reclaim the memory
+  close();
+}
+
+bool MemoryFormat::openr(const char *name) {
+  TRACE("MemoryFormat::openr");
+
+  close();
+
+  auto it = store().find(name);
+  if (it == store().end()) {
+    // Nothing was written under this name in this job
+    return false;
+  }
+
+  fname = name;
+  file = &it->second;
+  valid = true;
+  return true;
+}
+
+bool MemoryFormat::openw(const char *name, bool append) {
+  TRACE("MemoryFormat::openw");
+
+  close();
+
+  if (!append) {
+    // Start the region afresh, like truncating a file
+    store()[name].clear();
+  }
+
+  fname = name;
+  file = &store()[name];
+  valid = true;
+  return true;
+}
+
+bool MemoryFormat::is_valid() {
+  return valid;
+}
+
+void MemoryFormat::close() {
+  // The region itself stays in the store
+  fname.clear();
+  file = nullptr;
+  valid = false;
+  t0 = 0;
+}
+
+MemoryFormat::MemVar *MemoryFormat::findVar(const std::string &name) {
+  if (file == nullptr)
+    return nullptr;
+  auto it = file->find(name);
+  if (it == file->end())
+    return nullptr;
+  return &it->second;
+}
+
+const vector<int> MemoryFormat::getSize(const char *var) {
+  return getSize(string(var));
+}
+
+const vector<int> MemoryFormat::getSize(const string &var) {
+  MemVar *v = findVar(var);
+  if (v == nullptr)
+    return {};
+  return v->dims;
+}
+
+bool MemoryFormat::setGlobalOrigin(int x, int y, int z) {
+  // Each processor keeps only its own local blocks, so there are no
+  // offsets into a global layout to set
+  return (x == 0) && (y == 0) && (z == 0);
+}
+
+bool MemoryFormat::setRecord(int t) {
+  t0 = t;
+  return true;
+}
+
+bool MemoryFormat::addVarInt(const string &name, bool repeat) {
+  MemVar &v = (*file)[name];
+  v.is_real = false;
+  v.repeat = repeat;
+  return true;
+}
+
+bool MemoryFormat::addVarBoutReal(const string &name, bool repeat) {
+  MemVar &v = (*file)[name];
+  v.is_real = true;
+  v.repeat = repeat;
+  return true;
+}
+
+bool MemoryFormat::addVarField2D(const string &name, bool repeat) {
+  return addVarBoutReal(name, repeat);
+}
+
+bool MemoryFormat::addVarField3D(const string &name, bool repeat) {
+  return addVarBoutReal(name, repeat);
+}
+
+bool MemoryFormat::read(int *var, const char *name, int lx, int ly, int lz) {
+  return read(var, string(name), lx, ly, lz);
+}
+
+bool MemoryFormat::read(int *var, const string &name, int lx, int ly, int lz) {
+  if ((var == nullptr) || (lx < 0) || (ly < 0) || (lz < 0))
+    return false;
+
+  MemVar *v = findVar(name);
+  if ((v == nullptr) || v->is_real)
+    return false;
+
+  size_t n = numElements(lx, ly, lz);
+  if (v->idata.size() < n)
+    return false;
+
+  std::copy(v->idata.begin(), v->idata.begin() + n, var);
+  return true;
+}
+
+bool MemoryFormat::read(BoutReal *var, const char *name, int lx, int ly, int lz) {
+  return read(var, string(name), lx, ly, lz);
+}
+
+bool MemoryFormat::read(BoutReal *var, const string &name, int lx, int ly, int lz) {
+  if ((var == nullptr) || (lx < 0) || (ly < 0) || (lz < 0))
+    return false;
+
+  MemVar *v = findVar(name);
+  if ((v == nullptr) || !v->is_real)
+    return false;
+
+  size_t n = numElements(lx, ly, lz);
+  if (v->rdata.size() < n)
+    return false;
+
+  std::copy(v->rdata.begin(), v->rdata.begin() + n, var);
+  return true;
+}
+
+bool MemoryFormat::write(int *var, const char *name, int lx, int ly, int lz) {
+  return write(var, string(name), lx, ly, lz);
+}
+
+bool MemoryFormat::write(int *var, const string &name, int lx, int ly, int lz) {
+  if ((var == nullptr) || (lx < 0) || (ly < 0) || (lz < 0))
+    return false;
+  if (file == nullptr)
+    return false;
+
+  MemVar &v = (*file)[name];
+  v.is_real = false;
+  v.dims = shape(lx, ly, lz);
+  size_t n = numElements(lx, ly, lz);
+  v.idata.assign(var, var + n);
+  return true;
+}
+
+bool MemoryFormat::write(BoutReal *var, const char *name, int lx, int ly, int lz) {
+  return write(var, string(name), lx, ly, lz);
+}
+
+bool MemoryFormat::write(BoutReal *var, const string &name, int lx, int ly, int lz) {
+  if ((var == nullptr) || (lx < 0) || (ly < 0) || (lz < 0))
+    return false;
+  if (file == nullptr)
+    return false;
+
+  MemVar &v = (*file)[name];
+  v.is_real = true;
+  v.dims = shape(lx, ly, lz);
+  size_t n = numElements(lx, ly, lz);
+  v.rdata.assign(var, var + n);
+  return true;
+}
+
+bool MemoryFormat::read_rec(int *var, const char *name, int lx, int ly, int lz) {
+  return read_rec(var, string(name), lx, ly, lz);
+}
+
+bool MemoryFormat::read_rec(int *var, const string &name, int lx, int ly, int lz) {
+  if ((var == nullptr) || (lx < 0) || (ly < 0) || (lz < 0))
+    return false;
+
+  MemVar *v = findVar(name);
+  if ((v == nullptr) || v->is_real || (v->records < 1))
+    return false;
+
+  // Negative record means the latest, as elsewhere
+  int rec = (t0 < 0) ? (v->records - 1) : t0;
+  if (rec >= v->records)
+    return false;
+
+  size_t n = numElements(lx, ly, lz);
+  if (v->idata.size() < (rec + 1) * n)
+    return false;
+
+  std::copy(v->idata.begin() + rec * n, v->idata.begin() + (rec + 1) * n, var);
+  return true;
+}
+
+bool MemoryFormat::read_rec(BoutReal *var, const char *name, int lx, int ly, int lz) {
+  return read_rec(var, string(name), lx, ly, lz);
+}
+
+bool MemoryFormat::read_rec(BoutReal *var, const string &name, int lx, int ly, int lz) {
+  if ((var == nullptr) || (lx < 0) || (ly < 0) || (lz < 0))
+    return false;
+
+  MemVar *v = findVar(name);
+  if ((v == nullptr) || !v->is_real || (v->records < 1))
+    return false;
+
+  int rec = (t0 < 0) ? (v->records - 1) : t0;
+  if (rec >= v->records)
+    return false;
+
+  size_t n = numElements(lx, ly, lz);
+  if (v->rdata.size() < (rec + 1) * n)
+    return false;
+
+  std::copy(v->rdata.begin() + rec * n, v->rdata.begin() + (rec + 1) * n, var);
+  return true;
+}
+
+bool MemoryFormat::write_rec(int *var, const char *name, int lx, int ly, int lz) {
+  return write_rec(var, string(name), lx, ly, lz);
+}
+
+bool MemoryFormat::write_rec(int *var, const string &name, int lx, int ly, int lz) {
+  if ((var == nullptr) || (lx < 0) || (ly < 0) || (lz < 0))
+    return false;
+  if (file == nullptr)
+    return false;
+
+  MemVar &v = (*file)[name];
+  v.is_real = false;
+  v.repeat = true;
+  v.dims = shape(lx, ly, lz);
+  size_t n = numElements(lx, ly, lz);
+  v.idata.insert(v.idata.end(), var, var + n);
+  v.records++;
+  return true;
+}
+
+bool MemoryFormat::write_rec(BoutReal *var, const char *name, int lx, int ly, int lz) {
+  return write_rec(var, string(name), lx, ly, lz);
+}
+
+bool MemoryFormat::write_rec(BoutReal *var, const string &name, int lx, int ly, int lz) {
+  if ((var == nullptr) || (lx < 0) || (ly < 0) || (lz < 0))
+    return false;
+  if (file == nullptr)
+    return false;
+
+  MemVar &v = (*file)[name];
+  v.is_real = true;
+  v.repeat = true;
+  v.dims = shape(lx, ly, lz);
+  size_t n = numElements(lx, ly, lz);
+  v.rdata.insert(v.rdata.end(), var, var + n);
+  v.records++;
+  return true;
+}
+
+void MemoryFormat::setAttribute(const string &varname, const string &attrname,
+                                const string &text) {
+  MemVar *v = findVar(varname);
+  if (v == nullptr)
+    throw BoutException("Variable '%s' not in memory region '%s'", varname.c_str(),
+                        fname.c_str());
+  v->str_attributes[attrname] = text;
+}
+
+void MemoryFormat::setAttribute(const string &varname, const string &attrname,
+                                int value) {
+  MemVar *v = findVar(varname);
+  if (v == nullptr)
+    throw BoutException("Variable '%s' not in memory region '%s'", varname.c_str(),
+                        fname.c_str());
+  v->int_attributes[attrname] = value;
+}
+
+bool MemoryFormat::getAttribute(const string &varname, const string &attrname,
+                                std::string &text) {
+  MemVar *v = findVar(varname);
+  if (v == nullptr)
+    return false;
+  auto it = v->str_attributes.find(attrname);
+  if (it == v->str_attributes.end())
+    return false;
+  text = it->second;
+  return true;
+}
+
+bool MemoryFormat::getAttribute(const string &varname, const string &attrname,
+                                int &value) {
+  MemVar *v = findVar(varname);
+  if (v == nullptr)
+    return false;
+  auto it = v->int_attributes.find(attrname);
+  if (it == v->int_attributes.end())
+    return false;
+  value = it->second;
+  return true;
+}
@@ -0,0 +1,149 @@
+/**************************************************************************
+ * In-memory data format, for handing state between runs in one job
+ *
+ * Keeps the written variables in a process-wide store keyed by file
+ * name, so a restart written with this format can be read back by a
+ * follow-on PhysicsModel in the same executable without touching the
+ * filesystem. Selected like any other format, by extension: setting
+ *
+ *     restart_format = mem
+ *
+ * makes phase transitions (equilibrium -> perturbation -> turbulence)
+ * pay only a memcpy per variable instead of a full write+read cycle.
+ * Each processor stores its own local blocks, so no communication is
+ * involved; the state must be adopted on the same number of
+ * processors, and does not survive the end of the job.
+ *
+ **************************************************************************
+ * Copyright 2010 B.D.Dudson, S.Farley, M.V.Umansky, X.Q.Xu
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+class MemoryFormat;
+
+#ifndef __MEMORYFORMAT_H__
+#define __MEMORYFORMAT_H__
+
+#include <dataformat.hxx>
+
+#include <map>
+#include <string>
+#include <vector>
+
+class MemoryFormat : public DataFormat {
+public:
+  MemoryFormat();
+  MemoryFormat(const char *name);
+  ~MemoryFormat() override;
+
+  using DataFormat::openr;
+  bool openr(const char *name) override;
+  using DataFormat::openw;
+  bool openw(const char *name, bool append = false) override;
+
+  bool is_valid() override;
+
+  void close() override;
+
+  void flush() override {}
+
+  const vector<int> getSize(const char *var) override;
+  const vector<int> getSize(const string &var) override;
+
+  bool setGlobalOrigin(int x = 0, int y = 0, int z = 0) override;
+  bool setRecord(int t) override;
+
+  bool addVarInt(const string &name, bool repeat) override;
+  bool addVarBoutReal(const string &name, bool repeat) override;
+  bool addVarField2D(const string &name, bool repeat) override;
+  bool addVarField3D(const string &name, bool repeat) override;
+
+  bool read(int *var, const char *name, int lx = 1, int ly = 0, int lz = 0) override;
+  bool read(int *var, const string &name, int lx = 1, int ly = 0, int lz = 0) override;
+  bool read(BoutReal *var, const char *name, int lx = 1, int ly = 0, int lz = 0) override;
+  bool read(BoutReal *var, const string &name, int lx = 1, int ly = 0, int lz = 0) override;
+
+  bool write(int *var, const char *name, int lx = 0, int ly = 0, int lz = 0) override;
+  bool write(int *var, const string &name, int lx = 0, int ly = 0, int lz = 0) override;
+  bool write(BoutReal *var, const char *name, int lx = 0, int ly = 0, int lz = 0) override;
+  bool write(BoutReal *var, const string &name, int lx = 0, int ly = 0, int lz = 0) override;
+
+  bool read_rec(int *var, const char *name, int lx = 1, int ly = 0, int lz = 0) override;
+  bool read_rec(int *var, const string &name, int lx = 1, int ly = 0, int lz = 0) override;
+  bool read_rec(BoutReal *var, const char *name, int lx = 1, int ly = 0, int lz = 0) override;
+  bool read_rec(BoutReal *var, const string &name, int lx = 1, int ly = 0, int lz = 0) override;
+
+  bool write_rec(int *var, const char *name, int lx = 0, int ly = 0, int lz = 0) override;
+  bool write_rec(int *var, const string &name, int lx = 0, int ly = 0, int lz = 0) override;
+  bool write_rec(BoutReal *var, const char *name, int lx = 0, int ly = 0, int lz = 0) override;
+  bool write_rec(BoutReal *var, const string &name, int lx = 0, int ly = 0, int lz = 0) override;
+
+  void setAttribute(const string &varname, const string &attrname,
+                    const string &text) override;
+  void setAttribute(const string &varname, const string &attrname,
+                    int value) override;
+  bool getAttribute(const string &varname, const string &attrname,
+                    std::string &text) override;
+  bool getAttribute(const string &varname, const string &attrname,
+                    int &value) override;
+
+  /// Discard the stored contents of region \p name (all processors
+  /// hold their own store, so this is purely local). Mainly for
+  /// reclaiming memory once a hand-off is complete
+  static void erase(const std::string &name);
+
+private:
+  /// One stored variable. Records of repeat variables are
+  /// concatenated in the data vector
+  struct MemVar {
+    bool is_real = true; ///< BoutReal data, as opposed to int
+    bool repeat = false; ///< Has a time dimension?
+    std::vector<int> dims; ///< Shape of one record, empty until written
+    std::vector<BoutReal> rdata;
+    std::vector<int> idata;
+    int records = 0; ///< Number of records held (repeat only)
+    std::map<std::string, std::string> str_attributes;
+    std::map<std::string, int> int_attributes;
+  };
+
+  /// The variables of one named region
+  using MemFile = std::map<std::string, MemVar>;
+
+  /// The process-wide store: named regions persist after close(), so
+  /// a later MemoryFormat can adopt them
+  static std::map<std::string, MemFile> &store();
+
+  std::string fname; ///< Name of the open region, empty if closed
+  bool valid = false;
+  int t0 = 0; ///< Current record, negative means latest
+
+  /// The open region's variables; nullptr when closed
+  MemFile *file = nullptr;
+
+  /// Find a variable in the open region, nullptr if absent
+  MemVar *findVar(const std::string &name);
+
+  /// Number of elements given sizes where 0 means "dimension absent"
+  static size_t numElements(int lx, int ly, int lz);
+  /// Shape with the absent trailing dimensions trimmed off
+  static std::vector<int> shape(int lx, int ly, int lz);
+};
+
+#endif // __MEMORYFORMAT_H__
@@ -27,6 +27,7 @@
 
 #include <utils.hxx>
 #include <cmath>
+#include <utility>
 
 #include <output.hxx>
 #include <msg_stack.hxx>
@@ -37,9 +38,11 @@
 NcFormat::NcFormat() {
   dataFile = nullptr;
   x0 = y0 = z0 = t0 = 0;
+  gridNx = gridNy = gridNz = -1;
   recDimList = new const NcDim*[4];
   dimList = recDimList+1;
   lowPrecision = false;
+  lowPrecision3D = false;
 
   default_rec = 0;
   rec_nr.clear();
@@ -50,9 +53,11 @@ NcFormat::NcFormat() {
 NcFormat::NcFormat(const char *name) {
   dataFile = nullptr;
   x0 = y0 = z0 = t0 = 0;
+  gridNx = gridNy = gridNz = -1;
   recDimList = new const NcDim*[4];
   dimList = recDimList+1;
   lowPrecision = false;
+  lowPrecision3D = false;
 
   default_rec = 0;
   rec_nr.clear();
@@ -168,7 +173,13 @@ bool NcFormat::openw(const char *name, bool append) {
 #endif
 
   if (dataFile != nullptr) // Already open. Close then re-open
-    close(); 
+    close();
+
+  // Dimension sizes: the local mesh sizes unless overridden for
+  // sub-box (output window) files
+  const long sizeX = (gridNx > 0) ? gridNx : mesh->LocalNx;
+  const long sizeY = (gridNy > 0) ? gridNy : mesh->LocalNy;
+  const long sizeZ = (gridNz > 0) ? gridNz : mesh->LocalNz;
 
   if(append) {
     dataFile = new NcFile(name, NcFile::Write);
@@ -211,7 +222,7 @@ bool NcFormat::openw(const char *name, bool append) {
 
     /// Test they're the right size (and t is unlimited)
     
-    if((xDim->size() != mesh->LocalNx) || (yDim->size() != mesh->LocalNy) || (zDim->size() != mesh->LocalNz)
+    if((xDim->size() != sizeX) || (yDim->size() != sizeY) || (zDim->size() != sizeZ)
        || (!tDim->is_unlimited()) ) {
       delete dataFile;
       dataFile = nullptr;
@@ -232,19 +243,19 @@ bool NcFormat::openw(const char *name, bool append) {
 
     /// Add the dimensions
     
-    if(!(xDim = dataFile->add_dim("x", mesh->LocalNx))) {
+    if(!(xDim = dataFile->add_dim("x", sizeX))) {
       delete dataFile;
       dataFile = nullptr;
       return false;
     }
   
-    if(!(yDim = dataFile->add_dim("y", mesh->LocalNy))) {
+    if(!(yDim = dataFile->add_dim("y", sizeY))) {
       delete dataFile;
       dataFile = nullptr;
       return false;
     }
     
-    if(!(zDim = dataFile->add_dim("z", mesh->LocalNz))) {
+    if(!(zDim = dataFile->add_dim("z", sizeZ))) {
       delete dataFile;
       dataFile = nullptr;
       return false;
@@ -344,6 +355,30 @@ const vector<int> NcFormat::getSize(const string &var) {
   return getSize(var.c_str());
 }
 
+vector<string> NcFormat::listVars() {
+  vector<string> names;
+
+#ifdef NCDF_VERBOSE
+  NcError err(NcError::verbose_nonfatal);
+#else
+  NcError err(NcError::silent_nonfatal);
+#endif
+
+  if(!is_valid())
+    return names;
+
+  TRACE("NcFormat::listVars");
+
+  for(int i = 0; i < dataFile->num_vars(); i++) {
+    NcVar *var = dataFile->get_var(i);
+    if((var != nullptr) && var->is_valid()) {
+      names.push_back(var->name());
+    }
+  }
+
+  return names;
+}
+
 bool NcFormat::setGlobalOrigin(int x, int y, int z) {
   x0 = x;
   y0 = y;
@@ -358,6 +393,14 @@ bool NcFormat::setRecord(int t) {
   return true;
 }
 
+bool NcFormat::setLocalGridSize(int nx, int ny, int nz) {
+  gridNx = nx;
+  gridNy = ny;
+  gridNz = nz;
+
+  return true;
+}
+
 // Add a variable to the file
 bool NcFormat::addVarInt(const string &name, bool repeat) {
   if(!is_valid())
@@ -456,8 +499,17 @@ bool NcFormat::addVarField3D(const string &name, bool repeat) {
   NcVar* var;
   if (!(var = dataFile->get_var(name.c_str()))) {
     // Variable not in file, so add it.
-    auto nc_float_type = lowPrecision ? ncFloat : ncDouble;
-    if (repeat)
+    auto nc_float_type = (lowPrecision || lowPrecision3D) ? ncFloat : ncDouble;
+    if (isTransposed(name.c_str())) {
+      // Stored with x and y interchanged, so (x,z) planes are
+      // contiguous in the file. The dimension names make the layout
+      // self-describing to readers
+      const NcDim *tdims[4] = {tDim, yDim, xDim, zDim};
+      if (repeat)
+        var = dataFile->add_var(name.c_str(), nc_float_type, 4, tdims);
+      else
+        var = dataFile->add_var(name.c_str(), nc_float_type, 3, &tdims[1]);
+    } else if (repeat)
       var = dataFile->add_var(name.c_str(), nc_float_type, 4, recDimList);
     else
       var = dataFile->add_var(name.c_str(), nc_float_type, 3, dimList);
@@ -470,6 +522,11 @@ bool NcFormat::addVarField3D(const string &name, bool repeat) {
   return true;
 }
 
+bool NcFormat::setTransposeXY(const string &name) {
+  transposed_vars.insert(name);
+  return true;
+}
+
 bool NcFormat::read(int *data, const char *name, int lx, int ly, int lz) {
   if(!is_valid())
     return false;
@@ -634,29 +691,23 @@ bool NcFormat::write(BoutReal *data, const char *name, int lx, int ly, int lz) {
   cur[0] = x0;    cur[1] = y0;    cur[2] = z0;
   counts[0] = lx; counts[1] = ly; counts[2] = lz;
 
+  if (isTransposed(name)) {
+    // Variable has dimensions (y, x, z); the caller supplies the data
+    // in that order (see setTransposeXY)
+    std::swap(cur[0], cur[1]);
+    std::swap(counts[0], counts[1]);
+  }
+
   if(!(var->set_cur(cur)))
     return false;
 
-  if(lowPrecision) {
-    // An out of range value can make the conversion
-    // corrupt the whole dataset. Make sure everything
-    // is in the range of a float
-    int i_max=1;
-    if (lx>0) i_max*=lx;
-    if (ly>0) i_max*=ly;
-    if (lz>0) i_max*=lz;
-    for(int i=0;i<i_max;i++) {
-      if(data[i] > 1e20)
-	data[i] = 1e20;
-      if(data[i] < -1e20)
-	data[i] = -1e20;
-    }
-  }
-  
-  for(int i=0;i<lx*ly*lz;i++) {
-    if(!finite(data[i]))
-      data[i] = 0.0;
-  }
+  int i_max=1;
+  if (lx>0) i_max*=lx;
+  if (ly>0) i_max*=ly;
+  if (lz>0) i_max*=lz;
+  if(!prepared_input)
+    prepare(data, i_max);
+  clamp3D(data, lx, ly, lz);
 
   if(!(var->put(data, counts)))
     return false;
@@ -837,26 +888,13 @@ bool NcFormat::write_rec(BoutReal *data, const char *name, int lx, int ly, int l
   output_info.write("INFO: NetCDF writing record %d of '%s' in '%s'\n",t, name, fname); 
 #endif
 
-  if(lowPrecision) {
-    // An out of range value can make the conversion
-    // corrupt the whole dataset. Make sure everything
-    // is in the range of a float
-    
-    for(int i=0;i<lx*ly*lz;i++) {
-      if(data[i] > 1e20)
-	data[i] = 1e20;
-      if(data[i] < -1e20)
-	data[i] = -1e20;
-    }
-  }
   int i_max=1;
   if (lx>0) i_max*=lx;
   if (ly>0) i_max*=ly;
   if (lz>0) i_max*=lz;
-  for(int i=0;i<i_max;i++) {
-    if(!finite(data[i]))
-      data[i] = 0.0;
-  }
+  if(!prepared_input)
+    prepare(data, i_max);
+  clamp3D(data, lx, ly, lz);
 
   // Add the record
   if(!var->put_rec(data, t))
@@ -874,6 +912,42 @@ bool NcFormat::write_rec(BoutReal *var, const string &name, int lx, int ly, int
   return write_rec(var, name.c_str(), lx, ly, lz);
 }
 
+void NcFormat::clamp3D(BoutReal *data, int lx, int ly, int lz) {
+  if(lowPrecision || !lowPrecision3D || (lz <= 0))
+    return; // Not a 3D-only float variable, or prepare() already clamped
+
+  // Same range clamp as prepare() applies when the whole file is floats
+  int n = lx;
+  if(ly > 0) n *= ly;
+  if(lz > 0) n *= lz;
+  for(int i=0;i<n;i++) {
+    if(data[i] > 1e20)
+      data[i] = 1e20;
+    if(data[i] < -1e20)
+      data[i] = -1e20;
+  }
+}
+
+void NcFormat::prepare(BoutReal *data, int n) {
+  if(lowPrecision) {
+    // An out of range value can make the conversion
+    // corrupt the whole dataset. Make sure everything
+    // is in the range of a float
+
+    for(int i=0;i<n;i++) {
+      if(data[i] > 1e20)
+	data[i] = 1e20;
+      if(data[i] < -1e20)
+	data[i] = -1e20;
+    }
+  }
+
+  for(int i=0;i<n;i++) {
+    if(!finite(data[i]))
+      data[i] = 0.0;
+  }
+}
+
 /***************************************************************************
  * Attributes
  ***************************************************************************/
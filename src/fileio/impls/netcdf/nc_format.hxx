@@ -51,6 +51,7 @@ class NcFormat;
 #include <netcdfcpp.h>
 
 #include <map>
+#include <set>
 #include <string>
 
 using std::string;
@@ -78,6 +79,8 @@ class NcFormat : public DataFormat {
 
   const vector<int> getSize(const char *var) override;
   const vector<int> getSize(const string &var) override;
+
+  vector<string> listVars() override;
   
   // Set the origin for all subsequent calls
   bool setGlobalOrigin(int x = 0, int y = 0, int z = 0) override;
@@ -86,6 +89,11 @@ class NcFormat : public DataFormat {
     return setGlobalOrigin(x,y,z);
   }
   bool setRecord(int t) override; // negative -> latest
+
+  /// Use the given sizes instead of the local mesh sizes for the x, y
+  /// and z dimensions of files opened for writing, for sub-box
+  /// (output window) files
+  bool setLocalGridSize(int nx, int ny, int nz) override;
   
   // Add a variable to the file
   bool addVarInt(const string &name, bool repeat) override;
@@ -117,7 +125,22 @@ class NcFormat : public DataFormat {
   bool write_rec(BoutReal *var, const char *name, int lx = 0, int ly = 0, int lz = 0) override;
   bool write_rec(BoutReal *var, const string &name, int lx = 0, int ly = 0, int lz = 0) override;
   
+  /// Low-precision range clamping and non-finite replacement, as
+  /// applied before a put. Only reads configuration, so it is safe to
+  /// call from a staging thread while another variable is being written
+  void prepare(BoutReal *data, int n) override;
+
+  /// Clamp 3D data into the range of a float when only the 3D fields
+  /// are single precision in the file; prepare() handles the
+  /// whole-file lowPrecision case
+  void clamp3D(BoutReal *data, int lx, int ly, int lz);
+
   void setLowPrecision() override { lowPrecision = true; }
+  void setLowPrecision3D() override { lowPrecision3D = true; }
+
+  /// Store 3D variable \p name with dimensions (t,) y, x, z. The write
+  /// routines then expect (y,x,z)-ordered data for this variable
+  bool setTransposeXY(const string &name) override;
 
   // Attributes
 
@@ -141,12 +164,22 @@ class NcFormat : public DataFormat {
   const NcDim **recDimList; ///< List of dimensions (t,x,y,z)
 
   bool lowPrecision; ///< When writing, down-convert to floats
+  bool lowPrecision3D; ///< Down-convert only 3D field data to floats
 
   int x0, y0, z0, t0; ///< Data origins
 
+  /// Sizes for the x,y,z dimensions; the local mesh sizes if <= 0.
+  /// See setLocalGridSize
+  int gridNx, gridNy, gridNz;
+
   map<string, int> rec_nr; // Record number for each variable (bit nasty)
   int default_rec;  // Starting record. Useful when appending to existing file
 
+  std::set<std::string> transposed_vars; ///< 3D variables stored (y,x,z); see setTransposeXY
+  bool isTransposed(const char *name) const {
+    return transposed_vars.find(name) != transposed_vars.end();
+  }
+
   void checkName(const char* name); ///< Check if a name contains invalid characters
   
 };
@@ -27,6 +27,8 @@
 #include <globals.hxx>
 #include <utils.hxx>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 
 #include <output.hxx>
 #include <msg_stack.hxx>
@@ -38,12 +40,34 @@ using namespace netCDF;
 // Define this to see loads of info messages
 //#define NCDF_VERBOSE
 
+/// Zero all but the leading \p bits bits of each double's mantissa
+/// ("bit grooming"). The values lose precision, but the repeated
+/// trailing zero bytes compress far better, especially after the
+/// shuffle filter
+static void groomMantissa(BoutReal *data, int n, int bits) {
+  if ((bits <= 0) || (bits >= 52))
+    return; // Nothing to remove
+
+  const uint64_t mask = ~((UINT64_C(1) << (52 - bits)) - 1);
+  for (int i = 0; i < n; i++) {
+    uint64_t bitpattern;
+    memcpy(&bitpattern, &data[i], sizeof(bitpattern));
+    bitpattern &= mask;
+    memcpy(&data[i], &bitpattern, sizeof(bitpattern));
+  }
+}
+
 Ncxx4::Ncxx4() {
   dataFile = nullptr;
   x0 = y0 = z0 = t0 = 0;
+  gridNx = gridNy = gridNz = -1;
   recDimList = new const NcDim*[4];
   dimList = recDimList+1;
   lowPrecision = false;
+  lowPrecision3D = false;
+  deflate_level = 0;
+  shuffle = false;
+  groom_bits = 0;
 
   default_rec = 0;
   rec_nr.clear();
@@ -54,9 +78,14 @@ Ncxx4::Ncxx4() {
 Ncxx4::Ncxx4(const char *name) {
   dataFile = nullptr;
   x0 = y0 = z0 = t0 = 0;
+  gridNx = gridNy = gridNz = -1;
   recDimList = new const NcDim*[4];
   dimList = recDimList+1;
   lowPrecision = false;
+  lowPrecision3D = false;
+  deflate_level = 0;
+  shuffle = false;
+  groom_bits = 0;
 
   default_rec = 0;
   rec_nr.clear();
@@ -126,13 +155,19 @@ bool Ncxx4::openr(const char *name) {
 
 bool Ncxx4::openw(const char *name, bool append) {
   TRACE("Ncxx4::openw");
-  
+
 #ifdef NCDF_VERBOSE
-  output.write("Ncxx4:: openw(%s, %d)\n", name, static_cast<int>(append)); 
+  output.write("Ncxx4:: openw(%s, %d)\n", name, static_cast<int>(append));
 #endif
 
   if (dataFile != nullptr) // Already open. Close then re-open
-    close(); 
+    close();
+
+  // Dimension sizes: the local mesh sizes unless overridden for
+  // sub-box (output window) files
+  const int sizeX = (gridNx > 0) ? gridNx : mesh->LocalNx;
+  const int sizeY = (gridNy > 0) ? gridNy : mesh->LocalNy;
+  const int sizeZ = (gridNz > 0) ? gridNz : mesh->LocalNz;
 
   if(append) {
     dataFile = new NcFile(name, NcFile::write);
@@ -178,9 +213,9 @@ bool Ncxx4::openw(const char *name, bool append) {
     }
 
     /// Test they're the right size (and t is unlimited)
-    if ((xDim.getSize() != static_cast<size_t>(mesh->LocalNx)) ||
-        (yDim.getSize() != static_cast<size_t>(mesh->LocalNy)) ||
-        (zDim.getSize() != static_cast<size_t>(mesh->LocalNz)) || (!tDim.isUnlimited())) {
+    if ((xDim.getSize() != static_cast<size_t>(sizeX)) ||
+        (yDim.getSize() != static_cast<size_t>(sizeY)) ||
+        (zDim.getSize() != static_cast<size_t>(sizeZ)) || (!tDim.isUnlimited())) {
       delete dataFile;
       dataFile = nullptr;
       return false;
@@ -200,21 +235,21 @@ bool Ncxx4::openw(const char *name, bool append) {
 
     /// Add the dimensions
     
-    xDim = dataFile->addDim("x", mesh->LocalNx);
+    xDim = dataFile->addDim("x", sizeX);
     if(xDim.isNull()) {
       delete dataFile;
       dataFile = nullptr;
       return false;
     }
   
-    yDim = dataFile->addDim("y", mesh->LocalNy);
+    yDim = dataFile->addDim("y", sizeY);
     if(yDim.isNull()) {
       delete dataFile;
       dataFile = nullptr;
       return false;
     }
     
-    zDim = dataFile->addDim("z", mesh->LocalNz);
+    zDim = dataFile->addDim("z", sizeZ);
     if(zDim.isNull()) {
       delete dataFile;
       dataFile = nullptr;
@@ -300,6 +335,20 @@ const std::vector<int> Ncxx4::getSize(const std::string &var) {
   return getSize(var.c_str());
 }
 
+std::vector<std::string> Ncxx4::listVars() {
+  TRACE("Ncxx4::listVars");
+
+  std::vector<std::string> names;
+  if(!is_valid())
+    return names;
+
+  for(const auto& var : dataFile->getVars()) {
+    names.push_back(var.first);
+  }
+
+  return names;
+}
+
 bool Ncxx4::setGlobalOrigin(int x, int y, int z) {
   x0 = x;
   y0 = y;
@@ -314,6 +363,14 @@ bool Ncxx4::setRecord(int t) {
   return true;
 }
 
+bool Ncxx4::setLocalGridSize(int nx, int ny, int nz) {
+  gridNx = nx;
+  gridNy = ny;
+  gridNz = nz;
+
+  return true;
+}
+
 // Add a variable to the file
 bool Ncxx4::addVarInt(const string &name, bool repeat) {
   if(!is_valid())
@@ -385,6 +442,12 @@ bool Ncxx4::addVarField2D(const string &name, bool repeat) {
       output_error.write("ERROR: NetCDF could not add Field2D '%s' to file '%s'\n", name.c_str(), fname);
       return false;
     }
+
+    if ((deflate_level > 0) || shuffle) {
+      // Switches the variable to chunked (NetCDF-4) storage and
+      // attaches the shuffle/deflate filters
+      var.setCompression(shuffle, deflate_level > 0, deflate_level);
+    }
   }
   return true;
 }
@@ -396,7 +459,7 @@ bool Ncxx4::addVarField3D(const string &name, bool repeat) {
   NcVar var = dataFile->getVar(name);
   if(var.isNull()) {
     // Variable not in file, so add it.
-    if(lowPrecision) {
+    if(lowPrecision || lowPrecision3D) {
       if (repeat)
         var = dataFile->addVar(name, ncFloat, getRecDimVec(4));
       else
@@ -412,6 +475,12 @@ bool Ncxx4::addVarField3D(const string &name, bool repeat) {
       output_error.write("ERROR: NetCDF could not add Field3D '%s' to file '%s'\n", name.c_str(), fname);
       return false;
     }
+
+    if ((deflate_level > 0) || shuffle) {
+      // Switches the variable to chunked (NetCDF-4) storage and
+      // attaches the shuffle/deflate filters
+      var.setCompression(shuffle, deflate_level > 0, deflate_level);
+    }
   }
   return true;
 }
@@ -546,23 +615,8 @@ bool Ncxx4::write(BoutReal *data, const char *name, int lx, int ly, int lz) {
   vector<size_t> counts(3);
   counts[0] = lx; counts[1] = ly; counts[2] = lz;
 
-  if(lowPrecision) {
-    // An out of range value can make the conversion
-    // corrupt the whole dataset. Make sure everything
-    // is in the range of a float
-    
-    for(int i=0;i<lx*ly*lz;i++) {
-      if(data[i] > 1e20)
-	data[i] = 1e20;
-      if(data[i] < -1e20)
-	data[i] = -1e20;
-    }
-  }
-  
-  for(int i=0;i<lx*ly*lz;i++) {
-    if(!finite(data[i]))
-      data[i] = 0.0;
-  }
+  prepare(data, lx * ly * lz);
+  clamp3D(data, lx, ly, lz);
 
   var.putVar(start, counts, data);
 
@@ -714,43 +768,230 @@ bool Ncxx4::write_rec(BoutReal *data, const char *name, int lx, int ly, int lz)
   output_info.write("INFO: NetCDF writing record %d of '%s' in '%s'\n",t, name, fname);
 #endif
 
+  prepare(data, lx * ly * lz);
+  clamp3D(data, lx, ly, lz);
+
+  vector<size_t> start(4);
+  start[0] = t; start[1] = x0; start[2] = y0; start[3] = z0;
+  vector<size_t> counts(4);
+  counts[0] = 1; counts[1] = lx; counts[2] = ly; counts[3] = lz;
+
+  // Add the record
+  var.putVar(start, counts, data);
+  
+  // Increment record number
+  rec_nr[name] = rec_nr[name] + 1;
+
+  return true;
+}
+
+bool Ncxx4::write_rec(BoutReal *var, const std::string &name, int lx, int ly, int lz) {
+  return write_rec(var, name.c_str(), lx, ly, lz);
+}
+
+/***************************************************************************
+ * Bulk writes from field storage
+ ***************************************************************************/
+
+void Ncxx4::prepare(BoutReal *data, int n) {
   if(lowPrecision) {
     // An out of range value can make the conversion
     // corrupt the whole dataset. Make sure everything
     // is in the range of a float
-    
-    for(int i=0;i<lx*ly*lz;i++) {
+
+    for(int i=0;i<n;i++) {
       if(data[i] > 1e20)
 	data[i] = 1e20;
       if(data[i] < -1e20)
 	data[i] = -1e20;
     }
   }
-  
-  for(int i=0;i<lx*ly*lz;i++) {
+
+  for(int i=0;i<n;i++) {
     if(!finite(data[i]))
       data[i] = 0.0;
   }
 
+  groomMantissa(data, n, groom_bits);
+}
+
+bool Ncxx4::needsSanitising(const BoutReal *data, int n) const {
+  if(prepared_input)
+    return false; // The caller already ran prepare() on this buffer
+
+  if(lowPrecision || (groom_bits > 0))
+    return true; // Lossy conversion modifies the values
+
+  for(int i=0;i<n;i++)
+    if(!finite(data[i]))
+      return true;
+  return false;
+}
+
+const float *Ncxx4::narrowToFloat(const BoutReal *data, int n) {
+  narrow_buffer.resize(n);
+  float *out = narrow_buffer.data();
+
+  BOUT_SIMD
+  for(int i=0;i<n;i++) {
+    BoutReal value = data[i];
+    if(!finite(value))
+      value = 0.0;
+    if(value > 1e20)
+      value = 1e20;
+    if(value < -1e20)
+      value = -1e20;
+    out[i] = static_cast<float>(value);
+  }
+
+  return out;
+}
+
+void Ncxx4::clamp3D(BoutReal *data, int lx, int ly, int lz) {
+  if(lowPrecision || !lowPrecision3D || (lz <= 0))
+    return; // Not a 3D-only float variable, or prepare() already clamped
+
+  // Same range clamp as prepare() applies when the whole file is floats
+  int n = lx;
+  if(ly > 0) n *= ly;
+  if(lz > 0) n *= lz;
+  for(int i=0;i<n;i++) {
+    if(data[i] > 1e20)
+      data[i] = 1e20;
+    if(data[i] < -1e20)
+      data[i] = -1e20;
+  }
+}
+
+bool Ncxx4::write_block(const BoutReal *data, const std::string &name, int lx, int ly, int lz) {
+  TRACE("Ncxx4::write_block");
+
+  if(!is_valid())
+    return false;
+
+  if((lx < 0) || (ly < 0) || (lz < 0))
+    return false;
+
+  int n = lx;
+  if(ly > 0) n *= ly;
+  if(lz > 0) n *= lz;
+
+  if((lz > 0) && (lowPrecision || lowPrecision3D) && (groom_bits <= 0)) {
+    // The variable is single precision in the file: narrow the data
+    // in the staging buffer ourselves and put floats, so half the
+    // bytes cross the library and its element-wise conversion of the
+    // double buffer is skipped
+    NcVar var = dataFile->getVar(name);
+    if(var.isNull()) {
+      output_error.write("ERROR: NetCDF BoutReal variable '%s' has not been added to file '%s'\n", name.c_str(), fname);
+      return false;
+    }
+
+    vector<size_t> start(3);
+    start[0] = x0; start[1] = y0; start[2] = z0;
+    vector<size_t> counts(3);
+    counts[0] = lx; counts[1] = ly; counts[2] = lz;
+
+    var.putVar(start, counts, narrowToFloat(data, n));
+
+    return true;
+  }
+
+  if(needsSanitising(data, n)) {
+    // The values must be modified before writing, so stage a copy
+    // rather than scribbling on the caller's field storage
+    sanitise_buffer.assign(data, data + n);
+    return write(sanitise_buffer.data(), name, lx, ly, lz);
+  }
+
+  NcVar var = dataFile->getVar(name);
+  if(var.isNull()) {
+    output_error.write("ERROR: NetCDF BoutReal variable '%s' has not been added to file '%s'\n", name.c_str(), fname);
+    return false;
+  }
+
+  vector<size_t> start(3);
+  start[0] = x0; start[1] = y0; start[2] = z0;
+  vector<size_t> counts(3);
+  counts[0] = lx; counts[1] = ly; counts[2] = lz;
+
+  // A single put directly from the caller's storage
+  var.putVar(start, counts, data);
+
+  return true;
+}
+
+bool Ncxx4::write_rec_block(const BoutReal *data, const std::string &name, int lx, int ly, int lz) {
+  TRACE("Ncxx4::write_rec_block");
+
+  if(!is_valid())
+    return false;
+
+  if((lx < 0) || (ly < 0) || (lz < 0))
+    return false;
+
+  int n = lx;
+  if(ly > 0) n *= ly;
+  if(lz > 0) n *= lz;
+
+  if((lz > 0) && (lowPrecision || lowPrecision3D) && (groom_bits <= 0)) {
+    // Single-precision variable: narrow in the staging buffer and put
+    // floats, as in write_block
+    NcVar var = dataFile->getVar(name);
+    if(var.isNull()) {
+      output_error.write("ERROR: NetCDF BoutReal variable '%s' has not been added to file '%s'\n", name.c_str(), fname);
+      return false;
+    }
+    if(rec_nr.find(name) == rec_nr.end()) {
+      rec_nr[name] = default_rec;
+    }
+
+    vector<size_t> start(4);
+    start[0] = rec_nr[name]; start[1] = x0; start[2] = y0; start[3] = z0;
+    vector<size_t> counts(4);
+    counts[0] = 1; counts[1] = lx; counts[2] = ly; counts[3] = lz;
+
+    var.putVar(start, counts, narrowToFloat(data, n));
+
+    rec_nr[name] = rec_nr[name] + 1;
+
+    return true;
+  }
+
+  if(needsSanitising(data, n)) {
+    sanitise_buffer.assign(data, data + n);
+    return write_rec(sanitise_buffer.data(), name, lx, ly, lz);
+  }
+
+  // Try to find variable
+  NcVar var = dataFile->getVar(name);
+  if(var.isNull()) {
+    output_error.write("ERROR: NetCDF BoutReal variable '%s' has not been added to file '%s'\n", name.c_str(), fname);
+    return false;
+  }else {
+    // Get record number
+    if(rec_nr.find(name) == rec_nr.end()) {
+      // Add to map
+      rec_nr[name] = default_rec;
+    }
+  }
+
+  int t = rec_nr[name];
+
   vector<size_t> start(4);
   start[0] = t; start[1] = x0; start[2] = y0; start[3] = z0;
   vector<size_t> counts(4);
   counts[0] = 1; counts[1] = lx; counts[2] = ly; counts[3] = lz;
 
-  // Add the record
+  // Add the record in a single put directly from the caller's storage
   var.putVar(start, counts, data);
-  
+
   // Increment record number
   rec_nr[name] = rec_nr[name] + 1;
 
   return true;
 }
 
-bool Ncxx4::write_rec(BoutReal *var, const std::string &name, int lx, int ly, int lz) {
-  return write_rec(var, name.c_str(), lx, ly, lz);
-}
-
-
 /***************************************************************************
  * Attributes
  ***************************************************************************/
@@ -76,6 +76,8 @@ class Ncxx4 : public DataFormat {
 
   const std::vector<int> getSize(const char *var) override;
   const std::vector<int> getSize(const std::string &var) override;
+
+  std::vector<std::string> listVars() override;
   
   // Set the origin for all subsequent calls
   bool setGlobalOrigin(int x = 0, int y = 0, int z = 0) override;
@@ -85,6 +87,11 @@ class Ncxx4 : public DataFormat {
   }
   bool setRecord(int t) override; // negative -> latest
 
+  /// Use the given sizes instead of the local mesh sizes for the x, y
+  /// and z dimensions of files opened for writing, for sub-box
+  /// (output window) files
+  bool setLocalGridSize(int nx, int ny, int nz) override;
+
   // Add a variable to the file
   bool addVarInt(const string &name, bool repeat) override;
   bool addVarBoutReal(const string &name, bool repeat) override;
@@ -114,8 +121,28 @@ class Ncxx4 : public DataFormat {
   bool write_rec(int *var, const std::string &name, int lx = 0, int ly = 0, int lz = 0) override;
   bool write_rec(BoutReal *var, const char *name, int lx = 0, int ly = 0, int lz = 0) override;
   bool write_rec(BoutReal *var, const std::string &name, int lx = 0, int ly = 0, int lz = 0) override;
-  
+
+  // Bulk writes in a single put directly from field storage; falls
+  // back to a staged copy only when the data needs sanitising first
+  bool write_block(const BoutReal *data, const std::string &name, int lx = 0,
+                   int ly = 0, int lz = 0) override;
+  bool write_rec_block(const BoutReal *data, const std::string &name, int lx = 0,
+                       int ly = 0, int lz = 0) override;
+
+  /// The lossy/sanitising passes applied before a put: low-precision
+  /// range clamping, non-finite replacement and mantissa grooming.
+  /// Only reads configuration, so it is safe to call from a staging
+  /// thread while another variable is being written
+  void prepare(BoutReal *data, int n) override;
+
   void setLowPrecision() override { lowPrecision = true; }
+  void setLowPrecision3D() override { lowPrecision3D = true; }
+
+  void setCompression(int level, bool shuf, int groombits) override {
+    deflate_level = level;
+    shuffle = shuf;
+    groom_bits = groombits;
+  }
 
   // Attributes
 
@@ -140,14 +167,40 @@ private:
 
   bool appending;
   bool lowPrecision; ///< When writing, down-convert to floats
+  bool lowPrecision3D; ///< Down-convert only 3D field data to floats
+
+  int deflate_level; ///< Deflate compression level for field variables, 0 = off
+  bool shuffle;      ///< Apply the byte-shuffle filter before deflating?
+  int groom_bits;    ///< If > 0, keep only this many mantissa bits when writing (lossy)
 
   int x0, y0, z0, t0; ///< Data origins
 
+  /// Sizes for the x,y,z dimensions; the local mesh sizes if <= 0.
+  /// See setLocalGridSize
+  int gridNx, gridNy, gridNz;
+
   std::map<std::string, int> rec_nr; // Record number for each variable (bit nasty)
   int default_rec;  // Starting record. Useful when appending to existing file
   
   std::vector<netCDF::NcDim> getDimVec(int nd);
   std::vector<netCDF::NcDim> getRecDimVec(int nd);
+
+  /// Does writing this data require modifying it first (clamping,
+  /// non-finite replacement or mantissa grooming)?
+  bool needsSanitising(const BoutReal *data, int n) const;
+  std::vector<BoutReal> sanitise_buffer; ///< Reused staging space for that case
+
+  /// Narrow \p data to single precision in the staging buffer, fusing
+  /// the float-range clamp and non-finite replacement into the same
+  /// vectorised pass, so a float variable can be put directly without
+  /// the library's element-wise conversion
+  const float *narrowToFloat(const BoutReal *data, int n);
+  std::vector<float> narrow_buffer; ///< Reused staging space for that case
+
+  /// Clamp 3D data into the range of a float when only the 3D fields
+  /// are single precision in the file; prepare() handles the
+  /// whole-file lowPrecision case
+  void clamp3D(BoutReal *data, int lx, int ly, int lz);
 };
 
 #endif // __NCFORMAT4_H__
@@ -30,8 +30,10 @@
 
 #include <pnetcdf.h> // Parallel NetCDF library
 
+#include <options.hxx>
 #include <utils.hxx>
 #include <cmath>
+#include <string>
 
 #include <output.hxx>
 #include <msg_stack.hxx>
@@ -41,6 +43,47 @@
 // Define this to see loads of info messages
 //#define NCDF_VERBOSE
 
+/// Build the MPI-IO hints used when opening a file, read from the
+/// [pnetcdf] options section. These control how the collective writes
+/// are aggregated before hitting the filesystem, which matters at
+/// scale: a handful of writer (aggregator) processes and sensible
+/// striping keep a 32k-rank job from overwhelming the metadata and
+/// object servers, while every rank still only communicates its own
+/// subdomain.
+///
+///     [pnetcdf]
+///     cb_nodes = 64           # Writer processes, 0 = library default
+///     striping_factor = 16    # Lustre stripe count, 0 = fs default
+///     striping_unit = 4194304 # Stripe size in bytes, 0 = fs default
+///     force_collective = true # Force collective buffering on
+///
+/// The caller owns the returned info object and must MPI_Info_free it
+/// once the file is open
+static MPI_Info makeFileHints() {
+  MPI_Info info;
+  MPI_Info_create(&info);
+
+  Options *opt = Options::getRoot()->getSection("pnetcdf");
+
+  int cb_nodes, striping_factor, striping_unit;
+  bool force_collective;
+  opt->get("cb_nodes", cb_nodes, 0);
+  opt->get("striping_factor", striping_factor, 0);
+  opt->get("striping_unit", striping_unit, 0);
+  opt->get("force_collective", force_collective, false);
+
+  if(cb_nodes > 0)
+    MPI_Info_set(info, "cb_nodes", std::to_string(cb_nodes).c_str());
+  if(striping_factor > 0)
+    MPI_Info_set(info, "striping_factor", std::to_string(striping_factor).c_str());
+  if(striping_unit > 0)
+    MPI_Info_set(info, "striping_unit", std::to_string(striping_unit).c_str());
+  if(force_collective)
+    MPI_Info_set(info, "romio_cb_write", "enable");
+
+  return info;
+}
+
 PncFormat::PncFormat() {
   x0 = y0 = z0 = t0 = 0;
   lowPrecision = false;
@@ -76,8 +119,11 @@ bool PncFormat::openr(const char *name) {
   MPI_Comm comm = BoutComm::get();
   
   /// Open file for reading
-  
-  ret = ncmpi_open(comm, name, NC_NOWRITE, MPI_INFO_NULL, &ncfile); CHKERR(ret);
+
+  MPI_Info info = makeFileHints();
+  ret = ncmpi_open(comm, name, NC_NOWRITE, info, &ncfile);
+  MPI_Info_free(&info);
+  CHKERR(ret);
   
   /// Get the dimensions from the file
   ret = ncmpi_inq_dimid(ncfile, "x", &xDim);
@@ -123,8 +169,12 @@ bool PncFormat::openw(const char *name, bool append) {
   int ret; // Return status
   MPI_Comm comm = BoutComm::get();
 
+  MPI_Info info = makeFileHints();
+
   if(append) {
-    ret = ncmpi_open(comm, name, NC_WRITE, MPI_INFO_NULL, &ncfile); CHKERR(ret);
+    ret = ncmpi_open(comm, name, NC_WRITE, info, &ncfile);
+    MPI_Info_free(&info);
+    CHKERR(ret);
     
     /// Get the dimensions from the file
     
@@ -157,8 +207,10 @@ bool PncFormat::openw(const char *name, bool append) {
     ret = ncmpi_create(comm,
                        name,
                        NC_WRITE|NC_64BIT_OFFSET,
-                       MPI_INFO_NULL,
-                       &ncfile); CHKERR(ret);
+                       info,
+                       &ncfile);
+    MPI_Info_free(&info);
+    CHKERR(ret);
     
     /// Add the dimensions
     
@@ -0,0 +1,342 @@
+/*********************************************************
+ * Probe output class
+ *
+ * Appends point/line/plane samples of registered fields to
+ * per-processor text streams, for high-frequency diagnostics which
+ * would be far too expensive to dump as full 3D fields.
+ *
+ **************************************************************************
+ * Copyright 2010 B.D.Dudson, S.Farley, M.V.Umansky, X.Q.Xu
+ *
+ * Contact Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *********************************************************/
+
+#include <bout/probefile.hxx>
+
+#include <bout/solver.hxx>
+#include <bout/sys/timer.hxx>
+#include <boutcomm.hxx>
+#include <boutexception.hxx>
+#include <field3d.hxx>
+#include <globals.hxx>
+#include <msg_stack.hxx>
+#include <unused.hxx>
+#include <utils.hxx>
+
+#include <algorithm>
+#include <cstdarg>
+
+namespace {
+/// ProbeFiles currently sampling through the timestep monitor.
+/// Kept here rather than in the class so a single monitor function can
+/// serve any number of instances
+std::vector<ProbeFile *> enabled_probes;
+
+int probefile_timestep_monitor(Solver *UNUSED(solver), BoutReal simtime,
+                               BoutReal UNUSED(lastdt)) {
+  for (auto *p : enabled_probes) {
+    p->sample(simtime);
+  }
+  return 0;
+}
+
+/// Keep the registry valid when an enabled ProbeFile is moved
+void replaceEnabled(ProbeFile *from, ProbeFile *to) {
+  std::replace(enabled_probes.begin(), enabled_probes.end(), from, to);
+}
+} // namespace
+
+ProbeFile::ProbeFile(Options *opt) {
+  if (opt == nullptr) {
+    return; // To allow static initialisation
+  }
+
+  OPTION(opt, enabled, true);
+  OPTION(opt, flush_every, 16); // Samples between explicit flushes
+
+  if (flush_every < 1) {
+    throw BoutException("ProbeFile: flush_every must be at least 1");
+  }
+}
+
+ProbeFile::ProbeFile(ProbeFile &&other) noexcept
+    : enabled(other.enabled), flush_every(other.flush_every), mype(other.mype),
+      fp(other.fp), first_time(other.first_time),
+      samples_since_flush(other.samples_since_flush),
+      probes(std::move(other.probes)) {
+  other.fp = nullptr;
+  replaceEnabled(&other, this);
+}
+
+ProbeFile& ProbeFile::operator=(ProbeFile &&rhs) noexcept {
+  close();
+  replaceEnabled(this, nullptr);
+  enabled = rhs.enabled;
+  flush_every = rhs.flush_every;
+  mype = rhs.mype;
+  fp = rhs.fp;
+  first_time = rhs.first_time;
+  samples_since_flush = rhs.samples_since_flush;
+  probes = std::move(rhs.probes);
+  rhs.fp = nullptr;
+  replaceEnabled(&rhs, this);
+  // Drop any null entries left by a moved-from object
+  enabled_probes.erase(std::remove(enabled_probes.begin(), enabled_probes.end(),
+                                   static_cast<ProbeFile *>(nullptr)),
+                       enabled_probes.end());
+  return *this;
+}
+
+ProbeFile::~ProbeFile() {
+  replaceEnabled(this, nullptr);
+  enabled_probes.erase(std::remove(enabled_probes.begin(), enabled_probes.end(),
+                                   static_cast<ProbeFile *>(nullptr)),
+                       enabled_probes.end());
+  close();
+}
+
+int ProbeFile::localX(int gx) const {
+  for (int x = mesh->xstart; x <= mesh->xend; x++) {
+    if (mesh->XGLOBAL(x) == gx) {
+      return x;
+    }
+  }
+  return -1;
+}
+
+int ProbeFile::localY(int gy) const {
+  for (int y = mesh->ystart; y <= mesh->yend; y++) {
+    if (mesh->YGLOBAL(y) == gy) {
+      return y;
+    }
+  }
+  return -1;
+}
+
+ProbeFile::Probe &ProbeFile::addProbe(const Field3D &f, const std::string &name) {
+  if (!first_time) {
+    // The header (and hence the column layout) is already in the file
+    throw BoutException("ProbeFile: cannot add probe '%s' after sampling has started",
+                        name.c_str());
+  }
+  for (const auto &probe : probes) {
+    if (probe.name == name) {
+      throw BoutException("Probe with name '%s' already added to ProbeFile",
+                          name.c_str());
+    }
+  }
+
+  Probe probe;
+  probe.ptr = &f;
+  probe.name = name;
+  probes.push_back(probe);
+  return probes.back();
+}
+
+void ProbeFile::addIfOwned(Probe &probe, int gx, int gy, int z) {
+  int x = localX(gx);
+  int y = localY(gy);
+  if ((x < 0) || (y < 0)) {
+    return; // Owned by another processor
+  }
+
+  ProbePoint pt;
+  pt.x = x;
+  pt.y = y;
+  pt.z = z;
+  probe.points.push_back(pt);
+
+  char label[64];
+  snprintf(label, sizeof(label), "%s[%d,%d,%d]", probe.name.c_str(), gx, gy, z);
+  probe.labels.push_back(label);
+}
+
+void ProbeFile::addPoint(const Field3D &f, const std::string &name, int gx, int gy,
+                         int gz) {
+  TRACE("ProbeFile::addPoint(%s)", name.c_str());
+  if (!enabled)
+    return;
+  if ((gz < 0) || (gz >= mesh->LocalNz)) {
+    throw BoutException("ProbeFile: z index %d for probe '%s' out of range", gz,
+                        name.c_str());
+  }
+  Probe &probe = addProbe(f, name);
+  addIfOwned(probe, gx, gy, gz);
+}
+
+void ProbeFile::addLineX(const Field3D &f, const std::string &name, int gy, int gz) {
+  TRACE("ProbeFile::addLineX(%s)", name.c_str());
+  if (!enabled)
+    return;
+  if ((gz < 0) || (gz >= mesh->LocalNz)) {
+    throw BoutException("ProbeFile: z index %d for probe '%s' out of range", gz,
+                        name.c_str());
+  }
+  Probe &probe = addProbe(f, name);
+  for (int x = mesh->xstart; x <= mesh->xend; x++) {
+    addIfOwned(probe, mesh->XGLOBAL(x), gy, gz);
+  }
+}
+
+void ProbeFile::addLineY(const Field3D &f, const std::string &name, int gx, int gz) {
+  TRACE("ProbeFile::addLineY(%s)", name.c_str());
+  if (!enabled)
+    return;
+  if ((gz < 0) || (gz >= mesh->LocalNz)) {
+    throw BoutException("ProbeFile: z index %d for probe '%s' out of range", gz,
+                        name.c_str());
+  }
+  Probe &probe = addProbe(f, name);
+  for (int y = mesh->ystart; y <= mesh->yend; y++) {
+    addIfOwned(probe, gx, mesh->YGLOBAL(y), gz);
+  }
+}
+
+void ProbeFile::addLineZ(const Field3D &f, const std::string &name, int gx, int gy) {
+  TRACE("ProbeFile::addLineZ(%s)", name.c_str());
+  if (!enabled)
+    return;
+  Probe &probe = addProbe(f, name);
+  for (int z = 0; z < mesh->LocalNz; z++) {
+    addIfOwned(probe, gx, gy, z);
+  }
+}
+
+void ProbeFile::addPlaneY(const Field3D &f, const std::string &name, int gy) {
+  TRACE("ProbeFile::addPlaneY(%s)", name.c_str());
+  if (!enabled)
+    return;
+  Probe &probe = addProbe(f, name);
+  for (int x = mesh->xstart; x <= mesh->xend; x++) {
+    for (int z = 0; z < mesh->LocalNz; z++) {
+      addIfOwned(probe, mesh->XGLOBAL(x), gy, z);
+    }
+  }
+}
+
+bool ProbeFile::open(const char *format, ...) {
+  if (!enabled)
+    return true;
+
+  if (format == nullptr) {
+    throw BoutException("ProbeFile::open: No argument given for opening file!");
+  }
+
+  size_t baselen = 512;
+  char *base = new char[baselen];
+  bout_vsnprintf(base, baselen, format);
+
+  MPI_Comm_rank(BoutComm::get(), &mype);
+
+  std::string name = std::string(base) + "." + std::to_string(mype) + ".dat";
+  delete[] base;
+
+  close(); // In case a file is already open
+
+  // Append, so a restarted run continues its traces
+  fp = fopen(name.c_str(), "a");
+  if (fp == nullptr) {
+    throw BoutException("ProbeFile::open: Failed to open file '%s'!", name.c_str());
+  }
+
+  return true;
+}
+
+void ProbeFile::close() {
+  if (fp == nullptr)
+    return;
+  fflush(fp);
+  fclose(fp);
+  fp = nullptr;
+}
+
+void ProbeFile::writeHeader() {
+  fprintf(fp, "# BOUT++ probe time series, processor %d\n", mype);
+  fprintf(fp, "# columns: t");
+  for (const auto &probe : probes) {
+    for (const auto &label : probe.labels) {
+      fprintf(fp, " %s", label.c_str());
+    }
+  }
+  fprintf(fp, "\n");
+}
+
+void ProbeFile::sample(BoutReal t) {
+  if (!enabled)
+    return;
+
+  TRACE("ProbeFile::sample()");
+  Timer timer("io");
+
+  if (fp == nullptr) {
+    throw BoutException("ProbeFile::sample: File is not open!");
+  }
+
+  if (first_time) {
+    first_time = false;
+    writeHeader();
+  }
+
+  fprintf(fp, "%.15e", t);
+  for (const auto &probe : probes) {
+    for (const auto &pt : probe.points) {
+      fprintf(fp, " %.12e", (*probe.ptr)(pt.x, pt.y, pt.z));
+    }
+  }
+  fprintf(fp, "\n");
+
+  // stdio buffers the small records; flush explicitly every
+  // flush_every samples so traces can be watched during a run
+  if (++samples_since_flush >= flush_every) {
+    samples_since_flush = 0;
+    fflush(fp);
+  }
+}
+
+void ProbeFile::flush() {
+  if (fp != nullptr) {
+    samples_since_flush = 0;
+    fflush(fp);
+  }
+}
+
+void ProbeFile::enable(Solver *solver) {
+  if (!enabled)
+    return;
+  if (std::find(enabled_probes.begin(), enabled_probes.end(), this)
+      != enabled_probes.end()) {
+    return; // Already sampling
+  }
+  // The same monitor function serves every instance, so register it
+  // with the solver only when the first instance is enabled
+  if (enabled_probes.empty()) {
+    solver->addTimestepMonitor(probefile_timestep_monitor);
+  }
+  enabled_probes.push_back(this);
+}
+
+void ProbeFile::disable(Solver *solver) {
+  replaceEnabled(this, nullptr);
+  enabled_probes.erase(std::remove(enabled_probes.begin(), enabled_probes.end(),
+                                   static_cast<ProbeFile *>(nullptr)),
+                       enabled_probes.end());
+  if (enabled_probes.empty()) {
+    solver->removeTimestepMonitor(probefile_timestep_monitor);
+  }
+}
@@ -0,0 +1,206 @@
+/**************************************************************************
+ * Fan-out restart reads through designated per-node reader ranks
+ *
+ * See include/bout/restart_fanout.hxx for the description and options
+ *
+ **************************************************************************
+ * Copyright 2010 B.D.Dudson, S.Farley, M.V.Umansky, X.Q.Xu
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+#include <bout/restart_fanout.hxx>
+
+#include <boutcomm.hxx>
+#include <boutexception.hxx>
+#include <msg_stack.hxx>
+#include <options.hxx>
+#include <output.hxx>
+#include <utils.hxx>
+
+#include "mpi.h"
+
+#include <fstream>
+#include <vector>
+
+namespace {
+
+enum FanoutTags { FANOUT_SIZE_TAG = 2314, FANOUT_DATA_TAG };
+
+/// Files stream between reader and peer in chunks of this size, so
+/// the message counts stay within int limits whatever the file size
+const long long fanout_chunk = 64 * 1024 * 1024;
+
+/// Per-processor restart filename, named the same way
+/// DataFormat::openr(name, mype) names the file it opens
+std::string rankFilename(const std::string &base, int mype) {
+  size_t pos = base.find_last_of('.');
+  return base.substr(0, pos) + "." + toString(mype) + "." + base.substr(pos + 1);
+}
+
+/// Read the whole of \p path, returning false if it cannot be opened
+bool slurpFile(const std::string &path, std::vector<char> &data) {
+  std::ifstream in(path.c_str(), std::ios::binary | std::ios::ate);
+  if (!in.good()) {
+    return false;
+  }
+  const std::streamsize size = in.tellg();
+  data.resize(size);
+  in.seekg(0);
+  if (size > 0) {
+    in.read(data.data(), size);
+  }
+  return in.good();
+}
+
+/// Send \p data to node rank \p peer: the size first (negative size
+/// signals the reader failed to read the peer's file), then the bytes
+/// in chunks
+void sendFile(const std::vector<char> &data, bool ok, int peer, MPI_Comm comm) {
+  long long size = ok ? static_cast<long long>(data.size()) : -1;
+  MPI_Send(&size, 1, MPI_LONG_LONG, peer, FANOUT_SIZE_TAG, comm);
+  for (long long off = 0; off < size; off += fanout_chunk) {
+    const int count = static_cast<int>(
+        (size - off < fanout_chunk) ? size - off : fanout_chunk);
+    MPI_Send(const_cast<char *>(data.data()) + off, count, MPI_BYTE, peer,
+             FANOUT_DATA_TAG, comm);
+  }
+}
+
+/// Receive a file sent with sendFile() from node rank \p reader,
+/// returning false if the reader signalled a read failure
+bool recvFile(std::vector<char> &data, int reader, MPI_Comm comm) {
+  long long size;
+  MPI_Recv(&size, 1, MPI_LONG_LONG, reader, FANOUT_SIZE_TAG, comm,
+           MPI_STATUS_IGNORE);
+  if (size < 0) {
+    return false;
+  }
+  data.resize(size);
+  for (long long off = 0; off < size; off += fanout_chunk) {
+    const int count = static_cast<int>(
+        (size - off < fanout_chunk) ? size - off : fanout_chunk);
+    MPI_Recv(data.data() + off, count, MPI_BYTE, reader, FANOUT_DATA_TAG, comm,
+             MPI_STATUS_IGNORE);
+  }
+  return true;
+}
+
+} // namespace
+
+std::string bout::fanoutRestartPath(const std::string &filename) {
+  TRACE("bout::fanoutRestartPath");
+
+  Options *opt = Options::getRoot()->getSection("restart");
+
+  bool fanout;
+  opt->get("fanout", fanout, false);
+  if (!fanout) {
+    return filename;
+  }
+
+  std::string stage_dir;
+  int readers_per_node;
+  opt->get("fanout_stage_dir", stage_dir, "/tmp");
+  opt->get("fanout_readers", readers_per_node, 1);
+
+  int mype;
+  MPI_Comm_rank(BoutComm::get(), &mype);
+
+  // The staged copy keeps the file's own name, so the returned base
+  // resolves to it once DataFormat inserts the processor number
+  size_t slash = filename.find_last_of('/');
+  const std::string fname =
+      (slash == std::string::npos) ? filename : filename.substr(slash + 1);
+  const std::string staged_base = stage_dir + "/" + fname;
+  const std::string staged = rankFilename(staged_base, mype);
+
+  // Group the processors sharing a node, so readers and the staging
+  // path are per node
+  MPI_Comm nodecomm;
+  MPI_Comm_split_type(BoutComm::get(), MPI_COMM_TYPE_SHARED, mype, MPI_INFO_NULL,
+                      &nodecomm);
+  int noderank, nodesize;
+  MPI_Comm_rank(nodecomm, &noderank);
+  MPI_Comm_size(nodecomm, &nodesize);
+
+  int nreaders = readers_per_node;
+  if (nreaders < 1) {
+    nreaders = 1;
+  }
+  if (nreaders > nodesize) {
+    nreaders = nodesize;
+  }
+
+  if (mype == 0) {
+    output.write("Fan-out restart read: %d reader(s) per node, staging in %s\n",
+                 nreaders, stage_dir.c_str());
+  }
+
+  // Node ranks [0, nreaders) read from the filesystem; peer p is
+  // served by reader p modulo nreaders. Each rank needs its peers' global
+  // ranks to name their files, so gather them within the node
+  std::vector<int> global_ranks(nodesize);
+  MPI_Allgather(&mype, 1, MPI_INT, global_ranks.data(), 1, MPI_INT, nodecomm);
+
+  std::vector<char> data;
+  bool ok = true;
+
+  if (noderank < nreaders) {
+    // A reader: stream each served peer's file in turn, own file first
+    ok = slurpFile(rankFilename(filename, mype), data);
+
+    for (int peer = noderank + nreaders; peer < nodesize; peer += nreaders) {
+      std::vector<char> peerdata;
+      const bool peerok = slurpFile(rankFilename(filename, global_ranks[peer]),
+                                    peerdata);
+      sendFile(peerdata, peerok, peer, nodecomm);
+    }
+  } else {
+    ok = recvFile(data, noderank % nreaders, nodecomm);
+  }
+
+  if (!ok) {
+    MPI_Comm_free(&nodecomm);
+    throw BoutException("Fan-out restart read: could not read %s\n",
+                        rankFilename(filename, mype).c_str());
+  }
+
+  {
+    std::ofstream out(staged.c_str(), std::ios::binary | std::ios::trunc);
+    if (!out.good()) {
+      MPI_Comm_free(&nodecomm);
+      throw BoutException("Fan-out restart read: could not write staged copy %s. "
+                          "Does fanout_stage_dir exist on every node?\n",
+                          staged.c_str());
+    }
+    if (!data.empty()) {
+      out.write(data.data(), data.size());
+    }
+    if (!out.good()) {
+      MPI_Comm_free(&nodecomm);
+      throw BoutException("Fan-out restart read: write to %s failed\n",
+                          staged.c_str());
+    }
+  }
+
+  MPI_Comm_free(&nodecomm);
+
+  return staged_base;
+}
@@ -0,0 +1,361 @@
+/*********************************************************
+ * Region-of-interest output windows
+ *
+ * Writes registered fields inside a global index box to
+ * per-processor binary files at high cadence, so small regions such
+ * as an X-point or divertor target can be resolved in time without
+ * dumping global 3D fields.
+ *
+ **************************************************************************
+ * Copyright 2010 B.D.Dudson, S.Farley, M.V.Umansky, X.Q.Xu
+ *
+ * Contact Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *********************************************************/
+
+#include <bout/windowfile.hxx>
+
+#include <bout/solver.hxx>
+#include <bout/sys/timer.hxx>
+#include <boutcomm.hxx>
+#include <boutexception.hxx>
+#include <dataformat.hxx>
+#include <field3d.hxx>
+#include <globals.hxx>
+#include <msg_stack.hxx>
+#include <unused.hxx>
+#include <utils.hxx>
+
+#include "formatfactory.hxx"
+
+#include <algorithm>
+#include <cstdarg>
+
+namespace {
+/// WindowFiles currently sampling through the timestep monitor.
+/// Kept here rather than in the class so a single monitor function can
+/// serve any number of instances
+std::vector<WindowFile *> enabled_windows;
+
+int windowfile_timestep_monitor(Solver *UNUSED(solver), BoutReal simtime,
+                                BoutReal UNUSED(lastdt)) {
+  for (auto *w : enabled_windows) {
+    w->sample(simtime);
+  }
+  return 0;
+}
+
+/// Keep the registry valid when an enabled WindowFile is moved
+void replaceEnabled(WindowFile *from, WindowFile *to) {
+  std::replace(enabled_windows.begin(), enabled_windows.end(), from, to);
+}
+} // namespace
+
+WindowFile::WindowFile(Options *opt, const std::string &name) : name(name) {
+  if (opt == nullptr) {
+    return; // To allow static initialisation
+  }
+
+  OPTION(opt, enabled, true);
+  OPTION(opt, every, 1); // Internal timesteps between samples
+
+  if (every < 1) {
+    throw BoutException("WindowFile '%s': every must be at least 1", name.c_str());
+  }
+
+  // The index box, inclusive. Global x and y; z is the same on every
+  // processor. -1 means the full range, resolved in open() since the
+  // mesh may not exist yet
+  OPTION(opt, xmin, 0);
+  OPTION(opt, xmax, -1);
+  OPTION(opt, ymin, 0);
+  OPTION(opt, ymax, -1);
+  OPTION(opt, zmin, 0);
+  OPTION(opt, zmax, -1);
+
+  if ((xmin < 0) || (ymin < 0) || (zmin < 0)) {
+    throw BoutException("WindowFile '%s': window minimum indices must be >= 0",
+                        name.c_str());
+  }
+}
+
+WindowFile::WindowFile(WindowFile &&other) noexcept
+    : enabled(other.enabled), every(other.every), name(std::move(other.name)),
+      xmin(other.xmin), xmax(other.xmax), ymin(other.ymin), ymax(other.ymax),
+      zmin(other.zmin), zmax(other.zmax), lx0(other.lx0), lxn(other.lxn),
+      ly0(other.ly0), lyn(other.lyn), lz0(other.lz0), lzn(other.lzn),
+      gx0(other.gx0), gy0(other.gy0), gz0(other.gz0), have_data(other.have_data),
+      file(std::move(other.file)), mype(other.mype), first_time(other.first_time),
+      steps(other.steps), vars(std::move(other.vars)),
+      buffer(std::move(other.buffer)) {
+  replaceEnabled(&other, this);
+}
+
+WindowFile& WindowFile::operator=(WindowFile &&rhs) noexcept {
+  close();
+  replaceEnabled(this, nullptr);
+  enabled = rhs.enabled;
+  every = rhs.every;
+  name = std::move(rhs.name);
+  xmin = rhs.xmin; xmax = rhs.xmax;
+  ymin = rhs.ymin; ymax = rhs.ymax;
+  zmin = rhs.zmin; zmax = rhs.zmax;
+  lx0 = rhs.lx0; lxn = rhs.lxn;
+  ly0 = rhs.ly0; lyn = rhs.lyn;
+  lz0 = rhs.lz0; lzn = rhs.lzn;
+  gx0 = rhs.gx0; gy0 = rhs.gy0; gz0 = rhs.gz0;
+  have_data = rhs.have_data;
+  file = std::move(rhs.file);
+  mype = rhs.mype;
+  first_time = rhs.first_time;
+  steps = rhs.steps;
+  vars = std::move(rhs.vars);
+  buffer = std::move(rhs.buffer);
+  replaceEnabled(&rhs, this);
+  // Drop any null entries left by a moved-from object
+  enabled_windows.erase(std::remove(enabled_windows.begin(), enabled_windows.end(),
+                                    static_cast<WindowFile *>(nullptr)),
+                        enabled_windows.end());
+  return *this;
+}
+
+WindowFile::~WindowFile() {
+  close();
+  replaceEnabled(this, nullptr);
+  enabled_windows.erase(std::remove(enabled_windows.begin(), enabled_windows.end(),
+                                    static_cast<WindowFile *>(nullptr)),
+                        enabled_windows.end());
+}
+
+void WindowFile::add(const Field3D &f, const std::string &varname) {
+  TRACE("WindowFile::add(%s)", varname.c_str());
+  if (!enabled)
+    return;
+  if (!first_time) {
+    throw BoutException("WindowFile '%s': cannot add '%s' after sampling has started",
+                        name.c_str(), varname.c_str());
+  }
+  for (const auto &var : vars) {
+    if (var.name == varname) {
+      throw BoutException("WindowFile '%s': variable '%s' already added",
+                          name.c_str(), varname.c_str());
+    }
+  }
+  vars.push_back({&f, varname});
+}
+
+void WindowFile::computeIntersection() {
+  // Resolve full-range defaults now the mesh exists
+  if (xmax < 0)
+    xmax = mesh->GlobalNx - 1;
+  if (ymax < 0)
+    ymax = mesh->GlobalNy - 1;
+  if (zmax < 0)
+    zmax = mesh->LocalNz - 1;
+
+  if ((xmax < xmin) || (ymax < ymin) || (zmax < zmin)) {
+    throw BoutException("WindowFile '%s': empty window box [%d:%d, %d:%d, %d:%d]",
+                        name.c_str(), xmin, xmax, ymin, ymax, zmin, zmax);
+  }
+
+  // Intersect with this processor's owned region. The owned x and y
+  // index ranges are contiguous, so only the start and count are needed
+  lx0 = -1;
+  lxn = 0;
+  for (int x = mesh->xstart; x <= mesh->xend; x++) {
+    const int gx = mesh->XGLOBAL(x);
+    if ((gx >= xmin) && (gx <= xmax)) {
+      if (lx0 < 0)
+        lx0 = x;
+      lxn++;
+    }
+  }
+
+  ly0 = -1;
+  lyn = 0;
+  for (int y = mesh->ystart; y <= mesh->yend; y++) {
+    const int gy = mesh->YGLOBAL(y);
+    if ((gy >= ymin) && (gy <= ymax)) {
+      if (ly0 < 0)
+        ly0 = y;
+      lyn++;
+    }
+  }
+
+  // z is not decomposed
+  lz0 = zmin;
+  lzn = std::min(zmax, mesh->LocalNz - 1) - zmin + 1;
+
+  have_data = (lxn > 0) && (lyn > 0) && (lzn > 0);
+  if (have_data) {
+    gx0 = mesh->XGLOBAL(lx0);
+    gy0 = mesh->YGLOBAL(ly0);
+    gz0 = lz0;
+    buffer.resize(static_cast<size_t>(lxn) * lyn * lzn);
+  }
+}
+
+bool WindowFile::open(const char *format, ...) {
+  if (!enabled)
+    return true;
+
+  if (format == nullptr) {
+    throw BoutException("WindowFile::open: No argument given for opening file!");
+  }
+
+  size_t filenamelen = 512;
+  char *filename = new char[filenamelen];
+  bout_vsnprintf(filename, filenamelen, format);
+
+  MPI_Comm_rank(BoutComm::get(), &mype);
+
+  computeIntersection();
+
+  if (!have_data) {
+    // This processor owns no part of the window, so opens no file
+    delete[] filename;
+    return true;
+  }
+
+  close(); // In case a file is already open
+
+  // The extension selects the format, as for dump files
+  file = FormatFactory::getInstance()->createDataFormat(filename, false);
+  if (!file) {
+    throw BoutException("WindowFile '%s': Could not create data format for '%s'",
+                        name.c_str(), filename);
+  }
+
+  if (!file->setLocalGridSize(lxn, lyn, lzn)) {
+    throw BoutException("WindowFile '%s': file format of '%s' cannot write window "
+                        "(sub-box) sizes. Use a NetCDF format",
+                        name.c_str(), filename);
+  }
+
+  if (!file->openw(string(filename), mype)) {
+    throw BoutException("WindowFile '%s': Failed to open file '%s'",
+                        name.c_str(), filename);
+  }
+
+  delete[] filename;
+  return true;
+}
+
+void WindowFile::close() {
+  if (!file)
+    return;
+  file->close();
+  file = nullptr;
+}
+
+void WindowFile::addVariables() {
+  file->addVarBoutReal("t_array", true);
+
+  // Global origin of this processor's part of the box, for reassembly
+  file->addVarInt("window_x0", false);
+  file->addVarInt("window_y0", false);
+  file->addVarInt("window_z0", false);
+  file->write(&gx0, "window_x0");
+  file->write(&gy0, "window_y0");
+  file->write(&gz0, "window_z0");
+
+  for (const auto &var : vars) {
+    if (!file->addVarField3D(var.name, true)) {
+      throw BoutException("WindowFile '%s': Failed to add variable '%s'",
+                          name.c_str(), var.name.c_str());
+    }
+  }
+}
+
+void WindowFile::sample(BoutReal t) {
+  if (!enabled)
+    return;
+
+  // Sample only every "every"-th internal timestep
+  if (++steps < every)
+    return;
+  steps = 0;
+
+  const bool first = first_time;
+  first_time = false; // No more variables can be registered
+
+  if (!have_data)
+    return;
+
+  TRACE("WindowFile::sample()");
+  Timer timer("io");
+
+  if (!file || !file->is_valid()) {
+    throw BoutException("WindowFile '%s': File is not open!", name.c_str());
+  }
+
+  if (first) {
+    addVariables();
+  }
+
+  file->write_rec(&t, "t_array");
+
+  for (const auto &var : vars) {
+    // Copy the locally owned part of the box into a contiguous
+    // buffer, in the (x, y, z) order of the file dimensions
+    const Field3D &f = *var.ptr;
+    size_t i = 0;
+    for (int x = lx0; x < lx0 + lxn; x++) {
+      for (int y = ly0; y < ly0 + lyn; y++) {
+        for (int z = lz0; z < lz0 + lzn; z++) {
+          buffer[i++] = f(x, y, z);
+        }
+      }
+    }
+    if (!file->write_rec(buffer.data(), var.name, lxn, lyn, lzn)) {
+      throw BoutException("WindowFile '%s': Failed to write variable '%s'",
+                          name.c_str(), var.name.c_str());
+    }
+  }
+}
+
+void WindowFile::flush() {
+  if (file) {
+    file->flush();
+  }
+}
+
+void WindowFile::enable(Solver *solver) {
+  if (!enabled)
+    return;
+  if (std::find(enabled_windows.begin(), enabled_windows.end(), this)
+      != enabled_windows.end()) {
+    return; // Already sampling
+  }
+  // The same monitor function serves every instance, so register it
+  // with the solver only when the first instance is enabled
+  if (enabled_windows.empty()) {
+    solver->addTimestepMonitor(windowfile_timestep_monitor);
+  }
+  enabled_windows.push_back(this);
+}
+
+void WindowFile::disable(Solver *solver) {
+  replaceEnabled(this, nullptr);
+  enabled_windows.erase(std::remove(enabled_windows.begin(), enabled_windows.end(),
+                                    static_cast<WindowFile *>(nullptr)),
+                        enabled_windows.end());
+  if (enabled_windows.empty()) {
+    solver->removeTimestepMonitor(windowfile_timestep_monitor);
+  }
+}
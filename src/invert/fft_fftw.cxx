@@ -34,6 +34,10 @@
 #include <fftw3.h>
 #include <math.h>
 
+#include <map>
+#include <memory>
+#include <vector>
+
 #ifdef _OPENMP
 #include <omp.h>
 #endif
@@ -58,88 +62,210 @@ void fft_init()
  * Real FFTs
  ***********************************************************/
 
-#ifndef _OPENMP
-// Serial code
-void rfft(const BoutReal *in, int length, dcomplex *out) {
-  // static variables initialized once
-  static double *fin;
-  static fftw_complex *fout;
-  static fftw_plan p;
-  static int n = 0;
+namespace bout {
+namespace fft {
+
+/// FFTW plans and aligned buffers for transforms of one length.
+/// Both directions share the buffers, since a thread executes one
+/// transform at a time
+struct PlanImpl {
+  int length;         ///< Number of real points
+  double *fin;        ///< Aligned real buffer, length points
+  fftw_complex *fout; ///< Aligned complex buffer, length/2 + 1 modes
+  fftw_plan forward;  ///< r2c plan; nullptr until the first forward()
+  fftw_plan backward; ///< c2r plan; nullptr until the first backward()
+};
+
+Plan::Plan(int length) : impl(new PlanImpl) {
+  ASSERT1(length > 0);
 
-  // If the current length mismatches n
-  if(length != n) {
-    // If n has been used before
-    if(n > 0) {
-      // Free the previously initialized data
-      fftw_destroy_plan(p);
-      fftw_free(fin);
-      fftw_free(fout);
-    }
+  impl->length = length;
+
+  // Input of the fourier transformation
+  impl->fin = static_cast<double *>(fftw_malloc(sizeof(double) * length));
+  /* NOTE: Only the non-redundant output is stored
+   *       I.e the offset and the positive frequencies (so no mirroring
+   *       around the Nyquist frequency)
+   */
+  impl->fout =
+      static_cast<fftw_complex *>(fftw_malloc(sizeof(fftw_complex) * (length / 2 + 1)));
+
+  // Plans are built on first use: many Plan objects only ever
+  // transform in one direction
+  impl->forward = nullptr;
+  impl->backward = nullptr;
+}
 
-    fft_init();
+Plan::~Plan() {
+  // FFTW's planner bookkeeping is shared, so destroying plans
+  // serialises with plan creation
+  BOUT_OMP(critical(fftw_planner))
+  {
+    if (impl->forward != nullptr)
+      fftw_destroy_plan(impl->forward);
+    if (impl->backward != nullptr)
+      fftw_destroy_plan(impl->backward);
+  }
+  fftw_free(impl->fin);
+  fftw_free(impl->fout);
+  delete impl;
+}
 
-    // Initialize the input for the fourier transformation
-    fin = (double*) fftw_malloc(sizeof(double) * length);
-    // Initialize the output of the fourier transformation
-    /* NOTE: Only the non-redundant output is given
-     *       I.e the offset and the positive frequencies (so no mirroring
-     *       around the Nyquist frequency)
-     */
-    fout = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * (length/2 + 1));
+int Plan::size() const { return impl->length; }
+
+void Plan::forward(const BoutReal *in, dcomplex *out) {
+  if (impl->forward == nullptr) {
+    fft_init();
 
     unsigned int flags = FFTW_ESTIMATE;
-    if(fft_measure)
+    if (fft_measure)
       flags = FFTW_MEASURE;
 
     /* fftw call
      * Plan a real-input/complex-output discrete Fourier transform (DFT)
      * in 1 dimensions. Returns a fftw_plan (containing pointers etc.)
      * r2c = real to complex
+     *
+     * The FFTW planning routines are not thread safe
      */
-    p = fftw_plan_dft_r2c_1d(length, fin, fout, flags);
-
-    n = length;
+    BOUT_OMP(critical(fftw_planner))
+    impl->forward = fftw_plan_dft_r2c_1d(impl->length, impl->fin, impl->fout, flags);
   }
 
+  const int n = impl->length;
+
   // Put the input to fin
-  for(int i=0;i<n;i++)
-    fin[i] = in[i];
+  for (int i = 0; i < n; i++)
+    impl->fin[i] = in[i];
 
   // fftw call executing the fft
-  fftw_execute(p);
-  
-  //Normalising factor
-  const BoutReal fac = 1.0/((double) n);
-  const int nmodes = (n/2) + 1;
+  fftw_execute(impl->forward);
+
+  // Normalising factor
+  const BoutReal fac = 1.0 / static_cast<BoutReal>(n);
+  const int nmodes = (n / 2) + 1;
 
   // Store the output in out, and normalize
-  for(int i=0;i<nmodes;i++)
-    out[i] = dcomplex(fout[i][0], fout[i][1]) * fac; // Normalise
+  for (int i = 0; i < nmodes; i++)
+    out[i] = dcomplex(impl->fout[i][0], impl->fout[i][1]) * fac; // Normalise
+}
+
+void Plan::backward(const dcomplex *in, BoutReal *out) {
+  if (impl->backward == nullptr) {
+    fft_init();
+
+    unsigned int flags = FFTW_ESTIMATE;
+    if (fft_measure)
+      flags = FFTW_MEASURE;
+
+    /* fftw call
+     * Plan a complex-input/real-output discrete Fourier transform (DFT)
+     * in 1 dimensions. Returns a fftw_plan (containing pointers etc.)
+     * c2r = complex to real
+     */
+    BOUT_OMP(critical(fftw_planner))
+    impl->backward = fftw_plan_dft_c2r_1d(impl->length, impl->fout, impl->fin, flags);
+  }
+
+  const int n = impl->length;
+  const int nmodes = (n / 2) + 1;
+
+  // Store the real and imaginary parts in the proper way
+  for (int i = 0; i < nmodes; i++) {
+    impl->fout[i][0] = in[i].real();
+    impl->fout[i][1] = in[i].imag();
+  }
+
+  // fftw call executing the fft
+  fftw_execute(impl->backward);
+
+  // Store the output of the fftw to the out
+  for (int i = 0; i < n; i++)
+    out[i] = impl->fin[i];
+}
+
+Plan &Plan::get(int length) {
+  // One table per thread: lookups never synchronise with other
+  // threads, and plans for different lengths coexist instead of
+  // being destroyed whenever the length changes
+  static thread_local std::map<int, std::unique_ptr<Plan>> plans;
+
+  std::unique_ptr<Plan> &slot = plans[length];
+  if (!slot) {
+    slot.reset(new Plan(length));
+  }
+  return *slot;
+}
+
+} // namespace fft
+} // namespace bout
+
+// The legacy interface transforms through the calling thread's cached
+// plans, so it is re-entrant: concurrent transforms, including of
+// different lengths, no longer serialise on shared static plan state
+
+void rfft(const BoutReal *in, int length, dcomplex *out) {
+  bout::fft::Plan::get(length).forward(in, out);
 }
 
 const Array<dcomplex> rfft(const Array<BoutReal> &in) {
   ASSERT1(!in.empty()); // Check that there is data
-  
+
   int size = in.size();
   Array<dcomplex> out(size); // Allocates data array
-  
+
   rfft(in.begin(), size, out.begin());
   return out;
 }
 
 void irfft(const dcomplex *in, int length, BoutReal *out) {
+  bout::fft::Plan::get(length).backward(in, out);
+}
+
+//  Discrete sine transforms (B Shanahan)
+
+/***********************************************************
+ * Wisdom and plan warm-up
+ ***********************************************************/
+
+bool fft_load_wisdom(const std::string &filename) {
+  return fftw_import_wisdom_from_filename(filename.c_str()) != 0;
+}
+
+bool fft_save_wisdom(const std::string &filename) {
+  return fftw_export_wisdom_to_filename(filename.c_str()) != 0;
+}
+
+void fft_warmup(int length) {
+  // Run a dummy forward and backward transform, so that the calling
+  // thread's cached plans for this length are measured and built
+  // here; the wisdom gathered makes the other threads' planning cheap.
+  std::vector<BoutReal> real(length, 0.0);
+  std::vector<dcomplex> cplx(length / 2 + 1);
+
+  rfft(&real[0], length, &cplx[0]);
+  irfft(&cplx[0], length, &real[0]);
+}
+
+/***********************************************************
+ * Batched transforms
+ *
+ * One fftw_plan_many execution transforms every row at once,
+ * which is typically several times faster than looping rfft/irfft
+ * over the pencils of a field. Planning and the shared buffers are
+ * static, so these must be called from outside parallel regions
+ * (the batching replaces the loop that would be parallelised).
+ ***********************************************************/
+
+void rfft_many(const BoutReal *in, int length, int howmany, dcomplex *out) {
   // static variables initialized once
-  static fftw_complex *fin;
-  static double *fout;
+  static double *fin;
+  static fftw_complex *fout;
   static fftw_plan p;
-  static int n = 0;
+  static int n = 0, nbatch = 0;
 
-  // If the current length mismatches n
-  if(length != n) {
-    // If n has been used before
-    if(n > 0) {
-      // Free the previously initialized data
+  if ((length != n) || (howmany != nbatch)) {
+    if (n > 0) {
       fftw_destroy_plan(p);
       fftw_free(fin);
       fftw_free(fout);
@@ -147,186 +273,79 @@ void irfft(const dcomplex *in, int length, BoutReal *out) {
 
     fft_init();
 
-    // Initilaize the input for the inverse fourier transformation
-    /* NOTE: Only the non-redundant input is given
-     *       I.e the offset and the positive frequencies (so no mirroring
-     *       around the Nyquist frequency)
-     */
-    fin = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * (length/2 + 1));
-    // Initialize the output of the fourier transformation
-    fout = (double*) fftw_malloc(sizeof(double) * length);
+    fin = (double *)fftw_malloc(sizeof(double) * length * howmany);
+    fout = (fftw_complex *)fftw_malloc(sizeof(fftw_complex) * (length / 2 + 1) * howmany);
 
     unsigned int flags = FFTW_ESTIMATE;
-    if(fft_measure)
+    if (fft_measure)
       flags = FFTW_MEASURE;
 
-    /* fftw call
-     * Plan a complex-input/real-output discrete Fourier transform (DFT)
-     * in 1 dimensions. Returns a fftw_plan (containing pointers etc.)
-     * c2r = complex to real
-     */
-    p = fftw_plan_dft_c2r_1d(length, fin, fout, flags);
+    // Rows are contiguous: input stride 1, distance length; output
+    // stride 1, distance length/2 + 1
+    int nsize[] = {length};
+    p = fftw_plan_many_dft_r2c(1, nsize, howmany, fin, nullptr, 1, length, fout, nullptr,
+                               1, length / 2 + 1, flags);
 
     n = length;
+    nbatch = howmany;
   }
 
-  // Store the real and imaginary parts in the proper way
-  const int nmodes = (n/2) + 1;
-  for(int i=0;i<nmodes;i++) {
-    fin[i][0] = in[i].real();
-    fin[i][1] = in[i].imag();
-  }
-
-  // fftw call executing the fft
-  fftw_execute(p);
-
-  // Store the output of the fftw to the out
-  for(int i=0;i<n;i++)
-    out[i] = fout[i];
-}
-
-#else
-// Parallel thread-safe version of rfft and irfft
-void rfft(const BoutReal *in, int length, dcomplex *out) {
-  static double *finall;
-  static fftw_complex *foutall;
-  static fftw_plan *p;
-  static int size = 0, nthreads = 0;
-
-  int th_id = omp_get_thread_num();
-  int n_th = omp_get_num_threads(); // Number of threads
-
-  // Sort out memory. Also, FFTW planning routines not thread safe
-  if ((size != length) || (nthreads < n_th)) {
-    // We make the check to see if the problem size has changed twice
-    // intentionally. The first check ensures we don't pay the cost of
-    // obtaining a lock for the critical section if we don't need to do
-    // any work here. The second check is required to make sure that
-    // only one thread does the actual setup when required. Note we can't
-    // use a `single` block here as that requires all threads to reach the
-    // block (implicit barrier) which may not be true in all cases (e.g.
-    // if there are 8 threads but only 4 call the fft routine).
-    BOUT_OMP(critical(rfft))
-    if ((size != length) || (nthreads < n_th)) {
-      if(size > 0) {
-        // Free all memory
-        for(int i=0;i<nthreads;i++)
-          fftw_destroy_plan(p[i]);
-        delete[] p;
-        fftw_free(finall);
-        fftw_free(foutall);
-      }
-
-      fft_init();
-
-      finall = static_cast<double *>(fftw_malloc(sizeof(double) * length * n_th));
-      foutall = static_cast<fftw_complex *>(
-          fftw_malloc(sizeof(fftw_complex) * (length / 2 + 1) * n_th));
-      p = new fftw_plan[n_th]; //Never freed
-
-      unsigned int flags = FFTW_ESTIMATE;
-      if(fft_measure)
-        flags = FFTW_MEASURE;
-
-      for(int i=0;i<n_th;i++)
-        // fftw call
-        // Plan a real-input/complex-output discrete Fourier transform (DFT)
-        // in 1 dimensions. Returns a fftw_plan (containing pointers etc.)
-        p[i] = fftw_plan_dft_r2c_1d(length, finall+i*length,
-                                    foutall+i*(length/2 + 1), flags);
-      size = length;
-      nthreads = n_th;
-    }
-  }
-
-  // Get working arrays for this thread
-  double *fin = finall + th_id * size;
-  fftw_complex *fout = foutall + th_id * (size / 2 + 1);
-
-  for (int i = 0; i < size; i++)
+  for (int i = 0; i < n * nbatch; i++)
     fin[i] = in[i];
 
-  // fftw call executing the fft
-  fftw_execute(p[th_id]);
+  fftw_execute(p);
 
-  //Normalising factor
-  const BoutReal fac = 1.0 / static_cast<BoutReal>(size);
-  const int nmodes = (size / 2) + 1;
+  const BoutReal fac = 1.0 / static_cast<BoutReal>(n);
+  const int nmodes = (n / 2) + 1;
 
-  for(int i=0;i<nmodes;i++)
+  for (int i = 0; i < nmodes * nbatch; i++)
     out[i] = dcomplex(fout[i][0], fout[i][1]) * fac; // Normalise
+
 }
 
-void irfft(const dcomplex *in, int length, BoutReal *out) {
-  static fftw_complex *finall;
-  static double *foutall;
-  static fftw_plan *p;
-  static int size = 0, nthreads = 0;
-
-  int th_id = omp_get_thread_num();
-  int n_th = omp_get_num_threads(); // Number of threads
-
-  // Sort out memory. Also, FFTW planning routines not thread safe
-  if ((size != length) || (nthreads < n_th)) {
-    // We make the check to see if the problem size has changed twice
-    // intentionally. The first check ensures we don't pay the cost of
-    // obtaining a lock for the critical section if we don't need to do
-    // any work here. The second check is required to make sure that
-    // only one thread does the actual setup when required. Note we can't
-    // use a `single` block here as that requires all threads to reach the
-    // block (implicit barrier) which may not be true in all cases (e.g.
-    // if there are 8 threads but only 4 call the fft routine).
-    BOUT_OMP(critical(irfft))
-    if ((size != length) || (nthreads < n_th)) {
-      if (size > 0) {
-        // Free all memory
-        for (int i = 0; i < nthreads; i++)
-          fftw_destroy_plan(p[i]);
-        delete[] p;
-        fftw_free(finall);
-        fftw_free(foutall);
-      }
+void irfft_many(const dcomplex *in, int length, int howmany, BoutReal *out) {
+  // static variables initialized once
+  static fftw_complex *fin;
+  static double *fout;
+  static fftw_plan p;
+  static int n = 0, nbatch = 0;
 
-      fft_init();
+  if ((length != n) || (howmany != nbatch)) {
+    if (n > 0) {
+      fftw_destroy_plan(p);
+      fftw_free(fin);
+      fftw_free(fout);
+    }
 
-      finall = static_cast<fftw_complex *>(
-          fftw_malloc(sizeof(fftw_complex) * (length / 2 + 1) * n_th));
-      foutall = static_cast<double *>(fftw_malloc(sizeof(double) * length * n_th));
+    fft_init();
 
-      p = new fftw_plan[n_th]; // Never freed
+    fin = (fftw_complex *)fftw_malloc(sizeof(fftw_complex) * (length / 2 + 1) * howmany);
+    fout = (double *)fftw_malloc(sizeof(double) * length * howmany);
 
-      unsigned int flags = FFTW_ESTIMATE;
-      if (fft_measure)
-        flags = FFTW_MEASURE;
+    unsigned int flags = FFTW_ESTIMATE;
+    if (fft_measure)
+      flags = FFTW_MEASURE;
 
-      for (int i = 0; i < n_th; i++)
-        p[i] = fftw_plan_dft_c2r_1d(length, finall + i * (length / 2 + 1),
-                                    foutall + i * length, flags);
-      size = length;
-      nthreads = n_th;
-    }
-  }
+    int nsize[] = {length};
+    p = fftw_plan_many_dft_c2r(1, nsize, howmany, fin, nullptr, 1, length / 2 + 1, fout,
+                               nullptr, 1, length, flags);
 
-  // Get working arrays for this thread
-  fftw_complex *fin = finall + th_id * (size / 2 + 1);
-  double *fout = foutall + th_id * size;
+    n = length;
+    nbatch = howmany;
+  }
 
-  const int nmodes = (size / 2) + 1;
+  const int nmodes = (n / 2) + 1;
 
-  for(int i=0;i<nmodes;i++) {
+  for (int i = 0; i < nmodes * nbatch; i++) {
     fin[i][0] = in[i].real();
     fin[i][1] = in[i].imag();
   }
 
-  // fftw call executing the fft
-  fftw_execute(p[th_id]);
+  fftw_execute(p);
 
-  for (int i = 0; i < size; i++)
+  for (int i = 0; i < n * nbatch; i++)
     out[i] = fout[i];
 }
-#endif
-
-//  Discrete sine transforms (B Shanahan)
 
 void DST(const BoutReal *in, int length, dcomplex *out) {
   static double *fin;
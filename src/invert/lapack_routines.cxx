@@ -38,6 +38,11 @@
 #include <globals.hxx>
 #include <dcomplex.hxx>
 #include <boutexception.hxx>
+#include <bout/assert.hxx>
+#include <bout/cpu_dispatch.hxx>
+#include <bout/region.hxx> // for BOUT_SIMD
+
+#include <algorithm>
 
 #ifdef LAPACK
 
@@ -281,6 +286,141 @@ void cband_solve(Matrix<dcomplex>&, int, int, int, Array<dcomplex>&) {
 
 // Common functions
 
+/// Batched Thomas algorithm on split real/imaginary storage. The inner
+/// loops run over the contiguous batch index so they vectorise; the
+/// recurrence over rows stays scalar per batch member.
+BOUT_TARGET_CLONES
+void tridagBatch(const ComplexBatch &a, const ComplexBatch &b, const ComplexBatch &c,
+                 const ComplexBatch &r, ComplexBatch &u) {
+  const int n = a.length();
+  const int nb = a.batchSize();
+
+  ASSERT1(b.length() == n && c.length() == n && r.length() == n && u.length() == n);
+  ASSERT1(b.batchSize() == nb && c.batchSize() == nb && r.batchSize() == nb
+          && u.batchSize() == nb);
+
+  const BoutReal *ar = a.real(), *ai = a.imag();
+  const BoutReal *br = b.real(), *bi = b.imag();
+  const BoutReal *cr = c.real(), *ci = c.imag();
+  const BoutReal *rr = r.real(), *ri = r.imag();
+  BoutReal *ur = u.real(), *ui = u.imag();
+
+  // Per-batch-member pivot, and the gamma workspace of the Thomas algorithm
+  Array<BoutReal> betr(nb), beti(nb);
+  ComplexBatch gam(n, nb);
+  BoutReal *gr = gam.real(), *gi = gam.imag();
+
+  BOUT_SIMD
+  for (int m = 0; m < nb; m++) {
+    betr[m] = br[m];
+    beti[m] = bi[m];
+    const BoutReal inv = 1.0 / (betr[m] * betr[m] + beti[m] * beti[m]);
+    ur[m] = (rr[m] * betr[m] + ri[m] * beti[m]) * inv;
+    ui[m] = (ri[m] * betr[m] - rr[m] * beti[m]) * inv;
+  }
+
+  // Decomposition and forward substitution
+  for (int i = 1; i < n; i++) {
+    const int o = i * nb;
+    const int p = o - nb;
+    BOUT_SIMD
+    for (int m = 0; m < nb; m++) {
+      // gam[i] = c[i-1] / bet
+      const BoutReal ibet = 1.0 / (betr[m] * betr[m] + beti[m] * beti[m]);
+      gr[o + m] = (cr[p + m] * betr[m] + ci[p + m] * beti[m]) * ibet;
+      gi[o + m] = (ci[p + m] * betr[m] - cr[p + m] * beti[m]) * ibet;
+
+      // bet = b[i] - a[i]*gam[i]
+      betr[m] = br[o + m] - (ar[o + m] * gr[o + m] - ai[o + m] * gi[o + m]);
+      beti[m] = bi[o + m] - (ar[o + m] * gi[o + m] + ai[o + m] * gr[o + m]);
+
+      // u[i] = (r[i] - a[i]*u[i-1]) / bet
+      const BoutReal tr = rr[o + m] - (ar[o + m] * ur[p + m] - ai[o + m] * ui[p + m]);
+      const BoutReal ti = ri[o + m] - (ar[o + m] * ui[p + m] + ai[o + m] * ur[p + m]);
+      const BoutReal inv = 1.0 / (betr[m] * betr[m] + beti[m] * beti[m]);
+      ur[o + m] = (tr * betr[m] + ti * beti[m]) * inv;
+      ui[o + m] = (ti * betr[m] - tr * beti[m]) * inv;
+    }
+  }
+
+  // Back substitution
+  for (int i = n - 2; i >= 0; i--) {
+    const int o = i * nb;
+    const int p = o + nb;
+    BOUT_SIMD
+    for (int m = 0; m < nb; m++) {
+      const BoutReal xr = ur[p + m];
+      const BoutReal xi = ui[p + m];
+      ur[o + m] -= gr[p + m] * xr - gi[p + m] * xi;
+      ui[o + m] -= gr[p + m] * xi + gi[p + m] * xr;
+    }
+  }
+}
+
+/// Batched cyclic tridiagonal solver. Same Sherman-Morrison
+/// construction as cyclic_tridag(dcomplex) below, but one system per
+/// batch member with the two inner solves done by tridagBatch. The
+/// boundary-row fixups are O(batch) so use the interleaved accessors
+/// for clarity; only the final correction sweep is O(n * batch).
+void cyclicTridagBatch(const ComplexBatch &a, const ComplexBatch &b,
+                       const ComplexBatch &c, const ComplexBatch &r, ComplexBatch &x) {
+  const int n = a.length();
+  const int nb = a.batchSize();
+
+  if (n <= 2)
+    throw BoutException("n too small in cyclicTridagBatch");
+
+  ASSERT1(b.length() == n && c.length() == n && r.length() == n && x.length() == n);
+  ASSERT1(b.batchSize() == nb && c.batchSize() == nb && r.batchSize() == nb
+          && x.batchSize() == nb);
+
+  // Modified diagonal, and the rank-one update vector u
+  ComplexBatch bmod(n, nb);
+  ComplexBatch u(n, nb), z(n, nb);
+
+  std::copy(b.real(), b.real() + n * nb, bmod.real());
+  std::copy(b.imag(), b.imag() + n * nb, bmod.imag());
+  std::fill(u.real(), u.real() + n * nb, 0.0);
+  std::fill(u.imag(), u.imag() + n * nb, 0.0);
+
+  for (int m = 0; m < nb; m++) {
+    const dcomplex gamma = -b.get(0, m);
+    bmod.set(0, m, b.get(0, m) - gamma);
+    bmod.set(n - 1, m, b.get(n - 1, m) - c.get(n - 1, m) * a.get(0, m) / gamma);
+    u.set(0, m, gamma);
+    u.set(n - 1, m, c.get(n - 1, m));
+  }
+
+  // Solve Ax = r and Az = u with the modified diagonal
+  tridagBatch(a, bmod, c, r, x);
+  tridagBatch(a, bmod, c, u, z);
+
+  // Correction factor per batch member: v.x / (1 + v.z)
+  Array<dcomplex> fact(nb);
+  for (int m = 0; m < nb; m++) {
+    const dcomplex gamma = -b.get(0, m);
+    fact[m] = (x.get(0, m) + a.get(0, m) * x.get(n - 1, m) / gamma)
+              / (1.0 + z.get(0, m) + a.get(0, m) * z.get(n - 1, m) / gamma);
+  }
+
+  Array<BoutReal> fr(nb), fi(nb);
+  for (int m = 0; m < nb; m++) {
+    fr[m] = fact[m].real();
+    fi[m] = fact[m].imag();
+  }
+
+  BoutReal *xr = x.real(), *xi = x.imag();
+  const BoutReal *zr = z.real(), *zi = z.imag();
+  for (int i = 0; i < n; i++) {
+    const int o = i * nb;
+    BOUT_SIMD
+    for (int m = 0; m < nb; m++) {
+      xr[o + m] -= fr[m] * zr[o + m] - fi[m] * zi[o + m];
+      xi[o + m] -= fr[m] * zi[o + m] + fi[m] * zr[o + m];
+    }
+  }
+}
+
 /// Solve a cyclic tridiagonal matrix
 void cyclic_tridag(dcomplex *a, dcomplex *b, dcomplex *c, dcomplex *r, dcomplex *x, int n) {
   if (n <= 2)
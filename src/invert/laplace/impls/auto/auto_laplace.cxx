@@ -0,0 +1,275 @@
+/**************************************************************************
+ * Benchmarking wrapper which auto-selects a Laplacian implementation
+ *
+ **************************************************************************
+ * Copyright 2018 B.D.Dudson
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+#include <globals.hxx>
+#include <boutcomm.hxx>
+#include <boutexception.hxx>
+#include <output.hxx>
+
+#include "auto_laplace.hxx"
+
+#include "../serial_tri/serial_tri.hxx"
+#include "../serial_band/serial_band.hxx"
+#include "../pdd/pdd.hxx"
+#include "../spt/spt.hxx"
+#include "../petsc/petsc_laplace.hxx"
+#include "../mumps/mumps_laplace.hxx"
+#include "../cyclic/cyclic_laplace.hxx"
+#include "../shoot/shoot_laplace.hxx"
+#include "../multigrid/multigrid_laplace.hxx"
+#include "../naulin/naulin_laplace.hxx"
+
+#include <mpi.h>
+#include <cmath>
+
+LaplaceAuto::LaplaceAuto(Options *opt, CELL_LOC loc)
+    : Laplacian(opt, loc), nsolves(0) {
+
+  if (opt == nullptr)
+    opt = Options::getRoot()->getSection("laplace");
+
+  OPTION(opt, benchmark_solves, 10); // Solves to time before choosing
+  OPTION(opt, autoselect, true);     // Switch to the fastest solver afterwards?
+
+  // Try every implementation which can run on this mesh, in the same
+  // order as the factory. Solvers whose constructor throws (library
+  // not compiled in, unsupported decomposition, ...) are skipped
+  if (mesh->firstX() && mesh->lastX()) {
+    addCandidate("tri", [opt, loc]() { return new LaplaceSerialTri(opt, loc); });
+    addCandidate("band", [opt, loc]() { return new LaplaceSerialBand(opt, loc); });
+  } else {
+    addCandidate("pdd", [opt, loc]() { return new LaplacePDD(opt, loc); });
+  }
+  addCandidate("spt", [opt, loc]() { return new LaplaceSPT(opt, loc); });
+  addCandidate("petsc", [opt, loc]() { return new LaplacePetsc(opt, loc); });
+  addCandidate("mumps", [opt, loc]() { return new LaplaceMumps(opt, loc); });
+  addCandidate("cyclic", [opt, loc]() { return new LaplaceCyclic(opt, loc); });
+  addCandidate("shoot", [opt, loc]() { return new LaplaceShoot(opt, loc); });
+  addCandidate("multigrid", [opt, loc]() { return new LaplaceMultigrid(opt, loc); });
+  addCandidate("naulin", [opt, loc]() { return new LaplaceNaulin(opt, loc); });
+
+  if (candidates.empty())
+    throw BoutException("LaplaceAuto: no Laplacian solver could be constructed");
+
+  output.write("\tBenchmarking %d Laplacian solvers over the first %d solves\n",
+               static_cast<int>(candidates.size()), benchmark_solves);
+}
+
+void LaplaceAuto::addCandidate(const char *name, std::function<Laplacian *()> create) {
+  try {
+    Candidate c;
+    c.name = name;
+    c.solver.reset(create());
+    c.time = 0.0;
+    c.maxdiff = 0.0;
+    candidates.push_back(std::move(c));
+  } catch (BoutException &e) {
+    output.write("\tLaplacian benchmark: skipping '%s': %s\n", name, e.what());
+  }
+}
+
+void LaplaceAuto::forAll(const char *what, std::function<void(Laplacian &)> f) {
+  if (selection) {
+    f(*selection);
+    return;
+  }
+
+  for (auto it = candidates.begin(); it != candidates.end();) {
+    try {
+      f(*it->solver);
+      ++it;
+    } catch (BoutException &e) {
+      // e.g. a coefficient this solver does not implement
+      output.write("\tLaplacian benchmark: dropping '%s', %s failed: %s\n",
+                   it->name.c_str(), what, e.what());
+      it = candidates.erase(it);
+    }
+  }
+
+  if (candidates.empty())
+    throw BoutException("LaplaceAuto: no candidate solver supports %s", what);
+}
+
+void LaplaceAuto::setCoefA(const Field2D &val) {
+  forAll("setCoefA", [&val](Laplacian &l) { l.setCoefA(val); });
+}
+void LaplaceAuto::setCoefA(const Field3D &val) {
+  forAll("setCoefA", [&val](Laplacian &l) { l.setCoefA(val); });
+}
+void LaplaceAuto::setCoefC(const Field2D &val) {
+  forAll("setCoefC", [&val](Laplacian &l) { l.setCoefC(val); });
+}
+void LaplaceAuto::setCoefC(const Field3D &val) {
+  forAll("setCoefC", [&val](Laplacian &l) { l.setCoefC(val); });
+}
+void LaplaceAuto::setCoefC1(const Field2D &val) {
+  forAll("setCoefC1", [&val](Laplacian &l) { l.setCoefC1(val); });
+}
+void LaplaceAuto::setCoefC1(const Field3D &val) {
+  forAll("setCoefC1", [&val](Laplacian &l) { l.setCoefC1(val); });
+}
+void LaplaceAuto::setCoefC2(const Field2D &val) {
+  forAll("setCoefC2", [&val](Laplacian &l) { l.setCoefC2(val); });
+}
+void LaplaceAuto::setCoefC2(const Field3D &val) {
+  forAll("setCoefC2", [&val](Laplacian &l) { l.setCoefC2(val); });
+}
+void LaplaceAuto::setCoefD(const Field2D &val) {
+  forAll("setCoefD", [&val](Laplacian &l) { l.setCoefD(val); });
+}
+void LaplaceAuto::setCoefD(const Field3D &val) {
+  forAll("setCoefD", [&val](Laplacian &l) { l.setCoefD(val); });
+}
+void LaplaceAuto::setCoefEx(const Field2D &val) {
+  forAll("setCoefEx", [&val](Laplacian &l) { l.setCoefEx(val); });
+}
+void LaplaceAuto::setCoefEz(const Field2D &val) {
+  forAll("setCoefEz", [&val](Laplacian &l) { l.setCoefEz(val); });
+}
+
+void LaplaceAuto::setFlags(int f) {
+  Laplacian::setFlags(f);
+  forAll("setFlags", [f](Laplacian &l) { l.setFlags(f); });
+}
+void LaplaceAuto::setGlobalFlags(int f) {
+  Laplacian::setGlobalFlags(f);
+  forAll("setGlobalFlags", [f](Laplacian &l) { l.setGlobalFlags(f); });
+}
+void LaplaceAuto::setInnerBoundaryFlags(int f) {
+  Laplacian::setInnerBoundaryFlags(f);
+  forAll("setInnerBoundaryFlags", [f](Laplacian &l) { l.setInnerBoundaryFlags(f); });
+}
+void LaplaceAuto::setOuterBoundaryFlags(int f) {
+  Laplacian::setOuterBoundaryFlags(f);
+  forAll("setOuterBoundaryFlags", [f](Laplacian &l) { l.setOuterBoundaryFlags(f); });
+}
+
+void LaplaceAuto::invalidate() {
+  Laplacian::invalidate();
+  forAll("invalidate", [](Laplacian &l) { l.invalidate(); });
+}
+
+const FieldPerp LaplaceAuto::solve(const FieldPerp &b, const FieldPerp &x0) {
+  if (selection)
+    return selection->solve(b, x0);
+
+  Mesh *mesh = b.getMesh();
+  FieldPerp result(mesh);
+  bool first = true;
+
+  for (auto it = candidates.begin(); it != candidates.end();) {
+    try {
+      BoutReal started = MPI_Wtime();
+      FieldPerp x = it->solver->solve(b, x0);
+      it->time += MPI_Wtime() - started;
+
+      if (first) {
+        // The first candidate's result is returned to the model, and
+        // is the reference the others are compared against
+        result = x;
+        first = false;
+      } else {
+        // Maximum difference from the reference, over the interior
+        // (boundary region conventions differ between solvers)
+        BoutReal diff = 0.0;
+        for (int jx = mesh->xstart; jx <= mesh->xend; jx++) {
+          for (int jz = 0; jz < mesh->LocalNz; jz++) {
+            BoutReal d = fabs(x(jx, jz) - result(jx, jz));
+            if (d > diff)
+              diff = d;
+          }
+        }
+        if (diff > it->maxdiff)
+          it->maxdiff = diff;
+      }
+      ++it;
+    } catch (BoutException &e) {
+      output.write("\tLaplacian benchmark: dropping '%s', solve failed: %s\n",
+                   it->name.c_str(), e.what());
+      it = candidates.erase(it);
+    }
+  }
+
+  if (first)
+    throw BoutException("LaplaceAuto: all candidate solvers failed");
+
+  nsolves++;
+  if (nsolves >= benchmark_solves)
+    finishBenchmark();
+
+  return result;
+}
+
+const Field3D LaplaceAuto::solve(const Field3D &b) {
+  if (selection)
+    return selection->solve(b);
+  return Laplacian::solve(b); // Loops over y through the FieldPerp solve above
+}
+
+const Field3D LaplaceAuto::solve(const Field3D &b, const Field3D &x0) {
+  if (selection)
+    return selection->solve(b, x0);
+  return Laplacian::solve(b, x0);
+}
+
+const std::vector<Field3D> LaplaceAuto::solve(const std::vector<Field3D> &b) {
+  if (selection)
+    return selection->solve(b); // May use an optimised batch path
+  return Laplacian::solve(b);
+}
+
+void LaplaceAuto::finishBenchmark() {
+  int nc = candidates.size();
+
+  // Judge each candidate by its slowest processor, and report the
+  // worst-case difference, so every processor prints and decides the
+  // same thing
+  std::vector<BoutReal> local(2 * nc), global(2 * nc);
+  for (int i = 0; i < nc; i++) {
+    local[i] = candidates[i].time;
+    local[nc + i] = candidates[i].maxdiff;
+  }
+  MPI_Allreduce(&local[0], &global[0], 2 * nc, BOUT_MPI_REAL, MPI_MAX, BoutComm::get());
+
+  output.write("\tLaplacian benchmark results (%d solves):\n", nsolves);
+  int best = 0;
+  for (int i = 0; i < nc; i++) {
+    output.write("\t  %-10s time = %e s, max difference = %e\n",
+                 candidates[i].name.c_str(), global[i], global[nc + i]);
+    if (global[i] < global[best])
+      best = i;
+  }
+
+  if (!autoselect) {
+    // Report only; keep returning the reference solver's results
+    best = 0;
+  }
+
+  output.write("\tUsing '%s' Laplacian solver for the rest of the run\n",
+               candidates[best].name.c_str());
+
+  selection = std::move(candidates[best].solver);
+  candidates.clear(); // Frees the losing solvers
+}
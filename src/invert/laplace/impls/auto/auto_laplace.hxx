@@ -0,0 +1,119 @@
+/**************************************************************************
+ * Benchmarking wrapper which auto-selects a Laplacian implementation
+ *
+ * Instantiates every Laplacian solver which can be constructed on this
+ * mesh, times them against each other on the first few real solves
+ * (i.e. with the model's actual coefficients and right-hand sides),
+ * reports time and accuracy per implementation, then hands the rest of
+ * the run to the fastest one.
+ *
+ **************************************************************************
+ * Copyright 2018 B.D.Dudson
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+class LaplaceAuto;
+
+#ifndef __LAP_AUTO_H__
+#define __LAP_AUTO_H__
+
+#include <invert_laplace.hxx>
+#include <options.hxx>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+/// Benchmark all available Laplacian solvers, then use the fastest
+///
+/// Select with  type = auto  in the laplace options section. Until
+/// benchmark_solves solves have been timed, every call runs all
+/// candidate solvers; the first candidate's result is returned, and the
+/// others are compared against it. After that a table of accumulated
+/// times and maximum differences is printed and the fastest solver
+/// (slowest processor deciding, so all processors agree) is used for
+/// the remainder of the run.
+class LaplaceAuto : public Laplacian {
+public:
+  LaplaceAuto(Options *opt = nullptr, const CELL_LOC loc = CELL_CENTRE);
+  ~LaplaceAuto() {};
+
+  void setCoefA(const Field2D &val) override;
+  void setCoefA(const Field3D &val) override;
+  void setCoefC(const Field2D &val) override;
+  void setCoefC(const Field3D &val) override;
+  void setCoefC1(const Field2D &val) override;
+  void setCoefC1(const Field3D &val) override;
+  void setCoefC2(const Field2D &val) override;
+  void setCoefC2(const Field3D &val) override;
+  void setCoefD(const Field2D &val) override;
+  void setCoefD(const Field3D &val) override;
+  void setCoefEx(const Field2D &val) override;
+  void setCoefEz(const Field2D &val) override;
+
+  void setFlags(int f) override;
+  void setGlobalFlags(int f) override;
+  void setInnerBoundaryFlags(int f) override;
+  void setOuterBoundaryFlags(int f) override;
+
+  void invalidate() override;
+
+  const FieldPerp solve(const FieldPerp &b) override { return solve(b, b); }
+  const FieldPerp solve(const FieldPerp &b, const FieldPerp &x0) override;
+
+  const Field3D solve(const Field3D &b) override;
+  const Field3D solve(const Field3D &b, const Field3D &x0) override;
+  const std::vector<Field3D> solve(const std::vector<Field3D> &b) override;
+
+private:
+  /// One solver being benchmarked
+  struct Candidate {
+    std::string name;
+    std::unique_ptr<Laplacian> solver;
+    BoutReal time;    ///< Accumulated solve time [s]
+    BoutReal maxdiff; ///< Max abs difference from the first candidate's solution
+  };
+  std::vector<Candidate> candidates;
+
+  /// The solver chosen after benchmarking. All calls delegate to this
+  /// once it is set
+  std::unique_ptr<Laplacian> selection;
+
+  int benchmark_solves; ///< Number of solves to time before choosing
+  bool autoselect;      ///< Switch to the fastest solver after the benchmark?
+  int nsolves;          ///< Benchmark solves completed so far
+
+  /// Try to construct a candidate, skipping it (with a message) if the
+  /// constructor throws, e.g. because a library is not available
+  void addCandidate(const char *name, std::function<Laplacian *()> create);
+
+  /// Apply \p f to every candidate (or to the selection). Candidates
+  /// which throw, e.g. because they do not implement a coefficient the
+  /// model uses, are dropped with a warning
+  void forAll(const char *what, std::function<void(Laplacian &)> f);
+
+  /// Print the timing table and, if autoselect is set, pick the fastest
+  /// solver. All processors agree on the choice: each candidate is
+  /// judged by its slowest processor
+  void finishBenchmark();
+};
+
+#endif // __LAP_AUTO_H__
@@ -52,6 +52,7 @@ LaplaceCyclic::LaplaceCyclic(Options *opt, const CELL_LOC loc)
   // Get options
 
   OPTION(opt, dst, false);
+  OPTION(opt, mixedprecision, false);
 
   if(dst) {
     nmode = mesh->LocalNz-2;
@@ -82,11 +83,115 @@ LaplaceCyclic::LaplaceCyclic(Options *opt, const CELL_LOC loc)
   // Create a cyclic reduction object, operating on dcomplex values
   cr = new CyclicReduce<dcomplex>(mesh->getXcomm(), n);
   cr->setPeriodic(mesh->periodicX);
+
+  crf = nullptr;
+  if (mixedprecision) {
+    // Single-precision solver for the mixed-precision mode
+    crf = new CyclicReduce<std::complex<float>>(mesh->getXcomm(), n);
+    crf->setPeriodic(mesh->periodicX);
+  }
 }
 
 LaplaceCyclic::~LaplaceCyclic() {
-  // Delete tridiagonal solver
+  // Delete tridiagonal solvers
   delete cr;
+  delete crf;
+}
+
+void LaplaceCyclic::solveSystems(Matrix<dcomplex> &avec, Matrix<dcomplex> &bvec,
+                                 Matrix<dcomplex> &cvec, Matrix<dcomplex> &rhs,
+                                 Matrix<dcomplex> &x) {
+  if (!mixedprecision) {
+    cr->setCoefs(avec, bvec, cvec);
+    cr->solve(rhs, x);
+    return;
+  }
+
+  const int nsys = std::get<0>(avec.shape());
+  const int nx = std::get<1>(avec.shape());
+
+  if ((std::get<0>(af.shape()) != nsys) || (std::get<1>(af.shape()) != nx)) {
+    af = Matrix<std::complex<float>>(nsys, nx);
+    bf = Matrix<std::complex<float>>(nsys, nx);
+    cf = Matrix<std::complex<float>>(nsys, nx);
+    rhsf = Matrix<std::complex<float>>(nsys, nx);
+    xf = Matrix<std::complex<float>>(nsys, nx);
+  }
+
+  // Demote the systems to single precision
+  BOUT_OMP(parallel for)
+  for (int j = 0; j < nsys; j++) {
+    for (int i = 0; i < nx; i++) {
+      af(j, i) = std::complex<float>(avec(j, i));
+      bf(j, i) = std::complex<float>(bvec(j, i));
+      cf(j, i) = std::complex<float>(cvec(j, i));
+      rhsf(j, i) = std::complex<float>(rhs(j, i));
+    }
+  }
+
+  // Solve in single precision
+  crf->setCoefs(af, bf, cf);
+  crf->solve(rhsf, xf);
+
+  BOUT_OMP(parallel for)
+  for (int j = 0; j < nsys; j++)
+    for (int i = 0; i < nx; i++)
+      x(j, i) = dcomplex(xf(j, i));
+
+  // One iterative-refinement pass: residual in double precision,
+  // correction solved in single precision. The residual at the first
+  // and last local rows needs the solution on the neighbouring
+  // processors, so exchange the edge values first
+  Array<dcomplex> xlow(nsys), xhigh(nsys);   // x from the x-/x+ neighbour
+  Array<dcomplex> sendlow(nsys), sendhigh(nsys);
+  for (int j = 0; j < nsys; j++) {
+    xlow[j] = 0.0; // Rows at the global boundaries have no outside coupling
+    xhigh[j] = 0.0;
+    sendlow[j] = x(j, 0);
+    sendhigh[j] = x(j, nx - 1);
+  }
+
+  MPI_Comm comm = mesh->getXcomm();
+  int np, myp;
+  MPI_Comm_size(comm, &np);
+  MPI_Comm_rank(comm, &myp);
+  int pm = myp - 1, pp = myp + 1;
+  if (mesh->periodicX) {
+    pm = (myp - 1 + np) % np;
+    pp = (myp + 1) % np;
+  } else {
+    if (myp == 0)
+      pm = MPI_PROC_NULL;
+    if (myp == np - 1)
+      pp = MPI_PROC_NULL;
+  }
+
+  // Send last row up, receive neighbour's last row from below (and vice versa).
+  // Sending raw bytes, as in CyclicReduce
+  MPI_Sendrecv(std::begin(sendhigh), nsys * sizeof(dcomplex), MPI_BYTE, pp, 0,
+               std::begin(xlow), nsys * sizeof(dcomplex), MPI_BYTE, pm, 0, comm,
+               MPI_STATUS_IGNORE);
+  MPI_Sendrecv(std::begin(sendlow), nsys * sizeof(dcomplex), MPI_BYTE, pm, 1,
+               std::begin(xhigh), nsys * sizeof(dcomplex), MPI_BYTE, pp, 1, comm,
+               MPI_STATUS_IGNORE);
+
+  BOUT_OMP(parallel for)
+  for (int j = 0; j < nsys; j++) {
+    for (int i = 0; i < nx; i++) {
+      dcomplex xm = (i > 0) ? x(j, i - 1) : xlow[j];
+      dcomplex xp = (i < nx - 1) ? x(j, i + 1) : xhigh[j];
+      dcomplex res = rhs(j, i) - avec(j, i) * xm - bvec(j, i) * x(j, i) - cvec(j, i) * xp;
+      rhsf(j, i) = std::complex<float>(res);
+    }
+  }
+
+  // Correction solve reuses the coefficients already set in crf
+  crf->solve(rhsf, xf);
+
+  BOUT_OMP(parallel for)
+  for (int j = 0; j < nsys; j++)
+    for (int i = 0; i < nx; i++)
+      x(j, i) += dcomplex(xf(j, i));
 }
 
 const FieldPerp LaplaceCyclic::solve(const FieldPerp &rhs, const FieldPerp &x0) {
@@ -155,8 +260,7 @@ const FieldPerp LaplaceCyclic::solve(const FieldPerp &rhs, const FieldPerp &x0)
     }
 
     // Solve tridiagonal systems
-    cr->setCoefs(a, b, c);
-    cr->solve(bcmplx, xcmplx);
+    solveSystems(a, b, c, bcmplx, xcmplx);
 
     // FFT back to real space
     BOUT_OMP(parallel) {
@@ -220,8 +324,7 @@ const FieldPerp LaplaceCyclic::solve(const FieldPerp &rhs, const FieldPerp &x0)
     }
 
     // Solve tridiagonal systems
-    cr->setCoefs(a, b, c);
-    cr->solve(bcmplx, xcmplx);
+    solveSystems(a, b, c, bcmplx, xcmplx);
 
     // FFT back to real space
     BOUT_OMP(parallel)
@@ -354,8 +457,7 @@ const Field3D LaplaceCyclic::solve(const Field3D &rhs, const Field3D &x0) {
     }
 
     // Solve tridiagonal systems
-    cr->setCoefs(a3D, b3D, c3D);
-    cr->solve(bcmplx3D, xcmplx3D);
+    solveSystems(a3D, b3D, c3D, bcmplx3D, xcmplx3D);
 
     // FFT back to real space
     BOUT_OMP(parallel) {
@@ -431,8 +533,7 @@ const Field3D LaplaceCyclic::solve(const Field3D &rhs, const Field3D &x0) {
     }
 
     // Solve tridiagonal systems
-    cr->setCoefs(a3D, b3D, c3D);
-    cr->solve(bcmplx3D, xcmplx3D);
+    solveSystems(a3D, b3D, c3D, bcmplx3D, xcmplx3D);
 
     // FFT back to real space
     BOUT_OMP(parallel) {
@@ -458,3 +559,204 @@ const Field3D LaplaceCyclic::solve(const Field3D &rhs, const Field3D &x0) {
   }
   return x;
 }
+
+const std::vector<Field3D> LaplaceCyclic::solve(const std::vector<Field3D> &rhs) {
+  TRACE("LaplaceCyclic::solve(vector<Field3D>)");
+
+  const int nrhs = rhs.size();
+  if (nrhs == 0)
+    return std::vector<Field3D>();
+
+  Timer timer("invert");
+
+  Mesh *mesh = rhs[0].getMesh();
+  for (int ir = 0; ir < nrhs; ir++) {
+    ASSERT1(rhs[ir].getLocation() == location);
+    ASSERT1(rhs[ir].getMesh() == mesh);
+  }
+
+  std::vector<Field3D> x; // Results
+  x.reserve(nrhs);
+  for (int ir = 0; ir < nrhs; ir++) {
+    x.emplace_back(mesh);
+    x[ir].allocate();
+    x[ir].setLocation(location);
+  }
+
+  Coordinates *coord = rhs[0].getCoordinates();
+
+  int nx = xe - xs + 1; // Number of X points on this processor
+
+  // Get range of Y indices
+  int ys = mesh->ystart, ye = mesh->yend;
+
+  if (mesh->hasBndryLowerY()) {
+    if (include_yguards)
+      ys = 0; // Mesh contains a lower boundary and we are solving in the guard cells
+
+    ys += extra_yguards_lower;
+  }
+  if (mesh->hasBndryUpperY()) {
+    if (include_yguards)
+      ye = mesh->LocalNy -
+           1; // Contains upper boundary and we are solving in the guard cells
+
+    ye -= extra_yguards_upper;
+  }
+
+  const int ny = (ye - ys + 1);       // Number of Y points
+  const int nsys = nrhs * ny * nmode; // Number of systems, all fields batched
+  const int nxny = nx * ny;           // Number of points in X-Y, per field
+
+  auto a3D = Matrix<dcomplex>(nsys, nx);
+  auto b3D = Matrix<dcomplex>(nsys, nx);
+  auto c3D = Matrix<dcomplex>(nsys, nx);
+
+  auto xcmplx3D = Matrix<dcomplex>(nsys, nx);
+  auto bcmplx3D = Matrix<dcomplex>(nsys, nx);
+
+  // Note: there is no separate initial guess in the batched interface, so
+  // INVERT_SET boundaries take their values from the rhs field itself,
+  // as in solve(b)
+
+  if (dst) {
+    BOUT_OMP(parallel) {
+      /// Create a local thread-scope working array
+      auto k1d =
+          Array<dcomplex>(mesh->LocalNz); // ZFFT routine expects input of this length
+
+      // Loop over fields, X and Y indices, including boundaries but not
+      // guard cells (unless periodic in x)
+      BOUT_OMP(for)
+      for (int ind = 0; ind < nrhs * nxny; ++ind) {
+        // ind = ir*nxny + (ix - xs)*(ye - ys + 1) + (iy - ys)
+        int ir = ind / nxny;
+        int ix = xs + (ind % nxny) / ny;
+        int iy = ys + ind % ny;
+
+        // Take DST in Z direction and put result in k1d
+        DST(rhs[ir](ix, iy) + 1, mesh->LocalNz - 2, std::begin(k1d));
+
+        // Copy into array, transposing so kz is first index
+        for (int kz = 0; kz < nmode; kz++)
+          bcmplx3D((ir * ny + iy - ys) * nmode + kz, ix - xs) = k1d[kz];
+      }
+
+      // Get elements of the tridiagonal matrix
+      // including boundary conditions
+      BOUT_OMP(for nowait)
+      for (int ind = 0; ind < nsys; ind++) {
+        // ind = (ir*ny + iy - ys) * nmode + kz
+        int iy = ys + (ind / nmode) % ny;
+        int kz = ind % nmode;
+
+        BoutReal zlen = coord->dz * (mesh->LocalNz - 3);
+        BoutReal kwave =
+            kz * 2.0 * PI / (2. * zlen); // wave number is 1/[rad]; DST has extra 2.
+
+        tridagMatrix(&a3D(ind, 0), &b3D(ind, 0), &c3D(ind, 0), &bcmplx3D(ind, 0), iy,
+                     kz,    // wave number index
+                     kwave, // kwave (inverse wave length)
+                     global_flags, inner_boundary_flags, outer_boundary_flags, &Acoef,
+                     &Ccoef, &Dcoef,
+                     false); // Don't include guard cells in arrays
+      }
+    }
+
+    // Solve all tridiagonal systems in one go: a single round of
+    // cyclic-reduction communication covers every field in the batch
+    solveSystems(a3D, b3D, c3D, bcmplx3D, xcmplx3D);
+
+    // FFT back to real space
+    BOUT_OMP(parallel) {
+      /// Create a local thread-scope working array
+      auto k1d =
+          Array<dcomplex>(mesh->LocalNz); // ZFFT routine expects input of this length
+
+      BOUT_OMP(for nowait)
+      for (int ind = 0; ind < nrhs * nxny; ++ind) { // Loop over fields, X and Y
+        int ir = ind / nxny;
+        int ix = xs + (ind % nxny) / ny;
+        int iy = ys + ind % ny;
+
+        for (int kz = 0; kz < nmode; kz++)
+          k1d[kz] = xcmplx3D((ir * ny + iy - ys) * nmode + kz, ix - xs);
+
+        for (int kz = nmode; kz < mesh->LocalNz; kz++)
+          k1d[kz] = 0.0; // Filtering out all higher harmonics
+
+        DST_rev(std::begin(k1d), mesh->LocalNz - 2, &x[ir](ix, iy, 1));
+
+        x[ir](ix, iy, 0) = -x[ir](ix, iy, 2);
+        x[ir](ix, iy, mesh->LocalNz - 1) = -x[ir](ix, iy, mesh->LocalNz - 3);
+      }
+    }
+  } else {
+    BOUT_OMP(parallel) {
+      /// Create a local thread-scope working array
+      auto k1d = Array<dcomplex>(mesh->LocalNz / 2 +
+                                 1); // ZFFT routine expects input of this length
+
+      // Loop over fields, X and Y indices, including boundaries but not
+      // guard cells (unless periodic in x)
+      BOUT_OMP(for)
+      for (int ind = 0; ind < nrhs * nxny; ++ind) {
+        // ind = ir*nxny + (ix - xs)*(ye - ys + 1) + (iy - ys)
+        int ir = ind / nxny;
+        int ix = xs + (ind % nxny) / ny;
+        int iy = ys + ind % ny;
+
+        // Take FFT in Z direction and put result in k1d
+        rfft(rhs[ir](ix, iy), mesh->LocalNz, std::begin(k1d));
+
+        // Copy into array, transposing so kz is first index
+        for (int kz = 0; kz < nmode; kz++)
+          bcmplx3D((ir * ny + iy - ys) * nmode + kz, ix - xs) = k1d[kz];
+      }
+
+      // Get elements of the tridiagonal matrix
+      // including boundary conditions
+      BOUT_OMP(for nowait)
+      for (int ind = 0; ind < nsys; ind++) {
+        // ind = (ir*ny + iy - ys) * nmode + kz
+        int iy = ys + (ind / nmode) % ny;
+        int kz = ind % nmode;
+
+        BoutReal kwave = kz * 2.0 * PI / (coord->zlength()); // wave number is 1/[rad]
+        tridagMatrix(&a3D(ind, 0), &b3D(ind, 0), &c3D(ind, 0), &bcmplx3D(ind, 0), iy,
+                     kz,    // True for the component constant (DC) in Z
+                     kwave, // Z wave number
+                     global_flags, inner_boundary_flags, outer_boundary_flags, &Acoef,
+                     &Ccoef, &Dcoef,
+                     false); // Don't include guard cells in arrays
+      }
+    }
+
+    // Solve all tridiagonal systems in one go: a single round of
+    // cyclic-reduction communication covers every field in the batch
+    solveSystems(a3D, b3D, c3D, bcmplx3D, xcmplx3D);
+
+    // FFT back to real space
+    BOUT_OMP(parallel) {
+      /// Create a local thread-scope working array
+      auto k1d = Array<dcomplex>((mesh->LocalNz) / 2 +
+                                 1); // ZFFT routine expects input of this length
+
+      BOUT_OMP(for nowait)
+      for (int ind = 0; ind < nrhs * nxny; ++ind) { // Loop over fields, X and Y
+        int ir = ind / nxny;
+        int ix = xs + (ind % nxny) / ny;
+        int iy = ys + ind % ny;
+
+        for (int kz = 0; kz < nmode; kz++)
+          k1d[kz] = xcmplx3D((ir * ny + iy - ys) * nmode + kz, ix - xs);
+
+        for (int kz = nmode; kz < mesh->LocalNz / 2 + 1; kz++)
+          k1d[kz] = 0.0; // Filtering out all higher harmonics
+
+        irfft(std::begin(k1d), mesh->LocalNz, x[ir](ix, iy));
+      }
+    }
+  }
+  return x;
+}
@@ -77,16 +77,35 @@ public:
 
   const Field3D solve(const Field3D &b) override {return solve(b,b);}
   const Field3D solve(const Field3D &b, const Field3D &x0) override;
+
+  /// Invert several right-hand sides with the same coefficients in a
+  /// single batch: all fields go through one matrix setup and one
+  /// cyclic-reduction communication round
+  const std::vector<Field3D> solve(const std::vector<Field3D> &b) override;
 private:
   Field2D Acoef, Ccoef, Dcoef;
-  
+
   int nmode;  // Number of modes being solved
   int xs, xe; // Start and end X indices
   Matrix<dcomplex> a, b, c, bcmplx, xcmplx;
-  
+
   bool dst;
-  
+  bool mixedprecision; ///< Single-precision sweeps with double-precision refinement
+
   CyclicReduce<dcomplex> *cr; ///< Tridiagonal solver
+  CyclicReduce<std::complex<float>> *crf; ///< Single-precision solver for mixed-precision mode
+
+  /// Workspaces for the mixed-precision path, resized on demand
+  Matrix<std::complex<float>> af, bf, cf, rhsf, xf;
+
+  /// Solve the assembled tridiagonal systems \p rhs into \p x.
+  /// Either solves directly in double precision, or (mixedprecision)
+  /// runs the cyclic-reduction sweeps in single precision followed by
+  /// one double-precision iterative-refinement pass, halving the
+  /// memory traffic of the dominant kernel
+  void solveSystems(Matrix<dcomplex> &avec, Matrix<dcomplex> &bvec,
+                    Matrix<dcomplex> &cvec, Matrix<dcomplex> &rhs,
+                    Matrix<dcomplex> &x);
 };
 
 #endif // __SPT_H__
@@ -69,10 +69,35 @@ MultigridAlg::~MultigridAlg() {
   output<<"End deconstruction Malg AAAA "<<numP<<endl;
   for(int i = 0;i<mglevel;i++) delete [] matmg[i];
   delete [] matmg;
+  if(matmgf != nullptr) {
+    for(int i = 0;i<mglevel;i++) delete [] matmgf[i];
+    delete [] matmgf;
+  }
+}
+
+/// Refresh the single-precision copies of the matrices, used by the
+/// threaded smoothing sweeps in mixed-precision mode. Residuals,
+/// restriction and coarse corrections stay in double precision, so
+/// the V-cycle acts as iterative refinement and the converged answer
+/// is unaffected, while the memory traffic of the dominant smoothing
+/// kernel is halved
+void MultigridAlg::updateMatrixF() {
+  if(matmgf == nullptr) {
+    matmgf = new float *[mglevel];
+    for(int i = 0;i<mglevel;i++)
+      matmgf[i] = new float[(lnx[i]+2)*(lnz[i]+2)*9];
+  }
+  for(int n = 0;n<mglevel;n++) {
+    int dim = (lnx[n]+2)*(lnz[n]+2)*9;
+BOUT_OMP(parallel for default(shared))
+    for(int i = 0;i<dim;i++) matmgf[n][i] = static_cast<float>(matmg[n][i]);
+  }
 }
 
 void MultigridAlg::getSolution(BoutReal *x,BoutReal *b,int flag) {
 
+  if(mixedsm != 0) updateMatrixF();
+
   if(flag == 0) {
     //Solve exaclty
     if(mglevel == 1) pGMRES(x,b,mglevel-1,1);
@@ -107,16 +132,13 @@ void MultigridAlg::cycleMG(int level,BoutReal *sol,BoutReal *rhs)
     lowestSolver(sol,rhs,0);
   }
   else {
-    Array<BoutReal> r((lnx[level] + 2) * (lnz[level] + 2));
     Array<BoutReal> pr((lnx[level - 1] + 2) * (lnz[level - 1] + 2));
     Array<BoutReal> y((lnx[level - 1] + 2) * (lnz[level - 1] + 2));
     Array<BoutReal> iy((lnx[level] + 2) * (lnz[level] + 2));
 
     smoothings(level,sol,rhs);
 
-    residualVec(level, sol, rhs, std::begin(r));
-
-    projection(level, std::begin(r), std::begin(pr));
+    residualProjection(level, sol, rhs, std::begin(pr));
 
     BOUT_OMP(parallel default(shared))
 BOUT_OMP(for)
@@ -164,6 +186,47 @@ BOUT_OMP(for collapse(2))
   return;
 }
 
+/// Fused residual + restriction, equivalent to residualVec() followed
+/// by projection(). The restriction only reads interior fine-level
+/// residuals, so computing them on the fly avoids a fine-level work
+/// array and its two guard-cell communications
+void MultigridAlg::residualProjection(int level,BoutReal *x,BoutReal *b,
+                                      BoutReal *pr)
+{
+  communications(x,level);
+  int mm = lnz[level]+2;
+BOUT_OMP(parallel default(shared))
+  {
+BOUT_OMP(for)
+    for(int i=0;i<(lnx[level-1]+2)*(lnz[level-1]+2);i++) pr[i] = 0.;
+    int xend = lnx[level-1]+1;
+    int zend = lnz[level-1]+1;
+BOUT_OMP(for collapse(2))
+    for (int i=1; i< xend; i++) {
+      for (int k=1; k< zend; k++) {
+        int i2 = 2*i-1;
+        int k2 = 2*k-1;
+        int nn = i*(lnz[level-1]+2)+k;
+        int n0 = i2*mm+k2;
+        // The four fine-level points under this coarse point
+        int fine[4] = {n0, n0 + 1, n0 + mm, n0 + mm + 1};
+        BoutReal val = 0.0;
+        for(int j=0;j<4;j++) {
+          int p = fine[j];
+          val += b[p] - (matmg[level][p*9+4]*x[p] + matmg[level][p*9+3]*x[p-1]
+            +matmg[level][p*9+5]*x[p+1] + matmg[level][p*9+1]*x[p-mm]
+            +matmg[level][p*9+7]*x[p+mm] +matmg[level][p*9]*x[p-mm-1]
+            +matmg[level][p*9+2]*x[p-mm+1] + matmg[level][p*9+6]*x[p+mm-1]
+            +matmg[level][p*9+8]*x[p+mm+1]);
+        }
+        pr[nn] = val/4.0;
+      }
+    }
+  }
+  communications(pr,level-1);
+  return;
+}
+
 void MultigridAlg::prolongation(int level,BoutReal *x,BoutReal *ix) {
 
   communications(x,level);
@@ -202,11 +265,13 @@ void MultigridAlg::smoothings(int level, BoutReal *x, BoutReal *b) {
   dim = mm*(lnx[level]+2);
   if(mgsm == 0) {
     Array<BoutReal> x0(dim);
+    // Single-precision matrix for mixed-precision smoothing (see updateMatrixF)
+    const float *matf = (mixedsm != 0 && matmgf != nullptr) ? matmgf[level] : nullptr;
     communications(x,level);
 BOUT_OMP(parallel default(shared))
     for(int num =0;num < 2;num++) {
 BOUT_OMP(for)
-      for(int i = 0;i<dim;i++) x0[i] = x[i];    
+      for(int i = 0;i<dim;i++) x0[i] = x[i];
 
       int xend = lnx[level]+1;
       int zend = lnz[level]+1;
@@ -214,21 +279,81 @@ BOUT_OMP(for collapse(2))
       for(int i=1;i<xend;i++)
         for(int k=1;k<zend;k++) {
           int nn = i*mm+k;
-          BoutReal val = b[nn] - matmg[level][nn*9+3]*x0[nn-1]
-	   - matmg[level][nn*9+5]*x0[nn+1] - matmg[level][nn*9+1]*x0[nn-mm]
-           - matmg[level][nn*9+7]*x0[nn+mm] - matmg[level][nn*9]*x0[nn-mm-1]
-           - matmg[level][nn*9+2]*x0[nn-mm+1] - matmg[level][nn*9+6]*x0[nn+mm-1]
-           - matmg[level][nn*9+8]*x0[nn+mm+1];
-          if(fabs(matmg[level][nn*9+4]) <atol)
+          BoutReal val, diag;
+          if(matf != nullptr) {
+            val = b[nn] - matf[nn*9+3]*x0[nn-1]
+             - matf[nn*9+5]*x0[nn+1] - matf[nn*9+1]*x0[nn-mm]
+             - matf[nn*9+7]*x0[nn+mm] - matf[nn*9]*x0[nn-mm-1]
+             - matf[nn*9+2]*x0[nn-mm+1] - matf[nn*9+6]*x0[nn+mm-1]
+             - matf[nn*9+8]*x0[nn+mm+1];
+            diag = matf[nn*9+4];
+          }
+          else {
+            val = b[nn] - matmg[level][nn*9+3]*x0[nn-1]
+	     - matmg[level][nn*9+5]*x0[nn+1] - matmg[level][nn*9+1]*x0[nn-mm]
+             - matmg[level][nn*9+7]*x0[nn+mm] - matmg[level][nn*9]*x0[nn-mm-1]
+             - matmg[level][nn*9+2]*x0[nn-mm+1] - matmg[level][nn*9+6]*x0[nn+mm-1]
+             - matmg[level][nn*9+8]*x0[nn+mm+1];
+            diag = matmg[level][nn*9+4];
+          }
+          if(fabs(diag) <atol)
             throw BoutException("Error at matmg(%d-%d)",level,nn);
 
-          x[nn] = (1.0-omega)*x[nn] + omega*val/matmg[level][nn*9+4];
-        } 
+          x[nn] = (1.0-omega)*x[nn] + omega*val/diag;
+        }
       communications(x,level);
     }
   }
+  else if(mgsm == 2) {
+    /* Red-black Gauss-Seidel. The four corner couplings of the 9-point
+     * stencil connect points of the same colour, so within a half-sweep
+     * they use previous-iterate values (a Jacobi/Gauss-Seidel hybrid,
+     * which is fine for a smoother). Each half-sweep is then
+     * independent point-by-point and can be threaded over rows, keeping
+     * each row's contiguous z line in cache. The colouring uses global
+     * indices so the pattern matches across processor boundaries. */
+    int xoff = xProcI*lnx[level];
+    int zoff = zProcI*lnz[level];
+    // Single-precision matrix for mixed-precision smoothing (see updateMatrixF)
+    const float *matf = (mixedsm != 0 && matmgf != nullptr) ? matmgf[level] : nullptr;
+    communications(x,level);
+    for(int num = 0;num < 2;num++) {
+      for(int colour = 0;colour < 2;colour++) {
+        int xend = lnx[level]+1;
+BOUT_OMP(parallel for default(shared))
+        for(int i = 1;i<xend;i++) {
+          // First z index of this colour in this row, from the global parity
+          int ks = 2 - ((colour + xoff + zoff + i) % 2);
+          for(int k = ks;k<lnz[level]+1;k += 2) {
+            int nn = i*mm+k;
+            BoutReal val, diag;
+            if(matf != nullptr) {
+              val = b[nn] - matf[nn*9+3]*x[nn-1]
+                  - matf[nn*9+5]*x[nn+1] - matf[nn*9+1]*x[nn-mm]
+                  - matf[nn*9+7]*x[nn+mm] - matf[nn*9]*x[nn-mm-1]
+                  - matf[nn*9+2]*x[nn-mm+1] - matf[nn*9+6]*x[nn+mm-1]
+                  - matf[nn*9+8]*x[nn+mm+1];
+              diag = matf[nn*9+4];
+            }
+            else {
+              val = b[nn] - matmg[level][nn*9+3]*x[nn-1]
+                  - matmg[level][nn*9+5]*x[nn+1] - matmg[level][nn*9+1]*x[nn-mm]
+                  - matmg[level][nn*9+7]*x[nn+mm] - matmg[level][nn*9]*x[nn-mm-1]
+                  - matmg[level][nn*9+2]*x[nn-mm+1] - matmg[level][nn*9+6]*x[nn+mm-1]
+                  - matmg[level][nn*9+8]*x[nn+mm+1];
+              diag = matmg[level][nn*9+4];
+            }
+            if(fabs(diag) <atol)
+              throw BoutException("Error at matmg(%d-%d)",level,nn);
+            x[nn] = val/diag;
+          }
+        }
+        communications(x,level);
+      }
+    }
+  }
   else {
-    communications(x,level);    
+    communications(x,level);
     for(int i = 1;i<lnx[level]+1;i++)
       for(int k=1;k<lnz[level]+1;k++) {
         int nn = i*mm+k;
@@ -496,7 +621,7 @@ BOUT_OMP(for reduction(+:ini_e) collapse(2))
     }
   }
   if(numP > 1) 
-    MPI_Allreduce(&ini_e,&val,1,MPI_DOUBLE,MPI_SUM,commMG);
+    MPI_Allreduce(&ini_e,&val,1,BOUT_MPI_REAL,MPI_SUM,commMG);
   else val = ini_e;
 
   return(val);  
@@ -620,7 +745,7 @@ void MultigridAlg::communications(BoutReal* x, int level) {
   if(zNP > 1) {
     MPI_Datatype xvector;
     //    output<<"Start Z-comm"<<endl;
-    ierr = MPI_Type_vector(lnx[level], 1, lnz[level]+2, MPI_DOUBLE, &xvector);
+    ierr = MPI_Type_vector(lnx[level], 1, lnz[level]+2, BOUT_MPI_REAL, &xvector);
     ASSERT1(ierr == MPI_SUCCESS);
     
     ierr = MPI_Type_commit(&xvector);
@@ -655,16 +780,16 @@ void MultigridAlg::communications(BoutReal* x, int level) {
     stag = rProcI; 
     rtag = xProcM;
     ierr = MPI_Sendrecv(&x[lnx[level]*(lnz[level]+2)],lnz[level]+2,
-                MPI_DOUBLE,xProcP,stag,&x[0],lnz[level]+2,MPI_DOUBLE,
+                BOUT_MPI_REAL,xProcP,stag,&x[0],lnz[level]+2,BOUT_MPI_REAL,
                 xProcM,rtag,commMG,status);
     ASSERT1(ierr == MPI_SUCCESS);
     
     // Send to x- and recieve from x+
     stag = rProcI+xNP;
     rtag = xProcP+xNP;;
-    ierr = MPI_Sendrecv(&x[lnz[level]+2],lnz[level]+2,MPI_DOUBLE,xProcM,stag,
+    ierr = MPI_Sendrecv(&x[lnz[level]+2],lnz[level]+2,BOUT_MPI_REAL,xProcM,stag,
                         &x[(lnx[level]+1)*(lnz[level]+2)],lnz[level]+2,
-                        MPI_DOUBLE,xProcP,rtag,commMG,status);
+                        BOUT_MPI_REAL,xProcP,rtag,commMG,status);
     ASSERT1(ierr == MPI_SUCCESS);
   }  else {
     for (int i=0;i<lnz[level]+2;i++) {
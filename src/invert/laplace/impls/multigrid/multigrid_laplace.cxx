@@ -57,11 +57,12 @@ LaplaceMultigrid::LaplaceMultigrid(Options *opt, const CELL_LOC loc) :
   opts->get("dtol",dtol,pow(10.0,5),true);
   opts->get("smtype",mgsm,1,true);
 #ifdef _OPENMP
-  if (mgsm != 0 && omp_get_max_threads()>1) {
-    output_warn << "WARNING: in multigrid Laplace solver, for smtype!=0 the smoothing cannot be parallelised with OpenMP threads."<<endl
-                << "         Consider using smtype=0 instead when using OpenMP threads."<<endl;
+  if (mgsm == 1 && omp_get_max_threads()>1) {
+    output_warn << "WARNING: in multigrid Laplace solver, for smtype=1 the smoothing cannot be parallelised with OpenMP threads."<<endl
+                << "         Consider using smtype=0 (Jacobi) or smtype=2 (red-black) instead when using OpenMP threads."<<endl;
   }
 #endif
+  opts->get("mixedprecision",mixedsm,0,true);
   opts->get("jacomega",omega,0.8,true);
   opts->get("solvertype",mgplag,1,true);
   opts->get("cftype",cftype,0,true);
@@ -162,7 +163,8 @@ LaplaceMultigrid::LaplaceMultigrid(Options *opt, const CELL_LOC loc) :
   kMG = std::unique_ptr<Multigrid1DP>(new Multigrid1DP(
       aclevel, Nx_local, Nz_local, Nx_global, adlevel, mgmpi, commX, pcheck));
   kMG->mgplag = mgplag;
-  kMG->mgsm = mgsm; 
+  kMG->mgsm = mgsm;
+  kMG->mixedsm = mixedsm;
   kMG->cftype = cftype;
   kMG->rtol = rtol;
   kMG->atol = atol;
@@ -182,7 +184,9 @@ LaplaceMultigrid::LaplaceMultigrid(Options *opt, const CELL_LOC loc) :
       output<<"with omega = "<<omega<<endl;
     }
     else if(mgsm ==1) output<<" Gauss-Seidel smoother"<<endl;
+    else if(mgsm ==2) output<<" red-black Gauss-Seidel smoother"<<endl;
     else throw BoutException("Undefined smoother");
+    if (mixedsm != 0) output<<" with single-precision smoothing sweeps"<<endl;
     output<<"Solver type is ";
     if (mglevel == 1) output<<"PGMRES with simple Preconditioner"<<endl;
     else if(mgplag == 1) output<<"PGMRES with multigrid Preconditioner"<<endl;
@@ -53,9 +53,11 @@ public:
   void getSolution(BoutReal *,BoutReal *,int ); 
 
   int mglevel,mgplag,cftype,mgsm,pcheck,xNP,zNP,rProcI;
+  int mixedsm = 0; ///< If non-zero, threaded smoothing sweeps read single-precision matrices
   BoutReal rtol,atol,dtol,omega;
   Array<int> gnx, gnz, lnx, lnz;
   BoutReal **matmg;
+  float **matmgf = nullptr; ///< Single-precision copies of matmg, refreshed in getSolution()
 
 protected:
   /******* Start implementation ********/
@@ -65,10 +67,12 @@ protected:
 
   void communications(BoutReal *, int );
   void setMatrixC(int );
+  void updateMatrixF();
 
   void cycleMG(int ,BoutReal *, BoutReal *);
   void smoothings(int , BoutReal *, BoutReal *);
   void projection(int , BoutReal *, BoutReal *);
+  void residualProjection(int , BoutReal *, BoutReal *, BoutReal *);
   void prolongation(int ,BoutReal *, BoutReal *);
   void pGMRES(BoutReal *, BoutReal *, int , int);
   void solveMG(BoutReal *, BoutReal *, int );
@@ -199,6 +203,7 @@ private:
 
   /******* Start implementation ********/
   int mglevel,mgplag,cftype,mgsm,pcheck;
+  int mixedsm; // Mixed-precision smoothing
   int mgcount,mgmpi;
 
   Options *opts;
@@ -218,6 +218,7 @@ void Multigrid1DP::setValueS() {
   if(kflag == 1) {
     rMG->mgplag = mgplag;
     rMG->mgsm = mgsm;
+    rMG->mixedsm = mixedsm;
     rMG->cftype = cftype;
     rMG->rtol = rtol;
     rMG->atol = atol;
@@ -228,6 +229,7 @@ void Multigrid1DP::setValueS() {
   else if(kflag == 2) {
     sMG->mgplag = mgplag;
     sMG->mgsm = mgsm;
+    sMG->mixedsm = mixedsm;
     sMG->cftype = cftype;
     sMG->rtol = rtol;
     sMG->atol = atol;
@@ -287,7 +289,7 @@ BOUT_OMP(for collapse(2))
         }
       }
     }
-    MPI_Allreduce(std::begin(yl), std::begin(yg), dimg, MPI_DOUBLE, MPI_SUM, comm2D);
+    MPI_Allreduce(std::begin(yl), std::begin(yg), dimg, BOUT_MPI_REAL, MPI_SUM, comm2D);
 
     int nz = (xProcI%rMG->zNP)*(rMG->lnz[level]);
 BOUT_OMP(parallel default(shared))
@@ -324,7 +326,7 @@ BOUT_OMP(for collapse(2))
         }
       }
     }
-    MPI_Allreduce(std::begin(yl), std::begin(yg), dimg, MPI_DOUBLE, MPI_SUM, comm2D);
+    MPI_Allreduce(std::begin(yl), std::begin(yg), dimg, BOUT_MPI_REAL, MPI_SUM, comm2D);
 
     BOUT_OMP(parallel default(shared))
     {
@@ -365,7 +367,7 @@ BOUT_OMP(for collapse(2))
         }
       }
     }
-    MPI_Allreduce(std::begin(y), std::begin(r), dim, MPI_DOUBLE, MPI_SUM, commMG);
+    MPI_Allreduce(std::begin(y), std::begin(r), dim, BOUT_MPI_REAL, MPI_SUM, commMG);
     BOUT_OMP(parallel default(shared))
 BOUT_OMP(for)
     for(int i = 0;i<dim;i++) y[i] = 0.0;
@@ -440,7 +442,7 @@ BOUT_OMP(for collapse(2))
     }  
     fclose(outf);
   }
-  MPI_Allreduce(std::begin(yl), std::begin(yg), dim * 9, MPI_DOUBLE, MPI_SUM, comm2D);
+  MPI_Allreduce(std::begin(yl), std::begin(yg), dim * 9, BOUT_MPI_REAL, MPI_SUM, comm2D);
 
   if(pcheck == 3) {
     FILE *outf;
@@ -502,7 +504,7 @@ BOUT_OMP(for collapse(2))
       }
     }
   }
-  MPI_Allreduce(std::begin(yl), yg, dim * 9, MPI_DOUBLE, MPI_SUM, commMG);
+  MPI_Allreduce(std::begin(yl), yg, dim * 9, BOUT_MPI_REAL, MPI_SUM, commMG);
 }
 
 Multigrid2DPf1D::Multigrid2DPf1D(int level,int lx,int lz, int gx, int gz,
@@ -597,6 +599,7 @@ void Multigrid2DPf1D::setValueS() {
   if(kflag == 2) {
     sMG->mgplag = mgplag;
     sMG->mgsm = mgsm;
+    sMG->mixedsm = mixedsm;
     sMG->cftype = cftype;
     sMG->rtol = rtol;
     sMG->atol = atol;
@@ -641,7 +644,7 @@ BOUT_OMP(for collapse(2))
         }
       }
     }
-    MPI_Allreduce(std::begin(y), std::begin(r), dim, MPI_DOUBLE, MPI_SUM, commMG);
+    MPI_Allreduce(std::begin(y), std::begin(r), dim, BOUT_MPI_REAL, MPI_SUM, commMG);
     BOUT_OMP(parallel default(shared))
 BOUT_OMP(for)
     for(int i = 0;i<dim;i++) y[i] = 0.0;
@@ -694,7 +697,7 @@ BOUT_OMP(for collapse(2))
       }
     }
   }
-  MPI_Allreduce(std::begin(yl), yg, dim * 9, MPI_DOUBLE, MPI_SUM, commMG);
+  MPI_Allreduce(std::begin(yl), yg, dim * 9, BOUT_MPI_REAL, MPI_SUM, commMG);
 }
 
 MultigridSerial::MultigridSerial(int level, int gx, int gz, MPI_Comm comm, int check)
@@ -37,7 +37,8 @@
 LaplaceMumps::LaplaceMumps(Options *opt, const CELL_LOC loc) : 
   Laplacian(opt, loc),
   A(0.0), C1(1.0), C2(1.0), D(1.0), Ex(0.0), Ez(0.0),
-  issetD(false), issetC(false), issetE(false)
+  issetD(false), issetC(false), issetE(false),
+  matrix_generation(0), matrix_y(-1)
 {
   A.setLocation(location);
   C1.setLocation(location);
@@ -173,6 +174,24 @@ LaplaceMumps::LaplaceMumps(Options *opt, const CELL_LOC loc) :
 //   mumps_struc.icntl[22] = ; // Apparently should provide a value here significantly larger than infog[15] when running in parallel
   mumps_struc.icntl[27] = 2; // Force parallel analysis
   mumps_struc.icntl[28] = 0; // set to 1 to force pt-scotch and to 2 to force parmetis to be used for the ordering
+
+  // Block Low-Rank approximate factorization (MUMPS >= 5.1). Trades
+  // factorization accuracy for time and memory; the dropping threshold
+  // sets the accuracy of the low-rank blocks, so should be well below
+  // the accuracy needed of the solution. Must be set before analysis
+  bool mumps_blr;
+  opts->get("mumps_blr", mumps_blr, false);
+  if (mumps_blr) {
+    mumps_struc.icntl[34] = 2; // ICNTL(35): BLR in factorization and solution phases
+    BoutReal mumps_blr_tol;
+    opts->get("mumps_blr_tol", mumps_blr_tol, 1.e-8);
+    mumps_struc.cntl[6] = mumps_blr_tol; // CNTL(7): low-rank dropping threshold
+  }
+
+  // Number of OpenMP threads inside MUMPS (ICNTL(16), MUMPS >= 5.2).
+  // 0 (the default) leaves it to the OMP_NUM_THREADS environment;
+  // older MUMPS versions ignore this entry
+  opts->get("mumps_omp_threads", mumps_struc.icntl[15], 0);
 //   mumps_struc.cntl[0] = 0.01; // relative threshold for numerical pivoting. 0.0 is appropriate if matrix is diagonally dominant (there are no zero pivots). High values increase fill-in but lead to more accurate factorization. Default is 0.01
 // for (int i=0; i<40; i++) output<<i<<" "<<mumps_struc.icntl[i]<<endl;
 // exit(1);
@@ -461,7 +480,7 @@ LaplaceMumps::LaplaceMumps(Options *opt, const CELL_LOC loc) :
 //   
 //   BoutReal* localrhs = **x.getData(); // Input the rhs in the solution field as solution will be returned in place by MUMPS
 //   if (!mesh->firstX()) localrhs += mesh->xstart*mesh->LocalNy*mesh->LocalNz;
-//   MPI_Gatherv(localrhs,localrhssize,MPI_DOUBLE,rhs,localrhs_size_array,rhs_positions,MPI_DOUBLE,0,mesh->getXcomm());
+//   MPI_Gatherv(localrhs,localrhssize,BOUT_MPI_REAL,rhs,localrhs_size_array,rhs_positions,BOUT_MPI_REAL,0,mesh->getXcomm());
 //   
 //   if ( ++iteration_count > repeat_analysis ) {
 //     mumps_struc.job = MUMPS_JOB_ALL;
@@ -496,7 +515,7 @@ LaplaceMumps::LaplaceMumps(Options *opt, const CELL_LOC loc) :
 //     }
 //   }
 //   
-//   MPI_Scatterv(rhs,localrhs_size_array,rhs_positions,MPI_DOUBLE,localrhs,localrhssize,MPI_DOUBLE,0,mesh->getXcomm()); // Scatters solution from host back to localrhs (which points to x's data) on all processors
+//   MPI_Scatterv(rhs,localrhs_size_array,rhs_positions,BOUT_MPI_REAL,localrhs,localrhssize,BOUT_MPI_REAL,0,mesh->getXcomm()); // Scatters solution from host back to localrhs (which points to x's data) on all processors
 //   
 // #if CHECK > 0
 //   msg_stack.pop();
@@ -594,11 +613,11 @@ const FieldPerp LaplaceMumps::solve(const FieldPerp &b) {
     for (int z=0; z<mesh->LocalNz; z++)
       localrhs[(x-xs)*(mesh->LocalNz)+z] = bdata[x*mesh->LocalNz+z];
   
-  MPI_Gatherv(localrhs,localrhssize,MPI_DOUBLE,rhs,localrhs_size_array,rhs_positions,MPI_DOUBLE,0,comm);
+  MPI_Gatherv(localrhs,localrhssize,BOUT_MPI_REAL,rhs,localrhs_size_array,rhs_positions,BOUT_MPI_REAL,0,comm);
   
   solve(rhs,y);
   
-  MPI_Scatterv(rhs,localrhs_size_array,rhs_positions,MPI_DOUBLE,localrhs,localrhssize,MPI_DOUBLE,0,comm); // Scatters solution from host back to localrhs (which points to x's data) on all processors
+  MPI_Scatterv(rhs,localrhs_size_array,rhs_positions,BOUT_MPI_REAL,localrhs,localrhssize,BOUT_MPI_REAL,0,comm); // Scatters solution from host back to localrhs (which points to x's data) on all processors
   
   BoutReal* soldata = *sol.getData();
   for (int x=xs; x<=xe; x++)
@@ -610,6 +629,9 @@ const FieldPerp LaplaceMumps::solve(const FieldPerp &b) {
 
 void LaplaceMumps::solve(BoutReal* rhs, int y) {
 
+// The matrix depends on the y index as well as on the coefficients, so the
+// factorization can only be reused when both are unchanged since the last call
+if ( (matrix_generation != coef_generation) || (matrix_y != y) ) {
 { Timer timer("mumpssetup");
   int i = 0;
   
@@ -844,9 +866,16 @@ void LaplaceMumps::solve(BoutReal* rhs, int y) {
       }
   
   if ( i!=mumps_struc.nz_loc ) throw BoutException("LaplaceMumps: matrix index error");
-  
-  mumps_struc.rhs = rhs;
 }
+  matrix_generation = coef_generation;
+  matrix_y = y;
+  mumps_struc.job = MUMPS_JOB_BOTH; // Factorize the new matrix, then solve
+}
+else
+  mumps_struc.job = MUMPS_JOB_SOLUTION; // Reuse the existing factorization
+
+  mumps_struc.rhs = rhs;
+
 { Timer timer("mumpssolve");
   // Solve the system
   dmumps_c( &mumps_struc );
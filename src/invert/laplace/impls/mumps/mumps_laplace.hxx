@@ -86,75 +86,80 @@ public:
     delete [] mumps_struc.isol_loc;
   }
   
+  // Each coefficient goes through updateCoefCache, which bumps
+  // coef_generation when the value has actually changed. The solve
+  // routine compares generations to decide whether the factorization
+  // can be reused.
   void setCoefA(const Field2D &val) override {
     ASSERT1(val.getLocation() == location);
-    A = val;
+    updateCoefCache(A, Field3D(val));
   }
   void setCoefC(const Field2D &val) override {
     ASSERT1(val.getLocation() == location);
-    C1 = val;
-    C2 = val;
+    Field3D val3d(val);
+    updateCoefCache(C1, val3d);
+    updateCoefCache(C2, val3d);
     issetC = true;
   }
   void setCoefC1(const Field2D &val) override {
     ASSERT1(val.getLocation() == location);
-    C1 = val;
+    updateCoefCache(C1, Field3D(val));
     issetC = true;
   }
   void setCoefC2(const Field2D &val) override {
     ASSERT1(val.getLocation() == location);
-    C2 = val;
+    updateCoefCache(C2, Field3D(val));
     issetC = true;
   }
   void setCoefD(const Field2D &val) override {
     ASSERT1(val.getLocation() == location);
-    D = val;
+    updateCoefCache(D, Field3D(val));
     issetD = true;
   }
   void setCoefEx(const Field2D &val) override {
     ASSERT1(val.getLocation() == location);
-    Ex = val;
+    updateCoefCache(Ex, Field3D(val));
     issetE = true;
   }
   void setCoefEz(const Field2D &val) override {
     ASSERT1(val.getLocation() == location);
-    Ez = val;
+    updateCoefCache(Ez, Field3D(val));
     issetE = true;
   }
 
   void setCoefA(const Field3D &val) override {
     ASSERT1(val.getLocation() == location);
-    A = val;
+    updateCoefCache(A, val);
   }
   void setCoefC(const Field3D &val) override {
     ASSERT1(val.getLocation() == location);
-    C1 = val;
-    C2 = val;
+    updateCoefCache(C1, val);
+    updateCoefCache(C2, val);
     issetC = true;
   }
   void setCoefC1(const Field3D &val) override {
     ASSERT1(val.getLocation() == location);
-    C1 = val;
+    updateCoefCache(C1, val);
     issetC = true;
   }
   void setCoefC2(const Field3D &val) override {
     ASSERT1(val.getLocation() == location);
-    C2 = val;
+    updateCoefCache(C2, val);
     issetC = true;
   }
   void setCoefD(const Field3D &val) override {
     ASSERT1(val.getLocation() == location);
-    D = val;
+    updateCoefCache(D, val);
     issetD = true;
   }
   void setCoefEx(const Field3D &val) override {
     ASSERT1(val.getLocation() == location);
-    Ex = val;
+    updateCoefCache(Ex, val);
     issetE = true;
   }
   void setCoefEz(const Field3D &val) override {
     ASSERT1(val.getLocation() == location);
-    Ez = val;
+    updateCoefCache(Ez, val);
     issetE = true;
   }
   
@@ -174,6 +179,8 @@ private:
   bool issetD;
   bool issetC;
   bool issetE;
+  unsigned int matrix_generation; // coef_generation the factorization was built from
+  int matrix_y;                   // y index the factorization was built for
 //   int repeat_analysis; // Repeat analysis step after this many iterations
 //   int iteration_count; // Use this to count the number of iterations since last analysis
   
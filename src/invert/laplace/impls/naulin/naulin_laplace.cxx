@@ -110,6 +110,7 @@
  */
 
 #include <boutexception.hxx>
+#include <boutcomm.hxx>
 #include <bout/mesh.hxx>
 #include <bout/coordinates.hxx>
 #include <bout/sys/timer.hxx>
@@ -120,9 +121,29 @@
 
 #include "naulin_laplace.hxx"
 
+namespace {
+/// Global inner product of two fields over the grid, for the
+/// least-squares problem in the Anderson update
+BoutReal dot(const Field3D &a, const Field3D &b) {
+  // Accumulated in double, as in mean(Field3D)
+  double result = 0.;
+
+  const Region<Ind3D> &region = a.getMesh()->getRegion3D("RGN_NOBNDRY");
+  BOUT_FOR_OMP(i, region, parallel for reduction(+:result)) {
+    result += a[i] * b[i];
+  }
+
+  double localresult = result;
+  MPI_Allreduce(&localresult, &result, 1, MPI_DOUBLE, MPI_SUM, BoutComm::get());
+  return result;
+}
+} // namespace
+
 LaplaceNaulin::LaplaceNaulin(Options *opt, const CELL_LOC loc)
     : Laplacian(opt, loc), Acoef(0.0), C1coef(1.0), C2coef(0.0), Dcoef(1.0),
-      delp2solver(nullptr), naulinsolver_mean_its(0.), ncalls(0) {
+      delp2solver(nullptr), naulinsolver_mean_its(0.), ncalls(0),
+      naulinsolver_its(0), naulinsolver_abserr(0.), naulinsolver_relerr(0.),
+      have_last_solution(false) {
 
   ASSERT1(opt != nullptr); // An Options pointer should always be passed in by LaplaceFactory
 
@@ -135,6 +156,11 @@ LaplaceNaulin::LaplaceNaulin(Options *opt, const CELL_LOC loc)
   OPTION(opt, rtol, 1.e-7);
   OPTION(opt, atol, 1.e-20);
   OPTION(opt, maxits, 100);
+  // Anderson acceleration: combine this many previous iterates to
+  // extrapolate the fixed point. 0 (the default) keeps the plain
+  // fixed-point iteration; small values (2-4) usually cut the number
+  // of inner Laplacian solves several-fold in stiff cases
+  OPTION(opt, anderson_depth, 0);
   delp2solver = create(opt->getSection("delp2solver"), location);
   std::string delp2type;
   opt->getSection("delp2solver")->get("type", delp2type, "cyclic");
@@ -149,6 +175,9 @@ LaplaceNaulin::LaplaceNaulin(Options *opt, const CELL_LOC loc)
   static bool first = true;
   if (first) {
     SAVE_REPEAT(naulinsolver_mean_its);
+    // Per-call telemetry: iterations and errors of the most recent solve
+    SAVE_REPEAT(naulinsolver_its);
+    SAVE_REPEAT2(naulinsolver_abserr, naulinsolver_relerr);
     first = false;
   }
 }
@@ -194,6 +223,10 @@ const Field3D LaplaceNaulin::solve(const Field3D &rhs, const Field3D &x0) {
   BoutReal error_rel = 1e20, error_abs=1e20;
   int count = 0;
 
+  // Anderson history is only meaningful within one solve
+  x_hist.clear();
+  f_hist.clear();
+
   // Initial values for derivatives of x
   Field3D ddx_x = DDX(x, location, DIFF_C2);
   Field3D ddz_x = DDZ(x, location, DIFF_FFT);
@@ -207,8 +240,14 @@ const Field3D LaplaceNaulin::solve(const Field3D &rhs, const Field3D &x0) {
 
     // NB need to pass x in case boundary flags require 'x0', even if
     // delp2solver is not iterative and does not use an initial guess
-    x = delp2solver->solve(b, x);
-    mesh->communicate(x);
+    if (anderson_depth > 0) {
+      Field3D g = delp2solver->solve(b, x);
+      mesh->communicate(g);
+      x = andersonMix(x, g);
+    } else {
+      x = delp2solver->solve(b, x);
+      mesh->communicate(x);
+    }
 
     // re-calculate the rhs from the new solution
     // Use here to calculate an error, can also use for the next iteration
@@ -230,9 +269,114 @@ const Field3D LaplaceNaulin::solve(const Field3D &rhs, const Field3D &x0) {
   ncalls++;
   naulinsolver_mean_its = (naulinsolver_mean_its*BoutReal(ncalls-1) + BoutReal(count))/BoutReal(ncalls);
 
+  // Record how this call went
+  naulinsolver_its = count;
+  naulinsolver_abserr = error_abs;
+  naulinsolver_relerr = error_rel;
+
+  // Keep for warm-starting the next solve. Copy-on-write, so this
+  // just shares the data
+  last_solution = x;
+  have_last_solution = true;
+
   return x;
 }
 
+const Field3D LaplaceNaulin::solve(const Field3D &rhs) {
+  if (have_last_solution) {
+    return solve(rhs, last_solution);
+  }
+  Field3D x0(rhs.getMesh());
+  x0 = 0.;
+  x0.setLocation(rhs.getLocation());
+  return solve(rhs, x0);
+}
+
+Field3D LaplaceNaulin::andersonMix(const Field3D &xk, const Field3D &gk) {
+  // Anderson acceleration: find the affine combination of the stored
+  // fixed-point results whose residual g(x) - x is smallest in the
+  // least-squares sense, and take that as the next iterate. With
+  // depth p this solves the small p x p normal equations
+  //   M gamma = r,  M_ij = <df_i, df_j>,  r_i = <df_i, fk>
+  // where df_j = fk - f_hist[j], and then mixes
+  //   x_next = gk - sum_j gamma_j (gk - x_next_hist[j])
+  // The coefficients sum to one, so linear boundary conditions
+  // already satisfied by each iterate are preserved and no
+  // re-communication is needed
+
+  Field3D fk = gk - xk;
+
+  int p = f_hist.size();
+  Field3D xnext = gk;
+
+  if (p > 0) {
+    Matrix<BoutReal> M(p, p);
+    Array<BoutReal> r(p), gamma(p);
+
+    std::vector<Field3D> df;
+    for (int j = 0; j < p; j++) {
+      df.push_back(fk - f_hist[j]);
+    }
+    for (int i = 0; i < p; i++) {
+      r[i] = dot(df[i], fk);
+      for (int j = i; j < p; j++) {
+        M(i, j) = dot(df[i], df[j]);
+        M(j, i) = M(i, j);
+      }
+    }
+
+    // Solve M gamma = r by Gaussian elimination with partial
+    // pivoting; the system is tiny (p <= anderson_depth)
+    bool degenerate = false;
+    for (int i = 0; i < p; i++) {
+      int pivot = i;
+      for (int j = i + 1; j < p; j++) {
+        if (std::abs(M(j, i)) > std::abs(M(pivot, i)))
+          pivot = j;
+      }
+      if (std::abs(M(pivot, i)) < 1e-300) {
+        degenerate = true;
+        break;
+      }
+      if (pivot != i) {
+        for (int j = 0; j < p; j++)
+          std::swap(M(i, j), M(pivot, j));
+        std::swap(r[i], r[pivot]);
+      }
+      for (int j = i + 1; j < p; j++) {
+        BoutReal factor = M(j, i) / M(i, i);
+        for (int l = i; l < p; l++)
+          M(j, l) -= factor * M(i, l);
+        r[j] -= factor * r[i];
+      }
+    }
+    if (!degenerate) {
+      for (int i = p - 1; i >= 0; i--) {
+        gamma[i] = r[i];
+        for (int j = i + 1; j < p; j++)
+          gamma[i] -= M(i, j) * gamma[j];
+        gamma[i] /= M(i, i);
+      }
+      for (int j = 0; j < p; j++) {
+        xnext -= gamma[j] * (gk - x_hist[j]);
+      }
+    }
+    // If degenerate (e.g. converged history entries), fall through
+    // with the unaccelerated gk
+  }
+
+  // Update history. x_hist stores the candidate iterates whose
+  // residuals are in f_hist, so the two stay aligned
+  x_hist.push_back(gk);
+  f_hist.push_back(fk);
+  if (static_cast<int>(f_hist.size()) > anderson_depth) {
+    x_hist.erase(x_hist.begin());
+    f_hist.erase(f_hist.begin());
+  }
+
+  return xnext;
+}
+
 void LaplaceNaulin::copy_x_boundaries(Field3D &x, const Field3D &x0, Mesh *mesh) {
   if (mesh->firstX()) {
     for (int i=mesh->xstart-1; i>=0; i--)
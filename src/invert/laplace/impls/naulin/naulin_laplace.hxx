@@ -99,12 +99,11 @@ public:
         "LaplaceNaulin has no solve(FieldPerp), must call solve(Field3D)");
   }
   const Field3D solve(const Field3D &b, const Field3D &x0) override;
-  const Field3D solve(const Field3D &b) override {
-    Field3D x0(b.getMesh());
-    x0 = 0.;
-    x0.setLocation(b.getLocation());
-    return solve(b, Field3D(0.));
-  }
+  /// Solve, warm-starting from the previous solution if there is one.
+  /// When called once per timestep the solution changes little between
+  /// calls, so this typically saves several iterations compared to
+  /// starting from zero
+  const Field3D solve(const Field3D &b) override;
 
   // Override flag-setting methods to set delp2solver's flags as well
   void setGlobalFlags(int f) override { Laplacian::setGlobalFlags(f); delp2solver->setGlobalFlags(f); }
@@ -112,6 +111,11 @@ public:
   void setOuterBoundaryFlags(int f) override { Laplacian::setOuterBoundaryFlags(f); delp2solver->setOuterBoundaryFlags(f); }
 
   BoutReal getMeanIterations() const { return naulinsolver_mean_its; }
+  /// Number of iterations taken by the most recent solve
+  int getIterations() const { return naulinsolver_its; }
+  /// Absolute and relative error of the most recent solve
+  BoutReal getAbsError() const { return naulinsolver_abserr; }
+  BoutReal getRelError() const { return naulinsolver_relerr; }
 private:
   LaplaceNaulin(const LaplaceNaulin&);
   LaplaceNaulin& operator=(const LaplaceNaulin&);
@@ -119,9 +123,28 @@ private:
   Laplacian* delp2solver;
   BoutReal rtol, atol;
   int maxits;
+  int anderson_depth; ///< Depth of Anderson acceleration history, 0 = plain fixed point
   BoutReal naulinsolver_mean_its;
   int ncalls;
 
+  // Per-call telemetry, written to the dump file
+  int naulinsolver_its;         ///< Iterations taken by the last solve
+  BoutReal naulinsolver_abserr; ///< Absolute error of the last solve
+  BoutReal naulinsolver_relerr; ///< Relative error of the last solve
+
+  Field3D last_solution;   ///< Result of the previous solve, for warm-starting
+  bool have_last_solution; ///< Has a solve completed yet?
+
+  // Anderson acceleration history, valid only within one solve
+  std::vector<Field3D> x_hist; ///< Previous accepted iterates
+  std::vector<Field3D> f_hist; ///< Previous fixed-point residuals g(x) - x
+
+  /// Combine the current iterate \p xk and fixed-point result \p gk
+  /// with the history to produce an accelerated next iterate, and
+  /// update the history. Falls back to \p gk when the least-squares
+  /// problem is degenerate
+  Field3D andersonMix(const Field3D &xk, const Field3D &gk);
+
   void copy_x_boundaries(Field3D &x, const Field3D &x0, Mesh *mesh);
 };
 
@@ -60,7 +60,8 @@ static PetscErrorCode laplacePCapply(PC pc,Vec x,Vec y) {
 LaplacePetsc::LaplacePetsc(Options *opt, const CELL_LOC loc) :
   Laplacian(opt, loc),
   A(0.0), C1(1.0), C2(1.0), D(1.0), Ex(0.0), Ez(0.0),
-  issetD(false), issetC(false), issetE(false)
+  issetD(false), issetC(false), issetE(false),
+  matrix_generation(0), matrix_y(-1), matrix_reusable(false)
 {
   A.setLocation(location);
   C1.setLocation(location);
@@ -370,6 +371,13 @@ const FieldPerp LaplacePetsc::solve(const FieldPerp &b, const FieldPerp &x0) {
   // Determine which row/columns of the matrix are locally owned
   MatGetOwnershipRange( MatA, &Istart, &Iend );
 
+  // If the coefficients and y index are unchanged since the matrix was
+  // last assembled, the matrix - and with it the preconditioner or
+  // factorization the KSP has built - can be kept. The loop below still
+  // runs to fill the RHS and initial guess vectors, but Element() skips
+  // the matrix insertions.
+  matrix_reusable = (matrix_generation == coef_generation) && (matrix_y == y);
+
   int i = Istart;   // The row in the PETSc matrix
   { Timer timer("petscsetup");
 
@@ -711,13 +719,6 @@ const FieldPerp LaplacePetsc::solve(const FieldPerp &b, const FieldPerp &x0) {
     throw BoutException("Petsc index sanity check failed");
   }
 
-  // Assemble Matrix
-  MatAssemblyBegin( MatA, MAT_FINAL_ASSEMBLY );
-  MatAssemblyEnd( MatA, MAT_FINAL_ASSEMBLY );
-
-//   // Record which flags were used for this matrix
-//   lastflag = flags;
-
   // Assemble RHS Vector
   VecAssemblyBegin(bs);
   VecAssemblyEnd(bs);
@@ -726,6 +727,17 @@ const FieldPerp LaplacePetsc::solve(const FieldPerp &b, const FieldPerp &x0) {
   VecAssemblyBegin(xs);
   VecAssemblyEnd(xs);
 
+  // When the matrix is being reused, leave the KSP untouched so it keeps the
+  // preconditioner (or factorization, for a direct solve) it has already built
+  if( !matrix_reusable ) {
+
+  // Assemble Matrix
+  MatAssemblyBegin( MatA, MAT_FINAL_ASSEMBLY );
+  MatAssemblyEnd( MatA, MAT_FINAL_ASSEMBLY );
+
+//   // Record which flags were used for this matrix
+//   lastflag = flags;
+
   // Configure Linear Solver
 #if PETSC_VERSION_GE(3,5,0)
   KSPSetOperators( ksp,MatA,MatA);
@@ -783,6 +795,11 @@ const FieldPerp LaplacePetsc::solve(const FieldPerp &b, const FieldPerp &x0) {
 
     KSPSetFromOptions( ksp );
   }
+
+  // Record what the matrix now holds
+  matrix_generation = coef_generation;
+  matrix_y = y;
+  }
   }
 
   // Call the actual solver
@@ -863,6 +880,9 @@ void LaplacePetsc::Element(int i, int x, int z,
                            int xshift, int zshift,
                            PetscScalar ele, Mat &MatA ) {
 
+  // The assembled matrix already holds these values
+  if( matrix_reusable ) return;
+
   // Need to convert LOCAL x to GLOBAL x in order to correctly calculate
   // PETSC Matrix Index.
   int xoffset = Istart / meshz;
@@ -76,87 +76,89 @@ public:
     MatDestroy( &MatA );
   }
 
+  // Coefficients are stored through updateCoefCache, which increments
+  // coef_generation when a value actually changes; solve() uses this to
+  // decide whether the matrix and preconditioner can be kept
   void setCoefA(const Field2D &val) override {
     ASSERT1(val.getLocation() == location);
-    A = val;
-    /*Acoefchanged = true;*/
+    updateCoefCache(A, Field3D(val));
     if(pcsolve) pcsolve->setCoefA(val);
   }
   void setCoefC(const Field2D &val) override {
     ASSERT1(val.getLocation() == location);
-    C1 = val;
-    C2 = val;
-    issetC = true; /*coefchanged = true;*/
+    Field3D val3d(val);
+    updateCoefCache(C1, val3d);
+    updateCoefCache(C2, val3d);
+    issetC = true;
     if(pcsolve) pcsolve->setCoefC(val);
   }
   void setCoefC1(const Field2D &val) override {
     ASSERT1(val.getLocation() == location);
-    C1 = val;
+    updateCoefCache(C1, Field3D(val));
     issetC = true;
   }
   void setCoefC2(const Field2D &val) override {
     ASSERT1(val.getLocation() == location);
-    C2 = val;
+    updateCoefCache(C2, Field3D(val));
     issetC = true;
   }
   void setCoefD(const Field2D &val) override {
     ASSERT1(val.getLocation() == location);
-    D = val;
-    issetD = true; /*coefchanged = true;*/
+    updateCoefCache(D, Field3D(val));
+    issetD = true;
     if(pcsolve) pcsolve->setCoefD(val);
   }
   void setCoefEx(const Field2D &val) override {
     ASSERT1(val.getLocation() == location);
-    Ex = val;
-    issetE = true; /*coefchanged = true;*/
+    updateCoefCache(Ex, Field3D(val));
+    issetE = true;
     if(pcsolve) pcsolve->setCoefEx(val);
   }
   void setCoefEz(const Field2D &val) override {
     ASSERT1(val.getLocation() == location);
-    Ez = val;
-    issetE = true; /*coefchanged = true;*/
+    updateCoefCache(Ez, Field3D(val));
+    issetE = true;
     if(pcsolve) pcsolve->setCoefEz(val);
   }
 
   void setCoefA(const Field3D &val) override {
     ASSERT1(val.getLocation() == location);
-    A = val;
-    /*Acoefchanged = true;*/
+    updateCoefCache(A, val);
     if(pcsolve) pcsolve->setCoefA(val);
   }
   void setCoefC(const Field3D &val) override {
     ASSERT1(val.getLocation() == location);
-    C1 = val;
-    C2 = val;
-    issetC = true; /*coefchanged = true;*/
+    updateCoefCache(C1, val);
+    updateCoefCache(C2, val);
+    issetC = true;
     if(pcsolve) pcsolve->setCoefC(val);
   }
   void setCoefC1(const Field3D &val) override {
     ASSERT1(val.getLocation() == location);
-    C1 = val;
+    updateCoefCache(C1, val);
     issetC = true;
   }
   void setCoefC2(const Field3D &val) override {
     ASSERT1(val.getLocation() == location);
-    C2 = val;
+    updateCoefCache(C2, val);
     issetC = true;
   }
   void setCoefD(const Field3D &val) override {
     ASSERT1(val.getLocation() == location);
-    D = val;
-    issetD = true; /*coefchanged = true;*/
+    updateCoefCache(D, val);
+    issetD = true;
     if(pcsolve) pcsolve->setCoefD(val);
   }
   void setCoefEx(const Field3D &val) override {
     ASSERT1(val.getLocation() == location);
-    Ex = val;
-    issetE = true; /*coefchanged = true;*/
+    updateCoefCache(Ex, val);
+    issetE = true;
     if(pcsolve) pcsolve->setCoefEx(val);
   }
   void setCoefEz(const Field3D &val) override {
     ASSERT1(val.getLocation() == location);
-    Ez = val;
-    issetE = true; /*coefchanged = true;*/
+    updateCoefCache(Ez, val);
+    issetE = true;
     if(pcsolve) pcsolve->setCoefEz(val);
   }
 
@@ -176,14 +178,17 @@ private:
    * See LaplacePetsc::Coeffs for details an potential pit falls
    */
   Field3D A, C1, C2, D, Ex, Ez;
-// Metrics are not constant in y-direction, so matrix always changes as you loop over the grid
-// Hence using coefchanged switch to avoid recomputing the mmatrix is not a useful thing to do (unless maybe in a cylindrical machine, but not worth implementing just for that)
-//   bool coefchanged;           // Set to true when C, D, Ex or Ez coefficients are changed
-//   bool Acoefchanged;	      // Set to true when A coefficient is changed
+// Metrics are not constant in y-direction, so the matrix changes as you loop
+// over the grid. Reuse is therefore keyed on the (coefficient generation, y)
+// pair: it pays off when the same y-slice is solved repeatedly, e.g. a
+// FieldPerp inverted every timestep, not when looping over a 3D field
   bool issetD;
   bool issetC;
   bool issetE;
   int lastflag;               // The flag used to construct the matrix
+  unsigned int matrix_generation; // coef_generation the matrix was built from
+  int matrix_y;               // y index the matrix was built for
+  bool matrix_reusable;       // Set during solve(): skip matrix insertion and KSP setup
 
   FieldPerp sol;              // solution Field
 
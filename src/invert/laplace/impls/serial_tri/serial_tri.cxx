@@ -82,8 +82,6 @@ const FieldPerp LaplaceSerialTri::solve(const FieldPerp &b, const FieldPerp &x0)
   int ncz = mesh->LocalNz; // No of z pnts
   int ncx = mesh->LocalNx; // No of x pnts
 
-  BoutReal kwaveFactor = 2.0 * PI / mesh->getCoordinates(location)->zlength();
-
   // Setting the width of the boundary.
   // NOTE: The default is a width of 2 guard cells
   int inbndry = mesh->xstart, outbndry=mesh->xstart;
@@ -97,7 +95,7 @@ const FieldPerp LaplaceSerialTri::solve(const FieldPerp &b, const FieldPerp &x0)
   if (outer_boundary_flags & INVERT_BNDRY_ONE)
     outbndry = 1;
 
-  /* Allocation fo
+  /* Allocation (done once, on the first solve) of
    * bk   = The fourier transformed of b, where b is one of the inputs in
    *        LaplaceSerialTri::solve()
    * bk1d = The 1d array of bk
@@ -105,102 +103,188 @@ const FieldPerp LaplaceSerialTri::solve(const FieldPerp &b, const FieldPerp &x0)
    *        LaplaceSerialTri::solve()
    * xk1d = The 1d array of xk
    */
-  auto bk = Matrix<dcomplex>(ncx, ncz / 2 + 1);
-  auto bk1d = Array<dcomplex>(ncx);
-  auto xk = Matrix<dcomplex>(ncx, ncz / 2 + 1);
-  auto xk1d = Array<dcomplex>(ncx);
+  if (bk.empty()) {
+    bk = Matrix<dcomplex>(ncx, ncz / 2 + 1);
+    bk1d = Array<dcomplex>(ncx);
+    xk = Matrix<dcomplex>(ncx, ncz / 2 + 1);
+    xk1d = Array<dcomplex>(ncx);
 
-  // Initialise xk to 0 as we only visit 0<= kz <= maxmode in solve
-  for (int ix = 0; ix < ncx; ix++) {
-    for (int kz = maxmode + 1; kz < ncz / 2 + 1; kz++) {
-      xk(ix, kz) = 0.0;
+    // Initialise xk to 0 as we only visit 0<= kz <= maxmode in solve
+    for (int ix = 0; ix < ncx; ix++) {
+      for (int kz = maxmode + 1; kz < ncz / 2 + 1; kz++) {
+        xk(ix, kz) = 0.0;
+      }
+    }
+
+    if (mesh->periodicX) {
+      // Scratch matrix bands for cyclic_tridag, which modifies its inputs
+      avec = Array<dcomplex>(ncx);
+      bvec = Array<dcomplex>(ncx);
+      cvec = Array<dcomplex>(ncx);
     }
   }
 
-  /* Coefficents in the tridiagonal solver matrix
+  /* The tridiagonal matrix coefficients, built (and cached) by calling
+   * tridagCoef and setting the BC for each fourier mode
+   *
    * Following the notation in "Numerical recipes"
    * avec is the lower diagonal of the matrix
    * bvec is the diagonal of the matrix
    * cvec is the upper diagonal of the matrix
    * NOTE: Do not confuse avec, bvec and cvec with the A, C, and D coefficients
-   *       above
+   *       in
+   *
+   * D*Laplace_perp(x) + (1/C)Grad_perp(C)*Grad_perp(x) + Ax = B
    */
-  auto avec = Array<dcomplex>(ncx);
-  auto bvec = Array<dcomplex>(ncx);
-  auto cvec = Array<dcomplex>(ncx);
+  const TridagCoefTable &coefs = cachedTridagMatrix(jy, &A, &C, &D);
 
-  BOUT_OMP(parallel for)
-  for (int ix = 0; ix < ncx; ix++) {
-    /* This for loop will set the bk (initialized by the constructor)
-     * bk is the z fourier modes of b in z
-     * If the INVERT_SET flag is set (meaning that x0 will be used to set the
-     * bounadry values),
-     */
-    if (((ix < inbndry) && (inner_boundary_flags & INVERT_SET)) ||
-        ((ncx - 1 - ix < outbndry) && (outer_boundary_flags & INVERT_SET))) {
-      // Use the values in x0 in the boundary
-
-      // x0 is the input
-      // bk is the output
-      rfft(x0[ix], ncz, &bk(ix, 0));
-
-    } else {
-      // b is the input
-      // bk is the output
-      rfft(b[ix], ncz, &bk(ix, 0));
+  if (!((inner_boundary_flags & INVERT_SET) || (outer_boundary_flags & INVERT_SET))) {
+    // All rows come from b, and both b and bk have contiguous rows, so
+    // take the z fourier modes of the whole y-slice in one batched call
+
+    // b is the input
+    // bk is the output
+    rfft_many(b[0], ncz, ncx, &bk(0, 0));
+
+  } else {
+    BOUT_OMP(parallel for)
+    for (int ix = 0; ix < ncx; ix++) {
+      /* This for loop will set the bk (initialized by the constructor)
+       * bk is the z fourier modes of b in z
+       * If the INVERT_SET flag is set (meaning that x0 will be used to set the
+       * bounadry values),
+       */
+      if (((ix < inbndry) && (inner_boundary_flags & INVERT_SET)) ||
+          ((ncx - 1 - ix < outbndry) && (outer_boundary_flags & INVERT_SET))) {
+        // Use the values in x0 in the boundary
+
+        // x0 is the input
+        // bk is the output
+        rfft(x0[ix], ncz, &bk(ix, 0));
+
+      } else {
+        // b is the input
+        // bk is the output
+        rfft(b[ix], ncz, &bk(ix, 0));
+      }
     }
   }
 
+  if (mode_threshold > 0.0) {
+    // Adaptive mode truncation: flag modes whose RHS amplitude is
+    // negligible, so the tridiagonal solves below can be skipped
+    Array<BoutReal> amplitude(maxmode + 1);
+    for (int kz = 0; kz <= maxmode; kz++) {
+      BoutReal amax = 0.0;
+      for (int ix = mesh->xstart; ix <= mesh->xend; ix++) {
+        BoutReal a = std::abs(bk(ix, kz));
+        if (a > amax)
+          amax = a;
+      }
+      amplitude[kz] = amax;
+    }
+    selectModes(amplitude);
+  }
+
   /* Solve differential equation in x for each fourier mode
    * Note that only the non-degenerate fourier modes are being used (i.e. the
    * offset and all the modes up to the Nyquist frequency)
    */
+  if (!mesh->periodicX) {
+    // All modes are solved in one batched Thomas sweep, which vectorises
+    // across modes (see tridagBatch). Gather the RHS into split
+    // real/imaginary layout; the matrix bands are already cached in that
+    // layout alongside the interleaved ones
+    if (rhs_soa.empty()) {
+      rhs_soa = ComplexBatch(ncx, maxmode + 1);
+      x_soa = ComplexBatch(ncx, maxmode + 1);
+    }
+
+    for (int kz = 0; kz <= maxmode; kz++) {
+      // set bk1d
+      for (int ix = 0; ix < ncx; ix++) {
+        // Get bk of the current fourier mode
+        bk1d[ix] = bk(ix, kz);
+      }
+
+      // Apply the RHS part of the boundary conditions (the matrix part is
+      // already in the cached coefficients)
+      zeroBoundaryRHS(std::begin(bk1d));
+
+      for (int ix = 0; ix < ncx; ix++) {
+        rhs_soa.set(ix, kz, bk1d[ix]);
+      }
+    }
+
+    ///////// PERFORM INVERSION /////////
+    tridagBatch(coefs.avecs, coefs.bvecs, coefs.cvecs, rhs_soa, x_soa);
+
+    for (int kz = 0; kz <= maxmode; kz++) {
+      if (skipMode(kz)) {
+        // RHS amplitude is below mode_threshold: write zeros for this
+        // mode. (The batched solve computes it anyway; skipping a lane
+        // would not save any work)
+        for (int ix = 0; ix < ncx; ix++) {
+          xk(ix, kz) = 0.0;
+        }
+        continue;
+      }
+
+      // Store the solution xk for the current fourier mode in a 2D array
+      for (int ix = 0; ix < ncx; ix++) {
+        xk(ix, kz) = x_soa.get(ix, kz);
+      }
+    }
+
+    // If the global flag is set to INVERT_KX_ZERO
+    if ((global_flags & INVERT_KX_ZERO) && !skipMode(0)) {
+      dcomplex offset(0.0);
+      for (int ix = mesh->xstart; ix <= mesh->xend; ix++) {
+        offset += xk(ix, 0);
+      }
+      offset /= static_cast<BoutReal>(mesh->xend - mesh->xstart + 1);
+      for (int ix = mesh->xstart; ix <= mesh->xend; ix++) {
+        xk(ix, 0) -= offset;
+      }
+    }
+
+  } else {
   for (int kz = 0; kz <= maxmode; kz++) {
 
+    if (skipMode(kz)) {
+      // RHS amplitude is below mode_threshold: write zeros for this mode
+      for (int ix = 0; ix < ncx; ix++) {
+        xk(ix, kz) = 0.0;
+      }
+      continue;
+    }
+
     // set bk1d
     for (int ix = 0; ix < ncx; ix++) {
       // Get bk of the current fourier mode
       bk1d[ix] = bk(ix, kz);
     }
 
-    /* Set the matrix A used in the inversion of Ax=b
-     * by calling tridagCoef and setting the BC
-     *
-     * Note that A, C and D in
-     *
-     * D*Laplace_perp(x) + (1/C)Grad_perp(C)*Grad_perp(x) + Ax = B
-     *
-     * has nothing to do with
-     * avec - the lower diagonal of the tridiagonal matrix
-     * bvec - the main diagonal
-     * cvec - the upper diagonal
-    */
-    tridagMatrix(std::begin(avec), std::begin(bvec), std::begin(cvec), std::begin(bk1d),
-                 jy,
-                 // wave number index
-                 kz,
-                 // wave number (different from kz only if we are taking a part
-                 // of the z-domain [and not from 0 to 2*pi])
-                 kz * kwaveFactor, global_flags, inner_boundary_flags,
-                 outer_boundary_flags, &A, &C, &D);
+    // Apply the RHS part of the boundary conditions (the matrix part is
+    // already in the cached coefficients)
+    zeroBoundaryRHS(std::begin(bk1d));
 
     ///////// PERFORM INVERSION /////////
-    if (!mesh->periodicX) {
-      // Call tridiagonal solver
-      tridag(std::begin(avec), std::begin(bvec), std::begin(cvec), std::begin(bk1d),
-             std::begin(xk1d), ncx);
-
-    } else {
-      // Periodic in X, so cyclic tridiagonal
+    // Periodic in X, so cyclic tridiagonal
+    // cyclic_tridag modifies the matrix bands, so copy them out of the cache
+    for (int ix = 0; ix < ncx; ix++) {
+      avec[ix] = coefs.avec(kz, ix);
+      bvec[ix] = coefs.bvec(kz, ix);
+      cvec[ix] = coefs.cvec(kz, ix);
+    }
 
-      int xs = mesh->xstart;
-      cyclic_tridag(&avec[xs], &bvec[xs], &cvec[xs], &bk1d[xs], &xk1d[xs], ncx - 2 * xs);
+    int xs = mesh->xstart;
+    cyclic_tridag(&avec[xs], &bvec[xs], &cvec[xs], &bk1d[xs], &xk1d[xs], ncx - 2 * xs);
 
-      // Copy boundary regions
-      for (int ix = 0; ix < xs; ix++) {
-        xk1d[ix] = xk1d[ncx - 2 * xs + ix];
-        xk1d[ncx - xs + ix] = xk1d[xs + ix];
-      }
+    // Copy boundary regions
+    for (int ix = 0; ix < xs; ix++) {
+      xk1d[ix] = xk1d[ncx - 2 * xs + ix];
+      xk1d[ncx - xs + ix] = xk1d[xs + ix];
     }
 
     // If the global flag is set to INVERT_KX_ZERO
@@ -220,21 +304,25 @@ const FieldPerp LaplaceSerialTri::solve(const FieldPerp &b, const FieldPerp &x0)
       xk(ix, kz) = xk1d[ix];
     }
   }
+  }
 
   // Done inversion, transform back
-  for (int ix = 0; ix < ncx; ix++) {
-
-    if(global_flags & INVERT_ZERO_DC)
+  if(global_flags & INVERT_ZERO_DC) {
+    for (int ix = 0; ix < ncx; ix++)
       xk(ix, 0) = 0.0;
+  }
 
-    irfft(&xk(ix, 0), ncz, x[ix]);
+  // Rows of xk and x are both contiguous, so back transform the whole
+  // y-slice in one batched call
+  irfft_many(&xk(0, 0), ncz, ncx, x[0]);
 
 #if CHECK > 2
+  for (int ix = 0; ix < ncx; ix++) {
     for(int kz=0;kz<ncz;kz++)
       if(!finite(x(ix,kz)))
         throw BoutException("Non-finite at %d, %d, %d", ix, jy, kz);
-#endif
   }
+#endif
 
   return x; // Result of the inversion
 }
@@ -41,17 +41,17 @@ public:
   using Laplacian::setCoefA;
   void setCoefA(const Field2D &val) override {
     ASSERT1(val.getLocation() == location);
-    A = val;
+    updateCoefCache(A, val);
   }
   using Laplacian::setCoefC;
   void setCoefC(const Field2D &val) override {
     ASSERT1(val.getLocation() == location);
-    C = val;
+    updateCoefCache(C, val);
   }
   using Laplacian::setCoefD;
   void setCoefD(const Field2D &val) override {
     ASSERT1(val.getLocation() == location);
-    D = val;
+    updateCoefCache(D, val);
   }
   using Laplacian::setCoefEx;
   void setCoefEx(const Field2D &UNUSED(val)) override {
@@ -69,6 +69,13 @@ private:
   // The coefficents in
   // D*grad_perp^2(x) + (1/C)*(grad_perp(C))*grad_perp(x) + A*x = b
   Field2D A, C, D;
+
+  /// Workspaces allocated on first solve and reused, so the
+  /// steady-state cost of a solve is just the FFTs and sweeps
+  Matrix<dcomplex> bk, xk; ///< Fourier modes of b and x, indexed (ix, kz)
+  Array<dcomplex> bk1d, xk1d; ///< Single mode of bk / xk
+  Array<dcomplex> avec, bvec, cvec; ///< Scratch matrix bands for the periodicX solver
+  ComplexBatch rhs_soa, x_soa; ///< RHS and solution in split layout for tridagBatch
 };
 
 #endif // __SERIAL_TRI_H__
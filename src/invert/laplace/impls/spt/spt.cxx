@@ -121,51 +121,159 @@ const Field3D LaplaceSPT::solve(const Field3D &b) {
 
   ASSERT1(b.getLocation() == location);
 
+  if(async_in_flight)
+    throw BoutException("LaplaceSPT::solve() called while an asynchronous solve is in flight");
+
+  startAll(b);
+  return finishAll(b);
+}
+
+void LaplaceSPT::startAll(const Field3D &b) {
   Timer timer("invert");
-  Mesh *mesh = b.getMesh();
-  Field3D x(mesh);
-  x.allocate();
-  
+
   for(int jy=ys; jy <= ye; jy++) {
     // And start another one going
     start(sliceXZ(b, jy), alldata[jy]);
-    
+
     // Move each calculation along one processor
-    for(int jy2=ys; jy2 < jy; jy2++) 
+    for(int jy2=ys; jy2 < jy; jy2++)
       next(alldata[jy2]);
   }
-  
-  bool running = true;
-  do {
-    // Move each calculation along until the last one is finished
-    for(int jy=ys; jy <= ye; jy++)
-      running = next(alldata[jy]) == 0;
-  }while(running);
+}
+
+bool LaplaceSPT::progressAll() {
+  Timer timer("invert");
+
+  // Move each calculation along one processor
+  bool running = false;
+  for(int jy=ys; jy <= ye; jy++)
+    running = next(alldata[jy]) == 0;
+  return !running;
+}
+
+const Field3D LaplaceSPT::finishAll(const Field3D &b) {
+  Timer timer("invert");
+  Mesh *mesh = b.getMesh();
+
+  // Move each calculation along until the last one is finished
+  while(!progressAll()) {
+  }
+
+  Field3D x(mesh);
+  x.allocate();
 
   FieldPerp xperp(mesh);
   xperp.allocate();
-  
+
   // All calculations finished. Get result
   for(int jy=ys; jy <= ye; jy++) {
     finish(alldata[jy], xperp);
     x = xperp;
   }
-  
+
   x.setLocation(b.getLocation());
-  
+
+  async_in_flight = false;
+
   return x;
 }
 
-const Field3D LaplaceSPT::solve(const Field3D &b, const Field3D &x0) {
+/// Starts every y-slice moving through the pipeline as solve() does,
+/// then returns without draining it: the caller gets the communication
+/// time back to do other work in, polling Future::progress() to keep
+/// the slices moving until Future::get() collects the result
+Laplacian::Future LaplaceSPT::solveAsync(const Field3D &b) {
+  ASSERT1(b.getLocation() == location);
+
+  if(async_in_flight)
+    throw BoutException("LaplaceSPT::solveAsync() called while another solve is in flight");
+  async_in_flight = true;
+
+  startAll(b);
+  return Future(std::unique_ptr<Future::State>(new AsyncState(this, b)));
+}
+
+Laplacian::Future LaplaceSPT::solveAsync(const Field3D &b, const Field3D &x0) {
+  return solveAsync(boundaryRHS(b, x0));
+}
+
+/// Inverts a batch of 3D fields in a single pipeline
+/*!
+ * All slices of all fields share one pipeline, so the forward sweep of
+ * the second field fills the bubble left by the first field's backward
+ * sweep rather than letting the pipeline drain between fields. All the
+ * right-hand sides share the current coefficients.
+ */
+const std::vector<Field3D> LaplaceSPT::solve(const std::vector<Field3D> &b) {
+  if(b.empty())
+    return {};
+
+  Timer timer("invert");
+
+  const int ny = ye - ys + 1;
+  const int nslice = static_cast<int>(b.size()) * ny;
+
+  if(static_cast<int>(batchdata.size()) < nslice) {
+    batchdata.resize(nslice);
+    for(int i=0; i<nslice; i++)
+      batchdata[i].comm_tag = SPT_DATA + i; // Give each one a different tag
+  }
+
+  int nstarted = 0;
+  for(const auto &rhs : b) {
+    ASSERT1(rhs.getLocation() == location);
+
+    for(int jy=ys; jy <= ye; jy++) {
+      // And start another one going
+      start(sliceXZ(rhs, jy), batchdata[nstarted++]);
+
+      // Move each calculation along one processor
+      for(int i=0; i < nstarted-1; i++)
+        next(batchdata[i]);
+    }
+  }
+
+  bool running = true;
+  do {
+    // Move each calculation along until the last one is finished
+    for(int i=0; i < nstarted; i++)
+      running = next(batchdata[i]) == 0;
+  }while(running);
+
+  FieldPerp xperp(b[0].getMesh());
+  xperp.allocate();
+
+  // All calculations finished. Get results
+  std::vector<Field3D> x;
+  x.reserve(b.size());
+
+  int islice = 0;
+  for(const auto &rhs : b) {
+    Field3D xi(rhs.getMesh());
+    xi.allocate();
+
+    for(int jy=ys; jy <= ye; jy++) {
+      finish(batchdata[islice++], xperp);
+      xi = xperp;
+    }
+
+    xi.setLocation(rhs.getLocation());
+    x.push_back(xi);
+  }
+
+  return x;
+}
+
+const Field3D LaplaceSPT::boundaryRHS(const Field3D &b, const Field3D &x0) {
   if(  ((inner_boundary_flags & INVERT_SET) && mesh->firstX()) ||
        ((outer_boundary_flags & INVERT_SET) && mesh->lastX()) ) {
     Field3D bs = copy(b);
-    
+
     int xbndry = mesh->xstart;
     // If the flags to assign that only one guard cell should be used is set
     if((global_flags & INVERT_BOTH_BNDRY_ONE) || (mesh->xstart < 2))
       xbndry = 1;
-    
+
     if((inner_boundary_flags & INVERT_SET) && mesh->firstX()) {
       // Copy x0 inner boundary into bs
       for(int ix=0;ix<xbndry;ix++)
@@ -180,10 +288,14 @@ const Field3D LaplaceSPT::solve(const Field3D &b, const Field3D &x0) {
           for(int iz=0;iz<mesh->LocalNz;iz++)
             bs(ix,iy,iz) = x0(ix,iy,iz);
     }
-    return solve(bs);
+    return bs;
   }
-  
-  return solve(b);
+
+  return b;
+}
+
+const Field3D LaplaceSPT::solve(const Field3D &b, const Field3D &x0) {
+  return solve(boundaryRHS(b, x0));
 }
 
 /// This is the first half of the Thomas algorithm for parallel calculations
@@ -203,7 +315,7 @@ const Field3D LaplaceSPT::solve(const Field3D &b, const Field3D &x0) {
  * @param[inout] um
  * @param[in] start
  */
-void LaplaceSPT::tridagForward(dcomplex *a, dcomplex *b, dcomplex *c,
+void LaplaceSPT::tridagForward(const dcomplex *a, const dcomplex *b, const dcomplex *c,
                                 dcomplex *r, dcomplex *u, int n,
                                 dcomplex *gam,
                                 dcomplex &bet, dcomplex &um, bool start) {
@@ -288,24 +400,25 @@ int LaplaceSPT::start(const FieldPerp &b, SPT_data &data) {
       data.bk(kz, ix) = dc1d[kz];
   }
 
-  BoutReal kwaveFactor = 2.0 * PI / mesh->getCoordinates(location)->zlength();
+  /// Set matrix elements, rebuilt only when a coefficient has changed
+  data.coefs = &cachedTridagMatrix(data.jy, &Acoef, &Ccoef, &Dcoef);
 
-  /// Set matrix elements
+  // Apply the RHS part of the boundary conditions (the matrix part is
+  // already in the cached coefficients)
   for (int kz = 0; kz <= maxmode; kz++) {
-    tridagMatrix(&data.avec(kz, 0), &data.bvec(kz, 0), &data.cvec(kz, 0), &data.bk(kz, 0),
-                 data.jy, kz, kz * kwaveFactor, global_flags, inner_boundary_flags,
-                 outer_boundary_flags, &Acoef, &Ccoef, &Dcoef);
+    zeroBoundaryRHS(&data.bk(kz, 0));
   }
 
   data.proc = 0; //< Starts at processor 0
   data.dir = 1;
-  
+
   if(mesh->firstX()) {
     BOUT_OMP(parallel for)
     for(int kz = 0; kz <= maxmode; kz++) {
       dcomplex bet, u0;
       // Start tridiagonal solve
-      tridagForward(&data.avec(kz, 0), &data.bvec(kz, 0), &data.cvec(kz, 0),
+      tridagForward(&data.coefs->avec(kz, 0), &data.coefs->bvec(kz, 0),
+                    &data.coefs->cvec(kz, 0),
                     &data.bk(kz, 0), &data.xk(kz, 0), mesh->xend + 1, &data.gam(kz, 0),
                     bet, u0, true);
       // Load intermediate values into buffers
@@ -356,8 +469,9 @@ int LaplaceSPT::next(SPT_data &data) {
         dcomplex gp, up;
 	bet = dcomplex(data.buffer[4*kz], data.buffer[4*kz + 1]);
 	u0 = dcomplex(data.buffer[4*kz + 2], data.buffer[4*kz + 3]);
-        tridagForward(&data.avec(kz, mesh->xstart), &data.bvec(kz, mesh->xstart),
-                      &data.cvec(kz, mesh->xstart), &data.bk(kz, mesh->xstart),
+        tridagForward(&data.coefs->avec(kz, mesh->xstart),
+                      &data.coefs->bvec(kz, mesh->xstart),
+                      &data.coefs->cvec(kz, mesh->xstart), &data.bk(kz, mesh->xstart),
                       &data.xk(kz, mesh->xstart), mesh->xend + 1,
                       &data.gam(kz, mesh->xstart), bet, u0);
 
@@ -380,8 +494,9 @@ int LaplaceSPT::next(SPT_data &data) {
 	dcomplex bet, u0;
 	bet = dcomplex(data.buffer[4*kz], data.buffer[4*kz + 1]);
 	u0 = dcomplex(data.buffer[4*kz + 2], data.buffer[4*kz + 3]);
-        tridagForward(&data.avec(kz, mesh->xstart), &data.bvec(kz, mesh->xstart),
-                      &data.cvec(kz, mesh->xstart), &data.bk(kz, mesh->xstart),
+        tridagForward(&data.coefs->avec(kz, mesh->xstart),
+                      &data.coefs->bvec(kz, mesh->xstart),
+                      &data.coefs->cvec(kz, mesh->xstart), &data.bk(kz, mesh->xstart),
                       &data.xk(kz, mesh->xstart), mesh->xend - mesh->xstart + 1,
                       &data.gam(kz, mesh->xstart), bet, u0);
         // Load intermediate values into buffers
@@ -499,16 +614,14 @@ void LaplaceSPT::finish(SPT_data &data, FieldPerp &x) {
 // SPT_data helper class
 
 void LaplaceSPT::SPT_data::allocate(int mm, int nx) {
+  if (!bk.empty())
+    return; // Already allocated
+
   bk = Matrix<dcomplex>(mm, nx);
   xk = Matrix<dcomplex>(mm, nx);
 
   gam = Matrix<dcomplex>(mm, nx);
 
-  // Matrix to be solved
-  avec = Matrix<dcomplex>(mm, nx);
-  bvec = Matrix<dcomplex>(mm, nx);
-  cvec = Matrix<dcomplex>(mm, nx);
-
   buffer = Array<BoutReal>(4 * mm);
 }
 
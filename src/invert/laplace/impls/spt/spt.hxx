@@ -72,17 +72,17 @@ public:
   using Laplacian::setCoefA;
   void setCoefA(const Field2D &val) override {
     ASSERT1(val.getLocation() == location);
-    Acoef = val;
+    updateCoefCache(Acoef, val);
   }
   using Laplacian::setCoefC;
   void setCoefC(const Field2D &val) override {
     ASSERT1(val.getLocation() == location);
-    Ccoef = val;
+    updateCoefCache(Ccoef, val);
   }
   using Laplacian::setCoefD;
   void setCoefD(const Field2D &val) override {
     ASSERT1(val.getLocation() == location);
-    Dcoef = val;
+    updateCoefCache(Dcoef, val);
   }
   using Laplacian::setCoefEx;
   void setCoefEx(const Field2D &UNUSED(val)) override {
@@ -99,6 +99,16 @@ public:
   
   const Field3D solve(const Field3D &b) override;
   const Field3D solve(const Field3D &b, const Field3D &x0) override;
+
+  const std::vector<Field3D> solve(const std::vector<Field3D> &b) override;
+
+  /// Start the pipelined inversion of \p b and return a Future for the
+  /// result, overlapping the X-direction communication with whatever
+  /// the caller does before Future::get(). Call Future::progress()
+  /// occasionally to keep the slices moving. Only one asynchronous
+  /// solve may be in flight at a time
+  Future solveAsync(const Field3D &b) override;
+  Future solveAsync(const Field3D &b, const Field3D &x0) override;
 private:
   enum { SPT_DATA = 1123 }; ///< 'magic' number for SPT MPI messages
   
@@ -116,8 +126,11 @@ private:
     Matrix<dcomplex> xk;
 
     Matrix<dcomplex> gam;
-  
-    Matrix<dcomplex> avec, bvec, cvec; ///< Diagonal bands of matrix
+
+    /// Diagonal bands of the matrix, cached (and owned) by the
+    /// Laplacian base class. The forward and back sweeps only read
+    /// them, so no per-solve copy is needed
+    const TridagCoefTable *coefs = nullptr;
 
     int proc; // Which processor has this reached?
     int dir;  // Which direction is it going?
@@ -133,9 +146,11 @@ private:
   SPT_data slicedata; // Used to solve for a single FieldPerp
   SPT_data* alldata;  // Used to solve a Field3D
 
+  std::vector<SPT_data> batchdata; ///< Used to solve several Field3Ds in one pipeline
+
   Array<dcomplex> dc1d; ///< 1D in Z for taking FFTs
 
-  void tridagForward(dcomplex *a, dcomplex *b, dcomplex *c,
+  void tridagForward(const dcomplex *a, const dcomplex *b, const dcomplex *c,
                       dcomplex *r, dcomplex *u, int n,
                       dcomplex *gam,
                       dcomplex &bet, dcomplex &um, bool start=false);
@@ -143,11 +158,43 @@ private:
                    dcomplex *gam, dcomplex &gp, dcomplex &up);
   
   int start(const FieldPerp &b, SPT_data &data);
-  
+
   int next(SPT_data &data);
-  
+
   void finish(SPT_data &data, FieldPerp &x);
 
+  /// Start the pipelined inversion of every y-slice of \p b into
+  /// alldata, the first half of solve(const Field3D&)
+  void startAll(const Field3D &b);
+
+  /// Make one non-blocking pass over the slices in alldata, returning
+  /// true once the last one has finished
+  bool progressAll();
+
+  /// Drain the pipeline started by startAll() and collect the result.
+  /// \p b supplies the mesh and location of the result field
+  const Field3D finishAll(const Field3D &b);
+
+  /// Copy the boundary values of \p x0 into a copy of \p b where the
+  /// INVERT_SET flags require it, as the RHS actually inverted by the
+  /// solve(b, x0) variants
+  const Field3D boundaryRHS(const Field3D &b, const Field3D &x0);
+
+  /// State behind solveAsync(): the solver whose alldata pipeline is in
+  /// flight, and the RHS keeping its mesh alive for the result
+  class AsyncState : public Future::State {
+  public:
+    AsyncState(LaplaceSPT *solver, const Field3D &b) : solver(solver), b(b) {}
+    void progress() override { solver->progressAll(); }
+    const Field3D wait() override { return solver->finishAll(b); }
+
+  private:
+    LaplaceSPT *solver;
+    const Field3D b;
+  };
+
+  /// True while an asynchronous solve is using alldata
+  bool async_in_flight{false};
 };
 
 #endif // __SPT_H__
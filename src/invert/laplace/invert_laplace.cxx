@@ -51,7 +51,8 @@
  **********************************************************************************/
 
 /// Laplacian inversion initialisation. Called once at the start to get settings
-Laplacian::Laplacian(Options *options, const CELL_LOC loc) : location(loc) {
+Laplacian::Laplacian(Options *options, const CELL_LOC loc)
+    : coef_generation(1), location(loc) {
 
   if (options == nullptr) {
     // Use the default options
@@ -77,6 +78,10 @@ Laplacian::Laplacian(Options *options, const CELL_LOC loc) : location(loc) {
   if(maxmode < 0) maxmode = 0;
   if(maxmode > ncz/2) maxmode = ncz/2;
 
+  // Adaptive mode truncation: relative RHS amplitude below which a kz
+  // mode is skipped (zeros written). 0 solves every mode
+  OPTION(options, mode_threshold, 0.0);
+
   OPTION(options, low_mem, false);
 
   OPTION(options, nonuniform,
@@ -127,6 +132,68 @@ void Laplacian::cleanup() {
   instance = nullptr;
 }
 
+/**********************************************************************************
+ *                         Coefficient change detection
+ **********************************************************************************/
+
+bool Laplacian::updateCoefCache(Field2D &cache, const Field2D &val) {
+  ASSERT1(val.isAllocated());
+
+  if (cache.isAllocated()) {
+    if (&cache(0, 0) == &val(0, 0)) {
+      return false; // Still sharing data with the cached copy: unchanged
+    }
+    Mesh *mesh = val.getMesh();
+    if (cache.getMesh() == mesh) {
+      int n = mesh->LocalNx * mesh->LocalNy;
+      const BoutReal *c = &cache(0, 0);
+      const BoutReal *v = &val(0, 0);
+      int i;
+      for (i = 0; i < n; i++) {
+        if (c[i] != v[i])
+          break;
+      }
+      if (i == n) {
+        cache = val; // Share data, so the next check is a pointer compare
+        return false;
+      }
+    }
+  }
+
+  cache = val;
+  coef_generation++;
+  return true;
+}
+
+bool Laplacian::updateCoefCache(Field3D &cache, const Field3D &val) {
+  ASSERT1(val.isAllocated());
+
+  if (cache.isAllocated()) {
+    if (&cache(0, 0, 0) == &val(0, 0, 0)) {
+      return false; // Still sharing data with the cached copy: unchanged
+    }
+    Mesh *mesh = val.getMesh();
+    if (cache.getMesh() == mesh) {
+      int n = mesh->LocalNx * mesh->LocalNy * mesh->LocalNz;
+      const BoutReal *c = &cache(0, 0, 0);
+      const BoutReal *v = &val(0, 0, 0);
+      int i;
+      for (i = 0; i < n; i++) {
+        if (c[i] != v[i])
+          break;
+      }
+      if (i == n) {
+        cache = val; // Share data, so the next check is a pointer compare
+        return false;
+      }
+    }
+  }
+
+  cache = val;
+  coef_generation++;
+  return true;
+}
+
 /**********************************************************************************
  *                                 Solve routines
  **********************************************************************************/
@@ -159,10 +226,11 @@ const Field3D Laplacian::solve(const Field3D &b) {
 
   int status = 0;
   try {
+    FieldPerp b_slice(mesh); // Slab buffer, reused for every plane
     for(int jy=ys; jy <= ye; jy++) {
       // 1. Slice b (i.e. take a X-Z plane out of the field)
       // 2. Send it to the solver of the implementation (determined during creation)
-      x = solve(sliceXZ(b,jy));
+      x = solve(sliceXZ(b, jy, b_slice));
     }
   } catch (BoutIterationFail &itfail) {
     status = 1;
@@ -184,6 +252,22 @@ const Field2D Laplacian::solve(const Field2D &b) {
   return DC(f);
 }
 
+/*!
+ * Invert a batch of right-hand sides sharing the same coefficients.
+ * This fallback just loops over the fields; solvers which can batch the
+ * work (e.g. LaplaceCyclic) override it
+ */
+const std::vector<Field3D> Laplacian::solve(const std::vector<Field3D> &b) {
+  TRACE("Laplacian::solve(vector<Field3D>)");
+
+  std::vector<Field3D> x;
+  x.reserve(b.size());
+  for (const auto &rhs : b) {
+    x.push_back(solve(rhs));
+  }
+  return x;
+}
+
 /*!
  * Performs the laplacian inversion y-slice by y-slice
  *
@@ -214,10 +298,11 @@ const Field3D Laplacian::solve(const Field3D &b, const Field3D &x0) {
 
   int status = 0;
   try {
+    FieldPerp b_slice(mesh), x0_slice(mesh); // Slab buffers, reused for every plane
     for(int jy=ys; jy <= ye; jy++) {
       // 1. Slice b and x (i.e. take a X-Z plane out of the field)
       // 2. Send them to the solver of the implementation (determined during creation)
-      x = solve(sliceXZ(b,jy), sliceXZ(x0,jy));
+      x = solve(sliceXZ(b, jy, b_slice), sliceXZ(x0, jy, x0_slice));
     }
   } catch (BoutIterationFail &itfail) {
     status = 1;
@@ -235,6 +320,22 @@ const Field2D Laplacian::solve(const Field2D &b, const Field2D &x0) {
   return DC(f);
 }
 
+Laplacian::Future::State::~State() {}
+
+/*!
+ * Fallback for solvers without split-phase communication: solve
+ * immediately and hand back a completed Future, so callers can be
+ * written against the asynchronous interface regardless of which
+ * implementation is selected at run time
+ */
+Laplacian::Future Laplacian::solveAsync(const Field3D &b) {
+  return Future(solve(b));
+}
+
+Laplacian::Future Laplacian::solveAsync(const Field3D &b, const Field3D &x0) {
+  return Future(solve(b, x0));
+}
+
 /**********************************************************************************
  *                              MATRIX ELEMENTS
  **********************************************************************************/
@@ -737,6 +838,118 @@ void Laplacian::tridagMatrix(dcomplex *avec, dcomplex *bvec, dcomplex *cvec,
   }
 }
 
+const Laplacian::TridagCoefTable &Laplacian::cachedTridagMatrix(int jy, const Field2D *a,
+                                                                const Field2D *ccoef,
+                                                                const Field2D *d) {
+  if (coef_table.empty())
+    coef_table.resize(mesh->LocalNy);
+
+  ASSERT1((jy >= 0) && (jy < mesh->LocalNy));
+  TridagCoefTable &table = coef_table[jy];
+
+  if (table.valid && (table.generation == coef_generation))
+    return table; // Coefficients haven't changed since the table was built
+
+  if (table.avec.empty()) {
+    table.avec = Matrix<dcomplex>(maxmode + 1, mesh->LocalNx);
+    table.bvec = Matrix<dcomplex>(maxmode + 1, mesh->LocalNx);
+    table.cvec = Matrix<dcomplex>(maxmode + 1, mesh->LocalNx);
+  }
+
+  Coordinates *coord = mesh->getCoordinates(location);
+
+  BOUT_OMP(parallel for)
+  for(int kz = 0; kz <= maxmode; kz++) {
+    BoutReal kwave=kz*2.0*PI/coord->zlength(); // wave number is 1/[rad]
+
+    // The RHS changes (bk zeroing) are applied separately by
+    // zeroBoundaryRHS, so pass a scratch RHS here
+    Array<dcomplex> bk_scratch(mesh->LocalNx);
+
+    tridagMatrix(&table.avec(kz, 0), &table.bvec(kz, 0), &table.cvec(kz, 0),
+                 std::begin(bk_scratch),
+                 jy,
+                 kz, kwave,
+                 global_flags, inner_boundary_flags, outer_boundary_flags,
+                 a, ccoef, d);
+  }
+
+  if (table.avecs.empty()) {
+    table.avecs = ComplexBatch(mesh->LocalNx, maxmode + 1);
+    table.bvecs = ComplexBatch(mesh->LocalNx, maxmode + 1);
+    table.cvecs = ComplexBatch(mesh->LocalNx, maxmode + 1);
+  }
+
+  // Pack the bands into split real/imaginary layout for the batched
+  // tridiagonal solver. Done once per rebuild, so in steady state the
+  // solves only convert the RHS
+  for (int kz = 0; kz <= maxmode; kz++) {
+    for (int ix = 0; ix < mesh->LocalNx; ix++) {
+      table.avecs.set(ix, kz, table.avec(kz, ix));
+      table.bvecs.set(ix, kz, table.bvec(kz, ix));
+      table.cvecs.set(ix, kz, table.cvec(kz, ix));
+    }
+  }
+
+  table.generation = coef_generation;
+  table.valid = true;
+
+  return table;
+}
+
+void Laplacian::zeroBoundaryRHS(dcomplex *bk) {
+  if(mesh->periodicX)
+    return; // No boundaries in X
+
+  // Setting the width of the boundary.
+  // NOTE: The default is a width of (mesh->xstart) guard cells
+  int inbndry = mesh->xstart, outbndry=mesh->xstart;
+
+  if((global_flags & INVERT_BOTH_BNDRY_ONE) || (mesh->xstart < 2))  {
+    inbndry = outbndry = 1;
+  }
+  if(inner_boundary_flags & INVERT_BNDRY_ONE)
+    inbndry = 1;
+  if(outer_boundary_flags & INVERT_BNDRY_ONE)
+    outbndry = 1;
+
+  if(mesh->firstX() && !(inner_boundary_flags & (INVERT_RHS | INVERT_SET))) {
+    for(int ix=0;ix<inbndry;ix++)
+      bk[ix] = 0.;
+  }
+  if(mesh->lastX() && !(outer_boundary_flags & (INVERT_RHS | INVERT_SET))) {
+    for(int ix=0;ix<outbndry;ix++)
+      bk[mesh->LocalNx-1-ix] = 0.;
+  }
+}
+
+void Laplacian::selectModes(const Array<BoutReal> &amplitude) {
+  ASSERT1(amplitude.size() >= maxmode + 1);
+
+  if (static_cast<int>(mode_skip.size()) < maxmode + 1)
+    mode_skip.resize(maxmode + 1);
+
+  // Threshold is relative to the largest mode amplitude, so the
+  // truncation adapts to the overall size of the RHS
+  BoutReal peak = 0.0;
+  for (int kz = 0; kz <= maxmode; kz++) {
+    if (amplitude[kz] > peak)
+      peak = amplitude[kz];
+  }
+  BoutReal cutoff = mode_threshold * peak;
+
+  modes_total = maxmode + 1;
+  modes_skipped = 0;
+  for (int kz = 0; kz <= maxmode; kz++) {
+    // Always solve the DC mode: it carries the boundary conditions
+    // even when the RHS is zero
+    bool skip = (kz != 0) && (amplitude[kz] < cutoff);
+    mode_skip[kz] = skip;
+    if (skip)
+      modes_skipped++;
+  }
+}
+
 /**********************************************************************************
  *                              LEGACY INTERFACE
  *
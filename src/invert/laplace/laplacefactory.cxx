@@ -15,6 +15,7 @@
 #include "impls/shoot/shoot_laplace.hxx"
 #include "impls/multigrid/multigrid_laplace.hxx"
 #include "impls/naulin/naulin_laplace.hxx"
+#include "impls/auto/auto_laplace.hxx"
 
 #define LAPLACE_SPT  "spt"
 #define LAPLACE_PDD  "pdd"
@@ -26,6 +27,7 @@
 #define LAPLACE_SHOOT "shoot"
 #define LAPLACE_MULTIGRID "multigrid"
 #define LAPLACE_NAULIN "naulin"
+#define LAPLACE_AUTO "auto"
 
 LaplaceFactory *LaplaceFactory::instance = nullptr;
 
@@ -66,6 +68,8 @@ Laplacian* LaplaceFactory::createLaplacian(Options *options, const CELL_LOC loc)
       return new LaplaceMultigrid(options, loc);
     }else if(strcasecmp(type.c_str(), LAPLACE_NAULIN) == 0) {
       return new LaplaceNaulin(options, loc);
+    }else if(strcasecmp(type.c_str(), LAPLACE_AUTO) == 0) {
+      return new LaplaceAuto(options, loc);
     }else {
       throw BoutException("Unknown serial Laplacian solver type '%s'", type.c_str());
     }
@@ -90,6 +94,8 @@ Laplacian* LaplaceFactory::createLaplacian(Options *options, const CELL_LOC loc)
       return new LaplaceMultigrid(options, loc);
   }else if(strcasecmp(type.c_str(), LAPLACE_NAULIN) == 0) {
     return new LaplaceNaulin(options, loc);
+  }else if(strcasecmp(type.c_str(), LAPLACE_AUTO) == 0) {
+    return new LaplaceAuto(options, loc);
   }else {
     throw BoutException("Unknown parallel Laplacian solver type '%s'", type.c_str());
   }
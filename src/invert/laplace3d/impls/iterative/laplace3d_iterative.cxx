@@ -0,0 +1,186 @@
+/*!
+ * \file laplace3d_iterative.cxx
+ *
+ * \brief Native iterative 3D perpendicular Laplacian solver
+ *
+ * The equation
+ *
+ *   A*x + B*Delp2(x) + Div( C*Delp(x) ) = rhs
+ *
+ * is rearranged by expanding the divergence term,
+ *
+ *   Div( C*Delp(x) ) = C*Delp2(x) + Delp(C).Delp(x)
+ *
+ * so that the total Delp2 coefficient is Dfac = B + C. Dividing
+ * through by Dfac and splitting A/Dfac into its axisymmetric (DC)
+ * and non-axisymmetric (AC) parts gives
+ *
+ *   Delp2(x) + DC(A/Dfac)*x
+ *      = rhs/Dfac - Delp(C).Delp(x)/Dfac - (A/Dfac - DC(A/Dfac))*x
+ *
+ * The left-hand side is exactly invertible by a standard FFT-based
+ * Laplacian solver; the right-hand side is evaluated with x from the
+ * previous iteration and the fixed point is iterated until the
+ * residual is below tolerance. This is the same scheme as the 2D
+ * LaplaceNaulin solver, here applied through the Laplace3D interface
+ * with full 3D coefficients. All the field operations are the
+ * standard OpenMP-threaded ones.
+ *
+ **************************************************************************
+ * Copyright 2018 B.D.Dudson
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+#include <bout/coordinates.hxx>
+#include <bout/mesh.hxx>
+#include <bout/sys/timer.hxx>
+#include <boutexception.hxx>
+#include <derivs.hxx>
+#include <globals.hxx>
+#include <msg_stack.hxx>
+#include <options.hxx>
+
+#include "laplace3d_iterative.hxx"
+
+Laplace3DIterative::Laplace3DIterative(Options *opt)
+    : Laplace3D(opt), Acoef(0.0), Bcoef(0.0), Ccoef(1.0), delp2solver(nullptr) {
+
+  if (opt == nullptr) {
+    opt = Options::getRoot()->getSection("laplace3d");
+  }
+
+  OPTION(opt, rtol, 1.e-7);
+  OPTION(opt, atol, 1.e-20);
+  OPTION(opt, maxits, 100);
+
+  delp2solver = Laplacian::create(opt->getSection("delp2solver"));
+  std::string delp2type;
+  opt->getSection("delp2solver")->get("type", delp2type, "cyclic");
+  // The inner solver must invert Delp2 exactly for the fixed point to
+  // converge, so it has to be one of the FFT-based schemes
+  ASSERT0(delp2type == "cyclic" || delp2type == "spt" || delp2type == "tri");
+}
+
+Laplace3DIterative::~Laplace3DIterative() {
+  delete delp2solver;
+}
+
+void Laplace3DIterative::updateCoefs() {
+  TRACE("Laplace3DIterative::updateCoefs");
+
+  // Total Delp2 coefficient after expanding Div( C*Delp(x) )
+  Field3D Dfac = Bcoef + Ccoef;
+  oneOverDfac = 1. / Dfac;
+
+  ddx_c = DDX(Ccoef, CELL_DEFAULT, DIFF_C2);
+  ddz_c = DDZ(Ccoef, CELL_DEFAULT, DIFF_FFT);
+
+  // Split A/Dfac into DC and AC parts, so that the DC part can be
+  // kept in the inner inversion. This allows all-Neumann boundary
+  // conditions as long as DC(A/Dfac) is non-zero
+  Field3D AOverD = Acoef * oneOverDfac;
+  AOverD_DC = DC(AOverD);
+  AOverD_AC = AOverD - AOverD_DC;
+
+  delp2solver->setCoefA(AOverD_DC);
+
+  coefs_changed = false;
+}
+
+const Field3D Laplace3DIterative::solve(const Field3D &rhs, const Field3D &x0) {
+  TRACE("Laplace3DIterative::solve");
+
+  Timer timer("invert");
+
+  if (coefs_changed) {
+    updateCoefs();
+  }
+
+  Mesh *mesh = rhs.getMesh();
+  Coordinates *coords = rhs.getCoordinates();
+
+  Field3D x(x0); // Result
+
+  Field3D rhsOverD = rhs * oneOverDfac;
+
+  // Normalisation for the relative error estimate; sqrt(mean(SQ))
+  // so that we do not divide by zero at a point
+  BoutReal RMS_rhsOverD = sqrt(mean(SQ(rhsOverD), true, RGN_NOBNDRY));
+
+  BoutReal error_rel = 1e20, error_abs = 1e20;
+  int count = 0;
+
+  // Right-hand side evaluated with the current iterate
+  Field3D ddx_x = DDX(x, CELL_DEFAULT, DIFF_C2);
+  Field3D ddz_x = DDZ(x, CELL_DEFAULT, DIFF_FFT);
+  Field3D b = rhsOverD
+              - (coords->g11 * ddx_c * ddx_x + coords->g33 * ddz_c * ddz_x
+                 + coords->g13 * (ddx_c * ddz_x + ddz_c * ddx_x)) * oneOverDfac
+              - AOverD_AC * x;
+
+  while (error_rel > rtol && error_abs > atol) {
+
+    x = delp2solver->solve(b, x);
+    mesh->communicate(x);
+
+    // Re-evaluate the right-hand side with the new iterate. The
+    // difference from the previous one is the residual, since
+    // b(previous) = Delp2(x) + DC(A/Dfac)*x up to rounding
+    ddx_x = DDX(x, CELL_DEFAULT, DIFF_C2);
+    ddz_x = DDZ(x, CELL_DEFAULT, DIFF_FFT);
+    Field3D bnew = rhsOverD
+                   - (coords->g11 * ddx_c * ddx_x + coords->g33 * ddz_c * ddz_x
+                      + coords->g13 * (ddx_c * ddz_x + ddz_c * ddx_x)) * oneOverDfac
+                   - AOverD_AC * x;
+
+    Field3D error3D = b - bnew;
+    error_abs = max(abs(error3D, RGN_NOBNDRY), true, RGN_NOBNDRY);
+    error_rel = error_abs / RMS_rhsOverD;
+
+    b = bnew;
+
+    count++;
+    if (count > maxits) {
+      throw BoutException("Laplace3DIterative error: Took more than maxits=%i "
+                          "iterations to converge.", maxits);
+    }
+  }
+
+  last_its = count;
+
+  // Keep for warm-starting the next solve. Copy-on-write, so this
+  // just shares the data
+  last_solution = x;
+  have_last_solution = true;
+
+  return x;
+}
+
+const Field3D Laplace3DIterative::solve(const Field3D &rhs) {
+  if (have_last_solution) {
+    // Warm start from the previous solution; when called once per
+    // timestep this typically saves several iterations
+    return solve(rhs, last_solution);
+  }
+  Field3D x0(rhs.getMesh());
+  x0 = 0.;
+  x0.setLocation(rhs.getLocation());
+  return solve(rhs, x0);
+}
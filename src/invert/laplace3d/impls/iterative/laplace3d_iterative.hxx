@@ -0,0 +1,113 @@
+/**************************************************************************
+ * Native iterative 3D perpendicular Laplacian solver
+ *
+ * Solves
+ *
+ *   A*x + B*Delp2(x) + Div( C*Delp(x) ) = rhs
+ *
+ * with full Field3D coefficients, using the FFT-preconditioned
+ * fixed-point scheme of LaplaceNaulin: the axisymmetric part of the
+ * operator is inverted exactly by a standard (FFT-based) Laplacian
+ * solver, and the non-axisymmetric remainder is iterated on the
+ * right-hand side until the residual is below tolerance.
+ *
+ **************************************************************************
+ * Copyright 2018 B.D.Dudson
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+class Laplace3DIterative;
+
+#ifndef __ITERATIVE_LAPLACE3D_H__
+#define __ITERATIVE_LAPLACE3D_H__
+
+#include <bout/invert/laplace3d.hxx>
+#include <boutexception.hxx>
+#include <invert_laplace.hxx>
+#include <unused.hxx>
+
+class Laplace3DIterative : public Laplace3D {
+public:
+  Laplace3DIterative(Options *opt = nullptr);
+  ~Laplace3DIterative();
+
+  // The full 3D coefficients are kept; the Field2D setters are just
+  // the axisymmetric special case. Changing a coefficient invalidates
+  // the cached derived fields, which are rebuilt on the next solve
+  void setCoefA(const Field2D &f) override { Acoef = f; coefs_changed = true; }
+  void setCoefB(const Field2D &f) override { Bcoef = f; coefs_changed = true; }
+  void setCoefC(const Field2D &f) override { Ccoef = f; coefs_changed = true; }
+
+  void setCoefA(const Field3D &f) override { Acoef = f; coefs_changed = true; }
+  void setCoefB(const Field3D &f) override { Bcoef = f; coefs_changed = true; }
+  void setCoefC(const Field3D &f) override { Ccoef = f; coefs_changed = true; }
+
+  // The D * Del^2(x) term (full 3D Laplacian) is not included in this
+  // scheme; use the petsc implementation if it is needed
+  void setCoefD(const Field2D &UNUSED(f)) override {
+    throw BoutException("Laplace3DIterative does not support the D * Del2(x) term");
+  }
+  void setCoefD(const Field3D &UNUSED(f)) override {
+    throw BoutException("Laplace3DIterative does not support the D * Del2(x) term");
+  }
+
+  // Pass flags through to the inner solver, which applies the
+  // boundary conditions
+  void setFlags(int f) override {
+    Laplace3D::setFlags(f);
+    delp2solver->setFlags(f);
+  }
+
+  using Laplace3D::solve;
+  const Field3D solve(const Field3D &rhs) override;
+  const Field3D solve(const Field3D &rhs, const Field3D &x0) override;
+
+  /// Number of iterations taken by the most recent solve
+  int getIterations() const { return last_its; }
+
+private:
+  Laplace3DIterative(const Laplace3DIterative &);
+  Laplace3DIterative &operator=(const Laplace3DIterative &);
+
+  Field3D Acoef, Bcoef, Ccoef; ///< Operator coefficients
+
+  Laplacian *delp2solver; ///< FFT-based solver for the axisymmetric part
+
+  BoutReal rtol, atol; ///< Relative and absolute tolerances on the residual
+  int maxits;          ///< Maximum number of iterations before throwing
+
+  /// Derived fields cached between solves; recomputed only when a
+  /// coefficient is changed
+  bool coefs_changed{true};
+  Field3D oneOverDfac;  ///< 1 / (B + C), the inverse Delp2 coefficient
+  Field3D ddx_c, ddz_c; ///< Perpendicular derivatives of C
+  Field2D AOverD_DC;    ///< Axisymmetric part of A/(B+C), kept in the inner solve
+  Field3D AOverD_AC;    ///< Non-axisymmetric remainder, iterated on the rhs
+  void updateCoefs();
+
+  /// Solution of the previous solve, used as the starting guess for
+  /// the next one
+  Field3D last_solution;
+  bool have_last_solution{false};
+
+  int last_its{0}; ///< Iterations taken by the most recent solve
+};
+
+#endif // __ITERATIVE_LAPLACE3D_H__
@@ -6,6 +6,7 @@
 #include "laplace3d_factory.hxx"
 
 // Include implementations here
+#include "impls/iterative/laplace3d_iterative.hxx"
 #include "impls/petsc/petsc_laplace3d.hxx"
 
 Laplace3DFactory* Laplace3DFactory::instance = 0;
@@ -23,9 +24,14 @@ Laplace3D* Laplace3DFactory::createLaplace3D(Options *options) {
     options = Options::getRoot()->getSection("laplace3d");
   
   string type;
-  options->get("type", type, "petsc");
+  // Default to the native iterative solver, which doesn't depend on
+  // external libraries
+  options->get("type", type, "iterative");
 
   // Add tests for available solvers here. See src/invert/laplace/laplacefactory.cxx
+  if(strcasecmp(type.c_str(), "iterative") == 0) {
+    return new Laplace3DIterative(options);
+  }
   if(strcasecmp(type.c_str(), "petsc") == 0) {
     return new Laplace3DPetsc(options);
   }
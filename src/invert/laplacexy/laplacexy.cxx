@@ -25,7 +25,8 @@ static PetscErrorCode laplacePCapply(PC pc,Vec x,Vec y) {
   PetscFunctionReturn(s->precon(x, y));
 }
 
-LaplaceXY::LaplaceXY(Mesh *m, Options *opt, const CELL_LOC loc) : mesh(m), location(loc) {
+LaplaceXY::LaplaceXY(Mesh *m, Options *opt, const CELL_LOC loc)
+    : mesh(m), location(loc), coefs_set(false), have_last_solution(false) {
   Timer timer("invert");
 
   if (opt == nullptr) {
@@ -189,8 +190,12 @@ LaplaceXY::LaplaceXY(Mesh *m, Options *opt, const CELL_LOC loc) : mesh(m), locat
   }
   // Pre-allocate
   MatMPIAIJSetPreallocation( MatA, 0, d_nnz, 0, o_nnz );
-  MatSetUp(MatA); 
-  
+  MatSetUp(MatA);
+
+  // Only locally owned rows are ever set in setCoefs, so assembly
+  // doesn't need to communicate entries between processors
+  MatSetOption(MatA, MAT_NO_OFF_PROC_ENTRIES, PETSC_TRUE);
+
   PetscFree( d_nnz );
   PetscFree( o_nnz );
   
@@ -251,6 +256,20 @@ LaplaceXY::LaplaceXY(Mesh *m, Options *opt, const CELL_LOC loc) : mesh(m), locat
     KSPGetPC(ksp,&pc);
     PCSetType(pc, pctype.c_str());
 
+    if(pctype == "hypre") {
+      // Algebraic multigrid through the hypre interface. BoomerAMG is
+      // the sensible choice for these elliptic problems. Note that
+      // pctype = gamg selects PETSc's native AMG without needing
+      // anything extra here
+#ifdef PETSC_HAVE_HYPRE
+      string hypretype;
+      opt->get("hypretype", hypretype, "boomeramg", true);
+      PCHYPRESetType(pc, hypretype.c_str());
+#else
+      throw BoutException("PETSc was built without hypre, so pctype = hypre is not available");
+#endif
+    }
+
     if(pctype == "shell") {
       // Using tridiagonal solver as preconditioner
       PCShellSetApply(pc,laplacePCapply);
@@ -267,6 +286,13 @@ LaplaceXY::LaplaceXY(Mesh *m, Options *opt, const CELL_LOC loc) : mesh(m), locat
   
   KSPSetFromOptions( ksp );
 
+  // How many coefficient updates may reuse the preconditioner setup.
+  // 0 (the default) rebuilds it on every setCoefs call; larger values
+  // keep the factorisation or multigrid hierarchy for several updates,
+  // trading some extra Krylov iterations for much cheaper setup
+  OPTION(opt, reuse_limit, 0);
+  reuse_count = reuse_limit + 1; // So re-calculates first time
+
   ///////////////////////////////////////////////////
   // Decide boundary condititions
   if(mesh->periodicY(mesh->xstart)) {
@@ -488,13 +514,38 @@ void LaplaceXY::setCoefs(const Field2D &A, const Field2D &B) {
   MatAssemblyBegin( MatA, MAT_FINAL_ASSEMBLY );
   MatAssemblyEnd( MatA, MAT_FINAL_ASSEMBLY );
 
-  // Set the operator
+  if (!coefs_set) {
+    // The full pattern is now in place and later calls only change
+    // values, so freeze it. This also lets PETSc retain the symbolic
+    // part of factorisations across coefficient updates
+    MatSetOption(MatA, MAT_NEW_NONZERO_LOCATIONS, PETSC_FALSE);
+  }
+
+  // Set the operator, deciding whether the preconditioner setup can
+  // be reused from the previous coefficients
+  reuse_count++;
+  if (reuse_count > reuse_limit) {
+    // Reuse limit exceeded: rebuild the preconditioner. Reset count
+    reuse_count = 0;
 #if PETSC_VERSION_GE(3,5,0)
-  KSPSetOperators( ksp,MatA,MatA );
+    KSPSetReusePreconditioner(ksp, PETSC_FALSE);
+    KSPSetOperators( ksp,MatA,MatA );
 #else
-  KSPSetOperators( ksp,MatA,MatA,DIFFERENT_NONZERO_PATTERN );
+    KSPSetOperators( ksp,MatA,MatA,
+                     coefs_set ? SAME_NONZERO_PATTERN : DIFFERENT_NONZERO_PATTERN );
 #endif
-  
+  }else {
+    // Reuse the preconditioner, even though the operator has changed
+#if PETSC_VERSION_GE(3,5,0)
+    KSPSetReusePreconditioner(ksp, PETSC_TRUE);
+    KSPSetOperators( ksp,MatA,MatA );
+#else
+    KSPSetOperators( ksp,MatA,MatA,SAME_PRECONDITIONER );
+#endif
+  }
+
+  coefs_set = true;
+
   // Set coefficients for preconditioner
   cr->setCoefs(acoef, bcoef, ccoef);
 }
@@ -685,10 +736,23 @@ const Field2D LaplaceXY::solve(const Field2D &rhs, const Field2D &x0) {
     for(int y=mesh->yend+1;y<mesh->LocalNy;y++)
       result(it.ind, y) = val;
   }
-  
+
+  // Keep for warm-starting the next solve. Copy-on-write, so this
+  // just shares the data
+  last_solution = result;
+  have_last_solution = true;
+
   return result;
 }
 
+const Field2D LaplaceXY::solve(const Field2D &rhs) {
+  if(!have_last_solution) {
+    // Nothing to warm-start from yet
+    return solve(rhs, Field2D(0.0, mesh));
+  }
+  return solve(rhs, last_solution);
+}
+
 /*! Preconditioner
  * NOTE: For efficiency, this routine does not use globalIndex() 
  * in the inner loop. Instead, the indexing must be ordered in
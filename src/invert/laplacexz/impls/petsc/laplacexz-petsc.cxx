@@ -214,6 +214,10 @@ LaplaceXZpetsc::LaplaceXZpetsc(Mesh *m, Options *opt, const CELL_LOC loc)
     PetscFree( d_nnz );
     PetscFree( o_nnz );
 
+    // Only locally owned rows are ever set, so assembly never needs
+    // to communicate entries between processors
+    MatSetOption(data.MatA, MAT_NO_OFF_PROC_ENTRIES, PETSC_TRUE);
+
     //////////////////////////////////////////////////
     // Declare KSP Context
     KSPCreate( comm, &data.ksp );
@@ -239,6 +243,9 @@ LaplaceXZpetsc::LaplaceXZpetsc(Mesh *m, Options *opt, const CELL_LOC loc)
     slice.push_back(data);
   }
 
+  // Column map for the interior stencil rows, filled in by the first
+  // setCoefs call (see setCoefs)
+  stencil_cols.resize(5 * (mesh->xend - mesh->xstart + 1) * (mesh->LocalNz));
 }
 
 LaplaceXZpetsc::~LaplaceXZpetsc() {
@@ -304,7 +311,13 @@ void LaplaceXZpetsc::setCoefs(const Field3D &Ain, const Field3D &Bin) {
     // Inner X boundary (see note about BC in LaplaceXZ constructor)
     int row = Istart;
     if(mesh->firstX()) {
-      if (inner_boundary_flags & INVERT_AC_GRAD){
+      if (coefs_set) {
+        // The boundary rows don't depend on the coefficients, and the
+        // nonzero pattern is frozen: the values inserted on the first
+        // call still stand, so skip straight to the interior rows
+        row += mesh->LocalNz;
+      }
+      else if (inner_boundary_flags & INVERT_AC_GRAD){
         // Neumann 0
         /* NOTE: Sign of the elements are opposite of what one might expect,
          *       see note about BC in LaplaceXZ constructor for more details
@@ -427,30 +440,27 @@ void LaplaceXZpetsc::setCoefs(const Field3D &Ain, const Field3D &Bin) {
         /////////////////////////////////////////////////
         // Now have a 5-point stencil for the Laplacian
 
-        // Set the centre (diagonal)
-        MatSetValues(it.MatA, 1, &row, 1, &row, &c, INSERT_VALUES);
-
-        // X + 1
-        int col = row + (mesh->LocalNz);
-        MatSetValues(it.MatA, 1, &row, 1, &col, &xp, INSERT_VALUES);
-
-        // X - 1
-        col = row - (mesh->LocalNz);
-        MatSetValues(it.MatA, 1, &row, 1, &col, &xm, INSERT_VALUES);
-
-        // Z + 1
-        col = row + 1;
-        if(z == mesh->LocalNz-1) {
-          col -= mesh->LocalNz;  // Wrap around
+        // All five entries of the row go in with a single call, using
+        // the column map. The map is filled here on the first call;
+        // every matrix has the same layout, so the map built for one
+        // slice is valid for all of them
+        PetscInt *cols = &stencil_cols[5 * ((x - mesh->xstart) * (mesh->LocalNz) + z)];
+        if (!coefs_set) {
+          cols[0] = row;                    // Centre (diagonal)
+          cols[1] = row + (mesh->LocalNz);  // X + 1
+          cols[2] = row - (mesh->LocalNz);  // X - 1
+          cols[3] = row + 1;                // Z + 1
+          if(z == mesh->LocalNz-1) {
+            cols[3] -= mesh->LocalNz;  // Wrap around
+          }
+          cols[4] = row - 1;                // Z - 1
+          if(z == 0) {
+            cols[4] += mesh->LocalNz;  // Wrap around
+          }
         }
-        MatSetValues(it.MatA, 1, &row, 1, &col, &zp, INSERT_VALUES);
 
-        // Z - 1
-        col = row - 1;
-        if(z == 0) {
-          col += mesh->LocalNz;  // Wrap around
-        }
-        MatSetValues(it.MatA, 1, &row, 1, &col, &zm, INSERT_VALUES);
+        PetscScalar vals[5] = {c, xp, xm, zp, zm};
+        MatSetValues(it.MatA, 1, &row, 5, cols, vals, INSERT_VALUES);
 
         row++;
       }
@@ -459,7 +469,11 @@ void LaplaceXZpetsc::setCoefs(const Field3D &Ain, const Field3D &Bin) {
     ////////////////////////////////////////////////
     // Outer X boundary (see note about BC in LaplaceXZ constructor)
     if(mesh->lastX()) {
-      if (outer_boundary_flags & INVERT_AC_GRAD){
+      if (coefs_set) {
+        // As at the inner boundary, nothing to update
+        row += mesh->LocalNz;
+      }
+      else if (outer_boundary_flags & INVERT_AC_GRAD){
         // Neumann 0
         for(int z=0; z < mesh->LocalNz; z++) {
           PetscScalar val = 1.0;
@@ -518,6 +532,12 @@ void LaplaceXZpetsc::setCoefs(const Field3D &Ain, const Field3D &Bin) {
     // Assemble Matrix
     MatAssemblyBegin(it.MatA, MAT_FINAL_ASSEMBLY);
     MatAssemblyEnd(it.MatA, MAT_FINAL_ASSEMBLY);
+
+    if (!coefs_set) {
+      // The full pattern is now in place, and later calls only
+      // change values, so let PETSc take its fast insertion path
+      MatSetOption(it.MatA, MAT_NEW_NONZERO_LOCATIONS, PETSC_FALSE);
+    }
   }
 
   // Increase reuse count
@@ -541,6 +561,9 @@ void LaplaceXZpetsc::setCoefs(const Field3D &Ain, const Field3D &Bin) {
 
       // Note: This is a hack to force update of the preconditioner matrix
 #if PETSC_VERSION_GE(3,5,0)
+      // Clear any reuse request from previous calls, so the new
+      // preconditioner matrix really is refactorised
+      KSPSetReusePreconditioner(it.ksp, PETSC_FALSE);
       KSPSetOperators(it.ksp, it.MatA, it.MatP);
 #else
       KSPSetOperators(it.ksp, it.MatA, it.MatP, SAME_NONZERO_PATTERN);
@@ -34,6 +34,8 @@ private:
 
 #include <bout/petsclib.hxx>
 
+#include <vector>
+
 class LaplaceXZpetsc : public LaplaceXZ {
 public:
   /*!
@@ -81,7 +83,14 @@ private:
   int reuse_count; ///< How many times has it been reused?
 
   bool coefs_set; ///< Have coefficients been set?
-  
+
+  /// Column indices of the 5-point stencil, 5 per interior row.
+  /// The nonzero pattern is fixed, so this is computed on the first
+  /// setCoefs call and reused for every value update afterwards.
+  /// The same map serves every Y slice, since all the matrices have
+  /// identical layouts
+  std::vector<PetscInt> stencil_cols;
+
   #if CHECK > 0
     // Currently implemented flags
     static const int implemented_boundary_flags =   INVERT_AC_GRAD
@@ -1,14 +1,14 @@
 /************************************************************************
  * Inversion of parallel derivatives
- * 
- * Inverts a matrix of the form 
+ *
+ * Inverts a matrix of the form
  *
  * A + B * Grad2_par2 + C*D2DYDZ + + D*D2DZ2 + E*DDY
- * 
+ *
  * Parallel algorithm, using Cyclic Reduction
  *
  * Author: Ben Dudson, University of York, Oct 2011
- * 
+ *
  * Known issues:
  * ------------
  *
@@ -17,7 +17,7 @@
  * Copyright 2010 B.D.Dudson, S.Farley, M.V.Umansky, X.Q.Xu
  *
  * Contact: Ben Dudson, bd512@york.ac.uk
- * 
+ *
  * This file is part of BOUT++.
  *
  * BOUT++ is free software: you can redistribute it and/or modify
@@ -40,7 +40,6 @@
 #include "cyclic.hxx"
 #include <fft.hxx>
 #include <boutexception.hxx>
-#include <cyclic_reduction.hxx>
 #include <msg_stack.hxx>
 #include <bout/constants.hxx>
 
@@ -50,168 +49,224 @@
 
 InvertParCR::InvertParCR(Options *opt) : InvertPar(opt), A(1.0), B(0.0), C(0.0), D(0.0), E(0.0) {
   // Number of k equations to solve for each x location
-  nsys = 1 + (mesh->LocalNz)/2; 
+  nsys = 1 + (mesh->LocalNz)/2;
 
-  rhs = Matrix<dcomplex>(mesh->LocalNy, nsys);
-  
-  // Find out if we are on a boundary
-  int size = mesh->LocalNy-4;
+  // Sort the surfaces this processor owns into groups which can solve
+  // together: same communicator, same number of rows and the same
+  // boundary layout. The batched solve then needs one communication
+  // round per group rather than one per surface. The topology is fixed
+  // after startup, so this is done once
+  int max_size = mesh->LocalNy - 4;
   SurfaceIter surf(mesh);
   for(surf.first(); !surf.isDone(); surf.next()) {
-    BoutReal ts;
-    int n = mesh->LocalNy-4;
-    if(!surf.closed(ts)) {
-      // Open field line
-      if(surf.firstY())
-        n += 2;
-      if(surf.lastY())
-        n += 2;
-      
-      if(n > size)
-        size = n; // Maximum size
-    }
-  }
-  
-  rhsk = Matrix<dcomplex>(nsys, size);
-  xk = Matrix<dcomplex>(nsys, size);
-  a = Matrix<dcomplex>(nsys, size);
-  b = Matrix<dcomplex>(nsys, size);
-  c = Matrix<dcomplex>(nsys, size);
-}
-
-InvertParCR::~InvertParCR() {
-}
-
-const Field3D InvertParCR::solve(const Field3D &f) {
-  TRACE("InvertParCR::solve(Field3D)");
-  Mesh *mesh = f.getMesh();
-  Field3D result(mesh);
-  result.allocate();
-  result.setLocation(f.getLocation());
-  
-  Coordinates *coord = f.getCoordinates();
-  
-  // Create cyclic reduction object
-  CyclicReduce<dcomplex> *cr = 
-    new CyclicReduce<dcomplex>();
-  
-  // Loop over flux-surfaces
-  SurfaceIter surf(mesh);
-  for(surf.first(); !surf.isDone(); surf.next()) {
-    int x = surf.xpos;
-    
-    // Test if open or closed field-lines
-    BoutReal ts;
+    BoutReal ts = 0.;
     bool closed = surf.closed(ts);
 
-    // Number of rows
-    int y0 = 0, size = mesh->LocalNy-4; // If no boundaries
+    int y0 = 0, size = mesh->LocalNy - 4;
+    bool firstY = false, lastY = false;
     if(!closed) {
-      if(surf.firstY()) {
+      // Open field line, so may have boundaries
+      firstY = surf.firstY();
+      lastY = surf.lastY();
+      if(firstY) {
         y0 += 2;
         size += 2;
       }
-      if(surf.lastY())
+      if(lastY)
         size += 2;
+
+      if(size > max_size)
+        max_size = size;
+    }
+
+    // Find a group this surface can join
+    SurfaceGroup *sg = nullptr;
+    for(auto &group : groups) {
+      if((group.comm == surf.communicator()) && (group.size == size) &&
+         (group.closed == closed) && (group.firstY == firstY) &&
+         (group.lastY == lastY)) {
+        sg = &group;
+        break;
+      }
     }
-      
-    // Setup CyclicReduce object
-    cr->setup(surf.communicator(), size);
-    cr->setPeriodic(closed);
-    
-    // Take Fourier transform 
-    for(int y=0;y<mesh->LocalNy-4;y++)
-      rfft(f(x, y + 2), mesh->LocalNz, &rhs(y + y0, 0));
+    if(sg == nullptr) {
+      groups.push_back(SurfaceGroup());
+      sg = &groups.back();
+      sg->comm = surf.communicator();
+      sg->size = size;
+      sg->closed = closed;
+      sg->firstY = firstY;
+      sg->lastY = lastY;
+      sg->y0 = y0;
+    }
+    sg->xpos.push_back(surf.xpos);
+    sg->ts.push_back(ts);
+  }
+
+  // Allocate the persistent solver and workspaces for each group
+  for(auto &sg : groups) {
+    const int nbatch = static_cast<int>(sg.xpos.size()) * nsys;
+
+    sg.cr.reset(new CyclicReduce<dcomplex>());
+    sg.cr->setup(sg.comm, sg.size);
+    sg.cr->setPeriodic(sg.closed);
+
+    sg.a = Matrix<dcomplex>(nbatch, sg.size);
+    sg.b = Matrix<dcomplex>(nbatch, sg.size);
+    sg.c = Matrix<dcomplex>(nbatch, sg.size);
+    sg.rhsk = Matrix<dcomplex>(nbatch, sg.size);
+    sg.xk = Matrix<dcomplex>(nbatch, sg.size);
+  }
+
+  rhs = Matrix<dcomplex>(mesh->LocalNy, nsys);
+}
+
+InvertParCR::~InvertParCR() {
+}
+
+void InvertParCR::buildCoefs(SurfaceGroup &sg, Coordinates *coord) {
+  TRACE("InvertParCR::buildCoefs");
+
+  const int nsurf = static_cast<int>(sg.xpos.size());
+
+  for(int s = 0; s < nsurf; s++) {
+    const int x = sg.xpos[s];
+    const int row0 = s * nsys; // First system of this surface
 
     // Set up tridiagonal system
     for(int k=0; k<nsys; k++) {
       BoutReal kwave=k*2.0*PI/coord->zlength(); // wave number is 1/[rad]
       for(int y=0;y<mesh->LocalNy-4;y++) {
-        
+
 	BoutReal acoef = A(x, y+2);                     // Constant
 	BoutReal bcoef = B(x, y+2) / coord->g_22(x,y+2); // d2dy2
         BoutReal ccoef = C(x, y+2);                     // d2dydz
         BoutReal dcoef = D(x, y+2);                     // d2dz2
         BoutReal ecoef = E(x, y+2);                     // ddy
-	
+
         bcoef /= SQ(coord->dy(x, y+2));
         ccoef /= coord->dy(x,y+2)*coord->dz;
         dcoef /= SQ(coord->dz);
         ecoef /= coord->dy(x,y+2);
-        
-        //           const       d2dy2        d2dydz              d2dz2           ddy
-        //           -----       -----        ------              -----           ---
-        a(k, y + y0) =           bcoef - 0.5 * Im * kwave * ccoef          - 0.5 * ecoef;
-        b(k, y + y0) = acoef - 2. * bcoef           - SQ(kwave) * dcoef;
-        c(k, y + y0) =           bcoef + 0.5 * Im * kwave * ccoef          + 0.5 * ecoef;
-
-        rhsk(k, y + y0) = rhs(y + y0, k); // Transpose
+
+        //                  const       d2dy2        d2dydz              d2dz2           ddy
+        //                  -----       -----        ------              -----           ---
+        sg.a(row0 + k, y + sg.y0) =           bcoef - 0.5 * Im * kwave * ccoef          - 0.5 * ecoef;
+        sg.b(row0 + k, y + sg.y0) = acoef - 2. * bcoef           - SQ(kwave) * dcoef;
+        sg.c(row0 + k, y + sg.y0) =           bcoef + 0.5 * Im * kwave * ccoef          + 0.5 * ecoef;
       }
     }
 
-    if(closed) {
+    if(sg.closed) {
       // Twist-shift
       int rank, np;
-      MPI_Comm_rank(surf.communicator(), &rank);
-      MPI_Comm_size(surf.communicator(), &np);
+      MPI_Comm_rank(sg.comm, &rank);
+      MPI_Comm_size(sg.comm, &np);
       if(rank == 0) {
         for(int k=0; k<nsys; k++) {
           BoutReal kwave=k*2.0*PI/coord->zlength(); // wave number is 1/[rad]
-          dcomplex phase(cos(kwave*ts) , -sin(kwave*ts));
-          a(k, 0) *= phase;
+          dcomplex phase(cos(kwave*sg.ts[s]) , -sin(kwave*sg.ts[s]));
+          sg.a(row0 + k, 0) *= phase;
         }
       }
       if(rank == np-1) {
         for(int k=0; k<nsys; k++) {
           BoutReal kwave=k*2.0*PI/coord->zlength(); // wave number is 1/[rad]
-          dcomplex phase(cos(kwave*ts) , sin(kwave*ts));
-          c(k, mesh->LocalNy - 5) *= phase;
+          dcomplex phase(cos(kwave*sg.ts[s]) , sin(kwave*sg.ts[s]));
+          sg.c(row0 + k, sg.size - 1) *= phase;
         }
       }
     }else {
       // Open surface, so may have boundaries
-      if(surf.firstY()) {
+      if(sg.firstY) {
         for(int k=0; k<nsys; k++) {
           for(int y=0;y<2;y++) {
-            a(k, y) = 0.;
-            b(k, y) = 1.;
-            c(k, y) = -1.;
-
-            rhsk(k, y) = 0.;
+            sg.a(row0 + k, y) = 0.;
+            sg.b(row0 + k, y) = 1.;
+            sg.c(row0 + k, y) = -1.;
           }
         }
       }
-      if(surf.lastY()) {
+      if(sg.lastY) {
         for(int k=0; k<nsys; k++) {
-          for(int y=size-2;y<size;y++) {
-            a(k, y) = -1.;
-            b(k, y) = 1.;
-            c(k, y) = 0.;
-
-            rhsk(k, y) = 0.;
+          for(int y=sg.size-2;y<sg.size;y++) {
+            sg.a(row0 + k, y) = -1.;
+            sg.b(row0 + k, y) = 1.;
+            sg.c(row0 + k, y) = 0.;
           }
         }
       }
     }
-    
-    // Solve cyclic tridiagonal system for each k
-    cr->setCoefs(a, b, c);
-    cr->solve(rhsk, xk);
-
-    // Put back into rhs array
-    for(int k=0;k<nsys;k++) {
-      for(int y=0;y<size;y++)
-        rhs(y, k) = xk(k, y);
+  }
+}
+
+const Field3D InvertParCR::solve(const Field3D &f) {
+  TRACE("InvertParCR::solve(Field3D)");
+  ASSERT1(f.getMesh() == mesh);
+
+  Field3D result(mesh);
+  result.allocate();
+  result.setLocation(f.getLocation());
+
+  Coordinates *coord = f.getCoordinates();
+
+  // Loop over the surface groups, solving all surfaces of a group in
+  // one batched cyclic reduction
+  for(auto &sg : groups) {
+    const int nsurf = static_cast<int>(sg.xpos.size());
+
+    if(coefs_changed) {
+      // Rebuild and redistribute the coefficients. Skipped entirely
+      // when the coefficients haven't changed since the last solve,
+      // which is the common case for inversions called every RHS
+      buildCoefs(sg, coord);
+      sg.cr->setCoefs(sg.a, sg.b, sg.c);
+    }
+
+    // Take Fourier transforms, filling the batched RHS
+    for(int s = 0; s < nsurf; s++) {
+      const int x = sg.xpos[s];
+      const int row0 = s * nsys;
+
+      for(int y=0;y<mesh->LocalNy-4;y++)
+        rfft(f(x, y + 2), mesh->LocalNz, &rhs(y + sg.y0, 0));
+
+      for(int k=0; k<nsys; k++) {
+        for(int y=0;y<mesh->LocalNy-4;y++)
+          sg.rhsk(row0 + k, y + sg.y0) = rhs(y + sg.y0, k); // Transpose
+
+        // Boundary conditions
+        if(sg.firstY) {
+          for(int y=0;y<2;y++)
+            sg.rhsk(row0 + k, y) = 0.;
+        }
+        if(sg.lastY) {
+          for(int y=sg.size-2;y<sg.size;y++)
+            sg.rhsk(row0 + k, y) = 0.;
+        }
+      }
+    }
+
+    // Solve the batch of cyclic tridiagonal systems: one gather /
+    // scatter over sg.comm for the whole group
+    sg.cr->solve(sg.rhsk, sg.xk);
+
+    // Inverse Fourier transforms
+    for(int s = 0; s < nsurf; s++) {
+      const int x = sg.xpos[s];
+      const int row0 = s * nsys;
+
+      for(int k=0;k<nsys;k++) {
+        for(int y=0;y<sg.size;y++)
+          rhs(y, k) = sg.xk(row0 + k, y);
+      }
+
+      for(int y=0;y<sg.size;y++)
+        irfft(&rhs(y, 0), mesh->LocalNz, result(x, y + 2 - sg.y0));
     }
-    
-    // Inverse Fourier transform 
-    for(int y=0;y<size;y++)
-      irfft(&rhs(y, 0), mesh->LocalNz, result(x, y + 2 - y0));
   }
-  
-  // Delete cyclic reduction object
-  delete cr;
+
+  coefs_changed = false;
 
   return result;
 }
-
@@ -1,24 +1,24 @@
 /************************************************************************
  * Inversion of parallel derivatives
- * 
- * Inverts a matrix of the form 
+ *
+ * Inverts a matrix of the form
  *
  * A + B * Grad2_par2
- * 
+ *
  * Parallel algorithm, using Cyclic Reduction
  *
  * Author: Ben Dudson, University of York, Oct 2011
- * 
+ *
  * Known issues:
  * ------------
  *
- * 
+ *
  *
  **************************************************************************
  * Copyright 2010 B.D.Dudson, S.Farley, M.V.Umansky, X.Q.Xu
  *
  * Contact: Ben Dudson, bd512@york.ac.uk
- * 
+ *
  * This file is part of BOUT++.
  *
  * BOUT++ is free software: you can redistribute it and/or modify
@@ -42,6 +42,12 @@
 #include "invert_parderiv.hxx"
 #include "dcomplex.hxx"
 #include "utils.hxx"
+#include <cyclic_reduction.hxx>
+
+#include "mpi.h"
+
+#include <memory>
+#include <vector>
 
 class InvertParCR : public InvertPar {
 public:
@@ -52,25 +58,52 @@ public:
   const Field3D solve(const Field3D &f) override;
 
   using InvertPar::setCoefA;
-  void setCoefA(const Field2D &f) override { A = f; }
+  void setCoefA(const Field2D &f) override { A = f; coefs_changed = true; }
   using InvertPar::setCoefB;
-  void setCoefB(const Field2D &f) override { B = f; }
+  void setCoefB(const Field2D &f) override { B = f; coefs_changed = true; }
   using InvertPar::setCoefC;
-  void setCoefC(const Field2D &f) override { C = f; }
+  void setCoefC(const Field2D &f) override { C = f; coefs_changed = true; }
   using InvertPar::setCoefD;
-  void setCoefD(const Field2D &f) override { D = f; }
+  void setCoefD(const Field2D &f) override { D = f; coefs_changed = true; }
   using InvertPar::setCoefE;
-  void setCoefE(const Field2D &f) override { E = f; }
+  void setCoefE(const Field2D &f) override { E = f; coefs_changed = true; }
 
 private:
   Field2D A, B, C, D, E;
-  
-  int nsys;
-  
-  Matrix<dcomplex>rhs;
-  Matrix<dcomplex>rhsk;
-  Matrix<dcomplex>xk;
-  Matrix<dcomplex> a, b, c; // Matrix coefficients
+
+  int nsys; ///< Number of z modes to solve for each surface
+
+  /// Surfaces sharing a communicator, row count and boundary layout.
+  /// Each group solves all its surfaces' modes as one batched cyclic
+  /// reduction, so it costs one communication round per call instead
+  /// of one per surface. The solver and coefficient matrices persist
+  /// between calls
+  struct SurfaceGroup {
+    MPI_Comm comm;      ///< Communicator of the y range these surfaces cover
+    int size;           ///< Number of rows per surface on this processor
+    bool closed;        ///< Closed (periodic) field lines?
+    bool firstY, lastY; ///< Has lower/upper y boundary (open surfaces)
+    int y0;             ///< Row offset of the first interior point
+
+    std::vector<int> xpos;    ///< X index of each surface in the group
+    std::vector<BoutReal> ts; ///< Twist-shift angle of each surface (closed only)
+
+    std::unique_ptr<CyclicReduce<dcomplex>> cr; ///< Persistent solver state
+
+    Matrix<dcomplex> a, b, c;  ///< Cached coefficients [nsurf*nsys, size]
+    Matrix<dcomplex> rhsk, xk; ///< Workspaces [nsurf*nsys, size]
+  };
+  std::vector<SurfaceGroup> groups;
+
+  /// Do the cached a, b, c matrices need rebuilding? Set by the
+  /// setCoef* methods; repeated solves with unchanged coefficients
+  /// skip the coefficient assembly and CyclicReduce::setCoefs
+  bool coefs_changed{true};
+
+  /// Rebuild \p sg's coefficient matrices from A...E
+  void buildCoefs(SurfaceGroup &sg, Coordinates *coord);
+
+  Matrix<dcomplex> rhs; ///< Per-surface FFT buffer [LocalNy, nsys]
 };
 
 
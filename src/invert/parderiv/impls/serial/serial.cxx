@@ -52,12 +52,13 @@
 #include <cmath>
 
 InvertParSerial::InvertParSerial(Options *opt) : InvertPar(opt), A(1.0), B(0.0), C(0.0), D(0.0), E(0.0) {
-  rhs = Matrix<dcomplex>(mesh->LocalNy, (mesh->LocalNz)/2 + 1);
-  rhsk = Array<dcomplex>(mesh->LocalNy-4);
-  xk = Array<dcomplex>(mesh->LocalNy-4);
-  a = Array<dcomplex>(mesh->LocalNy-4);
-  b = Array<dcomplex>(mesh->LocalNy-4);
-  c = Array<dcomplex>(mesh->LocalNy-4);
+  int nmode = (mesh->LocalNz)/2 + 1;
+  rhs = Matrix<dcomplex>(mesh->LocalNy, nmode);
+  rhsk = ComplexBatch(mesh->LocalNy-4, nmode);
+  xk = ComplexBatch(mesh->LocalNy-4, nmode);
+  a = ComplexBatch(mesh->LocalNy-4, nmode);
+  b = ComplexBatch(mesh->LocalNy-4, nmode);
+  c = ComplexBatch(mesh->LocalNy-4, nmode);
 }
 
 const Field3D InvertParSerial::solve(const Field3D &f) {
@@ -81,15 +82,16 @@ const Field3D InvertParSerial::solve(const Field3D &f) {
     for(int y=0;y<mesh->LocalNy-4;y++)
       rfft(f(x,y+2), mesh->LocalNz, &rhs(y, 0));
     
-    // Solve cyclic tridiagonal system for each k
+    // Set up the cyclic tridiagonal systems for all k, then solve
+    // them in one batched call so the solver vectorises across modes
     int nyq = (mesh->LocalNz)/2;
     for(int k=0;k<=nyq;k++) {
-      // Copy component of rhs into 1D array
+      // Copy component of rhs into batch member k
       for(int y=0;y<mesh->LocalNy-4;y++)
-        rhsk[y] = rhs(y, k);
-      
+        rhsk.set(y, k, rhs(y, k));
+
       BoutReal kwave=k*2.0*PI/coord->zlength(); // wave number is 1/[rad]
-      
+
       // Set up tridiagonal system
       for(int y=0;y<mesh->LocalNy-4;y++) {
         BoutReal acoef = A(x, y+2);                     // Constant
@@ -97,31 +99,32 @@ const Field3D InvertParSerial::solve(const Field3D &f) {
         BoutReal ccoef = C(x, y+2);                     // d2dydz
         BoutReal dcoef = D(x, y+2);                     // d2dz2
         BoutReal ecoef = E(x, y+2);                     // ddy
-	
+
         bcoef /= SQ(coord->dy(x, y+2));
         ccoef /= coord->dy(x,y+2)*coord->dz;
         dcoef /= SQ(coord->dz);
         ecoef /= coord->dy(x,y+2);
-        
-        //     const     d2dy2        d2dydz             d2dz2           ddy
-        //     -----     -----        ------             -----           ---
-	a[y] =            bcoef - 0.5*Im*kwave*ccoef                  -0.5*ecoef;
-	b[y] = acoef - 2.*bcoef                     - SQ(kwave)*dcoef;
-	c[y] =            bcoef + 0.5*Im*kwave*ccoef                  +0.5*ecoef;
+
+        //              const     d2dy2        d2dydz             d2dz2           ddy
+        //              -----     -----        ------             -----           ---
+	a.set(y, k,               bcoef - 0.5*Im*kwave*ccoef                  -0.5*ecoef);
+	b.set(y, k,   acoef - 2.*bcoef                     - SQ(kwave)*dcoef);
+	c.set(y, k,               bcoef + 0.5*Im*kwave*ccoef                  +0.5*ecoef);
       }
-      
+
       // Modify coefficients across twist-shift
       dcomplex phase(cos(kwave*ts) , -sin(kwave*ts));
-      a[0] *= phase;
-      c[mesh->LocalNy-5] /= phase;
-      
-      // Solve cyclic tridiagonal system
-      cyclic_tridag(std::begin(a), std::begin(b), std::begin(c), std::begin(rhsk), std::begin(xk), mesh->LocalNy-4);
-      
-      // Put back into rhs array
-      for(int y=0;y<mesh->LocalNy-4;y++)
-        rhs(y, k) = xk[y];
+      a.set(0, k, a.get(0, k) * phase);
+      c.set(mesh->LocalNy-5, k, c.get(mesh->LocalNy-5, k) / phase);
     }
+
+    // Solve the cyclic tridiagonal systems, all modes at once
+    cyclicTridagBatch(a, b, c, rhsk, xk);
+
+    // Put back into rhs array
+    for(int k=0;k<=nyq;k++)
+      for(int y=0;y<mesh->LocalNy-4;y++)
+        rhs(y, k) = xk.get(y, k);
     
     // Inverse Fourier transform 
     for(int y=0;y<mesh->LocalNy-4;y++)
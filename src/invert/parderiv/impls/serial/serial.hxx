@@ -68,9 +68,11 @@ private:
   Field2D A, B, C, D, E;
   
   Matrix<dcomplex> rhs;
-  Array<dcomplex> rhsk;
-  Array<dcomplex> xk;
-  Array<dcomplex> a, b, c; // Matrix coefficients
+  // All Z modes in split layout, solved in one batched call (see
+  // cyclicTridagBatch). Mode index fastest
+  ComplexBatch rhsk;
+  ComplexBatch xk;
+  ComplexBatch a, b, c; // Matrix coefficients
 };
 
 
@@ -3,6 +3,37 @@
 #include <boundary_region.hxx>
 #include <utils.hxx>
 
+const Region<Ind2D> &BoundaryRegion::getRegion() {
+  if (!pointRegionSet) {
+    // Collect the boundary points once using the iterator protocol and
+    // store them as a Region, so loops over the boundary can be
+    // parallelised and don't pay a virtual call per point
+    Region<Ind2D>::RegionIndices indices;
+    for (first(); !isDone(); next()) {
+      indices.push_back(Ind2D(x * localmesh->LocalNy + y, localmesh->LocalNy, 1));
+    }
+    pointRegion = Region<Ind2D>(indices);
+    pointRegionSet = true;
+  }
+  return pointRegion;
+}
+
+const Region<Ind2D> &BoundaryRegion::getRegion1d() {
+  if (!pointRegion1dSet) {
+    // Collect only the innermost boundary points, as visited by the
+    // first()/next1d() protocol. bx, by and width are uniform over the
+    // region, so this flat list is all a boundary condition needs to
+    // apply itself in a single sweep
+    Region<Ind2D>::RegionIndices indices;
+    for (first(); !isDone(); next1d()) {
+      indices.push_back(Ind2D(x * localmesh->LocalNy + y, localmesh->LocalNy, 1));
+    }
+    pointRegion1d = Region<Ind2D>(indices);
+    pointRegion1dSet = true;
+  }
+  return pointRegion1d;
+}
+
 BoundaryRegionXIn::BoundaryRegionXIn(std::string name, int ymin, int ymax, Mesh* passmesh)
   : BoundaryRegion(name, -1, 0, passmesh), ys(ymin), ye(ymax)
 {
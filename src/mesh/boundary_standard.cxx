@@ -7,6 +7,7 @@
 #include <output.hxx>
 #include <msg_stack.hxx>
 #include <bout/constants.hxx>
+#include <bout/stencil_view.hxx>
 #include <derivs.hxx>
 
 // #define BOUNDARY_CONDITIONS_UPGRADE_EXTRAPOLATE_FOR_2ND_ORDER
@@ -131,6 +132,11 @@ void BoundaryDirichlet::apply(Field2D &f,BoutReal t) {
   if(!fg)
     fg = f.getBndryGenerator(bndry->location);
 
+  valCache.setGenerator(fg);
+  if (fg) {
+    valCache.startPass(t);
+  }
+
   BoutReal val = 0.0;
   
 
@@ -151,7 +157,7 @@ void BoundaryDirichlet::apply(Field2D &f,BoutReal t) {
 	    BoutReal xnorm = 0.5*(   mesh->GlobalX(bndry->x)
 				     + mesh->GlobalX(bndry->x - bndry->bx) );
 	    BoutReal ynorm = mesh->GlobalY(bndry->y);
-	    val = fg->generate(xnorm,TWOPI*ynorm,0.0, t);
+	    val = valCache.generate(xnorm,TWOPI*ynorm,0.0, t);
 	  }
           
 	  f(bndry->x,bndry->y) = val;
@@ -172,7 +178,7 @@ void BoundaryDirichlet::apply(Field2D &f,BoutReal t) {
             BoutReal xnorm = 0.5*(   mesh->GlobalX(bndry->x)
                                      + mesh->GlobalX(bndry->x - bndry->bx) );
             BoutReal ynorm = mesh->GlobalY(bndry->y);
-            val = fg->generate(xnorm,TWOPI*ynorm,0.0, t);
+            val = valCache.generate(xnorm,TWOPI*ynorm,0.0, t);
           }
           
           f(bndry->x - bndry->bx,bndry->y) = val;
@@ -194,7 +200,7 @@ void BoundaryDirichlet::apply(Field2D &f,BoutReal t) {
             // y norm is located half way between first grid cell and guard cell. 
             BoutReal xnorm = 0.5*(   mesh->GlobalX(bndry->x) + mesh->GlobalX(bndry->x - 1) ); 
             BoutReal ynorm = 0.5*(   mesh->GlobalY(bndry->y) + mesh->GlobalY(bndry->y - bndry->by) ); 
-            val = fg->generate(xnorm,TWOPI*ynorm,0.0, t);
+            val = valCache.generate(xnorm,TWOPI*ynorm,0.0, t);
           }
           f(bndry->x,bndry->y) = 2*val - f(bndry->x-bndry->bx, bndry->y-bndry->by);
           
@@ -218,7 +224,7 @@ void BoundaryDirichlet::apply(Field2D &f,BoutReal t) {
             BoutReal xnorm = mesh->GlobalX(bndry->x);
             BoutReal ynorm = 0.5*( mesh->GlobalY(bndry->y)
                                    + mesh->GlobalY(bndry->y - bndry->by) );
-            val = fg->generate(xnorm,TWOPI*ynorm,0.0, t);
+            val = valCache.generate(xnorm,TWOPI*ynorm,0.0, t);
           }
           
           f(bndry->x,bndry->y) = val;
@@ -239,7 +245,7 @@ void BoundaryDirichlet::apply(Field2D &f,BoutReal t) {
             BoutReal ynorm = 0.5*(   mesh->GlobalY(bndry->y)
                                      + mesh->GlobalY(bndry->y - bndry->by) );
             
-            val = fg->generate(xnorm,TWOPI*ynorm,0.0, t);
+            val = valCache.generate(xnorm,TWOPI*ynorm,0.0, t);
           }
           
           f(bndry->x,bndry->y - bndry->by) = val;
@@ -261,7 +267,7 @@ void BoundaryDirichlet::apply(Field2D &f,BoutReal t) {
             // y norm is shifted by half a grid point because it is staggered. 
             BoutReal xnorm = 0.5*(   mesh->GlobalX(bndry->x) + mesh->GlobalX(bndry->x - bndry->bx) );
             BoutReal ynorm = 0.5*(   mesh->GlobalY(bndry->y) + mesh->GlobalY(bndry->y - 1) ); 
-            val = fg->generate(xnorm,TWOPI*ynorm,0.0, t);
+            val = valCache.generate(xnorm,TWOPI*ynorm,0.0, t);
           }
           f(bndry->x,bndry->y) = 2*val - f(bndry->x-bndry->bx, bndry->y-bndry->by);
           
@@ -287,7 +293,7 @@ void BoundaryDirichlet::apply(Field2D &f,BoutReal t) {
 	BoutReal ynorm = 0.5*(   mesh->GlobalY(bndry->y)  // In the guard cell
 				 + mesh->GlobalY(bndry->y - bndry->by) ); // the grid cell
 	
-	val = fg->generate(xnorm,TWOPI*ynorm,0.0, t);
+	val = valCache.generate(xnorm,TWOPI*ynorm,0.0, t);
       }
       
       f(bndry->x,bndry->y) = 2*val - f(bndry->x-bndry->bx, bndry->y-bndry->by);
@@ -300,6 +306,10 @@ void BoundaryDirichlet::apply(Field2D &f,BoutReal t) {
       }	
     }
   }
+
+  if (fg) {
+    valCache.endPass();
+  }
 }
 
 
@@ -318,17 +328,27 @@ void BoundaryDirichlet::apply(Field3D &f,BoutReal t) {
   if(!fg)
     fg = f.getBndryGenerator(bndry->location);
 
+  valCache.setGenerator(fg);
+  if (fg) {
+    valCache.startPass(t);
+  }
+
   BoutReal val = 0.0;
 
+  // View of f for the loops below: hoisting z pencils out of the inner
+  // loops replaces the repeated triple-index arithmetic with contiguous,
+  // stride-one accesses
+  StencilView fv(f);
+
   // Check for staggered grids
-  
+
   CELL_LOC loc = f.getLocation();
   if(mesh->StaggerGrids && loc != CELL_CENTRE) {
     // Staggered. Need to apply slightly differently
-    
+
     if( loc == CELL_XLOW ) {
       // X boundary, and field is shifted in X
-      
+
       if(bndry->bx > 0) {
 	// Outer x boundary
 	
@@ -336,222 +356,280 @@ void BoundaryDirichlet::apply(Field3D &f,BoutReal t) {
 	  BoutReal xnorm = 0.5*(   mesh->GlobalX(bndry->x)
 				   + mesh->GlobalX(bndry->x - bndry->bx) );
 	  BoutReal ynorm = mesh->GlobalY(bndry->y);
-          
+
+	  BoutReal *fb = fv.pencil(bndry->x, bndry->y);
 	  for(int zk=0;zk<mesh->LocalNz;zk++) {
 	    if(fg){
-	      val = fg->generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
+	      val = valCache.generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
 	    }
-	    f(bndry->x,bndry->y, zk) = val;
-						
-	    // Need to set second guard cell, as may be used for interpolation or upwinding derivatives
-	    for(int i=1;i<bndry->width;i++) {
-	      int xi = bndry->x + i*bndry->bx;
-	      int yi = bndry->y ;
-							
-	      f(xi, yi, zk) = 2*f(xi - bndry->bx, yi , zk) - f(xi- 2*bndry->bx, yi , zk);	
-	    }	
+	    fb[zk] = val;
 	  }
+					
+	  // Need to set second guard cell, as may be used for interpolation or upwinding derivatives
+	  for(int i=1;i<bndry->width;i++) {
+	    int xi = bndry->x + i*bndry->bx;
+	    int yi = bndry->y ;
+						
+	    BoutReal *fp = fv.pencil(xi, yi);
+	    const BoutReal *f1 = fv.pencil(xi - bndry->bx, yi);
+	    const BoutReal *f2 = fv.pencil(xi - 2*bndry->bx, yi);
+	    for(int zk=0;zk<mesh->LocalNz;zk++)
+	      fp[zk] = 2*f1[zk] - f2[zk];
+	  }	
 	}
       }
       if (bndry->bx < 0){
 	// Inner x boundary. Set one point inwards
 	for(; !bndry->isDone(); bndry->next1d()) {
-	  
+	
 	  BoutReal xnorm = 0.5*(   mesh->GlobalX(bndry->x)
 				   + mesh->GlobalX(bndry->x - bndry->bx) );
 	  BoutReal ynorm = mesh->GlobalY(bndry->y);
-          
+
+	  BoutReal *fb = fv.pencil(bndry->x - bndry->bx, bndry->y);
+	  BoutReal *fb1 = fv.pencil(bndry->x, bndry->y);
 	  for(int zk=0;zk<mesh->LocalNz;zk++) {
 	    if(fg){
-	      val = fg->generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
+	      val = valCache.generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
 	    }
-	    f(bndry->x - bndry->bx,bndry->y, zk) = val;
-	    f(bndry->x,bndry->y, zk) = f(bndry->x - bndry->bx,bndry->y, zk);
-						
-	    // Need to set second guard cell, as may be used for interpolation or upwinding derivatives
-	    for(int i=0;i<bndry->width;i++) {
-	      int xi = bndry->x + i*bndry->bx;
-	      int yi = bndry->y ;
-              
-	      f(xi, yi, zk) = 2*f(xi - bndry->bx, yi , zk) - f(xi- 2*bndry->bx, yi , zk);	
-	    }	
+	    fb[zk] = val;
+	    fb1[zk] = fb[zk];
 	  }
+					
+	  // Need to set second guard cell, as may be used for interpolation or upwinding derivatives
+	  for(int i=0;i<bndry->width;i++) {
+	    int xi = bndry->x + i*bndry->bx;
+	    int yi = bndry->y ;
+
+	    BoutReal *fp = fv.pencil(xi, yi);
+	    const BoutReal *f1 = fv.pencil(xi - bndry->bx, yi);
+	    const BoutReal *f2 = fv.pencil(xi - 2*bndry->bx, yi);
+	    for(int zk=0;zk<mesh->LocalNz;zk++)
+	      fp[zk] = 2*f1[zk] - f2[zk];
+	  }	
 	}
       }
       if(bndry->by !=0){
 	// y boundaries
 	for(; !bndry->isDone(); bndry->next1d()) {
 	  // x norm is shifted by half a grid point because it is staggered.
-	  // y norm is located half way between first grid cell and guard cell. 
+	  // y norm is located half way between first grid cell and guard cell.
 	  BoutReal xnorm = 0.5*(   mesh->GlobalX(bndry->x) + mesh->GlobalX(bndry->x - 1) );
-	  BoutReal ynorm = 0.5*(   mesh->GlobalY(bndry->y) + mesh->GlobalY(bndry->y - bndry->by) ); 
-      
+	  BoutReal ynorm = 0.5*(   mesh->GlobalY(bndry->y) + mesh->GlobalY(bndry->y - bndry->by) );
+
+	  BoutReal *fb = fv.pencil(bndry->x, bndry->y);
+	  const BoutReal *fi = fv.pencil(bndry->x - bndry->bx, bndry->y - bndry->by);
 	  for(int zk=0;zk<mesh->LocalNz;zk++) {
 	    if(fg){
-	      val = fg->generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
+	      val = valCache.generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
 	    }
-	    f(bndry->x,bndry->y,zk) = 2*val - f(bndry->x-bndry->bx, bndry->y-bndry->by, zk);
-						
-	    // Need to set second guard cell, as may be used for interpolation or upwinding derivatives
-	    for(int i=1;i<bndry->width;i++) {
-	      int xi = bndry->x ;
-	      int yi = bndry->y + i*bndry->by;
-						
-	      f(xi, yi, zk) = 2*f(xi, yi - bndry->by, zk) - f(xi, yi - 2*bndry->by, zk);	
-	    }	
+	    fb[zk] = 2*val - fi[zk];
 	  }
+					
+	  // Need to set second guard cell, as may be used for interpolation or upwinding derivatives
+	  for(int i=1;i<bndry->width;i++) {
+	    int xi = bndry->x ;
+	    int yi = bndry->y + i*bndry->by;
+					
+	    BoutReal *fp = fv.pencil(xi, yi);
+	    const BoutReal *f1 = fv.pencil(xi, yi - bndry->by);
+	    const BoutReal *f2 = fv.pencil(xi, yi - 2*bndry->by);
+	    for(int zk=0;zk<mesh->LocalNz;zk++)
+	      fp[zk] = 2*f1[zk] - f2[zk];
+	  }	
 	}			
       }
     }
     else if( loc == CELL_YLOW ) {
       // Shifted in Y
-      
+
       if(bndry->by > 0) {
 	// Upper y boundary boundary
 	
 	for(; !bndry->isDone(); bndry->next1d()) {
 	  BoutReal xnorm = mesh->GlobalX(bndry->x);
 	  BoutReal ynorm = 0.5*(   mesh->GlobalY(bndry->y) + mesh->GlobalY(bndry->y - bndry->by) );
+	  BoutReal *fb = fv.pencil(bndry->x, bndry->y);
 	  for(int zk=0;zk<mesh->LocalNz;zk++) {
 	    if(fg){
-	      val = fg->generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
+	      val = valCache.generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
 	    }
-	    f(bndry->x,bndry->y,zk) = val;
-						
-	    // Need to set second guard cell, as may be used for interpolation or upwinding derivatives
-	    for(int i=1;i<bndry->width;i++) {
-	      int xi = bndry->x ;
-	      int yi = bndry->y + i*bndry->by;
+	    fb[zk] = val;
+	  }
+					
+	  // Need to set second guard cell, as may be used for interpolation or upwinding derivatives
+	  for(int i=1;i<bndry->width;i++) {
+	    int xi = bndry->x ;
+	    int yi = bndry->y + i*bndry->by;
 
-	      f(xi, yi, zk) = 2.0*f(xi, yi - bndry->by, zk) - f(xi, yi - 2*bndry->by, zk);
-	    }
+	    BoutReal *fp = fv.pencil(xi, yi);
+	    const BoutReal *f1 = fv.pencil(xi, yi - bndry->by);
+	    const BoutReal *f2 = fv.pencil(xi, yi - 2*bndry->by);
+	    for(int zk=0;zk<mesh->LocalNz;zk++)
+	      fp[zk] = 2.0*f1[zk] - f2[zk];
 	  }
 	}
       }
       if(bndry->by < 0){
 	// Lower y boundary. Set one point inwards
 	for(; !bndry->isDone(); bndry->next1d()) {
-	 
+	
 	  BoutReal xnorm = mesh->GlobalX(bndry->x);
 	  BoutReal ynorm = 0.5*(   mesh->GlobalY(bndry->y) + mesh->GlobalY(bndry->y - bndry->by) );
-	  
+	
+	  BoutReal *fb = fv.pencil(bndry->x, bndry->y - bndry->by);
 	  for(int zk=0;zk<mesh->LocalNz;zk++) {
 	    if(fg){
-	      val = fg->generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
+	      val = valCache.generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
 	    }
-	    f(bndry->x,bndry->y - bndry->by, zk) = val;
+	    fb[zk] = val;
+	  }
 
-            // Need to set second guard cell, as may be used for interpolation or upwinding derivatives
-	    for(int i=0;i<bndry->width;i++) {
-	      int xi = bndry->x ;
-	      int yi = bndry->y + i*bndry->by;
+          // Need to set second guard cell, as may be used for interpolation or upwinding derivatives
+	  for(int i=0;i<bndry->width;i++) {
+	    int xi = bndry->x ;
+	    int yi = bndry->y + i*bndry->by;
 
-	      f(xi, yi, zk) = 2*f(xi, yi - bndry->by, zk) - f(xi, yi - 2*bndry->by, zk);
-	    }
+	    BoutReal *fp = fv.pencil(xi, yi);
+	    const BoutReal *f1 = fv.pencil(xi, yi - bndry->by);
+	    const BoutReal *f2 = fv.pencil(xi, yi - 2*bndry->by);
+	    for(int zk=0;zk<mesh->LocalNz;zk++)
+	      fp[zk] = 2*f1[zk] - f2[zk];
 	  }
 	}
       }
       if(bndry->bx != 0){
 	// x boundaries
 	for(; !bndry->isDone(); bndry->next1d()) {
-	  // x norm is located half way between first grid cell and guard cell.  
-	  // y norm is shifted by half a grid point because it is staggered. 
-	  BoutReal xnorm = 0.5*(   mesh->GlobalX(bndry->x) + mesh->GlobalX(bndry->x - bndry->bx) ); 
+	  // x norm is located half way between first grid cell and guard cell.
+	  // y norm is shifted by half a grid point because it is staggered.
+	  BoutReal xnorm = 0.5*(   mesh->GlobalX(bndry->x) + mesh->GlobalX(bndry->x - bndry->bx) );
 	  BoutReal ynorm = 0.5*(   mesh->GlobalY(bndry->y) + mesh->GlobalY(bndry->y - 1) );
-					      
+				
+	  BoutReal *fb = fv.pencil(bndry->x, bndry->y);
+	  const BoutReal *fi = fv.pencil(bndry->x - bndry->bx, bndry->y - bndry->by);
 	  for(int zk=0;zk<mesh->LocalNz;zk++) {
 	    if(fg)
-	      val = fg->generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
+	      val = valCache.generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
 	
-	    f(bndry->x,bndry->y,zk) = 2*val - f(bndry->x-bndry->bx, bndry->y-bndry->by, zk);
-						
-	    // Need to set second guard cell, as may be used for interpolation or upwinding derivatives
-	    for(int i=1;i<bndry->width;i++) {
-	      int xi = bndry->x + i*bndry->bx;
-	      int yi = bndry->y ;
-						
-	      f(xi, yi, zk) = 2*f(xi - bndry->bx, yi , zk) - f(xi - 2*bndry->bx, yi, zk);	
-	    }	
+	    fb[zk] = 2*val - fi[zk];
 	  }
+					
+	  // Need to set second guard cell, as may be used for interpolation or upwinding derivatives
+	  for(int i=1;i<bndry->width;i++) {
+	    int xi = bndry->x + i*bndry->bx;
+	    int yi = bndry->y ;
+					
+	    BoutReal *fp = fv.pencil(xi, yi);
+	    const BoutReal *f1 = fv.pencil(xi - bndry->bx, yi);
+	    const BoutReal *f2 = fv.pencil(xi - 2*bndry->bx, yi);
+	    for(int zk=0;zk<mesh->LocalNz;zk++)
+	      fp[zk] = 2*f1[zk] - f2[zk];
+	  }	
 	}			
       }
     }
   }
   else {
-    // Standard (non-staggered) case
-    for(; !bndry->isDone(); bndry->next1d()) {
-      // Calculate the X and Y normalised values half-way between the guard cell and grid cell 
-      BoutReal xnorm = 0.5*(   mesh->GlobalX(bndry->x)  // In the guard cell
-			       + mesh->GlobalX(bndry->x - bndry->bx) ); // the grid cell
-
-      BoutReal ynorm = 0.5*(   mesh->GlobalY(bndry->y)  // In the guard cell
-			       + mesh->GlobalY(bndry->y - bndry->by) ); // the grid cell
-      
-      for(int zk=0;zk<mesh->LocalNz;zk++) {
-	if(fg){
-	  val = fg->generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
-	}
-	f(bndry->x,bndry->y,zk) = 2*val - f(bndry->x-bndry->bx, bndry->y-bndry->by, zk);
-
-        // We've set the first boundary point using extrapolation in
-        // the line above.  The below block of code is attempting to
-        // set the rest of the boundary cells also using
-        // extrapolation. Whilst this choice doesn't impact 2nd order
-        // methods it has been observed that with higher order
-        // methods, which actually use these points, the use of
-        // extrapolation can be unstable. For this reason we have
-        // commented out the below block and replaced it with the loop
-        // several lines below, which just sets all the rest of the
-        // boundary points to be the specified value.  We've not
-        // removed the commented out code as we may wish to revisit
-        // this in the future, however it may be that this is
-        // eventually removed.  It can be noted that we *don't* apply
-        // this treatment for other boundary treatments,
-        // i.e. elsewhere we tend to extrapolate.
-
-        // // Need to set second guard cell, as may be used for interpolation or upwinding derivatives
-        // for(int i=1;i<bndry->width;i++) {
-        //   int xi = bndry->x + i*bndry->bx;
-        //   int yi = bndry->y + i*bndry->by;
-
-        //   f(xi, yi, zk) = 2*f(xi - bndry->bx, yi - bndry->by, zk) - f(xi - 2*bndry->bx, yi - 2*bndry->by, zk);
-        //   // f(xi, yi, zk) = 3.0*f(xi - bndry->bx, yi - bndry->by, zk) - 3.0*f(xi - 2*bndry->bx, yi - 2*bndry->by, zk) + f(xi - 3*bndry->bx, yi - 3*bndry->by, zk);
-
-        // }
-      }
+    // Standard (non-staggered) case. The direction (bx, by) and width
+    // are uniform over the boundary region, so hoist them and sweep the
+    // precomputed flat point list instead of paying a virtual next1d()
+    // call per point
+    const int bx = bndry->bx;
+    const int by = bndry->by;
+    const int width = bndry->width;
+    for (const auto &pt : bndry->getRegion1d()) {
+      const int xb = pt.x();
+      const int yb = pt.y();
+      // Calculate the X and Y normalised values half-way between the guard cell and grid cell
+      BoutReal xnorm = 0.5*(   mesh->GlobalX(xb)  // In the guard cell
+			       + mesh->GlobalX(xb - bx) ); // the grid cell
+
+      BoutReal ynorm = 0.5*(   mesh->GlobalY(yb)  // In the guard cell
+			       + mesh->GlobalY(yb - by) ); // the grid cell
+
+      BoutReal *fb = fv.pencil(xb, yb);
+      const BoutReal *fi = fv.pencil(xb - bx, yb - by);
+      if (fg) {
+	for(int zk=0;zk<mesh->LocalNz;zk++) {
+	  val = valCache.generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
+	  fb[zk] = 2*val - fi[zk];
+	}
+      } else {
+	// Constant boundary value: resolve it once outside the z loop
+	const BoutReal val2 = 2*val;
+	for(int zk=0;zk<mesh->LocalNz;zk++)
+	  fb[zk] = val2 - fi[zk];
+      }
+
+      // We've set the first boundary point using extrapolation in
+      // the loop above.  The below block of code is attempting to
+      // set the rest of the boundary cells also using
+      // extrapolation. Whilst this choice doesn't impact 2nd order
+      // methods it has been observed that with higher order
+      // methods, which actually use these points, the use of
+      // extrapolation can be unstable. For this reason we have
+      // commented out the below block and replaced it with the loop
+      // several lines below, which just sets all the rest of the
+      // boundary points to be the specified value.  We've not
+      // removed the commented out code as we may wish to revisit
+      // this in the future, however it may be that this is
+      // eventually removed.  It can be noted that we *don't* apply
+      // this treatment for other boundary treatments,
+      // i.e. elsewhere we tend to extrapolate.
+
+      // // Need to set second guard cell, as may be used for interpolation or upwinding derivatives
+      // for(int i=1;i<bndry->width;i++) {
+      //   int xi = bndry->x + i*bndry->bx;
+      //   int yi = bndry->y + i*bndry->by;
+
+      //   f(xi, yi, zk) = 2*f(xi - bndry->bx, yi - bndry->by, zk) - f(xi - 2*bndry->bx, yi - 2*bndry->by, zk);
+      //   // f(xi, yi, zk) = 3.0*f(xi - bndry->bx, yi - bndry->by, zk) - 3.0*f(xi - 2*bndry->bx, yi - 2*bndry->by, zk) + f(xi - 3*bndry->bx, yi - 3*bndry->by, zk);
+
+      // }
 
       // This loop is our alternative approach to setting the rest of the boundary
       // points. Instead of extrapolating we just use the generated values. This
       // can help with the stability of higher order methods.
-      for (int i = 1; i < bndry->width; i++) {
+      for (int i = 1; i < width; i++) {
         // Set any other guard cells using the values on the cells
-        int xi = bndry->x + i*bndry->bx;
-        int yi = bndry->y + i*bndry->by;
+        int xi = xb + i*bx;
+        int yi = yb + i*by;
         xnorm = mesh->GlobalX(xi);
         ynorm = mesh->GlobalY(yi);
-        for(int zk=0;zk<mesh->LocalNz;zk++) {
-          if(fg) {
-            val = fg->generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
+        BoutReal *fp = fv.pencil(xi, yi);
+        if (fg) {
+          for(int zk=0;zk<mesh->LocalNz;zk++) {
+            val = valCache.generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
+            fp[zk] = val;
           }
-          f(xi, yi, zk) = val;
+        } else {
+          for(int zk=0;zk<mesh->LocalNz;zk++)
+            fp[zk] = val;
         }
       }
     }
   }
+
+  if (fg) {
+    valCache.endPass();
+  }
 }
 
 
 void BoundaryDirichlet::apply_ddt(Field2D &f) {
   Field2D *dt = f.timeDeriv();
-  for(bndry->first(); !bndry->isDone(); bndry->next())
-    (*dt)(bndry->x,bndry->y) = 0.; // Set time derivative to zero
+  BOUT_FOR(i, bndry->getRegion()) {
+    (*dt)(i.x(), i.y()) = 0.; // Set time derivative to zero
+  }
 }
 
 void BoundaryDirichlet::apply_ddt(Field3D &f) {
   Field3D *dt = f.timeDeriv();
-  for(bndry->first(); !bndry->isDone(); bndry->next())
-    for(int z=0;z<mesh->LocalNz;z++)
-      (*dt)(bndry->x,bndry->y,z) = 0.; // Set time derivative to zero
+  BOUT_FOR(i, bndry->getRegion()) {
+    for (int z = 0; z < mesh->LocalNz; z++)
+      (*dt)(i.x(), i.y(), z) = 0.; // Set time derivative to zero
+  }
 }
 
 
@@ -583,6 +661,11 @@ void BoundaryDirichlet_O3::apply(Field2D &f,BoutReal t) {
   if(!fg)
     fg = f.getBndryGenerator(bndry->location);
 
+  valCache.setGenerator(fg);
+  if (fg) {
+    valCache.startPass(t);
+  }
+
   BoutReal val = 0.0;
   
 
@@ -601,7 +684,7 @@ void BoundaryDirichlet_O3::apply(Field2D &f,BoutReal t) {
 	  if(fg) {
 	    BoutReal xnorm = 0.5*(   mesh->GlobalX(bndry->x) + mesh->GlobalX(bndry->x - bndry->bx) );
 	    BoutReal ynorm = mesh->GlobalY(bndry->y);
-	    val = fg->generate(xnorm,TWOPI*ynorm,0.0, t);
+	    val = valCache.generate(xnorm,TWOPI*ynorm,0.0, t);
 	  }
           
 	  f(bndry->x,bndry->y) = val;
@@ -620,7 +703,7 @@ void BoundaryDirichlet_O3::apply(Field2D &f,BoutReal t) {
 	  if(fg) {
 	    BoutReal xnorm = 0.5*(   mesh->GlobalX(bndry->x) + mesh->GlobalX(bndry->x - bndry->bx) );
 	    BoutReal ynorm = mesh->GlobalY(bndry->y);
-	    val = fg->generate(xnorm,TWOPI*ynorm,0.0, t);
+	    val = valCache.generate(xnorm,TWOPI*ynorm,0.0, t);
 	  }
 	  f(bndry->x - bndry->bx,bndry->y) = val;
 					
@@ -640,7 +723,7 @@ void BoundaryDirichlet_O3::apply(Field2D &f,BoutReal t) {
 	    BoutReal xnorm = 0.5*( mesh->GlobalX(bndry->x) + mesh->GlobalX(bndry->x - 1) ); 
 	    BoutReal ynorm = 0.5*( mesh->GlobalY(bndry->y) + mesh->GlobalY(bndry->y - bndry->by) ); 
 	
-	    val = fg->generate(xnorm,TWOPI*ynorm,0.0, t);
+	    val = valCache.generate(xnorm,TWOPI*ynorm,0.0, t);
 	  }
       
 	  f(bndry->x,bndry->y) = (8./3)*val - 2.*f(bndry->x-bndry->bx, bndry->y-bndry->by) + f(bndry->x-2*bndry->bx, bndry->y-2*bndry->by)/3.;
@@ -665,7 +748,7 @@ void BoundaryDirichlet_O3::apply(Field2D &f,BoutReal t) {
 	  if(fg) {
 	    BoutReal xnorm = mesh->GlobalX(bndry->x);
 	    BoutReal ynorm = 0.5*( mesh->GlobalY(bndry->y) + mesh->GlobalY(bndry->y - bndry->by) );
-	    val = fg->generate(xnorm,TWOPI*ynorm,0.0, t);
+	    val = valCache.generate(xnorm,TWOPI*ynorm,0.0, t);
 	  }
           
 	  f(bndry->x,bndry->y) = val;
@@ -685,7 +768,7 @@ void BoundaryDirichlet_O3::apply(Field2D &f,BoutReal t) {
 	  if(fg) {
 	    BoutReal xnorm = mesh->GlobalX(bndry->x);
 	    BoutReal ynorm = 0.5*(   mesh->GlobalY(bndry->y) + mesh->GlobalY(bndry->y - bndry->by) );
-	    val = fg->generate(xnorm,TWOPI*ynorm,0.0, t);
+	    val = valCache.generate(xnorm,TWOPI*ynorm,0.0, t);
 	  }
           
 	  f(bndry->x,bndry->y - bndry->by) = val;
@@ -708,7 +791,7 @@ void BoundaryDirichlet_O3::apply(Field2D &f,BoutReal t) {
 	    BoutReal xnorm = 0.5*( mesh->GlobalX(bndry->x) + mesh->GlobalX(bndry->x - bndry->bx) );
 	    BoutReal ynorm = 0.5*( mesh->GlobalY(bndry->y) + mesh->GlobalY(bndry->y - 1) );
 	
-	    val = fg->generate(xnorm,TWOPI*ynorm,0.0, t);
+	    val = valCache.generate(xnorm,TWOPI*ynorm,0.0, t);
 	  }
       
 	  f(bndry->x,bndry->y) = (8./3)*val - 2.*f(bndry->x-bndry->bx, bndry->y-bndry->by) + f(bndry->x-2*bndry->bx, bndry->y-2*bndry->by)/3.;
@@ -736,7 +819,7 @@ void BoundaryDirichlet_O3::apply(Field2D &f,BoutReal t) {
 	BoutReal ynorm = 0.5*(   mesh->GlobalY(bndry->y)  // In the guard cell
 				 + mesh->GlobalY(bndry->y - bndry->by) ); // the grid cell
 	
-	val = fg->generate(xnorm,TWOPI*ynorm,0.0, t);
+	val = valCache.generate(xnorm,TWOPI*ynorm,0.0, t);
       }
       
       f(bndry->x,bndry->y) = (8./3)*val - 2.*f(bndry->x-bndry->bx, bndry->y-bndry->by) + f(bndry->x-2*bndry->bx, bndry->y-2*bndry->by)/3.;
@@ -749,6 +832,10 @@ void BoundaryDirichlet_O3::apply(Field2D &f,BoutReal t) {
       }	
     }
   }
+
+  if (fg) {
+    valCache.endPass();
+  }
 }
 
 
@@ -768,6 +855,11 @@ void BoundaryDirichlet_O3::apply(Field3D &f,BoutReal t) {
   if(!fg)
     fg = f.getBndryGenerator(bndry->location);
 
+  valCache.setGenerator(fg);
+  if (fg) {
+    valCache.startPass(t);
+  }
+
   BoutReal val = 0.0;
 
   // Check for staggered grids
@@ -788,7 +880,7 @@ void BoundaryDirichlet_O3::apply(Field3D &f,BoutReal t) {
           
 	  for(int zk=0;zk<mesh->LocalNz;zk++) {
 	    if(fg){
-	      val = fg->generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
+	      val = valCache.generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
 	    }
 	    f(bndry->x,bndry->y, zk) = val;
 						
@@ -811,7 +903,7 @@ void BoundaryDirichlet_O3::apply(Field3D &f,BoutReal t) {
           
 	  for(int zk=0;zk<mesh->LocalNz;zk++) {
 	    if(fg){
-	      val = fg->generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
+	      val = valCache.generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
 	    }
 	    f(bndry->x - bndry->bx,bndry->y, zk) = val;
 						
@@ -836,7 +928,7 @@ void BoundaryDirichlet_O3::apply(Field3D &f,BoutReal t) {
       
 	  for(int zk=0;zk<mesh->LocalNz;zk++) {
 	    if(fg)
-	      val = fg->generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
+	      val = valCache.generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
 	
 	    f(bndry->x,bndry->y,zk) = (8./3)*val - 2.*f(bndry->x-bndry->bx, bndry->y-bndry->by,zk) + f(bndry->x-2*bndry->bx, bndry->y-2*bndry->by,zk)/3.;
 						
@@ -862,7 +954,7 @@ void BoundaryDirichlet_O3::apply(Field3D &f,BoutReal t) {
 	  BoutReal ynorm = 0.5*(   mesh->GlobalY(bndry->y) + mesh->GlobalY(bndry->y - bndry->by) );
 	  for(int zk=0;zk<mesh->LocalNz;zk++) {
 	    if(fg){
-	      val = fg->generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
+	      val = valCache.generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
 	    }
 	    f(bndry->x,bndry->y,zk) = val;
 						
@@ -885,7 +977,7 @@ void BoundaryDirichlet_O3::apply(Field3D &f,BoutReal t) {
 	  
 	  for(int zk=0;zk<mesh->LocalNz;zk++) {
 	    if(fg){
-	      val = fg->generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
+	      val = valCache.generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
 	    }
 	    f(bndry->x,bndry->y - bndry->by, zk) = val;
 						
@@ -909,7 +1001,7 @@ void BoundaryDirichlet_O3::apply(Field3D &f,BoutReal t) {
       
 	  for(int zk=0;zk<mesh->LocalNz;zk++) {
 	    if(fg)
-	      val = fg->generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
+	      val = valCache.generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
 	
 	    f(bndry->x,bndry->y,zk) = (8./3)*val - 2.*f(bndry->x-bndry->bx, bndry->y-bndry->by,zk) + f(bndry->x-2*bndry->bx, bndry->y-2*bndry->by,zk)/3.;
 						
@@ -937,7 +1029,7 @@ void BoundaryDirichlet_O3::apply(Field3D &f,BoutReal t) {
       
       for(int zk=0;zk<mesh->LocalNz;zk++) {
 	if(fg)
-	  val = fg->generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
+	  val = valCache.generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
 	
 	f(bndry->x,bndry->y,zk) = (8./3)*val - 2.*f(bndry->x-bndry->bx, bndry->y-bndry->by,zk) + f(bndry->x-2*bndry->bx, bndry->y-2*bndry->by,zk)/3.;
 				
@@ -951,12 +1043,17 @@ void BoundaryDirichlet_O3::apply(Field3D &f,BoutReal t) {
       }
     }
   }
+
+  if (fg) {
+    valCache.endPass();
+  }
 }
 
 void BoundaryDirichlet_O3::apply_ddt(Field2D &f) {
   Field2D *dt = f.timeDeriv();
-  for(bndry->first(); !bndry->isDone(); bndry->next())
-    (*dt)(bndry->x,bndry->y) = 0.; // Set time derivative to zero
+  BOUT_FOR(i, bndry->getRegion()) {
+    (*dt)(i.x(), i.y()) = 0.; // Set time derivative to zero
+  }
 }
 
 void BoundaryDirichlet_O3::apply_ddt(Field3D &f) {
@@ -998,6 +1095,11 @@ void BoundaryDirichlet_O4::apply(Field2D &f,BoutReal t) {
   if(!fg)
     fg = f.getBndryGenerator(bndry->location);
 
+  valCache.setGenerator(fg);
+  if (fg) {
+    valCache.startPass(t);
+  }
+
   BoutReal val = 0.0;
   
 
@@ -1017,7 +1119,7 @@ void BoundaryDirichlet_O4::apply(Field2D &f,BoutReal t) {
 	  if(fg) {
 	    BoutReal xnorm = 0.5*( mesh->GlobalX(bndry->x) + mesh->GlobalX(bndry->x - bndry->bx) );
 	    BoutReal ynorm = mesh->GlobalY(bndry->y);
-	    val = fg->generate(xnorm,TWOPI*ynorm,0.0, t);
+	    val = valCache.generate(xnorm,TWOPI*ynorm,0.0, t);
 	  }
 	  f(bndry->x,bndry->y) = val;
 					
@@ -1038,7 +1140,7 @@ void BoundaryDirichlet_O4::apply(Field2D &f,BoutReal t) {
 	    BoutReal xnorm = 0.5*(   mesh->GlobalX(bndry->x)
 				     + mesh->GlobalX(bndry->x - bndry->bx) );
 	    BoutReal ynorm = mesh->GlobalY(bndry->y);
-	    val = fg->generate(xnorm,TWOPI*ynorm,0.0, t);
+	    val = valCache.generate(xnorm,TWOPI*ynorm,0.0, t);
 	  }
           
 	  f(bndry->x - bndry->bx,bndry->y) = val;
@@ -1061,7 +1163,7 @@ void BoundaryDirichlet_O4::apply(Field2D &f,BoutReal t) {
 	    // y norm is located half way between first grid cell and guard cell.
 	    BoutReal xnorm = 0.5*(   mesh->GlobalX(bndry->x) + mesh->GlobalX(bndry->x - 1) ); 
 	    BoutReal ynorm = 0.5*(   mesh->GlobalY(bndry->y) + mesh->GlobalY(bndry->y - bndry->by) ); 
-	    val = fg->generate(xnorm,TWOPI*ynorm,0.0, t);
+	    val = valCache.generate(xnorm,TWOPI*ynorm,0.0, t);
 	  }
       
 	  f(bndry->x,bndry->y) = (16./5)*val - 3.*f(bndry->x-bndry->bx, bndry->y-bndry->by) + f(bndry->x-2*bndry->bx, bndry->y-2*bndry->by) - (1./5)*f(bndry->x-3*bndry->bx, bndry->y-3*bndry->by);
@@ -1087,7 +1189,7 @@ void BoundaryDirichlet_O4::apply(Field2D &f,BoutReal t) {
 	    BoutReal xnorm = mesh->GlobalX(bndry->x);
 	    BoutReal ynorm = 0.5*( mesh->GlobalY(bndry->y)
 				   + mesh->GlobalY(bndry->y - bndry->by) );
-	    val = fg->generate(xnorm,TWOPI*ynorm,0.0, t);
+	    val = valCache.generate(xnorm,TWOPI*ynorm,0.0, t);
 	  }
 	  f(bndry->x,bndry->y) = val;
 					
@@ -1108,7 +1210,7 @@ void BoundaryDirichlet_O4::apply(Field2D &f,BoutReal t) {
 	    BoutReal ynorm = 0.5*(   mesh->GlobalY(bndry->y)
 				     + mesh->GlobalY(bndry->y - bndry->by) );
             
-	    val = fg->generate(xnorm,TWOPI*ynorm,0.0, t);
+	    val = valCache.generate(xnorm,TWOPI*ynorm,0.0, t);
 	  }
           
 	  f(bndry->x,bndry->y - bndry->by) = val;
@@ -1133,7 +1235,7 @@ void BoundaryDirichlet_O4::apply(Field2D &f,BoutReal t) {
 	    BoutReal xnorm = 0.5*(   mesh->GlobalX(bndry->x) + mesh->GlobalX(bndry->x - bndry->bx) ); 
 	    BoutReal ynorm = 0.5*(   mesh->GlobalY(bndry->y) + mesh->GlobalY(bndry->y - 1) ); 
 	
-	    val = fg->generate(xnorm,TWOPI*ynorm,0.0, t);
+	    val = valCache.generate(xnorm,TWOPI*ynorm,0.0, t);
 	  }
       
 	  f(bndry->x,bndry->y) = (16./5)*val - 3.*f(bndry->x-bndry->bx, bndry->y-bndry->by) + f(bndry->x-2*bndry->bx, bndry->y-2*bndry->by) - (1./5)*f(bndry->x-3*bndry->bx, bndry->y-3*bndry->by);
@@ -1162,7 +1264,7 @@ void BoundaryDirichlet_O4::apply(Field2D &f,BoutReal t) {
 	BoutReal ynorm = 0.5*(   mesh->GlobalY(bndry->y)  // In the guard cell
 				 + mesh->GlobalY(bndry->y - bndry->by) ); // the grid cell
 	
-	val = fg->generate(xnorm,TWOPI*ynorm,0.0, t);
+	val = valCache.generate(xnorm,TWOPI*ynorm,0.0, t);
       }
       
       f(bndry->x,bndry->y) = (16./5)*val - 3.*f(bndry->x-bndry->bx, bndry->y-bndry->by) + f(bndry->x-2*bndry->bx, bndry->y-2*bndry->by) - (1./5)*f(bndry->x-3*bndry->bx, bndry->y-3*bndry->by);
@@ -1176,6 +1278,10 @@ void BoundaryDirichlet_O4::apply(Field2D &f,BoutReal t) {
       }
     }
   }
+
+  if (fg) {
+    valCache.endPass();
+  }
 }
 
 
@@ -1195,6 +1301,11 @@ void BoundaryDirichlet_O4::apply(Field3D &f,BoutReal t) {
   if(!fg)
     fg = f.getBndryGenerator(bndry->location);
 
+  valCache.setGenerator(fg);
+  if (fg) {
+    valCache.startPass(t);
+  }
+
   BoutReal val = 0.0;
 
   // Check for staggered grids
@@ -1216,7 +1327,7 @@ void BoundaryDirichlet_O4::apply(Field3D &f,BoutReal t) {
           
 	  for(int zk=0;zk<mesh->LocalNz;zk++) {
 	    if(fg){
-	      val = fg->generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
+	      val = valCache.generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
 	    }
 	    f(bndry->x,bndry->y, zk) = val;
 						
@@ -1240,7 +1351,7 @@ void BoundaryDirichlet_O4::apply(Field3D &f,BoutReal t) {
           
 	  for(int zk=0;zk<mesh->LocalNz;zk++) {
 	    if(fg)
-	      val = fg->generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
+	      val = valCache.generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
 	    
 	    f(bndry->x - bndry->bx,bndry->y, zk) = val;
 
@@ -1265,7 +1376,7 @@ void BoundaryDirichlet_O4::apply(Field3D &f,BoutReal t) {
 
           for(int zk=0;zk<mesh->LocalNz;zk++) {
             if(fg) {
-              val = fg->generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
+              val = valCache.generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
             }
             f(bndry->x,bndry->y,zk) = (16./5)*val - 3.*f(bndry->x-bndry->bx, bndry->y-bndry->by,zk) + f(bndry->x-2*bndry->bx, bndry->y-2*bndry->by,zk) - (1./5)*f(bndry->x-3*bndry->bx, bndry->y-3*bndry->by,zk);
 
@@ -1292,7 +1403,7 @@ void BoundaryDirichlet_O4::apply(Field3D &f,BoutReal t) {
 				   + mesh->GlobalY(bndry->y - bndry->by) );
 	  for(int zk=0;zk<mesh->LocalNz;zk++) {
 	    if(fg)
-	      val = fg->generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
+	      val = valCache.generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
 	    
 	    f(bndry->x,bndry->y,zk) = val;
 						
@@ -1316,7 +1427,7 @@ void BoundaryDirichlet_O4::apply(Field3D &f,BoutReal t) {
 	  
 	  for(int zk=0;zk<mesh->LocalNz;zk++) {
 	    if(fg)
-	      val = fg->generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
+	      val = valCache.generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
 	    
 	    f(bndry->x,bndry->y - bndry->by, zk) = val;
 
@@ -1341,7 +1452,7 @@ void BoundaryDirichlet_O4::apply(Field3D &f,BoutReal t) {
       
 	  for(int zk=0;zk<mesh->LocalNz;zk++) {
 	    if(fg)
-	      val = fg->generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
+	      val = valCache.generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
 	
 	    f(bndry->x,bndry->y,zk) = (16./5)*val - 3.*f(bndry->x-bndry->bx, bndry->y-bndry->by,zk) + f(bndry->x-2*bndry->bx, bndry->y-2*bndry->by,zk) - (1./5)*f(bndry->x-3*bndry->bx, bndry->y-3*bndry->by,zk);
 						
@@ -1369,7 +1480,7 @@ void BoundaryDirichlet_O4::apply(Field3D &f,BoutReal t) {
       
       for(int zk=0;zk<mesh->LocalNz;zk++) {
 	if(fg)
-	  val = fg->generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
+	  val = valCache.generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz), t);
 	
 	f(bndry->x,bndry->y,zk) = (16./5)*val - 3.*f(bndry->x-bndry->bx, bndry->y-bndry->by,zk) + f(bndry->x-2*bndry->bx, bndry->y-2*bndry->by,zk) - (1./5)*f(bndry->x-3*bndry->bx, bndry->y-3*bndry->by,zk);
 				
@@ -1383,19 +1494,25 @@ void BoundaryDirichlet_O4::apply(Field3D &f,BoutReal t) {
       }
     }
   }
+
+  if (fg) {
+    valCache.endPass();
+  }
 }
 
 void BoundaryDirichlet_O4::apply_ddt(Field2D &f) {
   Field2D *dt = f.timeDeriv();
-  for(bndry->first(); !bndry->isDone(); bndry->next())
-    (*dt)(bndry->x,bndry->y) = 0.; // Set time derivative to zero
+  BOUT_FOR(i, bndry->getRegion()) {
+    (*dt)(i.x(), i.y()) = 0.; // Set time derivative to zero
+  }
 }
 
 void BoundaryDirichlet_O4::apply_ddt(Field3D &f) {
   Field3D *dt = f.timeDeriv();
-  for(bndry->first(); !bndry->isDone(); bndry->next())
-    for(int z=0;z<mesh->LocalNz;z++)
-      (*dt)(bndry->x,bndry->y,z) = 0.; // Set time derivative to zero
+  BOUT_FOR(i, bndry->getRegion()) {
+    for (int z = 0; z < mesh->LocalNz; z++)
+      (*dt)(i.x(), i.y(), z) = 0.; // Set time derivative to zero
+  }
 }
 
 ///////////////////////////////////////////////////////////////
@@ -1441,15 +1558,17 @@ void BoundaryDirichlet_2ndOrder::apply(Field3D &f) {
 
 void BoundaryDirichlet_2ndOrder::apply_ddt(Field2D &f) {
   Field2D *dt = f.timeDeriv();
-  for(bndry->first(); !bndry->isDone(); bndry->next())
-    (*dt)(bndry->x,bndry->y) = 0.; // Set time derivative to zero
+  BOUT_FOR(i, bndry->getRegion()) {
+    (*dt)(i.x(), i.y()) = 0.; // Set time derivative to zero
+  }
 }
 
 void BoundaryDirichlet_2ndOrder::apply_ddt(Field3D &f) {
   Field3D *dt = f.timeDeriv();
-  for(bndry->first(); !bndry->isDone(); bndry->next())
-    for(int z=0;z<mesh->LocalNz;z++)
-      (*dt)(bndry->x,bndry->y,z) = 0.; // Set time derivative to zero
+  BOUT_FOR(i, bndry->getRegion()) {
+    for (int z = 0; z < mesh->LocalNz; z++)
+      (*dt)(i.x(), i.y(), z) = 0.; // Set time derivative to zero
+  }
 }
 
 ///////////////////////////////////////////////////////////////
@@ -1483,15 +1602,17 @@ void BoundaryDirichlet_4thOrder::apply(Field3D &f) {
 
 void BoundaryDirichlet_4thOrder::apply_ddt(Field2D &f) {
   Field2D *dt = f.timeDeriv();
-  for(bndry->first(); !bndry->isDone(); bndry->next())
-    (*dt)(bndry->x,bndry->y) = 0.; // Set time derivative to zero
+  BOUT_FOR(i, bndry->getRegion()) {
+    (*dt)(i.x(), i.y()) = 0.; // Set time derivative to zero
+  }
 }
 
 void BoundaryDirichlet_4thOrder::apply_ddt(Field3D &f) {
   Field3D *dt = f.timeDeriv();
-  for(bndry->first(); !bndry->isDone(); bndry->next())
-    for(int z=0;z<mesh->LocalNz;z++)
-      (*dt)(bndry->x,bndry->y,z) = 0.; // Set time derivative to zero
+  BOUT_FOR(i, bndry->getRegion()) {
+    for (int z = 0; z < mesh->LocalNz; z++)
+      (*dt)(i.x(), i.y(), z) = 0.; // Set time derivative to zero
+  }
 }
 
 ///////////////////////////////////////////////////////////////
@@ -1668,15 +1789,17 @@ void BoundaryNeumann_2ndOrder::apply(Field3D &f) {
 
 void BoundaryNeumann_2ndOrder::apply_ddt(Field2D &f) {
   Field2D *dt = f.timeDeriv();
-  for(bndry->first(); !bndry->isDone(); bndry->next())
-    (*dt)(bndry->x,bndry->y) = 0.; // Set time derivative to zero
+  BOUT_FOR(i, bndry->getRegion()) {
+    (*dt)(i.x(), i.y()) = 0.; // Set time derivative to zero
+  }
 }
 
 void BoundaryNeumann_2ndOrder::apply_ddt(Field3D &f) {
   Field3D *dt = f.timeDeriv();
-  for(bndry->first(); !bndry->isDone(); bndry->next())
-    for(int z=0;z<mesh->LocalNz;z++)
-      (*dt)(bndry->x,bndry->y,z) = 0.; // Set time derivative to zero
+  BOUT_FOR(i, bndry->getRegion()) {
+    for (int z = 0; z < mesh->LocalNz; z++)
+      (*dt)(i.x(), i.y(), z) = 0.; // Set time derivative to zero
+  }
 }
 
 ///////////////////////////////////////////////////////////////
@@ -1708,6 +1831,11 @@ void BoundaryNeumann::apply(Field2D &f,BoutReal t) {
   std::shared_ptr<FieldGenerator>  fg = gen;
   if(!fg)
     fg = f.getBndryGenerator(bndry->location);
+
+  valCache.setGenerator(fg);
+  if (fg) {
+    valCache.startPass(t);
+  }
   
   BoutReal val = 0.0;
   
@@ -1732,7 +1860,7 @@ void BoundaryNeumann::apply(Field2D &f,BoutReal t) {
 				     + mesh->GlobalX(bndry->x - bndry->bx) );
 	    BoutReal ynorm = mesh->GlobalY(bndry->y);
 	    
-	    val = fg->generate(xnorm,TWOPI*ynorm,0.0, t) * metric->dx(bndry->x, bndry->y);
+	    val = valCache.generate(xnorm,TWOPI*ynorm,0.0, t) * metric->dx(bndry->x, bndry->y);
 	  }
           
 	  f(bndry->x,bndry->y) = (4.*f(bndry->x - bndry->bx, bndry->y) - f(bndry->x - 2*bndry->bx, bndry->y) + 2.*val)/3.;
@@ -1756,7 +1884,7 @@ void BoundaryNeumann::apply(Field2D &f,BoutReal t) {
 				     + mesh->GlobalX(bndry->x - bndry->bx) );
 	    BoutReal ynorm = mesh->GlobalY(bndry->y);
 	    
-	    val = fg->generate(xnorm,TWOPI*ynorm,0.0, t) * metric->dx(bndry->x, bndry->y);
+	    val = valCache.generate(xnorm,TWOPI*ynorm,0.0, t) * metric->dx(bndry->x, bndry->y);
 	  }
           
 	  f(bndry->x - bndry->bx,bndry->y) = (4.*f(bndry->x - 2*bndry->bx, bndry->y) - f(bndry->x - 3*bndry->bx, bndry->y) - 2.*val)/3.;
@@ -1783,7 +1911,7 @@ void BoundaryNeumann::apply(Field2D &f,BoutReal t) {
 	    BoutReal xnorm = 0.5*(   mesh->GlobalX(bndry->x) + mesh->GlobalX(bndry->x - 1) ); 
 	    BoutReal ynorm = 0.5*(   mesh->GlobalY(bndry->y) + mesh->GlobalY(bndry->y - bndry->by) ); 
 	    
-	    val = fg->generate(xnorm, TWOPI*ynorm, 0.0, t);
+	    val = valCache.generate(xnorm, TWOPI*ynorm, 0.0, t);
 	  }
 	  
 	  f(bndry->x,bndry->y) = f(bndry->x-bndry->bx, bndry->y-bndry->by) + delta*val;
@@ -1805,7 +1933,7 @@ void BoundaryNeumann::apply(Field2D &f,BoutReal t) {
 	    BoutReal ynorm = 0.5*(   mesh->GlobalY(bndry->y)
 				     + mesh->GlobalY(bndry->y - bndry->by) );
             
-	    val = fg->generate(xnorm,TWOPI*ynorm,0.0, t) * metric->dx(bndry->x, bndry->y);
+	    val = valCache.generate(xnorm,TWOPI*ynorm,0.0, t) * metric->dx(bndry->x, bndry->y);
 	  }
 	  f(bndry->x,bndry->y) = (4.*f(bndry->x, bndry->y - bndry->by) - f(bndry->x, bndry->y - 2*bndry->by) + 2.*val)/3.;
 	  
@@ -1829,7 +1957,7 @@ void BoundaryNeumann::apply(Field2D &f,BoutReal t) {
 	    BoutReal ynorm = 0.5*(   mesh->GlobalY(bndry->y)
 				     + mesh->GlobalY(bndry->y - bndry->by) );
             
-	    val = fg->generate(xnorm,TWOPI*ynorm,0.0, t) * metric->dx(bndry->x, bndry->y - bndry->by);
+	    val = valCache.generate(xnorm,TWOPI*ynorm,0.0, t) * metric->dx(bndry->x, bndry->y - bndry->by);
 	  }
 	  f(bndry->x,bndry->y - bndry->by) = (4.*f(bndry->x, bndry->y - 2*bndry->by) - f(bndry->x, bndry->y - 3*bndry->by) - 2.*val)/3.;
 
@@ -1854,7 +1982,7 @@ void BoundaryNeumann::apply(Field2D &f,BoutReal t) {
 	    BoutReal xnorm = 0.5*(   mesh->GlobalX(bndry->x) + mesh->GlobalX(bndry->x - bndry->bx) ); 
 	    BoutReal ynorm = 0.5*(   mesh->GlobalY(bndry->y) + mesh->GlobalY(bndry->y - 1) ); 
 	    
-	    val = fg->generate(xnorm, TWOPI*ynorm, 0.0, t);
+	    val = valCache.generate(xnorm, TWOPI*ynorm, 0.0, t);
 	  }
 	  
 	  f(bndry->x,bndry->y) = f(bndry->x-bndry->bx, bndry->y-bndry->by) + delta*val;
@@ -1879,7 +2007,7 @@ void BoundaryNeumann::apply(Field2D &f,BoutReal t) {
 	BoutReal ynorm = 0.5*(   mesh->GlobalY(bndry->y)  // In the guard cell
 				 + mesh->GlobalY(bndry->y - bndry->by) ); // the grid cell
 	
-	val = fg->generate(xnorm, TWOPI*ynorm, 0.0, t);
+	val = valCache.generate(xnorm, TWOPI*ynorm, 0.0, t);
       }
       
       f(bndry->x,bndry->y) = f(bndry->x-bndry->bx, bndry->y-bndry->by) + delta*val;
@@ -1888,6 +2016,10 @@ void BoundaryNeumann::apply(Field2D &f,BoutReal t) {
       }
     }
   }
+
+  if (fg) {
+    valCache.endPass();
+  }
 }
 
 
@@ -1905,6 +2037,11 @@ void BoundaryNeumann::apply(Field3D &f,BoutReal t) {
   std::shared_ptr<FieldGenerator>  fg = gen;
   if(!fg)
     fg = f.getBndryGenerator(bndry->location);
+
+  valCache.setGenerator(fg);
+  if (fg) {
+    valCache.startPass(t);
+  }
   
   BoutReal val = 0.0;
   
@@ -1928,7 +2065,7 @@ void BoundaryNeumann::apply(Field3D &f,BoutReal t) {
 	  
 	  for(int zk=0;zk<mesh->LocalNz;zk++) {
 	    if(fg)
-	      val = fg->generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz),t) * metric->dx(bndry->x, bndry->y);
+	      val = valCache.generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz),t) * metric->dx(bndry->x, bndry->y);
 	    
 	    f(bndry->x,bndry->y, zk) = (4.*f(bndry->x - bndry->bx, bndry->y,zk) - f(bndry->x - 2*bndry->bx, bndry->y,zk) + 2.*val)/3.;
 	    
@@ -1955,7 +2092,7 @@ void BoundaryNeumann::apply(Field3D &f,BoutReal t) {
 	  for(int zk=0;zk<mesh->LocalNz;zk++) {
 	    
 	    if(fg)
-	      val = fg->generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz),t) * metric->dx(bndry->x - bndry->bx, bndry->y);
+	      val = valCache.generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz),t) * metric->dx(bndry->x - bndry->bx, bndry->y);
             
 	    f(bndry->x - bndry->bx,bndry->y, zk) = (4.*f(bndry->x - 2*bndry->bx, bndry->y,zk) - f(bndry->x - 3*bndry->bx, bndry->y,zk) - 2.*val)/3.;
 
@@ -1982,7 +2119,7 @@ void BoundaryNeumann::apply(Field3D &f,BoutReal t) {
 
 	  for(int zk=0;zk<mesh->LocalNz;zk++) {
 	    if(fg){
-	      val = fg->generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz),t);
+	      val = valCache.generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz),t);
 	    }
 	    f(bndry->x,bndry->y, zk) = f(bndry->x-bndry->bx, bndry->y-bndry->by, zk) + delta*val;
 	    if (bndry->width == 2){
@@ -2005,7 +2142,7 @@ void BoundaryNeumann::apply(Field3D &f,BoutReal t) {
 	  for(int zk=0;zk<mesh->LocalNz;zk++) {
 	  
 	    if(fg){
-	      val = fg->generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz),t) * metric->dy(bndry->x, bndry->y);
+	      val = valCache.generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz),t) * metric->dy(bndry->x, bndry->y);
 	    }
 	    f(bndry->x,bndry->y,zk) =   (4.*f(bndry->x, bndry->y - bndry->by,zk) - f(bndry->x, bndry->y - 2*bndry->by,zk) + 2.*val)/3.;
 	    
@@ -2030,7 +2167,7 @@ void BoundaryNeumann::apply(Field3D &f,BoutReal t) {
 				   + mesh->GlobalY(bndry->y - bndry->by) );
 	  for(int zk=0;zk<mesh->LocalNz;zk++) {
 	    if(fg)
-	      val = fg->generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz),t) * metric->dy(bndry->x, bndry->y - bndry->by);
+	      val = valCache.generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz),t) * metric->dy(bndry->x, bndry->y - bndry->by);
             
 	    f(bndry->x,bndry->y - bndry->by,zk) = (4.*f(bndry->x, bndry->y - 2*bndry->by,zk) - f(bndry->x, bndry->y - 3*bndry->by,zk) - 2.*val)/3.;
 	    
@@ -2058,7 +2195,7 @@ void BoundaryNeumann::apply(Field3D &f,BoutReal t) {
 
 	  for(int zk=0;zk<mesh->LocalNz;zk++) {
 	    if(fg){
-	      val = fg->generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz),t);
+	      val = valCache.generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz),t);
 	    }
 	    f(bndry->x,bndry->y, zk) = f(bndry->x-bndry->bx, bndry->y-bndry->by, zk) + delta*val;
 	    if (bndry->width == 2){
@@ -2070,40 +2207,76 @@ void BoundaryNeumann::apply(Field3D &f,BoutReal t) {
     }
   }
   else {
-    for(; !bndry->isDone(); bndry->next1d()) {
-      // Calculate the X and Y normalised values half-way between the guard cell and grid cell 
-      BoutReal xnorm = 0.5*(   mesh->GlobalX(bndry->x)  // In the guard cell
-			       + mesh->GlobalX(bndry->x - bndry->bx) ); // the grid cell
-      
-      BoutReal ynorm = 0.5*(   mesh->GlobalY(bndry->y)  // In the guard cell
-			       + mesh->GlobalY(bndry->y - bndry->by) ); // the grid cell
-      
-      BoutReal delta = bndry->bx*metric->dx(bndry->x,bndry->y)+bndry->by*metric->dy(bndry->x,bndry->y);
-      
-      for(int zk=0;zk<mesh->LocalNz;zk++) {
-	if(fg){
-	  val = fg->generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz),t);
+    StencilView fv(f);
+    // The direction (bx, by) and width are uniform over the boundary
+    // region, so hoist them and sweep the precomputed flat point list
+    // instead of paying a virtual next1d() call per point
+    const int bx = bndry->bx;
+    const int by = bndry->by;
+    const bool width2 = (bndry->width == 2);
+    for (const auto &pt : bndry->getRegion1d()) {
+      const int xb = pt.x();
+      const int yb = pt.y();
+      // Calculate the X and Y normalised values half-way between the guard cell and grid cell
+      BoutReal xnorm = 0.5*(   mesh->GlobalX(xb)  // In the guard cell
+			       + mesh->GlobalX(xb - bx) ); // the grid cell
+
+      BoutReal ynorm = 0.5*(   mesh->GlobalY(yb)  // In the guard cell
+			       + mesh->GlobalY(yb - by) ); // the grid cell
+
+      BoutReal delta = bx*metric->dx(xb,yb)+by*metric->dy(xb,yb);
+
+      // Hoist the boundary and interior pencils out of the z loop
+      BoutReal *fb = fv.pencil(xb, yb);
+      const BoutReal *fi = fv.pencil(xb - bx, yb - by);
+      BoutReal *fb2 = nullptr;
+      const BoutReal *fi2 = nullptr;
+      if (width2){
+	// Second guard cell, and the cell it extrapolates from
+	fb2 = fv.pencil(xb + bx, yb + by);
+	fi2 = fv.pencil(xb - 2*bx, yb - 2*by);
+      }
+
+      if (fg) {
+	for(int zk=0;zk<mesh->LocalNz;zk++) {
+	  val = valCache.generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz),t);
+	  fb[zk] = fi[zk] + delta*val;
+	  if (width2){
+	    fb2[zk] = fi2[zk] + 3.0*delta*val;
+	  }
 	}
-	f(bndry->x,bndry->y, zk) = f(bndry->x-bndry->bx, bndry->y-bndry->by, zk) + delta*val;
-	if (bndry->width == 2){
-	  f(bndry->x + bndry->bx, bndry->y + bndry->by, zk) = f(bndry->x - 2*bndry->bx, bndry->y - 2*bndry->by, zk) + 3.0*delta*val;
+      } else {
+	// Constant gradient: resolve the increments once outside the z loop
+	const BoutReal dval = delta*val;
+	for(int zk=0;zk<mesh->LocalNz;zk++)
+	  fb[zk] = fi[zk] + dval;
+	if (width2){
+	  const BoutReal dval3 = 3.0*dval;
+	  for(int zk=0;zk<mesh->LocalNz;zk++)
+	    fb2[zk] = fi2[zk] + dval3;
 	}
       }
     }
   }
+
+  if (fg) {
+    valCache.endPass();
+  }
 }
 
 void BoundaryNeumann::apply_ddt(Field2D &f) {
   Field2D *dt = f.timeDeriv();
-  for(bndry->first(); !bndry->isDone(); bndry->next())
-    (*dt)(bndry->x,bndry->y) = 0.; // Set time derivative to zero
+  BOUT_FOR(i, bndry->getRegion()) {
+    (*dt)(i.x(), i.y()) = 0.; // Set time derivative to zero
+  }
 }
 
 void BoundaryNeumann::apply_ddt(Field3D &f) {
   Field3D *dt = f.timeDeriv();
-  for(bndry->first(); !bndry->isDone(); bndry->next())
-    for(int z=0;z<mesh->LocalNz;z++)
-      (*dt)(bndry->x,bndry->y,z) = 0.; // Set time derivative to zero
+  BOUT_FOR(i, bndry->getRegion()) {
+    for (int z = 0; z < mesh->LocalNz; z++)
+      (*dt)(i.x(), i.y(), z) = 0.; // Set time derivative to zero
+  }
 }
 
 ///////////////////////////////////////////////////////////////
@@ -2132,6 +2305,11 @@ void BoundaryNeumann_O4::apply(Field2D &f,BoutReal t) {
   if(!fg)
     fg = f.getBndryGenerator(bndry->location);
 
+  valCache.setGenerator(fg);
+  if (fg) {
+    valCache.startPass(t);
+  }
+
   BoutReal val = 0.0;
   
   // Check for staggered grids
@@ -2155,7 +2333,7 @@ void BoundaryNeumann_O4::apply(Field2D &f,BoutReal t) {
         BoutReal ynorm = 0.5*(   mesh->GlobalY(bndry->y)  // In the guard cell
                                  + mesh->GlobalY(bndry->y - bndry->by) ); // the grid cell
 	
-        val = fg->generate(xnorm, TWOPI*ynorm, 0.0, t);
+        val = valCache.generate(xnorm, TWOPI*ynorm, 0.0, t);
       }
       
       f(bndry->x, bndry->y) = 12.*delta*val/11.
@@ -2172,6 +2350,10 @@ void BoundaryNeumann_O4::apply(Field2D &f,BoutReal t) {
       }
     }
   }
+
+  if (fg) {
+    valCache.endPass();
+  }
 }
 
 void BoundaryNeumann_O4::apply(Field3D &f) {
@@ -2186,6 +2368,11 @@ void BoundaryNeumann_O4::apply(Field3D &f,BoutReal t) {
   if(!fg)
     fg = f.getBndryGenerator(bndry->location);
 
+  valCache.setGenerator(fg);
+  if (fg) {
+    valCache.startPass(t);
+  }
+
   BoutReal val = 0.0;
   
   // Check for staggered grids
@@ -2207,7 +2394,7 @@ void BoundaryNeumann_O4::apply(Field3D &f,BoutReal t) {
 
       for(int zk=0;zk<mesh->LocalNz;zk++) {
         if(fg){
-          val = fg->generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz),t);
+          val = valCache.generate(xnorm,TWOPI*ynorm,TWOPI*zk/(mesh->LocalNz),t);
         }
 
         f(bndry->x,bndry->y, zk) = 12.*delta*val/11.
@@ -2225,19 +2412,25 @@ void BoundaryNeumann_O4::apply(Field3D &f,BoutReal t) {
       }
     }
   }
+
+  if (fg) {
+    valCache.endPass();
+  }
 }
 
 void BoundaryNeumann_O4::apply_ddt(Field2D &f) {
   Field2D *dt = f.timeDeriv();
-  for(bndry->first(); !bndry->isDone(); bndry->next())
-    (*dt)(bndry->x,bndry->y) = 0.; // Set time derivative to zero
+  BOUT_FOR(i, bndry->getRegion()) {
+    (*dt)(i.x(), i.y()) = 0.; // Set time derivative to zero
+  }
 }
 
 void BoundaryNeumann_O4::apply_ddt(Field3D &f) {
   Field3D *dt = f.timeDeriv();
-  for(bndry->first(); !bndry->isDone(); bndry->next())
-    for(int z=0;z<mesh->LocalNz;z++)
-      (*dt)(bndry->x,bndry->y,z) = 0.; // Set time derivative to zero
+  BOUT_FOR(i, bndry->getRegion()) {
+    for (int z = 0; z < mesh->LocalNz; z++)
+      (*dt)(i.x(), i.y(), z) = 0.; // Set time derivative to zero
+  }
 }
 
 ///////////////////////////////////////////////////////////////
@@ -2277,15 +2470,17 @@ void BoundaryNeumann_4thOrder::apply(Field3D &f) {
 
 void BoundaryNeumann_4thOrder::apply_ddt(Field2D &f) {
   Field2D *dt = f.timeDeriv();
-  for(bndry->first(); !bndry->isDone(); bndry->next())
-    (*dt)(bndry->x,bndry->y) = 0.; // Set time derivative to zero
+  BOUT_FOR(i, bndry->getRegion()) {
+    (*dt)(i.x(), i.y()) = 0.; // Set time derivative to zero
+  }
 }
 
 void BoundaryNeumann_4thOrder::apply_ddt(Field3D &f) {
   Field3D *dt = f.timeDeriv();
-  for(bndry->first(); !bndry->isDone(); bndry->next())
-    for(int z=0;z<mesh->LocalNz;z++)
-      (*dt)(bndry->x,bndry->y,z) = 0.; // Set time derivative to zero
+  BOUT_FOR(i, bndry->getRegion()) {
+    for (int z = 0; z < mesh->LocalNz; z++)
+      (*dt)(i.x(), i.y(), z) = 0.; // Set time derivative to zero
+  }
 }
 
 ///////////////////////////////////////////////////////////////
@@ -2888,17 +3083,19 @@ void BoundaryFree_O2::apply(Field2D &f) {
 }
 
 void BoundaryFree_O2::apply(Field3D &f) {
-  // Extrapolate from the last evolved simulation cells into the guard cells at 3rd order.  
+  // Extrapolate from the last evolved simulation cells into the guard cells at 3rd order.
 
   bndry->first();
 
+  // Pencil view of f: the z loops below then run over contiguous data
+  StencilView fv(f);
 
   // Check for staggered grids
-  
+
   CELL_LOC loc = f.getLocation();
   if(mesh->StaggerGrids && loc != CELL_CENTRE) {
     // Staggered. Need to apply slightly differently
-    
+
     if( loc == CELL_XLOW ) {
       // Field is shifted in X
 			
@@ -2906,26 +3103,28 @@ void BoundaryFree_O2::apply(Field3D &f) {
 	// Outer x boundary
 	
 	for(; !bndry->isDone(); bndry->next1d()) {
-					
-	  for(int zk=0;zk<mesh->LocalNz;zk++) {
-	    for(int i=0;i<bndry->width;i++) {
-	      int xi = bndry->x + i*bndry->bx;
-	      int yi = bndry->y + i*bndry->by;
-	      f(xi, yi, zk) = 2*f(xi - bndry->bx, yi -bndry->by, zk) - f(xi- 2*bndry->bx, yi - 2*bndry->by, zk);	
-	    }	
+	  for(int i=0;i<bndry->width;i++) {
+	    int xi = bndry->x + i*bndry->bx;
+	    int yi = bndry->y + i*bndry->by;
+	    BoutReal *fp = fv.pencil(xi, yi);
+	    const BoutReal *f1 = fv.pencil(xi - bndry->bx, yi - bndry->by);
+	    const BoutReal *f2 = fv.pencil(xi - 2*bndry->bx, yi - 2*bndry->by);
+	    for(int zk=0;zk<mesh->LocalNz;zk++)
+	      fp[zk] = 2*f1[zk] - f2[zk];
 	  }
 	}
       }
       if(bndry->bx < 0) {
 	// Inner x boundary. Set one point inwards
 	for(; !bndry->isDone(); bndry->next1d()) {
-	  
-	  for(int zk=0;zk<mesh->LocalNz;zk++) {
-	    for(int i=-1;i<bndry->width;i++) {
-	      int xi = bndry->x + i*bndry->bx;
-	      int yi = bndry->y + i*bndry->by;
-	      f(xi, yi, zk) = 2*f(xi - bndry->bx, yi -bndry->by, zk) - f(xi- 2*bndry->bx, yi - 2*bndry->by, zk);	
-	    }	
+	  for(int i=-1;i<bndry->width;i++) {
+	    int xi = bndry->x + i*bndry->bx;
+	    int yi = bndry->y + i*bndry->by;
+	    BoutReal *fp = fv.pencil(xi, yi);
+	    const BoutReal *f1 = fv.pencil(xi - bndry->bx, yi - bndry->by);
+	    const BoutReal *f2 = fv.pencil(xi - 2*bndry->bx, yi - 2*bndry->by);
+	    for(int zk=0;zk<mesh->LocalNz;zk++)
+	      fp[zk] = 2*f1[zk] - f2[zk];
 	  }
 	}
       }
@@ -2933,55 +3132,60 @@ void BoundaryFree_O2::apply(Field3D &f) {
 	//y boundaries
 				
 	for(; !bndry->isDone(); bndry->next1d()) {
-					
-	  for(int zk=0;zk<mesh->LocalNz;zk++) {
-	    for(int i=0;i<bndry->width;i++) {
-	      int xi = bndry->x + i*bndry->bx;
-	      int yi = bndry->y + i*bndry->by;
-	      f(xi, yi, zk) = 2*f(xi - bndry->bx, yi -bndry->by, zk) - f(xi- 2*bndry->bx, yi - 2*bndry->by, zk);	
-	    }	
+	  for(int i=0;i<bndry->width;i++) {
+	    int xi = bndry->x + i*bndry->bx;
+	    int yi = bndry->y + i*bndry->by;
+	    BoutReal *fp = fv.pencil(xi, yi);
+	    const BoutReal *f1 = fv.pencil(xi - bndry->bx, yi - bndry->by);
+	    const BoutReal *f2 = fv.pencil(xi - 2*bndry->bx, yi - 2*bndry->by);
+	    for(int zk=0;zk<mesh->LocalNz;zk++)
+	      fp[zk] = 2*f1[zk] - f2[zk];
 	  }
 	}
       }
     }
     else if( loc == CELL_YLOW ) {
       // Field is shifted in Y
-      
+
       if(bndry->by > 0) {
 	// Upper y boundary
 	for(; !bndry->isDone(); bndry->next1d()) {
-	  for(int zk=0;zk<mesh->LocalNz;zk++) {
-	    for(int i=0;i<bndry->width;i++) {
-	      int xi = bndry->x + i*bndry->bx;
-	      int yi = bndry->y + i*bndry->by;
-	      f(xi, yi, zk) = 2*f(xi - bndry->bx, yi -bndry->by, zk) - f(xi- 2*bndry->bx, yi - 2*bndry->by, zk);	
-	    }	
+	  for(int i=0;i<bndry->width;i++) {
+	    int xi = bndry->x + i*bndry->bx;
+	    int yi = bndry->y + i*bndry->by;
+	    BoutReal *fp = fv.pencil(xi, yi);
+	    const BoutReal *f1 = fv.pencil(xi - bndry->bx, yi - bndry->by);
+	    const BoutReal *f2 = fv.pencil(xi - 2*bndry->bx, yi - 2*bndry->by);
+	    for(int zk=0;zk<mesh->LocalNz;zk++)
+	      fp[zk] = 2*f1[zk] - f2[zk];
 	  }
 	}
       }
       if(bndry->by < 0) {
 	// Lower y boundary. Set one point inwards
 	for(; !bndry->isDone(); bndry->next1d()) {
-					
-	  for(int zk=0;zk<mesh->LocalNz;zk++) {
-	    for(int i=-1;i<bndry->width;i++) {
-	      int xi = bndry->x + i*bndry->bx;
-	      int yi = bndry->y + i*bndry->by;
-	      f(xi, yi, zk) = 2*f(xi - bndry->bx, yi -bndry->by, zk) - f(xi- 2*bndry->bx, yi - 2*bndry->by, zk);	
-	    }
+	  for(int i=-1;i<bndry->width;i++) {
+	    int xi = bndry->x + i*bndry->bx;
+	    int yi = bndry->y + i*bndry->by;
+	    BoutReal *fp = fv.pencil(xi, yi);
+	    const BoutReal *f1 = fv.pencil(xi - bndry->bx, yi - bndry->by);
+	    const BoutReal *f2 = fv.pencil(xi - 2*bndry->bx, yi - 2*bndry->by);
+	    for(int zk=0;zk<mesh->LocalNz;zk++)
+	      fp[zk] = 2*f1[zk] - f2[zk];
 	  }
 	}
       }
       if(bndry->bx != 0){
 	// x boundaries
 	for(; !bndry->isDone(); bndry->next1d()) {
-					
-	  for(int zk=0;zk<mesh->LocalNz;zk++) {
-	    for(int i=0;i<bndry->width;i++) {
-	      int xi = bndry->x + i*bndry->bx;
-	      int yi = bndry->y + i*bndry->by;
-	      f(xi, yi, zk) = 2*f(xi - bndry->bx, yi -bndry->by, zk) - f(xi- 2*bndry->bx, yi - 2*bndry->by, zk);			
-	    }
+	  for(int i=0;i<bndry->width;i++) {
+	    int xi = bndry->x + i*bndry->bx;
+	    int yi = bndry->y + i*bndry->by;
+	    BoutReal *fp = fv.pencil(xi, yi);
+	    const BoutReal *f1 = fv.pencil(xi - bndry->bx, yi - bndry->by);
+	    const BoutReal *f2 = fv.pencil(xi - 2*bndry->bx, yi - 2*bndry->by);
+	    for(int zk=0;zk<mesh->LocalNz;zk++)
+	      fp[zk] = 2*f1[zk] - f2[zk];
 	  }
 	}
       }
@@ -2990,13 +3194,14 @@ void BoundaryFree_O2::apply(Field3D &f) {
   else {
     // Standard (non-staggered) case
     for(; !bndry->isDone(); bndry->next1d()) {
-			
-      for(int zk=0;zk<mesh->LocalNz;zk++) {
-	for(int i=0;i<bndry->width;i++) {
-	  int xi = bndry->x + i*bndry->bx;
-	  int yi = bndry->y + i*bndry->by;
-	  f(xi, yi, zk) = 2*f(xi - bndry->bx, yi -bndry->by, zk) - f(xi- 2*bndry->bx, yi - 2*bndry->by, zk);	
-	}
+      for(int i=0;i<bndry->width;i++) {
+	int xi = bndry->x + i*bndry->bx;
+	int yi = bndry->y + i*bndry->by;
+	BoutReal *fp = fv.pencil(xi, yi);
+	const BoutReal *f1 = fv.pencil(xi - bndry->bx, yi - bndry->by);
+	const BoutReal *f2 = fv.pencil(xi - 2*bndry->bx, yi - 2*bndry->by);
+	for(int zk=0;zk<mesh->LocalNz;zk++)
+	  fp[zk] = 2*f1[zk] - f2[zk];
       }
     }
   }
@@ -3004,15 +3209,17 @@ void BoundaryFree_O2::apply(Field3D &f) {
 
 void BoundaryFree_O2::apply_ddt(Field2D &f) {
   Field2D *dt = f.timeDeriv();
-  for(bndry->first(); !bndry->isDone(); bndry->next())
-    (*dt)(bndry->x,bndry->y) = 0.; // Set time derivative to zero
+  BOUT_FOR(i, bndry->getRegion()) {
+    (*dt)(i.x(), i.y()) = 0.; // Set time derivative to zero
+  }
 }
 
 void BoundaryFree_O2::apply_ddt(Field3D &f) {
   Field3D *dt = f.timeDeriv();
-  for(bndry->first(); !bndry->isDone(); bndry->next())
-    for(int z=0;z<mesh->LocalNz;z++)
-      (*dt)(bndry->x,bndry->y,z) = 0.; // Set time derivative to zero
+  BOUT_FOR(i, bndry->getRegion()) {
+    for (int z = 0; z < mesh->LocalNz; z++)
+      (*dt)(i.x(), i.y(), z) = 0.; // Set time derivative to zero
+  }
 
 }
 
@@ -3250,15 +3457,17 @@ void BoundaryFree_O3::apply(Field3D &f) {
 
 void BoundaryFree_O3::apply_ddt(Field2D &f) {
   Field2D *dt = f.timeDeriv();
-  for(bndry->first(); !bndry->isDone(); bndry->next())
-    (*dt)(bndry->x,bndry->y) = 0.; // Set time derivative to zero
+  BOUT_FOR(i, bndry->getRegion()) {
+    (*dt)(i.x(), i.y()) = 0.; // Set time derivative to zero
+  }
 }
 
 void BoundaryFree_O3::apply_ddt(Field3D &f) {
   Field3D *dt = f.timeDeriv();
-  for(bndry->first(); !bndry->isDone(); bndry->next())
-    for(int z=0;z<mesh->LocalNz;z++)
-      (*dt)(bndry->x,bndry->y,z) = 0.; // Set time derivative to zero
+  BOUT_FOR(i, bndry->getRegion()) {
+    for (int z = 0; z < mesh->LocalNz; z++)
+      (*dt)(i.x(), i.y(), z) = 0.; // Set time derivative to zero
+  }
 
 }
 
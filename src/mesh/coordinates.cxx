@@ -7,6 +7,7 @@
 #include <bout/assert.hxx>
 #include <bout/constants.hxx>
 #include <bout/coordinates.hxx>
+#include <boutcomm.hxx>
 #include <msg_stack.hxx>
 #include <output.hxx>
 #include <utils.hxx>
@@ -18,7 +19,8 @@
 #include <globals.hxx>
 
 Coordinates::Coordinates(Mesh *mesh)
-    : dx(1, mesh), dy(1, mesh), dz(1), d1_dx(mesh), d1_dy(mesh), J(1, mesh), Bxy(1, mesh),
+    : dx(1, mesh), dy(1, mesh), dz(1), non_uniform(false), d1_dx(mesh), d1_dy(mesh),
+      J(1, mesh), Bxy(1, mesh),
       // Identity metric tensor
       g11(1, mesh), g22(1, mesh), g33(1, mesh), g12(0, mesh), g13(0, mesh), g23(0, mesh),
       g_11(1, mesh), g_22(1, mesh), g_33(1, mesh), g_12(0, mesh), g_13(0, mesh),
@@ -220,7 +222,8 @@ namespace {
 }
 
 Coordinates::Coordinates(Mesh *mesh, const CELL_LOC loc, const Coordinates* coords_in)
-    : dx(1, mesh), dy(1, mesh), dz(1), d1_dx(mesh), d1_dy(mesh), J(1, mesh), Bxy(1, mesh),
+    : dx(1, mesh), dy(1, mesh), dz(1), non_uniform(false), d1_dx(mesh), d1_dy(mesh),
+      J(1, mesh), Bxy(1, mesh),
       // Identity metric tensor
       g11(1, mesh), g22(1, mesh), g33(1, mesh), g12(0, mesh), g13(0, mesh), g23(0, mesh),
       g_11(1, mesh), g_22(1, mesh), g_33(1, mesh), g_12(0, mesh), g_13(0, mesh),
@@ -311,8 +314,6 @@ void Coordinates::outputVars(Datafile &file) {
 int Coordinates::geometry() {
   TRACE("Coordinates::geometry");
 
-  output_progress.write("Calculating differential geometry terms\n");
-
   if (min(abs(dx)) < 1e-8)
     throw BoutException("dx magnitude less than 1e-8");
 
@@ -343,131 +344,263 @@ int Coordinates::geometry() {
     throw BoutException("\tERROR: Off-diagonal g_ij metrics are not finite!\n");
   }
 
+  // Work out which inputs actually changed since the last call. On
+  // the first call the comparison copies are empty, so everything is
+  // changed. Transport-coupled runs update the equilibrium every
+  // ~1000 steps, often touching only some components: recomputing
+  // just their dependants turns a global recompute-and-communicate
+  // into a targeted one.
+  // Note | not ||, so every comparison copy is brought up to date
+  if (!geometry_inputs) {
+    geometry_inputs.reset(new GeometryInputs(localmesh));
+  }
+  GeometryInputs &last = *geometry_inputs;
+
+  bool spacing = updateChanged(last.dx, dx) | updateChanged(last.dy, dy);
+  if (last.dz != dz) {
+    spacing = true;
+    last.dz = dz;
+  }
+
+  // Contravariant components, appearing undifferentiated
+  bool c11 = updateChanged(last.g11, g11);
+  bool c22 = updateChanged(last.g22, g22);
+  bool c33 = updateChanged(last.g33, g33);
+  bool c12 = updateChanged(last.g12, g12);
+  bool c13 = updateChanged(last.g13, g13);
+  bool c23 = updateChanged(last.g23, g23);
+
+  // Covariant components, appearing differentiated: every Christoffel
+  // row reads derivatives of (almost) all of them, so they are only
+  // tracked individually for the cache invalidation below
+  bool v11 = updateChanged(last.g_11, g_11);
+  bool v22 = updateChanged(last.g_22, g_22);
+  bool v33 = updateChanged(last.g_33, g_33);
+  bool v12 = updateChanged(last.g_12, g_12);
+  bool v13 = updateChanged(last.g_13, g_13);
+  bool v23 = updateChanged(last.g_23, g_23);
+
+  bool jac = updateChanged(last.J, J);
+  bool bxy = updateChanged(last.Bxy, Bxy);
+
+  // The comparisons above only see the local subdomain, but the flags
+  // decide what is recomputed, communicated and early-returned, all
+  // of which must agree across processors: a spatially localized
+  // update must not leave one rank skipping a communicate its
+  // neighbour has entered. OR each flag over all processors
+  int changed[15] = {spacing, c11, c22, c33, c12, c13, c23, v11,
+                     v22,     v33, v12, v13, v23, jac, bxy};
+  MPI_Allreduce(MPI_IN_PLACE, changed, 15, MPI_INT, MPI_LOR, BoutComm::get());
+  spacing = changed[0] != 0;
+  c11 = changed[1] != 0;
+  c22 = changed[2] != 0;
+  c33 = changed[3] != 0;
+  c12 = changed[4] != 0;
+  c13 = changed[5] != 0;
+  c23 = changed[6] != 0;
+  v11 = changed[7] != 0;
+  v22 = changed[8] != 0;
+  v33 = changed[9] != 0;
+  v12 = changed[10] != 0;
+  v13 = changed[11] != 0;
+  v23 = changed[12] != 0;
+  jac = changed[13] != 0;
+  bxy = changed[14] != 0;
+
+  const bool cov = v11 || v22 || v33 || v12 || v13 || v23;
+
+  // Christoffel rows Gi_jk combine row i of the contravariant metric
+  // with covariant derivatives
+  const bool row1 = spacing || cov || c11 || c12 || c13;
+  const bool row2 = spacing || cov || c12 || c22 || c23;
+  const bool row3 = spacing || cov || c13 || c23 || c33;
+
+  // Divergence terms Gi read J and contravariant row i
+  const bool div1 = spacing || jac || c11 || c12 || c13;
+  const bool div2 = spacing || jac || c12 || c22 || c23;
+  const bool div3 = spacing || jac || c13 || c23 || c33;
+
+  if (!(row1 || row2 || row3 || div1 || div2 || div3 || bxy)) {
+    output_progress.write("\tGeometry unchanged; keeping cached terms\n");
+    return 0;
+  }
+  geometry_generation++;
+
+  output_progress.write("Calculating differential geometry terms\n");
+
+  // Selective invalidation of the cached operator coefficients: only
+  // those reading a changed component are dropped
+  if (v22) {
+    invSgCache.reset();
+  }
+  if (v22 || spacing) {
+    Grad2_par2_DDY_invSgCache.clear();
+    gradParCoefCache.reset();
+  }
+  if (c11 || c33 || c13 || spacing) {
+    delp2Cache.reset();
+  }
+  if (spacing) {
+    stencilCache.reset();
+  }
+  if (spacing || jac || bxy || v12 || v22 || v23) {
+    packedCache.clear();
+  }
+
   // Calculate Christoffel symbol terms (18 independent values)
   // Note: This calculation is completely general: metric
   // tensor can be 2D or 3D. For 2D, all DDZ terms are zero
 
-  G1_11 = 0.5 * g11 * DDX(g_11) + g12 * (DDX(g_12) - 0.5 * DDY(g_11)) +
-          g13 * (DDX(g_13) - 0.5 * DDZ(g_11));
-  G1_22 = g11 * (DDY(g_12) - 0.5 * DDX(g_22)) + 0.5 * g12 * DDY(g_22) +
-          g13 * (DDY(g_23) - 0.5 * DDZ(g_22));
-  G1_33 = g11 * (DDZ(g_13) - 0.5 * DDX(g_33)) + g12 * (DDZ(g_23) - 0.5 * DDY(g_33)) +
-          0.5 * g13 * DDZ(g_33);
-  G1_12 = 0.5 * g11 * DDY(g_11) + 0.5 * g12 * DDX(g_22) +
-          0.5 * g13 * (DDY(g_13) + DDX(g_23) - DDZ(g_12));
-  G1_13 = 0.5 * g11 * DDZ(g_11) + 0.5 * g12 * (DDZ(g_12) + DDX(g_23) - DDY(g_13)) +
-          0.5 * g13 * DDX(g_33);
-  G1_23 = 0.5 * g11 * (DDZ(g_12) + DDY(g_13) - DDX(g_23)) +
-          0.5 * g12 * (DDZ(g_22) + DDY(g_23) - DDY(g_23))
-          // + 0.5 *g13*(DDZ(g_32) + DDY(g_33) - DDZ(g_23));
-          // which equals
-          + 0.5 * g13 * DDY(g_33);
-
-  G2_11 = 0.5 * g12 * DDX(g_11) + g22 * (DDX(g_12) - 0.5 * DDY(g_11)) +
-          g23 * (DDX(g_13) - 0.5 * DDZ(g_11));
-  G2_22 = g12 * (DDY(g_12) - 0.5 * DDX(g_22)) + 0.5 * g22 * DDY(g_22) +
-          g23 * (DDY(g23) - 0.5 * DDZ(g_22));
-  G2_33 = g12 * (DDZ(g_13) - 0.5 * DDX(g_33)) + g22 * (DDZ(g_23) - 0.5 * DDY(g_33)) +
-          0.5 * g23 * DDZ(g_33);
-  G2_12 = 0.5 * g12 * DDY(g_11) + 0.5 * g22 * DDX(g_22) +
-          0.5 * g23 * (DDY(g_13) + DDX(g_23) - DDZ(g_12));
-  G2_13 =
-      // 0.5 *g21*(DDZ(g_11) + DDX(g_13) - DDX(g_13))
-      // which equals
-      0.5 * g12 * (DDZ(g_11) + DDX(g_13) - DDX(g_13))
-      // + 0.5 *g22*(DDZ(g_21) + DDX(g_23) - DDY(g_13))
-      // which equals
-      + 0.5 * g22 * (DDZ(g_12) + DDX(g_23) - DDY(g_13))
-      // + 0.5 *g23*(DDZ(g_31) + DDX(g_33) - DDZ(g_13));
-      // which equals
-      + 0.5 * g23 * DDX(g_33);
-  G2_23 = 0.5 * g12 * (DDZ(g_12) + DDY(g_13) - DDX(g_23)) + 0.5 * g22 * DDZ(g_22) +
-          0.5 * g23 * DDY(g_33);
-
-  G3_11 = 0.5 * g13 * DDX(g_11) + g23 * (DDX(g_12) - 0.5 * DDY(g_11)) +
-          g33 * (DDX(g_13) - 0.5 * DDZ(g_11));
-  G3_22 = g13 * (DDY(g_12) - 0.5 * DDX(g_22)) + 0.5 * g23 * DDY(g_22) +
-          g33 * (DDY(g_23) - 0.5 * DDZ(g_22));
-  G3_33 = g13 * (DDZ(g_13) - 0.5 * DDX(g_33)) + g23 * (DDZ(g_23) - 0.5 * DDY(g_33)) +
-          0.5 * g33 * DDZ(g_33);
-  G3_12 =
-      // 0.5 *g31*(DDY(g_11) + DDX(g_12) - DDX(g_12))
-      // which equals to
-      0.5 * g13 * DDY(g_11)
-      // + 0.5 *g32*(DDY(g_21) + DDX(g_22) - DDY(g_12))
-      // which equals to
-      + 0.5 * g23 * DDX(g_22)
-      //+ 0.5 *g33*(DDY(g_31) + DDX(g_32) - DDZ(g_12));
-      // which equals to
-      + 0.5 * g33 * (DDY(g_13) + DDX(g_23) - DDZ(g_12));
-  G3_13 = 0.5 * g13 * DDZ(g_11) + 0.5 * g23 * (DDZ(g_12) + DDX(g_23) - DDY(g_13)) +
-          0.5 * g33 * DDX(g_33);
-  G3_23 = 0.5 * g13 * (DDZ(g_12) + DDY(g_13) - DDX(g_23)) + 0.5 * g23 * DDZ(g_22) +
-          0.5 * g33 * DDY(g_33);
-
-  G1 = (DDX(J * g11) + DDY(J * g12) + DDZ(J * g13)) / J;
-  G2 = (DDX(J * g12) + DDY(J * g22) + DDZ(J * g23)) / J;
-  G3 = (DDX(J * g13) + DDY(J * g23) + DDZ(J * g33)) / J;
-
-  // Communicate christoffel symbol terms
+  if (row1) {
+    G1_11 = 0.5 * g11 * DDX(g_11) + g12 * (DDX(g_12) - 0.5 * DDY(g_11)) +
+            g13 * (DDX(g_13) - 0.5 * DDZ(g_11));
+    G1_22 = g11 * (DDY(g_12) - 0.5 * DDX(g_22)) + 0.5 * g12 * DDY(g_22) +
+            g13 * (DDY(g_23) - 0.5 * DDZ(g_22));
+    G1_33 = g11 * (DDZ(g_13) - 0.5 * DDX(g_33)) + g12 * (DDZ(g_23) - 0.5 * DDY(g_33)) +
+            0.5 * g13 * DDZ(g_33);
+    G1_12 = 0.5 * g11 * DDY(g_11) + 0.5 * g12 * DDX(g_22) +
+            0.5 * g13 * (DDY(g_13) + DDX(g_23) - DDZ(g_12));
+    G1_13 = 0.5 * g11 * DDZ(g_11) + 0.5 * g12 * (DDZ(g_12) + DDX(g_23) - DDY(g_13)) +
+            0.5 * g13 * DDX(g_33);
+    G1_23 = 0.5 * g11 * (DDZ(g_12) + DDY(g_13) - DDX(g_23)) +
+            0.5 * g12 * (DDZ(g_22) + DDY(g_23) - DDY(g_23))
+            // + 0.5 *g13*(DDZ(g_32) + DDY(g_33) - DDZ(g_23));
+            // which equals
+            + 0.5 * g13 * DDY(g_33);
+  }
+
+  if (row2) {
+    G2_11 = 0.5 * g12 * DDX(g_11) + g22 * (DDX(g_12) - 0.5 * DDY(g_11)) +
+            g23 * (DDX(g_13) - 0.5 * DDZ(g_11));
+    G2_22 = g12 * (DDY(g_12) - 0.5 * DDX(g_22)) + 0.5 * g22 * DDY(g_22) +
+            g23 * (DDY(g23) - 0.5 * DDZ(g_22));
+    G2_33 = g12 * (DDZ(g_13) - 0.5 * DDX(g_33)) + g22 * (DDZ(g_23) - 0.5 * DDY(g_33)) +
+            0.5 * g23 * DDZ(g_33);
+    G2_12 = 0.5 * g12 * DDY(g_11) + 0.5 * g22 * DDX(g_22) +
+            0.5 * g23 * (DDY(g_13) + DDX(g_23) - DDZ(g_12));
+    G2_13 =
+        // 0.5 *g21*(DDZ(g_11) + DDX(g_13) - DDX(g_13))
+        // which equals
+        0.5 * g12 * (DDZ(g_11) + DDX(g_13) - DDX(g_13))
+        // + 0.5 *g22*(DDZ(g_21) + DDX(g_23) - DDY(g_13))
+        // which equals
+        + 0.5 * g22 * (DDZ(g_12) + DDX(g_23) - DDY(g_13))
+        // + 0.5 *g23*(DDZ(g_31) + DDX(g_33) - DDZ(g_13));
+        // which equals
+        + 0.5 * g23 * DDX(g_33);
+    G2_23 = 0.5 * g12 * (DDZ(g_12) + DDY(g_13) - DDX(g_23)) + 0.5 * g22 * DDZ(g_22) +
+            0.5 * g23 * DDY(g_33);
+  }
+
+  if (row3) {
+    G3_11 = 0.5 * g13 * DDX(g_11) + g23 * (DDX(g_12) - 0.5 * DDY(g_11)) +
+            g33 * (DDX(g_13) - 0.5 * DDZ(g_11));
+    G3_22 = g13 * (DDY(g_12) - 0.5 * DDX(g_22)) + 0.5 * g23 * DDY(g_22) +
+            g33 * (DDY(g_23) - 0.5 * DDZ(g_22));
+    G3_33 = g13 * (DDZ(g_13) - 0.5 * DDX(g_33)) + g23 * (DDZ(g_23) - 0.5 * DDY(g_33)) +
+            0.5 * g33 * DDZ(g_33);
+    G3_12 =
+        // 0.5 *g31*(DDY(g_11) + DDX(g_12) - DDX(g_12))
+        // which equals to
+        0.5 * g13 * DDY(g_11)
+        // + 0.5 *g32*(DDY(g_21) + DDX(g_22) - DDY(g_12))
+        // which equals to
+        + 0.5 * g23 * DDX(g_22)
+        //+ 0.5 *g33*(DDY(g_31) + DDX(g_32) - DDZ(g_12));
+        // which equals to
+        + 0.5 * g33 * (DDY(g_13) + DDX(g_23) - DDZ(g_12));
+    G3_13 = 0.5 * g13 * DDZ(g_11) + 0.5 * g23 * (DDZ(g_12) + DDX(g_23) - DDY(g_13)) +
+            0.5 * g33 * DDX(g_33);
+    G3_23 = 0.5 * g13 * (DDZ(g_12) + DDY(g_13) - DDX(g_23)) + 0.5 * g23 * DDZ(g_22) +
+            0.5 * g33 * DDY(g_33);
+  }
+
+  if (div1) {
+    G1 = (DDX(J * g11) + DDY(J * g12) + DDZ(J * g13)) / J;
+  }
+  if (div2) {
+    G2 = (DDX(J * g12) + DDY(J * g22) + DDZ(J * g23)) / J;
+  }
+  if (div3) {
+    G3 = (DDX(J * g13) + DDY(J * g23) + DDZ(J * g33)) / J;
+  }
+
+  // Communicate the recalculated christoffel symbol terms
   output_progress.write("\tCommunicating connection terms\n");
 
   FieldGroup com;
 
-  com.add(G1_11);
-  com.add(G1_22);
-  com.add(G1_33);
-  com.add(G1_12);
-  com.add(G1_13);
-  com.add(G1_23);
-
-  com.add(G2_11);
-  com.add(G2_22);
-  com.add(G2_33);
-  com.add(G2_12);
-  com.add(G2_13);
-  com.add(G2_23);
-
-  com.add(G3_11);
-  com.add(G3_22);
-  com.add(G3_33);
-  com.add(G3_12);
-  com.add(G3_13);
-  com.add(G3_23);
-
-  com.add(G1);
-  com.add(G2);
-  com.add(G3);
+  if (row1) {
+    com.add(G1_11);
+    com.add(G1_22);
+    com.add(G1_33);
+    com.add(G1_12);
+    com.add(G1_13);
+    com.add(G1_23);
+  }
+
+  if (row2) {
+    com.add(G2_11);
+    com.add(G2_22);
+    com.add(G2_33);
+    com.add(G2_12);
+    com.add(G2_13);
+    com.add(G2_23);
+  }
+
+  if (row3) {
+    com.add(G3_11);
+    com.add(G3_22);
+    com.add(G3_33);
+    com.add(G3_12);
+    com.add(G3_13);
+    com.add(G3_23);
+  }
+
+  if (div1)
+    com.add(G1);
+  if (div2)
+    com.add(G2);
+  if (div3)
+    com.add(G3);
 
   localmesh->communicate(com);
 
   //////////////////////////////////////////////////////
   /// Non-uniform meshes. Need to use DDX, DDY
+  /// Only depends on the grid spacing, so skipped when that is unchanged
 
-  OPTION(Options::getRoot(), non_uniform, true);
+  if (spacing) {
+    OPTION(Options::getRoot(), non_uniform, true);
 
-  Field2D d2x(localmesh), d2y(localmesh); // d^2 x / d i^2
-  // Read correction for non-uniform meshes
-  if (localmesh->get(d2x, "d2x")) {
-    output_warn.write(
-        "\tWARNING: differencing quantity 'd2x' not found. Calculating from dx\n");
-    d1_dx = localmesh->indexDDX(1. / dx); // d/di(1/dx)
-  } else {
-    // Shift d2x to our location
-    d2x = interp_to(d2x, location);
+    Field2D d2x(localmesh), d2y(localmesh); // d^2 x / d i^2
+    // Read correction for non-uniform meshes
+    if (localmesh->get(d2x, "d2x")) {
+      output_warn.write(
+          "\tWARNING: differencing quantity 'd2x' not found. Calculating from dx\n");
+      d1_dx = localmesh->indexDDX(1. / dx); // d/di(1/dx)
+    } else {
+      // Shift d2x to our location
+      d2x = interp_to(d2x, location);
 
-    d1_dx = -d2x / (dx * dx);
-  }
+      d1_dx = -d2x / (dx * dx);
+    }
 
-  if (localmesh->get(d2y, "d2y")) {
-    output_warn.write(
-        "\tWARNING: differencing quantity 'd2y' not found. Calculating from dy\n");
-    d1_dy = localmesh->indexDDY(1. / dy); // d/di(1/dy)
-  } else {
-    // Shift d2y to our location
-    d2y = interp_to(d2y, location);
+    if (localmesh->get(d2y, "d2y")) {
+      output_warn.write(
+          "\tWARNING: differencing quantity 'd2y' not found. Calculating from dy\n");
+      d1_dy = localmesh->indexDDY(1. / dy); // d/di(1/dy)
+    } else {
+      // Shift d2y to our location
+      d2y = interp_to(d2y, location);
 
-    d1_dy = -d2y / (dy * dy);
+      d1_dy = -d2y / (dy * dy);
+    }
+
+    // d1_dx/d1_dy feed the stencil coefficient tables, so any cache
+    // built by the derivative calls above is out of date
+    stencilCache.reset();
+    gradParCoefCache.reset();
   }
 
   if (location == CELL_CENTRE) {
@@ -478,6 +611,37 @@ int Coordinates::geometry() {
   return 0;
 }
 
+bool Coordinates::updateChanged(Field2D &cache, const Field2D &val) {
+  // Same scheme as Laplacian::updateCoefCache: after a value compare
+  // finds the fields equal, share the data so the next call is a
+  // pointer compare
+  ASSERT1(val.isAllocated());
+
+  if (cache.isAllocated()) {
+    if (&cache(0, 0) == &val(0, 0)) {
+      return false; // Still sharing data with the comparison copy: unchanged
+    }
+    Mesh *mesh = val.getMesh();
+    if (cache.getMesh() == mesh) {
+      int n = mesh->LocalNx * mesh->LocalNy;
+      const BoutReal *c = &cache(0, 0);
+      const BoutReal *v = &val(0, 0);
+      int i;
+      for (i = 0; i < n; i++) {
+        if (c[i] != v[i])
+          break;
+      }
+      if (i == n) {
+        cache = val;
+        return false;
+      }
+    }
+  }
+
+  cache = val;
+  return true;
+}
+
 int Coordinates::calcCovariant() {
   TRACE("Coordinates::calcCovariant");
 
@@ -640,12 +804,12 @@ int Coordinates::jacobian() {
 
 const Field2D Coordinates::DDX(const Field2D &f, CELL_LOC loc, DIFF_METHOD method, REGION region) {
   ASSERT1(location == loc || loc == CELL_DEFAULT);
-  return localmesh->indexDDX(f, loc, method, region) / dx;
+  return localmesh->indexDDX(f, loc, method, region) * stencilCoefs().ddx;
 }
 
 const Field2D Coordinates::DDY(const Field2D &f, CELL_LOC loc, DIFF_METHOD method, REGION region) {
   ASSERT1(location == loc || loc == CELL_DEFAULT);
-  return localmesh->indexDDY(f, loc, method, region) / dy;
+  return localmesh->indexDDY(f, loc, method, region) * stencilCoefs().ddy;
 }
 
 const Field2D Coordinates::DDZ(MAYBE_UNUSED(const Field2D &f), MAYBE_UNUSED(CELL_LOC loc),
@@ -667,7 +831,7 @@ const Field2D Coordinates::Grad_par(const Field2D &var, MAYBE_UNUSED(CELL_LOC ou
   TRACE("Coordinates::Grad_par( Field2D )");
   ASSERT1(location == outloc || (outloc == CELL_DEFAULT && location == var.getLocation()));
 
-  return DDY(var) / sqrt(g_22);
+  return DDY(var) * invSg();
 }
 
 const Field3D Coordinates::Grad_par(const Field3D &var, CELL_LOC outloc,
@@ -675,7 +839,15 @@ const Field3D Coordinates::Grad_par(const Field3D &var, CELL_LOC outloc,
   TRACE("Coordinates::Grad_par( Field3D )");
   ASSERT1(location == outloc || outloc == CELL_DEFAULT);
 
-  return ::DDY(var, outloc, method) / sqrt(g_22);
+  if (method == DIFF_DEFAULT) {
+    // Single-sweep path: the index-space Y stencil (staggered or not)
+    // and the cached 1/(dy*sqrt(g_22)) coefficient are applied in one
+    // pass over var, instead of a derivative sweep followed by two
+    // scaling sweeps
+    return localmesh->indexDDY_scaled(var, gradParCoef(), outloc);
+  }
+
+  return ::DDY(var, outloc, method) * invSg();
 }
 
 /////////////////////////////////////////////////////////
@@ -686,13 +858,13 @@ const Field2D Coordinates::Vpar_Grad_par(const Field2D &v, const Field2D &f,
                                          MAYBE_UNUSED(CELL_LOC outloc),
                                          DIFF_METHOD UNUSED(method)) {
   ASSERT1(location == outloc || (outloc == CELL_DEFAULT && location == f.getLocation()));
-  return VDDY(v, f) / sqrt(g_22);
+  return VDDY(v, f) * invSg();
 }
 
 const Field3D Coordinates::Vpar_Grad_par(const Field3D &v, const Field3D &f, CELL_LOC outloc,
                                          DIFF_METHOD method) {
   ASSERT1(location == outloc || outloc == CELL_DEFAULT);
-  return VDDY(v, f, outloc, method) / sqrt(g_22);
+  return VDDY(v, f, outloc, method) * invSg();
 }
 
 /////////////////////////////////////////////////////////
@@ -747,8 +919,8 @@ const Field2D Coordinates::Grad2_par2(const Field2D &f, CELL_LOC outloc, DIFF_ME
   TRACE("Coordinates::Grad2_par2( Field2D )");
   ASSERT1(location == outloc || (outloc == CELL_DEFAULT && location == f.getLocation()));
 
-  Field2D sg = sqrt(g_22);
-  Field2D result = DDY(1. / sg, outloc, method) * DDY(f, outloc, method) / sg + D2DY2(f, outloc, method) / g_22;
+  Field2D result = Grad2_par2_DDY_invSg(outloc, method) * DDY(f, outloc, method)
+                   + D2DY2(f, outloc, method) / g_22;
 
   return result;
 }
@@ -760,18 +932,30 @@ const Field3D Coordinates::Grad2_par2(const Field3D &f, CELL_LOC outloc, DIFF_ME
   }
   ASSERT1(location == outloc);
 
-  Field2D sg(localmesh);
-  Field3D result(localmesh), r2(localmesh);
-
-  sg = sqrt(g_22);
-  sg = DDY(1. / sg, outloc, method) / sg;
+  if ((method == DIFF_DEFAULT) && (f.getLocation() == outloc)) {
+    // Single-sweep path: fold all the geometric factors into 2D
+    // coefficients of the two index-space Y derivatives, then evaluate
+    //   coef1 * DDY(f) + coef2 * D2DY2(f)
+    // in one pass over f instead of one pass per derivative plus the
+    // combines. Restricted to the default method because the
+    // non-uniform correction inside D2DY2 always uses the default DDY,
+    // and to matching locations because indexDDY_D2DY2 does not
+    // stagger
+    Field2D coef2 = 1. / (SQ(dy) * g_22);
+    Field2D coef1 = Grad2_par2_DDY_invSg(outloc, method) / dy;
+    if (non_uniform) {
+      coef1 += d1_dy * dy * coef2; // d1_dy / (dy * g_22)
+    }
+    return localmesh->indexDDY_D2DY2(f, coef1, coef2, outloc);
+  }
 
+  Field3D result(localmesh), r2(localmesh);
 
   result = ::DDY(f, outloc, method);
 
   r2 = D2DY2(f, outloc, method) / g_22;
 
-  result = sg * result + r2;
+  result = Grad2_par2_DDY_invSg(outloc, method) * result + r2;
 
   ASSERT2(result.getLocation() == outloc);
 
@@ -813,6 +997,10 @@ const Field3D Coordinates::Delp2(const Field3D &f, CELL_LOC outloc) {
 
   int ncz = localmesh->LocalNz;
 
+  // The fused tridiagonal coefficients, combined from the metrics once
+  // and reused for every solve
+  const Delp2Coefs &dc = delp2Coefs();
+
   // Allocate memory
   auto ft = Matrix<dcomplex>(localmesh->LocalNx, ncz / 2 + 1);
   auto delft = Matrix<dcomplex>(localmesh->LocalNx, ncz / 2 + 1);
@@ -827,13 +1015,15 @@ const Field3D Coordinates::Delp2(const Field3D &f, CELL_LOC outloc) {
 
     // Loop over kz
     for (int jz = 0; jz <= ncz / 2; jz++) {
-      dcomplex a, b, c;
+      const BoutReal kwave = jz * 2.0 * PI / zlength(); // wave number is 1/[rad]
 
       // No smoothing in the x direction
       for (int jx = localmesh->xstart; jx <= localmesh->xend; jx++) {
         // Perform x derivative
 
-        laplace_tridag_coefs(jx, jy, jz, a, b, c, nullptr, nullptr, outloc);
+        dcomplex a(dc.a_re(jx, jy), -kwave * dc.c3(jx, jy));
+        dcomplex b(dc.b0(jx, jy) - SQ(kwave) * dc.c2(jx, jy), kwave * dc.c5(jx, jy));
+        dcomplex c(dc.c_re(jx, jy), kwave * dc.c3(jx, jy));
 
         delft(jx, jz) = a * ft(jx - 1, jz) + b * ft(jx, jz) + c * ft(jx + 1, jz);
       }
@@ -878,6 +1068,8 @@ const FieldPerp Coordinates::Delp2(const FieldPerp &f, CELL_LOC outloc) {
 
   int ncz = localmesh->LocalNz;
 
+  const Delp2Coefs &dc = delp2Coefs();
+
   // Allocate memory
   auto ft = Matrix<dcomplex>(localmesh->LocalNx, ncz / 2 + 1);
   auto delft = Matrix<dcomplex>(localmesh->LocalNx, ncz / 2 + 1);
@@ -888,13 +1080,15 @@ const FieldPerp Coordinates::Delp2(const FieldPerp &f, CELL_LOC outloc) {
 
   // Loop over kz
   for (int jz = 0; jz <= ncz / 2; jz++) {
+    const BoutReal kwave = jz * 2.0 * PI / zlength(); // wave number is 1/[rad]
 
     // No smoothing in the x direction
     for (int jx = 2; jx < (localmesh->LocalNx - 2); jx++) {
       // Perform x derivative
 
-      dcomplex a, b, c;
-      laplace_tridag_coefs(jx, jy, jz, a, b, c);
+      dcomplex a(dc.a_re(jx, jy), -kwave * dc.c3(jx, jy));
+      dcomplex b(dc.b0(jx, jy) - SQ(kwave) * dc.c2(jx, jy), kwave * dc.c5(jx, jy));
+      dcomplex c(dc.c_re(jx, jy), kwave * dc.c3(jx, jy));
 
       delft(jx, jz) = a * ft(jx - 1, jz) + b * ft(jx, jz) + c * ft(jx + 1, jz);
     }
@@ -914,6 +1108,137 @@ const FieldPerp Coordinates::Delp2(const FieldPerp &f, CELL_LOC outloc) {
   return result;
 }
 
+/////////////////////////////////////////////////////////
+// Cached fused operator coefficients
+//
+// These are built lazily on first use and invalidated by geometry(),
+// so in steady state the hot operators above just stream precombined
+// arrays.
+
+const Coordinates::PackedMetric *Coordinates::packedMetrics() {
+  if (!packedCache.empty())
+    return packedCache.data();
+
+  const int nx = localmesh->LocalNx;
+  const int ny = localmesh->LocalNy;
+  packedCache.resize(static_cast<std::size_t>(nx) * ny);
+
+  for (int jx = 0; jx < nx; jx++) {
+    for (int jy = 0; jy < ny; jy++) {
+      PackedMetric &m = packedCache[jx * ny + jy];
+      m.dx = dx(jx, jy);
+      m.dy = dy(jx, jy);
+      m.J = J(jx, jy);
+      m.Bxy = Bxy(jx, jy);
+      m.g_12 = g_12(jx, jy);
+      m.g_22 = g_22(jx, jy);
+      m.g_23 = g_23(jx, jy);
+      m.inv_J_sqrtg22 = 1.0 / (J(jx, jy) * sqrt(g_22(jx, jy)));
+    }
+  }
+  return packedCache.data();
+}
+
+const Field2D &Coordinates::invSg() {
+  if (!invSgCache) {
+    invSgCache.reset(new Field2D(1. / sqrt(g_22)));
+  }
+  return *invSgCache;
+}
+
+const Field2D &Coordinates::gradParCoef() {
+  if (!gradParCoefCache) {
+    // The same inverse spacing that ::DDY applies to the index-space
+    // derivative, combined with the 1/sqrt(g_22) of Grad_par
+    gradParCoefCache.reset(new Field2D(stencilCoefs().ddy * invSg()));
+  }
+  return *gradParCoefCache;
+}
+
+const Field2D &Coordinates::Grad2_par2_DDY_invSg(CELL_LOC outloc, DIFF_METHOD method) {
+  auto it = Grad2_par2_DDY_invSgCache.find(method);
+  if (it != Grad2_par2_DDY_invSgCache.end())
+    return it->second;
+
+  // Communicate and cache DDY(1/sqrt(g_22))/sqrt(g_22)
+  Field2D &cached = Grad2_par2_DDY_invSgCache[method];
+  cached = DDY(invSg(), outloc, method) * invSg();
+  return cached;
+}
+
+const Coordinates::Delp2Coefs &Coordinates::delp2Coefs() {
+  if (delp2Cache)
+    return *delp2Cache;
+
+  std::unique_ptr<Delp2Coefs> coefs(new Delp2Coefs(localmesh));
+  coefs->a_re.setLocation(location);
+  coefs->c_re.setLocation(location);
+  coefs->b0.setLocation(location);
+  coefs->c2.setLocation(location);
+  coefs->c3.setLocation(location);
+  coefs->c5.setLocation(location);
+  coefs->a_re.allocate();
+  coefs->c_re.allocate();
+  coefs->b0.allocate();
+  coefs->c2.allocate();
+  coefs->c3.allocate();
+  coefs->c5.allocate();
+
+  // The tridiagonal coefficients depend on the mode number only through
+  // kwave: a = (a_re, -kwave*c3), b = (b0 - kwave^2*c2, kwave*c5),
+  // c = (c_re, kwave*c3). Two calls to laplace_tridag_coefs, at kz = 0
+  // and kz = 1, are enough to separate out the per-point factors while
+  // picking up all its options (all_terms, nonuniform, IncIntShear)
+  const BoutReal kwave1 = 2.0 * PI / zlength(); // wave number of the kz = 1 mode
+
+  for (int jx = 0; jx < localmesh->LocalNx; jx++) {
+    for (int jy = 0; jy < localmesh->LocalNy; jy++) {
+      dcomplex a0, b0, c0, a1, b1, c1;
+      laplace_tridag_coefs(jx, jy, 0, a0, b0, c0, nullptr, nullptr, location);
+      laplace_tridag_coefs(jx, jy, 1, a1, b1, c1, nullptr, nullptr, location);
+
+      coefs->a_re(jx, jy) = a0.real();
+      coefs->c_re(jx, jy) = c0.real();
+      coefs->b0(jx, jy) = b0.real();
+      coefs->c2(jx, jy) = (b0.real() - b1.real()) / SQ(kwave1);
+      coefs->c3(jx, jy) = -a1.imag() / kwave1;
+      coefs->c5(jx, jy) = b1.imag() / kwave1;
+    }
+  }
+
+  delp2Cache = std::move(coefs);
+  return *delp2Cache;
+}
+
+const Coordinates::StencilCoefs &Coordinates::stencilCoefs() {
+  if (stencilCache)
+    return *stencilCache;
+
+  std::unique_ptr<StencilCoefs> coefs(new StencilCoefs(localmesh));
+  coefs->ddx = 1. / dx;
+  coefs->ddy = 1. / dy;
+  coefs->d2dx2 = 1. / SQ(dx);
+  coefs->d2dy2 = 1. / SQ(dy);
+  if (non_uniform && d1_dx.isAllocated() && d1_dy.isAllocated()) {
+    // d1_dx/d1_dy are only available once geometry() has run; the
+    // derivative calls inside geometry() itself (before they are set)
+    // only use the first-derivative tables, and geometry() invalidates
+    // this cache again once the corrections are known
+    coefs->d2dx2_corr = d1_dx / dx;
+    coefs->d2dy2_corr = d1_dy / dy;
+  } else {
+    // No correction on a uniform mesh; keep the tables usable either
+    // way so consumers don't need to branch per point
+    coefs->d2dx2_corr = Field2D(0., localmesh);
+    coefs->d2dy2_corr = Field2D(0., localmesh);
+    coefs->d2dx2_corr.setLocation(location);
+    coefs->d2dy2_corr.setLocation(location);
+  }
+
+  stencilCache = std::move(coefs);
+  return *stencilCache;
+}
+
 const Field2D Coordinates::Laplace_par(const Field2D &f, CELL_LOC outloc) {
   ASSERT1(location == outloc || outloc == CELL_DEFAULT);
   return D2DY2(f, outloc) / g_22 + DDY(J / g_22, outloc) * DDY(f, outloc) / J;
@@ -1,7 +1,9 @@
 
 #include <bout/griddata.hxx>
 
+#include <boutcomm.hxx>
 #include <msg_stack.hxx>
+#include <options.hxx>
 #include <bout/sys/timer.hxx>
 
 #include <boutexception.hxx>
@@ -34,6 +36,11 @@ GridFile::GridFile(std::unique_ptr<DataFormat> format, string gridfilename)
 
   file->setGlobalOrigin(); // Set default global origin
 
+  // In broadcast mode only processor 0 reads metadata and data; the
+  // rest receive it over MPI instead of all issuing identical reads
+  // to the filesystem
+  Options::getRoot()->getSection("mesh")->get("broadcast_read", broadcast_read, false);
+  MPI_Comm_rank(BoutComm::get(), &mype);
 }
 
 GridFile::~GridFile() {
@@ -52,12 +59,36 @@ bool GridFile::hasVar(const string &name) {
   }
   
   /// Get the size of the variable
-  vector<int> s = file->getSize(name);
+  vector<int> s = varSize(name);
   
   /// Test if the variable has zero size
   return s.size() != 0;
 }
 
+/*!
+ * Get the dimensions of a variable. In broadcast mode the query is
+ * made on processor 0 only and the result broadcast, since metadata
+ * reads are as contended as data reads at scale.
+ */
+std::vector<int> GridFile::varSize(const string &name) {
+  if (!broadcast_read) {
+    return file->getSize(name);
+  }
+
+  int ndims = 0;
+  vector<int> s;
+  if (mype == 0) {
+    s = file->getSize(name);
+    ndims = static_cast<int>(s.size());
+  }
+  MPI_Bcast(&ndims, 1, MPI_INT, 0, BoutComm::get());
+  s.resize(ndims);
+  if (ndims > 0) {
+    MPI_Bcast(s.data(), ndims, MPI_INT, 0, BoutComm::get());
+  }
+  return s;
+}
+
 /*!
  * Read a single integer from file. If the integer is not
  * found, then ival is set to zero and false is returned.
@@ -87,7 +118,18 @@ bool GridFile::get(Mesh *UNUSED(m), int &ival,      const string &name) {
     throw BoutException("File cannot be read");
   }
   
-  bool success = file->read(&ival, name);
+  bool success;
+  if (broadcast_read) {
+    int buf[2] = {0, 0}; // {success, value}
+    if (mype == 0) {
+      buf[0] = file->read(&buf[1], name) ? 1 : 0;
+    }
+    MPI_Bcast(buf, 2, MPI_INT, 0, BoutComm::get());
+    success = (buf[0] != 0);
+    ival = buf[1];
+  } else {
+    success = file->read(&ival, name);
+  }
   if (success) {
     output_info << "\tOption " << name  << " = " << ival << " (" << filename <<")" << endl;
   }
@@ -107,7 +149,18 @@ bool GridFile::get(Mesh *UNUSED(m), BoutReal &rval, const string &name) {
   if (!file->is_valid()) {
     throw BoutException("File cannot be read");
   }
-  bool success = file->read(&rval, name);
+  bool success;
+  if (broadcast_read) {
+    int ok = 0;
+    if (mype == 0) {
+      ok = file->read(&rval, name) ? 1 : 0;
+    }
+    MPI_Bcast(&ok, 1, MPI_INT, 0, BoutComm::get());
+    MPI_Bcast(&rval, 1, BOUT_MPI_REAL, 0, BoutComm::get());
+    success = (ok != 0);
+  } else {
+    success = file->read(&rval, name);
+  }
   if (success) {
     output_info << "\tOption " << name  << " = " << rval << " (" << filename <<")" << endl;
   }
@@ -128,6 +181,11 @@ bool GridFile::get(Mesh *m, Field2D &var,   const string &name, BoutReal def) {
   if (!file->is_valid()) {
     throw BoutException("Could not read '%s' from file: File cannot be read", name.c_str());
   }
+
+  if (broadcast_read) {
+    return getField2DBroadcast(m, var, name, def);
+  }
+
   vector<int> size = file->getSize(name);
   
   switch(size.size()) {
@@ -232,6 +290,132 @@ bool GridFile::get(Mesh *m, Field2D &var,   const string &name, BoutReal def) {
   return true;
 }
 
+/*!
+ * Rank-0 read and broadcast of a 2D variable.
+ *
+ * Processor 0 reads the whole variable in one contiguous read
+ * (coalescing the per-processor hyperslab reads), broadcasts it, and
+ * every processor copies out its own part. The filesystem sees one
+ * reader regardless of the number of processors.
+ */
+bool GridFile::getField2DBroadcast(Mesh *m, Field2D &var, const string &name,
+                                   BoutReal def) {
+  MPI_Comm comm = BoutComm::get();
+
+  vector<int> size = varSize(name);
+
+  switch(size.size()) {
+  case 0: {
+    // Variable not found
+    output_warn.write("\tWARNING: Could not read '%s' from grid. Setting to %le\n", name.c_str(), def);
+    var = def;
+    return false;
+  }
+  case 1: {
+    // 0 or 1 dimension
+    if (size[0] != 1) {
+      throw BoutException("Expecting a 2D variable, but '%s' is 1D with %d elements\n", name.c_str(), size[0]);
+    }
+    BoutReal rval;
+    if (!get(m, rval, name)) {
+      throw BoutException("Couldn't read 0D variable '%s'\n", name.c_str());
+    }
+    var = rval;
+    return true;
+  }
+  case 2: {
+    break;
+  }
+  default: {
+    output_warn.write("WARNING: Variable '%s' should be 2D, but has %lu dimensions. Ignored\n",
+                      name.c_str(), static_cast<unsigned long>(size.size()));
+    var = def;
+    return false;
+  }
+  };
+
+  const int gnx = size[0];
+  const int gny = size[1];
+
+  // Whole variable in one read on processor 0, then one broadcast
+  vector<BoutReal> buf(gnx * gny);
+  int ok = 0;
+  if (mype == 0) {
+    file->setGlobalOrigin();
+    ok = file->read(buf.data(), name, gnx, gny) ? 1 : 0;
+  }
+  MPI_Bcast(&ok, 1, MPI_INT, 0, comm);
+  if (!ok) {
+    throw BoutException("Could not fetch data for '%s'", name.c_str());
+  }
+  MPI_Bcast(buf.data(), gnx * gny, BOUT_MPI_REAL, 0, comm);
+
+  var.allocate(); // Make sure data allocated
+
+  // Index offsets into source array
+  int xs = m->OffsetX;
+  int ys = m->OffsetY;
+
+  // Index offsets into destination
+  int xd = -1;
+  int yd = -1;
+
+  ///Ghost region widths.
+  int mxg = (m->LocalNx - (m->xend - m->xstart + 1)) / 2;
+  int myg = (m->LocalNy - (m->yend - m->ystart + 1)) / 2;
+  ///Check that ghost region widths are in fact integers
+  ASSERT1((m->LocalNx - (m->xend - m->xstart + 1)) % 2 == 0);
+  ASSERT1((m->LocalNy - (m->yend - m->ystart + 1)) % 2 == 0);
+
+  // Number of points to copy out of the broadcast buffer
+  int nx_to_read = -1;
+  int ny_to_read = -1;
+
+  ///Check if field dimensions are correct. x-direction
+  if (gnx == m->GlobalNx) { ///including ghostpoints
+    nx_to_read = m->LocalNx;
+    xd = 0;
+  } else if ( gnx == m->GlobalNx - 2*mxg ) {///including ghostpoints
+    nx_to_read = m->LocalNx - 2*mxg;
+    xd = mxg;
+  } else {
+    throw BoutException("Could not read '%s' from file: x-dimension = %i do neither match nx = %i"
+                "nor nx-2*mxg = %i ", name.c_str(), gnx, m->GlobalNx, m->GlobalNx-2*mxg);
+  }
+
+  ///Check if field dimensions are correct. y-direction
+  if (gny == m->GlobalNy) { ///including ghostpoints
+    ny_to_read = m->LocalNy;
+    yd = 0;
+  } else if ( gny == m->GlobalNy - 2*myg ) {///including ghostpoints
+    ny_to_read = m->LocalNy - 2*myg;
+    yd = myg;
+  } else {
+    throw BoutException("Could not read '%s' from file: y-dimension = %i do neither match ny = %i"
+                "nor ny-2*myg = %i ", name.c_str(), gny, m->GlobalNy, m->GlobalNy-2*myg);
+  }
+
+  // Copy this processor's part out of the broadcast buffer
+  for (int x = xs; x < xs + nx_to_read; x++) {
+    for (int j = 0; j < ny_to_read; j++) {
+      var(x - xs + xd, yd + j) = buf[x * gny + ys + j];
+    }
+  }
+
+  ///If field does not include ghost points in y-direction ->
+  ///Upper and lower Y boundaries copied from nearest point
+  if (gny == m->GlobalNy - 2*myg ) {
+    for(int x=0;x<m->LocalNx;x++) {
+      for(int y=0;y<m->ystart;y++)
+        var(x, y) = var(x, m->ystart);
+      for(int y=m->yend+1;y<m->LocalNy;y++)
+        var(x, y) = var(x, m->yend);
+    }
+  }
+
+  return true;
+}
+
 /*!
  * Reads a 3D variable from a file
  * 
@@ -32,6 +32,7 @@
 #include <fft.hxx>
 #include <msg_stack.hxx>
 #include <bout/assert.hxx>
+#include <bout/stencil_view.hxx>
 
 #include <invert_laplace.hxx> // Delp2 uses same coefficients as inversion code
 
@@ -211,22 +212,27 @@ const Field3D Div_par(const Field3D &f, const Field3D &v) {
   
   for(int i=mesh->xstart;i<=mesh->xend;i++)
     for(int j=mesh->ystart;j<=mesh->yend;j++) {
+      // Metric factors at the two cell faces, constant in z
+      BoutReal coefR = (coord->J(i,j) + coord->J(i,j+1)) / (sqrt(coord->g_22(i,j))+ sqrt(coord->g_22(i,j+1)));
+      BoutReal coefL = (coord->J(i,j) + coord->J(i,j-1)) / (sqrt(coord->g_22(i,j)) + sqrt(coord->g_22(i,j-1)));
+      BoutReal Jdy = coord->dy(i,j)*coord->J(i,j);
+
       for(int k=0;k<mesh->LocalNz;k++) {
-	
+
 	// Value of f and v at left cell face
 	BoutReal fL = 0.5*(f(i,j,k) + f.ydown()(i,j-1,k));
 	BoutReal vL = 0.5*(v(i,j,k) + v.ydown()(i,j-1,k));
-	
+
 	BoutReal fR = 0.5*(f(i,j,k) + f.yup()(i,j+1,k));
 	BoutReal vR = 0.5*(v(i,j,k) + v.yup()(i,j+1,k));
-	
+
         // Calculate flux at right boundary (y+1/2)
-	BoutReal fluxRight = fR * vR * (coord->J(i,j) + coord->J(i,j+1)) / (sqrt(coord->g_22(i,j))+ sqrt(coord->g_22(i,j+1)));
-	
+	BoutReal fluxRight = fR * vR * coefR;
+
         // Calculate at left boundary (y-1/2)
-	BoutReal fluxLeft = fL * vL * (coord->J(i,j) + coord->J(i,j-1)) / (sqrt(coord->g_22(i,j)) + sqrt(coord->g_22(i,j-1)));
-	
-	result(i,j,k)   = (fluxRight - fluxLeft) / (coord->dy(i,j)*coord->J(i,j));
+	BoutReal fluxLeft = fL * vL * coefL;
+
+	result(i,j,k)   = (fluxRight - fluxLeft) / Jdy;
       }
     }
 
@@ -240,24 +246,14 @@ const Field3D Div_par(const Field3D &f, const Field3D &v) {
 const Field3D Div_par_flux(const Field3D &v, const Field3D &f, CELL_LOC outloc, DIFF_METHOD method) {
   Coordinates *metric = f.getCoordinates(outloc);
 
-  Field2D Bxy_floc = f.getCoordinates()->Bxy;
-
-  if (!f.hasYupYdown()) {
-    return metric->Bxy*FDDY(v, f/Bxy_floc, outloc, method)/sqrt(metric->g_22);
-  }
-
-  // Need to modify yup and ydown fields
-  Field3D f_B = f / Bxy_floc;
-  if (&f.yup() == &f) {
-    // Identity, yup and ydown point to same field
-    f_B.mergeYupYdown();
-  } else {
-    // Distinct fields
-    f_B.splitYupYdown();
-    f_B.yup() = f.yup() / Bxy_floc;
-    f_B.ydown() = f.ydown() / Bxy_floc;
-  }
-  return metric->Bxy*FDDY(v, f_B, outloc, method)/sqrt(metric->g_22);
+  // Div_par_flux(v, f) = B * FDDY(v, f/B) / sqrt(g_22), fused into a
+  // single sweep: the 1/B factor is applied to the stencil values
+  // inside the derivative loop, and the remaining factors to the
+  // result on the way out, so no scaled copy of f (or of its
+  // yup/ydown fields) is materialised
+  return f.getMesh()->indexFDDY(v, f, 1. / f.getCoordinates()->Bxy,
+                                metric->Bxy / (sqrt(metric->g_22) * metric->dy),
+                                outloc, method);
 }
 
 const Field3D Div_par_flux(const Field3D &v, const Field3D &f, DIFF_METHOD method, CELL_LOC outloc) {
@@ -340,23 +336,33 @@ const Field3D Vpar_Grad_par_LCtoC(const Field3D &v, const Field3D &f, REGION reg
   /// Convert REGION enum to a Region string identifier
   const auto region_str = REGION_STRING(region);
 
+  const auto &region3d = vMesh->getRegion3D(region_str);
+  StencilView r = result.view(region3d);
+
   if (vUseUpDown && fUseUpDown) {
     // Both v and f have up/down fields
+
+    ConstStencilView vc = v.view(region3d);
+    ConstStencilView vcup = v.yup().view(region3d);
+    ConstStencilView vcdown = v.ydown().view(region3d);
+    ConstStencilView fc = f.view(region3d);
+    ConstStencilView fcup = f.yup().view(region3d);
+    ConstStencilView fcdown = f.ydown().view(region3d);
     BOUT_OMP(parallel) {
       stencil fval, vval;
-      BOUT_FOR_INNER(i, vMesh->getRegion3D(region_str)) {
-        vval.m = v.ydown()[i.ym()];
-        vval.c = v[i];
-        vval.p = v.yup()[i.yp()];
+      BOUT_FOR_INNER(i, region3d) {
+        vval.m = vcdown[i.ym()];
+        vval.c = vc[i];
+        vval.p = vcup[i.yp()];
 
-        fval.m = f.ydown()[i.ym()];
-        fval.c = f[i];
-        fval.p = f.yup()[i.yp()];
+        fval.m = fcdown[i.ym()];
+        fval.c = fc[i];
+        fval.p = fcup[i.yp()];
 
         // Left side
-        result[i] = (vval.c >= 0.0) ? vval.c * fval.m : vval.c * fval.c;
+        r[i] = (vval.c >= 0.0) ? vval.c * fval.m : vval.c * fval.c;
         // Right side
-        result[i] -= (vval.p >= 0.0) ? vval.p * fval.c : vval.p * fval.p;
+        r[i] -= (vval.p >= 0.0) ? vval.p * fval.c : vval.p * fval.p;
       }
     }
   }
@@ -368,21 +374,24 @@ const Field3D Vpar_Grad_par_LCtoC(const Field3D &v, const Field3D &f, REGION reg
     Field3D v_fa = vMesh->toFieldAligned(v);
     Field3D f_fa = vMesh->toFieldAligned(f);
 
+    ConstStencilView vc = v_fa.view(region3d);
+    ConstStencilView fc = f_fa.view(region3d);
+
     BOUT_OMP(parallel) {
       stencil fval, vval;
-      BOUT_FOR_INNER(i, vMesh->getRegion3D(region_str)) {
-        fval.m = f_fa[i.ym()];
-        fval.c = f_fa[i];
-        fval.p = f_fa[i.yp()];
+      BOUT_FOR_INNER(i, region3d) {
+        fval.m = fc[i.ym()];
+        fval.c = fc[i];
+        fval.p = fc[i.yp()];
 
-        vval.m = v_fa[i.ym()];
-        vval.c = v_fa[i];
-        vval.p = v_fa[i.yp()];
+        vval.m = vc[i.ym()];
+        vval.c = vc[i];
+        vval.p = vc[i.yp()];
 
         // Left side
-        result[i] = (vval.c >= 0.0) ? vval.c * fval.m : vval.c * fval.c;
+        r[i] = (vval.c >= 0.0) ? vval.c * fval.m : vval.c * fval.c;
         // Right side
-        result[i] -= (vval.p >= 0.0) ? vval.p * fval.c : vval.p * fval.p;
+        r[i] -= (vval.p >= 0.0) ? vval.p * fval.c : vval.p * fval.p;
       }
 
     result = vMesh->fromFieldAligned(result);
@@ -405,17 +414,23 @@ const Field3D Grad_par_LtoC(const Field3D &var) {
 
   Coordinates *metric = var.getCoordinates(CELL_CENTRE);
 
+  const auto &region = varMesh->getRegion3D("RGN_NOBNDRY");
+  StencilView r = result.view(region);
+
   if (var.hasYupYdown()) {
-    BOUT_FOR(i, varMesh->getRegion3D("RGN_NOBNDRY")) {
-      result[i] = (var.yup()[i.yp()] - var[i]) / (metric->dy[i]*sqrt(metric->g_22[i]));
+    ConstStencilView v = var.view(region);
+    ConstStencilView vup = var.yup().view(region);
+    BOUT_FOR(i, region) {
+      r[i] = (vup[i.yp()] - v[i]) / (metric->dy[i]*sqrt(metric->g_22[i]));
     }
   } else {
     // No yup/ydown field, so transform to field aligned
 
     Field3D var_fa = varMesh->toFieldAligned(var);
 
-    BOUT_FOR(i, varMesh->getRegion3D("RGN_NOBNDRY")) {
-      result[i] = (var_fa[i.yp()] - var_fa[i]) / (metric->dy[i]*sqrt(metric->g_22[i]));
+    ConstStencilView v = var_fa.view(region);
+    BOUT_FOR(i, region) {
+      r[i] = (v[i.yp()] - v[i]) / (metric->dy[i]*sqrt(metric->g_22[i]));
     }
     result = varMesh->fromFieldAligned(result);
   }
@@ -670,7 +685,19 @@ const Field3D b0xGrad_dot_Grad(const Field2D &phi, const Field3D &A, CELL_LOC ou
 
   Field3D result = VDDX(vx, A, outloc) + VDDY(vy, A, outloc) + VDDZ(vz, A, outloc);
 
-  result /= (metric->J*sqrt(metric->g_22));
+  // Divide by J*sqrt(g_22), precombined in the packed metric record
+  {
+    const Coordinates::PackedMetric *pm = metric->packedMetrics();
+    const int ncz = mesh->LocalNz;
+    StencilView r(result);
+    BOUT_FOR(j2D, mesh->getRegion2D("RGN_ALL")) {
+      const BoutReal c = pm[j2D.ind].inv_J_sqrtg22;
+      BoutReal *rp = r.pencil(j2D.x(), j2D.y());
+      for (int jz = 0; jz < ncz; jz++) {
+        rp[jz] *= c;
+      }
+    }
+  }
 
 #ifdef TRACK
   result.name = "b0xGrad_dot_Grad("+phi.name+","+A.name+")";
@@ -688,6 +715,8 @@ const Field3D b0xGrad_dot_Grad(const Field3D &p, const Field2D &A, CELL_LOC outl
 
   ASSERT1(p.getMesh() == A.getMesh());
 
+  Mesh *mesh = p.getMesh();
+
   Coordinates *metric = p.getCoordinates(outloc);
 
   // Calculate phi derivatives
@@ -695,15 +724,50 @@ const Field3D b0xGrad_dot_Grad(const Field3D &p, const Field2D &A, CELL_LOC outl
   Field3D dpdy = DDY(p, outloc);
   Field3D dpdz = DDZ(p, outloc);
 
-  // Calculate advection velocity
-  Field3D vx = metric->g_22 * dpdz - metric->g_23 * dpdy;
-  Field3D vy = metric->g_23 * dpdx - metric->g_12 * dpdz;
+  // Calculate advection velocity, fused per (x,y) via the packed
+  // metric records (see the Field3D/Field3D overload below)
+  Field3D vx(mesh), vy(mesh);
+  vx.allocate();
+  vx.setLocation(outloc);
+  vy.allocate();
+  vy.setLocation(outloc);
+
+  const Coordinates::PackedMetric *pm = metric->packedMetrics();
+  const int ncz = mesh->LocalNz;
+
+  {
+    ConstStencilView px(dpdx), py(dpdy), pz(dpdz);
+    StencilView wx(vx), wy(vy);
+    BOUT_FOR(j2D, mesh->getRegion2D("RGN_ALL")) {
+      const Coordinates::PackedMetric &m = pm[j2D.ind];
+      const int jx = j2D.x(), jy = j2D.y();
+      const BoutReal *dxp = px.pencil(jx, jy);
+      const BoutReal *dyp = py.pencil(jx, jy);
+      const BoutReal *dzp = pz.pencil(jx, jy);
+      BoutReal *vxp = wx.pencil(jx, jy);
+      BoutReal *vyp = wy.pencil(jx, jy);
+      for (int jz = 0; jz < ncz; jz++) {
+        vxp[jz] = m.g_22 * dzp[jz] - m.g_23 * dyp[jz];
+        vyp[jz] = m.g_23 * dxp[jz] - m.g_12 * dzp[jz];
+      }
+    }
+  }
 
   // Upwind A using these velocities
 
   Field3D result = VDDX(vx, A, outloc) + VDDY(vy, A, outloc);
 
-  result /= (metric->J*sqrt(metric->g_22));
+  // Divide by J*sqrt(g_22), precombined in the packed record
+  {
+    StencilView r(result);
+    BOUT_FOR(j2D, mesh->getRegion2D("RGN_ALL")) {
+      const BoutReal c = pm[j2D.ind].inv_J_sqrtg22;
+      BoutReal *rp = r.pencil(j2D.x(), j2D.y());
+      for (int jz = 0; jz < ncz; jz++) {
+        rp[jz] *= c;
+      }
+    }
+  }
   
 #ifdef TRACK
   result.name = "b0xGrad_dot_Grad("+p.name+","+A.name+")";
@@ -730,10 +794,40 @@ const Field3D b0xGrad_dot_Grad(const Field3D &phi, const Field3D &A, CELL_LOC ou
   Field3D dpdy = DDY(phi, outloc);
   Field3D dpdz = DDZ(phi, outloc);
 
-  // Calculate advection velocity
-  Field3D vx = metric->g_22 * dpdz - metric->g_23 * dpdy;
-  Field3D vy = metric->g_23 * dpdx - metric->g_12 * dpdz;
-  Field3D vz = metric->g_12 * dpdy - metric->g_22 * dpdx;
+  // Calculate advection velocity. One fused pass per (x,y) using the
+  // packed metric records: each record is fetched once and reused
+  // across the z points, instead of streaming g_22, g_23 and g_12 over
+  // z separately for each of six products
+  Field3D vx(mesh), vy(mesh), vz(mesh);
+  vx.allocate();
+  vx.setLocation(outloc);
+  vy.allocate();
+  vy.setLocation(outloc);
+  vz.allocate();
+  vz.setLocation(outloc);
+
+  const Coordinates::PackedMetric *pm = metric->packedMetrics();
+  const int ncz = mesh->LocalNz;
+
+  {
+    ConstStencilView px(dpdx), py(dpdy), pz(dpdz);
+    StencilView wx(vx), wy(vy), wz(vz);
+    BOUT_FOR(j2D, mesh->getRegion2D("RGN_ALL")) {
+      const Coordinates::PackedMetric &m = pm[j2D.ind];
+      const int jx = j2D.x(), jy = j2D.y();
+      const BoutReal *dxp = px.pencil(jx, jy);
+      const BoutReal *dyp = py.pencil(jx, jy);
+      const BoutReal *dzp = pz.pencil(jx, jy);
+      BoutReal *vxp = wx.pencil(jx, jy);
+      BoutReal *vyp = wy.pencil(jx, jy);
+      BoutReal *vzp = wz.pencil(jx, jy);
+      for (int jz = 0; jz < ncz; jz++) {
+        vxp[jz] = m.g_22 * dzp[jz] - m.g_23 * dyp[jz];
+        vyp[jz] = m.g_23 * dxp[jz] - m.g_12 * dzp[jz];
+        vzp[jz] = m.g_12 * dyp[jz] - m.g_22 * dxp[jz];
+      }
+    }
+  }
 
   if(mesh->IncIntShear) {
     // BOUT-06 style differencing
@@ -742,7 +836,17 @@ const Field3D b0xGrad_dot_Grad(const Field3D &phi, const Field3D &A, CELL_LOC ou
 
   Field3D result = VDDX(vx, A, outloc) + VDDY(vy, A, outloc) + VDDZ(vz, A, outloc);
 
-  result /=  (metric->J*sqrt(metric->g_22));
+  // Divide by J*sqrt(g_22), precombined in the packed record
+  {
+    StencilView r(result);
+    BOUT_FOR(j2D, mesh->getRegion2D("RGN_ALL")) {
+      const BoutReal c = pm[j2D.ind].inv_J_sqrtg22;
+      BoutReal *rp = r.pencil(j2D.x(), j2D.y());
+      for (int jz = 0; jz < ncz; jz++) {
+        rp[jz] *= c;
+      }
+    }
+  }
 
 #ifdef TRACK
   result.name = "b0xGrad_dot_Grad("+phi.name+","+A.name+")";
@@ -770,7 +874,8 @@ const Field2D bracket(const Field2D &f, const Field2D &g, BRACKET_METHOD method,
 
   Field2D result(f.getMesh());
 
-  if( (method == BRACKET_SIMPLE) || (method == BRACKET_ARAKAWA)) {
+  if ((method == BRACKET_SIMPLE) || (method == BRACKET_ARAKAWA) ||
+      (method == BRACKET_ARAKAWA_FAST)) {
     // Use a subset of terms for comparison to BOUT-06
     result = 0.0;
     result.setLocation(outloc);
@@ -840,6 +945,7 @@ const Field3D bracket(const Field3D &f, const Field2D &g, BRACKET_METHOD method,
       }
     break;
   }
+  case BRACKET_ARAKAWA_FAST: // The 3D/2D form has no z-stencil reuse to exploit
   case BRACKET_ARAKAWA: {
     // Arakawa scheme for perpendicular flow. Here as a test
 
@@ -984,7 +1090,8 @@ const Field3D bracket(const Field2D &f, const Field3D &g, BRACKET_METHOD method,
   case BRACKET_CTU:
     throw BoutException("Bracket method CTU is not yet implemented for [2d,3d] fields.");
     break;
-  case BRACKET_ARAKAWA: 
+  case BRACKET_ARAKAWA:
+  case BRACKET_ARAKAWA_FAST:
     // It is symmetric, therefore we can return -[3d,2d]
     return -bracket(g,f,method,outloc,solver);
     break;
@@ -1218,6 +1325,73 @@ const Field3D bracket(const Field3D &f, const Field3D &g, BRACKET_METHOD method,
 
     break;
   }
+  case BRACKET_ARAKAWA_FAST: {
+    // Arakawa scheme for perpendicular flow, walking z-contiguous lines
+    // with the three x-rows of the stencil rotating through registers,
+    // so each value of f and g is loaded once instead of nine times
+
+    result.allocate();
+    result.setLocation(outloc);
+
+    const int ncz = mesh->LocalNz;
+    const BoutReal partialFactor = 1.0 / (12 * metric->dz);
+
+    // We need to discard const qualifier in order to manipulate
+    // storage array directly
+    Field3D f_temp = f;
+    Field3D g_temp = g;
+
+    BOUT_FOR(j2D, mesh->getRegion2D("RGN_NOBNDRY")) {
+      const BoutReal spacingFactor = partialFactor / metric->dx[j2D];
+      const int jy = j2D.y(), jx = j2D.x();
+
+      const BoutReal *Fxm = f_temp(jx - 1, jy);
+      const BoutReal *Fx = f_temp(jx, jy);
+      const BoutReal *Fxp = f_temp(jx + 1, jy);
+      const BoutReal *Gxm = g_temp(jx - 1, jy);
+      const BoutReal *Gx = g_temp(jx, jy);
+      const BoutReal *Gxp = g_temp(jx + 1, jy);
+      BoutReal *res = result(jx, jy);
+
+      // The rotating stencil values. Naming: f{m,c,p} is the x-1, x, x+1
+      // row; the trailing {m,0} is the z offset (z-1, z). The z+1 column
+      // is loaded at the top of the loop below.
+      BoutReal fmm = Fxm[ncz - 1], fcm = Fx[ncz - 1], fpm = Fxp[ncz - 1];
+      BoutReal fm0 = Fxm[0], fc0 = Fx[0], fp0 = Fxp[0];
+      BoutReal gmm = Gxm[ncz - 1], gcm = Gx[ncz - 1], gpm = Gxp[ncz - 1];
+      BoutReal gm0 = Gxm[0], gc0 = Gx[0], gp0 = Gxp[0];
+
+      for (int jz = 0; jz < ncz; jz++) {
+        const int jzp = jz + 1 < ncz ? jz + 1 : 0;
+
+        // Load the new z+1 column; the other six stencil values of each
+        // field are already held from the previous iteration
+        const BoutReal fmp = Fxm[jzp], fcp = Fx[jzp], fpp = Fxp[jzp];
+        const BoutReal gmp = Gxm[jzp], gcp = Gx[jzp], gpp = Gxp[jzp];
+
+        // J++ = DDZ(f)*DDX(g) - DDX(f)*DDZ(g)
+        const BoutReal Jpp = (fcp - fcm) * (gp0 - gm0) - (fp0 - fm0) * (gcp - gcm);
+
+        // J+x
+        const BoutReal Jpx = gp0 * (fpp - fpm) - gm0 * (fmp - fmm) -
+                             gcp * (fpp - fmp) + gcm * (fpm - fmm);
+
+        // Jx+
+        const BoutReal Jxp = gpp * (fcp - fp0) - gmm * (fm0 - fcm) -
+                             gmp * (fcp - fm0) + gpm * (fp0 - fcm);
+
+        res[jz] = (Jpp + Jpx + Jxp) * spacingFactor;
+
+        // Rotate the stencil one point in z
+        fmm = fm0; fcm = fc0; fpm = fp0;
+        fm0 = fmp; fc0 = fcp; fp0 = fpp;
+        gmm = gm0; gcm = gc0; gpm = gp0;
+        gm0 = gmp; gc0 = gcp; gp0 = gpp;
+      }
+    }
+
+    break;
+  }
   case BRACKET_ARAKAWA_OLD: {
     // Arakawa scheme for perpendicular flow
 
@@ -35,14 +35,19 @@ namespace FV {
 
     for(int i=xs;i<=xe;i++)
       for(int j=mesh->ystart;j<=mesh->yend;j++) {
+	// Metric factors, constant in z
+	BoutReal dx_sum = coord->dx(i,j) + coord->dx(i+1,j);
+	BoutReal Jdx_c = coord->dx(i,j)*coord->J(i,j);
+	BoutReal Jdx_p = coord->dx(i+1,j)*coord->J(i+1,j);
+
 	for(int k=0;k<mesh->LocalNz;k++) {
 	  // Calculate flux from i to i+1
 	
 	  BoutReal fout = (coord->J(i,j)*a(i,j,k)*coord->g11(i,j) + coord->J(i+1,j)*a(i+1,j,k)*coord->g11(i+1,j)) *
-	    (f(i+1,j,k) - f(i,j,k))/(coord->dx(i,j) + coord->dx(i+1,j));
-                     
-	  result(i,j,k) += fout / (coord->dx(i,j)*coord->J(i,j));
-	  result(i+1,j,k) -= fout / (coord->dx(i+1,j)*coord->J(i+1,j));
+	    (f(i+1,j,k) - f(i,j,k))/dx_sum;
+
+	  result(i,j,k) += fout / Jdx_c;
+	  result(i+1,j,k) -= fout / Jdx_p;
 	}
       }
     
@@ -254,35 +259,46 @@ namespace FV {
     for(int i=mesh->xstart;i<=mesh->xend;i++)
       for(int j=mesh->ystart;j<=mesh->yend;j++) {
         BoutReal dy3 = SQ(coord->dy(i,j))*coord->dy(i,j);
+
+        // Metric factors, constant in z
+        BoutReal Jsum_r = coord->J(i,j) + coord->J(i,j+1);
+        BoutReal Jdy_c = coord->J(i,j) * coord->dy(i,j);
+        BoutReal Jdy_p = coord->J(i,j+1) * coord->dy(i,j+1);
+
         for(int k=0;k<mesh->LocalNz;k++) {
-          
+
           // 3rd derivative at right boundary
-          
+
           BoutReal d3fdx3 = (
                              f(i,j+2,k)
                              - 3.*f(i,j+1,k)
                              + 3.*f(i,j,  k)
                              -    f(i,j-1,k)
                              ) / dy3;
-          
-          BoutReal flux = 0.5*(d(i,j,k) + d(i,j+1,k))*(coord->J(i,j) + coord->J(i,j+1)) * d3fdx3;
-          
-          result(i,j,  k) += flux / (coord->J(i,j) * coord->dy(i,j));
-          result(i,j+1,k) -= flux / (coord->J(i,j+1) * coord->dy(i,j+1));
-          
-          if(j == mesh->ystart && (!mesh->firstY())) {
-            // Left cell boundary, no flux through boundaries
-            d3fdx3 = (
+
+          BoutReal flux = 0.5*(d(i,j,k) + d(i,j+1,k))*Jsum_r * d3fdx3;
+
+          result(i,j,  k) += flux / Jdy_c;
+          result(i,j+1,k) -= flux / Jdy_p;
+        }
+
+        if(j == mesh->ystart && (!mesh->firstY())) {
+          // Left cell boundary, no flux through boundaries
+          BoutReal Jsum_l = coord->J(i,j) + coord->J(i,j-1);
+          BoutReal Jdy_m = coord->J(i,j-1) * coord->dy(i,j-1);
+
+          for(int k=0;k<mesh->LocalNz;k++) {
+            BoutReal d3fdx3 = (
                       f(i,j+1,k)
                       - 3.*f(i,j,  k)
                       + 3.*f(i,j-1,k)
                       -    f(i,j-2,k)
                       ) / dy3;
-            
-            flux = 0.5*(d(i,j,k) + d(i,j-1,k))*(coord->J(i,j) + coord->J(i,j-1)) * d3fdx3;
-            
-            result(i,j,  k) -= flux / (coord->J(i,j) * coord->dy(i,j));
-            result(i,j-1,k) += flux / (coord->J(i,j-1) * coord->dy(i,j-1));
+
+            BoutReal flux = 0.5*(d(i,j,k) + d(i,j-1,k))*Jsum_l * d3fdx3;
+
+            result(i,j,  k) -= flux / Jdy_c;
+            result(i,j-1,k) += flux / Jdy_m;
           }
         }
       }
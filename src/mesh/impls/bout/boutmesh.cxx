@@ -36,6 +36,7 @@
 #include "boutmesh.hxx"
 
 #include <bout/constants.hxx>
+#include <bout/openmpwrap.hxx>
 #include <bout/sys/timer.hxx>
 #include <boutcomm.hxx>
 #include <boutexception.hxx>
@@ -47,8 +48,10 @@
 #include <output.hxx>
 #include <utils.hxx>
 
+#include <algorithm>
+
 /// MPI type of BoutReal for communications
-#define PVEC_REAL_MPI_TYPE MPI_DOUBLE
+#define PVEC_REAL_MPI_TYPE BOUT_MPI_REAL
 
 BoutMesh::BoutMesh(GridDataSource *s, Options *opt) : Mesh(s, opt) {
   OPTION(options, symmetricGlobalX, true);
@@ -65,9 +68,17 @@ If you want the old setting, you have to specify mesh:symmetricGlobalY=false in
   comm_inner = MPI_COMM_NULL;
   comm_middle = MPI_COMM_NULL;
   comm_outer = MPI_COMM_NULL;
+
+  comm_shared = MPI_COMM_NULL;
+  for (auto &n : shm_neighbour)
+    n = MPI_UNDEFINED;
 }
 
 BoutMesh::~BoutMesh() {
+  if (dump_comm_graph) {
+    dumpCommGraph();
+  }
+
   // Delete the communication handles
   clear_handles();
 
@@ -83,6 +94,8 @@ BoutMesh::~BoutMesh() {
     MPI_Comm_free(&comm_inner);
   if (comm_outer != MPI_COMM_NULL)
     MPI_Comm_free(&comm_outer);
+  if (comm_shared != MPI_COMM_NULL)
+    MPI_Comm_free(&comm_shared);
 }
 
 int BoutMesh::load() {
@@ -227,6 +240,22 @@ int BoutMesh::load() {
     jyseps2_2 = jyseps1_2;
   }
 
+  // Z decomposition. The rest of BOUT++ assumes that the full Z
+  // (toroidal) dimension is stored on every processor: Field3D
+  // storage, the z-FFT paths (fft_fftw, invert_laplace) and the DDZ
+  // stencils all index a locally-complete z. Accept the NZPE option
+  // here so input files can declare the intent, but refuse anything
+  // other than the serial case rather than silently mis-decompose
+  OPTION(options, NZPE, 1);
+  if (NZPE != 1) {
+    throw BoutException(
+        "NZPE = %d, but Z decomposition is not yet implemented: Field3D "
+        "storage, the z-FFT paths and the DDZ stencils all assume the full "
+        "Z dimension is local to each processor. Set NZPE = 1 and decompose "
+        "in X and Y (NXPE) instead",
+        NZPE);
+  }
+
   if (options->isSet("NXPE")) {    // Specified NXPE
     options->get("NXPE", NXPE, 1); // Decomposition in the radial direction
     if ((NPES % NXPE) != 0) {
@@ -298,9 +327,53 @@ int BoutMesh::load() {
     MX = nx - 2 * MXG;
 
     NXPE = -1; // Best option
-    
+
     BoutReal ideal = sqrt(MX * NPES / static_cast<BoutReal>(ny)); // Results in square domains
 
+    // Optionally weight the choice by per-region computational cost:
+    // tokamak grids do very different work per row (sheath boundary
+    // operations in the divertor legs, core-only physics, targets), so
+    // the "squarest" split is not always the one that equalises
+    // wall-clock per rank. Row weights can be supplied in the grid
+    // file ("decomposition_weights", length ny, e.g. derived from the
+    // wall-clock imbalance report of a previous run), or built from
+    // per-region weights in the options. The subdomain sizes stay
+    // uniform -- the topology requires it -- but the NXPE/NYPE choice
+    // then minimises the cost of the most expensive rank instead of
+    // the domain aspect ratio
+    bool weighted_decomposition;
+    OPTION(options, weighted_decomposition, false);
+
+    std::vector<BoutReal> ywork;
+    if (weighted_decomposition) {
+      ywork.resize(ny, 1.0);
+      if (!source->get(this, ywork, "decomposition_weights", ny, 0,
+                       GridDataSource::Y)) {
+        BoutReal weight_core, weight_legs, weight_target;
+        options->get("decomposition_weight_core", weight_core, 1.0);
+        options->get("decomposition_weight_legs", weight_legs, 1.0);
+        options->get("decomposition_weight_target", weight_target, 0.0);
+
+        for (int j = 0; j < ny; j++) {
+          // Rows outside [jyseps1_1+1, jyseps2_2] are divertor legs;
+          // for a double null the rows between the two inner
+          // separatrix indices hold the upper legs
+          bool leg = (j <= jyseps1_1) || (j > jyseps2_2)
+                     || ((jyseps2_1 != jyseps1_2) && (j > jyseps2_1)
+                         && (j <= jyseps1_2));
+          ywork[j] = leg ? weight_legs : weight_core;
+        }
+        // Target boundary rows, where sheath conditions are applied
+        ywork[0] += weight_target;
+        ywork[ny - 1] += weight_target;
+        if (jyseps2_1 != jyseps1_2) {
+          ywork[ny_inner - 1] += weight_target;
+          ywork[ny_inner] += weight_target;
+        }
+      }
+    }
+    BoutReal best_cost = 0.;
+
     output_info.write("Finding value for NXPE (ideal = %f)\n", ideal);
 
     for (int i = 1; i <= NPES; i++) { // Loop over all possibilities
@@ -375,7 +448,26 @@ int BoutMesh::load() {
         }
         output_info.write("\t -> Good value\n");
         // Found an acceptable value
-        if ((NXPE < 1) || (fabs(ideal - i) < fabs(ideal - NXPE)))
+        if (weighted_decomposition) {
+          // Cost of the slowest rank: the heaviest MYSUB slab of row
+          // weights, times the local x width including the guard-cell
+          // overhead (which is what makes narrow strips expensive)
+          BoutReal slab_max = 0.;
+          for (int p = 0; p < nyp; p++) {
+            BoutReal slab = 0.;
+            for (int j = p * ysub; j < (p + 1) * ysub; j++)
+              slab += ywork[j];
+            if (slab > slab_max)
+              slab_max = slab;
+          }
+          BoutReal cost = (MX / i + 2 * MXG) * slab_max;
+          output_info.write("\t -> Slowest-rank cost %e\n", cost);
+          if ((NXPE < 1) || (cost < best_cost)
+              || ((cost == best_cost) && (fabs(ideal - i) < fabs(ideal - NXPE)))) {
+            best_cost = cost;
+            NXPE = i; // Keep the value with the cheapest slowest rank
+          }
+        } else if ((NXPE < 1) || (fabs(ideal - i) < fabs(ideal - NXPE)))
           NXPE = i; // Keep value nearest to the ideal
       }
     }
@@ -420,6 +512,17 @@ int BoutMesh::load() {
   OPTION(options, periodicX, false); // Periodic in X
 
   OPTION(options, async_send, false); // Whether to use asyncronous sends
+  OPTION(options, dump_comm_graph, false); // Whether to record the halo-exchange
+                                           // pattern for tools/bout-commbench
+  OPTION(options, persistent_comms, false); // Whether to use persistent MPI requests
+  OPTION(options, shared_comms, false); // Whether to exchange on-node guard cells
+                                        // through MPI shared memory
+  if (shared_comms) {
+    // The fast path reads packed data straight from the neighbour's
+    // buffer, so it needs the fixed per-group buffers that the
+    // persistent machinery provides
+    persistent_comms = true;
+  }
 
   // Set global offsets
 
@@ -455,6 +558,38 @@ int BoutMesh::load() {
   /// Call topology to set layout of grid
   topology();
 
+  // Optionally let the MPI library renumber the processors to match
+  // the machine topology, so that communication partners (including
+  // the branch-cut Y connections set up by topology()) are placed
+  // close together. The logical layout is a pure function of the
+  // rank, so after renumbering each processor re-derives its
+  // subdomain from its new rank
+  bool reorder_ranks;
+  OPTION(options, reorder_ranks, false);
+  if (reorder_ranks) {
+    MPI_Comm graph_comm = createGraphComm();
+    if (graph_comm != MPI_COMM_NULL) {
+      int new_rank;
+      MPI_Comm_rank(graph_comm, &new_rank);
+
+      // Install as the global communicator, so everything created
+      // from BoutComm below uses the new numbering
+      BoutComm::getInstance()->setComm(graph_comm);
+      MPI_Comm_free(&graph_comm); // setComm duplicates
+
+      if (new_rank != MYPE) {
+        // This processor now owns a different subdomain.
+        // Re-derive the decomposition and connections from the new rank
+        MYPE = new_rank;
+        PE_YIND = MYPE / NXPE;
+        PE_XIND = MYPE % NXPE;
+        OffsetX = PE_XIND * MXSUB;
+        OffsetY = PE_YIND * MYSUB;
+        topology();
+      }
+    }
+  }
+
   OPTION(options, TwistShift, false);
 
   if (TwistShift) {
@@ -871,162 +1006,798 @@ const int OUT_SENT_DOWN = 3; ///< Data higher in X than branch-cut, at lower bou
 const int IN_SENT_OUT = 4; ///< Data going in positive X direction (in to out)
 const int OUT_SENT_IN = 5; ///< Data going in negative X direction (out to in)
 
+/****************************************************************
+ * Shared-memory (intra-node) guard cell exchange
+ *
+ * With shared_comms set, each persistent handle allocates an MPI
+ * shared window collectively over the node. Each processor's segment
+ * holds a header of per-channel flags followed by one packed send
+ * block per channel; the receiving side unpacks its guard cells
+ * directly from the sending neighbour's block, bypassing the MPI
+ * send/receive path entirely. A pair of epoch counters per channel
+ * (data-ready, written by the sender; acknowledge, written by the
+ * receiver) orders the accesses, with MPI_Win_sync as the memory
+ * barrier.
+ ****************************************************************/
+
+const int SHM_FLAG_STRIDE = 64;            ///< One cache line per flag, to avoid false sharing
+const int SHM_HEADER = 12 * SHM_FLAG_STRIDE; ///< 6 ready + 6 acknowledge flags
+
+/// The neighbour's send channel matching each of our receive
+/// channels, determined by the message tags: e.g. we receive from
+/// above (channel 0) what the neighbour sent downwards on the inside
+/// of the branch-cut (their channel 2)
+const int SHM_MATCH[6] = {2, 3, 0, 1, 5, 4};
+
+/// Epoch counter set by the sender when a channel's block is packed
+static volatile long *shm_ready_flag(char *base, int channel) {
+  return reinterpret_cast<volatile long *>(base + channel * SHM_FLAG_STRIDE);
+}
+
+/// Epoch counter set by the receiver when a channel's block has been unpacked
+static volatile long *shm_ack_flag(char *base, int channel) {
+  return reinterpret_cast<volatile long *>(base + (6 + channel) * SHM_FLAG_STRIDE);
+}
+
+/// The packed send block for a channel. Channels 0-3 are the Y
+/// directions, 4-5 the X directions; every channel gets a full-size
+/// block so the receiver needs no knowledge of the sender's
+/// branch-cut splits to locate its data
+static BoutReal *shm_block(char *base, int channel, int xlen, int ylen) {
+  int offset = (channel < 4) ? channel * ylen : 4 * ylen + (channel - 4) * xlen;
+  return reinterpret_cast<BoutReal *>(base + SHM_HEADER) + offset;
+}
+
+/// Spin until another processor's write brings \p flag up to \p value
+static void shm_wait_flag(volatile long *flag, long value, MPI_Win win) {
+  while (*flag < value) {
+    MPI_Win_sync(win); // Memory barrier: the flag is written by another process
+  }
+  MPI_Win_sync(win); // The data behind the flag must be visible too
+}
+
+void BoutMesh::setupSharedComms() {
+  if (comm_shared != MPI_COMM_NULL)
+    return; // Already set up
+
+  TRACE("BoutMesh::setupSharedComms");
+
+  // Group the processors able to share memory with this one (in
+  // practice: on the same node)
+  MPI_Comm_split_type(BoutComm::get(), MPI_COMM_TYPE_SHARED, MYPE, MPI_INFO_NULL,
+                      &comm_shared);
+
+  // Translate each neighbour's rank into the shared communicator.
+  // Off-node neighbours come back as MPI_UNDEFINED and keep the
+  // ordinary MPI path
+  const int world_neighbour[6] = {UDATA_INDEST, UDATA_OUTDEST, DDATA_INDEST,
+                                  DDATA_OUTDEST, IDATA_DEST,   ODATA_DEST};
+  MPI_Group group_world, group_shared;
+  MPI_Comm_group(BoutComm::get(), &group_world);
+  MPI_Comm_group(comm_shared, &group_shared);
+  int non_node = 0, total = 0;
+  for (int d = 0; d < 6; d++) {
+    if (world_neighbour[d] == -1) {
+      shm_neighbour[d] = MPI_UNDEFINED;
+      continue;
+    }
+    total++;
+    MPI_Group_translate_ranks(group_world, 1, &world_neighbour[d], group_shared,
+                              &shm_neighbour[d]);
+    if (shm_neighbour[d] != MPI_UNDEFINED)
+      non_node++;
+  }
+  MPI_Group_free(&group_world);
+  MPI_Group_free(&group_shared);
+
+  output_info.write("\tShared-memory exchange with %d of %d neighbours\n", non_node,
+                    total);
+}
+
+bool BoutMesh::shm_channel(CommHandle *ch, int channel) {
+  return (ch->shm_win != MPI_WIN_NULL) && (shm_neighbour[channel] != MPI_UNDEFINED)
+         && !self_channel(channel);
+}
+
+bool BoutMesh::self_channel(int channel) const {
+  switch (channel) {
+  case 0:
+    return UDATA_INDEST == MYPE;
+  case 1:
+    return UDATA_OUTDEST == MYPE;
+  case 2:
+    return DDATA_INDEST == MYPE;
+  case 3:
+    return DDATA_OUTDEST == MYPE;
+  case 4:
+    return IDATA_DEST == MYPE;
+  case 5:
+    return ODATA_DEST == MYPE;
+  }
+  return false;
+}
+
+int BoutMesh::local_exchange(CommHandle *ch, int channel, BoutReal *buffer) {
+  const vector<FieldData *> &vars = ch->var_list.get();
+  const int xd = ch->xdepth;
+  const int yd = ch->ydepth;
+
+  // Each channel's source region is what send() ships, and the
+  // destination is the guard region that wait() would unpack the
+  // matching incoming message into
+  int len = 0;
+  switch (channel) {
+  case 0: // Up, inner: arrives as this processor's own down-inner message
+    len = pack_data(vars, 0, UDATA_XSPLIT, MYSUB + MYG - yd, MYSUB + MYG, buffer,
+                    ch->single);
+    unpack_data(vars, 0, DDATA_XSPLIT, MYG - yd, MYG, buffer, ch->single);
+    break;
+  case 1: // Up, outer
+    len = pack_data(vars, UDATA_XSPLIT, LocalNx, MYSUB + MYG - yd, MYSUB + MYG, buffer,
+                    ch->single);
+    unpack_data(vars, DDATA_XSPLIT, LocalNx, MYG - yd, MYG, buffer, ch->single);
+    break;
+  case 2: // Down, inner
+    len = pack_data(vars, 0, DDATA_XSPLIT, MYG, MYG + yd, buffer, ch->single);
+    unpack_data(vars, 0, UDATA_XSPLIT, MYSUB + MYG, MYSUB + MYG + yd, buffer,
+                ch->single);
+    break;
+  case 3: // Down, outer
+    len = pack_data(vars, DDATA_XSPLIT, LocalNx, MYG, MYG + yd, buffer, ch->single);
+    unpack_data(vars, UDATA_XSPLIT, LocalNx, MYSUB + MYG, MYSUB + MYG + yd, buffer,
+                ch->single);
+    break;
+  case 4: // Inner X: arrives as the message from the outer neighbour
+    len = pack_data(vars, MXG, MXG + xd, MYG, MYG + MYSUB, buffer, ch->single);
+    unpack_data(vars, MXSUB + MXG, MXSUB + MXG + xd, MYG, MYG + MYSUB, buffer,
+                ch->single);
+    break;
+  case 5: // Outer X
+    len = pack_data(vars, MXSUB + MXG - xd, MXSUB + MXG, MYG, MYG + MYSUB, buffer,
+                    ch->single);
+    unpack_data(vars, MXG - xd, MXG, MYG, MYG + MYSUB, buffer, ch->single);
+    break;
+  }
+  return len;
+}
+
+void BoutMesh::shm_send(CommHandle *ch, int channel, int xge, int xlt, int yge,
+                        int ylt) {
+  // Wait until the neighbour has unpacked the previous exchange, so
+  // the block can be overwritten
+  shm_wait_flag(shm_ack_flag(ch->shm_base, channel), ch->shm_epoch - 1, ch->shm_win);
+
+  pack_data(ch->var_list.get(), xge, xlt, yge, ylt,
+            shm_block(ch->shm_base, channel, ch->xbufflen, ch->ybufflen), ch->single);
+
+  // Publish the packed data before raising the flag
+  MPI_Win_sync(ch->shm_win);
+  *shm_ready_flag(ch->shm_base, channel) = ch->shm_epoch;
+}
+
+void BoutMesh::shm_receive(CommHandle *ch, int channel, int xge, int xlt, int yge,
+                           int ylt) {
+  char *peer = ch->shm_peer[channel];
+  const int peer_channel = SHM_MATCH[channel];
+
+  // Wait for the neighbour to pack this exchange's data. The block
+  // layout is symmetric: all processors use the same local grid sizes
+  // and field group, so our buffer lengths locate the peer's blocks
+  shm_wait_flag(shm_ready_flag(peer, peer_channel), ch->shm_epoch, ch->shm_win);
+
+  unpack_data(ch->var_list.get(), xge, xlt, yge, ylt,
+              shm_block(peer, peer_channel, ch->xbufflen, ch->ybufflen), ch->single);
+
+  // Tell the neighbour its block is free for the next exchange
+  MPI_Win_sync(ch->shm_win);
+  *shm_ack_flag(peer, peer_channel) = ch->shm_epoch;
+}
+
 void BoutMesh::post_receive(CommHandle &ch) {
   BoutReal *inbuff;
   int len;
 
-  /// Post receive data from above (y+1)
+  // Message lengths are in values either way; single-precision
+  // groups just receive them as floats
+  const MPI_Datatype mpi_type = ch.single ? MPI_FLOAT : PVEC_REAL_MPI_TYPE;
+
+  /// Post receive data from above (y+1), filling the upper guards
 
   len = 0;
-  if (UDATA_INDEST != -1) {
-    len = msg_len(ch.var_list.get(), 0, UDATA_XSPLIT, 0, MYG);
-    MPI_Irecv(std::begin(ch.umsg_recvbuff), len, PVEC_REAL_MPI_TYPE, UDATA_INDEST,
-              IN_SENT_DOWN, BoutComm::get(), &ch.request[0]);
-  }
-  if (UDATA_OUTDEST != -1) {
+  if ((UDATA_INDEST != -1) && (ch.dirs & COMM_YUP)) {
+    len = msg_len(ch.var_list.get(), 0, UDATA_XSPLIT, 0, ch.ydepth);
+    // Self-sends are copied locally in send(), so get no receive
+    if (!self_channel(0))
+      MPI_Irecv(std::begin(ch.umsg_recvbuff), len, mpi_type, UDATA_INDEST,
+                IN_SENT_DOWN, BoutComm::get(), &ch.request[0]);
+  }
+  if ((UDATA_OUTDEST != -1) && (ch.dirs & COMM_YUP) && !self_channel(1)) {
     inbuff = &ch.umsg_recvbuff[len]; // pointer to second half of the buffer
-    MPI_Irecv(inbuff, msg_len(ch.var_list.get(), UDATA_XSPLIT, LocalNx, 0, MYG),
-              PVEC_REAL_MPI_TYPE, UDATA_OUTDEST, OUT_SENT_DOWN, BoutComm::get(),
+    MPI_Irecv(inbuff, msg_len(ch.var_list.get(), UDATA_XSPLIT, LocalNx, 0, ch.ydepth),
+              mpi_type, UDATA_OUTDEST, OUT_SENT_DOWN, BoutComm::get(),
               &ch.request[1]);
   }
 
-  /// Post receive data from below (y-1)
+  /// Post receive data from below (y-1), filling the lower guards
 
   len = 0;
 
-  if (DDATA_INDEST != -1) { // If sending & recieving data from a processor
-    len = msg_len(ch.var_list.get(), 0, DDATA_XSPLIT, 0, MYG);
-    MPI_Irecv(std::begin(ch.dmsg_recvbuff), len, PVEC_REAL_MPI_TYPE, DDATA_INDEST,
-              IN_SENT_UP, BoutComm::get(), &ch.request[2]);
+  if ((DDATA_INDEST != -1) && (ch.dirs & COMM_YDOWN)) { // If sending & recieving data from a processor
+    len = msg_len(ch.var_list.get(), 0, DDATA_XSPLIT, 0, ch.ydepth);
+    if (!self_channel(2))
+      MPI_Irecv(std::begin(ch.dmsg_recvbuff), len, mpi_type, DDATA_INDEST,
+                IN_SENT_UP, BoutComm::get(), &ch.request[2]);
   }
-  if (DDATA_OUTDEST != -1) {
+  if ((DDATA_OUTDEST != -1) && (ch.dirs & COMM_YDOWN) && !self_channel(3)) {
     inbuff = &ch.dmsg_recvbuff[len];
-    MPI_Irecv(inbuff, msg_len(ch.var_list.get(), DDATA_XSPLIT, LocalNx, 0, MYG),
-              PVEC_REAL_MPI_TYPE, DDATA_OUTDEST, OUT_SENT_UP, BoutComm::get(),
+    MPI_Irecv(inbuff, msg_len(ch.var_list.get(), DDATA_XSPLIT, LocalNx, 0, ch.ydepth),
+              mpi_type, DDATA_OUTDEST, OUT_SENT_UP, BoutComm::get(),
               &ch.request[3]);
   }
 
-  /// Post receive data from left (x-1)
+  /// Post receive data from left (x-1), filling the inner guards
+
+  if ((IDATA_DEST != -1) && (ch.dirs & COMM_XIN) && !self_channel(4)) {
+    MPI_Irecv(std::begin(ch.imsg_recvbuff),
+              msg_len(ch.var_list.get(), 0, ch.xdepth, 0, MYSUB), mpi_type,
+              IDATA_DEST, OUT_SENT_IN, BoutComm::get(), &ch.request[4]);
+  }
+
+  // Post receive data from right (x+1), filling the outer guards
 
-  if (IDATA_DEST != -1) {
-    MPI_Irecv(std::begin(ch.imsg_recvbuff), msg_len(ch.var_list.get(), 0, MXG, 0, MYSUB),
-              PVEC_REAL_MPI_TYPE, IDATA_DEST, OUT_SENT_IN, BoutComm::get(),
-              &ch.request[4]);
+  if ((ODATA_DEST != -1) && (ch.dirs & COMM_XOUT) && !self_channel(5)) {
+    MPI_Irecv(std::begin(ch.omsg_recvbuff),
+              msg_len(ch.var_list.get(), 0, ch.xdepth, 0, MYSUB), mpi_type,
+              ODATA_DEST, IN_SENT_OUT, BoutComm::get(), &ch.request[5]);
+  }
+}
+
+/****************************************************************
+ *                 COMMUNICATION GRAPH RECORDING
+ ****************************************************************/
+
+void BoutMesh::record_comm_graph(const std::vector<FieldData *> &vars, int xd, int yd,
+                                 int dirs) {
+  // One entry per (peer, message size); self-exchanges (local copies,
+  // e.g. twist-shift on a single Y processor) never touch the network
+  // and are not recorded. The channel structure mirrors send() and
+  // post_receive(): sends fill the peer's opposite guard region
+  auto add = [](std::map<std::pair<int, int>, long> &table, int peer, int len) {
+    if (len > 0)
+      table[std::make_pair(peer, len)] += 1;
+  };
+
+  // Up (y+1)
+  if ((UDATA_INDEST != -1) && !self_channel(0)) {
+    const int len = msg_len(vars, 0, UDATA_XSPLIT, 0, yd);
+    if (dirs & COMM_YDOWN)
+      add(comm_graph_sends, UDATA_INDEST, len);
+    if (dirs & COMM_YUP)
+      add(comm_graph_recvs, UDATA_INDEST, len);
+  }
+  if ((UDATA_OUTDEST != -1) && !self_channel(1)) {
+    const int len = msg_len(vars, UDATA_XSPLIT, LocalNx, 0, yd);
+    if (dirs & COMM_YDOWN)
+      add(comm_graph_sends, UDATA_OUTDEST, len);
+    if (dirs & COMM_YUP)
+      add(comm_graph_recvs, UDATA_OUTDEST, len);
+  }
+
+  // Down (y-1)
+  if ((DDATA_INDEST != -1) && !self_channel(2)) {
+    const int len = msg_len(vars, 0, DDATA_XSPLIT, 0, yd);
+    if (dirs & COMM_YUP)
+      add(comm_graph_sends, DDATA_INDEST, len);
+    if (dirs & COMM_YDOWN)
+      add(comm_graph_recvs, DDATA_INDEST, len);
+  }
+  if ((DDATA_OUTDEST != -1) && !self_channel(3)) {
+    const int len = msg_len(vars, DDATA_XSPLIT, LocalNx, 0, yd);
+    if (dirs & COMM_YUP)
+      add(comm_graph_sends, DDATA_OUTDEST, len);
+    if (dirs & COMM_YDOWN)
+      add(comm_graph_recvs, DDATA_OUTDEST, len);
+  }
+
+  // Inner and outer X
+  const int xmsg = msg_len(vars, 0, xd, 0, MYSUB);
+  if ((IDATA_DEST != -1) && !self_channel(4)) {
+    if (dirs & COMM_XOUT)
+      add(comm_graph_sends, IDATA_DEST, xmsg);
+    if (dirs & COMM_XIN)
+      add(comm_graph_recvs, IDATA_DEST, xmsg);
+  }
+  if ((ODATA_DEST != -1) && !self_channel(5)) {
+    if (dirs & COMM_XIN)
+      add(comm_graph_sends, ODATA_DEST, xmsg);
+    if (dirs & COMM_XOUT)
+      add(comm_graph_recvs, ODATA_DEST, xmsg);
+  }
+}
+
+void BoutMesh::dumpCommGraph() {
+  // One file per rank, so no communication is needed here (this runs
+  // at shutdown). The format is read back by tools/bout-commbench
+  std::string datadir;
+  Options::getRoot()->get("datadir", datadir, "data");
+
+  char filename[512];
+  snprintf(filename, sizeof(filename), "%s/comm_graph.%d", datadir.c_str(), MYPE);
+
+  FILE *file = fopen(filename, "w");
+  if (file == nullptr) {
+    output_warn.write("WARNING: Could not write communication graph to '%s'\n",
+                      filename);
+    return;
+  }
+
+  fprintf(file, "# BOUT++ halo-exchange graph: rank %d of %d\n", MYPE, NPES);
+  fprintf(file, "# <send|recv> <peer rank> <message size (BoutReals)> <count>\n");
+  for (const auto &edge : comm_graph_sends)
+    fprintf(file, "send %d %d %ld\n", edge.first.first, edge.first.second, edge.second);
+  for (const auto &edge : comm_graph_recvs)
+    fprintf(file, "recv %d %d %ld\n", edge.first.first, edge.first.second, edge.second);
+  fclose(file);
+
+  output_info.write("Communication graph written to '%s'\n", filename);
+}
+
+BoutMesh::CommHandle *BoutMesh::get_persistent_handle(FieldGroup &g, int xlen, int ylen) {
+  // Guard cell depth this group needs; 0 means the full width
+  int xd = MXG, yd = MYG;
+  if (g.getHaloDepth() > 0) {
+    xd = std::min(g.getHaloDepth(), MXG);
+    yd = std::min(g.getHaloDepth(), MYG);
+  }
+  const bool single = g.getSinglePrecision();
+
+  // The communication pattern and message sizes are fixed for a given
+  // set of fields, so the requests and pack buffers can be set up once
+  // per group signature and restarted every call
+  auto it = persistent_handles.find(g.get());
+  if (it != persistent_handles.end()) {
+    CommHandle *cached = it->second;
+    if ((cached->xdepth != xd) || (cached->ydepth != yd)) {
+      // The depth is baked into the cached message sizes and requests
+      throw BoutException("BoutMesh::send: halo depth of a field group changed "
+                          "between communicate calls");
+    }
+    if (cached->single != single) {
+      // As is the message datatype
+      throw BoutException("BoutMesh::send: precision of a field group changed "
+                          "between communicate calls");
+    }
+    return cached;
+  }
+
+  // Single-precision groups pack floats and send them as MPI_FLOAT;
+  // the counts below are in values either way
+  const MPI_Datatype mpi_type = single ? MPI_FLOAT : PVEC_REAL_MPI_TYPE;
+
+  auto *ch = new CommHandle;
+  for (auto &i : ch->request)
+    i = MPI_REQUEST_NULL;
+  for (auto &i : ch->sendreq)
+    i = MPI_REQUEST_NULL;
+
+  ch->shm_win = MPI_WIN_NULL;
+  ch->shm_base = nullptr;
+  for (auto &p : ch->shm_peer)
+    p = nullptr;
+  ch->shm_epoch = 0;
+
+  if (shared_comms) {
+    setupSharedComms();
+  }
+
+  // On-node channels are exchanged through the shared window below
+  // and self-sends are copied locally in send(); neither gets any
+  // MPI requests at all
+  auto no_mpi = [this](int channel) {
+    return self_channel(channel)
+           || (shared_comms && (shm_neighbour[channel] != MPI_UNDEFINED));
+  };
+
+  if (ylen > 0) {
+    ch->umsg_sendbuff = Array<BoutReal>(ylen);
+    ch->dmsg_sendbuff = Array<BoutReal>(ylen);
+    ch->umsg_recvbuff = Array<BoutReal>(ylen);
+    ch->dmsg_recvbuff = Array<BoutReal>(ylen);
+  }
+  if (xlen > 0) {
+    ch->imsg_sendbuff = Array<BoutReal>(xlen);
+    ch->omsg_sendbuff = Array<BoutReal>(xlen);
+    ch->imsg_recvbuff = Array<BoutReal>(xlen);
+    ch->omsg_recvbuff = Array<BoutReal>(xlen);
+  }
+
+  ch->xbufflen = xlen;
+  ch->ybufflen = ylen;
+  ch->xdepth = xd;
+  ch->ydepth = yd;
+  ch->single = single;
+  ch->in_progress = false;
+  ch->persistent = true;
+  ch->dirs = COMM_ALL; // Persistent exchanges always ship the full halo
+  ch->var_list = g;
+
+  const std::vector<FieldData *> &vars = ch->var_list.get();
+
+  // Persistent receives, mirroring post_receive()
+
+  int len = 0;
+  if (UDATA_INDEST != -1) {
+    len = msg_len(vars, 0, UDATA_XSPLIT, 0, yd);
+    if (!no_mpi(0))
+      MPI_Recv_init(std::begin(ch->umsg_recvbuff), len, mpi_type, UDATA_INDEST,
+                    IN_SENT_DOWN, BoutComm::get(), &ch->request[0]);
+  }
+  if ((UDATA_OUTDEST != -1) && !no_mpi(1)) {
+    MPI_Recv_init(&ch->umsg_recvbuff[len], msg_len(vars, UDATA_XSPLIT, LocalNx, 0, yd),
+                  mpi_type, UDATA_OUTDEST, OUT_SENT_DOWN, BoutComm::get(),
+                  &ch->request[1]);
+  }
+
+  len = 0;
+  if (DDATA_INDEST != -1) {
+    len = msg_len(vars, 0, DDATA_XSPLIT, 0, yd);
+    if (!no_mpi(2))
+      MPI_Recv_init(std::begin(ch->dmsg_recvbuff), len, mpi_type, DDATA_INDEST,
+                    IN_SENT_UP, BoutComm::get(), &ch->request[2]);
+  }
+  if ((DDATA_OUTDEST != -1) && !no_mpi(3)) {
+    MPI_Recv_init(&ch->dmsg_recvbuff[len], msg_len(vars, DDATA_XSPLIT, LocalNx, 0, yd),
+                  mpi_type, DDATA_OUTDEST, OUT_SENT_UP, BoutComm::get(),
+                  &ch->request[3]);
+  }
+
+  if ((IDATA_DEST != -1) && !no_mpi(4)) {
+    MPI_Recv_init(std::begin(ch->imsg_recvbuff), msg_len(vars, 0, xd, 0, MYSUB),
+                  mpi_type, IDATA_DEST, OUT_SENT_IN, BoutComm::get(),
+                  &ch->request[4]);
+  }
+  if ((ODATA_DEST != -1) && !no_mpi(5)) {
+    MPI_Recv_init(std::begin(ch->omsg_recvbuff), msg_len(vars, 0, xd, 0, MYSUB),
+                  mpi_type, ODATA_DEST, IN_SENT_OUT, BoutComm::get(),
+                  &ch->request[5]);
   }
 
-  // Post receive data from right (x+1)
+  // Persistent sends, with buffer offsets matching the packing in send()
 
-  if (ODATA_DEST != -1) {
-    MPI_Irecv(std::begin(ch.omsg_recvbuff), msg_len(ch.var_list.get(), 0, MXG, 0, MYSUB),
-              PVEC_REAL_MPI_TYPE, ODATA_DEST, IN_SENT_OUT, BoutComm::get(),
-              &ch.request[5]);
+  len = 0;
+  if (UDATA_INDEST != -1) {
+    len = msg_len(vars, 0, UDATA_XSPLIT, 0, yd);
+    if (!no_mpi(0))
+      MPI_Send_init(std::begin(ch->umsg_sendbuff), len, mpi_type, UDATA_INDEST,
+                    IN_SENT_UP, BoutComm::get(), &ch->sendreq[0]);
   }
+  if ((UDATA_OUTDEST != -1) && !no_mpi(1)) {
+    MPI_Send_init(&ch->umsg_sendbuff[len], msg_len(vars, UDATA_XSPLIT, LocalNx, 0, yd),
+                  mpi_type, UDATA_OUTDEST, OUT_SENT_UP, BoutComm::get(),
+                  &ch->sendreq[1]);
+  }
+
+  len = 0;
+  if (DDATA_INDEST != -1) {
+    len = msg_len(vars, 0, DDATA_XSPLIT, 0, yd);
+    if (!no_mpi(2))
+      MPI_Send_init(std::begin(ch->dmsg_sendbuff), len, mpi_type, DDATA_INDEST,
+                    IN_SENT_DOWN, BoutComm::get(), &ch->sendreq[2]);
+  }
+  if ((DDATA_OUTDEST != -1) && !no_mpi(3)) {
+    MPI_Send_init(&ch->dmsg_sendbuff[len], msg_len(vars, DDATA_XSPLIT, LocalNx, 0, yd),
+                  mpi_type, DDATA_OUTDEST, OUT_SENT_DOWN, BoutComm::get(),
+                  &ch->sendreq[3]);
+  }
+
+  if ((IDATA_DEST != -1) && !no_mpi(4)) {
+    MPI_Send_init(std::begin(ch->imsg_sendbuff), msg_len(vars, 0, xd, 0, MYSUB),
+                  mpi_type, IDATA_DEST, IN_SENT_OUT, BoutComm::get(),
+                  &ch->sendreq[4]);
+  }
+  if ((ODATA_DEST != -1) && !no_mpi(5)) {
+    MPI_Send_init(std::begin(ch->omsg_sendbuff), msg_len(vars, 0, xd, 0, MYSUB),
+                  mpi_type, ODATA_DEST, OUT_SENT_IN, BoutComm::get(),
+                  &ch->sendreq[5]);
+  }
+
+  if (shared_comms) {
+    // Allocate this group's shared window. This is collective over the
+    // node: every processor runs the same model code, so all reach here
+    // for the same field groups in the same order, including processors
+    // with no on-node neighbours
+    MPI_Aint segsize =
+        SHM_HEADER + static_cast<MPI_Aint>(4 * ylen + 2 * xlen) * sizeof(BoutReal);
+    MPI_Win_allocate_shared(segsize, 1, MPI_INFO_NULL, comm_shared, &ch->shm_base,
+                            &ch->shm_win);
+    shm_windows.push_back(ch->shm_win);
+
+    std::fill(ch->shm_base, ch->shm_base + SHM_HEADER, 0);
+
+    // Map each on-node neighbour's segment into shm_peer
+    for (int d = 0; d < 6; d++) {
+      if (shm_neighbour[d] != MPI_UNDEFINED) {
+        MPI_Aint peer_size;
+        int disp_unit;
+        void *peer;
+        MPI_Win_shared_query(ch->shm_win, shm_neighbour[d], &peer_size, &disp_unit,
+                             &peer);
+        ch->shm_peer[d] = static_cast<char *>(peer);
+      }
+    }
+
+    // Passive access for the lifetime of the handle; all ordering is
+    // done with the per-channel flags and MPI_Win_sync
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, ch->shm_win);
+
+    // Every segment's flags must be zeroed before the first exchange
+    MPI_Barrier(comm_shared);
+  }
+
+  persistent_handles[g.get()] = ch;
+
+  return ch;
 }
 
-comm_handle BoutMesh::send(FieldGroup &g) {
+comm_handle BoutMesh::send(FieldGroup &g) { return send(g, COMM_ALL); }
+
+comm_handle BoutMesh::send(FieldGroup &g, int dirs) {
   /// Start timer
   Timer timer("comms");
 
+  /// Guard cell depth to ship: the group declares what its stencils
+  /// need, up to the configured MXG/MYG
+  int xd = MXG, yd = MYG;
+  if (g.getHaloDepth() > 0) {
+    xd = std::min(g.getHaloDepth(), MXG);
+    yd = std::min(g.getHaloDepth(), MYG);
+  }
+
   /// Work out length of buffer needed
-  int xlen = msg_len(g.get(), 0, MXG, 0, MYSUB);
-  int ylen = msg_len(g.get(), 0, LocalNx, 0, MYG);
+  int xlen = msg_len(g.get(), 0, xd, 0, MYSUB);
+  int ylen = msg_len(g.get(), 0, LocalNx, 0, yd);
+
+  if (dump_comm_graph) {
+    record_comm_graph(g.get(), xd, yd, dirs);
+  }
+
+  // The persistent requests and shared-memory blocks are set up for
+  // the full exchange, so scoped communication (typically at monitor
+  // frequency, off the hot path) takes the per-call path below
+  if (persistent_comms && (dirs == COMM_ALL)) {
+    CommHandle *ch = get_persistent_handle(g, xlen, ylen);
+
+    if (ch->in_progress) {
+      throw BoutException("BoutMesh::send called for a group whose persistent "
+                          "communication is still in progress");
+    }
+
+    // Restart the fixed receive requests
+    for (auto &req : ch->request) {
+      if (req != MPI_REQUEST_NULL)
+        MPI_Start(&req);
+    }
+
+    if (ch->shm_win != MPI_WIN_NULL) {
+      ch->shm_epoch++; // New exchange epoch for the flag synchronisation
+    }
+
+    // Pack the guard cell data, into the shared window for on-node
+    // neighbours (flagging it ready for the neighbour to unpack), or
+    // into the cached buffers restarting the matching send requests
+    int plen = 0;
+    if (UDATA_INDEST != -1) {
+      if (self_channel(0)) {
+        // Send to this processor itself (e.g. single processor along
+        // periodic field lines): copy the guard cells locally
+        plen = local_exchange(ch, 0, std::begin(ch->umsg_sendbuff));
+      } else if (shm_channel(ch, 0)) {
+        plen = msg_len(ch->var_list.get(), 0, UDATA_XSPLIT, 0, yd);
+        shm_send(ch, 0, 0, UDATA_XSPLIT, MYSUB + MYG - yd, MYSUB + MYG);
+      } else {
+        plen = pack_data(ch->var_list.get(), 0, UDATA_XSPLIT, MYSUB + MYG - yd,
+                         MYSUB + MYG, std::begin(ch->umsg_sendbuff), ch->single);
+        MPI_Start(&ch->sendreq[0]);
+      }
+    }
+    if (UDATA_OUTDEST != -1) {
+      if (self_channel(1)) {
+        local_exchange(ch, 1, &ch->umsg_sendbuff[plen]);
+      } else if (shm_channel(ch, 1)) {
+        shm_send(ch, 1, UDATA_XSPLIT, LocalNx, MYSUB + MYG - yd, MYSUB + MYG);
+      } else {
+        pack_data(ch->var_list.get(), UDATA_XSPLIT, LocalNx, MYSUB + MYG - yd,
+                  MYSUB + MYG, &ch->umsg_sendbuff[plen], ch->single);
+        MPI_Start(&ch->sendreq[1]);
+      }
+    }
+    plen = 0;
+    if (DDATA_INDEST != -1) {
+      if (self_channel(2)) {
+        plen = local_exchange(ch, 2, std::begin(ch->dmsg_sendbuff));
+      } else if (shm_channel(ch, 2)) {
+        plen = msg_len(ch->var_list.get(), 0, DDATA_XSPLIT, 0, yd);
+        shm_send(ch, 2, 0, DDATA_XSPLIT, MYG, MYG + yd);
+      } else {
+        plen = pack_data(ch->var_list.get(), 0, DDATA_XSPLIT, MYG, MYG + yd,
+                         std::begin(ch->dmsg_sendbuff), ch->single);
+        MPI_Start(&ch->sendreq[2]);
+      }
+    }
+    if (DDATA_OUTDEST != -1) {
+      if (self_channel(3)) {
+        local_exchange(ch, 3, &ch->dmsg_sendbuff[plen]);
+      } else if (shm_channel(ch, 3)) {
+        shm_send(ch, 3, DDATA_XSPLIT, LocalNx, MYG, MYG + yd);
+      } else {
+        pack_data(ch->var_list.get(), DDATA_XSPLIT, LocalNx, MYG, MYG + yd,
+                  &ch->dmsg_sendbuff[plen], ch->single);
+        MPI_Start(&ch->sendreq[3]);
+      }
+    }
+    if (IDATA_DEST != -1) {
+      if (self_channel(4)) {
+        local_exchange(ch, 4, std::begin(ch->imsg_sendbuff));
+      } else if (shm_channel(ch, 4)) {
+        shm_send(ch, 4, MXG, MXG + xd, MYG, MYG + MYSUB);
+      } else {
+        pack_data(ch->var_list.get(), MXG, MXG + xd, MYG, MYG + MYSUB,
+                  std::begin(ch->imsg_sendbuff), ch->single);
+        MPI_Start(&ch->sendreq[4]);
+      }
+    }
+    if (ODATA_DEST != -1) {
+      if (self_channel(5)) {
+        local_exchange(ch, 5, std::begin(ch->omsg_sendbuff));
+      } else if (shm_channel(ch, 5)) {
+        shm_send(ch, 5, MXSUB + MXG - xd, MXSUB + MXG, MYG, MYG + MYSUB);
+      } else {
+        pack_data(ch->var_list.get(), MXSUB + MXG - xd, MXSUB + MXG, MYG, MYG + MYSUB,
+                  std::begin(ch->omsg_sendbuff), ch->single);
+        MPI_Start(&ch->sendreq[5]);
+      }
+    }
+
+    ch->in_progress = true;
+
+    return static_cast<void *>(ch);
+  }
 
   /// Get a communications handle of (at least) the needed size
   CommHandle *ch = get_handle(xlen, ylen);
   ch->var_list = g; // Group of fields to send
+  ch->xdepth = xd;  // Guard cell depth this exchange ships
+  ch->ydepth = yd;
+  ch->single = g.getSinglePrecision(); // Guard cells converted to float?
+  ch->dirs = dirs;  // Which guard regions this exchange fills
+
+  const MPI_Datatype mpi_type = ch->single ? MPI_FLOAT : PVEC_REAL_MPI_TYPE;
 
   /// Post receives
   post_receive(*ch);
 
   //////////////////////////////////////////////////
 
-  /// Send data going up (y+1)
+  /// Send data going up (y+1): fills the receiver's lower guards
 
   int len = 0;
   BoutReal *outbuff;
 
-  if (UDATA_INDEST != -1) { // If there is a destination for inner x data
-    len = pack_data(ch->var_list.get(), 0, UDATA_XSPLIT, MYSUB, MYSUB + MYG,
-                    std::begin(ch->umsg_sendbuff));
-    // Send the data to processor UDATA_INDEST
-
-    if (async_send) {
-      MPI_Isend(std::begin(ch->umsg_sendbuff), // Buffer to send
-                len,                           // Length of buffer in BoutReals
-                PVEC_REAL_MPI_TYPE,            // Real variable type
-                UDATA_INDEST,                  // Destination processor
-                IN_SENT_UP,                    // Label (tag) for the message
-                BoutComm::get(), &(ch->sendreq[0]));
-    } else
-      MPI_Send(std::begin(ch->umsg_sendbuff), len, PVEC_REAL_MPI_TYPE, UDATA_INDEST,
-               IN_SENT_UP, BoutComm::get());
+  if ((UDATA_INDEST != -1)
+      && (dirs & COMM_YDOWN)) { // If there is a destination for inner x data
+    if (self_channel(0)) {
+      // Send to this processor itself (e.g. single processor along
+      // periodic field lines): copy the guard cells locally and skip
+      // MPI; the matching receive was never posted
+      len = local_exchange(ch, 0, std::begin(ch->umsg_sendbuff));
+    } else {
+      len = pack_data(ch->var_list.get(), 0, UDATA_XSPLIT, MYSUB + MYG - yd,
+                      MYSUB + MYG, std::begin(ch->umsg_sendbuff), ch->single);
+      // Send the data to processor UDATA_INDEST
+
+      if (async_send) {
+        MPI_Isend(std::begin(ch->umsg_sendbuff), // Buffer to send
+                  len,                           // Length of buffer in BoutReals
+                  mpi_type,                      // Real variable type
+                  UDATA_INDEST,                  // Destination processor
+                  IN_SENT_UP,                    // Label (tag) for the message
+                  BoutComm::get(), &(ch->sendreq[0]));
+      } else
+        MPI_Send(std::begin(ch->umsg_sendbuff), len, mpi_type, UDATA_INDEST,
+                 IN_SENT_UP, BoutComm::get());
+    }
   }
-  if (UDATA_OUTDEST != -1) {             // if destination for outer x data
+  if ((UDATA_OUTDEST != -1)
+      && (dirs & COMM_YDOWN)) {          // if destination for outer x data
     outbuff = &(ch->umsg_sendbuff[len]); // A pointer to the start of the second part
                                          // of the buffer
-    len =
-        pack_data(ch->var_list.get(), UDATA_XSPLIT, LocalNx, MYSUB, MYSUB + MYG, outbuff);
-    // Send the data to processor UDATA_OUTDEST
-    if (async_send) {
-      MPI_Isend(outbuff, len, PVEC_REAL_MPI_TYPE, UDATA_OUTDEST, OUT_SENT_UP,
-                BoutComm::get(), &(ch->sendreq[1]));
-    } else
-      MPI_Send(outbuff, len, PVEC_REAL_MPI_TYPE, UDATA_OUTDEST, OUT_SENT_UP,
-               BoutComm::get());
+    if (self_channel(1)) {
+      local_exchange(ch, 1, outbuff);
+    } else {
+      len = pack_data(ch->var_list.get(), UDATA_XSPLIT, LocalNx, MYSUB + MYG - yd,
+                      MYSUB + MYG, outbuff, ch->single);
+      // Send the data to processor UDATA_OUTDEST
+      if (async_send) {
+        MPI_Isend(outbuff, len, mpi_type, UDATA_OUTDEST, OUT_SENT_UP,
+                  BoutComm::get(), &(ch->sendreq[1]));
+      } else
+        MPI_Send(outbuff, len, mpi_type, UDATA_OUTDEST, OUT_SENT_UP,
+                 BoutComm::get());
+    }
   }
 
-  /// Send data going down (y-1)
+  /// Send data going down (y-1): fills the receiver's upper guards
 
   len = 0;
-  if (DDATA_INDEST != -1) { // If there is a destination for inner x data
-    len = pack_data(ch->var_list.get(), 0, DDATA_XSPLIT, MYG, 2 * MYG,
-                    std::begin(ch->dmsg_sendbuff));
-    // Send the data to processor DDATA_INDEST
-    if (async_send) {
-      MPI_Isend(std::begin(ch->dmsg_sendbuff), len, PVEC_REAL_MPI_TYPE, DDATA_INDEST,
-                IN_SENT_DOWN, BoutComm::get(), &(ch->sendreq[2]));
-    } else
-      MPI_Send(std::begin(ch->dmsg_sendbuff), len, PVEC_REAL_MPI_TYPE, DDATA_INDEST,
-               IN_SENT_DOWN, BoutComm::get());
+  if ((DDATA_INDEST != -1)
+      && (dirs & COMM_YUP)) { // If there is a destination for inner x data
+    if (self_channel(2)) {
+      len = local_exchange(ch, 2, std::begin(ch->dmsg_sendbuff));
+    } else {
+      len = pack_data(ch->var_list.get(), 0, DDATA_XSPLIT, MYG, MYG + yd,
+                      std::begin(ch->dmsg_sendbuff), ch->single);
+      // Send the data to processor DDATA_INDEST
+      if (async_send) {
+        MPI_Isend(std::begin(ch->dmsg_sendbuff), len, mpi_type, DDATA_INDEST,
+                  IN_SENT_DOWN, BoutComm::get(), &(ch->sendreq[2]));
+      } else
+        MPI_Send(std::begin(ch->dmsg_sendbuff), len, mpi_type, DDATA_INDEST,
+                 IN_SENT_DOWN, BoutComm::get());
+    }
   }
-  if (DDATA_OUTDEST != -1) {             // if destination for outer x data
+  if ((DDATA_OUTDEST != -1)
+      && (dirs & COMM_YUP)) {            // if destination for outer x data
     outbuff = &(ch->dmsg_sendbuff[len]); // A pointer to the start of the second part
                                          // of the buffer
-    len = pack_data(ch->var_list.get(), DDATA_XSPLIT, LocalNx, MYG, 2 * MYG, outbuff);
-    // Send the data to processor DDATA_OUTDEST
+    if (self_channel(3)) {
+      local_exchange(ch, 3, outbuff);
+    } else {
+      len = pack_data(ch->var_list.get(), DDATA_XSPLIT, LocalNx, MYG, MYG + yd, outbuff,
+                      ch->single);
+      // Send the data to processor DDATA_OUTDEST
 
-    if (async_send) {
-      MPI_Isend(outbuff, len, PVEC_REAL_MPI_TYPE, DDATA_OUTDEST, OUT_SENT_DOWN,
-                BoutComm::get(), &(ch->sendreq[3]));
-    } else
-      MPI_Send(outbuff, len, PVEC_REAL_MPI_TYPE, DDATA_OUTDEST, OUT_SENT_DOWN,
-               BoutComm::get());
+      if (async_send) {
+        MPI_Isend(outbuff, len, mpi_type, DDATA_OUTDEST, OUT_SENT_DOWN,
+                  BoutComm::get(), &(ch->sendreq[3]));
+      } else
+        MPI_Send(outbuff, len, mpi_type, DDATA_OUTDEST, OUT_SENT_DOWN,
+                 BoutComm::get());
+    }
   }
 
-  /// Send to the left (x-1)
+  /// Send to the left (x-1): fills the receiver's outer guards
 
-  if (IDATA_DEST != -1) {
-    len = pack_data(ch->var_list.get(), MXG, 2 * MXG, MYG, MYG + MYSUB,
-                    std::begin(ch->imsg_sendbuff));
-    if (async_send) {
-      MPI_Isend(std::begin(ch->imsg_sendbuff), len, PVEC_REAL_MPI_TYPE, IDATA_DEST,
-                IN_SENT_OUT, BoutComm::get(), &(ch->sendreq[4]));
-    } else
-      MPI_Send(std::begin(ch->imsg_sendbuff), len, PVEC_REAL_MPI_TYPE, IDATA_DEST,
-               IN_SENT_OUT, BoutComm::get());
+  if ((IDATA_DEST != -1) && (dirs & COMM_XOUT)) {
+    if (self_channel(4)) {
+      // Periodic in X on a single X processor
+      local_exchange(ch, 4, std::begin(ch->imsg_sendbuff));
+    } else {
+      len = pack_data(ch->var_list.get(), MXG, MXG + xd, MYG, MYG + MYSUB,
+                      std::begin(ch->imsg_sendbuff), ch->single);
+      if (async_send) {
+        MPI_Isend(std::begin(ch->imsg_sendbuff), len, mpi_type, IDATA_DEST,
+                  IN_SENT_OUT, BoutComm::get(), &(ch->sendreq[4]));
+      } else
+        MPI_Send(std::begin(ch->imsg_sendbuff), len, mpi_type, IDATA_DEST,
+                 IN_SENT_OUT, BoutComm::get());
+    }
   }
 
-  /// Send to the right (x+1)
+  /// Send to the right (x+1): fills the receiver's inner guards
 
-  if (ODATA_DEST != -1) {
-    len = pack_data(ch->var_list.get(), MXSUB, MXSUB + MXG, MYG, MYG + MYSUB,
-                    std::begin(ch->omsg_sendbuff));
-    if (async_send) {
-      MPI_Isend(std::begin(ch->omsg_sendbuff), len, PVEC_REAL_MPI_TYPE, ODATA_DEST,
-                OUT_SENT_IN, BoutComm::get(), &(ch->sendreq[5]));
-    } else
-      MPI_Send(std::begin(ch->omsg_sendbuff), len, PVEC_REAL_MPI_TYPE, ODATA_DEST,
-               OUT_SENT_IN, BoutComm::get());
+  if ((ODATA_DEST != -1) && (dirs & COMM_XIN)) {
+    if (self_channel(5)) {
+      local_exchange(ch, 5, std::begin(ch->omsg_sendbuff));
+    } else {
+      len = pack_data(ch->var_list.get(), MXSUB + MXG - xd, MXSUB + MXG, MYG,
+                      MYG + MYSUB, std::begin(ch->omsg_sendbuff), ch->single);
+      if (async_send) {
+        MPI_Isend(std::begin(ch->omsg_sendbuff), len, mpi_type, ODATA_DEST,
+                  OUT_SENT_IN, BoutComm::get(), &(ch->sendreq[5]));
+      } else
+        MPI_Send(std::begin(ch->omsg_sendbuff), len, mpi_type, ODATA_DEST,
+                 OUT_SENT_IN, BoutComm::get());
+    }
   }
 
   /// Mark communication handle as in progress
@@ -1057,100 +1828,117 @@ int BoutMesh::wait(comm_handle handle) {
   if (ch->var_list.size() == 0) {
 
     // Just waiting for a single MPI request
+    Timer wait_timer("mpi_wait");
     MPI_Wait(ch->request, &status);
     free_handle(ch);
 
     return 0;
   }
 
+  if (ch->shm_win != MPI_WIN_NULL) {
+    // Guard cells from on-node neighbours come straight out of the
+    // neighbour's shared send block; these channels have no MPI
+    // requests. Done first, since this data is typically ready long
+    // before the off-node messages arrive
+    if (shm_channel(ch, 0))
+      shm_receive(ch, 0, 0, UDATA_XSPLIT, MYSUB + MYG, MYSUB + MYG + ch->ydepth);
+    if (shm_channel(ch, 1))
+      shm_receive(ch, 1, UDATA_XSPLIT, LocalNx, MYSUB + MYG, MYSUB + MYG + ch->ydepth);
+    if (shm_channel(ch, 2))
+      shm_receive(ch, 2, 0, DDATA_XSPLIT, MYG - ch->ydepth, MYG);
+    if (shm_channel(ch, 3))
+      shm_receive(ch, 3, DDATA_XSPLIT, LocalNx, MYG - ch->ydepth, MYG);
+    if (shm_channel(ch, 4))
+      shm_receive(ch, 4, MXG - ch->xdepth, MXG, MYG, MYG + MYSUB);
+    if (shm_channel(ch, 5))
+      shm_receive(ch, 5, MXSUB + MXG, MXSUB + MXG + ch->xdepth, MYG, MYG + MYSUB);
+  }
+
   do {
-    MPI_Waitany(6, ch->request, &ind, &status);
+    {
+      // Time spent blocked on MPI, as opposed to packing/unpacking:
+      // this is where load imbalance between processors shows up
+      Timer wait_timer("mpi_wait");
+      MPI_Waitany(6, ch->request, &ind, &status);
+    }
     switch (ind) {
     case 0: { // Up, inner
-      unpack_data(ch->var_list.get(), 0, UDATA_XSPLIT, MYSUB + MYG, MYSUB + 2 * MYG,
-                  std::begin(ch->umsg_recvbuff));
+      unpack_data(ch->var_list.get(), 0, UDATA_XSPLIT, MYSUB + MYG,
+                  MYSUB + MYG + ch->ydepth, std::begin(ch->umsg_recvbuff), ch->single);
       break;
     }
     case 1: { // Up, outer
-      len = msg_len(ch->var_list.get(), 0, UDATA_XSPLIT, 0, MYG);
-      unpack_data(ch->var_list.get(), UDATA_XSPLIT, LocalNx, MYSUB + MYG, MYSUB + 2 * MYG,
-                  &(ch->umsg_recvbuff[len]));
+      len = msg_len(ch->var_list.get(), 0, UDATA_XSPLIT, 0, ch->ydepth);
+      unpack_data(ch->var_list.get(), UDATA_XSPLIT, LocalNx, MYSUB + MYG,
+                  MYSUB + MYG + ch->ydepth, &(ch->umsg_recvbuff[len]), ch->single);
       break;
     }
     case 2: { // Down, inner
-      unpack_data(ch->var_list.get(), 0, DDATA_XSPLIT, 0, MYG,
-                  std::begin(ch->dmsg_recvbuff));
+      unpack_data(ch->var_list.get(), 0, DDATA_XSPLIT, MYG - ch->ydepth, MYG,
+                  std::begin(ch->dmsg_recvbuff), ch->single);
       break;
     }
     case 3: { // Down, outer
-      len = msg_len(ch->var_list.get(), 0, DDATA_XSPLIT, 0, MYG);
-      unpack_data(ch->var_list.get(), DDATA_XSPLIT, LocalNx, 0, MYG,
-                  &(ch->dmsg_recvbuff[len]));
+      len = msg_len(ch->var_list.get(), 0, DDATA_XSPLIT, 0, ch->ydepth);
+      unpack_data(ch->var_list.get(), DDATA_XSPLIT, LocalNx, MYG - ch->ydepth, MYG,
+                  &(ch->dmsg_recvbuff[len]), ch->single);
       break;
     }
     case 4: { // inner
-      unpack_data(ch->var_list.get(), 0, MXG, MYG, MYG + MYSUB,
-                  std::begin(ch->imsg_recvbuff));
+      unpack_data(ch->var_list.get(), MXG - ch->xdepth, MXG, MYG, MYG + MYSUB,
+                  std::begin(ch->imsg_recvbuff), ch->single);
       break;
     }
     case 5: { // outer
-      unpack_data(ch->var_list.get(), MXSUB + MXG, MXSUB + 2 * MXG, MYG, MYG + MYSUB,
-                  std::begin(ch->omsg_recvbuff));
+      unpack_data(ch->var_list.get(), MXSUB + MXG, MXSUB + MXG + ch->xdepth, MYG,
+                  MYG + MYSUB, std::begin(ch->omsg_recvbuff), ch->single);
       break;
     }
     }
-    if (ind != MPI_UNDEFINED)
+    if ((ind != MPI_UNDEFINED) && !ch->persistent)
       ch->request[ind] = MPI_REQUEST_NULL;
   } while (ind != MPI_UNDEFINED);
 
-  if (async_send) {
+  if (async_send || ch->persistent) {
     /// Asyncronous sending: Need to check if sends have completed (frees MPI memory)
+    Timer wait_timer("mpi_wait");
     MPI_Status async_status;
 
-    if (UDATA_INDEST != -1)
+    // The conditions mirror the sends posted in send(): a scoped
+    // exchange (dirs != COMM_ALL) posted no send for unselected
+    // boundaries, so has nothing to wait for there
+    if ((UDATA_INDEST != -1) && (ch->dirs & COMM_YDOWN) && !self_channel(0))
       MPI_Wait(ch->sendreq, &async_status);
-    if (UDATA_OUTDEST != -1)
+    if ((UDATA_OUTDEST != -1) && (ch->dirs & COMM_YDOWN) && !self_channel(1))
       MPI_Wait(ch->sendreq + 1, &async_status);
-    if (DDATA_INDEST != -1)
+    if ((DDATA_INDEST != -1) && (ch->dirs & COMM_YUP) && !self_channel(2))
       MPI_Wait(ch->sendreq + 2, &async_status);
-    if (DDATA_OUTDEST != -1)
+    if ((DDATA_OUTDEST != -1) && (ch->dirs & COMM_YUP) && !self_channel(3))
       MPI_Wait(ch->sendreq + 3, &async_status);
-    if (IDATA_DEST != -1)
+    if ((IDATA_DEST != -1) && (ch->dirs & COMM_XOUT) && !self_channel(4))
       MPI_Wait(ch->sendreq + 4, &async_status);
-    if (ODATA_DEST != -1)
+    if ((ODATA_DEST != -1) && (ch->dirs & COMM_XIN) && !self_channel(5))
       MPI_Wait(ch->sendreq + 5, &async_status);
   }
 
   // TWIST-SHIFT CONDITION
   if (TwistShift) {
-    int jx, jy;
-
-    // Perform Twist-shift using shifting method
-    // Loop over 3D fields
+    // Apply the precomputed phase tables to the guard cells just
+    // received. Loop over 3D fields
     for (const auto &var : ch->var_list.field3d()) {
-      // Lower boundary
-      if (TS_down_in && (DDATA_INDEST != -1)) {
-        for (jx = 0; jx < DDATA_XSPLIT; jx++)
-          for (jy = 0; jy != MYG; jy++)
-            shiftZ(*var, jx, jy, ShiftAngle[jx]);
-      }
-      if (TS_down_out && (DDATA_OUTDEST != -1)) {
-        for (jx = DDATA_XSPLIT; jx < LocalNx; jx++)
-          for (jy = 0; jy != MYG; jy++)
-            shiftZ(*var, jx, jy, ShiftAngle[jx]);
-      }
+      // Lower boundary. Only the guard rows actually filled by this
+      // exchange are transformed: shifting cells a scoped exchange
+      // did not refresh would corrupt them
+      if (TS_down_in && (DDATA_INDEST != -1) && (ch->dirs & COMM_YDOWN))
+        applyTwistShift(*var, 0, DDATA_XSPLIT, MYG - ch->ydepth, ch->ydepth, true);
+      if (TS_down_out && (DDATA_OUTDEST != -1) && (ch->dirs & COMM_YDOWN))
+        applyTwistShift(*var, DDATA_XSPLIT, LocalNx, MYG - ch->ydepth, ch->ydepth, true);
 
       // Upper boundary
-      if (TS_up_in && (UDATA_INDEST != -1)) {
-        for (jx = 0; jx < UDATA_XSPLIT; jx++)
-          for (jy = LocalNy - MYG; jy != LocalNy; jy++)
-            shiftZ(*var, jx, jy, -ShiftAngle[jx]);
-      }
-      if (TS_up_out && (UDATA_OUTDEST != -1)) {
-        for (jx = UDATA_XSPLIT; jx < LocalNx; jx++)
-          for (jy = LocalNy - MYG; jy != LocalNy; jy++)
-            shiftZ(*var, jx, jy, -ShiftAngle[jx]);
-      }
+      if (TS_up_in && (UDATA_INDEST != -1) && (ch->dirs & COMM_YUP))
+        applyTwistShift(*var, 0, UDATA_XSPLIT, LocalNy - MYG, ch->ydepth, false);
+      if (TS_up_out && (UDATA_OUTDEST != -1) && (ch->dirs & COMM_YUP))
+        applyTwistShift(*var, UDATA_XSPLIT, LocalNx, LocalNy - MYG, ch->ydepth, false);
     }
   }
 
@@ -1160,11 +1948,62 @@ int BoutMesh::wait(comm_handle handle) {
     var->doneComms();
 #endif
 
-  free_handle(ch);
+  if (ch->persistent) {
+    // Requests and buffers are cached in persistent_handles for reuse
+    ch->in_progress = false;
+  } else {
+    free_handle(ch);
+  }
 
   return 0;
 }
 
+void BoutMesh::applyTwistShift(Field3D &var, int xge, int xlt, int ybase, int nrows,
+                               bool lower) {
+  TRACE("BoutMesh::applyTwistShift");
+
+  const int ncz = LocalNz;
+  if ((ncz == 1) || (xge >= xlt) || (nrows < 1))
+    return; // Shifting doesn't do anything
+
+  const int nmodes = ncz / 2 + 1;
+
+  if (ts_phase.empty()) {
+    // Build the phase table on first use, once the Coordinates (and so
+    // zlength) are available. ShiftAngle is fixed for the run, so the
+    // trigonometry is done here once instead of at every communication
+    const BoutReal zlength = getCoordinates()->zlength();
+    ts_phase = Matrix<dcomplex>(LocalNx, nmodes);
+    for (int jx = 0; jx < LocalNx; jx++) {
+      for (int jz = 0; jz < nmodes; jz++) {
+        const BoutReal kwave = jz * 2.0 * PI / zlength; // wave number is 1/[rad]
+        ts_phase(jx, jz) =
+            dcomplex(cos(kwave * ShiftAngle[jx]), -sin(kwave * ShiftAngle[jx]));
+      }
+    }
+  }
+
+  checkData(var);
+  var.allocate(); // Ensure the data is unique before shifting in place
+
+  // The guard rows at each jx are contiguous in memory, so they
+  // transform in one batched FFT call per jx rather than one plan
+  // execution per (jx, jy) point
+  Array<dcomplex> buf(nrows * nmodes);
+  for (int jx = xge; jx < xlt; jx++) {
+    rfft_many(&var(jx, ybase, 0), ncz, nrows, buf.begin());
+    for (int jy = 0; jy < nrows; jy++) {
+      dcomplex *c = buf.begin() + jy * nmodes;
+      for (int jz = 1; jz < nmodes; jz++) {
+        // The table holds the lower-boundary (+ShiftAngle) factor; the
+        // upper boundary shifts the other way, i.e. the conjugate
+        c[jz] *= lower ? ts_phase(jx, jz) : conj(ts_phase(jx, jz));
+      }
+    }
+    irfft_many(buf.begin(), ncz, nrows, &var(jx, ybase, 0));
+  }
+}
+
 /***************************************************************
  *             Non-Local Communications
  ***************************************************************/
@@ -1238,6 +2077,40 @@ int BoutMesh::sendXIn(BoutReal *buffer, int size, int tag) {
   return 0;
 }
 
+comm_handle BoutMesh::isendXOut(BoutReal *buffer, int size, int tag) {
+  if (PE_XIND == NXPE - 1)
+    return nullptr;
+
+  Timer timer("comms");
+
+  // Get a communications handle. Not fussy about size of arrays
+  CommHandle *ch = get_handle(0, 0);
+
+  MPI_Isend(buffer, size, PVEC_REAL_MPI_TYPE, PROC_NUM(PE_XIND + 1, PE_YIND), tag,
+            BoutComm::get(), ch->request);
+
+  ch->in_progress = true;
+
+  return static_cast<comm_handle>(ch);
+}
+
+comm_handle BoutMesh::isendXIn(BoutReal *buffer, int size, int tag) {
+  if (PE_XIND == 0)
+    return nullptr;
+
+  Timer timer("comms");
+
+  // Get a communications handle. Not fussy about size of arrays
+  CommHandle *ch = get_handle(0, 0);
+
+  MPI_Isend(buffer, size, PVEC_REAL_MPI_TYPE, PROC_NUM(PE_XIND - 1, PE_YIND), tag,
+            BoutComm::get(), ch->request);
+
+  ch->in_progress = true;
+
+  return static_cast<comm_handle>(ch);
+}
+
 comm_handle BoutMesh::irecvXOut(BoutReal *buffer, int size, int tag) {
   if (PE_XIND == NXPE - 1)
     return nullptr;
@@ -1887,7 +2760,22 @@ BoutMesh::CommHandle *BoutMesh::get_handle(int xlen, int ylen) {
     ch->xbufflen = xlen;
     ch->ybufflen = ylen;
 
+    // Full guard depth and precision until send() records what the
+    // group needs
+    ch->xdepth = MXG;
+    ch->ydepth = MYG;
+    ch->single = false;
+
     ch->in_progress = false;
+    ch->persistent = false;
+    ch->dirs = COMM_ALL;
+
+    // Pooled handles never use the shared-memory path
+    ch->shm_win = MPI_WIN_NULL;
+    ch->shm_base = nullptr;
+    for (auto &p : ch->shm_peer)
+      p = nullptr;
+    ch->shm_epoch = 0;
 
     return ch;
   }
@@ -1915,6 +2803,7 @@ BoutMesh::CommHandle *BoutMesh::get_handle(int xlen, int ylen) {
   }
 
   ch->in_progress = false;
+  ch->persistent = false;
 
   ch->var_list.clear();
 
@@ -1934,74 +2823,183 @@ void BoutMesh::clear_handles() {
 
     comm_list.pop_front();
   }
+
+  for (const auto &it : persistent_handles) {
+    CommHandle *ch = it.second;
+    for (auto &req : ch->request) {
+      if (req != MPI_REQUEST_NULL)
+        MPI_Request_free(&req);
+    }
+    for (auto &req : ch->sendreq) {
+      if (req != MPI_REQUEST_NULL)
+        MPI_Request_free(&req);
+    }
+    delete ch;
+  }
+  persistent_handles.clear();
+
+  // MPI_Win_free is collective over the node, so free the shared
+  // windows in creation order: the persistent_handles map above
+  // iterates in pointer order, which differs between processors
+  for (auto &win : shm_windows) {
+    MPI_Win_unlock_all(win);
+    MPI_Win_free(&win);
+  }
+  shm_windows.clear();
 }
 
 /****************************************************************
  *                   Communication utilities
  ****************************************************************/
 
-int BoutMesh::pack_data(const vector<FieldData *> &var_list, int xge, int xlt, int yge,
-                        int ylt, BoutReal *buffer) {
+MPI_Comm BoutMesh::createGraphComm() {
+  // Gather this processor's communication partners: up and down in Y
+  // (split into inward/outward parts at branch cuts), and in and out
+  // in X. Guard-cell exchange is symmetric, so the same list serves
+  // as both sources and destinations
+  vector<int> neighbours;
+  for (int proc : {UDATA_INDEST, UDATA_OUTDEST, DDATA_INDEST, DDATA_OUTDEST,
+                   IDATA_DEST, ODATA_DEST}) {
+    if ((proc >= 0) && (proc != MYPE)) {
+      neighbours.push_back(proc);
+    }
+  }
 
-  int len = 0;
+  // Remove duplicates (e.g. the same processor both inward and
+  // outward of a branch cut)
+  std::sort(neighbours.begin(), neighbours.end());
+  neighbours.erase(std::unique(neighbours.begin(), neighbours.end()),
+                   neighbours.end());
+
+  int nneighbours = static_cast<int>(neighbours.size());
+
+  MPI_Comm graph_comm;
+  int status = MPI_Dist_graph_create_adjacent(
+      BoutComm::get(), nneighbours, neighbours.data(), MPI_UNWEIGHTED, nneighbours,
+      neighbours.data(), MPI_UNWEIGHTED, MPI_INFO_NULL, 1 /* reorder */, &graph_comm);
+
+  if (status != MPI_SUCCESS) {
+    output_warn.write("\tWARNING: Could not create graph communicator. "
+                      "Keeping the default rank order\n");
+    return MPI_COMM_NULL;
+  }
 
-  /// Loop over variables
-  for (const auto &var : var_list) {
-    if (var->is3D()) {
-      // 3D variable
-      ASSERT2(static_cast<Field3D *>(var)->isAllocated());
-      auto& var3d_ref = *static_cast<Field3D *>(var);
+  return graph_comm;
+}
+
+int BoutMesh::pack_data(const vector<FieldData *> &var_list, int xge, int xlt, int yge,
+                        int ylt, BoutReal *buffer, bool single) {
+
+  const int nx = xlt - xge;
+  const int ny = ylt - yge;
+
+  // Each field's length in the buffer depends only on the region
+  // size, so the offsets can be computed up front and the fields
+  // then packed independently, threading across the group
+  const int nvars = static_cast<int>(var_list.size());
+  vector<int> offset(nvars + 1);
+  offset[0] = 0;
+  for (int v = 0; v < nvars; v++) {
+    offset[v + 1] = offset[v] + (var_list[v]->is3D() ? nx * ny * LocalNz : nx * ny);
+  }
+
+  BOUT_OMP(parallel for schedule(OPENMP_SCHEDULE))
+  for (int v = 0; v < nvars; v++) {
+    // Single-precision groups convert on pack: the same buffer holds
+    // floats, so half the bytes go on the wire. The conversion loop
+    // vectorises; offsets are in values either way
+    BoutReal *buf = buffer + offset[v];
+    float *fbuf = reinterpret_cast<float *>(buffer) + offset[v];
+    if (var_list[v]->is3D()) {
+      // 3D variable. y and z are contiguous in field storage, so
+      // each x index is a single contiguous run
+      ASSERT2(static_cast<Field3D *>(var_list[v])->isAllocated());
+      auto &var3d_ref = *static_cast<Field3D *>(var_list[v]);
+      const int run = ny * LocalNz;
       for (int jx = xge; jx != xlt; jx++) {
-        for (int jy = yge; jy < ylt; jy++) {
-          for (int jz = 0; jz < LocalNz; jz++, len++) {
-            buffer[len] = var3d_ref(jx, jy, jz);
-          }
+        const BoutReal *src = &var3d_ref(jx, yge, 0);
+        if (single) {
+          for (int i = 0; i < run; i++)
+            fbuf[i] = static_cast<float>(src[i]);
+          fbuf += run;
+        } else {
+          memcpy(buf, src, run * sizeof(BoutReal));
+          buf += run;
         }
       }
     } else {
-      // 2D variable
-      ASSERT2(static_cast<Field2D *>(var)->isAllocated());
-      auto& var2d_ref = *static_cast<Field2D *>(var);
+      // 2D variable: one contiguous run of y values per x index
+      ASSERT2(static_cast<Field2D *>(var_list[v])->isAllocated());
+      auto &var2d_ref = *static_cast<Field2D *>(var_list[v]);
       for (int jx = xge; jx != xlt; jx++) {
-        for (int jy = yge; jy < ylt; jy++, len++) {
-          buffer[len] = var2d_ref(jx, jy);
+        const BoutReal *src = &var2d_ref(jx, yge);
+        if (single) {
+          for (int i = 0; i < ny; i++)
+            fbuf[i] = static_cast<float>(src[i]);
+          fbuf += ny;
+        } else {
+          memcpy(buf, src, ny * sizeof(BoutReal));
+          buf += ny;
         }
       }
     }
   }
 
-  return (len);
+  return offset[nvars];
 }
 
 int BoutMesh::unpack_data(const vector<FieldData *> &var_list, int xge, int xlt, int yge,
-                          int ylt, BoutReal *buffer) {
-
-  int len = 0;
-
-  /// Loop over variables
-  for (const auto &var : var_list) {
-    if (var->is3D()) {
-      // 3D variable
-      auto& var3d_ref = *static_cast<Field3D *>(var);
+                          int ylt, BoutReal *buffer, bool single) {
+
+  const int nx = xlt - xge;
+  const int ny = ylt - yge;
+
+  // Mirror of pack_data: compute per-field offsets, then unpack the
+  // fields independently
+  const int nvars = static_cast<int>(var_list.size());
+  vector<int> offset(nvars + 1);
+  offset[0] = 0;
+  for (int v = 0; v < nvars; v++) {
+    offset[v + 1] = offset[v] + (var_list[v]->is3D() ? nx * ny * LocalNz : nx * ny);
+  }
+
+  BOUT_OMP(parallel for schedule(OPENMP_SCHEDULE))
+  for (int v = 0; v < nvars; v++) {
+    const BoutReal *buf = buffer + offset[v];
+    const float *fbuf = reinterpret_cast<const float *>(buffer) + offset[v];
+    if (var_list[v]->is3D()) {
+      // 3D variable: contiguous run of (y,z) values per x index
+      auto &var3d_ref = *static_cast<Field3D *>(var_list[v]);
+      const int run = ny * LocalNz;
       for (int jx = xge; jx != xlt; jx++) {
-        for (int jy = yge; jy < ylt; jy++) {
-          for (int jz = 0; jz < LocalNz; jz++, len++) {
-            var3d_ref(jx, jy, jz) = buffer[len];
-          }
+        BoutReal *dst = &var3d_ref(jx, yge, 0);
+        if (single) {
+          for (int i = 0; i < run; i++)
+            dst[i] = static_cast<BoutReal>(fbuf[i]);
+          fbuf += run;
+        } else {
+          memcpy(dst, buf, run * sizeof(BoutReal));
+          buf += run;
         }
       }
     } else {
-      // 2D variable
-      auto& var2d_ref = *static_cast<Field2D *>(var);
+      // 2D variable: contiguous run of y values per x index
+      auto &var2d_ref = *static_cast<Field2D *>(var_list[v]);
       for (int jx = xge; jx != xlt; jx++) {
-        for (int jy = yge; jy < ylt; jy++, len++) {
-          var2d_ref(jx, jy) = buffer[len];
+        BoutReal *dst = &var2d_ref(jx, yge);
+        if (single) {
+          for (int i = 0; i < ny; i++)
+            dst[i] = static_cast<BoutReal>(fbuf[i]);
+          fbuf += ny;
+        } else {
+          memcpy(dst, buf, ny * sizeof(BoutReal));
+          buf += ny;
         }
       }
     }
   }
 
-  return (len);
+  return offset[nvars];
 }
 
 /****************************************************************
@@ -6,8 +6,11 @@
 
 #include <bout/mesh.hxx>
 #include "unused.hxx"
+#include <dcomplex.hxx>
+#include <utils.hxx>
 
 #include <list>
+#include <map>
 #include <vector>
 #include <cmath>
 
@@ -45,6 +48,12 @@ class BoutMesh : public Mesh {
   ///
   comm_handle send(FieldGroup &g);
 
+  /// Exchange only the guard regions selected by \p dirs
+  /// (Mesh::CommDir flags), posting no messages for the others. Used
+  /// by diagnostics which need e.g. only the Y guard cells, or a
+  /// single boundary
+  comm_handle send(FieldGroup &g, int dirs);
+
   /// Wait for a send operation to complete
   /// @param[in] handle  The handle returned by send()
   int wait(comm_handle handle);
@@ -80,6 +89,13 @@ class BoutMesh : public Mesh {
   /// @param[in] tag     A label for the communication. Must be the same at receive
   int sendXIn(BoutReal *buffer, int size, int tag);
 
+  /// Non-blocking version of sendXOut, using a pooled communication
+  /// handle. \p buffer must stay valid until the handle is waited on
+  comm_handle isendXOut(BoutReal *buffer, int size, int tag);
+
+  /// Non-blocking version of sendXIn; see isendXOut
+  comm_handle isendXIn(BoutReal *buffer, int size, int tag);
+
   /// Receive a buffer of data from X index +1
   ///
   /// @param[in] buffer  A buffer to put the data in. Must already be allocated of length \p size
@@ -174,6 +190,7 @@ class BoutMesh : public Mesh {
 
   int PE_YIND; ///< Y index of this processor
   int NYPE; // Number of processors in the Y direction
+  int NZPE; // Number of processors in the Z direction. Only 1 supported
 
   int MYPE_IN_CORE;  // 1 if processor in core
 
@@ -196,6 +213,18 @@ class BoutMesh : public Mesh {
   // Twist-shift switches
   bool TS_up_in, TS_up_out, TS_down_in, TS_down_out;
 
+  /// Precomputed twist-shift phase factors exp(-i k ShiftAngle[jx]),
+  /// indexed (jx, mode). ShiftAngle is fixed, so the trigonometric
+  /// factors are computed once rather than in every communication
+  Matrix<dcomplex> ts_phase;
+
+  /// Apply the twist-shift z-shift to the Y guard cells of \p var over
+  /// x indices [xge, xlt), using the precomputed phase table. \p ybase
+  /// is the first of the \p nrows guard rows that were filled by the
+  /// exchange; \p lower selects the shift direction
+  void applyTwistShift(Field3D &var, int xge, int xlt, int ybase, int nrows,
+                       bool lower);
+
   // Communication parameters calculated by topology
   int UDATA_INDEST, UDATA_OUTDEST, UDATA_XSPLIT;
   int DDATA_INDEST, DDATA_OUTDEST, DDATA_XSPLIT;
@@ -216,6 +245,12 @@ class BoutMesh : public Mesh {
   void set_connection(int ypos1, int ypos2, int xge, int xlt, bool ts = false);
   void add_target(int ypos, int xge, int xlt);
   void topology();
+
+  /// Create a distributed-graph communicator describing this
+  /// processor's communication partners (as set up by topology()),
+  /// allowing the MPI library to renumber the processors to match the
+  /// machine topology. Returns MPI_COMM_NULL on failure
+  MPI_Comm createGraphComm();
   
   void addBoundaryRegions(); ///< Adds 2D and 3D regions for boundaries
   
@@ -226,6 +261,23 @@ class BoutMesh : public Mesh {
   // Communications
 
   bool async_send;   ///< Switch to asyncronous sends (ISend, not Send)
+  bool persistent_comms; ///< Switch to persistent MPI requests (Send_init/Recv_init)
+  bool shared_comms; ///< Switch to shared-memory exchange with on-node neighbours
+
+  bool dump_comm_graph; ///< Record the halo-exchange pattern, written at shutdown
+
+  /// Number of messages per directed edge of the communication graph:
+  /// (peer rank, message length in BoutReals) -> count. Two tables,
+  /// one each way, filled by record_comm_graph()
+  std::map<std::pair<int, int>, long> comm_graph_sends;
+  std::map<std::pair<int, int>, long> comm_graph_recvs;
+
+  /// Add one halo exchange's messages to the communication graph tables
+  void record_comm_graph(const std::vector<FieldData *> &vars, int xd, int yd, int dirs);
+
+  /// Write the recorded communication graph to datadir/comm_graph.<rank>,
+  /// for replay with tools/bout-commbench
+  void dumpCommGraph();
 
   /// Communication handle
   /// Used to keep track of communications between send and receive
@@ -235,9 +287,25 @@ class BoutMesh : public Mesh {
     /// Array of send requests (for non-blocking send). One for each possible neighbour; one each way in X, two each way in Y
     MPI_Request sendreq[6];
     int xbufflen, ybufflen;  ///< Length of the buffers used to send/receive (in BoutReals)
+    int xdepth, ydepth; ///< Guard cell depth this exchange ships (<= MXG, MYG),
+                        ///< from the group's halo depth
+    bool single; ///< Guard cells converted to float in the buffers, and
+                 ///< sent as MPI_FLOAT, from the group's precision setting
     Array<BoutReal> umsg_sendbuff, dmsg_sendbuff, imsg_sendbuff, omsg_sendbuff; ///< Sending buffers
     Array<BoutReal> umsg_recvbuff, dmsg_recvbuff, imsg_recvbuff, omsg_recvbuff; ///< Receiving buffers
     bool in_progress; ///< Is the communication still going?
+    bool persistent; ///< Are request/sendreq persistent (Send_init/Recv_init) requests?
+    int dirs; ///< Guard regions this exchange fills (Mesh::CommDir flags)
+
+    /// Shared-memory exchange state (persistent handles with
+    /// shared_comms only, otherwise MPI_WIN_NULL). Each processor's
+    /// segment of the window holds per-channel flags followed by one
+    /// packed send block per channel; on-node neighbours unpack
+    /// directly from each other's segments
+    MPI_Win shm_win;
+    char *shm_base;    ///< This processor's segment of shm_win
+    char *shm_peer[6]; ///< Each on-node neighbour's segment (nullptr if off-node)
+    long shm_epoch;    ///< Number of exchanges of this group, for flag synchronisation
 
     /// List of fields being communicated
     FieldGroup var_list;
@@ -247,6 +315,65 @@ class BoutMesh : public Mesh {
   void clear_handles();
   list<CommHandle*> comm_list; // List of allocated communication handles
 
+  /// Return the cached persistent-communication handle for this group
+  /// of fields, creating it (with MPI_Send_init/MPI_Recv_init and
+  /// dedicated pack buffers) on first use
+  CommHandle* get_persistent_handle(FieldGroup &g, int xlen, int ylen);
+  /// Persistent handles, keyed on the group's set of fields. The MPI
+  /// requests and pack buffers are set up once and restarted each call
+  std::map<std::vector<FieldData*>, CommHandle*> persistent_handles;
+
+  //////////////////////////////////////////////////
+  // Shared-memory (intra-node) guard cell exchange
+
+  /// Communicator containing the processors able to share memory with
+  /// this one (in practice: on the same node). MPI_COMM_NULL until
+  /// first used
+  MPI_Comm comm_shared;
+
+  /// Rank in comm_shared of each neighbour, indexed by communication
+  /// channel (up-in, up-out, down-in, down-out, inner, outer).
+  /// MPI_UNDEFINED for off-node or missing neighbours, which keep the
+  /// ordinary MPI path
+  int shm_neighbour[6];
+
+  /// Shared windows in creation order. MPI_Win_free is collective over
+  /// the node, so they must be freed in the same order on every
+  /// processor; the persistent_handles map iterates in pointer order,
+  /// which differs between processors
+  std::vector<MPI_Win> shm_windows;
+
+  /// Create comm_shared and translate the neighbour ranks into it.
+  /// Called lazily once the topology is known. Collective
+  void setupSharedComms();
+
+  /// True if this handle exchanges \p channel through shared memory.
+  /// Self-sends (see self_channel) are excluded: they are copied
+  /// locally without going through the window
+  bool shm_channel(CommHandle *ch, int channel);
+
+  /// Is communication channel \p channel (up-in, up-out, down-in,
+  /// down-out, inner, outer) a send to this processor itself? This
+  /// happens in Y-serial layouts with closed field lines (a single
+  /// processor along periodic field lines) and with periodic X on a
+  /// single X processor. These exchanges get no MPI requests at all:
+  /// the guard cells are copied across the domain locally
+  bool self_channel(int channel) const;
+
+  /// Perform the self-send of \p channel locally: pack the outgoing
+  /// cells through \p buffer and unpack them straight into the guard
+  /// region that the matching receive would have filled. Returns the
+  /// packed length in values
+  int local_exchange(CommHandle *ch, int channel, BoutReal *buffer);
+
+  /// Pack guard cells [xge:xlt)x[yge:ylt) into this processor's send
+  /// block for \p channel and flag the data ready for the neighbour
+  void shm_send(CommHandle *ch, int channel, int xge, int xlt, int yge, int ylt);
+
+  /// Wait for the on-node neighbour's matching send block and unpack
+  /// it into guard cells [xge:xlt)x[yge:ylt)
+  void shm_receive(CommHandle *ch, int channel, int xge, int xlt, int yge, int ylt);
+
   //////////////////////////////////////////////////
   // X communicator
 
@@ -263,10 +390,16 @@ class BoutMesh : public Mesh {
   /// Create the MPI requests to receive data. Non-blocking call.
   void post_receive(CommHandle &ch);
 
-  /// Take data from objects and put into a buffer
-  int pack_data(const vector<FieldData*> &var_list, int xge, int xlt, int yge, int ylt, BoutReal *buffer);
-  /// Copy data from a buffer back into the fields
-  int unpack_data(const vector<FieldData*> &var_list, int xge, int xlt, int yge, int ylt, BoutReal *buffer);
+  /// Take data from objects and put into a buffer. If \p single is
+  /// true the values are converted to float in the buffer, which must
+  /// still be at least the returned length in BoutReals. Returns the
+  /// number of values packed
+  int pack_data(const vector<FieldData*> &var_list, int xge, int xlt, int yge, int ylt,
+                BoutReal *buffer, bool single = false);
+  /// Copy data from a buffer back into the fields. \p single must
+  /// match the value the buffer was packed with
+  int unpack_data(const vector<FieldData*> &var_list, int xge, int xlt, int yge, int ylt,
+                  BoutReal *buffer, bool single = false);
 };
 
 #endif // __BOUTMESH_H__
@@ -53,6 +53,8 @@
 #include <bout/openmpwrap.hxx>
 
 #include <msg_stack.hxx>
+#include <bout/offload.hxx>
+#include <bout/stencil_view.hxx>
 #include <stencils.hxx>
 #include <utils.hxx>
 #include <unused.hxx>
@@ -74,7 +76,7 @@ BoutReal VANLEER(BoutReal r) { return r + fabs(r) / (1.0 + fabs(r)); }
 
 // Superbee limiter
 BoutReal SUPERBEE(BoutReal r) {
-  return BOUTMAX(0.0, BOUTMIN(2. * r, 1.0), BOUTMIN(r, 2.));
+  return BOUTMAX(BoutReal(0.0), BOUTMIN(BoutReal(2.) * r, BoutReal(1.0)), BOUTMIN(r, BoutReal(2.)));
 }
 
 /*******************************************************************************
@@ -641,11 +643,53 @@ void Mesh::derivs_init(Options *options) {
  * loc  is the cell location of the result
  *******************************************************************************/
 
+
+BoutReal D4DX4_C2(stencil &f); // Defined below, with the fourth derivatives
+
+/// Wraps a differencing function as a compile-time constant, so that
+/// calls through operator() inline the stencil arithmetic into the
+/// surrounding loop (and let it vectorize), instead of going through a
+/// function pointer at every point
+template <BoutReal (*func)(stencil &)>
+struct InlineDeriv {
+  BoutReal operator()(stencil &s) const { return func(s); }
+};
+
+/// Dispatch a derivative loop. The common differencing kernels are bound
+/// as template arguments of the loop (see InlineDeriv), selected by a
+/// single comparison per field rather than an indirect call per point;
+/// any other kernel falls back to the function-pointer version.
+#define DERIV_INLINE_DISPATCH(impl, var, func, outloc, region)             \
+  if (func == DDX_C2)                                                      \
+    return impl(this, var, InlineDeriv<DDX_C2>(), outloc, region);         \
+  if (func == DDX_C4)                                                      \
+    return impl(this, var, InlineDeriv<DDX_C4>(), outloc, region);         \
+  if (func == DDX_CWENO2)                                                  \
+    return impl(this, var, InlineDeriv<DDX_CWENO2>(), outloc, region);     \
+  if (func == DDX_CWENO3)                                                  \
+    return impl(this, var, InlineDeriv<DDX_CWENO3>(), outloc, region);     \
+  if (func == DDX_S2)                                                      \
+    return impl(this, var, InlineDeriv<DDX_S2>(), outloc, region);         \
+  if (func == D2DX2_C2)                                                    \
+    return impl(this, var, InlineDeriv<D2DX2_C2>(), outloc, region);       \
+  if (func == D2DX2_C4)                                                    \
+    return impl(this, var, InlineDeriv<D2DX2_C4>(), outloc, region);       \
+  if (func == D4DX4_C2)                                                    \
+    return impl(this, var, InlineDeriv<D4DX4_C2>(), outloc, region);       \
+  if (func == DDX_C2_stag)                                                 \
+    return impl(this, var, InlineDeriv<DDX_C2_stag>(), outloc, region);    \
+  if (func == DDX_C4_stag)                                                 \
+    return impl(this, var, InlineDeriv<DDX_C4_stag>(), outloc, region);    \
+  if (func == D2DX2_C2_stag)                                               \
+    return impl(this, var, InlineDeriv<D2DX2_C2_stag>(), outloc, region);  \
+  return impl(this, var, func, outloc, region)
+
 // X derivative
 
-const Field2D Mesh::applyXdiff(const Field2D &var, Mesh::deriv_func func,
-                               CELL_LOC outloc, REGION region) {
-  ASSERT1(this == var.getMesh());
+template <typename DerivFunc>
+const Field2D applyXdiffImpl(Mesh *mesh, const Field2D &var, DerivFunc func,
+                             CELL_LOC outloc, const std::string &region_str) {
+  ASSERT1(mesh == var.getMesh());
   ASSERT1(var.isAllocated());
   CELL_LOC inloc = var.getLocation();
   if (outloc == CELL_DEFAULT)
@@ -655,28 +699,26 @@ const Field2D Mesh::applyXdiff(const Field2D &var, Mesh::deriv_func func,
           (outloc == CELL_XLOW && inloc == CELL_CENTRE));
 
   if (var.getNx() == 1) {
-    auto tmp = Field2D(0., this);
+    auto tmp = Field2D(0., mesh);
     tmp.setLocation(var.getLocation());
     return tmp;
   }
 
-  /// Convert REGION enum to a Region string identifier
-  const auto region_str = REGION_STRING(region);
   
-  Field2D result(this);
+  Field2D result(mesh);
   result.allocate(); // Make sure data allocated
   result.setLocation(outloc);
 
-  if (this->StaggerGrids && (outloc != inloc)) {
+  if (mesh->StaggerGrids && (outloc != inloc)) {
     // Staggered differencing
 
-    if (this->xstart > 1) {
+    if (mesh->xstart > 1) {
       // More than one guard cell, so set pp and mm values
       // This allows higher-order methods to be used
       BOUT_OMP(parallel)
       {
         stencil s;
-        BOUT_FOR_INNER(i, this->getRegion2D(region_str)) {
+        BOUT_FOR_INNER(i, mesh->getRegion2D(region_str)) {
           s.mm = var[i.xmm()];
           s.m = var[i.xm()];
           s.c = var[i];
@@ -701,7 +743,7 @@ const Field2D Mesh::applyXdiff(const Field2D &var, Mesh::deriv_func func,
       BOUT_OMP(parallel)
       {
         stencil s;
-        BOUT_FOR_INNER(i, this->getRegion2D(region_str)) {
+        BOUT_FOR_INNER(i, mesh->getRegion2D(region_str)) {
           s.m = var[i.xm()];
           s.c = var[i];
           s.p = var[i.xp()];
@@ -724,13 +766,13 @@ const Field2D Mesh::applyXdiff(const Field2D &var, Mesh::deriv_func func,
   } else {
     // Non-staggered differencing
 
-    if (this->xstart > 1) {
+    if (mesh->xstart > 1) {
       // More than one guard cell, so set pp and mm values
       // This allows higher-order methods to be used
       BOUT_OMP(parallel)
       {
         stencil s;
-        BOUT_FOR_INNER(i, this->getRegion2D(region_str)) {
+        BOUT_FOR_INNER(i, mesh->getRegion2D(region_str)) {
           s.mm = var[i.xmm()];
           s.m = var[i.xm()];
           s.c = var[i];
@@ -745,7 +787,7 @@ const Field2D Mesh::applyXdiff(const Field2D &var, Mesh::deriv_func func,
       BOUT_OMP(parallel)
       {
         stencil s;
-        BOUT_FOR_INNER(i, this->getRegion2D(region_str)) {
+        BOUT_FOR_INNER(i, mesh->getRegion2D(region_str)) {
           s.m = var[i.xm()];
           s.c = var[i];
           s.p = var[i.xp()];
@@ -764,10 +806,21 @@ const Field2D Mesh::applyXdiff(const Field2D &var, Mesh::deriv_func func,
   return result;
 }
 
-const Field3D Mesh::applyXdiff(const Field3D &var, Mesh::deriv_func func,
+const Field2D Mesh::applyXdiff(const Field2D &var, Mesh::deriv_func func,
                                CELL_LOC outloc, REGION region) {
+  return applyXdiff(var, func, outloc, REGION_STRING(region));
+}
+
+const Field2D Mesh::applyXdiff(const Field2D &var, Mesh::deriv_func func,
+                               CELL_LOC outloc, const std::string &region) {
+  DERIV_INLINE_DISPATCH(applyXdiffImpl, var, func, outloc, region);
+}
+
+template <typename DerivFunc>
+const Field3D applyXdiffImpl(Mesh *mesh, const Field3D &var, DerivFunc func,
+                             CELL_LOC outloc, const std::string &region_str) {
   // Check that the mesh is correct
-  ASSERT1(this == var.getMesh());
+  ASSERT1(mesh == var.getMesh());
   // Check that the input variable has data
   ASSERT1(var.isAllocated());
 
@@ -779,33 +832,38 @@ const Field3D Mesh::applyXdiff(const Field3D &var, Mesh::deriv_func func,
           (outloc == CELL_XLOW && inloc == CELL_CENTRE));
 
   if (var.getNx() == 1) {
-    auto tmp = Field3D(0., this);
+    auto tmp = Field3D(0., mesh);
     tmp.setLocation(var.getLocation());
     return tmp;
   }
 
-  /// Convert REGION enum to a Region string identifier
-  const auto region_str = REGION_STRING(region);
 
-  Field3D result(this);
+  Field3D result(mesh);
   result.allocate(); // Make sure data allocated
   result.setLocation(outloc);
 
-  if (this->StaggerGrids && (outloc != inloc)) {
+  // Hoist the region lookup and take unchecked views of the raw data:
+  // the region keeps clear of the x edges by the stencil width, so the
+  // neighbour offsets below stay inside the field
+  const auto &region = mesh->getRegion3D(region_str);
+  ConstStencilView v = var.view(region);
+  StencilView r = result.view(region);
+
+  if (mesh->StaggerGrids && (outloc != inloc)) {
     // Staggered differencing
 
-    if (this->xstart > 1) {
+    if (mesh->xstart > 1) {
       // More than one guard cell, so set pp and mm values
       // This allows higher-order methods to be used
       BOUT_OMP(parallel)
       {
         stencil s;
-        BOUT_FOR_INNER(i, this->getRegion3D(region_str)) {
-          s.mm = var[i.xmm()];
-          s.m = var[i.xm()];
-          s.c = var[i];
-          s.p = var[i.xp()];
-          s.pp = var[i.xpp()];
+        BOUT_FOR_INNER(i, region) {
+          s.mm = v[i.xmm()];
+          s.m = v[i.xm()];
+          s.c = v[i];
+          s.p = v[i.xp()];
+          s.pp = v[i.xpp()];
 
           if ((inloc == CELL_CENTRE) && (outloc == CELL_XLOW)) {
             // Producing a stencil centred around a lower X value
@@ -817,7 +875,7 @@ const Field3D Mesh::applyXdiff(const Field3D &var, Mesh::deriv_func func,
             s.m = s.c;
           }
 
-          result[i] = func(s);
+          r[i] = func(s);
         }
       }
     } else {
@@ -825,10 +883,10 @@ const Field3D Mesh::applyXdiff(const Field3D &var, Mesh::deriv_func func,
       BOUT_OMP(parallel)
       {
         stencil s;
-        BOUT_FOR_INNER(i, this->getRegion3D(region_str)) {
-          s.m = var[i.xm()];
-          s.c = var[i];
-          s.p = var[i.xp()];
+        BOUT_FOR_INNER(i, region) {
+          s.m = v[i.xm()];
+          s.c = v[i];
+          s.p = v[i.xp()];
 
           if (outloc == CELL_XLOW) {
             // Producing a stencil centred around a lower X value
@@ -840,7 +898,7 @@ const Field3D Mesh::applyXdiff(const Field3D &var, Mesh::deriv_func func,
             s.m = s.c;
           }
 
-          result[i] = func(s);
+          r[i] = func(s);
         }
       }
     }
@@ -848,20 +906,20 @@ const Field3D Mesh::applyXdiff(const Field3D &var, Mesh::deriv_func func,
   } else {
     // Non-staggered differencing
 
-    if (this->xstart > 1) {
+    if (mesh->xstart > 1) {
       // More than one guard cell, so set pp and mm values
       // This allows higher-order methods to be used
       BOUT_OMP(parallel)
       {
         stencil s;
-        BOUT_FOR_INNER(i, this->getRegion3D(region_str)) {
-          s.mm = var[i.xmm()];
-          s.m = var[i.xm()];
-          s.c = var[i];
-          s.p = var[i.xp()];
-          s.pp = var[i.xpp()];
-
-          result[i] = func(s);
+        BOUT_FOR_INNER(i, region) {
+          s.mm = v[i.xmm()];
+          s.m = v[i.xm()];
+          s.c = v[i];
+          s.p = v[i.xp()];
+          s.pp = v[i.xpp()];
+
+          r[i] = func(s);
         }
       }
     } else {
@@ -869,12 +927,12 @@ const Field3D Mesh::applyXdiff(const Field3D &var, Mesh::deriv_func func,
       BOUT_OMP(parallel)
       {
         stencil s;
-        BOUT_FOR_INNER(i, this->getRegion3D(region_str)) {
-          s.m = var[i.xm()];
-          s.c = var[i];
-          s.p = var[i.xp()];
+        BOUT_FOR_INNER(i, region) {
+          s.m = v[i.xm()];
+          s.c = v[i];
+          s.p = v[i.xp()];
 
-          result[i] = func(s);
+          r[i] = func(s);
         }
       }
     }
@@ -888,11 +946,22 @@ const Field3D Mesh::applyXdiff(const Field3D &var, Mesh::deriv_func func,
   return result;
 }
 
+const Field3D Mesh::applyXdiff(const Field3D &var, Mesh::deriv_func func,
+                               CELL_LOC outloc, REGION region) {
+  return applyXdiff(var, func, outloc, REGION_STRING(region));
+}
+
+const Field3D Mesh::applyXdiff(const Field3D &var, Mesh::deriv_func func,
+                               CELL_LOC outloc, const std::string &region) {
+  DERIV_INLINE_DISPATCH(applyXdiffImpl, var, func, outloc, region);
+}
+
 // Y derivative
 
-const Field2D Mesh::applyYdiff(const Field2D &var, Mesh::deriv_func func, CELL_LOC outloc,
-                               REGION region) {
-  ASSERT1(this == var.getMesh());
+template <typename DerivFunc>
+const Field2D applyYdiffImpl(Mesh *mesh, const Field2D &var, DerivFunc func,
+                             CELL_LOC outloc, const std::string &region_str) {
+  ASSERT1(mesh == var.getMesh());
   // Check that the input variable has data
   ASSERT1(var.isAllocated());
 
@@ -903,25 +972,23 @@ const Field2D Mesh::applyYdiff(const Field2D &var, Mesh::deriv_func func, CELL_L
   ASSERT1(outloc == inloc);
 
   if (var.getNy() == 1) {
-    auto tmp = Field2D(0., this);
+    auto tmp = Field2D(0., mesh);
     tmp.setLocation(var.getLocation());
     return tmp;
   }
 
-  /// Convert REGION enum to a Region string identifier
-  const auto region_str = REGION_STRING(region);
   
-  Field2D result(this);
+  Field2D result(mesh);
   result.allocate(); // Make sure data allocated
   result.setLocation(outloc);
 
-  if (this->ystart > 1) {
+  if (mesh->ystart > 1) {
     // More than one guard cell, so set pp and mm values
     // This allows higher-order methods to be used
     BOUT_OMP(parallel)
     {
       stencil s;
-      BOUT_FOR_INNER(i, this->getRegion2D(region_str)) {
+      BOUT_FOR_INNER(i, mesh->getRegion2D(region_str)) {
         s.mm = var[i.ymm()];
         s.m = var[i.ym()];
         s.c = var[i];
@@ -935,7 +1002,7 @@ const Field2D Mesh::applyYdiff(const Field2D &var, Mesh::deriv_func func, CELL_L
     BOUT_OMP(parallel)
     {
       stencil s;
-      BOUT_FOR_INNER(i, this->getRegion2D(region_str)) {
+      BOUT_FOR_INNER(i, mesh->getRegion2D(region_str)) {
         s.m = var[i.ym()];
         s.c = var[i];
         s.p = var[i.yp()];
@@ -953,9 +1020,20 @@ const Field2D Mesh::applyYdiff(const Field2D &var, Mesh::deriv_func func, CELL_L
   return result;
 }
 
-const Field3D Mesh::applyYdiff(const Field3D &var, Mesh::deriv_func func, CELL_LOC outloc,
-                               REGION region) {
-  ASSERT1(this == var.getMesh());
+const Field2D Mesh::applyYdiff(const Field2D &var, Mesh::deriv_func func,
+                               CELL_LOC outloc, REGION region) {
+  return applyYdiff(var, func, outloc, REGION_STRING(region));
+}
+
+const Field2D Mesh::applyYdiff(const Field2D &var, Mesh::deriv_func func,
+                               CELL_LOC outloc, const std::string &region) {
+  DERIV_INLINE_DISPATCH(applyYdiffImpl, var, func, outloc, region);
+}
+
+template <typename DerivFunc>
+const Field3D applyYdiffImpl(Mesh *mesh, const Field3D &var, DerivFunc func,
+                             CELL_LOC outloc, const std::string &region_str) {
+  ASSERT1(mesh == var.getMesh());
   // Check that the input variable has data
   ASSERT1(var.isAllocated());
   // Cell location of the input field
@@ -967,35 +1045,40 @@ const Field3D Mesh::applyYdiff(const Field3D &var, Mesh::deriv_func func, CELL_L
           (outloc == CELL_YLOW && inloc == CELL_CENTRE));
 
   if (var.getNy() == 1) {
-    auto tmp = Field3D(0., this);
+    auto tmp = Field3D(0., mesh);
     tmp.setLocation(var.getLocation());
     return tmp;
   }
 
-  /// Convert REGION enum to a Region string identifier
-  const auto region_str = REGION_STRING(region);
   
-  Field3D result(this);
+  Field3D result(mesh);
   result.allocate(); // Make sure data allocated
   result.setLocation(outloc);
 
+  const auto &region = mesh->getRegion3D(region_str);
+  StencilView r = result.view(region);
+
   if (var.hasYupYdown() && ((&var.yup() != &var) || (&var.ydown() != &var))) {
     // Field "var" has distinct yup and ydown fields which
     // will be used to calculate a derivative along
     // the magnetic field
 
-    if (this->StaggerGrids && (outloc != inloc)) {
+    ConstStencilView v = var.view(region);
+    ConstStencilView vup = var.yup().view(region);
+    ConstStencilView vdown = var.ydown().view(region);
+
+    if (mesh->StaggerGrids && (outloc != inloc)) {
       // Staggered differencing
 
       BOUT_OMP(parallel)
       {
         stencil s;
-        BOUT_FOR_INNER(i, this->getRegion3D(region_str)) {
+        BOUT_FOR_INNER(i, region) {
 
           // Set stencils
-          s.m = var.ydown()[i.ym()];
-          s.c = var[i];
-          s.p = var.yup()[i.yp()];
+          s.m = vdown[i.ym()];
+          s.c = v[i];
+          s.p = vup[i.yp()];
 
           if (outloc == CELL_YLOW) {
             // Producing a stencil centred around a lower Y value
@@ -1007,7 +1090,7 @@ const Field3D Mesh::applyYdiff(const Field3D &var, Mesh::deriv_func func, CELL_L
             s.m = s.c;
           }
 
-          result[i] = func(s);
+          r[i] = func(s);
         }
       }
     } else {
@@ -1015,36 +1098,37 @@ const Field3D Mesh::applyYdiff(const Field3D &var, Mesh::deriv_func func, CELL_L
       BOUT_OMP(parallel)
       {
         stencil s;
-        BOUT_FOR_INNER(i, this->getRegion3D(region_str)) {
+        BOUT_FOR_INNER(i, region) {
           // Set stencils
-          s.m = var.ydown()[i.ym()];
-          s.c = var[i];
-          s.p = var.yup()[i.yp()];
+          s.m = vdown[i.ym()];
+          s.c = v[i];
+          s.p = vup[i.yp()];
 
-          result[i] = func(s);
+          r[i] = func(s);
         }
       }
     }
   } else {
     // var has no yup/ydown fields, so we need to shift into field-aligned coordinates
 
-    Field3D var_fa = this->toFieldAligned(var);
+    Field3D var_fa = mesh->toFieldAligned(var);
+    ConstStencilView v = var_fa.view(region);
 
-    if (this->StaggerGrids && (outloc != inloc)) {
+    if (mesh->StaggerGrids && (outloc != inloc)) {
       // Staggered differencing
 
-      if (this->ystart > 1) {
+      if (mesh->ystart > 1) {
         // More than one guard cell, so set pp and mm values
         // This allows higher-order methods to be used
         BOUT_OMP(parallel) {
           stencil s;
-          BOUT_FOR_INNER(i, this->getRegion3D(region_str)) {
+          BOUT_FOR_INNER(i, region) {
             // Set stencils
-            s.mm = var_fa[i.ymm()];
-            s.m = var_fa[i.ym()];
-            s.c = var_fa[i];
-            s.p = var_fa[i.yp()];
-            s.pp = var_fa[i.ypp()];
+            s.mm = v[i.ymm()];
+            s.m = v[i.ym()];
+            s.c = v[i];
+            s.p = v[i.yp()];
+            s.pp = v[i.ypp()];
 
             if (outloc == CELL_YLOW) {
               // Producing a stencil centred around a lower Y value
@@ -1056,18 +1140,18 @@ const Field3D Mesh::applyYdiff(const Field3D &var, Mesh::deriv_func func, CELL_L
               s.m = s.c;
             }
 
-            result[i] = func(s);
+            r[i] = func(s);
           }
         }
       } else {
         // Only one guard cell, so no pp or mm values
         BOUT_OMP(parallel) {
           stencil s;
-          BOUT_FOR_INNER(i, this->getRegion3D(region_str)) {
+          BOUT_FOR_INNER(i, region) {
             // Set stencils
-            s.m = var_fa[i.ym()];
-            s.c = var_fa[i];
-            s.p = var_fa[i.yp()];
+            s.m = v[i.ym()];
+            s.c = v[i];
+            s.p = v[i.yp()];
 
             if (outloc == CELL_YLOW) {
               // Producing a stencil centred around a lower Y value
@@ -1079,40 +1163,40 @@ const Field3D Mesh::applyYdiff(const Field3D &var, Mesh::deriv_func func, CELL_L
               s.m = s.c;
             }
 
-            result[i] = func(s);
+            r[i] = func(s);
           }
         }
       }
     } else {
       // Non-staggered differencing
 
-      if (this->ystart > 1) {
+      if (mesh->ystart > 1) {
         // More than one guard cell, so set pp and mm values
         // This allows higher-order methods to be used
         BOUT_OMP(parallel) {
           stencil s;
-          BOUT_FOR_INNER(i, this->getRegion3D(region_str)) {
+          BOUT_FOR_INNER(i, region) {
             // Set stencils
-            s.mm = var_fa[i.ymm()];
-            s.m = var_fa[i.ym()];
-            s.c = var_fa[i];
-            s.p = var_fa[i.yp()];
-            s.pp = var_fa[i.ypp()];
+            s.mm = v[i.ymm()];
+            s.m = v[i.ym()];
+            s.c = v[i];
+            s.p = v[i.yp()];
+            s.pp = v[i.ypp()];
 
-            result[i] = func(s);
+            r[i] = func(s);
           }
         }
       } else {
         // Only one guard cell, so no pp or mm values
         BOUT_OMP(parallel) {
           stencil s;
-          BOUT_FOR_INNER(i, this->getRegion3D(region_str)) {
+          BOUT_FOR_INNER(i, region) {
             // Set stencils
-            s.m = var_fa[i.ym()];
-            s.c = var_fa[i];
-            s.p = var_fa[i.yp()];
+            s.m = v[i.ym()];
+            s.c = v[i];
+            s.p = v[i.yp()];
 
-            result[i] = func(s);
+            r[i] = func(s);
           }
         }
       }
@@ -1120,7 +1204,7 @@ const Field3D Mesh::applyYdiff(const Field3D &var, Mesh::deriv_func func, CELL_L
 
     // Shift result back
 
-    result = this->fromFieldAligned(result);
+    result = mesh->fromFieldAligned(result);
   }
 
 #if CHECK > 0
@@ -1131,11 +1215,22 @@ const Field3D Mesh::applyYdiff(const Field3D &var, Mesh::deriv_func func, CELL_L
   return result;
 }
 
+const Field3D Mesh::applyYdiff(const Field3D &var, Mesh::deriv_func func,
+                               CELL_LOC outloc, REGION region) {
+  return applyYdiff(var, func, outloc, REGION_STRING(region));
+}
+
+const Field3D Mesh::applyYdiff(const Field3D &var, Mesh::deriv_func func,
+                               CELL_LOC outloc, const std::string &region) {
+  DERIV_INLINE_DISPATCH(applyYdiffImpl, var, func, outloc, region);
+}
+
 // Z derivative
 
-const Field3D Mesh::applyZdiff(const Field3D &var, Mesh::deriv_func func, CELL_LOC outloc,
-                               REGION region) {
-  ASSERT1(this == var.getMesh());
+template <typename DerivFunc>
+const Field3D applyZdiffImpl(Mesh *mesh, const Field3D &var, DerivFunc func,
+                             CELL_LOC outloc, const std::string &region_str) {
+  ASSERT1(mesh == var.getMesh());
   // Check that the input variable has data
   ASSERT1(var.isAllocated());
   CELL_LOC inloc = var.getLocation();
@@ -1145,38 +1240,157 @@ const Field3D Mesh::applyZdiff(const Field3D &var, Mesh::deriv_func func, CELL_L
   ASSERT1(outloc == inloc);
 
   if (var.getNz() == 1) {
-    auto tmp = Field3D(0., this);
+    auto tmp = Field3D(0., mesh);
     tmp.setLocation(var.getLocation());
     return tmp;
   }
 
-  /// Convert REGION enum to a Region string identifier
-  const auto region_str = REGION_STRING(region);
 
-  Field3D result(this);
+  Field3D result(mesh);
   result.allocate(); // Make sure data allocated
   result.setLocation(outloc);
 
+#ifdef BOUT_USE_OPENMP_OFFLOAD
+  // Device path for the rectangular regions the Z derivatives are
+  // called with; anything else falls through to the host loop. The
+  // stencil wraps in z, so no halo exchange is needed and nothing
+  // crosses MPI from the device
+  if (region_str == "RGN_ALL" || region_str == "RGN_NOBNDRY") {
+    const bool bndry = (region_str == "RGN_ALL");
+    const int xs = bndry ? 0 : mesh->xstart;
+    const int xe = bndry ? mesh->LocalNx - 1 : mesh->xend;
+    const int ys = bndry ? 0 : mesh->ystart;
+    const int ye = bndry ? mesh->LocalNy - 1 : mesh->yend;
+    const int ny = mesh->LocalNy;
+    const int nz = mesh->LocalNz;
+    const int n = mesh->LocalNx * ny * nz;
+
+    const BoutReal *fd = &var(0, 0, 0);
+    BoutReal *rd = &result(0, 0, 0);
+
+    BOUT_OFFLOAD(target teams distribute parallel for collapse(3) map(to: fd[0:n]) map(from: rd[0:n]))
+    for (int jx = xs; jx <= xe; jx++) {
+      for (int jy = ys; jy <= ye; jy++) {
+        for (int jz = 0; jz < nz; jz++) {
+          const BoutReal *p = &fd[((jx * ny) + jy) * nz];
+          stencil s;
+          s.mm = p[(jz + nz - 2) % nz];
+          s.m = p[(jz + nz - 1) % nz];
+          s.c = p[jz];
+          s.p = p[(jz + 1) % nz];
+          s.pp = p[(jz + 2) % nz];
+          rd[((jx * ny) + jy) * nz + jz] = func(s);
+        }
+      }
+    }
+    return result;
+  }
+#endif
+
+  // z neighbour offsets wrap within the field, so an unchecked view is
+  // safe for any region
+  const auto &region = mesh->getRegion3D(region_str);
+  ConstStencilView v = var.view(region);
+  StencilView r = result.view(region);
+
   // Check that the input variable has data
   ASSERT1(var.isAllocated());
 
   BOUT_OMP(parallel)
   {
     stencil s;
-    BOUT_FOR_INNER(i, this->getRegion3D(region_str)) {
-      s.mm = var[i.zmm()];
-      s.m = var[i.zm()];
-      s.c = var[i];
-      s.p = var[i.zp()];
-      s.pp = var[i.zpp()];
-
-      result[i] = func(s);
+    BOUT_FOR_INNER(i, region) {
+      s.mm = v[i.zmm()];
+      s.m = v[i.zm()];
+      s.c = v[i];
+      s.p = v[i.zp()];
+      s.pp = v[i.zpp()];
+
+      r[i] = func(s);
     }
   }
 
   return result;
 }
 
+const Field3D Mesh::applyZdiff(const Field3D &var, Mesh::deriv_func func,
+                               CELL_LOC outloc, REGION region) {
+  return applyZdiff(var, func, outloc, REGION_STRING(region));
+}
+
+const Field3D Mesh::applyZdiff(const Field3D &var, Mesh::deriv_func func,
+                               CELL_LOC outloc, const std::string &region) {
+  DERIV_INLINE_DISPATCH(applyZdiffImpl, var, func, outloc, region);
+}
+
+// Interior/shell split variants, for overlapping with communication.
+// See the comment in mesh.hxx for the calling sequence.
+//
+// The interior pass is just a restriction to the direction's interior
+// region. The shell pass evaluates into a scratch field over the rim
+// only -- allocation recycles from the array store so this costs no
+// initialisation -- and copies the rim points into the caller's result
+
+const Field2D Mesh::applyXdiffInterior(const Field2D &var, Mesh::deriv_func func,
+                                       CELL_LOC outloc) {
+  return applyXdiff(var, func, outloc, "RGN_XINTERIOR");
+}
+
+void Mesh::applyXdiffShell(Field2D &result, const Field2D &var, Mesh::deriv_func func,
+                           CELL_LOC outloc) {
+  ASSERT1(result.isAllocated());
+  Field2D rim = applyXdiff(var, func, outloc, "RGN_XRIM");
+  BOUT_FOR(i, getRegion2D("RGN_XRIM")) { result[i] = rim[i]; }
+}
+
+const Field3D Mesh::applyXdiffInterior(const Field3D &var, Mesh::deriv_func func,
+                                       CELL_LOC outloc) {
+  return applyXdiff(var, func, outloc, "RGN_XINTERIOR");
+}
+
+void Mesh::applyXdiffShell(Field3D &result, const Field3D &var, Mesh::deriv_func func,
+                           CELL_LOC outloc) {
+  ASSERT1(result.isAllocated());
+  Field3D rim = applyXdiff(var, func, outloc, "RGN_XRIM");
+  BOUT_FOR(i, getRegion3D("RGN_XRIM")) { result[i] = rim[i]; }
+}
+
+const Field2D Mesh::applyYdiffInterior(const Field2D &var, Mesh::deriv_func func,
+                                       CELL_LOC outloc) {
+  return applyYdiff(var, func, outloc, "RGN_YINTERIOR");
+}
+
+void Mesh::applyYdiffShell(Field2D &result, const Field2D &var, Mesh::deriv_func func,
+                           CELL_LOC outloc) {
+  ASSERT1(result.isAllocated());
+  Field2D rim = applyYdiff(var, func, outloc, "RGN_YRIM");
+  BOUT_FOR(i, getRegion2D("RGN_YRIM")) { result[i] = rim[i]; }
+}
+
+const Field3D Mesh::applyYdiffInterior(const Field3D &var, Mesh::deriv_func func,
+                                       CELL_LOC outloc) {
+  return applyYdiff(var, func, outloc, "RGN_YINTERIOR");
+}
+
+void Mesh::applyYdiffShell(Field3D &result, const Field3D &var, Mesh::deriv_func func,
+                           CELL_LOC outloc) {
+  ASSERT1(result.isAllocated());
+  Field3D rim = applyYdiff(var, func, outloc, "RGN_YRIM");
+  BOUT_FOR(i, getRegion3D("RGN_YRIM")) { result[i] = rim[i]; }
+}
+
+const Field3D Mesh::applyZdiffInterior(const Field3D &var, Mesh::deriv_func func,
+                                       CELL_LOC outloc) {
+  // Z derivatives read no communicated data, so the interior pass can
+  // already cover the whole of the usual evaluation region
+  return applyZdiff(var, func, outloc, RGN_NOBNDRY);
+}
+
+void Mesh::applyZdiffShell(Field3D &UNUSED(result), const Field3D &UNUSED(var),
+                           Mesh::deriv_func UNUSED(func), CELL_LOC UNUSED(outloc)) {
+  // Nothing left to fill; see applyZdiffInterior
+}
+
 /*******************************************************************************
  * First central derivatives
  *******************************************************************************/
@@ -1184,6 +1398,11 @@ const Field3D Mesh::applyZdiff(const Field3D &var, Mesh::deriv_func func, CELL_L
 ////////////// X DERIVATIVE /////////////////
 
 const Field3D Mesh::indexDDX(const Field3D &f, CELL_LOC outloc, DIFF_METHOD method, REGION region) {
+  return indexDDX(f, outloc, method, REGION_STRING(region));
+}
+
+const Field3D Mesh::indexDDX(const Field3D &f, CELL_LOC outloc, DIFF_METHOD method,
+                             const std::string &region) {
 
   Mesh::deriv_func func = fDDX; // Set to default function
   DiffLookup *table = FirstDerivTable;
@@ -1212,8 +1431,13 @@ const Field3D Mesh::indexDDX(const Field3D &f, CELL_LOC outloc, DIFF_METHOD meth
   return applyXdiff(f, func, outloc, region);
 }
 
+const Field2D Mesh::indexDDX(const Field2D &f, CELL_LOC outloc, DIFF_METHOD method,
+                             REGION region) {
+  return indexDDX(f, outloc, method, REGION_STRING(region));
+}
+
 const Field2D Mesh::indexDDX(const Field2D &f, MAYBE_UNUSED(CELL_LOC outloc),
-                             MAYBE_UNUSED(DIFF_METHOD method), REGION region) {
+                             MAYBE_UNUSED(DIFF_METHOD method), const std::string &region) {
   ASSERT1(outloc == CELL_DEFAULT || outloc == f.getLocation());
   ASSERT1(method == DIFF_DEFAULT);
   return applyXdiff(f, fDDX, f.getLocation(), region);
@@ -1223,6 +1447,11 @@ const Field2D Mesh::indexDDX(const Field2D &f, MAYBE_UNUSED(CELL_LOC outloc),
 
 const Field3D Mesh::indexDDY(const Field3D &f, CELL_LOC outloc, DIFF_METHOD method,
                              REGION region) {
+  return indexDDY(f, outloc, method, REGION_STRING(region));
+}
+
+const Field3D Mesh::indexDDY(const Field3D &f, CELL_LOC outloc, DIFF_METHOD method,
+                             const std::string &region) {
   Mesh::deriv_func func = fDDY; // Set to default function
   DiffLookup *table = FirstDerivTable;
 
@@ -1249,8 +1478,13 @@ const Field3D Mesh::indexDDY(const Field3D &f, CELL_LOC outloc, DIFF_METHOD meth
   return applyYdiff(f, func, outloc, region);
 }
 
+const Field2D Mesh::indexDDY(const Field2D &f, CELL_LOC outloc, DIFF_METHOD method,
+                             REGION region) {
+  return indexDDY(f, outloc, method, REGION_STRING(region));
+}
+
 const Field2D Mesh::indexDDY(const Field2D &f, MAYBE_UNUSED(CELL_LOC outloc),
-                             MAYBE_UNUSED(DIFF_METHOD method), REGION region) {
+                             MAYBE_UNUSED(DIFF_METHOD method), const std::string &region) {
   ASSERT1(outloc == CELL_DEFAULT || outloc == f.getLocation());
   ASSERT1(method == DIFF_DEFAULT);
   return applyYdiff(f, fDDY, f.getLocation(), region);
@@ -1260,6 +1494,11 @@ const Field2D Mesh::indexDDY(const Field2D &f, MAYBE_UNUSED(CELL_LOC outloc),
 
 const Field3D Mesh::indexDDZ(const Field3D &f, CELL_LOC outloc,
                              DIFF_METHOD method, REGION region) {
+  return indexDDZ(f, outloc, method, REGION_STRING(region));
+}
+
+const Field3D Mesh::indexDDZ(const Field3D &f, CELL_LOC outloc,
+                             DIFF_METHOD method, const std::string &region) {
   Mesh::deriv_func func = fDDZ; // Set to default function
   DiffLookup *table = FirstDerivTable;
 
@@ -1311,11 +1550,9 @@ const Field3D Mesh::indexDDZ(const Field3D &f, CELL_LOC outloc,
       kfilter = ncz / 2;
     const int kmax = ncz / 2 - kfilter; // Up to and including this wavenumber index
 
-    const auto region_str = REGION_STRING(region);
-
     // Only allow a whitelist of regions for now
-    ASSERT2(region_str == "RGN_ALL" || region_str == "RGN_NOBNDRY" ||
-            region_str == "RGN_NOX" || region_str == "RGN_NOY");
+    ASSERT2(region == "RGN_ALL" || region == "RGN_NOBNDRY" ||
+            region == "RGN_NOX" || region == "RGN_NOY");
 
     BOUT_OMP(parallel)
     {
@@ -1331,7 +1568,7 @@ const Field3D Mesh::indexDDZ(const Field3D &f, CELL_LOC outloc,
       // With this in mind we could perhaps avoid the use of the BOUT_FOR_INNER macro
       // here,
       // but should be ok for now.
-      BOUT_FOR_INNER(i, mesh->getRegion2D(region_str)) {
+      BOUT_FOR_INNER(i, mesh->getRegion2D(region)) {
         auto i3D = mesh->ind2Dto3D(i, 0);
         rfft(&f[i3D], ncz, cv.begin()); // Forward FFT
 
@@ -1398,6 +1635,11 @@ const Field2D Mesh::indexDDZ(const Field2D &f, CELL_LOC UNUSED(outloc),
  */
 const Field3D Mesh::indexD2DX2(const Field3D &f, CELL_LOC outloc,
                                DIFF_METHOD method, REGION region) {
+  return indexD2DX2(f, outloc, method, REGION_STRING(region));
+}
+
+const Field3D Mesh::indexD2DX2(const Field3D &f, CELL_LOC outloc,
+                               DIFF_METHOD method, const std::string &region) {
   Mesh::deriv_func func = fD2DX2; // Set to default function
   DiffLookup *table = SecondDerivTable;
 
@@ -1436,8 +1678,13 @@ const Field3D Mesh::indexD2DX2(const Field3D &f, CELL_LOC outloc,
  *          guard cells
  *
  */
+const Field2D Mesh::indexD2DX2(const Field2D &f, CELL_LOC outloc, DIFF_METHOD method,
+                               REGION region) {
+  return indexD2DX2(f, outloc, method, REGION_STRING(region));
+}
+
 const Field2D Mesh::indexD2DX2(const Field2D &f, MAYBE_UNUSED(CELL_LOC outloc),
-                               MAYBE_UNUSED(DIFF_METHOD method), REGION region) {
+                               MAYBE_UNUSED(DIFF_METHOD method), const std::string &region) {
   ASSERT1(outloc == CELL_DEFAULT || outloc == f.getLocation());
   ASSERT1(method == DIFF_DEFAULT);
   return applyXdiff(f, fD2DX2, f.getLocation(), region);
@@ -1457,6 +1704,11 @@ const Field2D Mesh::indexD2DX2(const Field2D &f, MAYBE_UNUSED(CELL_LOC outloc),
  */
 const Field3D Mesh::indexD2DY2(const Field3D &f, CELL_LOC outloc,
                                DIFF_METHOD method, REGION region) {
+  return indexD2DY2(f, outloc, method, REGION_STRING(region));
+}
+
+const Field3D Mesh::indexD2DY2(const Field3D &f, CELL_LOC outloc,
+                               DIFF_METHOD method, const std::string &region) {
   Mesh::deriv_func func = fD2DY2; // Set to default function
   DiffLookup *table = SecondDerivTable;
 
@@ -1495,13 +1747,412 @@ const Field3D Mesh::indexD2DY2(const Field3D &f, CELL_LOC outloc,
  *          guard cells
  *
  */
+const Field2D Mesh::indexD2DY2(const Field2D &f, CELL_LOC outloc, DIFF_METHOD method,
+                               REGION region) {
+  return indexD2DY2(f, outloc, method, REGION_STRING(region));
+}
+
 const Field2D Mesh::indexD2DY2(const Field2D &f, MAYBE_UNUSED(CELL_LOC outloc),
-                               MAYBE_UNUSED(DIFF_METHOD method), REGION region) {
+                               MAYBE_UNUSED(DIFF_METHOD method), const std::string &region) {
   ASSERT1(outloc == CELL_DEFAULT || outloc == f.getLocation());
   ASSERT1(method == DIFF_DEFAULT);
   return applyYdiff(f, fD2DY2, f.getLocation(), region);
 }
 
+/*!
+ * @brief Fused first and second Y derivative, combined as
+ *        c1 * df/di + c2 * d^2f/di^2 in a single sweep over f
+ *
+ * The stencil is filled once per point and both default differencing
+ * functions are applied to it, so composite parallel operators such as
+ * Grad2_par2 read their input once and write one output instead of
+ * traversing the field once per derivative plus once per combine.
+ *
+ * @param[in] f        3D scalar field to be differentiated.
+ *                     Must be allocated and finite
+ * @param[in] c1       Axisymmetric coefficient of the first derivative
+ * @param[in] c2       Axisymmetric coefficient of the second derivative
+ *
+ * @return  A 3D scalar field with invalid data in the
+ *          guard cells
+ *
+ */
+const Field3D Mesh::indexDDY_D2DY2(const Field3D &f, const Field2D &c1,
+                                   const Field2D &c2, CELL_LOC outloc,
+                                   REGION region) {
+  TRACE("Mesh::indexDDY_D2DY2");
+
+  ASSERT1(this == f.getMesh());
+  ASSERT1(f.isAllocated());
+
+  CELL_LOC inloc = f.getLocation();
+  if (outloc == CELL_DEFAULT)
+    outloc = inloc;
+  // Staggering is not supported here: both derivatives would need
+  // their staggered functions and stencil shifts. Callers fall back to
+  // the separate derivative calls in that case
+  ASSERT1(outloc == inloc);
+
+  if (f.getNy() == 1) {
+    auto tmp = Field3D(0., this);
+    tmp.setLocation(f.getLocation());
+    return tmp;
+  }
+
+  /// Convert REGION enum to a Region string identifier
+  const auto region_str = REGION_STRING(region);
+
+  Field3D result(this);
+  result.allocate(); // Make sure data allocated
+  result.setLocation(outloc);
+
+  if (f.hasYupYdown() && ((&f.yup() != &f) || (&f.ydown() != &f))) {
+    // Field "f" has distinct yup and ydown fields which
+    // will be used to calculate the derivatives along
+    // the magnetic field
+    BOUT_OMP(parallel)
+    {
+      stencil s;
+      BOUT_FOR_INNER(i, this->getRegion3D(region_str)) {
+        // Set the stencil once, apply both differencing functions to it
+        s.m = f.ydown()[i.ym()];
+        s.c = f[i];
+        s.p = f.yup()[i.yp()];
+
+        const auto i2 = ind3Dto2D(i);
+        result[i] = c1[i2] * fDDY(s) + c2[i2] * fD2DY2(s);
+      }
+    }
+  } else {
+    // f has no yup/ydown fields, so we need to shift into field-aligned coordinates
+
+    Field3D f_fa = this->toFieldAligned(f);
+
+    if (ystart > 1) {
+      // More than one guard cell, so set pp and mm values
+      // This allows higher-order methods to be used
+      BOUT_OMP(parallel)
+      {
+        stencil s;
+        BOUT_FOR_INNER(i, this->getRegion3D(region_str)) {
+          // Set stencils
+          s.mm = f_fa[i.ymm()];
+          s.m = f_fa[i.ym()];
+          s.c = f_fa[i];
+          s.p = f_fa[i.yp()];
+          s.pp = f_fa[i.ypp()];
+
+          const auto i2 = ind3Dto2D(i);
+          result[i] = c1[i2] * fDDY(s) + c2[i2] * fD2DY2(s);
+        }
+      }
+    } else {
+      // Only one guard cell, so no pp or mm values
+      BOUT_OMP(parallel)
+      {
+        stencil s;
+        BOUT_FOR_INNER(i, this->getRegion3D(region_str)) {
+          // Set stencils
+          s.m = f_fa[i.ym()];
+          s.c = f_fa[i];
+          s.p = f_fa[i.yp()];
+
+          const auto i2 = ind3Dto2D(i);
+          result[i] = c1[i2] * fDDY(s) + c2[i2] * fD2DY2(s);
+        }
+      }
+    }
+
+    // c1 and c2 are axisymmetric, so applying them in field-aligned
+    // coordinates commutes with the shift back
+    result = this->fromFieldAligned(result);
+  }
+
+#if CHECK > 0
+  // Mark boundaries as invalid
+  result.bndry_xin = result.bndry_xout = result.bndry_yup = result.bndry_ydown = false;
+#endif
+
+  return result;
+}
+
+const Field3D Mesh::indexDDY_scaled(const Field3D &f, const Field2D &coef,
+                                    CELL_LOC outloc, REGION region) {
+  TRACE("Mesh::indexDDY_scaled");
+
+  ASSERT1(this == f.getMesh());
+  ASSERT1(f.isAllocated());
+
+  CELL_LOC inloc = f.getLocation();
+  if (outloc == CELL_DEFAULT)
+    outloc = inloc;
+  // Allowed staggers, as for indexDDY:
+  ASSERT1(outloc == inloc || (outloc == CELL_CENTRE && inloc == CELL_YLOW) ||
+          (outloc == CELL_YLOW && inloc == CELL_CENTRE));
+
+  if (f.getNy() == 1) {
+    auto tmp = Field3D(0., this);
+    tmp.setLocation(outloc);
+    return tmp;
+  }
+
+  // With staggered output the shift and the difference are combined in
+  // the staggered stencil function, so no separate interpolation pass
+  // is needed. The stencil offsets below match applyYdiff
+  const bool stag = StaggerGrids && (outloc != inloc);
+  Mesh::deriv_func func = stag ? sfDDY : fDDY;
+  const bool shift_down = stag && (outloc == CELL_YLOW);
+  const bool shift_up = stag && (inloc == CELL_YLOW);
+
+  /// Convert REGION enum to a Region string identifier
+  const auto region_str = REGION_STRING(region);
+
+  Field3D result(this);
+  result.allocate(); // Make sure data allocated
+  result.setLocation(outloc);
+
+  if (f.hasYupYdown() && ((&f.yup() != &f) || (&f.ydown() != &f))) {
+    // Field "f" has distinct yup and ydown fields which
+    // will be used to calculate the derivative along
+    // the magnetic field
+    BOUT_OMP(parallel)
+    {
+      stencil s;
+      BOUT_FOR_INNER(i, this->getRegion3D(region_str)) {
+        s.m = f.ydown()[i.ym()];
+        s.c = f[i];
+        s.p = f.yup()[i.yp()];
+
+        // The stagger directions are loop-invariant, so these
+        // branches predict perfectly
+        if (shift_down) {
+          // Producing a stencil centred around a lower Y value
+          s.pp = s.p;
+          s.p = s.c;
+        } else if (shift_up) {
+          // Stencil centred around a cell centre
+          s.mm = s.m;
+          s.m = s.c;
+        }
+
+        result[i] = coef[ind3Dto2D(i)] * func(s);
+      }
+    }
+  } else {
+    // f has no yup/ydown fields, so we need to shift into field-aligned coordinates
+
+    Field3D f_fa = this->toFieldAligned(f);
+
+    if (ystart > 1) {
+      // More than one guard cell, so set pp and mm values
+      // This allows higher-order methods to be used
+      BOUT_OMP(parallel)
+      {
+        stencil s;
+        BOUT_FOR_INNER(i, this->getRegion3D(region_str)) {
+          s.mm = f_fa[i.ymm()];
+          s.m = f_fa[i.ym()];
+          s.c = f_fa[i];
+          s.p = f_fa[i.yp()];
+          s.pp = f_fa[i.ypp()];
+
+          if (shift_down) {
+            s.pp = s.p;
+            s.p = s.c;
+          } else if (shift_up) {
+            s.mm = s.m;
+            s.m = s.c;
+          }
+
+          result[i] = coef[ind3Dto2D(i)] * func(s);
+        }
+      }
+    } else {
+      // Only one guard cell, so no pp or mm values
+      BOUT_OMP(parallel)
+      {
+        stencil s;
+        BOUT_FOR_INNER(i, this->getRegion3D(region_str)) {
+          s.m = f_fa[i.ym()];
+          s.c = f_fa[i];
+          s.p = f_fa[i.yp()];
+
+          if (shift_down) {
+            s.pp = s.p;
+            s.p = s.c;
+          } else if (shift_up) {
+            s.mm = s.m;
+            s.m = s.c;
+          }
+
+          result[i] = coef[ind3Dto2D(i)] * func(s);
+        }
+      }
+    }
+
+    // coef is axisymmetric, so applying it in field-aligned
+    // coordinates commutes with the shift back
+    result = this->fromFieldAligned(result);
+  }
+
+#if CHECK > 0
+  // Mark boundaries as invalid
+  result.bndry_xin = result.bndry_xout = result.bndry_yup = result.bndry_ydown = false;
+#endif
+
+  return result;
+}
+
+////////////// FUSED GRADIENT /////////////////
+
+void Mesh::indexGradAll(const Field3D &f, Field3D &ddx, Field3D &ddy, Field3D &ddz,
+                        CELL_LOC outloc, REGION region) {
+  TRACE("Mesh::indexGradAll");
+
+  ASSERT1(this == f.getMesh());
+  ASSERT1(f.isAllocated());
+
+  CELL_LOC inloc = f.getLocation();
+  if (outloc == CELL_DEFAULT)
+    outloc = inloc;
+  // Staggering is not supported here: each direction would need its
+  // staggered function and stencil shift. Callers fall back to the
+  // separate derivative calls in that case
+  ASSERT1(outloc == inloc);
+
+  // Degenerate directions are handled by the separate sweeps, which
+  // return zero fields for them
+  if ((f.getNx() == 1) || (f.getNy() == 1)) {
+    ddx = indexDDX(f, outloc, DIFF_DEFAULT, region);
+    ddy = indexDDY(f, outloc, DIFF_DEFAULT, region);
+    ddz = indexDDZ(f, outloc, DIFF_DEFAULT, region);
+    return;
+  }
+
+  // If the default z method is FFT there is no stencil function, so
+  // the z derivative keeps its own sweep and only x and y are fused
+  const bool fuse_z = (fDDZ != nullptr) && (LocalNz > 1);
+  if (!fuse_z) {
+    ddz = indexDDZ(f, outloc, DIFF_DEFAULT, region);
+  }
+
+  /// Convert REGION enum to a Region string identifier
+  const auto region_str = REGION_STRING(region);
+  const auto &reg = this->getRegion3D(region_str);
+
+  Field3D rx(this), ry(this), rz(this);
+  rx.allocate();
+  rx.setLocation(outloc);
+  ry.allocate();
+  ry.setLocation(outloc);
+  if (fuse_z) {
+    rz.allocate();
+    rz.setLocation(outloc);
+  }
+
+  // Whether the pp and mm stencil values can be filled, allowing
+  // higher-order methods. These (and fuse_z below) are loop-invariant,
+  // so the branches predict perfectly; duplicating the loop body for
+  // every combination, as the single-direction kernels do, would need
+  // eight copies here
+  const bool xgc2 = (xstart > 1);
+
+  if (f.hasYupYdown() && ((&f.yup() != &f) || (&f.ydown() != &f))) {
+    // Field "f" has distinct yup and ydown fields which will be used
+    // to calculate the derivative along the magnetic field
+    const Field3D &fup = f.yup();
+    const Field3D &fdown = f.ydown();
+
+    BOUT_OMP(parallel)
+    {
+      stencil sx, sy, sz;
+      BOUT_FOR_INNER(i, reg) {
+        sx.m = f[i.xm()];
+        sx.c = f[i];
+        sx.p = f[i.xp()];
+        if (xgc2) {
+          sx.mm = f[i.xmm()];
+          sx.pp = f[i.xpp()];
+        }
+        rx[i] = fDDX(sx);
+
+        // Single point offsets only, as in applyYdiff
+        sy.m = fdown[i.ym()];
+        sy.c = f[i];
+        sy.p = fup[i.yp()];
+        ry[i] = fDDY(sy);
+
+        if (fuse_z) {
+          sz.mm = f[i.zmm()];
+          sz.m = f[i.zm()];
+          sz.c = f[i];
+          sz.p = f[i.zp()];
+          sz.pp = f[i.zpp()];
+          rz[i] = fDDZ(sz);
+        }
+      }
+    }
+
+    ddy = ry;
+  } else {
+    // f has no yup/ydown fields, so we need to shift into field-aligned
+    // coordinates for the y stencil. For an identity transform this
+    // shares the data of f, so the traversal still reads one field
+    Field3D f_fa = this->toFieldAligned(f);
+
+    const bool ygc2 = (ystart > 1);
+
+    BOUT_OMP(parallel)
+    {
+      stencil sx, sy, sz;
+      BOUT_FOR_INNER(i, reg) {
+        sx.m = f[i.xm()];
+        sx.c = f[i];
+        sx.p = f[i.xp()];
+        if (xgc2) {
+          sx.mm = f[i.xmm()];
+          sx.pp = f[i.xpp()];
+        }
+        rx[i] = fDDX(sx);
+
+        sy.m = f_fa[i.ym()];
+        sy.c = f_fa[i];
+        sy.p = f_fa[i.yp()];
+        if (ygc2) {
+          sy.mm = f_fa[i.ymm()];
+          sy.pp = f_fa[i.ypp()];
+        }
+        ry[i] = fDDY(sy);
+
+        if (fuse_z) {
+          sz.mm = f[i.zmm()];
+          sz.m = f[i.zm()];
+          sz.c = f[i];
+          sz.p = f[i.zp()];
+          sz.pp = f[i.zpp()];
+          rz[i] = fDDZ(sz);
+        }
+      }
+    }
+
+    // The y derivative was calculated in field-aligned coordinates,
+    // so shift it back
+    ddy = this->fromFieldAligned(ry);
+  }
+
+  ddx = rx;
+  if (fuse_z) {
+    ddz = rz;
+  }
+
+#if CHECK > 0
+  // Mark boundaries as invalid
+  ddx.bndry_xin = ddx.bndry_xout = ddx.bndry_yup = ddx.bndry_ydown = false;
+  ddy.bndry_xin = ddy.bndry_xout = ddy.bndry_yup = ddy.bndry_ydown = false;
+  ddz.bndry_xin = ddz.bndry_xout = ddz.bndry_yup = ddz.bndry_ydown = false;
+#endif
+}
+
 ////////////// Z DERIVATIVE /////////////////
 
 /*!
@@ -1516,6 +2167,11 @@ const Field2D Mesh::indexD2DY2(const Field2D &f, MAYBE_UNUSED(CELL_LOC outloc),
  */
 const Field3D Mesh::indexD2DZ2(const Field3D &f, CELL_LOC outloc,
                                DIFF_METHOD method, REGION region) {
+  return indexD2DZ2(f, outloc, method, REGION_STRING(region));
+}
+
+const Field3D Mesh::indexD2DZ2(const Field3D &f, CELL_LOC outloc,
+                               DIFF_METHOD method, const std::string &region) {
   Mesh::deriv_func func = fD2DZ2; // Set to default function
   DiffLookup *table = SecondDerivTable;
 
@@ -1561,11 +2217,9 @@ const Field3D Mesh::indexD2DZ2(const Field3D &f, CELL_LOC outloc,
     const int ncz = this->LocalNz;
     const int kmax = ncz / 2; // Up to and including this wavenumber index
 
-    const auto region_str = REGION_STRING(region);
-
     // Only allow a whitelist of regions for now
-    ASSERT2(region_str == "RGN_ALL" || region_str == "RGN_NOBNDRY" ||
-            region_str == "RGN_NOX" || region_str == "RGN_NOY");
+    ASSERT2(region == "RGN_ALL" || region == "RGN_NOBNDRY" ||
+            region == "RGN_NOX" || region == "RGN_NOY");
 
     BOUT_OMP(parallel) {
       Array<dcomplex> cv(ncz / 2 + 1);
@@ -1580,7 +2234,7 @@ const Field3D Mesh::indexD2DZ2(const Field3D &f, CELL_LOC outloc,
       // With this in mind we could perhaps avoid the use of the BOUT_FOR_INNER macro
       // here,
       // but should be ok for now.
-      BOUT_FOR_INNER(i, mesh->getRegion2D(region_str)) {
+      BOUT_FOR_INNER(i, mesh->getRegion2D(region)) {
         auto i3D = mesh->ind2Dto3D(i, 0);
 
         rfft(&f[i3D], ncz, cv.begin()); // Forward FFT
@@ -1590,7 +2244,7 @@ const Field3D Mesh::indexD2DZ2(const Field3D &f, CELL_LOC outloc,
 
           cv[jz] *= -kwave * kwave;
           if (shift)
-            cv[jz] *= exp(0.5 * Im * (shift * kwave));
+            cv[jz] *= exp(BoutReal(0.5) * Im * (shift * kwave));
         }
         for (int jz = kmax + 1; jz <= ncz / 2; jz++) {
           cv[jz] = 0.0;
@@ -2849,6 +3503,160 @@ const Field3D Mesh::indexFDDY(const Field3D &v, const Field3D &f, CELL_LOC outlo
   return result;
 }
 
+/*!
+ * @brief Fused flux derivative in Y, with the field scaled inside the
+ *        stencil: computes rscale * d/di(v * fscale * f)
+ *
+ * Both scale factors must be axisymmetric. This is the kernel of
+ * Div_par_flux, which applies 1/B to the field and B/(dy*sqrt(g_22))
+ * to the result: doing so inside the sweep avoids materialising the
+ * scaled field (and its yup/ydown slices) and two further whole-field
+ * multiplies.
+ */
+const Field3D Mesh::indexFDDY(const Field3D &v, const Field3D &f, const Field2D &fscale,
+                              const Field2D &rscale, CELL_LOC outloc,
+                              DIFF_METHOD method, REGION region) {
+  TRACE("Mesh::indexFDDY(Field3D, Field3D, scaled)");
+
+  CELL_LOC vloc = v.getLocation();
+  CELL_LOC inloc = f.getLocation(); // Input location
+  if (outloc == CELL_DEFAULT)
+    outloc = inloc;
+
+  Mesh::flux_func func = fFDDY;
+  DiffLookup *table = FluxTable;
+
+  if (StaggerGrids && (vloc != inloc)) {
+    // V staggered w.r.t. variable
+    func = sfFDDY;
+    table = FluxStagTable;
+  }
+
+  if ((method != DIFF_DEFAULT) && (method != DIFF_SPLIT)) {
+    // Lookup function
+    func = lookupFunc(table, method);
+  }
+
+  if ((method == DIFF_SPLIT) || (func == nullptr)) {
+    // Split into an upwind and a central differencing part, which
+    // needs the scaled field materialised, along with any yup/ydown
+    // fields it carries
+    Field3D f_s = f * fscale;
+    if (f.hasYupYdown()) {
+      if (&f.yup() == &f) {
+        // Identity, yup and ydown point to same field
+        f_s.mergeYupYdown();
+      } else {
+        // Distinct fields
+        f_s.splitYupYdown();
+        f_s.yup() = f.yup() * fscale;
+        f_s.ydown() = f.ydown() * fscale;
+      }
+    }
+    return indexFDDY(v, f_s, outloc, method, region) * rscale;
+  }
+
+  // Allowed staggers:
+  ASSERT1(outloc == inloc &&
+          ((vloc == inloc) || (vloc == CELL_CENTRE && inloc == CELL_YLOW) ||
+           (vloc == CELL_YLOW && inloc == CELL_CENTRE)));
+
+  ASSERT1(this == v.getMesh());
+  ASSERT1(this == f.getMesh());
+
+  Field3D result(this);
+  result.allocate(); // Make sure data allocated
+  result.setLocation(outloc);
+
+  // If *UseUpDown is true, field "*" has distinct yup and ydown fields which
+  // will be used to calculate a derivative along the magnetic field
+  bool vUseUpDown = (v.hasYupYdown() && ((&v.yup() != &v) || (&v.ydown() != &v)));
+  bool fUseUpDown = (f.hasYupYdown() && ((&f.yup() != &f) || (&f.ydown() != &f)));
+
+  /// Convert REGION enum to a Region string identifier
+  const auto region_str = REGION_STRING(region);
+
+  if (vUseUpDown && fUseUpDown) {
+    // Both v and f have up/down fields. The scaling is applied to the
+    // stencil values directly, at the y index each value comes from
+    BOUT_OMP(parallel) {
+      stencil fval, vval;
+      BOUT_FOR_INNER(i, this->getRegion3D(region_str)) {
+        const auto i2 = ind3Dto2D(i);
+
+        fval.m = f.ydown()[i.ym()] * fscale[i2.ym()];
+        fval.c = f[i] * fscale[i2];
+        fval.p = f.yup()[i.yp()] * fscale[i2.yp()];
+
+        vval.m = v.ydown()[i.ym()];
+        vval.c = v[i];
+        vval.p = v.yup()[i.yp()];
+
+        if (StaggerGrids && (inloc != vloc)) {
+          // Non-centred stencil
+          if (inloc == CELL_YLOW) {
+            // Producing a stencil centred around a lower Y value
+            vval.pp = vval.p;
+            vval.p = vval.c;
+          } else {
+            // Stencil centred around a cell centre
+            vval.mm = vval.m;
+            vval.m = vval.c;
+          }
+        }
+        result[i] = rscale[i2] * func(vval, fval);
+      }
+    }
+  } else {
+    // Both must shift to field aligned
+    // The scale factors are axisymmetric, so applying them in
+    // field-aligned coordinates commutes with the shifts
+    Field3D v_fa = this->toFieldAligned(v);
+    Field3D f_fa = this->toFieldAligned(f);
+    BOUT_OMP(parallel) {
+      stencil fval, vval;
+      BOUT_FOR_INNER(i, this->getRegion3D(region_str)) {
+        const auto i2 = ind3Dto2D(i);
+
+        fval.mm = f_fa[i.ymm()] * fscale[i2.ymm()];
+        fval.m = f_fa[i.ym()] * fscale[i2.ym()];
+        fval.c = f_fa[i] * fscale[i2];
+        fval.p = f_fa[i.yp()] * fscale[i2.yp()];
+        fval.pp = f_fa[i.ypp()] * fscale[i2.ypp()];
+
+        vval.mm = v_fa[i.ymm()];
+        vval.m = v_fa[i.ym()];
+        vval.c = v_fa[i];
+        vval.p = v_fa[i.yp()];
+        vval.pp = v_fa[i.ypp()];
+
+        if (StaggerGrids && (inloc != vloc)) {
+          // Non-centred stencil
+          if (inloc == CELL_YLOW) {
+            // Producing a stencil centred around a lower Y value
+            vval.pp = vval.p;
+            vval.p = vval.c;
+          } else {
+            // Stencil centred around a cell centre
+            vval.mm = vval.m;
+            vval.m = vval.c;
+          }
+        }
+        result[i] = rscale[i2] * func(vval, fval);
+      }
+    }
+
+    result = this->fromFieldAligned(result);
+  }
+
+#if CHECK > 0
+  // Mark boundaries as invalid
+  result.bndry_xin = result.bndry_xout = result.bndry_yup = result.bndry_ydown = false;
+#endif
+
+  return result;
+}
+
 /////////////////////////////////////////////////////////////////////////
 
 const Field3D Mesh::indexFDDZ(const Field3D &v, const Field3D &f, CELL_LOC outloc,
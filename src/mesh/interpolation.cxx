@@ -273,6 +273,24 @@ const Field3D interp_to(const Field3D &var, CELL_LOC loc, REGION region) {
   return result;
 }
 
+const Field3D interp_to(Field3D &&var, CELL_LOC loc, REGION region) {
+
+  Mesh *fieldmesh = var.getMesh();
+
+  if (fieldmesh->StaggerGrids && (var.getLocation() != loc)) {
+    // Interpolation genuinely needed
+    return interp_to(var, loc, region);
+  }
+
+  if ((loc != CELL_CENTRE && loc != CELL_DEFAULT) && (fieldmesh->StaggerGrids == false)) {
+    throw BoutException("Asked to interpolate, but StaggerGrids is disabled!");
+  }
+
+  // Nothing to do - pass the temporary straight through, reusing its
+  // storage rather than taking another reference to the data
+  return std::move(var);
+}
+
 const Field2D interp_to(const Field2D &var, CELL_LOC loc, REGION region) {
 
   Mesh *fieldmesh = var.getMesh();
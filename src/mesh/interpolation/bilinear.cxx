@@ -21,6 +21,7 @@
  **************************************************************************/
 
 #include "bout/mesh.hxx"
+#include "bout/openmpwrap.hxx"
 #include "globals.hxx"
 #include "interpolation.hxx"
 
@@ -28,35 +29,35 @@
 #include <vector>
 
 Bilinear::Bilinear(int y_offset, Mesh *mesh)
-  : Interpolation(y_offset, mesh), w0(localmesh), w1(localmesh), w2(localmesh), w3(localmesh) {
+  : Interpolation(y_offset, mesh) {}
 
-  // Index arrays contain guard cells in order to get subscripts right
-  i_corner = Tensor<int>(localmesh->LocalNx, localmesh->LocalNy, localmesh->LocalNz);
-  k_corner = Tensor<int>(localmesh->LocalNx, localmesh->LocalNy, localmesh->LocalNz);
+void Bilinear::calcWeights(const Field3D &delta_x, const Field3D &delta_z) {
+  if (weightsCachedFor(delta_x, delta_z)) {
+    return; // Same displacement data as the last call
+  }
 
-  // Allocate Field3D members
-  w0.allocate();
-  w1.allocate();
-  w2.allocate();
-  w3.allocate();
-}
+  const int ny = localmesh->LocalNy;
+  const int ncz = localmesh->LocalNz;
+
+  fused_out.clear();
+  fused_ind.clear();
+  fused_w.clear();
 
-void Bilinear::calcWeights(const Field3D &delta_x, const Field3D &delta_z) {
   for(int x=localmesh->xstart;x<=localmesh->xend;x++) {
     for(int y=localmesh->ystart; y<=localmesh->yend;y++) {
-      for(int z=0;z<localmesh->LocalNz;z++) {
+      for(int z=0;z<ncz;z++) {
 
         if (skip_mask(x, y, z)) continue;
 
         // The integer part of xt_prime, zt_prime are the indices of the cell
         // containing the field line end-point
-        i_corner(x, y, z) = static_cast<int>(floor(delta_x(x, y, z)));
-        k_corner(x, y, z) = static_cast<int>(floor(delta_z(x, y, z)));
+        int i_corner = static_cast<int>(floor(delta_x(x, y, z)));
+        int k_corner = static_cast<int>(floor(delta_z(x, y, z)));
 
         // t_x, t_z are the normalised coordinates \in [0,1) within the cell
         // calculated by taking the remainder of the floating point index
-        BoutReal t_x = delta_x(x, y, z) - static_cast<BoutReal>(i_corner(x, y, z));
-        BoutReal t_z = delta_z(x, y, z) - static_cast<BoutReal>(k_corner(x, y, z));
+        BoutReal t_x = delta_x(x, y, z) - static_cast<BoutReal>(i_corner);
+        BoutReal t_z = delta_z(x, y, z) - static_cast<BoutReal>(k_corner);
         BoutReal t_x1 = 1.0 - t_x;
         BoutReal t_z1 = 1.0 - t_z;
 
@@ -67,18 +68,33 @@ void Bilinear::calcWeights(const Field3D &delta_x, const Field3D &delta_z) {
         if( (t_z < 0.0) || (t_z > 1.0) )
           throw BoutException("t_z=%e out of range at (%d,%d,%d)", t_z, x,y,z);
 
-        w0(x,y,z) = t_x1 * t_z1;
-        w1(x,y,z) = t_x  * t_z1;
-        w2(x,y,z) = t_x1 * t_z;
-        w3(x,y,z) = t_x  * t_z;
+        const int y_next = y + y_offset;
+
+        // Due to lack of guard cells in z-direction, we need to ensure z-index
+        // wraps around
+        const int z_mod = ((k_corner % ncz) + ncz) % ncz;
+        const int z_mod_p1 = (z_mod + 1) % ncz;
+
+        fused_out.push_back((x * ny + y_next) * ncz + z);
+
+        fused_ind.push_back((i_corner * ny + y_next) * ncz + z_mod);
+        fused_ind.push_back(((i_corner + 1) * ny + y_next) * ncz + z_mod);
+        fused_ind.push_back((i_corner * ny + y_next) * ncz + z_mod_p1);
+        fused_ind.push_back(((i_corner + 1) * ny + y_next) * ncz + z_mod_p1);
 
+        fused_w.push_back(t_x1 * t_z1);
+        fused_w.push_back(t_x  * t_z1);
+        fused_w.push_back(t_x1 * t_z);
+        fused_w.push_back(t_x  * t_z);
       }
     }
   }
+
+  cacheWeightsFor(delta_x, delta_z);
 }
 
 void Bilinear::calcWeights(const Field3D &delta_x, const Field3D &delta_z, const BoutMask &mask) {
-  skip_mask = mask;
+  setMask(mask);
   calcWeights(delta_x, delta_z);
 }
 
@@ -87,25 +103,17 @@ Field3D Bilinear::interpolate(const Field3D& f) const {
   Field3D f_interp(f.getMesh());
   f_interp.allocate();
 
-  for(int x=localmesh->xstart;x<=localmesh->xend;x++) {
-    for(int y=localmesh->ystart; y<=localmesh->yend;y++) {
-      for(int z=0;z<localmesh->LocalNz;z++) {
-
-        if (skip_mask(x, y, z)) continue;
-
-        int y_next = y + y_offset;
-        // Due to lack of guard cells in z-direction, we need to ensure z-index
-        // wraps around
-        int ncz = localmesh->LocalNz;
-        int z_mod = ((k_corner(x, y, z) % ncz) + ncz) % ncz;
-        int z_mod_p1 = (z_mod + 1) % ncz;
-
-        f_interp(x, y_next, z) = f(i_corner(x, y, z), y_next, z_mod) * w0(x, y, z) +
-                                 f(i_corner(x, y, z) + 1, y_next, z_mod) * w1(x, y, z) +
-                                 f(i_corner(x, y, z), y_next, z_mod_p1) * w2(x, y, z) +
-                                 f(i_corner(x, y, z) + 1, y_next, z_mod_p1) * w3(x, y, z);
-      }
-    }
+  // Apply the blocked weight rows as a sparse matrix-vector product
+  const BoutReal *fd = &f(0, 0, 0);
+  BoutReal *od = &f_interp(0, 0, 0);
+
+  const int nrows = static_cast<int>(fused_out.size());
+  BOUT_OMP(parallel for schedule(OPENMP_SCHEDULE))
+  for (int row = 0; row < nrows; row++) {
+    const int *ind = &fused_ind[row * 4];
+    const BoutReal *w = &fused_w[row * 4];
+    od[fused_out[row]] =
+        w[0] * fd[ind[0]] + w[1] * fd[ind[1]] + w[2] * fd[ind[2]] + w[3] * fd[ind[3]];
   }
   return f_interp;
 }
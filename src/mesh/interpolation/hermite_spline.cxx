@@ -21,6 +21,7 @@
  **************************************************************************/
 
 #include "bout/mesh.hxx"
+#include "bout/openmpwrap.hxx"
 #include "globals.hxx"
 #include "interpolation.hxx"
 
@@ -47,6 +48,9 @@ HermiteSpline::HermiteSpline(int y_offset, Mesh *mesh)
 }
 
 void HermiteSpline::calcWeights(const Field3D &delta_x, const Field3D &delta_z) {
+  if (weightsCachedFor(delta_x, delta_z)) {
+    return; // Same displacement data as the last call
+  }
 
   BoutReal t_x, t_z;
 
@@ -98,75 +102,97 @@ void HermiteSpline::calcWeights(const Field3D &delta_x, const Field3D &delta_z)
       }
     }
   }
-}
 
-void HermiteSpline::calcWeights(const Field3D &delta_x, const Field3D &delta_z, const BoutMask &mask) {
-  skip_mask = mask;
-  calcWeights(delta_x, delta_z);
+  weights_calculated = true;
+  buildFusedWeights();
+  cacheWeightsFor(delta_x, delta_z);
 }
 
-Field3D HermiteSpline::interpolate(const Field3D &f) const {
+void HermiteSpline::buildFusedWeights() {
+  if (!weights_calculated)
+    return; // calcWeights builds the rows once it has the data
 
-  ASSERT1(f.getMesh() == localmesh);
-  Field3D f_interp(f.getMesh());
-  f_interp.allocate();
+  const int ny = localmesh->LocalNy;
+  const int ncz = localmesh->LocalNz;
 
-  // Derivatives are used for tension and need to be on dimensionless
-  // coordinates
-  Field3D fx = localmesh->indexDDX(f, CELL_DEFAULT, DIFF_DEFAULT);
-  localmesh->communicateXZ(fx);
-  Field3D fz = localmesh->indexDDZ(f, CELL_DEFAULT, DIFF_DEFAULT, true);
-  localmesh->communicateXZ(fz);
-  Field3D fxz = localmesh->indexDDX(fz, CELL_DEFAULT, DIFF_DEFAULT);
-  localmesh->communicateXZ(fxz);
+  fused_out.clear();
+  fused_ind.clear();
+  fused_w.clear();
 
   for (int x = localmesh->xstart; x <= localmesh->xend; x++) {
     for (int y = localmesh->ystart; y <= localmesh->yend; y++) {
-      for (int z = 0; z < localmesh->LocalNz; z++) {
+      for (int z = 0; z < ncz; z++) {
 
         if (skip_mask(x, y, z))
           continue;
 
-        // Due to lack of guard cells in z-direction, we need to ensure z-index
-        // wraps around
-        int ncz = localmesh->LocalNz;
-        int z_mod = ((k_corner(x, y, z) % ncz) + ncz) % ncz;
-        int z_mod_p1 = (z_mod + 1) % ncz;
-
-        int y_next = y + y_offset;
-
-        // Interpolate f in X at Z
-        BoutReal f_z = f(i_corner(x, y, z), y_next, z_mod) * h00_x(x, y, z) +
-                       f(i_corner(x, y, z) + 1, y_next, z_mod) * h01_x(x, y, z) +
-                       fx(i_corner(x, y, z), y_next, z_mod) * h10_x(x, y, z) +
-                       fx(i_corner(x, y, z) + 1, y_next, z_mod) * h11_x(x, y, z);
-
-        // Interpolate f in X at Z+1
-        BoutReal f_zp1 = f(i_corner(x, y, z), y_next, z_mod_p1) * h00_x(x, y, z) +
-                         f(i_corner(x, y, z) + 1, y_next, z_mod_p1) * h01_x(x, y, z) +
-                         fx(i_corner(x, y, z), y_next, z_mod_p1) * h10_x(x, y, z) +
-                         fx(i_corner(x, y, z) + 1, y_next, z_mod_p1) * h11_x(x, y, z);
-
-        // Interpolate fz in X at Z
-        BoutReal fz_z = fz(i_corner(x, y, z), y_next, z_mod) * h00_x(x, y, z) +
-                        fz(i_corner(x, y, z) + 1, y_next, z_mod) * h01_x(x, y, z) +
-                        fxz(i_corner(x, y, z), y_next, z_mod) * h10_x(x, y, z) +
-                        fxz(i_corner(x, y, z) + 1, y_next, z_mod) * h11_x(x, y, z);
-
-        // Interpolate fz in X at Z+1
-        BoutReal fz_zp1 = fz(i_corner(x, y, z), y_next, z_mod_p1) * h00_x(x, y, z) +
-                          fz(i_corner(x, y, z) + 1, y_next, z_mod_p1) * h01_x(x, y, z) +
-                          fxz(i_corner(x, y, z), y_next, z_mod_p1) * h10_x(x, y, z) +
-                          fxz(i_corner(x, y, z) + 1, y_next, z_mod_p1) * h11_x(x, y, z);
-
-        // Interpolate in Z
-        f_interp(x, y_next, z) = +f_z * h00_z(x, y, z) + f_zp1 * h01_z(x, y, z) +
-                                 fz_z * h10_z(x, y, z) + fz_zp1 * h11_z(x, y, z);
-
-        ASSERT2(finite(f_interp(x, y_next, z)));
+        // The tension terms use the central-difference index
+        // derivatives fx(i) = (f(i+1) - f(i-1))/2 (and the same in z),
+        // so folding them into the basis functions gives weights over
+        // the four x offsets i_corner-1 .. i_corner+2
+        BoutReal wx[4];
+        wx[0] = -0.5 * h10_x(x, y, z);
+        wx[1] = h00_x(x, y, z) - 0.5 * h11_x(x, y, z);
+        wx[2] = h01_x(x, y, z) + 0.5 * h10_x(x, y, z);
+        wx[3] = 0.5 * h11_x(x, y, z);
+
+        // Same in z, over k_corner-1 .. k_corner+2
+        BoutReal wz[4];
+        wz[0] = -0.5 * h10_z(x, y, z);
+        wz[1] = h00_z(x, y, z) - 0.5 * h11_z(x, y, z);
+        wz[2] = h01_z(x, y, z) + 0.5 * h10_z(x, y, z);
+        wz[3] = 0.5 * h11_z(x, y, z);
+
+        const int y_next = y + y_offset;
+
+        fused_out.push_back((x * ny + y_next) * ncz + z);
+
+        // The 16 weights are the outer product of the x and z weights
+        for (int a = 0; a < 4; a++) {
+          const int xi = i_corner(x, y, z) - 1 + a;
+          for (int b = 0; b < 4; b++) {
+            // No z guard cells, so wrap the z index
+            const int zi = (((k_corner(x, y, z) - 1 + b) % ncz) + ncz) % ncz;
+            fused_ind.push_back((xi * ny + y_next) * ncz + zi);
+            fused_w.push_back(wx[a] * wz[b]);
+          }
+        }
       }
     }
   }
+}
+
+void HermiteSpline::calcWeights(const Field3D &delta_x, const Field3D &delta_z, const BoutMask &mask) {
+  setMask(mask);
+  calcWeights(delta_x, delta_z);
+}
+
+Field3D HermiteSpline::interpolate(const Field3D &f) const {
+
+  ASSERT1(f.getMesh() == localmesh);
+  Field3D f_interp(f.getMesh());
+  f_interp.allocate();
+
+  // Apply the fused weight rows as a sparse matrix-vector product.
+  // The tension derivatives are folded into the weights when the rows
+  // are built (see buildFusedWeights), so no derivative fields need to
+  // be computed or communicated here, and the inner loop is a plain
+  // 16-term gather which the compiler can vectorise
+  const BoutReal *fd = &f(0, 0, 0);
+  BoutReal *od = &f_interp(0, 0, 0);
+
+  const int nrows = static_cast<int>(fused_out.size());
+  BOUT_OMP(parallel for schedule(OPENMP_SCHEDULE))
+  for (int row = 0; row < nrows; row++) {
+    const int *ind = &fused_ind[row * 16];
+    const BoutReal *w = &fused_w[row * 16];
+    BoutReal val = 0.0;
+    for (int j = 0; j < 16; j++) {
+      val += w[j] * fd[ind[j]];
+    }
+    od[fused_out[row]] = val;
+    ASSERT2(finite(val));
+  }
   return f_interp;
 }
 
@@ -21,61 +21,110 @@
  **************************************************************************/
 
 #include "bout/mesh.hxx"
+#include "bout/openmpwrap.hxx"
 #include "globals.hxx"
 #include "interpolation.hxx"
 
 #include <vector>
 
+namespace {
+/// The weights applied to the four stencil values by lagrange_4pt:
+/// the cubic Lagrange basis polynomials evaluated at \p offset
+void lagrange_basis(BoutReal offset, BoutReal w[4]) {
+  w[0] = -offset * (offset - 1.0) * (offset - 2.0) / 6.0;
+  w[1] = 0.5 * (offset * offset - 1.0) * (offset - 2.0);
+  w[2] = -0.5 * offset * (offset + 1.0) * (offset - 2.0);
+  w[3] = offset * (offset * offset - 1.0) / 6.0;
+}
+} // namespace
+
 Lagrange4pt::Lagrange4pt(int y_offset, Mesh *mesh)
-    : Interpolation(y_offset, mesh), t_x(localmesh), t_z(localmesh) {
+    : Interpolation(y_offset, mesh) {}
 
-  // Index arrays contain guard cells in order to get subscripts right
-  i_corner = Tensor<int>(localmesh->LocalNx, localmesh->LocalNy, localmesh->LocalNz);
-  k_corner = Tensor<int>(localmesh->LocalNx, localmesh->LocalNy, localmesh->LocalNz);
+void Lagrange4pt::calcWeights(const Field3D &delta_x, const Field3D &delta_z) {
+  if (weightsCachedFor(delta_x, delta_z)) {
+    return; // Same displacement data as the last call
+  }
 
-  t_x.allocate();
-  t_z.allocate();
-}
+  const int ny = localmesh->LocalNy;
+  const int ncz = localmesh->LocalNz;
 
-void Lagrange4pt::calcWeights(const Field3D &delta_x, const Field3D &delta_z) {
+  fused_out.clear();
+  fused_ind.clear();
+  fused_w.clear();
 
   for (int x = localmesh->xstart; x <= localmesh->xend; x++) {
     for (int y = localmesh->ystart; y <= localmesh->yend; y++) {
-      for (int z = 0; z < localmesh->LocalNz; z++) {
+      for (int z = 0; z < ncz; z++) {
 
         if (skip_mask(x, y, z))
           continue;
 
         // The integer part of xt_prime, zt_prime are the indices of the cell
         // containing the field line end-point
-        i_corner(x, y, z) = static_cast<int>(floor(delta_x(x, y, z)));
-        k_corner(x, y, z) = static_cast<int>(floor(delta_z(x, y, z)));
+        int i_corner = static_cast<int>(floor(delta_x(x, y, z)));
+        int k_corner = static_cast<int>(floor(delta_z(x, y, z)));
 
         // t_x, t_z are the normalised coordinates \in [0,1) within the cell
         // calculated by taking the remainder of the floating point index
-        t_x(x, y, z) = delta_x(x, y, z) - static_cast<BoutReal>(i_corner(x, y, z));
-        t_z(x, y, z) = delta_z(x, y, z) - static_cast<BoutReal>(k_corner(x, y, z));
+        BoutReal t_x = delta_x(x, y, z) - static_cast<BoutReal>(i_corner);
+        BoutReal t_z = delta_z(x, y, z) - static_cast<BoutReal>(k_corner);
 
         // NOTE: A (small) hack to avoid one-sided differences
-        if (i_corner(x, y, z) == localmesh->xend) {
-          i_corner(x, y, z) -= 1;
-          t_x(x, y, z) = 1.0;
+        if (i_corner == localmesh->xend) {
+          i_corner -= 1;
+          t_x = 1.0;
         }
 
         // Check that t_x and t_z are in range
-        if ((t_x(x, y, z) < 0.0) || (t_x(x, y, z) > 1.0))
-          throw BoutException("t_x=%e out of range at (%d,%d,%d)", t_x(x, y, z), x, y, z);
-
-        if ((t_z(x, y, z) < 0.0) || (t_z(x, y, z) > 1.0))
-          throw BoutException("t_z=%e out of range at (%d,%d,%d)", t_z(x, y, z), x, y, z);
+        if ((t_x < 0.0) || (t_x > 1.0))
+          throw BoutException("t_x=%e out of range at (%d,%d,%d)", t_x, x, y, z);
+
+        if ((t_z < 0.0) || (t_z > 1.0))
+          throw BoutException("t_z=%e out of range at (%d,%d,%d)", t_z, x, y, z);
+
+        // The interpolation is linear in the field values, so the
+        // nested Z-then-X evaluation collapses to the outer product of
+        // the two basis polynomials over the 4x4 stencil
+        BoutReal wx[4], wz[4];
+        lagrange_basis(t_x, wx);
+        lagrange_basis(t_z, wz);
+
+        // The 4 X points, with the edge clamping used by the original
+        // nested evaluation
+        int jx[4];
+        jx[1] = i_corner;
+        jx[0] = (jx[1] == 0) ? 0 : (jx[1] - 1);
+        jx[2] = jx[1] + 1;
+        jx[3] = (jx[1] == (localmesh->LocalNx - 2)) ? jx[2] : (jx[2] + 1);
+
+        // The 4 Z points, wrapped as there are no z guard cells
+        int jz[4];
+        jz[1] = ((k_corner % ncz) + ncz) % ncz;
+        jz[0] = (jz[1] - 1 + ncz) % ncz;
+        jz[2] = (jz[1] + 1) % ncz;
+        jz[3] = (jz[1] + 2) % ncz;
+
+        const int y_next = y + y_offset;
+
+        fused_out.push_back((x * ny + y_next) * ncz + z);
+
+        for (int a = 0; a < 4; a++) {
+          for (int b = 0; b < 4; b++) {
+            fused_ind.push_back((jx[a] * ny + y_next) * ncz + jz[b]);
+            fused_w.push_back(wx[a] * wz[b]);
+          }
+        }
       }
     }
   }
+
+  cacheWeightsFor(delta_x, delta_z);
 }
 
 void Lagrange4pt::calcWeights(const Field3D &delta_x, const Field3D &delta_z,
                               const BoutMask &mask) {
-  skip_mask = mask;
+  setMask(mask);
   calcWeights(delta_x, delta_z);
 }
 
@@ -85,52 +134,20 @@ Field3D Lagrange4pt::interpolate(const Field3D &f) const {
   Field3D f_interp(f.getMesh());
   f_interp.allocate();
 
-  for (int x = localmesh->xstart; x <= localmesh->xend; x++) {
-    for (int y = localmesh->ystart; y <= localmesh->yend; y++) {
-      for (int z = 0; z < localmesh->LocalNz; z++) {
-
-        if (skip_mask(x, y, z))
-          continue;
-
-        int jx = i_corner(x, y, z);
-        int jx2mnew = (jx == 0) ? 0 : (jx - 1);
-        int jxpnew = jx + 1;
-        int jx2pnew = (jx == (localmesh->LocalNx - 2)) ? jxpnew : (jxpnew + 1);
-
-        int ncz = localmesh->LocalNz;
-
-        // Get the 4 Z points
-        int jz = ((k_corner(x, y, z) % ncz) + ncz) % ncz;
-
-        int jzpnew = (jz + 1) % ncz;
-        int jz2pnew = (jz + 2) % ncz;
-        int jz2mnew = (jz - 1 + ncz) % ncz;
-
-        // Interpolate in Z first
-        BoutReal xvals[4];
-
-        int y_next = y + y_offset;
-
-        xvals[0] = lagrange_4pt(f(jx2mnew, y_next, jz2mnew), f(jx2mnew, y_next, jz),
-                                f(jx2mnew, y_next, jzpnew), f(jx2mnew, y_next, jz2pnew),
-                                t_z(x, y, z));
-
-        xvals[1] =
-            lagrange_4pt(f(jx, y_next, jz2mnew), f(jx, y_next, jz), f(jx, y_next, jzpnew),
-                         f(jx, y_next, jz2pnew), t_z(x, y, z));
-
-        xvals[2] = lagrange_4pt(f(jxpnew, y_next, jz2mnew), f(jxpnew, y_next, jz),
-                                f(jxpnew, y_next, jzpnew), f(jxpnew, y_next, jz2pnew),
-                                t_z(x, y, z));
-
-        xvals[3] = lagrange_4pt(f(jx2pnew, y_next, jz2mnew), f(jx2pnew, y_next, jz),
-                                f(jx2pnew, y_next, jzpnew), f(jx2pnew, y_next, jz2pnew),
-                                t_z(x, y, z));
-
-        // Then in X
-        f_interp(x, y_next, z) = lagrange_4pt(xvals, t_x(x, y, z));
-      }
+  // Apply the blocked weight rows as a sparse matrix-vector product
+  const BoutReal *fd = &f(0, 0, 0);
+  BoutReal *od = &f_interp(0, 0, 0);
+
+  const int nrows = static_cast<int>(fused_out.size());
+  BOUT_OMP(parallel for schedule(OPENMP_SCHEDULE))
+  for (int row = 0; row < nrows; row++) {
+    const int *ind = &fused_ind[row * 16];
+    const BoutReal *w = &fused_w[row * 16];
+    BoutReal val = 0.0;
+    for (int j = 0; j < 16; j++) {
+      val += w[j] * fd[ind[j]];
     }
+    od[fused_out[row]] = val;
   }
   return f_interp;
 }
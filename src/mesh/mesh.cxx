@@ -2,6 +2,7 @@
 #include <globals.hxx>
 #include <bout/mesh.hxx>
 #include <bout/coordinates.hxx>
+#include <bout/sys/watchdog.hxx>
 #include <utils.hxx>
 #include <derivs.hxx>
 #include <msg_stack.hxx>
@@ -165,6 +166,7 @@ bool Mesh::sourceHasVar(const string &name) {
 
 void Mesh::communicateXZ(FieldGroup &g) {
   TRACE("Mesh::communicate(FieldGroup&)");
+  Watchdog::beat("communicate");
 
   // Send data
   comm_handle h = send(g);
@@ -175,6 +177,7 @@ void Mesh::communicateXZ(FieldGroup &g) {
 
 void Mesh::communicate(FieldGroup &g) {
   TRACE("Mesh::communicate(FieldGroup&)");
+  Watchdog::beat("communicate");
 
   // Send data
   comm_handle h = send(g);
@@ -187,26 +190,118 @@ void Mesh::communicate(FieldGroup &g) {
     getParallelTransform().calcYUpDown(*fptr);
 }
 
+void Mesh::communicateY(FieldGroup &g) {
+  TRACE("Mesh::communicateY(FieldGroup&)");
+  Watchdog::beat("communicate");
+
+  // Send data
+  comm_handle h = send(g, COMM_Y);
+
+  // Wait for data from other processors
+  wait(h);
+
+  // Calculate yup and ydown fields for 3D fields
+  for(const auto& fptr : g.field3d())
+    getParallelTransform().calcYUpDown(*fptr);
+}
+
+void Mesh::communicate(FieldGroup &g, int dirs) {
+  TRACE("Mesh::communicate(FieldGroup&, dirs)");
+  Watchdog::beat("communicate");
+
+  // Send data
+  comm_handle h = send(g, dirs);
+
+  // Wait for data from other processors
+  wait(h);
+
+  // Parallel slices need both Y boundaries; with only one exchanged
+  // the other slice would be built from stale guard cells
+  if((dirs & COMM_Y) == COMM_Y) {
+    for(const auto& fptr : g.field3d())
+      getParallelTransform().calcYUpDown(*fptr);
+  }
+}
+
+comm_handle Mesh::communicateBegin(FieldGroup &g) {
+  TRACE("Mesh::communicateBegin(FieldGroup&)");
+
+  // Send data, but don't wait: the caller computes on
+  // "RGN_INTERIOR" while guard cells are in flight
+  comm_handle h = send(g);
+
+  // Remember the group so communicateEnd can update parallel slices
+  pending_groups[h] = g;
+
+  return h;
+}
+
+void Mesh::communicateEnd(comm_handle handle) {
+  TRACE("Mesh::communicateEnd(comm_handle)");
+  Watchdog::beat("communicate");
+
+  // Wait for data from other processors
+  wait(handle);
+
+  auto it = pending_groups.find(handle);
+  if (it == pending_groups.end()) {
+    throw BoutException("Mesh::communicateEnd called with a handle not returned by "
+                        "communicateBegin");
+  }
+
+  // Calculate yup and ydown fields for 3D fields
+  for (const auto &fptr : it->second.field3d())
+    getParallelTransform().calcYUpDown(*fptr);
+
+  pending_groups.erase(it);
+}
+
+void Mesh::communicateDeferred(FieldGroup &g) {
+  TRACE("Mesh::communicateDeferred(FieldGroup&)");
+
+  // No MPI here: just accumulate, to be exchanged by flushDeferred()
+  deferred_comms.add(g);
+}
+
+void Mesh::flushDeferred() {
+  TRACE("Mesh::flushDeferred()");
+
+  if (deferred_comms.empty())
+    return;
+
+  // A field may have been deferred more than once; only
+  // communicate it once
+  deferred_comms.makeUnique();
+
+  communicate(deferred_comms);
+  deferred_comms.clear();
+}
+
 /// This is a bit of a hack for now to get FieldPerp communications
 /// The FieldData class needs to be changed to accomodate FieldPerp objects
 void Mesh::communicate(FieldPerp &f) {
-  comm_handle recv[2];
-  
+  comm_handle recv[2], send[2];
+
   int nin = xstart; // Number of x points in inner guard cell
   int nout = LocalNx-xend-1; // Number of x points in outer guard cell
 
-  // Post receives for guard cell regions
+  // Post receives for guard cell regions. FieldPerp data is
+  // contiguous in (x, z), so the messages go directly out of and into
+  // the field, with no pack buffers
 
   recv[0] = irecvXIn(f[0],       nin*LocalNz, 0);
   recv[1] = irecvXOut(f[xend+1], nout*LocalNz, 1);
-  
-  // Send data
-  sendXIn(f[xstart], nin*LocalNz, 1);
-  sendXOut(f[xend-nout+1], nout*LocalNz, 0);
- 
-  // Wait for receive
+
+  // Send data. Non-blocking, so the two messages are in flight
+  // together instead of the outer send waiting behind the inner one
+  send[0] = isendXIn(f[xstart], nin*LocalNz, 1);
+  send[1] = isendXOut(f[xend-nout+1], nout*LocalNz, 0);
+
+  // Wait for receives, then for our sends to clear
   wait(recv[0]);
   wait(recv[1]);
+  wait(send[0]);
+  wait(send[1]);
 }
 
 int Mesh::msg_len(const vector<FieldData*> &var_list, int xge, int xlt, int yge, int ylt) {
@@ -378,6 +473,89 @@ void Mesh::addRegion2D(const std::string &region_name, const Region<Ind2D> &regi
   output_info << "\t" << region.getStats() << "\n";
 }
 
+void Mesh::addRegionUnion3D(const std::string &region_name, const std::string &a,
+                            const std::string &b) {
+  addRegion3D(region_name, getUnion(getRegion3D(a), getRegion3D(b)));
+}
+
+void Mesh::addRegionUnion2D(const std::string &region_name, const std::string &a,
+                            const std::string &b) {
+  addRegion2D(region_name, getUnion(getRegion2D(a), getRegion2D(b)));
+}
+
+void Mesh::addRegionUnionPerp(const std::string &region_name, const std::string &a,
+                              const std::string &b) {
+  addRegionPerp(region_name, getUnion(getRegionPerp(a), getRegionPerp(b)));
+}
+
+void Mesh::addRegionIntersection3D(const std::string &region_name, const std::string &a,
+                                   const std::string &b) {
+  addRegion3D(region_name, intersection(getRegion3D(a), getRegion3D(b)));
+}
+
+void Mesh::addRegionIntersection2D(const std::string &region_name, const std::string &a,
+                                   const std::string &b) {
+  addRegion2D(region_name, intersection(getRegion2D(a), getRegion2D(b)));
+}
+
+void Mesh::addRegionIntersectionPerp(const std::string &region_name, const std::string &a,
+                                     const std::string &b) {
+  addRegionPerp(region_name, intersection(getRegionPerp(a), getRegionPerp(b)));
+}
+
+void Mesh::addRegionDifference3D(const std::string &region_name, const std::string &a,
+                                 const std::string &b) {
+  addRegion3D(region_name, mask(getRegion3D(a), getRegion3D(b)));
+}
+
+void Mesh::addRegionDifference2D(const std::string &region_name, const std::string &a,
+                                 const std::string &b) {
+  addRegion2D(region_name, mask(getRegion2D(a), getRegion2D(b)));
+}
+
+void Mesh::addRegionDifferencePerp(const std::string &region_name, const std::string &a,
+                                   const std::string &b) {
+  addRegionPerp(region_name, mask(getRegionPerp(a), getRegionPerp(b)));
+}
+
+const Region<> &Mesh::getRegionShrunk3D(int depth) {
+  ASSERT1(depth >= 0);
+  if (depth == 0) {
+    return getRegion3D("RGN_NOBNDRY");
+  }
+  const std::string region_name = "RGN_SHRUNK_" + toString(depth);
+  if (regionMap3D.count(region_name) == 0) {
+    if ((xstart + depth > xend - depth) || (ystart + depth > yend - depth)) {
+      throw BoutException("getRegionShrunk3D: depth %d leaves no points "
+                          "(nx: %d - %d, ny: %d - %d)",
+                          depth, xstart, xend, ystart, yend);
+    }
+    addRegion3D(region_name,
+                Region<Ind3D>(xstart + depth, xend - depth, ystart + depth, yend - depth,
+                              0, LocalNz - 1, LocalNy, LocalNz, maxregionblocksize));
+  }
+  return getRegion3D(region_name);
+}
+
+const Region<Ind2D> &Mesh::getRegionShrunk2D(int depth) {
+  ASSERT1(depth >= 0);
+  if (depth == 0) {
+    return getRegion2D("RGN_NOBNDRY");
+  }
+  const std::string region_name = "RGN_SHRUNK_" + toString(depth);
+  if (regionMap2D.count(region_name) == 0) {
+    if ((xstart + depth > xend - depth) || (ystart + depth > yend - depth)) {
+      throw BoutException("getRegionShrunk2D: depth %d leaves no points "
+                          "(nx: %d - %d, ny: %d - %d)",
+                          depth, xstart, xend, ystart, yend);
+    }
+    addRegion2D(region_name,
+                Region<Ind2D>(xstart + depth, xend - depth, ystart + depth, yend - depth,
+                              0, 0, LocalNy, 1, maxregionblocksize));
+  }
+  return getRegion2D(region_name);
+}
+
 void Mesh::addRegionPerp(const std::string &region_name, const Region<IndPerp> &region) {
   if (regionMapPerp.count(region_name)) {
     throw BoutException("Trying to add an already existing region %s to regionMapPerp",region_name.c_str());
@@ -397,7 +575,32 @@ void Mesh::createDefaultRegions(){
                                        LocalNy, LocalNz, maxregionblocksize));
   addRegion3D("RGN_NOY", Region<Ind3D>(0, LocalNx - 1, ystart, yend, 0, LocalNz - 1,
                                        LocalNy, LocalNz, maxregionblocksize));
-  addRegion3D("RGN_GUARDS", mask(getRegion3D("RGN_ALL"), getRegion3D("RGN_NOBNDRY")));
+  addRegion3D("RGN_GUARDS", mask(getRegion3D("RGN_ALL"), getRegion3D("RGN_NOBNDRY"))
+                  .tuneSchedule());
+  // Split of RGN_NOBNDRY for overlapping computation with
+  // communication (see Mesh::communicateBegin): points whose
+  // width-one stencils don't touch the guard cells, and the rim that
+  // needs communicated data. Z is periodic locally so only the x and
+  // y edges are excluded
+  addRegion3D("RGN_INTERIOR",
+              Region<Ind3D>(xstart + 1, xend - 1, ystart + 1, yend - 1, 0, LocalNz - 1,
+                            LocalNy, LocalNz, maxregionblocksize));
+  addRegion3D("RGN_RIM", mask(getRegion3D("RGN_NOBNDRY"), getRegion3D("RGN_INTERIOR"))
+                  .tuneSchedule());
+  // Direction-resolved splits for the same purpose: an X derivative
+  // only reads x guard cells, so its interior pass can cover every y
+  // index, and vice versa. The margin is the full guard width so that
+  // five-point stencils are also safe
+  addRegion3D("RGN_XINTERIOR",
+              Region<Ind3D>(2 * xstart, xend - xstart, ystart, yend, 0, LocalNz - 1,
+                            LocalNy, LocalNz, maxregionblocksize));
+  addRegion3D("RGN_XRIM", mask(getRegion3D("RGN_NOBNDRY"), getRegion3D("RGN_XINTERIOR"))
+                  .tuneSchedule());
+  addRegion3D("RGN_YINTERIOR",
+              Region<Ind3D>(xstart, xend, 2 * ystart, yend - ystart, 0, LocalNz - 1,
+                            LocalNy, LocalNz, maxregionblocksize));
+  addRegion3D("RGN_YRIM", mask(getRegion3D("RGN_NOBNDRY"), getRegion3D("RGN_YINTERIOR"))
+                  .tuneSchedule());
 
   //2D regions
   addRegion2D("RGN_ALL", Region<Ind2D>(0, LocalNx - 1, 0, LocalNy - 1, 0, 0, LocalNy, 1,
@@ -408,7 +611,20 @@ void Mesh::createDefaultRegions(){
                                        maxregionblocksize));
   addRegion2D("RGN_NOY", Region<Ind2D>(0, LocalNx - 1, ystart, yend, 0, 0, LocalNy, 1,
                                        maxregionblocksize));
-  addRegion2D("RGN_GUARDS", mask(getRegion2D("RGN_ALL"), getRegion2D("RGN_NOBNDRY")));
+  addRegion2D("RGN_GUARDS", mask(getRegion2D("RGN_ALL"), getRegion2D("RGN_NOBNDRY"))
+                  .tuneSchedule());
+  addRegion2D("RGN_INTERIOR", Region<Ind2D>(xstart + 1, xend - 1, ystart + 1, yend - 1, 0,
+                                            0, LocalNy, 1, maxregionblocksize));
+  addRegion2D("RGN_RIM", mask(getRegion2D("RGN_NOBNDRY"), getRegion2D("RGN_INTERIOR"))
+                  .tuneSchedule());
+  addRegion2D("RGN_XINTERIOR", Region<Ind2D>(2 * xstart, xend - xstart, ystart, yend, 0,
+                                             0, LocalNy, 1, maxregionblocksize));
+  addRegion2D("RGN_XRIM", mask(getRegion2D("RGN_NOBNDRY"), getRegion2D("RGN_XINTERIOR"))
+                  .tuneSchedule());
+  addRegion2D("RGN_YINTERIOR", Region<Ind2D>(xstart, xend, 2 * ystart, yend - ystart, 0,
+                                             0, LocalNy, 1, maxregionblocksize));
+  addRegion2D("RGN_YRIM", mask(getRegion2D("RGN_NOBNDRY"), getRegion2D("RGN_YINTERIOR"))
+                  .tuneSchedule());
 
   // Perp regions
   addRegionPerp("RGN_ALL", Region<IndPerp>(0, LocalNx - 1, 0, 0, 0, LocalNz - 1, 1,
@@ -419,7 +635,16 @@ void Mesh::createDefaultRegions(){
                                            maxregionblocksize)); // Same as NOBNDRY
   addRegionPerp("RGN_NOY", Region<IndPerp>(0, LocalNx - 1, 0, 0, 0, LocalNz - 1, 1,
                                            LocalNz, maxregionblocksize)); // Same as ALL
-  addRegionPerp("RGN_GUARDS", mask(getRegionPerp("RGN_ALL"), getRegionPerp("RGN_NOBNDRY")));
+  addRegionPerp("RGN_GUARDS", mask(getRegionPerp("RGN_ALL"), getRegionPerp("RGN_NOBNDRY"))
+                    .tuneSchedule());
+  // The two X guard regions separately, for boundary conditions which
+  // only apply on a physical (not processor) boundary
+  addRegionPerp("RGN_INNER_X", Region<IndPerp>(0, xstart - 1, 0, 0, 0, LocalNz - 1, 1,
+                                               LocalNz, maxregionblocksize)
+                                   .tuneSchedule());
+  addRegionPerp("RGN_OUTER_X", Region<IndPerp>(xend + 1, LocalNx - 1, 0, 0, 0,
+                                               LocalNz - 1, 1, LocalNz, maxregionblocksize)
+                                   .tuneSchedule());
 
   // Construct index lookup for 3D-->2D
   indexLookup3Dto2D = Array<int>(LocalNx*LocalNy*LocalNz);
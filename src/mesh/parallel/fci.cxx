@@ -302,21 +302,30 @@ const Field3D FCIMap::integrate(Field3D &f) const {
 void FCITransform::calcYUpDown(Field3D &f) {
   TRACE("FCITransform::calcYUpDown");
 
+  if (f.parallelSlicesUpToDate())
+    return; // Field not modified since the slices were last interpolated
+
   // Ensure that yup and ydown are different fields
   f.splitYupYdown();
 
   // Interpolate f onto yup and ydown fields
   f.ynext(forward_map.dir) = forward_map.interpolate(f);
   f.ynext(backward_map.dir) = backward_map.interpolate(f);
+
+  f.parallelSlicesCalculated();
 }
 
 void FCITransform::integrateYUpDown(Field3D &f) {
   TRACE("FCITransform::integrateYUpDown");
-  
+
   // Ensure that yup and ydown are different fields
   f.splitYupYdown();
 
   // Integrate f onto yup and ydown fields
   f.ynext(forward_map.dir) = forward_map.integrate(f);
   f.ynext(backward_map.dir) = backward_map.integrate(f);
+
+  // The slices now hold integrals, not the interpolated values
+  // calcYUpDown would produce, so don't let it skip the recalculation
+  f.invalidateParallelSlices();
 }
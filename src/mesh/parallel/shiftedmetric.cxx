@@ -8,9 +8,11 @@
 
 #include <bout/paralleltransform.hxx>
 #include <bout/mesh.hxx>
+#include <bout/zmodemask.hxx>
 #include <fft.hxx>
 #include <bout/constants.hxx>
 
+#include <algorithm>
 #include <cmath>
 
 #include <output.hxx>
@@ -98,20 +100,173 @@ ShiftedMetric::ShiftedMetric(Mesh &m) : mesh(m), zShift(&m) {
     }
   }
 
+  // Optional real-space shift mode: see the member documentation in
+  // paralleltransform.hxx. The phase tables above are kept for the
+  // general-angle shiftZ and the spectral cross-check
+  Options &smopts = Options::root()["shiftedmetric"];
+  realspace_shift = smopts["realspace"].withDefault(false);
+  interp_order = smopts["realspace_order"].withDefault(4);
+  check_spectral = smopts["realspace_check"].withDefault(false);
+
+  if (realspace_shift) {
+    if ((interp_order < 2) || (interp_order > 8) || (interp_order % 2 != 0)) {
+      throw BoutException("shiftedmetric:realspace_order must be an even number "
+                          "between 2 and 8, got %d", interp_order);
+    }
+    output.write("\tShiftedMetric using real-space shifts, %d-point Lagrange\n",
+                 interp_order);
+
+    toAlignedInterp = makeInterpTable(0, mesh.LocalNy - 1, 0, +1.0);
+    fromAlignedInterp = makeInterpTable(0, mesh.LocalNy - 1, 0, -1.0);
+    yupInterp = makeInterpTable(mesh.ystart, mesh.yend, +1, -1.0);
+    ydownInterp = makeInterpTable(mesh.ystart, mesh.yend, -1, -1.0);
+  }
+}
+
+void ShiftedMetric::interpWeights(BoutReal angle, int &offset, BoutReal *w) {
+  const BoutReal dz = mesh.getCoordinates()->zlength() / mesh.LocalNz;
+  const BoutReal d = angle / dz; // The shift in grid points
+  const int base = static_cast<int>(std::floor(d));
+  const BoutReal frac = d - base;
+  const int half = interp_order / 2 - 1;
+
+  offset = base - half;
+
+  // Lagrange weights interpolating at frac on the integer nodes
+  // (m - half), m = 0 .. interp_order-1
+  for (int m = 0; m < interp_order; m++) {
+    BoutReal wm = 1.0;
+    for (int k = 0; k < interp_order; k++) {
+      if (k != m) {
+        wm *= (frac + half - k) / static_cast<BoutReal>(m - k);
+      }
+    }
+    w[m] = wm;
+  }
+}
+
+ShiftedMetric::ZShiftInterp ShiftedMetric::makeInterpTable(int ys, int ye, int ydir,
+                                                           BoutReal sign) {
+  ZShiftInterp tab;
+  tab.offset.resize(mesh.LocalNx * mesh.LocalNy);
+  tab.weights.resize(mesh.LocalNx * mesh.LocalNy * interp_order);
+
+  for (int jx = 0; jx < mesh.LocalNx; jx++) {
+    for (int jy = 0; jy < mesh.LocalNy; jy++) {
+      const int i = jx * mesh.LocalNy + jy;
+      BoutReal angle = 0.0; // Identity outside [ys, ye], matching the phase tables
+      if ((jy >= ys) && (jy <= ye)) {
+        angle = (ydir == 0) ? sign * zShift(jx, jy)
+                            : sign * (zShift(jx, jy) - zShift(jx, jy + ydir));
+      }
+      interpWeights(angle, tab.offset[i], &tab.weights[i * interp_order]);
+    }
+  }
+  return tab;
+}
+
+void ShiftedMetric::shiftZInterpPencil(const BoutReal *in, int offset,
+                                       const BoutReal *w, BoutReal *out) {
+  const int nz = mesh.LocalNz;
+  for (int jz = 0; jz < nz; jz++) {
+    int idx = ((jz + offset) % nz + nz) % nz;
+    BoutReal sum = 0.0;
+    for (int m = 0; m < interp_order; m++) {
+      sum += w[m] * in[idx];
+      if (++idx == nz) {
+        idx = 0;
+      }
+    }
+    out[jz] = sum;
+  }
+}
+
+const Field3D ShiftedMetric::shiftZInterp(const Field3D &f, const ZShiftInterp &tab,
+                                          const arr3Dvec &phs) {
+  ASSERT1(&mesh == f.getMesh());
+  if(mesh.LocalNz == 1)
+    return f; // Shifting makes no difference
+
+  Field3D result(&mesh);
+  result.allocate();
+
+  for(int jx=0;jx<mesh.LocalNx;jx++) {
+    for(int jy=0;jy<mesh.LocalNy;jy++) {
+      const int i = jx * mesh.LocalNy + jy;
+      shiftZInterpPencil(f(jx, jy), tab.offset[i], &tab.weights[i * interp_order],
+                         result(jx, jy));
+    }
+  }
+
+  if (check_spectral && !checked) {
+    // One-off accuracy cross-check against the spectral path
+    checked = true;
+    const Field3D spectral = shiftZ(f, phs);
+    BoutReal maxdiff = 0.0;
+    for (int jx = 0; jx < mesh.LocalNx; jx++) {
+      for (int jy = 0; jy < mesh.LocalNy; jy++) {
+        for (int jz = 0; jz < mesh.LocalNz; jz++) {
+          const BoutReal diff = std::abs(result(jx, jy, jz) - spectral(jx, jy, jz));
+          if (diff > maxdiff) {
+            maxdiff = diff;
+          }
+        }
+      }
+    }
+    output.write("\tShiftedMetric real-space shift: max difference from spectral "
+                 "path %e\n", maxdiff);
+  }
+
+  return result;
+}
+
+void ShiftedMetric::shiftZInterpInPlace(Field3D &f, const ZShiftInterp &tab) {
+  ASSERT1(&mesh == f.getMesh());
+  if(mesh.LocalNz == 1)
+    return; // Shifting makes no difference
+
+  //Ensure the data is unique before transforming it in place
+  f.allocate();
+
+  // The stencil reads around each output point, so interpolate from a
+  // copy of the pencil
+  std::vector<BoutReal> tmp(mesh.LocalNz);
+  for(int jx=0;jx<mesh.LocalNx;jx++) {
+    for(int jy=0;jy<mesh.LocalNy;jy++) {
+      const int i = jx * mesh.LocalNy + jy;
+      std::copy(f(jx, jy), f(jx, jy) + mesh.LocalNz, tmp.begin());
+      shiftZInterpPencil(tmp.data(), tab.offset[i], &tab.weights[i * interp_order],
+                         f(jx, jy));
+    }
+  }
 }
 
 /*!
  * Calculate the Y up and down fields
  */
 void ShiftedMetric::calcYUpDown(Field3D &f) {
+  if(f.parallelSlicesUpToDate())
+    return; // Field not modified since the slices were last calculated
+
   f.splitYupYdown();
-  
+
   Field3D& yup = f.yup();
   yup.allocate();
 
+  //Per-x mode truncation, when enabled (not applied to the
+  //real-space interpolation path, which never leaves real space)
+  const bool masked = ZModeMask::enabled();
+
   for(int jx=0;jx<mesh.LocalNx;jx++) {
+    const int zlimit = masked ? ZModeMask::zmax(jx) : -1;
     for(int jy=mesh.ystart;jy<=mesh.yend;jy++) {
-      shiftZ(&(f(jx,jy+1,0)), yupPhs[jx][jy], &(yup(jx,jy+1,0)));
+      if (realspace_shift) {
+        const int i = jx * mesh.LocalNy + jy;
+        shiftZInterpPencil(&(f(jx, jy + 1, 0)), yupInterp.offset[i],
+                           &yupInterp.weights[i * interp_order], &(yup(jx, jy + 1, 0)));
+      } else {
+        shiftZ(&(f(jx,jy+1,0)), yupPhs[jx][jy], &(yup(jx,jy+1,0)), zlimit);
+      }
     }
   }
 
@@ -119,10 +274,20 @@ void ShiftedMetric::calcYUpDown(Field3D &f) {
   ydown.allocate();
 
   for(int jx=0;jx<mesh.LocalNx;jx++) {
+    const int zlimit = masked ? ZModeMask::zmax(jx) : -1;
     for(int jy=mesh.ystart;jy<=mesh.yend;jy++) {
-      shiftZ(&(f(jx,jy-1,0)), ydownPhs[jx][jy], &(ydown(jx,jy-1,0)));
+      if (realspace_shift) {
+        const int i = jx * mesh.LocalNy + jy;
+        shiftZInterpPencil(&(f(jx, jy - 1, 0)), ydownInterp.offset[i],
+                           &ydownInterp.weights[i * interp_order],
+                           &(ydown(jx, jy - 1, 0)));
+      } else {
+        shiftZ(&(f(jx,jy-1,0)), ydownPhs[jx][jy], &(ydown(jx,jy-1,0)), zlimit);
+      }
     }
   }
+
+  f.parallelSlicesCalculated();
 }
   
 /*!
@@ -130,6 +295,9 @@ void ShiftedMetric::calcYUpDown(Field3D &f) {
  * and Y is then field aligned.
  */
 const Field3D ShiftedMetric::toFieldAligned(const Field3D &f) {
+  if (realspace_shift) {
+    return shiftZInterp(f, toAlignedInterp, toAlignedPhs);
+  }
   return shiftZ(f, toAlignedPhs);
 }
 
@@ -138,9 +306,32 @@ const Field3D ShiftedMetric::toFieldAligned(const Field3D &f) {
  * but Y is not field aligned.
  */
 const Field3D ShiftedMetric::fromFieldAligned(const Field3D &f) {
+  if (realspace_shift) {
+    return shiftZInterp(f, fromAlignedInterp, fromAlignedPhs);
+  }
   return shiftZ(f, fromAlignedPhs);
 }
 
+/*!
+ * In-place variants, for callers which don't need the unshifted field
+ * afterwards. These avoid allocating a result field.
+ */
+void ShiftedMetric::toFieldAlignedInPlace(Field3D &f) {
+  if (realspace_shift) {
+    shiftZInterpInPlace(f, toAlignedInterp);
+    return;
+  }
+  shiftZInPlace(f, toAlignedPhs);
+}
+
+void ShiftedMetric::fromFieldAlignedInPlace(Field3D &f) {
+  if (realspace_shift) {
+    shiftZInterpInPlace(f, fromAlignedInterp);
+    return;
+  }
+  shiftZInPlace(f, fromAlignedPhs);
+}
+
 const Field3D ShiftedMetric::shiftZ(const Field3D &f, const arr3Dvec &phs) {
   ASSERT1(&mesh == f.getMesh());
   if(mesh.LocalNz == 1)
@@ -148,30 +339,92 @@ const Field3D ShiftedMetric::shiftZ(const Field3D &f, const arr3Dvec &phs) {
 
   Field3D result(&mesh);
   result.allocate();
-  
+
+  //All the z-pencils are contiguous in memory, so transform the whole
+  //field in one batched FFT call rather than looping rfft/irfft over
+  //each pencil
+  const int npencils = mesh.LocalNx*mesh.LocalNy;
+  const int nmodes = mesh.LocalNz/2 + 1;
+
+  cmplxAll.resize(npencils*nmodes);
+
+  rfft_many(&f(0,0,0), mesh.LocalNz, npencils, &cmplxAll[0]);
+
+  //With a z mode mask, only the kept modes at each radius are
+  //shifted; the rest are zeroed rather than rotated
+  const bool masked = ZModeMask::enabled();
+
   for(int jx=0;jx<mesh.LocalNx;jx++) {
+    const int jzend = masked ? ZModeMask::zmax(jx) + 1 : nmodes;
     for(int jy=0;jy<mesh.LocalNy;jy++) {
-      shiftZ(f(jx,jy), phs[jx][jy], result(jx,jy));
+      dcomplex *c = &cmplxAll[(jx*mesh.LocalNy + jy)*nmodes];
+      for(int jz=1;jz<jzend;jz++) {
+        c[jz] *= phs[jx][jy][jz];
+      }
+      for(int jz=jzend;jz<nmodes;jz++) {
+        c[jz] = 0.0;
+      }
     }
   }
-  
+
+  irfft_many(&cmplxAll[0], mesh.LocalNz, npencils, &result(0,0,0));
+
   return result;
 
 }
 
-void ShiftedMetric::shiftZ(const BoutReal *in, const std::vector<dcomplex> &phs, BoutReal *out) {
+void ShiftedMetric::shiftZInPlace(Field3D &f, const arr3Dvec &phs) {
+  ASSERT1(&mesh == f.getMesh());
+  if(mesh.LocalNz == 1)
+    return; // Shifting makes no difference
+
+  //Ensure the data is unique before transforming it in place
+  f.allocate();
+
+  const int npencils = mesh.LocalNx*mesh.LocalNy;
+  const int nmodes = mesh.LocalNz/2 + 1;
+
+  cmplxAll.resize(npencils*nmodes);
+
+  //The intermediate lives in cmplxAll, so the inverse transform can
+  //safely write back over the input
+  rfft_many(&f(0,0,0), mesh.LocalNz, npencils, &cmplxAll[0]);
+
+  const bool masked = ZModeMask::enabled();
+
+  for(int jx=0;jx<mesh.LocalNx;jx++) {
+    const int jzend = masked ? ZModeMask::zmax(jx) + 1 : nmodes;
+    for(int jy=0;jy<mesh.LocalNy;jy++) {
+      dcomplex *c = &cmplxAll[(jx*mesh.LocalNy + jy)*nmodes];
+      for(int jz=1;jz<jzend;jz++) {
+        c[jz] *= phs[jx][jy][jz];
+      }
+      for(int jz=jzend;jz<nmodes;jz++) {
+        c[jz] = 0.0;
+      }
+    }
+  }
+
+  irfft_many(&cmplxAll[0], mesh.LocalNz, npencils, &f(0,0,0));
+}
+
+void ShiftedMetric::shiftZ(const BoutReal *in, const std::vector<dcomplex> &phs, BoutReal *out, int zlimit) {
   // Take forward FFT
   rfft(in, mesh.LocalNz, &cmplx[0]);
 
   //Following is an algorithm approach to write a = a*b where a and b are
   //vectors of dcomplex.
-  //  std::transform(cmplxOneOff.begin(),cmplxOneOff.end(), ptr.begin(), 
+  //  std::transform(cmplxOneOff.begin(),cmplxOneOff.end(), ptr.begin(),
   //		 cmplxOneOff.begin(), std::multiplies<dcomplex>());
 
   const int nmodes = cmplx.size();
-  for(int jz=1;jz<nmodes;jz++) {
+  const int jzend = ((zlimit >= 0) && (zlimit + 1 < nmodes)) ? zlimit + 1 : nmodes;
+  for(int jz=1;jz<jzend;jz++) {
     cmplx[jz] *= phs[jz];
   }
+  for(int jz=jzend;jz<nmodes;jz++) {
+    cmplx[jz] = 0.0;
+  }
 
   irfft(&cmplx[0], mesh.LocalNz, out); // Reverse FFT
 }
@@ -1,6 +1,7 @@
 
 #include <bout/surfaceiter.hxx>
 
+#include <bout/array.hxx>
 #include <boutexception.hxx>
 #include <unused.hxx>
 
@@ -83,3 +84,52 @@ void SurfaceIter::next() {
 bool SurfaceIter::isDone() {
   return xpos < 0;
 }
+
+int SurfaceIter::yGlobalSize() {
+  int np;
+  MPI_Comm_size(m->getYcomm(0), &np);
+  return np * (m->yend - m->ystart + 1);
+}
+
+Matrix<BoutReal> SurfaceIter::gatherY(const Field2D &f) {
+  return gatherYImpl([&f](int x, int y) { return f(x, y); });
+}
+
+Matrix<BoutReal> SurfaceIter::gatherY(const Field3D &f, int jz) {
+  return gatherYImpl([&f, jz](int x, int y) { return f(x, y, jz); });
+}
+
+Matrix<BoutReal> SurfaceIter::gatherYImpl(const std::function<BoutReal(int, int)> &get) {
+  // Use the same communicator for all surfaces, as averageY does.
+  // Assumes all surfaces share the same Y decomposition
+  MPI_Comm comm = m->getYcomm(0);
+
+  int np, myp;
+  MPI_Comm_size(comm, &np);
+  MPI_Comm_rank(comm, &myp);
+
+  const int nx = m->LocalNx;
+  const int nyl = m->yend - m->ystart + 1; // Interior points per processor
+
+  // Pack every surface's local Y range, so a single collective
+  // replaces one message per surface
+  Array<BoutReal> send(nx * nyl);
+  for (int x = 0; x < nx; x++)
+    for (int y = 0; y < nyl; y++) {
+      send[x * nyl + y] = get(x, m->ystart + y);
+    }
+
+  Array<BoutReal> recv(np * nx * nyl);
+  MPI_Allgather(send.begin(), nx * nyl, BOUT_MPI_REAL, recv.begin(), nx * nyl,
+                BOUT_MPI_REAL, comm);
+
+  // Transpose into a contiguous slab with each surface's full Y
+  // profile in one row
+  Matrix<BoutReal> slab(nx, np * nyl);
+  for (int p = 0; p < np; p++)
+    for (int x = 0; x < nx; x++)
+      for (int y = 0; y < nyl; y++) {
+        slab(x, p * nyl + y) = recv[(p * nx + x) * nyl + y];
+      }
+  return slab;
+}
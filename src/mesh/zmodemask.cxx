@@ -0,0 +1,188 @@
+/**************************************************************************
+ * Radially-varying z mode truncation
+ *
+ * See include/bout/zmodemask.hxx for the interface and options.
+ *
+ **************************************************************************
+ * Copyright 2010 B.D.Dudson, S.Farley, M.V.Umansky, X.Q.Xu
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+#include <bout/zmodemask.hxx>
+
+#include <bout/mesh.hxx>
+#include <boutexception.hxx>
+#include <fft.hxx>
+#include <field3d.hxx>
+#include <field_factory.hxx>
+#include <globals.hxx>
+#include <msg_stack.hxx>
+#include <options.hxx>
+#include <output.hxx>
+#include <utils.hxx>
+
+#include <algorithm>
+#include <cmath>
+
+bool ZModeMask::is_enabled = false;
+bool ZModeMask::configured = false;
+int ZModeMask::margin = 2;
+std::vector<int> ZModeMask::zmax_x;
+
+void ZModeMask::configure() {
+  configured = true;
+
+  Options *opt = Options::getRoot()->getSection("zmask");
+  opt->get("enabled", is_enabled, false);
+  if (!is_enabled)
+    return;
+
+  ASSERT1(mesh != nullptr);
+
+  opt->get("margin", margin, 2);
+
+  const int nmax = mesh->LocalNz / 2; // The highest mode nz supports
+
+  string expr;
+  opt->get("zmax", expr, "");
+  if (expr.empty()) {
+    // No expression: start unmasked, expecting adaptFromSpectrum
+    zmax_x.assign(mesh->LocalNx, nmax);
+    output_info.write("\tZModeMask enabled, all %d modes kept until adapted\n",
+                      nmax + 1);
+    return;
+  }
+
+  // Evaluate the expression over the mesh, as initial profiles are
+  Field2D zmaxField = FieldFactory::get()->create2D(expr, opt, mesh);
+
+  zmax_x.resize(mesh->LocalNx);
+  for (int jx = 0; jx < mesh->LocalNx; jx++) {
+    int zm = static_cast<int>(std::floor(zmaxField(jx, mesh->ystart)));
+    if (zm < 1)
+      zm = 1; // Always keep the zonal and first mode
+    if (zm > nmax)
+      zm = nmax;
+    zmax_x[jx] = zm;
+  }
+  output_info.write("\tZModeMask enabled, %d to %d modes kept across x\n",
+                    *std::min_element(zmax_x.begin(), zmax_x.end()) + 1,
+                    *std::max_element(zmax_x.begin(), zmax_x.end()) + 1);
+}
+
+bool ZModeMask::enabled() {
+  if (!configured)
+    configure();
+  return is_enabled;
+}
+
+int ZModeMask::zmax(int jx) {
+  ASSERT2(enabled());
+  ASSERT2((jx >= 0) && (jx < static_cast<int>(zmax_x.size())));
+  return zmax_x[jx];
+}
+
+int ZModeMask::maxZmax() {
+  ASSERT2(enabled());
+  int zm = 1;
+  for (std::vector<int>::size_type jx = 0; jx < zmax_x.size(); jx++) {
+    if (zmax_x[jx] > zm)
+      zm = zmax_x[jx];
+  }
+  return zm;
+}
+
+void ZModeMask::adaptFromSpectrum(const Field3D &f, BoutReal threshold) {
+  TRACE("ZModeMask::adaptFromSpectrum");
+
+  if (!enabled())
+    throw BoutException("ZModeMask::adaptFromSpectrum called but zmask:enabled=false");
+
+  Mesh *localmesh = f.getMesh();
+  const int ncz = localmesh->LocalNz;
+  const int nmodes = ncz / 2 + 1;
+  const int nmax = ncz / 2;
+
+  Array<dcomplex> ck(nmodes);
+  std::vector<BoutReal> power(nmodes);
+
+  for (int jx = 0; jx < localmesh->LocalNx; jx++) {
+    // Mode power at this radius, averaged over the interior y points
+    std::fill(power.begin(), power.end(), 0.0);
+    for (int jy = localmesh->ystart; jy <= localmesh->yend; jy++) {
+      rfft(&f(jx, jy, 0), ncz, ck.begin());
+      for (int jz = 0; jz < nmodes; jz++) {
+        power[jz] += SQ(abs(ck[jz]));
+      }
+    }
+
+    BoutReal peak = 0.0;
+    for (int jz = 0; jz < nmodes; jz++) {
+      if (power[jz] > peak)
+        peak = power[jz];
+    }
+
+    // Highest mode still above threshold relative to the peak
+    // amplitude (power goes as amplitude squared)
+    int zm = 1;
+    const BoutReal cutoff = SQ(threshold) * peak;
+    for (int jz = nmodes - 1; jz > 0; jz--) {
+      if (power[jz] > cutoff) {
+        zm = jz;
+        break;
+      }
+    }
+
+    zm += margin; // Headroom so growing modes aren't clipped at once
+    if (zm > nmax)
+      zm = nmax;
+    zmax_x[jx] = zm;
+  }
+}
+
+const Field3D ZModeMask::filter(const Field3D &f) {
+  TRACE("ZModeMask::filter");
+
+  if (!enabled())
+    return f;
+
+  Mesh *localmesh = f.getMesh();
+  const int ncz = localmesh->LocalNz;
+  const int nmodes = ncz / 2 + 1;
+
+  Field3D result(localmesh);
+  result.allocate();
+  result.setLocation(f.getLocation());
+
+  Array<dcomplex> ck(nmodes);
+
+  for (int jx = 0; jx < localmesh->LocalNx; jx++) {
+    const int zm = zmax_x[jx];
+    for (int jy = 0; jy < localmesh->LocalNy; jy++) {
+      rfft(&f(jx, jy, 0), ncz, ck.begin());
+      for (int jz = zm + 1; jz < nmodes; jz++) {
+        ck[jz] = 0.0;
+      }
+      irfft(ck.begin(), ncz, &result(jx, jy, 0));
+    }
+  }
+
+  return result;
+}
@@ -108,3 +108,41 @@ const Field3D gyroPade2(const Field3D &f, const Field3D &rho, int flags) {
   return gyroPade2(f, DC(rho), flags);
 }
 
+
+GyroAverage::GyroAverage(const Field2D &rho, int flags) : lap(Laplacian::create()) {
+  lap->setFlags(flags);
+  setRho(rho);
+}
+
+GyroAverage::GyroAverage(BoutReal rho, int flags) : lap(Laplacian::create()) {
+  lap->setFlags(flags);
+  setRho(rho);
+}
+
+void GyroAverage::setRho(const Field2D &rho) {
+  rho2 = rho * rho;
+  // Coefficients are set once here, not per solve, so the inverter's
+  // cached coefficient tables stay valid while rho is unchanged
+  lap->setCoefA(1.0);
+  lap->setCoefC(1.0);
+  lap->setCoefD(-0.5 * rho2);
+}
+
+void GyroAverage::setRho(BoutReal rho) {
+  Field2D rho2d(rho);
+  setRho(rho2d);
+}
+
+const Field3D GyroAverage::pade1(const Field3D &f) {
+  Field3D x = lap->solve(f);
+  x.setLocation(f.getLocation());
+  return x;
+}
+
+const Field3D GyroAverage::pade2(const Field3D &f) {
+  Field3D result = pade1(pade1(f));
+  f.getMesh()->communicate(result);
+  result = 0.5 * rho2 * Delp2(result);
+  result.applyBoundary("dirichlet");
+  return result;
+}
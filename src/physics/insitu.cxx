@@ -0,0 +1,121 @@
+/**************************************************************************
+ * In-situ analysis of fields on the compute ranks
+ *
+ **************************************************************************
+ * Copyright 2010 B.D.Dudson, S.Farley, M.V.Umansky, X.Q.Xu
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+#include <bout/insitu.hxx>
+
+#include <boutexception.hxx>
+#include <msg_stack.hxx>
+#include <output.hxx>
+
+InSitu::InSitu(Options *opt) {
+  if (opt == nullptr)
+    return;
+
+  OPTION(opt, enabled, false);
+
+  if (enabled) {
+    // The analysis file shares the dump file's backend configuration
+    // (format, parallel settings) but is its own small file
+    analysis_file = Datafile(opt);
+  }
+}
+
+void InSitu::addField(const Field2D &f, const std::string &name) {
+  f2d_arr.push_back({&f, name});
+}
+
+void InSitu::addField(const Field3D &f, const std::string &name) {
+  f3d_arr.push_back({&f, name});
+}
+
+void InSitu::addAnalysis(InSituAnalysis *analysis) {
+  if (analysis == nullptr)
+    throw BoutException("InSitu::addAnalysis: null analysis plugin");
+  analyses.push_back(analysis);
+}
+
+const Field2D &InSitu::field2d(const std::string &name) const {
+  for (const auto &f : f2d_arr) {
+    if (f.name == name)
+      return *f.ptr;
+  }
+  throw BoutException("InSitu: no Field2D registered as '%s'", name.c_str());
+}
+
+const Field3D &InSitu::field3d(const std::string &name) const {
+  for (const auto &f : f3d_arr) {
+    if (f.name == name)
+      return *f.ptr;
+  }
+  throw BoutException("InSitu: no Field3D registered as '%s'", name.c_str());
+}
+
+void InSitu::initialise() {
+  TRACE("InSitu::initialise");
+
+  if (!enabled || analyses.empty())
+    return;
+
+  string datadir, dump_ext;
+  Options *options = Options::getRoot();
+  options->get("datadir", datadir, "data");
+  options->get("dump_format", dump_ext, "nc");
+
+  // Each processor writes its own file, like the dump files, so
+  // nothing here synchronises across ranks
+  if (!analysis_file.openw("%s/BOUT.analysis.%s", datadir.c_str(), dump_ext.c_str()))
+    throw BoutException("InSitu: could not open analysis output file");
+
+  // Plugins add their reduced output variables to the file
+  for (auto *analysis : analyses) {
+    analysis->init(*this);
+  }
+
+  output_info.write("In-situ analysis enabled: %lu plugins, %lu 3D and %lu 2D fields\n",
+                    static_cast<unsigned long>(analyses.size()),
+                    static_cast<unsigned long>(f3d_arr.size()),
+                    static_cast<unsigned long>(f2d_arr.size()));
+
+  initialised = true;
+}
+
+int InSitu::run(BoutReal time, int iter) {
+  TRACE("InSitu::run");
+
+  if (!initialised)
+    return 0;
+
+  // Plugins read the evolving field storage in place
+  for (auto *analysis : analyses) {
+    int ret = analysis->analyse(*this, time, iter);
+    if (ret != 0)
+      return ret;
+  }
+
+  if (!analysis_file.write())
+    throw BoutException("InSitu: could not write analysis output file");
+
+  return 0;
+}
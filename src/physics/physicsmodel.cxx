@@ -29,6 +29,7 @@
  **************************************************************************/
 
 #include <bout/physicsmodel.hxx>
+#include <bout/restart_fanout.hxx>
 
 PhysicsModel::PhysicsModel()
     : solver(nullptr), modelMonitor(this), splitop(false), userprecon(nullptr),
@@ -36,6 +37,12 @@ PhysicsModel::PhysicsModel()
 
   // Set up restart file
   restart = Datafile(Options::getRoot()->getSection("restart"));
+
+  // Set up fast binary checkpointing (off by default)
+  checkpoint = Checkpoint(Options::getRoot()->getSection("checkpoint"));
+
+  // Set up in-situ analysis (off by default)
+  insitu = InSitu(Options::getRoot()->getSection("insitu"));
 }
 
 PhysicsModel::~PhysicsModel() {
@@ -97,6 +104,9 @@ int PhysicsModel::postInit(bool restarting) {
   // Second argument specifies no time history
   solver->outputVars(restart, false);
 
+  // Register the same state with the fast checkpoint engine
+  solver->outputVars(checkpoint);
+
   string restart_dir;  ///< Directory for restart files
   string dump_ext, restart_ext;  ///< Dump, Restart file extension
   
@@ -114,14 +124,25 @@ int PhysicsModel::postInit(bool restarting) {
 
   string filename = restart_dir + "/BOUT.restart."+restart_ext;
   if (restarting) {
-    output.write("Loading restart file: %s\n", filename.c_str());
-
-    /// Load restart file
-    if (!restart.openr("%s",filename.c_str()))
-      throw BoutException("Error: Could not open restart file\n");
-    if (!restart.read())
-      throw BoutException("Error: Could not read restart file\n");
-    restart.close();
+    // Try the fast binary checkpoint first. Falls back to the restart
+    // file if disabled, or if no matching checkpoint is found
+    if (checkpoint.isEnabled() && checkpoint.read()) {
+      output.write("Restarting from binary checkpoint\n");
+    } else {
+      // In fan-out mode ([restart] fanout=true) the file is staged
+      // through a node-local path by designated per-node readers, and
+      // readname points at the staged copy
+      string readname = bout::fanoutRestartPath(filename);
+
+      output.write("Loading restart file: %s\n", readname.c_str());
+
+      /// Load restart file
+      if (!restart.openr("%s",readname.c_str()))
+        throw BoutException("Error: Could not open restart file\n");
+      if (!restart.read())
+        throw BoutException("Error: Could not read restart file\n");
+      restart.close();
+    }
   }
 
   // Add mesh information to restart file
@@ -135,9 +156,21 @@ int PhysicsModel::postInit(bool restarting) {
   if (!restart.openw("%s",filename.c_str()))
     throw BoutException("Error: Could not open restart file for writing\n");
 
+  // Open the analysis file and initialise any plugins registered
+  // during init()
+  insitu.initialise();
+
   // Add monitor to the solver which calls restart.write() and
   // PhysicsModel::outputMonitor()
   solver->addMonitor(&modelMonitor);
 
   return 0;
 }
+
+void PhysicsModel::writeRestartFile() {
+  if (checkpoint.isEnabled()) {
+    checkpoint.write();
+  } else {
+    restart.write();
+  }
+}
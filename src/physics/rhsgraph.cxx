@@ -0,0 +1,216 @@
+/**************************************************************************
+ * Declarative RHS pipeline with dataflow scheduling
+ *
+ * See include/bout/rhsgraph.hxx for the API description
+ *
+ **************************************************************************
+ * Copyright 2018 BOUT++ contributors
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+#include <bout/rhsgraph.hxx>
+
+#include <bout/mesh.hxx>
+#include <boutexception.hxx>
+#include <globals.hxx>
+#include <msg_stack.hxx>
+
+#include <utility>
+
+void RhsGraph::add(const std::string &name, Stage work,
+                   const std::vector<std::string> &depends) {
+  Node node;
+  node.name = name;
+  node.type = COMPUTE;
+  node.work = std::move(work);
+  addNode(std::move(node), depends);
+}
+
+void RhsGraph::addPointwise(const std::string &name, PointwiseStage work,
+                            const std::vector<std::string> &depends,
+                            const std::string &region) {
+  Node node;
+  node.name = name;
+  node.type = POINTWISE;
+  node.pointwise = std::move(work);
+  node.region = region;
+  addNode(std::move(node), depends);
+}
+
+void RhsGraph::addCommunicate(const std::string &name, const FieldGroup &fields,
+                              const std::vector<std::string> &depends) {
+  Node node;
+  node.name = name;
+  node.type = COMMUNICATE;
+  node.fields = fields;
+  addNode(std::move(node), depends);
+}
+
+void RhsGraph::addNode(Node node, const std::vector<std::string> &depends) {
+  if (names.count(node.name) != 0) {
+    throw BoutException("RhsGraph: duplicate stage name '%s'", node.name.c_str());
+  }
+
+  for (const std::string &dep : depends) {
+    auto it = names.find(dep);
+    if (it == names.end()) {
+      // Requiring dependencies to be already registered keeps the
+      // graph acyclic by construction
+      throw BoutException("RhsGraph: stage '%s' depends on unknown stage '%s'",
+                          node.name.c_str(), dep.c_str());
+    }
+    node.depends.push_back(it->second);
+  }
+
+  names[node.name] = static_cast<int>(nodes.size());
+  nodes.push_back(std::move(node));
+}
+
+void RhsGraph::clear() {
+  nodes.clear();
+  names.clear();
+}
+
+Mesh *RhsGraph::getMesh() {
+  if (localmesh == nullptr) {
+    localmesh = mesh;
+  }
+  return localmesh;
+}
+
+void RhsGraph::runPointwiseBatch(const std::string &region,
+                                 const std::vector<int> &batch) {
+  const Region<Ind3D> &rgn = getMesh()->getRegion3D(region);
+
+  if (batch.size() == 1) {
+    const PointwiseStage &work = nodes[batch[0]].pointwise;
+    BOUT_FOR(i, rgn) { work(i); }
+    return;
+  }
+
+  // Fused traversal: every stage sees the point while its inputs are
+  // hot in cache
+  BOUT_FOR(i, rgn) {
+    for (int stage : batch) {
+      nodes[stage].pointwise(i);
+    }
+  }
+}
+
+void RhsGraph::run() {
+  TRACE("RhsGraph::run()");
+
+  const int n = static_cast<int>(nodes.size());
+
+  // Remaining prerequisite count per stage, and who to release when a
+  // stage completes
+  std::vector<int> waiting(n, 0);
+  std::vector<std::vector<int>> dependents(n);
+  for (int i = 0; i < n; i++) {
+    waiting[i] = static_cast<int>(nodes[i].depends.size());
+    for (int dep : nodes[i].depends) {
+      dependents[dep].push_back(i);
+    }
+  }
+
+  std::vector<int> ready_compute, ready_comm;
+  // Ready pointwise stages, grouped by region so they can be fused
+  std::map<std::string, std::vector<int>> ready_pointwise;
+
+  // Halo exchanges started but not yet completed, oldest first
+  std::vector<std::pair<int, comm_handle>> in_flight;
+
+  auto makeReady = [&](int i) {
+    switch (nodes[i].type) {
+    case COMMUNICATE:
+      ready_comm.push_back(i);
+      break;
+    case POINTWISE:
+      ready_pointwise[nodes[i].region].push_back(i);
+      break;
+    default:
+      ready_compute.push_back(i);
+    }
+  };
+
+  for (int i = 0; i < n; i++) {
+    if (waiting[i] == 0) {
+      makeReady(i);
+    }
+  }
+
+  int completed = 0;
+  auto complete = [&](int i) {
+    completed++;
+    for (int next : dependents[i]) {
+      if (--waiting[next] == 0) {
+        makeReady(next);
+      }
+    }
+  };
+
+  while (completed < n) {
+    // Start every ready halo exchange first, so it proceeds in the
+    // background while compute stages run. Dependents are only
+    // released when the exchange is completed below
+    for (int i : ready_comm) {
+      in_flight.push_back(std::make_pair(i, getMesh()->communicateBegin(nodes[i].fields)));
+    }
+    ready_comm.clear();
+
+    if (!ready_pointwise.empty()) {
+      // Fuse the ready pointwise stages of one region into a single
+      // traversal
+      auto it = ready_pointwise.begin();
+      std::vector<int> batch = std::move(it->second);
+      std::string region = it->first;
+      ready_pointwise.erase(it);
+
+      runPointwiseBatch(region, batch);
+      for (int i : batch) {
+        complete(i);
+      }
+      continue;
+    }
+
+    if (!ready_compute.empty()) {
+      int i = ready_compute.back();
+      ready_compute.pop_back();
+      nodes[i].work();
+      complete(i);
+      continue;
+    }
+
+    if (!in_flight.empty()) {
+      // Nothing left that doesn't need the data: wait for the oldest
+      // exchange and release its dependents
+      std::pair<int, comm_handle> oldest = in_flight.front();
+      in_flight.erase(in_flight.begin());
+      getMesh()->communicateEnd(oldest.second);
+      complete(oldest.first);
+      continue;
+    }
+
+    // No stage ready and nothing in flight: can only happen if the
+    // bookkeeping above is broken
+    throw BoutException("RhsGraph: scheduler stalled with %d of %d stages complete",
+                        completed, n);
+  }
+}
@@ -39,6 +39,22 @@
 
 #include <utils.hxx>
 #include <bout/constants.hxx>
+#include <bout/openmpwrap.hxx>
+
+namespace {
+/// One 1-2-1 pass in X from \p in to \p out, leaving the X boundary
+/// rows untouched
+void smooth_x_pass(const Field3D &in, Field3D &out) {
+  Mesh *mesh = in.getMesh();
+
+  BOUT_OMP(parallel for)
+  for(int jx=1;jx<mesh->LocalNx-1;jx++)
+    for(int jy=0;jy<mesh->LocalNy;jy++)
+      for(int jz=0;jz<mesh->LocalNz;jz++) {
+	out(jx,jy,jz) = 0.5*in(jx,jy,jz) + 0.25*( in(jx-1,jy,jz) + in(jx+1,jy,jz) );
+      }
+}
+} // namespace
 
 // Smooth using simple 1-2-1 filter
 const Field3D smooth_x(const Field3D &f) {
@@ -55,12 +71,7 @@ const Field3D smooth_x(const Field3D &f) {
     }
 
   // Smooth using simple 1-2-1 filter
-
-  for(int jx=1;jx<mesh->LocalNx-1;jx++)
-    for(int jy=0;jy<mesh->LocalNy;jy++)
-      for(int jz=0;jz<mesh->LocalNz;jz++) {
-	result(jx,jy,jz) = 0.5*f(jx,jy,jz) + 0.25*( f(jx-1,jy,jz) + f(jx+1,jy,jz) );
-      }
+  smooth_x_pass(f, result);
 
   // Need to communicate boundaries
   mesh->communicate(result);
@@ -68,6 +79,28 @@ const Field3D smooth_x(const Field3D &f) {
   return result;
 }
 
+const Field3D smooth_x(const Field3D &f, int npasses) {
+  TRACE("smooth_x(Field3D, %d)", npasses);
+  Mesh *mesh = f.getMesh();
+
+  // Fused passes: ping-pong between the result and one temporary,
+  // rather than allocating and communicating per pass
+  Field3D result = copy(f);
+  Field3D tmp = copy(f);
+
+  for (int pass = 0; pass < npasses; pass++) {
+    smooth_x_pass(result, tmp);
+    swap(result, tmp);
+  }
+
+  // Guard cells are refreshed once at the end, so inner passes see
+  // guards smoothed one pass less. With more passes than guard cells
+  // this differs slightly from repeated smooth_x calls near
+  // processor boundaries
+  mesh->communicate(result);
+
+  return result;
+}
 
 const Field3D smooth_y(const Field3D &f) {
   TRACE("smooth_y");
@@ -84,6 +117,7 @@ const Field3D smooth_y(const Field3D &f) {
   
   // Smooth using simple 1-2-1 filter
 
+  BOUT_OMP(parallel for)
   for(int jx=0;jx<mesh->LocalNx;jx++)
     for(int jy=1;jy<mesh->LocalNy-1;jy++)
       for(int jz=0;jz<mesh->LocalNz;jz++) {
@@ -138,7 +172,7 @@ const Field2D averageX(const Field2D &f) {
       for(int y=0;y<ngy;y++)
         r(x,y) = input[y];
   }else {
-    MPI_Allreduce(input.begin(), result.begin(), ngy, MPI_DOUBLE, MPI_SUM, comm_x);
+    MPI_Allreduce(input.begin(), result.begin(), ngy, BOUT_MPI_REAL, MPI_SUM, comm_x);
     for(int x=0;x<ngx;x++)
       for(int y=0;y<ngy;y++)
         r(x,y) = result[y] / static_cast<BoutReal>(np);
@@ -193,7 +227,7 @@ const Field3D averageX(const Field3D &f) {
   int np;
   MPI_Comm_size(comm_x, &np);
   if(np > 1) {
-    MPI_Allreduce(std::begin(input), std::begin(result), ngy*ngz, MPI_DOUBLE, MPI_SUM, comm_x);
+    MPI_Allreduce(std::begin(input), std::begin(result), ngy*ngz, BOUT_MPI_REAL, MPI_SUM, comm_x);
     
     for(int x=0;x<ngx;x++)
       for(int y=0;y<ngy;y++)
@@ -244,7 +278,7 @@ const Field2D averageY(const Field2D &f) {
       for(int y=0;y<ngy;y++)
         r(x,y) = input[x];
   }else {
-    MPI_Allreduce(input.begin(), result.begin(), ngx, MPI_DOUBLE, MPI_SUM, comm_inner);
+    MPI_Allreduce(input.begin(), result.begin(), ngx, BOUT_MPI_REAL, MPI_SUM, comm_inner);
     for(int x=0;x<ngx;x++)
       for(int y=0;y<ngy;y++)
         r(x,y) = result[x] / static_cast<BoutReal>(np);
@@ -285,7 +319,7 @@ const Field3D averageY(const Field3D &f) {
   int np;
   MPI_Comm_size(comm_inner, &np);
   if(np > 1) {
-    MPI_Allreduce(std::begin(input), std::begin(result), ngx*ngz, MPI_DOUBLE, MPI_SUM, comm_inner);
+    MPI_Allreduce(std::begin(input), std::begin(result), ngx*ngz, BOUT_MPI_REAL, MPI_SUM, comm_inner);
     
     for(int x=0;x<ngx;x++)
       for(int y=0;y<ngy;y++)
@@ -318,7 +352,7 @@ BoutReal Average_XY(const Field2D &var) {
 
   MPI_Comm comm_x = mesh->getXcomm();
 
-  MPI_Allreduce(&Vol_Loc,&Vol_Glb,1,MPI_DOUBLE,MPI_SUM,comm_x);
+  MPI_Allreduce(&Vol_Loc,&Vol_Glb,1,BOUT_MPI_REAL,MPI_SUM,comm_x);
   Vol_Glb /= static_cast<BoutReal>(mesh->GlobalNx-2*mesh->xstart);
 
   return Vol_Glb;
@@ -342,6 +376,7 @@ const Field3D smoothXY(const Field3D &f) {
   Field3D result(mesh);
   result.allocate();
 
+  BOUT_OMP(parallel for)
   for(int x=2;x<mesh->LocalNx-2;x++)
     for(int y=2;y<mesh->LocalNy-2;y++)
       for(int z=0;z<mesh->LocalNz;z++) {
@@ -388,16 +423,22 @@ const Field3D nl_filter_x(const Field3D &f, BoutReal w) {
 
   Field3D result(mesh);
   result.allocate();
-  rvec v(mesh->LocalNx);
-  
-  for (int jy=0;jy<mesh->LocalNy;jy++) {
-    for (int jz=0;jz<mesh->LocalNz;jz++) {
-      for (int jx=0;jx<mesh->LocalNx;jx++) {
-        v[jx] = f(jx,jy,jz);
-      }
-      nl_filter(v, w);
-      for (int jx=0;jx<mesh->LocalNx;jx++) {
-         result(jx,jy,jz) = v[jx];
+
+  // Pencils are independent, so filter them in parallel with a
+  // temporary per thread
+  BOUT_OMP(parallel) {
+    rvec v(mesh->LocalNx);
+
+    BOUT_OMP(for)
+    for (int jy=0;jy<mesh->LocalNy;jy++) {
+      for (int jz=0;jz<mesh->LocalNz;jz++) {
+        for (int jx=0;jx<mesh->LocalNx;jx++) {
+          v[jx] = f(jx,jy,jz);
+        }
+        nl_filter(v, w);
+        for (int jx=0;jx<mesh->LocalNx;jx++) {
+           result(jx,jy,jz) = v[jx];
+        }
       }
     }
   }
@@ -412,19 +453,24 @@ const Field3D nl_filter_y(const Field3D &f, BoutReal w) {
   Field3D result(mesh);
   result.allocate();
 
-  rvec v(mesh->LocalNy); // Temporary array
-  
   // Transform into field-aligned coordinates
   Field3D fs = mesh->toFieldAligned(f);
 
-  for (int jx=0;jx<mesh->LocalNx;jx++) {
-    for (int jz=0;jz<mesh->LocalNz;jz++) {
-      for (int jy=0;jy<mesh->LocalNy;jy++) {
-        v[jy] = fs(jx,jy,jz);
-      }
-      nl_filter(v, w);
-      for (int jy=0;jy<mesh->LocalNy;jy++) {
-        result(jx,jy,jz) = v[jy];
+  // Pencils are independent, so filter them in parallel with a
+  // temporary per thread
+  BOUT_OMP(parallel) {
+    rvec v(mesh->LocalNy); // Temporary array
+
+    BOUT_OMP(for)
+    for (int jx=0;jx<mesh->LocalNx;jx++) {
+      for (int jz=0;jz<mesh->LocalNz;jz++) {
+        for (int jy=0;jy<mesh->LocalNy;jy++) {
+          v[jy] = fs(jx,jy,jz);
+        }
+        nl_filter(v, w);
+        for (int jy=0;jy<mesh->LocalNy;jy++) {
+          result(jx,jy,jz) = v[jy];
+        }
       }
     }
   }
@@ -440,16 +486,21 @@ const Field3D nl_filter_z(const Field3D &fs, BoutReal w) {
   Field3D result(mesh);
   result.allocate();
   
-  rvec v(mesh->LocalNz);
-  
-  for (int jx=0;jx<mesh->LocalNx;jx++) {
-    for (int jy=0;jy<mesh->LocalNy;jy++) {
-      for (int jz=0;jz<mesh->LocalNz;jz++) {
-        v[jz] = fs(jx,jy,jz);
-      }
-      nl_filter(v, w);
-      for (int jz=0;jz<mesh->LocalNz;jz++) {
-        result(jx,jy,jz) = v[jz];
+  // Pencils are independent, so filter them in parallel with a
+  // temporary per thread
+  BOUT_OMP(parallel) {
+    rvec v(mesh->LocalNz);
+
+    BOUT_OMP(for)
+    for (int jx=0;jx<mesh->LocalNx;jx++) {
+      for (int jy=0;jy<mesh->LocalNy;jy++) {
+        for (int jz=0;jz<mesh->LocalNz;jz++) {
+          v[jz] = fs(jx,jy,jz);
+        }
+        nl_filter(v, w);
+        for (int jz=0;jz<mesh->LocalNz;jz++) {
+          result(jx,jy,jz) = v[jz];
+        }
       }
     }
   }
@@ -31,8 +31,11 @@
 #include <boutcomm.hxx>
 #include <interpolation.hxx> // Cell interpolation
 #include <boutexception.hxx>
+#include <field_factory.hxx> // For generating per-variable tolerances
 #include <msg_stack.hxx>
 
+#include <sstream>
+
 #include <cvode/cvode.h>
 #include <cvode/cvode_bbdpre.h>
 #include <nvector/nvector_parallel.h>
@@ -63,6 +66,26 @@ static int cvode_jac(N_Vector v, N_Vector Jv,
 		     realtype t, N_Vector y, N_Vector fy,
 		     void *user_data, N_Vector tmp);
 
+/// Translate a per-variable positivity_constraint option string into
+/// the CVodeSetConstraints flag value
+static BoutReal constraintFromString(const std::string &name,
+                                     const std::string &constraint_type) {
+  if (constraint_type == "none")
+    return 0.0;
+  if (constraint_type == "positive")
+    return 2.0;
+  if (constraint_type == "non_negative")
+    return 1.0;
+  if (constraint_type == "negative")
+    return -2.0;
+  if (constraint_type == "non_positive")
+    return -1.0;
+  throw BoutException("Unrecognised positivity_constraint '%s' for evolving variable "
+                      "'%s'. Valid settings are 'none', 'positive', 'non_negative', "
+                      "'negative' and 'non_positive'",
+                      constraint_type.c_str(), name.c_str());
+}
+
 CvodeSolver::CvodeSolver(Options *opts) : Solver(opts) {
   has_constraints = false; ///< This solver doesn't have constraints
 
@@ -129,6 +152,8 @@ int CvodeSolver::init(int nout, BoutReal tstep) {
   int mukeep, mlkeep;
   int max_order;
   bool use_precon, use_jacobian, use_vector_abstol, stablimdet;
+  bool apply_positivity_constraints;
+  vector<BoutReal> f2d_constraints, f3d_constraints;
   BoutReal start_timestep, max_timestep;
   bool adams_moulton, func_iter; // Time-integration method
   int MXSUB = mesh->xend - mesh->xstart + 1;
@@ -146,24 +171,61 @@ int CvodeSolver::init(int nout, BoutReal tstep) {
     options->get("RTOL", reltol, 1.0e-5);
     options->get("cvode_max_order", max_order, -1);
     options->get("cvode_stability_limit_detection", stablimdet, false);
+    options->get("apply_positivity_constraints", apply_positivity_constraints, false);
+    if (apply_positivity_constraints) {
+      // The constraint is set per evolving variable, from
+      // "positivity_constraint" in its options section. Steps which
+      // would violate a constraint are retried with a smaller
+      // timestep, instead of the RHS failing (e.g. sqrt of a negative
+      // density) and the whole nonlinear solve being repeated
+      for (const auto& f : f2d) {
+        Options *f_options = Options::getRoot()->getSection(f.name);
+        std::string constraint_type;
+        f_options->get("positivity_constraint", constraint_type, "none");
+        f2d_constraints.push_back(constraintFromString(f.name, constraint_type));
+      }
+      for (const auto& f : f3d) {
+        Options *f_options = Options::getRoot()->getSection(f.name);
+        std::string constraint_type;
+        f_options->get("positivity_constraint", constraint_type, "none");
+        f3d_constraints.push_back(constraintFromString(f.name, constraint_type));
+      }
+    }
     options->get("use_vector_abstol",use_vector_abstol,false);
     if (use_vector_abstol) {
-      Options *abstol_options = Options::getRoot();
-      BoutReal tempabstol;
       if ((abstolvec = N_VNew_Parallel(BoutComm::get(), local_N, neq)) == nullptr)
         throw BoutException("ERROR: SUNDIALS memory allocation (abstol vector) failed\n");
-      vector<BoutReal> f2dtols;
-      vector<BoutReal> f3dtols;
+
+      // The tolerance is set per evolving variable, from "atol" in its
+      // options section, and is parsed as an expression of x,y,z so it
+      // can also vary over the domain. For example a tolerance relaxed
+      // by 10x outside of x = 0.85:
+      //     atol = 1e-12 * (1 + 9*h(x - 0.85))
+      std::string default_abstol;
+      {
+        std::stringstream ss;
+        ss << abstol;
+        default_abstol = ss.str();
+      }
+      vector<Field2D> f2dtols;
+      vector<Field3D> f3dtols;
       BoutReal* abstolvec_data = NV_DATA_P(abstolvec);
       for (const auto& f : f2d) {
-	abstol_options = Options::getRoot()->getSection(f.name);
-	abstol_options->get("abstol", tempabstol, abstol);
-	f2dtols.push_back(tempabstol);
+        Options *abstol_options = Options::getRoot()->getSection(f.name);
+        std::string tolstring;
+        // "abstol" was previously the name used for 2D variables
+        if (!abstol_options->isSet("atol") && abstol_options->isSet("abstol")) {
+          abstol_options->get("abstol", tolstring, default_abstol);
+        } else {
+          abstol_options->get("atol", tolstring, default_abstol);
+        }
+        f2dtols.push_back(FieldFactory::get()->create2D(tolstring, abstol_options, mesh));
       }
       for (const auto& f : f3d) {
-	abstol_options = Options::getRoot()->getSection(f.name);
-	abstol_options->get("atol", tempabstol, abstol);
-	f3dtols.push_back(tempabstol);
+        Options *abstol_options = Options::getRoot()->getSection(f.name);
+        std::string tolstring;
+        abstol_options->get("atol", tolstring, default_abstol);
+        f3dtols.push_back(FieldFactory::get()->create3D(tolstring, abstol_options, mesh));
       }
       set_abstol_values(abstolvec_data, f2dtols, f3dtols);
     }
@@ -219,10 +281,30 @@ int CvodeSolver::init(int nout, BoutReal tstep) {
    
   if (stablimdet) {
     TRACE("Calling CVodeSetstabLimDet");
+    if (lmm != CV_BDF) {
+      // The BDF stability limit detection algorithm (STALD) does not
+      // apply to Adams-Moulton
+      throw BoutException("cvode_stability_limit_detection requires the BDF method\n");
+    }
     if ( CVodeSetStabLimDet(cvode_mem, stablimdet) < 0)
       throw BoutException("CVodeSetstabLimDet failed\n");
   }
-  
+
+  if (apply_positivity_constraints) {
+    TRACE("Calling CVodeSetConstraints");
+    N_Vector constraints_vec;
+    if ((constraints_vec = N_VNew_Parallel(BoutComm::get(), local_N, neq)) == nullptr)
+      throw BoutException("ERROR: SUNDIALS memory allocation (constraints vector) failed\n");
+
+    set_constraint_values(NV_DATA_P(constraints_vec), f2d_constraints, f3d_constraints);
+
+    if ( CVodeSetConstraints(cvode_mem, constraints_vec) < 0 )
+      throw BoutException("CVodeSetConstraints failed\n");
+
+    // CVODE keeps its own copy of the constraints
+    N_VDestroy_Parallel(constraints_vec);
+  }
+
   if (use_vector_abstol) {
     TRACE("Calling CVodeSVtolerances");
     if( CVodeSVtolerances(cvode_mem, reltol, abstolvec) < 0 )
@@ -378,7 +460,29 @@ int CvodeSolver::run() {
       CVodeGetNumStabLimOrderReds(cvode_mem, &stab_lims);
       
       output.write("    -> Stability limit order reductions: %ld\n", stab_lims);
-      
+
+    }
+
+    {
+      // Collect per-output-step statistics. CVODE counters are
+      // cumulative over the run, so take differences from last time
+      long int nsteps, nniters, nliters, err_fails, conv_fails;
+      CVodeGetNumSteps(cvode_mem, &nsteps);
+      CVodeGetNumNonlinSolvIters(cvode_mem, &nniters);
+      CVSpilsGetNumLinIters(cvode_mem, &nliters);
+      CVodeGetNumErrTestFails(cvode_mem, &err_fails);
+      CVodeGetNumNonlinSolvConvFails(cvode_mem, &conv_fails);
+
+      stats.nsteps = static_cast<int>(nsteps - prev_nsteps);
+      stats.nnewton_iters = static_cast<int>(nniters - prev_nniters);
+      stats.nkrylov_iters = static_cast<int>(nliters - prev_nliters);
+      stats.nfailed = static_cast<int>((err_fails + conv_fails) - prev_nfails);
+      CVodeGetLastStep(cvode_mem, &stats.last_dt);
+
+      prev_nsteps = nsteps;
+      prev_nniters = nniters;
+      prev_nliters = nliters;
+      prev_nfails = err_fails + conv_fails;
     }
 
     /// Call the monitor function
@@ -577,7 +681,7 @@ static int cvode_jac(N_Vector v, N_Vector Jv, realtype t, N_Vector y, N_Vector U
  * vector abstol functions
  **************************************************************************/
 
-void CvodeSolver::set_abstol_values(BoutReal* abstolvec_data, vector<BoutReal> &f2dtols, vector<BoutReal> &f3dtols) {
+void CvodeSolver::set_abstol_values(BoutReal* abstolvec_data, vector<Field2D> &f2dtols, vector<Field3D> &f3dtols) {
   int p = 0; // Counter for location in abstolvec_data array
 
   // All boundaries
@@ -590,28 +694,75 @@ void CvodeSolver::set_abstol_values(BoutReal* abstolvec_data, vector<BoutReal> &
   }
 }
 
-void CvodeSolver::loop_abstol_values_op(Ind2D UNUSED(i2d),
+void CvodeSolver::loop_abstol_values_op(Ind2D i2d,
                                         BoutReal *abstolvec_data, int &p,
-                                        vector<BoutReal> &f2dtols,
-                                        vector<BoutReal> &f3dtols, bool bndry) {
+                                        vector<Field2D> &f2dtols,
+                                        vector<Field3D> &f3dtols, bool bndry) {
   // Loop over 2D variables
-  for(vector<BoutReal>::size_type i=0; i<f2dtols.size(); i++) {
+  for(vector<Field2D>::size_type i=0; i<f2dtols.size(); i++) {
     if(bndry && !f2d[i].evolve_bndry) {
       continue;
     }
-    abstolvec_data[p] = f2dtols[i];
+    abstolvec_data[p] = f2dtols[i][i2d];
     p++;
   }
-  
+
   for (int jz=0; jz < mesh->LocalNz; jz++) {
     // Loop over 3D variables
-    for(vector<BoutReal>::size_type i=0; i<f3dtols.size(); i++) {
+    for(vector<Field3D>::size_type i=0; i<f3dtols.size(); i++) {
       if(bndry && !f3d[i].evolve_bndry) {
         continue;
       }
-      abstolvec_data[p] = f3dtols[i];
+      abstolvec_data[p] = f3dtols[i][mesh->ind2Dto3D(i2d, jz)];
       p++;
-    }  
+    }
+  }
+}
+
+/**************************************************************************
+ * CVODE constraint functions
+ **************************************************************************/
+
+void CvodeSolver::set_constraint_values(BoutReal *constraints_data,
+                                        vector<BoutReal> &f2d_constraints,
+                                        vector<BoutReal> &f3d_constraints) {
+  int p = 0; // Counter for location in constraints_data array
+
+  // All boundaries
+  for (const auto &i2d : mesh->getRegion2D("RGN_BNDRY")) {
+    loop_constraint_values_op(i2d, constraints_data, p, f2d_constraints, f3d_constraints,
+                              true);
+  }
+  // Bulk of points
+  for (const auto &i2d : mesh->getRegion2D("RGN_NOBNDRY")) {
+    loop_constraint_values_op(i2d, constraints_data, p, f2d_constraints, f3d_constraints,
+                              false);
+  }
+}
+
+void CvodeSolver::loop_constraint_values_op(Ind2D UNUSED(i2d),
+                                            BoutReal *constraints_data, int &p,
+                                            vector<BoutReal> &f2d_constraints,
+                                            vector<BoutReal> &f3d_constraints,
+                                            bool bndry) {
+  // Loop over 2D variables
+  for (vector<BoutReal>::size_type i = 0; i < f2d_constraints.size(); i++) {
+    if (bndry && !f2d[i].evolve_bndry) {
+      continue;
+    }
+    constraints_data[p] = f2d_constraints[i];
+    p++;
+  }
+
+  for (int jz = 0; jz < mesh->LocalNz; jz++) {
+    // Loop over 3D variables
+    for (vector<BoutReal>::size_type i = 0; i < f3d_constraints.size(); i++) {
+      if (bndry && !f3d[i].evolve_bndry) {
+        continue;
+      }
+      constraints_data[p] = f3d_constraints[i];
+      p++;
+    }
   }
 }
 
@@ -88,9 +88,19 @@ class CvodeSolver : public Solver {
 
     BoutReal pre_Wtime; // Time in preconditioner
     BoutReal pre_ncalls; // Number of calls to preconditioner
+
+    // CVODE counters at the last output, used to get per-output-step
+    // statistics from the cumulative values
+    long int prev_nsteps{0};
+    long int prev_nniters{0};
+    long int prev_nliters{0};
+    long int prev_nfails{0};
     
-    void set_abstol_values(BoutReal* abstolvec_data, vector<BoutReal> &f2dtols, vector<BoutReal> &f3dtols);
-    void loop_abstol_values_op(Ind2D i2d, BoutReal* abstolvec_data, int &p, vector<BoutReal> &f2dtols, vector<BoutReal> &f3dtols, bool bndry);
+    void set_abstol_values(BoutReal* abstolvec_data, vector<Field2D> &f2dtols, vector<Field3D> &f3dtols);
+    void loop_abstol_values_op(Ind2D i2d, BoutReal* abstolvec_data, int &p, vector<Field2D> &f2dtols, vector<Field3D> &f3dtols, bool bndry);
+
+    void set_constraint_values(BoutReal* constraints_data, vector<BoutReal> &f2d_constraints, vector<BoutReal> &f3d_constraints);
+    void loop_constraint_values_op(Ind2D i2d, BoutReal* constraints_data, int &p, vector<BoutReal> &f2d_constraints, vector<BoutReal> &f3d_constraints, bool bndry);
 };
 
 #endif // __SUNDIAL_SOLVER_H__
@@ -49,8 +49,8 @@ int EulerSolver::init(int nout, BoutReal tstep) {
 	       n3Dvars(), n2Dvars(), neq, nlocal);
   
   // Allocate memory
-  f0 = Array<BoutReal>(nlocal);
-  f1 = Array<BoutReal>(nlocal);
+  f0 = Array<double>(nlocal);
+  f1 = Array<double>(nlocal);
 
   // Put starting values into f0
   save_vars(std::begin(f0));
@@ -83,11 +83,11 @@ int EulerSolver::run() {
       
       // Check with all processors if timestep was reduced
       
-      BoutReal newdt_local = 10.*old_timestep; // Signal no change
+      double newdt_local = 10.*old_timestep; // Signal no change
       if(timestep_reduced)
         newdt_local = timestep;
       
-      BoutReal newdt;
+      double newdt;
       if(MPI_Allreduce(&newdt_local, &newdt, 1, MPI_DOUBLE, MPI_MIN, BoutComm::get())) {
         throw BoutException("MPI_Allreduce failed in EulerSolver::run");
       }
@@ -131,8 +131,8 @@ int EulerSolver::run() {
   return 0;
 }
 
-void EulerSolver::take_step(BoutReal curtime, BoutReal dt, Array<BoutReal> &start,
-                            Array<BoutReal> &result) {
+void EulerSolver::take_step(BoutReal curtime, BoutReal dt, Array<double> &start,
+                            Array<double> &result) {
 
   load_vars(std::begin(start));
   run_rhs(curtime);
@@ -55,7 +55,7 @@ class EulerSolver : public Solver {
   int mxstep; // Maximum number of internal steps between outputs
   BoutReal cfl_factor; // Factor by which timestep must be smaller than maximum
 
-  Array<BoutReal> f0, f1;
+  Array<double> f0, f1;
   
   BoutReal out_timestep; // The output timestep
   int nsteps; // Number of output steps
@@ -66,7 +66,7 @@ class EulerSolver : public Solver {
   int nlocal; // Number of variables on local processor
   
   void take_step(BoutReal curtime, BoutReal dt, 
-                 Array<BoutReal> &start, Array<BoutReal> &result); // Take a single step to calculate f1
+                 Array<double> &start, Array<double> &result); // Take a single step to calculate f1
 };
 
 #endif // __KARNIADAKIS_SOLVER_H__
@@ -18,7 +18,8 @@
 
 IMEXBDF2::IMEXBDF2(Options *opt)
     : Solver(opt), snes_f(nullptr), snes_x(nullptr), snes(nullptr), snesAlt(nullptr),
-      snesUse(nullptr), Jmf(nullptr) {
+      snesUse(nullptr), Jmf(nullptr), fdcoloring(nullptr), lag_jacobian(-1),
+      jacobian_stale(false), jacobian_gamma(0.0) {
 
   has_constraints = true; ///< This solver can handle constraints
 }
@@ -127,7 +128,7 @@ int IMEXBDF2::init(int nout, BoutReal tstep) {
   }
 
   if (have_constraints) {
-    is_dae = Array<BoutReal>{nlocal};
+    is_dae = Array<double>{nlocal};
     // Call the Solver function, which sets the array
     // to zero when not a constraint, one for constraint
     set_id(std::begin(is_dae));
@@ -153,17 +154,17 @@ int IMEXBDF2::init(int nout, BoutReal tstep) {
   }
 
   // Allocate memory and initialise structures
-  u = Array<BoutReal>{nlocal};
+  u = Array<double>{nlocal};
   for(int i=0;i<maxOrder;i++){
-    uV.emplace_back(Array<BoutReal>{nlocal});
-    fV.emplace_back(Array<BoutReal>{nlocal});
+    uV.emplace_back(Array<double>{nlocal});
+    fV.emplace_back(Array<double>{nlocal});
     timesteps.push_back(timestep);
     uFac.push_back(0.0);
     fFac.push_back(0.0);
     gFac.push_back(0.0);
   }
 
-  rhs = Array<BoutReal>{nlocal};
+  rhs = Array<double>{nlocal};
 
   OPTION(options, adaptive, true); //Do we try to estimate the error?
   OPTION(options, nadapt, 4); //How often do we check the error
@@ -171,12 +172,22 @@ int IMEXBDF2::init(int nout, BoutReal tstep) {
   OPTION(options, dtMax, out_timestep);
   OPTION(options, dtMin, dtMinFatal);
   if(adaptive){
-    err = Array<BoutReal>{nlocal};
+    err = Array<double>{nlocal};
     OPTION(options, adaptRtol, 1.0e-3); //Target relative error
     OPTION(options, mxstepAdapt, mxstep); //Maximum no. consecutive times we try to reduce timestep
     OPTION(options, scaleCushUp, 1.5);
     OPTION(options, scaleCushDown, 1.0);
   }
+  //Use the predictor-corrector difference as the error estimate,
+  //instead of repeating the implicit solve at one order lower
+  OPTION(options, adaptEmbedded, true);
+  //Switch the order at run time from stiffness indicators. Works with
+  //or without the error check: the indicator is the Newton iteration count
+  OPTION(options, adaptOrder, false);
+  OPTION(options, stiffSnesIts, 8); //Newton its/solve treated as stiff
+  capture_predictor = false;
+  last_snes_its = 0;
+  nerr_checks = ndt_up = ndt_down = nretries = norder_up = norder_down = 0;
 
   // Put starting values into u
   saveVars(std::begin(u));
@@ -246,376 +257,14 @@ void IMEXBDF2::constructSNES(SNES *snesIn){
     if(use_coloring) {
       // Use matrix coloring to calculate Jacobian
 
-      //////////////////////////////////////////////////
-      // Get the local indices by starting at 0
-      Field3D index = globalIndex(0);
-
-      //////////////////////////////////////////////////
-      // Pre-allocate PETSc storage
-
-      int localN = getLocalN(); // Number of rows on this processor
-      int n2d = f2d.size();
-      int n3d = f3d.size();
-
-      // Set size of Matrix on each processor to localN x localN
-      MatCreate( BoutComm::get(), &Jmf );                                
-      MatSetSizes( Jmf, localN, localN, PETSC_DETERMINE, PETSC_DETERMINE );
-      MatSetFromOptions(Jmf);
-      
-      PetscInt *d_nnz, *o_nnz;
-      PetscMalloc( (localN)*sizeof(PetscInt), &d_nnz );
-      PetscMalloc( (localN)*sizeof(PetscInt), &o_nnz );
-
-      // Set values for most points
-      if(mesh->LocalNz > 1) {
-        // A 3D mesh, so need points in Z
-
-        for(int i=0;i<localN;i++) {
-          // Non-zero elements on this processor
-          d_nnz[i] = 7*n3d + 5*n2d; // Star pattern in 3D
-          // Non-zero elements on neighboring processor
-          o_nnz[i] = 0;
-        }
-      }else {
-        // Only one point in Z
-        
-        for(int i=0;i<localN;i++) {
-          // Non-zero elements on this processor
-          d_nnz[i] = 5*(n3d+n2d); // Star pattern in 2D
-          // Non-zero elements on neighboring processor
-          o_nnz[i] = 0;
-        }
-      }
-
-      // X boundaries
-      if(mesh->firstX()) {
-        // Lower X boundary
-        for(int y=mesh->ystart;y<=mesh->yend;y++) {
-          for(int z=0;z<mesh->LocalNz;z++) {
-            int localIndex = ROUND(index(mesh->xstart, y, z));
-            ASSERT2( (localIndex >= 0) && (localIndex < localN) );
-            if(z == 0) {
-              // All 2D and 3D fields
-              for(int i=0;i<n2d+n3d;i++)
-                d_nnz[localIndex + i] -= (n3d + n2d);
-            }else {
-              // Only 3D fields
-              for(int i=0;i<n3d;i++)
-                d_nnz[localIndex + i] -= (n3d + n2d);
-            }
-          }
-        }
-      }else {
-        // On another processor
-        for(int y=mesh->ystart;y<=mesh->yend;y++) {
-          for(int z=0;z<mesh->LocalNz;z++) {
-            int localIndex = ROUND(index(mesh->xstart, y, z));
-            ASSERT2( (localIndex >= 0) && (localIndex < localN) );
-            if(z == 0) {
-              // All 2D and 3D fields
-              for(int i=0;i<n2d+n3d;i++) {
-                d_nnz[localIndex+i] -= (n3d + n2d);
-                o_nnz[localIndex+i] += (n3d + n2d);
-              }
-            }else {
-              // Only 3D fields
-              for(int i=0;i<n3d;i++) {
-                d_nnz[localIndex+i] -= (n3d + n2d);
-                o_nnz[localIndex+i] += (n3d + n2d);
-              }
-            }
-          }
-        }
-      }
-
-      if(mesh->lastX()) {
-        // Upper X boundary
-        for(int y=mesh->ystart;y<=mesh->yend;y++) {
-          for(int z=0;z<mesh->LocalNz;z++) {
-            int localIndex = ROUND(index(mesh->xend, y, z));
-            ASSERT2( (localIndex >= 0) && (localIndex < localN) );
-            if(z == 0) {
-              // All 2D and 3D fields
-              for(int i=0;i<n2d+n3d;i++)
-                d_nnz[localIndex + i] -= (n3d + n2d);
-            }else {
-              // Only 3D fields
-              for(int i=0;i<n3d;i++)
-                d_nnz[localIndex + i] -= (n3d + n2d);
-            }
-          }
-        }
-      }else {
-        // On another processor
-        for(int y=mesh->ystart;y<=mesh->yend;y++) {
-          for(int z=0;z<mesh->LocalNz;z++) {
-            int localIndex = ROUND(index(mesh->xend, y, z));
-            ASSERT2( (localIndex >= 0) && (localIndex < localN) );
-            if(z == 0) {
-              // All 2D and 3D fields
-              for(int i=0;i<n2d+n3d;i++) {
-                d_nnz[localIndex+i] -= (n3d + n2d);
-                o_nnz[localIndex+i] += (n3d + n2d);
-              }
-            }else {
-              // Only 3D fields
-              for(int i=0;i<n3d;i++) {
-                d_nnz[localIndex+i] -= (n3d + n2d);
-                o_nnz[localIndex+i] += (n3d + n2d);
-              }
-            }
-          }
-        }
-      }
-      
-      // Y boundaries
-  
-      for(int x=mesh->xstart; x <=mesh->xend; x++) {
-        // Default to no boundary
-        // NOTE: This assumes that communications in Y are to other
-        //   processors. If Y is communicated with this processor (e.g. NYPE=1)
-        //   then this will result in PETSc warnings about out of range allocations
-
-        // z = 0 case
-        int localIndex = ROUND(index(x, mesh->ystart, 0));
-        // All 2D and 3D fields
-        for(int i=0;i<n2d+n3d;i++) {
-          //d_nnz[localIndex+i] -= (n3d + n2d);
-          o_nnz[localIndex+i] += (n3d + n2d);
-        }
-        
-        for(int z=1;z<mesh->LocalNz;z++) {
-          localIndex = ROUND(index(x, mesh->ystart, z));
-          
-          // Only 3D fields
-          for(int i=0;i<n3d;i++) {
-            //d_nnz[localIndex+i] -= (n3d + n2d);
-            o_nnz[localIndex+i] += (n3d + n2d);
-          }
-        }
-
-        // z = 0 case
-        localIndex = ROUND(index(x, mesh->yend, 0));
-        // All 2D and 3D fields
-        for(int i=0;i<n2d+n3d;i++) {
-          //d_nnz[localIndex+i] -= (n3d + n2d);
-          o_nnz[localIndex+i] += (n3d + n2d);
-        }
-        
-        for(int z=1;z<mesh->LocalNz;z++) {
-          localIndex = ROUND(index(x, mesh->yend, z));
-          
-          // Only 3D fields
-          for(int i=0;i<n3d;i++) {
-            //d_nnz[localIndex+i] -= (n3d + n2d);
-            o_nnz[localIndex+i] += (n3d + n2d);
-          }
-        }
-      }
-
-      for(RangeIterator it=mesh->iterateBndryLowerY(); !it.isDone(); it++) {
-        // A boundary, so no communication
-
-        // z = 0 case
-        int localIndex = ROUND(index(it.ind, mesh->ystart, 0));
-        // All 2D and 3D fields
-        for(int i=0;i<n2d+n3d;i++) {
-          o_nnz[localIndex+i] -= (n3d + n2d);
-        }
-        
-        for(int z=1;z<mesh->LocalNz;z++) {
-          int localIndex = ROUND(index(it.ind, mesh->ystart, z));
-          
-          // Only 3D fields
-          for(int i=0;i<n3d;i++) {
-            o_nnz[localIndex+i] -= (n3d + n2d);
-          }
-        }
+      if (fdcoloring == nullptr) {
+        // The sparsity pattern depends only on the mesh and the set of
+        // evolving variables, so the matrix and its coloring are
+        // computed once and then shared between SNES objects (a second
+        // SNES is used for the lower order solution when adaptive)
+        constructMatrixColoring();
       }
 
-      for(RangeIterator it=mesh->iterateBndryUpperY(); !it.isDone(); it++) {
-        // A boundary, so no communication
-
-        // z = 0 case
-        int localIndex = ROUND(index(it.ind, mesh->yend, 0));
-        // All 2D and 3D fields
-        for(int i=0;i<n2d+n3d;i++) {
-          o_nnz[localIndex+i] -= (n3d + n2d);
-        }
-        
-        for(int z=1;z<mesh->LocalNz;z++) {
-          int localIndex = ROUND(index(it.ind, mesh->yend, z));
-          
-          // Only 3D fields
-          for(int i=0;i<n3d;i++) {
-            o_nnz[localIndex+i] -= (n3d + n2d);
-          }
-        }
-      }
-      
-      // Pre-allocate
-      MatMPIAIJSetPreallocation( Jmf, 0, d_nnz, 0, o_nnz );
-      MatSetUp(Jmf); 
-      MatSetOption(Jmf,MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_FALSE);      
-      PetscFree( d_nnz );
-      PetscFree( o_nnz );
-      
-      // Determine which row/columns of the matrix are locally owned
-      int Istart, Iend;
-      MatGetOwnershipRange( Jmf, &Istart, &Iend );
-      
-      // Convert local into global indices
-      index += Istart;
-      
-      // Now communicate to fill guard cells
-      mesh->communicate(index);
-
-      //////////////////////////////////////////////////
-      // Mark non-zero entries
-
-      
-      // Offsets for a 5-point pattern
-      const int xoffset[5] = {0,-1, 1, 0, 0};
-      const int yoffset[5] = {0, 0, 0,-1, 1};
-      
-      PetscScalar val = 1.0;
-      
-      for(int x=mesh->xstart; x <= mesh->xend; x++) {
-        for(int y=mesh->ystart;y<=mesh->yend;y++) {
-          
-          int ind0 = ROUND(index(x,y,0));
-
-          // 2D fields
-          for(int i=0;i<n2d;i++) {
-            PetscInt row = ind0 + i;
-
-            // Loop through each point in the 5-point stencil
-            for(int c=0;c<5;c++) {
-              int xi = x + xoffset[c];
-              int yi = y + yoffset[c];
-                
-              if( (xi < 0) || (yi < 0) ||
-                  (xi >= mesh->LocalNx) || (yi >= mesh->LocalNy) )
-                continue;
-              
-              int ind2 = ROUND(index(xi, yi, 0));
-              
-              if(ind2 < 0)
-                continue; // A boundary point
-              
-              // Depends on all variables on this cell
-              for(int j=0;j<n2d;j++) {
-                PetscInt col = ind2 + j;
-
-                //output.write("SETTING 1: %d, %d\n", row, col);
-                MatSetValues(Jmf, 1, &row, 1, &col, &val, INSERT_VALUES);
-              }
-            }
-          }
-          
-          // 3D fields
-          for(int z=0;z<mesh->LocalNz;z++) {
-            
-            int ind = ROUND(index(x,y,z));
-            
-            for(int i=0;i<n3d;i++) {
-              PetscInt row = ind + i;
-              if(z == 0)
-                row += n2d;
-              
-              // Depends on 2D fields
-              for(int j=0;j<n2d;j++) {
-                PetscInt col = ind0 + j;
-                //output.write("SETTING 2: %d, %d\n", row, col);
-                MatSetValues(Jmf, 1, &row, 1, &col, &val, INSERT_VALUES);
-              }
-              
-              // 5 point star pattern
-              for(int c=0;c<5;c++) {
-                int xi = x + xoffset[c];
-                int yi = y + yoffset[c];
-                
-                if( (xi < 0) || (yi < 0) ||
-                    (xi >= mesh->LocalNx) || (yi >= mesh->LocalNy) )
-                  continue;
-                
-                int ind2 = ROUND(index(xi, yi, z));
-                if(ind2 < 0)
-                  continue; // Boundary point
-                
-                if(z == 0)
-                  ind2 += n2d;
-                
-                // 3D fields on this cell
-                for(int j=0;j<n3d;j++) {
-                  PetscInt col = ind2 + j;
-                  //output.write("SETTING 3: %d, %d\n", row, col);
-                  MatSetValues(Jmf, 1, &row, 1, &col, &val, INSERT_VALUES);
-                }
-              }
-
-              int nz = mesh->LocalNz;
-              if(nz > 1) {
-                // Multiple points in z
-                
-                int zp = (z + 1) % nz;
-
-                int ind2 = ROUND(index(x, y, zp));
-                if(zp == 0)
-                  ind2 += n2d;
-                for(int j=0;j<n3d;j++) {
-                  PetscInt col = ind2 + j;
-                  //output.write("SETTING 4: %d, %d\n", row, col);
-                  MatSetValues(Jmf, 1, &row, 1, &col, &val, INSERT_VALUES);
-                }
-
-                int zm = (z - 1 + nz) % nz;
-                ind2 = ROUND(index(x, y, zm));
-                if(zm == 0)
-                  ind2 += n2d;
-                for(int j=0;j<n3d;j++) {
-                  PetscInt col = ind2 + j;
-                  //output.write("SETTING 5: %d, %d\n", row, col);
-                  MatSetValues(Jmf, 1, &row, 1, &col, &val, INSERT_VALUES);
-                }
-                
-              }
-              
-            }
-          }
-        }
-      }
-      // Finished marking non-zero entries
-      
-      // Assemble Matrix
-      MatAssemblyBegin( Jmf, MAT_FINAL_ASSEMBLY );
-      MatAssemblyEnd( Jmf, MAT_FINAL_ASSEMBLY );
-      
-      
-      ISColoring iscoloring;
-      
-#if PETSC_VERSION_GE(3,5,0)
-      MatColoring coloring; // This new in PETSc 3.5
-      MatColoringCreate(Jmf,&coloring);
-      MatColoringSetType(coloring,MATCOLORINGSL);
-      MatColoringSetFromOptions(coloring);
-      // Calculate index sets
-      MatColoringApply(coloring,&iscoloring);
-      MatColoringDestroy(&coloring);
-#else
-      // Pre-3.5
-      MatGetColoring(Jmf,MATCOLORINGSL,&iscoloring);
-#endif
-
-      // Create data structure for SNESComputeJacobianDefaultColor
-      MatFDColoringCreate(Jmf,iscoloring,&fdcoloring);
-      ISColoringDestroy(&iscoloring);
-      // Set the function to difference
-      //MatFDColoringSetFunction(fdcoloring,(PetscErrorCode (*)(void))FormFunctionForDifferencing,this);
-      MatFDColoringSetFunction(fdcoloring,(PetscErrorCode (*)(void))FormFunctionForColoring,this);
-      MatFDColoringSetFromOptions(fdcoloring);
-      //MatFDColoringSetUp(Jmf,iscoloring,fdcoloring);
-      
 #if PETSC_VERSION_GE(3,4,0)
       SNESSetJacobian(*snesIn,Jmf,Jmf,SNESComputeJacobianDefault,fdcoloring);
 #else
@@ -624,12 +273,20 @@ void IMEXBDF2::constructSNES(SNES *snesIn){
 #endif
 
       // Re-use Jacobian
-      int lag_jacobian;
       OPTION(options, lag_jacobian,   4);
       SNESSetLagJacobian(*snesIn,lag_jacobian);
-      
-      //MatView(Jmf, PETSC_VIEWER_DRAW_WORLD);
-      //MatView(Jmf, PETSC_VIEWER_STDOUT_WORLD);
+
+#if PETSC_VERSION_GE(3,5,0)
+      // Keep the lagged Jacobian between SNESSolve calls, so it can be
+      // re-used across timesteps rather than recomputed at the start of
+      // every nonlinear solve. solve_implicit forces a recompute if the
+      // Jacobian has gone stale (failed step, or large timestep change)
+      bool lag_jacobian_persists;
+      OPTION(options, lag_jacobian_persists, true);
+      if (lag_jacobian_persists) {
+        SNESSetLagJacobianPersists(*snesIn, PETSC_TRUE);
+      }
+#endif
     }else {
       // Brute force calculation
       // NOTE: Slow!
@@ -667,6 +324,15 @@ void IMEXBDF2::constructSNES(SNES *snesIn){
   // Predictor method
   options->get("predictor", predictor, 1);
 
+  if(adaptive && adaptEmbedded && ((predictor < 0) || (predictor > 2))) {
+    //The embedded error estimate is the difference between the
+    //extrapolated predictor and the converged solution, so it needs
+    //an extrapolating predictor
+    output_warn.write("\tWARNING: predictor = %d does not extrapolate; falling back "
+                      "to the lower-order solve error estimate\n", predictor);
+    adaptEmbedded = false;
+  }
+
   /////////////////////////////////////////////////////
   // Preconditioner
 
@@ -732,6 +398,386 @@ void IMEXBDF2::constructSNES(SNES *snesIn){
 
 };
 
+//Create the matrix and its coloring, used for the finite difference
+//Jacobian evaluation. Stored in Jmf and fdcoloring, which are shared
+//between SNES objects and re-used for the whole run, since the sparsity
+//pattern doesn't change.
+void IMEXBDF2::constructMatrixColoring(){
+
+  //////////////////////////////////////////////////
+  // Get the local indices by starting at 0
+  Field3D index = globalIndex(0);
+
+  //////////////////////////////////////////////////
+  // Pre-allocate PETSc storage
+
+  int localN = getLocalN(); // Number of rows on this processor
+  int n2d = f2d.size();
+  int n3d = f3d.size();
+
+  // Set size of Matrix on each processor to localN x localN
+  MatCreate( BoutComm::get(), &Jmf );                                
+  MatSetSizes( Jmf, localN, localN, PETSC_DETERMINE, PETSC_DETERMINE );
+  MatSetFromOptions(Jmf);
+  
+  PetscInt *d_nnz, *o_nnz;
+  PetscMalloc( (localN)*sizeof(PetscInt), &d_nnz );
+  PetscMalloc( (localN)*sizeof(PetscInt), &o_nnz );
+
+  // Set values for most points
+  if(mesh->LocalNz > 1) {
+    // A 3D mesh, so need points in Z
+
+    for(int i=0;i<localN;i++) {
+      // Non-zero elements on this processor
+      d_nnz[i] = 7*n3d + 5*n2d; // Star pattern in 3D
+      // Non-zero elements on neighboring processor
+      o_nnz[i] = 0;
+    }
+  }else {
+    // Only one point in Z
+    
+    for(int i=0;i<localN;i++) {
+      // Non-zero elements on this processor
+      d_nnz[i] = 5*(n3d+n2d); // Star pattern in 2D
+      // Non-zero elements on neighboring processor
+      o_nnz[i] = 0;
+    }
+  }
+
+  // X boundaries
+  if(mesh->firstX()) {
+    // Lower X boundary
+    for(int y=mesh->ystart;y<=mesh->yend;y++) {
+      for(int z=0;z<mesh->LocalNz;z++) {
+        int localIndex = ROUND(index(mesh->xstart, y, z));
+        ASSERT2( (localIndex >= 0) && (localIndex < localN) );
+        if(z == 0) {
+          // All 2D and 3D fields
+          for(int i=0;i<n2d+n3d;i++)
+            d_nnz[localIndex + i] -= (n3d + n2d);
+        }else {
+          // Only 3D fields
+          for(int i=0;i<n3d;i++)
+            d_nnz[localIndex + i] -= (n3d + n2d);
+        }
+      }
+    }
+  }else {
+    // On another processor
+    for(int y=mesh->ystart;y<=mesh->yend;y++) {
+      for(int z=0;z<mesh->LocalNz;z++) {
+        int localIndex = ROUND(index(mesh->xstart, y, z));
+        ASSERT2( (localIndex >= 0) && (localIndex < localN) );
+        if(z == 0) {
+          // All 2D and 3D fields
+          for(int i=0;i<n2d+n3d;i++) {
+            d_nnz[localIndex+i] -= (n3d + n2d);
+            o_nnz[localIndex+i] += (n3d + n2d);
+          }
+        }else {
+          // Only 3D fields
+          for(int i=0;i<n3d;i++) {
+            d_nnz[localIndex+i] -= (n3d + n2d);
+            o_nnz[localIndex+i] += (n3d + n2d);
+          }
+        }
+      }
+    }
+  }
+
+  if(mesh->lastX()) {
+    // Upper X boundary
+    for(int y=mesh->ystart;y<=mesh->yend;y++) {
+      for(int z=0;z<mesh->LocalNz;z++) {
+        int localIndex = ROUND(index(mesh->xend, y, z));
+        ASSERT2( (localIndex >= 0) && (localIndex < localN) );
+        if(z == 0) {
+          // All 2D and 3D fields
+          for(int i=0;i<n2d+n3d;i++)
+            d_nnz[localIndex + i] -= (n3d + n2d);
+        }else {
+          // Only 3D fields
+          for(int i=0;i<n3d;i++)
+            d_nnz[localIndex + i] -= (n3d + n2d);
+        }
+      }
+    }
+  }else {
+    // On another processor
+    for(int y=mesh->ystart;y<=mesh->yend;y++) {
+      for(int z=0;z<mesh->LocalNz;z++) {
+        int localIndex = ROUND(index(mesh->xend, y, z));
+        ASSERT2( (localIndex >= 0) && (localIndex < localN) );
+        if(z == 0) {
+          // All 2D and 3D fields
+          for(int i=0;i<n2d+n3d;i++) {
+            d_nnz[localIndex+i] -= (n3d + n2d);
+            o_nnz[localIndex+i] += (n3d + n2d);
+          }
+        }else {
+          // Only 3D fields
+          for(int i=0;i<n3d;i++) {
+            d_nnz[localIndex+i] -= (n3d + n2d);
+            o_nnz[localIndex+i] += (n3d + n2d);
+          }
+        }
+      }
+    }
+  }
+  
+  // Y boundaries
+
+  for(int x=mesh->xstart; x <=mesh->xend; x++) {
+    // Default to no boundary
+    // NOTE: This assumes that communications in Y are to other
+    //   processors. If Y is communicated with this processor (e.g. NYPE=1)
+    //   then this will result in PETSc warnings about out of range allocations
+
+    // z = 0 case
+    int localIndex = ROUND(index(x, mesh->ystart, 0));
+    // All 2D and 3D fields
+    for(int i=0;i<n2d+n3d;i++) {
+      //d_nnz[localIndex+i] -= (n3d + n2d);
+      o_nnz[localIndex+i] += (n3d + n2d);
+    }
+    
+    for(int z=1;z<mesh->LocalNz;z++) {
+      localIndex = ROUND(index(x, mesh->ystart, z));
+      
+      // Only 3D fields
+      for(int i=0;i<n3d;i++) {
+        //d_nnz[localIndex+i] -= (n3d + n2d);
+        o_nnz[localIndex+i] += (n3d + n2d);
+      }
+    }
+
+    // z = 0 case
+    localIndex = ROUND(index(x, mesh->yend, 0));
+    // All 2D and 3D fields
+    for(int i=0;i<n2d+n3d;i++) {
+      //d_nnz[localIndex+i] -= (n3d + n2d);
+      o_nnz[localIndex+i] += (n3d + n2d);
+    }
+    
+    for(int z=1;z<mesh->LocalNz;z++) {
+      localIndex = ROUND(index(x, mesh->yend, z));
+      
+      // Only 3D fields
+      for(int i=0;i<n3d;i++) {
+        //d_nnz[localIndex+i] -= (n3d + n2d);
+        o_nnz[localIndex+i] += (n3d + n2d);
+      }
+    }
+  }
+
+  for(RangeIterator it=mesh->iterateBndryLowerY(); !it.isDone(); it++) {
+    // A boundary, so no communication
+
+    // z = 0 case
+    int localIndex = ROUND(index(it.ind, mesh->ystart, 0));
+    // All 2D and 3D fields
+    for(int i=0;i<n2d+n3d;i++) {
+      o_nnz[localIndex+i] -= (n3d + n2d);
+    }
+    
+    for(int z=1;z<mesh->LocalNz;z++) {
+      int localIndex = ROUND(index(it.ind, mesh->ystart, z));
+      
+      // Only 3D fields
+      for(int i=0;i<n3d;i++) {
+        o_nnz[localIndex+i] -= (n3d + n2d);
+      }
+    }
+  }
+
+  for(RangeIterator it=mesh->iterateBndryUpperY(); !it.isDone(); it++) {
+    // A boundary, so no communication
+
+    // z = 0 case
+    int localIndex = ROUND(index(it.ind, mesh->yend, 0));
+    // All 2D and 3D fields
+    for(int i=0;i<n2d+n3d;i++) {
+      o_nnz[localIndex+i] -= (n3d + n2d);
+    }
+    
+    for(int z=1;z<mesh->LocalNz;z++) {
+      int localIndex = ROUND(index(it.ind, mesh->yend, z));
+      
+      // Only 3D fields
+      for(int i=0;i<n3d;i++) {
+        o_nnz[localIndex+i] -= (n3d + n2d);
+      }
+    }
+  }
+  
+  // Pre-allocate
+  MatMPIAIJSetPreallocation( Jmf, 0, d_nnz, 0, o_nnz );
+  MatSetUp(Jmf); 
+  MatSetOption(Jmf,MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_FALSE);      
+  PetscFree( d_nnz );
+  PetscFree( o_nnz );
+  
+  // Determine which row/columns of the matrix are locally owned
+  int Istart, Iend;
+  MatGetOwnershipRange( Jmf, &Istart, &Iend );
+  
+  // Convert local into global indices
+  index += Istart;
+  
+  // Now communicate to fill guard cells
+  mesh->communicate(index);
+
+  //////////////////////////////////////////////////
+  // Mark non-zero entries
+
+  
+  // Offsets for a 5-point pattern
+  const int xoffset[5] = {0,-1, 1, 0, 0};
+  const int yoffset[5] = {0, 0, 0,-1, 1};
+  
+  PetscScalar val = 1.0;
+  
+  for(int x=mesh->xstart; x <= mesh->xend; x++) {
+    for(int y=mesh->ystart;y<=mesh->yend;y++) {
+      
+      int ind0 = ROUND(index(x,y,0));
+
+      // 2D fields
+      for(int i=0;i<n2d;i++) {
+        PetscInt row = ind0 + i;
+
+        // Loop through each point in the 5-point stencil
+        for(int c=0;c<5;c++) {
+          int xi = x + xoffset[c];
+          int yi = y + yoffset[c];
+            
+          if( (xi < 0) || (yi < 0) ||
+              (xi >= mesh->LocalNx) || (yi >= mesh->LocalNy) )
+            continue;
+          
+          int ind2 = ROUND(index(xi, yi, 0));
+          
+          if(ind2 < 0)
+            continue; // A boundary point
+          
+          // Depends on all variables on this cell
+          for(int j=0;j<n2d;j++) {
+            PetscInt col = ind2 + j;
+
+            //output.write("SETTING 1: %d, %d\n", row, col);
+            MatSetValues(Jmf, 1, &row, 1, &col, &val, INSERT_VALUES);
+          }
+        }
+      }
+      
+      // 3D fields
+      for(int z=0;z<mesh->LocalNz;z++) {
+        
+        int ind = ROUND(index(x,y,z));
+        
+        for(int i=0;i<n3d;i++) {
+          PetscInt row = ind + i;
+          if(z == 0)
+            row += n2d;
+          
+          // Depends on 2D fields
+          for(int j=0;j<n2d;j++) {
+            PetscInt col = ind0 + j;
+            //output.write("SETTING 2: %d, %d\n", row, col);
+            MatSetValues(Jmf, 1, &row, 1, &col, &val, INSERT_VALUES);
+          }
+          
+          // 5 point star pattern
+          for(int c=0;c<5;c++) {
+            int xi = x + xoffset[c];
+            int yi = y + yoffset[c];
+            
+            if( (xi < 0) || (yi < 0) ||
+                (xi >= mesh->LocalNx) || (yi >= mesh->LocalNy) )
+              continue;
+            
+            int ind2 = ROUND(index(xi, yi, z));
+            if(ind2 < 0)
+              continue; // Boundary point
+            
+            if(z == 0)
+              ind2 += n2d;
+            
+            // 3D fields on this cell
+            for(int j=0;j<n3d;j++) {
+              PetscInt col = ind2 + j;
+              //output.write("SETTING 3: %d, %d\n", row, col);
+              MatSetValues(Jmf, 1, &row, 1, &col, &val, INSERT_VALUES);
+            }
+          }
+
+          int nz = mesh->LocalNz;
+          if(nz > 1) {
+            // Multiple points in z
+            
+            int zp = (z + 1) % nz;
+
+            int ind2 = ROUND(index(x, y, zp));
+            if(zp == 0)
+              ind2 += n2d;
+            for(int j=0;j<n3d;j++) {
+              PetscInt col = ind2 + j;
+              //output.write("SETTING 4: %d, %d\n", row, col);
+              MatSetValues(Jmf, 1, &row, 1, &col, &val, INSERT_VALUES);
+            }
+
+            int zm = (z - 1 + nz) % nz;
+            ind2 = ROUND(index(x, y, zm));
+            if(zm == 0)
+              ind2 += n2d;
+            for(int j=0;j<n3d;j++) {
+              PetscInt col = ind2 + j;
+              //output.write("SETTING 5: %d, %d\n", row, col);
+              MatSetValues(Jmf, 1, &row, 1, &col, &val, INSERT_VALUES);
+            }
+            
+          }
+          
+        }
+      }
+    }
+  }
+  // Finished marking non-zero entries
+  
+  // Assemble Matrix
+  MatAssemblyBegin( Jmf, MAT_FINAL_ASSEMBLY );
+  MatAssemblyEnd( Jmf, MAT_FINAL_ASSEMBLY );
+  
+  
+  ISColoring iscoloring;
+  
+#if PETSC_VERSION_GE(3,5,0)
+  MatColoring coloring; // This new in PETSc 3.5
+  MatColoringCreate(Jmf,&coloring);
+  MatColoringSetType(coloring,MATCOLORINGSL);
+  MatColoringSetFromOptions(coloring);
+  // Calculate index sets
+  MatColoringApply(coloring,&iscoloring);
+  MatColoringDestroy(&coloring);
+#else
+  // Pre-3.5
+  MatGetColoring(Jmf,MATCOLORINGSL,&iscoloring);
+#endif
+
+  // Create data structure for SNESComputeJacobianDefaultColor
+  MatFDColoringCreate(Jmf,iscoloring,&fdcoloring);
+  ISColoringDestroy(&iscoloring);
+  // Set the function to difference
+  //MatFDColoringSetFunction(fdcoloring,(PetscErrorCode (*)(void))FormFunctionForDifferencing,this);
+  MatFDColoringSetFunction(fdcoloring,(PetscErrorCode (*)(void))FormFunctionForColoring,this);
+  MatFDColoringSetFromOptions(fdcoloring);
+  //MatFDColoringSetUp(Jmf,iscoloring,fdcoloring);
+
+  //MatView(Jmf, PETSC_VIEWER_DRAW_WORLD);
+  //MatView(Jmf, PETSC_VIEWER_STDOUT_WORLD);
+}
+
 int IMEXBDF2::run() {
   TRACE("IMEXBDF2::run()");
 
@@ -751,9 +797,10 @@ int IMEXBDF2::run() {
     BoutReal cumulativeTime = 0.;
     int counter = 0; //How many iterations in this output step
     
-    // Reset linear and nonlinear fail counts
+    // Reset linear and nonlinear fail counts, and the controller telemetry
     linear_fails = 0;
     nonlinear_fails = 0;
+    nerr_checks = ndt_up = ndt_down = nretries = norder_up = norder_down = 0;
     while(cumulativeTime<out_timestep){
       //Move state history along one stage (i.e. u_2-->u_3,u_1-->u_2, u-->u_1 etc.)
       //Note: This sets the current timestep to be the same as the last timestep.
@@ -807,9 +854,14 @@ int IMEXBDF2::run() {
 	timesteps[0] = dtNext;
 
 	//If we're checking the error at this point do the low order solution now
-	if(checkingErr){
+	//(unless the embedded estimate is in use: the predictor guess saved
+	//by the main solve below plays the role of the second solution)
+	if(checkingErr && adaptEmbedded){
+	  capture_predictor = true;
+	}
+	if(checkingErr && !adaptEmbedded){
 	  //First find coefficients for use with lower order scheme
-	  calculateCoeffs(order-1);  
+	  calculateCoeffs(order-1);
 
 	  //Use alternative snes solver for low order scheme
 	  snesUse = snesAlt;
@@ -823,19 +875,25 @@ int IMEXBDF2::run() {
               throw;
 
             failCounter++;
+            nretries++;
             if(failCounter > 10) {
               throw BoutException("Too many failed steps\n");
             }
-            
+
+            if(adaptOrder && (order > 1)) {
+              order--; // Drop towards BDF1, which has the better stability
+              norder_down++;
+            }
+
             running = true; // Retry
             dtNext = timesteps[0]*0.5;
+            jacobian_stale = true; // Rebuild the Jacobian before retrying
             continue;
           }
-	  
-	  //Store this solution in err
-	  for(int i=0;i<nlocal;i++){
-	    err[i] = u[i];
-	  };
+
+	  //Snapshot this solution into err: O(1), the storage is shared
+	  //and u is detached from it when the high order solve writes it
+	  err = snapshotState(u);
 
 	  //Go back to using the main snes object
 	  snesUse = snes;
@@ -844,8 +902,9 @@ int IMEXBDF2::run() {
 	//Now we get the coefficients if the order has changed *or* any of the
 	//timesteps in the history are different *or* we had to calc coefficients
 	//for lower order scheme.
-	if( (order!=lastOrder) || (lastTimesteps != timesteps) || checkingErr){
-	  calculateCoeffs(order);  
+	if( (order!=lastOrder) || (lastTimesteps != timesteps)
+	    || (checkingErr && !adaptEmbedded) ){
+	  calculateCoeffs(order);
 	}
 
 	//Now we complete the timestep by constructing rhs and solving the implicit part
@@ -857,20 +916,29 @@ int IMEXBDF2::run() {
             throw;
 
           failCounter++;
+          nretries++;
           if(failCounter > 10) {
             throw BoutException("Too many failed steps\n");
           }
 
+          if(adaptOrder && (order > 1)) {
+            order--; // Drop towards BDF1, which has the better stability
+            norder_down++;
+          }
+
           running = true; // Retry
           dtNext = timesteps[0]*0.5;
+          jacobian_stale = true; // Rebuild the Jacobian before retrying
           continue;
         }
+        capture_predictor = false;
 
 	//Now we can calculate the error and decide what we want to do
 	if(checkingErr){
+	  nerr_checks++;
 	  //Now we want to find the actual (abs) error
-	  BoutReal errTot[3] = {0,0,0}; 
-	  BoutReal errGlobTot[3] = {0,0,0};
+	  double errTot[3] = {0,0,0};
+	  double errGlobTot[3] = {0,0,0};
 
 	  //Find local data
 	  for(int i=0;i<nlocal;i++){
@@ -906,20 +974,28 @@ int IMEXBDF2::run() {
 	   * aRtol represents the error on the U_N as this is what we follow.
 	   */
 	  BoutReal delta = adaptRtol/aRtol;
-	  BoutReal s = pow(delta, 1.0/(order-1.0));
+	  //Order of the error estimate: the lower-order solution differs
+	  //from the full one at O(dt^(order-1)), while the embedded
+	  //predictor-corrector difference is set by the extrapolation
+	  //order of the predictor
+	  int errOrder = adaptEmbedded ? BOUTMIN(predictor + 1, order) : order - 1;
+	  BoutReal s = pow(delta, 1.0/errOrder);
 
 	  //Work out if we need to change the timestep and repeat this step
 	  if(s<scaleCushDown){
 	    running = true;
-	    dtNext = timesteps[0]*s; 
-	  }else if( (s>=scaleCushUp) && (adaptCounter==0) && (failCounter == 0) ){ 
+	    dtNext = timesteps[0]*s;
+	    ndt_down++;
+	    nretries++;
+	  }else if( (s>=scaleCushUp) && (adaptCounter==0) && (failCounter == 0) ){
 	    // Here we decide to increase the timestep
 	    // but note we only allow this if this is the first attempt at this step.
             // and if there have been no failed steps
 	    // This is designed to prevent oscillation in timestep.
-            
-            s = BOUTMIN(s, 1.25); // Limit increase 
+
+            s = BOUTMIN(s, 1.25); // Limit increase
 	    dtNext = timesteps[0]*s;
+	    ndt_up++;
 	  }else{ //No change to the timestep
 	    dtNext = timesteps[0];
 	  }
@@ -943,8 +1019,25 @@ int IMEXBDF2::run() {
       lastOrder = order;
       lastTimesteps = timesteps;
 
-      //Increment order if we're not at the maximum requested
-      if(order<maxOrder) order++;
+      //Stiffness signal: the Newton iteration working hard suggests
+      //dropping towards BDF1, which has the better stability region
+      if(adaptOrder && (order > 1) && (last_snes_its > stiffSnesIts)){
+	order--;
+	norder_down++;
+      }
+
+      //Increment order if we're not at the maximum requested. With
+      //adaptOrder this is gated on the step having gone smoothly, so
+      //a stiff phase holds the order down instead of ramping back up
+      if(order<maxOrder){
+	if(!adaptOrder){
+	  order++;
+	}else if( (failCounter == 0) && (adaptCounter <= 1)
+		  && (last_snes_its <= stiffSnesIts) ){
+	  order++;
+	  norder_up++;
+	}
+      }
 
       //Update simulation time and record of how far through this output step we are.
       simtime += timesteps[0];
@@ -955,6 +1048,11 @@ int IMEXBDF2::run() {
       //Increment internal counter to keep track of number of internal iterations
       internalCounter++;
 
+      // Record statistics for this output step
+      stats.nsteps++;
+      stats.last_dt = timesteps[0];
+      stats.nfailed = linear_fails + nonlinear_fails;
+
       //Increment iteration counter to ensure we don't get an infinite loop
       counter++;
       if(counter>mxstep){
@@ -965,6 +1063,14 @@ int IMEXBDF2::run() {
     if(diagnose) {
       output.write("\n   Last dt = %e, order = %d\n", timesteps[0], lastOrder);
       output.write("   Linear fails = %d, nonlinear fails = %d\n", linear_fails, nonlinear_fails);
+      if(adaptive) {
+        output.write("   Error checks = %d (%s): dt up = %d, dt down = %d, retries = %d\n",
+                     nerr_checks, adaptEmbedded ? "embedded" : "low-order solve",
+                     ndt_up, ndt_down, nretries);
+      }
+      if(adaptOrder) {
+        output.write("   Order raised = %d, dropped = %d\n", norder_up, norder_down);
+      }
     }
 
     loadVars(std::begin(u));// Put result into variables
@@ -1175,10 +1281,41 @@ PetscErrorCode IMEXBDF2::solve_implicit(BoutReal curtime, BoutReal gamma) {
   }
   }
 
+  if(capture_predictor) {
+    //Keep the extrapolated guess: its difference from the converged
+    //solution below is the embedded error estimate
+    BoutReal *edata = writableState(err);
+    for(int i=0;i<nlocal;i++)
+      edata[i] = xdata[i];
+  }
+
   ierr = VecRestoreArray(snes_x,&xdata);CHKERRQ(ierr);
 
+  bool force_jacobian = false;
+  if(lag_jacobian > 0) {
+    // The Jacobian depends on the timestep through gamma, so if gamma
+    // has drifted appreciably since the Jacobian was last recomputed
+    // the lagged Jacobian is stale. A failed step also marks it stale.
+    if(fabs(gamma - jacobian_gamma) > 0.1*fabs(jacobian_gamma)) {
+      jacobian_stale = true;
+    }
+    if(jacobian_stale) {
+      // Recompute the Jacobian during this solve, rather than waiting
+      // for the lag counter to expire
+      force_jacobian = true;
+      SNESSetLagJacobian(snesUse, 1);
+    }
+  }
+
   SNESSolve(snesUse, nullptr, snes_x);
 
+  if(force_jacobian) {
+    // Go back to the lagged Jacobian, which is now up to date
+    SNESSetLagJacobian(snesUse, lag_jacobian);
+    jacobian_stale = false;
+    jacobian_gamma = gamma;
+  }
+
   // Find out if converged
   SNESConvergedReason reason;
   SNESGetConvergedReason(snesUse,&reason);
@@ -1207,16 +1344,23 @@ PetscErrorCode IMEXBDF2::solve_implicit(BoutReal curtime, BoutReal gamma) {
 
   int its;
   SNESGetIterationNumber(snesUse,&its);
+  last_snes_its = its; // Stiffness indicator for the order controller
 
   if(verbose) {
     output << "Number of SNES iterations: " << its << endl;
   }
+
+  // Accumulate iteration counts for the solver statistics
+  stats.nnewton_iters += its;
+  SNESGetLinearSolveIterations(snesUse, &its);
+  stats.nkrylov_iters += its;
     
   // Put the result into u
   ierr = VecGetArray(snes_x,&xdata);CHKERRQ(ierr);
 
+  BoutReal *udata = writableState(u); // Detach any snapshot (e.g. err) first
   for(int i=0;i<nlocal;i++)
-    u[i] = xdata[i];
+    udata[i] = xdata[i];
   ierr = VecRestoreArray(snes_x,&xdata);CHKERRQ(ierr);
 
   return 0;
@@ -122,6 +122,29 @@ class IMEXBDF2 : public Solver {
   BoutReal dtMax; ///< Maximum timestep we want to use
   BoutReal dtMinFatal; ///< If timestep wants to drop below this we abort. Set -ve to deactivate
 
+  /// Estimate the error from the predictor-corrector difference: the
+  /// extrapolated initial guess is already formed for the SNES solve,
+  /// so comparing it with the converged solution costs nothing, where
+  /// the alternative (adaptEmbedded=false) repeats the implicit solve
+  /// at one order lower
+  bool adaptEmbedded;
+  /// Switch the scheme order between 1 and maxOrder at run time:
+  /// dropped when steps fail or the Newton iteration works hard
+  /// (BDF1/2 have the better stability), raised again when the
+  /// integration runs smoothly with the error well under target
+  bool adaptOrder;
+  int stiffSnesIts; ///< Newton iterations per solve treated as a stiffness signal
+
+  bool capture_predictor; ///< Save the next initial guess into err, for adaptEmbedded
+  int last_snes_its;      ///< Newton iterations taken by the last implicit solve
+
+  /// Timestep/order controller telemetry, accumulated per output
+  /// step and printed by the diagnose option
+  int nerr_checks;              ///< Error estimates evaluated
+  int ndt_up, ndt_down;         ///< Controller decisions to grow / shrink dt
+  int nretries;                 ///< Steps redone (error too large or solve failed)
+  int norder_up, norder_down;   ///< Order raised / dropped (adaptOrder)
+
   //Scheme coefficients
   vector<BoutReal> uFac, fFac, gFac;
   BoutReal dtImp;
@@ -142,6 +165,12 @@ class IMEXBDF2 : public Solver {
   ///
   void constructSNES(SNES *snesIn);
 
+  /// Create the matrix \p Jmf and its coloring \p fdcoloring, used for
+  /// finite difference Jacobian evaluation. Called at most once, since
+  /// the sparsity pattern (and hence the coloring) doesn't change
+  /// during a run.
+  void constructMatrixColoring();
+
   /// Shuffle state along one step
   void shuffleState();
 
@@ -149,12 +178,12 @@ class IMEXBDF2 : public Solver {
   void calculateCoeffs(int order);
 
   // Working memory
-  Array<BoutReal> u ; ///< System state at current time
-  vector<Array<BoutReal>> uV; ///< The solution history
-  vector<Array<BoutReal>> fV; ///< The non-stiff solution history
+  Array<double> u ; ///< System state at current time
+  vector<Array<double>> uV; ///< The solution history
+  vector<Array<double>> fV; ///< The non-stiff solution history
   vector<BoutReal> timesteps; ///< Timestep history
-  Array<BoutReal> rhs;
-  Array<BoutReal> err;
+  Array<double> rhs;
+  Array<double> err;
 
   // Implicit solver
   PetscErrorCode solve_implicit(BoutReal curtime, BoutReal gamma);
@@ -176,10 +205,14 @@ class IMEXBDF2 : public Solver {
   int nonlinear_fails;  ///< Numbef of nonlinear (SNES) convergence failures
 
   bool have_constraints; ///< Are there any constraint variables?
-  Array<BoutReal> is_dae; ///< If using constraints, 1 -> DAE, 0 -> AE
+  Array<double> is_dae; ///< If using constraints, 1 -> DAE, 0 -> AE
 
   MatFDColoring fdcoloring; ///< Matrix coloring context, used for finite difference Jacobian evaluation
 
+  int lag_jacobian;  ///< How many Newton iterations to re-use the Jacobian for. -1 if not lagging
+  bool jacobian_stale;  ///< Force the lagged Jacobian to be recomputed at the next implicit solve?
+  BoutReal jacobian_gamma;  ///< Value of implicit_gamma when the Jacobian was last recomputed
+
   template< class Op >
   void loopVars(BoutReal *u);
 
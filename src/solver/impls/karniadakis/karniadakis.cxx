@@ -74,16 +74,15 @@ int KarniadakisSolver::init(int nout, BoutReal tstep) {
   
   // Allocate memory
 
-  f1 = Array<BoutReal>(nlocal);
-  f0 = Array<BoutReal>(nlocal);
-  fm1 = Array<BoutReal>(nlocal);
-  fm2 = Array<BoutReal>(nlocal);
+  f0 = Array<double>(nlocal);
+  fm1 = Array<double>(nlocal);
+  fm2 = Array<double>(nlocal);
 
-  S0 = Array<BoutReal>(nlocal);
-  Sm1 = Array<BoutReal>(nlocal);
-  Sm2 = Array<BoutReal>(nlocal);
+  S0 = Array<double>(nlocal);
+  Sm1 = Array<double>(nlocal);
+  Sm2 = Array<double>(nlocal);
 
-  D0 = Array<BoutReal>(nlocal);
+  D0 = Array<double>(nlocal);
 
   first_time = true;
 
@@ -111,16 +110,18 @@ int KarniadakisSolver::run() {
   for(int i=0;i<nsteps;i++) {
     // Run through a fixed number of steps
     for(int j=0; j<nsubsteps; j++) {
-      // Advance f0 -> f1
+      // Advance the state, writing the result over fm2
       take_step(timestep);
-      
-      // Cycle buffers
+
+      // Cycle buffers. Array assignment shares the underlying data,
+      // so this is a pure handle rotation with no copying: the new
+      // state (in fm2's buffer) becomes f0, and the oldest history
+      // buffer is recycled
       auto tmp = fm2;
       fm2 = fm1;
       fm1 = f0;
-      f0 = f1;
-      f1 = tmp;
-      
+      f0 = tmp;
+
       tmp = Sm2;
       Sm2 = Sm1;
       Sm1 = S0;
@@ -162,6 +163,13 @@ void KarniadakisSolver::take_step(BoutReal dt) {
   run_convective(simtime);
   save_derivs(std::begin(S0));
 
+  // D0 = D(f0). Reload the state first, in case the convective part
+  // modified the evolving fields (e.g. boundary conditions applied in
+  // the model)
+  load_vars(std::begin(f0));
+  run_diffusive(simtime);
+  save_derivs(std::begin(D0));
+
   if(first_time) {
     // Initialise values
     BOUT_OMP(parallel for)
@@ -174,17 +182,21 @@ void KarniadakisSolver::take_step(BoutReal dt) {
     first_time = false;
   }
 
-  BOUT_OMP(parallel for)
-  for(int i=0;i<nlocal;i++)
-    f1[i] = (6./11.) * (3.*f0[i] - 1.5*fm1[i] + (1./3.)*fm2[i] + dt*(3.*S0[i] - 3.*Sm1[i] + Sm2[i]));
-  
-  // D0 = S(f0)
-  load_vars(std::begin(f0));
-  run_diffusive(simtime);
-  save_derivs(std::begin(D0));
+  // Single fused update: the SBDF combination and the dissipative
+  // correction in one pass over the state vector, written over fm2
+  // which is read before it is overwritten at each point. The update
+  // is memory bound, so halving the number of passes matters more
+  // than the arithmetic
+  const double *f0d = std::begin(f0);
+  const double *fm1d = std::begin(fm1);
+  const double *S0d = std::begin(S0);
+  const double *Sm1d = std::begin(Sm1);
+  const double *Sm2d = std::begin(Sm2);
+  const double *D0d = std::begin(D0);
+  double *fnew = std::begin(fm2);
 
-  // f1 = f1 + dt*D0
   BOUT_OMP(parallel for)
   for(int i=0;i<nlocal;i++)
-    f1[i] += (6./11.) * dt*D0[i];
+    fnew[i] = (6./11.) * (3.*f0d[i] - 1.5*fm1d[i] + (1./3.)*fnew[i]
+                          + dt*(3.*S0d[i] - 3.*Sm1d[i] + Sm2d[i] + D0d[i]));
 }
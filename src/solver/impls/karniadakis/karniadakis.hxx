@@ -59,10 +59,10 @@ class KarniadakisSolver : public Solver {
 
  private:
   
-  Array<BoutReal> f1, f0, fm1, fm2; // System state at current, and two previous time points
-  Array<BoutReal> S0, Sm1, Sm2; // Convective part of the RHS equations
-  Array<BoutReal> D0;             // Dissipative part of the RHS
-  
+  Array<double> f0, fm1, fm2; // System state at current, and two previous time points
+  Array<double> S0, Sm1, Sm2; // Convective part of the RHS equations
+  Array<double> D0;             // Dissipative part of the RHS
+
   bool first_time; // Need to initialise values
 
   BoutReal out_timestep; // The output timestep
@@ -73,7 +73,9 @@ class KarniadakisSolver : public Solver {
   
   int nlocal; // Number of variables on local processor
   
-  void take_step(BoutReal dt); // Take a single step to calculate f1
+  // Take a single step, writing the new state over fm2 (the oldest
+  // history buffer, discarded by the rotation in run())
+  void take_step(BoutReal dt);
 };
 
 #endif // __KARNIADAKIS_SOLVER_H__
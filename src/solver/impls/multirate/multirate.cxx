@@ -0,0 +1,142 @@
+#include "multirate.hxx"
+
+#include <boutcomm.hxx>
+#include <utils.hxx>
+#include <boutexception.hxx>
+#include <msg_stack.hxx>
+#include <bout/openmpwrap.hxx>
+#include <cmath>
+
+#include <output.hxx>
+
+MultirateSolver::MultirateSolver(Options *opt) : Solver(opt) {}
+
+int MultirateSolver::init(int nout, BoutReal tstep) {
+
+  TRACE("Initialising multirate solver");
+
+  /// Call the generic initialisation first
+  if (Solver::init(nout, tstep))
+    return 1;
+
+  output << "\n\tMultirate RK3 SSP solver\n";
+
+  if(!splitOperator()) {
+    output_warn.write("\tWARNING: Model is not split into convective and diffusive parts.\n"
+                      "\t         The whole RHS will be treated as slow.\n");
+  }
+
+  nsteps = nout; // Save number of output steps
+  out_timestep = tstep;
+
+  // Calculate number of variables
+  nlocal = getLocalN();
+
+  // Get total problem size
+  int ntmp;
+  if(MPI_Allreduce(&nlocal, &ntmp, 1, MPI_INT, MPI_SUM, BoutComm::get())) {
+    throw BoutException("MPI_Allreduce failed!");
+  }
+  neq = ntmp;
+
+  output.write("\t3d fields = %d, 2d fields = %d neq=%d, local_N=%d\n",
+	       n3Dvars(), n2Dvars(), neq, nlocal);
+
+  // Allocate memory
+  f = Array<double>(nlocal);
+
+  // memory for taking a single time step
+  u1 = Array<double>(nlocal);
+  u2 = Array<double>(nlocal);
+  L = Array<double>(nlocal);
+  D_slow = Array<double>(nlocal);
+
+  // Put starting values into f
+  save_vars(std::begin(f));
+
+  // Get options
+  OPTION(options, timestep, tstep); // Fast (substep) timestep
+  OPTION(options, nsubsteps, 10); // Fast substeps per slow RHS evaluation
+
+  if(nsubsteps < 1) {
+    throw BoutException("solver:nsubsteps must be at least 1");
+  }
+
+  // Make sure a whole number of slow steps fits into the output timestep,
+  // rounding the number of slow steps up
+  nslow = static_cast<int>(0.5 + tstep / (timestep * static_cast<BoutReal>(nsubsteps)));
+  if(nslow < 1)
+    nslow = 1;
+  timestep = tstep / static_cast<BoutReal>(nslow * nsubsteps);
+
+  output.write("\tFast timestep %e, slow timestep %e (%d substeps)\n",
+               timestep, timestep * static_cast<BoutReal>(nsubsteps), nsubsteps);
+
+  return 0;
+}
+
+int MultirateSolver::run() {
+  TRACE("MultirateSolver::run()");
+
+  for(int s=0;s<nsteps;s++) {
+
+    for(int i=0;i<nslow;i++) {
+      // Evaluate the slow (diffusive) part once, and freeze the
+      // resulting time derivative for the fast substeps
+      load_vars(std::begin(f));
+      run_diffusive(simtime, false);
+      save_derivs(std::begin(D_slow));
+
+      for(int j=0;j<nsubsteps;j++) {
+        take_step(simtime, timestep, f, f);
+
+        simtime += timestep;
+
+        call_timestep_monitors(simtime, timestep);
+      }
+    }
+
+    load_vars(std::begin(f)); // Put result into variables
+    // Call rhs function to get extra variables at this time
+    run_rhs(simtime);
+
+    iteration++; // Advance iteration number
+
+    /// Call the monitor function
+
+    if(call_monitors(simtime, s, nsteps)) {
+      // User signalled to quit
+      break;
+    }
+  }
+
+  return 0;
+}
+
+void MultirateSolver::take_step(BoutReal curtime, BoutReal dt, Array<double> &start,
+                                Array<double> &result) {
+
+  load_vars(std::begin(start));
+  run_convective(curtime);
+  save_derivs(std::begin(L));
+
+  BOUT_OMP(parallel for)
+  for(int i=0;i<nlocal;i++)
+    u1[i] = start[i] + dt*(L[i] + D_slow[i]);
+
+  load_vars(std::begin(u1));
+  run_convective(curtime + dt);
+  save_derivs(std::begin(L));
+
+  BOUT_OMP(parallel for )
+  for(int i=0;i<nlocal;i++)
+    u2[i] = 0.75*start[i] + 0.25*u1[i] + 0.25*dt*(L[i] + D_slow[i]);
+
+  load_vars(std::begin(u2));
+  run_convective(curtime + 0.5*dt);
+  save_derivs(std::begin(L));
+
+  BOUT_OMP(parallel for)
+  for(int i=0;i<nlocal;i++)
+    result[i] = (1./3)*start[i] + (2./3.)*(u2[i] + dt*(L[i] + D_slow[i]));
+}
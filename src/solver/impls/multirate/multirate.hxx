@@ -0,0 +1,91 @@
+/**************************************************************************
+ * Multirate split-operator solver
+ *
+ * Solves a system df/dt = S(f) + D(f)
+ *
+ * where S (the convective part) contains the fast dynamics, and
+ * D (the diffusive part) the slow dynamics. The slow part is
+ * evaluated once per slow step, and the resulting time derivative
+ * held frozen whilst a number of 3rd-order SSP Runge-Kutta substeps
+ * advance the fast part. The slow RHS - typically the expensive
+ * physics such as collision operators - is therefore evaluated
+ * nsubsteps times less often than the fast RHS.
+ *
+ * The coupling between the partitions is first order in the slow
+ * timestep, so the slow timestep (timestep * nsubsteps) must resolve
+ * the slow dynamics.
+ *
+ * Always available, since doesn't depend on external library
+ *
+ **************************************************************************
+ * Copyright 2010 B.D.Dudson, S.Farley, M.V.Umansky, X.Q.Xu
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+class MultirateSolver;
+
+#ifndef __MULTIRATE_SOLVER_H__
+#define __MULTIRATE_SOLVER_H__
+
+#include "mpi.h"
+
+#include <bout_types.hxx>
+#include <bout/solver.hxx>
+
+#include <bout/solverfactory.hxx>
+namespace {
+RegisterSolver<MultirateSolver> registersolvermultirate("multirate");
+}
+
+class MultirateSolver : public Solver {
+ public:
+  MultirateSolver(Options *opt = nullptr);
+  ~MultirateSolver(){};
+
+  BoutReal getCurrentTimestep() override {return timestep; }
+
+  int init(int nout, BoutReal tstep) override;
+
+  int run() override;
+ private:
+
+  int nsubsteps; // Number of fast substeps per slow RHS evaluation
+
+  Array<double> f;
+
+  BoutReal out_timestep; // The output timestep
+  int nsteps; // Number of output steps
+  int nslow; // Number of slow steps per output step
+
+  BoutReal timestep; // The internal (fast) timestep
+
+  int nlocal, neq; // Number of variables on local processor and in total
+
+  /// Take a single fast RK3-SSP step of the convective part,
+  /// including the frozen slow time derivative D_slow
+  void take_step(BoutReal curtime, BoutReal dt,
+                 Array<double> &start, Array<double> &result);
+
+  Array<double> u1, u2, L; // Time-stepping arrays
+  Array<double> D_slow; // Slow (diffusive) time derivative, frozen during substeps
+
+};
+
+#endif // __MULTIRATE_SOLVER_H__
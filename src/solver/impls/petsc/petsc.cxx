@@ -66,7 +66,6 @@ PetscSolver::PetscSolver(Options *opts) : Solver(opts) {
   initialised = false;
   bout_snes_time = .0;
 
-  prefunc = nullptr;
   jacfunc = nullptr;
 
   output_flag = PETSC_FALSE;
@@ -102,6 +101,8 @@ int PetscSolver::init(int NOUT, BoutReal TIMESTEP) {
   int             neq;
   int             mudq, mldq, mukeep, mlkeep;
   bool            use_precon, use_jacobian;
+  bool            ksp_recycle, reuse_preconditioner;
+  int             ksp_recycle_dim, ksp_gmres_restart;
   int             precon_dimens;
   BoutReal        precon_tol;
   MPI_Comm        comm = PETSC_COMM_WORLD;
@@ -298,9 +299,36 @@ int PetscSolver::init(int NOUT, BoutReal TIMESTEP) {
 
   ierr = KSPSetTolerances(ksp, reltol, abstol, PETSC_DEFAULT, PETSC_DEFAULT); CHKERRQ(ierr);
 
+  // Krylov subspace recycling. Across Newton iterations and timesteps
+  // the linear systems change slowly, so information from earlier
+  // solves is worth keeping: LGMRES augments each restart cycle with
+  // approximate error vectors from the previous cycle, and since the
+  // KSP object persists for the whole run the augmented space carries
+  // over between solves. Can still be overridden on the command line
+  // (e.g. -ksp_type) since TSSetFromOptions is called below
+  OPTION(options, ksp_recycle, false);
+  OPTION(options, ksp_recycle_dim, 4);
+  OPTION(options, ksp_gmres_restart, 30);
+  if (ksp_recycle) {
+    ierr = KSPSetType(ksp, KSPLGMRES);CHKERRQ(ierr);
+    ierr = KSPGMRESSetRestart(ksp, ksp_gmres_restart);CHKERRQ(ierr);
+    ierr = KSPLGMRESSetAugDim(ksp, ksp_recycle_dim);CHKERRQ(ierr);
+  }
+
+  // When the operator is lagged, the preconditioner setup doesn't
+  // need rebuilding between Newton iterations either
+  OPTION(options, reuse_preconditioner, false);
+  if (reuse_preconditioner) {
+#if PETSC_VERSION_GE(3,5,0)
+    ierr = KSPSetReusePreconditioner(ksp, PETSC_TRUE);CHKERRQ(ierr);
+#else
+    output_warn.write("\treuse_preconditioner requires PETSc >= 3.5; ignored\n");
+#endif
+  }
+
   ierr = KSPGetPC(ksp,&pc);CHKERRQ(ierr);
 
-  if(use_precon && (prefunc != nullptr)) {
+  if(use_precon && have_user_precon()) {
 
 #if PETSC_VERSION_GE(3,5,0)
     ierr = SNESGetNPC(snes,&psnes);CHKERRQ(ierr);
@@ -572,7 +600,7 @@ PetscErrorCode PetscSolver::pre(PC UNUSED(pc), Vec x, Vec y) {
   VecRestoreArray(x, &data);
 
   // Call the preconditioner
-  (*prefunc)(ts_time, 1./shift, 0.0);
+  run_precon(ts_time, 1./shift, 0.0);
 
   // Save the solution from time derivatives
   VecGetArray(y, &data);
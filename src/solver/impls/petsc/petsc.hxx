@@ -84,7 +84,6 @@ public:
   ~PetscSolver();
 
   // Can be called from physics initialisation to supply callbacks
-  void setPrecon(PhysicsPrecon f) { prefunc = f; }
   void setJacobian(Jacobian j) override { jacfunc = j; }
 
   int init(int NOUT, BoutReal TIMESTEP) override;
@@ -114,8 +113,7 @@ public:
   PetscLogEvent solver_event, loop_event, init_event;
 
 private:
-  PhysicsPrecon prefunc; ///< Preconditioner
-  Jacobian jacfunc;      ///< Jacobian - vector function
+  Jacobian jacfunc; ///< Jacobian - vector function
 
   BoutReal shift; ///< Shift (alpha) parameter from TS
   Vec state;
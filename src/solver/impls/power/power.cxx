@@ -35,7 +35,7 @@ int PowerSolver::init(int nout, BoutReal tstep) {
 	       n3Dvars(), n2Dvars(), nglobal, nlocal);
   
   // Allocate memory
-  f0 = Array<BoutReal>(nlocal);
+  f0 = Array<double>(nlocal);
 
   // Save the eigenvalue to the output
   dump.add(eigenvalue, "eigenvalue", true);
@@ -79,8 +79,8 @@ int PowerSolver::run() {
   return 0;
 }
 
-BoutReal PowerSolver::norm(Array<BoutReal> &state) {
-  BoutReal total = 0.0, result;
+BoutReal PowerSolver::norm(Array<double> &state) {
+  double total = 0.0, result;
   
   for(int i=0;i<nlocal;i++)
     total += state[i]*state[i];
@@ -92,7 +92,7 @@ BoutReal PowerSolver::norm(Array<BoutReal> &state) {
   return sqrt(result);
 }
 
-void PowerSolver::divide(Array<BoutReal> &in, BoutReal value) {
+void PowerSolver::divide(Array<double> &in, BoutReal value) {
   for(int i=0;i<nlocal;i++)
     in[i] /= value;
 }
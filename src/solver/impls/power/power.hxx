@@ -55,12 +55,12 @@ class PowerSolver : public Solver {
   BoutReal eigenvalue;
 
   int nlocal, nglobal; // Number of variables
-  Array<BoutReal> f0;  // The system state
+  Array<double> f0;  // The system state
   
   int nsteps; // Number of output steps
   
-  BoutReal norm(Array<BoutReal> &state);
-  void divide(Array<BoutReal> &in, BoutReal value);
+  BoutReal norm(Array<double> &state);
+  void divide(Array<double> &in, BoutReal value);
 };
 
 #endif // __KARNIADAKIS_SOLVER_H__
@@ -2,6 +2,8 @@
 #include "rk3-ssp.hxx"
 
 #include <boutcomm.hxx>
+#include <globals.hxx>
+#include <bout/mesh.hxx>
 #include <utils.hxx>
 #include <boutexception.hxx>
 #include <msg_stack.hxx>
@@ -13,9 +15,18 @@
 RK3SSP::RK3SSP(Options *opt) : Solver(opt) {}
 
 void RK3SSP::setMaxTimestep(BoutReal dt) {
+  if (adaptive) {
+    // Collected during the RHS evaluations of the current step: the
+    // model signals its CFL limit (e.g. from the fastest wave speed)
+    // and the controller caps the next timestep at it
+    if (dt < dt_lim)
+      dt_lim = dt;
+    return;
+  }
+
   if(dt > timestep)
     return; // Already less than this
-  
+
   timestep = dt; // Won't be used this time, but next
 }
 
@@ -47,13 +58,13 @@ int RK3SSP::init(int nout, BoutReal tstep) {
 	       n3Dvars(), n2Dvars(), neq, nlocal);
   
   // Allocate memory
-  f = Array<BoutReal>(nlocal);
+  f = Array<double>(nlocal);
 
   // memory for taking a single time step
-  u1 = Array<BoutReal>(nlocal);
-  u2 = Array<BoutReal>(nlocal);
-  u3 = Array<BoutReal>(nlocal);
-  L = Array<BoutReal>(nlocal);
+  u1 = Array<double>(nlocal);
+  u2 = Array<double>(nlocal);
+  u3 = Array<double>(nlocal);
+  L = Array<double>(nlocal);
 
   // Put starting values into f
   save_vars(std::begin(f));
@@ -63,6 +74,20 @@ int RK3SSP::init(int nout, BoutReal tstep) {
   OPTION(options, timestep, max_timestep); // Starting timestep
   OPTION(options, mxstep, 500); // Maximum number of steps between outputs
 
+  OPTION(options, adaptive, false); // Adapt the timestep?
+  OPTION(options, atol, 1.e-5); // Absolute tolerance
+  OPTION(options, rtol, 1.e-3); // Relative tolerance
+  OPTION(options, cfl_factor, 2.); // Safety factor on the model's CFL limit
+
+  // Communication-avoiding stepping: publish the sub-stage index
+  // through Mesh::setCommAvoidStage so a cooperating model can
+  // exchange halos deep enough for all three stages once, at stage 0,
+  // and evaluate later stages over Mesh::getRegionShrunk3D with no
+  // further communication. Requires guard cells at least three
+  // stencil widths wide; the model's RHS must opt in, so the default
+  // leaves the stage fixed at 0
+  OPTION(options, comm_avoiding, false);
+
   return 0;
 }
 
@@ -74,21 +99,86 @@ int RK3SSP::run() {
     
     BoutReal dt;
     bool running = true;
+    int internal_steps = 0;
     do {
       // Take a single time step
-      
-      dt = timestep;
-      running = true;
-      if((simtime + dt) >= target) {
-        dt = target - simtime; // Make sure the last timestep is on the output 
-        running = false;
+
+      do {
+        dt = timestep;
+        running = true;
+        if((simtime + dt) >= target) {
+          dt = target - simtime; // Make sure the last timestep is on the output
+          running = false;
+        }
+
+        if (adaptive) {
+          dt_lim = max_timestep; // Collect CFL limits from the model's
+                                 // setMaxTimestep calls during the RHS
+
+          take_step(simtime, dt, f, u3);
+
+          // Embedded 2nd-order (SSP RK2 / Heun) solution from the
+          // stages already computed: the second stage gives
+          // dt*L(u1) = 4*u2 - 3*f - u1, so the Heun result is
+          // 0.5*(f + u1 + dt*L(u1)) = 2*u2 - f. Its difference to the
+          // 3rd-order result estimates the local error with no extra
+          // RHS evaluations
+          double local_err = 0.;
+          BOUT_OMP(parallel for reduction(+: local_err))
+          for(int i=0;i<nlocal;i++) {
+            const BoutReal f_emb = 2.*u2[i] - f[i];
+            local_err += fabs(u3[i] - f_emb) / ( fabs(u3[i]) + fabs(f_emb) + atol );
+          }
+
+          // Average over all processors
+          double err;
+          if(MPI_Allreduce(&local_err, &err, 1, MPI_DOUBLE, MPI_SUM, BoutComm::get())) {
+            throw BoutException("MPI_Allreduce failed");
+          }
+          err /= static_cast<BoutReal>(neq);
+
+          // The model's CFL limit must hold on every processor
+          BoutReal dt_cfl;
+          if(MPI_Allreduce(&dt_lim, &dt_cfl, 1, MPI_DOUBLE, MPI_MIN, BoutComm::get())) {
+            throw BoutException("MPI_Allreduce failed");
+          }
+
+          internal_steps++;
+          if(internal_steps > mxstep)
+            throw BoutException("ERROR: MXSTEP exceeded. timestep = %e, err=%e\n", timestep, err);
+
+          if((err > rtol) || (err < 0.1*rtol)) {
+            // Need to change timestep. Error ~ dt^3
+            timestep = dt / pow(err / (0.5*rtol), 1./3.);
+          }
+          // Track the stability boundary signalled by the model
+          if(timestep > dt_cfl / cfl_factor)
+            timestep = dt_cfl / cfl_factor;
+          if((max_timestep > 0) && (timestep > max_timestep))
+            timestep = max_timestep;
+
+          if(err < rtol) {
+            break; // Acceptable accuracy
+          }
+          stats.nfailed++; // Repeating the step with a smaller timestep
+        }else {
+          // No adaptive timestepping
+          output.write("t = %e, dt = %e\n", simtime, dt);
+          take_step(simtime, dt, f, f);
+          break;
+        }
+      }while(true);
+
+      if (adaptive) {
+        // Accepted step: the result becomes the new state
+        swap(f, u3);
       }
-      output.write("t = %e, dt = %e\n", simtime, dt);
-      // No adaptive timestepping for now
-      take_step(simtime, dt, f, f);
-      
+
       simtime += dt;
-      
+
+      stats.nsteps++;
+      stats.last_dt = dt;
+
       call_timestep_monitors(simtime, dt);
     }while(running);
 
@@ -109,10 +199,12 @@ int RK3SSP::run() {
   return 0;
 }
 
-void RK3SSP::take_step(BoutReal curtime, BoutReal dt, Array<BoutReal> &start,
-                       Array<BoutReal> &result) {
+void RK3SSP::take_step(BoutReal curtime, BoutReal dt, Array<double> &start,
+                       Array<double> &result) {
 
   load_vars(std::begin(start));
+  if (comm_avoiding)
+    mesh->setCommAvoidStage(0); // Full-depth halo exchange here
   run_rhs(curtime);
   save_derivs(std::begin(L));
 
@@ -121,6 +213,8 @@ void RK3SSP::take_step(BoutReal curtime, BoutReal dt, Array<BoutReal> &start,
     u1[i] = start[i] + dt*L[i];
 
   load_vars(std::begin(u1));
+  if (comm_avoiding)
+    mesh->setCommAvoidStage(1); // Halo data from stage 0 still one width deep
   run_rhs(curtime + dt);
   save_derivs(std::begin(L));
 
@@ -129,8 +223,12 @@ void RK3SSP::take_step(BoutReal curtime, BoutReal dt, Array<BoutReal> &start,
     u2[i] = 0.75*start[i] + 0.25*u1[i] + 0.25*dt*L[i];
 
   load_vars(std::begin(u2));
+  if (comm_avoiding)
+    mesh->setCommAvoidStage(2);
   run_rhs(curtime + 0.5*dt);
   save_derivs(std::begin(L));
+  if (comm_avoiding)
+    mesh->setCommAvoidStage(0); // Monitors and output RHS calls see stage 0
 
   BOUT_OMP(parallel for)
   for(int i=0;i<nlocal;i++)
@@ -61,8 +61,15 @@ class RK3SSP : public Solver {
 
   BoutReal max_timestep; // Maximum timestep
   int mxstep; // Maximum number of internal steps between outputs
-  
-  Array<BoutReal> f;
+
+  bool adaptive;     // Adapt the timestep using the embedded error estimate?
+  bool comm_avoiding; // Tell the model which sub-stage is being evaluated,
+                      // so it can exchange deep halos once per step
+  BoutReal atol, rtol; // Absolute and relative tolerances
+  BoutReal cfl_factor; // Factor by which the model's CFL limit is divided
+  BoutReal dt_lim;   // Smallest setMaxTimestep request during the current step
+
+  Array<double> f;
   
   BoutReal out_timestep; // The output timestep
   int nsteps; // Number of output steps
@@ -72,9 +79,9 @@ class RK3SSP : public Solver {
   int nlocal, neq; // Number of variables on local processor and in total
   
   void take_step(BoutReal curtime, BoutReal dt, 
-                 Array<BoutReal> &start, Array<BoutReal> &result); // Take a single step to calculate f1
+                 Array<double> &start, Array<double> &result); // Take a single step to calculate f1
   
-  Array<BoutReal> u1, u2, u3, L; // Time-stepping arrays
+  Array<double> u1, u2, u3, L; // Time-stepping arrays
   
 };
 
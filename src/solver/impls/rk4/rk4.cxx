@@ -52,16 +52,17 @@ int RK4Solver::init(int nout, BoutReal tstep) {
 	       n3Dvars(), n2Dvars(), neq, nlocal);
   
   // Allocate memory
-  f0 = Array<BoutReal>(nlocal);
-  f1 = Array<BoutReal>(nlocal);
-  f2 = Array<BoutReal>(nlocal);
+  f0 = Array<double>(nlocal);
+  f1 = Array<double>(nlocal);
+  f2 = Array<double>(nlocal);
 
   // memory for taking a single time step
-  k1 = Array<BoutReal>(nlocal);
-  k2 = Array<BoutReal>(nlocal);
-  k3 = Array<BoutReal>(nlocal);
-  k4 = Array<BoutReal>(nlocal);
-  k5 = Array<BoutReal>(nlocal);
+  k0 = Array<double>(nlocal);
+  k1 = Array<double>(nlocal);
+  k2 = Array<double>(nlocal);
+  k3 = Array<double>(nlocal);
+  k4 = Array<double>(nlocal);
+  k5 = Array<double>(nlocal);
 
   // Put starting values into f0
   save_vars(std::begin(f0));
@@ -97,22 +98,28 @@ int RK4Solver::run() {
           running = false;
         }
         if(adaptive) {
+          // The first half-step and the full step both start from f0
+          // at simtime, so the first RHS evaluation is shared
+          load_vars(std::begin(f0));
+          run_rhs(simtime);
+          save_derivs(std::begin(k0));
+
           // Take two half-steps
-          take_step(simtime,          0.5*dt, f0, f1);
+          take_step_from(simtime,     0.5*dt, f0, k0, f1);
           take_step(simtime + 0.5*dt, 0.5*dt, f1, f2);
-          
+
           // Take a full step
-          take_step(simtime, dt, f0, f1);
+          take_step_from(simtime, dt, f0, k0, f1);
           
           // Check accuracy
-          BoutReal local_err = 0.;
+          double local_err = 0.;
           BOUT_OMP(parallel for reduction(+: local_err)   )
           for(int i=0;i<nlocal;i++) {
             local_err += fabs(f2[i] - f1[i]) / ( fabs(f1[i]) + fabs(f2[i]) + atol );
           }
         
           // Average over all processors
-          BoutReal err;
+          double err;
           if(MPI_Allreduce(&local_err, &err, 1, MPI_DOUBLE, MPI_SUM, BoutComm::get())) {
             throw BoutException("MPI_Allreduce failed");
           }
@@ -133,6 +140,7 @@ int RK4Solver::run() {
           if(err < rtol) {
             break; // Acceptable accuracy
           }
+          stats.nfailed++; // Repeating the step with a smaller timestep
         }else {
           // No adaptive timestepping
           take_step(simtime, dt, f0, f2);
@@ -143,7 +151,10 @@ int RK4Solver::run() {
       // Taken a step, swap buffers
       swap(f2, f0);
       simtime += dt;
-      
+
+      stats.nsteps++;
+      stats.last_dt = dt;
+
       call_timestep_monitors(simtime, dt);
     }while(running);
 
@@ -173,16 +184,23 @@ void RK4Solver::resetInternalFields(){
   save_vars(std::begin(f0));
 }
 
-void RK4Solver::take_step(BoutReal curtime, BoutReal dt, Array<BoutReal> &start,
-                          Array<BoutReal> &result) {
+void RK4Solver::take_step(BoutReal curtime, BoutReal dt, Array<double> &start,
+                          Array<double> &result) {
 
   load_vars(std::begin(start));
   run_rhs(curtime);
   save_derivs(std::begin(k1));
 
+  take_step_from(curtime, dt, start, k1, result);
+}
+
+void RK4Solver::take_step_from(BoutReal curtime, BoutReal dt, Array<double> &start,
+                               const Array<double> &dydt_start,
+                               Array<double> &result) {
+
   BOUT_OMP(parallel for)
   for(int i=0;i<nlocal;i++)
-    k5[i] = start[i] + 0.5*dt*k1[i];
+    k5[i] = start[i] + 0.5*dt*dydt_start[i];
 
   load_vars(std::begin(k5));
   run_rhs(curtime + 0.5*dt);
@@ -206,5 +224,5 @@ void RK4Solver::take_step(BoutReal curtime, BoutReal dt, Array<BoutReal> &start,
 
   BOUT_OMP(parallel for)
   for(int i=0;i<nlocal;i++)
-    result[i] = start[i] + (1./6.)*dt*(k1[i] + 2.*k2[i] + 2.*k3[i] + k4[i]);
+    result[i] = start[i] + (1./6.)*dt*(dydt_start[i] + 2.*k2[i] + 2.*k3[i] + k4[i]);
 }
@@ -57,7 +57,7 @@ class RK4Solver : public Solver {
   BoutReal max_timestep; // Maximum timestep
   int mxstep; // Maximum number of internal steps between outputs
   
-  Array<BoutReal> f0, f1, f2;
+  Array<double> f0, f1, f2;
   
   BoutReal out_timestep; // The output timestep
   int nsteps; // Number of output steps
@@ -68,10 +68,17 @@ class RK4Solver : public Solver {
 
   int nlocal, neq; // Number of variables on local processor and in total
   
-  void take_step(BoutReal curtime, BoutReal dt, 
-                 Array<BoutReal> &start, Array<BoutReal> &result); // Take a single step to calculate f1
-  
-  Array<BoutReal> k1, k2, k3, k4, k5; // Time-stepping arrays
+  void take_step(BoutReal curtime, BoutReal dt,
+                 Array<double> &start, Array<double> &result); // Take a single step to calculate f1
+
+  /// Take a single step, re-using the already calculated time
+  /// derivative \p dydt_start at the starting state. Used in adaptive
+  /// mode to share the first RHS evaluation between the half and full
+  /// steps, which start from the same state.
+  void take_step_from(BoutReal curtime, BoutReal dt, Array<double> &start,
+                      const Array<double> &dydt_start, Array<double> &result);
+
+  Array<double> k0, k1, k2, k3, k4, k5; // Time-stepping arrays
   
 };
 
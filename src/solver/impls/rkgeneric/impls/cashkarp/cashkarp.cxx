@@ -11,9 +11,9 @@ CASHKARPScheme::CASHKARPScheme(Options *options):RKScheme(options){
   OPTION(options, followHighOrder, followHighOrder);
 
   //Allocate coefficient arrays
-  stageCoeffs = Matrix<BoutReal>(numStages, numStages);
-  resultCoeffs = Matrix<BoutReal>(numStages, numOrders);
-  timeCoeffs = Array<BoutReal>(numStages);
+  stageCoeffs = Matrix<double>(numStages, numStages);
+  resultCoeffs = Matrix<double>(numStages, numOrders);
+  timeCoeffs = Array<double>(numStages);
 
   //Zero out arrays (shouldn't be needed, but do for testing)
   for(int i=0;i<numStages;i++){
@@ -11,9 +11,9 @@ RK4SIMPLEScheme::RK4SIMPLEScheme(Options *options):RKScheme(options){
   OPTION(options, followHighOrder, followHighOrder);
 
   //Allocate coefficient arrays
-  stageCoeffs = Matrix<BoutReal>(numStages, numStages);
-  resultCoeffs = Matrix<BoutReal>(numStages, numOrders);
-  timeCoeffs = Array<BoutReal>(numStages);
+  stageCoeffs = Matrix<double>(numStages, numStages);
+  resultCoeffs = Matrix<double>(numStages, numOrders);
+  timeCoeffs = Array<double>(numStages);
 
   //Zero out arrays (shouldn't be needed, but do for testing)
   for(int i=0;i<numStages;i++){
@@ -114,8 +114,8 @@ RK4SIMPLEScheme::~RK4SIMPLEScheme(){
   
 }
 
-BoutReal RK4SIMPLEScheme::setOutputStates(const Array<BoutReal> &start, const BoutReal dt,
-                                          Array<BoutReal> &resultFollow) {
+BoutReal RK4SIMPLEScheme::setOutputStates(const Array<double> &start, const BoutReal dt,
+                                          Array<double> &resultFollow) {
   //return RKScheme::setOutputStates(start,dt,resultFollow);
   if(followHighOrder){
     for(int i=0;i<nlocal;i++){
@@ -66,9 +66,9 @@ int RKGenericSolver::init(int nout, BoutReal tstep) {
   OPTION(options, adaptive, true); // Prefer adaptive scheme
 
   // Allocate memory
-  f0 = Array<BoutReal>(nlocal); // Input
-  f2 = Array<BoutReal>(nlocal); // Result--follow order
-  tmpState = Array<BoutReal>(nlocal);
+  f0 = Array<double>(nlocal); // Input
+  f2 = Array<double>(nlocal); // Result--follow order
+  tmpState = Array<double>(nlocal);
 
   // Put starting values into f0
   save_vars(std::begin(f0));
@@ -170,8 +170,8 @@ int RKGenericSolver::run() {
 
 //Returns the evolved state vector along with an error estimate
 BoutReal RKGenericSolver::take_step(const BoutReal timeIn, const BoutReal dt,
-                                    const Array<BoutReal> &start,
-                                    Array<BoutReal> &resultFollow) {
+                                    const Array<double> &start,
+                                    Array<double> &resultFollow) {
 
   //Calculate the intermediate stages
   for(int curStage=0;curStage<scheme->getStageCount();curStage++){
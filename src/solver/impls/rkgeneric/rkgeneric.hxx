@@ -58,11 +58,11 @@ class RKGenericSolver : public Solver {
 
  private:
   //Take a step using the scheme
-  BoutReal take_step(BoutReal timeIn,BoutReal dt, const Array<BoutReal> &start, 
-		     Array<BoutReal> &resultFollow);
+  BoutReal take_step(BoutReal timeIn,BoutReal dt, const Array<double> &start, 
+		     Array<double> &resultFollow);
 
   //Used for storing current state and next step
-  Array<BoutReal> f0, f2, tmpState;
+  Array<double> f0, f2, tmpState;
 
   //Inputs
   BoutReal atol, rtol;   // Tolerances for adaptive timestepping
@@ -37,12 +37,18 @@ void RKScheme::init(const int nlocalIn, const int neqIn, const bool adaptiveIn,
   adaptive = adaptiveIn;
 
   //Allocate storage for stages
-  steps = Matrix<BoutReal>(getStageCount(), nlocal);
+  steps = Matrix<double>(getStageCount(), nlocal);
   zeroSteps();
 
   //Allocate array for storing alternative order result
   if (adaptive)
-    resultAlt = Array<BoutReal>(nlocal); // Result--alternative order
+    resultAlt = Array<double>(nlocal); // Result--alternative order
+
+  //Scratch space for gathering the non-zero stage contributions, so
+  //states can be constructed in a single pass over the data
+  curFacs = Array<double>(getStageCount());
+  curFacsAlt = Array<double>(getStageCount());
+  curRows.resize(getStageCount());
 
   //Will probably only want the following when debugging, but leave it on for now
   if(diagnose){
@@ -57,34 +63,34 @@ BoutReal RKScheme::setCurTime(const BoutReal timeIn, const BoutReal dt, const in
 }
 
 //Get the state vector at given stage
-void RKScheme::setCurState(const Array<BoutReal> &start, Array<BoutReal> &out,
+void RKScheme::setCurState(const Array<double> &start, Array<double> &out,
                            const int curStage, const BoutReal dt) {
 
-  //Set the initial stage
-  BOUT_OMP(parallel for)
-  for(int i=0;i<nlocal;i++){
-    out[i] = start[i];
-  }
-
-  //If on the first stage we don't need to modify the state
-  if(curStage==0) return;//Don't realy need this as below loop won't execute
-  
-  //Construct the current state from previous results -- This is expensive
+  //Gather the non-zero contributions from the previous stages, so the
+  //state can be constructed in a single pass over the data rather than
+  //one axpy-style pass per previous stage
+  int nterms = 0;
   for(int j=0;j<curStage;j++){
     if (abs(stageCoeffs(curStage, j)) < atol)
       continue;
-    BoutReal fac = stageCoeffs(curStage, j) * dt;
+    curFacs[nterms] = stageCoeffs(curStage, j) * dt;
+    curRows[nterms] = &steps(j, 0);
+    nterms++;
+  }
 
-    BOUT_OMP(parallel for)
-    for(int i=0;i<nlocal;i++){
-      out[i] = out[i] + fac * steps(j, i);
+  BOUT_OMP(parallel for)
+  for(int i=0;i<nlocal;i++){
+    BoutReal val = start[i];
+    for(int j=0;j<nterms;j++){
+      val += curFacs[j] * curRows[j][i];
     }
+    out[i] = val;
   }
 }
 
 //Construct the system state at the next time
-BoutReal RKScheme::setOutputStates(const Array<BoutReal> &start, const BoutReal dt,
-                                   Array<BoutReal> &resultFollow) {
+BoutReal RKScheme::setOutputStates(const Array<double> &start, const BoutReal dt,
+                                   Array<double> &resultFollow) {
   //Only really need resultAlt in order to calculate the error, so if not adaptive could avoid it
   //*and* technically we can write resultFollow-resultAlt in terms of resultCoeffs and steps.
 
@@ -95,25 +101,12 @@ BoutReal RKScheme::setOutputStates(const Array<BoutReal> &start, const BoutReal
     followInd=1; altInd=0;
   }
 
-  //NOTE: It's slightly slower to split construction of output
-  //      into two separate loops as we're doing below *when*
-  //      we want both solutions, but it's faster when not adaptive.
-  //      To get the best of both worlds we could probably do something
-  //      like:
-  /*      
-	  if(adapative){
-	    constructOutputs;
-	  }else{
-            constructOutput;
-	  }
-   */
-
-  //Get the result
-  constructOutput(start,dt,followInd,resultFollow);
-
-  //If adaptive get the second state
   if(adaptive){
-    constructOutput(start, dt, altInd, resultAlt);
+    //Construct both solutions with a single pass through the stages
+    constructOutputs(start, dt, followInd, altInd, resultFollow, resultAlt);
+  }else{
+    //Only need the followed solution
+    constructOutput(start, dt, followInd, resultFollow);
   }
 
   //Get the error coefficient
@@ -129,14 +122,14 @@ BoutReal RKScheme::updateTimestep(const BoutReal dt, const BoutReal err){
 ////////////////////
 
 //Estimate the error, given two solutions
-BoutReal RKScheme::getErr(Array<BoutReal> &solA, Array<BoutReal> &solB) {
-  BoutReal err=0.;
+BoutReal RKScheme::getErr(Array<double> &solA, Array<double> &solB) {
+  double err = 0.;
 
   //If not adaptive don't care about the error
   if(!adaptive){return err;}
 
   //Get local part of relative error
-  BoutReal local_err = 0.;
+  double local_err = 0.;
 
   // Note because the order of operation is not deterministic
   // we expect slightly different round-off error each time this
@@ -157,48 +150,58 @@ BoutReal RKScheme::getErr(Array<BoutReal> &solA, Array<BoutReal> &solB) {
   return err;
 }
 
-void RKScheme::constructOutput(const Array<BoutReal> &start, const BoutReal dt,
-                               const int index, Array<BoutReal> &sol) {
-  //Initialise the return data
-  BOUT_OMP(parallel for)
-  for(int i=0;i<nlocal;i++){
-    sol[i]=start[i];
-  }
-
-  //Construct the solution
+void RKScheme::constructOutput(const Array<double> &start, const BoutReal dt,
+                               const int index, Array<double> &sol) {
+  //Gather the non-zero stage contributions
+  int nterms = 0;
   for(int curStage=0;curStage<getStageCount();curStage++){
     if (resultCoeffs(curStage, index) == 0.)
       continue; // Real comparison not great
-    BoutReal fac = dt * resultCoeffs(curStage, index);
-    BOUT_OMP(parallel for)
-    for(int i=0;i<nlocal;i++){
-      sol[i] = sol[i] + fac * steps(curStage, i);
-    }
+    curFacs[nterms] = dt * resultCoeffs(curStage, index);
+    curRows[nterms] = &steps(curStage, 0);
+    nterms++;
   }
-  
-}
 
-void RKScheme::constructOutputs(const Array<BoutReal> &start, const BoutReal dt,
-                                const int indexFollow, const int indexAlt,
-                                Array<BoutReal> &solFollow, Array<BoutReal> &solAlt) {
-  //Initialise the return data
+  //Construct the solution in a single pass over the data
   BOUT_OMP(parallel for)
   for(int i=0;i<nlocal;i++){
-    solFollow[i]=start[i];
-    solAlt[i]=start[i];
+    BoutReal val = start[i];
+    for(int j=0;j<nterms;j++){
+      val += curFacs[j] * curRows[j][i];
+    }
+    sol[i] = val;
   }
+}
 
-  //Construct the solution
+void RKScheme::constructOutputs(const Array<double> &start, const BoutReal dt,
+                                const int indexFollow, const int indexAlt,
+                                Array<double> &solFollow, Array<double> &solAlt) {
+  //Gather the stage contributions to both solutions, skipping stages
+  //which contribute to neither
+  int nterms = 0;
   for(int curStage=0;curStage<getStageCount();curStage++){
-    BoutReal facFol = dt * resultCoeffs(curStage, indexFollow);
-    BoutReal facAlt = dt * resultCoeffs(curStage, indexAlt);
-    BOUT_OMP(parallel for)
-    for(int i=0;i<nlocal;i++){
-      solFollow[i] = solFollow[i] + facFol * steps(curStage, i);
-      solAlt[i] = solAlt[i] + facAlt * steps(curStage, i);
+    if ((resultCoeffs(curStage, indexFollow) == 0.) &&
+        (resultCoeffs(curStage, indexAlt) == 0.))
+      continue;
+    curFacs[nterms] = dt * resultCoeffs(curStage, indexFollow);
+    curFacsAlt[nterms] = dt * resultCoeffs(curStage, indexAlt);
+    curRows[nterms] = &steps(curStage, 0);
+    nterms++;
+  }
+
+  //Construct both solutions in a single pass over the data, so each
+  //stage is only read from memory once
+  BOUT_OMP(parallel for)
+  for(int i=0;i<nlocal;i++){
+    BoutReal valFollow = start[i];
+    BoutReal valAlt = start[i];
+    for(int j=0;j<nterms;j++){
+      valFollow += curFacs[j] * curRows[j][i];
+      valAlt += curFacsAlt[j] * curRows[j][i];
     }
+    solFollow[i] = valFollow;
+    solAlt[i] = valAlt;
   }
-  
 }
 
 //Check that the coefficients are consistent
@@ -262,8 +262,8 @@ int SlepcSolver::init(int NOUT, BoutReal TIMESTEP) {
   //Also create vector for derivs etc. if SLEPc in charge of solving
   if(selfSolve && !ddtMode){
     // Allocate memory
-    f0 = Array<BoutReal>(localSize);
-    f1 = Array<BoutReal>(localSize);
+    f0 = Array<double>(localSize);
+    f1 = Array<double>(localSize);
   }
 
   // Get total problem size
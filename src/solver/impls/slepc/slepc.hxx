@@ -227,7 +227,7 @@ private:
   bool eigenValOnly;
 
   // For selfSolve=true
-  Array<BoutReal> f0, f1;
+  Array<double> f0, f1;
 
   // Timestep details
   int nout;
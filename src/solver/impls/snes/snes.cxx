@@ -13,6 +13,7 @@
 #include <output.hxx>
 
 #include "petscsnes.h"
+#include "petscmat.h"
 
 /*
  * PETSc callback function, which evaluates the nonlinear
@@ -25,6 +26,49 @@ static PetscErrorCode FormFunction(SNES UNUSED(snes), Vec x, Vec f, void *ctx) {
   return static_cast<SNESSolver*>(ctx)->snes_function(x, f);
 }
 
+/*
+ * PETSc callback for forming the preconditioner Jacobian with coloring.
+ */
+static PetscErrorCode FormFunctionForColoring(SNES UNUSED(snes), Vec x, Vec f,
+                                              void *ctx) {
+  return static_cast<SNESSolver *>(ctx)->snes_function(x, f);
+}
+
+/*
+ * PETSc callback applying the shell Jacobian: a matrix-free
+ * Jacobian-vector product by differencing
+ */
+static PetscErrorCode snesJacobianMult(Mat J, Vec v, Vec Jv) {
+  void *ctx;
+  int ierr = MatShellGetContext(J, &ctx);CHKERRQ(ierr);
+
+  return static_cast<SNESSolver *>(ctx)->jacobian_mult(v, Jv);
+}
+
+/*
+ * PETSc callback for assembling the shell Jacobian. The shell takes
+ * its base state and residual from the SNES at multiply time, so
+ * there is nothing to compute here
+ */
+static PetscErrorCode snesJacobianShell(SNES UNUSED(snes), Vec UNUSED(x),
+                                        Mat UNUSED(J), Mat UNUSED(Jpre),
+                                        void *UNUSED(ctx)) {
+  return 0;
+}
+
+/*
+ * PETSc callback function for applying the user-supplied preconditioner
+ */
+static PetscErrorCode snesPCapply(PC pc, Vec x, Vec y) {
+  int ierr;
+
+  // Get the context
+  SNESSolver *s;
+  ierr = PCShellGetContext(pc, (void**) &s);CHKERRQ(ierr);
+
+  PetscFunctionReturn(s->precon(x, y));
+}
+
 int SNESSolver::init(int nout, BoutReal tstep) {
 
   TRACE("Initialising SNES solver");
@@ -74,30 +118,114 @@ int SNESSolver::init(int nout, BoutReal tstep) {
   SNESSetFunction(snes,snes_f,FormFunction,this);
   
   // Set up the Jacobian
-  //MatCreateSNESMF(snes,&Jmf);
-  //SNESSetJacobian(snes,Jmf,Jmf,SNESComputeJacobianDefault,this);
-  MatCreateAIJ(BoutComm::get(),
-               nlocal,nlocal,  // Local sizes
-               PETSC_DETERMINE, PETSC_DETERMINE, // Global sizes
-               3,   // Number of nonzero entries in diagonal portion of local submatrix
-               PETSC_NULL,
-               0,   // Number of nonzeros per row in off-diagonal portion of local submatrix
-               PETSC_NULL, 
-               &Jmf);
+  OPTION(options, matrix_free, true);
+  if(matrix_free) {
+    /*
+      Matrix-free: J*v products are approximated by differencing the
+      residual around the current SNES state, so the solver stores
+      O(N) vectors rather than the O(stencil * N) entries of an
+      assembled Jacobian. The perturbation of each variable is scaled
+      by its own field's amplitude (see updateScaling), and the
+      residual SNES has already evaluated at the current state is
+      reused as the base of the difference, so each product costs a
+      single function evaluation.
+     */
+    MatCreateShell(BoutComm::get(),
+                   nlocal, nlocal, // Local sizes
+                   PETSC_DETERMINE, PETSC_DETERMINE, // Global sizes
+                   this, &Jmf);
+    MatShellSetOperation(Jmf, MATOP_MULT,
+                         reinterpret_cast<void (*)(void)>(snesJacobianMult));
+
+    // Scaling and work vectors for the differencing
+    VecDuplicate(snes_x, &x_scale);
+    VecDuplicate(snes_x, &mf_work);
+
+    OPTION(options, mf_epsilon, 1e-8); // Relative size of the perturbations
+
+    bool use_coloring;
+    OPTION(options, use_coloring, false);
+    if(use_coloring) {
+      // Assemble an approximate Jacobian by finite-difference
+      // coloring, used only as the preconditioner matrix: the J*v
+      // products stay matrix-free. Recomputing it is expensive, so it
+      // is lagged over many Newton iterations
+      constructMatrixColoring();
+
 #if PETSC_VERSION_GE(3,4,0)
-  SNESSetJacobian(snes,Jmf,Jmf,SNESComputeJacobianDefault,this);
+      SNESSetJacobian(snes,Jmf,Jpc,SNESComputeJacobianDefaultColor,fdcoloring);
 #else
-  // Before 3.4
-  SNESSetJacobian(snes,Jmf,Jmf,SNESDefaultComputeJacobian,this);
+      // Before 3.4
+      SNESSetJacobian(snes,Jmf,Jpc,SNESDefaultComputeJacobianColor,fdcoloring);
 #endif
-  MatSetOption(Jmf,MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_FALSE);
+
+      int lag_jacobian;
+      OPTION(options, lag_jacobian, 10);
+      SNESSetLagJacobian(snes,lag_jacobian);
+    }else {
+      // No preconditioner matrix: nothing to assemble, and the
+      // Krylov method runs unpreconditioned (or with the
+      // user-supplied preconditioner, set below)
+      SNESSetJacobian(snes,Jmf,Jmf,snesJacobianShell,this);
+
+      KSP ksp;
+      SNESGetKSP(snes, &ksp);
+      PC pc;
+      KSPGetPC(ksp, &pc);
+      PCSetType(pc, PCNONE);
+    }
+  }else {
+    /*
+      Calculate the full Jacobian by finite differences.
+      NOTE: Slow, and the assembled matrix needs O(stencil * N) memory
+     */
+    MatCreateAIJ(BoutComm::get(),
+                 nlocal,nlocal,  // Local sizes
+                 PETSC_DETERMINE, PETSC_DETERMINE, // Global sizes
+                 3,   // Number of nonzero entries in diagonal portion of local submatrix
+                 PETSC_NULL,
+                 0,   // Number of nonzeros per row in off-diagonal portion of local submatrix
+                 PETSC_NULL,
+                 &Jmf);
+#if PETSC_VERSION_GE(3,4,0)
+    SNESSetJacobian(snes,Jmf,Jmf,SNESComputeJacobianDefault,this);
+#else
+    // Before 3.4
+    SNESSetJacobian(snes,Jmf,Jmf,SNESDefaultComputeJacobian,this);
+#endif
+    MatSetOption(Jmf,MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_FALSE);
+  }
 
   // Set tolerances
   BoutReal atol, rtol; // Tolerances for SNES solver
   options->get("atol", atol, 1e-16);
   options->get("rtol", rtol, 1e-10);
   SNESSetTolerances(snes,atol,rtol,PETSC_DEFAULT,PETSC_DEFAULT,PETSC_DEFAULT);
-  
+
+  // Preconditioner
+  bool use_precon;
+  OPTION(options, use_precon, false);
+
+  if(use_precon && have_user_precon()) {
+    output.write("\tUsing user-supplied preconditioner\n");
+
+    // Get KSP context from SNES
+    KSP ksp;
+    SNESGetKSP(snes, &ksp);
+
+    // Get PC context from KSP
+    PC pc;
+    KSPGetPC(ksp, &pc);
+
+    // Set a Shell (matrix-free) preconditioner type
+    PCSetType(pc, PCSHELL);
+
+    // Specify the preconditioner function
+    PCShellSetApply(pc, snesPCapply);
+    // Context used to supply object pointer
+    PCShellSetContext(pc, this);
+  }
+
   // Get runtime options
   SNESSetFromOptions(snes);
   
@@ -106,7 +234,13 @@ int SNESSolver::init(int nout, BoutReal tstep) {
 
 int SNESSolver::run() {
   TRACE("SNESSolver::run()");
-  
+
+  if(matrix_free) {
+    // Size the differencing perturbations by the amplitude each
+    // evolving field has in the initial state
+    updateScaling();
+  }
+
   /*
   output << "Computing Jacobian\n";
   MatStructure  flag;
@@ -167,7 +301,313 @@ PetscErrorCode SNESSolver::snes_function(Vec x, Vec f) {
   ierr = VecGetArray(f,&fdata);CHKERRQ(ierr);
   save_derivs(fdata);
   ierr = VecRestoreArray(f,&fdata);CHKERRQ(ierr);
-  
+
+  return 0;
+}
+
+/*
+ * Matrix-free Jacobian-vector product J*v by differencing
+ */
+PetscErrorCode SNESSolver::jacobian_mult(Vec v, Vec Jv) {
+  TRACE("SNESSolver::jacobian_mult");
+
+  int ierr;
+
+  // Base state and residual at the current SNES iterate. Reusing the
+  // residual SNES has already evaluated there makes each product cost
+  // a single function evaluation
+  Vec x;
+  Vec fx;
+  ierr = SNESGetSolution(snes, &x);CHKERRQ(ierr);
+  ierr = SNESGetFunction(snes, &fx, nullptr, nullptr);CHKERRQ(ierr);
+
+  // Weighted RMS norm of v, weighting each variable by the inverse of
+  // its field's amplitude, so the perturbation below changes every
+  // variable by about mf_epsilon of its own typical size rather than
+  // sizing the step from a single global norm
+  ierr = VecPointwiseDivide(mf_work, v, x_scale);CHKERRQ(ierr);
+  PetscReal wnorm;
+  ierr = VecNorm(mf_work, NORM_2, &wnorm);CHKERRQ(ierr);
+
+  if(wnorm == 0.0) {
+    // J * 0 = 0
+    ierr = VecSet(Jv, 0.0);CHKERRQ(ierr);
+    return 0;
+  }
+
+  const BoutReal epsilon = mf_epsilon * sqrt(static_cast<BoutReal>(neq)) / wnorm;
+
+  // Jv = (F(x + epsilon*v) - F(x)) / epsilon
+  ierr = VecWAXPY(mf_work, epsilon, v, x);CHKERRQ(ierr);
+  ierr = snes_function(mf_work, Jv);CHKERRQ(ierr);
+  ierr = VecAXPY(Jv, -1.0, fx);CHKERRQ(ierr);
+  ierr = VecScale(Jv, 1.0 / epsilon);CHKERRQ(ierr);
+
+  return 0;
+}
+
+/*
+ * Fill x_scale with the amplitude of each evolving field
+ */
+void SNESSolver::updateScaling() {
+  TRACE("SNESSolver::updateScaling");
+
+  int ierr;
+
+  // Amplitude of each field over the whole domain. A zero-initialised
+  // field gives no information, so assume an O(1) typical size as
+  // normalised variables have
+  for(const auto& f : f2d) {
+    BoutReal amp = BOUTMAX(fabs(max(*f.var, true)), fabs(min(*f.var, true)));
+    if(amp == 0.0)
+      amp = 1.0;
+    *f.var = amp;
+  }
+  for(const auto& f : f3d) {
+    BoutReal amp = BOUTMAX(fabs(max(*f.var, true)), fabs(min(*f.var, true)));
+    if(amp == 0.0)
+      amp = 1.0;
+    *f.var = amp;
+  }
+
+  // The fields now hold their scales, so save_vars interleaves them
+  // into the PETSc vector in exactly the state vector's layout
+  BoutReal *sdata;
+  ierr = VecGetArray(x_scale, &sdata);
+  if(ierr != 0)
+    throw BoutException("VecGetArray failed. Error code %d", ierr);
+  save_vars(sdata);
+  ierr = VecRestoreArray(x_scale, &sdata);
+  if(ierr != 0)
+    throw BoutException("VecRestoreArray failed. Error code %d", ierr);
+
+  // Restore the state into the fields
+  const BoutReal *xdata;
+  ierr = VecGetArrayRead(snes_x, &xdata);
+  if(ierr != 0)
+    throw BoutException("VecGetArrayRead failed. Error code %d", ierr);
+  load_vars(const_cast<BoutReal*>(xdata));
+  VecRestoreArrayRead(snes_x, &xdata);
+}
+
+/*
+ * Build the preconditioner matrix's sparsity pattern and the
+ * finite-difference coloring used to assemble it.
+ *
+ * Follows the IMEX-BDF2 solver: every variable at a point couples to
+ * every variable in the 5-point (x,y) star, and 3D fields also to the
+ * z neighbours, matching the coupling the differential operators
+ * produce.
+ */
+void SNESSolver::constructMatrixColoring() {
+  TRACE("SNESSolver::constructMatrixColoring");
+
+  // Get the local indices, starting at 0; boundary cells are < 0
+  Field3D index = globalIndex(0);
+
+  int n2d = f2d.size();
+  int n3d = f3d.size();
+
+  // Create the matrix with a uniform star-pattern preallocation.
+  // Rows on branch cuts and boundaries have fewer entries, so this
+  // overallocates slightly; allocation errors are disabled below so
+  // any underestimate only costs extra mallocs
+  MatCreate(BoutComm::get(), &Jpc);
+  MatSetSizes(Jpc, nlocal, nlocal, PETSC_DETERMINE, PETSC_DETERMINE);
+  MatSetFromOptions(Jpc);
+
+  PetscInt diagonal = (mesh->LocalNz > 1) ? 7*n3d + 5*n2d : 5*(n3d + n2d);
+  MatSeqAIJSetPreallocation(Jpc, diagonal, PETSC_NULL);
+  MatMPIAIJSetPreallocation(Jpc, diagonal, PETSC_NULL, 2*(n3d + n2d), PETSC_NULL);
+  MatSetUp(Jpc);
+  MatSetOption(Jpc, MAT_NEW_NONZERO_ALLOCATION_ERR, PETSC_FALSE);
+
+  // Determine which rows/columns of the matrix are locally owned
+  int Istart, Iend;
+  MatGetOwnershipRange(Jpc, &Istart, &Iend);
+
+  // Convert local into global indices
+  index += Istart;
+
+  // Now communicate to fill guard cells
+  mesh->communicate(index);
+
+  //////////////////////////////////////////////////
+  // Mark non-zero entries
+
+  // Offsets for a 5-point pattern
+  const int xoffset[5] = {0,-1, 1, 0, 0};
+  const int yoffset[5] = {0, 0, 0,-1, 1};
+
+  PetscScalar val = 1.0;
+
+  for(int x=mesh->xstart; x <= mesh->xend; x++) {
+    for(int y=mesh->ystart;y<=mesh->yend;y++) {
+
+      int ind0 = ROUND(index(x,y,0));
+
+      // 2D fields
+      for(int i=0;i<n2d;i++) {
+        PetscInt row = ind0 + i;
+
+        // Loop through each point in the 5-point stencil
+        for(int c=0;c<5;c++) {
+          int xi = x + xoffset[c];
+          int yi = y + yoffset[c];
+
+          if( (xi < 0) || (yi < 0) ||
+              (xi >= mesh->LocalNx) || (yi >= mesh->LocalNy) )
+            continue;
+
+          int ind2 = ROUND(index(xi, yi, 0));
+
+          if(ind2 < 0)
+            continue; // A boundary point
+
+          // Depends on all variables on this cell
+          for(int j=0;j<n2d;j++) {
+            PetscInt col = ind2 + j;
+            MatSetValues(Jpc, 1, &row, 1, &col, &val, INSERT_VALUES);
+          }
+        }
+      }
+
+      // 3D fields
+      for(int z=0;z<mesh->LocalNz;z++) {
+
+        int ind = ROUND(index(x,y,z));
+
+        for(int i=0;i<n3d;i++) {
+          PetscInt row = ind + i;
+          if(z == 0)
+            row += n2d;
+
+          // Depends on 2D fields
+          for(int j=0;j<n2d;j++) {
+            PetscInt col = ind0 + j;
+            MatSetValues(Jpc, 1, &row, 1, &col, &val, INSERT_VALUES);
+          }
+
+          // 5 point star pattern
+          for(int c=0;c<5;c++) {
+            int xi = x + xoffset[c];
+            int yi = y + yoffset[c];
+
+            if( (xi < 0) || (yi < 0) ||
+                (xi >= mesh->LocalNx) || (yi >= mesh->LocalNy) )
+              continue;
+
+            int ind2 = ROUND(index(xi, yi, z));
+            if(ind2 < 0)
+              continue; // Boundary point
+
+            if(z == 0)
+              ind2 += n2d;
+
+            // 3D fields on this cell
+            for(int j=0;j<n3d;j++) {
+              PetscInt col = ind2 + j;
+              MatSetValues(Jpc, 1, &row, 1, &col, &val, INSERT_VALUES);
+            }
+          }
+
+          int nz = mesh->LocalNz;
+          if(nz > 1) {
+            // Multiple points in z
+
+            int zp = (z + 1) % nz;
+
+            int ind2 = ROUND(index(x, y, zp));
+            if(zp == 0)
+              ind2 += n2d;
+            for(int j=0;j<n3d;j++) {
+              PetscInt col = ind2 + j;
+              MatSetValues(Jpc, 1, &row, 1, &col, &val, INSERT_VALUES);
+            }
+
+            int zm = (z - 1 + nz) % nz;
+            ind2 = ROUND(index(x, y, zm));
+            if(zm == 0)
+              ind2 += n2d;
+            for(int j=0;j<n3d;j++) {
+              PetscInt col = ind2 + j;
+              MatSetValues(Jpc, 1, &row, 1, &col, &val, INSERT_VALUES);
+            }
+
+          }
+
+        }
+      }
+    }
+  }
+  // Finished marking non-zero entries
+
+  // Assemble Matrix
+  MatAssemblyBegin(Jpc, MAT_FINAL_ASSEMBLY);
+  MatAssemblyEnd(Jpc, MAT_FINAL_ASSEMBLY);
+
+  ISColoring iscoloring;
+
+#if PETSC_VERSION_GE(3,5,0)
+  MatColoring coloring;
+  MatColoringCreate(Jpc,&coloring);
+  MatColoringSetType(coloring,MATCOLORINGSL);
+  MatColoringSetFromOptions(coloring);
+  // Calculate index sets
+  MatColoringApply(coloring,&iscoloring);
+  MatColoringDestroy(&coloring);
+#else
+  // Pre-3.5
+  MatGetColoring(Jpc,MATCOLORINGSL,&iscoloring);
+#endif
+
+  // Create data structure for SNESComputeJacobianDefaultColor
+  MatFDColoringCreate(Jpc,iscoloring,&fdcoloring);
+  // Set the function to difference
+  MatFDColoringSetFunction(fdcoloring,(PetscErrorCode (*)(void))FormFunctionForColoring,this);
+  MatFDColoringSetFromOptions(fdcoloring);
+#if PETSC_VERSION_GE(3,5,0)
+  MatFDColoringSetUp(Jpc,iscoloring,fdcoloring);
+#endif
+  ISColoringDestroy(&iscoloring);
+}
+
+/*
+ * Preconditioner function
+ */
+PetscErrorCode SNESSolver::precon(Vec x, Vec f) {
+  if(!have_user_precon()) {
+    // No user preconditioner
+    throw BoutException("No user preconditioner");
+  }
+
+  int ierr;
+
+  // Get the current state into BOUT++ fields
+  Vec solution;
+  SNESGetSolution(snes, &solution);
+  const BoutReal *soldata;
+  ierr = VecGetArrayRead(solution,&soldata);CHKERRQ(ierr);
+  load_vars(const_cast<BoutReal*>(soldata));
+  ierr = VecRestoreArrayRead(solution,&soldata);CHKERRQ(ierr);
+
+  // Load vector to be inverted into ddt() variables
+  const BoutReal *xdata;
+  ierr = VecGetArrayRead(x,&xdata);CHKERRQ(ierr);
+  load_derivs(const_cast<BoutReal*>(xdata));
+  ierr = VecRestoreArrayRead(x,&xdata);CHKERRQ(ierr);
+
+  // Run the preconditioner. This is a steady-state solve, so there is
+  // no timestep: the preconditioner should approximate the inverse
+  // Jacobian directly
+  run_precon(0.0, 1.0, 0.0);
+
+  // Save the solution from the ddt() variables
+  BoutReal *fdata;
+  ierr = VecGetArray(f,&fdata);CHKERRQ(ierr);
+  save_derivs(fdata);
+  ierr = VecRestoreArray(f,&fdata);CHKERRQ(ierr);
+
   return 0;
 }
 
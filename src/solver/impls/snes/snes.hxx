@@ -51,26 +51,42 @@ RegisterSolver<SNESSolver> registersolversnes("snes");
 /// nonlinear ODE
 class SNESSolver : public Solver {
  public:
-  SNESSolver(Options *opt = nullptr) : Solver(opt) {}
+  SNESSolver(Options *opt = nullptr)
+      : Solver(opt), Jmf(nullptr), Jpc(nullptr), fdcoloring(nullptr) {}
   ~SNESSolver() {}
   
   int init(int nout, BoutReal tstep) override;
-  
+
   int run() override;
-  
+
   PetscErrorCode snes_function(Vec x, Vec f); ///< Nonlinear function
+  PetscErrorCode precon(Vec x, Vec f); ///< Preconditioner
+  PetscErrorCode jacobian_mult(Vec v, Vec Jv); ///< Matrix-free Jacobian-vector product
  private:
   int mxstep; ///< Maximum number of internal steps between outputs
-  
+
   int nlocal; ///< Number of variables on local processor
   int neq; ///< Number of variables in total
-  
+
+  bool matrix_free; ///< Approximate Jacobian-vector products by differencing?
+  BoutReal mf_epsilon; ///< Relative size of the differencing perturbation
+
   PetscLib lib;     ///< Handles initialising, finalising PETSc
   Vec      snes_f;  ///< Used by SNES to store function
   Vec      snes_x;  ///< Result of SNES
   SNES     snes;    ///< SNES context
-  Mat      Jmf;     ///< Matrix-free Jacobian
-  
+  Mat      Jmf;     ///< Jacobian: a shell matrix when matrix_free
+
+  Vec x_scale; ///< Typical magnitude of each variable, scaling the perturbations
+  Vec mf_work; ///< Work vector holding the perturbed state
+
+  Mat Jpc; ///< Approximate Jacobian assembled by coloring, preconditioning only
+  MatFDColoring fdcoloring; ///< Coloring data for assembling Jpc
+
+  /// Fill x_scale with each evolving field's amplitude at the current state
+  void updateScaling();
+  /// Build Jpc's star-pattern sparsity and its finite-difference coloring
+  void constructMatrixColoring();
 };
 
 #endif // __SNES_SOLVER_H__
@@ -0,0 +1,238 @@
+#include "split-rk.hxx"
+
+#include <boutcomm.hxx>
+#include <utils.hxx>
+#include <boutexception.hxx>
+#include <msg_stack.hxx>
+#include <bout/openmpwrap.hxx>
+#include <cmath>
+
+#include <output.hxx>
+
+SplitRK::SplitRK(Options *opt) : Solver(opt) {}
+
+void SplitRK::setMaxTimestep(BoutReal dt) {
+  if(dt > timestep)
+    return; // Already less than this
+
+  timestep = dt; // Won't be used this time, but next
+}
+
+int SplitRK::init(int nout, BoutReal tstep) {
+
+  TRACE("Initialising SplitRK solver");
+
+  /// Call the generic initialisation first
+  if (Solver::init(nout, tstep))
+    return 1;
+
+  if (!splitOperator()) {
+    throw BoutException("The splitrk solver requires a model with split "
+                        "convective/diffusive parts (setSplitOperator)");
+  }
+
+  output << "\n\tSplit Runge-Kutta solver: RKL2 super-time-stepping for the diffusive part\n";
+
+  nsteps = nout; // Save number of output steps
+  out_timestep = tstep;
+  max_dt = tstep;
+
+  // Calculate number of variables
+  nlocal = getLocalN();
+
+  // Get total problem size
+  int ntmp;
+  if(MPI_Allreduce(&nlocal, &ntmp, 1, MPI_INT, MPI_SUM, BoutComm::get())) {
+    throw BoutException("MPI_Allreduce failed!");
+  }
+  neq = ntmp;
+
+  output.write("\t3d fields = %d, 2d fields = %d neq=%d, local_N=%d\n",
+	       n3Dvars(), n2Dvars(), neq, nlocal);
+
+  // Allocate memory
+  f = Array<double>(nlocal);
+
+  // memory for the convective (SSP-RK3) stages
+  u1 = Array<double>(nlocal);
+  u2 = Array<double>(nlocal);
+  L = Array<double>(nlocal);
+
+  // memory for the diffusive (RKL2) stages
+  dydt0 = Array<double>(nlocal);
+  y_jm1 = Array<double>(nlocal);
+  y_jm2 = Array<double>(nlocal);
+
+  // Put starting values into f
+  save_vars(std::begin(f));
+
+  // Get options
+  OPTION(options, max_timestep, tstep); // Maximum timestep
+  OPTION(options, timestep, max_timestep); // Starting timestep
+  OPTION(options, mxstep, 500); // Maximum number of steps between outputs
+
+  OPTION(options, nstages, 10); // Number of stages in the RKL super-step
+
+  if (nstages < 2) {
+    // The stage coefficients are only defined from the second stage
+    // on, and a one-stage "super-step" is just forward Euler
+    throw BoutException("splitrk: nstages must be at least 2");
+  }
+
+  output.write("\tRKL2 stages = %d, stable up to ~%.1f times the explicit diffusive limit\n",
+               nstages, 0.5 * (nstages * nstages + nstages - 2.));
+
+  return 0;
+}
+
+int SplitRK::run() {
+  TRACE("SplitRK::run()");
+
+  for(int s=0;s<nsteps;s++) {
+    BoutReal target = simtime + out_timestep;
+
+    BoutReal dt;
+    bool running = true;
+    int internal_steps = 0;
+    do {
+      dt = timestep;
+      running = true;
+      if((simtime + dt) >= target) {
+        dt = target - simtime; // Make sure the last timestep is on the output
+        running = false;
+      }
+
+      internal_steps++;
+      if(internal_steps > mxstep)
+        throw BoutException("ERROR: MXSTEP exceeded. timestep = %e\n", timestep);
+
+      take_step(simtime, dt, f, f);
+
+      simtime += dt;
+
+      stats.nsteps++;
+      stats.last_dt = dt;
+
+      call_timestep_monitors(simtime, dt);
+    }while(running);
+
+    load_vars(std::begin(f)); // Put result into variables
+    // Call rhs function to get extra variables at this time
+    run_rhs(simtime);
+
+    iteration++; // Advance iteration number
+
+    /// Call the monitor function
+
+    if(call_monitors(simtime, s, nsteps)) {
+      // User signalled to quit
+      break;
+    }
+  }
+
+  return 0;
+}
+
+void SplitRK::take_step(BoutReal curtime, BoutReal dt, Array<double> &start,
+                        Array<double> &result) {
+  // Strang splitting: half a diffusive super-step on either side of a
+  // full convective step keeps the combination 2nd-order accurate
+
+  take_diffusive_step(curtime, 0.5*dt, start, result);
+  take_convective_step(curtime, dt, result, result);
+  take_diffusive_step(curtime + 0.5*dt, 0.5*dt, result, result);
+}
+
+void SplitRK::take_convective_step(BoutReal curtime, BoutReal dt, Array<double> &start,
+                                   Array<double> &result) {
+  // 3rd-order SSP RK3, as in the rk3ssp solver, using only the
+  // convective part of the model
+
+  load_vars(std::begin(start));
+  run_convective(curtime);
+  save_derivs(std::begin(L));
+
+  BOUT_OMP(parallel for)
+  for(int i=0;i<nlocal;i++)
+    u1[i] = start[i] + dt*L[i];
+
+  load_vars(std::begin(u1));
+  run_convective(curtime + dt);
+  save_derivs(std::begin(L));
+
+  BOUT_OMP(parallel for)
+  for(int i=0;i<nlocal;i++)
+    u2[i] = 0.75*start[i] + 0.25*u1[i] + 0.25*dt*L[i];
+
+  load_vars(std::begin(u2));
+  run_convective(curtime + 0.5*dt);
+  save_derivs(std::begin(L));
+
+  BOUT_OMP(parallel for)
+  for(int i=0;i<nlocal;i++)
+    result[i] = (1./3)*start[i] + (2./3.)*(u2[i] + dt*L[i]);
+}
+
+void SplitRK::take_diffusive_step(BoutReal curtime, BoutReal dt, Array<double> &start,
+                                  Array<double> &result) {
+  // RKL2 super-time-stepping (Meyer et al. 2014, section 2.2): an
+  // s-stage first-same-as-last recursion whose stability interval
+  // along the negative real axis grows like (s^2 + s - 2)/2 times the
+  // forward-Euler limit, while remaining 2nd-order accurate
+
+  const int s = nstages;
+
+  const BoutReal w1 = 4. / (s*s + s - 2.);
+
+  // b_0 = b_1 = b_2 = 1/3 ; b_j = (j^2 + j - 2) / (2 j (j+1))
+  auto bcoef = [](int j) -> BoutReal {
+    if(j < 2)
+      return 1./3;
+    return (j*j + j - 2.) / (2.*j*(j + 1.));
+  };
+
+  // The derivative at the start of the super-step enters every stage
+  load_vars(std::begin(start));
+  run_diffusive(curtime);
+  save_derivs(std::begin(dydt0));
+
+  // First stage: Y_1 = Y_0 + mu~_1 dt M(Y_0)
+  const BoutReal mu_tilde1 = bcoef(1)*w1;
+  BOUT_OMP(parallel for)
+  for(int i=0;i<nlocal;i++) {
+    y_jm2[i] = start[i];
+    y_jm1[i] = start[i] + mu_tilde1*dt*dydt0[i];
+  }
+
+  for(int j=2; j<=s; j++) {
+    const BoutReal bj = bcoef(j);
+    const BoutReal mu = ((2.*j - 1.)/j) * bj/bcoef(j-1);
+    const BoutReal nu = -((j - 1.)/j) * bj/bcoef(j-2);
+    const BoutReal mu_tilde = mu*w1;
+    const BoutReal gamma_tilde = -mu_tilde*(1. - bcoef(j-1));
+
+    // Fraction of the super-step reached by stage j-1
+    const BoutReal c_jm1 = ((j-1)*(j-1) + (j-1) - 2.) / (s*s + s - 2.);
+
+    load_vars(std::begin(y_jm1));
+    run_diffusive(curtime + c_jm1*dt);
+    save_derivs(std::begin(L));
+
+    if(j == s) {
+      // The final stage is the result
+      BOUT_OMP(parallel for)
+      for(int i=0;i<nlocal;i++)
+        result[i] = mu*y_jm1[i] + nu*y_jm2[i] + (1. - mu - nu)*start[i]
+                    + mu_tilde*dt*L[i] + gamma_tilde*dt*dydt0[i];
+    }else {
+      BOUT_OMP(parallel for)
+      for(int i=0;i<nlocal;i++)
+        u1[i] = mu*y_jm1[i] + nu*y_jm2[i] + (1. - mu - nu)*start[i]
+                + mu_tilde*dt*L[i] + gamma_tilde*dt*dydt0[i];
+
+      // Rotate the stage history
+      swap(y_jm2, y_jm1);
+      swap(y_jm1, u1);
+    }
+  }
+}
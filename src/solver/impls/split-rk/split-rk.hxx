@@ -0,0 +1,102 @@
+/**************************************************************************
+ * Split scheme with super-time-stepping for diffusive terms
+ *
+ * The model's diffusive (parabolic) part is advanced with the RKL2
+ * Runge-Kutta-Legendre scheme, Strang-split around a 3rd-order SSP
+ * Runge-Kutta step of the convective part. An s-stage RKL step is
+ * stable up to ~s^2 times the explicit diffusive limit, so the outer
+ * timestep is set by the advection CFL rather than the quadratic
+ * diffusion limit, at the cost of s cheap sub-stages.
+ *
+ * C. D. Meyer, D. S. Balsara and T. D. Aslam, A stabilized
+ * Runge-Kutta-Legendre method for explicit super-time-stepping of
+ * parabolic and mixed equations, J. Comput. Phys. 257 (2014), 594-626
+ *
+ * Requires a model with split convective/diffusive parts.
+ * Always available, since doesn't depend on external library
+ *
+ **************************************************************************
+ * Copyright 2018 BOUT++ contributors
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+class SplitRK;
+
+#ifndef __SPLITRK_SOLVER_H__
+#define __SPLITRK_SOLVER_H__
+
+#include "mpi.h"
+
+#include <bout_types.hxx>
+#include <bout/solver.hxx>
+
+#include <bout/solverfactory.hxx>
+namespace {
+RegisterSolver<SplitRK> registersolversplitrk("splitrk");
+}
+
+class SplitRK : public Solver {
+ public:
+  SplitRK(Options *opt = nullptr);
+  ~SplitRK(){};
+
+  void setMaxTimestep(BoutReal dt) override;
+  BoutReal getCurrentTimestep() override { return timestep; }
+
+  int init(int nout, BoutReal tstep) override;
+
+  int run() override;
+ private:
+
+  BoutReal max_timestep; // Maximum timestep
+  int mxstep; // Maximum number of internal steps between outputs
+
+  int nstages; // Number of stages in the RKL super-step
+
+  BoutReal out_timestep; // The output timestep
+  int nsteps; // Number of output steps
+
+  BoutReal timestep; // The internal (outer) timestep
+
+  int nlocal, neq; // Number of variables on local processor and in total
+
+  Array<double> f; // The system state
+
+  /// Take a single Strang-split step: a half diffusive super-step,
+  /// a full convective SSP-RK3 step, then another half diffusive
+  /// super-step
+  void take_step(BoutReal curtime, BoutReal dt,
+                 Array<double> &start, Array<double> &result);
+
+  /// Advance only the convective part with 3rd-order SSP Runge-Kutta
+  void take_convective_step(BoutReal curtime, BoutReal dt,
+                            Array<double> &start, Array<double> &result);
+
+  /// Advance only the diffusive part with an nstages-stage RKL2
+  /// super-step
+  void take_diffusive_step(BoutReal curtime, BoutReal dt,
+                           Array<double> &start, Array<double> &result);
+
+  Array<double> u1, u2, L; // Convective (SSP-RK3) stage arrays
+
+  Array<double> dydt0, y_jm1, y_jm2; // Diffusive (RKL2) stage arrays
+};
+
+#endif // __SPLITRK_SOLVER_H__
@@ -21,7 +21,9 @@
  **************************************************************************/
 
 #include <boutcomm.hxx>
+#include <bout/checkpoint.hxx>
 #include <bout/solver.hxx>
+#include <fenv.h>
 #include <string.h>
 #include <time.h>
 
@@ -33,12 +35,15 @@
 
 #include "bout/solverfactory.hxx"
 
+#include <bout/sys/steppipeline.hxx>
 #include <bout/sys/timer.hxx>
+#include <bout/sys/watchdog.hxx>
 #include <msg_stack.hxx>
 #include <output.hxx>
 #include <bout/assert.hxx>
 
 #include <bout/array.hxx>
+#include <bout/array_metrics.hxx>
 #include "bout/region.hxx"
 
 // Static member variables
@@ -74,10 +79,26 @@ Solver::Solver(Options *opts) : options(opts), model(nullptr), prefunc(nullptr)
   
   // Output monitor
   options->get("monitor_timestep", monitor_timestep, false);
+
+  // Trace the output-step pipeline, to verify that asynchronous
+  // output and monitors overlap the integration
+  bool trace_pipeline;
+  options->get("trace_pipeline", trace_pipeline, false);
+  if (trace_pipeline) {
+    StepPipeline::enable();
+  }
   
   // Method of Manufactured Solutions (MMS)
   options->get("mms", mms, false);
   options->get("mms_initialise", mms_initialise, mms);
+
+  // Sentinel NaN/Inf checking of the evolving fields
+  options->get("sentinel", sentinel, false);
+  options->get("sentinel_every", sentinel_every, 100);
+  if (sentinel && (sentinel_every < 1)) {
+    throw BoutException("sentinel_every (%d) must be >= 1", sentinel_every);
+  }
+  sentinel_fp_trips = 0;
 }
 
 /**************************************************************************
@@ -628,6 +649,29 @@ void Solver::outputVars(Datafile &outputfile, bool save_repeat) {
   }
 }
 
+void Solver::addTelemetry(Datafile &outputfile) {
+  outputfile.add(stats.nsteps, "solver_nsteps", true);
+  outputfile.add(stats.nfailed, "solver_nfailed", true);
+  outputfile.add(stats.nrhs_calls, "solver_nrhs_calls", true);
+  outputfile.add(stats.nnewton_iters, "solver_nnewton_iters", true);
+  outputfile.add(stats.nkrylov_iters, "solver_nkrylov_iters", true);
+  outputfile.add(stats.last_dt, "solver_last_dt", true);
+}
+
+void Solver::outputVars(Checkpoint &checkpoint) {
+  /// Add basic variables needed for restarting
+  checkpoint.add(simtime, "tt");
+  checkpoint.add(iteration, "hist_hi");
+
+  // Add 2D and 3D evolving fields
+  for(const auto& f : f2d) {
+    checkpoint.add(*(f.var), f.name);
+  }
+  for(const auto& f : f3d) {
+    checkpoint.add(*(f.var), f.name);
+  }
+}
+
 /////////////////////////////////////////////////////
 
 /// Method to add a Monitor to the Solver
@@ -684,17 +728,34 @@ int Solver::call_monitors(BoutReal simtime, int iter, int NOUT) {
     // Calculate MMS errors
     calculate_mms_error(simtime);
   }
-  
+
+  // RHS calls since the last output; the counter itself is
+  // reset separately (by BoutMonitor)
+  stats.nrhs_calls = rhs_ncalls;
+
   ++iter;
+
+  // Open the monitor phase of this output step, closing the
+  // integration window, and guard the evolving fields so that a
+  // monitor writing to the state is detected at stepEnd
+  StepPipeline::stepBegin(iter, simtime);
+  for (const auto &f : f3d) {
+    StepPipeline::guard(f.var, f.name);
+  }
+
   try {
     // Call monitors
+    int imon = 0;
     for (const auto &it : monitors){
       if ((iter % it->freq)==0){
         // Call each monitor one by one
+        StepPipeline::stageBegin(std::to_string(imon));
         int ret = it->call(this, simtime,iter/it->freq-1, NOUT/it->freq);
+        StepPipeline::stageEnd();
         if(ret)
           throw BoutException("Monitor signalled to quit");
       }
+      ++imon;
     }
   } catch (BoutException &e) {
     for (const auto &it : monitors){
@@ -719,6 +780,17 @@ int Solver::call_monitors(BoutReal simtime, int iter, int NOUT) {
     return 1;
   }
 
+  // Start counting afresh for the next output step. Note this is
+  // done after the monitors, which may write the statistics out
+  stats.nsteps = 0;
+  stats.nfailed = 0;
+  stats.nnewton_iters = 0;
+  stats.nkrylov_iters = 0;
+
+  // Close the monitor phase: checks the guarded fields and opens the
+  // integration window of the next step
+  StepPipeline::stepEnd();
+
   return 0;
 }
 
@@ -830,7 +902,7 @@ Solver* Solver::create(SolverType &type, Options *opts) {
  **************************************************************************/
 
 /// Perform an operation at a given Ind2D (jx,jy) location, moving data between BOUT++ and CVODE
-void Solver::loop_vars_op(Ind2D i2d, BoutReal *udata, int &p, SOLVER_VAR_OP op, bool bndry) {
+void Solver::loop_vars_op(Ind2D i2d, double *udata, int &p, SOLVER_VAR_OP op, bool bndry) {
   int nz = mesh->LocalNz;
   
   switch(op) {
@@ -964,21 +1036,107 @@ void Solver::loop_vars_op(Ind2D i2d, BoutReal *udata, int &p, SOLVER_VAR_OP op,
 }
 
 /// Loop over variables and domain. Used for all data operations for consistency
-void Solver::loop_vars(BoutReal *udata, SOLVER_VAR_OP op) {
+void Solver::loop_vars(double *udata, SOLVER_VAR_OP op) {
+  if (op != SET_ID) {
+    // Data copies, which happen on every RHS call: go through the
+    // variables' raw storage rather than indexing each Field per point
+    loop_vars_raw(udata, op);
+    return;
+  }
+
   int p = 0; // Counter for location in udata array
-  
+
   // All boundaries
   for(const auto &i2d : mesh->getRegion2D("RGN_BNDRY")) {
     loop_vars_op(i2d, udata, p, op, true);
   }
-  
+
   // Bulk of points
   for(const auto &i2d : mesh->getRegion2D("RGN_NOBNDRY")) {
     loop_vars_op(i2d, udata, p, op, false);
   }
 }
 
-void Solver::load_vars(BoutReal *udata) {
+void Solver::loop_vars_raw(double *udata, SOLVER_VAR_OP op) {
+  const bool load = (op == LOAD_VARS) || (op == LOAD_DERIVS);
+  const bool derivs = (op == LOAD_DERIVS) || (op == SAVE_DERIVS);
+
+  const int nz = mesh->LocalNz;
+  const int n2d = f2d.size();
+  const int n3d = f3d.size();
+
+  // Raw storage of each variable, and whether its boundary is evolving
+  std::vector<BoutReal *> ptr2d(n2d), ptr3d(n3d);
+  std::vector<int> bndry2d(n2d), bndry3d(n3d);
+  for (int k = 0; k < n2d; k++) {
+    Field2D *v = derivs ? f2d[k].F_var : f2d[k].var;
+    ptr2d[k] = &(*v)(0, 0);
+    bndry2d[k] = f2d[k].evolve_bndry;
+  }
+  for (int k = 0; k < n3d; k++) {
+    Field3D *v = derivs ? f3d[k].F_var : f3d[k].var;
+    ptr3d[k] = &(*v)(0, 0, 0);
+    bndry3d[k] = f3d[k].evolve_bndry;
+  }
+
+  int p = 0; // Counter for location in udata array
+
+  // All boundaries. Only variables with evolving boundaries contribute
+  for (const auto &i2d : mesh->getRegion2D("RGN_BNDRY")) {
+    const int i = i2d.ind;
+    for (int k = 0; k < n2d; k++) {
+      if (!bndry2d[k])
+        continue;
+      if (load)
+        ptr2d[k][i] = udata[p];
+      else
+        udata[p] = ptr2d[k][i];
+      p++;
+    }
+    for (int jz = 0; jz < nz; jz++) {
+      for (int k = 0; k < n3d; k++) {
+        if (!bndry3d[k])
+          continue;
+        if (load)
+          ptr3d[k][i * nz + jz] = udata[p];
+        else
+          udata[p] = ptr3d[k][i * nz + jz];
+        p++;
+      }
+    }
+  }
+
+  // Bulk of points. For the 3D variables each field's z column is
+  // contiguous in field storage, strided by n3d in udata
+  for (const auto &i2d : mesh->getRegion2D("RGN_NOBNDRY")) {
+    const int i = i2d.ind;
+    for (int k = 0; k < n2d; k++) {
+      if (load)
+        ptr2d[k][i] = udata[p];
+      else
+        udata[p] = ptr2d[k][i];
+      p++;
+    }
+    if (load) {
+      for (int k = 0; k < n3d; k++) {
+        BoutReal *f = ptr3d[k] + i * nz;
+        const double *u = udata + p + k;
+        for (int jz = 0; jz < nz; jz++)
+          f[jz] = u[jz * n3d];
+      }
+    } else {
+      for (int k = 0; k < n3d; k++) {
+        const BoutReal *f = ptr3d[k] + i * nz;
+        double *u = udata + p + k;
+        for (int jz = 0; jz < nz; jz++)
+          u[jz * n3d] = f[jz];
+      }
+    }
+    p += n3d * nz;
+  }
+}
+
+void Solver::load_vars(double *udata) {
   // Make sure data is allocated
   for(const auto& f : f2d) 
     f.var->allocate();
@@ -997,7 +1155,7 @@ void Solver::load_vars(BoutReal *udata) {
     v.var->covariant = v.covariant;
 }
 
-void Solver::load_derivs(BoutReal *udata) {
+void Solver::load_derivs(double *udata) {
   // Make sure data is allocated
   for(const auto& f : f2d) 
     f.F_var->allocate();
@@ -1017,7 +1175,7 @@ void Solver::load_derivs(BoutReal *udata) {
 }
 
 // This function only called during initialisation
-void Solver::save_vars(BoutReal *udata) {
+void Solver::save_vars(double *udata) {
   for(const auto& f : f2d) 
     if(!f.var->isAllocated())
       throw BoutException("Variable '%s' not initialised", f.name.c_str());
@@ -1043,7 +1201,7 @@ void Solver::save_vars(BoutReal *udata) {
   loop_vars(udata, SAVE_VARS);
 }
 
-void Solver::save_derivs(BoutReal *dudata) {
+void Solver::save_derivs(double *dudata) {
   // Make sure vectors in correct basis
   for(const auto& v : v2d) {
     if(v.covariant) {
@@ -1068,7 +1226,7 @@ void Solver::save_derivs(BoutReal *dudata) {
   loop_vars(dudata, SAVE_DERIVS);
 }
 
-void Solver::set_id(BoutReal *udata) {
+void Solver::set_id(double *udata) {
   loop_vars(udata, SET_ID);
 }
 
@@ -1147,17 +1305,24 @@ void Solver::setSplitOperator(rhsfunc fC, rhsfunc fD) {
 
 int Solver::run_rhs(BoutReal t) {
   int status;
-  
+
   Timer timer("rhs");
-  
+  ArrayMetrics::Label metrics_label("rhs");
+  Watchdog::beat("run_rhs");
+  sentinel_clear_fp();
+
   if(split_operator) {
     // Run both parts
     
     int nv = getLocalN();
-    // Create two temporary arrays for system state
-    Array<BoutReal> tmp(nv);
-    Array<BoutReal> tmp2(nv);
-    
+    // Two buffers for system state, reused between calls
+    if (split_state.size() != nv) {
+      split_state = Array<double>(nv);
+      split_deriv = Array<double>(nv);
+    }
+    Array<double> &tmp = split_state;
+    Array<double> &tmp2 = split_deriv;
+
     save_vars(tmp.begin()); // Copy variables into tmp
     pre_rhs(t);
     if(model) {
@@ -1175,7 +1340,7 @@ int Solver::run_rhs(BoutReal t) {
       status = (*phys_diff)(t);
     post_rhs(t);
     save_derivs(tmp2.begin()); // Save time derivatives
-    for(BoutReal *t = tmp.begin(), *t2 = tmp2.begin(); t != tmp.end(); ++t, ++t2)
+    for(double *t = tmp.begin(), *t2 = tmp2.begin(); t != tmp.end(); ++t, ++t2)
       *t += *t2;
     load_derivs(tmp.begin()); // Put back time-derivatives
   }else {
@@ -1193,6 +1358,7 @@ int Solver::run_rhs(BoutReal t) {
   rhs_ncalls++;
   rhs_ncalls_e++;
   rhs_ncalls_i++;
+  sentinel_check();
   return status;
 }
 
@@ -1201,6 +1367,8 @@ int Solver::run_convective(BoutReal t) {
   int status;
   
   Timer timer("rhs");
+  ArrayMetrics::Label metrics_label("rhs: convective");
+  sentinel_clear_fp();
   pre_rhs(t);
   if(split_operator) {
     if(model) {
@@ -1222,6 +1390,7 @@ int Solver::run_convective(BoutReal t) {
   
   rhs_ncalls++;
   rhs_ncalls_e++;
+  sentinel_check();
   return status;
 }
 
@@ -1229,6 +1398,8 @@ int Solver::run_diffusive(BoutReal t, bool linear) {
   int status = 0;
   
   Timer timer("rhs");
+  ArrayMetrics::Label metrics_label("rhs: diffusive");
+  sentinel_clear_fp();
   pre_rhs(t);
   if(split_operator) {
 
@@ -1245,6 +1416,7 @@ int Solver::run_diffusive(BoutReal t, bool linear) {
       status = (*phys_run)(t);
   }
   rhs_ncalls_i++;
+  sentinel_check();
   return status;
 }
 
@@ -1311,6 +1483,68 @@ void Solver::post_rhs(BoutReal UNUSED(t)) {
 #endif
 }
 
+/**************************************************************************
+ * Sentinel NaN/Inf checking, for runs compiled with CHECK=0
+ *
+ * Per-operation checkData is too expensive for production, but a NaN
+ * entering the state silently corrupts everything downstream and is
+ * typically only noticed in the output files. The sentinel (option
+ * sentinel in the [solver] section) watches every RHS evaluation at
+ * near-zero cost through the floating-point exception status flags,
+ * and runs a full non-finite scan of the evolving fields and their
+ * time derivatives every sentinel_every RHS calls -- or immediately
+ * when the flags trip. A scan which finds bad data throws, stopping
+ * the run at the step the corruption appeared rather than hours
+ * later; combined with checkpointing, the last complete checkpoint
+ * then provides a clean state to roll back to.
+ **************************************************************************/
+
+void Solver::sentinel_clear_fp() {
+  if (!sentinel)
+    return;
+  feclearexcept(FE_INVALID | FE_DIVBYZERO | FE_OVERFLOW);
+}
+
+void Solver::sentinel_check() {
+  if (!sentinel)
+    return;
+
+  // Reading the accumulated status flags is the only per-call cost
+  const bool fp_tripped = fetestexcept(FE_INVALID | FE_DIVBYZERO | FE_OVERFLOW) != 0;
+  if (fp_tripped)
+    sentinel_fp_trips++;
+
+  // The flags can be raised benignly (speculative SIMD lanes, maths
+  // library internals), so a trip only brings the full scan forward:
+  // what the evolving fields actually contain is what decides
+  if (!fp_tripped && (rhs_ncalls % sentinel_every != 0))
+    return;
+
+  TRACE("Solver sentinel check");
+
+  string bad;
+  for (const auto &f : f2d) {
+    if (!finite(*f.var, RGN_NOBNDRY))
+      bad += " " + f.name;
+    if (f.F_var->isAllocated() && !finite(*f.F_var, RGN_NOBNDRY))
+      bad += " ddt(" + f.name + ")";
+  }
+  for (const auto &f : f3d) {
+    if (!finite(*f.var, RGN_NOBNDRY))
+      bad += " " + f.name;
+    if (f.F_var->isAllocated() && !finite(*f.F_var, RGN_NOBNDRY))
+      bad += " ddt(" + f.name + ")";
+  }
+
+  if (!bad.empty()) {
+    throw BoutException(
+        "Sentinel check found non-finite values in:%s\n"
+        "\tat t = %e after %d RHS calls (FP exception flags raised on %d calls).\n"
+        "\tRestart from the last checkpoint or restart files before the corruption",
+        bad.c_str(), simtime, rhs_ncalls, sentinel_fp_trips);
+  }
+}
+
 bool Solver::varAdded(const string &name) {
   for(const auto& f : f2d) {
     if(f.name == name)
@@ -6,6 +6,7 @@
 #include "impls/ida/ida.hxx"
 #include "impls/imex-bdf2/imex-bdf2.hxx"
 #include "impls/karniadakis/karniadakis.hxx"
+#include "impls/multirate/multirate.hxx"
 #include "impls/petsc/petsc.hxx"
 #include "impls/power/power.hxx"
 #include "impls/pvode/pvode.hxx"
@@ -14,6 +15,7 @@
 #include "impls/rkgeneric/rkgeneric.hxx"
 #include "impls/slepc/slepc.hxx"
 #include "impls/snes/snes.hxx"
+#include "impls/split-rk/split-rk.hxx"
 
 SolverFactory* SolverFactory::instance = nullptr;
 
@@ -26,9 +26,12 @@ void BoutComm::setComm(MPI_Comm c) {
 
 MPI_Comm BoutComm::getComm() {
   if(comm == MPI_COMM_NULL) {
-    // No communicator set. Initialise MPI
-    MPI_Init(pargc,pargv);
-    
+    // No communicator set. Initialise MPI, requesting thread support
+    // so that e.g. AsyncMonitor can make MPI calls from a helper
+    // thread. The implementation may provide less; see threadSafe()
+    int provided;
+    MPI_Init_thread(pargc, pargv, MPI_THREAD_MULTIPLE, &provided);
+
     // Duplicate MPI_COMM_WORLD
     MPI_Comm_dup(MPI_COMM_WORLD, &comm);
   }
@@ -61,6 +64,13 @@ int BoutComm::size() {
   return NPES;
 }
 
+bool BoutComm::threadSafe() {
+  get(); // Make sure MPI is initialised
+  int provided;
+  MPI_Query_thread(&provided);
+  return provided == MPI_THREAD_MULTIPLE;
+}
+
 BoutComm* BoutComm::getInstance() {
   if(instance == nullptr) {
     // Create the singleton object
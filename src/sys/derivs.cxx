@@ -63,7 +63,7 @@
 const Field3D DDX(const Field3D &f, CELL_LOC outloc, DIFF_METHOD method, REGION region) {
   Field3D result =  f.getMesh()->indexDDX(f,outloc, method, region);
   Coordinates *coords = f.getCoordinates(outloc);
-  result /= coords->dx;
+  result *= coords->stencilCoefs().ddx;
 
   if(f.getMesh()->IncIntShear) {
     // Using BOUT-06 style shifting
@@ -76,6 +76,36 @@ const Field3D DDX(const Field3D &f, CELL_LOC outloc, DIFF_METHOD method, REGION
   return result;
 }
 
+const Field3D DDX(const Field3D &f, CELL_LOC outloc, DIFF_METHOD method,
+                  const std::string &region) {
+  Mesh *localmesh = f.getMesh();
+  Field3D result = localmesh->indexDDX(f, outloc, method, region);
+  Coordinates *coords = f.getCoordinates(outloc);
+
+  // Scale in-region only: cells outside a narrow region are not set by
+  // indexDDX, so a whole-field operation would read uninitialised data
+  const Field2D &invdx = coords->stencilCoefs().ddx;
+  if (localmesh->IncIntShear) {
+    // Using BOUT-06 style shifting
+    Field3D dfdz = localmesh->indexDDZ(f, outloc, method, region);
+    const BoutReal invdz = 1. / coords->dz;
+    BOUT_FOR(i, result.getRegion(region)) {
+      const auto i2 = localmesh->ind3Dto2D(i);
+      result[i] = result[i] * invdx[i2]
+                  + coords->IntShiftTorsion[i2] * dfdz[i] * invdz;
+    }
+  } else {
+    BOUT_FOR(i, result.getRegion(region)) {
+      result[i] *= invdx[localmesh->ind3Dto2D(i)];
+    }
+  }
+
+  ASSERT2(((outloc == CELL_DEFAULT) && (result.getLocation() == f.getLocation())) ||
+          (result.getLocation() == outloc));
+
+  return result;
+}
+
 const Field2D DDX(const Field2D &f, CELL_LOC outloc, DIFF_METHOD method, REGION region) {
   return f.getCoordinates(outloc)->DDX(f, outloc, method, region);
 }
@@ -83,7 +113,19 @@ const Field2D DDX(const Field2D &f, CELL_LOC outloc, DIFF_METHOD method, REGION
 ////////////// Y DERIVATIVE /////////////////
 
 const Field3D DDY(const Field3D &f, CELL_LOC outloc, DIFF_METHOD method, REGION region) {
-  return f.getMesh()->indexDDY(f, outloc, method, region) / f.getCoordinates(outloc)->dy;
+  return f.getMesh()->indexDDY(f, outloc, method, region)
+         * f.getCoordinates(outloc)->stencilCoefs().ddy;
+}
+
+const Field3D DDY(const Field3D &f, CELL_LOC outloc, DIFF_METHOD method,
+                  const std::string &region) {
+  Mesh *localmesh = f.getMesh();
+  Field3D result = localmesh->indexDDY(f, outloc, method, region);
+  const Field2D &invdy = f.getCoordinates(outloc)->stencilCoefs().ddy;
+  BOUT_FOR(i, result.getRegion(region)) {
+    result[i] *= invdy[localmesh->ind3Dto2D(i)];
+  }
+  return result;
 }
 
 const Field2D DDY(const Field2D &f, CELL_LOC outloc, DIFF_METHOD method, REGION region) {
@@ -96,6 +138,16 @@ const Field3D DDZ(const Field3D &f, CELL_LOC outloc, DIFF_METHOD method, REGION
   return f.getMesh()->indexDDZ(f, outloc, method, region) / f.getCoordinates(outloc)->dz;
 }
 
+const Field3D DDZ(const Field3D &f, CELL_LOC outloc, DIFF_METHOD method,
+                  const std::string &region) {
+  Field3D result = f.getMesh()->indexDDZ(f, outloc, method, region);
+  const BoutReal dz = f.getCoordinates(outloc)->dz;
+  BOUT_FOR(i, result.getRegion(region)) {
+    result[i] /= dz;
+  }
+  return result;
+}
+
 const Field2D DDZ(const Field2D &f, CELL_LOC UNUSED(outloc), DIFF_METHOD UNUSED(method),
                   REGION UNUSED(region)) {
   auto tmp = Field2D(0., f.getMesh());
@@ -147,6 +199,53 @@ const Vector2D DDZ(const Vector2D &v, CELL_LOC UNUSED(outloc), DIFF_METHOD UNUSE
   return result;
 }
 
+////////////// FUSED GRADIENT /////////////////
+
+void gradAll(const Field3D &f, Field3D &ddx, Field3D &ddy, Field3D &ddz,
+             CELL_LOC outloc) {
+  TRACE("gradAll( Field3D )");
+
+  Mesh *localmesh = f.getMesh();
+  CELL_LOC inloc = f.getLocation();
+  if (outloc == CELL_DEFAULT)
+    outloc = inloc;
+
+  if (outloc != inloc) {
+    // Staggered output: the fused kernel doesn't support the stencil
+    // shifts, so use the separate sweeps
+    ddx = DDX(f, outloc);
+    ddy = DDY(f, outloc);
+    ddz = DDZ(f, outloc);
+    return;
+  }
+
+  localmesh->indexGradAll(f, ddx, ddy, ddz, outloc);
+
+  // Metric scaling in one further pass, in-region only: cells outside
+  // RGN_NOBNDRY are not set by indexGradAll
+  Coordinates *coords = f.getCoordinates(outloc);
+  const Field2D &invdx = coords->stencilCoefs().ddx;
+  const Field2D &invdy = coords->stencilCoefs().ddy;
+  const BoutReal invdz = 1. / coords->dz;
+
+  if (localmesh->IncIntShear) {
+    // Using BOUT-06 style shifting
+    BOUT_FOR(i, localmesh->getRegion3D("RGN_NOBNDRY")) {
+      const auto i2 = localmesh->ind3Dto2D(i);
+      ddy[i] *= invdy[i2];
+      ddz[i] *= invdz;
+      ddx[i] = ddx[i] * invdx[i2] + coords->IntShiftTorsion[i2] * ddz[i];
+    }
+  } else {
+    BOUT_FOR(i, localmesh->getRegion3D("RGN_NOBNDRY")) {
+      const auto i2 = localmesh->ind3Dto2D(i);
+      ddx[i] *= invdx[i2];
+      ddy[i] *= invdy[i2];
+      ddz[i] *= invdz;
+    }
+  }
+}
+
 /*******************************************************************************
  * 2nd derivative
  *******************************************************************************/
@@ -155,12 +254,40 @@ const Vector2D DDZ(const Vector2D &v, CELL_LOC UNUSED(outloc), DIFF_METHOD UNUSE
 
 const Field3D D2DX2(const Field3D &f, CELL_LOC outloc, DIFF_METHOD method, REGION region) {
   Coordinates *coords = f.getCoordinates(outloc);
+  const Coordinates::StencilCoefs &sc = coords->stencilCoefs();
+
+  Field3D result = f.getMesh()->indexD2DX2(f, outloc, method, region) * sc.d2dx2;
 
-  Field3D result = f.getMesh()->indexD2DX2(f, outloc, method, region) / SQ(coords->dx);
-  
   if(coords->non_uniform) {
     // Correction for non-uniform f.getMesh()
-    result += coords->d1_dx * f.getMesh()->indexDDX(f, outloc, DIFF_DEFAULT, region)/coords->dx;
+    result += sc.d2dx2_corr * f.getMesh()->indexDDX(f, outloc, DIFF_DEFAULT, region);
+  }
+
+  ASSERT2(((outloc == CELL_DEFAULT) && (result.getLocation() == f.getLocation())) ||
+          (result.getLocation() == outloc));
+
+  return result;
+}
+
+const Field3D D2DX2(const Field3D &f, CELL_LOC outloc, DIFF_METHOD method,
+                    const std::string &region) {
+  Mesh *localmesh = f.getMesh();
+  Coordinates *coords = f.getCoordinates(outloc);
+
+  Field3D result = localmesh->indexD2DX2(f, outloc, method, region);
+
+  const Coordinates::StencilCoefs &sc = coords->stencilCoefs();
+  if (coords->non_uniform) {
+    // Correction for non-uniform f.getMesh()
+    Field3D df = localmesh->indexDDX(f, outloc, DIFF_DEFAULT, region);
+    BOUT_FOR(i, result.getRegion(region)) {
+      const auto i2 = localmesh->ind3Dto2D(i);
+      result[i] = result[i] * sc.d2dx2[i2] + sc.d2dx2_corr[i2] * df[i];
+    }
+  } else {
+    BOUT_FOR(i, result.getRegion(region)) {
+      result[i] *= sc.d2dx2[localmesh->ind3Dto2D(i)];
+    }
   }
 
   ASSERT2(((outloc == CELL_DEFAULT) && (result.getLocation() == f.getLocation())) ||
@@ -172,11 +299,12 @@ const Field3D D2DX2(const Field3D &f, CELL_LOC outloc, DIFF_METHOD method, REGIO
 const Field2D D2DX2(const Field2D &f, CELL_LOC outloc, DIFF_METHOD method, REGION region) {
   Coordinates *coords = f.getCoordinates(outloc);
 
-  Field2D result = f.getMesh()->indexD2DX2(f, outloc, method, region) / SQ(coords->dx);
+  const Coordinates::StencilCoefs &sc = coords->stencilCoefs();
+  Field2D result = f.getMesh()->indexD2DX2(f, outloc, method, region) * sc.d2dx2;
 
   if(coords->non_uniform) {
     // Correction for non-uniform f.getMesh()
-    result += coords->d1_dx * f.getMesh()->indexDDX(f, outloc, DIFF_DEFAULT, region) / coords->dx;
+    result += sc.d2dx2_corr * f.getMesh()->indexDDX(f, outloc, DIFF_DEFAULT, region);
   }
 
   return result;
@@ -187,11 +315,39 @@ const Field2D D2DX2(const Field2D &f, CELL_LOC outloc, DIFF_METHOD method, REGIO
 const Field3D D2DY2(const Field3D &f, CELL_LOC outloc, DIFF_METHOD method, REGION region) {
   Coordinates *coords = f.getCoordinates(outloc);
 
-  Field3D result = f.getMesh()->indexD2DY2(f, outloc, method, region) / SQ(coords->dy);
+  const Coordinates::StencilCoefs &sc = coords->stencilCoefs();
+  Field3D result = f.getMesh()->indexD2DY2(f, outloc, method, region) * sc.d2dy2;
 
   if(coords->non_uniform) {
     // Correction for non-uniform f.getMesh()
-    result += coords->d1_dy * f.getMesh()->indexDDY(f, outloc, DIFF_DEFAULT, region) / coords->dy;
+    result += sc.d2dy2_corr * f.getMesh()->indexDDY(f, outloc, DIFF_DEFAULT, region);
+  }
+
+  ASSERT2(((outloc == CELL_DEFAULT) && (result.getLocation() == f.getLocation())) ||
+          (result.getLocation() == outloc));
+
+  return result;
+}
+
+const Field3D D2DY2(const Field3D &f, CELL_LOC outloc, DIFF_METHOD method,
+                    const std::string &region) {
+  Mesh *localmesh = f.getMesh();
+  Coordinates *coords = f.getCoordinates(outloc);
+
+  Field3D result = localmesh->indexD2DY2(f, outloc, method, region);
+
+  const Coordinates::StencilCoefs &sc = coords->stencilCoefs();
+  if (coords->non_uniform) {
+    // Correction for non-uniform f.getMesh()
+    Field3D df = localmesh->indexDDY(f, outloc, DIFF_DEFAULT, region);
+    BOUT_FOR(i, result.getRegion(region)) {
+      const auto i2 = localmesh->ind3Dto2D(i);
+      result[i] = result[i] * sc.d2dy2[i2] + sc.d2dy2_corr[i2] * df[i];
+    }
+  } else {
+    BOUT_FOR(i, result.getRegion(region)) {
+      result[i] *= sc.d2dy2[localmesh->ind3Dto2D(i)];
+    }
   }
 
   ASSERT2(((outloc == CELL_DEFAULT) && (result.getLocation() == f.getLocation())) ||
@@ -203,10 +359,11 @@ const Field3D D2DY2(const Field3D &f, CELL_LOC outloc, DIFF_METHOD method, REGIO
 const Field2D D2DY2(const Field2D &f, CELL_LOC outloc, DIFF_METHOD method, REGION region) {
   Coordinates *coords = f.getCoordinates(outloc);
 
-  Field2D result = f.getMesh()->indexD2DY2(f, outloc, method, region) / SQ(coords->dy);
+  const Coordinates::StencilCoefs &sc = coords->stencilCoefs();
+  Field2D result = f.getMesh()->indexD2DY2(f, outloc, method, region) * sc.d2dy2;
   if(coords->non_uniform) {
     // Correction for non-uniform f.getMesh()
-    result += coords->d1_dy * f.getMesh()->indexDDY(f, outloc, DIFF_DEFAULT, region) / coords->dy;
+    result += sc.d2dy2_corr * f.getMesh()->indexDDY(f, outloc, DIFF_DEFAULT, region);
   }
   
   return result;
@@ -219,6 +376,16 @@ const Field3D D2DZ2(const Field3D &f, CELL_LOC outloc, DIFF_METHOD method, REGIO
          SQ(f.getCoordinates(outloc)->dz);
 }
 
+const Field3D D2DZ2(const Field3D &f, CELL_LOC outloc, DIFF_METHOD method,
+                    const std::string &region) {
+  Field3D result = f.getMesh()->indexD2DZ2(f, outloc, method, region);
+  const BoutReal dz2 = SQ(f.getCoordinates(outloc)->dz);
+  BOUT_FOR(i, result.getRegion(region)) {
+    result[i] /= dz2;
+  }
+  return result;
+}
+
 const Field2D D2DZ2(const Field2D &f, CELL_LOC UNUSED(outloc), DIFF_METHOD UNUSED(method),
                     REGION UNUSED(region)) {
   auto tmp = Field2D(0., f.getMesh());
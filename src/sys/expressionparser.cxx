@@ -23,6 +23,7 @@
  **************************************************************************/
 
 #include <bout/sys/expressionparser.hxx>
+#include <bout/sys/generatorbytecode.hxx>
 
 #include <utils.hxx> // for lowercase
 
@@ -49,6 +50,7 @@ namespace { // These classes only visible in this file
                     double UNUSED(t)) override {
       return x;
     }
+    void compile(GeneratorBytecode &code) override { code.emitX(); }
     const std::string str() override { return std::string("x"); }
   };
   
@@ -61,6 +63,7 @@ namespace { // These classes only visible in this file
                     double UNUSED(t)) override {
       return y;
     }
+    void compile(GeneratorBytecode &code) override { code.emitY(); }
     const std::string str() override { return std::string("y"); }
   };
 
@@ -73,6 +76,7 @@ namespace { // These classes only visible in this file
                     double UNUSED(t)) override {
       return z;
     }
+    void compile(GeneratorBytecode &code) override { code.emitZ(); }
     const std::string str() override { return std::string("z"); }
   };
   
@@ -85,10 +89,22 @@ namespace { // These classes only visible in this file
                     double t) override {
       return t;
     }
+    void compile(GeneratorBytecode &code) override { code.emitT(); }
     const std::string str() override { return std::string("t"); }
   };
 }
 
+namespace {
+  /// Canonical key for a numeric literal: enough digits that distinct
+  /// doubles get distinct keys, so e.g. "0.1" and ".1" share a node
+  /// but nothing merges which shouldn't
+  std::string numberKey(double value) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.17g", value);
+    return std::string(buf);
+  }
+}
+
 FieldGeneratorPtr FieldBinary::clone(const list<FieldGeneratorPtr> args) {
   if (args.size() != 2)
     throw ParseException("Binary operator expecting 2 arguments. Got '%lu'",
@@ -129,6 +145,12 @@ ExpressionParser::ExpressionParser() {
 }
 
 void ExpressionParser::addGenerator(const string &name, FieldGeneratorPtr g) {
+  if (gen.find(name) != gen.end()) {
+    // Redefinition: interned subtrees may embed the old definition, so
+    // start sharing afresh. Already-parsed trees are unaffected
+    interned.clear();
+    subtree_keys.clear();
+  }
   gen[name] = g;
 }
 
@@ -136,6 +158,22 @@ void ExpressionParser::addBinaryOp(char sym, FieldGeneratorPtr b, int precedence
   bin_op[sym] = std::make_pair(b, precedence);
 }
 
+FieldGeneratorPtr ExpressionParser::intern(const std::string &key, FieldGeneratorPtr g) {
+  auto it = interned.find(key);
+  if (it != interned.end())
+    return it->second; // Seen before: share the existing node
+  interned[key] = g;
+  subtree_keys[g.get()] = key;
+  return g;
+}
+
+const std::string *ExpressionParser::internKey(FieldGenerator *g) const {
+  auto it = subtree_keys.find(g);
+  if (it == subtree_keys.end())
+    return nullptr;
+  return &it->second;
+}
+
 FieldGeneratorPtr ExpressionParser::parseString(const string &input) {
   // Allocate a new lexer
   LexInfo lex(input);
@@ -160,23 +198,41 @@ FieldGeneratorPtr ExpressionParser::parseIdentifierExpr(LexInfo &lex) {
     
     // Parse arguments (if any)
     list<FieldGeneratorPtr> args;
-    
+
     lex.nextToken();
     if(lex.curtok == ')') {
       // Empty list
       lex.nextToken();
-      return it->second->clone(args);
+      return intern(name + "()", it->second->clone(args));
     }
+    // Key of the whole call, built from the arguments' keys.
+    // Abandoned if any argument doesn't have one
+    string key = name + "(";
+    bool keyed = true;
     do{
       // Should be an expression
       args.push_back(parseExpression(lex));
-      
+
+      if (keyed) {
+        const string *argkey = internKey(args.back().get());
+        if (argkey == nullptr) {
+          keyed = false;
+        } else {
+          if (args.size() > 1)
+            key += ",";
+          key += *argkey;
+        }
+      }
+
       // Now either a comma or ')'
-      
+
       if(lex.curtok == ')') {
         // Finished list
         lex.nextToken();
-        return it->second->clone(args);
+        FieldGeneratorPtr call = it->second->clone(args);
+        if (keyed)
+          call = intern(key + ")", call);
+        return call;
       }
       if(lex.curtok != ',') {
         throw ParseException("Expecting ',' or ')' in function argument list (%s)\n",
@@ -196,7 +252,7 @@ FieldGeneratorPtr ExpressionParser::parseIdentifierExpr(LexInfo &lex) {
       return g;
     }
     list<FieldGeneratorPtr> args;
-    return it->second->clone(args);
+    return intern(name, it->second->clone(args));
   }
 }
 
@@ -217,7 +273,7 @@ FieldGeneratorPtr ExpressionParser::parsePrimary(LexInfo &lex) {
   switch(lex.curtok) {
   case -1: { // a number
     lex.nextToken(); // Eat number
-    return std::make_shared<FieldValue>(lex.curval);
+    return intern(numberKey(lex.curval), std::make_shared<FieldValue>(lex.curval));
   }
   case -2: {
     return parseIdentifierExpr(lex);
@@ -225,7 +281,7 @@ FieldGeneratorPtr ExpressionParser::parsePrimary(LexInfo &lex) {
   case '-': {
     // Unary minus
     // Don't eat the minus, and return an implicit zero
-    return std::make_shared<FieldValue>(0.0);
+    return intern(numberKey(0.0), std::make_shared<FieldValue>(0.0));
   }
   case '(':
   case '[':
@@ -249,6 +305,7 @@ FieldGeneratorPtr ExpressionParser::parseBinOpRHS(LexInfo &lex, int ExprPrec, Fi
       throw ParseException("Unexpected binary operator '%c'", lex.curtok);
     
     FieldGeneratorPtr op = it->second.first;
+    char opchar = static_cast<char>(lex.curtok);
     int TokPrec = it->second.second;
   
     if (TokPrec < ExprPrec)
@@ -264,7 +321,7 @@ FieldGeneratorPtr ExpressionParser::parseBinOpRHS(LexInfo &lex, int ExprPrec, Fi
       list<FieldGeneratorPtr> args;
       args.push_front(lhs);
       args.push_back(rhs);
-      return op->clone(args);
+      return makeBinary(opchar, lhs, rhs, op->clone(args));
     }
     
     // Find next binop
@@ -282,10 +339,20 @@ FieldGeneratorPtr ExpressionParser::parseBinOpRHS(LexInfo &lex, int ExprPrec, Fi
     list<FieldGeneratorPtr> args;
     args.push_front(lhs);
     args.push_back(rhs);
-    lhs = op->clone(args);
+    lhs = makeBinary(opchar, lhs, rhs, op->clone(args));
   }
 }
 
+FieldGeneratorPtr ExpressionParser::makeBinary(char op, FieldGeneratorPtr lhs,
+                                               FieldGeneratorPtr rhs,
+                                               FieldGeneratorPtr node) {
+  const string *lkey = internKey(lhs.get());
+  const string *rkey = internKey(rhs.get());
+  if ((lkey == nullptr) || (rkey == nullptr))
+    return node; // An operand isn't shareable, so neither is this
+  return intern("(" + *lkey + string(1, op) + *rkey + ")", std::move(node));
+}
+
 FieldGeneratorPtr ExpressionParser::parseExpression(LexInfo &lex) {
   FieldGeneratorPtr lhs = parsePrimary(lex);
   return parseBinOpRHS(lex, 0, lhs);
@@ -0,0 +1,301 @@
+/**************************************************************************
+ * Compiles trees of FieldGenerators into linear bytecode
+ *
+ **************************************************************************
+ * Copyright 2010 B.D.Dudson, S.Farley, M.V.Umansky, X.Q.Xu
+ *
+ * Contact: Ben Dudson, bd512@york.ac.uk
+ *
+ * This file is part of BOUT++.
+ *
+ * BOUT++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BOUT++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with BOUT++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **************************************************************************/
+
+#include <bout/sys/generatorbytecode.hxx>
+
+#include <bout/assert.hxx>
+
+#include <cmath>
+
+/////////////////////////////////////////////
+// Compilation of the core tree nodes
+//
+// Other generators implement compile() themselves (see
+// src/field/fieldgenerators.hxx); anything without an implementation
+// goes through this default, which calls back into the tree.
+
+void FieldGenerator::compile(GeneratorBytecode &code) { code.emitGenerator(this); }
+
+void FieldValue::compile(GeneratorBytecode &code) { code.emitConstant(value); }
+
+void FieldBinary::compile(GeneratorBytecode &code) {
+  switch (op) {
+  case '+':
+  case '-':
+  case '*':
+  case '/':
+  case '^':
+    break;
+  default:
+    // An operator added through addBinaryOp, which generate() handles
+    code.emitGenerator(this);
+    return;
+  }
+  code.add(lhs);
+  code.add(rhs);
+  code.emitBinary(op);
+}
+
+/////////////////////////////////////////////
+
+GeneratorBytecode::GeneratorBytecode(FieldGeneratorPtr gen)
+    : root(std::move(gen)), depth(0), maxdepth(0), counting(true), nslots(0) {
+  ASSERT1(root != nullptr);
+
+  // Two passes. The first counts how often each node is added; the
+  // parser shares the nodes of identical subexpressions, so a repeat
+  // is the same node by address. The second pass then stores the
+  // value of any repeated subtree when it is first computed, and
+  // reloads it on the repeats
+  add(root);
+  counting = false;
+  code.clear();
+  depth = 0;
+  maxdepth = 0;
+
+  add(root);
+
+  if (maxdepth > max_stack) {
+    // Too deeply nested for the fixed evaluation stack. Fall back to
+    // evaluating the tree directly: slower, but always works
+    code.clear();
+    Instr ins;
+    ins.op = opGenerator;
+    ins.gen = root.get();
+    code.push_back(ins);
+    maxdepth = 1;
+  }
+}
+
+void GeneratorBytecode::add(const FieldGeneratorPtr &gen) {
+  FieldGenerator *node = gen.get();
+
+  if (counting) {
+    // Only descend the first time: repeats will be loads, so their
+    // children's counts are unaffected
+    if (uses[node]++ == 0)
+      gen->compile(*this);
+    return;
+  }
+
+  auto it = slot_of.find(node);
+  if (it != slot_of.end()) {
+    // Already computed at this point: reuse the stored value
+    emitLoad(it->second);
+    return;
+  }
+
+  const std::size_t start = code.size();
+  gen->compile(*this);
+
+  // Store the value if this subtree appears again and is more than a
+  // single push, which a slot load wouldn't beat
+  auto u = uses.find(node);
+  if ((u != uses.end()) && (u->second > 1) && (code.size() - start > 1)
+      && (nslots < max_slots)) {
+    slot_of[node] = nslots;
+    emitStore(nslots);
+    ++nslots;
+  }
+}
+
+void GeneratorBytecode::emit(const Instr &ins, int npop) {
+  code.push_back(ins);
+  depth += 1 - npop;
+  if (depth > maxdepth)
+    maxdepth = depth;
+}
+
+void GeneratorBytecode::emitConstant(BoutReal value) {
+  Instr ins;
+  ins.op = opConstant;
+  ins.value = value;
+  emit(ins, 0);
+}
+
+void GeneratorBytecode::emitPointer(const BoutReal *ptr) {
+  Instr ins;
+  ins.op = opPointer;
+  ins.ptr = ptr;
+  emit(ins, 0);
+}
+
+void GeneratorBytecode::emitX() {
+  Instr ins;
+  ins.op = opX;
+  emit(ins, 0);
+}
+
+void GeneratorBytecode::emitY() {
+  Instr ins;
+  ins.op = opY;
+  emit(ins, 0);
+}
+
+void GeneratorBytecode::emitZ() {
+  Instr ins;
+  ins.op = opZ;
+  emit(ins, 0);
+}
+
+void GeneratorBytecode::emitT() {
+  Instr ins;
+  ins.op = opT;
+  emit(ins, 0);
+}
+
+void GeneratorBytecode::emitBinary(char op) {
+  Instr ins;
+  switch (op) {
+  case '+':
+    ins.op = opAdd;
+    break;
+  case '-':
+    ins.op = opSub;
+    break;
+  case '*':
+    ins.op = opMul;
+    break;
+  case '/':
+    ins.op = opDiv;
+    break;
+  case '^':
+    ins.op = opPow;
+    break;
+  default:
+    throw ParseException("Unknown binary operator '%c'", op);
+  }
+  emit(ins, 2);
+}
+
+void GeneratorBytecode::emitFunc1(BoutReal (*func)(BoutReal)) {
+  Instr ins;
+  ins.op = opFunc1;
+  ins.func1 = func;
+  emit(ins, 1);
+}
+
+void GeneratorBytecode::emitFunc2(BoutReal (*func)(BoutReal, BoutReal)) {
+  Instr ins;
+  ins.op = opFunc2;
+  ins.func2 = func;
+  emit(ins, 2);
+}
+
+void GeneratorBytecode::emitGenerator(FieldGenerator *gen) {
+  Instr ins;
+  ins.op = opGenerator;
+  ins.gen = gen;
+  emit(ins, 0);
+}
+
+void GeneratorBytecode::emitStore(int slot) {
+  Instr ins;
+  ins.op = opStore;
+  ins.slot = slot;
+  emit(ins, 1); // Leaves the stack as it found it
+}
+
+void GeneratorBytecode::emitLoad(int slot) {
+  Instr ins;
+  ins.op = opLoad;
+  ins.slot = slot;
+  emit(ins, 0);
+}
+
+BoutReal GeneratorBytecode::run(BoutReal x, BoutReal y, BoutReal z, BoutReal t) const {
+  BoutReal stack[max_stack];
+  BoutReal slots[max_slots]; // Values of stored common subexpressions
+  BoutReal *sp = stack;      // Points past the top value
+
+  for (const Instr &ins : code) {
+    switch (ins.op) {
+    case opConstant:
+      *sp++ = ins.value;
+      break;
+    case opPointer:
+      *sp++ = *ins.ptr;
+      break;
+    case opX:
+      *sp++ = x;
+      break;
+    case opY:
+      *sp++ = y;
+      break;
+    case opZ:
+      *sp++ = z;
+      break;
+    case opT:
+      *sp++ = t;
+      break;
+    case opAdd:
+      sp[-2] += sp[-1];
+      --sp;
+      break;
+    case opSub:
+      sp[-2] -= sp[-1];
+      --sp;
+      break;
+    case opMul:
+      sp[-2] *= sp[-1];
+      --sp;
+      break;
+    case opDiv:
+      sp[-2] /= sp[-1];
+      --sp;
+      break;
+    case opPow:
+      sp[-2] = pow(sp[-2], sp[-1]);
+      --sp;
+      break;
+    case opFunc1:
+      sp[-1] = ins.func1(sp[-1]);
+      break;
+    case opFunc2:
+      sp[-2] = ins.func2(sp[-2], sp[-1]);
+      --sp;
+      break;
+    case opGenerator:
+      *sp++ = ins.gen->generate(x, y, z, t);
+      break;
+    case opStore:
+      slots[ins.slot] = sp[-1];
+      break;
+    case opLoad:
+      *sp++ = slots[ins.slot];
+      break;
+    }
+  }
+  return sp[-1];
+}
+
+bool GeneratorBytecode::cacheable() const {
+  for (const auto &ins : code) {
+    if ((ins.op == opT) || (ins.op == opPointer) || (ins.op == opGenerator)) {
+      return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,237 @@
+#include <mpi.h>
+#include <bout/sys/hwcounters.hxx>
+
+#include <boutcomm.hxx>
+#include <output.hxx>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+bool HwCounters::is_enabled = false;
+int HwCounters::fds[HwCounters::NCOUNTERS] = {-1, -1, -1, -1};
+int HwCounters::cache_line = 64;
+bool HwCounters::have_flops = false;
+double HwCounters::peak_flops = 0.0;
+double HwCounters::peak_bytes = 0.0;
+std::map<std::string, HwCounters::totals_info> HwCounters::totals;
+
+#ifdef __linux__
+namespace {
+/// Open one counting event on this process, all CPUs it runs on.
+/// inherit includes threads started after the call (the OpenMP
+/// pool), which rules out grouped reads, so each event is read
+/// through its own descriptor
+int openCounter(unsigned int type, unsigned long long config) {
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = type;
+  attr.config = config;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.inherit = 1;
+  return syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+} // namespace
+#endif
+
+void HwCounters::enable(long long flops_raw, int line_size, double peak_gflops,
+                        double peak_gbytes) {
+#ifdef __linux__
+  fds[CYCLES] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+  fds[INSTRUCTIONS] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+  fds[CACHE_MISSES] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+  if (flops_raw != 0) {
+    fds[FLOPS] = openCounter(PERF_TYPE_RAW,
+                             static_cast<unsigned long long>(flops_raw));
+    have_flops = (fds[FLOPS] >= 0);
+    if (!have_flops) {
+      output_warn.write("\tHwCounters: FLOP event %#llx could not be opened; "
+                        "FLOP columns will be omitted\n",
+                        static_cast<unsigned long long>(flops_raw));
+    }
+  }
+
+  if ((fds[CYCLES] < 0) && (fds[INSTRUCTIONS] < 0) && (fds[CACHE_MISSES] < 0)
+      && !have_flops) {
+    output_warn.write("\tHwCounters: no events could be opened "
+                      "(check kernel.perf_event_paranoid); disabled\n");
+    cleanup();
+    return;
+  }
+
+  cache_line = line_size;
+  peak_flops = peak_gflops;
+  peak_bytes = peak_gbytes;
+  is_enabled = true;
+#else
+  (void)flops_raw;
+  (void)line_size;
+  (void)peak_gflops;
+  (void)peak_gbytes;
+  output_warn.write(
+      "\tHwCounters needs the Linux perf_event interface; disabled\n");
+#endif
+}
+
+void HwCounters::snapshot(long long counts[NCOUNTERS]) {
+  for (int i = 0; i < NCOUNTERS; i++) {
+    counts[i] = 0;
+#ifdef __linux__
+    if (fds[i] >= 0) {
+      long long val;
+      if (read(fds[i], &val, sizeof(val)) == sizeof(val)) {
+        counts[i] = val;
+      }
+    }
+#endif
+  }
+}
+
+void HwCounters::accumulate(const std::string &path,
+                            const long long start[NCOUNTERS]) {
+  long long now[NCOUNTERS];
+  snapshot(now);
+
+  totals_info &t = totals[path];
+  for (int i = 0; i < NCOUNTERS; i++) {
+    t.counts[i] += now[i] - start[i];
+  }
+  t.hits++;
+}
+
+void HwCounters::cleanup() {
+#ifdef __linux__
+  for (int i = 0; i < NCOUNTERS; i++) {
+    if (fds[i] >= 0) {
+      close(fds[i]);
+      fds[i] = -1;
+    }
+  }
+#endif
+  totals.clear();
+  have_flops = false;
+  is_enabled = false;
+}
+
+std::string HwCounters::getReport(int top_n) {
+  int rank = BoutComm::rank();
+
+  // Processors can disagree on which paths were sampled, so take the
+  // list on rank 0 and broadcast it, as the Timer report does
+  std::string pathlist;
+  if (rank == 0) {
+    for (const auto &it : totals) {
+      pathlist += it.first;
+      pathlist += '\n';
+    }
+  }
+  int len = pathlist.length();
+  MPI_Bcast(&len, 1, MPI_INT, 0, BoutComm::get());
+  pathlist.resize(len);
+  if (len > 0)
+    MPI_Bcast(&pathlist[0], len, MPI_CHAR, 0, BoutComm::get());
+
+  // This processor's counts for each path, in rank 0's order
+  std::vector<std::string> names;
+  std::vector<long long> local;
+  for (std::string::size_type start = 0; start < pathlist.length();) {
+    std::string::size_type end = pathlist.find('\n', start);
+    std::string name = pathlist.substr(start, end - start);
+
+    auto it = totals.find(name);
+    names.push_back(name);
+    for (int i = 0; i < NCOUNTERS; i++) {
+      local.push_back((it != totals.end()) ? it->second.counts[i] : 0);
+    }
+
+    start = end + 1;
+  }
+
+  int n = names.size();
+  std::vector<long long> sum(n * NCOUNTERS);
+  MPI_Reduce(local.data(), sum.data(), n * NCOUNTERS, MPI_LONG_LONG, MPI_SUM, 0,
+             BoutComm::get());
+
+  if (rank != 0)
+    return "";
+
+  // Sort the paths by total cycles, largest first
+  std::vector<int> order(n);
+  for (int i = 0; i < n; i++)
+    order[i] = i;
+  std::sort(order.begin(), order.end(), [&sum](int a, int b) {
+    return sum[a * NCOUNTERS + CYCLES] > sum[b * NCOUNTERS + CYCLES];
+  });
+
+  int nshow = n;
+  if ((top_n > 0) && (nshow > top_n))
+    nshow = top_n;
+
+  // The machine ridge point, where a region stops being bandwidth
+  // bound, in FLOP per byte
+  const bool roofline = have_flops && (peak_flops > 0.0) && (peak_bytes > 0.0);
+  const double ridge = roofline ? peak_flops / peak_bytes : 0.0;
+
+  char buffer[256];
+  std::string res = "====== Hardware counters per Timer scope ======\n";
+  snprintf(buffer, sizeof(buffer), "%-40s %8s %10s %6s %10s", "Path", "Calls",
+           "GCycles", "IPC", "GBytes");
+  res += buffer;
+  if (have_flops) {
+    snprintf(buffer, sizeof(buffer), " %10s %8s", "GFLOP", "FLOP/B");
+    res += buffer;
+  }
+  if (roofline) {
+    snprintf(buffer, sizeof(buffer), " %8s", "Bound");
+    res += buffer;
+  }
+  res += '\n';
+
+  for (int i = 0; i < nshow; i++) {
+    const long long *c = &sum[order[i] * NCOUNTERS];
+    const double bytes = static_cast<double>(c[CACHE_MISSES]) * cache_line;
+    const double ipc =
+        (c[CYCLES] > 0)
+            ? static_cast<double>(c[INSTRUCTIONS]) / static_cast<double>(c[CYCLES])
+            : 0.0;
+
+    snprintf(buffer, sizeof(buffer), "%-40s %8d %10.3e %6.2f %10.3e",
+             names[order[i]].c_str(), totals[names[order[i]]].hits,
+             static_cast<double>(c[CYCLES]) / 1e9, ipc, bytes / 1e9);
+    res += buffer;
+    if (have_flops) {
+      const double intensity =
+          (bytes > 0.0) ? static_cast<double>(c[FLOPS]) / bytes : 0.0;
+      snprintf(buffer, sizeof(buffer), " %10.3e %8.2f",
+               static_cast<double>(c[FLOPS]) / 1e9, intensity);
+      res += buffer;
+      if (roofline) {
+        snprintf(buffer, sizeof(buffer), " %8s",
+                 (intensity < ridge) ? "memory" : "compute");
+        res += buffer;
+      }
+    }
+    res += '\n';
+  }
+
+  if (roofline) {
+    snprintf(buffer, sizeof(buffer),
+             "Ridge point %.2f FLOP/B (peaks %.1f GFLOP/s, %.1f GB/s); bytes "
+             "are cache misses x %d\n",
+             ridge, peak_flops, peak_bytes, cache_line);
+    res += buffer;
+  } else {
+    snprintf(buffer, sizeof(buffer), "Bytes are cache misses x %d\n", cache_line);
+    res += buffer;
+  }
+  return res;
+}
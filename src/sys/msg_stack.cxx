@@ -26,6 +26,8 @@
 
 #include "bout/openmpwrap.hxx"
 #include <cstdarg>
+#include <cstdio>
+#include <bout/sys/tracer.hxx>
 #include <msg_stack.hxx>
 #include <output.hxx>
 #include <string>
@@ -43,10 +45,33 @@ int MsgStack::push(const char *s, ...) {
     }
 
     if (position >= stack.size()) {
-      stack.emplace_back(buffer);
-    } else {
-      stack[position] = buffer;
+      stack.emplace_back();
+    }
+    stack[position].formatted = buffer;
+    stack[position].msg = nullptr;
+
+    if (Tracer::enabled())
+      Tracer::instant(stack[position].formatted);
+
+    position++;
+  };
+  return position - 1;
+}
+
+int MsgStack::push(const char *file, int line, const char *msg) {
+  // Defer formatting until getDump(): just keep the pointers, which
+  // must be to storage outliving the stack entry (string literals)
+  BOUT_OMP(critical(MsgStack_push)) {
+    if (position >= stack.size()) {
+      stack.emplace_back();
     }
+    stack[position].msg = msg;
+    stack[position].file = file;
+    stack[position].line = line;
+
+    // msg is a string literal, so can go into the trace by pointer
+    if (Tracer::enabled() && (msg != nullptr))
+      Tracer::instant(msg);
 
     position++;
   };
@@ -89,9 +114,17 @@ void MsgStack::dump() {
 std::string MsgStack::getDump() {
   std::string res = "====== Back trace ======\n";
   for (int i = position - 1; i >= 0; i--) {
-    if (stack[i] != "") {
+    if (stack[i].msg != nullptr) {
+      // A deferred message: format it now
+      char formatted[MSG_MAX_SIZE + 1];
+      snprintf(formatted, sizeof(formatted), "%s on line %d of '%s'", stack[i].msg,
+               stack[i].line, stack[i].file);
+      res += " -> ";
+      res += formatted;
+      res += "\n";
+    } else if (stack[i].formatted != "") {
       res += " -> ";
-      res += stack[i];
+      res += stack[i].formatted;
       res += "\n";
     }
   }
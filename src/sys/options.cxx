@@ -109,6 +109,7 @@ void Options::_set(string val, std::string source, bool force) {
   value.source = std::move(source);
   value.used = false;
   is_value = true;
+  modification++; // Lets any bound OptionHandle spot the change
 }
 
 bool Options::isSet() const {
@@ -26,6 +26,7 @@
 #include <stdarg.h>
 #include <stdio.h>
 #include <string.h>
+#include <chrono>
 #include <output.hxx>
 #include <utils.hxx>
 
@@ -95,7 +96,94 @@ void Output::vwrite(const char *string, va_list va) {
 
   bout_vsnprintf_(buffer, buffer_len, string, va);
 
-  multioutbuf_init::buf()->sputn(buffer, strlen(buffer));
+  size_t len = strlen(buffer);
+
+  if (flush_run.load(std::memory_order_relaxed)) {
+    if (len <= ring.size()) {
+      // Buffered mode: hand the formatted message to the flush thread.
+      // If the ring is full, wait for it to drain rather than bypassing
+      // it, so messages stay in order
+      while (!ringPush(buffer, len)) {
+        std::this_thread::yield();
+      }
+      return;
+    }
+    // Message bigger than the whole ring: wait for pending output so
+    // order is preserved, then fall through to a synchronous write
+    while (ring_tail.load(std::memory_order_acquire)
+           != ring_head.load(std::memory_order_acquire)) {
+      std::this_thread::yield();
+    }
+  }
+
+  multioutbuf_init::buf()->sputn(buffer, len);
+}
+
+bool Output::ringPush(const char *data, size_t len) {
+  size_t size = ring.size();
+  size_t head = ring_head.load(std::memory_order_relaxed);
+  size_t tail = ring_tail.load(std::memory_order_acquire);
+
+  if (len > size - (head - tail)) {
+    return false; // Not enough free space
+  }
+
+  for (size_t i = 0; i < len; i++) {
+    ring[(head + i) % size] = data[i];
+  }
+  ring_head.store(head + len, std::memory_order_release);
+  return true;
+}
+
+void Output::drainRing() {
+  size_t size = ring.size();
+  size_t tail = ring_tail.load(std::memory_order_relaxed);
+  size_t head = ring_head.load(std::memory_order_acquire);
+
+  while (tail != head) {
+    // Write the largest contiguous chunk; this batches many messages
+    // into one stream write (and one flush) per pass
+    size_t pos = tail % size;
+    size_t chunk = head - tail;
+    if (chunk > size - pos) {
+      chunk = size - pos;
+    }
+    multioutbuf_init::buf()->sputn(&ring[pos], chunk);
+
+    tail += chunk;
+    ring_tail.store(tail, std::memory_order_release);
+    head = ring_head.load(std::memory_order_acquire);
+  }
+}
+
+void Output::flushLoop() {
+  while (flush_run.load(std::memory_order_acquire)) {
+    drainRing();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  drainRing(); // Final drain after flushBuffer() clears the flag
+}
+
+void Output::setBuffered(int size) {
+  if (flush_run.load()) {
+    return; // Already buffered
+  }
+  if (size < 2) {
+    throw BoutException("Output buffer size must be at least 2 bytes");
+  }
+  ring.assign(static_cast<size_t>(size), 0);
+  ring_head.store(0);
+  ring_tail.store(0);
+  flush_run.store(true);
+  flush_thread = std::thread(&Output::flushLoop, this);
+}
+
+void Output::flushBuffer() {
+  if (!flush_run.load()) {
+    return;
+  }
+  flush_run.store(false);
+  flush_thread.join(); // Joins after the final drain
 }
 
 void Output::print(const char *string, ...) {
@@ -0,0 +1,125 @@
+#include <bout/sys/steppipeline.hxx>
+
+#include <field3d.hxx>
+#include <output.hxx>
+#include <unused.hxx>
+
+#include <mpi.h>
+
+#include <algorithm>
+
+bool StepPipeline::is_enabled = false;
+bool StepPipeline::have_previous = false;
+int StepPipeline::current_iter = 0;
+double StepPipeline::phase_start = 0.0;
+double StepPipeline::integrate_start = 0.0;
+double StepPipeline::monitors_time = 0.0;
+
+std::vector<StepPipeline::Window> StepPipeline::stages;
+std::vector<StepPipeline::Guard> StepPipeline::guards;
+std::vector<std::string> StepPipeline::warned;
+
+std::mutex StepPipeline::background_mutex;
+std::vector<StepPipeline::Window> StepPipeline::background_open;
+std::vector<StepPipeline::Window> StepPipeline::background_done;
+
+void StepPipeline::enable() { is_enabled = true; }
+
+void StepPipeline::stepBegin(int iter, BoutReal UNUSED(simtime)) {
+  const double now = MPI_Wtime();
+
+  if (is_enabled && have_previous) {
+    // The integration window of the previous step just closed: report
+    // its timeline. Background windows are attributed to the step in
+    // which they finished
+    std::vector<Window> done;
+    {
+      std::lock_guard<std::mutex> lock(background_mutex);
+      done.swap(background_done);
+    }
+
+    output_info.write("Pipeline step %d: monitors %.3e s [", current_iter,
+                      monitors_time);
+    for (std::vector<Window>::size_type i = 0; i < stages.size(); i++) {
+      output_info.write("%s%s: %.3e", (i == 0) ? "" : ", ", stages[i].name.c_str(),
+                        stages[i].stop - stages[i].start);
+    }
+    output_info.write("], integrate %.3e s", now - integrate_start);
+
+    for (const auto &window : done) {
+      // Portion of the window spent while the solver was integrating,
+      // i.e. genuinely overlapped with computation
+      const double overlapped =
+          std::max(0.0, std::min(window.stop, now) - std::max(window.start, integrate_start));
+      output_info.write(", background %s %.3e s (%.3e overlapped)", window.name.c_str(),
+                        window.stop - window.start, overlapped);
+    }
+    output_info.write("\n");
+  }
+
+  current_iter = iter;
+  phase_start = now;
+  stages.clear();
+  guards.clear();
+}
+
+void StepPipeline::stageBegin(const std::string &name) {
+  if (!is_enabled)
+    return;
+  stages.push_back({name, MPI_Wtime(), 0.0});
+}
+
+void StepPipeline::stageEnd() {
+  if (!is_enabled || stages.empty())
+    return;
+  stages.back().stop = MPI_Wtime();
+}
+
+void StepPipeline::guard(const Field3D *field, const std::string &name) {
+  guards.push_back({field, name, field->getGeneration()});
+}
+
+void StepPipeline::stepEnd() {
+  const double now = MPI_Wtime();
+
+  // Check for data hazards: a monitor writing to an evolving field
+  // invalidates the snapshots the background consumers are reading
+  for (const auto &g : guards) {
+    if (g.field->getGeneration() != g.generation) {
+      if (std::find(warned.begin(), warned.end(), g.name) == warned.end()) {
+        warned.push_back(g.name);
+        output_warn.write(
+            "\tWARNING: Evolving field '%s' was modified during the output stage. "
+            "Overlapping output with time-stepping is not safe for this monitor\n",
+            g.name.c_str());
+      }
+    }
+  }
+  guards.clear();
+
+  monitors_time = now - phase_start;
+  integrate_start = now;
+  have_previous = true;
+}
+
+void StepPipeline::backgroundBegin(const std::string &what) {
+  if (!is_enabled)
+    return;
+  std::lock_guard<std::mutex> lock(background_mutex);
+  background_open.push_back({what, MPI_Wtime(), 0.0});
+}
+
+void StepPipeline::backgroundEnd(const std::string &what) {
+  if (!is_enabled)
+    return;
+  std::lock_guard<std::mutex> lock(background_mutex);
+  for (auto it = background_open.begin(); it != background_open.end(); ++it) {
+    if (it->name == what) {
+      Window window = *it;
+      window.stop = MPI_Wtime();
+      background_open.erase(it);
+      background_done.push_back(window);
+      return;
+    }
+  }
+}
@@ -1,5 +1,12 @@
 #include <mpi.h>
 #include <bout/sys/timer.hxx>
+#include <bout/sys/tracer.hxx>
+
+#include <boutcomm.hxx>
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
 
 using namespace std;
 
@@ -7,18 +14,56 @@ Timer::Timer() {
   timing = getInfo("");
   timing->started = MPI_Wtime();
   timing->running = true;
+
+  if (Tracer::enabled())
+    Tracer::begin("");
+
+  if (HwCounters::enabled())
+    HwCounters::snapshot(hw_start);
+
+  parent_path = current_path;
+  path = parent_path + "/";
+  current_path = path;
+  hier_started = timing->started;
 }
 
 Timer::Timer(const std::string &label) {
   timing = getInfo(label);
   timing->started = MPI_Wtime();
   timing->running = true;
+
+  if (Tracer::enabled())
+    Tracer::begin(label);
+
+  if (HwCounters::enabled())
+    HwCounters::snapshot(hw_start);
+
+  // Record where this scope sits in the tree of running timers
+  parent_path = current_path;
+  if (parent_path.empty()) {
+    path = label;
+  } else {
+    path = parent_path + "/" + label;
+  }
+  current_path = path;
+  hier_started = timing->started;
 }
 
 Timer::~Timer() {
+  if (Tracer::enabled())
+    Tracer::end();
+
+  if (HwCounters::enabled())
+    HwCounters::accumulate(path, hw_start);
+
   double finished = MPI_Wtime();
   timing->running = false;
   timing->time += finished - timing->started;
+
+  path_info &p = paths[path];
+  p.time += finished - hier_started;
+  p.hits++;
+  current_path = parent_path;
 }
 
 double Timer::getTime() {
@@ -64,10 +109,15 @@ void Timer::cleanup() {
     delete it.second;
   }
   info.clear();
+  paths.clear();
+  current_path.clear();
 }
 
 map<std::string, Timer::timer_info*> Timer::info;
 
+map<std::string, Timer::path_info> Timer::paths;
+std::string Timer::current_path;
+
 Timer::timer_info* Timer::getInfo(const std::string &label) {
   map<string, timer_info*>::iterator it(info.find(label));
   if(it == info.end()) {
@@ -80,3 +130,71 @@ Timer::timer_info* Timer::getInfo(const std::string &label) {
   }
   return it->second;
 }
+
+std::string Timer::getPerformanceReport(int top_n) {
+  int rank = BoutComm::rank();
+  int nprocs = BoutComm::size();
+
+  // Processors can disagree on which paths were timed (e.g. rank 0
+  // does extra I/O), so take the list on rank 0 and broadcast it
+  std::string pathlist;
+  if (rank == 0) {
+    for (const auto &it : paths) {
+      pathlist += it.first;
+      pathlist += '\n';
+    }
+  }
+  int len = pathlist.length();
+  MPI_Bcast(&len, 1, MPI_INT, 0, BoutComm::get());
+  pathlist.resize(len);
+  if (len > 0)
+    MPI_Bcast(&pathlist[0], len, MPI_CHAR, 0, BoutComm::get());
+
+  // This processor's time for each path, in rank 0's order
+  std::vector<std::string> names;
+  std::vector<double> local;
+  for (std::string::size_type start = 0; start < pathlist.length();) {
+    std::string::size_type end = pathlist.find('\n', start);
+    std::string name = pathlist.substr(start, end - start);
+
+    auto it = paths.find(name);
+    names.push_back(name);
+    local.push_back((it != paths.end()) ? it->second.time : 0.0);
+
+    start = end + 1;
+  }
+
+  int n = names.size();
+  std::vector<double> tmin(n), tmax(n), tsum(n);
+  MPI_Reduce(local.data(), tmin.data(), n, MPI_DOUBLE, MPI_MIN, 0, BoutComm::get());
+  MPI_Reduce(local.data(), tmax.data(), n, MPI_DOUBLE, MPI_MAX, 0, BoutComm::get());
+  MPI_Reduce(local.data(), tsum.data(), n, MPI_DOUBLE, MPI_SUM, 0, BoutComm::get());
+
+  if (rank != 0)
+    return "";
+
+  // Sort the paths by mean time, largest first
+  std::vector<int> order(n);
+  for (int i = 0; i < n; i++)
+    order[i] = i;
+  std::sort(order.begin(), order.end(),
+            [&tsum](int a, int b) { return tsum[a] > tsum[b]; });
+
+  int nshow = n;
+  if ((top_n > 0) && (nshow > top_n))
+    nshow = top_n;
+
+  char buffer[256];
+  std::string res = "====== Timings of nested Timer scopes ======\n";
+  snprintf(buffer, sizeof(buffer), "%-40s %8s %10s %10s %10s\n", "Path", "Calls",
+           "Min", "Mean", "Max");
+  res += buffer;
+  for (int i = 0; i < nshow; i++) {
+    int j = order[i];
+    snprintf(buffer, sizeof(buffer), "%-40s %8d %10.3e %10.3e %10.3e\n",
+             names[j].c_str(), paths[names[j]].hits, tmin[j], tsum[j] / nprocs,
+             tmax[j]);
+    res += buffer;
+  }
+  return res;
+}
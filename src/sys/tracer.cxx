@@ -0,0 +1,132 @@
+#include <bout/sys/tracer.hxx>
+
+#include <boutcomm.hxx>
+#include <boutexception.hxx>
+#include <output.hxx>
+
+#include <chrono>
+#include <cstdio>
+#include <set>
+
+bool Tracer::is_enabled = false;
+std::vector<Tracer::Event> Tracer::ring;
+std::vector<Tracer::Event>::size_type Tracer::next = 0;
+bool Tracer::wrapped = false;
+
+namespace {
+/// Time origin, set by enable()
+std::chrono::steady_clock::time_point trace_origin;
+
+/// Interned event names. Set elements are never moved, so the
+/// pointers handed out stay valid until cleanup()
+std::set<std::string> trace_names;
+
+/// Copy \p s with the characters JSON strings can't contain escaped
+std::string escaped(const char *s) {
+  std::string res;
+  for (; *s != '\0'; s++) {
+    if ((*s == '"') || (*s == '\\')) {
+      res += '\\';
+      res += *s;
+    } else if (*s == '\n') {
+      res += "\\n";
+    } else {
+      res += *s;
+    }
+  }
+  return res;
+}
+} // namespace
+
+void Tracer::enable(int nevents) {
+  if (nevents < 2) {
+    throw BoutException("Tracer::enable: buffer of %d events is too small", nevents);
+  }
+  ring.assign(static_cast<std::vector<Event>::size_type>(nevents), Event());
+  next = 0;
+  wrapped = false;
+  trace_origin = std::chrono::steady_clock::now();
+  is_enabled = true;
+  output_info.write("Timeline tracing enabled: %d events per processor (%d KB)\n",
+                    nevents, static_cast<int>((nevents * sizeof(Event)) / 1024));
+}
+
+long long Tracer::now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now() - trace_origin)
+      .count();
+}
+
+void Tracer::record(char phase, const char *name) {
+  Event &e = ring[next];
+  e.name = name;
+  e.time_ns = now();
+  e.phase = phase;
+  if (++next == ring.size()) {
+    next = 0;
+    wrapped = true;
+  }
+}
+
+const char *Tracer::intern(const std::string &label) {
+  return trace_names.insert(label).first->c_str();
+}
+
+void Tracer::begin(const std::string &label) { record('B', intern(label)); }
+
+void Tracer::end() { record('E', nullptr); }
+
+void Tracer::instant(const std::string &label) { record('i', intern(label)); }
+
+void Tracer::instant(const char *name) { record('i', name); }
+
+void Tracer::write(const std::string &basename) {
+  if (!is_enabled) {
+    return;
+  }
+
+  const int rank = BoutComm::rank();
+  char suffix[32];
+  snprintf(suffix, sizeof(suffix), ".%d.json", rank);
+  const std::string filename = basename + suffix;
+
+  FILE *file = fopen(filename.c_str(), "w");
+  if (file == nullptr) {
+    throw BoutException("Tracer::write: could not open trace file %s",
+                        filename.c_str());
+  }
+
+  // Oldest event first: after a wrap the slot about to be
+  // overwritten holds the oldest surviving event
+  const std::vector<Event>::size_type count = wrapped ? ring.size() : next;
+  const std::vector<Event>::size_type start = wrapped ? next : 0;
+
+  fprintf(file, "[\n");
+  for (std::vector<Event>::size_type i = 0; i < count; i++) {
+    const Event &e = ring[(start + i) % ring.size()];
+    const double ts_us = static_cast<double>(e.time_ns) * 1e-3; // Format wants us
+    if (e.phase == 'E') {
+      fprintf(file, "{\"ph\":\"E\",\"ts\":%.3f,\"pid\":%d,\"tid\":0},\n", ts_us, rank);
+    } else if (e.phase == 'i') {
+      fprintf(file, "{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":%d,"
+                    "\"tid\":0},\n",
+              escaped(e.name).c_str(), ts_us, rank);
+    } else {
+      fprintf(file, "{\"name\":\"%s\",\"ph\":\"B\",\"ts\":%.3f,\"pid\":%d,\"tid\":0},\n",
+              escaped(e.name).c_str(), ts_us, rank);
+    }
+  }
+  fprintf(file, "{}]\n"); // Dummy last entry so the list doesn't end on a comma
+  fclose(file);
+
+  output_info.write("Wrote %d trace events to %s\n", static_cast<int>(count),
+                    filename.c_str());
+}
+
+void Tracer::cleanup() {
+  is_enabled = false;
+  std::vector<Event>().swap(ring);
+  next = 0;
+  wrapped = false;
+  trace_names.clear();
+}
@@ -0,0 +1,104 @@
+#include <bout/sys/watchdog.hxx>
+
+#include <bout/sys/timer.hxx>
+#include <boutcomm.hxx>
+#include <boutexception.hxx>
+#include <msg_stack.hxx>
+
+#include <chrono>
+#include <cstdio>
+
+bool Watchdog::is_enabled = false;
+std::atomic<uint64_t> Watchdog::count{0};
+std::atomic<const char *> Watchdog::current_phase{"startup"};
+std::atomic<bool> Watchdog::run{false};
+std::thread Watchdog::monitor_thread;
+BoutReal Watchdog::timeout = 0.0;
+bool Watchdog::abort_on_stall = false;
+int Watchdog::mype = 0;
+
+void Watchdog::enable(BoutReal timeout_in, bool abort_in) {
+  if (is_enabled)
+    return;
+
+  if (timeout_in <= 0.0) {
+    throw BoutException("Watchdog: timeout must be positive, got %e", timeout_in);
+  }
+
+  timeout = timeout_in;
+  abort_on_stall = abort_in;
+  MPI_Comm_rank(BoutComm::get(), &mype);
+
+  run.store(true);
+  is_enabled = true; // Heartbeats start recording from here
+  monitor_thread = std::thread(monitorLoop);
+}
+
+void Watchdog::disable() {
+  if (!is_enabled)
+    return;
+  is_enabled = false;
+  run.store(false);
+  monitor_thread.join();
+}
+
+void Watchdog::monitorLoop() {
+  using clock = std::chrono::steady_clock;
+
+  // Check often enough that a stall is caught soon after the
+  // threshold, without the polling itself costing anything noticeable
+  const auto poll = std::chrono::milliseconds(
+      static_cast<int>(1000. * timeout / 10.) + 1);
+
+  uint64_t last_count = count.load(std::memory_order_relaxed);
+  auto last_change = clock::now();
+
+  while (run.load()) {
+    std::this_thread::sleep_for(poll);
+
+    const uint64_t now_count = count.load(std::memory_order_relaxed);
+    if (now_count != last_count) {
+      last_count = now_count;
+      last_change = clock::now();
+      continue;
+    }
+
+    const BoutReal stalled_for =
+        std::chrono::duration<BoutReal>(clock::now() - last_change).count();
+    if (stalled_for < timeout)
+      continue;
+
+    reportStall(stalled_for);
+
+    if (abort_on_stall) {
+      // Free the allocation rather than idling until the job limit.
+      // Healthy processors reach their own timeout within one poll
+      // interval of this one, so every stalled rank gets to report
+      MPI_Abort(BoutComm::get(), 1);
+    }
+
+    // Keep monitoring; if the stall persists, report again after
+    // another full timeout
+    last_change = clock::now();
+  }
+}
+
+void Watchdog::reportStall(BoutReal stalled_for) {
+  // Written directly to stderr: the usual output streams could be
+  // blocked (buffered logging, a hung filesystem) and are owned by
+  // the thread being diagnosed. The stalled thread sits in a blocking
+  // call, so the stacks read here are quiescent
+  fprintf(stderr,
+          "\nWATCHDOG: processor %d stalled for %.1f s (no heartbeat; last "
+          "phase '%s', %llu beats)\n",
+          mype, stalled_for, current_phase.load(std::memory_order_relaxed),
+          static_cast<unsigned long long>(count.load(std::memory_order_relaxed)));
+
+  std::string msgs = msg_stack.getDump();
+  fprintf(stderr, "WATCHDOG: message stack at stall:\n%s", msgs.c_str());
+
+  std::string timers = Timer::getPerformanceReport();
+  fprintf(stderr, "WATCHDOG: timers at stall:\n%s\n", timers.c_str());
+
+  fflush(stderr);
+}
@@ -0,0 +1,111 @@
+/**************************************************************************
+ * Timing harness for the core-kernel microbenchmarks
+ *
+ * Runs each kernel in a calibrated loop, takes the best of several
+ * repeats (the minimum is the least noisy estimator for a fixed-work
+ * kernel), and synchronises across processors so the reported time is
+ * that of the slowest rank. Results can be written as JSON for
+ * comparison between machines and releases with compare.py
+ *
+ **************************************************************************/
+
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#include "mpi.h"
+
+#include <boutcomm.hxx>
+#include <output.hxx>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+class BenchmarkRunner {
+public:
+  /// Time \p kernel, identified as \p name in the report. The first
+  /// call is a discarded warm-up (allocations, FFT plans, first-touch)
+  template <typename F> void run(const std::string &name, F &&kernel) {
+    MPI_Comm comm = BoutComm::get();
+    MPI_Barrier(comm);
+
+    kernel(); // Warm up
+
+    // Calibrate: aim for ~0.2s per repeat so short kernels are
+    // averaged over many iterations
+    MPI_Barrier(comm);
+    double single = MPI_Wtime();
+    kernel();
+    single = MPI_Wtime() - single;
+    MPI_Allreduce(MPI_IN_PLACE, &single, 1, MPI_DOUBLE, MPI_MAX, comm);
+
+    int iters = 1;
+    if (single > 0.0) {
+      iters = static_cast<int>(0.2 / single);
+    }
+    if (iters < 1)
+      iters = 1;
+    if (iters > 10000)
+      iters = 10000;
+
+    double best = -1.0;
+    for (int rep = 0; rep < nrepeats; rep++) {
+      MPI_Barrier(comm);
+      double start = MPI_Wtime();
+      for (int i = 0; i < iters; i++) {
+        kernel();
+      }
+      double elapsed = (MPI_Wtime() - start) / iters;
+      // The benchmark is only as fast as its slowest rank
+      MPI_Allreduce(MPI_IN_PLACE, &elapsed, 1, MPI_DOUBLE, MPI_MAX, comm);
+      if ((best < 0.0) || (elapsed < best)) {
+        best = elapsed;
+      }
+    }
+
+    results.push_back({name, best, iters});
+    output.write("\t%-24s %.6e s/iter  (best of %d x %d iters)\n", name.c_str(), best,
+                 nrepeats, iters);
+  }
+
+  /// Write all results as JSON to \p filename (rank 0 only), for
+  /// archiving and baseline comparison
+  void writeJSON(const std::string &filename) const {
+    int rank;
+    MPI_Comm_rank(BoutComm::get(), &rank);
+    if (rank != 0) {
+      return;
+    }
+    int nprocs;
+    MPI_Comm_size(BoutComm::get(), &nprocs);
+
+    std::ofstream file(filename);
+    file.precision(9);
+    file << "{\n";
+    file << "  \"version\": \"" << BOUT_VERSION_STRING << "\",\n";
+    file << "  \"nprocs\": " << nprocs << ",\n";
+    file << "  \"results\": {\n";
+    for (std::size_t i = 0; i < results.size(); i++) {
+      file << "    \"" << results[i].name << "\": {\"seconds\": " << results[i].seconds
+           << ", \"iterations\": " << results[i].iterations << "}";
+      file << ((i + 1 < results.size()) ? ",\n" : "\n");
+    }
+    file << "  }\n";
+    file << "}\n";
+
+    output.write("Wrote benchmark results to %s\n", filename.c_str());
+  }
+
+private:
+  struct Result {
+    std::string name;
+    double seconds; ///< Best per-iteration time of the slowest rank
+    int iterations;
+  };
+
+  std::vector<Result> results;
+
+  static const int nrepeats = 5;
+};
+
+#endif // __BENCH_H__
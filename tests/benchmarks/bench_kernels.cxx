@@ -0,0 +1,115 @@
+/*
+ * Microbenchmarks for the BOUT++ core kernels
+ *
+ * Times the hot paths that dominate production runs: generated field
+ * operations, finite-difference derivatives per scheme, the bracket
+ * operators, guard-cell communication, the z FFTs, Laplacian inversion
+ * and raw Array store throughput. Results are printed and written as
+ * JSON (benchmark_output option, default benchmarks.json) so runs can
+ * be archived per machine and compared between releases with
+ * compare.py
+ */
+
+#include <bout.hxx>
+
+#include <bout/openmpwrap.hxx>
+#include <derivs.hxx>
+#include <difops.hxx>
+#include <fft.hxx>
+#include <field_factory.hxx>
+#include <invert_laplace.hxx>
+
+#include "bench.hxx"
+
+int main(int argc, char **argv) {
+
+  BoutInitialise(argc, argv);
+  {
+    BenchmarkRunner bench;
+
+    // Smooth test data, communicated so the guard cells are valid
+    FieldFactory *factory = FieldFactory::get();
+    Field3D a = factory->create3D("1 + 0.5*sin(2*pi*x)*cos(3*z)", nullptr, mesh);
+    Field3D b = factory->create3D("2 + 0.1*cos(4*pi*x)*sin(z)", nullptr, mesh);
+    Field3D phi = factory->create3D("0.3*sin(2*pi*x)*sin(2*z)", nullptr, mesh);
+    mesh->communicate(a, b, phi);
+
+    Field3D result;
+
+    output.write("\nRunning core-kernel benchmarks\n\n");
+
+    // Raw Array store throughput: the upper bound for every
+    // memory-bound field operation
+    {
+      Array<BoutReal> arr(1 << 22);
+      BoutReal *data = arr.begin();
+      const int n = arr.size();
+      bench.run("array_store", [&]() {
+        BOUT_OMP(parallel for schedule(OPENMP_SCHEDULE))
+        for (int i = 0; i < n; i++) {
+          data[i] = 0.5 * i;
+        }
+      });
+    }
+
+    // Generated field operations
+    bench.run("fieldops_add", [&]() { result = a + b; });
+    bench.run("fieldops_triad", [&]() { result = a + b * phi; });
+    bench.run("fieldops_update", [&]() { result += a; });
+
+    // Finite-difference derivatives, per direction and scheme
+    bench.run("ddx_c2", [&]() { result = DDX(a, CELL_DEFAULT, DIFF_C2); });
+    bench.run("ddx_c4", [&]() { result = DDX(a, CELL_DEFAULT, DIFF_C4); });
+    bench.run("ddy_c2", [&]() { result = DDY(a, CELL_DEFAULT, DIFF_C2); });
+    bench.run("ddz_c2", [&]() { result = DDZ(a, CELL_DEFAULT, DIFF_C2); });
+    bench.run("ddz_c4", [&]() { result = DDZ(a, CELL_DEFAULT, DIFF_C4); });
+    bench.run("ddz_fft", [&]() { result = DDZ(a, CELL_DEFAULT, DIFF_FFT); });
+    bench.run("d2dx2_c2", [&]() { result = D2DX2(a, CELL_DEFAULT, DIFF_C2); });
+
+    // Bracket operators
+    bench.run("bracket_std", [&]() { result = bracket(phi, a, BRACKET_STD); });
+    bench.run("bracket_simple", [&]() { result = bracket(phi, a, BRACKET_SIMPLE); });
+    bench.run("bracket_arakawa", [&]() { result = bracket(phi, a, BRACKET_ARAKAWA); });
+
+    // Guard-cell communication on the synthetic mesh
+    bench.run("communicate_1field", [&]() { mesh->communicate(a); });
+    bench.run("communicate_3fields", [&]() { mesh->communicate(a, b, phi); });
+
+    // z FFTs, one transform per pencil and the batched variant
+    {
+      const int ncz = mesh->LocalNz;
+      const int npencils = mesh->LocalNx * mesh->LocalNy;
+      Array<dcomplex> spectrum(ncz / 2 + 1);
+      Array<dcomplex> spectra(npencils * (ncz / 2 + 1));
+      Field3D back = a; // Separate output so 'a' stays intact
+      back.allocate();
+
+      bench.run("rfft_pencils", [&]() {
+        for (int jx = 0; jx < mesh->LocalNx; jx++) {
+          for (int jy = 0; jy < mesh->LocalNy; jy++) {
+            rfft(&a(jx, jy, 0), ncz, spectrum.begin());
+          }
+        }
+      });
+
+      bench.run("rfft_irfft_many", [&]() {
+        rfft_many(&a(0, 0, 0), ncz, npencils, spectra.begin());
+        irfft_many(spectra.begin(), ncz, npencils, &back(0, 0, 0));
+      });
+    }
+
+    // Laplacian inversion with the configured implementation
+    {
+      Laplacian *lap = Laplacian::create();
+      bench.run("laplacian_solve", [&]() { result = lap->solve(a); });
+      delete lap;
+    }
+
+    std::string benchmark_output;
+    Options::getRoot()->get("benchmark_output", benchmark_output, "benchmarks.json");
+    bench.writeJSON(benchmark_output);
+  }
+  BoutFinalise();
+
+  return 0;
+}
@@ -0,0 +1,83 @@
+#!/usr/bin/env python
+"""Compare two benchmark JSON files produced by bench_kernels or the
+scenario benchmarks.
+
+Usage:
+    compare.py baseline.json new.json [--tolerance 0.1]
+
+Prints the per-benchmark change and exits non-zero if any benchmark
+regressed by more than the tolerance, so the comparison can gate a
+release or machine upgrade. When both files carry allocation counts
+(the scenarios do), an increase beyond the tolerance is also a
+regression: extra allocations in a pinned run mean the store stopped
+recycling somewhere.
+"""
+
+from __future__ import print_function
+
+import argparse
+import json
+import sys
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("baseline", help="Baseline JSON file")
+    parser.add_argument("new", help="New JSON file to compare against the baseline")
+    parser.add_argument("--tolerance", type=float, default=0.1,
+                        help="Allowed fractional slowdown before failing (default 0.1)")
+    args = parser.parse_args()
+
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+    with open(args.new) as f:
+        new = json.load(f)
+
+    if baseline.get("nprocs") != new.get("nprocs"):
+        print("WARNING: processor counts differ (%s vs %s)"
+              % (baseline.get("nprocs"), new.get("nprocs")))
+
+    base_results = baseline["results"]
+    new_results = new["results"]
+
+    regressions = []
+    print("%-24s %14s %14s %9s" % ("benchmark", "baseline [s]", "new [s]", "change"))
+    for name in sorted(base_results):
+        if name not in new_results:
+            print("%-24s %14.6e %14s   missing" % (name, base_results[name]["seconds"], "-"))
+            continue
+        old_t = base_results[name]["seconds"]
+        new_t = new_results[name]["seconds"]
+        change = (new_t - old_t) / old_t
+        flag = ""
+        if change > args.tolerance:
+            flag = "  REGRESSION"
+            regressions.append(name)
+        print("%-24s %14.6e %14.6e %+8.1f%%%s" % (name, old_t, new_t, 100 * change, flag))
+
+        if "allocations" in base_results[name] and "allocations" in new_results[name]:
+            old_a = base_results[name]["allocations"]
+            new_a = new_results[name]["allocations"]
+            change = (new_a - old_a) / float(old_a) if old_a else 0.0
+            flag = ""
+            if change > args.tolerance:
+                flag = "  REGRESSION"
+                if name not in regressions:
+                    regressions.append(name)
+            print("%-24s %14d %14d %+8.1f%%%s"
+                  % ("  (allocations)", old_a, new_a, 100 * change, flag))
+
+    for name in sorted(new_results):
+        if name not in base_results:
+            print("%-24s %14s %14.6e   new" % (name, "-", new_results[name]["seconds"]))
+
+    if regressions:
+        print("\n%d benchmark(s) regressed by more than %.0f%%: %s"
+              % (len(regressions), 100 * args.tolerance, ", ".join(regressions)))
+        return 1
+    print("\nNo regressions beyond %.0f%%" % (100 * args.tolerance))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
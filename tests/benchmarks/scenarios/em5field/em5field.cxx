@@ -0,0 +1,89 @@
+/// Electromagnetic 5-field scenario benchmark
+///
+/// A reduced-MHD style model evolving density, temperature, vorticity,
+/// parallel velocity and the parallel vector potential, with magnetic
+/// flutter in the parallel gradients and an Ohm's law coupling psi to
+/// the current. The heaviest of the three scenarios: five evolving
+/// 3D fields, two communications and a Laplacian inversion plus a
+/// Delp2 for the current every RHS call. Inputs are pinned in
+/// data/BOUT.inp
+
+#include <bout/physicsmodel.hxx>
+#include <invert_laplace.hxx>
+#include <derivs.hxx>
+
+#include "../scenario.hxx"
+
+class EM5Field : public PhysicsModel {
+private:
+  Field3D n, Te, U, Vpar, psi; // Evolving fields
+  Field3D phi, jpar;           // Potential and parallel current
+  Field3D p;                   // Pressure n*Te
+
+  // Model parameters
+  BoutReal beta;  // Plasma beta: strength of the electromagnetic coupling
+  BoutReal eta;   // Parallel resistivity
+  BoutReal kappa; // Curvature drive
+  BoutReal mu;    // Viscosity
+  BoutReal chi;   // Parallel heat conduction
+
+  class Laplacian *phiSolver; // Laplacian solver for U -> phi
+
+  /// Parallel gradient including magnetic flutter,
+  /// b dot Grad(f) = Grad_par(f) - beta * [psi, f]
+  Field3D Grad_parP(const Field3D &f) {
+    return Grad_par(f) - beta * bracket(psi, f, BRACKET_ARAKAWA);
+  }
+
+protected:
+  int init(bool UNUSED(restarting)) {
+    Options *options = Options::getRoot()->getSection("em5field");
+    OPTION(options, beta,  1e-3);
+    OPTION(options, eta,   1e-3);
+    OPTION(options, kappa, 0.1);
+    OPTION(options, mu,    1e-3);
+    OPTION(options, chi,   1e-2);
+
+    SOLVE_FOR5(n, Te, U, Vpar, psi);
+    SAVE_REPEAT2(phi, jpar);
+
+    phiSolver = Laplacian::create();
+    phi = 0.; // Starting phi
+
+    return 0;
+  }
+
+  int rhs(BoutReal UNUSED(time)) {
+    // Solve for potential
+    phi = phiSolver->solve(U, phi);
+
+    mesh->communicate(n, Te, U, Vpar, psi, phi);
+
+    // Parallel current from Ampere's law
+    jpar = -Delp2(psi);
+    mesh->communicate(jpar);
+
+    p = n * Te;
+
+    // Density
+    ddt(n) = -bracket(phi, n, BRACKET_ARAKAWA) - Grad_parP(n * Vpar)
+             + kappa * DDZ(phi);
+
+    // Temperature, with parallel conduction
+    ddt(Te) = -bracket(phi, Te, BRACKET_ARAKAWA) + chi * Grad2_par2(Te);
+
+    // Vorticity
+    ddt(U) = -bracket(phi, U, BRACKET_ARAKAWA) + Grad_parP(jpar) + kappa * DDZ(p)
+             + mu * Delp2(U);
+
+    // Parallel velocity
+    ddt(Vpar) = -bracket(phi, Vpar, BRACKET_ARAKAWA) - Grad_parP(p);
+
+    // Ohm's law
+    ddt(psi) = -Grad_parP(phi) + eta * jpar;
+
+    return 0;
+  }
+};
+
+SCENARIO_MAIN(EM5Field, "em5field");
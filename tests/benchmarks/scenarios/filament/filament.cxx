@@ -0,0 +1,79 @@
+/// SOL filament scenario benchmark
+///
+/// An isothermal blob/filament model in the scrape-off layer style:
+/// density, parallel momentum and vorticity with the finite-volume
+/// flux-conservative operators (FV::Div_par with MC limiters and wave
+/// speeds, FV::Div_a_Laplace_perp for diffusion), curvature drive and
+/// a Laplacian inversion. Exercises the fv_ops stencils and the
+/// field-aligned transforms. Inputs are pinned in data/BOUT.inp
+
+#include <bout/physicsmodel.hxx>
+#include <bout/fv_ops.hxx>
+#include <invert_laplace.hxx>
+#include <derivs.hxx>
+
+#include "../scenario.hxx"
+
+class Filament : public PhysicsModel {
+private:
+  Field3D n, nv, vort; // Evolving density, parallel momentum, vorticity
+  Field3D phi;         // Electrostatic potential
+
+  // Model parameters
+  BoutReal Te;        // Electron temperature (normalised)
+  BoutReal g;         // Curvature drive
+  Field3D Dn, Dvort;  // Perpendicular diffusion coefficients
+
+  class Laplacian *phiSolver; // Laplacian solver for vort -> phi
+
+protected:
+  int init(bool UNUSED(restarting)) {
+    BoutReal dn, dvort;
+
+    Options *options = Options::getRoot()->getSection("filament");
+    OPTION(options, Te, 1.0);
+    OPTION(options, g,  5e-4);
+    OPTION(options, dn,    1e-3);
+    OPTION(options, dvort, 1e-3);
+
+    // FV::Div_a_Laplace_perp takes field coefficients
+    Dn = dn;
+    Dvort = dvort;
+
+    SOLVE_FOR3(n, nv, vort);
+    SAVE_REPEAT(phi);
+
+    phiSolver = Laplacian::create();
+    phi = 0.; // Starting phi
+
+    return 0;
+  }
+
+  int rhs(BoutReal UNUSED(time)) {
+    // Solve for potential
+    phi = phiSolver->solve(vort, phi);
+
+    mesh->communicate(n, nv, vort, phi);
+
+    // Parallel velocity and sound speed, used as the wave speed in the
+    // flux limiters. Floor the density to keep v finite in the far SOL
+    Field3D nlim = floor(n, 1e-4);
+    Field3D v = nv / nlim;
+    Field3D cs = sqrt(Te) + abs(v);
+
+    ddt(n) = -bracket(phi, n, BRACKET_ARAKAWA) - FV::Div_par(n, v, cs)
+             + FV::Div_a_Laplace_perp(Dn, n);
+
+    // Parallel momentum, with the isothermal pressure gradient
+    ddt(nv) = -bracket(phi, nv, BRACKET_ARAKAWA) - FV::Div_par(nv, v, cs)
+              - Te * Grad_par(n);
+
+    // Vorticity, driven by curvature acting on the pressure
+    ddt(vort) = -bracket(phi, vort, BRACKET_ARAKAWA) - FV::Div_par(vort, v, cs)
+                + g * Te * DDZ(n) + FV::Div_a_Laplace_perp(Dvort, vort);
+
+    return 0;
+  }
+};
+
+SCENARIO_MAIN(Filament, "filament");
@@ -0,0 +1,110 @@
+/**************************************************************************
+ * Harness for the end-to-end scenario benchmarks
+ *
+ * A scenario is a small but complete physics model run to completion
+ * with pinned inputs, so the number measured is the whole stack —
+ * solver, RHS, inversions, communication and I/O — rather than one
+ * kernel. SCENARIO_MAIN() replaces BOUTMAIN: it times solver->solve()
+ * between barriers, counts system allocations over the run with
+ * ArrayMetrics, takes the maximum of both over ranks, and writes a
+ * JSON report compatible with ../compare.py so a run can be gated
+ * against an archived baseline.
+ *
+ **************************************************************************/
+
+#ifndef __SCENARIO_H__
+#define __SCENARIO_H__
+
+#include "mpi.h"
+
+#include <bout/array_metrics.hxx>
+#include <bout/physicsmodel.hxx>
+#include <boutcomm.hxx>
+#include <options.hxx>
+#include <output.hxx>
+
+#include <fstream>
+#include <string>
+
+/// Write the scenario's wall time and allocation count as JSON to the
+/// file given by the root option benchmark_output (rank 0 only). The
+/// schema matches the microbenchmarks', with an extra "allocations"
+/// field, so compare.py can gate both
+inline void writeScenarioReport(const std::string &name, double seconds,
+                                unsigned long long allocations) {
+  int rank;
+  MPI_Comm_rank(BoutComm::get(), &rank);
+  if (rank != 0) {
+    return;
+  }
+  int nprocs;
+  MPI_Comm_size(BoutComm::get(), &nprocs);
+
+  int iterations;
+  std::string filename;
+  Options *options = Options::getRoot();
+  options->get("nout", iterations, 1);
+  options->get("benchmark_output", filename, name + ".json");
+
+  std::ofstream file(filename);
+  file.precision(9);
+  file << "{\n";
+  file << "  \"version\": \"" << BOUT_VERSION_STRING << "\",\n";
+  file << "  \"nprocs\": " << nprocs << ",\n";
+  file << "  \"results\": {\n";
+  file << "    \"" << name << "\": {\"seconds\": " << seconds
+       << ", \"iterations\": " << iterations << ", \"allocations\": " << allocations
+       << "}\n";
+  file << "  }\n";
+  file << "}\n";
+
+  output.write("Wrote scenario results to %s\n", filename.c_str());
+}
+
+/// Variant of BOUTMAIN timing the run and counting allocations. The
+/// model and inputs must be deterministic: same work every run, fixed
+/// (non-adaptive) internal timestep
+#define SCENARIO_MAIN(ModelClass, name)                                  \
+  int main(int argc, char **argv) {                                      \
+    int init_err = BoutInitialise(argc, argv);                           \
+    if (init_err < 0)                                                    \
+      return 0;                                                          \
+    else if (init_err > 0)                                               \
+      return init_err;                                                   \
+    try {                                                                \
+      ModelClass *model = new ModelClass();                              \
+      Solver *solver = Solver::create();                                 \
+      solver->setModel(model);                                           \
+      Monitor *bout_monitor = new BoutMonitor(solver);                   \
+      solver->addMonitor(bout_monitor, Solver::BACK);                    \
+      solver->outputVars(dump);                                          \
+                                                                         \
+      ArrayMetrics::enabled() = true;                                    \
+      ArrayMetrics::reset();                                             \
+                                                                         \
+      MPI_Barrier(BoutComm::get());                                      \
+      double elapsed = MPI_Wtime();                                      \
+      solver->solve();                                                   \
+      elapsed = MPI_Wtime() - elapsed;                                   \
+      MPI_Allreduce(MPI_IN_PLACE, &elapsed, 1, MPI_DOUBLE, MPI_MAX,      \
+                    BoutComm::get());                                    \
+                                                                         \
+      unsigned long long allocs = ArrayMetrics::total().allocations;     \
+      MPI_Allreduce(MPI_IN_PLACE, &allocs, 1, MPI_UNSIGNED_LONG_LONG,    \
+                    MPI_MAX, BoutComm::get());                           \
+                                                                         \
+      writeScenarioReport(name, elapsed, allocs);                        \
+                                                                         \
+      delete model;                                                      \
+      delete solver;                                                     \
+      delete bout_monitor;                                               \
+    } catch (BoutException &e) {                                         \
+      output << "Error encountered\n";                                   \
+      output << e.what() << endl;                                        \
+      MPI_Abort(BoutComm::get(), 1);                                     \
+    }                                                                    \
+    BoutFinalise();                                                      \
+    return 0;                                                            \
+  }
+
+#endif // __SCENARIO_H__
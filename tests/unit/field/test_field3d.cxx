@@ -8,6 +8,7 @@
 #include "bout/mesh.hxx"
 #include "boutexception.hxx"
 #include "field3d.hxx"
+#include "interpolation.hxx"
 #include "output.hxx"
 #include "test_extras.hxx"
 #include "unused.hxx"
@@ -278,6 +279,53 @@ TEST_F(Field3DTest, SplitThenMergeYupYDown) {
   EXPECT_EQ(&field, &ydown2);
 }
 
+TEST_F(Field3DTest, ParallelSlicesUpToDate) {
+  Field3D field;
+
+  field = 0.;
+
+  // No yup/ydown fields yet
+  EXPECT_FALSE(field.parallelSlicesUpToDate());
+
+  field.splitYupYdown();
+
+  // Slices exist but have not been calculated
+  EXPECT_FALSE(field.parallelSlicesUpToDate());
+
+  field.parallelSlicesCalculated();
+
+  EXPECT_TRUE(field.parallelSlicesUpToDate());
+
+  // Writing to the field makes the slices stale
+  field.allocate();
+
+  EXPECT_FALSE(field.parallelSlicesUpToDate());
+
+  field.parallelSlicesCalculated();
+  field.invalidateParallelSlices();
+
+  EXPECT_FALSE(field.parallelSlicesUpToDate());
+
+  // Assignment also makes the slices stale
+  field.parallelSlicesCalculated();
+  field = Field3D(1.0);
+
+  EXPECT_FALSE(field.parallelSlicesUpToDate());
+
+  // Compound assignment writes in place on unique data, and must
+  // still make the slices stale
+  field.splitYupYdown();
+  field.parallelSlicesCalculated();
+  field += 1.0;
+
+  EXPECT_FALSE(field.parallelSlicesUpToDate());
+
+  field.parallelSlicesCalculated();
+  field *= Field3D(2.0);
+
+  EXPECT_FALSE(field.parallelSlicesUpToDate());
+}
+
 TEST_F(Field3DTest, Ynext) {
   Field3D field;
 
@@ -1958,6 +2006,39 @@ TEST_F(Field3DTest, DC) {
   EXPECT_TRUE(IsField2DEqualBoutReal(DC(field), 3.0));
 }
 
+// Regression tests that moving a field into an rvalue-overloaded
+// operation reuses its storage rather than allocating a fresh field
+
+TEST_F(Field3DTest, LowPassMovedTemporaryReusesStorage) {
+  Field3D field(1.0);
+  const BoutReal *data = &field(0, 0, 0);
+
+  // zmax out of range, so nothing is removed and the field is passed
+  // straight through
+  Field3D result = lowPass(std::move(field), nz);
+
+  EXPECT_EQ(&result(0, 0, 0), data);
+}
+
+TEST_F(Field3DTest, LowPassZminMovedTemporaryReusesStorage) {
+  Field3D field(1.0);
+  const BoutReal *data = &field(0, 0, 0);
+
+  Field3D result = lowPass(std::move(field), nz, -1);
+
+  EXPECT_EQ(&result(0, 0, 0), data);
+}
+
+TEST_F(Field3DTest, InterpToMovedTemporaryReusesStorage) {
+  Field3D field(2.0);
+  const BoutReal *data = &field(0, 0, 0);
+
+  // No interpolation needed, so the field is passed straight through
+  Field3D result = interp_to(std::move(field), CELL_CENTRE);
+
+  EXPECT_EQ(&result(0, 0, 0), data);
+}
+
 #ifdef _OPENMP
 // This test may be more of a DataIterator test so should perhaps
 // be migrated to a separate test file.
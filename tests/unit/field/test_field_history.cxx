@@ -0,0 +1,98 @@
+#include "gtest/gtest.h"
+
+#include "bout/field_history.hxx"
+#include "bout/mesh.hxx"
+#include "boutexception.hxx"
+#include "field3d.hxx"
+#include "output.hxx"
+#include "test_extras.hxx"
+
+/// Global mesh
+extern Mesh *mesh;
+
+/// Test fixture to make sure the global mesh is our fake one
+class FieldHistoryTest : public ::testing::Test {
+protected:
+  static void SetUpTestCase() {
+    // Delete any existing mesh
+    if (mesh != nullptr) {
+      delete mesh;
+      mesh = nullptr;
+    }
+    mesh = new FakeMesh(nx, ny, nz);
+    output_info.disable();
+    mesh->createDefaultRegions();
+    output_info.enable();
+  }
+
+  static void TearDownTestCase() {
+    delete mesh;
+    mesh = nullptr;
+  }
+
+public:
+  static const int nx;
+  static const int ny;
+  static const int nz;
+};
+
+const int FieldHistoryTest::nx = 3;
+const int FieldHistoryTest::ny = 5;
+const int FieldHistoryTest::nz = 7;
+
+TEST_F(FieldHistoryTest, GetNewest) {
+  FieldHistory history(mesh, 4, false);
+
+  Field3D f = 3.0;
+  history.record(f, 1.0);
+
+  EXPECT_EQ(history.size(), 1);
+  EXPECT_TRUE(IsField3DEqualBoutReal(history.get(0.0), 3.0));
+}
+
+TEST_F(FieldHistoryTest, LinearInterpolation) {
+  FieldHistory history(mesh, 4, false);
+
+  history.record(Field3D(1.0), 0.0);
+  history.record(Field3D(3.0), 1.0);
+
+  // Halfway between the two samples
+  EXPECT_TRUE(IsField3DEqualBoutReal(history.get(0.5), 2.0));
+  // Exactly at the older sample
+  EXPECT_TRUE(IsField3DEqualBoutReal(history.get(1.0), 1.0));
+}
+
+TEST_F(FieldHistoryTest, SinglePrecisionStorage) {
+  FieldHistory history(mesh, 4, true);
+
+  history.record(Field3D(2.0), 0.0);
+
+  // Values survive the float round trip to float precision
+  EXPECT_TRUE(IsField3DEqualBoutReal(history.get(0.0), 2.0, 1e-6));
+  // Single precision uses half the memory of double
+  FieldHistory dhistory(mesh, 4, false);
+  EXPECT_EQ(dhistory.getBytes(), 2 * history.getBytes());
+}
+
+TEST_F(FieldHistoryTest, RingOverwritesOldest) {
+  FieldHistory history(mesh, 2, false);
+
+  history.record(Field3D(1.0), 0.0);
+  history.record(Field3D(2.0), 1.0);
+  history.record(Field3D(3.0), 2.0);
+
+  EXPECT_EQ(history.size(), 2);
+  EXPECT_DOUBLE_EQ(history.maxDelay(), 1.0);
+  // Sample at t=0 has been overwritten
+  EXPECT_THROW(history.get(1.5), BoutException);
+}
+
+TEST_F(FieldHistoryTest, ThrowsWithNoSamples) {
+  FieldHistory history(mesh, 2);
+  EXPECT_THROW(history.get(0.0), BoutException);
+}
+
+TEST_F(FieldHistoryTest, MemoryBudgetEnforced) {
+  // A tiny budget should be rejected at construction
+  EXPECT_THROW(FieldHistory(mesh, 1024, false, 0, 1.e-6), BoutException);
+}
@@ -206,6 +206,43 @@ TEST_F(ArrayTest, Assignment) {
   EXPECT_FALSE(b.unique());
 }
 
+TEST_F(ArrayTest, ArenaMode) {
+  Array<double>::useArena(true);
+
+  {
+    Array<double> a(41);
+    std::iota(a.begin(), a.end(), 0);
+    EXPECT_EQ(a.size(), 41);
+    EXPECT_TRUE(a.unique());
+    EXPECT_DOUBLE_EQ(a[40], 40);
+  }
+
+  // Blocks carved from the same slab must not alias each other
+  Array<double> b(41);
+  Array<double> c(41);
+  std::fill(b.begin(), b.end(), 1.0);
+  std::fill(c.begin(), c.end(), 2.0);
+  EXPECT_DOUBLE_EQ(b[0], 1.0);
+  EXPECT_DOUBLE_EQ(c[0], 2.0);
+  EXPECT_TRUE(b.unique());
+  EXPECT_TRUE(c.unique());
+
+  Array<double>::useArena(false);
+}
+
+TEST_F(ArrayTest, FirstTouch) {
+  Array<double>::useFirstTouch(true);
+
+  // Fresh allocations are value-initialised by the first-touch loop
+  Array<double> a(43);
+  EXPECT_EQ(a.size(), 43);
+  for (int i = 0; i < 43; i++) {
+    EXPECT_DOUBLE_EQ(a[i], 0.0);
+  }
+
+  Array<double>::useFirstTouch(false);
+}
+
 #if CHECK > 2
 TEST_F(ArrayTest, OutOfBoundsThrow) {
   Array<double> a(34);
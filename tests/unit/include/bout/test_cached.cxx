@@ -0,0 +1,171 @@
+#include "gtest/gtest.h"
+
+#include "bout/cached.hxx"
+#include "bout/mesh.hxx"
+#include "field3d.hxx"
+#include "output.hxx"
+#include "test_extras.hxx"
+
+/// Global mesh
+extern Mesh *mesh;
+
+/// Test fixture to make sure the global mesh is our fake one
+class CachedTest : public ::testing::Test {
+protected:
+  static void SetUpTestCase() {
+    // Delete any existing mesh
+    if (mesh != nullptr) {
+      delete mesh;
+      mesh = nullptr;
+    }
+    mesh = new FakeMesh(nx, ny, nz);
+    output_info.disable();
+    mesh->createDefaultRegions();
+    output_info.enable();
+  }
+
+  static void TearDownTestCase() {
+    delete mesh;
+    mesh = nullptr;
+  }
+
+public:
+  static const int nx;
+  static const int ny;
+  static const int nz;
+};
+
+const int CachedTest::nx = 3;
+const int CachedTest::ny = 5;
+const int CachedTest::nz = 7;
+
+TEST_F(CachedTest, ComputesOnFirstCall) {
+  Field3D input = 2.0;
+
+  int evaluations = 0;
+  bout::Cached<Field3D> twice{[&]() {
+                                evaluations++;
+                                return 2. * input;
+                              },
+                              {&input}};
+
+  EXPECT_FALSE(twice.upToDate());
+  const Field3D &result = twice();
+  EXPECT_EQ(evaluations, 1);
+  EXPECT_TRUE(IsField3DEqualBoutReal(result, 4.0));
+  EXPECT_TRUE(twice.upToDate());
+}
+
+TEST_F(CachedTest, ReusesResultWhileInputUnchanged) {
+  Field3D input = 3.0;
+
+  int evaluations = 0;
+  bout::Cached<Field3D> twice{[&]() {
+                                evaluations++;
+                                return 2. * input;
+                              },
+                              {&input}};
+
+  twice();
+  twice();
+  twice();
+  EXPECT_EQ(evaluations, 1);
+}
+
+TEST_F(CachedTest, RecomputesWhenInputChanges) {
+  Field3D input = 1.0;
+
+  int evaluations = 0;
+  bout::Cached<Field3D> twice{[&]() {
+                                evaluations++;
+                                return 2. * input;
+                              },
+                              {&input}};
+
+  twice();
+  input = 5.0; // Assignment bumps the generation counter
+
+  EXPECT_FALSE(twice.upToDate());
+  EXPECT_TRUE(IsField3DEqualBoutReal(twice(), 10.0));
+  EXPECT_EQ(evaluations, 2);
+}
+
+TEST_F(CachedTest, RecomputesAfterCompoundAssignment) {
+  Field3D input = 1.0;
+
+  int evaluations = 0;
+  bout::Cached<Field3D> twice{[&]() {
+                                evaluations++;
+                                return 2. * input;
+                              },
+                              {&input}};
+
+  twice();
+  input += 4.0; // In-place write must also bump the generation counter
+
+  EXPECT_FALSE(twice.upToDate());
+  EXPECT_TRUE(IsField3DEqualBoutReal(twice(), 10.0));
+  EXPECT_EQ(evaluations, 2);
+
+  input *= 2.0;
+
+  EXPECT_FALSE(twice.upToDate());
+  EXPECT_TRUE(IsField3DEqualBoutReal(twice(), 20.0));
+  EXPECT_EQ(evaluations, 3);
+}
+
+TEST_F(CachedTest, TracksSeveralInputs) {
+  Field3D a = 1.0;
+  Field3D b = 2.0;
+
+  int evaluations = 0;
+  bout::Cached<Field3D> sum{[&]() {
+                              evaluations++;
+                              return a + b;
+                            },
+                            {&a, &b}};
+
+  sum();
+  b = 4.0;
+
+  EXPECT_TRUE(IsField3DEqualBoutReal(sum(), 5.0));
+  EXPECT_EQ(evaluations, 2);
+}
+
+TEST_F(CachedTest, CountsHitsAndMisses) {
+  Field3D input = 1.0;
+
+  bout::Cached<Field3D> twice{[&]() { return 2. * input; }, {&input}};
+
+  bout::CacheStats::reset();
+  twice(); // Miss
+  twice(); // Hit
+  twice(); // Hit
+  input = 5.0;
+  twice(); // Miss
+
+  EXPECT_EQ(bout::CacheStats::hits(), 2);
+  EXPECT_EQ(bout::CacheStats::misses(), 2);
+
+  bout::CacheStats::reset();
+  EXPECT_EQ(bout::CacheStats::hits(), 0);
+  EXPECT_EQ(bout::CacheStats::misses(), 0);
+}
+
+TEST_F(CachedTest, Invalidate) {
+  Field3D input = 1.0;
+
+  int evaluations = 0;
+  bout::Cached<Field3D> twice{[&]() {
+                                evaluations++;
+                                return 2. * input;
+                              },
+                              {&input}};
+
+  twice();
+  twice.invalidate();
+
+  EXPECT_FALSE(twice.upToDate());
+  twice();
+  EXPECT_EQ(evaluations, 2);
+}
@@ -457,6 +457,36 @@ TEST_F(RegionTest, regionAsUnique) {
   }
 }
 
+TEST_F(RegionTest, regionAsTiled) {
+  Region<Ind3D> region(0, nx - 1, 0, ny - 1, 0, nz - 1, ny, nz);
+
+  const int tx = 1, ty = 2, tz = 4;
+  Region<Ind3D> regionTiled = region.asTiled(tx, ty, tz);
+
+  // Same number of indices, and the same set of indices
+  EXPECT_EQ(regionTiled.size(), region.size());
+  Region<Ind3D>::RegionIndices tiledSorted = regionTiled.asSorted().getIndices();
+  Region<Ind3D>::RegionIndices originalSorted = region.asSorted().getIndices();
+  for (unsigned int i = 0; i < originalSorted.size(); i++) {
+    EXPECT_EQ(tiledSorted[i], originalSorted[i]);
+  }
+
+  // Indices are visited tile by tile: the tile of each index must be
+  // monotonic in the iteration order
+  auto tileOf = [&](const Ind3D &i) {
+    return ((i.x() / tx) * ny + (i.y() / ty)) * nz + (i.z() / tz);
+  };
+  Region<Ind3D>::RegionIndices tiledIndices = regionTiled.getIndices();
+  for (unsigned int i = 1; i < tiledIndices.size(); i++) {
+    EXPECT_LE(tileOf(tiledIndices[i - 1]), tileOf(tiledIndices[i]));
+  }
+
+  // Each point is visited exactly once by the tiled loop macro
+  Field3D a = 0.0;
+  BOUT_FOR_TILED(i, mesh->getRegion3D("RGN_ALL"), tx, ty, tz) { a[i] = a[i] + 1.0; }
+  BOUT_FOR_SERIAL(i, mesh->getRegion3D("RGN_ALL")) { EXPECT_DOUBLE_EQ(a[i], 1.0); }
+}
+
 TEST_F(RegionTest, regionSetIndices) {
   // Values to insert
   std::vector<int> rawIndicesIn1 = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
@@ -43,6 +43,22 @@ TEST_F(MeshTest, GetRegion3DFromMesh) {
   EXPECT_THROW(localmesh.getRegion3D("SOME_MADE_UP_REGION_NAME"), BoutException);
 }
 
+TEST_F(MeshTest, InteriorAndRimRegions) {
+  localmesh.createDefaultRegions();
+  EXPECT_NO_THROW(localmesh.getRegion3D("RGN_INTERIOR"));
+  EXPECT_NO_THROW(localmesh.getRegion3D("RGN_RIM"));
+  EXPECT_NO_THROW(localmesh.getRegion2D("RGN_INTERIOR"));
+  EXPECT_NO_THROW(localmesh.getRegion2D("RGN_RIM"));
+
+  // RGN_INTERIOR and RGN_RIM partition RGN_NOBNDRY
+  EXPECT_EQ(localmesh.getRegion3D("RGN_INTERIOR").size()
+                + localmesh.getRegion3D("RGN_RIM").size(),
+            localmesh.getRegion3D("RGN_NOBNDRY").size());
+  EXPECT_EQ(localmesh.getRegion2D("RGN_INTERIOR").size()
+                + localmesh.getRegion2D("RGN_RIM").size(),
+            localmesh.getRegion2D("RGN_NOBNDRY").size());
+}
+
 TEST_F(MeshTest, GetRegion2DFromMesh) {
   localmesh.createDefaultRegions();
   EXPECT_NO_THROW(localmesh.getRegion2D("RGN_ALL"));
@@ -0,0 +1,105 @@
+#include "gtest/gtest.h"
+
+#include "bout/sys/expressionparser.hxx"
+#include "bout/sys/generatorbytecode.hxx"
+#include "bout_types.hxx"
+#include "unused.hxx"
+
+#include <cmath>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Need to inherit from ExpressionParser in order to expose the
+// protected parseString as a public method
+class BytecodeExpressionParser : public ExpressionParser {
+public:
+  using ExpressionParser::parseString;
+};
+
+class GeneratorBytecodeTest : public ::testing::Test {
+public:
+  BytecodeExpressionParser parser;
+  std::vector<double> x_array = {-1., 0., 1., 5., 10., 3.14e8};
+  std::vector<double> y_array = {-1., 0., 1., 5., 10., 3.14e8};
+  std::vector<double> z_array = {-1., 0., 1., 5., 10., 3.14e8};
+  std::vector<double> t_array = {-1., 0., 1., 5., 10., 3.14e8};
+
+  // Check that the bytecode evaluates to the same values as walking
+  // the generator tree
+  void checkMatchesTree(const std::string &expression) {
+    auto gen = parser.parseString(expression);
+    GeneratorBytecode code(gen);
+    for (auto x : x_array) {
+      for (auto y : y_array) {
+        for (auto z : z_array) {
+          for (auto t : t_array) {
+            const BoutReal expected = gen->generate(x, y, z, t);
+            if (!std::isfinite(expected)) {
+              // e.g. 0/0: NaN never compares equal to itself
+              continue;
+            }
+            EXPECT_DOUBLE_EQ(code.run(x, y, z, t), expected);
+          }
+        }
+      }
+    }
+  }
+};
+
+// A generator with no compile() method, to check the fallback path
+class NoCompileGenerator : public FieldGenerator {
+public:
+  NoCompileGenerator(std::shared_ptr<FieldGenerator> gen = nullptr) : gen(gen) {}
+
+  std::shared_ptr<FieldGenerator>
+  clone(const std::list<std::shared_ptr<FieldGenerator>> args) override {
+    return std::make_shared<NoCompileGenerator>(args.front());
+  }
+
+  BoutReal generate(BoutReal x, BoutReal y, BoutReal z, BoutReal t) override {
+    return 2. * gen->generate(x, y, z, t) + 1.;
+  }
+
+private:
+  std::shared_ptr<FieldGenerator> gen;
+};
+
+TEST_F(GeneratorBytecodeTest, Constant) {
+  GeneratorBytecode code(parser.parseString("1.5 + 2.5"));
+  EXPECT_DOUBLE_EQ(code.run(0., 0., 0., 0.), 4.0);
+}
+
+TEST_F(GeneratorBytecodeTest, Coordinates) {
+  checkMatchesTree("x");
+  checkMatchesTree("y");
+  checkMatchesTree("z");
+  checkMatchesTree("t");
+}
+
+TEST_F(GeneratorBytecodeTest, BinaryOperators) {
+  checkMatchesTree("x + y");
+  checkMatchesTree("x - t");
+  checkMatchesTree("y * z");
+  checkMatchesTree("x / t");
+  checkMatchesTree("x^2");
+}
+
+TEST_F(GeneratorBytecodeTest, NestedExpression) {
+  checkMatchesTree("2*x + (y - z) * (1 + t) / (x^2 + 1)");
+}
+
+TEST_F(GeneratorBytecodeTest, UnaryMinus) { checkMatchesTree("-x + 2"); }
+
+TEST_F(GeneratorBytecodeTest, FallbackGenerator) {
+  parser.addGenerator("nocompile", std::make_shared<NoCompileGenerator>());
+  checkMatchesTree("nocompile(x + y) * t");
+}
+
+TEST_F(GeneratorBytecodeTest, StackDepth) {
+  // Each operand of a binary operation occupies a stack slot
+  GeneratorBytecode code(parser.parseString("x + y * z"));
+  EXPECT_GE(code.stackDepth(), 2);
+  EXPECT_LE(code.stackDepth(), 3);
+}
@@ -477,3 +477,30 @@ TEST_F(OptionsTest, OptionsMacroConstReference) {
   EXPECT_EQ(val, 42);
 }
 
+
+TEST_F(OptionsTest, BindHandle) {
+  Options options;
+
+  options["val"] = 42;
+
+  auto handle = options["val"].bind(3);
+  EXPECT_EQ(handle.get(), 42);
+  EXPECT_FALSE(handle.changed());
+
+  // Re-setting the value is picked up on the next read
+  options["val"].force(7);
+  EXPECT_TRUE(handle.changed());
+  EXPECT_EQ(handle.get(), 7);
+  EXPECT_FALSE(handle.changed());
+}
+
+TEST_F(OptionsTest, BindHandleDefault) {
+  Options options;
+
+  auto handle = options.bind("section", "notset", 3);
+  EXPECT_EQ(handle.get(), 3);
+
+  // Binding assigns the default into the tree
+  int val = options["section"]["notset"];
+  EXPECT_EQ(val, 3);
+}
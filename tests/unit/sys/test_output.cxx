@@ -126,6 +126,36 @@ TEST_F(OutputTest, DisableEnableStdout) {
   std::remove(filename);
 }
 
+TEST_F(OutputTest, BufferedWritesInOrder) {
+  Output local_output;
+
+  local_output.setBuffered(1024);
+  local_output.write("%s%d\n", "Hello, world!", 4);
+  local_output.write("%s%d\n", "Hello, world!", 5);
+  // Drain the ring and return to synchronous mode
+  local_output.flushBuffer();
+
+  EXPECT_EQ(buffer.str(), "Hello, world!4\nHello, world!5\n");
+
+  // Back to synchronous writes
+  local_output.write("%s%d\n", "Hello, world!", 6);
+  EXPECT_EQ(buffer.str(), "Hello, world!4\nHello, world!5\nHello, world!6\n");
+}
+
+TEST_F(OutputTest, BufferedFlushedOnDestruction) {
+  {
+    Output local_output;
+    local_output.setBuffered(1024);
+    local_output.write("%s%d\n", "Hello, world!", 7);
+  }
+  EXPECT_EQ(buffer.str(), "Hello, world!7\n");
+}
+
+TEST_F(OutputTest, BufferedRejectsTinyBuffer) {
+  Output local_output;
+  EXPECT_THROW(local_output.setBuffered(1), BoutException);
+}
+
 TEST_F(OutputTest, GetInstance) {
   Output *local_output = Output::getInstance();
 
@@ -94,6 +94,12 @@ public:
   bool lastX() { return true; }
   int sendXOut(BoutReal *UNUSED(buffer), int UNUSED(size), int UNUSED(tag)) { return 0; }
   int sendXIn(BoutReal *UNUSED(buffer), int UNUSED(size), int UNUSED(tag)) { return 0; }
+  comm_handle isendXOut(BoutReal *UNUSED(buffer), int UNUSED(size), int UNUSED(tag)) {
+    return nullptr;
+  }
+  comm_handle isendXIn(BoutReal *UNUSED(buffer), int UNUSED(size), int UNUSED(tag)) {
+    return nullptr;
+  }
   comm_handle irecvXOut(BoutReal *UNUSED(buffer), int UNUSED(size), int UNUSED(tag)) {
     return nullptr;
   }
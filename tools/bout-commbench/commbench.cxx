@@ -0,0 +1,245 @@
+/*******************************************************************************
+ * bout-commbench: replay a recorded BOUT++ communication graph
+ *
+ * Evaluating a network configuration or a rank-placement scheme by
+ * running the physics burns allocation on computation that the
+ * network question does not need. With the mesh option
+ * dump_comm_graph=true, a short production run writes one
+ * comm_graph.<rank> file per processor recording every halo-exchange
+ * message (peer, size, count). This tool replays that pattern with
+ * synthetic data: each rank re-issues exactly the messages it
+ * recorded, for a configurable number of rounds and at configurable
+ * message-size scales, and reports the timing. Run it under the same
+ * MPI launcher, node counts and placement options being evaluated.
+ *
+ * The replay is pattern-faithful, not schedule-faithful: each round
+ * posts all receives, then all sends, then waits, like
+ * BoutMesh::send()/wait() with asynchronous sends. Messages are
+ * matched by (source, size-derived tag), which is unambiguous for
+ * the size multisets a halo exchange produces.
+ *
+ * Usage: mpirun -np N bout-commbench <datadir> [options]
+ *
+ * N must equal the number of ranks that wrote the graph.
+ *******************************************************************************/
+
+#include <boutexception.hxx>
+
+#include <mpi.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+/// One directed edge of the communication graph
+struct Edge {
+  int peer;   ///< MPI rank at the other end
+  int len;    ///< Message size in BoutReals (before scaling)
+  long count; ///< Messages recorded during the dumping run
+};
+
+void usage(const char *argv0) {
+  fprintf(stderr,
+          "Usage: mpirun -np N %s <datadir> [options]\n"
+          "\n"
+          "Replay the halo-exchange pattern recorded by a run with the mesh\n"
+          "option dump_comm_graph=true, using synthetic data.\n"
+          "\n"
+          "Options:\n"
+          "  -rounds <n>    Timed rounds to replay (default 100)\n"
+          "  -scale <f>     Multiply message sizes by f (default 1.0)\n"
+          "  -freq          Repeat each edge its recorded count per round,\n"
+          "                 reproducing relative message frequencies\n"
+          "                 (default: each edge once per round)\n"
+          "  -prefix <name> Graph file prefix (default comm_graph)\n",
+          argv0);
+}
+
+int parseInt(const char *str, const char *what) {
+  char *end;
+  long value = strtol(str, &end, 10);
+  if ((*end != '\0') || (value <= 0)) {
+    throw BoutException("Expected a positive integer for %s, got '%s'", what, str);
+  }
+  return static_cast<int>(value);
+}
+
+double parseReal(const char *str, const char *what) {
+  char *end;
+  double value = strtod(str, &end);
+  if ((*end != '\0') || (value <= 0.0)) {
+    throw BoutException("Expected a positive number for %s, got '%s'", what, str);
+  }
+  return value;
+}
+
+/// Read this rank's graph file, splitting the edges by direction
+void readGraph(const std::string &filename, std::vector<Edge> &sends,
+               std::vector<Edge> &recvs) {
+  FILE *file = fopen(filename.c_str(), "r");
+  if (file == nullptr) {
+    throw BoutException("Could not open '%s'. Was the dumping run the same size?",
+                        filename.c_str());
+  }
+
+  char line[256];
+  while (fgets(line, sizeof(line), file) != nullptr) {
+    if (line[0] == '#')
+      continue;
+    char dir[8];
+    Edge edge;
+    if (sscanf(line, "%7s %d %d %ld", dir, &edge.peer, &edge.len, &edge.count) != 4)
+      continue;
+    if (strcmp(dir, "send") == 0) {
+      sends.push_back(edge);
+    } else if (strcmp(dir, "recv") == 0) {
+      recvs.push_back(edge);
+    }
+  }
+  fclose(file);
+}
+
+/// Message tag for an edge: both ends derive it from the size they
+/// recorded, so matching needs no negotiation
+int edgeTag(const Edge &edge) { return edge.len % 32768; }
+
+} // namespace
+
+int main(int argc, char **argv) {
+  MPI_Init(&argc, &argv);
+
+  int rank, nprocs;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+
+  try {
+    if (argc < 2) {
+      if (rank == 0)
+        usage(argv[0]);
+      MPI_Finalize();
+      return 1;
+    }
+
+    const std::string datadir = argv[1];
+    int rounds = 100;
+    double scale = 1.0;
+    bool freq = false;
+    std::string prefix = "comm_graph";
+
+    for (int i = 2; i < argc; i++) {
+      if (strcmp(argv[i], "-rounds") == 0) {
+        if (++i == argc)
+          throw BoutException("-rounds needs a value");
+        rounds = parseInt(argv[i], "-rounds");
+      } else if (strcmp(argv[i], "-scale") == 0) {
+        if (++i == argc)
+          throw BoutException("-scale needs a value");
+        scale = parseReal(argv[i], "-scale");
+      } else if (strcmp(argv[i], "-freq") == 0) {
+        freq = true;
+      } else if (strcmp(argv[i], "-prefix") == 0) {
+        if (++i == argc)
+          throw BoutException("-prefix needs a value");
+        prefix = argv[i];
+      } else {
+        throw BoutException("Unknown option '%s'", argv[i]);
+      }
+    }
+
+    std::vector<Edge> sends, recvs;
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), "/%s.%d", prefix.c_str(), rank);
+    readGraph(datadir + suffix, sends, recvs);
+
+    for (const Edge &edge : sends) {
+      if ((edge.peer < 0) || (edge.peer >= nprocs))
+        throw BoutException("Graph names rank %d, but only %d ranks are running. "
+                            "Launch with the dumping run's processor count",
+                            edge.peer, nprocs);
+    }
+
+    // Scaled message sizes, and one buffer per edge so that every
+    // message has its own memory, as in the real exchange
+    auto scaled = [scale](const Edge &edge) {
+      int n = static_cast<int>(edge.len * scale);
+      return (n > 0) ? n : 1;
+    };
+
+    std::vector<std::vector<double>> sendbuf(sends.size()), recvbuf(recvs.size());
+    long volume = 0; // Values sent per round
+    for (size_t i = 0; i < sends.size(); i++) {
+      sendbuf[i].assign(scaled(sends[i]), 1.0);
+      volume += static_cast<long>(scaled(sends[i])) * (freq ? sends[i].count : 1);
+    }
+    for (size_t i = 0; i < recvs.size(); i++) {
+      recvbuf[i].resize(scaled(recvs[i]));
+    }
+
+    // One replay round: receives first, then sends, then wait, as
+    // BoutMesh does with asynchronous sends
+    std::vector<MPI_Request> requests;
+    auto round = [&]() {
+      requests.clear();
+      for (size_t i = 0; i < recvs.size(); i++) {
+        const long repeats = freq ? recvs[i].count : 1;
+        for (long r = 0; r < repeats; r++) {
+          MPI_Request req;
+          MPI_Irecv(recvbuf[i].data(), scaled(recvs[i]), MPI_DOUBLE, recvs[i].peer,
+                    edgeTag(recvs[i]), MPI_COMM_WORLD, &req);
+          requests.push_back(req);
+        }
+      }
+      for (size_t i = 0; i < sends.size(); i++) {
+        const long repeats = freq ? sends[i].count : 1;
+        for (long r = 0; r < repeats; r++) {
+          MPI_Request req;
+          MPI_Isend(sendbuf[i].data(), scaled(sends[i]), MPI_DOUBLE, sends[i].peer,
+                    edgeTag(sends[i]), MPI_COMM_WORLD, &req);
+          requests.push_back(req);
+        }
+      }
+      MPI_Waitall(static_cast<int>(requests.size()), requests.data(),
+                  MPI_STATUSES_IGNORE);
+    };
+
+    // Untimed warm-up: connection establishment and buffer
+    // registration should not pollute the measurement
+    for (int r = 0; r < 5; r++)
+      round();
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    const double start = MPI_Wtime();
+    for (int r = 0; r < rounds; r++)
+      round();
+    MPI_Barrier(MPI_COMM_WORLD);
+    const double elapsed = MPI_Wtime() - start;
+
+    // Aggregate statistics. The barrier-to-barrier time is common to
+    // all ranks; per-rank volume varies
+    long total_volume;
+    MPI_Reduce(&volume, &total_volume, 1, MPI_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    int nedges = static_cast<int>(sends.size());
+    int total_edges;
+    MPI_Reduce(&nedges, &total_edges, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+
+    if (rank == 0) {
+      const double bytes = static_cast<double>(total_volume) * sizeof(double);
+      printf("Replayed %d directed edges on %d ranks for %d rounds%s\n", total_edges,
+             nprocs, rounds, freq ? " (frequency-weighted)" : "");
+      printf("  Message size scale : %.3g\n", scale);
+      printf("  Volume per round   : %.3f MB\n", bytes / 1e6);
+      printf("  Time per round     : %.3f us\n", 1e6 * elapsed / rounds);
+      printf("  Aggregate bandwidth: %.3f GB/s\n", bytes * rounds / elapsed / 1e9);
+    }
+  } catch (BoutException &e) {
+    fprintf(stderr, "Error: %s\n", e.what());
+    MPI_Abort(MPI_COMM_WORLD, 1);
+  }
+
+  MPI_Finalize();
+  return 0;
+}
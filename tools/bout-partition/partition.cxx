@@ -0,0 +1,320 @@
+/*******************************************************************************
+ * bout-partition: preview NXPE/NYPE domain splits for a grid file
+ *
+ * Choosing the processor layout by submitting full jobs wastes
+ * allocation time: an infeasible NXPE aborts at startup, and a poor
+ * one runs slowly for the whole job. This tool reads the topology
+ * scalars from a grid file, enumerates the NXPE values BoutMesh would
+ * accept for a given processor count -- the same divisibility and
+ * branch-cut rules as src/mesh/impls/bout/boutmesh.cxx -- and ranks
+ * the feasible layouts with a per-rank cost model:
+ *
+ *   cost = compute * interior+guard points on the slowest rank
+ *        + latency * guard-exchange messages per RHS
+ *        + percell * guard cells communicated per RHS
+ *
+ * The coefficients are relative (compute is per grid point, the
+ * others in grid-point equivalents); calibrate them from a short
+ * pilot run's timer report (see the README). With -weights the
+ * compute term uses the per-row 'decomposition_weights' array from
+ * the grid file, matching the weighted_decomposition option.
+ *
+ * Usage: bout-partition <gridfile> <nprocs> [options]
+ *******************************************************************************/
+
+#include <bout_types.hxx>
+#include <boutexception.hxx>
+#include <dataformat.hxx>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+/// Read a scalar integer from the grid file, falling back to \p def
+/// (the same default BoutMesh would use) with a note when missing
+int readScalar(DataFormat &file, const char *name, int def) {
+  int value;
+  if (!file.read(&value, name)) {
+    printf("\tNote: '%s' not in grid file. Using %d\n", name, def);
+    return def;
+  }
+  return value;
+}
+
+/// A feasible processor layout with its modelled slowest-rank cost
+struct Layout {
+  int nxpe, nype;   ///< Processor split
+  int mxsub, mysub; ///< Interior points per processor
+  BoutReal compute; ///< Modelled compute cost of the slowest rank
+  BoutReal comm;    ///< Modelled communication cost per RHS
+  BoutReal total;   ///< compute + comm; the ranking key
+};
+
+void usage(const char *argv0) {
+  fprintf(stderr, "Usage: %s <gridfile> <nprocs> [options]\n\n", argv0);
+  fprintf(stderr, "Enumerate and rank the feasible NXPE/NYPE domain splits\n");
+  fprintf(stderr, "for a grid file, without submitting a job.\n\n");
+  fprintf(stderr, "Options:\n");
+  fprintf(stderr, "  -mxg <n>      Number of X guard cells (default 2)\n");
+  fprintf(stderr, "  -myg <n>      Number of Y guard cells (default 2)\n");
+  fprintf(stderr, "  -nz <n>       Number of Z points (default 64)\n");
+  fprintf(stderr, "  -top <n>      Show the n cheapest layouts (default 5, 0 = all)\n");
+  fprintf(stderr, "  -compute <c>  Cost per grid point per RHS (default 1)\n");
+  fprintf(stderr, "  -latency <c>  Cost per guard-exchange message, in\n");
+  fprintf(stderr, "                grid-point equivalents (default 2000)\n");
+  fprintf(stderr, "  -percell <c>  Cost per communicated guard cell (default 5)\n");
+  fprintf(stderr, "  -weights      Weight rows by 'decomposition_weights' from\n");
+  fprintf(stderr, "                the grid file (as weighted_decomposition)\n");
+}
+
+int parseInt(const char *str, const char *what) {
+  char *end = nullptr;
+  long value = strtol(str, &end, 10);
+  if ((end == str) || (*end != '\0')) {
+    throw BoutException("Expected an integer for %s, got '%s'", what, str);
+  }
+  return static_cast<int>(value);
+}
+
+BoutReal parseReal(const char *str, const char *what) {
+  char *end = nullptr;
+  double value = strtod(str, &end);
+  if ((end == str) || (*end != '\0')) {
+    throw BoutException("Expected a number for %s, got '%s'", what, str);
+  }
+  return value;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  try {
+    const char *gridname = argv[1];
+    const int NPES = parseInt(argv[2], "<nprocs>");
+    if (NPES < 1) {
+      throw BoutException("Number of processors (%d) must be positive", NPES);
+    }
+
+    int MXG = 2, MYG = 2;
+    int nz = 64;
+    int top = 5;
+    BoutReal c_compute = 1.0, c_latency = 2000.0, c_percell = 5.0;
+    bool use_weights = false;
+
+    for (int i = 3; i < argc; i++) {
+      auto arg = [&](const char *name) -> const char * {
+        if (i + 1 >= argc) {
+          throw BoutException("Option %s needs an argument", name);
+        }
+        return argv[++i];
+      };
+      if (strcmp(argv[i], "-mxg") == 0) {
+        MXG = parseInt(arg("-mxg"), "-mxg");
+      } else if (strcmp(argv[i], "-myg") == 0) {
+        MYG = parseInt(arg("-myg"), "-myg");
+      } else if (strcmp(argv[i], "-nz") == 0) {
+        nz = parseInt(arg("-nz"), "-nz");
+      } else if (strcmp(argv[i], "-top") == 0) {
+        top = parseInt(arg("-top"), "-top");
+      } else if (strcmp(argv[i], "-compute") == 0) {
+        c_compute = parseReal(arg("-compute"), "-compute");
+      } else if (strcmp(argv[i], "-latency") == 0) {
+        c_latency = parseReal(arg("-latency"), "-latency");
+      } else if (strcmp(argv[i], "-percell") == 0) {
+        c_percell = parseReal(arg("-percell"), "-percell");
+      } else if (strcmp(argv[i], "-weights") == 0) {
+        use_weights = true;
+      } else {
+        usage(argv[0]);
+        throw BoutException("Unknown option '%s'", argv[i]);
+      }
+    }
+
+    // Read the topology from the grid file. No mesh exists here, so
+    // go straight through the DataFormat interface (the NetCDF
+    // implementations read fine without a global mesh)
+    auto file = data_format(gridname);
+    if (!file->openr(gridname)) {
+      throw BoutException("Could not open grid file '%s'", gridname);
+    }
+
+    int nx, ny;
+    if (!file->read(&nx, "nx") || !file->read(&ny, "ny")) {
+      throw BoutException("Grid file '%s' has no nx or ny", gridname);
+    }
+
+    if (2 * MXG >= nx) {
+      throw BoutException("nx must be greater than 2*MXG");
+    }
+
+    // Branch cuts, defaulting exactly as BoutMesh does
+    int jyseps1_1 = readScalar(*file, "jyseps1_1", -1);
+    int jyseps1_2 = readScalar(*file, "jyseps1_2", ny / 2);
+    int jyseps2_1 = readScalar(*file, "jyseps2_1", jyseps1_2);
+    int jyseps2_2 = readScalar(*file, "jyseps2_2", ny - 1);
+    int ny_inner = readScalar(*file, "ny_inner", jyseps2_1);
+
+    // And the same sanity clamps
+    if (jyseps1_1 < -1) {
+      jyseps1_1 = -1;
+    }
+    if (jyseps2_1 <= jyseps1_1) {
+      jyseps2_1 = jyseps1_1 + 1;
+    }
+    if (jyseps1_2 < jyseps2_1) {
+      jyseps1_2 = jyseps2_1;
+    }
+    if (jyseps2_2 >= ny) {
+      jyseps2_2 = ny - 1;
+    }
+    if (jyseps2_2 < jyseps1_2) {
+      if (jyseps1_2 >= ny) {
+        throw BoutException("jyseps1_2 (%d) must be < ny (%d).", jyseps1_2, ny);
+      }
+      jyseps2_2 = jyseps1_2;
+    }
+
+    const bool double_null = (jyseps2_1 != jyseps1_2);
+
+    // Optional per-row compute weights, as weighted_decomposition reads
+    std::vector<BoutReal> ywork(ny, 1.0);
+    if (use_weights) {
+      if (!file->read(ywork.data(), "decomposition_weights", ny)) {
+        printf("\tNote: no 'decomposition_weights' in grid file. "
+               "Using uniform row weights\n");
+      }
+    }
+    file->close();
+
+    const int MX = nx - 2 * MXG;
+    const BoutReal ideal = sqrt(MX * NPES / static_cast<BoutReal>(ny));
+
+    printf("Grid '%s': nx = %d, ny = %d (%s)\n", gridname, nx, ny,
+           double_null ? "double null" : "single null");
+    printf("NPES = %d, MXG = %d, MYG = %d, nz = %d (ideal NXPE = %.2f)\n\n", NPES, MXG,
+           MYG, nz, ideal);
+
+    // Enumerate NXPE exactly as BoutMesh does when NXPE is not given
+    std::vector<Layout> layouts;
+    for (int i = 1; i <= NPES; i++) {
+      if ((NPES % i != 0) ||       // Processors divide equally
+          (MX % i != 0) ||         // Mesh in X divides equally
+          (ny % (NPES / i) != 0)) { // Mesh in Y divides equally
+        continue;
+      }
+
+      const int nyp = NPES / i;
+      const int ysub = ny / nyp;
+
+      if (ysub < MYG) {
+        continue;
+      }
+      // Branch cuts must fall on subdomain boundaries
+      if ((jyseps1_1 + 1) % ysub != 0) {
+        continue;
+      }
+      if (double_null) {
+        if (((jyseps2_1 - jyseps1_1) % ysub != 0)
+            || ((jyseps2_2 - jyseps1_2) % ysub != 0)
+            || ((ny_inner - jyseps2_1 - 1) % ysub != 0)
+            || ((jyseps1_2 - ny_inner + 1) % ysub != 0)) {
+          continue;
+        }
+      } else {
+        if ((jyseps2_2 - jyseps1_1) % ysub != 0) {
+          continue;
+        }
+      }
+      if ((ny - jyseps2_2 - 1) % ysub != 0) {
+        continue;
+      }
+
+      Layout l;
+      l.nxpe = i;
+      l.nype = nyp;
+      l.mxsub = MX / i;
+      l.mysub = ysub;
+
+      // Compute cost of the slowest rank: its heaviest MYSUB slab of
+      // row weights times the local x width including guard cells
+      // (uniform weights reduce this to the subdomain point count)
+      BoutReal slab_max = 0.;
+      for (int p = 0; p < nyp; p++) {
+        BoutReal slab = 0.;
+        for (int j = p * ysub; j < (p + 1) * ysub; j++) {
+          slab += ywork[j];
+        }
+        slab_max = std::max(slab_max, slab);
+      }
+      l.compute = c_compute * (l.mxsub + 2 * MXG) * (slab_max + 2 * MYG) * nz;
+
+      // Communication per RHS evaluation: two messages per decomposed
+      // direction, plus the guard-cell volume exchanged. Z is never
+      // decomposed so it only scales the volumes
+      int messages = 0;
+      BoutReal volume = 0.;
+      if (i > 1) {
+        messages += 2;
+        volume += 2.0 * MXG * l.mysub * nz;
+      }
+      if (nyp > 1) {
+        messages += 2;
+        volume += 2.0 * MYG * l.mxsub * nz;
+      }
+      l.comm = c_latency * messages + c_percell * volume;
+      l.total = l.compute + l.comm;
+
+      layouts.push_back(l);
+    }
+
+    if (layouts.empty()) {
+      printf("No feasible layout for %d processors. "
+             "Try a different number of processors.\n",
+             NPES);
+      return 1;
+    }
+
+    // Cheapest first; break ties towards the squarest domains, as
+    // BoutMesh's automatic choice would
+    std::sort(layouts.begin(), layouts.end(), [ideal](const Layout &a, const Layout &b) {
+      if (a.total != b.total) {
+        return a.total < b.total;
+      }
+      return fabs(ideal - a.nxpe) < fabs(ideal - b.nxpe);
+    });
+
+    int nshow = static_cast<int>(layouts.size());
+    if ((top > 0) && (top < nshow)) {
+      nshow = top;
+    }
+
+    printf("%d feasible layout%s, showing %d:\n\n", static_cast<int>(layouts.size()),
+           (layouts.size() == 1) ? "" : "s", nshow);
+    printf("    NXPE x NYPE   local x*y      compute         comm        total\n");
+    for (int n = 0; n < nshow; n++) {
+      const Layout &l = layouts[n];
+      printf("  %c %4d x %-4d   %4d x %-4d %12.4g %12.4g %12.4g\n",
+             (n == 0) ? '*' : ' ', l.nxpe, l.nype, l.mxsub, l.mysub, l.compute, l.comm,
+             l.total);
+    }
+    printf("\nRecommended: NXPE = %d (set in the input file or with 'NXPE=%d')\n",
+           layouts[0].nxpe, layouts[0].nxpe);
+  } catch (const BoutException &e) {
+    fprintf(stderr, "Error: %s\n", e.what());
+    return 1;
+  }
+
+  return 0;
+}
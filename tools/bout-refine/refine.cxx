@@ -0,0 +1,542 @@
+/*******************************************************************************
+ * bout-refine: interpolate restart files to a new resolution
+ *
+ * Restarting a run at higher resolution otherwise means interpolating
+ * the restart files offline in Python, which takes hours for large
+ * grids. This tool does the transfer natively: it reassembles each
+ * variable's global array from the per-processor restart files, using
+ * the decomposition scalars (NXPE, NYPE, MXSUB, MYSUB, ...) the mesh
+ * writes into them, precomputes one table of Lagrange interpolation
+ * stencils per direction -- each target index maps to a source base
+ * index and `order` weights -- and applies the tables as separable
+ * tensor-product passes over x, y and z. The stencil work is O(nx +
+ * ny + nz) and each pass streams the field once, so the transfer is
+ * bandwidth-bound rather than bound by per-point weight computation.
+ *
+ * The mesh topology scalars are rescaled to the new resolution
+ * (branch cuts included), all other scalars are copied through, and a
+ * complete set of restart files for the target decomposition is
+ * written. The target guard cells are filled from the interpolated
+ * global array; boundary guards are extrapolated, and are reset by
+ * the boundary conditions on the first step in any case.
+ *
+ * Usage: bout-refine <srcdir> <dstdir> [options]
+ *******************************************************************************/
+
+#include <bout_types.hxx>
+#include <boutexception.hxx>
+#include <dataformat.hxx>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+
+/// Read a scalar integer from a restart file, throwing if missing:
+/// unlike grid files, restart files always carry their decomposition
+int readScalar(DataFormat &file, const char *name) {
+  int value;
+  if (!file.read(&value, name)) {
+    throw BoutException("Restart file has no '%s': not a BOUT++ restart?", name);
+  }
+  return value;
+}
+
+/// Precomputed interpolation stencils for one direction: target index
+/// t takes source points base[t] .. base[t]+order-1 with weights
+/// weights[t*order] .. weights[t*order+order-1]
+struct Stencil1D {
+  int order = 0;
+  std::vector<int> base;
+  std::vector<BoutReal> weights;
+};
+
+/// Build the stencil table mapping \p nsrc source points onto
+/// refinement factor \p factor more interior points. Cell-centred
+/// index mapping: target interior cell t sits at source coordinate
+/// (t + 0.5)/factor - 0.5, with \p guards boundary cells outside the
+/// interior on each side (0 and periodic wrapping for z). Stencils at
+/// non-periodic edges are clamped inside the array, so guard cells
+/// are filled by extrapolation
+Stencil1D buildStencil(int nsrc, int ntgt, int factor, int guards, int order,
+                       bool periodic) {
+  Stencil1D s;
+  s.order = (order > nsrc) ? nsrc : order; // Degrade gracefully on tiny grids
+  s.base.resize(ntgt);
+  s.weights.resize(static_cast<size_t>(ntgt) * s.order);
+
+  for (int t = 0; t < ntgt; t++) {
+    const BoutReal pos = (t - guards + 0.5) / factor - 0.5 + guards;
+
+    int base = static_cast<int>(floor(pos)) - s.order / 2 + 1;
+    if (!periodic) {
+      if (base < 0) {
+        base = 0;
+      }
+      if (base > nsrc - s.order) {
+        base = nsrc - s.order;
+      }
+    }
+    s.base[t] = base;
+
+    // Lagrange weights on the (integer-spaced) source nodes
+    for (int j = 0; j < s.order; j++) {
+      BoutReal w = 1.0;
+      for (int k = 0; k < s.order; k++) {
+        if (k != j) {
+          w *= (pos - (base + k)) / static_cast<BoutReal>(j - k);
+        }
+      }
+      s.weights[static_cast<size_t>(t) * s.order + j] = w;
+    }
+  }
+  return s;
+}
+
+/// Apply a stencil table to the slowest-varying index of an (n1, n2)
+/// row-major array, producing a (base.size(), n2) array. Each target
+/// slab is a weighted sum of `order` source slabs, streamed
+/// contiguously
+std::vector<BoutReal> applyLeading(const std::vector<BoutReal> &in, int n1, int n2,
+                                   const Stencil1D &s, bool periodic) {
+  const int ntgt = static_cast<int>(s.base.size());
+  std::vector<BoutReal> out(static_cast<size_t>(ntgt) * n2, 0.0);
+
+  for (int t = 0; t < ntgt; t++) {
+    BoutReal *op = &out[static_cast<size_t>(t) * n2];
+    for (int j = 0; j < s.order; j++) {
+      int si = s.base[t] + j;
+      if (periodic) {
+        si = ((si % n1) + n1) % n1;
+      }
+      const BoutReal w = s.weights[static_cast<size_t>(t) * s.order + j];
+      const BoutReal *ip = &in[static_cast<size_t>(si) * n2];
+      for (int i = 0; i < n2; i++) {
+        op[i] += w * ip[i];
+      }
+    }
+  }
+  return out;
+}
+
+/// Interpolate a global (nx, ny[, nz]) array with per-direction
+/// stencil tables; sz may be empty for 2D fields. x and y are applied
+/// as leading-index passes, z row by row with periodic wrapping
+std::vector<BoutReal> interpolate(const std::vector<BoutReal> &in, int gnx, int gny,
+                                  int gnz, const Stencil1D &sx, const Stencil1D &sy,
+                                  const Stencil1D &sz) {
+  const int tnx = static_cast<int>(sx.base.size());
+  const int tny = static_cast<int>(sy.base.size());
+
+  // x: one pass over the whole array
+  std::vector<BoutReal> tmp = applyLeading(in, gnx, gny * gnz, sx, false);
+
+  // y: a leading-index pass per x plane
+  std::vector<BoutReal> tmp2(static_cast<size_t>(tnx) * tny * gnz);
+  for (int ix = 0; ix < tnx; ix++) {
+    std::vector<BoutReal> plane(tmp.begin() + static_cast<size_t>(ix) * gny * gnz,
+                                tmp.begin() + static_cast<size_t>(ix + 1) * gny * gnz);
+    std::vector<BoutReal> tplane = applyLeading(plane, gny, gnz, sy, false);
+    std::copy(tplane.begin(), tplane.end(),
+              tmp2.begin() + static_cast<size_t>(ix) * tny * gnz);
+  }
+  if (sz.base.empty()) {
+    return tmp2; // 2D field
+  }
+
+  // z: periodic, applied row by row
+  const int tnz = static_cast<int>(sz.base.size());
+  std::vector<BoutReal> out(static_cast<size_t>(tnx) * tny * tnz);
+  for (size_t row = 0; row < static_cast<size_t>(tnx) * tny; row++) {
+    const BoutReal *ip = &tmp2[row * gnz];
+    BoutReal *op = &out[row * tnz];
+    for (int t = 0; t < tnz; t++) {
+      BoutReal sum = 0.0;
+      for (int j = 0; j < sz.order; j++) {
+        const int si = ((sz.base[t] + j) % gnz + gnz) % gnz;
+        sum += sz.weights[static_cast<size_t>(t) * sz.order + j] * ip[si];
+      }
+      op[t] = sum;
+    }
+  }
+  return out;
+}
+
+void usage(const char *argv0) {
+  fprintf(stderr, "Usage: %s <srcdir> <dstdir> [options]\n\n", argv0);
+  fprintf(stderr, "Interpolate the restart files in <srcdir> to a new resolution\n");
+  fprintf(stderr, "and/or processor layout, writing them into <dstdir>.\n\n");
+  fprintf(stderr, "Options:\n");
+  fprintf(stderr, "  -rx <n>     Refinement factor in x (default 1)\n");
+  fprintf(stderr, "  -ry <n>     Refinement factor in y (default 1)\n");
+  fprintf(stderr, "  -rz <n>     Refinement factor in z (default 1)\n");
+  fprintf(stderr, "  -npes <n>   Target number of processors (default: unchanged)\n");
+  fprintf(stderr, "  -nxpe <n>   Target NXPE (default: unchanged; check the split\n");
+  fprintf(stderr, "              is feasible with bout-partition first)\n");
+  fprintf(stderr, "  -order <n>  Stencil width: 2 = linear, 4 = cubic (default 4)\n");
+  fprintf(stderr, "  -name <s>   Restart file base name (default BOUT.restart)\n");
+}
+
+int parseInt(const char *str, const char *what) {
+  char *end = nullptr;
+  long value = strtol(str, &end, 10);
+  if ((end == str) || (*end != '\0')) {
+    throw BoutException("Expected an integer for %s, got '%s'", what, str);
+  }
+  return static_cast<int>(value);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  try {
+    const std::string srcdir = argv[1];
+    const std::string dstdir = argv[2];
+
+    int rx = 1, ry = 1, rz = 1;
+    int npes_t = -1, nxpe_t = -1;
+    int order = 4;
+    std::string base = "BOUT.restart";
+
+    for (int i = 3; i < argc; i++) {
+      auto arg = [&](const char *name) -> const char * {
+        if (i + 1 >= argc) {
+          throw BoutException("Option %s needs an argument", name);
+        }
+        return argv[++i];
+      };
+      if (strcmp(argv[i], "-rx") == 0) {
+        rx = parseInt(arg("-rx"), "-rx");
+      } else if (strcmp(argv[i], "-ry") == 0) {
+        ry = parseInt(arg("-ry"), "-ry");
+      } else if (strcmp(argv[i], "-rz") == 0) {
+        rz = parseInt(arg("-rz"), "-rz");
+      } else if (strcmp(argv[i], "-npes") == 0) {
+        npes_t = parseInt(arg("-npes"), "-npes");
+      } else if (strcmp(argv[i], "-nxpe") == 0) {
+        nxpe_t = parseInt(arg("-nxpe"), "-nxpe");
+      } else if (strcmp(argv[i], "-order") == 0) {
+        order = parseInt(arg("-order"), "-order");
+      } else if (strcmp(argv[i], "-name") == 0) {
+        base = arg("-name");
+      } else {
+        usage(argv[0]);
+        throw BoutException("Unknown option '%s'", argv[i]);
+      }
+    }
+    if ((rx < 1) || (ry < 1) || (rz < 1)) {
+      throw BoutException("Refinement factors must be positive integers");
+    }
+    if (order < 2) {
+      throw BoutException("Stencil order must be at least 2");
+    }
+
+    // Find processor 0's file and its format by extension. Variable
+    // enumeration (listVars) needs the NetCDF backends
+    const char *extensions[] = {"nc", "ncdf", "cdl"};
+    std::string ext;
+    for (const auto *e : extensions) {
+      const std::string candidate = srcdir + "/" + base + ".0." + e;
+      FILE *f = fopen(candidate.c_str(), "rb");
+      if (f != nullptr) {
+        fclose(f);
+        ext = e;
+        break;
+      }
+    }
+    if (ext.empty()) {
+      throw BoutException("No NetCDF restart file %s/%s.0.* found", srcdir.c_str(),
+                          base.c_str());
+    }
+
+    auto srcName = [&](int p) {
+      char buf[16];
+      snprintf(buf, sizeof(buf), ".%d.", p);
+      return srcdir + "/" + base + buf + ext;
+    };
+
+    auto file = data_format(srcName(0).c_str());
+    if (!file->openr(srcName(0))) {
+      throw BoutException("Could not open '%s'", srcName(0).c_str());
+    }
+
+    // Source decomposition, as written by BoutMesh::outputVars
+    const int MXSUB = readScalar(*file, "MXSUB");
+    const int MYSUB = readScalar(*file, "MYSUB");
+    const int MXG = readScalar(*file, "MXG");
+    const int MYG = readScalar(*file, "MYG");
+    const int nx = readScalar(*file, "nx");
+    const int ny = readScalar(*file, "ny");
+    const int nz = readScalar(*file, "MZ");
+    const int NXPE = readScalar(*file, "NXPE");
+    const int NYPE = readScalar(*file, "NYPE");
+    const int NPES = NXPE * NYPE;
+
+    const int lnx = MXSUB + 2 * MXG; // Per-processor array sizes
+    const int lny = MYSUB + 2 * MYG;
+    const int gnx = nx; // Assembled global sizes, with boundary guards
+    const int gny = ny + 2 * MYG;
+    const int gnz = nz;
+
+    // Target resolution and decomposition
+    const int MX_t = rx * (nx - 2 * MXG);
+    const int tnx = MX_t + 2 * MXG;
+    const int ny_t = ry * ny;
+    const int tny = ny_t + 2 * MYG;
+    const int tnz = rz * nz;
+
+    if (npes_t < 1) {
+      npes_t = NPES;
+    }
+    if (nxpe_t < 1) {
+      nxpe_t = NXPE;
+    }
+    if (npes_t % nxpe_t != 0) {
+      throw BoutException("NXPE (%d) does not divide NPES (%d)", nxpe_t, npes_t);
+    }
+    const int nype_t = npes_t / nxpe_t;
+    if (MX_t % nxpe_t != 0) {
+      throw BoutException("Interior x size %d not divisible by NXPE = %d "
+                          "(try bout-partition to find a feasible layout)",
+                          MX_t, nxpe_t);
+    }
+    if (ny_t % nype_t != 0) {
+      throw BoutException("ny = %d not divisible by NYPE = %d "
+                          "(try bout-partition to find a feasible layout)",
+                          ny_t, nype_t);
+    }
+    const int mxsub_t = MX_t / nxpe_t;
+    const int mysub_t = ny_t / nype_t;
+    const int lnx_t = mxsub_t + 2 * MXG;
+    const int lny_t = mysub_t + 2 * MYG;
+
+    printf("Source: nx = %d, ny = %d, nz = %d on %d x %d processors\n", nx, ny, nz,
+           NXPE, NYPE);
+    printf("Target: nx = %d, ny = %d, nz = %d on %d x %d processors "
+           "(order %d stencils)\n\n",
+           tnx, ny_t, tnz, nxpe_t, nype_t, order);
+
+    // Classify the variables in processor 0's file. Everything not a
+    // scalar or a field of the local size is reported and dropped
+    const std::set<std::string> int_scalars = {
+        "MXSUB",   "MYSUB",     "MXG",       "MYG",       "nx",
+        "ny",      "MZ",        "NXPE",      "NYPE",      "zperiod",
+        "ixseps1", "ixseps2",   "jyseps1_1", "jyseps1_2", "jyseps2_1",
+        "jyseps2_2", "ny_inner", "hist_hi"};
+
+    std::vector<std::string> fields2d, fields3d;
+    std::map<std::string, int> scalars_i;
+    std::map<std::string, BoutReal> scalars_r;
+
+    for (const auto &name : file->listVars()) {
+      const std::vector<int> size = file->getSize(name);
+      if ((size.size() == 1) && (size[0] == 1)) {
+        if (int_scalars.count(name) > 0) {
+          file->read(&scalars_i[name], name);
+        } else {
+          file->read(&scalars_r[name], name);
+        }
+      } else if ((size.size() == 2) && (size[0] == lnx) && (size[1] == lny)) {
+        fields2d.push_back(name);
+      } else if ((size.size() == 3) && (size[0] == lnx) && (size[1] == lny)
+                 && (size[2] == nz)) {
+        fields3d.push_back(name);
+      } else {
+        printf("\tNote: '%s' is neither a scalar nor a local-sized field. "
+               "Not transferred\n",
+               name.c_str());
+      }
+    }
+    file->close();
+
+    // Assemble the global arrays, one pass over the source files.
+    // Interior points come from their owning processor; boundary
+    // guard cells from the processors on the domain edge. Internal
+    // guard cells are duplicates of neighbour interiors, so they are
+    // simply skipped
+    std::map<std::string, std::vector<BoutReal>> global;
+    for (const auto &name : fields2d) {
+      global[name].resize(static_cast<size_t>(gnx) * gny);
+    }
+    for (const auto &name : fields3d) {
+      global[name].resize(static_cast<size_t>(gnx) * gny * gnz);
+    }
+
+    std::vector<BoutReal> local(static_cast<size_t>(lnx) * lny * gnz);
+    for (int p = 0; p < NPES; p++) {
+      const int px = p % NXPE;
+      const int py = p / NXPE;
+      auto in = data_format(srcName(p).c_str());
+      if (!in->openr(srcName(p))) {
+        throw BoutException("Could not open '%s'", srcName(p).c_str());
+      }
+
+      const int lx0 = (px == 0) ? 0 : MXG;
+      const int lx1 = (px == NXPE - 1) ? lnx : MXSUB + MXG;
+      const int ly0 = (py == 0) ? 0 : MYG;
+      const int ly1 = (py == NYPE - 1) ? lny : MYSUB + MYG;
+
+      for (const auto &name : fields2d) {
+        if (!in->read(local.data(), name, lnx, lny)) {
+          throw BoutException("Could not read '%s' from '%s'", name.c_str(),
+                              srcName(p).c_str());
+        }
+        std::vector<BoutReal> &g = global[name];
+        for (int lx = lx0; lx < lx1; lx++) {
+          for (int ly = ly0; ly < ly1; ly++) {
+            g[static_cast<size_t>(px * MXSUB + lx) * gny + (py * MYSUB + ly)] =
+                local[static_cast<size_t>(lx) * lny + ly];
+          }
+        }
+      }
+      for (const auto &name : fields3d) {
+        if (!in->read(local.data(), name, lnx, lny, gnz)) {
+          throw BoutException("Could not read '%s' from '%s'", name.c_str(),
+                              srcName(p).c_str());
+        }
+        std::vector<BoutReal> &g = global[name];
+        for (int lx = lx0; lx < lx1; lx++) {
+          for (int ly = ly0; ly < ly1; ly++) {
+            const size_t gind =
+                (static_cast<size_t>(px * MXSUB + lx) * gny + (py * MYSUB + ly)) * gnz;
+            const size_t lind = (static_cast<size_t>(lx) * lny + ly) * gnz;
+            for (int lz = 0; lz < gnz; lz++) {
+              g[gind + lz] = local[lind + lz];
+            }
+          }
+        }
+      }
+      in->close();
+    }
+
+    // Precompute the stencil tables, then run the separable passes
+    // over every field. The empty z table marks the 2D case
+    const Stencil1D sx = buildStencil(gnx, tnx, rx, MXG, order, false);
+    const Stencil1D sy = buildStencil(gny, tny, ry, MYG, order, false);
+    const Stencil1D sz = buildStencil(gnz, tnz, rz, 0, order, true);
+    const Stencil1D sz_none;
+
+    for (const auto &name : fields2d) {
+      global[name] = interpolate(global[name], gnx, gny, 1, sx, sy, sz_none);
+    }
+    for (const auto &name : fields3d) {
+      global[name] = interpolate(global[name], gnx, gny, gnz, sx, sy, sz);
+    }
+
+    // Rescale the topology scalars. Branch cuts are 'last index of
+    // the region' values, so they scale as ry*(j+1)-1; the separatrix
+    // indices scale in the x interior
+    auto rescale = [&](const char *name, int value) {
+      auto it = scalars_i.find(name);
+      if (it != scalars_i.end()) {
+        it->second = value;
+      }
+    };
+    rescale("nx", tnx);
+    rescale("ny", ny_t);
+    rescale("MZ", tnz);
+    rescale("MXSUB", mxsub_t);
+    rescale("MYSUB", mysub_t);
+    rescale("NXPE", nxpe_t);
+    rescale("NYPE", nype_t);
+    for (const auto *name : {"ixseps1", "ixseps2"}) {
+      auto it = scalars_i.find(name);
+      if (it != scalars_i.end()) {
+        it->second = rx * (it->second - MXG) + MXG;
+      }
+    }
+    for (const auto *name : {"jyseps1_1", "jyseps1_2", "jyseps2_1", "jyseps2_2"}) {
+      auto it = scalars_i.find(name);
+      if (it != scalars_i.end()) {
+        it->second = ry * (it->second + 1) - 1;
+      }
+    }
+    {
+      auto it = scalars_i.find("ny_inner");
+      if (it != scalars_i.end()) {
+        it->second = ry * it->second;
+      }
+    }
+
+    // Write the target decomposition, slicing each processor's local
+    // array (guard cells included) out of the interpolated globals
+    std::vector<BoutReal> tlocal(static_cast<size_t>(lnx_t) * lny_t * tnz);
+    for (int p = 0; p < npes_t; p++) {
+      const int px = p % nxpe_t;
+      const int py = p / nxpe_t;
+
+      char buf[16];
+      snprintf(buf, sizeof(buf), ".%d.", p);
+      const std::string outname = dstdir + "/" + base + buf + ext;
+
+      auto out = data_format(outname.c_str());
+      out->setLocalGridSize(lnx_t, lny_t, tnz);
+      if (!out->openw(outname)) {
+        throw BoutException("Could not create '%s'", outname.c_str());
+      }
+
+      for (const auto &s : scalars_i) {
+        out->addVarInt(s.first, false);
+        int value = s.second;
+        out->write(&value, s.first);
+      }
+      for (const auto &s : scalars_r) {
+        out->addVarBoutReal(s.first, false);
+        BoutReal value = s.second;
+        out->write(&value, s.first);
+      }
+
+      for (const auto &name : fields2d) {
+        out->addVarField2D(name, false);
+        const std::vector<BoutReal> &g = global[name];
+        for (int lx = 0; lx < lnx_t; lx++) {
+          for (int ly = 0; ly < lny_t; ly++) {
+            tlocal[static_cast<size_t>(lx) * lny_t + ly] =
+                g[static_cast<size_t>(px * mxsub_t + lx) * tny + (py * mysub_t + ly)];
+          }
+        }
+        out->write(tlocal.data(), name, lnx_t, lny_t);
+      }
+      for (const auto &name : fields3d) {
+        out->addVarField3D(name, false);
+        const std::vector<BoutReal> &g = global[name];
+        for (int lx = 0; lx < lnx_t; lx++) {
+          for (int ly = 0; ly < lny_t; ly++) {
+            const size_t gind =
+                (static_cast<size_t>(px * mxsub_t + lx) * tny + (py * mysub_t + ly))
+                * tnz;
+            const size_t lind = (static_cast<size_t>(lx) * lny_t + ly) * tnz;
+            for (int lz = 0; lz < tnz; lz++) {
+              tlocal[lind + lz] = g[gind + lz];
+            }
+          }
+        }
+        out->write(tlocal.data(), name, lnx_t, lny_t, tnz);
+      }
+      out->close();
+    }
+
+    printf("Wrote %d restart file%s to %s (%d 3D, %d 2D fields, %d scalars)\n",
+           npes_t, (npes_t == 1) ? "" : "s", dstdir.c_str(),
+           static_cast<int>(fields3d.size()), static_cast<int>(fields2d.size()),
+           static_cast<int>(scalars_i.size() + scalars_r.size()));
+  } catch (const BoutException &e) {
+    fprintf(stderr, "Error: %s\n", e.what());
+    return 1;
+  }
+
+  return 0;
+}